@@ -1,6 +1,12 @@
 #include "ED.h"
 #include "EDColor.h"
 #include <fstream>
+#include <climits>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GS_ED_USE_NEON
+#endif
 
 using namespace cv;
 using namespace std;
@@ -198,6 +204,77 @@ ED::ED()
 	//
 }
 
+void ED::Detect(const Mat& image, const Rect& roi, bool input_is_smoothed, GradientOperator _op, int _gradThresh, int _anchorThresh, int _scanInterval, int _minPathLen, double _sigma, bool _sumFlag)
+{
+	// Check parameters for sanity
+	if (_gradThresh < 1) _gradThresh = 1;
+	if (_anchorThresh < 0) _anchorThresh = 0;
+	if (_sigma < 1.0) _sigma = 1.0;
+
+	Mat region = image;
+	if (roi.area() > 0)
+		region = image(roi & Rect(0, 0, image.cols, image.rows));
+
+	// The detector indexes the image as one contiguous block, so an ROI is copied out.
+	// roiBuffer is only ever written here, never aliased to a caller's image.
+	if (region.isContinuous()) {
+		srcImage = region;
+	}
+	else {
+		region.copyTo(roiBuffer);
+		srcImage = roiBuffer;
+	}
+
+	height = srcImage.rows;
+	width = srcImage.cols;
+
+	op = _op;
+	gradThresh = _gradThresh;
+	anchorThresh = _anchorThresh;
+	scanInterval = _scanInterval;
+	minPathLen = _minPathLen;
+	sigma = _sigma;
+	sumFlag = _sumFlag;
+
+	segmentNos = 0;
+	segmentPoints.clear();
+	segmentPoints.push_back(vector<Point>()); // create empty vector of points for segments
+	anchorPoints.clear();
+
+	// create() only re-allocates if the size changed
+	edgeImage.create(height, width, CV_8UC1);
+	edgeImage.setTo(Scalar(0));
+	gradImage.create(height, width, CV_16SC1);
+
+	srcImg = srcImage.data;
+
+	if (input_is_smoothed) {
+		smoothImage = srcImage;
+	}
+	else {
+		if (sigma == 1.0)
+			GaussianBlur(srcImage, smoothBuffer, Size(5, 5), sigma);
+		else
+			GaussianBlur(srcImage, smoothBuffer, Size(), sigma); // calculate kernel from sigma
+
+		smoothImage = smoothBuffer;
+	}
+
+	smoothImg = smoothImage.data;
+	gradImg = (short*)gradImage.data;
+	edgeImg = edgeImage.data;
+
+	// Cleared so that pixels below the gradient threshold never carry a stale direction
+	dirBuffer.assign((size_t)width * height, 0);
+	dirImg = dirBuffer.data();
+
+	ComputeGradient();
+	ComputeAnchorPoints();
+	JoinAnchorPointsUsingSortedAnchors();
+
+	dirImg = nullptr;
+}
+
 
 Mat ED::getEdgeImage()
 {
@@ -275,14 +352,60 @@ Mat ED::drawParticularSegments(std::vector<int> list)
 }
 
 
+int ED::ComputeGradientSumRow(const uchar* above, const uchar* row, const uchar* below, int width, int edgeWeight,
+	short* gradRow, uchar* dirRow, int gradThresh)
+{
+	int j = 1;
+
+#ifdef GS_ED_USE_NEON
+	// 8 pixels at a time.  |gx| + |gy| is at most 2 * 4 * 255, so 16-bit lanes give the same
+	// integers as the scalar code.
+	auto load = [](const uchar* p) { return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p))); };
+
+	const int16x8_t weight = vdupq_n_s16((short)edgeWeight);
+	const int16x8_t thresh = vdupq_n_s16((short)std::min(gradThresh, (int)SHRT_MAX));
+	const uint8x8_t vertical = vdup_n_u8(EDGE_VERTICAL);
+	const uint8x8_t horizontal = vdup_n_u8(EDGE_HORIZONTAL);
+
+	for (; j + 8 <= width - 1; j += 8) {
+		int16x8_t com1 = vsubq_s16(load(below + j + 1), load(above + j - 1));
+		int16x8_t com2 = vsubq_s16(load(above + j + 1), load(below + j - 1));
+
+		int16x8_t gx = vabsq_s16(vmlaq_s16(vaddq_s16(com1, com2), weight, vsubq_s16(load(row + j + 1), load(row + j - 1))));
+		int16x8_t gy = vabsq_s16(vmlaq_s16(vsubq_s16(com1, com2), weight, vsubq_s16(load(below + j), load(above + j))));
+
+		int16x8_t sum = vaddq_s16(gx, gy);
+		vst1q_s16(gradRow + j, sum);
+
+		if (dirRow != nullptr) {
+			// Pixels below the threshold keep whatever direction they had
+			uint8x8_t isEdge = vmovn_u16(vcgeq_s16(sum, thresh));
+			uint8x8_t edgeDir = vbsl_u8(vmovn_u16(vcgeq_s16(gx, gy)), vertical, horizontal);
+			vst1_u8(dirRow + j, vbsl_u8(isEdge, edgeDir, vld1_u8(dirRow + j)));
+		}
+	}
+#endif
+
+	return j;
+}
+
 void ED::ComputeGradient()
 {
 	// Initialize gradient image for row = 0, row = height-1, column=0, column=width-1 
 	for (int j = 0; j < width; j++) { gradImg[j] = gradImg[(height - 1) * width + j] = gradThresh - 1; }
 	for (int i = 1; i < height - 1; i++) { gradImg[i * width] = gradImg[(i + 1) * width - 1] = gradThresh - 1; }
 
+	// Scharr falls through to LSD below, so only Prewitt and Sobel have a vectorized form
+	const bool vectorized = sumFlag && (op == PREWITT_OPERATOR || op == SOBEL_OPERATOR);
+
 	for (int i = 1; i < height - 1; i++) {
-		for (int j = 1; j < width - 1; j++) {
+		int j = 1;
+		if (vectorized) {
+			j = ComputeGradientSumRow(&smoothImg[(i - 1) * width], &smoothImg[i * width], &smoothImg[(i + 1) * width], width,
+				op == SOBEL_OPERATOR ? 2 : 1, &gradImg[i * width], &dirImg[i * width], gradThresh);
+		}
+
+		for (; j < width - 1; j++) {
 			// Prewitt Operator in horizontal and vertical direction
 			// A B C
 			// D x E
@@ -383,6 +506,13 @@ void ED::ComputeAnchorPoints()
 		if (i % scanInterval != 0) { start = scanInterval; inc = scanInterval; }
 
 		for (int j = start; j < width - 2; j += inc) {
+#ifdef GS_ED_USE_NEON
+			// Most pixels are well below the threshold, so skip 8 at a time while none reach it
+			if (inc == 1) {
+				while (j + 8 <= width - 2 && vmaxvq_s16(vld1q_s16(&gradImg[i * width + j])) < gradThresh) j += 8;
+				if (j >= width - 2) break;
+			}
+#endif
 			if (gradImg[i * width + j] < gradThresh) continue;
 
 			if (dirImg[i * width + j] == EDGE_VERTICAL) {
@@ -412,11 +542,22 @@ void ED::ComputeAnchorPoints()
 
 void ED::JoinAnchorPointsUsingSortedAnchors()
 {
-	int* chainNos = new int[(width + height) * 8];
+	// The buffers only grow, so repeated calls to Detect do not re-allocate
+	chainNosBuffer.resize((width + height) * 8);
+	pixelsBuffer.resize(width * height);
+	stackBuffer.resize(width * height);
+	chainsBuffer.resize(width * height);
+
+	int* chainNos = chainNosBuffer.data();
 
-	Point* pixels = new Point[width * height];
-	StackNode* stack = new StackNode[width * height];
-	Chain* chains = new Chain[width * height];
+	Point* pixels = pixelsBuffer.data();
+	StackNode* stack = stackBuffer.data();
+	Chain* chains = chainsBuffer.data();
+
+	// The segment being traced is built up here, and is then copied into segmentPoints at its
+	// final size.  The buffer keeps its capacity, so the tracing itself does not allocate.
+	std::vector<Point>& segment = segmentBuffer;
+	segment.clear();
 
 	// sort the anchor points by their gradient value in decreasing order
 	int* A = sortAnchorsByGradValue1();
@@ -793,12 +934,12 @@ void ED::JoinAnchorPointsUsingSortedAnchors()
 
 					int index = noSegmentPixels - 2;
 					while (index >= 0) {
-						int dr = abs(fr - segmentPoints[segmentNos][index].y);
-						int dc = abs(fc - segmentPoints[segmentNos][index].x);
+						int dr = abs(fr - segment[index].y);
+						int dc = abs(fc - segment[index].x);
 
 						if (dr <= 1 && dc <= 1) {
 							// neighbors. Erase last pixel
-							segmentPoints[segmentNos].pop_back();
+							segment.pop_back();
 							noSegmentPixels--;
 							index--;
 						}
@@ -809,15 +950,15 @@ void ED::JoinAnchorPointsUsingSortedAnchors()
 						fr = chains[chainNo].pixels[chains[chainNo].len - 2].y;
 						fc = chains[chainNo].pixels[chains[chainNo].len - 2].x;
 
-						int dr = abs(fr - segmentPoints[segmentNos][noSegmentPixels - 1].y);
-						int dc = abs(fc - segmentPoints[segmentNos][noSegmentPixels - 1].x);
+						int dr = abs(fr - segment[noSegmentPixels - 1].y);
+						int dc = abs(fc - segment[noSegmentPixels - 1].x);
 
 						if (dr <= 1 && dc <= 1) chains[chainNo].len--;
 					} //end-if
 #endif
 
 					for (int l = chains[chainNo].len - 1; l >= 0; l--) {
-						segmentPoints[segmentNos].push_back(chains[chainNo].pixels[l]);
+						segment.push_back(chains[chainNo].pixels[l]);
 						noSegmentPixels++;
 					} //end-for
 
@@ -846,12 +987,12 @@ void ED::JoinAnchorPointsUsingSortedAnchors()
 
 					int index = noSegmentPixels - 2;
 					while (index >= 0) {
-						int dr = abs(fr - segmentPoints[segmentNos][index].y);
-						int dc = abs(fc - segmentPoints[segmentNos][index].x);
+						int dr = abs(fr - segment[index].y);
+						int dc = abs(fc - segment[index].x);
 
 						if (dr <= 1 && dc <= 1) {
 							// neighbors. Erase last pixel
-							segmentPoints[segmentNos].pop_back();
+							segment.pop_back();
 							noSegmentPixels--;
 							index--;
 						}
@@ -864,8 +1005,8 @@ void ED::JoinAnchorPointsUsingSortedAnchors()
 						int fr = chains[chainNo].pixels[1].y;
 						int fc = chains[chainNo].pixels[1].x;
 
-						int dr = abs(fr - segmentPoints[segmentNos][noSegmentPixels - 1].y);
-						int dc = abs(fc - segmentPoints[segmentNos][noSegmentPixels - 1].x);
+						int dr = abs(fr - segment[noSegmentPixels - 1].y);
+						int dc = abs(fc - segment[noSegmentPixels - 1].x);
 
 						if (dr <= 1 && dc <= 1) { startIndex = 1; }
 					} //end-if
@@ -873,7 +1014,7 @@ void ED::JoinAnchorPointsUsingSortedAnchors()
 
 					  /* Start a new chain & copy pixels from the new chain */
 					for (int l = startIndex; l < chains[chainNo].len; l++) {
-						segmentPoints[segmentNos].push_back(chains[chainNo].pixels[l]);
+						segment.push_back(chains[chainNo].pixels[l]);
 						noSegmentPixels++;
 					} //end-for
 
@@ -883,19 +1024,21 @@ void ED::JoinAnchorPointsUsingSortedAnchors()
 
 
 			  // See if the first pixel can be cleaned up
-			int fr = segmentPoints[segmentNos][1].y;
-			int fc = segmentPoints[segmentNos][1].x;
+			int fr = segment[1].y;
+			int fc = segment[1].x;
 
 
-			int dr = abs(fr - segmentPoints[segmentNos][noSegmentPixels - 1].y);
-			int dc = abs(fc - segmentPoints[segmentNos][noSegmentPixels - 1].x);
+			int dr = abs(fr - segment[noSegmentPixels - 1].y);
+			int dc = abs(fc - segment[noSegmentPixels - 1].x);
 
 
 			if (dr <= 1 && dc <= 1) {
-				segmentPoints[segmentNos].erase(segmentPoints[segmentNos].begin());
+				segment.erase(segment.begin());
 				noSegmentPixels--;
 			} //end-if
 
+			segmentPoints[segmentNos].assign(segment.begin(), segment.end());
+			segment.clear();
 			segmentNos++;
 			segmentPoints.push_back(vector<Point>()); // create empty vector of points for segments
 
@@ -922,12 +1065,12 @@ void ED::JoinAnchorPointsUsingSortedAnchors()
 
 						int index = noSegmentPixels - 2;
 						while (index >= 0) {
-							int dr = abs(fr - segmentPoints[segmentNos][index].y);
-							int dc = abs(fc - segmentPoints[segmentNos][index].x);
+							int dr = abs(fr - segment[index].y);
+							int dc = abs(fc - segment[index].x);
 
 							if (dr <= 1 && dc <= 1) {
 								// neighbors. Erase last pixel
-								segmentPoints[segmentNos].pop_back();
+								segment.pop_back();
 								noSegmentPixels--;
 								index--;
 							}
@@ -940,20 +1083,22 @@ void ED::JoinAnchorPointsUsingSortedAnchors()
 							int fr = chains[chainNo].pixels[1].y;
 							int fc = chains[chainNo].pixels[1].x;
 
-							int dr = abs(fr - segmentPoints[segmentNos][noSegmentPixels - 1].y);
-							int dc = abs(fc - segmentPoints[segmentNos][noSegmentPixels - 1].x);
+							int dr = abs(fr - segment[noSegmentPixels - 1].y);
+							int dc = abs(fc - segment[noSegmentPixels - 1].x);
 
 							if (dr <= 1 && dc <= 1) { startIndex = 1; }
 						} //end-if
 #endif
 						  /* Start a new chain & copy pixels from the new chain */
 						for (int l = startIndex; l < chains[chainNo].len; l++) {
-							segmentPoints[segmentNos].push_back(chains[chainNo].pixels[l]);
+							segment.push_back(chains[chainNo].pixels[l]);
 							noSegmentPixels++;
 						} //end-for
 
 						chains[chainNo].len = 0;  // Mark as copied
 					} //end-for
+					segmentPoints[segmentNos].assign(segment.begin(), segment.end());
+					segment.clear();
 					segmentPoints.push_back(vector<Point>()); // create empty vector of points for segments
 					segmentNos++;
 				} //end-if          
@@ -966,13 +1111,6 @@ void ED::JoinAnchorPointsUsingSortedAnchors()
 	// pop back last segment from vector
 	// because of one preallocation in the beginning, it will always empty
 	segmentPoints.pop_back();
-
-	// Clean up
-	delete[] A;
-	delete[] chains;
-	delete[] stack;
-	delete[] chainNos;
-	delete[] pixels;
 }
 
 void ED::sortAnchorsByGradValue()
@@ -1012,39 +1150,35 @@ void ED::sortAnchorsByGradValue()
 
 int* ED::sortAnchorsByGradValue1()
 {
-	int SIZE = 128 * 256;
-	int* C = new int[SIZE];
-	memset(C, 0, sizeof(int) * SIZE);
+	// A counting sort over the anchor list, which is in raster order, so the anchors come out in
+	// the same order as from a scan of the whole image, in a time that only depends on the
+	// number of anchors.  Only the histogram entries up to the largest anchor gradient are used.
+	int maxGrad = 0;
+	for (const Point& anchor : anchorPoints) {
+		int grad = gradImg[anchor.y * width + anchor.x];
+		if (grad > maxGrad) maxGrad = grad;
+	} //end-for
+
+	int SIZE = maxGrad + 1;
+	gradCountBuffer.assign(SIZE, 0);
+	int* C = gradCountBuffer.data();
 
 	// Count the number of grad values
-	for (int i = 1; i < height - 1; i++) {
-		for (int j = 1; j < width - 1; j++) {
-			if (edgeImg[i * width + j] != ANCHOR_PIXEL) continue;
-
-			int grad = gradImg[i * width + j];
-			C[grad]++;
-		} //end-for
-	} //end-for 
+	for (const Point& anchor : anchorPoints)
+		C[gradImg[anchor.y * width + anchor.x]]++;
 
 	// Compute indices
 	for (int i = 1; i < SIZE; i++) C[i] += C[i - 1];
 
 	int noAnchors = C[SIZE - 1];
-	int* A = new int[noAnchors];
-	memset(A, 0, sizeof(int) * noAnchors);
-
-
-	for (int i = 1; i < height - 1; i++) {
-		for (int j = 1; j < width - 1; j++) {
-			if (edgeImg[i * width + j] != ANCHOR_PIXEL) continue;
-
-			int grad = gradImg[i * width + j];
-			int index = --C[grad];
-			A[index] = i * width + j;    // anchor's offset 
-		} //end-for
-	} //end-for  
-
-	delete[] C;
+	sortedAnchorsBuffer.assign(noAnchors, 0);
+	int* A = sortedAnchorsBuffer.data();
+
+	for (const Point& anchor : anchorPoints) {
+		int offset = anchor.y * width + anchor.x;
+		int index = --C[gradImg[offset]];
+		A[index] = offset;    // anchor's offset 
+	} //end-for
 
 	/*
 	ofstream myFile;
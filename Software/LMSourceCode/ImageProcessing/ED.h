@@ -84,6 +84,14 @@ public://ED 
 
 	cv::Mat drawParticularSegments(std::vector<int> list);
 
+	// Re-runs the detector on a new image, reusing this object's working buffers, so that an
+	// ED constructed once with ED() can be called for each image without re-allocating.
+	// If roi is not empty, only that part of the image is processed, and the results are in
+	// ROI coordinates.  If the image has already been blurred, input_is_smoothed skips the
+	// Gaussian smoothing step.  The returned images are overwritten by the next call.
+	void Detect(const cv::Mat& image, const cv::Rect& roi = cv::Rect(), bool input_is_smoothed = false,
+		GradientOperator _op = PREWITT_OPERATOR, int _gradThresh = 20, int _anchorThresh = 0, int _scanInterval = 1, int _minPathLen = 10, double _sigma = 1.0, bool _sumFlag = true);
+
 protected:
 	int width; // width of source image
 	int height; // height of source image
@@ -97,6 +105,13 @@ protected:
 	int minPathLen;
 	cv::Mat srcImage;
 
+	// Computes the Prewitt (edgeWeight = 1) or Sobel (edgeWeight = 2) |gx| + |gy| for the interior
+	// pixels of one row, several pixels at a time where NEON is available.  If dirRow is not null,
+	// the edge direction is also set wherever the sum reaches gradThresh.  Returns the first column
+	// that is left for the caller's scalar loop (1 if nothing was done).
+	static int ComputeGradientSumRow(const uchar* above, const uchar* row, const uchar* below, int width, int edgeWeight,
+		short* gradRow, uchar* dirRow = nullptr, int gradThresh = 0);
+
 private:
 	void ComputeGradient();
 	void ComputeAnchorPoints();
@@ -122,6 +137,18 @@ private:
 	int anchorThresh; // anchor point threshold
 	int scanInterval;
 	bool sumFlag;
+
+	// Working buffers, kept between calls to Detect
+	cv::Mat roiBuffer;
+	cv::Mat smoothBuffer;
+	std::vector<uchar> dirBuffer;
+	std::vector<int> chainNosBuffer;
+	std::vector<cv::Point> pixelsBuffer;
+	std::vector<StackNode> stackBuffer;
+	std::vector<Chain> chainsBuffer;
+	std::vector<int> gradCountBuffer;
+	std::vector<int> sortedAnchorsBuffer;
+	std::vector<cv::Point> segmentBuffer;
 };
 
 
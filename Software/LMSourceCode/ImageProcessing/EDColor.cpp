@@ -1,5 +1,11 @@
 #include "EDColor.h"
 #include "ED.h"
+#include <array>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GS_EDCOLOR_USE_NEON
+#endif
 
 using namespace cv;
 using namespace std;
@@ -138,41 +144,99 @@ void EDColor::MyRGB2LabFast()
 	double* a = new double[width * height];
 	double* b = new double[width * height];
 
-	for (int i = 0; i < width * height; i++) {
-		red = redImg[i] / 255.0;
-		green = greenImg[i] / 255.0;
-		blue = blueImg[i] / 255.0;
-
-		red = LUT1[(int)(red * LUT_SIZE + 0.5)];
-		green = LUT1[(int)(green * LUT_SIZE + 0.5)];
-		blue = LUT1[(int)(blue * LUT_SIZE + 0.5)];
-
-		red = red * 100;
-		green = green * 100;
-		blue = blue * 100;
-
-		//Observer. = 2? Illuminant = D65
-		x = red * 0.4124564 + green * 0.3575761 + blue * 0.1804375;
-		y = red * 0.2126729 + green * 0.7151522 + blue * 0.0721750;
-		z = red * 0.0193339 + green * 0.1191920 + blue * 0.9503041;
-
-		// Now xyz 2 Lab
-		double refX = 95.047;
-		double refY = 100.000;
-		double refZ = 108.883;
-
-		x = x / refX;          //ref_X =  95.047   Observer= 2? Illuminant= D65
-		y = y / refY;          //ref_Y = 100.000
-		z = z / refZ;          //ref_Z = 108.883
-
-		x = LUT2[(int)(x * LUT_SIZE + 0.5)];
-		y = LUT2[(int)(y * LUT_SIZE + 0.5)];
-		z = LUT2[(int)(z * LUT_SIZE + 0.5)];
-
-		L[i] = (116.0 * y) - 16;
-		a[i] = 500 * (x / y);
-		b[i] = 200 * (y - z);
-	} //end-for
+	if (!referenceMode) {
+		// The gamma correction only depends on the 8-bit value, so each of the 256 is looked up
+		// (with the same arithmetic as below) just once
+		static const std::array<double, 256> linearValues = [] {
+			std::array<double, 256> values;
+			for (int v = 0; v < 256; v++) values[v] = LUT1[(int)((v / 255.0) * LUT_SIZE + 0.5)] * 100;
+			return values;
+		}();
+
+		const double* linear = linearValues.data();
+		int i = 0;
+
+#ifdef GS_EDCOLOR_USE_NEON
+		// 2 pixels at a time, with the same double operations in the same order as the scalar code
+		for (; i + 2 <= width * height; i += 2) {
+			float64x2_t r = { linear[redImg[i]], linear[redImg[i + 1]] };
+			float64x2_t g = { linear[greenImg[i]], linear[greenImg[i + 1]] };
+			float64x2_t bl = { linear[blueImg[i]], linear[blueImg[i + 1]] };
+
+			float64x2_t vx = vaddq_f64(vaddq_f64(vmulq_n_f64(r, 0.4124564), vmulq_n_f64(g, 0.3575761)), vmulq_n_f64(bl, 0.1804375));
+			float64x2_t vy = vaddq_f64(vaddq_f64(vmulq_n_f64(r, 0.2126729), vmulq_n_f64(g, 0.7151522)), vmulq_n_f64(bl, 0.0721750));
+			float64x2_t vz = vaddq_f64(vaddq_f64(vmulq_n_f64(r, 0.0193339), vmulq_n_f64(g, 0.1191920)), vmulq_n_f64(bl, 0.9503041));
+
+			vx = vdivq_f64(vx, vdupq_n_f64(95.047));
+			vy = vdivq_f64(vy, vdupq_n_f64(100.000));
+			vz = vdivq_f64(vz, vdupq_n_f64(108.883));
+
+			float64x2_t fx = { LUT2[(int)(vgetq_lane_f64(vx, 0) * LUT_SIZE + 0.5)], LUT2[(int)(vgetq_lane_f64(vx, 1) * LUT_SIZE + 0.5)] };
+			float64x2_t fy = { LUT2[(int)(vgetq_lane_f64(vy, 0) * LUT_SIZE + 0.5)], LUT2[(int)(vgetq_lane_f64(vy, 1) * LUT_SIZE + 0.5)] };
+			float64x2_t fz = { LUT2[(int)(vgetq_lane_f64(vz, 0) * LUT_SIZE + 0.5)], LUT2[(int)(vgetq_lane_f64(vz, 1) * LUT_SIZE + 0.5)] };
+
+			vst1q_f64(&L[i], vsubq_f64(vmulq_n_f64(fy, 116.0), vdupq_n_f64(16)));
+			vst1q_f64(&a[i], vmulq_n_f64(vdivq_f64(fx, fy), 500));
+			vst1q_f64(&b[i], vmulq_n_f64(vsubq_f64(fy, fz), 200));
+		}
+#endif
+
+		for (; i < width * height; i++) {
+			red = linear[redImg[i]];
+			green = linear[greenImg[i]];
+			blue = linear[blueImg[i]];
+
+			x = (red * 0.4124564 + green * 0.3575761 + blue * 0.1804375) / 95.047;
+			y = (red * 0.2126729 + green * 0.7151522 + blue * 0.0721750) / 100.000;
+			z = (red * 0.0193339 + green * 0.1191920 + blue * 0.9503041) / 108.883;
+
+			x = LUT2[(int)(x * LUT_SIZE + 0.5)];
+			y = LUT2[(int)(y * LUT_SIZE + 0.5)];
+			z = LUT2[(int)(z * LUT_SIZE + 0.5)];
+
+			L[i] = (116.0 * y) - 16;
+			a[i] = 500 * (x / y);
+			b[i] = 200 * (y - z);
+		}
+	}
+
+	else {
+		for (int i = 0; i < width * height; i++) {
+			red = redImg[i] / 255.0;
+			green = greenImg[i] / 255.0;
+			blue = blueImg[i] / 255.0;
+
+			red = LUT1[(int)(red * LUT_SIZE + 0.5)];
+			green = LUT1[(int)(green * LUT_SIZE + 0.5)];
+			blue = LUT1[(int)(blue * LUT_SIZE + 0.5)];
+
+			red = red * 100;
+			green = green * 100;
+			blue = blue * 100;
+
+			//Observer. = 2? Illuminant = D65
+			x = red * 0.4124564 + green * 0.3575761 + blue * 0.1804375;
+			y = red * 0.2126729 + green * 0.7151522 + blue * 0.0721750;
+			z = red * 0.0193339 + green * 0.1191920 + blue * 0.9503041;
+
+			// Now xyz 2 Lab
+			double refX = 95.047;
+			double refY = 100.000;
+			double refZ = 108.883;
+
+			x = x / refX;          //ref_X =  95.047   Observer= 2? Illuminant= D65
+			y = y / refY;          //ref_Y = 100.000
+			z = z / refZ;          //ref_Z = 108.883
+
+			x = LUT2[(int)(x * LUT_SIZE + 0.5)];
+			y = LUT2[(int)(y * LUT_SIZE + 0.5)];
+			z = LUT2[(int)(z * LUT_SIZE + 0.5)];
+
+			L[i] = (116.0 * y) - 16;
+			a[i] = 500 * (x / y);
+			b[i] = 200 * (y - z);
+		} //end-for
+	}
 
 	// Scale L to [0-255]
 	double min = 1e10;
@@ -220,84 +284,188 @@ void EDColor::ComputeGradientMapByDiZenzo()
 
 	int max = 0;
 
-	for (int i = 1; i < height - 1; i++) {
-		for (int j = 1; j < width - 1; j++) {
-#if 1
-			// Prewitt for channel1
-			int com1 = smooth_L[(i + 1) * width + j + 1] - smooth_L[(i - 1) * width + j - 1];
-			int com2 = smooth_L[(i - 1) * width + j + 1] - smooth_L[(i + 1) * width + j - 1];
-
-			int gxCh1 = com1 + com2 + (smooth_L[i * width + j + 1] - smooth_L[i * width + j - 1]);
-			int gyCh1 = com1 - com2 + (smooth_L[(i + 1) * width + j] - smooth_L[(i - 1) * width + j]);
-
-			// Prewitt for channel2
-			com1 = smooth_a[(i + 1) * width + j + 1] - smooth_a[(i - 1) * width + j - 1];
-			com2 = smooth_a[(i - 1) * width + j + 1] - smooth_a[(i + 1) * width + j - 1];
+	if (!referenceMode) {
+		for (int i = 1; i < height - 1; i++) {
+			int rowMax = ComputeDiZenzoRow(i);
+			if (rowMax > max) max = rowMax;
+		}
+	}
 
-			int gxCh2 = com1 + com2 + (smooth_a[i * width + j + 1] - smooth_a[i * width + j - 1]);
-			int gyCh2 = com1 - com2 + (smooth_a[(i + 1) * width + j] - smooth_a[(i - 1) * width + j]);
+	else {
+		for (int i = 1; i < height - 1; i++) {
+			for (int j = 1; j < width - 1; j++) {
+	#if 1
+				// Prewitt for channel1
+				int com1 = smooth_L[(i + 1) * width + j + 1] - smooth_L[(i - 1) * width + j - 1];
+				int com2 = smooth_L[(i - 1) * width + j + 1] - smooth_L[(i + 1) * width + j - 1];
+
+				int gxCh1 = com1 + com2 + (smooth_L[i * width + j + 1] - smooth_L[i * width + j - 1]);
+				int gyCh1 = com1 - com2 + (smooth_L[(i + 1) * width + j] - smooth_L[(i - 1) * width + j]);
+
+				// Prewitt for channel2
+				com1 = smooth_a[(i + 1) * width + j + 1] - smooth_a[(i - 1) * width + j - 1];
+				com2 = smooth_a[(i - 1) * width + j + 1] - smooth_a[(i + 1) * width + j - 1];
+
+				int gxCh2 = com1 + com2 + (smooth_a[i * width + j + 1] - smooth_a[i * width + j - 1]);
+				int gyCh2 = com1 - com2 + (smooth_a[(i + 1) * width + j] - smooth_a[(i - 1) * width + j]);
+
+				// Prewitt for channel3
+				com1 = smooth_b[(i + 1) * width + j + 1] - smooth_b[(i - 1) * width + j - 1];
+				com2 = smooth_b[(i - 1) * width + j + 1] - smooth_b[(i + 1) * width + j - 1];
+
+				int gxCh3 = com1 + com2 + (smooth_b[i * width + j + 1] - smooth_b[i * width + j - 1]);
+				int gyCh3 = com1 - com2 + (smooth_b[(i + 1) * width + j] - smooth_b[(i - 1) * width + j]);
+	#else
+				// Sobel for channel1
+				int com1 = smooth_L[(i + 1) * width + j + 1] - smooth_L[(i - 1) * width + j - 1];
+				int com2 = smooth_L[(i - 1) * width + j + 1] - smooth_L[(i + 1) * width + j - 1];
+
+				int gxCh1 = com1 + com2 + 2 * (smooth_L[i * width + j + 1] - smooth_L[i * width + j - 1]);
+				int gyCh1 = com1 - com2 + 2 * (smooth_L[(i + 1) * width + j] - smooth_L[(i - 1) * width + j]);
+
+				// Sobel for channel2
+				com1 = smooth_a[(i + 1) * width + j + 1] - smooth_a[(i - 1) * width + j - 1];
+				com2 = smooth_a[(i - 1) * width + j + 1] - smooth_a[(i + 1) * width + j - 1];
+
+				int gxCh2 = com1 + com2 + 2 * (smooth_a[i * width + j + 1] - smooth_a[i * width + j - 1]);
+				int gyCh2 = com1 - com2 + 2 * (smooth_a[(i + 1) * width + j] - smooth_a[(i - 1) * width + j]);
+
+				// Sobel for channel3
+				com1 = smooth_b[(i + 1) * width + j + 1] - smooth_b[(i - 1) * width + j - 1];
+				com2 = smooth_b[(i - 1) * width + j + 1] - smooth_b[(i + 1) * width + j - 1];
+
+				int gxCh3 = com1 + com2 + 2 * (smooth_b[i * width + j + 1] - smooth_b[i * width + j - 1]);
+				int gyCh3 = com1 - com2 + 2 * (smooth_b[(i + 1) * width + j] - smooth_b[(i - 1) * width + j]);
+	#endif
+				int gxx = gxCh1 * gxCh1 + gxCh2 * gxCh2 + gxCh3 * gxCh3;
+				int gyy = gyCh1 * gyCh1 + gyCh2 * gyCh2 + gyCh3 * gyCh3;
+				int gxy = gxCh1 * gyCh1 + gxCh2 * gyCh2 + gxCh3 * gyCh3;
+
+	#if 1
+				// Di Zenzo's formulas from Gonzales & Woods - Page 337
+				double theta = atan2(2.0 * gxy, (double)(gxx - gyy)) / 2; // Gradient Direction
+				int grad = (int)(sqrt(((gxx + gyy) + (gxx - gyy) * cos(2 * theta) + 2 * gxy * sin(2 * theta)) / 2.0) + 0.5); // Gradient Magnitude
+	#else
+				// Koschan & Abidi - 2005 - Signal Processing Magazine
+				double theta = atan2(2.0 * gxy, (double)(gxx - gyy)) / 2; // Gradient Direction
+
+				double cosTheta = cos(theta);
+				double sinTheta = sin(theta);
+				int grad = (int)(sqrt(gxx * cosTheta * cosTheta + 2 * gxy * sinTheta * cosTheta + gyy * sinTheta * sinTheta) + 0.5); // Gradient Magnitude
+	#endif
+
+				// Gradient is perpendicular to the edge passing through the pixel	
+				if (theta >= -3.14159 / 4 && theta <= 3.14159 / 4)
+					dirImg[i * width + j] = EDGE_VERTICAL;
+				else
+					dirImg[i * width + j] = EDGE_HORIZONTAL;
+
+				gradImg[i * width + j] = grad;
+				if (grad > max) max = grad;
 
-			// Prewitt for channel3
-			com1 = smooth_b[(i + 1) * width + j + 1] - smooth_b[(i - 1) * width + j - 1];
-			com2 = smooth_b[(i - 1) * width + j + 1] - smooth_b[(i + 1) * width + j - 1];
+			}
+		} // end outer for
+	}
 
-			int gxCh3 = com1 + com2 + (smooth_b[i * width + j + 1] - smooth_b[i * width + j - 1]);
-			int gyCh3 = com1 - com2 + (smooth_b[(i + 1) * width + j] - smooth_b[(i - 1) * width + j]);
-#else
-			// Sobel for channel1
-			int com1 = smooth_L[(i + 1) * width + j + 1] - smooth_L[(i - 1) * width + j - 1];
-			int com2 = smooth_L[(i - 1) * width + j + 1] - smooth_L[(i + 1) * width + j - 1];
+	// Scale the gradient values to 0-255
+	double scale = 255.0 / max;
+	for (int i = 0; i < width * height; i++)
+		gradImg[i] = (short)(gradImg[i] * scale);
+}
 
-			int gxCh1 = com1 + com2 + 2 * (smooth_L[i * width + j + 1] - smooth_L[i * width + j - 1]);
-			int gyCh1 = com1 - com2 + 2 * (smooth_L[(i + 1) * width + j] - smooth_L[(i - 1) * width + j]);
+int EDColor::ComputeDiZenzoRow(int i)
+{
+	// With cos(2 * theta) = (gxx - gyy) / r and sin(2 * theta) = 2 * gxy / r, where
+	// r = sqrt((gxx - gyy)^2 + 4 * gxy^2), Di Zenzo's magnitude is sqrt(((gxx + gyy) + r) / 2).
+	// |theta| is at most 45 degrees where gxx - gyy > 0 (or where all of them are 0).
+	const uchar* channels[3] = { smooth_L, smooth_a, smooth_b };
+	int max = 0;
+	int j = 1;
+
+#ifdef GS_EDCOLOR_USE_NEON
+	// 8 pixels at a time.  The Prewitt sums fit in 16 bits and the moments in 32 bits, so those are
+	// the same integers as the scalar code, and the magnitude is then worked out in doubles.
+	auto load = [](const uchar* p) { return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p))); };
+	auto toDouble = [](int32x2_t v) { return vcvtq_f64_s64(vmovl_s32(v)); };
+	auto magnitude = [&](int32x2_t gxx, int32x2_t gyy, int32x2_t gxy) {
+		float64x2_t diff = toDouble(vsub_s32(gxx, gyy));
+		float64x2_t cross = toDouble(gxy);
+		float64x2_t r = vsqrtq_f64(vaddq_f64(vmulq_f64(diff, diff), vmulq_f64(vmulq_n_f64(cross, 4.0), cross)));
+		float64x2_t grad = vsqrtq_f64(vmulq_n_f64(vaddq_f64(toDouble(vadd_s32(gxx, gyy)), r), 0.5));
+		return vmovn_s64(vcvtq_s64_f64(vaddq_f64(grad, vdupq_n_f64(0.5))));
+	};
+
+	const uint8x8_t vertical = vdup_n_u8(EDGE_VERTICAL);
+	const uint8x8_t horizontal = vdup_n_u8(EDGE_HORIZONTAL);
+	int32x4_t rowMax = vdupq_n_s32(0);
+
+	for (; j + 8 <= width - 1; j += 8) {
+		int32x4_t gxxLo = vdupq_n_s32(0), gxxHi = vdupq_n_s32(0);
+		int32x4_t gyyLo = vdupq_n_s32(0), gyyHi = vdupq_n_s32(0);
+		int32x4_t gxyLo = vdupq_n_s32(0), gxyHi = vdupq_n_s32(0);
+
+		for (const uchar* channel : channels) {
+			const uchar* above = channel + (i - 1) * width + j;
+			const uchar* row = channel + i * width + j;
+			const uchar* below = channel + (i + 1) * width + j;
+
+			int16x8_t com1 = vsubq_s16(load(below + 1), load(above - 1));
+			int16x8_t com2 = vsubq_s16(load(above + 1), load(below - 1));
+
+			int16x8_t gx = vaddq_s16(vaddq_s16(com1, com2), vsubq_s16(load(row + 1), load(row - 1)));
+			int16x8_t gy = vaddq_s16(vsubq_s16(com1, com2), vsubq_s16(load(below), load(above)));
+
+			gxxLo = vmlal_s16(gxxLo, vget_low_s16(gx), vget_low_s16(gx));
+			gxxHi = vmlal_high_s16(gxxHi, gx, gx);
+			gyyLo = vmlal_s16(gyyLo, vget_low_s16(gy), vget_low_s16(gy));
+			gyyHi = vmlal_high_s16(gyyHi, gy, gy);
+			gxyLo = vmlal_s16(gxyLo, vget_low_s16(gx), vget_low_s16(gy));
+			gxyHi = vmlal_high_s16(gxyHi, gx, gy);
+		}
 
-			// Sobel for channel2
-			com1 = smooth_a[(i + 1) * width + j + 1] - smooth_a[(i - 1) * width + j - 1];
-			com2 = smooth_a[(i - 1) * width + j + 1] - smooth_a[(i + 1) * width + j - 1];
+		int32x4_t gradLo = vcombine_s32(magnitude(vget_low_s32(gxxLo), vget_low_s32(gyyLo), vget_low_s32(gxyLo)),
+			magnitude(vget_high_s32(gxxLo), vget_high_s32(gyyLo), vget_high_s32(gxyLo)));
+		int32x4_t gradHi = vcombine_s32(magnitude(vget_low_s32(gxxHi), vget_low_s32(gyyHi), vget_low_s32(gxyHi)),
+			magnitude(vget_high_s32(gxxHi), vget_high_s32(gyyHi), vget_high_s32(gxyHi)));
 
-			int gxCh2 = com1 + com2 + 2 * (smooth_a[i * width + j + 1] - smooth_a[i * width + j - 1]);
-			int gyCh2 = com1 - com2 + 2 * (smooth_a[(i + 1) * width + j] - smooth_a[(i - 1) * width + j]);
+		rowMax = vmaxq_s32(rowMax, vmaxq_s32(gradLo, gradHi));
+		vst1q_s16(&gradImg[i * width + j], vcombine_s16(vmovn_s32(gradLo), vmovn_s32(gradHi)));
 
-			// Sobel for channel3
-			com1 = smooth_b[(i + 1) * width + j + 1] - smooth_b[(i - 1) * width + j - 1];
-			com2 = smooth_b[(i - 1) * width + j + 1] - smooth_b[(i + 1) * width + j - 1];
+		// gxx > gyy, or gxx == gyy with gxy == 0
+		uint32x4_t verticalLo = vorrq_u32(vcgtq_s32(gxxLo, gyyLo), vandq_u32(vceqq_s32(gxxLo, gyyLo), vceqzq_s32(gxyLo)));
+		uint32x4_t verticalHi = vorrq_u32(vcgtq_s32(gxxHi, gyyHi), vandq_u32(vceqq_s32(gxxHi, gyyHi), vceqzq_s32(gxyHi)));
+		uint8x8_t isVertical = vmovn_u16(vcombine_u16(vmovn_u32(verticalLo), vmovn_u32(verticalHi)));
+		vst1_u8(&dirImg[i * width + j], vbsl_u8(isVertical, vertical, horizontal));
+	}
 
-			int gxCh3 = com1 + com2 + 2 * (smooth_b[i * width + j + 1] - smooth_b[i * width + j - 1]);
-			int gyCh3 = com1 - com2 + 2 * (smooth_b[(i + 1) * width + j] - smooth_b[(i - 1) * width + j]);
-#endif
-			int gxx = gxCh1 * gxCh1 + gxCh2 * gxCh2 + gxCh3 * gxCh3;
-			int gyy = gyCh1 * gyCh1 + gyCh2 * gyCh2 + gyCh3 * gyCh3;
-			int gxy = gxCh1 * gyCh1 + gxCh2 * gyCh2 + gxCh3 * gyCh3;
-
-#if 1
-			// Di Zenzo's formulas from Gonzales & Woods - Page 337
-			double theta = atan2(2.0 * gxy, (double)(gxx - gyy)) / 2; // Gradient Direction
-			int grad = (int)(sqrt(((gxx + gyy) + (gxx - gyy) * cos(2 * theta) + 2 * gxy * sin(2 * theta)) / 2.0) + 0.5); // Gradient Magnitude
-#else
-			// Koschan & Abidi - 2005 - Signal Processing Magazine
-			double theta = atan2(2.0 * gxy, (double)(gxx - gyy)) / 2; // Gradient Direction
-
-			double cosTheta = cos(theta);
-			double sinTheta = sin(theta);
-			int grad = (int)(sqrt(gxx * cosTheta * cosTheta + 2 * gxy * sinTheta * cosTheta + gyy * sinTheta * sinTheta) + 0.5); // Gradient Magnitude
+	max = vmaxvq_s32(rowMax);
 #endif
 
-			// Gradient is perpendicular to the edge passing through the pixel	
-			if (theta >= -3.14159 / 4 && theta <= 3.14159 / 4)
-				dirImg[i * width + j] = EDGE_VERTICAL;
-			else
-				dirImg[i * width + j] = EDGE_HORIZONTAL;
+	for (; j < width - 1; j++) {
+		int gxx = 0, gyy = 0, gxy = 0;
 
-			gradImg[i * width + j] = grad;
-			if (grad > max) max = grad;
+		for (const uchar* channel : channels) {
+			int com1 = channel[(i + 1) * width + j + 1] - channel[(i - 1) * width + j - 1];
+			int com2 = channel[(i - 1) * width + j + 1] - channel[(i + 1) * width + j - 1];
+
+			int gx = com1 + com2 + (channel[i * width + j + 1] - channel[i * width + j - 1]);
+			int gy = com1 - com2 + (channel[(i + 1) * width + j] - channel[(i - 1) * width + j]);
 
+			gxx += gx * gx;
+			gyy += gy * gy;
+			gxy += gx * gy;
 		}
-	} // end outer for
 
-	// Scale the gradient values to 0-255
-	double scale = 255.0 / max;
-	for (int i = 0; i < width * height; i++)
-		gradImg[i] = (short)(gradImg[i] * scale);
+		double diff = (double)(gxx - gyy);
+		double r = sqrt(diff * diff + 4.0 * gxy * (double)gxy);
+		int grad = (int)(sqrt(((gxx + gyy) + r) / 2.0) + 0.5);
+
+		dirImg[i * width + j] = (gxx > gyy || (gxx == gyy && gxy == 0)) ? EDGE_VERTICAL : EDGE_HORIZONTAL;
+		gradImg[i * width + j] = grad;
+		if (grad > max) max = grad;
+	}
+
+	return max;
 }
 
 void EDColor::smoothChannel(uchar* src, uchar* smooth, double sigma)
@@ -620,5 +788,6 @@ void EDColor::InitColorEDLib()
 }
 
 bool EDColor::LUT_Initialized = false;
+bool EDColor::referenceMode = false;
 double EDColor::LUT1[LUT_SIZE + 1] = { 0 };
 double EDColor::LUT2[LUT_SIZE + 1] = { 0 };
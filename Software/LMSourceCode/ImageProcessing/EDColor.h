@@ -59,6 +59,14 @@ public:
 	int getHeight();
 
 	cv::Mat inputImage;
+
+	// If set, the Lab conversion and the Di Zenzo gradient run the original scalar code, e.g., to
+	// validate the faster versions against it.  The faster Lab conversion gives the same bytes.  The
+	// faster gradient takes its magnitude and direction straight from the moments rather than from
+	// the angle, so a magnitude that rounds at exactly .5 could be one apart.  A pixel whose moments
+	// put it at exactly 45 degrees is a horizontal edge in both, as it (narrowly) is in the original.
+	static bool referenceMode;
+
 private:
 	uchar* L_Img;
 	uchar* a_Img;
@@ -94,6 +102,9 @@ private:
 
 	void MyRGB2LabFast();
 	void ComputeGradientMapByDiZenzo();
+	// Computes the Di Zenzo gradient and edge direction of the interior pixels of row i, several
+	// pixels at a time where NEON is available, and returns the largest gradient of the row
+	int ComputeDiZenzoRow(int i);
 	void smoothChannel(uchar* src, uchar* smooth, double sigma);
 	void validateEdgeSegments();
 	void testSegment(int i, int index1, int index2);
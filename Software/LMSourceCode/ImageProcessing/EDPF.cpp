@@ -28,13 +28,26 @@ EDPF::EDPF(EDColor obj)
 {
 }
 
+EDPF::EDPF()
+	:ED()
+{
+}
+
+void EDPF::Detect(const Mat& image, const Rect& roi, bool input_is_smoothed)
+{
+	// Same parameters as EDPF(Mat)
+	ED::Detect(image, roi, input_is_smoothed, PREWITT_OPERATOR, 11, 3);
+
+	validateEdgeSegments();
+}
+
 void EDPF::validateEdgeSegments()
 {
 	divForTestSegment = 2.25; // Some magic number :-)
 	memset(edgeImg, 0, width * height); // clear edge image
 
-	H = new double[MAX_GRAD_VALUE];
-	memset(H, 0, sizeof(double) * MAX_GRAD_VALUE);
+	HBuffer.assign(MAX_GRAD_VALUE, 0.0);
+	H = HBuffer.data();
 
 	gradImg = ComputePrewitt3x3();
 
@@ -64,22 +77,22 @@ void EDPF::validateEdgeSegments()
 	} //end-for
 
 	ExtractNewSegments();
-
-	// clean space		  
-	delete[] H;
-	delete[] gradImg;
 }
 
 short* EDPF::ComputePrewitt3x3()
 {
-	short* gradImg = new short[width * height];
-	memset(gradImg, 0, sizeof(short) * width * height);
+	prewittBuffer.assign(width * height, 0);
+	short* gradImg = prewittBuffer.data();
 
-	int* grads = new int[MAX_GRAD_VALUE];
-	memset(grads, 0, sizeof(int) * MAX_GRAD_VALUE);
+	gradsBuffer.assign(MAX_GRAD_VALUE, 0);
+	int* grads = gradsBuffer.data();
 
 	for (int i = 1; i < height - 1; i++) {
-		for (int j = 1; j < width - 1; j++) {
+		int j = ComputeGradientSumRow(&srcImg[(i - 1) * width], &srcImg[i * width], &srcImg[(i + 1) * width], width, 1, &gradImg[i * width]);
+		for (int k = 1; k < j; k++)
+			grads[gradImg[i * width + k]]++;
+
+		for (; j < width - 1; j++) {
 			// Prewitt Operator in horizontal and vertical direction
 			// A B C
 			// D x E
@@ -115,7 +128,6 @@ short* EDPF::ComputePrewitt3x3()
 	for (int i = 0; i < MAX_GRAD_VALUE; i++)
 		H[i] = (double)grads[i] / ((double)size);
 
-	delete[] grads;
 	return gradImg;
 }
 
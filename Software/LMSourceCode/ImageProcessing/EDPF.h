@@ -38,12 +38,23 @@ public:
 	EDPF(cv::Mat srcImage);
 	EDPF(ED obj);
 	EDPF(EDColor obj);
+	EDPF();
+
+	// Reusable-engine form of EDPF(Mat).  See ED::Detect.  Unlike the constructor, this
+	// does not re-smooth the image after detection, so getSmoothImage() returns the
+	// image that the edges were detected on.
+	void Detect(const cv::Mat& image, const cv::Rect& roi = cv::Rect(), bool input_is_smoothed = false);
 private:
 	double divForTestSegment;
 	double* H;
 	int np;
 	short* gradImg;
 
+	// Working buffers, kept between calls to Detect
+	std::vector<double> HBuffer;
+	std::vector<short> prewittBuffer;
+	std::vector<int> gradsBuffer;
+
 	void validateEdgeSegments();
 	short* ComputePrewitt3x3(); // differs from base class's prewit function (calculates H)
 	void TestSegment(int i, int index1, int index2);
@@ -14,6 +14,12 @@ http://dx.doi.org/10.1016/j.patcog.2014.05.012.
 
 #include "EllipseDetectorYaed.h"
 #include "logging_tools.h"
+#include "worker_thread.h"
+
+#include <array>
+#include <atomic>
+#include <future>
+#include <memory>
 
 namespace golf_sim {
 
@@ -32,6 +38,10 @@ CEllipseDetectorYaed::CEllipseDetectorYaed(void) : _times(6, 0.0), _timesHelper(
 	_fMinReliability = 0.4f;
 	_uNs = 16;
 
+	_bParallelTriplets = false;
+	_bTimingEnabled = true;
+	ClearArcAnnulus();
+
 	srand(unsigned(time(nullptr)));
 }
 
@@ -67,6 +77,160 @@ void CEllipseDetectorYaed::SetParameters(Size	szPreProcessingGaussKernelSize,
 
 }
 
+void CEllipseDetectorYaed::SetArcAnnulus(Point2f center, float fInnerRadius, float fOuterRadius)
+{
+	_ptArcAnnulusCenter = center;
+	_fArcAnnulusInnerRadius = max(0.0f, fInnerRadius);
+	_fArcAnnulusOuterRadius = fOuterRadius;
+}
+
+void CEllipseDetectorYaed::ClearArcAnnulus()
+{
+	_ptArcAnnulusCenter = Point2f(0.0f, 0.0f);
+	_fArcAnnulusInnerRadius = 0.0f;
+	_fArcAnnulusOuterRadius = 0.0f;
+}
+
+// Sizes the accumulators for _szImg and empties the arc and center buffers, keeping their memory
+void CEllipseDetectorYaed::PrepareWorkingBuffers()
+{
+	// Initialize accumulator dimensions
+	ACC_N_SIZE = 101;
+	ACC_R_SIZE = 180;
+	ACC_A_SIZE = max(_szImg.height, _szImg.width);
+
+	_points_1.clear();
+	_points_2.clear();
+	_points_3.clear();
+	_points_4.clear();
+
+	_tripletWorkspaces.resize(_bParallelTriplets ? 4 : 1);
+
+	for (TripletWorkspace& ws : _tripletWorkspaces)
+	{
+		// FindEllipses clears the accumulators before each use
+		ws.accN.resize(ACC_N_SIZE);
+		ws.accR.resize(ACC_R_SIZE);
+		ws.accA.resize(ACC_A_SIZE);
+		ws.centers.clear();
+		ws.ellipses.clear();
+	}
+}
+
+void CEllipseDetectorYaed::RunTripletFamily(int iFamily, TripletWorkspace& ws)
+{
+	switch (iFamily)
+	{
+	case 0: Triplets124(_points_1, _points_2, _points_4, ws); break;
+	case 1: Triplets231(_points_2, _points_3, _points_1, ws); break;
+	case 2: Triplets342(_points_3, _points_4, _points_2, ws); break;
+	case 3: Triplets413(_points_4, _points_1, _points_3, ws); break;
+	}
+}
+
+void CEllipseDetectorYaed::FindTriplets(vector<Ellipse>& ellipses)
+{
+	if (!_bParallelTriplets)
+	{
+		TripletWorkspace& ws = _tripletWorkspaces[0];
+		for (int iFamily = 0; iFamily < 4; ++iFamily)
+		{
+			RunTripletFamily(iFamily, ws);
+		}
+		ellipses.insert(ellipses.end(), ws.ellipses.begin(), ws.ellipses.end());
+		return;
+	}
+
+	_bTimingEnabled = false;
+	_times[3] = _times[4] = 0.0;
+
+	// Whichever thread claims a family first runs it.  This thread runs any family that
+	// no pool thread has started yet, so it never waits on a task that is still queued
+	// (e.g., behind the task that is calling this).
+	auto claimed = std::make_shared<std::array<std::atomic<bool>, 4>>();
+	for (std::atomic<bool>& flag : *claimed)
+	{
+		flag = false;
+	}
+
+	std::array<std::future<void>, 4> futures;
+	for (int iFamily = 1; iFamily < 4; ++iFamily)
+	{
+		futures[iFamily] = GsThreadPool::GetSharedPool().Submit([this, claimed, iFamily]() {
+			if (!(*claimed)[iFamily].exchange(true))
+			{
+				RunTripletFamily(iFamily, _tripletWorkspaces[iFamily]);
+			}
+		});
+	}
+
+	std::array<bool, 4> ranHere{};
+	for (int iFamily = 0; iFamily < 4; ++iFamily)
+	{
+		if (!(*claimed)[iFamily].exchange(true))
+		{
+			RunTripletFamily(iFamily, _tripletWorkspaces[iFamily]);
+			ranHere[iFamily] = true;
+		}
+	}
+
+	for (int iFamily = 1; iFamily < 4; ++iFamily)
+	{
+		if (!ranHere[iFamily])
+		{
+			futures[iFamily].get();
+		}
+	}
+
+	_bTimingEnabled = true;
+
+	// Merged in the serial order
+	for (const TripletWorkspace& ws : _tripletWorkspaces)
+	{
+		ellipses.insert(ellipses.end(), ws.ellipses.begin(), ws.ellipses.end());
+	}
+}
+
+// Clears the edge points of D that are outside the arc annulus, if there is one
+void CEllipseDetectorYaed::MaskToArcAnnulus(cv::Mat& D)
+{
+	if (_fArcAnnulusOuterRadius <= 0.0f)
+		return;
+
+	const float fOuter2 = _fArcAnnulusOuterRadius * _fArcAnnulusOuterRadius;
+	const float fInner2 = _fArcAnnulusInnerRadius * _fArcAnnulusInnerRadius;
+	const float xc = _ptArcAnnulusCenter.x;
+
+	for (int i = 0; i < D.rows; ++i)
+	{
+		uchar* _d = D.ptr<uchar>(i);
+		float dy = float(i) - _ptArcAnnulusCenter.y;
+		float dy2 = dy * dy;
+
+		if (dy2 > fOuter2)
+		{
+			memset(_d, 0, D.cols);
+			continue;
+		}
+
+		// Keep [iLeft, iRight)
+		float fHalfOuter = sqrt(fOuter2 - dy2);
+		int iLeft = max(0, min(D.cols, int(ceil(xc - fHalfOuter))));
+		int iRight = max(iLeft, min(D.cols, int(floor(xc + fHalfOuter)) + 1));
+		memset(_d, 0, iLeft);
+		memset(_d + iRight, 0, D.cols - iRight);
+
+		if (dy2 < fInner2)
+		{
+			// Clear [iInnerLeft, iInnerRight), strictly inside the inner radius
+			float fHalfInner = sqrt(fInner2 - dy2);
+			int iInnerLeft = max(0, min(D.cols, int(floor(xc - fHalfInner)) + 1));
+			int iInnerRight = max(iInnerLeft, min(D.cols, int(ceil(xc + fHalfInner))));
+			memset(_d + iInnerLeft, 0, iInnerRight - iInnerLeft);
+		}
+	}
+}
+
 uint inline CEllipseDetectorYaed::GenerateKey(uchar pair, ushort u, ushort v)
 {
 	return (pair << 30) + (u << 15) + v;
@@ -423,6 +587,8 @@ void CEllipseDetectorYaed::GetFastCenter(vector<Point>& e1, vector<Point>& e2, E
 
 void CEllipseDetectorYaed::DetectEdges13(cv::Mat& DP, VVP& points_1, VVP& points_3)
 {
+	MaskToArcAnnulus(DP);
+
 	// Vector of connected edge points
 	VVP contours;
 
@@ -473,11 +639,11 @@ void CEllipseDetectorYaed::DetectEdges13(cv::Mat& DP, VVP& points_1, VVP& points
 
 		if (iCountBottom > iCountTop)
 		{	//1
-			points_1.push_back(edgeSegment);
+			points_1.push_back(std::move(edgeSegment));
 		}
 		else if (iCountBottom < iCountTop)
 		{	//3
-			points_3.push_back(edgeSegment);
+			points_3.push_back(std::move(edgeSegment));
 		}
 	}
 };
@@ -485,6 +651,8 @@ void CEllipseDetectorYaed::DetectEdges13(cv::Mat& DP, VVP& points_1, VVP& points
 
 void CEllipseDetectorYaed::DetectEdges24(cv::Mat& DN, VVP& points_2, VVP& points_4 )
 {
+	MaskToArcAnnulus(DN);
+
 	// Vector of connected edge points
 	VVP contours;
 
@@ -539,12 +707,12 @@ void CEllipseDetectorYaed::DetectEdges24(cv::Mat& DN, VVP& points_2, VVP& points
 		if (iCountBottom > iCountTop)
 		{
 			//2
-			points_2.push_back(edgeSegment);
+			points_2.push_back(std::move(edgeSegment));
 		}
 		else if (iCountBottom < iCountTop)
 		{
 			//4
-			points_4.push_back(edgeSegment);
+			points_4.push_back(std::move(edgeSegment));
 		}
 	}
 };
@@ -556,9 +724,14 @@ void CEllipseDetectorYaed::FindEllipses(	Point2f& center,
 											VP& edge_k,
 											EllipseData& data_ij,
 											EllipseData& data_ik,
-											vector<Ellipse>& ellipses
+											TripletWorkspace& ws
 										)
 {
+	vector<Ellipse>& ellipses = ws.ellipses;
+	int* accN = ws.accN.data();
+	int* accR = ws.accR.data();
+	int* accA = ws.accA.data();
+
 	// Find ellipse parameters
 
 	// 0-initialize accumulators
@@ -1065,10 +1238,11 @@ Point2f CEllipseDetectorYaed::GetCenterCoordinates(EllipseData& data_ij, Ellipse
 void CEllipseDetectorYaed::Triplets124(VVP& pi,
 	VVP& pj,
 	VVP& pk,
-	unordered_map<uint, EllipseData>& data,
-	vector<Ellipse>& ellipses
+	TripletWorkspace& ws
 	)
 {
+	unordered_map<uint, EllipseData>& data = ws.centers;
+
 	// get arcs length
 	ushort sz_i = ushort(pi.size());
 	ushort sz_j = ushort(pj.size());
@@ -1187,7 +1361,7 @@ void CEllipseDetectorYaed::Triplets124(VVP& pi,
 				Point2f center = GetCenterCoordinates(data_ij, data_ik);
 
 				// Find remaining paramters (A,B,rho)
-				FindEllipses(center, edge_i, edge_j, edge_k, data_ij, data_ik, ellipses);
+				FindEllipses(center, edge_i, edge_j, edge_k, data_ij, data_ik, ws);
 			}
 		}
 	}
@@ -1198,10 +1372,11 @@ void CEllipseDetectorYaed::Triplets124(VVP& pi,
 void CEllipseDetectorYaed::Triplets231(VVP& pi,
 	VVP& pj,
 	VVP& pk,
-	unordered_map<uint, EllipseData>& data,
-	vector<Ellipse>& ellipses
+	TripletWorkspace& ws
 	)
 {
+	unordered_map<uint, EllipseData>& data = ws.centers;
+
 	ushort sz_i = ushort(pi.size());
 	ushort sz_j = ushort(pj.size());
 	ushort sz_k = ushort(pk.size());
@@ -1307,7 +1482,7 @@ void CEllipseDetectorYaed::Triplets231(VVP& pi,
 				// Find ellipse parameters
 				Point2f center = GetCenterCoordinates(data_ij, data_ik);
 
-				FindEllipses(center, edge_i, edge_j, edge_k, data_ij, data_ik, ellipses);
+				FindEllipses(center, edge_i, edge_j, edge_k, data_ij, data_ik, ws);
 
 			}
 		}
@@ -1318,10 +1493,11 @@ void CEllipseDetectorYaed::Triplets231(VVP& pi,
 void CEllipseDetectorYaed::Triplets342(VVP& pi,
 	VVP& pj,
 	VVP& pk,
-	unordered_map<uint, EllipseData>& data,
-	vector<Ellipse>& ellipses
+	TripletWorkspace& ws
 	)
 {
+	unordered_map<uint, EllipseData>& data = ws.centers;
+
 	ushort sz_i = ushort(pi.size());
 	ushort sz_j = ushort(pj.size());
 	ushort sz_k = ushort(pk.size());
@@ -1429,7 +1605,7 @@ void CEllipseDetectorYaed::Triplets342(VVP& pi,
 #endif
 				// Find ellipse parameters
 				Point2f center = GetCenterCoordinates(data_ij, data_ik);
-				FindEllipses(center, edge_i, edge_j, edge_k, data_ij, data_ik, ellipses);
+				FindEllipses(center, edge_i, edge_j, edge_k, data_ij, data_ik, ws);
 			}
 		}
 
@@ -1441,10 +1617,11 @@ void CEllipseDetectorYaed::Triplets342(VVP& pi,
 void CEllipseDetectorYaed::Triplets413(VVP& pi,
 	VVP& pj,
 	VVP& pk,
-	unordered_map<uint, EllipseData>& data,
-	vector<Ellipse>& ellipses
+	TripletWorkspace& ws
 	)
 {
+	unordered_map<uint, EllipseData>& data = ws.centers;
+
 		ushort sz_i = ushort(pi.size());
 		ushort sz_j = ushort(pj.size());
 		ushort sz_k = ushort(pk.size());
@@ -1543,7 +1720,7 @@ void CEllipseDetectorYaed::Triplets413(VVP& pi,
 					// Find ellipse parameters
 					Point2f center = GetCenterCoordinates(data_ij, data_ik);
 
-					FindEllipses(center, edge_i, edge_j, edge_k, data_ij, data_ik, ellipses);
+					FindEllipses(center, edge_i, edge_j, edge_k, data_ij, data_ik, ws);
 
 				}
 			}
@@ -1636,8 +1813,12 @@ void CEllipseDetectorYaed::DetectAfterPreProcessing(vector<Ellipse>& ellipses, c
 	_szImg = E.size();
 
 	// Initialize temporary data structures
-	cv::Mat DP = cv::Mat::zeros(_szImg, E.type());		// arcs along positive diagonal
-	cv::Mat DN = cv::Mat::zeros(_szImg, E.type());		// arcs along negative diagonal
+	_DP.create(_szImg);
+	_DP.setTo(0);
+	_DN.create(_szImg);
+	_DN.setTo(0);
+	cv::Mat DP = _DP;		// arcs along positive diagonal
+	cv::Mat DN = _DN;		// arcs along negative diagonal
 
 	// For each edge points, compute the edge direction
 	for (int i = 0; i<_szImg.height; ++i)
@@ -1660,38 +1841,23 @@ void CEllipseDetectorYaed::DetectAfterPreProcessing(vector<Ellipse>& ellipses, c
 		}
 	}
 
-	// Initialize accumulator dimensions
-	ACC_N_SIZE = 101;
-	ACC_R_SIZE = 180;
-	ACC_A_SIZE = max(_szImg.height, _szImg.width);
+	PrepareWorkingBuffers();
 
-	// Allocate accumulators
-	accN = new int[ACC_N_SIZE];
-	accR = new int[ACC_R_SIZE];
-	accA = new int[ACC_A_SIZE];
-
-	// Other temporary 
-	VVP points_1, points_2, points_3, points_4;		//vector of points, one for each convexity class
-	unordered_map<uint, EllipseData> centers;		//hash map for reusing already computed EllipseData
+	VVP& points_1 = _points_1;
+	VVP& points_2 = _points_2;
+	VVP& points_3 = _points_3;
+	VVP& points_4 = _points_4;
 
 	// Detect edges and find convexities
 	DetectEdges13(DP, points_1, points_3);
 	DetectEdges24(DN, points_2, points_4);
 
 	// Find triplets
-	Triplets124(points_1, points_2, points_4, centers, ellipses);
-	Triplets231(points_2, points_3, points_1, centers, ellipses);
-	Triplets342(points_3, points_4, points_2, centers, ellipses);
-	Triplets413(points_4, points_1, points_3, centers, ellipses);
+	FindTriplets(ellipses);
 
 	// Sort detected ellipses with respect to score
 	sort(ellipses.begin(), ellipses.end());
 
-	//free accumulator memory
-	delete[] accN;
-	delete[] accR;
-	delete[] accA;
-
 	//cluster detections
 	//ClusterEllipses(ellipses);
 };
@@ -1711,22 +1877,19 @@ void CEllipseDetectorYaed::Detect(cv::Mat& I, vector<Ellipse>& ellipses)
 	cv::Mat DP = cv::Mat::zeros(_szImg, CV_8S);		// arcs along positive diagonal
 	cv::Mat DN = cv::Mat::zeros(_szImg, CV_8S);		// arcs along negative diagonal
 	*/
-	Mat1b DP = Mat1b::zeros(_szImg);		// arcs along positive diagonal
-	Mat1b DN = Mat1b::zeros(_szImg);		// arcs along negative diagonal
+	_DP.create(_szImg);
+	_DP.setTo(0);
+	_DN.create(_szImg);
+	_DN.setTo(0);
+	Mat1b& DP = _DP;		// arcs along positive diagonal
+	Mat1b& DN = _DN;		// arcs along negative diagonal
 
-	// Initialize accumulator dimensions
-	ACC_N_SIZE = 101;
-	ACC_R_SIZE = 180;
-	ACC_A_SIZE = max(_szImg.height, _szImg.width);
-
-	// Allocate accumulators
-	accN = new int[ACC_N_SIZE];
-	accR = new int[ACC_R_SIZE];
-	accA = new int[ACC_A_SIZE];
+	PrepareWorkingBuffers();
 
-	// Other temporary 
-	VVP points_1, points_2, points_3, points_4;		//vector of points, one for each convexity class
-	unordered_map<uint, EllipseData> centers;		//hash map for reusing already computed EllipseData
+	VVP& points_1 = _points_1;
+	VVP& points_2 = _points_2;
+	VVP& points_3 = _points_3;
+	VVP& points_4 = _points_4;
 
 	Toc(1); //prepare data structure
 
@@ -1744,49 +1907,49 @@ void CEllipseDetectorYaed::Detect(cv::Mat& I, vector<Ellipse>& ellipses)
 	Toc(1); //preprocessing
 
 
-	// DEBUG
-	Mat3b out(I.rows, I.cols, Vec3b(0,0,0));
-	for(unsigned i=0; i<points_1.size(); ++i)
+	// DEBUG - only built if it will be shown
+	if (golf_sim::LoggingTools::DisplayIntermediateImages())
 	{
-		//Vec3b color(rand()%255, 128+rand()%127, 128+rand()%127);
-		Vec3b color(255,0,0);
-		for(unsigned j=0; j<points_1[i].size(); ++j)
-			out(points_1[i][j]) = color;
-	}
+		Mat3b out(I.rows, I.cols, Vec3b(0,0,0));
+		for(unsigned i=0; i<points_1.size(); ++i)
+		{
+			//Vec3b color(rand()%255, 128+rand()%127, 128+rand()%127);
+			Vec3b color(255,0,0);
+			for(unsigned j=0; j<points_1[i].size(); ++j)
+				out(points_1[i][j]) = color;
+		}
 
-	for(unsigned i=0; i<points_2.size(); ++i)
-	{
-		//Vec3b color(rand()%255, 128+rand()%127, 128+rand()%127);
-		Vec3b color(0,255,0);
-		for(unsigned j=0; j<points_2[i].size(); ++j)
-			out(points_2[i][j]) = color;
-	}
-	for(unsigned i=0; i<points_3.size(); ++i)
-	{
-		//Vec3b color(rand()%255, 128+rand()%127, 128+rand()%127);
-		Vec3b color(0,0,255);
-		for(unsigned j=0; j<points_3[i].size(); ++j)
-			out(points_3[i][j]) = color;
-	}
+		for(unsigned i=0; i<points_2.size(); ++i)
+		{
+			//Vec3b color(rand()%255, 128+rand()%127, 128+rand()%127);
+			Vec3b color(0,255,0);
+			for(unsigned j=0; j<points_2[i].size(); ++j)
+				out(points_2[i][j]) = color;
+		}
+		for(unsigned i=0; i<points_3.size(); ++i)
+		{
+			//Vec3b color(rand()%255, 128+rand()%127, 128+rand()%127);
+			Vec3b color(0,0,255);
+			for(unsigned j=0; j<points_3[i].size(); ++j)
+				out(points_3[i][j]) = color;
+		}
 
-	for(unsigned i=0; i<points_4.size(); ++i)
-	{
-		//Vec3b color(rand()%255, 128+rand()%127, 128+rand()%127);
-		Vec3b color(255,0,255);
-		for(unsigned j=0; j<points_4[i].size(); ++j)
-			out(points_4[i][j]) = color;
-	}
+		for(unsigned i=0; i<points_4.size(); ++i)
+		{
+			//Vec3b color(rand()%255, 128+rand()%127, 128+rand()%127);
+			Vec3b color(255,0,255);
+			for(unsigned j=0; j<points_4[i].size(); ++j)
+				out(points_4[i][j]) = color;
+		}
 
-	golf_sim::LoggingTools::DebugShowImage("out", out);
+		golf_sim::LoggingTools::DebugShowImage("out", out);
+	}
 
 	// time estimation, validation  inside
 
 	Tic(2); //grouping
 	//find triplets
-	Triplets124(points_1, points_2, points_4, centers, ellipses);
-	Triplets231(points_2, points_3, points_1, centers, ellipses);
-	Triplets342(points_3, points_4, points_2, centers, ellipses);
-	Triplets413(points_4, points_1, points_3, centers, ellipses);
+	FindTriplets(ellipses);
 	Toc(2); //grouping	
 	// time estimation, validation inside
 	_times[2] -= (_times[3] + _times[4]);
@@ -1796,11 +1959,6 @@ void CEllipseDetectorYaed::Detect(cv::Mat& I, vector<Ellipse>& ellipses)
 	sort(ellipses.begin(), ellipses.end());
 	Toc(4); //validation
 
-	// Free accumulator memory
-	delete[] accN;
-	delete[] accR;
-	delete[] accA;
-
 	Tic(5);
 	// Cluster detections
 	ClusterEllipses(ellipses);
@@ -114,9 +114,37 @@ class CEllipseDetectorYaed
 	int ACC_R_SIZE;			// size of accumulator R = rho = atan(K)
 	int ACC_A_SIZE;			// size of accumulator A
 
-	int* accN;				// pointer to accumulator N
-	int* accR;				// pointer to accumulator R
-	int* accA;				// pointer to accumulator A
+	// Everything that a family of triplets (e.g., Triplets124) writes to while it runs.
+	// In serial mode, one workspace is shared by all four families.  In parallel mode,
+	// each family has its own.  The centers are only a cache of values that depend on
+	// nothing but the pair of arcs, so not sharing them does not change the results.
+	struct TripletWorkspace
+	{
+		vector<int> accN;	// accumulator N
+		vector<int> accR;	// accumulator R
+		vector<int> accA;	// accumulator A
+		unordered_map<uint, EllipseData> centers;	// for reusing already computed EllipseData
+		vector<Ellipse> ellipses;
+	};
+
+	// Working buffers.  They are kept between calls, so that a long-lived detector
+	// does not re-allocate them for each image.
+	Mat1b	_DP;			// arcs along positive diagonal
+	Mat1b	_DN;			// arcs along negative diagonal
+	VVP		_points_1, _points_2, _points_3, _points_4;	// one for each convexity class
+	vector<TripletWorkspace> _tripletWorkspaces;
+
+	// If set, the four families of triplets are evaluated at the same time on the shared thread pool
+	bool	_bParallelTriplets;
+
+	// Cleared while the triplets are evaluated in parallel, as the timers are not thread-safe
+	bool	_bTimingEnabled;
+
+	// Optional annulus outside of which edge points are not considered as arcs.
+	// Inactive if _fArcAnnulusOuterRadius <= 0.
+	Point2f	_ptArcAnnulusCenter;
+	float	_fArcAnnulusInnerRadius;
+	float	_fArcAnnulusOuterRadius;
 
 public:
 
@@ -145,6 +173,14 @@ public:
 							int     iNs
 						);
 
+	// Restricts DetectEdges13/24 to edge points between fInnerRadius and fOuterRadius (inclusive)
+	// of center, in input image coordinates.  Stays in effect until changed or cleared.
+	void SetArcAnnulus(Point2f center, float fInnerRadius, float fOuterRadius);
+	void ClearArcAnnulus();
+
+	// The ellipses found are the same, and in the same order, either way
+	void SetParallelTriplets(bool bParallelTriplets) { _bParallelTriplets = bParallelTriplets; }
+
 	// Return the execution time
 	double GetExecTime() { return _times[0] + _times[1] + _times[2] + _times[3] + _times[4] + _times[5]; }
 	vector<double> GetTimes() { return _times; }
@@ -178,6 +214,9 @@ private:
 	void GetFastCenter	(vector<Point>& e1, vector<Point>& e2, EllipseData& data);
 	
 
+	void PrepareWorkingBuffers();
+	void MaskToArcAnnulus(cv::Mat& D);
+
 	void DetectEdges13(cv::Mat& DP, VVP& points_1, VVP& points_3);
 	void DetectEdges24(cv::Mat& DN, VVP& points_2, VVP& points_4);
 
@@ -187,7 +226,7 @@ private:
 							VP& edge_k,
 							EllipseData& data_ij,
 							EllipseData& data_ik,
-							vector<Ellipse>& ellipses
+							TripletWorkspace& ws
 						);
 
 	Point2f GetCenterCoordinates(EllipseData& data_ij, EllipseData& data_ik);
@@ -195,48 +234,51 @@ private:
 
 	
 
+	// Runs the four families of triplets over _points_1.._4 and appends what they find to ellipses
+	void FindTriplets(vector<Ellipse>& ellipses);
+	void RunTripletFamily(int iFamily, TripletWorkspace& ws);
+
 	void Triplets124	(	VVP& pi,
 							VVP& pj,
 							VVP& pk,
-							unordered_map<uint, EllipseData>& data,
-							vector<Ellipse>& ellipses
+							TripletWorkspace& ws
 						);
 
 	void Triplets231	(	VVP& pi,
 							VVP& pj,
 							VVP& pk,
-							unordered_map<uint, EllipseData>& data,
-							vector<Ellipse>& ellipses
+							TripletWorkspace& ws
 						);
 
 	void Triplets342	(	VVP& pi,
 							VVP& pj,
 							VVP& pk,
-							unordered_map<uint, EllipseData>& data,
-							vector<Ellipse>& ellipses
+							TripletWorkspace& ws
 						);
 
 	void Triplets413	(	VVP& pi,
 							VVP& pj,
 							VVP& pk,
-							unordered_map<uint, EllipseData>& data,
-							vector<Ellipse>& ellipses
+							TripletWorkspace& ws
 						);
 
 	void Tic(unsigned idx) //start
 	{
+		if (!_bTimingEnabled) return;
 		_timesHelper[idx] = 0.0;
 		_times[idx] = (double)cv::getTickCount();
 	};
 
 	void Tac(unsigned idx) //restart
 	{
+		if (!_bTimingEnabled) return;
 		_timesHelper[idx] = _times[idx];
 		_times[idx] = (double)cv::getTickCount();
 	};
 
 	void Toc(unsigned idx) //stop
 	{
+		if (!_bTimingEnabled) return;
 		_times[idx] = ((double)cv::getTickCount() - _times[idx])*1000. / cv::getTickFrequency();
 		_times[idx] += _timesHelper[idx];
 	};
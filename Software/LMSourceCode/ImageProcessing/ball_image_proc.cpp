@@ -13,9 +13,19 @@
 
 #include <ranges>
 #include <algorithm>
+#include <functional>
 #include <vector>
+#include <map>
+#include <array>
+#include <limits>
+#include <deque>
+#include <tuple>
 #include <chrono>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <memory>
+#include <filesystem>
 #include <omp.h>
 #include "gs_format_lib.h"
 
@@ -26,10 +36,31 @@
 #include <opencv2/calib3d.hpp>
 #include <opencv2/core/cvdef.h>
 
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GS_USE_NEON_ROTATION_COMPARE
+#define GS_USE_NEON_GABOR
+#endif
+
 #include "ball_image_proc.h"
+#include "gs_hot_kernel.h"
+#include "gs_shot_analysis.h"
+#include "gs_pixel_kernels.h"
+#include "gs_scratch_pool.h"
+#include "gs_gpu_spin_search.h"
 #include "spin_predictor.hpp"
 #include "logging_tools.h"
 #include "cv_utils.h"
+#include "gs_color_statistics.h"
+#include "gs_circle_grid_index.h"
+#include "gs_ternary_image.h"
+#include "gs_metrics.h"
+#include "gs_trace_zones.h"
+#include "gs_memory_footprint.h"
+#ifdef __unix__
+#include "gs_performance_profile.h"
+#endif
+#include "worker_thread.h"
 #include "gs_config.h"
 #include "gs_options.h"
 #include "gs_ui_system.h"
@@ -81,6 +112,22 @@ namespace golf_sim {
     int BallImageProc::kCoarseZRotationDegreesStart = -50;
     int BallImageProc::kCoarseZRotationDegreesEnd = 60;
     int BallImageProc::kCoarseSearchResolution = 90;
+    int BallImageProc::kSpinPatchResolution = 0;
+
+    bool BallImageProc::kSpinSearchUseHierarchical = false;
+    int BallImageProc::kSpinSearchTopKCandidates = 3;
+    bool BallImageProc::kSpinSearchUseEarlyTermination = true;
+    std::string BallImageProc::kSpinSearchCacheDirectory = "";
+    std::string BallImageProc::kSpinScoreSurfaceDirectory = "";
+    bool BallImageProc::kSpinSearchUseRemapTables = true;
+    double BallImageProc::kSpinSearchRemapRadiusQuantum = 1.0;
+    bool BallImageProc::kSpinSearchUseBitPackedImages = true;
+    bool BallImageProc::kSpinSearchUseGpu = false;
+    int BallImageProc::kSpinSearchTimeBudgetMs = 0;
+    bool BallImageProc::kSpinSearchUseOptimizer = false;
+    int BallImageProc::kSpinOptimizerStarts = 4;
+    int BallImageProc::kSpinOptimizerMaxEvaluations = 160;
+    int BallImageProc::kSpinOptimizerSeedSpacingFactor = 3;
 
     double BallImageProc::kPlacedBallCannyLower;
     double BallImageProc::kPlacedBallCannyUpper;
@@ -155,6 +202,23 @@ namespace golf_sim {
 
     bool BallImageProc::kUseDynamicRadiiAdjustment = true;
     int BallImageProc::kNumberRadiiToAverageForDynamicAdjustment = 3;
+    bool BallImageProc::kUseHoughParameterMemory = false;
+    bool BallImageProc::kUsePyramidHoughSearch = false;
+    bool BallImageProc::kUseParallelEllipseTriplets = false;
+    bool BallImageProc::kUseEllipseArcAnnulus = false;
+    double BallImageProc::kEllipseArcAnnulusInnerRadiusRatio = 0.5;
+
+    // A remembered param2 is only re-used if the search radii are within this fraction
+    // of the ones it was found with, i.e., the ball is about the same size in the image
+    static const double kHoughParameterMemoryRadiusTolerance = 0.25;
+
+    // The pyramid search is skipped if the smallest radius would be fewer pixels than this
+    // in the downsampled image
+    static const int kPyramidHoughMinDownsampledRadius = 6;
+
+    std::array<BallImageProc::HoughParameterMemory, BallImageProc::kPutting + 1> BallImageProc::hough_parameter_memory_;
+    std::mutex BallImageProc::hough_parameter_memory_mutex_;
+
     double BallImageProc::kStrobedNarrowingRadiiMinRatio = 0.8;
     double BallImageProc::kStrobedNarrowingRadiiMaxRatio = 1.2;
     double BallImageProc::kStrobedNarrowingRadiiDpParam = 1.8;
@@ -177,6 +241,8 @@ namespace golf_sim {
 
     bool BallImageProc::kUseBestCircleRefinement = false;
     bool BallImageProc::kUseBestCircleLargestCircle = false;
+    bool BallImageProc::kUseFastEllipseRefinement = false;
+    int BallImageProc::kFastEllipseRansacIterations = 64;
 
     double BallImageProc::kBestCircleCannyLower = 55;
     double BallImageProc::kBestCircleCannyUpper = 110;
@@ -203,7 +269,11 @@ namespace golf_sim {
 
     int BallImageProc::kGaborMaxWhitePercent = 44; // Nominal 46;
     int BallImageProc::kGaborMinWhitePercent = 38; // Nominal 40;
+    bool BallImageProc::kGaborUseFixedPoint = false;
     std::string BallImageProc::kSpinDetectionMethod = "ml";
+    int BallImageProc::kSpinHybridSearchWindowDegrees = 4;
+    std::string BallImageProc::kSpinDimpleEdgeModelPath = "";
+    float BallImageProc::kSpinDimpleEdgeThreshold = 0.5f;
 
     // Model Detection Configuration
     std::string BallImageProc::kStrobedBallDetectionMethod = "experimental";
@@ -218,33 +288,85 @@ namespace golf_sim {
     int BallImageProc::kModelInputWidth = 736;
     int BallImageProc::kModelInputHeight = 544;
     int BallImageProc::kInferenceThreads = 4;
+    std::string BallImageProc::kModelVariant = "auto";
+    int BallImageProc::kModelPlacementInputWidth = 0;
+    int BallImageProc::kModelPlacementInputHeight = 0;
+    bool BallImageProc::kModelUseTiledDetection = false;
+    double BallImageProc::kModelTiledCorridorTopFraction = 0.0;
+    double BallImageProc::kModelTiledCorridorBottomFraction = 1.0;
+    int BallImageProc::kModelTileOverlapPixels = 96;
+    bool BallImageProc::kModelHasSequenceOutputs = false;
+    float BallImageProc::kModelSequenceConfidence = 0.8f;
+    bool BallImageProc::kUseSubpixelRadiusRefinement = false;
+    int BallImageProc::kSubpixelRadiusRays = 72;
+    double BallImageProc::kSubpixelRadiusSearchFraction = 0.15;
+    double BallImageProc::kSubpixelRadiusMinimumEdgeStrength = 10.0;
     // NCNN detector
     std::unique_ptr<NCNNDetector> BallImageProc::ncnn_detector_;
+    std::unique_ptr<NCNNDetector> BallImageProc::ncnn_placement_detector_;
     std::atomic<bool> BallImageProc::ncnn_detector_initialized_{false};
     std::mutex BallImageProc::ncnn_detector_mutex_;
 
     std::unique_ptr<SpinPredictor> BallImageProc::spin_predictor_;
+    std::unique_ptr<DimpleEdgeExtractor> BallImageProc::dimple_edge_extractor_;
     std::atomic<bool> BallImageProc::spin_predictor_initialized_{false};
     std::mutex BallImageProc::spin_predictor_mutex_;
 
     BallImageProc::YOLOImageTypeToUse BallImageProc::kImageTypeToProcessWithYOLO = BallImageProc::YOLOImageTypeToUse::kUseYOLOWithColorImages;
 
     BallImageProc* BallImageProc::get_ball_image_processor() {
-        static BallImageProc* ip = nullptr;
-
-        if (ip == nullptr) {
-            ip = new BallImageProc;
-        }
+        // Constructed on first use.  The startup tasks may get here from more than one thread.
+        static BallImageProc* ip = new BallImageProc;
 
         return ip;
     }
 
 
+    // The tuning values and models are shared by every BallImageProc, so only the first one loads them
+    static std::once_flag ball_image_proc_startup_once;
+
     BallImageProc::BallImageProc() {
         min_ball_radius_ = -1;
         max_ball_radius_ = -1;
 
-        // The following constants are only used internal to the GolfSimCamera class, and so can be initialized in the constructor
+        std::call_once(ball_image_proc_startup_once, []() {
+            LoadTuningValues();
+#ifdef __unix__
+            // The tuning values include some of the profile's settings
+            GsPerformanceProfile::ApplySelectedProfile();
+#endif
+            PreloadModels();
+        });
+    }
+
+    void BallImageProc::PreloadModels() {
+
+        // Preload model at startup if using experimental detection for either ball placement or flight
+        if (kStrobedBallDetectionMethod == "experimental" ||
+            kBallPlacementDetectionMethod == "experimental") {
+            GS_LOG_MSG(info, "Detection method is '" + kStrobedBallDetectionMethod + "' / Placement method is '" + kBallPlacementDetectionMethod + "', preloading NCNN model at startup...");
+
+            if (PreloadNCNNModel()) {
+                GS_LOG_MSG(info, "NCNN model preloaded - first detection will be fast");
+            } else {
+                GS_LOG_MSG(warning, "Failed to preload NCNN model");
+            }
+        }
+
+        if (kSpinDetectionMethod == "ml" || kSpinDetectionMethod == "hybrid") {
+            if (PreloadSpinModel()) {
+                GS_LOG_MSG(info, "ML spin model preloaded - spin detection will use ML path");
+            } else {
+                GS_LOG_MSG(warning, "Failed to preload ML spin model - will fall back to rotation search");
+            }
+        }
+    }
+
+    BallImageProc::~BallImageProc() {
+    }
+
+    void BallImageProc::LoadTuningValues() {
+        // The following constants are only used internal to the BallImageProc class
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kCoarseXRotationDegreesIncrement", kCoarseXRotationDegreesIncrement);
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kCoarseXRotationDegreesStart", kCoarseXRotationDegreesStart);
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kCoarseXRotationDegreesEnd", kCoarseXRotationDegreesEnd);
@@ -256,9 +378,28 @@ namespace golf_sim {
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kCoarseZRotationDegreesEnd", kCoarseZRotationDegreesEnd);
 
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kCoarseSearchResolution", kCoarseSearchResolution);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinPatchResolution", kSpinPatchResolution);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchUseHierarchical", kSpinSearchUseHierarchical);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchCacheDirectory", kSpinSearchCacheDirectory);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinScoreSurfaceDirectory", kSpinScoreSurfaceDirectory);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchTopKCandidates", kSpinSearchTopKCandidates);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchUseEarlyTermination", kSpinSearchUseEarlyTermination);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchUseRemapTables", kSpinSearchUseRemapTables);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchRemapRadiusQuantum", kSpinSearchRemapRadiusQuantum);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchUseBitPackedImages", kSpinSearchUseBitPackedImages);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchUseGpu", kSpinSearchUseGpu);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchTimeBudgetMs", kSpinSearchTimeBudgetMs);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchUseOptimizer", kSpinSearchUseOptimizer);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinOptimizerStarts", kSpinOptimizerStarts);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinOptimizerMaxEvaluations", kSpinOptimizerMaxEvaluations);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinOptimizerSeedSpacingFactor", kSpinOptimizerSeedSpacingFactor);
+        kSpinOptimizerStarts = std::max(1, kSpinOptimizerStarts);
+        kSpinOptimizerMaxEvaluations = std::max(kSpinOptimizerStarts, kSpinOptimizerMaxEvaluations);
+        kSpinOptimizerSeedSpacingFactor = std::max(1, kSpinOptimizerSeedSpacingFactor);
 
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kGaborMinWhitePercent", kGaborMinWhitePercent);
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kGaborMaxWhitePercent", kGaborMaxWhitePercent);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kGaborUseFixedPoint", kGaborUseFixedPoint);
 
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kPlacedBallCannyLower", kPlacedBallCannyLower);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kPlacedBallCannyUpper", kPlacedBallCannyUpper);
@@ -351,6 +492,9 @@ namespace golf_sim {
 
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUseBestCircleRefinement", kUseBestCircleRefinement);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUseBestCircleLargestCircle", kUseBestCircleLargestCircle);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUseFastEllipseRefinement", kUseFastEllipseRefinement);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kFastEllipseRansacIterations", kFastEllipseRansacIterations);
+        kFastEllipseRansacIterations = std::max(1, kFastEllipseRansacIterations);
 
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kBestCircleCannyLower", kBestCircleCannyLower);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kBestCircleCannyUpper", kBestCircleCannyUpper);
@@ -366,6 +510,11 @@ namespace golf_sim {
 
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUseDynamicRadiiAdjustment", kUseDynamicRadiiAdjustment);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kNumberRadiiToAverageForDynamicAdjustment", kNumberRadiiToAverageForDynamicAdjustment);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUseHoughParameterMemory", kUseHoughParameterMemory);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUsePyramidHoughSearch", kUsePyramidHoughSearch);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUseParallelEllipseTriplets", kUseParallelEllipseTriplets);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUseEllipseArcAnnulus", kUseEllipseArcAnnulus);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kEllipseArcAnnulusInnerRadiusRatio", kEllipseArcAnnulusInnerRadiusRatio);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kStrobedNarrowingRadiiMinRatio", kStrobedNarrowingRadiiMinRatio);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kStrobedNarrowingRadiiMaxRatio", kStrobedNarrowingRadiiMaxRatio);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kStrobedNarrowingRadiiDpParam", kStrobedNarrowingRadiiDpParam);
@@ -382,31 +531,23 @@ namespace golf_sim {
 
 
         GolfSimConfiguration::SetConstant("gs_config.logging.kLogIntermediateSpinImagesToFile", kLogIntermediateSpinImagesToFile);
+    }
 
-        // Preload model at startup if using experimental detection for either ball placement or flight
-        if (kStrobedBallDetectionMethod == "experimental" ||
-            kBallPlacementDetectionMethod == "experimental") {
-            GS_LOG_MSG(info, "Detection method is '" + kStrobedBallDetectionMethod + "' / Placement method is '" + kBallPlacementDetectionMethod + "', preloading NCNN model at startup...");
+    void BallImageProc::ReloadTuningValues() {
+        LoadConfigurationValues();
+        LoadTuningValues();
 
-            if (PreloadNCNNModel()) {
-                GS_LOG_MSG(info, "NCNN model preloaded - first detection will be fast");
-            } else {
-                GS_LOG_MSG(warning, "Failed to preload NCNN model");
-            }
-        }
+        // The detectors keep their own copy of the thresholds.  Everything else about
+        // them (the model files and input sizes) only changes with a restart.
+        std::lock_guard<std::mutex> lock(ncnn_detector_mutex_);
 
-        if (kSpinDetectionMethod == "ml") {
-            if (PreloadSpinModel()) {
-                GS_LOG_MSG(info, "ML spin model preloaded - spin detection will use ML path");
-            } else {
-                GS_LOG_MSG(warning, "Failed to preload ML spin model - will fall back to rotation search");
+        for (NCNNDetector* detector : { ncnn_detector_.get(), ncnn_placement_detector_.get() }) {
+            if (detector != nullptr) {
+                detector->SetThresholds(kModelConfidenceThreshold, kModelNMSThreshold);
             }
         }
     }
 
-    BallImageProc::~BallImageProc() {
-    }
-
     /**
      * Given a gray-scale image and a ball search mode (e.g., kStrobed), this function applies
      * CLAHE processing to improve the contrast and edge definition of the balls.  It then
@@ -414,10 +555,13 @@ namespace golf_sim {
      * 
      * \param search_image  The image to be processed.
      * \param search_mode  Currently can be only kStrobed or kExternallyStrobed
+     * \param preprocessing  If it has a region of interest, only that part of the image
+     *                       (plus the filters' reach) is processed.  The rest is left as-is.
      * \return True on success.
      */
     bool BallImageProc::PreProcessStrobedImage( cv::Mat& search_image, 
-                                                BallSearchMode search_mode) {
+                                                BallSearchMode search_mode,
+                                                const GsPreprocessingContext& preprocessing) {
 
         GS_LOG_TRACE_MSG(trace, "PreProcessStrobedImage");
 
@@ -447,35 +591,6 @@ namespace golf_sim {
             return false;
         }
 
-        // Create a CLAHE object
-
-        if (use_clahe_processing) {
-            cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE();
-
-            // Set CLAHE parameters
-
-            if (clahe_tiles_grid_size < 1) {
-                clahe_tiles_grid_size = 1;
-                GS_LOG_MSG(warning, "clahe_tiles_grid_size was < 1 - Resetting to 1.");
-            }
-            if (clahe_clip_limit < 1) {
-                clahe_clip_limit = 1;
-                GS_LOG_MSG(warning, "kCLAHEClipLimit was < 1 - Resetting to 1.");
-            }
-
-            GS_LOG_TRACE_MSG(trace, "Using CLAHE Pre-processing with GridSize = " + std::to_string(clahe_tiles_grid_size) +
-                ", ClipLimit = " + std::to_string(clahe_clip_limit));
-
-            clahe->setClipLimit(clahe_clip_limit);
-            clahe->setTilesGridSize(cv::Size(clahe_tiles_grid_size, clahe_tiles_grid_size));
-
-            // Apply CLAHE
-            cv::Mat equalizedImage;
-            clahe->apply(search_image, search_image);
-
-            LoggingTools::DebugShowImage(image_name_ + "  Strobed Ball Image - After CLAHE equalization", search_image);
-        }
-
         double canny_lower = 0.0;
         double canny_upper = 0.0;
         int pre_canny_blur_size = 0;
@@ -515,6 +630,34 @@ namespace golf_sim {
             }
         }
 
+        // Everything below works on just this part of the search image.  The margin covers
+        // the two blurs plus the Canny's 3x3 gradient and non-maximum suppression.
+        const int region_margin = pre_canny_blur_size / 2 + pre_hough_blur_size / 2 + 2;
+        cv::Mat search_region = preprocessing.RegionToProcess(search_image, region_margin);
+
+        if (use_clahe_processing) {
+
+            // Set CLAHE parameters
+
+            if (clahe_tiles_grid_size < 1) {
+                clahe_tiles_grid_size = 1;
+                GS_LOG_MSG(warning, "clahe_tiles_grid_size was < 1 - Resetting to 1.");
+            }
+            if (clahe_clip_limit < 1) {
+                clahe_clip_limit = 1;
+                GS_LOG_MSG(warning, "kCLAHEClipLimit was < 1 - Resetting to 1.");
+            }
+
+            GS_LOG_TRACE_MSG(trace, "Using CLAHE Pre-processing with GridSize = " + std::to_string(clahe_tiles_grid_size) +
+                ", ClipLimit = " + std::to_string(clahe_clip_limit));
+
+            // Apply CLAHE
+            cv::Ptr<cv::CLAHE> clahe = GsPreprocessingContext::Clahe(clahe_clip_limit, clahe_tiles_grid_size);
+            clahe->apply(search_region, search_region);
+
+            LoggingTools::DebugShowImage(image_name_ + "  Strobed Ball Image - After CLAHE equalization", search_image);
+        }
+
 
         GS_LOG_MSG(trace, "Main HoughCircle Image Prep - Performing Pre-Hough Blur and Canny for kStrobed mode.");
         GS_LOG_MSG(trace, "  Blur Parameters are: pre_canny_blur_size = " + std::to_string(pre_canny_blur_size) +
@@ -524,7 +667,7 @@ namespace golf_sim {
 
 
         if (pre_canny_blur_size > 0) {
-            cv::GaussianBlur(search_image, search_image, cv::Size(pre_canny_blur_size, pre_canny_blur_size), 0);
+            cv::GaussianBlur(search_region, search_region, cv::Size(pre_canny_blur_size, pre_canny_blur_size), 0);
         }
         else {
             GS_LOG_TRACE_MSG(trace, "Skipping pre-Canny Blur");
@@ -532,8 +675,8 @@ namespace golf_sim {
 
         // TBD - REMOVED THIS FOR NOW - IT DOESN'T SEEM TO HELP
         for (int i = 0; i < 0; i++) {
-            cv::erode(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
-            cv::dilate(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+            cv::erode(search_region, search_region, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+            cv::dilate(search_region, search_region, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
         }
 
         LoggingTools::DebugShowImage(image_name_ + "  Strobed Ball Image - Ready for Edge Detection", search_image);
@@ -541,22 +684,66 @@ namespace golf_sim {
         cv::Mat cannyOutput_for_balls;
         if (search_mode == kExternallyStrobed || pre_canny_blur_size == 0) {
             // Don't do the Canny at all if the blur size is zero and we're in comparison mode
-            cannyOutput_for_balls = search_image.clone();
+            cannyOutput_for_balls = search_region.clone();
         }
         else {
-            cv::Canny(search_image, cannyOutput_for_balls, canny_lower, canny_upper);
+            cv::Canny(search_region, cannyOutput_for_balls, canny_lower, canny_upper);
         }
 
         LoggingTools::DebugShowImage(image_name_ + "  cannyOutput_for_balls", cannyOutput_for_balls);
 
         // Blur the lines-only image back to the search_image that the code below uses
         if (pre_hough_blur_size > 0) {
-            cv::GaussianBlur(cannyOutput_for_balls, search_image, cv::Size(pre_hough_blur_size, pre_hough_blur_size), 0);   // Nominal is 7x7
+            cv::GaussianBlur(cannyOutput_for_balls, search_region, cv::Size(pre_hough_blur_size, pre_hough_blur_size), 0);   // Nominal is 7x7
         }
 
         return true;
     }
 
+    // Re-fits a circle found on the 2x-downsampled image (but already scaled back up) by
+    // running HoughCircles over a small full-resolution window around it.  The circle
+    // is left alone if nothing close enough is found in the window.
+    static void RefinePyramidHoughCircle(const cv::Mat& full_resolution_image,
+                                         GsCircle& circle,
+                                         const cv::HoughModes hough_mode,
+                                         const double dp,
+                                         const double param1,
+                                         const double param2) {
+        // One downsampled pixel is two full-resolution pixels, so allow a couple of them each way
+        const float kSlop = 4.0f;
+        const float radius = circle[2];
+        const int half_window = (int)std::ceil(radius + 2.0f * kSlop);
+
+        cv::Rect window((int)std::round(circle[0]) - half_window, (int)std::round(circle[1]) - half_window, 2 * half_window, 2 * half_window);
+        window &= cv::Rect(0, 0, full_resolution_image.cols, full_resolution_image.rows);
+
+        if (window.width <= 2 * radius || window.height <= 2 * radius) {
+            // Too close to the edge for a full circle to fit
+            return;
+        }
+
+        std::vector<GsCircle> refined_circles;
+        cv::HoughCircles(full_resolution_image(window),
+            refined_circles,
+            hough_mode,
+            dp,
+            /* minDist = */ (double)half_window,
+            param1,
+            param2,
+            /* minRadius = */ std::max(1, (int)std::floor(radius - kSlop)),
+            /* maxRadius = */ (int)std::ceil(radius + kSlop));
+
+        const cv::Point2f candidate_center(circle[0] - window.x, circle[1] - window.y);
+        float best_distance = kSlop;
+        for (const GsCircle& refined : refined_circles) {
+            const float distance = (float)cv::norm(cv::Point2f(refined[0], refined[1]) - candidate_center);
+            if (distance <= best_distance) {
+                best_distance = distance;
+                circle = GsCircle(refined[0] + window.x, refined[1] + window.y, refined[2]);
+            }
+        }
+    }
+
     // Given a picture, see if we can find the golf ball somewhere in that picture.
     // Should be much more successful if called with a calibrated golf ball so that the code has
     // some hints about where to look.
@@ -569,6 +756,8 @@ namespace golf_sim {
                                 bool chooseLargestFinalBall,
                                 bool report_find_failures) {
 
+        GS_TRACE_ZONE("GetBall");
+
         auto getball_start = std::chrono::high_resolution_clock::now();
         GS_LOG_TRACE_MSG(trace, "GetBall called with PREBLUR_IMAGE = " + std::to_string(PREBLUR_IMAGE) + " IS_COLOR_MASKING = " +
                     std::to_string(IS_COLOR_MASKING) + " FINAL_BLUR = " + std::to_string(FINAL_BLUR) + " search_mode = " + std::to_string(search_mode) 
@@ -586,7 +775,8 @@ namespace golf_sim {
 
         if (detection_method == "experimental") {
             std::vector<GsCircle> detected_circles;
-            if (DetectBalls(rgbImg, search_mode, detected_circles, report_find_failures)) {
+            std::vector<NCNNDetector::Detection> detections;
+            if (DetectBalls(rgbImg, search_mode, detected_circles, report_find_failures, &detections)) {
                 // Convert GsCircle results to GolfBall objects for trajectory analysis
                 return_balls.clear();
                 for (size_t i = 0; i < detected_circles.size(); ++i) {
@@ -601,6 +791,11 @@ namespace golf_sim {
                     ball.median_color_ = baseBallWithSearchParams.average_color_;
                     ball.std_color_ = GsColorTriplet(0, 0, 0);
 
+                    if (i < detections.size()) {
+                        ball.model_overlap_score_ = detections[i].overlap_score;
+                        ball.model_exposure_index_ = detections[i].exposure_index;
+                    }
+
                     return_balls.push_back(ball);
                 }
 
@@ -647,13 +842,19 @@ namespace golf_sim {
 
         // We will create our own colorMask if we don't have one already
         // We will not do anything with the areaMask(other than to apply it further below if it exists)
-        if (color_mask_image_.empty()) {
+        // The mask is only built for the expected ball area (if any), straight from the BGR image
+        if (IS_COLOR_MASKING && color_mask_image_.empty()) {
 
-            cv::Mat hsvImage;
-            cv::cvtColor(blurImg, hsvImage, cv::COLOR_BGR2HSV);
+            std::vector<cv::Rect> mask_regions;
+            if (expectedBallArea.area() > 0) {
+                mask_regions.push_back(expectedBallArea);
+            }
 
             // Save the colorMask for later debugging as well as for use below
-            color_mask_image_ = GetColorMaskImage(hsvImage, baseBallWithSearchParams);
+            color_mask_image_ = GetColorMaskImageFromBgr(blurImg,
+                                                         baseBallWithSearchParams.GetBallLowerHSV(baseBallWithSearchParams.ball_color_),
+                                                         baseBallWithSearchParams.GetBallUpperHSV(baseBallWithSearchParams.ball_color_),
+                                                         mask_regions);
         }
 
         // LoggingTools::DebugShowImage(image_name_ + "  cv::GaussianBlur(...) hsvImage", hsvImage);
@@ -686,15 +887,22 @@ namespace golf_sim {
 
         LoggingTools::DebugShowImage(image_name_ + "  Final color AND area-masked image (search_image)", search_image);
 
+        // Only the expected ball area (if any) is searched below, so only that part needs preprocessing
+        GsPreprocessingContext preprocessing(expectedBallArea);
+
         switch (search_mode) {
             case kFindPlacedBall: {
 
-               cv::GaussianBlur(search_image, search_image, cv::Size(kPlacedPreCannyBlurSize, kPlacedPreCannyBlurSize), 0);
+               // The margin covers the two blurs plus the Canny's 3x3 gradient and non-maximum suppression
+               const int region_margin = kPlacedPreCannyBlurSize / 2 + kPlacedPreHoughBlurSize / 2 + 2;
+               cv::Mat search_region = preprocessing.RegionToProcess(search_image, region_margin);
+
+               cv::GaussianBlur(search_region, search_region, cv::Size(kPlacedPreCannyBlurSize, kPlacedPreCannyBlurSize), 0);
 
                  // TBD - REMOVED THIS FOR NOW
                  for (int i = 0; i < 0; i++) {
-                     cv::erode(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
-                     cv::dilate(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+                     cv::erode(search_region, search_region, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+                     cv::dilate(search_region, search_region, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
                  }
 
                  LoggingTools::DebugShowImage(image_name_ + "  Placed Ball Image - Ready for Edge Detection", search_image);
@@ -706,12 +914,12 @@ namespace golf_sim {
                  search_image = edgePFImage;
                  */
                  cv::Mat cannyOutput_for_balls;
-                 cv::Canny(search_image, cannyOutput_for_balls, kPlacedBallCannyLower, kPlacedBallCannyUpper);
+                 cv::Canny(search_region, cannyOutput_for_balls, kPlacedBallCannyLower, kPlacedBallCannyUpper);
 
                  LoggingTools::DebugShowImage(image_name_ + "  cannyOutput_for_balls", cannyOutput_for_balls);
 
                  // Blur the lines-only image back to the search_image that the code below uses
-                 cv::GaussianBlur(cannyOutput_for_balls, search_image, cv::Size(kPlacedPreHoughBlurSize, kPlacedPreHoughBlurSize), 0);   // Nominal is 7x7
+                 cv::GaussianBlur(cannyOutput_for_balls, search_region, cv::Size(kPlacedPreHoughBlurSize, kPlacedPreHoughBlurSize), 0);   // Nominal is 7x7
 
 
                  break;
@@ -719,7 +927,7 @@ namespace golf_sim {
 
             case kStrobed: {
 
-                if (!PreProcessStrobedImage(search_image, kStrobed)) {
+                if (!PreProcessStrobedImage(search_image, kStrobed, preprocessing)) {
                     GS_LOG_MSG(error, "Failed to PreProcessStrobedImage");
                     return false;
                 }
@@ -735,14 +943,14 @@ namespace golf_sim {
                 std::vector<cv::Vec4i> lines;
 
                 if (GolfSimCamera::kExternallyStrobedEnvFilterImage) {
-                    if (!GolfSimCamera::CleanExternalStrobeArtifacts(rgbImg, search_image, lines)) {
+                    if (!GolfSimCamera::CleanExternalStrobeArtifacts(rgbImg, search_image, lines, expectedBallArea)) {
                         GS_LOG_MSG(warning, "ProcessReceivedCam2Image - failed to CleanExternalStrobeArtifacts.");
                     }
 
                     LoggingTools::DebugShowImage(image_name_ + "After CleanExternalStrobeArtifacts", search_image);
                 }
 
-                if (!PreProcessStrobedImage(search_image, kExternallyStrobed)) {
+                if (!PreProcessStrobedImage(search_image, kExternallyStrobed, preprocessing)) {
                     GS_LOG_MSG(error, "Failed to PreProcessStrobedImage");
                     return false;
                 }
@@ -755,14 +963,16 @@ namespace golf_sim {
                 cv::medianBlur(search_image, search_image, kPuttingPreHoughBlurSize);
 
                 for (int i = 0; i < 0; i++) {
-                    cv::erode(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
-                    cv::dilate(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+                    cv::erode(search_image, search_image, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+                    cv::dilate(search_image, search_image, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
                 }
 
                 LoggingTools::DebugShowImage(image_name_ + "  Putting Image - Ready for Edge Detection", search_image);
 
-                EDPF testEDPF = EDPF(search_image);
-                Mat edgePFImage = testEDPF.getEdgeImage();
+                // One detector per thread, so that its working buffers are re-used from shot to shot
+                static thread_local EDPF putting_edge_detector;
+                putting_edge_detector.Detect(search_image);
+                Mat edgePFImage = putting_edge_detector.getEdgeImage();
                 edgePFImage = edgePFImage * -1 + 255;
                 search_image = edgePFImage;
 
@@ -947,6 +1157,13 @@ namespace golf_sim {
 
         double currentParam2 = starting_param2;
 
+        // Counts the HoughCircles calls made by the adaptive loop below
+        int hough_calls = 0;
+
+        // 2 if the adaptive loop searches a 2x-downsampled image (see kUsePyramidHoughSearch)
+        int pyramid_scale = 1;
+        cv::Mat pyramid_search_image;
+
         int priorNumCircles = 0;
         int finalNumberOfFoundCircles = 0;
 
@@ -1147,6 +1364,37 @@ namespace golf_sim {
             goto post_detection_processing;
         }
 
+        minimum_search_radius = CvUtils::RoundAndMakeEven(minimum_search_radius);
+        maximum_search_radius = CvUtils::RoundAndMakeEven(maximum_search_radius);
+
+        if (kUseHoughParameterMemory) {
+            std::lock_guard<std::mutex> lock(hough_parameter_memory_mutex_);
+            const HoughParameterMemory& memory = hough_parameter_memory_[search_mode];
+
+            const auto radius_is_close = [](int remembered_radius, int radius) {
+                return std::abs(remembered_radius - radius) <= kHoughParameterMemoryRadiusTolerance * std::max(remembered_radius, radius);
+            };
+
+            if (memory.valid && memory.dp == currentDp && memory.param1 == currentParam1 &&
+                radius_is_close(memory.min_radius, (int)minimum_search_radius) &&
+                radius_is_close(memory.max_radius, (int)maximum_search_radius)) {
+
+                // The loop treats its first param2 as the starting point, so this is all it takes
+                starting_param2 = std::clamp(memory.param2, min_param2, max_param2);
+                currentParam2 = starting_param2;
+
+                GS_LOG_TRACE_MSG(trace, "Warm-starting the Hough loop at param2 = " + std::to_string(currentParam2) +
+                    " (the last converged value took " + std::to_string(memory.hough_calls) + " HoughCircles calls).");
+            }
+        }
+
+        if (kUsePyramidHoughSearch && search_mode != kFindPlacedBall &&
+            minimum_search_radius / 2 >= kPyramidHoughMinDownsampledRadius) {
+            cv::pyrDown(final_search_image, pyramid_search_image);
+            pyramid_scale = 2;
+            GS_LOG_TRACE_MSG(trace, "Running the adaptive Hough loop on a 2x-downsampled search image.");
+        }
+
         // Adaptive algorithm to dynamically adjust the (very touchy) Hough circle parameters depending on how things are going
         while (!done) {
 
@@ -1162,16 +1410,40 @@ namespace golf_sim {
             // NOTE - Param 1 may be sensitive as well - needs to be 100 for large pictures ?
             // TBD - Need to set minDist to rows / 8, roughly ?
             std::vector<GsCircle> test_circles;
-            
-            cv::HoughCircles(final_search_image,
-                test_circles,
-                hough_mode,
-                currentDp,
-                /* minDist = */ minimum_distance, // Does this really matter if we are only looking for one circle ?
-                /* param1 = */ currentParam1,
-                /* param2 = */ currentParam2,
-                /* minRadius = */ (int)minimum_search_radius,
-                /* maxRadius = */ (int)maximum_search_radius);
+
+            hough_calls++;
+
+            if (pyramid_scale == 1) {
+                cv::HoughCircles(final_search_image,
+                    test_circles,
+                    hough_mode,
+                    currentDp,
+                    /* minDist = */ minimum_distance, // Does this really matter if we are only looking for one circle ?
+                    /* param1 = */ currentParam1,
+                    /* param2 = */ currentParam2,
+                    /* minRadius = */ (int)minimum_search_radius,
+                    /* maxRadius = */ (int)maximum_search_radius);
+            }
+            else {
+                // The HOUGH_GRADIENT accumulator threshold scales with the circumference, but
+                // the HOUGH_GRADIENT_ALT "perfectness" does not depend on the size
+                const double pyramid_param2 = (hough_mode == cv::HOUGH_GRADIENT) ? currentParam2 / pyramid_scale : currentParam2;
+
+                cv::HoughCircles(pyramid_search_image,
+                    test_circles,
+                    hough_mode,
+                    currentDp,
+                    /* minDist = */ minimum_distance / pyramid_scale,
+                    /* param1 = */ currentParam1,
+                    /* param2 = */ pyramid_param2,
+                    /* minRadius = */ (int)minimum_search_radius / pyramid_scale,
+                    /* maxRadius = */ (int)maximum_search_radius / pyramid_scale);
+
+                // Everything from here on works in the full-resolution coordinates
+                for (auto& c : test_circles) {
+                    c *= (float)pyramid_scale;
+                }
+            }
 
             // Save the prior number of circles if we need it later
             if (!circles.empty()) {
@@ -1202,6 +1474,19 @@ namespace golf_sim {
                 // We found what we consider to be a reasonable number of circles
                 circles.assign(test_circles.begin(), test_circles.end());
                 finalNumberOfFoundCircles = numCircles;
+
+                if (kUseHoughParameterMemory) {
+                    std::lock_guard<std::mutex> lock(hough_parameter_memory_mutex_);
+                    HoughParameterMemory& memory = hough_parameter_memory_[search_mode];
+                    memory.valid = true;
+                    memory.dp = currentDp;
+                    memory.param1 = currentParam1;
+                    memory.param2 = currentParam2;
+                    memory.min_radius = (int)minimum_search_radius;
+                    memory.max_radius = (int)maximum_search_radius;
+                    memory.hough_calls = hough_calls;
+                }
+
                 done = true;
                 break;
             }
@@ -1304,6 +1589,18 @@ namespace golf_sim {
             GS_LOG_TRACE_MSG(trace, "Found " + std::to_string(numCircles) + " circles.");
         }
 
+        if (pyramid_scale != 1) {
+            for (auto& c : circles) {
+                RefinePyramidHoughCircle(final_search_image, c, hough_mode, currentDp, currentParam1, currentParam2);
+            }
+        }
+
+        if (hough_calls > 0) {
+            GsMetrics::Increment(GsMetrics::Counter::kHoughCircleCalls, hough_calls);
+            GS_LOG_MSG(debug, "GetBall (search_mode " + std::to_string(search_mode) + ") adaptive Hough loop made " +
+                std::to_string(hough_calls) + " HoughCircles calls, ending at param2 = " + std::to_string(currentParam2) + ".");
+        }
+
     post_detection_processing:
 
         GS_LOG_MSG(trace, "Stating post_detection_processing.");
@@ -1314,7 +1611,7 @@ namespace golf_sim {
         // Also draw detected circles if in debug mode
 
         // We may have to sort based on several criteria to find the best ball
-        std::vector<CircleCandidateListElement>  foundCircleList;
+        std::vector<BallCandidate>  foundCircleList;
 
         int MAX_CIRCLES_TO_EVALUATE = 200;
         bool expectedBallColorExists = false;
@@ -1356,6 +1653,17 @@ namespace golf_sim {
                 c[1] += offset_sub_to_full.y;
             }
 
+            // The color of every candidate that is evaluated below may be looked at
+            std::vector<GsCircle> color_circles;
+            if (expectedBallColorExists || search_mode == kPutting) {
+                for (size_t circle_index = 0; circle_index < circles.size() && (int)circle_index < MAX_CIRCLES_TO_EVALUATE; circle_index++) {
+                    if ((int)std::round(circles[circle_index][2]) >= MIN_BALL_CANDIDATE_RADIUS) {
+                        color_circles.push_back(circles[circle_index]);
+                    }
+                }
+            }
+            GsColorStatistics color_statistics(rgbImg, color_circles);
+
             for (auto& c : circles) {
 
                 i += 1;
@@ -1383,7 +1691,7 @@ namespace golf_sim {
                     // Putting currently uses ball colors to weed out balls that are formed from the noise of the putting green.
                     if (expectedBallColorExists || search_mode == kPutting) {
                         // Only deal with color if we will be comparing colors
-                        std::vector<GsColorTriplet> stats = CvUtils::GetBallColorRgb(rgbImg, c);
+                        std::vector<GsColorTriplet> stats = color_statistics.GetBallColorRgb(c);
                         avg_RGB = { stats[0] };
                         medianRGB = { stats[1] };
                         stdRGB = { stats[2] };
@@ -1416,15 +1724,17 @@ namespace golf_sim {
                         */
                     }
 
-                    foundCircleList.push_back(CircleCandidateListElement{
-                                "Ball " + std::to_string(i),
-                                c,
-                                calculated_color_difference,
-                                found_radius,
-                                avg_RGB,
-                                rgb_avg_diff,
-                                rgb_median_diff,
-                                rgb_std_diff });
+                    BallCandidate candidate;
+                    candidate.set_circle(c);
+                    candidate.index = i;
+                    candidate.score = calculated_color_difference;
+                    candidate.found_radius = found_radius;
+                    candidate.set_average_color(avg_RGB);
+                    candidate.rgb_avg_diff = rgb_avg_diff;
+                    candidate.rgb_median_diff = rgb_median_diff;
+                    candidate.rgb_std_diff = rgb_std_diff;
+
+                    foundCircleList.push_back(candidate);
                 }
                 else {
                     GS_LOG_TRACE_MSG(trace, "Skipping too-small circle of radius = " + std::to_string(c[2]));
@@ -1448,8 +1758,8 @@ namespace golf_sim {
 
         if (search_mode != BallSearchMode::kStrobed && expectedBallColorExists) {
             // Sort by the difference between the found ball's color and the expected oolor
-            std::sort(foundCircleList.begin(), foundCircleList.end(), [](const CircleCandidateListElement& a, const CircleCandidateListElement& b)
-                { return (a.calculated_color_difference < b.calculated_color_difference); });
+            std::sort(foundCircleList.begin(), foundCircleList.end(), [](const BallCandidate& a, const BallCandidate& b)
+                { return (a.score < b.score); });
         }
         else {
             // Do nothing if the color differences would be meaningless
@@ -1472,18 +1782,18 @@ namespace golf_sim {
             return false;
         }
 
-        std::vector<CircleCandidateListElement>  candidates;
-        std::vector<CircleCandidateListElement>  finalCandidates;
+        std::vector<BallCandidate>  candidates;
+        std::vector<BallCandidate>  finalCandidates;
 
         if ((search_mode == BallSearchMode::kStrobed) && expectedBallColorExists) {
             // Remove any balls whose RGB difference is too great, and then re - sort based on radius and
             // return the biggest radius ball.
-            struct CircleCandidateListElement& firstCircleElement = foundCircleList.front();
-            float maxRGBDistance = (float)(firstCircleElement.calculated_color_difference + CANDIDATE_BALL_COLOR_TOLERANCE);
+            const BallCandidate& firstCircleElement = foundCircleList.front();
+            float maxRGBDistance = (float)(firstCircleElement.score + CANDIDATE_BALL_COLOR_TOLERANCE);
 
-            for (auto& e : foundCircleList)
+            for (const BallCandidate& e : foundCircleList)
             {
-                if (e.calculated_color_difference <= maxRGBDistance)
+                if (e.score <= maxRGBDistance)
                 {
                     candidates.push_back(e);
 
@@ -1493,7 +1803,7 @@ namespace golf_sim {
 
             // Sort by radius, largest first, and copy the list to the finalCandidates
 
-            std::sort(candidates.begin(), candidates.end(), [](const CircleCandidateListElement& a, const CircleCandidateListElement& b)
+            std::sort(candidates.begin(), candidates.end(), [](const BallCandidate& a, const BallCandidate& b)
                 { return (a.found_radius > b.found_radius); });
 
             std::copy(std::begin(candidates), std::end(candidates), std::back_inserter(finalCandidates));
@@ -1512,7 +1822,7 @@ namespace golf_sim {
             return false;
         }
 
-        GsCircle bestCircle = finalCandidates.front().circle;
+        GsCircle bestCircle = finalCandidates.front().circle();
         if (CvUtils::CircleRadius(bestCircle) < .001) {
             GS_LOG_MSG(error, "BestCircle had 0 radius!");
             return false;
@@ -1521,7 +1831,7 @@ namespace golf_sim {
         cv::Mat initial_ball_candidates_image_ = rgbImg.clone(); 
         
         int index = 0;
-        for (CircleCandidateListElement& c : finalCandidates) {
+        for (const BallCandidate& c : finalCandidates) {
 
             // We have one or more (possibly sketchy) initial ball candidates.  Create a ball and setup its color information
             // so that we can (if desired) use that information to further isolate the ball before we calculate the final
@@ -1530,7 +1840,7 @@ namespace golf_sim {
 
             // TBD - refactor so that the x & y are set from the circle for the ball instead of having to keep separate
             b.quality_ranking = index;  // Rankings start at 0
-            b.set_circle(c.circle);
+            b.set_circle(c.circle());
 
             // The detection method may vary based on whether we're looking for a placed ball or a strobed ball
             std::string detection_method = (search_mode == BallSearchMode::kFindPlacedBall) ? kBallPlacementDetectionMethod : kStrobedBallDetectionMethod;
@@ -1543,7 +1853,7 @@ namespace golf_sim {
             return_balls.push_back(b);
 
             // Record the candidate graphically for later analysis
-            LoggingTools::DrawCircleOutlineAndCenter(initial_ball_candidates_image_, c.circle, std::to_string(index), index, (index > kMaxCirclesToEmphasize));
+            LoggingTools::DrawCircleOutlineAndCenter(initial_ball_candidates_image_, c.circle(), std::to_string(index), index, (index > kMaxCirclesToEmphasize));
             
             index++;
         }
@@ -1689,8 +1999,8 @@ namespace golf_sim {
 
         // TBD - REMOVED THIS FOR NOW - it was decreasing accuracy.
         for (int i = 0; i < 0; i++) {
-            cv::erode(finalChoiceSubImg, finalChoiceSubImg, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
-            cv::dilate(finalChoiceSubImg, finalChoiceSubImg, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+            cv::erode(finalChoiceSubImg, finalChoiceSubImg, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+            cv::dilate(finalChoiceSubImg, finalChoiceSubImg, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
         }
 
         // use the radius to try to come up with a unique name for the debug window
@@ -1698,7 +2008,7 @@ namespace golf_sim {
 
         cv::Mat cannyOutput_for_balls; 
 
-        bool is_externally_strobed = GolfSimOptions::GetCommandLineOptions().lm_comparison_mode_;
+        bool is_externally_strobed = GsAnalysisContext::LmComparisonMode();
 
         if (!is_externally_strobed) {
 
@@ -1729,8 +2039,8 @@ namespace golf_sim {
 
 
         for (int i = 0; i < 0; i++) {
-            cv::erode(finalChoiceSubImg, finalChoiceSubImg, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
-            cv::dilate(finalChoiceSubImg, finalChoiceSubImg, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
+            cv::erode(finalChoiceSubImg, finalChoiceSubImg, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
+            cv::dilate(finalChoiceSubImg, finalChoiceSubImg, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
         }
 
         LoggingTools::DebugShowImage("DetermineBestCircle Image After Morphology", finalChoiceSubImg);
@@ -1837,6 +2147,12 @@ namespace golf_sim {
 
     cv::RotatedRect BallImageProc::FindBestEllipseFornaciari(cv::Mat& img, const GsCircle& reference_ball_circle, int mask_radius) {
 
+        // The detector below is only needed when the ball's edge is hard to follow
+        cv::RotatedRect edge_fit_ellipse;
+        if (kUseFastEllipseRefinement && FitBallEllipseToEdges(img, reference_ball_circle, edge_fit_ellipse)) {
+            return edge_fit_ellipse;
+        }
+
         // Finding ellipses is expensive - use it only in the region of interest
         Size sz = img.size();
 
@@ -1871,8 +2187,8 @@ namespace golf_sim {
         ***/
 
         cv::GaussianBlur(processedImg, processedImg, cv::Size(3, 3), 0);  // nominal was 11x11
-        cv::erode(processedImg, processedImg, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
-        cv::dilate(processedImg, processedImg, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
+        cv::erode(processedImg, processedImg, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
+        cv::dilate(processedImg, processedImg, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
 
         LoggingTools::DebugShowImage(" BallImageProc::FindLargestEllipse_fornaciari - blurred/eroded/dilated image", processedImg);
 
@@ -1904,8 +2220,8 @@ namespace golf_sim {
         float	fMinReliability = 0.4f;	// Const parameters to discard bad ellipses
 
 
-        // Initialize Detector with selected parameters
-        CEllipseDetectorYaed detector;
+        // One detector per thread, so that its accumulators and arc buffers are re-used from call to call
+        static thread_local CEllipseDetectorYaed detector;
         detector.SetParameters(szPreProcessingGaussKernelSize,
             dPreProcessingGaussSigma,
             fThPos,
@@ -1917,7 +2233,19 @@ namespace golf_sim {
             fMinReliability,
             iNs
         );
-
+        detector.SetParallelTriplets(kUseParallelEllipseTriplets);
+
+        // The arcs of the ball's ellipse lie near the expected edge of the ball.  Ignoring the ones
+        // at the center of the ball (dimples and logos) and out in the corners of the sub-image
+        // saves most of the triplet search.  The detector is re-used, so the annulus is always set
+        // or cleared.
+        if (kUseEllipseArcAnnulus) {
+            detector.SetArcAnnulus(Point2f((float)(circleX + offset_full_to_sub.x), (float)(circleY + offset_full_to_sub.y)),
+                                   (float)kEllipseArcAnnulusInnerRadiusRatio * ballRadius, (float)expandedRadiusForCanny);
+        }
+        else {
+            detector.ClearArcAnnulus();
+        }
 
         // Detect
         vector<Ellipse> ellipses;
@@ -2021,6 +2349,11 @@ namespace golf_sim {
 
     cv::RotatedRect BallImageProc::FindLargestEllipse(cv::Mat& img, const GsCircle& reference_ball_circle, int mask_radius) {
 
+        cv::RotatedRect edge_fit_ellipse;
+        if (kUseFastEllipseRefinement && FitBallEllipseToEdges(img, reference_ball_circle, edge_fit_ellipse)) {
+            return edge_fit_ellipse;
+        }
+
         LoggingTools::DebugShowImage(" BallImageProc::FindLargestEllipse - input image for final choices", img);
 
         int lowThresh = 30;
@@ -2055,8 +2388,8 @@ namespace golf_sim {
 
         // Try to remove the noise around the ball
         // TBD - This can be made better than it is.  Possibly more iterations, different kernel size
-        cv::erode(finalChoiceSubImg, finalChoiceSubImg, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(7, 7)), cv::Point(-1, -1), 2);
-        cv::dilate(finalChoiceSubImg, finalChoiceSubImg, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(7, 7)), cv::Point(-1, -1), 2);
+        cv::erode(finalChoiceSubImg, finalChoiceSubImg, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(7, 7)), cv::Point(-1, -1), 2);
+        cv::dilate(finalChoiceSubImg, finalChoiceSubImg, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(7, 7)), cv::Point(-1, -1), 2);
 
         LoggingTools::DebugShowImage(" BallImageProc::FindLargestEllipse - after erode/dilate of grayscale:", finalChoiceSubImg);
 
@@ -2111,8 +2444,8 @@ namespace golf_sim {
         // LoggingTools::DebugShowImage(image_name_ + "  Canny:", cannyOutput);
         // Try to fill in any gaps in the best ellipse lines
         for (int dilations = 0; dilations < 2; dilations++) {
-            cv::dilate(cannyOutput, cannyOutput, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
-            cv::erode(cannyOutput, cannyOutput, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
+            cv::dilate(cannyOutput, cannyOutput, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
+            cv::erode(cannyOutput, cannyOutput, GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 2);
         }
         LoggingTools::DebugShowImage("BallImageProc::FindLargestEllipse - Dilated/eroded Canny:", cannyOutput);
 
@@ -2202,8 +2535,8 @@ namespace golf_sim {
 #else
         // Get rid of strongly horizontal and vertical lines, given that the ball should not be affected much
         int minLineLength = std::max(2, img.cols / 25);
-        cv::Mat horizontalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(minLineLength, 1));
-        cv::Mat verticalKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, minLineLength));
+        cv::Mat horizontalKernel = GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(minLineLength, 1));
+        cv::Mat verticalKernel = GsPreprocessingContext::StructuringElement(cv::MORPH_RECT, cv::Size(1, minLineLength));
         // cv::morphologyEx(cannyOutput, cannyOutput, cv::MORPH_ERODE, horizontal_kernel, cv::Point(-1, -1), 2);
         // TBD - shouldn't have to XOR the images, should be able to remove the lines in-place?
         cv::Mat horizontalLinesImg = img.clone();
@@ -2220,11 +2553,8 @@ namespace golf_sim {
         return true;
     }
 
-    // Returns a mask with 1 bits wherever the corresponding pixel is OUTSIDE the upper/lower HSV range
-    cv::Mat BallImageProc::GetColorMaskImage(const cv::Mat& hsvImage, 
-                                             const GsColorTriplet input_lowerHsv, 
-                                             const GsColorTriplet input_upperHsv, 
-                                             double wideningAmount) {
+    GsHsvRanges BallImageProc::GetColorMaskRanges(const GsColorTriplet input_lowerHsv,
+                                                  const GsColorTriplet input_upperHsv) {
 
         GsColorTriplet lowerHsv = input_lowerHsv;
         GsColorTriplet upperHsv = input_upperHsv;
@@ -2241,57 +2571,51 @@ namespace golf_sim {
         upperHsv[1] = std::min((int)upperHsv[1], 255);
         upperHsv[2] = std::min((int)upperHsv[2], 255);
 
-        // Because we are creating a binary mask, it should be CV_8U or CV_8S (TBD - I think?)
-        cv::Mat color_mask_image_(hsvImage.rows, hsvImage.cols, CV_8U, cv::Scalar(0));
-        //        CvUtils::SetMatSize(hsvImage, color_mask_image_);
-        // color_mask_image_ = hsvImage.clone();
-
-        // We will need TWO masks if the hue range crosses over the 180 - degreee "loop" point for reddist colors
-        // TBD - should we convert the ranges to scalars?
+        // We will need TWO ranges if the hue range crosses over the 180 - degreee "loop" point for reddist colors
         if ((lowerHsv[0] >= 0) && (upperHsv[0] <= (float)CvUtils::kOpenCvHueMax)) {
-            cv::inRange(hsvImage, cv::Scalar(lowerHsv), cv::Scalar(upperHsv), color_mask_image_);
+            return { { cv::Scalar(lowerHsv), cv::Scalar(upperHsv) } };
+        }
+
+        cv::Scalar leftMostLowerHsv;
+        cv::Scalar leftMostUpperHsv;
+        cv::Scalar rightMostLowerHsv;
+        cv::Scalar rightMostUpperHsv;
+
+        // Check the hue range - does it loop around 180 degrees?
+        if (lowerHsv[0] < 0) {
+            // the lower hue is below 0
+            leftMostLowerHsv = cv::Scalar(0.f, (float)lowerHsv[1], (float)lowerHsv[2]);
+            leftMostUpperHsv = cv::Scalar((float)upperHsv[0], (float)upperHsv[1], (float)upperHsv[2]);
+            rightMostLowerHsv = cv::Scalar((float)CvUtils::kOpenCvHueMax + (float)lowerHsv[0], (float)lowerHsv[1], (float)lowerHsv[2]);
+            rightMostUpperHsv = cv::Scalar((float)CvUtils::kOpenCvHueMax, (float)upperHsv[1], (float)upperHsv[2]);
         }
         else {
-            // 'First' and 'Second' refer to the Hsv triplets that will be used for he first and second masks
-            cv::Vec3f firstLowerHsv;
-            cv::Vec3f secondLowerHsv;
-            cv::Vec3f firstUpperHsv;
-            cv::Vec3f secondUpperHsv;
-
-            cv::Vec3f leftMostLowerHsv;
-            cv::Vec3f leftMostUpperHsv;
-            cv::Vec3f rightMostLowerHsv;
-            cv::Vec3f rightMostUpperHsv;
-
-            // Check the hue range - does it loop around 180 degrees?
-            if (lowerHsv[0] < 0) {
-                // the lower hue is below 0
-                leftMostLowerHsv = cv::Vec3f(0.f, (float)lowerHsv[1], (float)lowerHsv[2]);
-                leftMostUpperHsv = cv::Vec3f((float)upperHsv[0], (float)upperHsv[1], (float)upperHsv[2]);
-                rightMostLowerHsv = cv::Vec3f((float)CvUtils::kOpenCvHueMax + (float)lowerHsv[0], (float)lowerHsv[1], (float)lowerHsv[2]);
-                rightMostUpperHsv = cv::Vec3f((float)CvUtils::kOpenCvHueMax, (float)upperHsv[1], (float)upperHsv[2]);
-            }
-            else {
-                // the upper hue is over 180 degrees
-                leftMostLowerHsv = cv::Vec3f(0.f, (float)lowerHsv[1], (float)lowerHsv[2]);
-                leftMostUpperHsv = cv::Vec3f((float)upperHsv[0] - 180.f, (float)upperHsv[1], (float)upperHsv[2]);
-                rightMostLowerHsv = cv::Vec3f((float)lowerHsv[0], (float)lowerHsv[1], (float)lowerHsv[2]);
-                rightMostUpperHsv = cv::Vec3f((float)CvUtils::kOpenCvHueMax, (float)upperHsv[1], (float)upperHsv[2]);
-            }
+            // the upper hue is over 180 degrees
+            leftMostLowerHsv = cv::Scalar(0.f, (float)lowerHsv[1], (float)lowerHsv[2]);
+            leftMostUpperHsv = cv::Scalar((float)upperHsv[0] - 180.f, (float)upperHsv[1], (float)upperHsv[2]);
+            rightMostLowerHsv = cv::Scalar((float)lowerHsv[0], (float)lowerHsv[1], (float)lowerHsv[2]);
+            rightMostUpperHsv = cv::Scalar((float)CvUtils::kOpenCvHueMax, (float)upperHsv[1], (float)upperHsv[2]);
+        }
+
+        return { { leftMostLowerHsv, leftMostUpperHsv }, { rightMostLowerHsv, rightMostUpperHsv } };
+    }
 
-            //GS_LOG_TRACE_MSG(trace, "leftMost Lower/Upper HSV{ " + LoggingTools::FormatVec3f(leftMostLowerHsv) + ", " + LoggingTools::FormatVec3f(leftMostUpperHsv) + ".");
-            //GS_LOG_TRACE_MSG(trace, "righttMost Lower/Upper HSV{ " + LoggingTools::FormatVec3f(rightMostLowerHsv) + ", " + LoggingTools::FormatVec3f(rightMostUpperHsv) + ".");
+    // Returns a mask with 1 bits wherever the corresponding pixel is OUTSIDE the upper/lower HSV range
+    cv::Mat BallImageProc::GetColorMaskImage(const cv::Mat& hsvImage, 
+                                             const GsColorTriplet input_lowerHsv, 
+                                             const GsColorTriplet input_upperHsv, 
+                                             double wideningAmount) {
 
-            cv::Mat firstColorMaskImage;
-            cv::inRange(hsvImage, leftMostLowerHsv, leftMostUpperHsv, firstColorMaskImage);
+        const GsHsvRanges ranges = GetColorMaskRanges(input_lowerHsv, input_upperHsv);
 
-            cv::Mat secondColorMaskImage;
-            cv::inRange(hsvImage, rightMostLowerHsv, rightMostUpperHsv, secondColorMaskImage);
+        // Because we are creating a binary mask, it should be CV_8U or CV_8S (TBD - I think?)
+        cv::Mat color_mask_image_(hsvImage.rows, hsvImage.cols, CV_8U, cv::Scalar(0));
 
-            //LoggingTools::DebugShowImage(image_name_ + "  firstColorMaskImage", firstColorMaskImage);
-            //LoggingTools::DebugShowImage(image_name_ + "  secondColorMaskImage", secondColorMaskImage);
+        cv::Mat range_mask_image;
 
-            cv::bitwise_or(firstColorMaskImage, secondColorMaskImage, color_mask_image_);
+        for (const auto& range : ranges) {
+            cv::inRange(hsvImage, range.first, range.second, range_mask_image);
+            cv::bitwise_or(color_mask_image_, range_mask_image, color_mask_image_);
         }
 
         //LoggingTools::DebugShowImage("BallImagProc::GetColorMaskImage returning color_mask_image_", color_mask_image_);
@@ -2299,6 +2623,17 @@ namespace golf_sim {
         return color_mask_image_;
     }
 
+    cv::Mat BallImageProc::GetColorMaskImageFromBgr(const cv::Mat& bgrImage,
+                                                    const GsColorTriplet input_lowerHsv,
+                                                    const GsColorTriplet input_upperHsv,
+                                                    const std::vector<cv::Rect>& regions) {
+
+        cv::Mat color_mask_image;
+        GsColorMaskTable::ForThisThread(GetColorMaskRanges(input_lowerHsv, input_upperHsv)).ComputeMask(bgrImage, regions, color_mask_image);
+
+        return color_mask_image;
+    }
+
 
     cv::Mat BallImageProc::GetColorMaskImage(const cv::Mat& hsvImage, const GolfBall& ball, double widening_amount) {
 
@@ -2323,15 +2658,15 @@ namespace golf_sim {
        */
     }
 
-    std::string BallImageProc::FormatCircleCandidateElement(const struct CircleCandidateListElement& e) {
+    std::string BallImageProc::FormatCircleCandidateElement(const BallCandidate& e) {
         // std::locale::global(std::locale("es_CO.UTF-8"));   // Try to get comma for thousands separators - doesn't work?  TBD
 
         auto f = GS_FORMATLIB_FORMAT("[{: <7}: {: <18} cd={: <15.2f} fr={: <4d} av={: <10} ad={: <9.1f} md={: <9.1f}    sd={: <9.1f}]", 
-            e.name,
-            LoggingTools::FormatCircle(e.circle),
-            e.calculated_color_difference,
+            "Ball " + std::to_string(e.index),
+            LoggingTools::FormatCircle(e.circle()),
+            e.score,
             e.found_radius,
-            LoggingTools::FormatGsColorTriplet(e.avg_RGB),
+            LoggingTools::FormatGsColorTriplet(e.average_color()),
             e.rgb_avg_diff,
             e.rgb_median_diff,
             e.rgb_std_diff
@@ -2339,7 +2674,7 @@ namespace golf_sim {
         return f;
     }
 
-    std::string BallImageProc::FormatCircleCandidateList(const std::vector<struct CircleCandidateListElement>& candidates) {
+    std::string BallImageProc::FormatCircleCandidateList(const std::vector<BallCandidate>& candidates) {
         std::string s = "\nName     | Circle                     | Color Diff         |Radius| Avg RGB                    |rgb_avg_diff  |rgb_median_diff | rgb_std_diff\n";
         for (auto& c : candidates)
         {
@@ -2607,37 +2942,61 @@ namespace golf_sim {
         // TBD - this shouldn't occur, but the HOUGH_ALT_GRADIENT mode does not seem to respect the minimum
         // distance setting
 
-        // The incoming circles may be in any order, so have to check all pairs.
+        // The incoming circles may be in any order.  Concentric circles always fall into the same
+        // grid cell, so each circle only has to be checked against the others in its cell.
+        // Of each set of concentric circles, the largest (or the first of the largest) is retained.
 
-        for (int i = 0; i < (int)(circles.size()) - 1; i++) {
-            GsCircle& circle_current = circles[i];
+        const int number_circles = (int)circles.size();
 
-            for (int j = (int)circles.size() - 1; j > i; j--) {
-                GsCircle& circle_other = circles[j];
+        float largest_radius = 0.0;
+        for (const GsCircle& c : circles) {
+            largest_radius = std::max(largest_radius, c[2]);
+        }
 
-                if (CvUtils::CircleXY(circle_current) == CvUtils::CircleXY(circle_other)) {
-                    // The two circles are concentric.  Remove the smaller circle
-                    int radius_current = (int)std::round(circle_current[2]);
-                    int radius_other = (int)std::round(circle_other[2]);
+        GsCircleGridIndex circle_index(largest_radius);
+        std::vector<cv::Vec2i> centers(number_circles);
 
-                    if (radius_other <= radius_current) {
-                        circles.erase(circles.begin() + j);
-                    }
-                    else {
-                        circles.erase(circles.begin() + i);
-                        // Skip over the circle we just erased
-                        // NOTE - i could go negative for a moment before it's incremented
-                        // above.  That's why we are using an int
-                        i--;
-
-                        // There should only be one concentric pair, so we can move onto the next
-                        // outer loop circle.  If there are more pairs, we will deal with that on
-                        // a later loop
-                        break;
-                    }
+        for (int i = 0; i < number_circles; i++) {
+            centers[i] = CvUtils::CircleXY(circles[i]);
+            circle_index.Insert(i, centers[i][0], centers[i][1]);
+        }
+
+        std::vector<int> same_cell_circles;
+
+        for (int i = 0; i < number_circles; i++) {
+            if (circle_index.IsRemoved(i)) {
+                continue;
+            }
+
+            same_cell_circles.clear();
+            circle_index.GetNearbyIds(centers[i][0], centers[i][1], 0, same_cell_circles);
+
+            for (const int j : same_cell_circles) {
+                if (j == i || centers[j] != centers[i]) {
+                    continue;
+                }
+
+                // The two circles are concentric.  Remove the smaller circle
+                int radius_current = (int)std::round(circles[i][2]);
+                int radius_other = (int)std::round(circles[j][2]);
+
+                if (radius_other < radius_current || (radius_other == radius_current && j > i)) {
+                    circle_index.Remove(j);
                 }
+                else {
+                    circle_index.Remove(i);
+                    break;
+                }
+            }
+        }
+
+        int retained = 0;
+        for (int i = 0; i < number_circles; i++) {
+            if (!circle_index.IsRemoved(i)) {
+                circles[retained++] = circles[i];
             }
         }
+        circles.resize(retained);
 
         return true;
     }
@@ -2685,26 +3044,18 @@ namespace golf_sim {
 
         const int kCloseKernelSize = 3;  // 7
 
-        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(kCloseKernelSize, kCloseKernelSize));
+        cv::Mat kernel = GsPreprocessingContext::StructuringElement(cv::MORPH_ELLIPSE, cv::Size(kCloseKernelSize, kCloseKernelSize));
         // Morph is a binary (0 or 255) mask
         cv::Mat morph;
         cv::morphologyEx(thresh, morph, cv::MORPH_CLOSE, kernel, cv::Point(-1, -1), /*iterations = */ 1);
 
-        kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(kReflectionKernelDilationSize, kReflectionKernelDilationSize));   // originally 25,25
+        kernel = GsPreprocessingContext::StructuringElement(cv::MORPH_ELLIPSE, cv::Size(kReflectionKernelDilationSize, kReflectionKernelDilationSize));   // originally 25,25
         cv::morphologyEx(morph, morph, cv::MORPH_DILATE, kernel, cv::Point(-1, -1),  /*iterations = */ 1);
 
         // LoggingTools::DebugShowImage("RemoveReflections - Expanded thresholded image = ", morph);
 
-        // Iterate through the morphed, expanded mask image and set the corresponding pixels to "ignore" in the filtered_image
-        for (int x = 0; x < original_image.cols; x++) {
-            for (int y = 0; y < original_image.rows; y++) {
-                uchar p1 = morph.at<uchar>(x, y);
-
-                if (p1 == 255) {
-                    filtered_image.at<uchar>(x, y) = kPixelIgnoreValue;
-                }
-             }
-        }
+        // Set the pixels under the morphed, expanded mask image to "ignore" in the filtered_image
+        GsPixelKernels::FillWhereMaskEquals(filtered_image, morph, 255, kPixelIgnoreValue);
 
         LoggingTools::DebugShowImage("RemoveReflections - final filtered image = ", filtered_image);
     }
@@ -2754,7 +3105,7 @@ namespace golf_sim {
 
     // Returns new coordinates in the passed-in ball, so make a copy of it before
     // calling this if the original information needs to be preserved
-    cv::Mat BallImageProc::IsolateBall(const cv::Mat& img, GolfBall& ball) {
+    cv::Mat BallImageProc::IsolateBall(const cv::Mat& img, GolfBall& ball, cv::Rect* ball_rect) {
 
         // We will grab a rectangle a little larger than the actual ball size
         const float ballSurroundMult = 1.05f;
@@ -2781,6 +3132,10 @@ namespace golf_sim {
 
         cv::Rect ballRect{ x1, y1, x_width, y_height };
 
+        if (ball_rect != nullptr) {
+            *ball_rect = ballRect;
+        }
+
         // Re-center the ball's x and y position in the new, smaller picture
         // This will change the ball that was sent in
         ball.set_x( (float)std::round(rInc + ball.measured_radius_pixels_));
@@ -2805,6 +3160,41 @@ namespace golf_sim {
         return finalResult;
     }
 
+    BallImageProc::BallPatch BallImageProc::MakeBallPatch(const cv::Mat& full_gray_image, const GolfBall& ball, int resolution) {
+
+        BallPatch patch;
+        patch.ball = ball;
+        patch.image = IsolateBall(full_gray_image, patch.ball, &patch.source_rect);
+
+        if (resolution > 0 && !patch.image.empty()) {
+            ResizeBallPatch(patch, resolution);
+        }
+
+        return patch;
+    }
+
+    void BallImageProc::ResizeBallPatch(BallPatch& patch, int size) {
+
+        // The patches are square
+        if (patch.image.empty() || patch.image.rows == size) {
+            return;
+        }
+
+        const double multiplier = (double)size / (double)patch.image.rows;
+        const int interpolation = (multiplier < 1.0) ? cv::INTER_AREA : cv::INTER_LINEAR;
+
+        cv::Mat resized;
+        cv::resize(patch.image, resized, cv::Size(size, size), 0, 0, interpolation);
+        patch.image = resized;
+        patch.scale *= multiplier;
+
+        GolfBall& ball = patch.ball;
+        ball.measured_radius_pixels_ = ball.measured_radius_pixels_ * multiplier;
+        ball.ball_circle_[2] = ball.ball_circle_[2] * (float)multiplier;
+        ball.set_x((float)((double)ball.x() * multiplier));
+        ball.set_y((float)((double)ball.y() * multiplier));
+    }
+
     cv::Mat BallImageProc::MaskAreaOutsideBall(cv::Mat& ball_image, const GolfBall& ball, float mask_reduction_factor, const cv::Scalar& maskValue) {
 
         // LoggingTools::DebugShowImage("MaskAreaOutsideBall - ball_image", ball_image);
@@ -2813,13 +3203,16 @@ namespace golf_sim {
 
         int mask_radius = (int)(ball.measured_radius_pixels_ * mask_reduction_factor);
 
-        cv::Mat maskImage = cv::Mat::zeros(ball_image.rows, ball_image.cols, ball_image.type());
+        GsScratchPool& pool = GsScratchPool::ForThisThread();
+
+        cv::Mat maskImage = pool.Get(ball_image.rows, ball_image.cols, ball_image.type(), cv::Scalar::all(0));
         cv::circle(maskImage, cv::Point(ball.x(), ball.y()), mask_radius, cv::Scalar(255, 255, 255), -1);
         //LoggingTools::DebugShowImage("1st maskImage", maskImage);
 
         // At this point, maskImage is an image with a white circle and a black outside
 
-        cv::Mat result = ball_image.clone();
+        // Every pixel of the result is written by the bitwise_and
+        cv::Mat result = pool.Get(ball_image.rows, ball_image.cols, ball_image.type());
         cv::bitwise_and(ball_image, maskImage, result);
         //LoggingTools::DebugShowImage("Intermediate result", result);
 
@@ -2837,80 +3230,323 @@ namespace golf_sim {
     }
 
 
-    cv::Vec3d BallImageProc::GetBallRotation(const cv::Mat& full_gray_image1,
-                                             const GolfBall& ball1,
-                                             const cv::Mat& full_gray_image2,
-                                             const GolfBall& ball2) {
-        // NOTE - This function (and downstream functions) assumes that ball1 is the earlier-in-time ball
-        // for a right-handed shot.  So, for example, the expected spin will be largely counter-clockwise
-        // from ball 1 to ball 2.
-        // Make sure that for left-handed shots this is correct - we will assume that for
-        // left-handed shots, ball1 is still to the LEFT of ball 2
+    // FNV-1a, 64-bit
+    static uint64_t HashBytes(const void* data, size_t length, uint64_t hash = 14695981039346656037ULL) {
+        const unsigned char* bytes = (const unsigned char*)data;
+        for (size_t i = 0; i < length; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
 
-        BOOST_LOG_FUNCTION();
-        auto spin_detection_start = std::chrono::high_resolution_clock::now();
+    static uint64_t HashImage(const cv::Mat& img, uint64_t hash) {
+        const int header[3] = { img.rows, img.cols, img.type() };
+        hash = HashBytes(header, sizeof(header), hash);
+        const size_t row_bytes = (size_t)img.cols * img.elemSize();
+        for (int y = 0; y < img.rows; y++) {
+            hash = HashBytes(img.ptr(y), row_bytes, hash);
+        }
+        return hash;
+    }
 
-        GS_LOG_TRACE_MSG(trace, "GetBallRotation called with ball1 = " + ball1.Format() + ",\nball2 = " + ball2.Format());
-        LoggingTools::DebugShowImage("full_gray_image1", full_gray_image1);
-        LoggingTools::DebugShowImage("full_gray_image2", full_gray_image2);
+    // Everything other than the dimple images that the rotation search result depends on
+    static std::string GetSpinSearchSettingsKey(const GolfBall& ball1, const GolfBall& ball2) {
+        std::ostringstream s;
+        s << std::setprecision(9) << "v1"
+          << "," << ball1.x() << "," << ball1.y() << "," << ball1.measured_radius_pixels_
+          << "," << ball2.x() << "," << ball2.y() << "," << ball2.measured_radius_pixels_
+          << "," << BallImageProc::kCoarseSearchResolution
+          << "," << BallImageProc::kCoarseXRotationDegreesStart << "," << BallImageProc::kCoarseXRotationDegreesEnd << "," << BallImageProc::kCoarseXRotationDegreesIncrement
+          << "," << BallImageProc::kCoarseYRotationDegreesStart << "," << BallImageProc::kCoarseYRotationDegreesEnd << "," << BallImageProc::kCoarseYRotationDegreesIncrement
+          << "," << BallImageProc::kCoarseZRotationDegreesStart << "," << BallImageProc::kCoarseZRotationDegreesEnd << "," << BallImageProc::kCoarseZRotationDegreesIncrement
+          << "," << BallImageProc::kSpinSearchUseHierarchical << "," << BallImageProc::kSpinSearchTopKCandidates
+          << "," << BallImageProc::kSpinSearchUseEarlyTermination
+          << "," << BallImageProc::kSpinSearchRemapRadiusQuantum
+          << "," << BallImageProc::kSpinSearchUseOptimizer << "," << BallImageProc::kSpinOptimizerStarts
+          << "," << BallImageProc::kSpinOptimizerMaxEvaluations << "," << BallImageProc::kSpinOptimizerSeedSpacingFactor;
+        return s.str();
+    }
 
-        // First, get a clean picture of each ball with nothing in the background, both sized the exactly same way
-        // Resize the images so that the balls are the same radius.
+    static std::string GetSpinSearchCacheFileName(const cv::Mat& dimple_image1, const cv::Mat& dimple_image2,
+                                                  const GolfBall& ball1, const GolfBall& ball2) {
+        const std::string settings = GetSpinSearchSettingsKey(ball1, ball2);
+        uint64_t hash = HashBytes(settings.data(), settings.size());
+        hash = HashImage(dimple_image1, hash);
+        hash = HashImage(dimple_image2, hash);
 
-        GolfBall local_ball1 = ball1;
-        GolfBall local_ball2 = ball2;
+        std::ostringstream s;
+        s << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return (std::filesystem::path(BallImageProc::kSpinSearchCacheDirectory) / ("spin_search_" + s.str() + ".csv")).string();
+    }
 
+    // The first line of the file is the best (un-normalized) rotation
+    static bool ReadSpinSearchCache(const std::string& file_name, cv::Vec3i& best_rotation) {
+        std::ifstream file(file_name);
+        char comma1 = 0;
+        char comma2 = 0;
+        return (bool)(file >> best_rotation[0] >> comma1 >> best_rotation[1] >> comma2 >> best_rotation[2]) &&
+                comma1 == ',' && comma2 == ',';
+    }
 
-        // NOTE - The ball that is passed into the IsolateBall image will be adjusted
-        // to have the new x, y, and radius values relative to the smaller, isolated picture
-        cv::Mat ball_image1 = IsolateBall(full_gray_image1, local_ball1);
-        cv::Mat ball_image2 = IsolateBall(full_gray_image2, local_ball2);
+    static void WriteSpinSearchCache(const std::string& file_name, const cv::Vec3i& best_rotation,
+                                     const std::vector<RotationCandidate>& coarse_candidates,
+                                     const std::vector<RotationCandidate>& fine_candidates) {
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(file_name).parent_path(), error);
 
+        // Written under a temporary name so that a reader never sees half of a file
+        const std::string temporary_file_name = file_name + ".tmp";
+        {
+            std::ofstream file(temporary_file_name);
+            file << best_rotation[0] << "," << best_rotation[1] << "," << best_rotation[2] << "\n";
+            file << "level,x,y,z,score,pixels_examined,pixels_matching,pruned\n";
+
+            auto write_candidates = [&](const char* level, const std::vector<RotationCandidate>& candidates) {
+                for (const RotationCandidate& c : candidates) {
+                    file << level << "," << c.x_rotation_degrees << "," << c.y_rotation_degrees << "," << c.z_rotation_degrees << ","
+                         << c.score << "," << c.pixels_examined << "," << c.pixels_matching << "," << (c.pruned ? 1 : 0) << "\n";
+                }
+            };
+            write_candidates("coarse", coarse_candidates);
+            write_candidates("fine", fine_candidates);
 
-        LoggingTools::DebugShowImage("ISOLATED full_gray_image1", ball_image1);
-        LoggingTools::DebugShowImage("ISOLATED full_gray_image2", ball_image2);
+            if (!file) {
+                GS_LOG_MSG(warning, "Could not write spin search cache file " + temporary_file_name);
+                return;
+            }
+        }
 
-        if (GolfSimOptions::GetCommandLineOptions().artifact_save_level_ != ArtifactSaveLevel::kNoArtifacts && kLogIntermediateSpinImagesToFile) {
-            LoggingTools::LogImage("", ball_image1, std::vector < cv::Point >{}, true, "log_view_ISOLATED_full_gray_image1.png");
-            LoggingTools::LogImage("", ball_image2, std::vector < cv::Point >{}, true, "log_view_ISOLATED_full_gray_image2.png");
+        std::filesystem::rename(temporary_file_name, file_name, error);
+        if (error) {
+            GS_LOG_MSG(warning, "Could not write spin search cache file " + file_name + ": " + error.message());
         }
+    }
 
-        // Just to test.  Ignore the 0 bin
-        // CvUtils::DrawGrayImgHistogram(ball_image1, true);
+    bool BallImageProc::WriteSpinScoreSurface(const SpinScoreSurface& surface, const std::string& file_name_base) {
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(file_name_base).parent_path(), error);
+
+        const std::string csv_file_name = file_name_base + ".csv";
+        {
+            std::ofstream file(csv_file_name);
+            file << "index,x,y,z,pixels_matching,pixels_examined,score,pruned\n";
+
+            for (const SpinScoreSample& sample : surface) {
+                file << sample.index << "," << sample.x_rotation_degrees << "," << sample.y_rotation_degrees << "," << sample.z_rotation_degrees << ","
+                     << sample.pixels_matching << "," << sample.pixels_examined << "," << sample.score << "," << (sample.pruned ? 1 : 0) << "\n";
+            }
+
+            if (!file) {
+                GS_LOG_MSG(warning, "Could not write spin score surface file " + csv_file_name);
+                return false;
+            }
+        }
+
+        // The fine windows can overlap and are not on one grid, so the heatmap has a column (row) for
+        // each distinct x (y) rotation
+        std::vector<int> x_rotations;
+        std::vector<int> y_rotations;
+
+        for (const SpinScoreSample& sample : surface) {
+            if (!sample.pruned && sample.pixels_examined > 0) {
+                x_rotations.push_back(sample.x_rotation_degrees);
+                y_rotations.push_back(sample.y_rotation_degrees);
+            }
+        }
+
+        if (x_rotations.empty()) {
+            return true;
+        }
+
+        std::sort(x_rotations.begin(), x_rotations.end());
+        x_rotations.erase(std::unique(x_rotations.begin(), x_rotations.end()), x_rotations.end());
+        std::sort(y_rotations.begin(), y_rotations.end());
+        y_rotations.erase(std::unique(y_rotations.begin(), y_rotations.end()), y_rotations.end());
+
+        cv::Mat best_scores((int)y_rotations.size(), (int)x_rotations.size(), CV_32F, cv::Scalar(0));
+        cv::Mat has_score((int)y_rotations.size(), (int)x_rotations.size(), CV_8U, cv::Scalar(0));
+
+        for (const SpinScoreSample& sample : surface) {
+            if (sample.pruned || sample.pixels_examined <= 0) {
+                continue;
+            }
+
+            int col = (int)(std::lower_bound(x_rotations.begin(), x_rotations.end(), sample.x_rotation_degrees) - x_rotations.begin());
+            int row = (int)(std::lower_bound(y_rotations.begin(), y_rotations.end(), sample.y_rotation_degrees) - y_rotations.begin());
+
+            float& best = best_scores.at<float>(row, col);
+            best = has_score.at<uchar>(row, col) ? std::max(best, (float)sample.score) : (float)sample.score;
+            has_score.at<uchar>(row, col) = 255;
+        }
+
+        cv::Mat normalized_scores;
+        cv::normalize(best_scores, normalized_scores, 0, 255, cv::NORM_MINMAX, CV_8U, has_score);
+
+        cv::Mat heatmap;
+        cv::applyColorMap(normalized_scores, heatmap, cv::COLORMAP_JET);
+        // Black where there was nothing to score
+        heatmap.setTo(cv::Scalar(0, 0, 0), has_score == 0);
+
+        // Large enough to see each rotation
+        const int kHeatmapCellSize = 8;
+        cv::resize(heatmap, heatmap, cv::Size(), kHeatmapCellSize, kHeatmapCellSize, cv::INTER_NEAREST);
+
+        const std::string png_file_name = file_name_base + ".png";
+        if (!cv::imwrite(png_file_name, heatmap)) {
+            GS_LOG_MSG(warning, "Could not write spin score surface file " + png_file_name);
+            return false;
+        }
+
+        GS_LOG_TRACE_MSG(trace, "Wrote " + std::to_string(surface.size()) + " spin scores to " + csv_file_name);
+        return true;
+    }
+
+    // The pixels that any candidate could have to compare with target_image
+    static long CountExaminablePixels(const cv::Mat& target_image) {
+        return (long)cv::countNonZero(target_image != kPixelIgnoreValue);
+    }
+
+    bool BallImageProc::RefineMLBallRotation(const cv::Mat& ball_image1_dimple_edges,
+                                             const GolfBall& ball1,
+                                             const cv::Mat& ball_image2_dimple_edges,
+                                             int& best_rot_x, int& best_rot_y, int& best_rot_z,
+                                             std::optional<cv::Vec3i>* predicted_rotation) {
+
+        auto ml_result = spin_predictor_->Predict(ball_image1_dimple_edges, ball_image2_dimple_edges);
+
+        GS_LOG_MSG(info, "ML spin prediction (hybrid): (" + std::to_string(ml_result.x_deg) + ", " +
+                   std::to_string(ml_result.y_deg) + ", " + std::to_string(ml_result.z_deg) +
+                   ") in " + std::to_string(ml_result.inference_ms) + "ms");
+
+        // A Z prediction beyond the model's fallback threshold is where it is least reliable
+        if (ml_result.z_used_fallback) {
+            GS_LOG_MSG(info, "ML Z prediction is beyond the fallback threshold - running the full rotation search");
+            return false;
+        }
+
+        const int predicted_x = (int)std::round(ml_result.x_deg);
+        const int predicted_y = (int)std::round(ml_result.y_deg);
+        const int predicted_z = (int)std::round(ml_result.z_deg);
+        const int window = std::max(1, kSpinHybridSearchWindowDegrees);
+
+        if (predicted_rotation != nullptr) {
+            *predicted_rotation = cv::Vec3i(predicted_x, predicted_y, predicted_z);
+        }
+
+        // Same resolution as the fine level of the full search
+        RotationSearchSpace localSearchSpace;
+        localSearchSpace.anglex_rotation_degrees_increment = 1;
+        localSearchSpace.anglex_rotation_degrees_start = predicted_x - window;
+        localSearchSpace.anglex_rotation_degrees_end = predicted_x + window;
+        localSearchSpace.angley_rotation_degrees_increment = std::max(1, (int)std::round(kCoarseYRotationDegreesIncrement / 2.));
+        localSearchSpace.angley_rotation_degrees_start = predicted_y - localSearchSpace.angley_rotation_degrees_increment;
+        localSearchSpace.angley_rotation_degrees_end = predicted_y + localSearchSpace.angley_rotation_degrees_increment;
+        localSearchSpace.anglez_rotation_degrees_increment = 1;
+        localSearchSpace.anglez_rotation_degrees_start = predicted_z - window;
+        localSearchSpace.anglez_rotation_degrees_end = predicted_z + window;
+
+        cv::Mat localCandidateElementsMat;
+        cv::Vec3i localCandidateElementsMatSize;
+        std::vector<RotationCandidate> localCandidates;
+
+        ComputeCandidateAngleImages(ball_image1_dimple_edges, localSearchSpace, localCandidateElementsMat, localCandidateElementsMatSize, localCandidates, ball1, &ball_image2_dimple_edges);
+
+        std::optional<SpinPruningBound> pruning_bound;
+        if (kSpinSearchUseEarlyTermination) {
+            pruning_bound.emplace(1, CountExaminablePixels(ball_image2_dimple_edges));
+        }
+
+        int best_index = CompareCandidateAngleImages(&ball_image2_dimple_edges, &localCandidateElementsMat, &localCandidateElementsMatSize,
+                                                     &localCandidates, pruning_bound ? &*pruning_bound : nullptr);
+
+        if (pruning_bound && best_index >= 0) {
+            std::vector<int> best_indexes = GetBestRotationCandidates(ball_image2_dimple_edges, localCandidates, 1);
+            best_index = best_indexes.empty() ? -1 : best_indexes[0];
+        }
+
+        if (best_index < 0) {
+            GS_LOG_MSG(info, "No best candidate near the ML spin prediction - running the full rotation search");
+            return false;
+        }
+
+        const RotationCandidate& best = localCandidates[best_index];
+
+        // If the best match is at the edge of the window, the real rotation may well be outside of it
+        if (std::abs(best.x_rotation_degrees - predicted_x) >= window ||
+            std::abs(best.z_rotation_degrees - predicted_z) >= window) {
+            GS_LOG_MSG(info, "Best rotation near the ML spin prediction is at the edge of the search window - running the full rotation search");
+            return false;
+        }
+
+        best_rot_x = best.x_rotation_degrees;
+        best_rot_y = best.y_rotation_degrees;
+        best_rot_z = best.z_rotation_degrees;
+
+        GS_LOG_MSG(info, "Hybrid spin result: (" + std::to_string(best_rot_x) + ", " + std::to_string(best_rot_y) + ", " + std::to_string(best_rot_z) +
+                   ") from " + std::to_string(localCandidates.size()) + " candidates");
+
+        return true;
+    }
+
+    cv::Vec3d BallImageProc::GetBallRotation(const cv::Mat& full_gray_image1,
+                                             const GolfBall& ball1,
+                                             const cv::Mat& full_gray_image2,
+                                             const GolfBall& ball2,
+                                             SpinSearchQuality* search_quality,
+                                             const std::atomic<bool>* cancel) {
+        // NOTE - This function (and downstream functions) assumes that ball1 is the earlier-in-time ball
+        // for a right-handed shot.  So, for example, the expected spin will be largely counter-clockwise
+        // from ball 1 to ball 2.
+        // Make sure that for left-handed shots this is correct - we will assume that for
+        // left-handed shots, ball1 is still to the LEFT of ball 2
+
+        BOOST_LOG_FUNCTION();
+        GS_TRACE_ZONE("GetBallRotation");
+        auto spin_detection_start = std::chrono::high_resolution_clock::now();
 
+        GS_LOG_TRACE_MSG(trace, "GetBallRotation called with ball1 = " + ball1.Format() + ",\nball2 = " + ball2.Format());
+        LoggingTools::DebugShowImage("full_gray_image1", full_gray_image1);
+        LoggingTools::DebugShowImage("full_gray_image2", full_gray_image2);
 
-        // We will assume that the images are now square
+        // First, get a clean picture of each ball with nothing in the background, both sized the exactly same way
+        // Resize the images so that the balls are the same radius.
 
-        double ball1RadiusMultiplier = 1.0;
-        double ball2RadiusMultiplier = 1.0;
+        // NOTE - The patch's ball has the new x, y, and radius values relative to the smaller, isolated picture
+        BallPatch patch1 = MakeBallPatch(full_gray_image1, ball1, kSpinPatchResolution);
+        BallPatch patch2 = MakeBallPatch(full_gray_image2, ball2, kSpinPatchResolution);
 
-        if (ball_image1.rows > ball_image2.rows || ball_image1.cols > ball_image2.cols) {
-            ball2RadiusMultiplier = (double)ball_image1.rows / (double)ball_image2.rows;
-            int upWidth = ball_image1.cols;
-            int upHeight = ball_image1.rows;
-            cv::resize(ball_image2, ball_image2, cv::Size(upWidth, upHeight), cv::INTER_LINEAR);
+        // We will assume that the images are now square.  With a fixed patch resolution they
+        // are already the same size, and otherwise the smaller is enlarged to match.
+        if (patch1.image.rows > patch2.image.rows || patch1.image.cols > patch2.image.cols) {
+            ResizeBallPatch(patch2, patch1.image.rows);
         }
-        else if (ball_image2.rows > ball_image1.rows || ball_image2.cols > ball_image1.cols) {
-            ball1RadiusMultiplier = (double)ball_image2.rows / (double)ball_image1.rows;
-            int upWidth = ball_image2.cols;
-            int upHeight = ball_image2.rows;
-            cv::resize(ball_image1, ball_image1, cv::Size(upWidth, upHeight), cv::INTER_LINEAR);
+        else if (patch2.image.rows > patch1.image.rows || patch2.image.cols > patch1.image.cols) {
+            ResizeBallPatch(patch1, patch2.image.rows);
+        }
+
+        cv::Mat& ball_image1 = patch1.image;
+        cv::Mat& ball_image2 = patch2.image;
+        GolfBall& local_ball1 = patch1.ball;
+        GolfBall& local_ball2 = patch2.ball;
+
+
+        LoggingTools::DebugShowImage("ISOLATED full_gray_image1", ball_image1);
+        LoggingTools::DebugShowImage("ISOLATED full_gray_image2", ball_image2);
+
+        if (GolfSimOptions::GetCommandLineOptions().artifact_save_level_ != ArtifactSaveLevel::kNoArtifacts && kLogIntermediateSpinImagesToFile) {
+            LoggingTools::LogImage("", ball_image1, std::vector < cv::Point >{}, true, "log_view_ISOLATED_full_gray_image1.png");
+            LoggingTools::LogImage("", ball_image2, std::vector < cv::Point >{}, true, "log_view_ISOLATED_full_gray_image2.png");
         }
 
+        // Just to test.  Ignore the 0 bin
+        // CvUtils::DrawGrayImgHistogram(ball_image1, true);
+
+
         // Save the original, non-equalized images for later QA
         cv::Mat originalBallImg1 = ball_image1.clone();
         cv::Mat originalBallImg2 = ball_image2.clone();
 
-        // Adjust relevant ball radius information accordingly
-        local_ball1.measured_radius_pixels_ = local_ball1.measured_radius_pixels_ * ball1RadiusMultiplier;
-        local_ball1.ball_circle_[2] = local_ball1.ball_circle_[2] * (float)ball1RadiusMultiplier;
-        local_ball1.set_x( (float)((double)local_ball1.x() * ball1RadiusMultiplier));
-        local_ball1.set_y( (float)((double)local_ball1.y() * ball1RadiusMultiplier));
-        local_ball2.measured_radius_pixels_ = local_ball2.measured_radius_pixels_ * ball2RadiusMultiplier;
-        local_ball2.ball_circle_[2] = local_ball2.ball_circle_[2] * (float)ball2RadiusMultiplier;
-        local_ball2.set_x( (float)((double)local_ball2.x() * ball2RadiusMultiplier));
-        local_ball2.set_y( (float)((double)local_ball2.y() * ball2RadiusMultiplier));
-
 
         std::vector < cv::Point > center1 = { cv::Point{(int)local_ball1.x(), (int)local_ball1.y()} };
         LoggingTools::DebugShowImage("Ball1 Image", ball_image1, center1);
@@ -2920,12 +3556,30 @@ namespace golf_sim {
         GS_LOG_TRACE_MSG(trace, "Updated (local) ball2 data: " + local_ball2.Format());
 
 
-        float calibrated_binary_threshold = 0;
-        cv::Mat ball_image1DimpleEdges = ApplyGaborFilterToBall(ball_image1, local_ball1, calibrated_binary_threshold);
+        bool use_ml = (kSpinDetectionMethod == "ml") &&
+                      spin_predictor_initialized_.load(std::memory_order_acquire);
+        bool use_hybrid = (kSpinDetectionMethod == "hybrid") &&
+                      spin_predictor_initialized_.load(std::memory_order_acquire);
+
+        if ((kSpinDetectionMethod == "ml" || kSpinDetectionMethod == "hybrid") && !use_ml && !use_hybrid) {
+            GS_LOG_MSG(warning, "Spin method is '" + kSpinDetectionMethod + "' but model not initialized - using rotation search");
+        }
+
+        cv::Mat ball_image1DimpleEdges;
+        cv::Mat ball_image2DimpleEdges;
+
+        // The hybrid and legacy searches were tuned on the Gabor images, so only the ML path uses the model
+        const bool extracted_dimple_edges = use_ml && dimple_edge_extractor_ != nullptr &&
+            dimple_edge_extractor_->Extract(ball_image1, ball_image1DimpleEdges) &&
+            dimple_edge_extractor_->Extract(ball_image2, ball_image2DimpleEdges);
 
+        if (!extracted_dimple_edges) {
+            float calibrated_binary_threshold = 0;
+            ball_image1DimpleEdges = ApplyGaborFilterToBall(ball_image1, local_ball1, calibrated_binary_threshold);
 
-        //  Suggest the same binary threshold between the images as a starting point for the second ball - they are probably similar
-        cv::Mat ball_image2DimpleEdges = ApplyGaborFilterToBall(ball_image2, local_ball2, calibrated_binary_threshold, calibrated_binary_threshold);
+            //  Suggest the same binary threshold between the images as a starting point for the second ball - they are probably similar
+            ball_image2DimpleEdges = ApplyGaborFilterToBall(ball_image2, local_ball2, calibrated_binary_threshold, calibrated_binary_threshold);
+        }
 
    
         // TBD = Consider inverting the image to focus only on the inner parts of the dimples that will
@@ -2967,7 +3621,7 @@ namespace golf_sim {
         cv::Vec3f angleOffsetDeltas1Float = (angleOffset2 - angleOffset1) / 2.0;
 
         // For left-handed shots, the first ball will be higher (and have a larger y angle), than the first, so account for that here
-        if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kLeftHanded) {
+        if (GsAnalysisContext::GolferHandedness() == GolferOrientation::kLeftHanded) {
             angleOffsetDeltas1Float[1] = -angleOffsetDeltas1Float[1];  // Account for how our rotations are signed
         }
         cv::Vec3i angleOffsetDeltas1 = CvUtils::Round(angleOffsetDeltas1Float);
@@ -2981,7 +3635,7 @@ namespace golf_sim {
         
         // The second rotation deltas will be the remainder of (approximately) the other half of the necessary degrees to get everything to be the same perspective
         cv::Vec3i angleOffsetDeltas2 = CvUtils::Round(  -(( angleOffset2 - angleOffset1) - angleOffsetDeltas1Float) );
-        if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kLeftHanded) {
+        if (GsAnalysisContext::GolferHandedness() == GolferOrientation::kLeftHanded) {
             angleOffsetDeltas2[1] = (int)std::round( - ((angleOffset1[1] - angleOffset2[1]) - angleOffsetDeltas1Float[1]) );
         }
 
@@ -3013,12 +3667,13 @@ namespace golf_sim {
         int best_rot_y = 0;
         int best_rot_z = 0;
 
-        bool use_ml = (kSpinDetectionMethod == "ml") &&
-                      spin_predictor_initialized_.load(std::memory_order_acquire);
+        SpinSearchQuality quality = kSpinSearchComplete;
 
-        if (kSpinDetectionMethod == "ml" && !use_ml) {
-            GS_LOG_MSG(warning, "Spin method is 'ml' but model not initialized - using rotation search");
-        }
+        // Set if the hybrid refinement got as far as an ML prediction, even if it did not trust it
+        std::optional<cv::Vec3i> ml_predicted_rotation;
+
+        bool refined_ml_rotation = use_hybrid &&
+            RefineMLBallRotation(ball_image1DimpleEdges, local_ball1, ball_image2DimpleEdges, best_rot_x, best_rot_y, best_rot_z, &ml_predicted_rotation);
 
         if (use_ml) {
             auto ml_result = spin_predictor_->Predict(ball_image1DimpleEdges, ball_image2DimpleEdges);
@@ -3050,11 +3705,10 @@ namespace golf_sim {
                 std::vector<RotationCandidate> zCandidates;
 
                 ComputeCandidateAngleImages(ball_image1DimpleEdges, zSearchSpace,
-                    zCandidateElementsMat, zCandidateElementsMatSize, zCandidates, local_ball1);
+                    zCandidateElementsMat, zCandidateElementsMatSize, zCandidates, local_ball1, &ball_image2DimpleEdges);
 
-                std::vector<std::string> z_csv_data;
                 int z_best_idx = CompareCandidateAngleImages(&ball_image2DimpleEdges,
-                    &zCandidateElementsMat, &zCandidateElementsMatSize, &zCandidates, z_csv_data);
+                    &zCandidateElementsMat, &zCandidateElementsMatSize, &zCandidates);
 
                 if (z_best_idx >= 0) {
                     best_rot_z = zCandidates[z_best_idx].z_rotation_degrees;
@@ -3062,82 +3716,242 @@ namespace golf_sim {
                 }
             }
         }
-        else {
-            cv::Mat coarse_dimple1, coarse_dimple2;
-            int coarseRes = kCoarseSearchResolution;
-            cv::Size coarseSize(coarseRes, coarseRes);
-            cv::resize(ball_image1DimpleEdges, coarse_dimple1, coarseSize, 0, 0, cv::INTER_NEAREST);
-            cv::resize(ball_image2DimpleEdges, coarse_dimple2, coarseSize, 0, 0, cv::INTER_NEAREST);
-
-            GolfBall coarse_ball1 = local_ball1;
-            GolfBall coarse_ball2 = local_ball2;
-            float scale = (float)coarseRes / (float)ball_image1DimpleEdges.cols;
-            coarse_ball1.set_x((float)(local_ball1.x() * scale));
-            coarse_ball1.set_y((float)(local_ball1.y() * scale));
-            coarse_ball1.measured_radius_pixels_ = local_ball1.measured_radius_pixels_ * scale;
-            coarse_ball2.set_x((float)(local_ball2.x() * scale));
-            coarse_ball2.set_y((float)(local_ball2.y() * scale));
-            coarse_ball2.measured_radius_pixels_ = local_ball2.measured_radius_pixels_ * scale;
-
-            RotationSearchSpace initialSearchSpace;
-            initialSearchSpace.anglex_rotation_degrees_increment = kCoarseXRotationDegreesIncrement;
-            initialSearchSpace.anglex_rotation_degrees_start = kCoarseXRotationDegreesStart;
-            initialSearchSpace.anglex_rotation_degrees_end = kCoarseXRotationDegreesEnd;
-            initialSearchSpace.angley_rotation_degrees_increment = kCoarseYRotationDegreesIncrement;
-            initialSearchSpace.angley_rotation_degrees_start = kCoarseYRotationDegreesStart;
-            initialSearchSpace.angley_rotation_degrees_end = kCoarseYRotationDegreesEnd;
-            initialSearchSpace.anglez_rotation_degrees_increment = kCoarseZRotationDegreesIncrement;
-            initialSearchSpace.anglez_rotation_degrees_start = kCoarseZRotationDegreesStart;
-            initialSearchSpace.anglez_rotation_degrees_end = kCoarseZRotationDegreesEnd;
-
-            cv::Mat outputCandidateElementsMat;
-            std::vector<RotationCandidate> candidates;
-            cv::Vec3i output_candidate_elements_mat_size;
-
-            ComputeCandidateAngleImages(coarse_dimple1, initialSearchSpace, outputCandidateElementsMat, output_candidate_elements_mat_size, candidates, coarse_ball1);
-
-            std::vector<std::string> comparison_csv_data;
-            int best_candidate_index = CompareCandidateAngleImages(&coarse_dimple2, &outputCandidateElementsMat, &output_candidate_elements_mat_size, &candidates, comparison_csv_data);
-
-            if (best_candidate_index < 0) {
-                LoggingTools::Warning("No best candidate found.");
-                return rotationResult;
-            }
-
-            RotationCandidate c = candidates[best_candidate_index];
-            GS_LOG_MSG(debug, "Best Coarse Rotation: (" + std::to_string(c.x_rotation_degrees) + ", " + std::to_string(c.y_rotation_degrees) + ", " + std::to_string(c.z_rotation_degrees) + ")");
-
-            RotationSearchSpace finalSearchSpace;
-            int anglex_window_width = (int)std::round(ceil(initialSearchSpace.anglex_rotation_degrees_increment / 2.));
-            int angley_window_width = (int)std::round(ceil(initialSearchSpace.angley_rotation_degrees_increment / 2.));
-            int anglez_window_width = (int)std::round(ceil(initialSearchSpace.anglez_rotation_degrees_increment / 2.));
-
-            finalSearchSpace.anglex_rotation_degrees_increment = 1;
-            finalSearchSpace.anglex_rotation_degrees_start = c.x_rotation_degrees - anglex_window_width;
-            finalSearchSpace.anglex_rotation_degrees_end = c.x_rotation_degrees + anglex_window_width;
-            finalSearchSpace.angley_rotation_degrees_increment = (int) std::round(kCoarseYRotationDegreesIncrement / 2.);
-            finalSearchSpace.angley_rotation_degrees_start = c.y_rotation_degrees - angley_window_width;
-            finalSearchSpace.angley_rotation_degrees_end = c.y_rotation_degrees + angley_window_width;
-            finalSearchSpace.anglez_rotation_degrees_increment = 1;
-            finalSearchSpace.anglez_rotation_degrees_start = c.z_rotation_degrees - anglez_window_width;
-            finalSearchSpace.anglez_rotation_degrees_end = c.z_rotation_degrees + anglez_window_width;
-
-            cv::Mat finalOutputCandidateElementsMat;
-            cv::Vec3i finalOutputCandidateElementsMatSize;
-            std::vector<RotationCandidate> finalCandidates;
-
-            ComputeCandidateAngleImages(ball_image1DimpleEdges, finalSearchSpace, finalOutputCandidateElementsMat, finalOutputCandidateElementsMatSize, finalCandidates, local_ball1);
-            best_candidate_index = CompareCandidateAngleImages(&ball_image2DimpleEdges, &finalOutputCandidateElementsMat, &finalOutputCandidateElementsMatSize, &finalCandidates, comparison_csv_data);
-
-            if (best_candidate_index >= 0) {
-                RotationCandidate finalC = finalCandidates[best_candidate_index];
-                best_rot_x = finalC.x_rotation_degrees;
-                best_rot_y = finalC.y_rotation_degrees;
-                best_rot_z = finalC.z_rotation_degrees;
-                GS_LOG_MSG(debug, "Best Fine Rotation: (" + std::to_string(best_rot_x) + ", " + std::to_string(best_rot_y) + ", " + std::to_string(best_rot_z) + ")");
-            } else {
-                LoggingTools::Warning("No best final candidate found.  Returning 0,0,0 spin results.");
-                rotationResult = cv::Vec3d(0, 0, 0);
+        else if (!refined_ml_rotation) {
+            std::string spin_search_cache_file_name;
+            cv::Vec3i cached_rotation;
+
+            if (!kSpinSearchCacheDirectory.empty()) {
+                spin_search_cache_file_name = GetSpinSearchCacheFileName(ball_image1DimpleEdges, ball_image2DimpleEdges, local_ball1, local_ball2);
+            }
+
+            if (!spin_search_cache_file_name.empty() && ReadSpinSearchCache(spin_search_cache_file_name, cached_rotation)) {
+                best_rot_x = cached_rotation[0];
+                best_rot_y = cached_rotation[1];
+                best_rot_z = cached_rotation[2];
+                GS_LOG_MSG(info, "Using the cached spin search result from " + spin_search_cache_file_name + ": (" + std::to_string(best_rot_x) + ", " + std::to_string(best_rot_y) + ", " + std::to_string(best_rot_z) + ")");
+            }
+            else if (kSpinSearchUseOptimizer) {
+                std::vector<RotationCandidate> seed_candidates;
+                std::vector<RotationCandidate> evaluated_candidates;
+
+                if (!OptimizeBallRotation(ball_image1DimpleEdges, local_ball1, ball_image2DimpleEdges,
+                                          ml_predicted_rotation ? &(*ml_predicted_rotation) : nullptr, spin_detection_start,
+                                          best_rot_x, best_rot_y, best_rot_z, quality, seed_candidates, evaluated_candidates, cancel)) {
+                    LoggingTools::Warning("No best optimizer candidate found.");
+                    if (search_quality != nullptr) {
+                        *search_quality = kSpinSearchCoarseOnly;
+                    }
+                    return rotationResult;
+                }
+
+                // Only a complete search gives the result that a later search would
+                if (!spin_search_cache_file_name.empty() && quality == kSpinSearchComplete) {
+                    WriteSpinSearchCache(spin_search_cache_file_name, cv::Vec3i(best_rot_x, best_rot_y, best_rot_z), seed_candidates, evaluated_candidates);
+                }
+            }
+            else {
+                cv::Mat coarse_dimple1, coarse_dimple2;
+                int coarseRes = kCoarseSearchResolution;
+                cv::Size coarseSize(coarseRes, coarseRes);
+
+                // Already at the coarse resolution if that is the patch resolution
+                if (ball_image1DimpleEdges.size() == coarseSize && ball_image2DimpleEdges.size() == coarseSize) {
+                    coarse_dimple1 = ball_image1DimpleEdges;
+                    coarse_dimple2 = ball_image2DimpleEdges;
+                }
+                else {
+                    cv::resize(ball_image1DimpleEdges, coarse_dimple1, coarseSize, 0, 0, cv::INTER_NEAREST);
+                    cv::resize(ball_image2DimpleEdges, coarse_dimple2, coarseSize, 0, 0, cv::INTER_NEAREST);
+                }
+
+                GolfBall coarse_ball1 = local_ball1;
+                GolfBall coarse_ball2 = local_ball2;
+                float scale = (float)coarseRes / (float)ball_image1DimpleEdges.cols;
+                coarse_ball1.set_x((float)(local_ball1.x() * scale));
+                coarse_ball1.set_y((float)(local_ball1.y() * scale));
+                coarse_ball1.measured_radius_pixels_ = local_ball1.measured_radius_pixels_ * scale;
+                coarse_ball2.set_x((float)(local_ball2.x() * scale));
+                coarse_ball2.set_y((float)(local_ball2.y() * scale));
+                coarse_ball2.measured_radius_pixels_ = local_ball2.measured_radius_pixels_ * scale;
+
+                RotationSearchSpace initialSearchSpace;
+                initialSearchSpace.anglex_rotation_degrees_increment = kCoarseXRotationDegreesIncrement;
+                initialSearchSpace.anglex_rotation_degrees_start = kCoarseXRotationDegreesStart;
+                initialSearchSpace.anglex_rotation_degrees_end = kCoarseXRotationDegreesEnd;
+                initialSearchSpace.angley_rotation_degrees_increment = kCoarseYRotationDegreesIncrement;
+                initialSearchSpace.angley_rotation_degrees_start = kCoarseYRotationDegreesStart;
+                initialSearchSpace.angley_rotation_degrees_end = kCoarseYRotationDegreesEnd;
+                initialSearchSpace.anglez_rotation_degrees_increment = kCoarseZRotationDegreesIncrement;
+                initialSearchSpace.anglez_rotation_degrees_start = kCoarseZRotationDegreesStart;
+                initialSearchSpace.anglez_rotation_degrees_end = kCoarseZRotationDegreesEnd;
+
+                cv::Mat outputCandidateElementsMat;
+                std::vector<RotationCandidate> candidates;
+                cv::Vec3i output_candidate_elements_mat_size;
+
+                ComputeCandidateAngleImages(coarse_dimple1, initialSearchSpace, outputCandidateElementsMat, output_candidate_elements_mat_size, candidates, coarse_ball1, &coarse_dimple2);
+
+                // Each level is pruned against its own best scores.  The coarse level keeps
+                // enough of them for all of the windows that are to be refined.
+                const bool prune_comparisons = kSpinSearchUseHierarchical && kSpinSearchUseEarlyTermination;
+                std::optional<SpinPruningBound> coarse_pruning_bound;
+                if (prune_comparisons) {
+                    coarse_pruning_bound.emplace(std::max(1, kSpinSearchTopKCandidates), CountExaminablePixels(coarse_dimple2));
+                }
+
+                // Only recorded if someone is going to look at the scores
+                std::string score_surface_file_base;
+                SpinScoreSurface coarse_score_surface;
+                SpinScoreSurface fine_score_surface;
+
+                if (!kSpinScoreSurfaceDirectory.empty()) {
+                    static std::atomic<int> score_surface_count(0);
+                    score_surface_file_base = (std::filesystem::path(kSpinScoreSurfaceDirectory) /
+                                               ("spin_score_surface_" + std::to_string(score_surface_count++))).string();
+                }
+
+                SpinScoreSurface* coarse_score_surface_ptr = score_surface_file_base.empty() ? nullptr : &coarse_score_surface;
+                SpinScoreSurface* fine_score_surface_ptr = score_surface_file_base.empty() ? nullptr : &fine_score_surface;
+
+                int best_candidate_index = CompareCandidateAngleImages(&coarse_dimple2, &outputCandidateElementsMat, &output_candidate_elements_mat_size, &candidates,
+                                                                       coarse_pruning_bound ? &*coarse_pruning_bound : nullptr, coarse_score_surface_ptr);
+
+                if (coarse_score_surface_ptr != nullptr) {
+                    WriteSpinScoreSurface(coarse_score_surface, score_surface_file_base + "_coarse");
+                }
+
+                if (best_candidate_index < 0) {
+                    LoggingTools::Warning("No best candidate found.");
+                    if (search_quality != nullptr) {
+                        *search_quality = kSpinSearchCoarseOnly;
+                    }
+                    return rotationResult;
+                }
+
+                // Normally we only refine around the single best coarse candidate
+                std::vector<int> coarse_indexes_to_refine{ best_candidate_index };
+
+                if (kSpinSearchUseHierarchical) {
+                    coarse_indexes_to_refine = GetBestRotationCandidates(coarse_dimple2, candidates, std::max(1, kSpinSearchTopKCandidates));
+
+                    if (!coarse_indexes_to_refine.empty()) {
+                        best_candidate_index = coarse_indexes_to_refine[0];
+                    }
+                }
+
+                RotationCandidate c = candidates[best_candidate_index];
+                GS_LOG_MSG(debug, "Best Coarse Rotation: (" + std::to_string(c.x_rotation_degrees) + ", " + std::to_string(c.y_rotation_degrees) + ", " + std::to_string(c.z_rotation_degrees) + ")");
+
+                int anglex_window_width = (int)std::round(ceil(initialSearchSpace.anglex_rotation_degrees_increment / 2.));
+                int angley_window_width = (int)std::round(ceil(initialSearchSpace.angley_rotation_degrees_increment / 2.));
+                int anglez_window_width = (int)std::round(ceil(initialSearchSpace.anglez_rotation_degrees_increment / 2.));
+
+                // Holds the results from every fine search window so that the best can be picked across all of them
+                std::vector<RotationCandidate> allFinalCandidates;
+                // Shared by the windows, so that later windows only have to beat the best so far
+                std::optional<SpinPruningBound> fine_pruning_bound;
+                if (prune_comparisons) {
+                    fine_pruning_bound.emplace(1, CountExaminablePixels(ball_image2DimpleEdges));
+                }
+
+                // The time the last fine window took is the estimate for the next one
+                long long last_window_ms = 0;
+                size_t windows_searched = 0;
+
+                for (int coarse_index : coarse_indexes_to_refine) {
+                    const RotationCandidate& coarseC = candidates[coarse_index];
+
+                    auto window_start = std::chrono::high_resolution_clock::now();
+
+                    if (cancel != nullptr && cancel->load()) {
+                        quality = (windows_searched == 0) ? kSpinSearchCoarseOnly : kSpinSearchPartiallyRefined;
+                        GS_LOG_MSG(info, "Spin search cancelled after " + std::to_string(windows_searched) + " of " +
+                            std::to_string(coarse_indexes_to_refine.size()) + " fine windows.");
+                        break;
+                    }
+
+                    if (kSpinSearchTimeBudgetMs > 0) {
+                        long long elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(window_start - spin_detection_start).count();
+
+                        if (elapsed_ms + last_window_ms > kSpinSearchTimeBudgetMs) {
+                            quality = (windows_searched == 0) ? kSpinSearchCoarseOnly : kSpinSearchPartiallyRefined;
+                            GS_LOG_MSG(info, "Spin search time budget of " + std::to_string(kSpinSearchTimeBudgetMs) + " ms reached after " + std::to_string(elapsed_ms) +
+                                " ms.  Searched " + std::to_string(windows_searched) + " of " + std::to_string(coarse_indexes_to_refine.size()) + " fine windows.");
+                            break;
+                        }
+                    }
+
+                    RotationSearchSpace finalSearchSpace;
+                    finalSearchSpace.anglex_rotation_degrees_increment = 1;
+                    finalSearchSpace.anglex_rotation_degrees_start = coarseC.x_rotation_degrees - anglex_window_width;
+                    finalSearchSpace.anglex_rotation_degrees_end = coarseC.x_rotation_degrees + anglex_window_width;
+                    finalSearchSpace.angley_rotation_degrees_increment = (int) std::round(kCoarseYRotationDegreesIncrement / 2.);
+                    finalSearchSpace.angley_rotation_degrees_start = coarseC.y_rotation_degrees - angley_window_width;
+                    finalSearchSpace.angley_rotation_degrees_end = coarseC.y_rotation_degrees + angley_window_width;
+                    finalSearchSpace.anglez_rotation_degrees_increment = 1;
+                    finalSearchSpace.anglez_rotation_degrees_start = coarseC.z_rotation_degrees - anglez_window_width;
+                    finalSearchSpace.anglez_rotation_degrees_end = coarseC.z_rotation_degrees + anglez_window_width;
+
+                    cv::Mat finalOutputCandidateElementsMat;
+                    cv::Vec3i finalOutputCandidateElementsMatSize;
+                    std::vector<RotationCandidate> finalCandidates;
+
+                    ComputeCandidateAngleImages(ball_image1DimpleEdges, finalSearchSpace, finalOutputCandidateElementsMat, finalOutputCandidateElementsMatSize, finalCandidates, local_ball1, &ball_image2DimpleEdges);
+                    CompareCandidateAngleImages(&ball_image2DimpleEdges, &finalOutputCandidateElementsMat, &finalOutputCandidateElementsMatSize, &finalCandidates,
+                                                fine_pruning_bound ? &*fine_pruning_bound : nullptr, fine_score_surface_ptr);
+
+                    for (RotationCandidate& finalC : finalCandidates) {
+                        // The images are no longer needed, and the fine candidates can add up.  A pruned
+                        // candidate keeps its image in case it has to be compared in full after all.
+                        if (!finalC.pruned) {
+                            finalC.img.release();
+                            finalC.packed_img.reset();
+                            finalC.remap.reset();
+                            finalC.source_img.release();
+                        }
+
+                        allFinalCandidates.push_back(finalC);
+                    }
+
+                    windows_searched++;
+                    last_window_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - window_start).count();
+                }
+
+                if (fine_score_surface_ptr != nullptr) {
+                    WriteSpinScoreSurface(fine_score_surface, score_surface_file_base + "_fine");
+                }
+
+                std::vector<int> best_final_indexes = GetBestRotationCandidates(ball_image2DimpleEdges, allFinalCandidates, 1);
+
+                if (kSpinSearchUseHierarchical) {
+                    int coarse_pruned = (int)std::count_if(candidates.begin(), candidates.end(), [](const RotationCandidate& rc) { return rc.pruned; });
+                    int fine_pruned = (int)std::count_if(allFinalCandidates.begin(), allFinalCandidates.end(), [](const RotationCandidate& rc) { return rc.pruned; });
+                    std::string best_score_str = best_final_indexes.empty() ? "none" : std::to_string(allFinalCandidates[best_final_indexes[0]].score);
+
+                    GS_LOG_MSG(info, "Hierarchical spin search - coarse level: " + std::to_string(candidates.size()) + " candidates (" +
+                        std::to_string(coarse_pruned) + " pruned).  Fine level: " + std::to_string(coarse_indexes_to_refine.size()) + " windows, " +
+                        std::to_string(allFinalCandidates.size()) + " candidates (" + std::to_string(fine_pruned) + " pruned).  Best fine score: " + best_score_str);
+                }
+
+                if (!best_final_indexes.empty()) {
+                    RotationCandidate finalC = allFinalCandidates[best_final_indexes[0]];
+                    best_rot_x = finalC.x_rotation_degrees;
+                    best_rot_y = finalC.y_rotation_degrees;
+                    best_rot_z = finalC.z_rotation_degrees;
+                    GS_LOG_MSG(debug, "Best Fine Rotation: (" + std::to_string(best_rot_x) + ", " + std::to_string(best_rot_y) + ", " + std::to_string(best_rot_z) + ")");
+
+                    // Only a complete search gives the result that a later search would
+                    if (!spin_search_cache_file_name.empty() && quality == kSpinSearchComplete) {
+                        WriteSpinSearchCache(spin_search_cache_file_name, cv::Vec3i(best_rot_x, best_rot_y, best_rot_z), candidates, allFinalCandidates);
+                    }
+                } else if (quality == kSpinSearchCoarseOnly) {
+                    best_rot_x = c.x_rotation_degrees;
+                    best_rot_y = c.y_rotation_degrees;
+                    best_rot_z = c.z_rotation_degrees;
+                } else {
+                    LoggingTools::Warning("No best final candidate found.  Returning 0,0,0 spin results.");
+                    rotationResult = cv::Vec3d(0, 0, 0);
+                }
             }
         }
 
@@ -3212,6 +4026,10 @@ namespace golf_sim {
         auto spin_duration = std::chrono::duration_cast<std::chrono::milliseconds>(spin_detection_end - spin_detection_start);
         GS_LOG_MSG(info, "Spin detection completed in " + std::to_string(spin_duration.count()) + "ms");
 
+        if (search_quality != nullptr) {
+            *search_quality = quality;
+        }
+
         // Note that we return angles, not angular velocities.  The velocities will
         // be determined later based on the derived ball speed.
         return rotationResult;
@@ -3220,18 +4038,19 @@ namespace golf_sim {
 
 
     // This structure is used as a callback for the OpenCV forEach() call.
-    // After first being setup, the operator() will be called in parallel across
-    // different processing cores.
+    // The operator() will be called in parallel across different processing cores.
+    // Everything it works on is passed in, so that several spin searches can run at once.
     struct ImgComparisonOp {
-        // Must be called prior to using the iteration() operator
-        static void setup(const cv::Mat* target_image,
-                          const cv::Mat* candidate_elements_mat,
-                          std::vector<RotationCandidate>* candidates,
-                          std::vector<std::string>* comparisonData ) {
-            ImgComparisonOp::comparisonData_ = comparisonData;
-            ImgComparisonOp::target_image_ = target_image;
-            ImgComparisonOp::candidate_elements_mat_ = candidate_elements_mat;
-            ImgComparisonOp::candidates_ = candidates;
+        ImgComparisonOp(const cv::Mat* target_image,
+                        const cv::Mat* candidate_elements_mat,
+                        std::vector<RotationCandidate>* candidates,
+                        SpinPruningBound* pruning_bound = nullptr,
+                        const GsTernaryImage* packed_target_image = nullptr)
+            : target_image_(target_image),
+              candidate_elements_mat_(candidate_elements_mat),
+              candidates_(candidates),
+              pruning_bound_(pruning_bound),
+              packed_target_image_(packed_target_image) {
         }
 
         void operator ()(ushort& unusedValue, const int* position) const {
@@ -3249,40 +4068,197 @@ namespace golf_sim {
             // LoggingTools::DebugShowImage("Img #" + std::to_string(c.index), c.img);
 
             // Compare the second ball image to each of the rotated versions of the first ball image to see which is closest
-            cv::Vec2i results = BallImageProc::CompareRotationImage(*target_image_, c.img, c.index);
+            cv::Vec2i results;
+            bool terminated_early = false;
+
+            const double min_score_to_beat = (pruning_bound_ != nullptr) ? pruning_bound_->GetMinScoreToBeat() : -1.0;
+
+            if (c.scored) {
+                results = cv::Vec2i(c.pixels_matching, c.pixels_examined);
+            }
+            else if (c.remap) {
+                results = (packed_target_image_ != nullptr) ?
+                    BallImageProc::CompareRemappedRotationImage(*packed_target_image_, c, min_score_to_beat, terminated_early) :
+                    BallImageProc::CompareRemappedRotationImage(*target_image_, c, min_score_to_beat, terminated_early);
+            }
+            else if (packed_target_image_ != nullptr && c.packed_img) {
+                results = GsTernaryImage::Compare(*packed_target_image_, *c.packed_img, min_score_to_beat, terminated_early);
+            }
+            else if (pruning_bound_ != nullptr) {
+                results = BallImageProc::CompareRotationImageWithCutoff(*target_image_, c.img, min_score_to_beat, terminated_early);
+            }
+            else {
+                results = BallImageProc::CompareRotationImage(*target_image_, c.img, c.index);
+            }
+
             double scaledScore = (double)results[0] / (double)results[1];
             
             // Save the calculated score for later analysis
             c.pixels_matching = results[0];
             c.pixels_examined = results[1];
             c.score = scaledScore;
+            c.pruned = terminated_early;
+
+            // Raise the bar for the other comparisons that are still running
+            if (pruning_bound_ != nullptr && !terminated_early && results[1] > 0) {
+                pruning_bound_->Record(results[0], results[1]);
+            }
 
             // GS_LOG_TRACE_MSG(trace, "I=" + std::to_string(elementIndex) + ", Rot: (" + std::to_string(c.x_rotation_degrees) + ", " + std::to_string(c.y_rotation_degrees) + ", " + std::to_string(c.z_rotation_degrees) + ") " + ".Score : " + std::to_string(results[0]) + " out of " + std::to_string(results[1]) +
             //    ". Scaled = " + std::to_string(scaledScore);
+        }
+
+        const cv::Mat* target_image_;
+        const cv::Mat* candidate_elements_mat_;
+        std::vector<RotationCandidate>* candidates_;
+        SpinPruningBound* pruning_bound_;
+        const GsTernaryImage* packed_target_image_;
+    };
+
+
+    // The final score is this times the match ratio, less the low-pixel-count penalty
+    static const double kSpinMatchRatioScoreWeight = 10.0;
+
+    // Combines the match ratio with a penalty for candidates that had fewer pixels to compare
+    // than the best-covered candidate.  Higher is better.
+    static double GetFinalScaledScore(const double score, const double pixels_examined, const double max_pixels_examined) {
 
-            // CSV (Excel) File format - Comma-Seperated-Values for Excel spreadsheet export
-            // Columns are Idx, Rotx, Roty, Rotz, Score, Out-of, ScaledScore
-            std::string s = std::to_string(c.index) + "\t" + std::to_string(c.x_rotation_degrees) + "\t" + std::to_string(c.y_rotation_degrees) + "\t" + std::to_string(c.z_rotation_degrees) + "\t" + std::to_string(results[0]) + "\t" + std::to_string(results[1]) +
-                "\t" + std::to_string(scaledScore) + "\n";
+        const double kSpinLowCountPenaltyPower = 2.0;
+        const double kSpinLowCountPenaltyScalingFactor = 1000.0;
+        const double kSpinLowCountDifferenceWeightingFactor = 500.0;
 
-            // DEBUG - Save a CSV-compatible string for later analysis
-            (*comparisonData_)[c.index] = s;
+        double low_count_penalty = std::pow((max_pixels_examined - pixels_examined) / kSpinLowCountDifferenceWeightingFactor,
+                                            kSpinLowCountPenaltyPower) / kSpinLowCountPenaltyScalingFactor;
+        return (score * kSpinMatchRatioScoreWeight) - low_count_penalty;
+    }
+
+    static double GetFinalScaledCandidateScore(const RotationCandidate& c, const double max_pixels_examined) {
+        return GetFinalScaledScore(c.score, (double)c.pixels_examined, max_pixels_examined);
+    }
+
+
+    SpinPruningBound::SpinPruningBound(int k, long max_pixels_examinable)
+        : k_((size_t)std::max(1, k)), max_pixels_examinable_((double)max_pixels_examinable) {
+        best_lowest_final_scores_.reserve(k_ + 1);
+    }
+
+    void SpinPruningBound::Record(long pixels_matching, long pixels_examined) {
+
+        if (pixels_examined <= 0) {
+            return;
         }
 
-        static const cv::Mat* target_image_;
-        static const cv::Mat* candidate_elements_mat_;
-        static std::vector<std::string>* comparisonData_;
-        static std::vector<RotationCandidate>* candidates_;
-    };
+        // The penalty only grows with the most pixels examined by any candidate, which is at
+        // most max_pixels_examinable_, so this is the lowest that the final score can be
+        const double lowest_final_score = GetFinalScaledScore((double)pixels_matching / (double)pixels_examined,
+                                                              (double)pixels_examined, max_pixels_examinable_);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (best_lowest_final_scores_.size() == k_ && lowest_final_score <= best_lowest_final_scores_.front()) {
+            return;
+        }
+
+        best_lowest_final_scores_.push_back(lowest_final_score);
+        std::push_heap(best_lowest_final_scores_.begin(), best_lowest_final_scores_.end(), std::greater<double>());
+
+        if (best_lowest_final_scores_.size() > k_) {
+            std::pop_heap(best_lowest_final_scores_.begin(), best_lowest_final_scores_.end(), std::greater<double>());
+            best_lowest_final_scores_.pop_back();
+        }
+
+        // A candidate's final score is never more than its (un-penalized) weighted match ratio.
+        // The comparisons cut off on a strictly lower ratio, so a tie is never pruned.
+        if (best_lowest_final_scores_.size() == k_) {
+            min_score_to_beat_.store(best_lowest_final_scores_.front() / kSpinMatchRatioScoreWeight);
+        }
+    }
+
+
+    // The indexes of the (up to) k best un-pruned candidates, best first, if the candidate with
+    // the most pixels examined had max_pixels_examined
+    static std::vector<int> RankRotationCandidates(const std::vector<RotationCandidate>& candidates, double max_pixels_examined, int k) {
+
+        std::vector<std::pair<double, int>> scored_indexes;
+
+        for (int i = 0; i < (int)candidates.size(); i++) {
+            // A candidate with nothing examined has no meaningful (NaN) score
+            if (!candidates[i].pruned && candidates[i].pixels_examined > 0) {
+                scored_indexes.push_back({ GetFinalScaledCandidateScore(candidates[i], max_pixels_examined), i });
+            }
+        }
+
+        // stable_sort so that ties go to the earlier candidate, as in CompareCandidateAngleImages
+        std::stable_sort(scored_indexes.begin(), scored_indexes.end(),
+            [](const std::pair<double, int>& a, const std::pair<double, int>& b) { return a.first > b.first; });
+
+        std::vector<int> best_indexes;
+
+        for (int i = 0; i < (int)scored_indexes.size() && i < k; i++) {
+            best_indexes.push_back(scored_indexes[i].second);
+        }
+
+        return best_indexes;
+    }
+
+    static double GetMaxUnprunedPixelsExamined(const std::vector<RotationCandidate>& candidates) {
+
+        double maxPixelsExamined = -1.0;
+
+        for (const RotationCandidate& c : candidates) {
+            if (!c.pruned && c.pixels_examined > maxPixelsExamined) {
+                maxPixelsExamined = c.pixels_examined;
+            }
+        }
+
+        return maxPixelsExamined;
+    }
+
+    std::vector<int> BallImageProc::GetBestRotationCandidates(const std::vector<RotationCandidate>& candidates, int k) {
+        return RankRotationCandidates(candidates, GetMaxUnprunedPixelsExamined(candidates), k);
+    }
+
+    std::vector<int> BallImageProc::GetBestRotationCandidates(const cv::Mat& target_image,
+                                                              std::vector<RotationCandidate>& candidates, int k) {
+
+        if (std::none_of(candidates.begin(), candidates.end(), [](const RotationCandidate& c) { return c.pruned; })) {
+            return GetBestRotationCandidates(candidates, k);
+        }
+
+        // The pruned candidates cannot be among the best k themselves, but one of them may have
+        // had more pixels to compare than any of the others, which would raise everyone's
+        // penalty.  The most that can be is every pixel that is not ignored in the target image.
+        const double max_unpruned_pixels_examined = GetMaxUnprunedPixelsExamined(candidates);
+        const double max_pixels_examinable = std::max(max_unpruned_pixels_examined, (double)CountExaminablePixels(target_image));
+
+        // The difference between two candidates' final scores changes linearly with the most
+        // pixels examined, so if the ranking is the same at both ends of its range, it is the
+        // same everywhere in between, including wherever it would have been without the pruning
+        std::vector<int> best_indexes = RankRotationCandidates(candidates, max_unpruned_pixels_examined, k);
+
+        if (best_indexes == RankRotationCandidates(candidates, max_pixels_examinable, k)) {
+            return best_indexes;
+        }
 
-    // Complete storage for ImgComparisonOp struct
-    // Create temporary nonce objects because C++ requires references to point to a valid object.
-    // the null/nonce references will go out of scope after setup() is called and these references
-    // are set to valid objects
-    std::vector<std::string>* ImgComparisonOp::comparisonData_ = nullptr;
-    const cv::Mat* ImgComparisonOp::target_image_ = nullptr;
-    const cv::Mat* ImgComparisonOp::candidate_elements_mat_ = nullptr;
-    std::vector<RotationCandidate>* ImgComparisonOp::candidates_ = nullptr;
+        GS_LOG_TRACE_MSG(trace, "GetBestRotationCandidates - comparing the pruned candidates in full, as their pixel counts could change the best " + std::to_string(k) + ".");
+
+        for (RotationCandidate& c : candidates) {
+            if (!c.pruned) {
+                continue;
+            }
+
+            bool terminated_early = false;
+            const cv::Vec2i results = c.remap ? CompareRemappedRotationImage(target_image, c, -1.0, terminated_early) :
+                                                CompareRotationImage(target_image, c.img, c.index);
+
+            c.pixels_matching = results[0];
+            c.pixels_examined = results[1];
+            c.score = (results[1] > 0) ? (double)results[0] / (double)results[1] : 0.0;
+            c.pruned = false;
+        }
+
+        return GetBestRotationCandidates(candidates, k);
+    }
 
 
     // Returns the index within candidates that has the best comparison.
@@ -3291,7 +4267,8 @@ namespace golf_sim {
                                                     const cv::Mat* candidate_elements_mat,
                                                     const cv::Vec3i* candidate_elements_mat_size,
                                                     std::vector<RotationCandidate>* candidates,
-                                                    std::vector<std::string>& comparison_csv_data) {
+                                                    SpinPruningBound* pruning_bound,
+                                                    SpinScoreSurface* score_surface) {
 
         boost::timer::cpu_timer timer1;
 
@@ -3301,13 +4278,16 @@ namespace golf_sim {
         int ySize = (*candidate_elements_mat_size)[1];
         int zSize = (*candidate_elements_mat_size)[2];
 
-        int numCandidates = xSize * ySize * zSize;
-        std::vector<std::string> comparisonData(numCandidates);
-
-
         // Iterate through the matrix of candidates
 
-        ImgComparisonOp::setup(target_image, candidate_elements_mat, candidates, &comparisonData);
+        // Packed once here, as every candidate is compared with it
+        GsTernaryImage packed_target_image;
+        if (kSpinSearchUseBitPackedImages) {
+            packed_target_image.Pack(*target_image, kPixelIgnoreValue);
+        }
+
+        const ImgComparisonOp comparison_op(target_image, candidate_elements_mat, candidates, pruning_bound,
+                                            kSpinSearchUseBitPackedImages ? &packed_target_image : nullptr);
 
         //  Serialized version for debugging
         if (kSerializeOpsForDebug) {
@@ -3316,17 +4296,35 @@ namespace golf_sim {
                     for (int z = 0; z < zSize; z++) {
                         ushort unusedValue = 0;
                         int position[]{ x, y, z };
-                        ImgComparisonOp()(unusedValue, position);
+                        comparison_op(unusedValue, position);
                     }
                 }
             }
         }
         else {
-            (*candidate_elements_mat).forEach<ushort>(ImgComparisonOp());
+            (*candidate_elements_mat).forEach<ushort>(comparison_op);
         }
 
-        // Find the best candidate from the comparison results
-        double maxScaledScore = -1.0;
+        // Copied out after the (parallel) comparisons, so that they do not have to share anything
+        if (score_surface != nullptr) {
+            score_surface->reserve(score_surface->size() + candidates->size());
+
+            for (const RotationCandidate& c : *candidates) {
+                SpinScoreSample sample;
+                sample.index = c.index;
+                sample.x_rotation_degrees = c.x_rotation_degrees;
+                sample.y_rotation_degrees = c.y_rotation_degrees;
+                sample.z_rotation_degrees = c.z_rotation_degrees;
+                sample.pixels_matching = c.pixels_matching;
+                sample.pixels_examined = c.pixels_examined;
+                sample.score = c.score;
+                sample.pruned = c.pruned;
+                score_surface->push_back(sample);
+            }
+        }
+
+        // Find the best candidate from the comparison results
+        double maxScaledScore = -1.0;
         double maxPixelsExamined = -1.0;
         double maxPixelsMatching = -1.0;
         int maxPixelsExaminedIndex = -1;
@@ -3347,20 +4345,19 @@ namespace golf_sim {
         // as a far rotation that had few pixels to begin with, but very high
         // correspondence might be the correct one
 
-        double kSpinLowCountPenaltyPower = 2.0;
-        double kSpinLowCountPenaltyScalingFactor = 1000.0;
-        double kSpinLowCountDifferenceWeightingFactor = 500.0;
-
-        double low_count_penalty = 0.0;
         double final_scaled_score = 0.0;
 
         // Find the range of numbers of matching pixels and the total
         // most-available pixels in order to insert that into the mix for
-        // a combined score
+        // a combined score.  Pruned candidates were only partially compared, so skip them.
         for (auto& element : *candidates)
         {
             RotationCandidate c = element;
 
+            if (c.pruned) {
+                continue;
+            }
+
             if (c.pixels_examined > maxPixelsExamined) {
                 maxPixelsExamined = c.pixels_examined;
                 maxPixelsExaminedIndex = c.index;
@@ -3379,9 +4376,11 @@ namespace golf_sim {
         {
             RotationCandidate c = element;
 
-            low_count_penalty = std::pow((maxPixelsExamined - (double)c.pixels_examined) / kSpinLowCountDifferenceWeightingFactor,
-                                kSpinLowCountPenaltyPower) / kSpinLowCountPenaltyScalingFactor;
-            final_scaled_score = (c.score * 10.) - low_count_penalty;
+            if (c.pruned) {
+                continue;
+            }
+
+            final_scaled_score = GetFinalScaledCandidateScore(c, maxPixelsExamined);
 
             if (final_scaled_score > maxScaledScore) {
                 maxScaledScore = final_scaled_score;
@@ -3402,16 +4401,10 @@ namespace golf_sim {
                             std::to_string(bestScaledScoreRotY) + ", " + std::to_string(bestScaledScoreRotZ) + ") ";
         GS_LOG_MSG(debug, s);
 
-        // Transfer all the csv data to the output variable
-        comparison_csv_data = comparisonData;
-
         timer1.stop();
-        boost::timer::cpu_times times = timer1.elapsed();
-        std::cout << "CompareCandidateAngleImages: ";
-        std::cout << std::fixed << std::setprecision(8)
-            << times.wall / 1.0e9 << "s wall, "
-            << times.user / 1.0e9 << "s user + "
-            << times.system / 1.0e9 << "s system.\n";
+        const boost::timer::cpu_times times = timer1.elapsed();
+        GS_LOG_TRACE_MSG(trace, "CompareCandidateAngleImages: " + std::to_string(times.wall / 1.0e9) + "s wall, " +
+                                std::to_string(times.user / 1.0e9) + "s user + " + std::to_string(times.system / 1.0e9) + "s system.");
 
         return maxScaledScoreIndex;
     }
@@ -3420,26 +4413,84 @@ namespace golf_sim {
 
 
 
-    cv::Vec2i BallImageProc::CompareRotationImage(const cv::Mat& img1, const cv::Mat& img2, const int index) {
+    // Accumulates the number of matching and examined (non-ignored) pixels in one row
+    static inline void CompareRotationImageRow(const uchar* row1, const uchar* row2, const int cols,
+                                               long& score, long& totalPixelsExamined) {
+        int x = 0;
+
+#ifdef GS_USE_NEON_ROTATION_COMPARE
+        // Process 16 pixels at a time
+        const uint8x16_t ignore_value = vdupq_n_u8(kPixelIgnoreValue);
+
+        for (; x + 16 <= cols; x += 16) {
+            uint8x16_t p1 = vld1q_u8(row1 + x);
+            uint8x16_t p2 = vld1q_u8(row2 + x);
+
+            // Lanes are 0xFF where true, 0x00 where false
+            uint8x16_t examined_mask = vandq_u8(vmvnq_u8(vceqq_u8(p1, ignore_value)),
+                                                vmvnq_u8(vceqq_u8(p2, ignore_value)));
+            uint8x16_t matched_mask = vandq_u8(examined_mask, vceqq_u8(p1, p2));
+
+            // Each true lane contributes 8 set bits
+            totalPixelsExamined += vaddvq_u8(vcntq_u8(examined_mask)) >> 3;
+            score += vaddvq_u8(vcntq_u8(matched_mask)) >> 3;
+        }
+#endif
+
+        // Scalar path for any remaining pixels (or all of them on non-NEON builds)
+        for (; x < cols; x++) {
+            uchar p1 = row1[x];
+            uchar p2 = row2[x];
+
+            if (p1 != kPixelIgnoreValue && p2 != kPixelIgnoreValue) {
+                totalPixelsExamined++;
+                if (p1 == p2) {
+                    score++;
+                }
+            }
+        }
+    }
+
+    GS_HOT_KERNEL cv::Vec2i BallImageProc::CompareRotationImage(const cv::Mat& img1, const cv::Mat& img2, const int index) {
 
         CV_Assert((img1.rows == img2.rows && img1.rows == img2.cols));
+        CV_Assert((img1.type() == CV_8UC1 && img2.type() == CV_8UC1));
 
         long score = 0;
         long totalPixelsExamined = 0;
 
         // Optimized: row-major traversal with pointer access, no debug Mat allocation
         for (int y = 0; y < img1.rows; y++) {
-            const uchar* row1 = img1.ptr<uchar>(y);
-            const cv::Vec2i* row2 = img2.ptr<cv::Vec2i>(y);
-            for (int x = 0; x < img1.cols; x++) {
-                uchar p1 = row1[x];
-                uchar p2 = static_cast<uchar>(row2[x][1]);
+            CompareRotationImageRow(img1.ptr<uchar>(y), img2.ptr<uchar>(y), img1.cols, score, totalPixelsExamined);
+        }
 
-                if (p1 != kPixelIgnoreValue && p2 != kPixelIgnoreValue) {
-                    totalPixelsExamined++;
-                    if (p1 == p2) {
-                        score++;
-                    }
+        return cv::Vec2i(score, totalPixelsExamined);
+    }
+
+    GS_HOT_KERNEL cv::Vec2i BallImageProc::CompareRotationImageWithCutoff(const cv::Mat& img1, const cv::Mat& img2,
+                                                            double min_score_to_beat, bool& terminated_early) {
+
+        CV_Assert((img1.rows == img2.rows && img1.rows == img2.cols));
+        CV_Assert((img1.type() == CV_8UC1 && img2.type() == CV_8UC1));
+
+        // Checking the bound on every row would cost more than it saves
+        const int kRowsBetweenCutoffChecks = 4;
+
+        long score = 0;
+        long totalPixelsExamined = 0;
+        terminated_early = false;
+
+        for (int y = 0; y < img1.rows; y++) {
+            CompareRotationImageRow(img1.ptr<uchar>(y), img2.ptr<uchar>(y), img1.cols, score, totalPixelsExamined);
+
+            if ((y + 1) % kRowsBetweenCutoffChecks == 0 && y + 1 < img1.rows) {
+                // Best case, every remaining pixel is examined and matches
+                long remaining_pixels = (long)(img1.rows - (y + 1)) * img1.cols;
+                double best_possible_score = (double)(score + remaining_pixels) / (double)(totalPixelsExamined + remaining_pixels);
+
+                if (best_possible_score < min_score_to_beat) {
+                    terminated_early = true;
+                    break;
                 }
             }
         }
@@ -3464,14 +4515,230 @@ namespace golf_sim {
         return kernel;
     }
 
+    // The Gabor filter bank for one set of kernel parameters.  If it is to be applied with DFTs,
+    // it also holds the spectrum of each kernel for one (padded) DFT size.  Either way, nothing
+    // in it depends on the image itself, so it is built once and cached.
+    struct GaborFilterBank {
+        int kernel_size = 0;
+        double sig = 0.0;
+        double lm = 0.0;
+        double gm = 0.0;
+        double ps = 0.0;
+
+        // 0 x 0 for a bank that is applied directly with filter2D
+        int dft_rows = 0;
+        int dft_cols = 0;
+
+        std::vector<cv::Mat> kernels;
+        std::vector<cv::Mat> kernel_spectra;
+
+        // All of the kernels, one after the other in row-major order, scaled by 2^fixed_point_shift
+        std::vector<int16_t> fixed_point_kernels;
+        int fixed_point_shift = 0;
+
+        bool Matches(int ks, double sigma, double lambda, double gamma, double psi, int rows, int cols) const {
+            return kernel_size == ks && sig == sigma && lm == lambda && gm == gamma && ps == psi &&
+                dft_rows == rows && dft_cols == cols;
+        }
+    };
+
+    static const int kGaborNumberOfOrientations = 33;
+    static const double kGaborThetaIncrement = 11.25;
+
+    // The two balls of a spin analysis are usually about the same size, but are not always
+    // padded to the same DFT size, so keep a few banks.
+    static const size_t kMaxCachedGaborFilterBanks = 4;
+    static std::vector<std::shared_ptr<const GaborFilterBank>> gabor_filter_banks_;
+    static std::mutex gabor_filter_banks_mutex_;
+
+    // create_kernel(theta) returns the kernel for one orientation
+    template <typename CreateKernel>
+    static std::shared_ptr<const GaborFilterBank> GetGaborFilterBank(int kernel_size, double sig, double lm, double gm, double ps,
+                                                                     int dft_rows, int dft_cols, CreateKernel create_kernel) {
+        {
+            std::lock_guard<std::mutex> lock(gabor_filter_banks_mutex_);
+
+            for (const auto& bank : gabor_filter_banks_) {
+                if (bank->Matches(kernel_size, sig, lm, gm, ps, dft_rows, dft_cols)) {
+                    return bank;
+                }
+            }
+        }
+
+        // Built outside of the lock, as with the ball projection tables
+        auto bank = std::make_shared<GaborFilterBank>();
+        bank->kernel_size = kernel_size;
+        bank->sig = sig;
+        bank->lm = lm;
+        bank->gm = gm;
+        bank->ps = ps;
+        bank->dft_rows = dft_rows;
+        bank->dft_cols = dft_cols;
+
+        bank->kernels.resize(kGaborNumberOfOrientations);
+        for (int i = 0; i < kGaborNumberOfOrientations; i++) {
+            double theta = i * kGaborThetaIncrement;
+            bank->kernels[i] = create_kernel(theta);
+        }
+
+        // Use as many fractional bits as the 16-bit kernel values and the 32-bit sums of
+        // (kernel value * 8-bit pixel) allow, leaving headroom for the rounding
+        double max_abs_value = 0.0;
+        double max_abs_sum = 0.0;
+        for (const cv::Mat& kernel : bank->kernels) {
+            max_abs_value = std::max(max_abs_value, cv::norm(kernel, cv::NORM_INF));
+            max_abs_sum = std::max(max_abs_sum, cv::norm(kernel, cv::NORM_L1));
+        }
+
+        int shift = 14;
+        while (shift > 0 && (max_abs_value * (1 << shift) > 32767.0 ||
+                             255.0 * max_abs_sum * (1 << shift) > (double)(INT32_MAX / 2))) {
+            shift--;
+        }
+        bank->fixed_point_shift = shift;
+
+        const int taps = kernel_size * kernel_size;
+        bank->fixed_point_kernels.resize((size_t)kGaborNumberOfOrientations * taps);
+        for (int i = 0; i < kGaborNumberOfOrientations; i++) {
+            for (int ky = 0; ky < kernel_size; ky++) {
+                for (int kx = 0; kx < kernel_size; kx++) {
+                    bank->fixed_point_kernels[(size_t)i * taps + ky * kernel_size + kx] =
+                        cv::saturate_cast<int16_t>(std::round(bank->kernels[i].at<float>(ky, kx) * (1 << shift)));
+                }
+            }
+        }
+
+        if (dft_rows > 0) {
+            bank->kernel_spectra.resize(kGaborNumberOfOrientations);
+            for (int i = 0; i < kGaborNumberOfOrientations; i++) {
+                cv::Mat padded_kernel = cv::Mat::zeros(dft_rows, dft_cols, CV_32F);
+                bank->kernels[i].copyTo(padded_kernel(cv::Rect(0, 0, kernel_size, kernel_size)));
+                cv::dft(padded_kernel, bank->kernel_spectra[i], 0, kernel_size);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(gabor_filter_banks_mutex_);
+
+        if (gabor_filter_banks_.size() >= kMaxCachedGaborFilterBanks) {
+            gabor_filter_banks_.erase(gabor_filter_banks_.begin());
+        }
+        gabor_filter_banks_.push_back(bank);
+
+        return bank;
+    }
+
+    // The number of threads that ParallelForEach may run body on at once
+    static int ParallelSlotCount() {
+        return GsThreadPool::kUseSharedWorkerPool ? (int)GsThreadPool::GetSharedPool().GetNumberOfThreads() + 1 :
+                                                    std::min(omp_get_max_threads(), 4);
+    }
+
+    // Calls body(i, slot) for each i in [0, count), where slot (below ParallelSlotCount) is
+    // different for each of the threads that are running at once.  Uses the shared pool if
+    // kUseSharedWorkerPool is set, which can be nested safely, or else OpenMP.
+    template <typename F>
+    static void ParallelForEach(int count, F&& body) {
+        if (GsThreadPool::kUseSharedWorkerPool) {
+            GsThreadPool::GetSharedPool().ParallelFor(0, count, [&body](int i) {
+                body(i, GsThreadPool::GetCurrentWorkerIndex() + 1);
+            });
+            return;
+        }
+
+        const int number_of_threads = ParallelSlotCount();
+
+        #pragma omp parallel for schedule(static) num_threads(number_of_threads)
+        for (int i = 0; i < count; i++) {
+            body(i, omp_get_thread_num());
+        }
+    }
+
+    // The float accumulation is max(0, correlation of each kernel with (image_gray / 255)), scaled
+    // back up by 255, which is the same as the correlation with image_gray itself.  This computes
+    // that with the bank's 16-bit kernels and 32-bit sums.  The max over all of the orientations
+    // is kept in registers, so that each output pixel is written just once.
+    GS_HOT_KERNEL static cv::Mat ComputeGaborAccumulationFixedPoint(const cv::Mat& image_gray, const GaborFilterBank& bank) {
+
+        const int ks = bank.kernel_size;
+        const int anchor = ks / 2;
+        const int taps = ks * ks;
+        const int shift = bank.fixed_point_shift;
+        const int32_t rounding = (shift > 0) ? (1 << (shift - 1)) : 0;
+
+        GsScratchPool& pool = GsScratchPool::ForThisThread();
+
+        // Same border as filter2D
+        cv::Mat bordered = pool.Get(image_gray.rows + 2 * anchor, image_gray.cols + 2 * anchor, CV_8U);
+        cv::copyMakeBorder(image_gray, bordered, anchor, anchor, anchor, anchor, cv::BORDER_REFLECT_101);
+
+        cv::Mat accumGray = pool.Get(image_gray.rows, image_gray.cols, CV_8U);
+
+        ParallelForEach(image_gray.rows, [&](int y, int) {
+            uchar* out = accumGray.ptr<uchar>(y);
+            int x = 0;
+
+#ifdef GS_USE_NEON_GABOR
+            // 8 pixels at a time
+            const int32x4_t negative_shift = vdupq_n_s32(-shift);
+
+            for (; x + 8 <= image_gray.cols; x += 8) {
+                int32x4_t max_low = vdupq_n_s32(0);
+                int32x4_t max_high = vdupq_n_s32(0);
+
+                for (int i = 0; i < kGaborNumberOfOrientations; i++) {
+                    const int16_t* q = &bank.fixed_point_kernels[(size_t)i * taps];
+                    int32x4_t sum_low = vdupq_n_s32(0);
+                    int32x4_t sum_high = vdupq_n_s32(0);
+
+                    for (int ky = 0; ky < ks; ky++) {
+                        const uchar* src = bordered.ptr<uchar>(y + ky) + x;
+                        for (int kx = 0; kx < ks; kx++, q++) {
+                            int16x8_t pixels = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src + kx)));
+                            sum_low = vmlal_n_s16(sum_low, vget_low_s16(pixels), *q);
+                            sum_high = vmlal_high_n_s16(sum_high, pixels, *q);
+                        }
+                    }
+
+                    max_low = vmaxq_s32(max_low, sum_low);
+                    max_high = vmaxq_s32(max_high, sum_high);
+                }
+
+                // Rounding shift back to 8 bits, saturating at 255
+                int16x8_t result = vcombine_s16(vqmovn_s32(vrshlq_s32(max_low, negative_shift)),
+                                                vqmovn_s32(vrshlq_s32(max_high, negative_shift)));
+                vst1_u8(out + x, vqmovun_s16(result));
+            }
+#endif
+
+            // Scalar path for any remaining pixels (or all of them on non-NEON builds)
+            for (; x < image_gray.cols; x++) {
+                int32_t max_sum = 0;
+
+                for (int i = 0; i < kGaborNumberOfOrientations; i++) {
+                    const int16_t* q = &bank.fixed_point_kernels[(size_t)i * taps];
+                    int32_t sum = 0;
+
+                    for (int ky = 0; ky < ks; ky++) {
+                        const uchar* src = bordered.ptr<uchar>(y + ky) + x;
+                        for (int kx = 0; kx < ks; kx++, q++) {
+                            sum += (int32_t)(*q) * src[kx];
+                        }
+                    }
+
+                    max_sum = std::max(max_sum, sum);
+                }
+
+                out[x] = (uchar)std::min(255, (max_sum + rounding) >> shift);
+            }
+        });
+
+        return accumGray;
+    }
+
     cv::Mat BallImageProc::ApplyGaborFilterToBall(const cv::Mat& image_gray, const GolfBall& ball, float & calibrated_binary_threshold, float prior_binary_threshold) {
         // TBD - Not sure we will ever need the ball information?
         CV_Assert( (image_gray.type() == CV_8UC1) );
 
-        cv::Mat img_f32;
-        image_gray.convertTo(img_f32, CV_32F, 1.0 / 255, 0);
-
-
         // This two-step calculation of the kernel parameters allows us to use the first set in a 
         // testing/playground environment with easier-to-control parameters and then convert as necessary to
         // the final kernal call.  So, DON'T REFACTOR
@@ -3511,10 +4778,47 @@ namespace golf_sim {
         int white_percent = 0;
 
         // Compute the 32 Gabor convolutions ONCE — this is the expensive part (~80ms)
-        cv::Mat accumGray = ComputeGaborAccumulation(img_f32, kernel_size, sig, lm, th, ps, gm);
+        cv::Mat accumGray;
+        if (kGaborUseFixedPoint) {
+            auto create_kernel = [&](double theta) { return CreateGaborKernel(kernel_size, sig, theta, lm, gm, ps); };
+            std::shared_ptr<const GaborFilterBank> bank = GetGaborFilterBank(kernel_size, sig, lm, gm, ps, 0, 0, create_kernel);
+            accumGray = ComputeGaborAccumulationFixedPoint(image_gray, *bank);
+        }
+        else {
+            cv::Mat img_f32 = GsScratchPool::ForThisThread().Get(image_gray.size(), CV_32F);
+            image_gray.convertTo(img_f32, CV_32F, 1.0 / 255, 0);
+            accumGray = ComputeGaborAccumulation(img_f32, kernel_size, sig, lm, th, ps, gm);
+        }
+
+        // The calibration only needs the white percentage at each threshold that it tries, so
+        // those come from a single histogram pass over the accumulation, and the image itself
+        // is thresholded just once, at the end.
+        // pixels_above[t] is the number of pixels > t, which is what THRESH_BINARY keeps.
+        std::array<int, 256> pixels_above{};
+        for (int y = 0; y < accumGray.rows; y++) {
+            const uchar* row = accumGray.ptr<uchar>(y);
+            for (int x = 0; x < accumGray.cols; x++) {
+                pixels_above[row[x]]++;
+            }
+        }
+        // Each bin currently holds the count equal to t, so turn that into a count above t
+        int number_above = 0;
+        for (int t = 255; t >= 0; t--) {
+            const int number_equal = pixels_above[t];
+            pixels_above[t] = number_above;
+            number_above += number_equal;
+        }
+        const double total_pixels = (double)accumGray.rows * accumGray.cols;
+
+        // Same threshold and rounding as ThresholdGaborAccumulation
+        auto get_white_percent = [&](float threshold) {
+            const int edge_threshold_low = (int)std::round(threshold * 10.);
+            const int white_pixels = (edge_threshold_low < 0) ? (int)total_pixels :
+                                     (edge_threshold_low > 255) ? 0 : pixels_above[edge_threshold_low];
+            return (int)std::round(((double)white_pixels * 100.) / total_pixels);
+        };
 
-        // Apply initial threshold — this is cheap (~0.01ms)
-        cv::Mat dimpleImg = ThresholdGaborAccumulation(accumGray, binary_threshold, white_percent);
+        white_percent = get_white_percent(binary_threshold);
 
         GS_LOG_TRACE_MSG(trace, "Initial Gabor filter white percent = " + std::to_string(white_percent));
 
@@ -3546,8 +4850,7 @@ namespace golf_sim {
                     GS_LOG_TRACE_MSG(trace, "Trying higher gabor binary_threshold setting of " + std::to_string(binary_threshold) + " for better balance.");
                 }
 
-                // Re-threshold the SAME accumulation — no re-running 32 convolutions
-                dimpleImg = ThresholdGaborAccumulation(accumGray, binary_threshold, white_percent);
+                white_percent = get_white_percent(binary_threshold);
                 GS_LOG_TRACE_MSG(trace, "Next, refined, Gabor white percent = " + std::to_string(white_percent));
 
                 if (binary_threshold > 30 || binary_threshold < 2) {
@@ -3562,48 +4865,82 @@ namespace golf_sim {
             GS_LOG_TRACE_MSG(trace, "Final Gabor white percent = " + std::to_string(white_percent));
         }
 
-        return dimpleImg;
+        return ThresholdGaborAccumulation(accumGray, binary_threshold, white_percent);
     }
 
     cv::Mat BallImageProc::ComputeGaborAccumulation(const cv::Mat& img_f32,
         const int kernel_size, double sig, double lm, double th, double ps, double gm) {
 
-        const int nOrientations = 33;
-        const double thetaIncrement = 11.25;
+        // filter2D correlates each kernel with the image, centered, over a BORDER_REFLECT_101
+        // border.  The same correlation can be had from one forward DFT of the bordered image,
+        // multiplied by each (cached) conjugate kernel spectrum and then inverse-transformed.
+        // Which of the two is cheaper depends on the kernel and image sizes.
+        const int anchor = kernel_size / 2;
+        const int bordered_rows = img_f32.rows + 2 * anchor;
+        const int bordered_cols = img_f32.cols + 2 * anchor;
+        const int dft_rows = cv::getOptimalDFTSize(bordered_rows);
+        const int dft_cols = cv::getOptimalDFTSize(bordered_cols);
+
+        // Rough operation counts per orientation: every kernel tap of every pixel for the direct
+        // approach, versus an inverse DFT and a spectrum product for the DFT approach
+        const double dft_area = (double)dft_rows * dft_cols;
+        const double direct_cost = (double)img_f32.rows * img_f32.cols * kernel_size * kernel_size;
+        const double dft_cost = dft_area * (2.0 * std::log2(dft_area) + 4.0);
+        const bool use_dft = (kernel_size % 2 == 1) && dft_cost < direct_cost;
+
+        auto create_kernel = [&](double theta) { return CreateGaborKernel(kernel_size, sig, theta, lm, gm, ps); };
+        std::shared_ptr<const GaborFilterBank> bank = use_dft ?
+            GetGaborFilterBank(kernel_size, sig, lm, gm, ps, dft_rows, dft_cols, create_kernel) :
+            GetGaborFilterBank(kernel_size, sig, lm, gm, ps, 0, 0, create_kernel);
+
+        // The temporaries all come from the scratch pools, as they have the same sizes from shot to shot
+        GsScratchPool& pool = GsScratchPool::ForThisThread();
+
+        cv::Mat image_spectrum;
+        if (use_dft) {
+            image_spectrum = pool.Get(dft_rows, dft_cols, CV_32F);
+            cv::Mat padded_image = pool.Get(dft_rows, dft_cols, CV_32F, cv::Scalar(0));
+            cv::copyMakeBorder(img_f32, padded_image(cv::Rect(0, 0, bordered_cols, bordered_rows)),
+                               anchor, anchor, anchor, anchor, cv::BORDER_REFLECT_101);
+            cv::dft(padded_image, image_spectrum, 0, bordered_rows);
+        }
 
-        static std::once_flag kernelCacheFlag;
-        static std::vector<cv::Mat> cachedKernels;
-        std::call_once(kernelCacheFlag, [&]() {
-            cachedKernels.resize(nOrientations);
-            for (int i = 0; i < nOrientations; i++) {
-                double theta = i * thetaIncrement;
-                cachedKernels[i] = CreateGaborKernel(kernel_size, sig, theta, lm, gm, ps);
-            }
-        });
+        const cv::Rect output_rect(0, 0, img_f32.cols, img_f32.rows);
 
-        int nThreads = std::min(omp_get_max_threads(), 4);
+        int nThreads = ParallelSlotCount();
         std::vector<cv::Mat> threadAccum(nThreads);
         for (auto& a : threadAccum) {
-            a = cv::Mat::zeros(img_f32.rows, img_f32.cols, CV_32F);
+            a = pool.Get(img_f32.rows, img_f32.cols, CV_32F, cv::Scalar(0));
         }
 
-        #pragma omp parallel num_threads(nThreads)
-        {
-            int tid = omp_get_thread_num();
-            cv::Mat dest;
-            #pragma omp for schedule(static)
-            for (int i = 0; i < nOrientations; i++) {
-                cv::filter2D(img_f32, dest, CV_32F, cachedKernels[i]);
+        ParallelForEach(kGaborNumberOfOrientations, [&](int i, int tid) {
+            // This runs on a worker, so use the worker's own pool
+            GsScratchPool& worker_pool = GsScratchPool::ForThisThread();
+            cv::Mat dest = use_dft ? worker_pool.Get(dft_rows, dft_cols, CV_32F) : worker_pool.Get(img_f32.rows, img_f32.cols, CV_32F);
+            if (use_dft) {
+                cv::Mat product = worker_pool.Get(dft_rows, dft_cols, CV_32F);
+                cv::mulSpectrums(image_spectrum, bank->kernel_spectra[i], product, 0, true);
+                cv::dft(product, dest, cv::DFT_INVERSE | cv::DFT_SCALE | cv::DFT_REAL_OUTPUT, img_f32.rows);
+                cv::max(threadAccum[tid], dest(output_rect), threadAccum[tid]);
+            }
+            else {
+                cv::filter2D(img_f32, dest, CV_32F, bank->kernels[i]);
                 cv::max(threadAccum[tid], dest, threadAccum[tid]);
             }
-        }
+        });
+
+        // Each thread has an accumulator, and its own filter output (and product spectrum)
+        const size_t worker_bytes = use_dft ? 2 * (size_t)dft_rows * dft_cols * sizeof(float) : (size_t)img_f32.total() * sizeof(float);
+        const size_t spectrum_bytes = use_dft ? 2 * (size_t)dft_rows * dft_cols * sizeof(float) : 0;
+        GsMemoryFootprint::RecordPeak(GsMemoryFootprint::Subsystem::kGaborBuffers,
+                                      nThreads * ((size_t)img_f32.total() * sizeof(float) + worker_bytes) + spectrum_bytes);
 
         cv::Mat accum = threadAccum[0];
         for (int t = 1; t < nThreads; t++) {
             cv::max(accum, threadAccum[t], accum);
         }
 
-        cv::Mat accumGray;
+        cv::Mat accumGray = pool.Get(img_f32.rows, img_f32.cols, CV_8U);
         accum.convertTo(accumGray, CV_8U, 255, 0);
         return accumGray;
     }
@@ -3630,7 +4967,8 @@ namespace golf_sim {
                                                     cv::Mat &outputCandidateElementsMat,
                                                     cv::Vec3i &output_candidate_elements_mat_size, 
                                                     std::vector< RotationCandidate> &output_candidates, 
-                                                    const GolfBall& ball) {
+                                                    const GolfBall& ball,
+                                                    const cv::Mat* target_image) {
         boost::timer::cpu_timer timer1;
 
         // These are the ranges of angles that we will create candidate images for
@@ -3691,13 +5029,19 @@ namespace golf_sim {
         // Pre-allocate the candidate vector so threads can write by index without locking
         output_candidates.resize(totalCandidates);
 
+        // The remap tables index the pixels of a continuous image
+        cv::Mat remap_source_image;
+
+        if (kSpinSearchUseRemapTables) {
+            remap_source_image = base_dimple_image.isContinuous() ? base_dimple_image : base_dimple_image.clone();
+        }
+
         // Flatten the 3-level nested loop into a single parallel loop.
         // Each iteration is independent — the 3D projection only reads from base_dimple_image
         // and writes to its own candidate slot.
-        GS_LOG_MSG(info, "OMP: parallelizing " + std::to_string(totalCandidates) + " candidates across " + std::to_string(omp_get_max_threads()) + " threads (serial pixel loops)");
+        GS_LOG_MSG(info, "Parallelizing " + std::to_string(totalCandidates) + " candidates across " + std::to_string(ParallelSlotCount()) + " threads (serial pixel loops)");
 
-        #pragma omp parallel for schedule(static) num_threads(4)
-        for (int flatIdx = 0; flatIdx < totalCandidates; flatIdx++) {
+        ParallelForEach(totalCandidates, [&](int flatIdx, int) {
             // Decompose flat index back to (xIndex, yIndex, zIndex)
             int xIndex = flatIdx / (ySize * zSize);
             int rem = flatIdx % (ySize * zSize);
@@ -3708,30 +5052,402 @@ namespace golf_sim {
             int y_rotation_degrees = angley_rotation_degrees_start + yIndex * angley_rotation_degrees_increment;
             int z_rotation_degrees = anglez_rotation_degrees_start + zIndex * anglez_rotation_degrees_increment;
 
-            // Project the ball onto a 3D hemisphere at the current rotation
-            // force_serial=true because we're inside an OMP parallel region — each thread
-            // runs its own serial pixel loop instead of fighting over OpenCV's thread pool
-            cv::Mat ball13DImage = Project2dImageTo3dBall(base_dimple_image, ball,
-                cv::Vec3i(x_rotation_degrees, y_rotation_degrees, z_rotation_degrees), true);
-
             // Store candidate at its pre-determined index (no locking needed)
             RotationCandidate& c = output_candidates[flatIdx];
             c.index = static_cast<short>(flatIdx);
-            c.img = std::move(ball13DImage);
             c.x_rotation_degrees = x_rotation_degrees - xAngleOffset;
             c.y_rotation_degrees = y_rotation_degrees - yAngleOffset;
             c.z_rotation_degrees = z_rotation_degrees;
             c.score = 0.0;
 
             outputCandidateElementsMat.at<ushort>(xIndex, yIndex, zIndex) = static_cast<ushort>(flatIdx);
+        });
+
+        // The GPU does the projections and the comparisons in one go
+        if (kSpinSearchUseGpu && target_image != nullptr) {
+            if (ScoreCandidateAnglesOnGpu(base_dimple_image, ball, *target_image, output_candidates)) {
+                timer1.stop();
+                GS_LOG_TRACE_MSG(trace, "ComputeCandidateAngleImages scored the candidates on the GPU in " +
+                                        std::to_string(timer1.elapsed().wall / 1.0e9) + "s.");
+                return true;
+            }
+
+            GS_LOG_MSG(warning, "The GPU spin search is not available - using the CPU instead.");
+        }
+
+        ParallelForEach(totalCandidates, [&](int flatIdx, int) {
+            RotationCandidate& c = output_candidates[flatIdx];
+
+            const cv::Vec3i rotation(c.x_rotation_degrees + xAngleOffset, c.y_rotation_degrees + yAngleOffset, c.z_rotation_degrees);
+
+            std::shared_ptr<const RotationRemap> remap;
+
+            if (kSpinSearchUseRemapTables) {
+                remap = GetRotationRemap(base_dimple_image.size(), ball, rotation);
+            }
+
+            if (remap) {
+                // The candidate image is only ever looked at through the remap
+                c.remap = std::move(remap);
+                c.source_img = remap_source_image;
+            }
+            else {
+                // Project the ball onto a 3D hemisphere at the current rotation
+                // force_serial=true so that each candidate uses the (faster) table-driven serial
+                // pixel loop.  The candidates already keep every thread busy.
+                c.img = Project2dImageTo3dBall(base_dimple_image, ball, rotation, true);
+
+                // Packed here, once, rather than each time that the candidate is compared
+                if (kSpinSearchUseBitPackedImages) {
+                    auto packed_img = std::make_shared<GsTernaryImage>();
+                    packed_img->Pack(c.img, kPixelIgnoreValue);
+                    c.packed_img = std::move(packed_img);
+                }
+            }
+        });
+
+        // The shared remap tables are cached across shots, so only the projected images count
+        size_t candidate_bytes = output_candidates.size() * sizeof(RotationCandidate);
+        for (const RotationCandidate& c : output_candidates) {
+            candidate_bytes += c.img.total() * c.img.elemSize();
+
+            if (c.packed_img) {
+                // The valid and white bit planes
+                candidate_bytes += (size_t)c.img.rows * GsTernaryImage::WordsPerRow(c.img.cols) * 2 * sizeof(uint64_t);
+            }
         }
+        GsMemoryFootprint::RecordPeak(GsMemoryFootprint::Subsystem::kSpinCandidates, candidate_bytes);
 
         timer1.stop();
-        boost::timer::cpu_times times = timer1.elapsed();
-        std::cout << "ComputeCandidateAngleImages Time: " << std::fixed << std::setprecision(8)
-            << times.wall / 1.0e9 << "s wall, "
-            << times.user / 1.0e9 << "s user + "
-            << times.system / 1.0e9 << "s system.\n";
+        const boost::timer::cpu_times times = timer1.elapsed();
+        GS_LOG_TRACE_MSG(trace, "ComputeCandidateAngleImages: " + std::to_string(times.wall / 1.0e9) + "s wall, " +
+                                std::to_string(times.user / 1.0e9) + "s user + " + std::to_string(times.system / 1.0e9) + "s system.");
+
+        return true;
+    }
+
+
+    bool BallImageProc::OptimizeBallRotation(const cv::Mat& ball_image1_dimple_edges,
+                                             const GolfBall& ball1,
+                                             const cv::Mat& ball_image2_dimple_edges,
+                                             const cv::Vec3i* prior_rotation,
+                                             const std::chrono::high_resolution_clock::time_point& search_start,
+                                             int& best_rot_x, int& best_rot_y, int& best_rot_z,
+                                             SpinSearchQuality& quality,
+                                             std::vector<RotationCandidate>& seed_candidates,
+                                             std::vector<RotationCandidate>& evaluated_candidates,
+                                             const std::atomic<bool>* cancel) {
+        boost::timer::cpu_timer timer1;
+
+        quality = kSpinSearchComplete;
+
+        const cv::Vec3i range_start(kCoarseXRotationDegreesStart, kCoarseYRotationDegreesStart, kCoarseZRotationDegreesStart);
+        const cv::Vec3i range_end(kCoarseXRotationDegreesEnd, kCoarseYRotationDegreesEnd, kCoarseZRotationDegreesEnd);
+        const cv::Vec3i seed_increment(kCoarseXRotationDegreesIncrement * kSpinOptimizerSeedSpacingFactor,
+                                       kCoarseYRotationDegreesIncrement * kSpinOptimizerSeedSpacingFactor,
+                                       kCoarseZRotationDegreesIncrement * kSpinOptimizerSeedSpacingFactor);
+
+        // A cancelled search stops in the same way
+        auto time_budget_reached = [&]() {
+            return (cancel != nullptr && cancel->load()) || (kSpinSearchTimeBudgetMs > 0 &&
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - search_start).count() >= kSpinSearchTimeBudgetMs);
+        };
+
+        // The seeds come from a sparse sample of the coarse grid, at the coarse resolution
+        cv::Mat coarse_dimple1, coarse_dimple2;
+        cv::Size coarseSize(kCoarseSearchResolution, kCoarseSearchResolution);
+
+        if (ball_image1_dimple_edges.size() == coarseSize && ball_image2_dimple_edges.size() == coarseSize) {
+            coarse_dimple1 = ball_image1_dimple_edges;
+            coarse_dimple2 = ball_image2_dimple_edges;
+        }
+        else {
+            cv::resize(ball_image1_dimple_edges, coarse_dimple1, coarseSize, 0, 0, cv::INTER_NEAREST);
+            cv::resize(ball_image2_dimple_edges, coarse_dimple2, coarseSize, 0, 0, cv::INTER_NEAREST);
+        }
+
+        GolfBall coarse_ball1 = ball1;
+        float scale = (float)kCoarseSearchResolution / (float)ball_image1_dimple_edges.cols;
+        coarse_ball1.set_x((float)(ball1.x() * scale));
+        coarse_ball1.set_y((float)(ball1.y() * scale));
+        coarse_ball1.measured_radius_pixels_ = ball1.measured_radius_pixels_ * scale;
+
+        RotationSearchSpace seedSearchSpace;
+        seedSearchSpace.anglex_rotation_degrees_increment = seed_increment[0];
+        seedSearchSpace.anglex_rotation_degrees_start = range_start[0];
+        seedSearchSpace.anglex_rotation_degrees_end = range_end[0];
+        seedSearchSpace.angley_rotation_degrees_increment = seed_increment[1];
+        seedSearchSpace.angley_rotation_degrees_start = range_start[1];
+        seedSearchSpace.angley_rotation_degrees_end = range_end[1];
+        seedSearchSpace.anglez_rotation_degrees_increment = seed_increment[2];
+        seedSearchSpace.anglez_rotation_degrees_start = range_start[2];
+        seedSearchSpace.anglez_rotation_degrees_end = range_end[2];
+
+        cv::Mat seedCandidateElementsMat;
+        cv::Vec3i seedCandidateElementsMatSize;
+
+        ComputeCandidateAngleImages(coarse_dimple1, seedSearchSpace, seedCandidateElementsMat, seedCandidateElementsMatSize, seed_candidates, coarse_ball1, &coarse_dimple2);
+        CompareCandidateAngleImages(&coarse_dimple2, &seedCandidateElementsMat, &seedCandidateElementsMatSize, &seed_candidates);
+
+        for (RotationCandidate& seedC : seed_candidates) {
+            seedC.img.release();
+            seedC.packed_img.reset();
+            seedC.remap.reset();
+            seedC.source_img.release();
+        }
+
+        std::vector<int> best_seed_indexes = GetBestRotationCandidates(seed_candidates, kSpinOptimizerStarts);
+
+        if (best_seed_indexes.empty()) {
+            return false;
+        }
+
+        if (time_budget_reached()) {
+            const RotationCandidate& seedC = seed_candidates[best_seed_indexes[0]];
+            best_rot_x = seedC.x_rotation_degrees;
+            best_rot_y = seedC.y_rotation_degrees;
+            best_rot_z = seedC.z_rotation_degrees;
+            quality = kSpinSearchCoarseOnly;
+            GS_LOG_MSG(info, "Spin search time budget of " + std::to_string(kSpinSearchTimeBudgetMs) + " ms reached after the optimizer's seed sample.");
+            return true;
+        }
+
+        auto clamp_to_range = [&](const cv::Vec3d& p) {
+            cv::Vec3d clamped;
+            for (int axis = 0; axis < 3; axis++) {
+                clamped[axis] = std::clamp(p[axis], (double)range_start[axis], (double)range_end[axis]);
+            }
+            return clamped;
+        };
+
+        std::vector<cv::Vec3d> starts;
+
+        if (prior_rotation != nullptr) {
+            starts.push_back(clamp_to_range(cv::Vec3d((*prior_rotation)[0], (*prior_rotation)[1], (*prior_rotation)[2])));
+        }
+
+        for (int seed_index : best_seed_indexes) {
+            const RotationCandidate& seedC = seed_candidates[seed_index];
+            starts.push_back(cv::Vec3d(seedC.x_rotation_degrees, seedC.y_rotation_degrees, seedC.z_rotation_degrees));
+        }
+
+        // Everything that is compared with is looked at from every thread, but only read
+        const cv::Mat remap_source_image = ball_image1_dimple_edges.isContinuous() ? ball_image1_dimple_edges : ball_image1_dimple_edges.clone();
+        GsTernaryImage packed_target_image;
+
+        if (kSpinSearchUseBitPackedImages) {
+            packed_target_image.Pack(ball_image2_dimple_edges, kPixelIgnoreValue);
+        }
+
+        // Scored the same way as a candidate of the fine search, but on its own
+        auto score_rotation = [&](const cv::Vec3i& rotation) {
+            RotationCandidate c;
+            c.x_rotation_degrees = rotation[0];
+            c.y_rotation_degrees = rotation[1];
+            c.z_rotation_degrees = rotation[2];
+
+            cv::Vec2i results;
+            bool terminated_early = false;
+            std::shared_ptr<const RotationRemap> remap;
+
+            if (kSpinSearchUseRemapTables) {
+                remap = GetRotationRemap(ball_image1_dimple_edges.size(), ball1, rotation);
+            }
+
+            if (remap) {
+                c.remap = std::move(remap);
+                c.source_img = remap_source_image;
+                results = kSpinSearchUseBitPackedImages ?
+                    CompareRemappedRotationImage(packed_target_image, c, -1.0, terminated_early) :
+                    CompareRemappedRotationImage(ball_image2_dimple_edges, c, -1.0, terminated_early);
+                c.remap.reset();
+                c.source_img.release();
+            }
+            else {
+                // Each of the starts is on a thread of its own
+                results = CompareRotationImage(ball_image2_dimple_edges, Project2dImageTo3dBall(ball_image1_dimple_edges, ball1, rotation, true));
+            }
+
+            c.pixels_matching = results[0];
+            c.pixels_examined = results[1];
+            c.score = (results[1] > 0) ? (double)results[0] / (double)results[1] : 0.0;
+            return c;
+        };
+
+        // Each start has its own share of the evaluations and remembers its own rotations, so that
+        // the result does not depend on how the threads happened to run
+        const int evaluations_per_start = std::max(4, kSpinOptimizerMaxEvaluations / (int)starts.size());
+        std::vector<std::vector<RotationCandidate>> start_candidates(starts.size());
+        std::atomic<bool> stopped_by_time_budget(false);
+
+        ParallelForEach((int)starts.size(), [&](int start_index, int) {
+            std::vector<RotationCandidate>& evaluated = start_candidates[start_index];
+            std::map<std::array<int, 3>, size_t> evaluated_indexes;
+
+            // The low-count penalty is relative to how many pixels the first simplex had to compare,
+            // so that the objective does not change as the search goes on
+            double reference_pixels_examined = 0.0;
+
+            auto evaluate = [&](const cv::Vec3d& p) {
+                const cv::Vec3i rotation((int)std::lround(p[0]), (int)std::lround(p[1]), (int)std::lround(p[2]));
+                const std::array<int, 3> key{ rotation[0], rotation[1], rotation[2] };
+
+                auto it = evaluated_indexes.find(key);
+                if (it == evaluated_indexes.end()) {
+                    it = evaluated_indexes.emplace(key, evaluated.size()).first;
+                    evaluated.push_back(score_rotation(rotation));
+                }
+
+                return it->second;
+            };
+
+            // Lower is better
+            auto objective = [&](size_t evaluated_index) {
+                const RotationCandidate& c = evaluated[evaluated_index];
+                if (c.pixels_examined <= 0) {
+                    return std::numeric_limits<double>::max();
+                }
+                return -GetFinalScaledCandidateScore(c, std::max(reference_pixels_examined, (double)c.pixels_examined));
+            };
+
+            // The first simplex spans half a seed spacing along each axis
+            std::array<cv::Vec3d, 4> simplex;
+            std::array<double, 4> values;
+            simplex[0] = starts[start_index];
+
+            for (int axis = 0; axis < 3; axis++) {
+                cv::Vec3d vertex = simplex[0];
+                const double step = std::max(1.0, seed_increment[axis] / 2.0);
+                vertex[axis] += (vertex[axis] + step <= range_end[axis]) ? step : -step;
+                simplex[axis + 1] = clamp_to_range(vertex);
+            }
+
+            std::array<size_t, 4> simplex_indexes;
+            for (int i = 0; i < 4; i++) {
+                simplex_indexes[i] = evaluate(simplex[i]);
+                reference_pixels_examined = std::max(reference_pixels_examined, (double)evaluated[simplex_indexes[i]].pixels_examined);
+            }
+            for (int i = 0; i < 4; i++) {
+                values[i] = objective(simplex_indexes[i]);
+            }
+
+            auto score_point = [&](const cv::Vec3d& p) {
+                return objective(evaluate(p));
+            };
+
+            while ((int)evaluated.size() < evaluations_per_start) {
+                if (time_budget_reached()) {
+                    stopped_by_time_budget = true;
+                    break;
+                }
+
+                // Best vertex first
+                std::array<int, 4> order{ 0, 1, 2, 3 };
+                std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return values[a] < values[b]; });
+                std::array<cv::Vec3d, 4> sorted_simplex;
+                std::array<double, 4> sorted_values;
+                for (int i = 0; i < 4; i++) {
+                    sorted_simplex[i] = simplex[order[i]];
+                    sorted_values[i] = values[order[i]];
+                }
+                simplex = sorted_simplex;
+                values = sorted_values;
+
+                // Done once the whole simplex is within a degree of the best vertex
+                double simplex_size = 0.0;
+                for (int i = 1; i < 4; i++) {
+                    for (int axis = 0; axis < 3; axis++) {
+                        simplex_size = std::max(simplex_size, std::abs(simplex[i][axis] - simplex[0][axis]));
+                    }
+                }
+                if (simplex_size < 1.0) {
+                    break;
+                }
+
+                const cv::Vec3d centroid = (simplex[0] + simplex[1] + simplex[2]) / 3.0;
+                const cv::Vec3d reflected = clamp_to_range(centroid + (centroid - simplex[3]));
+                const double reflected_value = score_point(reflected);
+
+                if (reflected_value < values[0]) {
+                    const cv::Vec3d expanded = clamp_to_range(centroid + 2.0 * (centroid - simplex[3]));
+                    const double expanded_value = score_point(expanded);
+
+                    if (expanded_value < reflected_value) {
+                        simplex[3] = expanded;
+                        values[3] = expanded_value;
+                    }
+                    else {
+                        simplex[3] = reflected;
+                        values[3] = reflected_value;
+                    }
+                }
+                else if (reflected_value < values[2]) {
+                    simplex[3] = reflected;
+                    values[3] = reflected_value;
+                }
+                else {
+                    const cv::Vec3d contracted = (reflected_value < values[3]) ?
+                        centroid + 0.5 * (reflected - centroid) : centroid + 0.5 * (simplex[3] - centroid);
+                    const double contracted_value = score_point(contracted);
+
+                    if (contracted_value < std::min(reflected_value, values[3])) {
+                        simplex[3] = contracted;
+                        values[3] = contracted_value;
+                    }
+                    else {
+                        for (int i = 1; i < 4; i++) {
+                            simplex[i] = simplex[0] + 0.5 * (simplex[i] - simplex[0]);
+                            values[i] = score_point(simplex[i]);
+                        }
+                    }
+                }
+            }
+        });
+
+        for (std::vector<RotationCandidate>& evaluated : start_candidates) {
+            for (RotationCandidate& c : evaluated) {
+                c.index = (short)evaluated_candidates.size();
+                evaluated_candidates.push_back(c);
+            }
+        }
+
+        // Picked in the same way as the best of the fine search windows
+        std::vector<int> best_indexes = GetBestRotationCandidates(evaluated_candidates, 1);
+
+        if (best_indexes.empty()) {
+            return false;
+        }
+
+        if (stopped_by_time_budget) {
+            quality = kSpinSearchPartiallyRefined;
+            GS_LOG_MSG(info, "Spin search time budget of " + std::to_string(kSpinSearchTimeBudgetMs) + " ms reached during the optimizer search.");
+        }
+
+        const RotationCandidate& bestC = evaluated_candidates[best_indexes[0]];
+        best_rot_x = bestC.x_rotation_degrees;
+        best_rot_y = bestC.y_rotation_degrees;
+        best_rot_z = bestC.z_rotation_degrees;
+
+        // What the coarse grid and (all of) its fine windows would have compared, for the log
+        const int grid_candidates =
+            ((range_end[0] - range_start[0]) / kCoarseXRotationDegreesIncrement + 1) *
+            ((range_end[1] - range_start[1]) / kCoarseYRotationDegreesIncrement + 1) *
+            ((range_end[2] - range_start[2]) / kCoarseZRotationDegreesIncrement + 1);
+        const int fine_y_increment = std::max(1, (int)std::round(kCoarseYRotationDegreesIncrement / 2.));
+        const int fine_window_candidates =
+            (2 * (int)std::ceil(kCoarseXRotationDegreesIncrement / 2.) + 1) *
+            (2 * (int)std::ceil(kCoarseYRotationDegreesIncrement / 2.) / fine_y_increment + 1) *
+            (2 * (int)std::ceil(kCoarseZRotationDegreesIncrement / 2.) + 1);
+        const int grid_evaluations = grid_candidates + fine_window_candidates * (kSpinSearchUseHierarchical ? std::max(1, kSpinSearchTopKCandidates) : 1);
+
+        const int evaluations_used = (int)(seed_candidates.size() + evaluated_candidates.size());
+        GsMetrics::Increment(GsMetrics::Counter::kSpinOptimizerEvaluations, evaluations_used);
+
+        timer1.stop();
+        GS_LOG_MSG(info, "Optimizer spin search: (" + std::to_string(best_rot_x) + ", " + std::to_string(best_rot_y) + ", " + std::to_string(best_rot_z) +
+            ") from " + std::to_string(starts.size()) + " starts after " + std::to_string(evaluations_used) + " evaluations (" +
+            std::to_string(seed_candidates.size()) + " seed + " + std::to_string(evaluated_candidates.size()) + " full-resolution), vs. " +
+            std::to_string(grid_evaluations) + " for the grid search, in " + std::to_string(timer1.elapsed().wall / 1.0e9) + "s.");
 
         return true;
     }
@@ -3739,6 +5455,17 @@ namespace golf_sim {
 
     void BallImageProc::GetRotatedImage(const cv::Mat& gray_2D_input_image, const GolfBall& ball, const cv::Vec3i rotation, cv::Mat& outputGrayImg) {
        BOOST_LOG_FUNCTION();                    
+
+       if (kSpinSearchUseRemapTables && gray_2D_input_image.type() == CV_8UC1) {
+           std::shared_ptr<const RotationRemap> remap = GetRotationRemap(gray_2D_input_image.size(), ball, rotation);
+
+           if (remap) {
+               const cv::Mat source_img = gray_2D_input_image.isContinuous() ? gray_2D_input_image : gray_2D_input_image.clone();
+               outputGrayImg = GsScratchPool::ForThisThread().Get(gray_2D_input_image.rows, gray_2D_input_image.cols, CV_8UC1, cv::Scalar(kPixelIgnoreValue));
+               ApplyRotationRemap(*remap, source_img, outputGrayImg);
+               return;
+           }
+       }
        
        // Project the ball out onto a 3D hemisphere at the current x, y, and z-axis rotation
        // and then unproject back to 2D matrix (image)
@@ -3747,7 +5474,7 @@ namespace golf_sim {
        // TBD - FOR DEBUG
        // outputGrayImg = gray_2D_input_image.clone();
 
-       outputGrayImg = cv::Mat::zeros(gray_2D_input_image.rows, gray_2D_input_image.cols, gray_2D_input_image.type());
+       outputGrayImg = GsScratchPool::ForThisThread().Get(gray_2D_input_image.rows, gray_2D_input_image.cols, gray_2D_input_image.type(), cv::Scalar(0));
        Unproject3dBallTo2dImage(ball3DImage, outputGrayImg, ball);
    }
 
@@ -3846,7 +5573,15 @@ namespace golf_sim {
             float ball3dZOfUnrotatedPoint = 0.0f;
             getBallZ(imageX, imageY, imageXFromCenter, imageYFromCenter, ball3dZOfUnrotatedPoint);
 
-            bool prerotatedPointNotValid = (ball3dZOfUnrotatedPoint <= 0.0001f);  // A 0 value from getBallZ means that the point was outside the ROI
+            projectPoint(pixelValue, imageX, imageY, imageXFromCenter, imageYFromCenter, ball3dZOfUnrotatedPoint);
+        }
+
+        // Rotates a single point that has already been placed on the hemisphere (e.g., by getBallZ
+        // or from a BallProjectionTable) and writes its pixel value into the projected image.
+        void projectPoint(const uchar pixelValue, float imageX, float imageY,
+                          float imageXFromCenter, float imageYFromCenter, const float ball3dZOfUnrotatedPoint) const {
+
+            bool prerotatedPointNotValid = (ball3dZOfUnrotatedPoint <= 0.0001f);  // A 0 value from getBallZ means that the point was outside the ROI
 
             // The following is a sort of safety feature - TBD - do we need this?
             // If the point we are rotating FROM is not on the visible hemisphere, set its pixel value to Ignore it.
@@ -3857,14 +5592,35 @@ namespace golf_sim {
                 // std::cout << "CV_ELEM_SIZE1(traits::Depth<_Tp>::value): " << CV_ELEM_SIZE1(projectedImg_.traits::Depth<_Tp>::value) << "elemSize1()" << projectedImg_.elemSize1() << std::endl;
                 // TBD - Not sure we even need to bother with this?
 
-                // Channel [0] Z is dead data — only write channel [1]
-                projectedImg_.at<cv::Vec2i>((int)imageX, (int)imageY)[1] = kPixelIgnoreValue;
+                projectedImg_.at<uchar>((int)imageX, (int)imageY) = kPixelIgnoreValue;
             }
 
 
             // Note - this method is likely to leave a lot of gaps in the unprojected image.  Consider interpolation?
             // GS_LOG_TRACE_MSG(trace, "projectionOp Result:  [" + std::to_string(imageX) + ", " + std::to_string(imageX) + ", " + std::to_string(ball3dZ) + "]=" + std::to_string(pixelValue));
 
+            int roundedImageX;
+            int roundedImageY;
+
+            if (rotatedDestination(imageXFromCenter, imageYFromCenter, ball3dZOfUnrotatedPoint, roundedImageX, roundedImageY)) {
+                projectedImg_.at<uchar>(roundedImageX, roundedImageY) = (prerotatedPointNotValid ? kPixelIgnoreValue : pixelValue);
+            }
+            else {
+                /** TBD - DEBUG ONLY
+                if (currentBall_->PointIsInsideBall(imageX, imageY)) {
+                    GS_LOG_TRACE_MSG(trace, "Project2dImageTo3dBall SKIPPED a pixel at (" + std::to_string(imageX) +
+                        ", " + std::to_string(imageY) + ").");
+                }
+                */
+            }
+        }
+
+        // Rotates a point on the hemisphere and returns true if it lands on the visible part of the
+        // ball within the image, in which case roundedImageX and roundedImageY are the (first, second)
+        // Mat indexes of the pixel that it lands on.
+        bool rotatedDestination(float imageXFromCenter, float imageYFromCenter, const float ball3dZOfUnrotatedPoint,
+                                int& roundedImageX, int& roundedImageY) const {
+
             float imageZ = ball3dZOfUnrotatedPoint; // Note - the z axis is already situated with the origin in the center
 
             // X-axis rotation
@@ -3889,11 +5645,11 @@ namespace golf_sim {
             }
 
             // Shift back to coordinates with the origin in the top-left
-            imageX = imageXFromCenter + (float)currentBall_->x();
-            imageY = imageYFromCenter + (float)currentBall_->y();
+            float imageX = imageXFromCenter + (float)currentBall_->x();
+            float imageY = imageYFromCenter + (float)currentBall_->y();
 
             // Check if the rotated destination point is on the visible hemisphere.
-            // We only need to know if r² >= x² + y² (no sqrt needed — channel [0] Z value is dead data).
+            // We only need to know if r² >= x² + y² (no sqrt needed — the Z depth is not kept).
             float destXFromCenter = imageX - (float)currentBall_->x();
             float destYFromCenter = imageY - (float)currentBall_->y();
             float r = (float)currentBall_->measured_radius_pixels_;
@@ -3906,20 +5662,12 @@ namespace golf_sim {
                 imageY < projectedImg_.rows &&
                 rotatedPointVisible) {
 
-                    int roundedImageX = (int)(imageX + 0.5f);
-                    int roundedImageY = (int)(imageY + 0.5f);
-
-                    // Channel [0] (Z depth) is never read downstream — skip the write
-                    projectedImg_.at<cv::Vec2i>(roundedImageX, roundedImageY)[1] = (prerotatedPointNotValid ? kPixelIgnoreValue : pixelValue);
-            }
-            else {
-                /** TBD - DEBUG ONLY
-                if (currentBall_->PointIsInsideBall(imageX, imageY)) {
-                    GS_LOG_TRACE_MSG(trace, "Project2dImageTo3dBall SKIPPED a pixel at (" + std::to_string(imageX) +
-                        ", " + std::to_string(imageY) + ").");
-                }
-                */
+                    roundedImageX = (int)(imageX + 0.5f);
+                    roundedImageY = (int)(imageY + 0.5f);
+                    return true;
             }
+
+            return false;
         }
 
         // Instance members — each copy of the functor has its own state (thread-safe)
@@ -3960,17 +5708,457 @@ namespace golf_sim {
     bool projectionOp::s_rotatingOnZ_ = true;
 
 
+    // The hemisphere position of each pixel depends only on the image size and the ball's center and
+    // radius - not on the rotation.  So, rather than re-computing it (including a sqrt) for every
+    // pixel of every rotation candidate, it is computed once per ball and kept in a structure-of-arrays
+    // table.  The values are computed exactly as projectionOp::getBallZ does, so results are unchanged.
+    struct BallProjectionTable {
+        int rows = 0;
+        int cols = 0;
+        long center_x = 0;
+        long center_y = 0;
+        double radius = 0.0;
+
+        // Indexed by (row * cols + col), the same order that the serial path visits the pixels
+        std::vector<float> x_from_center;
+        std::vector<float> y_from_center;
+        std::vector<float> z;
+
+        bool Matches(const cv::Mat& image_gray, const GolfBall& ball) const {
+            return rows == image_gray.rows && cols == image_gray.cols &&
+                center_x == ball.x() && center_y == ball.y() && radius == ball.measured_radius_pixels_;
+        }
+    };
+
+    // A spin analysis will usually involve only a couple of distinct balls (e.g., the full-resolution
+    // and coarse versions of ball 1), and the candidates are computed in parallel, so keep a few tables
+    // behind a lock.
+    static const size_t kMaxCachedBallProjectionTables = 4;
+    static std::vector<std::shared_ptr<const BallProjectionTable>> ball_projection_tables_;
+    static std::mutex ball_projection_tables_mutex_;
+
+    static std::shared_ptr<const BallProjectionTable> GetBallProjectionTable(const cv::Mat& image_gray, const GolfBall& ball) {
+
+        {
+            std::lock_guard<std::mutex> lock(ball_projection_tables_mutex_);
+
+            for (const auto& table : ball_projection_tables_) {
+                if (table->Matches(image_gray, ball)) {
+                    return table;
+                }
+            }
+        }
+
+        // Build the table outside of the lock.  Two threads may occasionally build the same
+        // table, which is harmless.
+        auto table = std::make_shared<BallProjectionTable>();
+        table->rows = image_gray.rows;
+        table->cols = image_gray.cols;
+        table->center_x = ball.x();
+        table->center_y = ball.y();
+        table->radius = ball.measured_radius_pixels_;
+
+        size_t num_pixels = (size_t)image_gray.rows * image_gray.cols;
+        table->x_from_center.resize(num_pixels);
+        table->y_from_center.resize(num_pixels);
+        table->z.resize(num_pixels);
+
+        // getBallZ only needs the ball
+        projectionOp op;
+        op.currentBall_ = &ball;
+
+        // As in forEach, the row is the first (imageX) coordinate
+        size_t i = 0;
+        for (int row = 0; row < image_gray.rows; row++) {
+            for (int col = 0; col < image_gray.cols; col++, i++) {
+                op.getBallZ((float)row, (float)col, table->x_from_center[i], table->y_from_center[i], table->z[i]);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(ball_projection_tables_mutex_);
+
+        if (ball_projection_tables_.size() >= kMaxCachedBallProjectionTables) {
+            ball_projection_tables_.erase(ball_projection_tables_.begin());
+        }
+        ball_projection_tables_.push_back(table);
+
+        return table;
+    }
+
+
+    // A rotated ball image, as a table of where each of its pixels comes from in the un-rotated image.
+    // Like the BallProjectionTable, it only depends on the image size, the ball and the rotation, so one
+    // table serves every image of that ball.  Only the run of each row that comes from somewhere is kept -
+    // the rest of the rotated image is ignored pixels.
+    struct RotationRemap {
+        // The source of a pixel inside a run that is ignored (e.g., a hole left by the rotation)
+        static constexpr uint16_t kNoSource = 0xFFFF;
+
+        int rows = 0;
+        int cols = 0;
+
+        // The run of row r is columns [row_begin[r], row_end[r]), and the source of each of its
+        // pixels (row * cols + col in the un-rotated image) is at sources[row_offset[r] + col - row_begin[r]]
+        std::vector<int> row_begin;
+        std::vector<int> row_end;
+        std::vector<int> row_offset;
+        std::vector<uint16_t> sources;
+
+        size_t SizeInBytes() const {
+            return sizeof(RotationRemap) + (row_begin.size() + row_end.size() + row_offset.size()) * sizeof(int) +
+                   sources.size() * sizeof(uint16_t);
+        }
+    };
+
+    // Image rows and cols, ball center x and y, radius (as quantized), and the x, y and z rotations
+    using RotationRemapKey = std::tuple<int, int, long, long, double, int, int, int>;
+
+    // The coarse search alone has a few thousand rotations, so the tables are kept in a map, and the
+    // oldest are dropped once they add up to more than the limit.
+    static const size_t kMaxCachedRotationRemapBytes = 64 * 1024 * 1024;
+    static std::map<RotationRemapKey, std::shared_ptr<const RotationRemap>> rotation_remaps_;
+    static std::deque<RotationRemapKey> rotation_remap_order_;
+    static size_t rotation_remap_bytes_ = 0;
+    static std::mutex rotation_remaps_mutex_;
+
+    std::shared_ptr<const RotationRemap> BallImageProc::GetRotationRemap(const cv::Size& image_size, const GolfBall& ball,
+                                                                         const cv::Vec3i& rotation_angles_degrees) {
+        const int rows = image_size.height;
+        const int cols = image_size.width;
+        const int num_pixels = rows * cols;
+
+        // The sources are 16 bits
+        if (num_pixels >= RotationRemap::kNoSource) {
+            return nullptr;
+        }
+
+        GolfBall remap_ball = ball;
+
+        if (kSpinSearchRemapRadiusQuantum > 0.0) {
+            remap_ball.measured_radius_pixels_ = std::round(ball.measured_radius_pixels_ / kSpinSearchRemapRadiusQuantum) * kSpinSearchRemapRadiusQuantum;
+        }
+
+        const RotationRemapKey key{ rows, cols, remap_ball.x(), remap_ball.y(), remap_ball.measured_radius_pixels_,
+                                    rotation_angles_degrees[0], rotation_angles_degrees[1], rotation_angles_degrees[2] };
+
+        {
+            std::lock_guard<std::mutex> lock(rotation_remaps_mutex_);
+
+            auto found = rotation_remaps_.find(key);
+            if (found != rotation_remaps_.end()) {
+                return found->second;
+            }
+        }
+
+        // Build the table outside of the lock, by replaying the serial loop of Project2dImageTo3dBall
+        // with the index of each source pixel in place of its value.  As there, a later write to a
+        // pixel replaces an earlier one.  -1 is an ignored pixel.
+        std::vector<int> source_of_pixel(num_pixels, -1);
+
+        float x_rad = -(float)CvUtils::DegreesToRadians((double)rotation_angles_degrees[0]);
+        float y_rad = (float)CvUtils::DegreesToRadians((double)rotation_angles_degrees[1]);
+        float z_rad = (float)CvUtils::DegreesToRadians((double)rotation_angles_degrees[2]);
+
+        // The op is only used for the rotation, which needs the size of the projected image
+        cv::Mat projection_size_image(rows, cols, CV_8UC1);
+        projectionOp op(&remap_ball, projection_size_image, x_rad, y_rad, z_rad);
+
+        std::shared_ptr<const BallProjectionTable> table = GetBallProjectionTable(projection_size_image, remap_ball);
+
+        for (int i = 0; i < num_pixels; i++) {
+            // Same test as projectionOp::projectPoint
+            const bool source_not_valid = (table->z[i] <= 0.0001f);
+
+            if (source_not_valid) {
+                source_of_pixel[i] = -1;
+            }
+
+            int rounded_row;
+            int rounded_col;
+
+            if (op.rotatedDestination(table->x_from_center[i], table->y_from_center[i], table->z[i], rounded_row, rounded_col)) {
+                // The at<uchar>(rounded_row, rounded_col) pixel of the (continuous) projected image.
+                // Anything past its end would not have been a pixel of the image at all.
+                const int destination = rounded_row * cols + rounded_col;
+
+                if (destination < num_pixels) {
+                    source_of_pixel[destination] = source_not_valid ? -1 : i;
+                }
+            }
+        }
+
+        auto remap = std::make_shared<RotationRemap>();
+        remap->rows = rows;
+        remap->cols = cols;
+        remap->row_begin.resize(rows);
+        remap->row_end.resize(rows);
+        remap->row_offset.resize(rows);
+
+        for (int row = 0; row < rows; row++) {
+            const int* row_sources = source_of_pixel.data() + (size_t)row * cols;
+
+            int begin = 0;
+            while (begin < cols && row_sources[begin] < 0) {
+                begin++;
+            }
+
+            int end = cols;
+            while (end > begin && row_sources[end - 1] < 0) {
+                end--;
+            }
+
+            remap->row_begin[row] = begin;
+            remap->row_end[row] = end;
+            remap->row_offset[row] = (int)remap->sources.size();
+
+            for (int col = begin; col < end; col++) {
+                remap->sources.push_back(row_sources[col] < 0 ? RotationRemap::kNoSource : (uint16_t)row_sources[col]);
+            }
+        }
+
+        remap->sources.shrink_to_fit();
+
+        std::lock_guard<std::mutex> lock(rotation_remaps_mutex_);
+
+        // Another thread may have built the same table in the meantime
+        auto inserted = rotation_remaps_.emplace(key, remap);
+        if (!inserted.second) {
+            return inserted.first->second;
+        }
+
+        rotation_remap_order_.push_back(key);
+        rotation_remap_bytes_ += remap->SizeInBytes();
+
+        while (rotation_remap_bytes_ > kMaxCachedRotationRemapBytes && rotation_remap_order_.size() > 1) {
+            auto oldest = rotation_remaps_.find(rotation_remap_order_.front());
+            rotation_remap_bytes_ -= oldest->second->SizeInBytes();
+            rotation_remaps_.erase(oldest);
+            rotation_remap_order_.pop_front();
+        }
+
+        return remap;
+    }
+
+    void BallImageProc::ApplyRotationRemap(const RotationRemap& remap, const cv::Mat& source_img, cv::Mat& rotated_img) {
+
+        CV_Assert((rotated_img.rows == remap.rows && rotated_img.cols == remap.cols && source_img.size() == rotated_img.size()));
+        CV_Assert((rotated_img.type() == CV_8UC1 && source_img.type() == CV_8UC1 && source_img.isContinuous()));
+
+        const uchar* source_pixels = source_img.ptr<uchar>(0);
+
+        for (int y = 0; y < remap.rows; y++) {
+            uchar* row = rotated_img.ptr<uchar>(y);
+            const uint16_t* sources = remap.sources.data() + remap.row_offset[y] - remap.row_begin[y];
+
+            std::fill(row, row + remap.row_begin[y], kPixelIgnoreValue);
+
+            for (int x = remap.row_begin[y]; x < remap.row_end[y]; x++) {
+                const uint16_t source = sources[x];
+                row[x] = (source == RotationRemap::kNoSource) ? kPixelIgnoreValue : source_pixels[source];
+            }
+
+            std::fill(row + remap.row_end[y], row + remap.cols, kPixelIgnoreValue);
+        }
+    }
+
+    GS_HOT_KERNEL cv::Vec2i BallImageProc::CompareRemappedRotationImage(const cv::Mat& img1, const RotationCandidate& candidate,
+                                                                        double min_score_to_beat, bool& terminated_early) {
+
+        const RotationRemap& remap = *candidate.remap;
+        const cv::Mat& source_image = candidate.source_img;
+
+        CV_Assert((img1.rows == remap.rows && img1.cols == remap.cols && source_image.size() == img1.size()));
+        CV_Assert((img1.type() == CV_8UC1 && source_image.type() == CV_8UC1 && source_image.isContinuous()));
+
+        // The same as CompareRotationImageWithCutoff, so that the cut-offs happen in the same places
+        const int kRowsBetweenCutoffChecks = 4;
+
+        const uchar* source_pixels = source_image.ptr<uchar>(0);
+        long score = 0;
+        long totalPixelsExamined = 0;
+        terminated_early = false;
+
+        for (int y = 0; y < remap.rows; y++) {
+            // Everything outside of the row's run is ignored in the candidate image
+            const uchar* row1 = img1.ptr<uchar>(y);
+            const uint16_t* sources = remap.sources.data() + remap.row_offset[y] - remap.row_begin[y];
+
+            for (int x = remap.row_begin[y]; x < remap.row_end[y]; x++) {
+                const uint16_t source = sources[x];
+
+                if (source == RotationRemap::kNoSource) {
+                    continue;
+                }
+
+                uchar p1 = row1[x];
+                uchar p2 = source_pixels[source];
+
+                if (p1 != kPixelIgnoreValue && p2 != kPixelIgnoreValue) {
+                    totalPixelsExamined++;
+                    if (p1 == p2) {
+                        score++;
+                    }
+                }
+            }
+
+            if ((y + 1) % kRowsBetweenCutoffChecks == 0 && y + 1 < remap.rows) {
+                // Best case, every remaining pixel is examined and matches
+                long remaining_pixels = (long)(remap.rows - (y + 1)) * remap.cols;
+                double best_possible_score = (double)(score + remaining_pixels) / (double)(totalPixelsExamined + remaining_pixels);
+
+                if (best_possible_score < min_score_to_beat) {
+                    terminated_early = true;
+                    break;
+                }
+            }
+        }
+
+        return cv::Vec2i(score, totalPixelsExamined);
+    }
+
+    GS_HOT_KERNEL cv::Vec2i BallImageProc::CompareRemappedRotationImage(const GsTernaryImage& img1, const RotationCandidate& candidate,
+                                                                        double min_score_to_beat, bool& terminated_early) {
+
+        const RotationRemap& remap = *candidate.remap;
+        const cv::Mat& source_image = candidate.source_img;
+
+        CV_Assert((img1.rows() == remap.rows && img1.cols() == remap.cols && source_image.rows == remap.rows && source_image.cols == remap.cols));
+        CV_Assert((source_image.type() == CV_8UC1 && source_image.isContinuous()));
+
+        // The same as CompareRotationImageWithCutoff, so that the cut-offs happen in the same places
+        const int kRowsBetweenCutoffChecks = 4;
+
+        const int words_per_row = img1.words_per_row();
+
+        // One row of the candidate image, re-used by each thread from one candidate to the next
+        thread_local std::vector<uint64_t> candidate_row;
+        candidate_row.resize(2 * (size_t)words_per_row);
+        uint64_t* candidate_valid = candidate_row.data();
+        uint64_t* candidate_white = candidate_row.data() + words_per_row;
+
+        const uchar* source_pixels = source_image.ptr<uchar>(0);
+        long score = 0;
+        long totalPixelsExamined = 0;
+        terminated_early = false;
+
+        for (int y = 0; y < remap.rows; y++) {
+            std::fill(candidate_row.begin(), candidate_row.end(), 0);
+
+            // Everything outside of the row's run is ignored in the candidate image
+            const uint16_t* sources = remap.sources.data() + remap.row_offset[y] - remap.row_begin[y];
+
+            for (int x = remap.row_begin[y]; x < remap.row_end[y]; x++) {
+                const uint16_t source = sources[x];
+
+                if (source == RotationRemap::kNoSource) {
+                    continue;
+                }
+
+                const uchar p2 = source_pixels[source];
+                const uint64_t bit = (uint64_t)1 << (x % 64);
+
+                candidate_valid[x / 64] |= (p2 != kPixelIgnoreValue) ? bit : 0;
+                candidate_white[x / 64] |= (p2 == 255) ? bit : 0;
+            }
+
+            // Only the words that the run touches can have any valid candidate pixels
+            const int first_word = remap.row_begin[y] / 64;
+            const int end_word = (remap.row_end[y] + 63) / 64;
+
+            if (end_word > first_word) {
+                GsTernaryImage::CountRow(img1.ValidRow(y) + first_word, img1.WhiteRow(y) + first_word,
+                                         candidate_valid + first_word, candidate_white + first_word,
+                                         end_word - first_word, score, totalPixelsExamined);
+            }
+
+            if (min_score_to_beat >= 0.0 && (y + 1) % kRowsBetweenCutoffChecks == 0 && y + 1 < remap.rows) {
+                // Best case, every remaining pixel is examined and matches
+                long remaining_pixels = (long)(remap.rows - (y + 1)) * remap.cols;
+                double best_possible_score = (double)(score + remaining_pixels) / (double)(totalPixelsExamined + remaining_pixels);
+
+                if (best_possible_score < min_score_to_beat) {
+                    terminated_early = true;
+                    break;
+                }
+            }
+        }
+
+        return cv::Vec2i(score, totalPixelsExamined);
+    }
+
+    bool BallImageProc::ScoreCandidateAnglesOnGpu(const cv::Mat& base_dimple_image, const GolfBall& ball,
+                                                  const cv::Mat& target_image, std::vector<RotationCandidate>& candidates) {
+
+        GsGpuSpinSearch* gpu = GsGpuSpinSearch::Instance();
+
+        if (gpu == nullptr) {
+            return false;
+        }
+
+        // The same hemisphere positions as the serial projection uses
+        std::shared_ptr<const BallProjectionTable> table = GetBallProjectionTable(base_dimple_image, ball);
+
+        GsGpuSpinProjection projection;
+        projection.x_from_center = table->x_from_center.data();
+        projection.y_from_center = table->y_from_center.data();
+        projection.z = table->z.data();
+        projection.center_x = (float)ball.x();
+        projection.center_y = (float)ball.y();
+        projection.radius = (float)ball.measured_radius_pixels_;
+        projection.ignore_value = kPixelIgnoreValue;
+
+        // The same angles (and sines and cosines) as Project2dImageTo3dBall and projectionOp
+        std::vector<GsGpuSpinRotation> rotations(candidates.size());
+
+        for (size_t i = 0; i < candidates.size(); i++) {
+            const RotationCandidate& c = candidates[i];
+            float x_rad = -(float)CvUtils::DegreesToRadians((double)c.x_rotation_degrees);
+            float y_rad = (float)CvUtils::DegreesToRadians((double)c.y_rotation_degrees);
+            float z_rad = (float)CvUtils::DegreesToRadians((double)c.z_rotation_degrees);
+
+            GsGpuSpinRotation& rotation = rotations[i];
+            rotation.sin_x = sinf(x_rad);
+            rotation.cos_x = cosf(x_rad);
+            rotation.sin_y = sinf(y_rad);
+            rotation.cos_y = cosf(y_rad);
+            rotation.sin_z = sinf(z_rad);
+            rotation.cos_z = cosf(z_rad);
+            rotation.rotating_on_x = (std::abs(x_rad) > 0.001f);
+            rotation.rotating_on_y = (std::abs(y_rad) > 0.001f);
+            rotation.rotating_on_z = (std::abs(z_rad) > 0.001f);
+        }
+
+        std::vector<cv::Vec2i> scores;
+
+        if (!gpu->ScoreRotations(base_dimple_image, target_image, projection, rotations, scores)) {
+            return false;
+        }
+
+        for (size_t i = 0; i < candidates.size(); i++) {
+            RotationCandidate& c = candidates[i];
+            c.pixels_matching = scores[i][0];
+            c.pixels_examined = scores[i][1];
+            c.score = (double)c.pixels_matching / (double)c.pixels_examined;
+            c.scored = true;
+        }
+
+        return true;
+    }
+
+
     // Positive X-axis angles rotate so that the ball appears to go from left to right
     // positive Y-axis angles move the ball from the top to the bottom
     // positive Z-Axis angles are counter-clockwise looking down the positive z-axis
     // The image_gray input Mat is expected to have pixels with only 0, 255, or kPixelIgnoreValue
     cv::Mat BallImageProc::Project2dImageTo3dBall(const cv::Mat& image_gray, const GolfBall& ball, const cv::Vec3i& rotation_angles_degrees, bool force_serial) {
 
-        // Create a new 3D Mat to hold the results
-        int sizes[2] = { image_gray.rows, image_gray.cols };
+        // Create a new Mat to hold the results.  Only the (0/255/ignore) pixel value of each
+        // projected point is used downstream, so the Z-depth is not kept and the result is
+        // a packed 8-bit plane (1 byte/pixel instead of the 8 bytes of a CV_32SC2).
         // It's possible that due to rotations, some of the 3D image might have "holes" where
         // the pixel was not set to a value.  Make sure anything we don't set is ignored.
-        cv::Mat projectedImg = cv::Mat(2, sizes, CV_32SC2, cv::Scalar(0, kPixelIgnoreValue));
+        // There are hundreds of these per shot, all the same size, so they come from the scratch pool.
+        cv::Mat projectedImg = GsScratchPool::ForThisThread().Get(image_gray.rows, image_gray.cols, CV_8UC1, cv::Scalar(kPixelIgnoreValue));
         // TBD - hack to pass the 3D image size to the call-back function
         // Kind of a hack, because a 3D Mat won't usually have these values set.  TBD
         projectedImg.rows = image_gray.rows;
@@ -3983,20 +6171,40 @@ namespace golf_sim {
         // Create a thread-safe functor with all state in instance members
         projectionOp op(&ball, projectedImg, x_rad, y_rad, z_rad);
 
-        if (kSerializeOpsForDebug || force_serial) {
-            // Serial path — used inside OMP parallel regions to avoid thread contention
-            // Keep original x-outer/y-inner order to match projectionOp's coordinate semantics
-            // (position[0]=x is treated as the first Mat index in at<>() calls)
-            for (int x = 0; x < image_gray.cols; x++) {
-                for (int y = 0; y < image_gray.rows; y++) {
-                    int position[]{ x, y };
-                    uchar pixel = image_gray.at<uchar>(x, y);
+        if (force_serial) {
+            // Serial path — used when the caller already runs many projections in parallel.
+            // The un-rotated hemisphere positions come from the (shared) table, so only the
+            // rotation itself is done per candidate.
+            std::shared_ptr<const BallProjectionTable> table = GetBallProjectionTable(image_gray, ball);
+            const float* x_from_center = table->x_from_center.data();
+            const float* y_from_center = table->y_from_center.data();
+            const float* z = table->z.data();
+
+            // Row-major, with the same coordinates that forEach passes to projectionOp
+            // (position[0] is the row, and is treated as the first Mat index in at<>() calls)
+            size_t i = 0;
+            for (int row = 0; row < image_gray.rows; row++) {
+                const uchar* pixels = image_gray.ptr<uchar>(row);
+                for (int col = 0; col < image_gray.cols; col++, i++) {
+                    op.projectPoint(pixels[col], (float)row, (float)col, x_from_center[i], y_from_center[i], z[i]);
+                }
+            }
+        }
+        else if (kSerializeOpsForDebug) {
+            // Same coordinates as forEach, one pixel at a time
+            for (int row = 0; row < image_gray.rows; row++) {
+                const uchar* pixels = image_gray.ptr<uchar>(row);
+                for (int col = 0; col < image_gray.cols; col++) {
+                    int position[]{ row, col };
+                    uchar pixel = pixels[col];
                     op(pixel, position);
                 }
             }
         }
         else {
-            // forEach uses OpenCV's internal thread pool — only use outside OMP regions
+            // forEach uses OpenCV's parallel backend — the shared GsThreadPool if kUseSharedWorkerPool
+            // is set (which is safe to nest), or else OpenCV's own pool, which should not be used from
+            // inside an OpenMP region
             image_gray.forEach<uchar>(op);
         }
 
@@ -4008,32 +6216,8 @@ namespace golf_sim {
         // TBD - We already essentially have a 2D Mat.  So why spend all this time copying?
         // Can we just go on to use the 3D Mat?
         // Currently, this function is only used when we need to display one of the 3D projections.
-        for (int x = 0; x < destination_image_gray.cols; x++) {
-            for (int y = 0; y < destination_image_gray.rows; y++) {
-                int position[]{ x, y };
-                // There is only one Z-plane in the reduced image - at z = 0
-                // The reduced image is a set of uints, so we seem to need to normalize to 0-255 - TBD - why??
-                int maxValueZ = src3D.at<cv::Vec2i>(x, y)[0];
-                int pixelValue = src3D.at<cv::Vec2i>(x, y)[1];
-
-                int original_pixel_value = (int)destination_image_gray.at<uchar>(x, y);
-                /* ONLY FOR DEBUG - TBD
-                if (pixelValue != original_pixel_value) {
-                    GS_LOG_TRACE_MSG(trace, "Unproject3dBallTo2dImage found different pixel value of " + std::to_string(pixelValue) +
-                        " (was " + std::to_string(original_pixel_value) + ") at( " + std::to_string(x) + ", " + std::to_string(y) + ").");
-                }
-                // std::cout << "pixel from 3D image: " << (int)pixelValue << std::endl;
-                */
-                destination_image_gray.at<uchar>(x, y) = pixelValue;  // was uchar
-
-                // FOR DEBUG ONLY
-                /* ONLY FOR DEBUG - TBD
-                if (ball.PointIsInsideBall(x, y) && pixelValue == kPixelIgnoreValue) {
-                    GS_LOG_TRACE_MSG(trace, "Unproject3dBallTo2dImage found ignore pixel within ball at (" + std::to_string(x) + ", " + std::to_string(y) + ").");
-                }
-                */
-            }
-        }
+        // The projected image is a single 8-bit plane of pixel values.
+        GsPixelKernels::CopyOverlap(src3D, destination_image_gray);
 
         // LoggingTools::DebugShowImage("destination_image_gray", destination_image_gray);
         // We're trying to fill in holes here, but this may be fuzzing up the picture too much
@@ -4118,7 +6302,8 @@ namespace golf_sim {
      */
     bool BallImageProc::DetectBalls(const cv::Mat& preprocessed_img, BallSearchMode search_mode,
                                    std::vector<GsCircle>& detected_circles,
-                                    bool report_find_failures) {
+                                    bool report_find_failures,
+                                    std::vector<NCNNDetector::Detection>* detections) {
         GS_LOG_TRACE_MSG(trace, "BallImageProc::DetectBalls - Method: " + kStrobedBallDetectionMethod);
 
 		std::string detection_method = (search_mode == BallSearchMode::kFindPlacedBall) ? kBallPlacementDetectionMethod : kStrobedBallDetectionMethod;
@@ -4126,7 +6311,7 @@ namespace golf_sim {
         if (detection_method == "legacy") {
             return DetectBallsHoughCircles(preprocessed_img, search_mode, detected_circles);
         } else if (detection_method == "experimental") {
-            return DetectBallsNCNN(preprocessed_img, search_mode, detected_circles, report_find_failures);
+            return DetectBallsNCNN(preprocessed_img, search_mode, detected_circles, report_find_failures, detections);
         } else {
             GS_LOG_MSG(error, "Unknown detection method: " + detection_method);
             return DetectBallsHoughCircles(preprocessed_img, search_mode, detected_circles);
@@ -4149,6 +6334,330 @@ namespace golf_sim {
     /**
      * Single-class NMS for golf ball detection
      */
+    void BallImageProc::FindRadialEdgePoints(const cv::Mat& gray, double cx, double cy, double r, double band,
+                                             int number_rays, double min_edge_strength,
+                                             std::vector<cv::Point2d>& edge_points, std::vector<double>& edge_radii) {
+
+        CV_Assert(gray.type() == CV_8UC1);
+
+        auto sample = [&gray](double x, double y, double& value) {
+            const int x0 = (int)std::floor(x);
+            const int y0 = (int)std::floor(y);
+            if (x0 < 0 || y0 < 0 || x0 + 1 >= gray.cols || y0 + 1 >= gray.rows) {
+                return false;
+            }
+            const double fx = x - x0;
+            const double fy = y - y0;
+            const uchar* row0 = gray.ptr<uchar>(y0);
+            const uchar* row1 = gray.ptr<uchar>(y0 + 1);
+            value = (1 - fy) * ((1 - fx) * row0[x0] + fx * row0[x0 + 1]) + fy * ((1 - fx) * row1[x0] + fx * row1[x0 + 1]);
+            return true;
+        };
+
+        const double step = 0.5;
+        const int number_steps = (int)(2 * band / step) + 1;
+
+        edge_points.clear();
+        edge_radii.clear();
+        std::vector<double> profile(number_steps);
+
+        for (int ray = 0; ray < number_rays; ray++) {
+            const double angle = 2.0 * CV_PI * ray / number_rays;
+            const double dx = std::cos(angle);
+            const double dy = std::sin(angle);
+
+            bool ray_in_image = true;
+            for (int s = 0; s < number_steps && ray_in_image; s++) {
+                const double radius = r - band + s * step;
+                ray_in_image = sample(cx + radius * dx, cy + radius * dy, profile[s]);
+            }
+            if (!ray_in_image) {
+                continue;
+            }
+
+            // Central differences.  The ball may be brighter or darker than what is behind it.
+            int best_s = -1;
+            double best_gradient = 0.0;
+            for (int s = 1; s + 1 < number_steps; s++) {
+                const double gradient = std::abs(profile[s + 1] - profile[s - 1]);
+                if (gradient > best_gradient) {
+                    best_gradient = gradient;
+                    best_s = s;
+                }
+            }
+
+            // Ignore the ray if there is no real edge, or if the peak is at the end of the band
+            if (best_s < 2 || best_s + 2 >= number_steps || best_gradient < min_edge_strength) {
+                continue;
+            }
+
+            // Fit a parabola through the gradient peak and its neighbours
+            const double g_minus = std::abs(profile[best_s] - profile[best_s - 2]);
+            const double g_plus = std::abs(profile[best_s + 2] - profile[best_s]);
+            const double denominator = g_minus - 2.0 * best_gradient + g_plus;
+            const double offset = (std::abs(denominator) > 1e-9) ? 0.5 * (g_minus - g_plus) / denominator : 0.0;
+
+            const double edge_radius = r - band + (best_s + std::clamp(offset, -0.5, 0.5)) * step;
+            edge_radii.push_back(edge_radius);
+            edge_points.emplace_back(cx + edge_radius * dx, cy + edge_radius * dy);
+        }
+    }
+
+    bool BallImageProc::FitBallEllipseToEdges(const cv::Mat& img, const GsCircle& reference_ball_circle, cv::RotatedRect& ellipse) {
+
+        const double cx = reference_ball_circle[0];
+        const double cy = reference_ball_circle[1];
+        const double r = reference_ball_circle[2];
+
+        if (img.empty() || r < 3.0) {
+            return false;
+        }
+
+        cv::Mat gray;
+        if (img.channels() == 3) {
+            cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY);
+        }
+        else {
+            gray = img;
+        }
+
+        if (gray.type() != CV_8UC1) {
+            gray.convertTo(gray, CV_8UC1);
+        }
+
+        const int number_rays = std::max(8, kSubpixelRadiusRays);
+        const double band = std::max(2.0, kSubpixelRadiusSearchFraction * r);
+
+        std::vector<cv::Point2d> edge_points;
+        std::vector<double> edge_radii;
+        FindRadialEdgePoints(gray, cx, cy, r, band, number_rays, kSubpixelRadiusMinimumEdgeStrength, edge_points, edge_radii);
+
+        const int minimum_inliers = std::max(5, number_rays / 2);
+
+        if ((int)edge_points.size() < minimum_inliers) {
+            GS_LOG_TRACE_MSG(trace, "FitBallEllipseToEdges - only " + std::to_string(edge_points.size()) + " of " +
+                std::to_string(number_rays) + " rays found an edge.");
+            return false;
+        }
+
+        std::vector<cv::Point2f> points(edge_points.begin(), edge_points.end());
+
+        // Approximately the distance from p to the ellipse, along the line through its center
+        auto distance_to_ellipse = [](const cv::RotatedRect& e, const cv::Point2f& p) {
+            const double a = e.size.width / 2.0;
+            const double b = e.size.height / 2.0;
+            const double theta = e.angle * CV_PI / 180.0;
+            const double dx = p.x - e.center.x;
+            const double dy = p.y - e.center.y;
+            const double u = dx * std::cos(theta) + dy * std::sin(theta);
+            const double v = -dx * std::sin(theta) + dy * std::cos(theta);
+            const double normalized_radius = std::sqrt((u * u) / (a * a) + (v * v) / (b * b));
+            return (normalized_radius > 1e-9) ? std::abs(1.0 - 1.0 / normalized_radius) * std::hypot(u, v) : std::min(a, b);
+        };
+
+        // The ball is a circle seen at a slight angle, so anything else was fit to something else
+        auto plausible = [cx, cy, r, band](const cv::RotatedRect& e) {
+            const double minor_axis = std::min(e.size.width, e.size.height) / 2.0;
+            const double major_axis = std::max(e.size.width, e.size.height) / 2.0;
+            return minor_axis > 0.0 && minor_axis >= r - band && major_axis <= r + band &&
+                   minor_axis / major_axis >= 0.8 && std::hypot(e.center.x - cx, e.center.y - cy) <= band;
+        };
+
+        const double inlier_distance = std::max(1.0, 0.02 * r);
+
+        // Seeded, so that the same image always gives the same outline
+        cv::RNG rng(0x9e3779b9);
+        std::vector<cv::Point2f> sample_points(5);
+        std::vector<int> sample_indexes(5);
+        cv::RotatedRect best_fit;
+        int best_inliers = 0;
+
+        for (int iteration = 0; iteration < kFastEllipseRansacIterations; iteration++) {
+            for (int i = 0; i < 5; i++) {
+                int index;
+                do {
+                    index = rng.uniform(0, (int)points.size());
+                } while (std::find(sample_indexes.begin(), sample_indexes.begin() + i, index) != sample_indexes.begin() + i);
+                sample_indexes[i] = index;
+                sample_points[i] = points[index];
+            }
+
+            const cv::RotatedRect candidate = cv::fitEllipseDirect(sample_points);
+            if (!plausible(candidate)) {
+                continue;
+            }
+
+            int inliers = 0;
+            for (const cv::Point2f& p : points) {
+                inliers += (distance_to_ellipse(candidate, p) <= inlier_distance) ? 1 : 0;
+            }
+
+            if (inliers > best_inliers) {
+                best_inliers = inliers;
+                best_fit = candidate;
+
+                // Nothing is left to be found
+                if (best_inliers == (int)points.size()) {
+                    break;
+                }
+            }
+        }
+
+        if (best_inliers < minimum_inliers) {
+            GS_LOG_TRACE_MSG(trace, "FitBallEllipseToEdges - the best fit had only " + std::to_string(best_inliers) + " inliers.");
+            return false;
+        }
+
+        // Refit to all of the inliers of the best sample
+        std::vector<cv::Point2f> inlier_points;
+        for (const cv::Point2f& p : points) {
+            if (distance_to_ellipse(best_fit, p) <= inlier_distance) {
+                inlier_points.push_back(p);
+            }
+        }
+
+        const cv::RotatedRect final_fit = cv::fitEllipseDirect(inlier_points);
+        if (!plausible(final_fit)) {
+            return false;
+        }
+
+        GS_LOG_TRACE_MSG(trace, "FitBallEllipseToEdges - " + std::to_string(inlier_points.size()) + " of " + std::to_string(number_rays) +
+            " rays fit an ellipse at (" + std::to_string(final_fit.center.x) + ", " + std::to_string(final_fit.center.y) + "), axes " +
+            std::to_string(final_fit.size.width) + " x " + std::to_string(final_fit.size.height));
+
+        ellipse = final_fit;
+        return true;
+    }
+
+    bool BallImageProc::RefineBallRadiusSubpixel(const cv::Mat& img, GsCircle& circle, double& confidence) {
+
+        confidence = 0.0;
+
+        const double cx = circle[0];
+        const double cy = circle[1];
+        const double r = circle[2];
+
+        if (img.empty() || r < 3.0) {
+            return false;
+        }
+
+        cv::Mat gray;
+        if (img.channels() == 3) {
+            cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY);
+        }
+        else {
+            gray = img;
+        }
+
+        if (gray.type() != CV_8UC1) {
+            gray.convertTo(gray, CV_8UC1);
+        }
+
+        // Look for the strongest edge along each ray, within the search band around the detected radius
+        const int number_rays = std::max(8, kSubpixelRadiusRays);
+        const double band = std::max(2.0, kSubpixelRadiusSearchFraction * r);
+
+        std::vector<cv::Point2d> edge_points;
+        std::vector<double> edge_radii;
+        FindRadialEdgePoints(gray, cx, cy, r, band, number_rays, kSubpixelRadiusMinimumEdgeStrength, edge_points, edge_radii);
+
+        if ((int)edge_points.size() < number_rays / 2) {
+            GS_LOG_TRACE_MSG(trace, "RefineBallRadiusSubpixel - only " + std::to_string(edge_points.size()) + " of " +
+                std::to_string(number_rays) + " rays found an edge.  Keeping the original radius.");
+            return false;
+        }
+
+        // Drop the edges that are far from the typical radius (e.g., a tee or a shadow)
+        std::vector<double> sorted_radii = edge_radii;
+        std::nth_element(sorted_radii.begin(), sorted_radii.begin() + sorted_radii.size() / 2, sorted_radii.end());
+        const double median_radius = sorted_radii[sorted_radii.size() / 2];
+        const double outlier_distance = std::max(1.0, 0.05 * median_radius);
+
+        std::vector<cv::Point2d> inliers;
+        for (size_t i = 0; i < edge_points.size(); i++) {
+            if (std::abs(edge_radii[i] - median_radius) <= outlier_distance) {
+                inliers.push_back(edge_points[i]);
+            }
+        }
+
+        if ((int)inliers.size() < number_rays / 2) {
+            return false;
+        }
+
+        // Algebraic (Kasa) least-squares circle fit:  x^2 + y^2 + D x + E y + F = 0
+        // Centered on the original circle to keep the normal equations well conditioned
+        cv::Mat A((int)inliers.size(), 3, CV_64F);
+        cv::Mat b((int)inliers.size(), 1, CV_64F);
+        for (int i = 0; i < (int)inliers.size(); i++) {
+            const double x = inliers[i].x - cx;
+            const double y = inliers[i].y - cy;
+            A.at<double>(i, 0) = x;
+            A.at<double>(i, 1) = y;
+            A.at<double>(i, 2) = 1.0;
+            b.at<double>(i, 0) = -(x * x + y * y);
+        }
+
+        cv::Mat solution;
+        if (!cv::solve(A, b, solution, cv::DECOMP_SVD)) {
+            return false;
+        }
+
+        const double center_x = -solution.at<double>(0) / 2.0;
+        const double center_y = -solution.at<double>(1) / 2.0;
+        const double radius_squared = center_x * center_x + center_y * center_y - solution.at<double>(2);
+
+        if (radius_squared <= 0.0) {
+            return false;
+        }
+
+        const double fitted_radius = std::sqrt(radius_squared);
+
+        double residual_squared_sum = 0.0;
+        for (const cv::Point2d& p : inliers) {
+            const double residual = std::hypot(p.x - cx - center_x, p.y - cy - center_y) - fitted_radius;
+            residual_squared_sum += residual * residual;
+        }
+        const double residual_rms = std::sqrt(residual_squared_sum / inliers.size());
+
+        // A refinement that moves the circle a long way means that something else was fit
+        if (std::abs(fitted_radius - r) > band || std::hypot(center_x, center_y) > band) {
+            GS_LOG_TRACE_MSG(trace, "RefineBallRadiusSubpixel - the fitted circle moved too far.  Keeping the original radius.");
+            return false;
+        }
+
+        // Mostly the fraction of the ball's edge that was found, reduced if the edge is ragged
+        confidence = ((double)inliers.size() / number_rays) / (1.0 + residual_rms);
+
+        GS_LOG_TRACE_MSG(trace, "RefineBallRadiusSubpixel - radius " + std::to_string(r) + " -> " + std::to_string(fitted_radius) +
+            ", center moved (" + std::to_string(center_x) + ", " + std::to_string(center_y) + "), residual " +
+            std::to_string(residual_rms) + " px, confidence " + std::to_string(confidence));
+
+        circle[0] = (float)(cx + center_x);
+        circle[1] = (float)(cy + center_y);
+        circle[2] = (float)fitted_radius;
+
+        return true;
+    }
+
+    bool BallImageProc::RefineBallRadiusSubpixel(const cv::Mat& img, GolfBall& ball) {
+
+        if (!kUseSubpixelRadiusRefinement) {
+            return false;
+        }
+
+        GsCircle circle = ball.ball_circle_;
+        double confidence = 0.0;
+
+        if (!RefineBallRadiusSubpixel(img, circle, confidence)) {
+            ball.radius_confidence_ = 0.0;
+            return false;
+        }
+
+        ball.set_circle(circle);
+        ball.radius_confidence_ = confidence;
+        return true;
+    }
+
     std::vector<int> BallImageProc::SingleClassNMS(const std::vector<cv::Rect>& boxes,
                                                    const std::vector<float>& confidences,
                                                    float conf_threshold,
@@ -4172,42 +6681,16 @@ namespace golf_sim {
         std::sort(confidence_index_pairs.begin(), confidence_index_pairs.end(),
                  [](const auto& a, const auto& b) { return a.first > b.first; });
         
-        std::vector<bool> suppressed(confidence_index_pairs.size(), false);
-        
-        for (size_t i = 0; i < confidence_index_pairs.size(); ++i) {
-            if (suppressed[i]) continue;
-            
-            int idx_i = confidence_index_pairs[i].second;
-            indices.push_back(idx_i);
-            const cv::Rect& box_i = boxes[idx_i];
-            
-            for (size_t j = i + 1; j < confidence_index_pairs.size(); ++j) {
-                if (suppressed[j]) continue;
-                
-                int idx_j = confidence_index_pairs[j].second;
-                const cv::Rect& box_j = boxes[idx_j];
-                
-                int x1 = std::max(box_i.x, box_j.x);
-                int y1 = std::max(box_i.y, box_j.y);
-                int x2 = std::min(box_i.x + box_i.width, box_j.x + box_j.width);
-                int y2 = std::min(box_i.y + box_i.height, box_j.y + box_j.height);
-                
-                int intersection_width = std::max(0, x2 - x1);
-                int intersection_height = std::max(0, y2 - y1);
-                float intersection_area = static_cast<float>(intersection_width * intersection_height);
-                
-                float box_i_area = static_cast<float>(box_i.width * box_i.height);
-                float box_j_area = static_cast<float>(box_j.width * box_j.height);
-                float union_area = box_i_area + box_j_area - intersection_area;
-                
-                float iou = (union_area > 0) ? (intersection_area / union_area) : 0.0f;
-                
-                if (iou > nms_threshold) {
-                    suppressed[j] = true;
-                }
-            }
+        std::vector<cv::Rect2f> sorted_boxes;
+        sorted_boxes.reserve(confidence_index_pairs.size());
+        for (const auto& pair : confidence_index_pairs) {
+            sorted_boxes.push_back(cv::Rect2f(boxes[pair.second]));
         }
-        
+
+        for (int i : NCNNDetector::GridNMS(sorted_boxes, nms_threshold)) {
+            indices.push_back(confidence_index_pairs[i].second);
+        }
+
         GS_LOG_TRACE_MSG(trace, "SingleClassNMS: " + std::to_string(boxes.size()) + 
                         " boxes -> " + std::to_string(indices.size()) + " after NMS");
         
@@ -4217,53 +6700,54 @@ namespace golf_sim {
     bool BallImageProc::DetectBallsNCNN(const cv::Mat& preprocessed_img,
                                         BallSearchMode search_mode,
                                         std::vector<GsCircle>& detected_circles,
-                                        bool report_find_failures) {
+                                        bool report_find_failures,
+                                        std::vector<NCNNDetector::Detection>* kept_detections) {
         auto detection_start = std::chrono::high_resolution_clock::now();
 
         try {
             if (!ncnn_detector_initialized_.load(std::memory_order_acquire)) {
                 std::lock_guard<std::mutex> lock(ncnn_detector_mutex_);
                 if (!ncnn_detector_initialized_.load(std::memory_order_relaxed)) {
-
-                    NCNNDetector::Config config;
-                    config.param_path = kModelPath + "/best.ncnn.param";
-                    config.bin_path = kModelPath + "/best.ncnn.bin";
-                    config.confidence_threshold = kModelConfidenceThreshold;
-                    config.nms_threshold = kModelNMSThreshold;
-                    config.input_width = kModelInputWidth;
-                    config.input_height = kModelInputHeight;
-                    config.num_threads = kInferenceThreads;
-                    config.is_single_class_model = true;
-                    config.num_classes = 1;
-
-                    ncnn_detector_ = std::make_unique<NCNNDetector>(config);
-
-                    if (!ncnn_detector_->Initialize()) {
+                    if (!InitializeNCNNDetectors()) {
                         GS_LOG_MSG(error, "Failed to initialize NCNN detector");
-                        ncnn_detector_.reset();
                         return false;
                     }
-
-                    ncnn_detector_initialized_.store(true, std::memory_order_release);
                 }
             }
 
-            cv::Mat input_image;
-            if (preprocessed_img.channels() == 1) {
-                cv::cvtColor(preprocessed_img, input_image, cv::COLOR_GRAY2BGR);
-            } else {
-                input_image = preprocessed_img;
+            // The detector converts grayscale images itself as part of its letterboxing
+            const cv::Mat& input_image = preprocessed_img;
+
+            std::vector<NCNNDetector::Detection> detections;
+
+            if (kModelUseTiledDetection && search_mode != BallSearchMode::kFindPlacedBall) {
+                detections = DetectBallsNCNNTiled(input_image, search_mode);
             }
+            else {
+                NCNNDetector* detector = (search_mode == BallSearchMode::kFindPlacedBall && ncnn_placement_detector_) ?
+                    ncnn_placement_detector_.get() : ncnn_detector_.get();
 
-            auto detections = ncnn_detector_->Detect(input_image);
+                NCNNDetector::PerformanceMetrics metrics;
+                detections = detector->Detect(input_image, &metrics);
+
+                GS_LOG_TRACE_MSG(trace, "NCNN timing (ms) - preprocessing: " + std::to_string(metrics.preprocessing_ms) +
+                               ", inference: " + std::to_string(metrics.inference_ms) +
+                               ", postprocessing: " + std::to_string(metrics.postprocessing_ms));
+            }
 
             detected_circles.clear();
             detected_circles.reserve(detections.size());
+            if (kept_detections != nullptr) {
+                kept_detections->clear();
+            }
             for (const auto& d : detections) {
                 GsCircle circle;
                 if (BboxToCircle(d.bbox.x, d.bbox.y, d.bbox.width, d.bbox.height,
                                  input_image.cols, input_image.rows, "NCNN", circle)) {
                     detected_circles.push_back(circle);
+                    if (kept_detections != nullptr) {
+                        kept_detections->push_back(d);
+                    }
                 }
             }
 
@@ -4283,6 +6767,125 @@ namespace golf_sim {
         }
     }
 
+    // Returns the starting offsets of tile_size-long tiles that cover [start, start + length),
+    // each overlapping the last by (at least) overlap.  Assumes length >= tile_size.
+    static std::vector<int> GetTileOrigins(const int start, const int length, const int tile_size, const int overlap) {
+        std::vector<int> origins;
+        const int stride = std::max(1, tile_size - overlap);
+
+        for (int origin = start; ; origin += stride) {
+            if (origin + tile_size >= start + length) {
+                // Align the last tile with the end, rather than running past it
+                origins.push_back(start + length - tile_size);
+                break;
+            }
+            origins.push_back(origin);
+        }
+
+        return origins;
+    }
+
+    std::vector<NCNNDetector::Detection> BallImageProc::DetectBallsNCNNTiled(const cv::Mat& preprocessed_img,
+                                                                             BallSearchMode search_mode) {
+
+        const cv::Rect image_rect(0, 0, preprocessed_img.cols, preprocessed_img.rows);
+
+        // Tiles are the size of the model input so that they are processed at native resolution
+        const int tile_width = std::min(kModelInputWidth, preprocessed_img.cols);
+        const int tile_height = std::min(kModelInputHeight, preprocessed_img.rows);
+
+        double top_fraction = kModelTiledCorridorTopFraction;
+        double bottom_fraction = kModelTiledCorridorBottomFraction;
+
+        // Keep this consistent with the putting ROI in GolfSimCamera::AnalyzeStrobedBalls
+        if (search_mode == BallSearchMode::kPutting) {
+            top_fraction = 0.5;
+            bottom_fraction = 1.0;
+        }
+
+        int corridor_top = (int)(top_fraction * preprocessed_img.rows);
+        int corridor_bottom = (int)(bottom_fraction * preprocessed_img.rows);
+
+        // The corridor must be at least one tile high.  Grow it around its center if not.
+        if (corridor_bottom - corridor_top < tile_height) {
+            int center = (corridor_top + corridor_bottom) / 2;
+            corridor_top = std::clamp(center - tile_height / 2, 0, preprocessed_img.rows - tile_height);
+            corridor_bottom = corridor_top + tile_height;
+        }
+
+        // The ball can travel across the whole width of the image regardless of handedness
+        const cv::Rect corridor = cv::Rect(0, corridor_top, preprocessed_img.cols, corridor_bottom - corridor_top) & image_rect;
+
+        // A ball on a seam has to be whole in at least one of the tiles, so the overlap is
+        // never less than the largest ball that the camera is expected to see (but is capped
+        // at half a tile so that the tiles still advance).
+        const int largest_ball_diameter = 2 * ((int)std::ceil(GolfSimCamera::kExpectedBallRadiusPixelsAt40cm) + GolfSimCamera::kMaxRadiusOffset);
+        const int tile_overlap = std::min(std::max(kModelTileOverlapPixels, largest_ball_diameter),
+                                          std::min(tile_width, tile_height) / 2);
+
+        std::vector<NCNNDetector::Detection> tile_detections;
+        std::vector<cv::Rect> boxes;
+        std::vector<float> confidences;
+        NCNNDetector::PerformanceMetrics total_metrics;
+        int number_of_tiles = 0;
+
+        for (int tile_y : GetTileOrigins(corridor.y, corridor.height, tile_height, tile_overlap)) {
+            for (int tile_x : GetTileOrigins(corridor.x, corridor.width, tile_width, tile_overlap)) {
+
+                const cv::Rect tile_rect(tile_x, tile_y, tile_width, tile_height);
+                number_of_tiles++;
+
+                // The detector honors the ROI's stride, so the tile is not copied
+                NCNNDetector::PerformanceMetrics metrics;
+                auto detections = ncnn_detector_->Detect(preprocessed_img(tile_rect), &metrics);
+
+                total_metrics.preprocessing_ms += metrics.preprocessing_ms;
+                total_metrics.inference_ms += metrics.inference_ms;
+                total_metrics.postprocessing_ms += metrics.postprocessing_ms;
+
+                for (auto d : detections) {
+                    d.bbox.x += (float)tile_x;
+                    d.bbox.y += (float)tile_y;
+
+                    // Only a ball cut off by the edge of the image is dropped.  One cut off by
+                    // a seam between tiles is kept, as the NMS below removes it if the whole
+                    // ball was found in an overlapping tile.
+                    GsCircle unused_circle;
+                    if (!BboxToCircle(d.bbox.x, d.bbox.y, d.bbox.width, d.bbox.height,
+                                      image_rect.width, image_rect.height, "NCNN tile", unused_circle)) {
+                        continue;
+                    }
+
+                    // A tile only sees part of the exposure sequence
+                    d.exposure_index = -1.0f;
+
+                    tile_detections.push_back(d);
+                    boxes.push_back(cv::Rect(d.bbox));
+                    confidences.push_back(d.confidence);
+                }
+            }
+        }
+
+        // The overlapping tiles will often find the same ball more than once
+        std::vector<int> kept_indices = SingleClassNMS(boxes, confidences, kModelConfidenceThreshold, kModelNMSThreshold);
+
+        std::vector<NCNNDetector::Detection> merged_detections;
+        merged_detections.reserve(kept_indices.size());
+
+        for (int index : kept_indices) {
+            merged_detections.push_back(tile_detections[index]);
+        }
+
+        GS_LOG_TRACE_MSG(trace, "NCNN tiled detection: " + std::to_string(number_of_tiles) + " tiles (overlap " +
+                       std::to_string(tile_overlap) + " px), " +
+                       std::to_string(tile_detections.size()) + " raw -> " + std::to_string(merged_detections.size()) +
+                       " merged detections.  Timing (ms) - preprocessing: " + std::to_string(total_metrics.preprocessing_ms) +
+                       ", inference: " + std::to_string(total_metrics.inference_ms) +
+                       ", postprocessing: " + std::to_string(total_metrics.postprocessing_ms));
+
+        return merged_detections;
+    }
+
     bool BallImageProc::PreloadNCNNModel() {
         if (ncnn_detector_initialized_.load(std::memory_order_relaxed)) return true;
 
@@ -4292,24 +6895,11 @@ namespace golf_sim {
         try {
             auto start = std::chrono::high_resolution_clock::now();
 
-            NCNNDetector::Config config;
-            config.param_path = kModelPath + "/best.ncnn.param";
-            config.bin_path = kModelPath + "/best.ncnn.bin";
-            config.confidence_threshold = kModelConfidenceThreshold;
-            config.nms_threshold = kModelNMSThreshold;
-            config.input_width = kModelInputWidth;
-            config.input_height = kModelInputHeight;
-            config.num_threads = kInferenceThreads;
-
-            ncnn_detector_ = std::make_unique<NCNNDetector>(config);
-            if (!ncnn_detector_->Initialize()) {
+            if (!InitializeNCNNDetectors()) {
                 GS_LOG_MSG(error, "Failed to preload NCNN detector");
-                ncnn_detector_.reset();
                 return false;
             }
 
-            ncnn_detector_initialized_.store(true, std::memory_order_release);
-
             auto end = std::chrono::high_resolution_clock::now();
             auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
             GS_LOG_MSG(info, "NCNN model preloaded in " + std::to_string(ms.count()) + "ms");
@@ -4321,11 +6911,135 @@ namespace golf_sim {
         }
     }
 
+    std::unique_ptr<NCNNDetector> BallImageProc::CreateNCNNDetector(const std::string& purpose, int input_width, int input_height) {
+
+        NCNNDetector::Config config;
+        config.confidence_threshold = kModelConfidenceThreshold;
+        config.nms_threshold = kModelNMSThreshold;
+        config.input_width = input_width;
+        config.input_height = input_height;
+        config.num_threads = kInferenceThreads;
+        config.is_single_class_model = true;
+        config.num_classes = 1;
+        config.has_sequence_outputs = kModelHasSequenceOutputs;
+
+        NCNNDetector::Config int8_config = config;
+        int8_config.param_path = kModelPath + "/best.ncnn.int8.param";
+        int8_config.bin_path = kModelPath + "/best.ncnn.int8.bin";
+        int8_config.use_int8_inference = true;
+
+        config.param_path = kModelPath + "/best.ncnn.param";
+        config.bin_path = kModelPath + "/best.ncnn.bin";
+
+        const bool int8_model_exists = std::filesystem::exists(int8_config.param_path) && std::filesystem::exists(int8_config.bin_path);
+
+        std::vector<NCNNDetector::Config> model_variants;
+        if (kModelVariant != "fp16" && int8_model_exists) {
+            model_variants.push_back(int8_config);
+        }
+        if (kModelVariant != "int8" || !int8_model_exists) {
+            model_variants.push_back(config);
+        }
+
+        // In the benchmark mode, each model is timed side by side on the GPU and the CPU
+        const std::string& backend = NcnnRuntime::kNcnnComputeBackend;
+        const bool try_vulkan = (backend != "cpu") && NcnnRuntime::VulkanAvailable();
+
+        std::vector<NCNNDetector::Config> variants;
+        for (NCNNDetector::Config variant : model_variants) {
+            if (try_vulkan) {
+                variant.use_vulkan_compute = true;
+                variants.push_back(variant);
+            }
+            if (!try_vulkan || backend == "benchmark") {
+                variant.use_vulkan_compute = false;
+                variants.push_back(variant);
+            }
+        }
+
+        std::unique_ptr<NCNNDetector> best_detector;
+        float best_ms = 0;
+
+        for (const NCNNDetector::Config& variant : variants) {
+            auto detector = std::make_unique<NCNNDetector>(variant);
+            if (!detector->Initialize()) {
+                GS_LOG_MSG(warning, "Could not load the NCNN model " + variant.param_path + (variant.use_vulkan_compute ? " on the GPU" : ""));
+
+                if (variant.use_vulkan_compute && backend != "benchmark") {
+                    // Fall back to the CPU for this model
+                    NCNNDetector::Config cpu_variant = variant;
+                    cpu_variant.use_vulkan_compute = false;
+                    detector = std::make_unique<NCNNDetector>(cpu_variant);
+                    if (!detector->Initialize()) {
+                        continue;
+                    }
+                }
+                else {
+                    continue;
+                }
+            }
+
+            // No need to time the only candidate
+            const float ms = (variants.size() > 1) ? detector->MeasureDetectMs() : 0;
+            if (variants.size() > 1) {
+                GS_LOG_MSG(info, "NCNN " + purpose + " model " + variant.param_path + " (" + (detector->UsesVulkan() ? "GPU" : "CPU") +
+                    ") takes " + std::to_string(ms) + "ms per detection");
+            }
+
+            if (!best_detector || ms < best_ms) {
+                best_detector = std::move(detector);
+                best_ms = ms;
+            }
+        }
+
+        if (best_detector) {
+            GS_LOG_MSG(info, "Using NCNN " + purpose + " model " + best_detector->GetConfig().param_path + " at " +
+                std::to_string(input_width) + "x" + std::to_string(input_height) + " on the " + (best_detector->UsesVulkan() ? "GPU" : "CPU"));
+        }
+
+        return best_detector;
+    }
+
+    bool BallImageProc::InitializeNCNNDetectors() {
+
+        ncnn_detector_ = CreateNCNNDetector("strobed ball", kModelInputWidth, kModelInputHeight);
+        if (!ncnn_detector_) {
+            return false;
+        }
+
+        const int placement_width = (kModelPlacementInputWidth > 0) ? kModelPlacementInputWidth : kModelInputWidth;
+        const int placement_height = (kModelPlacementInputHeight > 0) ? kModelPlacementInputHeight : kModelInputHeight;
+
+        if (placement_width != kModelInputWidth || placement_height != kModelInputHeight) {
+            ncnn_placement_detector_ = CreateNCNNDetector("placed ball", placement_width, placement_height);
+            if (!ncnn_placement_detector_) {
+                ncnn_detector_.reset();
+                return false;
+            }
+        }
+
+        // The weights are most of a model's memory
+        size_t model_bytes = 0;
+        for (NCNNDetector* detector : { ncnn_detector_.get(), ncnn_placement_detector_.get() }) {
+            std::error_code ec;
+            const uintmax_t bin_bytes = (detector != nullptr) ? std::filesystem::file_size(detector->GetConfig().bin_path, ec) : 0;
+            if (!ec) {
+                model_bytes += (size_t)bin_bytes;
+            }
+        }
+        GsMemoryFootprint::SetBytes(GsMemoryFootprint::Subsystem::kBallDetectorModels, model_bytes);
+
+        ncnn_detector_initialized_.store(true, std::memory_order_release);
+        return true;
+    }
+
     void BallImageProc::CleanupNCNN() {
         std::lock_guard<std::mutex> lock(ncnn_detector_mutex_);
         if (ncnn_detector_initialized_.load(std::memory_order_relaxed)) {
             ncnn_detector_.reset();
+            ncnn_placement_detector_.reset();
             ncnn_detector_initialized_.store(false, std::memory_order_release);
+            GsMemoryFootprint::SetBytes(GsMemoryFootprint::Subsystem::kBallDetectorModels, 0);
             GS_LOG_MSG(info, "NCNN detector cleaned up");
         }
     }
@@ -4355,6 +7069,8 @@ namespace golf_sim {
             config.bin_path = spin_model_path + "/best.ncnn.bin";
             config.input_size = 128;
             config.num_threads = kInferenceThreads;
+            // The spin model is small, so it is not worth benchmarking on both
+            config.use_vulkan_compute = (NcnnRuntime::kNcnnComputeBackend == "vulkan");
             config.z_fallback_threshold = z_threshold;
 
             spin_predictor_ = std::make_unique<SpinPredictor>(config);
@@ -4364,6 +7080,34 @@ namespace golf_sim {
                 return false;
             }
 
+            std::error_code ec;
+            uintmax_t bin_bytes = std::filesystem::file_size(config.bin_path, ec);
+            if (ec) {
+                bin_bytes = 0;
+            }
+
+            if (!kSpinDimpleEdgeModelPath.empty()) {
+                DimpleEdgeExtractor::Config edge_config;
+                edge_config.param_path = kSpinDimpleEdgeModelPath + "/best.ncnn.param";
+                edge_config.bin_path = kSpinDimpleEdgeModelPath + "/best.ncnn.bin";
+                edge_config.input_size = 128;
+                edge_config.num_threads = kInferenceThreads;
+                edge_config.use_vulkan_compute = config.use_vulkan_compute;
+                edge_config.edge_threshold = kSpinDimpleEdgeThreshold;
+
+                dimple_edge_extractor_ = std::make_unique<DimpleEdgeExtractor>(edge_config);
+                if (dimple_edge_extractor_->Initialize()) {
+                    const uintmax_t edge_bin_bytes = std::filesystem::file_size(edge_config.bin_path, ec);
+                    bin_bytes += ec ? 0 : edge_bin_bytes;
+                }
+                else {
+                    GS_LOG_MSG(warning, "Failed to initialize the dimple-edge model - the ML spin path will use the Gabor filter");
+                    dimple_edge_extractor_.reset();
+                }
+            }
+
+            GsMemoryFootprint::SetBytes(GsMemoryFootprint::Subsystem::kSpinPredictorModel, (size_t)bin_bytes);
+
             spin_predictor_initialized_.store(true, std::memory_order_release);
 
             auto end = std::chrono::high_resolution_clock::now();
@@ -4388,8 +7132,26 @@ namespace golf_sim {
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelInputWidth", kModelInputWidth);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelInputHeight", kModelInputHeight);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kInferenceThreads", kInferenceThreads);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelVariant", kModelVariant);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelPlacementInputWidth", kModelPlacementInputWidth);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelPlacementInputHeight", kModelPlacementInputHeight);
+        NcnnRuntime::LoadConfigurationValues();
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelUseTiledDetection", kModelUseTiledDetection);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelTiledCorridorTopFraction", kModelTiledCorridorTopFraction);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelTiledCorridorBottomFraction", kModelTiledCorridorBottomFraction);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelTileOverlapPixels", kModelTileOverlapPixels);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelHasSequenceOutputs", kModelHasSequenceOutputs);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kModelSequenceConfidence", kModelSequenceConfidence);
+        kModelSequenceConfidence = std::clamp(kModelSequenceConfidence, 0.5f, 1.0f);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUseSubpixelRadiusRefinement", kUseSubpixelRadiusRefinement);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kSubpixelRadiusRays", kSubpixelRadiusRays);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kSubpixelRadiusSearchFraction", kSubpixelRadiusSearchFraction);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kSubpixelRadiusMinimumEdgeStrength", kSubpixelRadiusMinimumEdgeStrength);
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinDetectionMethod", kSpinDetectionMethod);
-        if (kSpinDetectionMethod != "ml" && kSpinDetectionMethod != "legacy") {
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinHybridSearchWindowDegrees", kSpinHybridSearchWindowDegrees);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinDimpleEdgeModelPath", kSpinDimpleEdgeModelPath);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinDimpleEdgeThreshold", kSpinDimpleEdgeThreshold);
+        if (kSpinDetectionMethod != "ml" && kSpinDetectionMethod != "legacy" && kSpinDetectionMethod != "hybrid") {
             GS_LOG_MSG(error, "Unrecognized kSpinDetectionMethod: '" + kSpinDetectionMethod + "' - defaulting to 'ml'");
             kSpinDetectionMethod = "ml";
         }
@@ -9,9 +9,13 @@
 #pragma once
 
 
+#include <array>
+#include <chrono>
 #include <iostream>
 #include <filesystem>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <atomic>
 
 #include <opencv2/core.hpp>
@@ -25,6 +29,10 @@
 #include "golf_ball.h"
 #include "ncnn_detector.hpp"
 #include "spin_predictor.hpp"
+#include "dimple_edge_extractor.hpp"
+#include "gs_preprocessing_context.h"
+#include "gs_color_mask.h"
+#include "gs_ball_candidate.h"
 
 
 namespace golf_sim {
@@ -33,16 +41,69 @@ namespace golf_sim {
 // the comparison should not be performed on the particular pixel
 const uchar kPixelIgnoreValue = 128;
 
+// Where each pixel of a rotated ball image comes from - see BallImageProc::GetRotationRemap
+struct RotationRemap;
+
+class GsTernaryImage;
+
 // Holds one potential rotated golf ball candidate image and associated data
 struct RotationCandidate {
     short index = 0;
-    cv::Mat img;
+    cv::Mat img;  // CV_8UC1 plane of 0, 255, or kPixelIgnoreValue pixels - see Project2dImageTo3dBall
+    // If remap is set, img is empty and the candidate image is source_img as seen through the remap
+    std::shared_ptr<const RotationRemap> remap;
+    cv::Mat source_img;
+    // If kSpinSearchUseBitPackedImages is set, img packed once when it is projected
+    std::shared_ptr<const GsTernaryImage> packed_img;
     int x_rotation_degrees = 0; // All Rotations are in degrees
     int y_rotation_degrees = 0;
     int z_rotation_degrees = 0;
     int pixels_examined = 0;
     int pixels_matching = 0;
     double score = 0;
+    bool pruned = false;  // True if the comparison was abandoned early because it could not beat the best score
+    bool scored = false;  // True if the pixel counts and score were already filled in (by the GPU backend)
+};
+
+// The score of one rotation candidate, without its images, for looking at a spin search afterwards.
+// Only numbers, so that recording it costs next to nothing - see BallImageProc::WriteSpinScoreSurface.
+struct SpinScoreSample {
+    int index = 0;
+    int x_rotation_degrees = 0;
+    int y_rotation_degrees = 0;
+    int z_rotation_degrees = 0;
+    int pixels_matching = 0;
+    int pixels_examined = 0;
+    double score = 0;
+    bool pruned = false;
+};
+
+using SpinScoreSurface = std::vector<SpinScoreSample>;
+
+// How good a rotation candidate's match ratio has to be able to get for its comparison to be
+// finished.  A candidate's final score is its match ratio less a penalty for having had fewer
+// pixels to compare than the candidate with the most (see GetBestRotationCandidates), and the
+// most any candidate can have is max_pixels_examinable.  So a candidate can be abandoned once
+// even its least-penalized score could not make the best k of the lowest scores that the
+// candidates compared in full so far could end up with.  Shared by the comparison threads.
+class SpinPruningBound {
+public:
+    SpinPruningBound(int k, long max_pixels_examinable);
+
+    // For a candidate that was compared in full
+    void Record(long pixels_matching, long pixels_examined);
+
+    // Negative until k candidates have been recorded
+    double GetMinScoreToBeat() const { return min_score_to_beat_.load(); }
+
+private:
+    const size_t k_;
+    const double max_pixels_examinable_;
+
+    std::mutex mutex_;
+    // The k highest of the recorded candidates' lowest possible final scores, as a min-heap
+    std::vector<double> best_lowest_final_scores_;
+    std::atomic<double> min_score_to_beat_{ -1.0 };
 };
 
 class BallImageProc
@@ -54,6 +115,15 @@ public:
         kUseYOLOWithMonochromeImages = 1
     };
 
+    // How much of the (non-ML) spin search was done before kSpinSearchTimeBudgetMs ran out
+    enum SpinSearchQuality {
+        kSpinSearchComplete = 0,
+        // Only some of the fine search windows (the ones around the best coarse candidates) were searched
+        kSpinSearchPartiallyRefined = 1,
+        // The result is the best coarse candidate
+        kSpinSearchCoarseOnly = 2
+    };
+
     // The following are constants that control how the ball spin algorithm and the
     // ball (circle) identification works.  They are set from the configuration .json file
 
@@ -68,6 +138,68 @@ public:
     static int kCoarseZRotationDegreesEnd;
     static int kCoarseSearchResolution;
 
+    // If positive, each ball's spin patch (see BallPatch) is resampled to this many pixels
+    // square, so that the Gabor filter, masking, de-rotation and fine search cost the same
+    // however near the ball was to the camera.  If it is the same as kCoarseSearchResolution,
+    // the coarse search also works on the patches as-is.  If 0, the patches stay at the
+    // ball's own pixel size, with the smaller of the two enlarged to match the larger.
+    static int kSpinPatchResolution;
+
+    // If true, the (non-ML) spin search refines around the kSpinSearchTopKCandidates best coarse
+    // candidates instead of only the single best one.  If kSpinSearchUseEarlyTermination is also set,
+    // a comparison is abandoned as soon as it can no longer make the best final scores found so
+    // far at that level (see SpinPruningBound).  The result is the same as the exhaustive search's.
+    static bool kSpinSearchUseHierarchical;
+    static int kSpinSearchTopKCandidates;
+    static bool kSpinSearchUseEarlyTermination;
+
+    // If not empty, the result of each (non-ML) spin search is saved in this directory, keyed by
+    // a hash of the two dimple images, the balls and the search settings.  A later search with
+    // bit-identical inputs (e.g., when re-processing logged shots while tuning other settings)
+    // just reads the saved best rotation.  Each file also holds the score of every candidate.
+    static std::string kSpinSearchCacheDirectory;
+
+    // If not empty, the score of every coarse and fine candidate of each (non-ML) spin search is
+    // written to this directory as a CSV file and as an x-by-y heatmap - see WriteSpinScoreSurface
+    static std::string kSpinScoreSurfaceDirectory;
+
+    // If true, the rotation candidates are not projected into images of their own.  Instead, each
+    // rotation's remap table (which pixel of the un-rotated ball ends up where) is computed once
+    // and cached, and a candidate is scored by looking its pixels up through the table.  The scores
+    // are the same as for the projected images.
+    // If kSpinSearchRemapRadiusQuantum is positive, the tables are computed for the ball radius
+    // rounded to a multiple of it, so that balls of nearly the same size (e.g., from one shot to the
+    // next) share tables.  Otherwise, every shot's (fractional) radius makes a new set of tables, and
+    // the cache rarely gets a hit.  The rounding makes the projection slightly approximate, so 0
+    // turns it off.  The default is a whole pixel.
+    static bool kSpinSearchUseRemapTables;
+    static double kSpinSearchRemapRadiusQuantum;
+
+    // If true, the candidates are compared with a bit-packed copy of the target image (see
+    // gs_ternary_image.h) instead of a pixel at a time.  The scores are the same either way.
+    static bool kSpinSearchUseBitPackedImages;
+
+    // If true (and the build has the GPU backend - see gs_gpu_spin_search.h), the rotation
+    // candidates are projected and scored on the GPU, and the CPU search is only the fallback.
+    static bool kSpinSearchUseGpu;
+
+    // If positive, the (non-ML) spin search stops refining once this many ms have passed since
+    // GetBallRotation was called, or once the next fine search window would most likely take it
+    // past that.  The coarse search always runs, and the fine windows are searched best coarse
+    // candidate first, so the result is the best one found in the time.  0 means no limit.
+    static int kSpinSearchTimeBudgetMs;
+
+    // If true, the (non-ML) spin search does not score the whole coarse grid and then the fine
+    // windows.  Instead, a sparse sample of the coarse grid (at kSpinOptimizerSeedSpacingFactor times
+    // the coarse increments) picks the kSpinOptimizerStarts best seeds, and a Nelder-Mead search from
+    // each seed (and from the ML prediction, in "hybrid" mode) climbs to the best rotation at full
+    // resolution, with at most kSpinOptimizerMaxEvaluations comparisons in all.  The rotations are
+    // whole degrees within the coarse ranges, and the best one is picked the same way as the grid's.
+    static bool kSpinSearchUseOptimizer;
+    static int kSpinOptimizerStarts;
+    static int kSpinOptimizerMaxEvaluations;
+    static int kSpinOptimizerSeedSpacingFactor;
+
     static double kPlacedBallCannyLower;
     static double kPlacedBallCannyUpper;
     static double kPlacedBallStartingParam2;
@@ -149,6 +281,26 @@ public:
 
     static bool kUseDynamicRadiiAdjustment;
     static int kNumberRadiiToAverageForDynamicAdjustment;
+
+    // If set, each search mode's adaptive Hough loop in GetBall starts from the param2
+    // that it last converged on instead of from its starting param2.  With fixed lighting
+    // and a mounted unit, that is usually right on the first HoughCircles call.
+    static bool kUseHoughParameterMemory;
+
+    // If set, the adaptive Hough loop for strobed (and putting) images runs on a 2x-downsampled
+    // copy of the search image, and each circle it settles on is then re-fit with a
+    // HoughCircles call over just a small full-resolution window around that circle.
+    static bool kUsePyramidHoughSearch;
+
+    // If set, the ellipse fitting evaluates its four families of arc triplets at the same
+    // time on the shared thread pool.  The ellipses found are the same either way.
+    static bool kUseParallelEllipseTriplets;
+
+    // If set, the ellipse fitting only looks for arcs between kEllipseArcAnnulusInnerRadiusRatio
+    // times the ball's radius from its center and the edge of the search area, rather than
+    // everywhere in that area.  Most of the triplet search is then skipped.
+    static bool kUseEllipseArcAnnulus;
+    static double kEllipseArcAnnulusInnerRadiusRatio;
     static double kStrobedNarrowingRadiiMinRatio;
     static double kStrobedNarrowingRadiiMaxRatio;
 
@@ -165,6 +317,12 @@ public:
     static bool kUseBestCircleRefinement;
     static bool kUseBestCircleLargestCircle;
 
+    // If set, the best-circle refinement and the ellipse searches first try FitBallEllipseToEdges,
+    // and only fall back to the Hough, contour or YAED searches if it cannot find the ball's edge.
+    // kFastEllipseRansacIterations bounds its RANSAC search.
+    static bool kUseFastEllipseRefinement;
+    static int kFastEllipseRansacIterations;
+
     static double kBestCircleCannyLower;
     static double kBestCircleCannyUpper;
     static int kBestCirclePreCannyBlurSize;
@@ -189,7 +347,24 @@ public:
 
     static int kGaborMaxWhitePercent;
     static int kGaborMinWhitePercent;
+
+    // If set, the Gabor accumulation is computed with 16-bit fixed-point kernels on the 8-bit
+    // ball image (with NEON where available) instead of in 32-bit float.  Off until it has
+    // been validated against the float path.
+    static bool kGaborUseFixedPoint;
+
+    // "ml", "legacy" (the rotation search), or "hybrid".  In the hybrid mode, the ML prediction
+    // is only refined by a search of +/- kSpinHybridSearchWindowDegrees (in x and z) around it.
+    // The full rotation search is still run if the model falls back on Z or if the best
+    // refined rotation is at the edge of that window.
     static std::string kSpinDetectionMethod;
+    static int kSpinHybridSearchWindowDegrees;
+
+    // If set, the "ml" spin method gets its dimple-edge images from the DimpleEdgeExtractor model
+    // in this directory instead of from the Gabor filter bank, so that the spin is found with two
+    // small inferences.  The Gabor filter is still used if the model cannot be loaded or run.
+    static std::string kSpinDimpleEdgeModelPath;
+    static float kSpinDimpleEdgeThreshold;
 
     // Model Detection Configuration
     static std::string kStrobedBallDetectionMethod;
@@ -201,6 +376,43 @@ public:
     static int kModelInputHeight;
     static int kInferenceThreads;
 
+    // "fp16" uses best.ncnn.param/bin.  "int8" uses best.ncnn.int8.param/bin (made with
+    // ncnn2int8 and a calibration table) if they exist.  "auto" loads both (if the int8
+    // files exist) and keeps whichever runs faster on this Pi.
+    static std::string kModelVariant;
+    // The model input size for finding the placed (teed) ball.  0 means the same as
+    // kModelInputWidth/Height.  A smaller size is faster, and the placed ball is large.
+    static int kModelPlacementInputWidth;
+    static int kModelPlacementInputHeight;
+
+    // If true, strobed-ball model detection runs on native-resolution (model input-sized) tiles
+    // along the expected flight corridor instead of on the letterboxed full frame.  The corridor
+    // is a horizontal band given as fractions of the image height (the lower half when putting).
+    // Tiles overlap by kModelTileOverlapPixels, or by the largest expected ball diameter if that is
+    // more, so that a ball cut off by one tile is whole in the next.
+    static bool kModelUseTiledDetection;
+    static double kModelTiledCorridorTopFraction;
+    static double kModelTiledCorridorBottomFraction;
+    static int kModelTileOverlapPixels;
+
+    // If true, the model also gives each strobed ball an overlap score and its place in the
+    // exposure sequence (see NCNNDetector::Config::has_sequence_outputs).  When each ball's
+    // overlap score is within (1 - kModelSequenceConfidence) of 0 or 1, the overlap filtering is
+    // done from the scores, and when each exposure index is within that much of a whole number,
+    // the strobe-pattern search only considers that sequence.  The exposure indices are not used
+    // with tiled detection, where a tile does not see the whole sequence.
+    static bool kModelHasSequenceOutputs;
+    static float kModelSequenceConfidence;
+
+    // If set, the radius (and center) of the placed ball and of the auto-calibration ball are
+    // refined to sub-pixel accuracy by finding the edge along kSubpixelRadiusRays rays, within
+    // kSubpixelRadiusSearchFraction of the detected radius, and fitting a circle to those edges.
+    // Edges with a gradient below kSubpixelRadiusMinimumEdgeStrength (grey levels) are ignored.
+    static bool kUseSubpixelRadiusRefinement;
+    static int kSubpixelRadiusRays;
+    static double kSubpixelRadiusSearchFraction;
+    static double kSubpixelRadiusMinimumEdgeStrength;
+
     // This determines which potential 3D angles will be searched for spin processing
     struct RotationSearchSpace {
         int anglex_rotation_degrees_increment = 0;
@@ -289,30 +501,118 @@ public:
 
     // Inputs are two balls and the images within which those balls exist
     // Returns the estimated amount of rotation in x, y, and z axes in degrees
+    // If search_quality is given, it is set to how complete the search was (see kSpinSearchTimeBudgetMs)
+    // If cancel is given, the search stops once it is set, as if the time budget had run out.
     static cv::Vec3d GetBallRotation(const cv::Mat& full_gray_image1, 
                                     const GolfBall& ball1, 
                                     const cv::Mat& full_gray_image2, 
-                                    const GolfBall& ball2);
+                                    const GolfBall& ball2,
+                                    SpinSearchQuality* search_quality = nullptr,
+                                    const std::atomic<bool>* cancel = nullptr);
 
+    // If target_image is given and kSpinSearchUseGpu is set, the candidates are also compared with
+    // it here (on the GPU), so that CompareCandidateAngleImages only has to pick the best one.
     static bool ComputeCandidateAngleImages(const cv::Mat& base_dimple_image, 
                                     const RotationSearchSpace& search_space, 
                                     cv::Mat& output_candidate_mat, 
                                     cv::Vec3i& output_candidate_elements_mat_size, 
                                     std::vector< RotationCandidate>& output_candidates, 
-                                    const GolfBall& ball);
+                                    const GolfBall& ball,
+                                    const cv::Mat* target_image = nullptr);
 
     // Returns the index within candidates that has the best comparison.
     // Returns -1 on failure.
+    // If pruning_bound is set, candidates that cannot beat it are not fully compared and are
+    // marked pruned, and the others are recorded in it.  The returned index then only takes the
+    // un-pruned candidates into account, so use GetBestRotationCandidates(target_image, ...)
+    // to pick from them.
     static int CompareCandidateAngleImages(const cv::Mat* target_image,
                                             const cv::Mat* candidate_elements_mat,
                                             const cv::Vec3i* candidate_elements_mat_size,
                                             std::vector<RotationCandidate>* candidates,
-                                            std::vector<std::string>& comparison_csv_data);
+                                            SpinPruningBound* pruning_bound = nullptr,
+                                            SpinScoreSurface* score_surface = nullptr);
+
+    // Writes file_name_base.csv with one line per sample, and file_name_base.png, a heatmap of the
+    // best (un-pruned) score over all the z rotations for each x (across) and y (down) rotation.
+    // Returns false if either file could not be written.
+    static bool WriteSpinScoreSurface(const SpinScoreSurface& surface, const std::string& file_name_base);
+
+    // Returns the indexes within candidates of the (up to) k best-scoring candidates, best first.
+    // Uses the same scoring as CompareCandidateAngleImages.  Pruned candidates are not returned.
+    static std::vector<int> GetBestRotationCandidates(const std::vector<RotationCandidate>& candidates, int k);
+
+    // The same, for candidates that were pruned against a SpinPruningBound of (at least) this k,
+    // but with the same result as if none had been.  The pruned candidates are compared with
+    // target_image in full (and are no longer pruned) if it turns out that their pixel counts
+    // could change the order, so they must still have their images.
+    static std::vector<int> GetBestRotationCandidates(const cv::Mat& target_image,
+                                                      std::vector<RotationCandidate>& candidates, int k);
+
+    // The "hybrid" spin detection.  Refines the ML spin prediction with a small local rotation search.
+    // Returns false (and leaves the rotations alone) if the prediction cannot be trusted, in which
+    // case the caller should run the full rotation search instead.  If predicted_rotation is given,
+    // it is set to the (rounded) prediction if the search was run around it.
+    static bool RefineMLBallRotation(const cv::Mat& ball_image1_dimple_edges,
+                                     const GolfBall& ball1,
+                                     const cv::Mat& ball_image2_dimple_edges,
+                                     int& best_rot_x, int& best_rot_y, int& best_rot_z,
+                                     std::optional<cv::Vec3i>* predicted_rotation = nullptr);
+
+    // The optimizer spin search - see kSpinSearchUseOptimizer.  If prior_rotation is given, it is
+    // also a starting point.  seed_candidates are the (coarse) seed sample and evaluated_candidates
+    // every full-resolution rotation that was scored, so the evaluations used are their total.
+    // Returns false if no rotation could be scored.  Otherwise, quality is set to how complete the
+    // search was, given kSpinSearchTimeBudgetMs since search_start (or cancel, if it is set).
+    static bool OptimizeBallRotation(const cv::Mat& ball_image1_dimple_edges,
+                                     const GolfBall& ball1,
+                                     const cv::Mat& ball_image2_dimple_edges,
+                                     const cv::Vec3i* prior_rotation,
+                                     const std::chrono::high_resolution_clock::time_point& search_start,
+                                     int& best_rot_x, int& best_rot_y, int& best_rot_z,
+                                     SpinSearchQuality& quality,
+                                     std::vector<RotationCandidate>& seed_candidates,
+                                     std::vector<RotationCandidate>& evaluated_candidates,
+                                     const std::atomic<bool>* cancel = nullptr);
 
     static cv::Vec2i CompareRotationImage(const cv::Mat& img1, const cv::Mat& img2, const int index = 0);
 
+    // Same as CompareRotationImage, but gives up (and sets terminated_early) once the ratio of
+    // matching to examined pixels can no longer reach min_score_to_beat.
+    static cv::Vec2i CompareRotationImageWithCutoff(const cv::Mat& img1, const cv::Mat& img2,
+                                                    double min_score_to_beat, bool& terminated_early);
+
+    // Returns the (cached) remap table of the given rotation of a ball in an image of the given size,
+    // or nullptr if the image is too large for a table.
+    static std::shared_ptr<const RotationRemap> GetRotationRemap(const cv::Size& image_size, const GolfBall& ball,
+                                                                 const cv::Vec3i& rotation_angles_degrees);
+
+    // Fills rotated_img (which must be the size of the remap) with the rotation of source_img,
+    // which must be continuous.  The same image as Project2dImageTo3dBall's serial path.
+    static void ApplyRotationRemap(const RotationRemap& remap, const cv::Mat& source_img, cv::Mat& rotated_img);
+
+    // Same as CompareRotationImageWithCutoff(img1, <the candidate's image>, ...) for a candidate with
+    // a remap.  A negative min_score_to_beat means the comparison is never cut off.
+    static cv::Vec2i CompareRemappedRotationImage(const cv::Mat& img1, const RotationCandidate& candidate,
+                                                  double min_score_to_beat, bool& terminated_early);
+
+    // The same, for a bit-packed img1.  Each row of the candidate is looked up through the remap
+    // straight into bitplanes, and is then compared a 64-pixel word at a time.
+    static cv::Vec2i CompareRemappedRotationImage(const GsTernaryImage& img1, const RotationCandidate& candidate,
+                                                  double min_score_to_beat, bool& terminated_early);
+
+    // Projects each candidate's rotation of base_dimple_image and compares it with target_image
+    // on the GPU, and marks the candidates scored.  Returns false if there is no GPU backend or
+    // it failed, in which case the candidates are left alone.
+    static bool ScoreCandidateAnglesOnGpu(const cv::Mat& base_dimple_image, const GolfBall& ball,
+                                          const cv::Mat& target_image, std::vector<RotationCandidate>& candidates);
+
     static cv::Mat MaskAreaOutsideBall(cv::Mat& ball_image, const GolfBall& ball, float mask_reduction_factor, const cv::Scalar& maskValue = (255, 255, 255));
 
+    // If kSpinSearchUseRemapTables is set, the rotation is looked up through the (cached) remap
+    // table of the rotation, rather than projected.  The perspective de-rotations of a shot are
+    // whole degrees of a ball centered in its patch, so the tables are shared from shot to shot,
+    // and the spin search has usually already built the table for the best rotation.
     static void GetRotatedImage(const cv::Mat& gray_2D_input_image, const GolfBall& ball, const cv::Vec3i rotation, cv::Mat& outputGrayImg);
 
     static bool RemoveSmallestConcentricCircles(std::vector<GsCircle>& circles);
@@ -330,7 +630,20 @@ public:
         const GsColorTriplet input_upperHsv,
         double wideningAmount = 0.0);
 
-    bool PreProcessStrobedImage(cv::Mat& search_image, BallSearchMode search_mode);
+    // The same mask, but computed from the (8-bit) BGR image with no HSV conversion, and only
+    // within the regions (if there are any - see GsColorMaskTable)
+    static cv::Mat GetColorMaskImageFromBgr(const cv::Mat& bgrImage,
+        const GsColorTriplet input_lowerHsv,
+        const GsColorTriplet input_upperHsv,
+        const std::vector<cv::Rect>& regions = {});
+
+    // The (widened) HSV range(s) that the color masks test, split in two if the hue wraps around
+    static GsHsvRanges GetColorMaskRanges(const GsColorTriplet input_lowerHsv,
+        const GsColorTriplet input_upperHsv);
+
+    // Only the preprocessing context's region of interest (if any) is processed
+    bool PreProcessStrobedImage(cv::Mat& search_image, BallSearchMode search_mode,
+                                const GsPreprocessingContext& preprocessing = GsPreprocessingContext());
 
     // Converts a bounding box to a GsCircle, rejecting edge-clipped detections
     // whose inscribed circle extends outside the image bounds.
@@ -341,23 +654,53 @@ public:
                              GsCircle& out_circle);
 
     // Detection Methods
+    // If detections is not null, it is set to the model's detection for each of the detected_circles
     static bool DetectBalls(const cv::Mat& preprocessed_img,
                             BallSearchMode search_mode,
                             std::vector<GsCircle>& detected_circles,
-                            bool report_find_failures);
+                            bool report_find_failures,
+                            std::vector<NCNNDetector::Detection>* detections = nullptr);
     static bool DetectBallsHoughCircles(const cv::Mat& preprocessed_img, BallSearchMode search_mode, std::vector<GsCircle>& detected_circles);
     static bool DetectBallsNCNN(const cv::Mat& preprocessed_img,
                                 BallSearchMode search_mode,
                                 std::vector<GsCircle>& detected_circles,
-                                bool report_find_failures);
+                                bool report_find_failures,
+                                std::vector<NCNNDetector::Detection>* kept_detections = nullptr);
+
+    // Runs the (already-initialized) NCNN detector over tiles of the flight corridor and merges
+    // the results with SingleClassNMS.  Returned boxes are in preprocessed_img coordinates.
+    static std::vector<NCNNDetector::Detection> DetectBallsNCNNTiled(const cv::Mat& preprocessed_img,
+                                                                     BallSearchMode search_mode);
 
     static bool PreloadNCNNModel();
     static bool PreloadSpinModel();
+    // Whichever of the above the configured detection methods need
+    static void PreloadModels();
     static void CleanupNCNN();
 
     // Load configuration values from JSON after config is initialized
     static void LoadConfigurationValues();
 
+    // The detection, Hough and spin-search values that the constructor reads
+    static void LoadTuningValues();
+
+    // Re-reads both sets of values (e.g., after a live tuning change) and passes the new
+    // thresholds on to the NCNN detectors.  Only call this between shots.
+    static void ReloadTuningValues();
+
+    // Refines the circle in place.  confidence is about 1.0 if the whole edge was found and is
+    // smooth.  Returns false (and leaves the circle alone) if no reliable edge was found.
+    static bool RefineBallRadiusSubpixel(const cv::Mat& img, GsCircle& circle, double& confidence);
+
+    // Does nothing unless kUseSubpixelRadiusRefinement is set.  Also sets the ball's radius_confidence_.
+    static bool RefineBallRadiusSubpixel(const cv::Mat& img, GolfBall& ball);
+
+    // Fits the ball's outline near reference_ball_circle from the sub-pixel edges along
+    // kSubpixelRadiusRays rays (as RefineBallRadiusSubpixel does), with a RANSAC search of
+    // cv::fitEllipseDirect fits that ignores edges from, e.g., a tee or an overlapping ball.
+    // Returns false, leaving the ellipse alone, if too little of the edge was found.
+    static bool FitBallEllipseToEdges(const cv::Mat& img, const GsCircle& reference_ball_circle, cv::RotatedRect& ellipse);
+
     // Custom single-class NMS optimized for golf balls (faster than generic multi-class NMS)
     static std::vector<int> SingleClassNMS(const std::vector<cv::Rect>& boxes,
                                           const std::vector<float>& confidences,
@@ -365,44 +708,67 @@ public:
                                           float nms_threshold);
 
 private:
+    // Times the private image-processing kernels directly
+    friend class GsKernelBenchmark;
+    friend class GsPerformanceProfile;
+
     // NCNN detector
     static std::unique_ptr<NCNNDetector> ncnn_detector_;
+    // Only if the placement input size is different from the strobed one
+    static std::unique_ptr<NCNNDetector> ncnn_placement_detector_;
     static std::atomic<bool> ncnn_detector_initialized_;
     static std::mutex ncnn_detector_mutex_;
 
+    // Caller must hold ncnn_detector_mutex_
+    static bool InitializeNCNNDetectors();
+    // Picks the model variant per kModelVariant.  Returns nullptr if no variant could be loaded.
+    static std::unique_ptr<NCNNDetector> CreateNCNNDetector(const std::string& purpose, int input_width, int input_height);
+
+    // Finds the strongest edge along each of number_rays rays out from (cx, cy), within band of
+    // radius r, to sub-pixel accuracy.  Rays without an edge of min_edge_strength are skipped.
+    static void FindRadialEdgePoints(const cv::Mat& gray, double cx, double cy, double r, double band,
+                                     int number_rays, double min_edge_strength,
+                                     std::vector<cv::Point2d>& edge_points, std::vector<double>& edge_radii);
+
     static std::unique_ptr<SpinPredictor> spin_predictor_;
+    // Loaded along with the spin predictor, if kSpinDimpleEdgeModelPath is set
+    static std::unique_ptr<DimpleEdgeExtractor> dimple_edge_extractor_;
     static std::atomic<bool> spin_predictor_initialized_;
     static std::mutex spin_predictor_mutex_;
 
+    // The parameters that GetBall's adaptive Hough loop last converged on for a search mode.
+    // Only used again if dp, param1 and the search radii still match.
+    struct HoughParameterMemory {
+        bool valid = false;
+        double dp = 0.0;
+        double param1 = 0.0;
+        double param2 = 0.0;
+        int min_radius = 0;
+        int max_radius = 0;
+        int hough_calls = 0;
+    };
+
+    // Indexed by BallSearchMode
+    static std::array<HoughParameterMemory, kPutting + 1> hough_parameter_memory_;
+    static std::mutex hough_parameter_memory_mutex_;
+
     // Experimental flag to have YOLO process either monochrome or color images
     static YOLOImageTypeToUse kImageTypeToProcessWithYOLO;
 
-    // When we create a candidate ball list, the elements of that list include not only 
-    // the ball, but also the ball identifier(e.g., 1, 2...),
+    // When we create a candidate ball list, the elements of that list (see BallCandidate) include not only
+    // the ball circle, but also the ball identifier(e.g., 1, 2...),
     // as well as information about the difference between the ball's average/median/std color versus the expected color.
-    // The following constants identify where in each element the information is
-
-    struct CircleCandidateListElement {
-        std::string     name;
-        GsCircle        circle;
-        double          calculated_color_difference;
-        int             found_radius;
-        GsColorTriplet  avg_RGB;
-        float           rgb_avg_diff;
-        float           rgb_median_diff;
-        float           rgb_std_diff;
-    };
 
-    static std::string FormatCircleCandidateElement(const struct CircleCandidateListElement& e);
-    static std::string FormatCircleCandidateList(const std::vector<struct CircleCandidateListElement>& e);
+    static std::string FormatCircleCandidateElement(const BallCandidate& e);
+    static std::string FormatCircleCandidateList(const std::vector<BallCandidate>& e);
 
     // This is an early attempt to remove lines from an image, such as those caused when using the 
     // system with another strobe-based launch monitor
     static bool RemoveLinearNoise(cv::Mat& img);
 
-    inline bool CompareColorDiff(const CircleCandidateListElement& a, const CircleCandidateListElement& b)
+    inline bool CompareColorDiff(const BallCandidate& a, const BallCandidate& b)
     {
-        return (a.calculated_color_difference < b.calculated_color_difference);
+        return (a.score < b.score);
     }
 
     void RoundCircleData(std::vector<GsCircle>& circles);
@@ -411,7 +777,27 @@ private:
 
     // Assumes the ball is fully within the image.
     // Updates the input ball1 to reflect the new position of the ball within the isolated image we are returning.
-    static cv::Mat IsolateBall(const cv::Mat& img, GolfBall& ball);
+    // If ball_rect is given, it is set to the part of img that was isolated.
+    static cv::Mat IsolateBall(const cv::Mat& img, GolfBall& ball, cv::Rect* ball_rect = nullptr);
+
+    // One ball, cut out of its image once for the whole spin analysis.  Every spin stage
+    // works on the patch's image and ball, which are in the patch's own coordinates.
+    struct BallPatch {
+        // The isolated ball, with everything outside the ball masked to black
+        cv::Mat image;
+        // The ball's position and radius within image
+        GolfBall ball;
+        // The part of the original image that the patch came from
+        cv::Rect source_rect;
+        // Patch pixels per original-image pixel
+        double scale = 1.0;
+    };
+
+    // If resolution is positive, the patch is resampled to resolution x resolution
+    static BallPatch MakeBallPatch(const cv::Mat& full_gray_image, const GolfBall& ball, int resolution);
+
+    // Resamples the patch (enlarging with INTER_LINEAR or shrinking with INTER_AREA), and scales its ball to match
+    static void ResizeBallPatch(BallPatch& patch, int size);
 
     static cv::Mat ReduceReflections(const cv::Mat& img, const cv::Mat& mask);
 
@@ -423,7 +809,9 @@ private:
     // in the calibrated_binary_threshold variable.
     static cv::Mat ApplyGaborFilterToBall(const cv::Mat& img, const GolfBall& ball, float& calibrated_binary_threshold, float prior_binary_threshold = -1);
 
-    // Compute max Gabor response across all orientations — expensive, run once per ball
+    // Compute max Gabor response across all orientations — expensive, run once per ball.
+    // Uses either filter2D or one forward DFT and cached kernel spectra, whichever is cheaper
+    // for the image and kernel sizes.
     static cv::Mat ComputeGaborAccumulation(const cv::Mat& img_f32,
         const int kernel_size, double sig, double lm, double th, double ps, double gm);
 
@@ -437,6 +825,7 @@ private:
 
     static cv::Mat CreateGaborKernel(int ks, double sig, double th, double lm, double gm, double ps);
 
+    // Returns a CV_8UC1 image of the same size as image_gray
     static cv::Mat Project2dImageTo3dBall(const cv::Mat& image_gray, const GolfBall& ball, const cv::Vec3i& rotation_angles_degrees, bool force_serial = false);
 
     static void Unproject3dBallTo2dImage(const cv::Mat& src3D, cv::Mat& destination_image_gray, const GolfBall& ball);
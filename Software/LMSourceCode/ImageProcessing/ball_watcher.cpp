@@ -5,11 +5,19 @@
 
 #ifdef __unix__  // Ignore in Windows environment
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
+#include <optional>
 #include <signal.h>
 #include <sys/stat.h>
 #include <sched.h>
 #include <pthread.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
 
 #include "core/rpicam_encoder.hpp"
 #include "encoder/encoder.hpp"
@@ -17,14 +25,25 @@
 
 #include <opencv2/core/cvdef.h>
 #include <opencv2/highgui.hpp>
+#include <opencv2/imgproc.hpp>
 
 #include <boost/circular_buffer.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
 #include "motion_detect.h"
 
+#include "libcamera_interface.h"
 #include "logging_tools.h"
 #include "gs_globals.h"
+#include "gs_deferred_log.h"
+#include "gs_preview_stream.h"
+#include "gs_local_display.h"
+#include "gs_watcher_stage_chain.h"
+#include "gs_crop_planner.h"
+#include "gs_camera_health.h"
+#include "gs_swing_replay.h"
+#include "gs_trace_zones.h"
+#include "ncnn_runtime.hpp"
 
 namespace gs = golf_sim;
 
@@ -50,10 +69,329 @@ static int get_colourspace_flags(std::string const &codec)
 		return RPiCamEncoder::FLAG_VIDEO_NONE;
 }
 
+// Pins the calling thread to the reserved real-time core for the lifetime of the object,
+// then restores whatever affinity the thread had before.  NCNN inference is kept off of
+// that core (see NcnnRuntime), so the motion-detection loop doesn't get preempted by it.
+class ScopedRealtimeCoreAffinity {
+public:
+	ScopedRealtimeCoreAffinity() {
+		if (NcnnRuntime::kRealtimeCpuCore < 0) {
+			return;
+		}
+
+		if (pthread_getaffinity_np(pthread_self(), sizeof(previous_cpu_set_), &previous_cpu_set_) != 0) {
+			GS_LOG_MSG(warning, "Could not get the current thread affinity.");
+			return;
+		}
+
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		CPU_SET(NcnnRuntime::kRealtimeCpuCore, &cpu_set);
+
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+			GS_LOG_MSG(warning, "Could not pin ball_watcher_event_loop to core " + std::to_string(NcnnRuntime::kRealtimeCpuCore));
+			return;
+		}
+
+		pinned_ = true;
+	}
+
+	~ScopedRealtimeCoreAffinity() {
+		if (pinned_) {
+			pthread_setaffinity_np(pthread_self(), sizeof(previous_cpu_set_), &previous_cpu_set_);
+		}
+	}
+
+private:
+	cpu_set_t previous_cpu_set_;
+	bool pinned_ = false;
+};
+
+// Flushes the trigger-path messages once the loop is done, which is after the
+// thread has dropped back to normal priority.
+class ScopedDeferredLogFlush {
+public:
+	~ScopedDeferredLogFlush() {
+		GsDeferredLog::Flush();
+	}
+};
+
+// Touches enough of the stack that the trigger path will not fault on it.  Each page is
+// written through the volatile array, and the function is never inlined, so that the
+// compiler can neither drop the writes nor fold the array into the caller's frame.
+__attribute__((noinline)) static void PrefaultStack() {
+	const size_t kPrefaultStackBytes = 256 * 1024;
+	const size_t page_size = std::max((long)sysconf(_SC_PAGESIZE), 1L);
+	volatile unsigned char stack_memory[kPrefaultStackBytes];
+
+	for (size_t offset = 0; offset < kPrefaultStackBytes; offset += page_size) {
+		stack_memory[offset] = 0;
+	}
+	stack_memory[kPrefaultStackBytes - 1] = 0;
+}
+
+// Locks all of the process's current pages into memory.  Future pages are locked too
+// when there is no memlock limit (e.g., with CAP_IPC_LOCK), since otherwise later
+// allocations elsewhere in the system could start to fail once the limit is reached.
+static void LockProcessMemory() {
+	static bool memory_locked = false;
+	if (memory_locked) {
+		return;
+	}
+
+	struct rlimit memlock_limit;
+	int flags = MCL_CURRENT;
+	if (getrlimit(RLIMIT_MEMLOCK, &memlock_limit) == 0 && memlock_limit.rlim_cur == RLIM_INFINITY) {
+		flags |= MCL_FUTURE;
+	}
+
+	if (mlockall(flags) != 0) {
+		GS_LOG_MSG(warning, "Could not mlockall (" + std::string(strerror(errno)) + ") — trigger path may page fault. Grant CAP_IPC_LOCK to pitrac_lm.");
+		return;
+	}
+
+	GS_LOG_TRACE_MSG(trace, std::string("Locked process memory") + ((flags & MCL_FUTURE) ? " (current and future pages)." : " (current pages only)."));
+	memory_locked = true;
+}
+
+// Logs the chain's stage timings once the loop is done, along with the deferred messages
+class ScopedStageTimingLog {
+public:
+	explicit ScopedStageTimingLog(const GsWatcherStageChain& chain) : chain_(chain) {}
+	~ScopedStageTimingLog() {
+		chain_.LogTimings();
+	}
+
+private:
+	const GsWatcherStageChain& chain_;
+};
+
+// Keeps the intervals between the frames that the watcher gets (from each request's sensor
+// timestamps), and has the crop planner check them against the requested rate once the loop
+// is done.  Nothing is logged while the loop runs.
+class FrameRateMonitorStage : public GsWatcherStage {
+public:
+	explicit FrameRateMonitorStage(double requested_fps) : requested_fps_(requested_fps) {}
+	~FrameRateMonitorStage() {
+		GsCropPlanner::CheckDeliveredFrameRate(frames_, (frames_ > 0) ? total_interval_us_ / frames_ : 0.0,
+											   worst_interval_us_, requested_fps_);
+	}
+
+	char const* Name() const override { return "frame_rate_monitor"; }
+
+	bool Process(GsWatcherFrame& frame) override {
+		// The first frame of a (re-)started camera has no interval
+		const float framerate = (*frame.request)->framerate;
+		if (framerate <= 0.0f) {
+			return false;
+		}
+
+		const double interval_us = 1.0e6 / framerate;
+		frames_++;
+		total_interval_us_ += interval_us;
+		worst_interval_us_ = std::max(worst_interval_us_, interval_us);
+		return false;
+	}
+
+private:
+	double requested_fps_ = 0.0;
+	unsigned int frames_ = 0;
+	double total_interval_us_ = 0.0;
+	double worst_interval_us_ = 0.0;
+};
+
+// Hands each frame to the camera health monitor, along with how far the app's message queue
+// has backed up behind it
+class CameraHealthStage : public GsWatcherStage {
+public:
+	CameraHealthStage(RPiCamApp& app, GsCameraHealth& health) : app_(app), health_(health) {}
+
+	char const* Name() const override { return "camera_health"; }
+
+	bool Process(GsWatcherFrame& frame) override {
+		health_.RecordFrame(**frame.request, app_.PendingMessages());
+		return false;
+	}
+
+private:
+	RPiCamApp& app_;
+	GsCameraHealth& health_;
+};
+
+// Works up the recovery tiers from the one that the health monitor picked, until one of
+// them gets the camera going again.  reconfigured is called after the camera has been
+// configured again, so that whatever depends on its streams can be set up again.
+// Returns false if none of the tiers worked.
+static bool RecoverCamera(RPiCamEncoder &app, GsCameraHealth& health, GsCameraRecovery tier,
+						  unsigned int video_flags, const std::function<void()>& reconfigured)
+{
+	while (tier != GsCameraRecovery::kNone) {
+		GS_LOG_MSG(warning, "Attempting a camera " + std::string(GsCameraHealth::RecoveryName(tier)) + ".");
+
+		bool recovered = false;
+
+		try {
+			switch (tier) {
+				case GsCameraRecovery::kRequeue:
+					recovered = app.RequeueCancelledRequests();
+					break;
+
+				case GsCameraRecovery::kRestartStream:
+					app.StopCamera();
+					app.StartCamera();
+					recovered = true;
+					break;
+
+				case GsCameraRecovery::kReconfigure:
+					app.StopCamera();
+					app.Teardown();
+					app.ConfigureVideo(video_flags);
+					app.StartCamera();
+					reconfigured();
+					recovered = true;
+					break;
+
+				case GsCameraRecovery::kReopen:
+					app.StopCamera();
+					app.Teardown();
+					app.CloseCamera();
+					app.OpenCamera();
+					app.ConfigureVideo(video_flags);
+					app.StartCamera();
+					reconfigured();
+					recovered = true;
+					break;
+
+				default:
+					break;
+			}
+		}
+		catch (std::exception const& e) {
+			GS_LOG_MSG(error, "Camera " + std::string(GsCameraHealth::RecoveryName(tier)) + " failed: " + std::string(e.what()));
+		}
+
+		tier = health.RecordRecovery(tier, recovered);
+
+		if (recovered) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Offers frames to the live preview stream, which has its own rate
+class PreviewWatcherStage : public GsWatcherStage {
+public:
+	explicit PreviewWatcherStage(const cv::Rect& search_area = cv::Rect()) : search_area_(search_area) {}
+
+	char const* Name() const override { return "preview"; }
+
+	bool Process(GsWatcherFrame& frame) override {
+		if (frame.main_image == nullptr || !GsPreviewStream::WantsFrame()) {
+			return false;
+		}
+
+		cv::Mat luminance((int)frame.main_info.height, (int)frame.main_info.width, CV_8U, (void *)frame.main_image, frame.main_info.stride);
+		GsPreviewStream::SubmitFrame(luminance, search_area_);
+		return false;
+	}
+
+private:
+	cv::Rect search_area_;
+};
+
+// Puts frames on the local display, straight from the camera's buffers
+class LocalDisplayWatcherStage : public GsWatcherStage {
+public:
+	// The display may still be showing one of this loop's buffers
+	~LocalDisplayWatcherStage() override { GsLocalDisplay::ReleaseFrames(); }
+
+	char const* Name() const override { return "local_display"; }
+
+	bool Process(GsWatcherFrame& frame) override {
+		if (frame.main_image == nullptr || !GsLocalDisplay::WantsFrame()) {
+			return false;
+		}
+
+		GsLocalDisplay::ShowFrame(*frame.request, frame.main_stream, frame.main_info);
+		return false;
+	}
+};
+
+// Compares a decimated sample of the tee region with the last-seen one, every frame_period'th frame
+class PlacementChangeWatcherStage : public GsWatcherStage {
+public:
+	PlacementChangeWatcherStage(const cv::Rect& region, cv::Mat& reference_region)
+		: region_(region), reference_region_(reference_region) {
+		const int decimation = std::max(1, LibCameraInterface::kBallPlacementWatcherDecimation);
+		frame_period_ = std::max(1, LibCameraInterface::kBallPlacementWatcherFramePeriod);
+		sample_size_ = cv::Size(std::max(1, region.width / decimation), std::max(1, region.height / decimation));
+		changed_pixels_threshold_ = std::max(1, (int)(LibCameraInterface::kBallPlacementWatcherChangedFraction * sample_size_.area()));
+	}
+
+	char const* Name() const override { return "placement_change"; }
+
+	// Ends the chain once the region has changed
+	bool Process(GsWatcherFrame& frame) override {
+		// Duty-cycle the detector.  The frames in between are just handed back to the camera.
+		if (frame.main_image == nullptr || (*frame.request)->sequence % frame_period_) {
+			return false;
+		}
+
+		// Only the luminance plane is needed
+		cv::Mat luminance((int)frame.main_info.height, (int)frame.main_info.width, CV_8U, (void *)frame.main_image, frame.main_info.stride);
+
+		// Nearest-neighbor decimation only touches the sampled pixels
+		cv::resize(luminance(region_), sample_, sample_size_, 0, 0, cv::INTER_NEAREST);
+
+		if (reference_region_.size() != sample_.size() || reference_region_.type() != sample_.type()) {
+			reference_region_ = sample_.clone();
+			return false;
+		}
+
+		cv::absdiff(sample_, reference_region_, difference_);
+		int changed_pixels = cv::countNonZero(difference_ > LibCameraInterface::kBallPlacementWatcherPixelDifference);
+
+		if (changed_pixels < changed_pixels_threshold_) {
+			return false;
+		}
+
+		GS_LOG_TRACE_MSG(trace, "ball_placement_watcher_event_loop - tee region changed (" + std::to_string(changed_pixels) + " of " +
+								std::to_string(sample_size_.area()) + " sampled pixels).");
+		reference_region_ = sample_.clone();
+		change_detected_ = true;
+		return true;
+	}
+
+	bool ChangeDetected() const { return change_detected_; }
+
+private:
+	cv::Rect region_;
+	cv::Mat& reference_region_;
+	int frame_period_ = 1;
+	cv::Size sample_size_;
+	int changed_pixels_threshold_ = 1;
+	cv::Mat sample_;
+	cv::Mat difference_;
+	bool change_detected_ = false;
+};
+
 // The main event loop for the application.
 
 bool ball_watcher_event_loop(RPiCamEncoder &app, bool & motion_detected)
 {
+	GS_TRACE_ZONE("BallWatcherLoop");
+
+	ScopedDeferredLogFlush deferred_log_flush;
+
+	const bool realtime_mode = LibCameraInterface::kBallWatcherRealtimeMode;
+
+	if (realtime_mode) {
+		LockProcessMemory();
+		PrefaultStack();
+	}
+
 	// Elevate to real-time priority for the trigger-critical motion detection loop.
 	// Prevents the kernel from preempting us for 1-4ms during normal scheduling.
 	// Requires CAP_SYS_NICE (granted via AmbientCapabilities in the systemd service).
@@ -63,16 +401,41 @@ bool ball_watcher_event_loop(RPiCamEncoder &app, bool & motion_detected)
 		GS_LOG_MSG(warning, "Could not set SCHED_FIFO — trigger latency may have jitter. Grant CAP_SYS_NICE to pitrac_lm.");
 	}
 
+	ScopedRealtimeCoreAffinity realtime_core_affinity;
+
 	VideoOptions const *options = app.GetOptions();
-	std::unique_ptr<Output> output = std::unique_ptr<Output>(Output::Create(options));
-	app.SetEncodeOutputReadyCallback(std::bind(&Output::OutputReady, output.get(), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
-	app.SetMetadataReadyCallback(std::bind(&Output::MetadataReady, output.get(), std::placeholders::_1));
+
+	// In detect-only mode there is no encoder or output at all, so each buffer goes
+	// back to libcamera as soon as the motion detector is done with it
+	const bool detect_only = LibCameraInterface::kBallWatcherDetectOnly;
+
+	// The swing replay is the one output that is kept even in detect-only mode
+	std::unique_ptr<Output> output;
+	GsSwingReplay* swing_replay = nullptr;
+	if (GsSwingReplay::UseReplay()) {
+		GsSwingReplay::ConfigureVideoOptions(app.GetOptions());
+		swing_replay = new GsSwingReplay(options);
+		output = std::unique_ptr<Output>(swing_replay);
+	}
+	else if (!detect_only) {
+		output = std::unique_ptr<Output>(Output::Create(options));
+	}
+
+	const bool encoding = (output != nullptr);
+	if (encoding) {
+		app.SetEncodeOutputReadyCallback(std::bind(&Output::OutputReady, output.get(), std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+		app.SetMetadataReadyCallback(std::bind(&Output::MetadataReady, output.get(), std::placeholders::_1));
+	}
+
+	const unsigned int video_flags = get_colourspace_flags(options->Get().codec);
 
 	app.OpenCamera();
 
-	app.ConfigureVideo(get_colourspace_flags(options->Get().codec));
-	GS_LOG_TRACE_MSG(trace, "ball_watcher_event_loop - starting encoder.");
-	app.StartEncoder();
+	app.ConfigureVideo(video_flags);
+	if (encoding) {
+		GS_LOG_TRACE_MSG(trace, "ball_watcher_event_loop - starting encoder.");
+		app.StartEncoder();
+	}
 	app.StartCamera();
 
 	// Instead of using the dynamical link4ed-library approach used by lrpiocam apps, 
@@ -86,6 +449,33 @@ bool ball_watcher_event_loop(RPiCamEncoder &app, bool & motion_detected)
 	motion_detect_stage.Read(empty_params);
 	motion_detect_stage.Configure();
 
+	// Motion detection always runs first, as it is the latency-critical part.  The preview
+	// only sees the frames in which nothing was triggered, and is left out altogether in
+	// realtime mode.
+	// The frame-rate and health monitors are last, and so do not see the frame that triggered.
+	const double requested_fps = options->Get().framerate.value_or(0.0f);
+	GsCameraHealth camera_health(GsCameraNumber::kGsCamera1, "ball_watcher_event_loop", requested_fps);
+	PreviewWatcherStage preview_stage;
+	LocalDisplayWatcherStage local_display_stage;
+	FrameRateMonitorStage frame_rate_monitor_stage(requested_fps);
+	CameraHealthStage camera_health_stage(app, camera_health);
+	GsWatcherStageChain watcher_chain(app);
+	watcher_chain.Add(motion_detect_stage);
+	if (!realtime_mode) {
+		watcher_chain.Add(preview_stage);
+		watcher_chain.Add(local_display_stage);
+	}
+	watcher_chain.Add(frame_rate_monitor_stage);
+	watcher_chain.Add(camera_health_stage);
+	watcher_chain.Configure();
+	ScopedStageTimingLog stage_timing_log(watcher_chain);
+
+	auto reconfigured = [&]() {
+		GsLocalDisplay::ReleaseFrames();
+		motion_detect_stage.Configure();
+		watcher_chain.Configure();
+	};
+
 
 	auto start_time = std::chrono::high_resolution_clock::now();
 
@@ -93,6 +483,22 @@ bool ball_watcher_event_loop(RPiCamEncoder &app, bool & motion_detected)
 
 	motion_detected = false;
 
+	// Once the ball has been hit, the swing replay still gets this many more frames
+	int post_hit_frames_left = 0;
+
+	// Ends a watch in which the ball was hit, once the swing replay has all of its frames
+	auto end_after_hit = [&]() {
+		app.StopCamera();
+		app.StopEncoder();
+		if (swing_replay != nullptr) {
+			swing_replay->SaveClip();
+		}
+		// Drop RT priority before returning to normal processing
+		sp.sched_priority = 0;
+		pthread_setschedparam(pthread_self(), SCHED_OTHER, &sp);
+		return true;
+	};
+
 	for (unsigned int count = 0; ; count++)
 	{
 		if (!gs::GolfSimGlobals::golf_sim_running_) {
@@ -104,15 +510,28 @@ bool ball_watcher_event_loop(RPiCamEncoder &app, bool & motion_detected)
 		}
 
 
-		RPiCamEncoder::Msg msg = app.Wait();
-		if (msg.type == RPiCamApp::MsgType::Timeout)
+		std::optional<RPiCamEncoder::Msg> waited_msg = app.Wait(std::chrono::milliseconds(GsCameraHealth::kCameraHealthStallTimeoutMs));
+		if (!waited_msg || waited_msg->type == RPiCamApp::MsgType::Timeout)
 		{
-			GS_LOG_MSG(error, "ERROR: Device timeout detected, attempting a restart!!!");
-			app.StopCamera();
-			app.StartCamera();
+			GS_LOG_MSG(error, waited_msg ? "ERROR: Device timeout detected in ball_watcher_event_loop." :
+										   "ERROR: Camera stream stalled in ball_watcher_event_loop.");
+			// The shot does not depend on the post-hit frames, so they are not worth a recovery
+			if (post_hit_frames_left > 0) {
+				return end_after_hit();
+			}
+			GsCameraRecovery tier = waited_msg ? camera_health.RecordTimeout() : camera_health.RecordStall();
+			if (!RecoverCamera(app, camera_health, tier, video_flags, reconfigured)) {
+				app.StopCamera();
+				app.StopEncoder();
+				sp.sched_priority = 0;
+				pthread_setschedparam(pthread_self(), SCHED_OTHER, &sp);
+				return false;
+			}
 			continue;
 		}
 
+		RPiCamEncoder::Msg& msg = *waited_msg;
+
 		if (msg.type == RPiCamEncoder::MsgType::Quit) {
 			GS_LOG_TRACE_MSG(trace, "Received Quit message in ball_watcher_event_loop.");
 			app.StopCamera();
@@ -132,22 +551,34 @@ bool ball_watcher_event_loop(RPiCamEncoder &app, bool & motion_detected)
 
 		CompletedRequestPtr &completed_request = std::get<CompletedRequestPtr>(msg.payload);
 
+		// The trigger has already gone out, so the post-hit frames only go to the replay
+		if (post_hit_frames_left > 0) {
+			app.EncodeBuffer(completed_request, app.VideoStream());
+			if (--post_hit_frames_left == 0) {
+				return end_after_hit();
+			}
+			continue;
+		}
+
 		// Motion detection FIRST — this is the latency-critical path.
 		// EncodeBuffer is deferred until after we check for motion.
-		bool result = motion_detect_stage.Process(completed_request);
+		watcher_chain.Process(completed_request);
 
-		bool mdResult = false;
-		int getStatus = completed_request->post_process_metadata.Get("motion_detect.result", mdResult);
+		bool mdResult = motion_detect_stage.GetLastResult();
+		int getStatus = 0;
+		if (!realtime_mode) {
+			getStatus = completed_request->post_process_metadata.Get("motion_detect.result", mdResult);
+		}
 		if (getStatus == 0) {
 			if (mdResult) {
-				// Trigger already fired inside Process() — stop immediately
-				app.StopCamera();
-				app.StopEncoder();
 				motion_detected = true;
-				// Drop RT priority before returning to normal processing
-				sp.sched_priority = 0;
-				pthread_setschedparam(pthread_self(), SCHED_OTHER, &sp);
-				return true;
+				if (swing_replay != nullptr && GsSwingReplay::kSwingReplayPostHitFrames > 0) {
+					app.EncodeBuffer(completed_request, app.VideoStream());
+					post_hit_frames_left = GsSwingReplay::kSwingReplayPostHitFrames;
+					continue;
+				}
+				// Trigger already fired inside Process() — stop immediately
+				return end_after_hit();
 			}
 			else {
 				// std::cout << "****** motion stopped ********* " << std::endl;
@@ -158,7 +589,115 @@ bool ball_watcher_event_loop(RPiCamEncoder &app, bool & motion_detected)
 		}
 
 		// Encode after motion check — keeps encoding out of the trigger-critical path
-		app.EncodeBuffer(completed_request, app.VideoStream());
+		if (encoding) {
+			app.EncodeBuffer(completed_request, app.VideoStream());
+		}
+	}
+
+	return true;
+}
+
+
+bool ball_placement_watcher_event_loop(RPiCamEncoder &app,
+									   const cv::Rect& watch_region,
+									   cv::Mat& reference_region,
+									   unsigned int max_watch_time_ms,
+									   bool& change_detected)
+{
+	GS_TRACE_ZONE("BallPlacementWatcherLoop");
+
+	change_detected = false;
+
+	VideoOptions const *options = app.GetOptions();
+
+	const unsigned int video_flags = get_colourspace_flags(options->Get().codec);
+
+	// Nothing is being recorded, so the encoder is never started
+	app.OpenCamera();
+	app.ConfigureVideo(video_flags);
+	app.StartCamera();
+
+	Stream *stream = app.VideoStream();
+	StreamInfo info = app.GetStreamInfo(stream);
+
+	const cv::Rect region = watch_region & cv::Rect(0, 0, (int)info.width, (int)info.height);
+
+	if (region.empty()) {
+		GS_LOG_MSG(error, "ball_placement_watcher_event_loop - watch region is outside of the video frame.");
+		app.StopCamera();
+		return false;
+	}
+
+	// The live preview has its own rate, so it is fed from frames the detector skips, too
+	// The health monitor goes first, as the placement stage ends the chain once it sees a change
+	GsCameraHealth camera_health(GsCameraNumber::kGsCamera1, "ball_placement_watcher_event_loop",
+								 options->Get().framerate.value_or(0.0f));
+	CameraHealthStage camera_health_stage(app, camera_health);
+	PreviewWatcherStage preview_stage(region);
+	LocalDisplayWatcherStage local_display_stage;
+	PlacementChangeWatcherStage placement_stage(region, reference_region);
+	GsWatcherStageChain watcher_chain(app);
+	watcher_chain.Add(camera_health_stage);
+	watcher_chain.Add(preview_stage);
+	watcher_chain.Add(local_display_stage);
+	watcher_chain.Add(placement_stage);
+	watcher_chain.Configure();
+	ScopedStageTimingLog stage_timing_log(watcher_chain);
+
+	// The same options give the same stream, so the region still fits
+	auto reconfigured = [&]() {
+		GsLocalDisplay::ReleaseFrames();
+		watcher_chain.Configure();
+	};
+
+	auto start_time = std::chrono::steady_clock::now();
+
+	while (true)
+	{
+		if (!gs::GolfSimGlobals::golf_sim_running_) {
+			app.StopCamera();
+			return false;
+		}
+
+		auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+		if (elapsed_ms >= max_watch_time_ms) {
+			app.StopCamera();
+			return true;
+		}
+
+		std::optional<RPiCamEncoder::Msg> waited_msg = app.Wait(std::chrono::milliseconds(GsCameraHealth::kCameraHealthStallTimeoutMs));
+		if (!waited_msg || waited_msg->type == RPiCamApp::MsgType::Timeout)
+		{
+			GS_LOG_MSG(error, waited_msg ? "ERROR: Device timeout detected in ball_placement_watcher_event_loop." :
+										   "ERROR: Camera stream stalled in ball_placement_watcher_event_loop.");
+			GsCameraRecovery tier = waited_msg ? camera_health.RecordTimeout() : camera_health.RecordStall();
+			if (!RecoverCamera(app, camera_health, tier, video_flags, reconfigured)) {
+				app.StopCamera();
+				return false;
+			}
+			continue;
+		}
+
+		RPiCamEncoder::Msg& msg = *waited_msg;
+
+		if (msg.type == RPiCamEncoder::MsgType::Quit) {
+			GS_LOG_TRACE_MSG(trace, "Received Quit message in ball_placement_watcher_event_loop.");
+			app.StopCamera();
+			return true;
+		}
+		else if (msg.type != RPiCamEncoder::MsgType::RequestComplete) {
+			GS_LOG_MSG(error, "Unrecognised camera message type in ball_placement_watcher_event_loop, aborting.");
+			app.StopCamera();
+			return false;
+		}
+
+		CompletedRequestPtr &completed_request = std::get<CompletedRequestPtr>(msg.payload);
+
+		if (watcher_chain.Process(completed_request) && placement_stage.ChangeDetected()) {
+			change_detected = true;
+			app.StopCamera();
+			return true;
+		}
 	}
 
 	return true;
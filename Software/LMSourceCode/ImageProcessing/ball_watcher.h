@@ -7,6 +7,8 @@
 
 #ifdef __unix__  // Ignore in Windows environment
 
+#include <opencv2/core.hpp>
+
 #include "core/rpicam_encoder.hpp"
 #include "encoder/encoder.hpp"
 
@@ -17,6 +19,17 @@ namespace golf_sim {
 	// motion_detected will be set true only if motion was successfully detected.
 	bool ball_watcher_event_loop(RPiCamEncoder &app, bool& motion_detected);
 
+	// A low-power loop that watches the (decimated) watch_region of a low frame-rate video
+	// stream for any change compared to reference_region, e.g., from a ball being placed.
+	// reference_region holds the decimated sample of the last-seen scene across calls.
+	// Returns after a change is seen, or after max_watch_time_ms with change_detected = false.
+	// Returns true if function ran as expected, and without error.
+	bool ball_placement_watcher_event_loop(RPiCamEncoder &app,
+										   const cv::Rect& watch_region,
+										   cv::Mat& reference_region,
+										   unsigned int max_watch_time_ms,
+										   bool& change_detected);
+
 }
 
 #endif // #ifdef __unix__  // Ignore in Windows environment
@@ -7,12 +7,115 @@
 
 #ifdef __unix__  // Ignore in Windows environment
 
+#include <algorithm>
+#include <cstring>
+
+#include "gs_memory_footprint.h"
 
 #include "ball_watcher_image_buffer.h"
 
-	// Global queue to hold the last <n> frames before motion is detected in the frame
-	// WARNING - NOT THREAD SAFE ON ITS OWN
-	boost::circular_buffer<golf_sim::RecentFrameInfo> golf_sim::RecentFrames(10);
+	// Global ring to hold the last <n> frames before motion is detected in the frame
+	golf_sim::RecentFrameRing golf_sim::RecentFrames;
 
-#endif // #ifdef __unix__  // Ignore in Windows environment
+namespace golf_sim {
+
+	void RecentFrameRing::Configure(size_t capacity, int width, int height) {
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		slots_.resize(capacity);
+		for (RecentFrameInfo& slot : slots_) {
+			// Re-uses the existing allocation if the size has not changed
+			slot.mat.create(height, width, CV_8U);
+			slot.requestSequence = 0;
+			slot.isballHitFrame = false;
+			slot.frameRate = 0.0;
+		}
+
+		next_slot_ = 0;
+		count_ = 0;
+
+		GsMemoryFootprint::SetBytes(GsMemoryFootprint::Subsystem::kRecentFrames, capacity * (size_t)width * (size_t)height);
+	}
+
+	cv::Mat* RecentFrameRing::CopyIntoNextSlot(const uint8_t* image, int width, int height, int stride, const RecentFrameInfo& frame_info) {
+		if (slots_.empty()) {
+			return nullptr;
+		}
+
+		RecentFrameInfo& slot = slots_[next_slot_];
+
+		if (slot.mat.cols != width || slot.mat.rows != height) {
+			return nullptr;
+		}
+
+		// Only the visible width of each row is kept, not the stride padding
+		for (int row = 0; row < height; row++) {
+			memcpy(slot.mat.ptr(row), image + (size_t)row * stride, width);
+		}
+
+		slot.requestSequence = frame_info.requestSequence;
+		slot.isballHitFrame = frame_info.isballHitFrame;
+		slot.frameRate = frame_info.frameRate;
+
+		next_slot_ = (next_slot_ + 1) % slots_.size();
+		count_ = std::min(count_ + 1, slots_.size());
+
+		return &slot.mat;
+	}
+
+	std::vector<RecentFrameInfo> RecentFrameRing::Snapshot() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		std::vector<RecentFrameInfo> frames;
+		frames.reserve(count_);
 
+		// The oldest frame is the one that will be overwritten next
+		const size_t oldest_slot = (next_slot_ + slots_.size() - count_) % std::max(slots_.size(), (size_t)1);
+
+		for (size_t i = 0; i < count_; i++) {
+			const RecentFrameInfo& slot = slots_[(oldest_slot + i) % slots_.size()];
+
+			RecentFrameInfo frame = slot;
+			frame.mat = slot.mat.clone();
+			frames.push_back(frame);
+		}
+
+		return frames;
+	}
+
+	std::vector<RecentFrameInfo> RecentFrameRing::TakeFrames() {
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		std::vector<RecentFrameInfo> frames;
+		frames.reserve(count_);
+
+		const size_t oldest_slot = (next_slot_ + slots_.size() - count_) % std::max(slots_.size(), (size_t)1);
+
+		for (size_t i = 0; i < count_; i++) {
+			frames.push_back(std::move(slots_[(oldest_slot + i) % slots_.size()]));
+		}
+
+		// The next Configure allocates new frame memory, as these Mats are now the caller's
+		slots_.clear();
+		next_slot_ = 0;
+		count_ = 0;
+
+		GsMemoryFootprint::SetBytes(GsMemoryFootprint::Subsystem::kRecentFrames, 0);
+
+		return frames;
+	}
+
+	size_t RecentFrameRing::size() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return count_;
+	}
+
+	void RecentFrameRing::clear() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		next_slot_ = 0;
+		count_ = 0;
+	}
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
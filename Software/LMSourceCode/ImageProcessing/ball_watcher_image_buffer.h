@@ -8,11 +8,12 @@
 
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 #include <opencv2/core/cvdef.h>
 #include <opencv2/highgui.hpp>
 
-#include <boost/circular_buffer.hpp>
-
 namespace golf_sim {
 
 	//  We also need to be able to reach these variables from within the libcamera namespace.
@@ -26,7 +27,60 @@ namespace golf_sim {
 		float frameRate = 0.0;
 	};
 
-	// Global queue to hold the last <n> frames before motion is detected in the frame
-	extern boost::circular_buffer<RecentFrameInfo> RecentFrames;
+	// A fixed-size ring of the last <n> frames around the time motion is detected.
+	// All of the frame memory is allocated up front by Configure(), so adding a frame
+	// on the (time-critical) motion-detection thread is just a row-by-row memcpy into
+	// the oldest slot.  Snapshot() gives the club-data processing its own copy, and
+	// TakeFrames() hands the frames over without copying them.
+	class RecentFrameRing {
+	public:
+		// Allocates capacity frames of width x height 8-bit pixels and empties the ring
+		void Configure(size_t capacity, int width, int height);
+
+		// Copies the frame into the ring, overwriting the oldest frame if the ring is full.
+		// annotate(cv::Mat&) is then called on the ring's copy of the frame while the ring
+		// is still locked, so that a Snapshot() or TakeFrames() on another thread never
+		// sees a half-drawn frame.
+		// Returns false if the ring has not been configured for frames of this size.
+		template <typename Annotator>
+		bool Push(const uint8_t* image, int width, int height, int stride, const RecentFrameInfo& frame_info,
+				  Annotator&& annotate) {
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			cv::Mat* frame = CopyIntoNextSlot(image, width, height, stride, frame_info);
+
+			if (frame == nullptr) {
+				return false;
+			}
+
+			annotate(*frame);
+			return true;
+		}
+
+		// Deep copy of the frames currently in the ring, oldest first
+		std::vector<RecentFrameInfo> Snapshot() const;
+
+		// The frames currently in the ring, oldest first, without copying them.  The ring
+		// gives up its frame memory and is empty afterward, so it must be configured
+		// again before the next Push.
+		std::vector<RecentFrameInfo> TakeFrames();
+
+		size_t size() const;
+		void clear();
+
+	private:
+		// The caller must hold mutex_.  Returns the slot's Mat, or nullptr if there is no
+		// slot for a frame of this size.
+		cv::Mat* CopyIntoNextSlot(const uint8_t* image, int width, int height, int stride, const RecentFrameInfo& frame_info);
+
+		mutable std::mutex mutex_;
+		std::vector<RecentFrameInfo> slots_;
+		// Index of the slot the next Push will write
+		size_t next_slot_ = 0;
+		size_t count_ = 0;
+	};
+
+	// Global ring to hold the last <n> frames before (and after) motion is detected in the frame
+	extern RecentFrameRing RecentFrames;
 
-}
\ No newline at end of file
+}
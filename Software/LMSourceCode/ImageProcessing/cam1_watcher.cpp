@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__
+
+#include "cam1_watcher.h"
+#include "golf_ball.h"
+#include "gs_camera.h"
+#include "camera_hardware.h"
+#include "libcamera_interface.h"
+#include "logging_tools.h"
+#include "core/rpicam_encoder.hpp"
+
+namespace golf_sim {
+
+Camera1Watcher::~Camera1Watcher() {
+    stop();
+}
+
+void Camera1Watcher::init() {
+    GS_LOG_TRACE_MSG(trace, "Camera1 creating the ball-watcher app");
+
+    camera_ = std::make_unique<GolfSimCamera>();
+    camera_->camera_hardware_.init_camera_parameters(
+        GsCameraNumber::kGsCamera1,
+        GolfSimCamera::kSystemSlot1CameraType,
+        GolfSimCamera::kSystemSlot1LensType,
+        GolfSimCamera::kSystemSlot1CameraOrientation);
+
+    app_ = std::make_unique<RPiCamEncoder>();
+    app_->KeepSensorModes(true);
+}
+
+void Camera1Watcher::release_camera() {
+    try {
+        app_->StopCamera();
+        app_->Teardown();
+        app_->CloseCamera();
+    }
+    catch (std::exception const& e) {
+        GS_LOG_MSG(warning, "Camera1 could not release the camera: " + std::string(e.what()));
+    }
+
+    // The ball watcher's output only lives as long as each watch
+    app_->SetEncodeOutputReadyCallback(nullptr);
+    app_->SetMetadataReadyCallback(nullptr);
+}
+
+bool Camera1Watcher::watch(const GolfBall& ball, cv::Mat& image, bool& motion_detected) {
+    if (!app_) {
+        init();
+    }
+
+    const bool ok = WatchForHitAndTrigger(*camera_, *app_, ball, image, motion_detected);
+
+    release_camera();
+
+    return ok;
+}
+
+void Camera1Watcher::stop() {
+    if (!app_) {
+        return;
+    }
+
+    release_camera();
+    app_.reset();
+    camera_.reset();
+}
+
+} // namespace golf_sim
+
+#endif // __unix__
@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#pragma once
+
+#ifdef __unix__
+
+#include <memory>
+#include <opencv2/core.hpp>
+
+// Forward declarations — avoid pulling libcamera headers into every TU
+class RPiCamEncoder;
+
+namespace golf_sim {
+
+class GolfBall;
+class GolfSimCamera;
+
+// Holds camera 1's ball-watching app (and its camera description) across shots, so that
+// each shot does not build a new RPiCamEncoder, re-parse its options or re-enumerate the
+// sensor modes.  Unlike Camera2Thread, the camera itself cannot stay open - camera 1 also
+// takes the full-frame ball-placement pictures between shots - so it is released after
+// every watch.  The sensor modes are only found again if the crop size changes.
+class Camera1Watcher {
+public:
+    Camera1Watcher() = default;
+    ~Camera1Watcher();
+
+    Camera1Watcher(const Camera1Watcher&) = delete;
+    Camera1Watcher& operator=(const Camera1Watcher&) = delete;
+
+    // Crops camera 1 around the ball and blocks until the ball moves.  See
+    // WatchForHitAndTrigger.  Returns true iff no error occurred.
+    bool watch(const GolfBall& ball, cv::Mat& image, bool& motion_detected);
+    void stop();
+
+private:
+    void init();
+    void release_camera();
+
+    std::unique_ptr<GolfSimCamera> camera_;
+    std::unique_ptr<RPiCamEncoder> app_;
+};
+
+} // namespace golf_sim
+
+#endif // __unix__
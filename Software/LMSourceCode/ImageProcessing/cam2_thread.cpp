@@ -5,21 +5,32 @@
 
 #ifdef __unix__
 
+#include <functional>
+
 #include "cam2_thread.h"
 #include "gs_globals.h"
 #include "gs_events.h"
 #include "gs_options.h"
 #include "gs_clubs.h"
+#include "gs_session_settings.h"
 #include "gs_camera.h"
 #include "camera_hardware.h"
 #include "libcamera_interface.h"
 #include "logging_tools.h"
+#include "gs_shot_trace.h"
+#include "gs_trace_zones.h"
+#include "gs_camera2_background.h"
+#include "gs_camera2_exposure.h"
+#include "gs_memory_footprint.h"
 #include "still_image_libcamera_app.hpp"
 #include "core/rpicam_app.hpp"
 #include "core/still_options.hpp"
 
 // Defined in libcamera_jpeg.cpp
-bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_priming_pulses = false);
+void cam2_start_persistent_capture(LibcameraJpegApp& app);
+bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_priming_pulses,
+                         const golf_sim::Cam2FrameHandoff& frame_handoff, bool persistent_capture,
+                         const golf_sim::Cam2FrameHandoff& priming_frame_handoff);
 
 namespace golf_sim {
 
@@ -45,7 +56,7 @@ bool Camera2Thread::init_pipeline() {
 
     char dummy[] = "DummyExecutableName";
     char* argv[] = {dummy, NULL};
-    if (!options->Parse(1, argv)) {
+    if (!options->ParseOnce(1, argv)) {
         GS_LOG_MSG(error, "Camera2 failed to parse options");
         return false;
     }
@@ -82,9 +93,16 @@ bool Camera2Thread::init_pipeline() {
 
     // Open and configure once — this is the expensive part (~500-1200ms)
     app_->OpenCamera();
-    uint flags = RPiCamApp::FLAG_STILL_RGB;
+    uint flags = LibCameraInterface::GetCamera2ViewfinderFlags();
     app_->ConfigureViewfinder(flags);
 
+    persistent_capture_ = LibCameraInterface::kCamera2PersistentRequests;
+
+    if (persistent_capture_) {
+        // The requests are made and queued here, once, instead of on every shot
+        cam2_start_persistent_capture(*app_);
+    }
+
     pipeline_ready_ = true;
     GS_LOG_MSG(info, "Camera2 pipeline ready (OpenCamera + Configure done)");
     return true;
@@ -158,6 +176,7 @@ void Camera2Thread::arm() {
 }
 
 void Camera2Thread::run() {
+    GS_TRACE_THREAD_NAME("Camera2Thread");
     GS_LOG_MSG(info, "Camera2 thread started");
 
     if (!init_pipeline()) {
@@ -180,21 +199,75 @@ void Camera2Thread::run() {
             continue;
         }
 
-        // Update gain/contrast if club type changed (takes effect on next StartCamera)
-        StillOptions* options = app_->GetOptions();
-        if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
-            options->Set().gain = LibCameraInterface::kCamera2PuttingGain;
-            options->Set().contrast = LibCameraInterface::kCamera2PuttingContrast;
-        } else {
-            options->Set().gain = LibCameraInterface::kCamera2Gain;
-            options->Set().contrast = LibCameraInterface::kCamera2Contrast;
+        // Update gain/contrast in case the club type changed
+        const bool putting = (GsSessionSettings::ShotSettings().club_type == GolfSimClubs::kPutter);
+        const double gain = GsCamera2Exposure::GetGain(putting, putting ? LibCameraInterface::kCamera2PuttingGain : LibCameraInterface::kCamera2Gain);
+        const double contrast = putting ? LibCameraInterface::kCamera2PuttingContrast : LibCameraInterface::kCamera2Contrast;
+
+        // A background taken with the other club type's (or an earlier) gain would not match the strobed image
+        if (gain != last_gain_ || contrast != last_contrast_) {
+            GsCamera2Background::Reset();
+            last_gain_ = gain;
+            last_contrast_ = contrast;
         }
 
-        GS_LOG_MSG(info, "Camera2 starting capture (StartCamera only — pipeline pre-opened)");
+        if (persistent_capture_) {
+            // The camera is not restarted, so the settings go out with the next queued request instead
+            libcamera::ControlList controls;
+            controls.set(libcamera::controls::AnalogueGain, (float)gain);
+            controls.set(libcamera::controls::Contrast, (float)contrast);
+            app_->SetControls(controls);
+
+            GS_LOG_MSG(info, "Camera2 armed (camera already running)");
+        } else {
+            StillOptions* options = app_->GetOptions();
+            options->Set().gain = gain;
+            options->Set().contrast = contrast;
+
+            GS_LOG_MSG(info, "Camera2 starting capture (StartCamera only — pipeline pre-opened)");
+        }
 
-        cv::Mat raw_image;
-        if (cam2_run_event_loop(*app_, raw_image)) {
-            cv::Mat undistorted = LibCameraInterface::undistort_camera_image(raw_image, *camera_);
+        // The undistortion reads straight from the camera buffer and writes into a pooled
+        // image, so the frame is neither copied nor (usually) allocated
+        cv::Mat undistorted;
+        auto frame_handoff = [this, &undistorted](const cv::Mat& frame, const GsGpuFrameBuffer* frame_buffer) {
+            GsShotTrace::Mark(GsShotTrace::Stage::kCam2FrameReceived);
+            if (LibCameraInterface::kCamera2GpuPreprocessing) {
+                undistorted = get_pooled_image(frame.size(), CV_8UC1);
+                if (LibCameraInterface::undistort_camera_image_to_gray_gpu(frame, frame_buffer, *camera_, undistorted)) {
+                    GsShotTrace::Mark(GsShotTrace::Stage::kUndistorted);
+                    return;
+                }
+            }
+            cv::Rect roi;
+            if (LibCameraInterface::kCamera2UndistortRoiOnly) {
+                roi = LibCameraInterface::GetCamera2UndistortionRoi(cv::Size(frame.cols, frame.rows));
+            }
+            undistorted = get_pooled_image(frame.size(), frame.type());
+            LibCameraInterface::undistort_camera_image_into(frame, *camera_, roi, undistorted);
+            GsShotTrace::Mark(GsShotTrace::Stage::kUndistorted);
+        };
+
+        // The background frames are undistorted the same way as the strobed image, but into
+        // an image of their own, as this happens before the hit
+        auto priming_frame_handoff = [this](const cv::Mat& frame, const GsGpuFrameBuffer* frame_buffer) {
+            if (!LibCameraInterface::kCamera2GpuPreprocessing ||
+                !LibCameraInterface::undistort_camera_image_to_gray_gpu(frame, frame_buffer, *camera_, background_frame_)) {
+                cv::Rect roi;
+                if (LibCameraInterface::kCamera2UndistortRoiOnly) {
+                    roi = LibCameraInterface::GetCamera2UndistortionRoi(cv::Size(frame.cols, frame.rows));
+                }
+                LibCameraInterface::undistort_camera_image_into(frame, *camera_, roi, background_frame_);
+            }
+            GsCamera2Background::Update(background_frame_);
+        };
+
+        GS_TRACE_ZONE("Camera2Capture");
+
+        cv::Mat unused_raw_image;
+        if (cam2_run_event_loop(*app_, unused_raw_image, false, frame_handoff, persistent_capture_,
+                                GsCamera2Background::kUseCamera2BackgroundModel ? priming_frame_handoff : Cam2FrameHandoff()) &&
+            !undistorted.empty()) {
             GS_LOG_MSG(info, "Camera2 captured, queuing image for FSM");
             GolfSimEventElement event{new GolfSimEvent::Camera2ImageReceived{undistorted}};
             GolfSimEventQueue::QueueEvent(event);
@@ -207,6 +280,29 @@ void Camera2Thread::run() {
     GS_LOG_MSG(info, "Camera2 thread exiting");
 }
 
+cv::Mat Camera2Thread::get_pooled_image(const cv::Size& size, int type) {
+    // An image is free again once the FSM (and anything else downstream) has let go of it
+    for (cv::Mat& image : image_pool_) {
+        if (image.u != nullptr && image.u->refcount == 1 && image.size() == size && image.type() == type) {
+            return image;
+        }
+    }
+
+    cv::Mat image(size, type);
+
+    if (image_pool_.size() < kImagePoolSize) {
+        image_pool_.push_back(image);
+
+        size_t pool_bytes = 0;
+        for (const cv::Mat& pooled_image : image_pool_) {
+            pool_bytes += pooled_image.total() * pooled_image.elemSize();
+        }
+        GsMemoryFootprint::SetBytes(GsMemoryFootprint::Subsystem::kCamera2Images, pool_bytes);
+    }
+
+    return image;
+}
+
 } // namespace golf_sim
 
 #endif // __unix__
@@ -12,6 +12,7 @@
 #include <condition_variable>
 #include <atomic>
 #include <memory>
+#include <vector>
 #include <opencv2/core.hpp>
 
 // Forward declarations — avoid pulling libcamera headers into every TU
@@ -42,6 +43,9 @@ private:
     bool init_pipeline();
     void teardown_pipeline();
 
+    // Returns an image that nothing else is using, allocating one only if every pooled image is still in use
+    cv::Mat get_pooled_image(const cv::Size& size, int type);
+
     std::thread thread_;
     std::mutex mutex_;
     std::condition_variable cv_;
@@ -53,6 +57,19 @@ private:
     std::unique_ptr<GolfSimCamera> camera_;
     std::atomic<bool> pipeline_ready_{false};
     std::atomic<bool> pipeline_failed_{false};
+
+    // See LibCameraInterface::kCamera2PersistentRequests
+    bool persistent_capture_ = false;
+
+    // Undistorted camera2 images, re-used across shots
+    static constexpr size_t kImagePoolSize = 3;
+    std::vector<cv::Mat> image_pool_;
+
+    // The priming frame being added to the background model (see GsCamera2Background)
+    cv::Mat background_frame_;
+    // The settings that the background model was taken with
+    double last_gain_ = -1.0;
+    double last_contrast_ = -1.0;
 };
 
 } // namespace golf_sim
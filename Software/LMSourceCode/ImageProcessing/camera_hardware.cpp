@@ -217,6 +217,11 @@ namespace golf_sim {
         
         camera_number_ = camera_number;
         camera_model_ = model;
+
+        // A per-camera resolution takes precedence over the process-wide one
+        const bool use_instance_override = (instance_resolution_x_override_ > 0 && instance_resolution_y_override_ > 0);
+        const int override_x = use_instance_override ? instance_resolution_x_override_ : resolution_x_override_;
+        const int override_y = use_instance_override ? instance_resolution_y_override_ : resolution_y_override_;
         lens_type_ = lens_type;
         camera_orientation_ = camera_orientation_;
 
@@ -247,9 +252,9 @@ namespace golf_sim {
             sensor_width_ = (float)5.077365371;   // 4.45;   // (1456.0 * 3.4) / 1000;   // = 4.95; //  In mm 6.3 / sqrt(2.0);  // TBD - Confirm math from diagonal measurement
             sensor_height_ = (float)3.789078635;    // 4.45; //(1088.0 * 3.4) / 1000;   //  In mm 6.3 / sqrt(2.0);
             
-            if (resolution_x_override_ > 0 && resolution_y_override_ > 0) {
-                resolution_x_ = resolution_x_override_;
-                resolution_y_ = resolution_y_override_;
+            if (override_x > 0 && override_y > 0) {
+                resolution_x_ = override_x;
+                resolution_y_ = override_y;
             }
             else {
                 //  Defaults
@@ -340,9 +345,9 @@ namespace golf_sim {
             sensor_width_ = 6.287f;
             sensor_height_ = 4.712f;
 
-            if (resolution_x_override_ > 0 && resolution_y_override_ > 0) {
-                resolution_x_ = resolution_x_override_;
-                resolution_y_ = resolution_y_override_;
+            if (override_x > 0 && override_y > 0) {
+                resolution_x_ = override_x;
+                resolution_y_ = override_y;
             }
             else {
                 //  Defaults
@@ -394,9 +399,9 @@ namespace golf_sim {
             //           resolution_x_ = 1024;
             //           resolution_y_ = 768;
 
-            if (resolution_x_override_ > 0 && resolution_y_override_ > 0) {
-                resolution_x_ = resolution_x_override_;
-                resolution_y_ = resolution_y_override_;
+            if (override_x > 0 && override_y > 0) {
+                resolution_x_ = override_x;
+                resolution_y_ = override_y;
             }
             else {
                 //  Defaults
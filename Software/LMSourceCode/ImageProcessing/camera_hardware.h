@@ -27,6 +27,10 @@ namespace golf_sim {
         // TBD - Should not be static
         static int resolution_x_override_;
         static int resolution_y_override_;
+        // Same, but only for this camera, e.g., for shots analyzed in parallel from images of
+        // different sizes.  Used instead of the static values when both are > 0.
+        int instance_resolution_x_override_ = -1;
+        int instance_resolution_y_override_ = -1;
 
         int CAMERA_NUM_PICTURES_TO_TAKE = 2;
 
@@ -25,6 +25,12 @@ struct CompletedRequest
 	{
 		r->reuse();
 	}
+	// For frames that do not come from libcamera (see GsVirtualCamera), so there are no
+	// buffers or request to re-use
+	CompletedRequest(unsigned int seq, const ControlList &m)
+		: sequence(seq), metadata(m), request(nullptr), framerate(0)
+	{
+	}
 	unsigned int sequence;
 	BufferMap buffers;
 	ControlList metadata;
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ *
+ * dma_buffer_pool.cpp - Keeps capture buffers allocated across camera reconfigurations.
+ */
+
+#include <sys/mman.h>
+
+#include "core/dma_buffer_pool.hpp"
+#include "core/logging.hpp"
+
+std::mutex DmaBufferPool::mutex_;
+std::vector<DmaBufferPool::Entry> DmaBufferPool::entries_;
+unsigned int DmaBufferPool::allocations_ = 0;
+unsigned int DmaBufferPool::reuses_ = 0;
+
+bool DmaBufferPool::Acquire(const DmaHeap &dma_heap, const char *name, std::size_t size, Buffer &buffer)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	Entry *best_fit = nullptr;
+	for (Entry &entry : entries_)
+	{
+		if (!entry.in_use && entry.buffer.size >= size && (!best_fit || entry.buffer.size < best_fit->buffer.size))
+			best_fit = &entry;
+	}
+
+	if (best_fit)
+	{
+		best_fit->in_use = true;
+		buffer = best_fit->buffer;
+		reuses_++;
+		return true;
+	}
+
+	libcamera::UniqueFD fd = dma_heap.alloc(name, size);
+	if (!fd.isValid())
+		return false;
+
+	void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+	if (memory == MAP_FAILED)
+	{
+		LOG_ERROR("failed to mmap dma buffer " << name);
+		return false;
+	}
+
+	Entry entry;
+	entry.buffer.fd = libcamera::SharedFD(std::move(fd));
+	entry.buffer.size = size;
+	entry.buffer.memory = static_cast<uint8_t *>(memory);
+	entry.in_use = true;
+	entries_.push_back(entry);
+	allocations_++;
+
+	buffer = entry.buffer;
+	return true;
+}
+
+void DmaBufferPool::Release(const Buffer &buffer)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (Entry &entry : entries_)
+	{
+		if (entry.buffer.memory == buffer.memory)
+		{
+			entry.in_use = false;
+			return;
+		}
+	}
+
+	LOG_ERROR("DmaBufferPool::Release called for a buffer that is not in the pool");
+}
+
+DmaBufferPool::Stats DmaBufferPool::GetStats()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	Stats stats;
+	stats.allocations = allocations_;
+	stats.reuses = reuses_;
+	stats.buffers = entries_.size();
+	for (const Entry &entry : entries_)
+	{
+		stats.bytes += entry.buffer.size;
+		if (entry.in_use)
+			stats.buffers_in_use++;
+	}
+
+	return stats;
+}
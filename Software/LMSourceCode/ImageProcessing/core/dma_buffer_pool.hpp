@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ *
+ * dma_buffer_pool.hpp - Keeps capture buffers allocated across camera reconfigurations.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <stddef.h>
+#include <vector>
+
+#include <libcamera/base/shared_fd.h>
+
+#include "core/dma_heaps.hpp"
+
+// Switching between, e.g., full-screen stills and cropped high-fps video used to free
+// every capture buffer and allocate (and mmap) a new set.  Instead, buffers are returned
+// to this process-wide pool when an RPiCamApp tears down, and are handed out again to
+// any stream (of either camera) whose frames fit in them.
+class DmaBufferPool
+{
+public:
+	struct Buffer
+	{
+		libcamera::SharedFD fd;
+		std::size_t size = 0;
+		uint8_t *memory = nullptr;
+	};
+
+	struct Stats
+	{
+		unsigned int allocations = 0;
+		unsigned int reuses = 0;
+		unsigned int buffers = 0;
+		unsigned int buffers_in_use = 0;
+		std::size_t bytes = 0;
+	};
+
+	// Returns the smallest free buffer of at least size bytes, or allocates and maps a
+	// new one if none fits.  Returns false if the allocation fails.
+	static bool Acquire(const DmaHeap &dma_heap, const char *name, std::size_t size, Buffer &buffer);
+
+	// Makes the buffer available again.  It stays allocated and mapped.
+	static void Release(const Buffer &buffer);
+
+	static Stats GetStats();
+
+private:
+	struct Entry
+	{
+		Buffer buffer;
+		bool in_use = false;
+	};
+
+	static std::mutex mutex_;
+	static std::vector<Entry> entries_;
+	static unsigned int allocations_;
+	static unsigned int reuses_;
+};
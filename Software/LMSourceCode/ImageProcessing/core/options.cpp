@@ -12,8 +12,10 @@
 #include <linux/v4l2-controls.h>
 #include <linux/videodev2.h>
 #include <map>
+#include <mutex>
 #include <string>
 #include <sys/ioctl.h>
+#include <typeinfo>
 
 #include <libcamera/formats.h>
 #include <libcamera/logging.h>
@@ -359,6 +361,34 @@ bool Options::Parse(int argc, char *argv[])
 	return v_->Parse(vm, app_);
 }
 
+bool Options::ParseOnce(int argc, char *argv[])
+{
+	// VideoOptions and StillOptions parse different things from the same command line
+	std::string key = typeid(*this).name();
+	for (int i = 0; i < argc; i++)
+		key += std::string(" ") + argv[i];
+
+	static std::mutex parsed_mutex;
+	static std::map<std::string, OptsInternal> parsed_options;
+
+	// Held through the first Parse too, as it changes process-wide state (logging, environment)
+	std::lock_guard<std::mutex> lock(parsed_mutex);
+
+	auto it = parsed_options.find(key);
+	if (it != parsed_options.end())
+	{
+		// Assigned in place, as options_ points at v_'s members
+		*v_ = it->second;
+		return true;
+	}
+
+	if (!Parse(argc, argv))
+		return false;
+
+	parsed_options.emplace(key, *v_);
+	return true;
+}
+
 bool OptsInternal::Parse(boost::program_options::variables_map &vm, RPiCamApp *app)
 {
 	using namespace libcamera;
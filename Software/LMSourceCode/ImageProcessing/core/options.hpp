@@ -330,6 +330,12 @@ struct Options
 	virtual bool Parse(int argc, char *argv[]);
 	virtual void Print() const { v_->Print(); }
 
+	// As Parse, but the command line is only parsed (and checked) the first time that an Options
+	// of this type sees it. Later calls just copy that result, which also skips Parse's
+	// camera enumeration and sensor HDR control set-up. Use it for command lines that never
+	// change, such as the dummy ones used to make each app of a shot. Failed parses are not kept.
+	bool ParseOnce(int argc, char *argv[]);
+
 	const OptsInternal &Get() const { return *v_.get(); }
 	OptsInternal &Set() const { return *v_.get(); }
 
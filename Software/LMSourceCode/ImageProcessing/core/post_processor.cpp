@@ -5,6 +5,7 @@
  * post_processor.cpp - Post processor implementation.
  */
 
+#include <algorithm>
 #include <dlfcn.h>
 #include <filesystem>
 #include <iostream>
@@ -26,7 +27,7 @@
 
 namespace fs = std::filesystem;
 
-PostProcessor::PostProcessor(RPiCamApp *app) : app_(app)
+PostProcessor::PostProcessor(RPiCamApp *app) : app_(app), quit_(false), quit_workers_(false)
 {
 }
 
@@ -68,6 +69,8 @@ void PostProcessor::Read(std::string const &filename)
 {
 	boost::property_tree::ptree root;
 	boost::property_tree::read_json(filename, root);
+	// An app that is opened more than once (e.g., the camera 1 watcher) reads its stages again
+	stages_.clear();
 	for (auto const &key_and_value : root)
 	{
 		if (key_and_value.first == "rpicam-apps")
@@ -148,8 +151,19 @@ void PostProcessor::Configure()
 void PostProcessor::Start()
 {
 	quit_ = false;
+	quit_workers_ = false;
 	output_thread_ = std::thread(&PostProcessor::outputThread, this);
 
+	// Each request goes through the whole stage chain on one worker, so more workers than cores would only
+	// add contention.
+	if (!stages_.empty())
+	{
+		unsigned int num_workers = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned int i = 0; i < num_workers; i++)
+			workers_.emplace_back(&PostProcessor::workerThread, this);
+		LOG(2, "Post processing with " << num_workers << " worker threads");
+	}
+
 	for (auto &stage : stages_)
 	{
 		stage->Start();
@@ -164,28 +178,50 @@ void PostProcessor::Process(CompletedRequestPtr &request)
 		return;
 	}
 
-	std::unique_lock<std::mutex> l(mutex_);
-	requests_.push(std::move(request)); // caller has given us ownership of this reference
+	// The jobs_ queue ensures we have correct ordering in the output thread, whichever worker finishes first.
+	{
+		std::unique_lock<std::mutex> l(mutex_);
+		jobs_.emplace_back();
+		jobs_.back().request = std::move(request); // caller has given us ownership of this reference
+		pending_jobs_.push(&jobs_.back());
+	}
+	work_cv_.notify_one();
+}
+
+void PostProcessor::workerThread()
+{
+	while (true)
+	{
+		Job *job;
+		{
+			std::unique_lock<std::mutex> l(mutex_);
+
+			work_cv_.wait(l, [this] { return quit_workers_ || !pending_jobs_.empty(); });
+
+			if (pending_jobs_.empty())
+				break;
+
+			job = pending_jobs_.front();
+			pending_jobs_.pop();
+		}
 
-	std::promise<bool> promise;
-	auto process_fn = [this](CompletedRequestPtr &request, std::promise<bool> promise) {
 		bool drop_request = false;
 		for (auto &stage : stages_)
 		{
-			if (stage->Process(request))
+			if (stage->Process(job->request))
 			{
 				drop_request = true;
 				break;
 			}
 		}
-		promise.set_value(drop_request);
-		cv_.notify_one();
-	};
 
-	// Queue the futures to ensure we have correct ordering in the output thread. The promise/future return value
-	// tells us when all the streams for this request have been processed and output_ready_callback_ can be called.
-	futures_.push(promise.get_future());
-	std::thread { process_fn, std::ref(requests_.back()), std::move(promise) }.detach();
+		{
+			std::unique_lock<std::mutex> l(mutex_);
+			job->drop_request = drop_request;
+			job->done = true;
+		}
+		cv_.notify_one();
+	}
 }
 
 void PostProcessor::outputThread()
@@ -198,19 +234,15 @@ void PostProcessor::outputThread()
 		{
 			std::unique_lock<std::mutex> l(mutex_);
 
-			cv_.wait(l, [this] {
-				return (quit_ && futures_.empty()) ||
-					   (!futures_.empty() && futures_.front().wait_for(0s) == std::future_status::ready);
-			});
+			cv_.wait(l, [this] { return (quit_ && jobs_.empty()) || (!jobs_.empty() && jobs_.front().done); });
 
-			// Only quit when the futures_ queue is empty.
-			if (quit_ && futures_.empty())
+			// Only quit when the jobs_ queue is empty.
+			if (quit_ && jobs_.empty())
 				break;
 
-			drop_request = futures_.front().get();
-			futures_.pop();
-			request = std::move(requests_.front()); // reuse as it's being dropped from the queue
-			requests_.pop();
+			drop_request = jobs_.front().drop_request;
+			request = std::move(jobs_.front().request); // reuse as it's being dropped from the queue
+			jobs_.pop_front();
 		}
 
 		if (!drop_request)
@@ -232,6 +264,17 @@ void PostProcessor::Stop()
 	}
 
 	output_thread_.join();
+
+	// The output thread only finishes once every job is done, so no worker is still busy.
+	{
+		std::unique_lock<std::mutex> l(mutex_);
+		quit_workers_ = true;
+	}
+	work_cv_.notify_all();
+
+	for (auto &worker : workers_)
+		worker.join();
+	workers_.clear();
 }
 
 void PostProcessor::Teardown()
@@ -9,9 +9,12 @@
 
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <future>
 #include <mutex>
 #include <queue>
+#include <thread>
+#include <vector>
 
 #include "core/completed_request.hpp"
 #include "core/dl_lib.hpp"
@@ -62,12 +65,27 @@ private:
 	std::vector<StagePtr> stages_;
 	std::vector<DlLib> dynamic_stages_;
 	void outputThread();
-
-	std::queue<CompletedRequestPtr> requests_;
-	std::queue<std::future<bool>> futures_;
+	void workerThread();
+
+	// One request going through the stages. Jobs are only ever added at the back and removed from the front of
+	// jobs_, so the workers' pointers to them stay valid.
+	struct Job
+	{
+		CompletedRequestPtr request;
+		bool done = false;
+		bool drop_request = false;
+	};
+
+	// In arrival order, which is the order in which the output thread hands them on.
+	std::deque<Job> jobs_;
+	// The jobs that no worker has taken yet.
+	std::queue<Job *> pending_jobs_;
+	std::vector<std::thread> workers_;
 	std::thread output_thread_;
 	bool quit_;
+	bool quit_workers_;
 	PostProcessorCallback callback_;
 	std::mutex mutex_;
 	std::condition_variable cv_;
+	std::condition_variable work_cv_;
 };
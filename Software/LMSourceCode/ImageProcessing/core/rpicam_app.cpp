@@ -29,7 +29,6 @@
 unsigned int RPiCamApp::verbosity = 1;
 std::mutex RPiCamApp::cm_mutex_;
 std::weak_ptr<RPiCamApp::CameraManager> RPiCamApp::shared_cm_;
-std::recursive_mutex RPiCamApp::pipeline_mutex_;
 
 static libcamera::PixelFormat mode_to_pixel_format(Mode const &mode)
 {
@@ -164,21 +163,27 @@ void RPiCamApp::OpenCamera()
 	if (!camera_manager_)
 		initCameraManager();
 
-	std::vector<std::shared_ptr<libcamera::Camera>> cameras = GetCameras();
-	if (cameras.size() == 0)
-		throw std::runtime_error("no cameras available");
+	std::string cam_id;
+	{
+		// The other camera may be opening or closing at the same time
+		std::lock_guard<std::mutex> cm_lock(cm_mutex_);
+
+		std::vector<std::shared_ptr<libcamera::Camera>> cameras = GetCameras();
+		if (cameras.size() == 0)
+			throw std::runtime_error("no cameras available");
 
-	if (options_->Get().camera >= cameras.size())
-		throw std::runtime_error("selected camera is not available");
+		if (options_->Get().camera >= cameras.size())
+			throw std::runtime_error("selected camera is not available");
 
-	std::string const &cam_id = cameras[options_->Get().camera]->id();
-	camera_ = camera_manager_->get(cam_id);
-	if (!camera_)
-		throw std::runtime_error("failed to find camera " + cam_id);
+		cam_id = cameras[options_->Get().camera]->id();
+		camera_ = camera_manager_->get(cam_id);
+		if (!camera_)
+			throw std::runtime_error("failed to find camera " + cam_id);
 
-	if (camera_->acquire())
-		throw std::runtime_error("failed to acquire camera " + cam_id);
-	camera_acquired_ = true;
+		if (camera_->acquire())
+			throw std::runtime_error("failed to acquire camera " + cam_id);
+		camera_acquired_ = true;
+	}
 
 	LOG(2, "Acquired camera " << cam_id);
 
@@ -191,6 +196,14 @@ void RPiCamApp::OpenCamera()
 	post_processor_.SetCallback(
 		[this](CompletedRequestPtr &r) { this->msg_queue_.Post(Msg(MsgType::RequestComplete, std::move(r))); });
 
+	if (keep_sensor_modes_ && !sensor_modes_.empty())
+	{
+		LOG(2, "Re-using " << sensor_modes_.size() << " sensor modes");
+		return;
+	}
+
+	sensor_modes_.clear();
+
 	// We're going to make a list of all the available sensor modes, but we only populate
 	// the framerate field if the user has requested a framerate (as this requires us actually
 	// to configure the sensor, which is otherwise best avoided).
@@ -241,13 +254,19 @@ void RPiCamApp::CloseCamera()
 
 	preview_.reset();
 
-	if (camera_acquired_)
-		camera_->release();
-	camera_acquired_ = false;
+	{
+		// If this is the last reference, the CameraManager is destroyed here, and the
+		// other camera must not be creating a new one (or looking a camera up) meanwhile
+		std::lock_guard<std::mutex> cm_lock(cm_mutex_);
 
-	camera_.reset();
+		if (camera_acquired_)
+			camera_->release();
+		camera_acquired_ = false;
 
-	camera_manager_.reset();
+		camera_.reset();
+
+		camera_manager_.reset();
+	}
 
 	if (!options_->Get().help)
 		LOG(2, "Camera closed");
@@ -658,13 +677,10 @@ void RPiCamApp::Teardown()
 	if (!options_->Get().help)
 		LOG(2, "Tearing down requests, buffers and configuration");
 
-	for (auto &iter : mapped_buffers_)
-	{
-		// assert(iter.first->planes().size() == iter.second.size());
-		// for (unsigned i = 0; i < iter.first->planes().size(); i++)
-		for (auto &span : iter.second)
-			munmap(span.data(), span.size());
-	}
+	// The buffers stay allocated and mapped in the pool for the next configuration
+	for (auto &buffer : pooled_buffers_)
+		DmaBufferPool::Release(buffer);
+	pooled_buffers_.clear();
 	mapped_buffers_.clear();
 
 	configuration_.reset();
@@ -885,6 +901,11 @@ void RPiCamApp::StopCamera()
 
 	msg_queue_.Clear();
 
+	{
+		std::lock_guard<std::mutex> lock(cancelled_requests_mutex_);
+		cancelled_requests_.clear();
+	}
+
 	requests_.clear();
 
 	controls_.clear(); // no need for mutex here
@@ -898,6 +919,52 @@ RPiCamApp::Msg RPiCamApp::Wait()
 	return msg_queue_.Wait();
 }
 
+std::optional<RPiCamApp::Msg> RPiCamApp::Wait(std::chrono::milliseconds timeout)
+{
+	return msg_queue_.Wait(timeout);
+}
+
+size_t RPiCamApp::PendingMessages()
+{
+	return msg_queue_.Size();
+}
+
+bool RPiCamApp::RequeueCancelledRequests()
+{
+	// As for queueRequest, the camera must not stop while the requests go back
+	std::lock_guard<std::mutex> stop_lock(camera_stop_mutex_);
+
+	std::vector<Request *> requests;
+	{
+		std::lock_guard<std::mutex> lock(cancelled_requests_mutex_);
+		requests.swap(cancelled_requests_);
+	}
+
+	if (!camera_started_ || requests.empty())
+		return false;
+
+	for (Request *request : requests)
+	{
+		// A cancelled request still has its buffers, as it never became a CompletedRequest
+		request->reuse(Request::ReuseBuffers);
+
+		{
+			std::lock_guard<std::mutex> lock(control_mutex_);
+			request->controls().merge(controls_, ControlList::MergePolicy::OverwriteExisting);
+			controls_.clear();
+		}
+
+		if (camera_->queueRequest(request) < 0)
+		{
+			LOG_ERROR("failed to re-queue cancelled request");
+			return false;
+		}
+	}
+
+	LOG(2, "Re-queued " << requests.size() << " cancelled requests");
+	return true;
+}
+
 void RPiCamApp::queueRequest(CompletedRequest *completed_request)
 {
 	BufferMap buffers(std::move(completed_request->buffers));
@@ -965,6 +1032,11 @@ void RPiCamApp::PostQuit()
 	msg_queue_.Post(Msg(MsgType::Quit));
 }
 
+void RPiCamApp::ClearMessages()
+{
+	msg_queue_.Clear();
+}
+
 libcamera::Stream *RPiCamApp::GetStream(std::string const &name, StreamInfo *info) const
 {
 	auto it = streams_.find(name);
@@ -1072,6 +1144,13 @@ void RPiCamApp::setupCapture()
 	for (auto const &[id, info] : camera_->controls())
 		LOG(2, "    " << id->name() << " : " << info.toString());
 
+	// A reconfiguration without a Teardown() (e.g., after a device timeout) replaces the old buffers
+	for (auto &buffer : pooled_buffers_)
+		DmaBufferPool::Release(buffer);
+	pooled_buffers_.clear();
+	mapped_buffers_.clear();
+	frame_buffers_.clear();
+
 	// Next allocate all the buffers we need, mmap them and store them on a free list.
 
 	for (StreamConfiguration &config : *configuration_)
@@ -1082,25 +1161,29 @@ void RPiCamApp::setupCapture()
 		for (unsigned int i = 0; i < config.bufferCount; i++)
 		{
 			std::string name("rpicam-apps" + std::to_string(i));
-			libcamera::UniqueFD fd = dma_heap_.alloc(name.c_str(), config.frameSize);
+			DmaBufferPool::Buffer buffer;
 
-			if (!fd.isValid())
+			if (!DmaBufferPool::Acquire(dma_heap_, name.c_str(), config.frameSize, buffer))
 				throw std::runtime_error("failed to allocate capture buffers for stream");
 
+			pooled_buffers_.push_back(buffer);
+
+			// A pooled buffer may be larger than this stream's frames
 			std::vector<FrameBuffer::Plane> plane(1);
-			plane[0].fd = libcamera::SharedFD(std::move(fd));
+			plane[0].fd = buffer.fd;
 			plane[0].offset = 0;
 			plane[0].length = config.frameSize;
 
 			fb.push_back(std::make_unique<FrameBuffer>(plane));
-			void *memory = mmap(NULL, config.frameSize, PROT_READ | PROT_WRITE, MAP_SHARED, plane[0].fd.get(), 0);
-			mapped_buffers_[fb.back().get()].push_back(
-						libcamera::Span<uint8_t>(static_cast<uint8_t *>(memory), config.frameSize));
+			mapped_buffers_[fb.back().get()].push_back(libcamera::Span<uint8_t>(buffer.memory, config.frameSize));
 		}
 
 		frame_buffers_[stream] = std::move(fb);
 	}
-	LOG(2, "Buffers allocated and mapped");
+
+	const DmaBufferPool::Stats pool_stats = DmaBufferPool::GetStats();
+	LOG(2, "Buffers allocated and mapped (pool: " << pool_stats.allocations << " allocations, " << pool_stats.reuses
+			<< " reuses, " << pool_stats.buffers << " buffers, " << pool_stats.bytes << " bytes)");
 
 	startPreview();
 
@@ -1151,9 +1234,21 @@ void RPiCamApp::requestComplete(Request *request)
 	if (request->status() == Request::RequestCancelled)
 	{
 		// If the request is cancelled while the camera is still running, it indicates
-		// a hardware timeout. Let the application handle this error.
+		// a hardware timeout. Let the application handle this error.  The request is kept
+		// so that it can be re-queued, and a timeout cancels all of the queued requests at
+		// once, so only the first of them is reported.
 		if (camera_started_)
-			msg_queue_.Post(Msg(MsgType::Timeout));
+		{
+			bool first_cancelled;
+			{
+				std::lock_guard<std::mutex> lock(cancelled_requests_mutex_);
+				first_cancelled = cancelled_requests_.empty();
+				cancelled_requests_.push_back(request);
+			}
+
+			if (first_cancelled)
+				msg_queue_.Post(Msg(MsgType::Timeout));
+		}
 
 		return;
 	}
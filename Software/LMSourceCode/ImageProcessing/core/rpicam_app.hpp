@@ -9,10 +9,12 @@
 
 #include <sys/mman.h>
 
+#include <chrono>
 #include <condition_variable>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <set>
 #include <sstream>
@@ -32,6 +34,7 @@
 
 #include "core/buffer_sync.hpp"
 #include "core/completed_request.hpp"
+#include "core/dma_buffer_pool.hpp"
 #include "core/dma_heaps.hpp"
 #include "core/post_processor.hpp"
 #include "core/stream_info.hpp"
@@ -40,6 +43,11 @@ struct Options;
 class Preview;
 struct Mode;
 
+namespace golf_sim
+{
+class GsWatcherStageChain;
+}
+
 namespace controls = libcamera::controls;
 namespace properties = libcamera::properties;
 
@@ -134,6 +142,12 @@ public:
 	std::string CameraModel() const;
 	void OpenCamera();
 	void CloseCamera();
+	// For an app that is re-opened over and over with the same sensor set up (e.g., the
+	// camera 1 watcher), OpenCamera can re-use the sensor modes that it found the last
+	// time instead of configuring the sensor in each mode again.  ForgetSensorModes must
+	// be called if the sensor (e.g., its crop) has changed.
+	void KeepSensorModes(bool keep) { keep_sensor_modes_ = keep; }
+	void ForgetSensorModes() { sensor_modes_.clear(); }
 
         // JPMOD - Now allowing flags to be sent to the viewfinder
         void ConfigureViewfinder(unsigned int flags = FLAG_STILL_NONE);
@@ -146,8 +160,18 @@ public:
 	void StopCamera();
 
 	Msg Wait();
+	// As Wait(), but gives up (and returns nothing) if no message comes within the timeout
+	std::optional<Msg> Wait(std::chrono::milliseconds timeout);
+	// The number of messages that have not been read yet
+	size_t PendingMessages();
+	// Queues the requests that a device timeout cancelled back to the running camera,
+	// which is cheaper than re-starting it.  Returns false if there were none, or the
+	// camera would not take them back.
+	bool RequeueCancelledRequests();
 	void PostMessage(MsgType &t, MsgPayload &p);
 	void PostQuit();
+	// Drops any messages that have not been read yet, which returns their requests to the camera
+	void ClearMessages();
 
 	Stream *GetStream(std::string const &name, StreamInfo *info = nullptr) const;
 	Stream *ViewfinderStream(StreamInfo *info = nullptr) const;
@@ -188,6 +212,7 @@ public:
 
 	friend class BufferWriteSync;
 	friend class BufferReadSync;
+	friend class golf_sim::GsWatcherStageChain;
 	friend class PostProcessor;
 	friend struct OptsInternal;
 
@@ -214,6 +239,20 @@ private:
 			queue_.pop();
 			return msg;
 		}
+		std::optional<T> Wait(std::chrono::milliseconds timeout)
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			if (!cond_.wait_for(lock, timeout, [this] { return !queue_.empty(); }))
+				return std::nullopt;
+			T msg = std::move(queue_.front());
+			queue_.pop();
+			return msg;
+		}
+		size_t Size()
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			return queue_.size();
+		}
 		void Clear()
 		{
 			std::unique_lock<std::mutex> lock(mutex_);
@@ -255,12 +294,20 @@ private:
 	// libcamera enforces a single CameraManager per process.  In single-process
 	// mode both camera RPiCamApp instances share one via weak_ptr/shared_ptr;
 	// the last instance to CloseCamera() destroys it.
+	// cm_mutex_ guards the manager's creation and destruction, and the camera
+	// look-up and acquire that go through it.
 	static std::mutex cm_mutex_;
 	static std::weak_ptr<CameraManager> shared_cm_;
-	// libcamera's pipeline handler is not thread-safe for concurrent camera
-	// operations (acquire, configure, start, stop).  This mutex serializes
-	// all pipeline-state-changing calls across every RPiCamApp instance.
-	static std::recursive_mutex pipeline_mutex_;
+	// Serializes this instance's pipeline-state-changing calls (open, configure,
+	// start, stop, teardown, close).  libcamera itself serializes the calls that
+	// reach the pipeline handler, so each camera has its own lock, and
+	// reconfiguring one camera never waits for the other.
+	// Lock hierarchy, outermost first:
+	//   1. pipeline_mutex_ - at most one instance's at a time.  Never take the
+	//      other camera's while holding this one.
+	//   2. cm_mutex_ - only briefly, and never held while taking a pipeline_mutex_.
+	//   3. Leaf locks, e.g., DmaBufferPool's and the message queue's.
+	std::recursive_mutex pipeline_mutex_;
 	std::shared_ptr<CameraManager> camera_manager_;
 	std::shared_ptr<Camera> camera_;
 	bool camera_acquired_ = false;
@@ -269,13 +316,19 @@ private:
 	std::map<std::string, Stream *> streams_;
 	DmaHeap dma_heap_;
 	std::map<Stream *, std::vector<std::unique_ptr<FrameBuffer>>> frame_buffers_;
+	// The DmaBufferPool buffers behind frame_buffers_, given back in Teardown()
+	std::vector<DmaBufferPool::Buffer> pooled_buffers_;
 	std::vector<std::unique_ptr<Request>> requests_;
 	std::mutex completed_requests_mutex_;
 	std::set<CompletedRequest *> completed_requests_;
 	bool camera_started_ = false;
 	std::mutex camera_stop_mutex_;
+	// The requests that were cancelled while the camera was running, for RequeueCancelledRequests
+	std::mutex cancelled_requests_mutex_;
+	std::vector<Request *> cancelled_requests_;
 	MessageQueue<Msg> msg_queue_;
 	std::vector<SensorMode> sensor_modes_;
+	bool keep_sensor_modes_ = false;
 	// Related to the preview window.
 	std::unique_ptr<Preview> preview_;
 	std::map<int, CompletedRequestPtr> preview_completed_requests_;
@@ -101,9 +101,6 @@ namespace golf_sim {
         BOOST_LOG_FUNCTION();
 
         int r = (int)CircleRadius(circle);
-        cv::Vec2i xy = CircleXY(circle);
-        int x = xy[0];
-        int y = xy[1];
 
         if (r == 0) {
             GS_LOG_MSG(error, "CvUtils::GetBallColorRgb called with circle of 0 radius.");
@@ -111,17 +108,9 @@ namespace golf_sim {
             return empty;
         }
 
-        const double BOUNDED_BOX_RADIUS_RATIO = ((2.0*r) * 0.707) / 2.0;   // 1.6 (which is almost the whole ball may be resulting in too much averaging)
-        int xmin = std::max(0, (int)round(x - BOUNDED_BOX_RADIUS_RATIO));
-        int xmax = std::min(CvWidth(img), (int)round(x + BOUNDED_BOX_RADIUS_RATIO));    // Somehow, the box otherwise seems too far to the left?
-        int ymin = std::max(0, (int)round(y - BOUNDED_BOX_RADIUS_RATIO));    // Round up to focus more on the better-lit top of the ball
-        int ymax = std::min(CvHeight(img), (int)round(y + BOUNDED_BOX_RADIUS_RATIO));
-
-        // GS_LOG_TRACE_MSG(trace, "GetBall_color: xmin,max, ymin,max = (" + std::to_string(xmin) + "," + std::to_string(xmax) + ") : (" + std::to_string(ymin) + "," + std::to_string(ymax) + ")");
-
         // LoggingTools::ShowRectangleOnImage("getBallColor area to average: ", img, cv::Point(xmin, ymin), cv::Point(xmax, ymax));
 
-        cv::Mat subImg = img(cv::Range(ymin, ymax), cv::Range(xmin, xmax));
+        cv::Mat subImg = img(GetBallColorRect(img, circle));
 
         cv::Scalar avg_color, std_color;
         cv::meanStdDev(subImg, avg_color, std_color);
@@ -142,13 +131,30 @@ namespace golf_sim {
         return results;  
     }
 
+    cv::Rect CvUtils::GetBallColorRect(const cv::Mat& img, const GsCircle& circle) {
+
+        int r = (int)CircleRadius(circle);
+        cv::Vec2i xy = CircleXY(circle);
+        int x = xy[0];
+        int y = xy[1];
+
+        const double BOUNDED_BOX_RADIUS_RATIO = ((2.0*r) * 0.707) / 2.0;   // 1.6 (which is almost the whole ball may be resulting in too much averaging)
+        int xmin = std::max(0, (int)round(x - BOUNDED_BOX_RADIUS_RATIO));
+        int xmax = std::min(CvWidth(img), (int)round(x + BOUNDED_BOX_RADIUS_RATIO));    // Somehow, the box otherwise seems too far to the left?
+        int ymin = std::max(0, (int)round(y - BOUNDED_BOX_RADIUS_RATIO));    // Round up to focus more on the better-lit top of the ball
+        int ymax = std::min(CvHeight(img), (int)round(y + BOUNDED_BOX_RADIUS_RATIO));
+
+        // GS_LOG_TRACE_MSG(trace, "GetBall_color: xmin,max, ymin,max = (" + std::to_string(xmin) + "," + std::to_string(xmax) + ") : (" + std::to_string(ymin) + "," + std::to_string(ymax) + ")");
+
+        return cv::Rect(cv::Point(xmin, ymin), cv::Point(xmax, ymax));
+    }
+
     cv::Mat CvUtils::GetAreaMaskImage(int resolution_x_, int resolution_y_, int expected_ball_X, int expected_ball_Y, int mask_radius, cv::Rect& mask_dimensions, bool use_square)
     {
         BOOST_LOG_FUNCTION();
 
-        cv::Mat initialAreaMaskImage = cv::Mat::zeros(resolution_y_, resolution_x_, CV_8UC3);
-        cv::Mat maskImage;
-        cv::cvtColor(initialAreaMaskImage, maskImage, cv::COLOR_BGR2HSV);
+        // (Black is black in HSV, too, so there is no need to convert the blank image)
+        cv::Mat maskImage = cv::Mat::zeros(resolution_y_, resolution_x_, CV_8UC3);
 
         // A white circle on a black background will act as our mask
 
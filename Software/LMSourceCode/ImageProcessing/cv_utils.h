@@ -66,6 +66,9 @@ struct CvUtils
     // The ball color will be an average of the colors near the middle of the input ball
     // The returned color is in RGB form
     static std::vector<GsColorTriplet> GetBallColorRgb(const cv::Mat &img, const GsCircle &circle);
+
+    // The (clipped) square in the middle of the ball that GetBallColorRgb averages over
+    static cv::Rect GetBallColorRect(const cv::Mat& img, const GsCircle& circle);
     
     static cv::Mat GetAreaMaskImage(int resolution_x_, int resolution_y_, int expected_ball_X, int expected_ball_Y, int mask_radius, cv::Rect &mask_dimensions, bool use_square = false);
 
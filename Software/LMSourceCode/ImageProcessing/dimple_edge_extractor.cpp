@@ -0,0 +1,122 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include "dimple_edge_extractor.hpp"
+#include "logging_tools.h"
+#include "gs_metrics.h"
+
+#include <chrono>
+#include <filesystem>
+
+namespace golf_sim {
+
+DimpleEdgeExtractor::DimpleEdgeExtractor(const Config& config)
+    : config_(config) {
+}
+
+DimpleEdgeExtractor::~DimpleEdgeExtractor() {
+#ifdef HAS_NCNN
+    net_.clear();
+#endif
+}
+
+bool DimpleEdgeExtractor::Initialize() {
+#ifndef HAS_NCNN
+    GS_LOG_MSG(error, "DimpleEdgeExtractor: NCNN not available (compiled without HAS_NCNN)");
+    return false;
+#else
+    if (!std::filesystem::exists(config_.param_path)) {
+        GS_LOG_MSG(error, "DimpleEdgeExtractor: param file not found: " + config_.param_path);
+        return false;
+    }
+    if (!std::filesystem::exists(config_.bin_path)) {
+        GS_LOG_MSG(error, "DimpleEdgeExtractor: bin file not found: " + config_.bin_path);
+        return false;
+    }
+
+    NcnnRuntime::ConfigureNet(net_, workspace_, config_.num_threads);
+    net_.opt.use_fp16_packed = config_.use_fp16_packing;
+    net_.opt.use_fp16_storage = config_.use_fp16_packing;
+    net_.opt.use_fp16_arithmetic = true;
+    net_.opt.use_packing_layout = true;
+    NcnnRuntime::ConfigureVulkan(net_, config_.use_vulkan_compute);
+
+    if (net_.load_param(config_.param_path.c_str()) != 0) {
+        GS_LOG_MSG(error, "DimpleEdgeExtractor: failed to load param: " + config_.param_path);
+        return false;
+    }
+    if (net_.load_model(config_.bin_path.c_str()) != 0) {
+        GS_LOG_MSG(error, "DimpleEdgeExtractor: failed to load model: " + config_.bin_path);
+        return false;
+    }
+
+    initialized_ = true;
+    GS_LOG_MSG(info, "DimpleEdgeExtractor initialized (" +
+               std::string(net_.opt.use_vulkan_compute ? "Vulkan GPU" : std::to_string(net_.opt.num_threads) + " threads") + ", input=" + std::to_string(config_.input_size) + "px)");
+
+    cv::Mat dummy = cv::Mat::zeros(config_.input_size, config_.input_size, CV_8UC1);
+    cv::Mat dummy_edges;
+    for (int i = 0; i < 3; i++) {
+        Extract(dummy, dummy_edges);
+    }
+    GS_LOG_MSG(info, "DimpleEdgeExtractor warmup complete (3 iterations)");
+
+    return true;
+#endif
+}
+
+bool DimpleEdgeExtractor::Extract(const cv::Mat& ball_gray, cv::Mat& dimple_edges) {
+
+#ifndef HAS_NCNN
+    GS_LOG_MSG(error, "DimpleEdgeExtractor::Extract called without NCNN support");
+    return false;
+#else
+    if (!initialized_) {
+        GS_LOG_MSG(error, "DimpleEdgeExtractor::Extract called before Initialize()");
+        return false;
+    }
+
+    CV_Assert(ball_gray.type() == CV_8UC1 && !ball_gray.empty());
+
+    auto t_start = std::chrono::high_resolution_clock::now();
+
+    const int s = config_.input_size;
+
+    // Scaled as it is read in, rather than with a separate resize
+    ncnn::Mat in = ncnn::Mat::from_pixels_resize(ball_gray.data, ncnn::Mat::PIXEL_GRAY,
+                                                 ball_gray.cols, ball_gray.rows, (int)ball_gray.step[0], s, s);
+    const float norm_vals[1] = { 1.0f / 255.0f };
+    in.substract_mean_normalize(nullptr, norm_vals);
+
+    NcnnRuntime::PinInferenceThreads(net_.opt.num_threads);
+    ncnn::Extractor ex = net_.create_extractor();
+    if (ex.input("in0", in) != 0) {
+        GS_LOG_MSG(error, "DimpleEdgeExtractor: failed to set input blob");
+        return false;
+    }
+
+    ncnn::Mat out;
+    if (ex.extract("out0", out) != 0 || out.data == nullptr || out.w != s || out.h != s) {
+        GS_LOG_MSG(error, "DimpleEdgeExtractor: failed to extract output");
+        return false;
+    }
+
+    const cv::Mat probabilities(s, s, CV_32FC1, (void*)out.channel(0).data);
+    cv::Mat edges;
+    cv::threshold(probabilities, edges, config_.edge_threshold, 255.0, cv::THRESH_BINARY);
+    edges.convertTo(edges, CV_8UC1);
+
+    // Back to the patch's size, so that the ball's coordinates still apply
+    cv::resize(edges, dimple_edges, ball_gray.size(), 0, 0, cv::INTER_NEAREST);
+
+    auto t_end = std::chrono::high_resolution_clock::now();
+    GsMetrics::Observe(GsMetrics::Histogram::kDimpleEdgeExtractorInference,
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count());
+
+    return true;
+#endif
+}
+
+} // namespace golf_sim
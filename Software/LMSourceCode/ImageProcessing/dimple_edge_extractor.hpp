@@ -0,0 +1,58 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A small NCNN model that maps the isolated gray ball patch straight to its dimple-edge image,
+// in place of the 33-orientation Gabor filter bank (BallImageProc::ApplyGaborFilterToBall).
+// The model takes the patch, scaled to input_size x input_size and normalized to [0, 1], as
+// "in0" (1 channel), and returns the edge probability of each pixel as "out0" (1 channel, the
+// same size).  The result is the same binary (0 / 255) image that the Gabor filter returns, at
+// the patch's size, so the reflection and outside-the-ball masking that follow are unchanged.
+
+#pragma once
+
+#ifdef HAS_NCNN
+#include <ncnn/net.h>
+#include "ncnn_runtime.hpp"
+#endif
+
+#include <opencv2/opencv.hpp>
+#include <string>
+
+namespace golf_sim {
+
+class DimpleEdgeExtractor {
+public:
+    struct Config {
+        std::string param_path;
+        std::string bin_path;
+        int input_size = 128;
+        int num_threads = 3;
+        bool use_fp16_packing = true;
+        // Falls back to the CPU if there is no usable GPU
+        bool use_vulkan_compute = false;
+        // Pixels with more than this edge probability are edges
+        float edge_threshold = 0.5f;
+    };
+
+    explicit DimpleEdgeExtractor(const Config& config);
+    ~DimpleEdgeExtractor();
+
+    bool Initialize();
+    bool IsInitialized() const { return initialized_; }
+
+    // ball_gray is the isolated (CV_8UC1) ball patch.  Returns false if the model could not be run.
+    bool Extract(const cv::Mat& ball_gray, cv::Mat& dimple_edges);
+
+private:
+    Config config_;
+    bool initialized_ = false;
+
+#ifdef HAS_NCNN
+    NcnnRuntime::ModelWorkspace workspace_;
+    ncnn::Net net_;
+#endif
+};
+
+} // namespace golf_sim
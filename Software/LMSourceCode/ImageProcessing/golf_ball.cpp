@@ -15,26 +15,36 @@ namespace golf_sim {
 // that went into figuring out the HSV values.
 // Use the hsv_range_finder utility in this same directory
 // Calibrate this dynamically when a ball is placed in a known position
-// static const std::map< BallColor, BallColorRange> BallHSVRangeDict;
-static std::map< GolfBall::BallColor, BallColorRange> BallHSVRangeDict;
+// Indexed by GolfBall::BallColor.  A constant table (instead of a map that each GolfBall
+// re-built and cleared) so that balls can be made and destroyed on any thread.
+struct BallHSVRange {
+    unsigned char min[3];
+    unsigned char max[3];
+    unsigned char center[3];
+};
+
+static constexpr BallHSVRange BallHSVRangeDict[] = {
+    { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } },                  // kCalibrated - the ball's own ball_hsv_range_ is used instead
+    { { 30, 0, 100 }, { 170, 100, 255 }, { 90, 0, 255 } },      // kWhite
+    { { 0, 30, 80 }, { 35, 255, 255 }, { 5, 225, 222 } },       // kOrange - Very touchy, much higher Hmax and things fail
+    { { 20, 50, 70 }, { 70, 255, 255 }, { 12, 123, 210 } },     // kYellow
+    { { 10, 80, 130 }, { 35, 165, 255 }, { 20, 124, 208 } },    // kOpticGreen
+    { { 0, 0, 40 }, { 180, 255, 255 }, { 0, 0, 0 } },           // kUnknown
+    { { 0, 0, 40 }, { 180, 255, 255 }, { 0, 0, 0 } },           // kModelDetected
+};
+
+static_assert(sizeof(BallHSVRangeDict) / sizeof(BallHSVRangeDict[0]) == GolfBall::BallColor::kModelDetected + 1,
+              "BallHSVRangeDict needs an entry for each BallColor");
+
+static GsColorTriplet ToColorTriplet(const unsigned char (&hsv)[3]) {
+    return GsColorTriplet(hsv[0], hsv[1], hsv[2]);
+}
 
 double GolfBall::kBallRadiusMeters = 21.335e-3;
 
 
 void GolfBall::InitMembers()
 {
-    if (BallHSVRangeDict.size() == 0)
-    {
-        BallColorRange cr{ cv::Vec3b(30, 0, 100), cv::Vec3b(170, 100, 255), cv::Vec3b(90, 0, 255) };
-
-        BallHSVRangeDict[BallColor::kWhite] = BallColorRange(cv::Vec3b(30, 0, 100), cv::Vec3b(170, 100, 255), cv::Vec3b(90, 0, 255));
-        BallHSVRangeDict[BallColor::kOrange] = BallColorRange(cv::Vec3b(0, 30, 80), cv::Vec3b(35, 255, 255), cv::Vec3b(5, 225, 222));   // Very touchy, much higher Hmax and things fail
-        BallHSVRangeDict[BallColor::kYellow] = BallColorRange(cv::Vec3b(20, 50, 70), cv::Vec3b(70, 255, 255), cv::Vec3b(12, 123, 210));
-        BallHSVRangeDict[BallColor::kOpticGreen] = BallColorRange(cv::Vec3b(10, 80, 130), cv::Vec3b(35, 165, 255), cv::Vec3b(20, 124, 208));
-        BallHSVRangeDict[BallColor::kUnknown] = BallColorRange(cv::Vec3b(0, 0, 40), cv::Vec3b(180, 255, 255), cv::Vec3b(0, 0, 0));
-        BallHSVRangeDict[BallColor::kModelDetected] = BallColorRange(cv::Vec3b(0, 0, 40), cv::Vec3b(180, 255, 255), cv::Vec3b(0, 0, 0));
-    }
-
     // All zero's signifies thaht there is no average color set yet
     average_color_ = (0, 0, 0);
     median_color_ = (0, 0, 0);
@@ -48,21 +58,11 @@ void GolfBall::InitMembers()
     angles_camera_ortho_perspective_ = cv::Vec2f(0, 0);
 }
 
-void GolfBall::DeInitMembers()
-{
-    BallHSVRangeDict.clear();
-}
-
 GolfBall::GolfBall() 
 {
     InitMembers();
 }
 
-GolfBall::~GolfBall()
-{
-    DeInitMembers();
-}
-
 void GolfBall::set_circle(const GsCircle& c){ 
     ball_circle_ = c;  
     x_ = (int)std::round(c[0]);
@@ -86,7 +86,7 @@ GsColorTriplet GolfBall::GetBallLowerHSV(BallColor ball_color) const
     else
     {
         // Use the coarse ball-color settings based on the color
-        hsv = BallHSVRangeDict[ball_color].min;
+        hsv = ToColorTriplet(BallHSVRangeDict[ball_color].min);
     }
 
     // logging.debug("GetBallLowerHSV returning: " + str(hsv));
@@ -107,7 +107,7 @@ GsColorTriplet GolfBall::GetBallUpperHSV(BallColor ball_color) const
     else
     {
         // Use the coarse ball-color settings based on the color
-        hsv = BallHSVRangeDict[ball_color].max;
+        hsv = ToColorTriplet(BallHSVRangeDict[ball_color].max);
     }
 
     return hsv;
@@ -126,7 +126,7 @@ GsColorTriplet GolfBall::GetRGBCenterFromHSVRange() const {
     optimum perfect values in the golf ball object.
     */
 
-    GsColorTriplet hsvCenter = BallHSVRangeDict[ball_color_].center;
+    GsColorTriplet hsvCenter = ToColorTriplet(BallHSVRangeDict[ball_color_].center);
     GsColorTriplet rgb = CvUtils::ConvertHsvToRgb(hsvCenter);
 
     return rgb;
@@ -221,6 +221,15 @@ void GolfBall::PrintBallFlightResults() const {
     GS_LOG_TRACE_MSG(trace, "Calculated ball velocity (m/s)= " + std::to_string(ball.velocity_) + ", or " + std::to_string(ball.velocity_ * 2.237) + " mph.");
 
     GS_LOG_TRACE_MSG(trace, "Calculated ball spin (x,y,z) in RPM = " + std::to_string(ball.rotation_speeds_RPM_[0]) + ", " + std::to_string(ball.rotation_speeds_RPM_[1]) + ", " + std::to_string(ball.rotation_speeds_RPM_[2]) + ".");
+
+    if (ball.spin_pairs_used_ > 1) {
+        GS_LOG_TRACE_MSG(trace, "Spin is the median of " + std::to_string(ball.spin_pairs_used_) + " ball pairs, with a dispersion (x,y,z) in RPM of " +
+            std::to_string(ball.spin_dispersion_RPM_[0]) + ", " + std::to_string(ball.spin_dispersion_RPM_[1]) + ", " + std::to_string(ball.spin_dispersion_RPM_[2]) + ".");
+    }
+
+    if (ball.spin_search_truncated_) {
+        GS_LOG_TRACE_MSG(trace, "Spin is the best found within the spin search time budget.");
+    }
 }
 
 void GolfBall::AverageBalls(const std::vector<GolfBall>& ball_vector, GolfBall& averaged_ball, bool average_all_parameters) {
@@ -103,6 +103,16 @@ public:
 
     double distance_to_z_plane_from_lens_ = -1;       // Current distance in meters
 
+    // Set if the radius was refined to sub-pixel accuracy.  Near 1.0 if the whole edge of
+    // the ball was found and it was smooth, 0 if the radius was not refined.
+    double radius_confidence_ = 0.0;
+
+    // Set for a strobed ball found by a sequence-aware model (see BallImageProc::kModelHasSequenceOutputs),
+    // and otherwise -1.  How likely the ball's image is overlapped by another exposure (0 to 1), and
+    // which strobe exposure it is, counting from 0.
+    double model_overlap_score_ = -1.0;
+    double model_exposure_index_ = -1.0;
+
     // TBD - We've moved almost entirely away from using ball color for image-processing.
     // This stuff is deprecated.
     enum BallColor {
@@ -136,6 +146,13 @@ public:
     uint quality_ranking = 0;   // 0 is best.  Set by circle/ellipse detector if possible
 
     cv::Vec3d rotation_speeds_RPM_;
+    // If the spin is the consensus of several ball pairs, the median absolute deviation
+    // of the pairs' spins and the number of pairs.  Otherwise 0's.
+    cv::Vec3d spin_dispersion_RPM_;
+    int spin_pairs_used_ = 0;
+    // True if the spin search ran out of time (see BallImageProc::kSpinSearchTimeBudgetMs),
+    // so that the spin is the best found in the time rather than the best overall
+    bool spin_search_truncated_ = false;
     double velocity_ = 0; // In m/s
     long time_between_ball_positions_for_velocity_uS_ = 0;
     long time_between_angle_measures_for_rpm_uS_ = 0;
@@ -156,7 +173,6 @@ public:
     int search_area_radius_ = 0;
 
     GolfBall();
-    ~GolfBall();
 
     // Again, we're moving away from using the ball color for processing in most instances
     GsColorTriplet GetBallLowerHSV(BallColor ball_color) const;
@@ -190,9 +206,8 @@ private:
     long x_ = 0;                         // Position on screen.  In pixels in openCV coordinate system
     long y_ = 0;                         // In pixels in openCV coordinate system
 
-    // (De)Initialize any members -- called from (de)constructors.
+    // Initialize any members -- called from the constructor.
     void InitMembers();
-    void DeInitMembers();
 
 };
 
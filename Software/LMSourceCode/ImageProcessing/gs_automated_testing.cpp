@@ -13,7 +13,14 @@
 
 
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <thread>
 
 #include <boost/timer/timer.hpp>
 #include <boost/filesystem.hpp>
@@ -22,6 +29,10 @@
 
 #include "gs_config.h"
 #include "pulse_strobe.h"
+#include "gs_shot_trace.h"
+#include "gs_shot_archive.h"
+#include "gs_config_snapshot.h"
+#include "gs_shot_analysis.h"
 
 #include "gs_automated_testing.h"
 
@@ -194,7 +205,7 @@ std::vector<std::string> GsAutomatedTesting::get_files_by_wildcard(const std::st
 }
 
 
-bool GsAutomatedTesting::TestFinalShotResultData() {
+bool GsAutomatedTesting::FindFinalResultsTestImages(const std::string& test_suite_directory, std::vector<FinalResultsTestScenario>& tests) {
 
     std::string kWebServerLastTeedBallImageFilenamePrefix;
     std::string kWebServerCamera2ImageFilenamePrefix;
@@ -202,6 +213,40 @@ bool GsAutomatedTesting::TestFinalShotResultData() {
     GolfSimConfiguration::SetConstant("gs_config.user_interface.kWebServerLastTeedBallImage", kWebServerLastTeedBallImageFilenamePrefix);
     GolfSimConfiguration::SetConstant("gs_config.user_interface.kWebServerCamera2Image", kWebServerCamera2ImageFilenamePrefix);
 
+    // TBD - Centralize in a single place -- this is also in the LoggingTools implementation
+    const std::string kLogImagePrefix = "gs_log_img__";
+
+    // For each expected result, find the corresponding image files
+
+    for (FinalResultsTestScenario& r : tests) {
+
+        // Perform a wild-card search to find the right file.  It basically just needs to have a particular prefix and the shot number
+        std::string wildcarded_teed_ball_filename = kLogImagePrefix + kWebServerLastTeedBallImageFilenamePrefix + "_Shot_" + std::to_string(r.shot_number) + "_(.*)png";
+
+        std::vector<std::string> teed_ball_filenames = get_files_by_wildcard(test_suite_directory, wildcarded_teed_ball_filename);
+
+        std::string wildcarded_strobed_ball_filename = kLogImagePrefix + kWebServerCamera2ImageFilenamePrefix + "_Shot_" + std::to_string(r.shot_number) + "_(.*)png";
+
+        std::vector<std::string> wildcarded_strobed_ball_filenames = get_files_by_wildcard(test_suite_directory, wildcarded_strobed_ball_filename);
+
+        if (teed_ball_filenames.size() != 1 || wildcarded_strobed_ball_filenames.size() != 1) {
+            GS_LOG_MSG(error, "Could not resolve iamge filenames.");
+            return false;
+        }
+
+        std::string teed_ball_filename = teed_ball_filenames[0];
+        std::string strobed_ball_filename = wildcarded_strobed_ball_filenames[0];
+
+        r.teed_ball_filename = teed_ball_filename;
+        r.strobed_ball_filename = strobed_ball_filename;
+    }
+
+    return true;
+}
+
+
+bool GsAutomatedTesting::TestFinalShotResultData() {
+
     std::string kAutomatedTestSuiteDirectory;
     std::string kAutomatedTestExpectedResultsCSV;
     GsResults tolerances;
@@ -231,32 +276,8 @@ bool GsAutomatedTesting::TestFinalShotResultData() {
         return false;
     }
 
-    // TBD - Centralize in a single place -- this is also in the LoggingTools implementation
-    const std::string kLogImagePrefix = "gs_log_img__";
-
-    // For each expected result, find the corresponding image files
-
-    for (FinalResultsTestScenario& r : tests) {
-
-        // Perform a wild-card search to find the right file.  It basically just needs to have a particular prefix and the shot number
-        std::string wildcarded_teed_ball_filename = kLogImagePrefix + kWebServerLastTeedBallImageFilenamePrefix + "_Shot_" + std::to_string(r.shot_number) + "_(.*)png";
-
-        std::vector<std::string> teed_ball_filenames = get_files_by_wildcard(kAutomatedTestSuiteDirectory, wildcarded_teed_ball_filename);
-
-        std::string wildcarded_strobed_ball_filename = kLogImagePrefix + kWebServerCamera2ImageFilenamePrefix + "_Shot_" + std::to_string(r.shot_number) + "_(.*)png";
-
-        std::vector<std::string> wildcarded_strobed_ball_filenames = get_files_by_wildcard(kAutomatedTestSuiteDirectory, wildcarded_strobed_ball_filename);
-
-        if (teed_ball_filenames.size() != 1 || wildcarded_strobed_ball_filenames.size() != 1) {
-            GS_LOG_MSG(error, "Could not resolve iamge filenames.");
-            return false;
-        }
-
-        std::string teed_ball_filename = teed_ball_filenames[0];
-        std::string strobed_ball_filename = wildcarded_strobed_ball_filenames[0];
-
-        r.teed_ball_filename = teed_ball_filename;
-        r.strobed_ball_filename = strobed_ball_filename;
+    if (!FindFinalResultsTestImages(kAutomatedTestSuiteDirectory, tests)) {
+        return false;
     }
 
     // The pulses must be setup so that we can determine, e.g., pulse-ratios for distance and time measurements
@@ -270,6 +291,11 @@ bool GsAutomatedTesting::TestFinalShotResultData() {
 
     std::string kAutomatedTestResultsCSV;
     GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestResultsCSV", kAutomatedTestResultsCSV);
+    std::string kAutomatedTestReportFile;
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestReportFile", kAutomatedTestReportFile);
+    // 0 means one per core
+    int kAutomatedTestParallelShots = 1;
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestParallelShots", kAutomatedTestParallelShots);
 
 
     std::ofstream testing_results_csv_file(kAutomatedTestSuiteDirectory + kAutomatedTestResultsCSV);
@@ -278,68 +304,125 @@ bool GsAutomatedTesting::TestFinalShotResultData() {
     testing_results_csv_file << "Ball, PiTrac Shot, Speed ? (mph), VLA ? , HLA ? , Back Spin ? (rpm), Side Spin ? (rpm), , Uneekor Speed, PiTrac Speed, , Uneekor VLA, PiTrac VLA, , Uneekor HLA, PiTrac HLA, , Uneekor Back Spin, PiTrac Back Spin, , Uneekor Side Spin, PiTrac Side Spin, , Ball ID Picture, Spin Ball 1, Spin Ball 2, Test Result Ball, Notes" << std::endl;
     
 
+    // Every image is read before any shot is analyzed, so the workers below share nothing
+    // but the (read-only) images and configuration.  The decoded images stay cached for
+    // the next run in this process.
+    struct ScenarioRun {
+        cv::Mat teed_ball_img;
+        cv::Mat strobed_balls_img;
+        bool images_read = false;
+        bool analyzed = false;
+        bool passed = false;
+        GolfBall result_ball;
+        double wall_ms = 0.0;
+    };
+
     boost::timer::cpu_timer timer1;
 
-    bool allTestsPassed = true;
-    int numTotalTests = 0;
-    int numTestsFailed = 0;
+    std::vector<ScenarioRun> runs(tests.size());
 
     CameraHardware::CameraModel  camera_model = CameraHardware::PiGS;
 
-    for (auto& test : tests) {
+    for (size_t i = 0; i < tests.size(); i++) {
+        if (tests[i].ignore_shot) {
+            continue;
+        }
 
-        numTotalTests++;
+        cv::Mat teed_ball_ImgGray;
+        cv::Mat strobed_balls_ImgGray;
 
-        GS_LOG_TRACE_MSG(info, "Starting Test No. " + std::to_string(test.test_index) + ".");
+        runs[i].images_read = GsAutomatedTesting::ReadTestImages(tests[i].teed_ball_filename, tests[i].strobed_ball_filename,
+                                teed_ball_ImgGray, strobed_balls_ImgGray, runs[i].teed_ball_img, runs[i].strobed_balls_img, camera_model, false /* No undistort)*/, true /* do_not_alter_filenames */);
 
-        if (test.ignore_shot) {
-            GS_LOG_TRACE_MSG(info, "Ignoring Test No. " + std::to_string(test.test_index) + ".");
+        if (!runs[i].images_read) {
+            GS_LOG_TRACE_MSG(warning, "Failed to read valid images for Test No. " + std::to_string(tests[i].test_index));
+        }
+    }
 
-            // Just leave a blank line with the shot number
-            testing_results_csv_file << ",";
-            testing_results_csv_file << test.shot_number << "," << std::endl;
-            continue;
+    // Run the tests using whatever current .json configuration we have.  Each shot gets its
+    // own copy of the context, so one shot's handedness does not carry over to the next.
+    const GsAnalysisContext base_context = GsAnalysisContext::FromCurrentSettings();
+
+    const int num_threads = (kAutomatedTestParallelShots > 0) ? kAutomatedTestParallelShots :
+                            std::max(1, (int)std::thread::hardware_concurrency());
+    std::atomic<size_t> next_test{ 0 };
+
+    auto run_tests = [&]() {
+        size_t i;
+        while ((i = next_test++) < tests.size()) {
+            ScenarioRun& run = runs[i];
+
+            if (!run.images_read) {
+                continue;
+            }
+
+            GS_LOG_TRACE_MSG(info, "Starting Test No. " + std::to_string(tests[i].test_index) + ".");
+
+            GsAnalysisContext context = base_context;
+            context.resolution_x = run.teed_ball_img.cols;
+            context.resolution_y = run.teed_ball_img.rows;
+
+            cv::Vec3d rotation_results;
+            cv::Mat exposures_image;
+            cv::Mat dummy_pre_image;
+            std::vector<GolfBall> exposure_balls;
+
+            const auto start_time = std::chrono::steady_clock::now();
+
+            run.analyzed = GolfSimCamera::ProcessReceivedCam2Image(run.teed_ball_img,
+                                                                   run.strobed_balls_img,
+                                                                   dummy_pre_image,
+                                                                   context,
+                                                                   run.result_ball,
+                                                                   rotation_results,
+                                                                   exposures_image,
+                                                                   exposure_balls);
+
+            run.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+            if (!run.analyzed) {
+                GS_LOG_TRACE_MSG(warning, "Failed to ProcessReceivedCam2Image() for Test No. " + std::to_string(tests[i].test_index));
+            }
         }
+    };
 
-        const std::string teed_ball_image_filename = test.teed_ball_filename;
-        const std::string strobed_balls_image_filename = test.strobed_ball_filename;
-        // The (simulated) camera and ball position will depend on the test images we use, above.
+    GS_LOG_MSG(info, "TestFinalShotResultData - Running " + std::to_string(tests.size()) + " tests on " + std::to_string(num_threads) + " thread(s).");
 
-        // NOTE - These tests are expected to be run using the same .json configuration file
-        // with which the original images were captured.
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+        threads.emplace_back(run_tests);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
 
-        cv::Mat teed_ball_ImgGray;
-        cv::Mat strobed_balls_ImgGray;
-        cv::Mat teed_ball_ImgColor;
-        cv::Mat strobed_balls_ImgColor;
+    timer1.stop();
 
-        if (!GsAutomatedTesting::ReadTestImages(teed_ball_image_filename, strobed_balls_image_filename, 
-                                teed_ball_ImgGray, strobed_balls_ImgGray, teed_ball_ImgColor, strobed_balls_ImgColor, camera_model, false /* No undistort)*/, true /* do_not_alter_filenames */)) {
-            GS_LOG_TRACE_MSG(warning, "Failed to read valid images for Test No. " + std::to_string(test.test_index));
-            numTestsFailed++;
+    // The results are compared and written in the order of the tests, whatever order they ran in
+    int numTotalTests = 0;
+    int numTestsFailed = 0;
+
+    for (size_t i = 0; i < tests.size(); i++) {
+        const FinalResultsTestScenario& test = tests[i];
+        ScenarioRun& run = runs[i];
+
+        numTotalTests++;
+
+        if (test.ignore_shot) {
+            GS_LOG_TRACE_MSG(info, "Ignoring Test No. " + std::to_string(test.test_index) + ".");
+
+            // Just leave a blank line with the shot number
+            testing_results_csv_file << ",";
+            testing_results_csv_file << test.shot_number << "," << std::endl;
             continue;
         }
 
-        // Run the test using whatever current .json configuration we have
-
-        GolfBall result_ball;
-        cv::Vec3d rotation_results;
-        cv::Mat exposures_image;
-        cv::Mat dummy_pre_image;
-        std::vector<GolfBall> exposure_balls;
-
-        if (!GolfSimCamera::ProcessReceivedCam2Image(teed_ball_ImgColor,
-                                                     strobed_balls_ImgColor,
-                                                     dummy_pre_image,
-                                                     result_ball,
-                                                     rotation_results,
-                                                     exposures_image,
-                                                     exposure_balls)) {
-            GS_LOG_TRACE_MSG(warning, "Failed to ProcessReceivedCam2Image() for Test No. " + std::to_string(test.test_index));
+        if (!run.images_read || !run.analyzed) {
             numTestsFailed++;
             continue;
         }
 
+        const GolfBall& result_ball = run.result_ball;
         result_ball.PrintBallFlightResults();
 
         // Compare the results to the expected results
@@ -370,6 +453,8 @@ bool GsAutomatedTesting::TestFinalShotResultData() {
             test_passed = false;
         }
 
+        run.passed = test_passed;
+
         if (!test_passed) {
             numTestsFailed++;
         }
@@ -405,19 +490,313 @@ bool GsAutomatedTesting::TestFinalShotResultData() {
 
     GS_LOG_TRACE_MSG(trace, "Final Test Statistics:\nTotal Tests: " + std::to_string(numTotalTests) + ".\nTests Failed: " + std::to_string(numTestsFailed) + ".");
 
-    timer1.stop();
     boost::timer::cpu_times times = timer1.elapsed();
     std::cout << "TestFinalShotResultData timing: ";
     std::cout << std::fixed << std::setprecision(8)
         << times.wall / 1.0e9 << "s wall, "
         << times.user / 1.0e9 << "s user + "
-        << times.system / 1.0e9 << "s system.\n";
+        << times.system / 1.0e9 << "s system on " << num_threads << " thread(s).\n";
+
+    if (!kAutomatedTestReportFile.empty()) {
+        // One entry per test, e.g., {"shot":4,"result":"pass","wall_ms":812.3,"speed_mph":101.2,...}.
+        // A test whose images could not be read or whose shot could not be analyzed is an "error".
+        std::ofstream report_file(kAutomatedTestSuiteDirectory + kAutomatedTestReportFile);
+
+        report_file << std::fixed << std::setprecision(2);
+        report_file << "{\"threads\":" << num_threads << ",\"wall_s\":" << times.wall / 1.0e9 << ",\"tests\":" << numTotalTests
+            << ",\"failed\":" << numTestsFailed << ",\"scenarios\":[";
+
+        for (size_t i = 0; i < tests.size(); i++) {
+            const ScenarioRun& run = runs[i];
+            const char* result = tests[i].ignore_shot ? "ignored" : (!run.images_read || !run.analyzed) ? "error" : run.passed ? "pass" : "fail";
+
+            report_file << (i == 0 ? "" : ",") << "{\"shot\":" << tests[i].shot_number << ",\"result\":\"" << result << "\",\"wall_ms\":" << run.wall_ms;
+
+            if (run.analyzed) {
+                report_file << ",\"speed_mph\":" << CvUtils::MetersPerSecondToMPH((float)run.result_ball.velocity_)
+                    << ",\"hla_deg\":" << run.result_ball.angles_ball_perspective_[0]
+                    << ",\"vla_deg\":" << run.result_ball.angles_ball_perspective_[1]
+                    << ",\"back_spin_rpm\":" << run.result_ball.rotation_speeds_RPM_[2]
+                    << ",\"side_spin_rpm\":" << run.result_ball.rotation_speeds_RPM_[0];
+            }
+
+            report_file << "}";
+        }
+
+        report_file << "]}" << std::endl;
+
+        if (!report_file) {
+            GS_LOG_MSG(warning, "TestFinalShotResultData - Could not write " + kAutomatedTestSuiteDirectory + kAutomatedTestReportFile);
+        }
+        else {
+            GS_LOG_TRACE_MSG(trace, "Wrote the test report to: " + kAutomatedTestReportFile);
+        }
+    }
 
 
     return true;
 }
 
 
+bool GsAutomatedTesting::RunReplayBenchmark() {
+
+    std::string kAutomatedTestSuiteDirectory;
+    std::string kAutomatedTestExpectedResultsCSV;
+    int kReplayBenchmarkIterations = 1;
+    int kReplayBenchmarkParallelShots = 1;
+    std::string kReplayBenchmarkShotArchive;
+
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestSuiteDirectory", kAutomatedTestSuiteDirectory);
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestExpectedResultsCSV", kAutomatedTestExpectedResultsCSV);
+    GolfSimConfiguration::SetConstant("gs_config.testing.kReplayBenchmarkIterations", kReplayBenchmarkIterations);
+    GolfSimConfiguration::SetConstant("gs_config.testing.kReplayBenchmarkParallelShots", kReplayBenchmarkParallelShots);
+    GolfSimConfiguration::SetConstant("gs_config.testing.kReplayBenchmarkShotArchive", kReplayBenchmarkShotArchive);
+
+    kReplayBenchmarkIterations = std::max(1, kReplayBenchmarkIterations);
+    kReplayBenchmarkParallelShots = std::max(1, kReplayBenchmarkParallelShots);
+
+    // Load every image up front so that the timing below does not include any disk I/O
+    struct ReplayShot {
+        const FinalResultsTestScenario* test = nullptr;
+        cv::Mat teed_ball_img;
+        cv::Mat strobed_balls_img;
+    };
+
+    std::vector<FinalResultsTestScenario> tests;
+    std::vector<ReplayShot> shots;
+
+    // If there is a shot archive, the shots (and their expected results) come from it, and its
+    // frames are used straight from the mapped file.  Otherwise, the archive is written from
+    // the test suite's images so that the next run does not have to decode them.
+    const std::string archive_file_name = kReplayBenchmarkShotArchive.empty() ? std::string() :
+                                          kAutomatedTestSuiteDirectory + kReplayBenchmarkShotArchive;
+    GsShotArchiveReader archive_reader;
+
+    if (!archive_file_name.empty() && fs::exists(archive_file_name)) {
+
+        if (!archive_reader.Open(archive_file_name)) {
+            return false;
+        }
+
+        for (const GsArchivedShot& archived_shot : archive_reader.GetShots()) {
+            FinalResultsTestScenario test;
+            test.test_index = (int)tests.size();
+            test.shot_number = (int)archived_shot.results.shot_number_;
+            test.teed_ball_filename = archived_shot.teed_ball_frame_name;
+            test.strobed_ball_filename = archived_shot.strobed_balls_frame_name;
+            test.expected_results = archived_shot.results;
+            tests.push_back(test);
+        }
+
+        for (const FinalResultsTestScenario& test : tests) {
+            ReplayShot shot;
+            shot.test = &test;
+
+            if (!archive_reader.GetFrame(test.teed_ball_filename, shot.teed_ball_img) ||
+                !archive_reader.GetFrame(test.strobed_ball_filename, shot.strobed_balls_img)) {
+                GS_LOG_MSG(error, "RunReplayBenchmark - The shot archive has no images for shot " + std::to_string(test.shot_number));
+                return false;
+            }
+
+            shots.push_back(shot);
+        }
+
+        GS_LOG_MSG(info, "RunReplayBenchmark - Read " + std::to_string(shots.size()) + " shots from " + archive_file_name);
+    }
+    else {
+        try {
+            if (!ReadExpectedResults(kAutomatedTestSuiteDirectory + kAutomatedTestExpectedResultsCSV, tests)) {
+                GS_LOG_MSG(error, "Could not ReadExpectedResults().");
+                return false;
+            }
+        }
+        catch (std::exception& ex) {
+            GS_LOG_TRACE_MSG(error, "Exception! - " + std::string(ex.what()) + ".  Exiting.");
+            return false;
+        }
+
+        tests.erase(std::remove_if(tests.begin(), tests.end(), [](const FinalResultsTestScenario& t) { return t.ignore_shot; }), tests.end());
+
+        if (!FindFinalResultsTestImages(kAutomatedTestSuiteDirectory, tests)) {
+            return false;
+        }
+
+        for (const FinalResultsTestScenario& test : tests) {
+            ReplayShot shot;
+            shot.test = &test;
+            shot.teed_ball_img = cv::imread(test.teed_ball_filename, cv::IMREAD_COLOR);
+            shot.strobed_balls_img = cv::imread(test.strobed_ball_filename, cv::IMREAD_COLOR);
+
+            if (shot.teed_ball_img.empty() || shot.strobed_balls_img.empty()) {
+                GS_LOG_MSG(error, "RunReplayBenchmark - Could not read the images for shot " + std::to_string(test.shot_number));
+                return false;
+            }
+
+            shots.push_back(shot);
+        }
+
+        if (!archive_file_name.empty() && !shots.empty()) {
+            const std::shared_ptr<const GsConfigSnapshot> config_snapshot = GsConfigSnapshot::Current();
+            GsShotArchiveWriter archive_writer;
+
+            bool archived = archive_writer.Open(archive_file_name);
+
+            for (size_t i = 0; archived && i < shots.size(); i++) {
+                const FinalResultsTestScenario& test = *shots[i].test;
+
+                GsArchivedShot archived_shot;
+                archived_shot.name = "Shot_" + std::to_string(test.shot_number);
+                archived_shot.teed_ball_frame_name = fs::path(test.teed_ball_filename).filename().string();
+                archived_shot.strobed_balls_frame_name = fs::path(test.strobed_ball_filename).filename().string();
+                archived_shot.camera1_model = GolfSimCamera::kSystemSlot1CameraType;
+                archived_shot.camera1_lens_type = GolfSimCamera::kSystemSlot1LensType;
+                archived_shot.camera2_model = GolfSimCamera::kSystemSlot2CameraType;
+                archived_shot.camera2_lens_type = GolfSimCamera::kSystemSlot2LensType;
+                archived_shot.config_hash = (config_snapshot != nullptr) ? config_snapshot->ContentHash() : 0;
+                archived_shot.results = test.expected_results;
+                archived_shot.results.shot_number_ = test.shot_number;
+
+                archived = archive_writer.AddFrame(archived_shot.teed_ball_frame_name, shots[i].teed_ball_img) &&
+                           archive_writer.AddFrame(archived_shot.strobed_balls_frame_name, shots[i].strobed_balls_img) &&
+                           archive_writer.AddShot(archived_shot);
+            }
+
+            archived = archive_writer.Close() && archived;
+
+            if (archived) {
+                GS_LOG_MSG(info, "RunReplayBenchmark - Wrote the shots to " + archive_file_name + " for the next run.");
+            }
+            else {
+                GS_LOG_MSG(warning, "RunReplayBenchmark - Could not write the shot archive " + archive_file_name);
+                std::error_code error;
+                std::filesystem::remove(archive_file_name, error);
+            }
+        }
+    }
+
+    if (shots.empty()) {
+        GS_LOG_MSG(error, "RunReplayBenchmark - No shots to replay.");
+        return false;
+    }
+
+    // Same as ReadTestImages - use whatever (simulated) resolution the recorded images have
+    CameraHardware::resolution_x_override_ = shots[0].teed_ball_img.cols;
+    CameraHardware::resolution_y_override_ = shots[0].teed_ball_img.rows;
+
+    if (!PulseStrobe::InitGPIOSystem(nullptr /* Signal handler not needed here */)) {
+        GS_LOG_MSG(error, "Failed to InitGPIOSystem.");
+        return false;
+    }
+
+    // The stage trace only follows one shot at a time, so it is only used when the shots are run serially
+    const bool trace_stages = (kReplayBenchmarkParallelShots == 1);
+
+    const int num_replays = (int)shots.size() * kReplayBenchmarkIterations;
+    std::vector<double> latencies_ms(num_replays, 0.0);
+    std::vector<GolfBall> result_balls(num_replays);
+    std::vector<char> succeeded(num_replays, 0);
+    std::atomic<int> next_replay{ 0 };
+
+    auto replay_shots = [&]() {
+        int replay;
+        while ((replay = next_replay++) < num_replays) {
+            const ReplayShot& shot = shots[replay % shots.size()];
+
+            cv::Vec3d rotation_results;
+            cv::Mat exposures_image;
+            cv::Mat dummy_pre_image;
+            std::vector<GolfBall> exposure_balls;
+
+            if (trace_stages) {
+                GsShotTrace::BeginShot();
+            }
+
+            const auto start_time = std::chrono::steady_clock::now();
+
+            succeeded[replay] = GolfSimCamera::ProcessReceivedCam2Image(shot.teed_ball_img,
+                                                                        shot.strobed_balls_img,
+                                                                        dummy_pre_image,
+                                                                        result_balls[replay],
+                                                                        rotation_results,
+                                                                        exposures_image,
+                                                                        exposure_balls);
+
+            latencies_ms[replay] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+            if (trace_stages) {
+                GsShotTrace::EndShot();
+            }
+        }
+    };
+
+    GS_LOG_MSG(info, "RunReplayBenchmark - Replaying " + std::to_string(shots.size()) + " shots " + std::to_string(kReplayBenchmarkIterations) +
+        " time(s) on " + std::to_string(kReplayBenchmarkParallelShots) + " thread(s).");
+
+    const auto benchmark_start_time = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kReplayBenchmarkParallelShots; i++) {
+        threads.emplace_back(replay_shots);
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    const double elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - benchmark_start_time).count();
+
+    // Accuracy is the mean absolute difference from the expected results, over the shots that succeeded
+    int num_succeeded = 0;
+    double speed_mph_delta = 0.0;
+    double hla_deg_delta = 0.0;
+    double vla_deg_delta = 0.0;
+    double back_spin_rpm_delta = 0.0;
+    double side_spin_rpm_delta = 0.0;
+    std::vector<double> succeeded_latencies_ms;
+
+    for (int replay = 0; replay < num_replays; replay++) {
+        if (!succeeded[replay]) {
+            continue;
+        }
+
+        const GsResults& expected = shots[replay % shots.size()].test->expected_results;
+        const GolfBall& result_ball = result_balls[replay];
+
+        num_succeeded++;
+        succeeded_latencies_ms.push_back(latencies_ms[replay]);
+        speed_mph_delta += std::abs(CvUtils::MetersPerSecondToMPH((float)result_ball.velocity_) - expected.speed_mph_);
+        hla_deg_delta += std::abs(result_ball.angles_ball_perspective_[0] - expected.hla_deg_);
+        vla_deg_delta += std::abs(result_ball.angles_ball_perspective_[1] - expected.vla_deg_);
+        back_spin_rpm_delta += std::abs(result_ball.rotation_speeds_RPM_[2] - expected.back_spin_rpm_);
+        side_spin_rpm_delta += std::abs(result_ball.rotation_speeds_RPM_[0] - expected.side_spin_rpm_);
+    }
+
+    std::sort(succeeded_latencies_ms.begin(), succeeded_latencies_ms.end());
+
+    auto percentile = [&succeeded_latencies_ms](double p) {
+        if (succeeded_latencies_ms.empty()) {
+            return 0.0;
+        }
+        return succeeded_latencies_ms[(size_t)(p * (succeeded_latencies_ms.size() - 1))];
+    };
+
+    const double n = std::max(1, num_succeeded);
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "Replay benchmark: " << num_replays << " shots (" << num_replays - num_succeeded << " failed) in " << elapsed_seconds << "s - "
+        << (elapsed_seconds > 0.0 ? num_replays / elapsed_seconds : 0.0) << " shots/sec.\n"
+        << "Per-shot latency: p50 " << percentile(0.50) << "ms, p95 " << percentile(0.95) << "ms, p99 " << percentile(0.99) << "ms.\n"
+        << "Mean absolute error: speed " << speed_mph_delta / n << " mph, HLA " << hla_deg_delta / n << " deg, VLA " << vla_deg_delta / n
+        << " deg, back spin " << back_spin_rpm_delta / n << " rpm, side spin " << side_spin_rpm_delta / n << " rpm.\n";
+
+    if (trace_stages) {
+        // Covers only the most recent shots (the trace ring is small)
+        std::cout << "Per-stage latency: " << GsShotTrace::GetPercentilesJson() << "\n";
+    }
+
+    return num_succeeded > 0;
+}
+
+
 
 cv::Mat GsAutomatedTesting::UndistortImage(const cv::Mat& img, CameraHardware::CameraModel camera_model, CameraHardware::LensType lens_type, CameraHardware::CameraOrientation camera_orientation) {
     // Get a camera object just to be able to get the calibration values
@@ -438,6 +817,40 @@ cv::Mat GsAutomatedTesting::UndistortImage(const cv::Mat& img, CameraHardware::C
 }
 
 
+// The decoded test images, by file name, so that a later run in the same process (e.g.,
+// after a tuning change) does not decode them again.  Each caller gets its own copy, as
+// the images are sometimes drawn on.
+static cv::Mat ReadCachedTestImage(const std::string& file_name) {
+    static std::mutex cache_mutex;
+    static std::map<std::string, cv::Mat> cache;
+    static size_t cache_bytes = 0;
+    static int kAutomatedTestImageCacheMegabytes = -1;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    if (kAutomatedTestImageCacheMegabytes < 0) {
+        kAutomatedTestImageCacheMegabytes = 1024;
+        GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestImageCacheMegabytes", kAutomatedTestImageCacheMegabytes);
+        kAutomatedTestImageCacheMegabytes = std::max(kAutomatedTestImageCacheMegabytes, 0);
+    }
+
+    auto cached_image = cache.find(file_name);
+    if (cached_image != cache.end()) {
+        return cached_image->second.clone();
+    }
+
+    cv::Mat img = cv::imread(file_name, cv::IMREAD_COLOR);
+    const size_t img_bytes = img.total() * img.elemSize();
+
+    // Once the cache is full, the rest of the images are just decoded each time
+    if (!img.empty() && cache_bytes + img_bytes <= (size_t)kAutomatedTestImageCacheMegabytes * 1024 * 1024) {
+        cache[file_name] = img.clone();
+        cache_bytes += img_bytes;
+    }
+
+    return img;
+}
+
 bool GsAutomatedTesting::ReadTestImages(const std::string& img_1_base_filename, const std::string& img_2_base_filename, cv::Mat& ball1Img, cv::Mat& ball2Img, cv::Mat& ball1ImgColor, cv::Mat& ball2ImgColor,
     CameraHardware::CameraModel camera_model, bool undistort, bool do_not_alter_filenames) {
 
@@ -471,8 +884,38 @@ bool GsAutomatedTesting::ReadTestImages(const std::string& img_1_base_filename,
     GS_LOG_TRACE_MSG(trace, "Raw Image1: " + img1FileName);
     GS_LOG_TRACE_MSG(trace, "Raw Image2: " + img2FileName);
 
-    ball1Img = cv::imread(img1FileName, cv::IMREAD_COLOR);
-    ball2Img = cv::imread(img2FileName, cv::IMREAD_COLOR);
+    // A shot archive, if there is one, is searched for the images (by their base names) first
+    std::string kTestImageShotArchive;
+    GolfSimConfiguration::SetConstant("gs_config.testing.kTestImageShotArchive", kTestImageShotArchive);
+
+    if (!kTestImageShotArchive.empty()) {
+        // The archive stays mapped, as the frames it returns point into it
+        static std::mutex test_image_archive_mutex;
+        static GsShotArchiveReader test_image_archive;
+        static std::string test_image_archive_file_name;
+
+        std::lock_guard<std::mutex> lock(test_image_archive_mutex);
+
+        if (test_image_archive_file_name != kTestImageShotArchive) {
+            test_image_archive_file_name = kTestImageShotArchive;
+            test_image_archive.Open(kTestImageShotArchive);
+        }
+
+        if (test_image_archive.IsOpen() &&
+            test_image_archive.GetFrame(img_1_base_filename, ball1Img) &&
+            test_image_archive.GetFrame(img_2_base_filename, ball2Img)) {
+            GS_LOG_TRACE_MSG(trace, "Read both images from the shot archive " + kTestImageShotArchive);
+        }
+        else {
+            ball1Img = cv::Mat();
+            ball2Img = cv::Mat();
+        }
+    }
+
+    if (ball1Img.empty()) {
+        ball1Img = ReadCachedTestImage(img1FileName);
+        ball2Img = ReadCachedTestImage(img2FileName);
+    }
 
     if (ball1Img.empty() || ball2Img.empty()) {
         return false;
@@ -62,6 +62,13 @@ namespace golf_sim {
 
         static bool TestFinalShotResultData();
 
+        // Replays the recorded shots of the automated test suite through ProcessReceivedCam2Image
+        // as fast as possible (optionally several at once) and reports the throughput, the
+        // per-shot and per-stage latencies and the mean error against the expected results.
+        static bool RunReplayBenchmark();
+
+        static bool FindFinalResultsTestImages(const std::string& test_suite_directory, std::vector<FinalResultsTestScenario>& tests);
+
         static void ConvertInchesToMeters(const cv::Vec3d& expectedPositionsInches, cv::Vec3d& expectedPositionsMeters);
 
         static bool ReadTestImages(const std::string& img_1_base_filename, 
@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// One circle that the ball search found, together with the values that the search ranks
+// it by.  Only plain numbers, so that the candidate lists can be sorted and filtered with
+// plain copies.  A GolfBall is only made for the candidates that survive (see
+// BallImageProc::GetBall and GolfSimCamera's BallCandidateTable).
+
+#pragma once
+
+#include <type_traits>
+
+#include "gs_globals.h"
+
+namespace golf_sim {
+
+    struct BallCandidate {
+        float x = 0.0f;
+        float y = 0.0f;
+        float radius = 0.0f;
+
+        // The candidate's place in the search's (e.g., HoughCircles') results, starting at 1
+        int index = 0;
+
+        // Lower is better.  The color difference, weighted by the index.
+        double score = 0.0;
+        int found_radius = 0;
+
+        // BGR, as per openCV.  All zero if the colors were not compared.
+        float avg_rgb[3] = { 0.0f, 0.0f, 0.0f };
+        float rgb_avg_diff = 0.0f;
+        float rgb_median_diff = 0.0f;
+        float rgb_std_diff = 0.0f;
+
+        GsCircle circle() const { return GsCircle(x, y, radius); }
+
+        GsColorTriplet average_color() const { return GsColorTriplet(avg_rgb[0], avg_rgb[1], avg_rgb[2]); }
+
+        void set_circle(const GsCircle& c) {
+            x = c[0];
+            y = c[1];
+            radius = c[2];
+        }
+
+        void set_average_color(const GsColorTriplet& color) {
+            avg_rgb[0] = (float)color[0];
+            avg_rgb[1] = (float)color[1];
+            avg_rgb[2] = (float)color[2];
+        }
+    };
+
+    static_assert(std::is_trivially_copyable<BallCandidate>::value, "BallCandidate must stay trivially copyable");
+
+}
@@ -0,0 +1,298 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+#include "golf_ball.h"
+#include "cv_utils.h"
+#include "gs_config.h"
+
+#include "gs_ball_flight.h"
+
+namespace golf_sim {
+
+    double GsBallFlight::kAirDensityKgPerM3 = 1.194;
+    double GsBallFlight::kDragSpinFactor = 0.3;
+    double GsBallFlight::kLiftSpinFactor = 1.6;
+    double GsBallFlight::kMaxLiftCoefficient = 0.3;
+    double GsBallFlight::kSpinDecaySeconds = 25.0;
+    double GsBallFlight::kGroundSpeedRetention = 0.4;
+    double GsBallFlight::kGroundSpinBraking = 0.2;
+    double GsBallFlight::kGroundRollingResistance = 0.17;
+    bool GsBallFlight::kUseBallFlightTable = true;
+
+    static constexpr double kGravityMPerS2 = 9.81;
+    static constexpr double kTimeStepSeconds = 0.01;
+    static constexpr double kMaximumFlightSeconds = 20.0;
+
+    // The grid that Estimate() interpolates in
+    struct GridAxis {
+        double first;
+        double step;
+        int count;
+    };
+
+    static constexpr GridAxis kSpeedAxis{ 5.0, 2.5, 37 };           // 5 to 95 m/s
+    static constexpr GridAxis kLaunchAxis{ -10.0, 2.5, 29 };        // -10 to 60 degrees
+    static constexpr GridAxis kSpinAxis{ 0.0, 500.0, 25 };          // 0 to 12000 rpm
+    static constexpr GridAxis kSpinAxisAngleAxis{ -60.0, 5.0, 25 }; // -60 to 60 degrees
+
+    // The grid points are only filled in as shots need them.  The grid is only ever added to,
+    // and a point is simulated outside of the lock.
+    static std::mutex table_mutex;
+    static std::unordered_map<int, GsBallFlight::Flight> table_flights;
+
+
+    void GsBallFlight::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.ball_flight.kAirDensityKgPerM3", kAirDensityKgPerM3);
+        GolfSimConfiguration::SetConstant("gs_config.ball_flight.kDragSpinFactor", kDragSpinFactor);
+        GolfSimConfiguration::SetConstant("gs_config.ball_flight.kLiftSpinFactor", kLiftSpinFactor);
+        GolfSimConfiguration::SetConstant("gs_config.ball_flight.kMaxLiftCoefficient", kMaxLiftCoefficient);
+        GolfSimConfiguration::SetConstant("gs_config.ball_flight.kSpinDecaySeconds", kSpinDecaySeconds);
+        GolfSimConfiguration::SetConstant("gs_config.ball_flight.kGroundSpeedRetention", kGroundSpeedRetention);
+        GolfSimConfiguration::SetConstant("gs_config.ball_flight.kGroundSpinBraking", kGroundSpinBraking);
+        GolfSimConfiguration::SetConstant("gs_config.ball_flight.kGroundRollingResistance", kGroundRollingResistance);
+        GolfSimConfiguration::SetConstant("gs_config.ball_flight.kUseBallFlightTable", kUseBallFlightTable);
+
+        // Any points already in the table were simulated with the old values
+        std::lock_guard<std::mutex> lock(table_mutex);
+        table_flights.clear();
+    }
+
+    // Returns the spin (in rpm, never negative) and the spin axis (in degrees, positive curves right)
+    static void GetSpinAndAxis(const GsBallLaunch& launch, double& spin_rpm, double& spin_axis_deg) {
+        spin_rpm = std::hypot(launch.back_spin_rpm, launch.side_spin_rpm);
+        spin_axis_deg = (spin_rpm > 0.0) ? CvUtils::RadiansToDegrees(std::atan2(launch.side_spin_rpm, launch.back_spin_rpm)) : 0.0;
+    }
+
+    bool GsBallFlight::Simulate(const GsBallLaunch& launch, GsBallFlightResult& result) {
+
+        if (!(launch.speed_mps > 0.0)) {
+            return false;
+        }
+
+        double spin_rpm;
+        double spin_axis_deg;
+        GetSpinAndAxis(launch, spin_rpm, spin_axis_deg);
+
+        RotateFlight(SimulateFlight(launch.speed_mps, launch.vla_deg, spin_rpm, spin_axis_deg), launch.hla_deg, result);
+
+        return true;
+    }
+
+    bool GsBallFlight::Estimate(const GsBallLaunch& launch, GsBallFlightResult& result) {
+
+        if (!kUseBallFlightTable) {
+            return Simulate(launch, result);
+        }
+
+        if (!(launch.speed_mps > 0.0)) {
+            return false;
+        }
+
+        double spin_rpm;
+        double spin_axis_deg;
+        GetSpinAndAxis(launch, spin_rpm, spin_axis_deg);
+
+        const double values[4] = { launch.speed_mps, launch.vla_deg, spin_rpm, spin_axis_deg };
+        const GridAxis axes[4] = { kSpeedAxis, kLaunchAxis, kSpinAxis, kSpinAxisAngleAxis };
+
+        int lower[4];
+        double fraction[4];
+
+        for (int a = 0; a < 4; a++) {
+            const double position = (values[a] - axes[a].first) / axes[a].step;
+
+            if (position < 0.0 || position > axes[a].count - 1) {
+                return Simulate(launch, result);
+            }
+
+            lower[a] = std::min((int)position, axes[a].count - 2);
+            fraction[a] = position - lower[a];
+        }
+
+        // Interpolate between the 16 grid points around the shot
+        double sums[7] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+        for (int corner = 0; corner < 16; corner++) {
+            int index = 0;
+            double weight = 1.0;
+
+            for (int a = 0; a < 4; a++) {
+                const int upper = (corner >> a) & 1;
+                index = index * axes[a].count + lower[a] + upper;
+                weight *= upper ? fraction[a] : 1.0 - fraction[a];
+            }
+
+            if (weight == 0.0) {
+                continue;
+            }
+
+            const Flight flight = GetTableFlight(index);
+            sums[0] += weight * flight.landing_x;
+            sums[1] += weight * flight.landing_z;
+            sums[2] += weight * flight.final_x;
+            sums[3] += weight * flight.final_z;
+            sums[4] += weight * flight.apex;
+            sums[5] += weight * flight.descent_deg;
+            sums[6] += weight * flight.flight_time;
+        }
+
+        const Flight flight{ (float)sums[0], (float)sums[1], (float)sums[2], (float)sums[3], (float)sums[4], (float)sums[5], (float)sums[6] };
+        RotateFlight(flight, launch.hla_deg, result);
+
+        return true;
+    }
+
+    GsBallFlight::Flight GsBallFlight::GetTableFlight(const int index) {
+        {
+            std::lock_guard<std::mutex> lock(table_mutex);
+            auto it = table_flights.find(index);
+
+            if (it != table_flights.end()) {
+                return it->second;
+            }
+        }
+
+        const int spin_axis_index = index % kSpinAxisAngleAxis.count;
+        const int spin_index = (index / kSpinAxisAngleAxis.count) % kSpinAxis.count;
+        const int launch_index = (index / (kSpinAxisAngleAxis.count * kSpinAxis.count)) % kLaunchAxis.count;
+        const int speed_index = index / (kSpinAxisAngleAxis.count * kSpinAxis.count * kLaunchAxis.count);
+
+        const Flight flight = SimulateFlight(kSpeedAxis.first + speed_index * kSpeedAxis.step,
+                                             kLaunchAxis.first + launch_index * kLaunchAxis.step,
+                                             kSpinAxis.first + spin_index * kSpinAxis.step,
+                                             kSpinAxisAngleAxis.first + spin_axis_index * kSpinAxisAngleAxis.step);
+
+        std::lock_guard<std::mutex> lock(table_mutex);
+        table_flights.emplace(index, flight);
+
+        return flight;
+    }
+
+    GsBallFlight::Flight GsBallFlight::SimulateFlight(const double speed_mps, const double vla_deg,
+                                                      const double spin_rpm, const double spin_axis_deg) {
+
+        const double radius = GolfBall::kBallRadiusMeters;
+        const double area = kPi * radius * radius;
+        const double k = 0.5 * kAirDensityKgPerM3 * area / kBallMassKg;
+        const double initial_spin = spin_rpm * 2.0 * kPi / 60.0;
+
+        // x is down the launch line, y is up and z is to the right.  The spin axis is fixed,
+        // and tilting it to the right (a positive spin axis) curves the ball to the right.
+        const double axis = CvUtils::DegreesToRadians(spin_axis_deg);
+        const double spin_y = -std::sin(axis);
+        const double spin_z = std::cos(axis);
+
+        auto acceleration = [&](const double v[3], const double t, double a[3]) {
+            const double speed = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+
+            if (speed <= 0.0) {
+                a[0] = 0.0;
+                a[1] = -kGravityMPerS2;
+                a[2] = 0.0;
+                return;
+            }
+
+            const double s = radius * initial_spin * std::exp(-t / kSpinDecaySeconds) / speed;
+            const double cd = kBallDrag_Cd + kDragSpinFactor * s;
+            const double cl = std::min(kLiftSpinFactor * s, kMaxLiftCoefficient);
+
+            // Drag is against the velocity and lift is along (spin axis x velocity)
+            a[0] = k * speed * (-cd * v[0] + cl * (spin_y * v[2] - spin_z * v[1]));
+            a[1] = k * speed * (-cd * v[1] + cl * (spin_z * v[0])) - kGravityMPerS2;
+            a[2] = k * speed * (-cd * v[2] + cl * (-spin_y * v[0]));
+        };
+
+        const double launch = CvUtils::DegreesToRadians(vla_deg);
+        double p[3] = { 0.0, 0.0, 0.0 };
+        double v[3] = { speed_mps * std::cos(launch), speed_mps * std::sin(launch), 0.0 };
+        double t = 0.0;
+        double apex = 0.0;
+
+        const double dt = kTimeStepSeconds;
+
+        while (t < kMaximumFlightSeconds) {
+            double a1[3], a2[3], a3[3], a4[3];
+            double v2[3], v3[3], v4[3];
+
+            acceleration(v, t, a1);
+            for (int i = 0; i < 3; i++) v2[i] = v[i] + 0.5 * dt * a1[i];
+            acceleration(v2, t + 0.5 * dt, a2);
+            for (int i = 0; i < 3; i++) v3[i] = v[i] + 0.5 * dt * a2[i];
+            acceleration(v3, t + 0.5 * dt, a3);
+            for (int i = 0; i < 3; i++) v4[i] = v[i] + dt * a3[i];
+            acceleration(v4, t + dt, a4);
+
+            double next_p[3];
+            double next_v[3];
+
+            for (int i = 0; i < 3; i++) {
+                next_p[i] = p[i] + dt * (v[i] + v2[i] * 2.0 + v3[i] * 2.0 + v4[i]) / 6.0;
+                next_v[i] = v[i] + dt * (a1[i] + 2.0 * a2[i] + 2.0 * a3[i] + a4[i]) / 6.0;
+            }
+
+            if (next_p[1] < 0.0) {
+                // Landed during this step - interpolate to the ground
+                const double f = p[1] / (p[1] - next_p[1]);
+
+                for (int i = 0; i < 3; i++) {
+                    p[i] += f * (next_p[i] - p[i]);
+                    v[i] += f * (next_v[i] - v[i]);
+                }
+                t += f * dt;
+                break;
+            }
+
+            for (int i = 0; i < 3; i++) {
+                p[i] = next_p[i];
+                v[i] = next_v[i];
+            }
+            t += dt;
+            apex = std::max(apex, p[1]);
+        }
+
+        Flight flight;
+        flight.landing_x = (float)p[0];
+        flight.landing_z = (float)p[2];
+        flight.apex = (float)apex;
+        flight.flight_time = (float)t;
+
+        const double horizontal_speed = std::hypot(v[0], v[2]);
+        flight.descent_deg = (float)CvUtils::RadiansToDegrees(std::atan2(-v[1], horizontal_speed));
+
+        // The roll, along the direction the ball was traveling when it landed
+        const double back_spin_surface_speed = radius * initial_spin * std::exp(-t / kSpinDecaySeconds) * std::cos(axis);
+        const double roll_speed = std::max(0.0, kGroundSpeedRetention * horizontal_speed - kGroundSpinBraking * back_spin_surface_speed);
+        const double roll = (roll_speed * roll_speed) / (2.0 * kGroundRollingResistance * kGravityMPerS2);
+
+        flight.final_x = flight.landing_x;
+        flight.final_z = flight.landing_z;
+
+        if (horizontal_speed > 0.0) {
+            flight.final_x += (float)(roll * v[0] / horizontal_speed);
+            flight.final_z += (float)(roll * v[2] / horizontal_speed);
+        }
+
+        return flight;
+    }
+
+    void GsBallFlight::RotateFlight(const Flight& flight, const double hla_deg, GsBallFlightResult& result) {
+
+        // The horizontal launch angle turns the flight to the right (if positive) about the vertical
+        const double hla = CvUtils::DegreesToRadians(hla_deg);
+
+        result.carry_m = std::hypot(flight.landing_x, flight.landing_z);
+        result.total_m = std::hypot(flight.final_x, flight.final_z);
+        result.offline_m = flight.landing_x * std::sin(hla) + flight.landing_z * std::cos(hla);
+        result.apex_m = flight.apex;
+        result.descent_deg = flight.descent_deg;
+        result.flight_time_s = flight.flight_time;
+    }
+
+}
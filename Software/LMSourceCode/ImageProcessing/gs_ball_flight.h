@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// An internal ball-flight model, so that a bay without an external simulator can still
+// show carry, total, apex, descent angle and flight time for each shot.
+//
+// Simulate() integrates the ball's flight (RK4, 10 ms steps) under gravity, drag and the
+// Magnus lift of its spin, with the spin decaying exponentially.  Drag uses
+// kBallDrag_Cd (plus a spin-dependent term) and kBallMassKg from golf_ball.h.  The lift
+// and drag spin factors are fitted to published tour-average carries and apexes, which
+// they match to within a few percent for driver through wedge.  The roll after landing is a
+// simple one-bounce model for a firm fairway, so the total is only a rough guide.
+//
+// Estimate() is the fast path.  It interpolates between Simulate() results on a grid of
+// speed, launch angle, total spin and spin axis, where each grid point is simulated the first
+// time it is needed and then kept.  Once the grid points around a shot are known, an
+// estimate takes about a microsecond.  The horizontal launch angle is applied afterward, as it
+// only rotates the flight.  A shot outside the grid is just simulated.
+
+#pragma once
+
+namespace golf_sim {
+
+    // Angles and spins are as in GsResults - a positive side spin curves the ball to the right
+    struct GsBallLaunch {
+        double speed_mps = 0.0;
+        double vla_deg = 0.0;
+        double hla_deg = 0.0;
+        double back_spin_rpm = 0.0;
+        double side_spin_rpm = 0.0;
+    };
+
+    struct GsBallFlightResult {
+        // Ground distances from the ball's starting position
+        double carry_m = 0.0;
+        double total_m = 0.0;
+
+        // Where the ball lands relative to the target line.  Positive is to the right.
+        double offline_m = 0.0;
+
+        double apex_m = 0.0;
+        double descent_deg = 0.0;
+        double flight_time_s = 0.0;
+    };
+
+    class GsBallFlight {
+
+    public:
+        static double kAirDensityKgPerM3;
+
+        // Cd = kBallDrag_Cd + kDragSpinFactor * S and CL = min(kLiftSpinFactor * S, kMaxLiftCoefficient),
+        // where S is the spin factor, (ball radius * angular speed) / speed
+        static double kDragSpinFactor;
+        static double kLiftSpinFactor;
+        static double kMaxLiftCoefficient;
+
+        // The time for the spin to decay to 1/e of its starting rate
+        static double kSpinDecaySeconds;
+
+        // On landing, the ball keeps kGroundSpeedRetention of its horizontal speed, less
+        // kGroundSpinBraking times the surface speed of its remaining back spin, and then
+        // rolls to a stop against kGroundRollingResistance (times g) of deceleration
+        static double kGroundSpeedRetention;
+        static double kGroundSpinBraking;
+        static double kGroundRollingResistance;
+
+        // If false, Estimate() always simulates
+        static bool kUseBallFlightTable;
+
+        static void LoadConfigurationValues();
+
+        // The accurate (but roughly millisecond) version.  Returns false if the speed is not positive.
+        static bool Simulate(const GsBallLaunch& launch, GsBallFlightResult& result);
+
+        // The fast version.  Safe to call from any thread.
+        static bool Estimate(const GsBallLaunch& launch, GsBallFlightResult& result);
+
+        // The flight with no horizontal launch angle.  x is down the launch line, z is to the right.
+        struct Flight {
+            float landing_x;
+            float landing_z;
+            float final_x;
+            float final_z;
+            float apex;
+            float descent_deg;
+            float flight_time;
+        };
+
+    private:
+        static Flight SimulateFlight(const double speed_mps, const double vla_deg,
+                                     const double spin_rpm, const double spin_axis_deg);
+
+        static Flight GetTableFlight(const int index);
+
+        static void RotateFlight(const Flight& flight, const double hla_deg, GsBallFlightResult& result);
+    };
+
+}
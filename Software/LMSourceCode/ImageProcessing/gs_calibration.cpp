@@ -5,6 +5,18 @@
 
 #include <algorithm>
 #include <bitset>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/objdetect/charuco_detector.hpp>
 
 #include "gs_options.h"
 #include "ball_image_proc.h"
@@ -58,6 +70,22 @@ namespace golf_sim {
     int GolfSimCalibration::kNumberPicturesForFocalLengthAverage = 5;
 
     int GolfSimCalibration::kNumberOfCalibrationFailuresToTolerate = 2;
+    bool GolfSimCalibration::kPipelinedAutoCalibration = false;
+    double GolfSimCalibration::kFocalLengthConvergenceTolerance = 0.0;
+
+    int GolfSimCalibration::kMarkerBoardSquaresX = 7;
+    int GolfSimCalibration::kMarkerBoardSquaresY = 5;
+    double GolfSimCalibration::kMarkerBoardSquareLengthMeters = 0.030;
+    double GolfSimCalibration::kMarkerBoardMarkerLengthMeters = 0.022;
+    std::string GolfSimCalibration::kMarkerBoardDictionary = "DICT_5X5_100";
+    cv::Vec3d GolfSimCalibration::kMarkerBoardCenterOffsetFromBallMeters = cv::Vec3d(0.0, 0.054, 0.0);
+    int GolfSimCalibration::kMarkerCalibrationNumberOfPictures = 3;
+    int GolfSimCalibration::kMarkerCalibrationMinimumCorners = 12;
+    bool GolfSimCalibration::kMarkerCalibrationRefineDistortion = true;
+    bool GolfSimCalibration::kMarkerCalibrationBallCrossCheck = true;
+    int GolfSimCalibration::kMarkerCalibrationBallPlacementDelaySeconds = 10;
+    double GolfSimCalibration::kMarkerCalibrationMaxFocalLengthDifference = 0.03;
+    double GolfSimCalibration::kMarkerCalibrationMaxAngleDifferenceDegrees = 1.5;
 
 
     GolfSimCalibration::GolfSimCalibration() {
@@ -74,6 +102,22 @@ namespace golf_sim {
         kCalibrationRigType = (GolfSimCalibration::CalibrationRigType)rig_type;
 
         GolfSimConfiguration::SetConstant("gs_config.calibration.kNumberOfCalibrationFailuresToTolerate", kNumberOfCalibrationFailuresToTolerate);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kPipelinedAutoCalibration", kPipelinedAutoCalibration);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kFocalLengthConvergenceTolerance", kFocalLengthConvergenceTolerance);
+
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerBoardSquaresX", kMarkerBoardSquaresX);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerBoardSquaresY", kMarkerBoardSquaresY);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerBoardSquareLengthMeters", kMarkerBoardSquareLengthMeters);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerBoardMarkerLengthMeters", kMarkerBoardMarkerLengthMeters);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerBoardDictionary", kMarkerBoardDictionary);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerBoardCenterOffsetFromBallMeters", kMarkerBoardCenterOffsetFromBallMeters);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerCalibrationNumberOfPictures", kMarkerCalibrationNumberOfPictures);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerCalibrationMinimumCorners", kMarkerCalibrationMinimumCorners);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerCalibrationRefineDistortion", kMarkerCalibrationRefineDistortion);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerCalibrationBallCrossCheck", kMarkerCalibrationBallCrossCheck);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerCalibrationBallPlacementDelaySeconds", kMarkerCalibrationBallPlacementDelaySeconds);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerCalibrationMaxFocalLengthDifference", kMarkerCalibrationMaxFocalLengthDifference);
+        GolfSimConfiguration::SetConstant("gs_config.calibration.kMarkerCalibrationMaxAngleDifferenceDegrees", kMarkerCalibrationMaxAngleDifferenceDegrees);
 
         GolfSimConfiguration::SetConstant("gs_config.calibration.kCustomCalibrationRigPositionFromCamera1", kCustomCalibrationRigPositionFromCamera1);
         GolfSimConfiguration::SetConstant("gs_config.calibration.kCustomCalibrationRigPositionFromCamera2", kCustomCalibrationRigPositionFromCamera2);
@@ -157,6 +201,8 @@ namespace golf_sim {
 
         ball = return_balls[0];
 
+        BallImageProc::RefineBallRadiusSubpixel(color_image, ball);
+
         // Because we are auto-calibrating, we know the exact distance from the ball to the lens
         double distance_direct_to_ball = CvUtils::GetDistance(kFinalAutoCalibrationBallPositionFromCameraMeters);
 
@@ -266,11 +312,9 @@ namespace golf_sim {
         // words, the angle of the ball from the center of the lens if the camera was
         // pointing straight out).
 
-        double x_angle_degrees_of_ball_lm_perspective = -CvUtils::RadiansToDegrees(atan(kFinalAutoCalibrationBallPositionFromCameraMeters[0] / kFinalAutoCalibrationBallPositionFromCameraMeters[2]));
-            
-        // Need to calculate the adjacent (tan x = opposite/adjacent) distance by using the known x and z distances) to determine the y angle
-        double horizontal_distance_to_ball_vertical_axis = sqrt(pow(kFinalAutoCalibrationBallPositionFromCameraMeters[0], 2) + pow(kFinalAutoCalibrationBallPositionFromCameraMeters[2], 2) );
-        double y_angle_degrees_of_ball_lm_perspective = CvUtils::RadiansToDegrees(atan(kFinalAutoCalibrationBallPositionFromCameraMeters[1] / horizontal_distance_to_ball_vertical_axis));
+        const cv::Vec2d lm_perspective_angles = ComputeLmPerspectiveAngles(kFinalAutoCalibrationBallPositionFromCameraMeters);
+        double x_angle_degrees_of_ball_lm_perspective = lm_perspective_angles[0];
+        double y_angle_degrees_of_ball_lm_perspective = lm_perspective_angles[1];
 
         GS_LOG_TRACE_MSG(trace, "GolfSimCalibration::DetermineCameraAngles computed angles to ball from the perspective of the LM (from the center of the camera lens if the camera was pointing straight out): " +
             std::to_string(x_angle_degrees_of_ball_lm_perspective) + ", " +
@@ -296,6 +340,194 @@ namespace golf_sim {
         return true;
     }
 
+    cv::Vec2d GolfSimCalibration::ComputeLmPerspectiveAngles(const cv::Vec3d& position) {
+
+        const double x_angle_degrees = -CvUtils::RadiansToDegrees(atan(position[0] / position[2]));
+
+        // Need to calculate the adjacent (tan x = opposite/adjacent) distance by using the known x and z distances) to determine the y angle
+        const double horizontal_distance_to_vertical_axis = sqrt(pow(position[0], 2) + pow(position[2], 2));
+        const double y_angle_degrees = CvUtils::RadiansToDegrees(atan(position[1] / horizontal_distance_to_vertical_axis));
+
+        return cv::Vec2d(x_angle_degrees, y_angle_degrees);
+    }
+
+    bool GolfSimCalibration::SampleFocalLengthsPipelined(const GolfSimCamera& camera, int number_attempts,
+                                                         double& focal_length_sum, int& number_samples, cv::Mat& last_image) {
+
+        GS_LOG_TRACE_MSG(trace, "SampleFocalLengthsPipelined - up to " + std::to_string(number_attempts) + " samples.");
+
+        struct CalibrationFrame {
+            int index;
+            cv::Mat image;
+        };
+
+        std::mutex mutex;
+        std::condition_variable frames_changed;
+        std::deque<CalibrationFrame> frames;
+        bool capture_done = false;
+        bool analysis_done = false;
+        bool analysis_failed = false;
+        int number_failures = 0;
+        int number_frames_captured = 0;
+        std::vector<double> focal_lengths;
+
+        // The artifact images are written in the background so that neither the capture nor the
+        // analysis waits on the PNG encoding
+        std::mutex artifact_writes_mutex;
+        std::vector<std::future<void>> artifact_writes;
+
+        auto write_artifact = [&](const cv::Mat& image, const std::string& file_name) {
+            std::lock_guard<std::mutex> lock(artifact_writes_mutex);
+            artifact_writes.push_back(std::async(std::launch::async, [image, file_name]() {
+                LoggingTools::LogImage("", image, std::vector < cv::Point >{}, true, file_name);
+            }));
+        };
+
+        // True once the standard error of the running mean is within the tolerance
+        auto has_converged = [&focal_lengths]() {
+            const size_t n = focal_lengths.size();
+            if (kFocalLengthConvergenceTolerance <= 0.0 || n < 3) {
+                return false;
+            }
+
+            const double mean = std::accumulate(focal_lengths.begin(), focal_lengths.end(), 0.0) / n;
+            double variance = 0.0;
+            for (double f : focal_lengths) {
+                variance += (f - mean) * (f - mean);
+            }
+            variance /= (n - 1);
+
+            return mean > 0.0 && std::sqrt(variance / n) / mean < kFocalLengthConvergenceTolerance;
+        };
+
+        // Analyzes frame N while frame N+1 is being captured
+        std::thread analyzer([&]() {
+            while (true) {
+                CalibrationFrame frame;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    frames_changed.wait(lock, [&] { return capture_done || !frames.empty(); });
+
+                    if (frames.empty()) {
+                        return;
+                    }
+
+                    frame = std::move(frames.front());
+                    frames.pop_front();
+                }
+                frames_changed.notify_all();
+
+                GolfBall ball;
+                const double focal_length = DetermineFocalLengthForAutoCalibration(frame.image, camera, ball);
+
+                if (focal_length >= 0.0) {
+                    cv::Mat final_result_image = frame.image.clone();
+                    LoggingTools::DrawCircleOutlineAndCenter(final_result_image, ball.ball_circle_, "Ball");
+
+                    // The intermediate image is useful to see if the circles are being identified accurately
+                    write_artifact(final_result_image, "Focal_Length_Autocalibration_Results_Image_" + std::to_string(frame.index) + ".png");
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (focal_length < 0.0) {
+                    number_failures++;
+
+                    if (number_failures > kNumberOfCalibrationFailuresToTolerate) {
+                        GS_LOG_MSG(error, "Could not DetermineFocalLengthForAutoCalibration -- Too many failures - giving up.  Check the input pictures for more information.");
+                        analysis_failed = true;
+                        analysis_done = true;
+                    }
+                    else {
+                        GS_LOG_MSG(warning, "Could not DetermineFocalLengthForAutoCalibration -- trying again.");
+                    }
+                }
+                else {
+                    focal_lengths.push_back(focal_length);
+                    last_image = frame.image;
+                    GS_LOG_MSG(info, "Next Sampled Focal Length = " + std::to_string(focal_length) + ".");
+
+                    if ((int)focal_lengths.size() >= number_attempts) {
+                        analysis_done = true;
+                    }
+                    else if (has_converged()) {
+                        GS_LOG_MSG(info, "Focal length converged after " + std::to_string(focal_lengths.size()) + " samples.");
+                        analysis_done = true;
+                    }
+                }
+
+                if (analysis_done) {
+                    frames_changed.notify_all();
+                    return;
+                }
+            }
+        });
+
+        // Returns false once no more frames are needed
+        auto on_frame = [&](const cv::Mat& image) -> bool {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            if (analysis_done) {
+                return false;
+            }
+
+            const int index = number_frames_captured++;
+            write_artifact(image, "Focal_Length_Autocalibration_Input_Image_" + std::to_string(index) + ".png");
+            frames.push_back(CalibrationFrame{ index, image });
+            frames_changed.notify_all();
+
+            // Stay at most one frame ahead of the analysis
+            frames_changed.wait(lock, [&] { return analysis_done || frames.empty(); });
+
+            // Enough frames for every sample plus every tolerated failure
+            return !analysis_done && number_frames_captured < number_attempts + kNumberOfCalibrationFailuresToTolerate + 1;
+        };
+
+        bool capture_succeeded = true;
+
+#ifdef __unix__
+        if (camera.camera_hardware_.camera_number_ == GsCameraNumber::kGsCamera1) {
+            // Camera 1 streams stills without being re-configured for each one
+            capture_succeeded = TakeRawPictures(camera, on_frame);
+        }
+        else
+#endif
+        {
+            cv::Mat color_image;
+            while ((capture_succeeded = GolfSimCamera::TakeStillPicture(camera, color_image))) {
+                if (!on_frame(color_image.clone())) {
+                    break;
+                }
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            capture_done = true;
+        }
+        frames_changed.notify_all();
+        analyzer.join();
+
+        for (std::future<void>& write : artifact_writes) {
+            write.wait();
+        }
+
+        if (!capture_succeeded && !analysis_done) {
+            GS_LOG_MSG(error, "FAILED to TakeStillPicture");
+            return false;
+        }
+
+        if (analysis_failed) {
+            return false;
+        }
+
+        focal_length_sum = std::accumulate(focal_lengths.begin(), focal_lengths.end(), 0.0);
+        number_samples = (int)focal_lengths.size();
+
+        return true;
+    }
+
+
     bool GolfSimCalibration::AutoCalibrateCamera(GsCameraNumber camera_number) {
 
         GS_LOG_TRACE_MSG(trace, "AutoCalibrateCamera called with camera number = " + std::to_string(camera_number));
@@ -306,17 +538,8 @@ namespace golf_sim {
         }
 
         // We will need a camera for context
-        const CameraHardware::CameraModel  camera_model = (camera_number == GsCameraNumber::kGsCamera1) ? GolfSimCamera::kSystemSlot1CameraType : GolfSimCamera::kSystemSlot2CameraType;
-        GS_LOG_TRACE_MSG(trace, "AutoCalibrateCamera called with camera model = " + std::to_string(camera_model));
-        const CameraHardware::LensType  camera_lens_type = (camera_number == GsCameraNumber::kGsCamera1) ? GolfSimCamera::kSystemSlot1LensType : GolfSimCamera::kSystemSlot2LensType;
-        GS_LOG_TRACE_MSG(trace, "AutoCalibrateCamera called with camera lens type = " + std::to_string(camera_lens_type));
-		const CameraHardware::CameraOrientation camera_orientation = (camera_number == GsCameraNumber::kGsCamera1) ? GolfSimCamera::kSystemSlot1CameraOrientation : GolfSimCamera::kSystemSlot2CameraOrientation;
-        GS_LOG_TRACE_MSG(trace, "AutoCalibrateCamera called with camera orientation = " + std::to_string(camera_orientation));
-
         GolfSimCamera camera;
-        // Use the default focal length for the camera, as the focal length is one parameter
-        // that this function is being called to re-set
-        camera.camera_hardware_.init_camera_parameters(camera_number, camera_model, camera_lens_type, camera_orientation, true /* Use default, not .json focal-length*/);
+        InitCalibrationCamera(camera_number, camera);
 
         cv::Mat color_image;
 
@@ -391,7 +614,13 @@ namespace golf_sim {
         // Find an average focal length
         int number_failures = 0;
 
-        for (int i = 0; i < number_attempts; i++) {
+        if (kPipelinedAutoCalibration) {
+            if (!SampleFocalLengthsPipelined(camera, number_attempts, average_focal_length, number_samples, color_image)) {
+                return false;
+            }
+        }
+
+        for (int i = 0; !kPipelinedAutoCalibration && i < number_attempts; i++) {
 
             if (!GolfSimCamera::TakeStillPicture(camera, color_image)) {
                 GS_LOG_MSG(error, "FAILED to TakeStillPicture");
@@ -494,6 +723,25 @@ namespace golf_sim {
         std::vector<double> angles_vector = {camera_angles[0], camera_angles[1]};
         WebApi::UpdateCalibration(camera_angles_tag_name, angles_vector);
 
+        return SaveCalibrationToConfigFile();
+    }
+
+    void GolfSimCalibration::InitCalibrationCamera(GsCameraNumber camera_number, GolfSimCamera& camera) {
+
+        const CameraHardware::CameraModel  camera_model = (camera_number == GsCameraNumber::kGsCamera1) ? GolfSimCamera::kSystemSlot1CameraType : GolfSimCamera::kSystemSlot2CameraType;
+        GS_LOG_TRACE_MSG(trace, "InitCalibrationCamera called with camera model = " + std::to_string(camera_model));
+        const CameraHardware::LensType  camera_lens_type = (camera_number == GsCameraNumber::kGsCamera1) ? GolfSimCamera::kSystemSlot1LensType : GolfSimCamera::kSystemSlot2LensType;
+        GS_LOG_TRACE_MSG(trace, "InitCalibrationCamera called with camera lens type = " + std::to_string(camera_lens_type));
+		const CameraHardware::CameraOrientation camera_orientation = (camera_number == GsCameraNumber::kGsCamera1) ? GolfSimCamera::kSystemSlot1CameraOrientation : GolfSimCamera::kSystemSlot2CameraOrientation;
+        GS_LOG_TRACE_MSG(trace, "InitCalibrationCamera called with camera orientation = " + std::to_string(camera_orientation));
+
+        // Use the default focal length for the camera, as the focal length is one parameter
+        // that the calibration is being done to re-set
+        camera.camera_hardware_.init_camera_parameters(camera_number, camera_model, camera_lens_type, camera_orientation, true /* Use default, not .json focal-length*/);
+    }
+
+    bool GolfSimCalibration::SaveCalibrationToConfigFile() {
+
         std::string config_file_name = "golf_sim_config.json";
 
         if (!GolfSimOptions::GetCommandLineOptions().config_file_.empty()) {
@@ -529,6 +777,371 @@ namespace golf_sim {
         return true;
     }
 
+
+    // The RMS distance (in pixels) between the board corners and where the best pose for each
+    // picture puts them, with the given camera matrix and distortion
+    static double MarkerReprojectionError(const std::vector<std::vector<cv::Point3f>>& object_points,
+                                          const std::vector<std::vector<cv::Point2f>>& image_points,
+                                          const cv::Mat& camera_matrix,
+                                          const cv::Mat& distortion) {
+        double squared_error_sum = 0.0;
+        size_t number_points = 0;
+
+        for (size_t i = 0; i < object_points.size(); i++) {
+            cv::Mat rvec, tvec;
+            if (!cv::solvePnP(object_points[i], image_points[i], camera_matrix, distortion, rvec, tvec)) {
+                continue;
+            }
+
+            std::vector<cv::Point2f> projected_points;
+            cv::projectPoints(object_points[i], rvec, tvec, camera_matrix, distortion, projected_points);
+
+            for (size_t j = 0; j < projected_points.size(); j++) {
+                const cv::Point2f difference = projected_points[j] - image_points[i][j];
+                squared_error_sum += difference.dot(difference);
+            }
+            number_points += projected_points.size();
+        }
+
+        return (number_points == 0) ? -1.0 : std::sqrt(squared_error_sum / number_points);
+    }
+
+    static bool GetMarkerDictionary(const std::string& name, cv::aruco::PredefinedDictionaryType& dictionary) {
+
+        static const std::vector<std::pair<std::string, cv::aruco::PredefinedDictionaryType>> kDictionaries = {
+            { "DICT_4X4_50", cv::aruco::DICT_4X4_50 },
+            { "DICT_4X4_100", cv::aruco::DICT_4X4_100 },
+            { "DICT_5X5_50", cv::aruco::DICT_5X5_50 },
+            { "DICT_5X5_100", cv::aruco::DICT_5X5_100 },
+            { "DICT_6X6_50", cv::aruco::DICT_6X6_50 },
+            { "DICT_6X6_250", cv::aruco::DICT_6X6_250 },
+            { "DICT_ARUCO_ORIGINAL", cv::aruco::DICT_ARUCO_ORIGINAL },
+            { "DICT_APRILTAG_16h5", cv::aruco::DICT_APRILTAG_16h5 },
+            { "DICT_APRILTAG_25h9", cv::aruco::DICT_APRILTAG_25h9 },
+            { "DICT_APRILTAG_36h10", cv::aruco::DICT_APRILTAG_36h10 },
+            { "DICT_APRILTAG_36h11", cv::aruco::DICT_APRILTAG_36h11 },
+        };
+
+        for (const auto& entry : kDictionaries) {
+            if (entry.first == name) {
+                dictionary = entry.second;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool GolfSimCalibration::MarkerCalibrateCamera(GsCameraNumber camera_number) {
+
+        GS_LOG_TRACE_MSG(trace, "MarkerCalibrateCamera called with camera number = " + std::to_string(camera_number));
+
+        if (!RetrieveAutoCalibrationConstants(camera_number)) {
+            GS_LOG_MSG(error, "Could not RetrieveAutoCalibrationConstants.");
+            return false;
+        }
+
+        GolfSimCamera camera;
+        InitCalibrationCamera(camera_number, camera);
+        CameraHardware& camera_hardware = camera.camera_hardware_;
+
+        const cv::Vec3d board_center_position = kFinalAutoCalibrationBallPositionFromCameraMeters + kMarkerBoardCenterOffsetFromBallMeters;
+        const double distance_to_board = CvUtils::GetDistance(board_center_position);
+
+        if (distance_to_board <= 0.0001 || board_center_position[2] <= 0.0) {
+            GS_LOG_MSG(error, "MarkerCalibrateCamera could not calculate a valid distance to the board.");
+            return false;
+        }
+
+        cv::aruco::PredefinedDictionaryType dictionary_type;
+
+        if (!GetMarkerDictionary(kMarkerBoardDictionary, dictionary_type)) {
+            GS_LOG_MSG(error, "MarkerCalibrateCamera - unknown marker dictionary: " + kMarkerBoardDictionary);
+            return false;
+        }
+
+        const cv::aruco::CharucoBoard board(cv::Size(kMarkerBoardSquaresX, kMarkerBoardSquaresY),
+                                            (float)kMarkerBoardSquareLengthMeters, (float)kMarkerBoardMarkerLengthMeters,
+                                            cv::aruco::getPredefinedDictionary(dictionary_type));
+        const cv::aruco::CharucoDetector detector(board);
+
+        // In the board's axes (x to the right and y down the board as printed, z into it)
+        const cv::Point3d board_center(kMarkerBoardSquaresX * kMarkerBoardSquareLengthMeters / 2.0,
+                                       kMarkerBoardSquaresY * kMarkerBoardSquareLengthMeters / 2.0, 0.0);
+
+        GS_LOG_MSG(info, "Board center is expected at (x,y,z) = " + LoggingTools::FormatVec3f(board_center_position) +
+                         " meters from the camera, " + std::to_string(distance_to_board) + " meters away.");
+
+        // The corners that were found in each picture
+        std::vector<std::vector<cv::Point3f>> object_points;
+        std::vector<std::vector<cv::Point2f>> image_points;
+
+        cv::Mat color_image;
+        int number_failures = 0;
+
+        for (int i = 0; (int)image_points.size() < std::max(1, kMarkerCalibrationNumberOfPictures); i++) {
+
+            if (!GolfSimCamera::TakeStillPicture(camera, color_image)) {
+                GS_LOG_MSG(error, "FAILED to TakeStillPicture");
+                return false;
+            }
+
+            LoggingTools::LogImage("", color_image, std::vector < cv::Point >{}, true, "Marker_Autocalibration_Input_Image_" + std::to_string(i) + ".png");
+
+            if (color_image.cols != camera_hardware.resolution_x_ || color_image.rows != camera_hardware.resolution_y_) {
+                GS_LOG_MSG(error, "MarkerCalibrateCamera - the picture is " + std::to_string(color_image.cols) + "x" + std::to_string(color_image.rows) +
+                                  ", but the camera's resolution is " + std::to_string(camera_hardware.resolution_x_) + "x" + std::to_string(camera_hardware.resolution_y_) + ".");
+                return false;
+            }
+
+            cv::Mat gray_image;
+            if (color_image.channels() == 3) {
+                cv::cvtColor(color_image, gray_image, cv::COLOR_BGR2GRAY);
+            }
+            else {
+                gray_image = color_image;
+            }
+
+            std::vector<cv::Point2f> charuco_corners;
+            std::vector<int> charuco_ids;
+            detector.detectBoard(gray_image, charuco_corners, charuco_ids);
+
+            std::vector<cv::Point3f> frame_object_points;
+            std::vector<cv::Point2f> frame_image_points;
+
+            if (!charuco_ids.empty()) {
+                board.matchImagePoints(charuco_corners, charuco_ids, frame_object_points, frame_image_points);
+            }
+
+            if ((int)frame_image_points.size() < kMarkerCalibrationMinimumCorners) {
+                number_failures++;
+
+                if (number_failures > kNumberOfCalibrationFailuresToTolerate) {
+                    GS_LOG_MSG(error, "MarkerCalibrateCamera found too few board corners (" + std::to_string(frame_image_points.size()) +
+                                      ") too many times - giving up.  Check the input pictures for more information.");
+                    return false;
+                }
+
+                GS_LOG_MSG(warning, "MarkerCalibrateCamera found only " + std::to_string(frame_image_points.size()) + " board corners -- trying again.");
+                continue;
+            }
+
+            cv::Mat final_result_image = color_image.clone();
+            cv::aruco::drawDetectedCornersCharuco(final_result_image, charuco_corners, charuco_ids);
+            LoggingTools::LogImage("", final_result_image, std::vector < cv::Point >{}, true, "Marker_Autocalibration_Results_Image_" + std::to_string(i) + ".png");
+
+            GS_LOG_MSG(info, "Found " + std::to_string(frame_image_points.size()) + " board corners.");
+
+            object_points.push_back(frame_object_points);
+            image_points.push_back(frame_image_points);
+        }
+
+        // The stills have already been undistorted with the .json calibration values, so any distortion
+        // that is left is the error in those values.  To first order, the radial terms of the two
+        // distortions add up, so the residual k1 and k2 (at the same camera matrix) are added to the
+        // current ones.
+        cv::Mat refined_distortion;
+
+        if (kMarkerCalibrationRefineDistortion && camera_hardware.use_undistortion_matrix_) {
+            cv::Mat calibration_matrix;
+            camera_hardware.calibrationMatrix_.convertTo(calibration_matrix, CV_64F);
+
+            const cv::Mat no_distortion = cv::Mat::zeros(1, 5, CV_64F);
+            const double error_before = MarkerReprojectionError(object_points, image_points, calibration_matrix, no_distortion);
+
+            cv::Mat residual_distortion = no_distortion.clone();
+            std::vector<cv::Mat> rvecs, tvecs;
+            const double error_after = cv::calibrateCamera(object_points, image_points, color_image.size(), calibration_matrix, residual_distortion, rvecs, tvecs,
+                                                           cv::CALIB_USE_INTRINSIC_GUESS | cv::CALIB_FIX_FOCAL_LENGTH | cv::CALIB_FIX_PRINCIPAL_POINT |
+                                                           cv::CALIB_FIX_TANGENT_DIST | cv::CALIB_FIX_K3);
+
+            GS_LOG_MSG(info, "Board corner reprojection error is " + std::to_string(error_before) + " pixels with the current distortion, and " +
+                             std::to_string(error_after) + " pixels with the residual distortion of k1 = " + std::to_string(residual_distortion.at<double>(0, 0)) +
+                             ", k2 = " + std::to_string(residual_distortion.at<double>(0, 1)) + ".");
+
+            // Only worth changing the undistortion for a clear improvement
+            if (error_before > 0.0 && error_after < 0.9 * error_before) {
+                camera_hardware.cameraDistortionVector_.convertTo(refined_distortion, CV_64F);
+                refined_distortion = refined_distortion.reshape(1, 1).clone();
+                refined_distortion.at<double>(0, 0) += residual_distortion.at<double>(0, 0);
+                refined_distortion.at<double>(0, 1) += residual_distortion.at<double>(0, 1);
+            }
+        }
+        else if (kMarkerCalibrationRefineDistortion) {
+            GS_LOG_MSG(warning, "MarkerCalibrateCamera - the camera has no undistortion values to refine.");
+        }
+
+        // Find the focal length at which the boards' distance matches the known distance.  With the
+        // camera matrix that the rest of the system's geometry uses (see GsCameraIntrinsics), the
+        // distance from the PnP pose is proportional to the focal length (exactly, for a board that
+        // faces the camera), so this converges in a few steps.
+        const double pixels_per_mm_x = camera_hardware.resolution_x_ / (double)camera_hardware.sensor_width_;
+        const double pixels_per_mm_y = camera_hardware.resolution_y_ / (double)camera_hardware.sensor_height_;
+
+        auto make_camera_matrix = [&](const double focal_length) -> cv::Mat {
+            cv::Mat camera_matrix = (cv::Mat_<double>(3, 3) <<
+                focal_length * pixels_per_mm_x, 0.0, std::round(camera_hardware.resolution_x_ / 2.0),
+                0.0, focal_length * pixels_per_mm_y, std::round(camera_hardware.resolution_y_ / 2.0),
+                0.0, 0.0, 1.0);
+            return camera_matrix;
+        };
+
+        const cv::Mat board_center_mat = (cv::Mat_<double>(3, 1) << board_center.x, board_center.y, board_center.z);
+
+        // The board center in the camera's axes (x to the right, y down and z out along its bore line)
+        auto board_center_from_camera = [&](const size_t picture, const cv::Mat& camera_matrix, cv::Vec3d& center) {
+            cv::Mat rvec, tvec, rotation;
+            if (!cv::solvePnP(object_points[picture], image_points[picture], camera_matrix, cv::noArray(), rvec, tvec)) {
+                return false;
+            }
+            cv::Rodrigues(rvec, rotation);
+            cv::Mat center_mat = rotation * board_center_mat + tvec;
+            center = cv::Vec3d(center_mat.at<double>(0), center_mat.at<double>(1), center_mat.at<double>(2));
+            return true;
+        };
+
+        double focal_length = camera_hardware.focal_length_;
+        cv::Vec3d average_board_center(0.0, 0.0, 0.0);
+
+        for (int iteration = 0; iteration < 10; iteration++) {
+            const cv::Mat camera_matrix = make_camera_matrix(focal_length);
+
+            average_board_center = cv::Vec3d(0.0, 0.0, 0.0);
+            int number_poses = 0;
+            for (size_t i = 0; i < object_points.size(); i++) {
+                cv::Vec3d center;
+                if (board_center_from_camera(i, camera_matrix, center)) {
+                    average_board_center += center;
+                    number_poses++;
+                }
+            }
+
+            if (number_poses == 0) {
+                GS_LOG_MSG(error, "MarkerCalibrateCamera could not determine the pose of the board.");
+                return false;
+            }
+
+            average_board_center /= (double)number_poses;
+
+            const double measured_distance = CvUtils::GetDistance(average_board_center);
+            const double next_focal_length = focal_length * distance_to_board / measured_distance;
+            const bool converged = std::abs(next_focal_length - focal_length) < 1e-5 * focal_length;
+
+            focal_length = next_focal_length;
+
+            if (converged) {
+                break;
+            }
+        }
+
+        GS_LOG_MSG(info, "====>  Board Focal Length = " + std::to_string(focal_length) + ".");
+
+        const double kMinFocalLength = 2.0;
+        const double kMaxFocalLength = 50.0;
+        if (focal_length < kMinFocalLength || focal_length > kMaxFocalLength) {
+            GS_LOG_MSG(error, "GolfSimCalibration::MarkerCalibrateCamera computed invalid focal length: " +
+                std::to_string(focal_length) + " mm. Valid range is " +
+                std::to_string(kMinFocalLength) + " to " + std::to_string(kMaxFocalLength) +
+                " mm for typical camera lenses. Rejecting calibration.");
+            return false;
+        }
+
+        // As in DetermineCameraAngles, the camera angles are the difference between the angles
+        // to the board center from the LM's perspective and from the camera's
+        const double x_angle_degrees_camera_perspective = -CvUtils::RadiansToDegrees(atan(average_board_center[0] / average_board_center[2]));
+        const double y_angle_degrees_camera_perspective = CvUtils::RadiansToDegrees(atan(-average_board_center[1] /
+                                                              sqrt(pow(average_board_center[0], 2) + pow(average_board_center[2], 2))));
+
+        const cv::Vec2d lm_perspective_angles = ComputeLmPerspectiveAngles(board_center_position);
+
+        cv::Vec2d camera_angles(lm_perspective_angles[0] - x_angle_degrees_camera_perspective,
+                                lm_perspective_angles[1] - y_angle_degrees_camera_perspective);
+
+        const double kMaxReasonableAngle = 45.0;
+        if (std::abs(camera_angles[0]) > kMaxReasonableAngle || std::abs(camera_angles[1]) > kMaxReasonableAngle) {
+            GS_LOG_MSG(error, "GolfSimCalibration::MarkerCalibrateCamera computed invalid camera angles: " +
+                std::to_string(camera_angles[0]) + ", " + std::to_string(camera_angles[1]) +
+                " degrees. Rejecting calibration.");
+            return false;
+        }
+
+        GS_LOG_MSG(info, "====>  Board Camera Angles = " + std::to_string(camera_angles[0]) + ", " + std::to_string(camera_angles[1]) + ".");
+
+        camera_hardware.focal_length_ = (float)focal_length;
+
+        if (kMarkerCalibrationBallCrossCheck) {
+            GS_LOG_MSG(info, "Remove the calibration board and place a ball on the tee.  The cross-check picture will be taken in " +
+                             std::to_string(kMarkerCalibrationBallPlacementDelaySeconds) + " seconds.");
+            std::this_thread::sleep_for(std::chrono::seconds(std::max(0, kMarkerCalibrationBallPlacementDelaySeconds)));
+
+            BallImageProc* ip = BallImageProc::get_ball_image_processor();
+
+            if (ip == nullptr) {
+                GS_LOG_MSG(error, "Could not get_ball_image_processor().");
+                return false;
+            }
+
+            // The board's focal length should already be close
+            const double distance_direct_to_ball = CvUtils::GetDistance(kFinalAutoCalibrationBallPositionFromCameraMeters);
+            const double expected_radius = GolfSimCamera::GetExpectedBallRadiusPixelsUsingKnownFocalLength(camera_hardware, camera_hardware.resolution_x_, distance_direct_to_ball);
+            ip->min_ball_radius_ = int(expected_radius * 0.9);
+            ip->max_ball_radius_ = int(expected_radius * 1.1);
+
+            cv::Mat ball_image;
+            if (!GolfSimCamera::TakeStillPicture(camera, ball_image)) {
+                GS_LOG_MSG(error, "FAILED to TakeStillPicture");
+                return false;
+            }
+
+            LoggingTools::LogImage("", ball_image, std::vector < cv::Point >{}, true, "Marker_Autocalibration_Ball_Check_Image.png");
+
+            GolfBall ball;
+            const double ball_focal_length = DetermineFocalLengthForAutoCalibration(ball_image, camera, ball);
+
+            cv::Vec2d ball_camera_angles;
+            if (ball_focal_length < 0.0 || !DetermineCameraAngles(ball_image, camera, ball_camera_angles)) {
+                GS_LOG_MSG(error, "MarkerCalibrateCamera could not measure the cross-check ball.  Not saving the calibration.");
+                return false;
+            }
+
+            const double focal_length_difference = std::abs(ball_focal_length - focal_length) / focal_length;
+            const double angle_difference = std::max(std::abs(ball_camera_angles[0] - camera_angles[0]), std::abs(ball_camera_angles[1] - camera_angles[1]));
+
+            GS_LOG_MSG(info, "Cross-check ball gives a focal length of " + std::to_string(ball_focal_length) + " (" + std::to_string(100.0 * focal_length_difference) +
+                             "% off) and camera angles of " + std::to_string(ball_camera_angles[0]) + ", " + std::to_string(ball_camera_angles[1]) +
+                             " (up to " + std::to_string(angle_difference) + " degrees off).");
+
+            if (focal_length_difference > kMarkerCalibrationMaxFocalLengthDifference || angle_difference > kMarkerCalibrationMaxAngleDifferenceDegrees) {
+                GS_LOG_MSG(error, "MarkerCalibrateCamera - the board and the ball disagree.  Check where the board was placed (see kMarkerBoardCenterOffsetFromBallMeters).  Not saving the calibration.");
+                return false;
+            }
+        }
+
+        // Now save the values out to a .json file.  The web server gets them as one batch.
+        std::string camera_number_string = std::to_string(camera_number);
+
+        std::string focal_length_tag_name = "gs_config.cameras.kCamera" + camera_number_string + "FocalLength";
+        std::string camera_angles_tag_name = "gs_config.cameras.kCamera" + camera_number_string + "Angles";
+
+        GolfSimConfiguration::SetTreeValue(focal_length_tag_name, focal_length);
+        GolfSimConfiguration::SetTreeValue(camera_angles_tag_name, camera_angles);
+
+        WebApi::UpdateCalibration(focal_length_tag_name, focal_length);
+        WebApi::UpdateCalibration(camera_angles_tag_name, std::vector<double>{ camera_angles[0], camera_angles[1] });
+
+        if (!refined_distortion.empty()) {
+            std::string distortion_tag_name = "gs_config.cameras.kCamera" + camera_number_string + "DistortionVector";
+            std::vector<double> distortion_vector(refined_distortion.begin<double>(), refined_distortion.end<double>());
+
+            GS_LOG_MSG(info, "====>  Refined Distortion k1 = " + std::to_string(distortion_vector[0]) + ", k2 = " + std::to_string(distortion_vector[1]) + ".");
+
+            GolfSimConfiguration::SetTreeValue(distortion_tag_name, distortion_vector);
+            WebApi::UpdateCalibration(distortion_tag_name, distortion_vector);
+        }
+
+        return SaveCalibrationToConfigFile();
+    }
+
 }
 
 
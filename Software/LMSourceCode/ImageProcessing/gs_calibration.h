@@ -78,6 +78,42 @@ namespace golf_sim {
 		// occur a few times before giving up on the calibration process.
         static int kNumberOfCalibrationFailuresToTolerate;
 
+        // If set, the focal-length pictures are analyzed on a worker thread while the next one is
+        // being taken (camera 1 keeps streaming stills), and the images are written in the background.
+        static bool kPipelinedAutoCalibration;
+        // In the pipelined mode, the sampling stops early once the standard error of the average
+        // focal length is less than this fraction of it.  0 means always take every picture.
+        static double kFocalLengthConvergenceTolerance;
+
+        // The ChArUco board for MarkerCalibrateCamera: its size in squares, the square and marker
+        // sizes as printed, and its marker dictionary (e.g., DICT_5X5_100 or DICT_APRILTAG_36h11)
+        static int kMarkerBoardSquaresX;
+        static int kMarkerBoardSquaresY;
+        static double kMarkerBoardSquareLengthMeters;
+        static double kMarkerBoardMarkerLengthMeters;
+        static std::string kMarkerBoardDictionary;
+
+        // The board stands upright, facing the LM, where the calibration ball would be.  This is
+        // where its center is relative to that ball position (e.g., higher than the ball's center
+        // if the board stands on the mat), in the same axes.
+        static cv::Vec3d kMarkerBoardCenterOffsetFromBallMeters;
+
+        // Board pictures to average, and the fewest ChArUco corners that a picture must show
+        static int kMarkerCalibrationNumberOfPictures;
+        static int kMarkerCalibrationMinimumCorners;
+
+        // If set, the residual (after the current undistortion) radial distortion of the board
+        // pictures is folded into the camera's distortion vector, if it fits the corners better
+        static bool kMarkerCalibrationRefineDistortion;
+
+        // If set, a ball is placed on the tee (in place of the board) kMarkerCalibrationBallPlacementDelaySeconds
+        // after the board pictures, and the calibration is only saved if the focal length and camera angles
+        // that it gives agree with the board's to within the two tolerances
+        static bool kMarkerCalibrationBallCrossCheck;
+        static int kMarkerCalibrationBallPlacementDelaySeconds;
+        static double kMarkerCalibrationMaxFocalLengthDifference;   // Fraction of the focal length
+        static double kMarkerCalibrationMaxAngleDifferenceDegrees;
+
         // Used internally during calibration
         static cv::Vec3d kFinalAutoCalibrationBallPositionFromCameraMeters;
 
@@ -90,6 +126,10 @@ namespace golf_sim {
 
         static bool AutoCalibrateCamera(GsCameraNumber camera_number);
 
+        // Determines the same values as AutoCalibrateCamera (and optionally refines the distortion)
+        // from the pose of a ChArUco board in a few pictures, instead of from the ball in many.
+        static bool MarkerCalibrateCamera(GsCameraNumber camera_number);
+
         static bool RetrieveAutoCalibrationConstants(GsCameraNumber camera_number);
 
         static bool DetermineCameraAngles(const cv::Mat& color_image, const GolfSimCamera& camera, cv::Vec2d& camera_angles);
@@ -98,5 +138,23 @@ namespace golf_sim {
 		// The ball is the ball that the focal length was determined from
         static double DetermineFocalLengthForAutoCalibration(const cv::Mat& color_image, const GolfSimCamera& camera, GolfBall &ball);
 
+        // The pipelined version of the focal-length sampling loop in AutoCalibrateCamera.  Returns the
+        // sum of the successful samples, how many there were, and the last image that was used.
+        static bool SampleFocalLengthsPipelined(const GolfSimCamera& camera, int number_attempts,
+                                                double& focal_length_sum, int& number_samples, cv::Mat& last_image);
+
+    private:
+
+        // Sets up the camera to be calibrated, with the default (not the .json) focal length
+        static void InitCalibrationCamera(GsCameraNumber camera_number, GolfSimCamera& camera);
+
+        // The angles of a position (in the axes of kFinalAutoCalibrationBallPositionFromCameraMeters)
+        // from the center of the lens if the camera was pointing straight out
+        static cv::Vec2d ComputeLmPerspectiveAngles(const cv::Vec3d& position);
+
+        // Backs up the .json file, and then overwrites it with the configuration tree, to which
+        // the calibration values have already been set
+        static bool SaveCalibrationToConfigFile();
+
     };
 }
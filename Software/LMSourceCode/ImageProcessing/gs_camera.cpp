@@ -5,7 +5,15 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 #include "gs_options.h"
 #include "ball_image_proc.h"
@@ -18,7 +26,20 @@
 #include "libcamera_interface.h"
 
 #include "gs_camera.h"
+#include "gs_shot_analysis.h"
+#include "gs_session_settings.h"
+#include "gs_trajectory_fit.h"
+#include "gs_camera_intrinsics.h"
+#include "gs_exposure_predictor.h"
+#include "gs_metrics.h"
+#include "gs_trace_zones.h"
+#ifdef __unix__
+#include "gs_shared_memory.h"
+#endif
 #include "gs_web_api.h"
+#include "worker_thread.h"
+#include "gs_shot_trace.h"
+#include "gs_circle_grid_index.h"
 
 
 namespace golf_sim {
@@ -51,6 +72,9 @@ namespace golf_sim {
 
     int GolfSimCamera::kClosestBallPairEdgeBackoffPixels = 200;
 
+    int GolfSimCamera::kSpinMultiPairCount = 1;
+    int GolfSimCamera::kSpinMultiPairTimeBudgetMs = 0;
+
     double GolfSimCamera::kMaxIntermediateBallRadiusChangePercent = 10.0;
     double GolfSimCamera::kMaxPuttingIntermediateBallRadiusChangePercent = 10.0;
     double GolfSimCamera::kMaxOverlappedBallRadiusChangeRatio = 1.3;
@@ -93,8 +117,56 @@ namespace golf_sim {
     double GolfSimCamera::kStandardBallSpeedSlowdownPercentage = 0.5;
     double GolfSimCamera::kPracticeBallSpeedSlowdownPercentage = 2.0;
     double GolfSimCamera::kPuttingBallSpeedSlowdownPercentage = 5.0;
+    bool GolfSimCamera::kPuttingFastPath = false;
+    double GolfSimCamera::kPuttingFastPathDetectionScale = 0.5;
     bool GolfSimCamera::kCameraRequiresFlushPulse = false;
 
+    static std::mutex last_trigger_timing_mutex;
+    static GsTriggerTiming last_trigger_timing;
+
+    void GolfSimCamera::RecordTriggerTiming(const GsTriggerTiming& timing) {
+        std::lock_guard<std::mutex> lock(last_trigger_timing_mutex);
+        last_trigger_timing = timing;
+    }
+
+    GsTriggerTiming GolfSimCamera::GetLastTriggerTiming() {
+        std::lock_guard<std::mutex> lock(last_trigger_timing_mutex);
+        return last_trigger_timing;
+    }
+
+    bool GolfSimCamera::kUseMeasuredStrobeTiming = false;
+    int GolfSimCamera::kStrobeTimingToleranceUs = 300;
+
+    static std::mutex last_camera2_frame_timing_mutex;
+    static int64_t last_camera2_sensor_timestamp_ns = 0;
+    static int64_t last_camera2_exposure_time_us = 0;
+
+    void GolfSimCamera::RecordCamera2FrameTiming(int64_t sensor_timestamp_ns, int64_t exposure_time_us) {
+        std::lock_guard<std::mutex> lock(last_camera2_frame_timing_mutex);
+        last_camera2_sensor_timestamp_ns = sensor_timestamp_ns;
+        last_camera2_exposure_time_us = exposure_time_us;
+    }
+
+    GsStrobedFrameTiming GolfSimCamera::GetLastStrobedFrameTiming() {
+        GsStrobedFrameTiming timing;
+
+        {
+            std::lock_guard<std::mutex> lock(last_camera2_frame_timing_mutex);
+            timing.sensor_timestamp_ns = last_camera2_sensor_timestamp_ns;
+            timing.exposure_time_us = last_camera2_exposure_time_us;
+        }
+
+        PulseStrobe::GetLastStrobeWriteTimes(timing.strobe_write_start_ns, timing.strobe_write_end_ns);
+
+        // A frame from another shot would be seconds away from the strobes
+        constexpr int64_t kMaxFrameToStrobeNs = 1000000000;
+
+        timing.valid = timing.sensor_timestamp_ns > 0 && timing.exposure_time_us > 0 && timing.strobe_write_start_ns > 0 &&
+                       std::abs(timing.sensor_timestamp_ns - timing.strobe_write_start_ns) < kMaxFrameToStrobeNs;
+
+        return timing;
+    }
+
     int GolfSimCamera::kMaxBallsToRetain = 18;
 
     bool GolfSimCamera::kExternallyStrobedEnvFilterImage = true;
@@ -132,6 +204,7 @@ namespace golf_sim {
 
 
     bool GolfSimCamera::kUseOnlyHighQualityBallImagesForHLA = true;
+    bool GolfSimCamera::kUseStrobedTrajectoryFit = false;
 
 
     GolfSimCamera::GolfSimCamera() {
@@ -161,11 +234,17 @@ namespace golf_sim {
 
         GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kClosestBallPairEdgeBackoffPixels", kClosestBallPairEdgeBackoffPixels);
         GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kMaxBallsToRetain", kMaxBallsToRetain);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kSpinMultiPairCount", kSpinMultiPairCount);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kSpinMultiPairTimeBudgetMs", kSpinMultiPairTimeBudgetMs);
         
         GolfSimConfiguration::SetConstant("gs_config.strobing.kStandardBallSpeedSlowdownPercentage", kStandardBallSpeedSlowdownPercentage);
         GolfSimConfiguration::SetConstant("gs_config.strobing.kPracticeBallSpeedSlowdownPercentage", kPracticeBallSpeedSlowdownPercentage);
         GolfSimConfiguration::SetConstant("gs_config.strobing.kPuttingBallSpeedSlowdownPercentage", kPuttingBallSpeedSlowdownPercentage);
+        GolfSimConfiguration::SetConstant("gs_config.strobing.kPuttingFastPath", kPuttingFastPath);
+        GolfSimConfiguration::SetConstant("gs_config.strobing.kPuttingFastPathDetectionScale", kPuttingFastPathDetectionScale);
         GolfSimConfiguration::SetConstant("gs_config.strobing.kCameraRequiresFlushPulse", kCameraRequiresFlushPulse);
+        GolfSimConfiguration::SetConstant("gs_config.strobing.kUseMeasuredStrobeTiming", kUseMeasuredStrobeTiming);
+        GolfSimConfiguration::SetConstant("gs_config.strobing.kStrobeTimingToleranceUs", kStrobeTimingToleranceUs);
         
         /* TBD - InnoMaker cameras do not appear to need a flush image
         const CameraHardware::CameraModel  camera_model = GolfSimCamera::kSystemSlot2CameraType;
@@ -213,6 +292,7 @@ namespace golf_sim {
         GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kNumberAngleCheckExposures", kNumberAngleCheckExposures);
 
         GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kUsePreImageSubtraction", kUsePreImageSubtraction);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kUseStrobedTrajectoryFit", kUseStrobedTrajectoryFit);
 
         GolfSimConfiguration::SetConstant("gs_config.testing.kExternallyStrobedEnvFilterImage", kExternallyStrobedEnvFilterImage);
         GolfSimConfiguration::SetConstant("gs_config.testing.kExternallyStrobedEnvBottomIgnoreHeight", kExternallyStrobedEnvBottomIgnoreHeight);
@@ -321,18 +401,9 @@ namespace golf_sim {
             return 0;
         }
 
-        double magnification = camera_hardware.focal_length_ / distance;
-
-		double image_diameter_mm = magnification * (2 * GolfBall::kBallRadiusMeters);
-
-        double pixel_size_mm = camera_hardware.sensor_width_ / resolution_x_;
-
-		double image_diameter_pixels = image_diameter_mm / pixel_size_mm;
-
-        double radius = (image_diameter_pixels /2);
-
-        // Scale to our current resolution
-        int radius_as_integer = (int)std::round(image_diameter_pixels / 2.0);
+        // The magnification (focal length / distance) times the ball diameter, in pixels of
+        // this resolution, halved
+        int radius_as_integer = (int)std::round(GsCameraIntrinsics::ForCamera(camera_hardware).RadiusPixelsAtDistance(distance, resolution_x_));
             
         GS_LOG_TRACE_MSG(trace, "GetExpectedBallRadiusPixelsUsingKnownFocalLength returning: " + std::to_string(radius_as_integer));
 
@@ -422,7 +493,9 @@ namespace golf_sim {
 
         GS_LOG_TRACE_MSG(trace, "GetCalibratedBall");
 
-        BallImageProc* ip = BallImageProc::get_ball_image_processor();
+        // The search radii, mask and image name are per-call state, so each call has its own processor
+        BallImageProc ball_image_proc;
+        BallImageProc* ip = &ball_image_proc;
         ip->image_name_ = "Calibration Photo";
 
         if (rgbImg.empty()) {
@@ -576,6 +649,8 @@ namespace golf_sim {
 
         // We were able to discern a circle that the system thinks is a ball - return the ball with the information corresponding to it inside
 
+        BallImageProc::RefineBallRadiusSubpixel(rgbImg, b);
+
         // Setup a ball to return with all the pertinent information
         b.measured_radius_pixels_ = b.ball_circle_[2];
 
@@ -606,16 +681,29 @@ namespace golf_sim {
 
             return true;
         }
-        else {
-            distance_direct_to_ball = ComputeDistanceToBallUsingRadius(camera, b);
-            b.distance_to_z_plane_from_lens_ = distance_direct_to_ball;
+
+        if (!ComputeCalibratedBallPosition(camera, b)) {
+            return false;
         }
 
+        GetBallColorInformation(rgbImg, b);
+
+        b.calibrated = true;
+
+        GS_LOG_TRACE_MSG(trace, "Calibrated Ball Results: " + b.Format());
+
+        return true;
+    }
+
+    bool GolfSimCamera::ComputeCalibratedBallPosition(const GolfSimCamera& camera, GolfBall& b) {
+
+        // Directly to the ball, not just along the Z axis
+        const double distance_direct_to_ball = ComputeDistanceToBallUsingRadius(camera, b);
+        b.distance_to_z_plane_from_lens_ = distance_direct_to_ball;
+
         // Make sure all the related ball elements are set consistently
         b.set_circle(b.ball_circle_);
 
-        cv::Vec2d camera_angles = camera.camera_hardware_.camera_angles_;
-
         // The golf ball may not be centered in the frame of the camera.  Determine the angle at which
         // the ball sits so that it can be taken into account for, e.g., ball rotation perspectives
 
@@ -628,22 +716,21 @@ namespace golf_sim {
             return false;
         }
 
-        GetBallColorInformation(rgbImg, b);
-
         b.distance_at_calibration_ = distance_direct_to_ball;
         // The measured radius may change later, so save the current one now
         b.radius_at_calibration_pixels_ = (float)b.measured_radius_pixels_;
 
-        b.calibrated = true;
-
-        GS_LOG_TRACE_MSG(trace, "Calibrated Ball Results: " + b.Format());
-
         return true;
     }
 
 
     void GolfSimCamera::GetBallColorInformation(const cv::Mat& color_image, GolfBall& b) {
-        std::vector<GsColorTriplet> stats = CvUtils::GetBallColorRgb(color_image, b.ball_circle_);
+        GsColorStatistics color_statistics(color_image, std::vector<GsCircle>{});
+        GetBallColorInformation(color_statistics, b);
+    }
+
+    void GolfSimCamera::GetBallColorInformation(const GsColorStatistics& color_statistics, GolfBall& b) {
+        std::vector<GsColorTriplet> stats = color_statistics.GetBallColorRgb(b.ball_circle_);
         b.average_color_ = stats[0];
         b.median_color_ = stats[1];
         b.std_color_ = stats[2];
@@ -774,7 +861,9 @@ namespace golf_sim {
             // TBD - will copy work on a ball yet ?
             foundBall = calibrated_ball;
 
-            BallImageProc *ip = BallImageProc::get_ball_image_processor();
+            // Per-call search state - see GetCalibratedBall
+            BallImageProc ball_image_proc;
+            BallImageProc* ip = &ball_image_proc;
 
             LoggingTools::DebugShowImage("GolfSimCamera::GetCurrentBallLocation input: ", rgbImg);
 
@@ -917,21 +1006,17 @@ namespace golf_sim {
             
             // Could reasonably do this with either height or width parameters for the sensors that we are using,
             // but for at least the GS camera, the "correct" divisor is the X axis, not Y.
-            return ( ball_distance_meters * camera.camera_hardware_.sensor_width_ * ((2.0 * ball_radius_pixels) / camera.camera_hardware_.resolution_x_ ) / (2.0*GolfBall::kBallRadiusMeters));
+            return GsCameraIntrinsics::ForCamera(camera.camera_hardware_).FocalLengthFromBall(ball_radius_pixels, ball_distance_meters);
         }
 
         double GolfSimCamera::convertXDistanceToMeters(const GolfSimCamera& camera, double zDistanceMeters, double xDistancePixels) {
             // Note that we are NOT using the calibrated_focal_length
-            double halfWidthMeters = (zDistanceMeters / camera.camera_hardware_.focal_length_) * (camera.camera_hardware_.sensor_width_ / 2.0);
-            double xDistanceMeters = halfWidthMeters * (xDistancePixels / (camera.camera_hardware_.resolution_x_ / 2.0));
-            return (xDistanceMeters);
+            return GsCameraIntrinsics::ForCamera(camera.camera_hardware_).MetersX(zDistanceMeters, xDistancePixels);
         }
 
         double GolfSimCamera::convertYDistanceToMeters(const GolfSimCamera& camera, double zDistanceMeters, double yDistancePixels) {
             // Note that we are NOT using the calibrated_focal_length
-            double halfHeightMeters = (zDistanceMeters / camera.camera_hardware_.focal_length_) * (camera.camera_hardware_.sensor_height_/2.0);
-            double yDistanceMeters = halfHeightMeters * (yDistancePixels / (camera.camera_hardware_.resolution_y_ / 2.0));
-            return (yDistanceMeters);
+            return GsCameraIntrinsics::ForCamera(camera.camera_hardware_).MetersY(zDistanceMeters, yDistancePixels);
         }
 
         double GolfSimCamera::ComputeDistanceToBallUsingRadius(const GolfSimCamera& camera, const GolfBall& ball) {
@@ -1134,82 +1219,19 @@ namespace golf_sim {
                 return false;
             }
 
-            // First calculate the distances as if the camera was facing straight ahead toward 
-            // the ball flight plane
-
-            double xFromCameraCenter = b1.x() - std::round(camera.camera_hardware_.resolution_x_ / 2.0);
-            double yFromCameraCenter = b1.y() - std::round(camera.camera_hardware_.resolution_y_ / 2.0);
-
-            cv::Vec3d camera_perspective_distances;
-
-            // Direct-to-ball-PLANE distance is already in real-world meters.   
-            // However, we do not have the exact direct-to-ball distance due to the lens.
-            // We will figure out the Z axis distance (which will generally be a little shorter) first.
-            double xDistanceFromCamCenter = convertXDistanceToMeters(camera, b1.distance_to_z_plane_from_lens_, xFromCameraCenter);
-            camera_perspective_distances[0] = xDistanceFromCamCenter;  // X distance, negative means to the left of the camera
-            
-            double yDistanceFromCamCenter = convertYDistanceToMeters(camera, b1.distance_to_z_plane_from_lens_, yFromCameraCenter);
-
-            camera_perspective_distances[1] = -yDistanceFromCamCenter;  // Y distance, positive is upward (smaller Y values)  // TBD - sqrt(pow(b1.distance_to_z_plane_from_lens_, 2) - pow(yDistanceFromCamCenter, 2));  // Y distance.  Positive values are above the camera center
-
-            camera_perspective_distances[2] = b1.distance_to_z_plane_from_lens_;// FOR NON_DIRECT sqrt(pow(b1.distance_to_z_plane_from_lens_, 2) - pow(xDistanceFromCamCenter, 2));  // Z distance.  Only positive values in front of camera
-
-            GS_LOG_TRACE_MSG(trace, "GolfSimCamera::ComputeXyzDistanceFromOrthoCamPerspective computed camera_perspective_distances of: " +
-                std::to_string(camera_perspective_distances[0]) + ", " +
-                std::to_string(camera_perspective_distances[1]));
-
-            // If the camera were pointed straight out, the above is all we would need to have in 
-            // order to compute the x,y,z position of the ball.  The ball would be at the same z-distance,
-            // and the x and y distances would just have to be added/subtracted to the point in space
-            // directly out from the camera.
-            // 
-            // However, because the camera is at an angle, we need to convert the x,y,z distances from the
-            // camera's perspective into x,y,z from a perspective that is orthogonal to the launch monitor.
-            // This will entail a polar (or spherical) coordinate system to a cartesian (x,y,z) conversion
-            // So, Convert the distances from the camera into a set of angles from the camera's perspective
-
-            // Using the adjusted X and Y distances (lined up with the real world up/down and left/right),
-            // determine the angles of the ball from the camera perspective
-            // Positive X degrees is to the left looking out the camera
-            // Negative Y degrees is tilting down looking out the camera
-            cv::Vec2d deltaAnglesCameraPerspective;
-            deltaAnglesCameraPerspective[0] = -CvUtils::RadiansToDegrees(atan(camera_perspective_distances[0] / b1.distance_to_z_plane_from_lens_));
-            deltaAnglesCameraPerspective[1] = CvUtils::RadiansToDegrees(atan(camera_perspective_distances[1] / b1.distance_to_z_plane_from_lens_));
-
-            // Account for the angle of the camera, which will adjust the camera perspective angles
-            // to the real-world orthogonal-to-the-LM-perspective polar coordinates.
-            // X angle here is positive in a counter-clockwise movement looking down at the LM from above
-            // Y angle is negative as the azimuth angle goes down from horizontal
-            cv::Vec2d deltaAnglesLMPerspective;
-            deltaAnglesLMPerspective[0] = camera.camera_hardware_.camera_angles_[0] + deltaAnglesCameraPerspective[0] ;
-            deltaAnglesLMPerspective[1] = camera.camera_hardware_.camera_angles_[1] + deltaAnglesCameraPerspective[1];
-
-            GS_LOG_TRACE_MSG(trace, "GolfSimCamera::ComputeXyzDistanceFromOrthoCamPerspective computed (LM-perspective) X,Y angles of: " + 
-                                        std::to_string(deltaAnglesLMPerspective[0]) + ", " +
-                                        std::to_string(deltaAnglesLMPerspective[1]));
-
-            // Second, figure out the X, Y, and Z distances from the LM's perspective
-            // Theta is the rotation in the floor plane
-            // Phi is the rotation down/away from the vertical
-            // This is essentially a polar-coordinate system to cartesian system conversion
+            // First, the distances as if the camera was facing straight ahead toward the ball
+            // flight plane.  Then, because the camera is at an angle, the ball's angles from the
+            // camera's bore line are added to the camera angles, and the resulting spherical
+            // coordinates (rho being the distance to the ball plane) are converted into x,y,z
+            // from a perspective that is orthogonal to the launch monitor.
             // See https://math.libretexts.org/Courses/Mount_Royal_University/MATH_2200%3A_Calculus_for_Scientists_II/7%3A_Vector_Spaces/5.7%3A_Cylindrical_and_Spherical_Coordinates#:~:text=To%20convert%20a%20point%20from,y2%2Bz2).
+            //
+            // The camera's trigonometry and inverse intrinsics are computed once per camera
+            // (see GsCameraIntrinsics), so that this is only a handful of multiplies.
+            GsCameraIntrinsics::ForCamera(camera.camera_hardware_).ComputeBallPosition(b1.x(), b1.y(), b1.distance_to_z_plane_from_lens_, distances);
 
-            double phi_radians = CvUtils::DegreesToRadians( 90. + deltaAnglesLMPerspective[1] );
-            double p_rho = camera_perspective_distances[2];
-            double theta_radians = CvUtils::DegreesToRadians(deltaAnglesLMPerspective[0]);
-            // Intermediate results for precision testing - ignore
-            double sin_phi = sin(phi_radians);
-            double cos_theta = cos(theta_radians);
-            double sin_theta = sin(theta_radians);
-
-            double cartesian_x = p_rho * sin(phi_radians) * cos(theta_radians);
-            double cartesian_y = p_rho * sin(phi_radians) * sin(theta_radians);
-            double cartesian_z = p_rho * cos(phi_radians);
-
-            // Convert from the model cartesian system into the one used by the launch monitor
-            distances[0] = -cartesian_y;
-            distances[1] = -cartesian_z;
-            distances[2] = cartesian_x;
+            GS_LOG_TRACE_MSG(trace, "GolfSimCamera::ComputeXyzDistanceFromOrthoCamPerspective computed distances of: " +
+                std::to_string(distances[0]) + ", " + std::to_string(distances[1]) + ", " + std::to_string(distances[2]));
 
             return true;
         }
@@ -1286,19 +1308,15 @@ namespace golf_sim {
                                             const int second_ball_index ) {
 
             // It's expensive to clone an image, so make sure we're here to do at least something
-            if (!log_image_to_file && 
-                !GolfSimOptions::GetCommandLineOptions().show_images_ && 
-                GolfSimOptions::GetCommandLineOptions().artifact_save_level_ != ArtifactSaveLevel::kAll) {
+            if (!WillShowOrLogBalls(log_image_to_file)) {
                 return true;
             }
 
-            cv::Mat ball_image = img.clone();
-
             // Outline the final candidates for this image 
-            for (size_t i = 0; i < balls.size(); i++) {
-                GolfBall& b = balls[i];
-                GsCircle& c = b.ball_circle_;
+            std::vector<GsImageWriter::CircleAnnotation> annotations;
+            annotations.reserve(balls.size());
 
+            for (size_t i = 0; i < balls.size(); i++) {
                 std::string label;
 
                 if (i == (size_t)middle_ball_index) {
@@ -1310,21 +1328,38 @@ namespace golf_sim {
                     label = std::to_string(i);
                 }
 
-                LoggingTools::DrawCircleOutlineAndCenter(ball_image, c, label);
+                annotations.push_back(GsImageWriter::CircleAnnotation{ balls[i].ball_circle_, label });
             }
 
-            LoggingTools::DebugShowImage(title, ball_image);
+            // Only an image that will be shown needs to be drawn now.  Otherwise, the image
+            // writer will draw the annotations on its own copy, off of this thread.
+            if (LoggingTools::DisplayIntermediateImages()) {
+                cv::Mat ball_image = img.clone();
+
+                for (const auto& annotation : annotations) {
+                    LoggingTools::DrawCircleOutlineAndCenter(ball_image, annotation.circle, annotation.label);
+                }
+
+                LoggingTools::DebugShowImage(title, ball_image);
+            }
 
             if (log_image_to_file && GolfSimOptions::GetCommandLineOptions().artifact_save_level_ == ArtifactSaveLevel::kAll) {
-                LoggingTools::LogImage("", ball_image, std::vector < cv::Point >{}, true, title + ".png");
+                LoggingTools::LogAnnotatedImage("", img, std::move(annotations), true, title + ".png");
             }
 
             return true;
         }
 
+        bool GolfSimCamera::WillShowOrLogBalls(const bool log_image_to_file) {
+
+            return (log_image_to_file ||
+                    GolfSimOptions::GetCommandLineOptions().show_images_ ||
+                    GolfSimOptions::GetCommandLineOptions().artifact_save_level_ == ArtifactSaveLevel::kAll);
+        }
+
         void GolfSimCamera::SortBallsByXPosition(std::vector<GolfBall>& balls) {
 
-            if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kRightHanded) {
+            if (GsAnalysisContext::GolferHandedness() == GolferOrientation::kRightHanded) {
                 std::sort(balls.begin(), balls.end(), [](const GolfBall& a, const GolfBall& b)
                     { return (a.x() < b.x()); });
             }
@@ -1535,22 +1570,118 @@ namespace golf_sim {
             return numerator / denominator;
         }
 
+        void GolfSimCamera::BuildCandidateTable(const std::vector<GolfBall>& balls, BallCandidateTable& table) {
+
+            const size_t number_balls = balls.size();
+
+            table.x.resize(number_balls);
+            table.y.resize(number_balls);
+            table.circle_x.resize(number_balls);
+            table.circle_y.resize(number_balls);
+            table.radius.resize(number_balls);
+            table.quality_ranking.resize(number_balls);
+            table.model_detected.resize(number_balls);
+
+            table.has_color_statistics.assign(number_balls, 0);
+            table.average_color.resize(number_balls);
+            table.median_color.resize(number_balls);
+            table.std_color.resize(number_balls);
+
+            table.rejected.assign(number_balls, 0);
+            table.order.resize(number_balls);
+
+            for (size_t i = 0; i < number_balls; i++) {
+                const GolfBall& b = balls[i];
+
+                table.x[i] = b.x();
+                table.y[i] = b.y();
+                table.circle_x[i] = CvUtils::CircleX(b.ball_circle_);
+                table.circle_y[i] = CvUtils::CircleY(b.ball_circle_);
+                table.radius[i] = b.measured_radius_pixels_;
+                table.quality_ranking[i] = b.quality_ranking;
+                table.model_detected[i] = (b.ball_color_ == GolfBall::BallColor::kModelDetected);
+                table.order[i] = (int)i;
+            }
+        }
+
+        GolfBall GolfSimCamera::MaterializeCandidate(const std::vector<GolfBall>& balls, const BallCandidateTable& table, const int row) {
+
+            GolfBall b = balls[row];
+
+            // Model-detected balls already got their color information before filtering
+            if (table.has_color_statistics[row] && !table.model_detected[row]) {
+                b.average_color_ = table.average_color[row];
+                b.std_color_ = table.std_color[row];
+            }
+
+            return b;
+        }
+
+        void GolfSimCamera::MaterializeCandidates(const std::vector<GolfBall>& balls,
+                                                  const BallCandidateTable& table,
+                                                  std::vector<GolfBall>& survivors) {
+
+            std::vector<GolfBall> result;
+            result.reserve(table.order.size());
+
+            for (const int row : table.order) {
+                result.push_back(MaterializeCandidate(balls, table, row));
+            }
+
+            survivors = std::move(result);
+        }
+
+        void GolfSimCamera::ComputeCandidateColorStatistics(const GsColorStatistics& color_statistics,
+                                                            const std::vector<GolfBall>& balls,
+                                                            BallCandidateTable& table,
+                                                            const int row) {
+
+            if (table.has_color_statistics[row]) {
+                return;
+            }
+
+            std::vector<GsColorTriplet> statistics = color_statistics.GetBallColorRgb(balls[row].ball_circle_);
+
+            table.average_color[row] = statistics[0];
+            table.median_color[row] = statistics[1];
+            table.std_color[row] = statistics[2];
+            table.has_color_statistics[row] = 1;
+        }
+
+        void GolfSimCamera::CompactCandidates(BallCandidateTable& table) {
+
+            std::erase_if(table.order, [&table](const int row) { return table.rejected[row] != 0; });
+        }
+
+        void GolfSimCamera::SortCandidatesByXPosition(BallCandidateTable& table) {
+
+            if (GsAnalysisContext::GolferHandedness() == GolferOrientation::kRightHanded) {
+                std::sort(table.order.begin(), table.order.end(), [&table](const int a, const int b)
+                    { return (table.x[a] < table.x[b]); });
+            }
+            else {
+                std::sort(table.order.begin(), table.order.end(), [&table](const int a, const int b)
+                    { return (table.x[a] > table.x[b]); });
+            }
+        }
+
         void GolfSimCamera::RemoveLowScoringBalls(std::vector<GolfBall>& balls, const int max_balls_to_retain) {
 
-            int adjusted_max_balls_to_retain = max_balls_to_retain;
+            BallCandidateTable table;
+            BuildCandidateTable(balls, table);
+            FilterLowScoringCandidates(table, max_balls_to_retain);
+            MaterializeCandidates(balls, table, balls);
+        }
+
+        void GolfSimCamera::FilterLowScoringCandidates(BallCandidateTable& table, const int max_balls_to_retain) {
 
-            if (adjusted_max_balls_to_retain >= (int)balls.size()) {
+            if (max_balls_to_retain >= (int)table.order.size()) {
                 GS_LOG_TRACE_MSG(trace, "RemoveLowScoringBalls asked to remove more balls than were identified.  max_balls_to_retain= " + 
-                                    std::to_string(max_balls_to_retain) + ", but only have " + std::to_string(balls.size()) + " balls.");
+                                    std::to_string(max_balls_to_retain) + ", but only have " + std::to_string(table.order.size()) + " balls.");
                 return;
             }
 
-            int original_number_balls = (int)balls.size();
-            int ball_to_delete = original_number_balls - 1;
-            for (int i = 0; i < original_number_balls - adjusted_max_balls_to_retain; i++) {
-                balls.erase(balls.begin() + ball_to_delete);
-                ball_to_delete--;
-            }
+            table.order.resize(max_balls_to_retain);
         }
 
 
@@ -1559,7 +1690,20 @@ namespace golf_sim {
                                                             const double max_overlapped_ball_radius_change_ratio,
                                                             const bool preserve_high_quality_balls) {
 
-            if (initial_balls.size() < 3) {
+            BallCandidateTable table;
+            BuildCandidateTable(initial_balls, table);
+            FilterUnlikelyRadiusChangeCandidates(table, max_change_percent, max_overlapped_ball_radius_change_ratio, preserve_high_quality_balls);
+            MaterializeCandidates(initial_balls, table, initial_balls);
+        }
+
+        void GolfSimCamera::FilterUnlikelyRadiusChangeCandidates(BallCandidateTable& table,
+                                                                 const double max_change_percent,
+                                                                 const double max_overlapped_ball_radius_change_ratio,
+                                                                 const bool preserve_high_quality_balls) {
+
+            std::vector<int>& order = table.order;
+
+            if (order.size() < 3) {
                 GS_LOG_TRACE_MSG(trace, "GolfSimCamera::RemoveUnlikelyRadiusChangeBalls found too few (< 3) balls.  Not processing anything.");
                 return;
             }
@@ -1567,14 +1711,31 @@ namespace golf_sim {
             // We should never drop the <n> best balls
             uint kNumberHighQualityBallsToRetain_ = 2;
 
-            // Identify any balls that are outside the expected radius range by retaining them only in the initial ball vector
-            for (int i = (int)initial_balls.size() - 3; i >= 0; i--) {
-                double b1_radius = initial_balls[i].measured_radius_pixels_;
-                double b2_radius = initial_balls[i + 1].measured_radius_pixels_;
-                double b3_radius = initial_balls[i + 2].measured_radius_pixels_;
+            auto pixel_distance = [&table](const int row1, const int row2) {
+                double x_distance = std::abs(table.circle_x[row1] - table.circle_x[row2]);
+                double y_distance = std::abs(table.circle_y[row1] - table.circle_y[row2]);
+                return std::sqrt(x_distance * x_distance + y_distance * y_distance);
+            };
+
+            // Each triple depends on which of the balls to its right survived, so this
+            // filter has to edit the order as it goes
+            for (int i = (int)order.size() - 3; i >= 0; i--) {
+
+                // Removing both outer balls of the prior triple can leave fewer than three balls from here
+                if (i + 2 >= (int)order.size()) {
+                    continue;
+                }
+
+                const int left_row = order[i];
+                const int middle_row = order[i + 1];
+                const int right_row = order[i + 2];
+
+                double b1_radius = table.radius[left_row];
+                double b2_radius = table.radius[middle_row];
+                double b3_radius = table.radius[right_row];
 
-                double middle_to_right_ball_proximity_pixels = initial_balls[i + 1].PixelDistanceFromBall(initial_balls[i + 2]);
-                double middle_to_left_ball_proximity_pixels = initial_balls[i].PixelDistanceFromBall(initial_balls[i + 1]);
+                double middle_to_right_ball_proximity_pixels = pixel_distance(middle_row, right_row);
+                double middle_to_left_ball_proximity_pixels = pixel_distance(left_row, middle_row);
 
                 double  middle_to_right_distance_adjustment = (middle_to_right_ball_proximity_pixels / 150.0) / 100.0;
                 double  middle_to_left_distance_adjustment = (middle_to_left_ball_proximity_pixels / 150.0) / 100.0;
@@ -1584,9 +1745,9 @@ namespace golf_sim {
                     (b2_radius < (b1_radius * (1.0 - max_change_percent / 100. - middle_to_left_distance_adjustment)) &&
                         b2_radius < (b3_radius * (1.0 - max_change_percent / 100. - middle_to_right_distance_adjustment))) ) {
 
-                    if (initial_balls[i + 1].quality_ranking >= kNumberHighQualityBallsToRetain_) {
+                    if (table.quality_ranking[middle_row] >= kNumberHighQualityBallsToRetain_) {
                         GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls removing ball " + std::to_string(i + 1) + " because it was too much smaller/larger than both adjacent balls.");
-                        initial_balls.erase(initial_balls.begin() + i + 1);
+                        order.erase(order.begin() + i + 1);
                     }
                     else {
                         GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls NOT removing ball " + std::to_string(i + 1) + " because although it was larger than both adjacent balls, it was a high-quality circle.");
@@ -1608,10 +1769,10 @@ namespace golf_sim {
                         // The right-most ball shouldn't have changed in size this much when
                         // it hasn't moved very far.  Likely it's a mis-identification
                         if (right_radius_change > max_overlapped_ball_radius_change_ratio * left_radius_change) {
-                            if (initial_balls[i + 2].quality_ranking >= kNumberHighQualityBallsToRetain_ ||
+                            if (table.quality_ranking[right_row] >= kNumberHighQualityBallsToRetain_ ||
                                 preserve_high_quality_balls == false) {
                                 GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls removing ball " + std::to_string(i + 2) + " because it was much larger/smaller than the ball it overlaps.");
-                                initial_balls.erase(initial_balls.begin() + i + 2);
+                                order.erase(order.begin() + i + 2);
                             }
                         }
                     }
@@ -1624,10 +1785,10 @@ namespace golf_sim {
                         // The left-most ball shouldn't have changed in size this much when
                         // it hasn't moved very far.  Likely it's a mis-identification
                         if (left_radius_change > max_overlapped_ball_radius_change_ratio * right_radius_change) {
-                            if (initial_balls[i].quality_ranking > kNumberHighQualityBallsToRetain_ - 1 ||
+                            if (table.quality_ranking[left_row] > kNumberHighQualityBallsToRetain_ - 1 ||
                                 preserve_high_quality_balls == false) {
                                 GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls removing ball " + std::to_string(i) + " because it was much larger/smaller than the ball it overlaps.");
-                                initial_balls.erase(initial_balls.begin() + i);
+                                order.erase(order.begin() + i);
                             }
                         }
                     }
@@ -1641,28 +1802,39 @@ namespace golf_sim {
                                                      const GolfBall& best_ball,
                                                      const GolfBall& second_best_ball ) {
 
-            if (initial_balls.size() < 1) {
+            BallCandidateTable table;
+            BuildCandidateTable(initial_balls, table);
+            FilterOffTrajectoryCandidates(table, max_distance_from_trajectory, best_ball, second_best_ball);
+            MaterializeCandidates(initial_balls, table, initial_balls);
+        }
+
+        void GolfSimCamera::FilterOffTrajectoryCandidates(BallCandidateTable& table,
+                                                          const double max_distance_from_trajectory,
+                                                          const GolfBall& best_ball,
+                                                          const GolfBall& second_best_ball) {
+
+            if (table.order.size() < 1) {
                 GS_LOG_TRACE_MSG(warning, "RemoveOffTrajectoryBalls - balls vector was empty.  Exiting function.");
                 return;
             }
 
             // Identify any balls that are far from the projected trajectory
-            for (int i = (int)initial_balls.size() - 1; i >= 0; i--) {
-                GolfBall& b = initial_balls[i];
+            for (const int row : table.order) {
 
                 // Don't both examining the two balls we're using to draw the trajectory line
-                if (b.quality_ranking == best_ball.quality_ranking ||
-                    b.quality_ranking == second_best_ball.quality_ranking ) {
+                if (table.quality_ranking[row] == best_ball.quality_ranking ||
+                    table.quality_ranking[row] == second_best_ball.quality_ranking ) {
                     continue;
                 }
 
-                double ball_distance = GetPerpendicularDistanceFromLine(b.x(), b.y(), best_ball.x(), best_ball.y(), second_best_ball.x(), second_best_ball.y());
+                double ball_distance = GetPerpendicularDistanceFromLine(table.x[row], table.y[row], best_ball.x(), best_ball.y(), second_best_ball.x(), second_best_ball.y());
 
                 if (ball_distance > max_distance_from_trajectory) {
-                    // GS_LOG_TRACE_MSG(trace, "Not analyzing ball " + std::to_string(i) + " due to it having off - trajectory distance of : " + std::to_string(ball_distance));
-                    initial_balls.erase(initial_balls.begin() + i);
+                    table.rejected[row] = 1;
                 }
             }
+
+            CompactCandidates(table);
         }
 
 
@@ -1670,43 +1842,106 @@ namespace golf_sim {
                                                          const double max_ball_proximity,
                                                          const int max_quality_difference) {
 
-            if (initial_balls.size() < 1) {
+            BallCandidateTable table;
+            BuildCandidateTable(initial_balls, table);
+            FilterNearbyPoorQualityCandidates(table, max_ball_proximity, max_quality_difference);
+            MaterializeCandidates(initial_balls, table, initial_balls);
+        }
+
+        void GolfSimCamera::FilterNearbyPoorQualityCandidates(BallCandidateTable& table,
+                                                              const double max_ball_proximity,
+                                                              const int max_quality_difference) {
+
+            std::vector<int>& order = table.order;
+
+            if (order.size() < 1) {
                 GS_LOG_TRACE_MSG(warning, "RemoveNearbyPoorQualityBalls - balls vector was empty.  Exiting function.");
                 return;
             }
 
             // Examine each of the search balls and remove any other balls that are both
-            // much worse in quality and nearby the search ball
+            // much worse in quality and nearby the search ball.
+            // Positions (i and outer_index) are positions in the order that the balls would have
+            // if each removal were erased right away, even though removals are only marked.
+
+            const std::vector<int> order_copy = order;
+            const int number_balls = (int)order_copy.size();
+
+            GsCircleGridIndex ball_index(max_ball_proximity);
+
+            // A Fenwick tree over the not-yet-removed balls, so that a ball's current position
+            // (the number of balls still ahead of it) is quick to find
+            std::vector<int> remaining_balls_tree(number_balls + 1, 0);
+
+            auto update_remaining = [&](int k, const int delta) {
+                for (k++; k <= number_balls; k += k & -k) {
+                    remaining_balls_tree[k] += delta;
+                }
+            };
+            auto count_remaining_before = [&](int k) {
+                int count = 0;
+                for (; k > 0; k -= k & -k) {
+                    count += remaining_balls_tree[k];
+                }
+                return count;
+            };
+
+            for (int k = 0; k < number_balls; k++) {
+                ball_index.Insert(k, table.circle_x[order_copy[k]], table.circle_y[order_copy[k]]);
+                update_remaining(k, 1);
+            }
+
+            std::vector<int> nearby_balls;
+
+            for (int outer_index = 0; outer_index < number_balls; outer_index++) {
+
+                const int current_row = order_copy[outer_index];
 
-            std::vector<GolfBall> balls_copy = initial_balls;
+                nearby_balls.clear();
+                ball_index.GetNearbyIds(table.circle_x[current_row], table.circle_y[current_row], max_ball_proximity, nearby_balls);
 
-            for (size_t outer_index = 0; outer_index < balls_copy.size(); outer_index++) {
+                // Go from the back to the front, so that a removal does not change the position
+                // of any of the balls that are still to be looked at
+                std::sort(nearby_balls.begin(), nearby_balls.end(), std::greater<int>());
 
-                GolfBall& current_ball = balls_copy[outer_index];
+                for (const int k : nearby_balls) {
+                    const int i = count_remaining_before(k);
 
-                for (int i = (int)initial_balls.size() - 1; i > (int)outer_index; i--) {
-                    GolfBall& b = initial_balls[i];
+                    if (i <= outer_index) {
+                        continue;
+                    }
 
-                    double ball_distance = current_ball.PixelDistanceFromBall(b);
+                    const int row = order_copy[k];
+
+                    double x_distance = std::abs(table.circle_x[current_row] - table.circle_x[row]);
+                    double y_distance = std::abs(table.circle_y[current_row] - table.circle_y[row]);
+                    double ball_distance = std::sqrt(x_distance * x_distance + y_distance * y_distance);
                     
                     // NCNN detections lack HoughCircles quality scores, so use spatial ordering as a proxy
                     int quality_difference;
-                    if (b.ball_color_ == GolfBall::BallColor::kModelDetected &&
-                        current_ball.ball_color_ == GolfBall::BallColor::kModelDetected) {
+                    if (table.model_detected[row] && table.model_detected[current_row]) {
 
-                        quality_difference = std::abs(i - (int)outer_index); // Position difference in sorted list
+                        quality_difference = std::abs(i - outer_index); // Position difference in sorted list
                     } else {
                         // Legacy HoughCircles quality ranking
-                        quality_difference = b.quality_ranking - current_ball.quality_ranking;
+                        quality_difference = table.quality_ranking[row] - table.quality_ranking[current_row];
                     }
 
                     if (ball_distance < max_ball_proximity && quality_difference > max_quality_difference) {
                         GS_LOG_TRACE_MSG(trace, "Not analyzing ball " + std::to_string(i) + " due to its proximity of : " 
                                     + std::to_string(ball_distance) + " and quality difference of " + std::to_string(quality_difference));
-                        initial_balls.erase(initial_balls.begin() + i);
+                        ball_index.Remove(k);
+                        update_remaining(k, -1);
                     }
                 }
             }
+
+            order.clear();
+            for (int k = 0; k < number_balls; k++) {
+                if (!ball_index.IsRemoved(k)) {
+                    order.push_back(order_copy[k]);
+                }
+            }
         }
 
         bool GolfSimCamera::BallIsInBallVector(const GolfBall& search_ball, const GsBallsAndTimingVector& ball_vector) {
@@ -1786,7 +2021,7 @@ namespace golf_sim {
 
                         // The ground can cause a lot of bounch up & down on the balls, so
                         // make sure we don't get rid of a good ball just because it moved a bit.
-                        if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
+                        if (GsAnalysisContext::ClubType() == GolfSimClubs::kPutter) {
                             kMaximumOffTrajectoryDistance_ = 23;
                         }
 
@@ -1931,66 +2166,86 @@ namespace golf_sim {
 
         void GolfSimCamera::RemoveUnlikelyAngleLowerQualityBalls(std::vector<GolfBall>& initial_balls) {
 
+            BallCandidateTable table;
+            BuildCandidateTable(initial_balls, table);
+            FilterUnlikelyAngleLowerQualityCandidates(table);
+            MaterializeCandidates(initial_balls, table, initial_balls);
+        }
+
+        void GolfSimCamera::FilterUnlikelyAngleLowerQualityCandidates(BallCandidateTable& table) {
+
             // Note - the balls must have been ordered in quality order before calling this method.
 
             GS_LOG_TRACE_MSG(trace, "GolfSimCamera::RemoveUnlikelyAngleLowerQualityBalls");
 
-            if (initial_balls.size() < 2) {
+            std::vector<int>& order = table.order;
+
+            if (order.size() < 2) {
                 GS_LOG_TRACE_MSG(warning, "initial_balls vector was empty or had only 1 ball.  Exiting function.");
                 return;
             }
 
-            size_t number_exposures_to_analyze = kNumberAngleCheckExposures;
-            // Make sure we're not trying to check more exposures than we have
-            if (number_exposures_to_analyze >= initial_balls.size() - 1) {
-                number_exposures_to_analyze = initial_balls.size() - 1;
-            }
-
             // Examine each of the search balls and remove any near-by balls that are at an unreasonable angle.
             // This process takes care of the (likely) situation when the top (position 0) quality ball is
             // near another high-quality ball (e.g., position 1), but the second ball is a mistake and is
             // at a weird angle below/above the higher-quality ball.
 
-            std::vector<GolfBall> balls_copy = initial_balls;
+            double min_angle = 0;
+            double max_angle = 0;
+
+            // We will generally allow much smaller angles if we're putting
+            if (GsAnalysisContext::ClubType() == GolfSimClubs::kPutter) {
+                min_angle = kMinPuttingQualityExposureLaunchAngle;
+                max_angle = kMaxPuttingQualityExposureLaunchAngle;
+            }
+            else {
+                min_angle = kMinQualityExposureLaunchAngle;
+                max_angle = kMaxQualityExposureLaunchAngle;
+            }
+
+            const bool left_handed = (GsAnalysisContext::GolferHandedness() == GolferOrientation::kLeftHanded);
 
             // This index should point to the highest-quality ball
             size_t outer_index = 0;
 
-            while ( (outer_index < initial_balls.size() - 1) && (initial_balls.size() > 0) ) {
+            while ( (outer_index < order.size() - 1) && (order.size() > 0) ) {
 
-                GolfBall& current_ball = initial_balls[outer_index];
+                const int current_row = order[outer_index];
+                const long current_x = table.x[current_row];
+                const long current_y = table.y[current_row];
 
-                for (size_t i = initial_balls.size() - 1; (initial_balls.size() > 0) && (i > outer_index); i--) {
-                    GolfBall& b = initial_balls[i];
+                for (size_t i = order.size() - 1; (order.size() > 0) && (i > outer_index); i--) {
+                    const int row = order[i];
+                    const long b_x = table.x[row];
+                    const long b_y = table.y[row];
 
                     double ball_angle_degrees = 0;
 
                     // TBD - This is only an approximation.  It might not work at very high
                     // camera in(de)clinations
 
-                    int x_distance_pixels = std::abs(b.x() - current_ball.x());
+                    int x_distance_pixels = std::abs(b_x - current_x);
 
                     if (x_distance_pixels > kUnlikelyAngleMinimumDistancePixels) {
                         // The balls are too far apart to want to check for unlikely angles
                         continue;
                     }
-                    else if (x_distance_pixels == 0 && b.y() == current_ball.y()) {
+                    else if (x_distance_pixels == 0 && b_y == current_y) {
                         // The balls are concentric, so don't do anything
                         continue;
                     }
                     else if (x_distance_pixels < 0.001) {
-                        // GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyAngleLowerQualityBalls not analyzing ball " + std::to_string(i) + " because its X coordinate is too far from ball number " + std::to_string(outer_index));
                         // If the balls are right above/below each other, just pick a very big angle to avoid doing a divide by zero
                         // The large angle should ensure that the 'bad' ball is removed
                         ball_angle_degrees = 89;
                     }
                     else {
                         // Calculate angle so that it doesn't matter which ball is to the left
-                        ball_angle_degrees = CvUtils::RadiansToDegrees(atan((double)(b.y() - current_ball.y()) /
-                            (double)std::abs(b.x() - current_ball.x())));;
+                        ball_angle_degrees = CvUtils::RadiansToDegrees(atan((double)(b_y - current_y) /
+                            (double)std::abs(b_x - current_x)));
                     }
 
-                    if (b.x() > current_ball.x()) {
+                    if (b_x > current_x) {
                         // The ball to be compared to the outer loop ball is to the right of the outer loop
                         ball_angle_degrees = -ball_angle_degrees;
                     }
@@ -2000,28 +2255,15 @@ namespace golf_sim {
                     }
 
                     // The angles are opposite if the ball is moving right to left
-                    if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kLeftHanded) {
+                    if (left_handed) {
                         ball_angle_degrees = -ball_angle_degrees;
                     }
 
-                    double min_angle = 0;
-                    double max_angle = 0;
-
-                    // We will generally allow much smaller angles if we're putting
-                    if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
-                        min_angle = kMinPuttingQualityExposureLaunchAngle;
-                        max_angle = kMaxPuttingQualityExposureLaunchAngle;
-                    }
-                    else {
-                        min_angle = kMinQualityExposureLaunchAngle;
-                        max_angle = kMaxQualityExposureLaunchAngle;
-                    }
-
                     if (ball_angle_degrees < min_angle || ball_angle_degrees > max_angle) {
                         GS_LOG_TRACE_MSG(trace, "Not analyzing ball " + std::to_string(i) + " due to its unlikely angle of "
                             + std::to_string(ball_angle_degrees) + " degrees with respect to ball number " + std::to_string(outer_index));
 
-                        initial_balls.erase(initial_balls.begin() + i);
+                        order.erase(order.begin() + i);
                     }
                 }
 
@@ -2036,41 +2278,59 @@ namespace golf_sim {
                                                     const GolfBall& expected_best_ball,
                                                     const double max_strobed_ball_color_difference) {
 
-            GS_LOG_TRACE_MSG(trace, "GolfSimCamera::RemoveWrongColorBalls");
-
             if (initial_balls.size() < 1) {
                 GS_LOG_TRACE_MSG(warning, "RemoveWrongColorBalls - balls vector was empty.  Exiting function.");
                 return;
             }
 
+            std::vector<GsCircle> circles{ expected_best_ball.ball_circle_ };
+            for (const GolfBall& b : initial_balls) {
+                circles.push_back(b.ball_circle_);
+            }
+            GsColorStatistics color_statistics(rgbImg, circles);
+
             // Get the color and std of the ball that is the most likely to be a real ball
-            std::vector<GsColorTriplet> statistics = CvUtils::GetBallColorRgb(rgbImg, expected_best_ball.ball_circle_);
-            GsColorTriplet expectedBallRGBAverage{ statistics[0] };
-            GsColorTriplet expectedBallRGBMedian{ statistics[1] };
-            GsColorTriplet expectedBallRGBStd{ statistics[2] };
+            std::vector<GsColorTriplet> statistics = color_statistics.GetBallColorRgb(expected_best_ball.ball_circle_);
+
+            BallCandidateTable table;
+            BuildCandidateTable(initial_balls, table);
+            FilterWrongColorCandidates(color_statistics, initial_balls, table, statistics[0], statistics[1], statistics[2], max_strobed_ball_color_difference);
+            MaterializeCandidates(initial_balls, table, initial_balls);
+        }
+
+        void GolfSimCamera::FilterWrongColorCandidates(const GsColorStatistics& color_statistics,
+                                                       const std::vector<GolfBall>& balls,
+                                                       BallCandidateTable& table,
+                                                       const GsColorTriplet& expectedBallRGBAverage,
+                                                       const GsColorTriplet& expectedBallRGBMedian,
+                                                       const GsColorTriplet& expectedBallRGBStd,
+                                                       const double max_strobed_ball_color_difference) {
+
+            GS_LOG_TRACE_MSG(trace, "GolfSimCamera::RemoveWrongColorBalls");
+
+            if (table.order.size() < 1) {
+                GS_LOG_TRACE_MSG(warning, "RemoveWrongColorBalls - balls vector was empty.  Exiting function.");
+                return;
+            }
 
             // Expect that the expected_best_ball will not be removed from the vector, as its differences 
             // should be zero.
 
-            for (int i = (int)initial_balls.size() - 1; i >= 0; i--) {
-                GolfBall& b = initial_balls[i];
+            for (size_t i = 0; i < table.order.size(); i++) {
+                const int row = table.order[i];
 
-                if (b.ball_color_ == GolfBall::BallColor::kModelDetected) {
+                if (table.model_detected[row]) {
                     GS_LOG_TRACE_MSG(trace, "Skipping color analysis for model-detected ball " + std::to_string(i));
                     continue;
                 }
 
-                std::vector<GsColorTriplet> statistics = CvUtils::GetBallColorRgb(rgbImg, b.ball_circle_);
-                GsColorTriplet avg_RGB{ statistics[0] };
-                GsColorTriplet median_RGB{ statistics[1] };
-                GsColorTriplet std_RGB{ statistics[2] };
-
-                // Save the information for later - TBD - Centralize this earlier somewhere
-                b.average_color_ = avg_RGB;
-                b.std_color_ = std_RGB;
+                // Also saves the information for later (see MaterializeCandidate)
+                ComputeCandidateColorStatistics(color_statistics, balls, table, row);
+                const GsColorTriplet& avg_RGB = table.average_color[row];
+                const GsColorTriplet& median_RGB = table.median_color[row];
+                const GsColorTriplet& std_RGB = table.std_color[row];
 
-                // Draw the outer circle if in debug
-                GS_LOG_TRACE_MSG(trace, "\n\nExamining circle No. " + std::to_string(i) + ".  Radius " + std::to_string(b.measured_radius_pixels_) +
+                GS_LOG_TRACE_MSG(trace, "\n\nExamining circle No. " + std::to_string(i) + ".  Radius " + std::to_string(table.radius[row]) +
                     " pixels. Average RGB is{ " + LoggingTools::FormatGsColorTriplet(avg_RGB)
                     + ". Average HSV is{ " + LoggingTools::FormatGsColorTriplet(CvUtils::ConvertRgbToHsv(avg_RGB)));
 
@@ -2111,7 +2371,7 @@ namespace golf_sim {
                     calculated_color_difference = rgb_difference_component + std_difference_component;
                 }
 
-                GS_LOG_TRACE_MSG(trace, "Found " + brightness + " circle number " + std::to_string(i) + "(x,y) = (" + std::to_string(b.x()) + ", " + std::to_string(b.y()) + "). radius = " + std::to_string(b.measured_radius_pixels_) +
+                GS_LOG_TRACE_MSG(trace, "Found " + brightness + " circle number " + std::to_string(i) + "(x,y) = (" + std::to_string(table.x[row]) + ", " + std::to_string(table.y[row]) + "). radius = " + std::to_string(table.radius[row]) +
                     " rgb_avg_diff = " + std::to_string(rgb_avg_diff) +
                     " CALCDiff = " + std::to_string(calculated_color_difference) + " rgbDiff = " + std::to_string(rgb_avg_diff) +
                     " rgb_median_diff = " + std::to_string(rgb_median_diff) + " rgb_std_diff = " + std::to_string(rgb_std_diff));
@@ -2121,37 +2381,46 @@ namespace golf_sim {
                     GS_LOG_TRACE_MSG(trace, "  Not analyzing found ball No. " + std::to_string(i) + " due to it having too different a color ( difference was " +
                         std::to_string(calculated_color_difference) + "), and the max was " + std::to_string(max_strobed_ball_color_difference) + ".\n");
                     GS_LOG_TRACE_MSG(trace, " rgb_difference_component was " + std::to_string(rgb_difference_component) + "), and std_difference_component was " + std::to_string(std_difference_component) + ".\n\n");
-                    initial_balls.erase(initial_balls.begin() + i);
+                    table.rejected[row] = 1;
                 }
-
             }
 
+            CompactCandidates(table);
         }
 
 
         void GolfSimCamera::RemoveWrongRadiusBalls(std::vector<GolfBall>& initial_balls,
                                                    const GolfBall& expected_best_ball ) {
 
+            BallCandidateTable table;
+            BuildCandidateTable(initial_balls, table);
+            FilterWrongRadiusCandidates(table, expected_best_ball.measured_radius_pixels_);
+            MaterializeCandidates(initial_balls, table, initial_balls);
+        }
+
+        void GolfSimCamera::FilterWrongRadiusCandidates(BallCandidateTable& table, const double nominal_radius) {
+
             GS_LOG_TRACE_MSG(trace, "GolfSimCamera::RemoveWrongRadiusBalls");
 
-            double nominal_radius = expected_best_ball.measured_radius_pixels_;
-               
+            const double max_radius_different = nominal_radius * (kMaxRadiusDifferencePercentageFromBest / 100.0);
+
             // Expect that the expected_best_ball will not be removed from the vector, as it's differences 
-            // should be zero.
+            // should be zero.  The first ball is never removed.
 
-            for (int i = (int)initial_balls.size() - 1; i > 0; i--) {
-                GolfBall& b = initial_balls[i];
+            for (size_t i = 1; i < table.order.size(); i++) {
+                const int row = table.order[i];
 
-                double radius_difference = std::abs(nominal_radius - b.measured_radius_pixels_);
-                double max_radius_different = nominal_radius * (kMaxRadiusDifferencePercentageFromBest / 100.0);
+                double radius_difference = std::abs(nominal_radius - table.radius[row]);
 
                 // Remove any balls that are too far away from the expected radius range
                 if (radius_difference > max_radius_different) {
                     GS_LOG_TRACE_MSG(trace, "  Not analyzing found ball No. " + std::to_string(i) + " due to it having too different a radius from best ball ( difference was " +
                         std::to_string(radius_difference) + "), and the max was " + std::to_string(max_radius_different));
-                    initial_balls.erase(initial_balls.begin() + i);
+                    table.rejected[row] = 1;
                 }
             }
+
+            CompactCandidates(table);
         }
 
         void GolfSimCamera::ReportBallSearchError(const int number_balls_found) {
@@ -2167,57 +2436,206 @@ namespace golf_sim {
                 root_cause_str = "An error occurred while processing the post-hit ball image.  Please check logs.";
             }
 
-            LoggingTools::current_error_root_cause_ = root_cause_str;
+            GsAnalysisContext::SetErrorRootCause(root_cause_str);
             GS_LOG_MSG(error, root_cause_str);
         }
 
-        bool GolfSimCamera::AnalyzeStrobedBalls( const cv::Mat& strobed_balls_color_image,
-                                                 const cv::Mat& strobed_balls_gray_image,
-                                                 const GolfBall& calibrated_ball,
-                                                 GsBallsAndTimingVector& return_balls_and_timings,
-                                                 GsBallsAndTimingVector& non_overlapping_balls_and_timing,
-                                                 GolfBall& face_ball,
-                                                 GolfBall& ball2,
-                                                 long& time_between_ball_images_uS  ) {
+        bool GolfSimCamera::FilterStrobedBallCandidates(const cv::Mat& strobed_balls_color_image,
+                                                        const GsColorStatistics& color_statistics,
+                                                        const int min_ball_radius,
+                                                        const double max_color_difference,
+                                                        const double max_intermediate_ball_radius_change_percent,
+                                                        std::vector<GolfBall>& initial_balls,
+                                                        GolfBall& best_ball,
+                                                        GolfBall& second_best_ball) {
 
-            GS_LOG_TRACE_MSG(trace, "AnalyzeStrobedBalls(ball).  calibrated_ball = " + calibrated_ball.Format());
+            const int number_of_initial_balls = (int)initial_balls.size();
 
-            if (!calibrated_ball.calibrated) {
+            BallCandidateTable table;
+            BuildCandidateTable(initial_balls, table);
 
-                GS_LOG_MSG(error, "AnalyzeStrobedBall called without a properly calibrated ball.");
+            // Only pay to build a ball vector for the intermediate images if something will be done with them
+            auto show_candidates = [&](const std::string& title, const bool log_image_to_file) {
+                if (!WillShowOrLogBalls(log_image_to_file)) {
+                    return;
+                }
+                std::vector<GolfBall> survivors;
+                MaterializeCandidates(initial_balls, table, survivors);
+                ShowAndLogBalls(title, strobed_balls_color_image, survivors, log_image_to_file);
+            };
+
+            auto trace_candidates = [&](const std::string& msg) {
+                if (GolfSimOptions::GetCommandLineOptions().logging_level_ != kTrace) {
+                    return;
+                }
+                std::vector<GolfBall> survivors;
+                MaterializeCandidates(initial_balls, table, survivors);
+                LoggingTools::Trace(msg, survivors);
+            };
+
+            GolfBall expected_best_ball = best_ball;
+
+            // The balls are still sorted by quality, so the first one is the expected best ball
+            const int expected_best_row = table.order[0];
+            ComputeCandidateColorStatistics(color_statistics, initial_balls, table, expected_best_row);
+
+            FilterWrongColorCandidates(color_statistics, initial_balls, table,
+                                       table.average_color[expected_best_row],
+                                       table.median_color[expected_best_row],
+                                       table.std_color[expected_best_row],
+                                       max_color_difference);
+            show_candidates("AnalyzeStrobedBall_After_RemoveWrongColorBalls", kLogIntermediateExposureImagesToFile);
+            trace_candidates("Initial_balls after RemoveWrongColorBalls: ");
+
+            // Seems like wrong radius balls can be a better and more-ball-removing early filter than UnlikelyAngle balls
+            FilterWrongRadiusCandidates(table, expected_best_ball.measured_radius_pixels_);
+            show_candidates("AnalyzeStrobedBall_After_RemoveWrongRadiusBalls", kLogIntermediateExposureImagesToFile);
+
+            FilterUnlikelyAngleLowerQualityCandidates(table);
+            show_candidates("AnalyzeStrobedBall_After_RemoveUnlikelyAngleLowerQualityBalls", kLogIntermediateExposureImagesToFile);
+
+            if (table.order.size() < 2) {
+                GS_LOG_MSG(warning, "Found less than 2 balls.");
                 return false;
             }
+            // Unlikely that the best balls would have been removed.  However, it is possible.
+            // Reset as necessary
+            best_ball = MaterializeCandidate(initial_balls, table, table.order[0]);
+            second_best_ball = MaterializeCandidate(initial_balls, table, table.order[1]);
+            expected_best_ball = best_ball;
 
-            if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
-                GS_LOG_MSG(info, "In putting mode.");
-            }
-            else {
-                GS_LOG_MSG(info, "In driving mode.");
-            }
+            // TBD - Am putting this back in because we're still getting too many balls with the new edge detector
+            FilterLowScoringCandidates(table, kMaxBallsToRetain);
+            show_candidates("AnalyzeStrobedBall_After_RemoveLowScoringBalls", kLogIntermediateExposureImagesToFile);
 
+            // Must be sorted by quality
+            FilterUnlikelyAngleLowerQualityCandidates(table);
+            show_candidates("AnalyzeStrobedBall_After_RemoveUnlikelyAngleLowerQualityBalls", kLogIntermediateExposureImagesToFile);
 
-            BallImageProc* ip = BallImageProc::get_ball_image_processor();
+            FilterWrongRadiusCandidates(table, expected_best_ball.measured_radius_pixels_);
+            show_candidates("AnalyzeStrobedBall_After_RemoveWrongRadiusBalls (Normal Mode)", kLogIntermediateExposureImagesToFile);
 
-            LoggingTools::DebugShowImage("GolfSimCamera::TestAnalyzeStrobedBall COLOR input: ", strobed_balls_color_image);
-            LoggingTools::DebugShowImage("GolfSimCamera::TestAnalyzeStrobedBall GRAY input: ", strobed_balls_gray_image);
+            if (table.order.size() < 2) {
+                GS_LOG_MSG(warning, "Found less than 2 balls.");
+                return false;
+            }
+            // Unlikely that the best balls would have been removed.  However, it is possible.
+            // Reset as necessary
+            best_ball = MaterializeCandidate(initial_balls, table, table.order[0]);
+            second_best_ball = MaterializeCandidate(initial_balls, table, table.order[1]);
 
-            // Find where the ball currently is based on where we expected it from the prior information
+            // Especially if we are using a loose Hough for initial identification, this could get rid of 100 or more ball candidates
+            SortCandidatesByXPosition(table);
+            FilterOffTrajectoryCandidates(table, kMaxDistanceFromTrajectory, best_ball, second_best_ball);
+            show_candidates("AnalyzeStrobedBall_After_0thRemoveOffTrajectoryBalls", kLogIntermediateExposureImagesToFile);
 
-            double distance_at_calibration_ = calibrated_ball.distance_at_calibration_;
+            // A frequent problem because of the very-broad net we cast is that crappy balls end up determined
+            // right next to a good one.  Get rid of 'em
+            if (number_of_initial_balls > 20) {
+                show_candidates("AnalyzeStrobedBall Balls before RemoveNearbyPoorQualityBalls", kLogIntermediateExposureImagesToFile);
+                FilterNearbyPoorQualityCandidates(table, min_ball_radius, number_of_initial_balls / 2);
+                show_candidates("AnalyzeStrobedBall Balls after RemoveNearbyPoorQualityBalls", kLogIntermediateExposureImagesToFile);
+            }
 
-            // Approximate the new distance based just on the X/Z plane distance, assuming
-            // the ball will be hit straight
-            double expected_camera2_distance = calibrated_ball.distances_ortho_camera_perspective_[2];
-            if (expected_camera2_distance < 0.0001) {
+            // Allow for a couple of misidentifications, but assume that the best scoring
+            // balls are all at the front of the herd and that we can get rid of the ones
+            // at the back of the pack, quality-wise;
+            FilterLowScoringCandidates(table, kMaxBallsToRetain);
 
-                GS_LOG_MSG(error, "AnalyzeStrobedBall: Calculated expected_camera2_distance was 0.");
+            show_candidates("AnalyzeStrobedBall_after_RemoveLowScoringBalls", false);
+
+            if (table.order.size() == 1) {
+                GS_LOG_MSG(warning, "GetBall() found only one ball after initial filtering.  Ball velocity may have been too high or very slow.");
                 return false;
             }
 
-            // The ball's position is useful for later analysis
-            GS_LOG_MSG(info, "Teed-up Ball:" + calibrated_ball.Format() + "\n");
+            SortCandidatesByXPosition(table);
+            show_candidates("AnalyzeStrobedBall_Before_RemoveUnlikelyRadiusChangeBalls", kLogIntermediateExposureImagesToFile);
 
-            double expected_strobed_ball_radius = calibrated_ball.radius_at_calibration_pixels_ * (distance_at_calibration_ / expected_camera2_distance);
+            FilterUnlikelyRadiusChangeCandidates(table, max_intermediate_ball_radius_change_percent, kMaxOverlappedBallRadiusChangeRatio);
+
+            SortCandidatesByXPosition(table);
+            show_candidates("AnalyzeStrobedBall_After_1stRemoveUnlikelyRadiusChangeBalls", kLogIntermediateExposureImagesToFile);
+
+            FilterUnlikelyRadiusChangeCandidates(table, max_intermediate_ball_radius_change_percent, kMaxOverlappedBallRadiusChangeRatio);
+
+            SortCandidatesByXPosition(table);
+            show_candidates("AnalyzeStrobedBall_After_2ndRemoveUnlikelyRadiusChangeBalls", kLogIntermediateExposureImagesToFile);
+
+            FilterUnlikelyRadiusChangeCandidates(table, max_intermediate_ball_radius_change_percent, kMaxOverlappedBallRadiusChangeRatio);
+
+            show_candidates("AnalyzeStrobedBall_After_3rdRemoveUnlikelyRadiusChangeBalls", kLogIntermediateExposureImagesToFile);
+
+            // After sorting, the first ball will be the one that is furthest away from the tee-off spot
+            // This is necessary for the RemoveOverlappingBalls to work correctly
+            SortCandidatesByXPosition(table);
+
+            trace_candidates("Initial_balls sorted by ascending (or for left-handed--descending) X value: ");
+            show_candidates("AnalyzeStrobedBall_After_1stRemoveOffTrajectoryBalls", false);
+
+            // This should be using a tighter trajectory limit, but we're trying to accomodate some slow balls right now 
+            // that end up with curved trajectories.  TBD
+            FilterOffTrajectoryCandidates(table, kMaxDistanceFromTrajectory, best_ball, second_best_ball);
+
+            show_candidates("AnalyzeStrobedBall_After_1stRemoveOffTrajectoryBalls", kLogIntermediateExposureImagesToFile);
+
+            // Dropping candidates does not reorder the rest, so the survivors are still sorted by X
+            MaterializeCandidates(initial_balls, table, initial_balls);
+
+            return true;
+        }
+
+        bool GolfSimCamera::AnalyzeStrobedBalls( const cv::Mat& strobed_balls_color_image,
+                                                 const cv::Mat& strobed_balls_gray_image,
+                                                 const GolfBall& calibrated_ball,
+                                                 GsBallsAndTimingVector& return_balls_and_timings,
+                                                 GsBallsAndTimingVector& non_overlapping_balls_and_timing,
+                                                 GolfBall& face_ball,
+                                                 GolfBall& ball2,
+                                                 long& time_between_ball_images_uS  ) {
+
+            GS_TRACE_ZONE("AnalyzeStrobedBalls");
+
+            GS_LOG_TRACE_MSG(trace, "AnalyzeStrobedBalls(ball).  calibrated_ball = " + calibrated_ball.Format());
+
+            if (!calibrated_ball.calibrated) {
+
+                GS_LOG_MSG(error, "AnalyzeStrobedBall called without a properly calibrated ball.");
+                return false;
+            }
+
+            if (GsAnalysisContext::ClubType() == GolfSimClubs::kPutter) {
+                GS_LOG_MSG(info, "In putting mode.");
+            }
+            else {
+                GS_LOG_MSG(info, "In driving mode.");
+            }
+
+
+            // Per-call search state - see GetCalibratedBall
+            BallImageProc ball_image_proc;
+            BallImageProc* ip = &ball_image_proc;
+
+            LoggingTools::DebugShowImage("GolfSimCamera::TestAnalyzeStrobedBall COLOR input: ", strobed_balls_color_image);
+            LoggingTools::DebugShowImage("GolfSimCamera::TestAnalyzeStrobedBall GRAY input: ", strobed_balls_gray_image);
+
+            // Find where the ball currently is based on where we expected it from the prior information
+
+            double distance_at_calibration_ = calibrated_ball.distance_at_calibration_;
+
+            // Approximate the new distance based just on the X/Z plane distance, assuming
+            // the ball will be hit straight
+            double expected_camera2_distance = calibrated_ball.distances_ortho_camera_perspective_[2];
+            if (expected_camera2_distance < 0.0001) {
+
+                GS_LOG_MSG(error, "AnalyzeStrobedBall: Calculated expected_camera2_distance was 0.");
+                return false;
+            }
+
+            // The ball's position is useful for later analysis
+            GS_LOG_MSG(info, "Teed-up Ball:" + calibrated_ball.Format() + "\n");
+
+            double expected_strobed_ball_radius = calibrated_ball.radius_at_calibration_pixels_ * (distance_at_calibration_ / expected_camera2_distance);
 
             // Setup to search for a ball that has a reasonable size relationship to the calibrated ball
             ip->min_ball_radius_ = int(expected_strobed_ball_radius * kMinMovedBallRadiusRatio);
@@ -2239,12 +2657,12 @@ namespace golf_sim {
 
             BallImageProc::BallSearchMode processing_mode = BallImageProc::BallSearchMode::kStrobed;
 
-            if (GolfSimOptions::GetCommandLineOptions().lm_comparison_mode_) {
+            if (GsAnalysisContext::LmComparisonMode()) {
                 processing_mode = BallImageProc::BallSearchMode::kExternallyStrobed;
             }
 
             // If we're putting, the ball should only be in the lower one-half to one-third of the image
-            if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
+            if (GsAnalysisContext::ClubType() == GolfSimClubs::kPutter) {
                 processing_mode = BallImageProc::BallSearchMode::kPutting;
 
                 roi = cv::Rect{ 0, (int)(0.5 * strobed_balls_color_image.rows),
@@ -2258,7 +2676,63 @@ namespace golf_sim {
             GolfBall non_const_ball = calibrated_ball;
             non_const_ball.average_color_ = GsColorTriplet(0, 0, 0);
 
-            bool result = ip->GetBall(strobed_balls_color_image, non_const_ball, initial_balls, roi, processing_mode, useLargestFoundBall, dontReportErrors);
+            bool result = false;
+
+            const bool use_putting_fast_path = processing_mode == BallImageProc::BallSearchMode::kPutting &&
+                                               kPuttingFastPath && kPuttingFastPathDetectionScale > 0.0 && kPuttingFastPathDetectionScale < 1.0;
+
+            if (use_putting_fast_path) {
+                const double scale = kPuttingFastPathDetectionScale;
+                auto search_start = std::chrono::steady_clock::now();
+
+                cv::Mat small_image;
+                cv::resize(strobed_balls_color_image, small_image, cv::Size(), scale, scale, cv::INTER_AREA);
+
+                cv::Rect small_roi{ (int)(roi.x * scale), (int)(roi.y * scale), (int)(roi.width * scale), (int)(roi.height * scale) };
+                small_roi &= cv::Rect(0, 0, small_image.cols, small_image.rows);
+
+                // The later filtering works on the full-size image, so the full-size radii are put back
+                const int full_min_ball_radius = ip->min_ball_radius_;
+                const int full_max_ball_radius = ip->max_ball_radius_;
+                ip->min_ball_radius_ = std::max(1, (int)(full_min_ball_radius * scale));
+                ip->max_ball_radius_ = std::max(ip->min_ball_radius_ + 1, (int)std::ceil(full_max_ball_radius * scale));
+
+                result = ip->GetBall(small_image, non_const_ball, initial_balls, small_roi, processing_mode, useLargestFoundBall, dontReportErrors);
+
+                ip->min_ball_radius_ = full_min_ball_radius;
+                ip->max_ball_radius_ = full_max_ball_radius;
+
+                // GetBall only sets the circle of each candidate
+                for (GolfBall& ball : initial_balls) {
+                    const GsCircle& c = ball.ball_circle_;
+                    ball.set_circle(GsCircle((float)(c[0] / scale), (float)(c[1] / scale), (float)(c[2] / scale)));
+                }
+
+                GS_LOG_TRACE_MSG(trace, "Putting fast path ball search at scale " + std::to_string(scale) + " took " +
+                    std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - search_start).count()) + " us.");
+            }
+            else if (!predicted_exposure_windows_.empty() && processing_mode == BallImageProc::BallSearchMode::kStrobed) {
+                // The legacy search only looks within the ROI.  The model looks at the whole frame,
+                // but what it finds outside the windows is dropped just the same.
+                cv::Rect predicted_roi = GsExposurePredictor::SearchArea(predicted_exposure_windows_);
+                result = ip->GetBall(strobed_balls_color_image, non_const_ball, initial_balls, predicted_roi, processing_mode, useLargestFoundBall, true);
+                GsExposurePredictor::KeepBallsInWindows(predicted_exposure_windows_, initial_balls);
+
+                if (result && initial_balls.size() >= 2) {
+                    GsMetrics::Increment(GsMetrics::Counter::kExposurePredictionsUsed);
+                }
+                else {
+                    GS_LOG_TRACE_MSG(trace, "AnalyzeStrobedBalls - found only " + std::to_string(initial_balls.size()) +
+                                            " balls where they were predicted.  Searching the whole frame.");
+                    GsMetrics::Increment(GsMetrics::Counter::kExposurePredictionFallbacks);
+
+                    initial_balls.clear();
+                    result = ip->GetBall(strobed_balls_color_image, non_const_ball, initial_balls, roi, processing_mode, useLargestFoundBall, dontReportErrors);
+                }
+            }
+            else {
+                result = ip->GetBall(strobed_balls_color_image, non_const_ball, initial_balls, roi, processing_mode, useLargestFoundBall, dontReportErrors);
+            }
 
             int number_of_initial_balls = (int)initial_balls.size();
 
@@ -2279,7 +2753,7 @@ namespace golf_sim {
 
             // Override the handedness that was sent in from the command line.  
             // The command-line is going to be deprecated - TBD
-            GolfSimOptions::GetCommandLineOptions().golfer_orientation_ = handedness;
+            GsAnalysisContext::SetGolferHandedness(handedness);
 
             // Save the best and 2nd-best balls based on the GetBall's sorting
             // Do this here after we've gotten rid of any low-quality/angle balls above
@@ -2291,8 +2765,15 @@ namespace golf_sim {
             // Note - balls should be sorted by quality during this early phase
             // TBD - let's try the putter way for the strobed balls as well?
 
-            double max_color_difference = (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) ? kMaxPuttingBallColorDifferenceRelaxed : kMaxStrobedBallColorDifferenceRelaxed;
+            double max_color_difference = (GsAnalysisContext::ClubType() == GolfSimClubs::kPutter) ? kMaxPuttingBallColorDifferenceRelaxed : kMaxStrobedBallColorDifferenceRelaxed;
             
+            // Every candidate's color is looked at at least once below, so do the per-frame work up front
+            std::vector<GsCircle> candidate_circles;
+            for (const GolfBall& ball : initial_balls) {
+                candidate_circles.push_back(ball.ball_circle_);
+            }
+            GsColorStatistics color_statistics(strobed_balls_color_image, candidate_circles);
+
             // Model-detected balls skip the normal pipeline, so compute spatial data explicitly
             for (auto& ball : initial_balls) {
                 if (ball.ball_color_ == GolfBall::BallColor::kModelDetected) {
@@ -2303,7 +2784,7 @@ namespace golf_sim {
                         GS_LOG_MSG(warning, "Failed to compute spatial physics for model-detected ball - continuing anyway");
                     }
 
-                    GetBallColorInformation(strobed_balls_color_image, ball);
+                    GetBallColorInformation(color_statistics, ball);
 
                     GS_LOG_TRACE_MSG(trace, "Model-detected ball physics complete: DistFromLens=" +
                                    std::to_string(ball.distance_to_z_plane_from_lens_) + "m, CalFocLen=" +
@@ -2311,124 +2792,23 @@ namespace golf_sim {
                 }
             }
             
-            RemoveWrongColorBalls(strobed_balls_color_image, initial_balls, expected_best_ball, max_color_difference);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_RemoveWrongColorBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-            LoggingTools::Trace("Initial_balls after RemoveWrongColorBalls: ", initial_balls);
-
-            // Seems like wrong radius balls can be a better and more-ball-removing early filter than UnlikelyAngle balls
-            RemoveWrongRadiusBalls(initial_balls, expected_best_ball);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_RemoveWrongRadiusBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-            RemoveUnlikelyAngleLowerQualityBalls(initial_balls);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_RemoveUnlikelyAngleLowerQualityBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-
-            // TBD - REMOVE - Hack to test the strobe interval function
-            /** 
-            initial_balls.erase(initial_balls.begin() + 2);
-            initial_balls.erase(initial_balls.begin() + 2);
-            ShowAndLogBalls("initial_balls after hack for testing", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-            ***/
-
-
-            if (initial_balls.size() < 2) {
-                GS_LOG_MSG(warning, "Found less than 2 balls.");
-                return false;
-            }
-            // Unlikely that the best balls would have been removed.  However, it is possible.
-            // Reset as necessary
-            best_ball = initial_balls[0];
-            second_best_ball = initial_balls[1];
-            expected_best_ball = best_ball;
-
-            // TBD - Am putting this back in because we're still getting too many balls with the new edge detector
-            RemoveLowScoringBalls(initial_balls, kMaxBallsToRetain);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_RemoveLowScoringBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-            // Must be sorted by quality
-            RemoveUnlikelyAngleLowerQualityBalls(initial_balls);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_RemoveUnlikelyAngleLowerQualityBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-            RemoveWrongRadiusBalls(initial_balls, expected_best_ball);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_RemoveWrongRadiusBalls (Normal Mode)", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-            // Unlikely that the best balls would have been removed.  However, it is possible.
-            // Reset as necessary
-            best_ball = initial_balls[0];
-            second_best_ball = initial_balls[1];
-            expected_best_ball = best_ball;
-
-
-            // Especially if we are using a loose Hough for initial identification, this could get rid of 100 or more ball candidates
-            SortBallsByXPosition(initial_balls);
-            RemoveOffTrajectoryBalls(initial_balls, kMaxDistanceFromTrajectory, best_ball, second_best_ball);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_0thRemoveOffTrajectoryBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-            // A frequent problem because of the very-broad net we cast is that crappy balls end up determined
-            // right next to a good one.  Get rid of 'em
-            if (number_of_initial_balls > 20) {
-                ShowAndLogBalls("AnalyzeStrobedBall Balls before RemoveNearbyPoorQualityBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-                RemoveNearbyPoorQualityBalls(initial_balls, ip->min_ball_radius_, number_of_initial_balls / 2);
-                ShowAndLogBalls("AnalyzeStrobedBall Balls after RemoveNearbyPoorQualityBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-            }
-
-            // Allow for a couple of misidentifications, but assume that the best scoring
-            // balls are all at the front of the herd and that we can get rid of the ones
-            // at the back of the pack, quality-wise;
-            RemoveLowScoringBalls(initial_balls, kMaxBallsToRetain);
-
-            ShowAndLogBalls("AnalyzeStrobedBall_after_RemoveLowScoringBalls", strobed_balls_color_image, initial_balls, false);
-
-            if (initial_balls.size() == 1) {
-                GS_LOG_MSG(warning, "GetBall() found only one ball after initial filtering.  Ball velocity may have been too high or very slow.");
-                return false;
-            }
-
-            SortBallsByXPosition(initial_balls);
-            ShowAndLogBalls("AnalyzeStrobedBall_Before_RemoveUnlikelyRadiusChangeBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
             double max_intermediate_ball_radius_change_percent = 0.0;
 
-            if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
+            if (GsAnalysisContext::ClubType() == GolfSimClubs::kPutter) {
                 max_intermediate_ball_radius_change_percent = kMaxPuttingIntermediateBallRadiusChangePercent;
             }
             else {
                 max_intermediate_ball_radius_change_percent = kMaxIntermediateBallRadiusChangePercent;
             }
 
-            RemoveUnlikelyRadiusChangeBalls(initial_balls, max_intermediate_ball_radius_change_percent, kMaxOverlappedBallRadiusChangeRatio);
-
-            SortBallsByXPosition(initial_balls);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_1stRemoveUnlikelyRadiusChangeBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-            RemoveUnlikelyRadiusChangeBalls(initial_balls, max_intermediate_ball_radius_change_percent, kMaxOverlappedBallRadiusChangeRatio);
-
-            SortBallsByXPosition(initial_balls);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_2ndRemoveUnlikelyRadiusChangeBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-            RemoveUnlikelyRadiusChangeBalls(initial_balls, max_intermediate_ball_radius_change_percent, kMaxOverlappedBallRadiusChangeRatio);
-
-            ShowAndLogBalls("AnalyzeStrobedBall_After_3rdRemoveUnlikelyRadiusChangeBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-            // Identify any balls that are overlapping with other balls.  Such balls are unlikely to be useful 
-            // for spin calculations.
-
-            // After sorting, the first ball will be the one that is furthest away from the tee-off spot
-            // This is necessary for the RemoveOverlappingBalls to work correctly
-            SortBallsByXPosition(initial_balls);
-
-            LoggingTools::Trace("Initial_balls sorted by ascending (or for left-handed--descending) X value: ", initial_balls);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_1stRemoveOffTrajectoryBalls", strobed_balls_color_image, initial_balls, false);
-
-
-            // This should be using a tighter trajectory limit, but we're trying to accomodate some slow balls right now 
-            // that end up with curved trajectories.  TBD
-            SortBallsByXPosition(initial_balls);
-            RemoveOffTrajectoryBalls(initial_balls, kMaxDistanceFromTrajectory, best_ball, second_best_ball);
-
-            ShowAndLogBalls("AnalyzeStrobedBall_After_1stRemoveOffTrajectoryBalls", strobed_balls_color_image, initial_balls, kLogIntermediateExposureImagesToFile);
-
-            SortBallsByXPosition(initial_balls);
+            // Runs the color, radius, angle, quality, trajectory and radius-change filters.
+            // Afterward, initial_balls is sorted by X position.
+            if (!FilterStrobedBallCandidates(strobed_balls_color_image, color_statistics, ip->min_ball_radius_,
+                                             max_color_difference, max_intermediate_ball_radius_change_percent,
+                                             initial_balls, best_ball, second_best_ball)) {
+                return false;
+            }
+            expected_best_ball = best_ball;
 
 
             // Because some of the overlapping balls have bright colors that will likely be removed
@@ -2439,31 +2819,60 @@ namespace golf_sim {
             // later remove any (strictly) overlapping balls for spin analysis.
             std::vector<GolfBall> possibly_overlapping_balls_before_color_filter = initial_balls;
 
-            // Balls with a small (say 25%) overlap should still be evaluated and retained if possible
-            // During this pass, we will preserve high-quality balls even if they look sketchy
             std::vector<GolfBall> first_pass_balls;
-            int number_overlapping_balls_removed = RemoveOverlappingBalls(initial_balls, kBallProximityMarginPercentRelaxed, true, 
-                                                            first_pass_balls, best_ball, second_best_ball);
-            if (number_overlapping_balls_removed < 0) {
-                GS_LOG_MSG(error, "RemoveOverlappingBalls Failed.");
-                return false;
+            std::vector<GolfBall> return_balls;
+            int number_overlapping_balls_removed = 0;
+
+            // A sequence-aware model already says which balls are overlapped.  If it is sure about
+            // every one of them, those are just dropped instead of going through the filters below.
+            bool model_scored_every_overlap = BallImageProc::kModelHasSequenceOutputs && !initial_balls.empty();
+            for (const GolfBall& b : initial_balls) {
+                if (b.ball_color_ != GolfBall::BallColor::kModelDetected || b.model_overlap_score_ < 0.0 ||
+                    (b.model_overlap_score_ > 1.0 - BallImageProc::kModelSequenceConfidence &&
+                     b.model_overlap_score_ < BallImageProc::kModelSequenceConfidence)) {
+                    model_scored_every_overlap = false;
+                    break;
+                }
             }
 
-            SortBallsByXPosition(first_pass_balls);
+            if (model_scored_every_overlap) {
+                for (const GolfBall& b : initial_balls) {
+                    if (b.model_overlap_score_ < 0.5) {
+                        return_balls.push_back(b);
+                    }
+                }
 
-            ShowAndLogBalls("AnalyzeStrobedBall_After_1stRemoveOverlappingBalls", strobed_balls_color_image, first_pass_balls, kLogIntermediateExposureImagesToFile);
+                number_overlapping_balls_removed = (int)(initial_balls.size() - return_balls.size());
+                SortBallsByXPosition(return_balls);
+                first_pass_balls = return_balls;
 
-            // TBD -Trying these two steps twice to deal with really close balls that remain after the first pass
-            // THIS time, do not preserve high-quality balls that look sketchy
-            RemoveUnlikelyRadiusChangeBalls(first_pass_balls, max_intermediate_ball_radius_change_percent, kMaxOverlappedBallRadiusChangeRatio, false);
-            ShowAndLogBalls("AnalyzeStrobedBall_After_3rdRemoveUnlikelyRadiusChangeBalls", strobed_balls_color_image, first_pass_balls, kLogIntermediateExposureImagesToFile);
+                GsMetrics::Increment(GsMetrics::Counter::kModelSequenceOverlapFilterSkipped);
+                GS_LOG_TRACE_MSG(trace, "AnalyzeStrobedBalls - the model's overlap scores removed " + std::to_string(number_overlapping_balls_removed) + " balls.");
+            }
+            else {
+                // Balls with a small (say 25%) overlap should still be evaluated and retained if possible
+                // During this pass, we will preserve high-quality balls even if they look sketchy
+                number_overlapping_balls_removed = RemoveOverlappingBalls(initial_balls, kBallProximityMarginPercentRelaxed, true,
+                                                                first_pass_balls, best_ball, second_best_ball);
+                if (number_overlapping_balls_removed < 0) {
+                    GS_LOG_MSG(error, "RemoveOverlappingBalls Failed.");
+                    return false;
+                }
 
-            SortBallsByXPosition(first_pass_balls);
+                SortBallsByXPosition(first_pass_balls);
 
+                ShowAndLogBalls("AnalyzeStrobedBall_After_1stRemoveOverlappingBalls", strobed_balls_color_image, first_pass_balls, kLogIntermediateExposureImagesToFile);
 
-            std::vector<GolfBall> return_balls;
-            number_overlapping_balls_removed += RemoveOverlappingBalls(first_pass_balls, kBallProximityMarginPercentRelaxed, true,
-                                                    return_balls, best_ball, second_best_ball, false);
+                // TBD -Trying these two steps twice to deal with really close balls that remain after the first pass
+                // THIS time, do not preserve high-quality balls that look sketchy
+                RemoveUnlikelyRadiusChangeBalls(first_pass_balls, max_intermediate_ball_radius_change_percent, kMaxOverlappedBallRadiusChangeRatio, false);
+                ShowAndLogBalls("AnalyzeStrobedBall_After_3rdRemoveUnlikelyRadiusChangeBalls", strobed_balls_color_image, first_pass_balls, kLogIntermediateExposureImagesToFile);
+
+                SortBallsByXPosition(first_pass_balls);
+
+                number_overlapping_balls_removed += RemoveOverlappingBalls(first_pass_balls, kBallProximityMarginPercentRelaxed, true,
+                                                        return_balls, best_ball, second_best_ball, false);
+            }
 
 
             // From here one, we're only working with the return_balls vector
@@ -2519,7 +2928,7 @@ namespace golf_sim {
 
             bool perform_best_circle_fit_when_putting = true;
 
-            if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
+            if (GsAnalysisContext::ClubType() == GolfSimClubs::kPutter) {
                 if (best_ball.y() + best_ball.measured_radius_pixels_ >= 0.98 * strobed_balls_gray_image.rows) {
                     perform_best_circle_fit_when_putting = false;
                 }
@@ -2535,8 +2944,16 @@ namespace golf_sim {
                         LoggingTools::DebugShowImage("GolfSimCamera::TestAnalyzeStrobedBall GRAY pre-best-circle input: ", strobed_balls_gray_image);
                     }
 
+                    cv::RotatedRect edge_fit_ellipse;
+
+                    if (BallImageProc::kUseFastEllipseRefinement &&
+                        BallImageProc::FitBallEllipseToEdges(strobed_balls_gray_image, original_ball.ball_circle_, edge_fit_ellipse)) {
+                        // The ball is very nearly round, so use the average of the axes
+                        best_circle = GsCircle(edge_fit_ellipse.center.x, edge_fit_ellipse.center.y,
+                                               (edge_fit_ellipse.size.width + edge_fit_ellipse.size.height) / 4.0f);
+                    }
                     // TBD - Still trying to figure out of the largest circle (among the top few) is the best?
-                    if (!BallImageProc::DetermineBestCircle(strobed_balls_gray_image, original_ball, BallImageProc::kUseBestCircleLargestCircle, best_circle)) {
+                    else if (!BallImageProc::DetermineBestCircle(strobed_balls_gray_image, original_ball, BallImageProc::kUseBestCircleLargestCircle, best_circle)) {
                         GS_LOG_MSG(warning, "GolfSimCamera::AnalyzeStrobedBalls - failed to DetermineBestCircle spin ball number " +
                             std::to_string(first_index) + " .Using originally - found ball.");
                         continue;
@@ -2674,10 +3091,10 @@ namespace golf_sim {
 
             double kBallConstantSpeedAdjustmentPercentage;
 
-            if (GolfSimOptions::GetCommandLineOptions().practice_ball_) {
+            if (GsAnalysisContext::PracticeBall()) {
                 kBallConstantSpeedAdjustmentPercentage = kPracticeBallSpeedSlowdownPercentage; // percent
             }
-            else if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
+            else if (GsAnalysisContext::ClubType() == GolfSimClubs::kPutter) {
                 kBallConstantSpeedAdjustmentPercentage = kPuttingBallSpeedSlowdownPercentage; // percent
             }
             else {
@@ -2700,8 +3117,39 @@ namespace golf_sim {
             cv::Mat& exposures_image,
             std::vector<GolfBall>& exposure_balls) {
 
+            GsAnalysisContext context = GsAnalysisContext::FromCurrentSettings();
+            context.send_staged_results = true;
+            context.skip_spin_if_busy = true;
+
+            const bool success = ProcessReceivedCam2Image(ball1_mat, strobed_ball_mat, camera2_pre_image_, context,
+                                                          result_ball, rotationResults, exposures_image, exposure_balls);
+
+            // The command-line handedness is overridden by whatever the shot showed
+            // TBD - The command-line is going to be deprecated
+            GsSessionSettings::SetGolferHandedness(context.golfer_orientation);
+
+            // Callers of this form look for the root cause in the process-wide one
+            if (!context.error_root_cause.empty()) {
+                LoggingTools::SetErrorRootCause(context.error_root_cause);
+            }
+
+            return success;
+        }
+
+        bool GolfSimCamera::ProcessReceivedCam2Image(const cv::Mat& ball1_mat,
+            const cv::Mat& strobed_ball_mat,
+            const cv::Mat& camera2_pre_image_,
+            GsAnalysisContext& context,
+            GolfBall& result_ball,
+            cv::Vec3d& rotationResults,
+            cv::Mat& exposures_image,
+            std::vector<GolfBall>& exposure_balls) {
+
             GS_LOG_TRACE_MSG(trace, "ProcessReceivedCam2Image called.");
 
+            // Everything below (and the stages that it starts on the thread pool) reads the shot's settings from here
+            GsAnalysisContext::Scope context_scope(&context);
+
             if (ball1_mat.empty()) {
                 GS_LOG_MSG(error, "ProcessReceivedCam2Image received empty ball1_mat.");
                 return false;
@@ -2712,6 +3160,11 @@ namespace golf_sim {
                 return false;
             }
 
+#ifdef __unix__
+            GsSharedMemory::PublishFrame(PITRAC_SHM_FRAME_TEED, "teed_ball", ball1_mat);
+            GsSharedMemory::PublishFrame(PITRAC_SHM_FRAME_STROBED, "strobed_balls", strobed_ball_mat);
+#endif
+
             cv::Mat prepared_strobed_ball_mat = strobed_ball_mat.clone();
 
             if (!kUsePreImageSubtraction) {
@@ -2721,6 +3174,9 @@ namespace golf_sim {
                 if (camera2_pre_image_.empty()) {
                     GS_LOG_MSG(warning, "ProcessReceivedCam2Image - not using kUsePreImageSubtraction, or received empty camera2_pre_image_.");
                 }
+                else if (camera2_pre_image_.channels() != strobed_ball_mat.channels()) {
+                    GS_LOG_MSG(warning, "ProcessReceivedCam2Image - the pre-image and the strobed image must both be color or both be mono.  Not subtracting.");
+                }
                 else
                 {
                     // TBD - For test:
@@ -2746,23 +3202,35 @@ namespace golf_sim {
                     GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kPreImageWeightingRed", kPreImageWeightingRed);
 
 
-                    std::vector<cv::Mat> bgr;
-
-                    cv::split(camera2_pre_image_, bgr);
-                    bgr[0] = bgr[0] * kPreImageWeightingOverall * kPreImageWeightingBlue;
-                    bgr[1] = bgr[1] * kPreImageWeightingOverall * kPreImageWeightingGreen;
-                    bgr[2] = bgr[2] * kPreImageWeightingOverall * kPreImageWeightingRed;
+                    // The camera 2 background model (see GsCamera2Background) is kept downscaled
+                    cv::Mat full_size_pre_image = camera2_pre_image_;
 
+                    if (camera2_pre_image_.size() != strobed_ball_mat.size()) {
+                        cv::resize(camera2_pre_image_, full_size_pre_image, strobed_ball_mat.size(), 0, 0, cv::INTER_LINEAR);
+                    }
 
                     cv::Mat final_pre_image;    // = camera2_pre_image_;
-                    cv::merge(bgr, final_pre_image);
+
+                    if (full_size_pre_image.channels() == 1) {
+                        final_pre_image = full_size_pre_image * kPreImageWeightingOverall;
+                    }
+                    else {
+                        std::vector<cv::Mat> bgr;
+
+                        cv::split(full_size_pre_image, bgr);
+                        bgr[0] = bgr[0] * kPreImageWeightingOverall * kPreImageWeightingBlue;
+                        bgr[1] = bgr[1] * kPreImageWeightingOverall * kPreImageWeightingGreen;
+                        bgr[2] = bgr[2] * kPreImageWeightingOverall * kPreImageWeightingRed;
+
+                        cv::merge(bgr, final_pre_image);
+                    }
 
                     // LoggingTools::LogImage("", final_pre_image, std::vector < cv::Point >{}, true, "scaled_pre_image.png");
 
                     // Subtract the pre-image from the incoming strobed image to (hopefully) end up with just
                     // the golf balls and not all the background clutter
-                    cv::Mat strobed_ball_mat_copy = prepared_strobed_ball_mat.clone();
-                    cv::subtract(strobed_ball_mat_copy, final_pre_image, strobed_ball_mat);
+                    // The result goes into our own copy, not the caller's (const) image
+                    cv::subtract(strobed_ball_mat, final_pre_image, prepared_strobed_ball_mat);
                     LoggingTools::LogImage("", prepared_strobed_ball_mat, std::vector < cv::Point >{}, true, "strobed_img_minus_pre_image.png");
                 }
             }
@@ -2784,19 +3252,29 @@ namespace golf_sim {
             cv::Mat strobed_balls_gray_image;
 
             auto grayscale_start = std::chrono::high_resolution_clock::now();
-            cv::cvtColor(strobed_balls_color_image, strobed_balls_gray_image, cv::COLOR_BGR2GRAY);
+            if (strobed_balls_color_image.channels() == 1) {
+                // A mono capture (see LibCameraInterface::kCamera2MonoCapture) is already grayscale.
+                // The ball identification still works on a BGR image, so expand it for that.
+                strobed_balls_gray_image = strobed_balls_color_image;
+                cv::cvtColor(strobed_balls_gray_image, strobed_balls_color_image, cv::COLOR_GRAY2BGR);
+            }
+            else {
+                cv::cvtColor(strobed_balls_color_image, strobed_balls_gray_image, cv::COLOR_BGR2GRAY);
+            }
             auto grayscale_end = std::chrono::high_resolution_clock::now();
             auto grayscale_duration = std::chrono::duration_cast<std::chrono::microseconds>(grayscale_end - grayscale_start);
             GS_LOG_MSG(info, "Grayscale conversion completed in " + std::to_string(grayscale_duration.count()) + "us");
 
-            const CameraHardware::CameraModel  camera_1_model = GolfSimCamera::kSystemSlot1CameraType;
-            const CameraHardware::LensType  camera_lens_type = GolfSimCamera::kSystemSlot1LensType;
-            const CameraHardware::CameraOrientation camera_orientation = GolfSimCamera::kSystemSlot1CameraOrientation;
+            const CameraHardware::CameraModel  camera_1_model = context.camera1_model;
+            const CameraHardware::LensType  camera_lens_type = context.camera1_lens_type;
+            const CameraHardware::CameraOrientation camera_orientation = context.camera1_orientation;
 
             // Get the ball data.  We will calibrate based on the first ball and then get the second one
             // using that calibrated data from the first ball.
 
             GolfSimCamera camera_1;
+            camera_1.camera_hardware_.instance_resolution_x_override_ = context.resolution_x;
+            camera_1.camera_hardware_.instance_resolution_y_override_ = context.resolution_y;
             camera_1.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera1, camera_1_model, camera_lens_type, camera_orientation);
 
             // One set of positions, below describes the relationship of camera2 to itself and the z-plane of the ball.
@@ -2813,19 +3291,37 @@ namespace golf_sim {
 
             cv::Vec2i expectedBallCenter = cv::Vec2i(1456 / 2, 1088 / 2);
 
-            if (GolfSimOptions::GetCommandLineOptions().search_center_x_ > 0) {
-                expectedBallCenter[0] = GolfSimOptions::GetCommandLineOptions().search_center_x_;
+            if (context.teed_ball_search_center[0] > 0) {
+                expectedBallCenter[0] = context.teed_ball_search_center[0];
             }
 
-            if (GolfSimOptions::GetCommandLineOptions().search_center_y_ > 0) {
-                expectedBallCenter[1] = GolfSimOptions::GetCommandLineOptions().search_center_y_;
+            if (context.teed_ball_search_center[1] > 0) {
+                expectedBallCenter[1] = context.teed_ball_search_center[1];
             }
 
             // Get the location information about the first ball from the initial, static, image
             GolfBall calibrated_ball;
 
             /*****************************  Get the first (teed) ball  ***************************/
-            bool success = camera_1.GetCalibratedBall(camera_1, ball1_mat, calibrated_ball, expectedBallCenter, true /* We expect the ball*/);
+            bool success = false;
+
+            // The FSM already found (and calibrated) the teed ball in this image when it was placed.
+            // Its circle and color are kept, and only its position is worked out again for camera_1.
+            if (context.teed_ball_context != nullptr &&
+                context.teed_ball_context->CanReuseBallFor(ball1_mat) &&
+                GolfSimOptions::GetCommandLineOptions().GetCameraNumber() == GsCameraNumber::kGsCamera1) {
+
+                calibrated_ball = context.teed_ball_context->ball;
+                calibrated_ball.measured_radius_pixels_ = calibrated_ball.ball_circle_[2];
+                success = ComputeCalibratedBallPosition(camera_1, calibrated_ball);
+
+                GS_LOG_TRACE_MSG(trace, "ProcessReceivedCam2Image - re-using the teed ball found at placement" +
+                                        std::string(success ? "." : ", but could not compute its position."));
+            }
+
+            if (!success) {
+                success = camera_1.GetCalibratedBall(camera_1, ball1_mat, calibrated_ball, expectedBallCenter, true /* We expect the ball*/);
+            }
 
             if (!success) {
                 GS_LOG_TRACE_MSG(trace, "ProcessReceivedCam2Image - Failed to GetCalibratedBall.");
@@ -2856,12 +3352,18 @@ namespace golf_sim {
             LoggingTools::DebugShowImage("Current Gray Image 1", strobed_balls_gray_image);
 
             GolfSimCamera camera_2;
-            CameraHardware::CameraModel  camera_2_model = GolfSimCamera::kSystemSlot2CameraType;
-            CameraHardware::LensType  camera_2_lens_type = GolfSimCamera::kSystemSlot2LensType;
-            const CameraHardware::CameraOrientation camera_2_orientation = GolfSimCamera::kSystemSlot2CameraOrientation;
+            CameraHardware::CameraModel  camera_2_model = context.camera2_model;
+            CameraHardware::LensType  camera_2_lens_type = context.camera2_lens_type;
+            const CameraHardware::CameraOrientation camera_2_orientation = context.camera2_orientation;
 
+            camera_2.camera_hardware_.instance_resolution_x_override_ = context.resolution_x;
+            camera_2.camera_hardware_.instance_resolution_y_override_ = context.resolution_y;
             camera_2.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera2, camera_2_model, camera_2_lens_type, camera_2_orientation);
 
+            if (GsAnalysisContext::ClubType() != GolfSimClubs::kPutter) {
+                GsExposurePredictor::PredictExposureWindows(camera_1.camera_hardware_, camera_2.camera_hardware_, calibrated_ball,
+                                                            camera_2.GetPulseIntervalsNoTrailingZero(), camera_2.predicted_exposure_windows_);
+            }
 
             success = camera_2.AnalyzeStrobedBalls(strobed_balls_color_image,
                                             strobed_balls_gray_image,
@@ -2878,6 +3380,8 @@ namespace golf_sim {
                 return false;
             }
 
+            GsShotTrace::Mark(GsShotTrace::Stage::kBallDetection);
+
             LoggingTools::DebugShowImage("Current Gray Image 1.5", strobed_balls_gray_image);
 
             // Setup to return the exposures that were found to the caller
@@ -2886,6 +3390,53 @@ namespace golf_sim {
                 exposure_balls.push_back(exposure_ball_and_timing.ball);
             }
 
+            // The rest of the post-hit analysis is run as a small task graph.  The spin analysis and the
+            // averaged strobed-ball data only depend on the balls found above, so they are started on the
+            // shared thread pool where they overlap with the launch angle and velocity calculations that
+            // follow on this thread.  Each stage logs its own timing.
+            bool kSkipSpinCalculation = false;
+            GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kSkipSpinCalculation", kSkipSpinCalculation);
+
+            // When staged delivery is enabled, the user sees the speed and launch angles
+            // right away, and the spin is bounded by a deadline so that the (combined) final
+            // shot is never held up by a slow spin analysis.  The golf sims only receive
+            // the final shot, as most of them would count a second message as a second shot.
+            bool kStagedResultDelivery = false;
+            int kStagedResultSpinDeadlineMs = 250;
+            float kStagedResultFallbackBackSpinRPM = 0.0;
+            float kStagedResultFallbackSideSpinRPM = 0.0;
+            GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kStagedResultDelivery", kStagedResultDelivery);
+            GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kStagedResultSpinDeadlineMs", kStagedResultSpinDeadlineMs);
+            GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kStagedResultFallbackBackSpinRPM", kStagedResultFallbackBackSpinRPM);
+            GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kStagedResultFallbackSideSpinRPM", kStagedResultFallbackSideSpinRPM);
+
+            const bool skip_spin = kSkipSpinCalculation || context.club_type == GolfSimClubs::kPutter;
+            std::shared_ptr<SpinAnalysisTask> spin_task;
+
+            if (!skip_spin && non_overlapping_balls_and_timing.size() >= 2) {
+                spin_task = StartSpinAnalysis(camera_2, strobed_balls_gray_image, non_overlapping_balls_and_timing);
+            }
+
+            // The stage works on its own copies, so nothing needs to be joined if we bail out early below
+            std::future<std::optional<GolfBall>> strobed_averaging_future = GsThreadPool::GetSharedPool().Submit(
+                [camera = camera_2, balls_and_timing = return_balls_and_timing, shot_context = context]() mutable -> std::optional<GolfBall> {
+                    GsAnalysisContext::Scope context_scope(&shot_context);
+                    auto stage_start_time = std::chrono::steady_clock::now();
+
+                    GolfBall averaged_ball;
+                    bool averaging_success = ComputeAveragedStrobedBallData(camera, balls_and_timing, averaged_ball);
+
+                    auto stage_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - stage_start_time).count();
+                    GS_LOG_TRACE_MSG(trace, "ProcessReceivedCam2Image - strobed ball averaging stage took " + std::to_string(stage_ms) + " ms.");
+
+                    if (!averaging_success) {
+                        return std::nullopt;
+                    }
+                    return averaged_ball;
+                });
+
+            auto launch_stage_start_time = std::chrono::steady_clock::now();
+
             // First, determine a velocity based on the two best balls as determined by the
             // AnalyzeStrobedBall method.
 
@@ -2918,7 +3469,7 @@ namespace golf_sim {
             // The ball's position is useful for later analysis
             GS_LOG_MSG(info, "'First' Ball After ComputeBallDeltas:" + ball1.Format() + "\n");
 
-            if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kLeftHanded) {
+            if (GsAnalysisContext::GolferHandedness() == GolferOrientation::kLeftHanded) {
                 if (!ReverseBallAngleDeltas(ball2)) {
                     GS_LOG_MSG(error, "ProcessReceivedCam2Image - failed to ReverseBallDeltas for ball2.");
                     return false;
@@ -2971,7 +3522,7 @@ namespace golf_sim {
                     return false;
                 }
 
-                if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kLeftHanded) {
+                if (GsAnalysisContext::GolferHandedness() == GolferOrientation::kLeftHanded) {
                     if (!ReverseBallAngleDeltas(ball2)) {
                         GS_LOG_MSG(error, "ProcessReceivedCam2Image - failed to ReverseBallDeltas for ball2.");
                         return false;
@@ -3045,19 +3596,43 @@ namespace golf_sim {
 
             result_ball.time_between_ball_positions_for_velocity_uS_ = time_between_balls_uS;
 
+            GsShotTrace::Mark(GsShotTrace::Stage::kTrajectory);
+
+            // The strobe intervals (and so the velocity) are timed from the first pulse, but the
+            // ball was already moving for however long the trigger took to go out
+            const GsTriggerTiming trigger_timing = GetLastTriggerTiming();
+            if (trigger_timing.valid) {
+                const double trigger_latency_us = (double)trigger_timing.GetTriggerLatencyUs();
+                const double ball_travel_mm = result_ball.velocity_ * trigger_latency_us / 1000.0;
+
+                GS_LOG_MSG(info, "Trigger was sent " + std::to_string(trigger_latency_us / 1000.0) + " ms after the motion frame started (frame duration " +
+                           std::to_string(trigger_timing.frame_duration_us) + " us, exposure " + std::to_string(trigger_timing.exposure_time_us) +
+                           " us).  Ball moved up to " + std::to_string(ball_travel_mm) + " mm before the trigger.");
+            }
+
+            const long trigger_to_first_pulse_us = PulseStrobe::GetLastTriggerToFirstPulseUs();
+            if (trigger_to_first_pulse_us >= 0) {
+                GS_LOG_MSG(info, "First strobe pulse was sent " + std::to_string(trigger_to_first_pulse_us) + " us after the trigger started.");
+            }
+
 
             LoggingTools::DebugShowImage("Current Gray Image 2", strobed_balls_gray_image);
 
 
+            auto launch_stage_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - launch_stage_start_time).count();
+            GS_LOG_TRACE_MSG(trace, "ProcessReceivedCam2Image - launch angle and velocity stage took " + std::to_string(launch_stage_ms) + " ms.");
+
             // TBD - Let's see how the entire group of strobed balls BY THEMSELVES do in terms of HLA, VLA, velocity, etc.
-            GolfBall average_of_strobed_ball_data;
+            std::optional<GolfBall> strobed_averaging_result = strobed_averaging_future.get();
 
-            if (!ComputeAveragedStrobedBallData(camera_2, return_balls_and_timing, average_of_strobed_ball_data)) {
+            if (!strobed_averaging_result) {
                 GS_LOG_MSG(error, "ProcessReceivedCam2Image - failed to ComputeBallLocation between initial ball and strobed ball.");
                 return false;
             }
 
-            if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kLeftHanded) {
+            GolfBall average_of_strobed_ball_data = *strobed_averaging_result;
+
+            if (GsAnalysisContext::GolferHandedness() == GolferOrientation::kLeftHanded) {
                 if (!ReverseBallAngleDeltas(average_of_strobed_ball_data)) {
                     GS_LOG_MSG(error, "ProcessReceivedCam2Image - failed to ReverseBallDeltas for ball2.");
                     return false;
@@ -3075,17 +3650,25 @@ namespace golf_sim {
             // by the angles between the strobed balls than by the angles between the initial ball and the strobed balls.
             result_ball.angles_ball_perspective_[1] = average_of_strobed_ball_data.angles_ball_perspective_[1];
 
-            // Send a quick IPCResult message here to allow the user to quickly
-            // see the angular and velocity information before we do the (lengthy) spin measurement.
+            if (kStagedResultDelivery && context.send_staged_results) {
+                // Send a quick IPCResult message here to allow the user to quickly
+                // see the angular and velocity information before we do the (lengthy) spin measurement.
+                // The offsets are not applied to the result_ball until the end, so apply them to a copy.
+                GolfBall preliminary_ball = result_ball;
+                float vla_offset = 0.0;
+                float hla_offset = 0.0;
+                GolfSimConfiguration::SetConstant("gs_config.cameras.kVLAOffset", vla_offset);
+                GolfSimConfiguration::SetConstant("gs_config.cameras.kHLAOffset", hla_offset);
+                preliminary_ball.angles_ball_perspective_[1] += vla_offset;
+                preliminary_ball.angles_ball_perspective_[0] += hla_offset;
+
+                GS_LOG_TRACE_MSG(trace, "Sending preliminary (pre-spin) IPC hit message.");
 #ifdef __unix__ 
-            // TBD - Note the sleep in the send will slow us down getting to the spin measurement
-            // once spin is faster, we should just send the final message
-            // GsUISystem::SendIPCHitMessage(result_ball);
+                GsUISystem::SendIPCHitMessage(preliminary_ball, " Spin pending.");
 #endif
-            bool kSkipSpinCalculation = false;
-            GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kSkipSpinCalculation", kSkipSpinCalculation);
+            }
 
-            if (kSkipSpinCalculation || GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
+            if (skip_spin) {
                 // Do nothing regarding spin and just get back as quickly as possible
                 GS_LOG_TRACE_MSG(trace, "Skipping spin analysis.");
             }
@@ -3093,7 +3676,7 @@ namespace golf_sim {
                 if (non_overlapping_balls_and_timing.size() < 2) {
                     std::string error_str = "Could not find two non-overlapping balls to analyze for spin.";
                     GS_LOG_MSG(error, error_str);
-                    LoggingTools::current_error_root_cause_ = error_str;
+                    context.error_root_cause = error_str;
 
                     // We probably still calculated non-spin values like HLA, VLA and velocity,
                     // so return successfully and set the spin values to something we can
@@ -3105,14 +3688,26 @@ namespace golf_sim {
                 // Determine the spin based on the two closest balls in the strictly 
                 // non-overlapping set of balls, and apply that information to the result_ball
                 // that we are building up.
-                if (!ProcessSpin(camera_2, strobed_balls_gray_image, non_overlapping_balls_and_timing,
-                    result_ball, rotationResults)) {
+                // The spin stage has been running in the background.  Without staged delivery, wait for as long as it takes.
+                const int spin_deadline_ms = kStagedResultDelivery ? kStagedResultSpinDeadlineMs : -1;
+                bool spin_success = (spin_task != nullptr) && FinishSpinAnalysis(*spin_task, result_ball, rotationResults, spin_deadline_ms);
+
+                if (!spin_success) {
 
                     // If we can't compute spin, it's a bummer, but it shouldn't be fatal
                     std::string error_str = "Unable to compute spin.";
                     GS_LOG_MSG(warning, error_str);
-                    LoggingTools::current_error_root_cause_ = error_str;
+                    context.error_root_cause = error_str;
+
+                    if (kStagedResultDelivery) {
+                        GS_LOG_MSG(info, "Using fallback spin of " + std::to_string(kStagedResultFallbackBackSpinRPM) + " RPM back spin and " +
+                                            std::to_string(kStagedResultFallbackSideSpinRPM) + " RPM side spin.");
+                        result_ball.rotation_speeds_RPM_[2] = kStagedResultFallbackBackSpinRPM;
+                        result_ball.rotation_speeds_RPM_[0] = kStagedResultFallbackSideSpinRPM;
+                    }
                 }
+
+                GsShotTrace::Mark(GsShotTrace::Stage::kSpin);
             }
 
             // Finally, apply and HLA or VLA offsets to the results
@@ -3154,10 +3749,13 @@ namespace golf_sim {
             GolfBall spin_ball1;
             GolfBall spin_ball2;
             double spin_timing_interval_uS = 0.0;
+            bool found_best_spin_balls = true;
 
             // Try to find the two closest balls while avoiding any balls really close to the edge if we can.
             // Back off if necessary
             if (!FindBestTwoSpinBalls(strobed_balls_gray_image, non_overlapping_balls_and_timing, true, spin_ball1, spin_ball2, spin_timing_interval_uS)) {
+                found_best_spin_balls = false;
+
                 if (!FindClosestTwoBalls(strobed_balls_gray_image, non_overlapping_balls_and_timing, false, spin_ball1, spin_ball2, spin_timing_interval_uS)) {
                     GS_LOG_MSG(error, "FindClosestTwoBalls failed.");
                     return false;
@@ -3180,15 +3778,282 @@ namespace golf_sim {
             ShowAndLogBalls("ProcessSpin - Final Spin Balls", strobed_balls_gray_image, finalSpinBalls, kLogIntermediateExposureImagesToFile);
 
 
-            // The best spin analysis will likely be between the two closest balls that are non-overlapping
-            rotationResults = BallImageProc::GetBallRotation(strobed_balls_gray_image, spin_ball1, strobed_balls_gray_image, spin_ball2);
+            // With enough exposures, several of the best pairs are analyzed and their median spin is used
+            std::vector<GsBallPairAndSpinCandidateScoreElement> spin_pairs;
+            cv::Vec3d consensus_rpm;
+            cv::Vec3d dispersion_rpm;
+            int spin_pairs_used = 0;
+            BallImageProc::SpinSearchQuality search_quality = BallImageProc::kSpinSearchComplete;
+
+            if (found_best_spin_balls && kSpinMultiPairCount > 1 &&
+                FindBestSpinBallPairs(strobed_balls_gray_image, non_overlapping_balls_and_timing, true, kSpinMultiPairCount, spin_pairs) &&
+                spin_pairs.size() > 1 &&
+                ComputeMultiPairSpin(strobed_balls_gray_image, spin_pairs, consensus_rpm, dispersion_rpm, spin_pairs_used, search_quality)) {
+
+                // Express the consensus as the rotation over the best pair's interval, so that the
+                // rotation angles and the RPMs agree
+                for (int axis = 0; axis < 3; axis++) {
+                    rotationResults[axis] = consensus_rpm[axis] * 360. * spin_timing_interval_uS / (60. * 1000000.);
+                }
+
+                result_ball.spin_dispersion_RPM_ = dispersion_rpm;
+                result_ball.spin_pairs_used_ = spin_pairs_used;
+            }
+            else {
+                // The best spin analysis will likely be between the two closest balls that are non-overlapping
+                rotationResults = BallImageProc::GetBallRotation(strobed_balls_gray_image, spin_ball1, strobed_balls_gray_image, spin_ball2, &search_quality);
+
+                result_ball.spin_dispersion_RPM_ = cv::Vec3d(0, 0, 0);
+                result_ball.spin_pairs_used_ = 1;
+            }
+
+            result_ball.spin_search_truncated_ = (search_quality != BallImageProc::kSpinSearchComplete);
 
             // TBD - Find the interval between spin_ball1 and spin_ball2
             // 
             // Calculate the spin RPMs into the result ball
             camera.CalculateBallSpinRates(result_ball, rotationResults, (long)std::round(spin_timing_interval_uS));
 
-            result_ball.time_between_angle_measures_for_rpm_uS_ = (long)std::round(spin_timing_interval_uS);
+            result_ball.time_between_angle_measures_for_rpm_uS_ = (long)std::round(spin_timing_interval_uS);
+
+            return true;
+        }
+
+
+        bool GolfSimCamera::ComputeMultiPairSpin(const cv::Mat& strobed_balls_gray_image,
+                                                 const std::vector<GsBallPairAndSpinCandidateScoreElement>& spin_pairs,
+                                                 cv::Vec3d& consensus_rpm,
+                                                 cv::Vec3d& dispersion_rpm,
+                                                 int& pairs_used,
+                                                 BallImageProc::SpinSearchQuality& best_pair_quality) {
+
+            auto start_time = std::chrono::steady_clock::now();
+
+            // One pair per pool thread, plus the calling thread's
+            const size_t number_of_pairs = std::min(spin_pairs.size(), (size_t)GsThreadPool::GetSharedPool().GetNumberOfThreads() + 1);
+
+            // The extra pairs get their own copies, so that nothing they use can go away under
+            // them.  The image copy shares the (unchanging) pixels.
+            const GsAnalysisContext* active_context = GsAnalysisContext::Active();
+            auto context = std::make_shared<GsAnalysisContext>((active_context != nullptr) ? *active_context : GsAnalysisContext::FromCurrentSettings());
+            // Set once the time budget has run out, so that the extra pairs' searches stop early
+            auto cancel = std::make_shared<std::atomic<bool>>(false);
+
+            // Empty if the pair's search was cut short by the cancel
+            std::vector<std::future<std::optional<cv::Vec3d>>> extra_pair_rotations;
+
+            for (size_t i = 1; i < number_of_pairs; i++) {
+                extra_pair_rotations.push_back(GsThreadPool::GetSharedPool().Submit(
+                    [context, cancel, image = strobed_balls_gray_image, ball1 = spin_pairs[i].ball1, ball2 = spin_pairs[i].ball2]() -> std::optional<cv::Vec3d> {
+                        if (cancel->load()) {
+                            return std::nullopt;
+                        }
+
+                        GsAnalysisContext::Scope context_scope(context.get());
+                        BallImageProc::SpinSearchQuality quality = BallImageProc::kSpinSearchComplete;
+                        const cv::Vec3d rotation = BallImageProc::GetBallRotation(image, ball1, image, ball2, &quality, cancel.get());
+
+                        if (cancel->load() && quality != BallImageProc::kSpinSearchComplete) {
+                            return std::nullopt;
+                        }
+                        return rotation;
+                    }));
+            }
+
+            std::vector<cv::Vec3d> pair_rpms;
+
+            auto add_pair_rpm = [&pair_rpms](const cv::Vec3d& rotation, double timing_interval_uS) {
+                GolfBall pair_ball;
+                CalculateBallSpinRates(pair_ball, rotation, (long)std::round(timing_interval_uS));
+                pair_rpms.push_back(pair_ball.rotation_speeds_RPM_);
+            };
+
+            // The best pair is always used
+            add_pair_rpm(BallImageProc::GetBallRotation(strobed_balls_gray_image, spin_pairs[0].ball1, strobed_balls_gray_image, spin_pairs[0].ball2, &best_pair_quality),
+                         spin_pairs[0].timing_interval_uS);
+
+            const auto deadline = start_time + std::chrono::milliseconds(kSpinMultiPairTimeBudgetMs);
+
+            for (size_t i = 0; i < extra_pair_rotations.size(); i++) {
+                std::future<std::optional<cv::Vec3d>>& rotation = extra_pair_rotations[i];
+
+                if (kSpinMultiPairTimeBudgetMs > 0 && rotation.wait_until(deadline) != std::future_status::ready) {
+                    GS_LOG_TRACE_MSG(trace, "ComputeMultiPairSpin - spin ball pair " + std::to_string(i + 1) + " missed the time budget.");
+                    cancel->store(true);
+                    continue;
+                }
+
+                try {
+                    const std::optional<cv::Vec3d> pair_rotation = rotation.get();
+                    if (pair_rotation) {
+                        add_pair_rpm(*pair_rotation, spin_pairs[i + 1].timing_interval_uS);
+                    }
+                }
+                catch (std::exception& ex) {
+                    GS_LOG_MSG(warning, "ComputeMultiPairSpin - spin ball pair " + std::to_string(i + 1) + " failed: " + std::string(ex.what()));
+                }
+            }
+
+            // Pairs that missed the budget stop at their next check.  They are waited for so that
+            // they do not hold up the pool (and the next shot's spin) after this call.
+            for (std::future<std::optional<cv::Vec3d>>& rotation : extra_pair_rotations) {
+                if (rotation.valid()) {
+                    rotation.wait();
+                }
+            }
+
+            if (pair_rpms.size() < 2) {
+                GS_LOG_MSG(info, "ComputeMultiPairSpin - only the best ball pair was analyzed in time.");
+                return false;
+            }
+
+            auto median = [](std::vector<double> values) {
+                const size_t middle = values.size() / 2;
+                std::nth_element(values.begin(), values.begin() + middle, values.end());
+                double result = values[middle];
+
+                if (values.size() % 2 == 0) {
+                    result = (result + *std::max_element(values.begin(), values.begin() + middle)) / 2.0;
+                }
+                return result;
+            };
+
+            for (int axis = 0; axis < 3; axis++) {
+                std::vector<double> values;
+                for (const cv::Vec3d& rpm : pair_rpms) {
+                    values.push_back(rpm[axis]);
+                }
+
+                consensus_rpm[axis] = median(values);
+
+                for (double& value : values) {
+                    value = std::abs(value - consensus_rpm[axis]);
+                }
+
+                dispersion_rpm[axis] = median(values);
+            }
+
+            pairs_used = (int)pair_rpms.size();
+
+            auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+            GS_LOG_MSG(info, "Multi-pair spin (x,y,z) in RPM = " + std::to_string(consensus_rpm[0]) + ", " + std::to_string(consensus_rpm[1]) + ", " +
+                std::to_string(consensus_rpm[2]) + ", dispersion = " + std::to_string(dispersion_rpm[0]) + ", " + std::to_string(dispersion_rpm[1]) + ", " +
+                std::to_string(dispersion_rpm[2]) + " from " + std::to_string(pairs_used) + " of " + std::to_string(number_of_pairs) + " pairs in " +
+                std::to_string(elapsed_ms) + " ms.");
+
+            return true;
+        }
+
+
+        // The spin stage owns copies of everything it touches, so that it can
+        // safely outlive the post-hit processing if it misses its deadline.
+        struct GolfSimCamera::SpinAnalysisTask {
+            GolfSimCamera camera;
+            cv::Mat gray_image;
+            GsBallsAndTimingVector balls;
+            GolfBall ball;
+            cv::Vec3d rotation;
+            // A copy, as the stage can outlive the shot's own context
+            GsAnalysisContext context;
+            bool uses_busy_flag = true;
+            bool success = false;
+            std::atomic<bool> abandoned{ false };
+            std::chrono::steady_clock::time_point start_time;
+            std::future<void> done;
+        };
+
+        // Only one spin analysis may be outstanding at a time.  A straggler from
+        // the prior shot should be long gone, but if not, don't pile on another.
+        static std::atomic<bool> spin_analysis_busy{ false };
+
+        std::shared_ptr<GolfSimCamera::SpinAnalysisTask> GolfSimCamera::StartSpinAnalysis(const GolfSimCamera& camera,
+                                                                                           const cv::Mat& strobed_balls_gray_image,
+                                                                                           const GsBallsAndTimingVector& non_overlapping_balls_and_timing) {
+
+            // Shots that are analyzed in parallel on purpose do not have to wait for each other
+            const GsAnalysisContext* context = GsAnalysisContext::Active();
+            const bool uses_busy_flag = (context == nullptr || context->skip_spin_if_busy);
+
+            if (uses_busy_flag && spin_analysis_busy.exchange(true)) {
+                GS_LOG_MSG(warning, "StartSpinAnalysis - prior spin analysis is still running.  Skipping spin for this shot.");
+                return nullptr;
+            }
+
+            auto task = std::make_shared<SpinAnalysisTask>();
+            task->context = (context != nullptr) ? *context : GsAnalysisContext::FromCurrentSettings();
+            task->uses_busy_flag = uses_busy_flag;
+            task->camera = camera;
+            task->gray_image = strobed_balls_gray_image.clone();
+            task->balls = non_overlapping_balls_and_timing;
+            task->start_time = std::chrono::steady_clock::now();
+
+            task->done = GsThreadPool::GetSharedPool().Submit([task]() {
+                GsAnalysisContext::Scope context_scope(&task->context);
+
+                try {
+                    task->success = ProcessSpin(task->camera, task->gray_image, task->balls, task->ball, task->rotation);
+                }
+                catch (std::exception& ex) {
+                    GS_LOG_MSG(error, "ERROR: *** StartSpinAnalysis - spin analysis threw: " + std::string(ex.what()));
+                    task->success = false;
+                }
+
+                auto stage_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - task->start_time).count();
+
+                if (task->abandoned) {
+                    GS_LOG_MSG(info, "Late spin result (" + std::to_string(stage_ms) + " ms, not delivered): " +
+                                        std::to_string(task->ball.rotation_speeds_RPM_[2]) + " RPM back spin, " +
+                                        std::to_string(task->ball.rotation_speeds_RPM_[0]) + " RPM side spin.");
+                }
+                else {
+                    GS_LOG_TRACE_MSG(trace, "ProcessReceivedCam2Image - spin stage took " + std::to_string(stage_ms) + " ms.");
+                }
+
+                if (task->uses_busy_flag) {
+                    spin_analysis_busy = false;
+                }
+            });
+
+            return task;
+        }
+
+
+        bool GolfSimCamera::FinishSpinAnalysis(SpinAnalysisTask& task,
+                                               GolfBall& result_ball,
+                                               cv::Vec3d& rotationResults,
+                                               const int deadline_ms) {
+
+            auto wait_start_time = std::chrono::steady_clock::now();
+
+            if (deadline_ms < 0) {
+                task.done.wait();
+            }
+            else {
+                auto remaining = std::chrono::milliseconds(deadline_ms) - (wait_start_time - task.start_time);
+
+                if (task.done.wait_for(remaining) != std::future_status::ready) {
+                    task.abandoned = true;
+                    GS_LOG_MSG(warning, "FinishSpinAnalysis - spin analysis did not finish within " + std::to_string(deadline_ms) + " ms.");
+                    return false;
+                }
+            }
+
+            auto wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wait_start_time).count();
+            GS_LOG_TRACE_MSG(trace, "ProcessReceivedCam2Image - waited " + std::to_string(wait_ms) + " ms for the spin stage.");
+
+            if (!task.success) {
+                return false;
+            }
+
+            // Only the spin information comes from the spin stage
+            result_ball.ball_rotation_angles_camera_ortho_perspective_ = task.ball.ball_rotation_angles_camera_ortho_perspective_;
+            result_ball.rotation_speeds_RPM_ = task.ball.rotation_speeds_RPM_;
+            result_ball.time_between_angle_measures_for_rpm_uS_ = task.ball.time_between_angle_measures_for_rpm_uS_;
+            result_ball.spin_dispersion_RPM_ = task.ball.spin_dispersion_RPM_;
+            result_ball.spin_pairs_used_ = task.ball.spin_pairs_used_;
+            result_ball.spin_search_truncated_ = task.ball.spin_search_truncated_;
+            rotationResults = task.rotation;
 
             return true;
         }
@@ -3309,6 +4174,14 @@ namespace golf_sim {
         bool GolfSimCamera::ComputeAveragedStrobedBallData(const GolfSimCamera& camera, const GsBallsAndTimingVector& balls_and_timing,
                                                            GolfBall& output_averaged_ball) {
 
+            if (kUseStrobedTrajectoryFit) {
+                if (FitStrobedBallTrajectory(camera, balls_and_timing, output_averaged_ball)) {
+                    return true;
+                }
+
+                GS_LOG_MSG(warning, "ComputeAveragedStrobedBallData - could not fit a trajectory to the strobed balls.  Averaging the ball pairs instead.");
+            }
+
             std::vector<GolfBall> delta_balls;
 
             // Go through the second-to-last ball on the outer loop, as the inner
@@ -3341,6 +4214,128 @@ namespace golf_sim {
         }
 
 
+        bool GolfSimCamera::FitStrobedBallTrajectory(const GolfSimCamera& camera, const GsBallsAndTimingVector& balls_and_timing,
+                                                     GolfBall& output_ball) {
+
+            const size_t number_of_balls = balls_and_timing.size();
+
+            if (number_of_balls < 2) {
+                GS_LOG_TRACE_MSG(trace, "FitStrobedBallTrajectory - need at least 2 balls.");
+                return false;
+            }
+
+            // The balls are sorted left to right, but each interval is still the time since the
+            // ball before it in the order the balls were imaged, which is right to left for
+            // left-handed shots.  The times here increase left to right either way, which
+            // is the direction the pairwise deltas are taken in.
+            const bool left_handed = (GsAnalysisContext::GolferHandedness() == GolferOrientation::kLeftHanded);
+            std::vector<double> times_us(number_of_balls, 0.0);
+
+            for (size_t k = 1; k < number_of_balls; k++) {
+                const double interval_us = left_handed ? balls_and_timing[k - 1].time_interval_before_ball_us
+                                                       : balls_and_timing[k].time_interval_before_ball_us;
+                if (interval_us <= 0.0) {
+                    GS_LOG_TRACE_MSG(trace, "FitStrobedBallTrajectory - ball " + std::to_string(k) + " has no strobe interval.");
+                    return false;
+                }
+
+                times_us[k] = times_us[k - 1] + interval_us;
+            }
+
+            // Only the first ball is needed in full.  The others just need their positions,
+            // which can all be computed at once unless a ball was found as an ellipse.
+            GolfBall first_ball = balls_and_timing.front().ball;
+
+            if (!ComputeSingleBallXYZOrthoCamPerspective(camera, first_ball)) {
+                GS_LOG_MSG(error, "FitStrobedBallTrajectory - could not ComputeSingleBallXYZOrthoCamPerspective for ball 0");
+                return false;
+            }
+
+            std::vector<float> x(number_of_balls);
+            std::vector<float> y(number_of_balls);
+            std::vector<float> radius(number_of_balls);
+            bool any_ellipses = false;
+
+            for (size_t k = 0; k < number_of_balls; k++) {
+                const GolfBall& ball = balls_and_timing[k].ball;
+                x[k] = ball.x();
+                y[k] = ball.y();
+                radius[k] = (float)CvUtils::CircleRadius(ball.ball_circle_);
+                any_ellipses = any_ellipses || (ball.ball_ellipse_.size.width > 0 && ball.ball_ellipse_.size.height > 0);
+
+                if (radius[k] <= 0.0f) {
+                    GS_LOG_MSG(error, "FitStrobedBallTrajectory - ball " + std::to_string(k) + " has no radius.");
+                    return false;
+                }
+            }
+
+            std::vector<double> distance_x(number_of_balls);
+            std::vector<double> distance_y(number_of_balls);
+            std::vector<double> distance_z(number_of_balls);
+
+            if (!any_ellipses) {
+                GsCameraIntrinsics::FromCameraHardware(camera.camera_hardware_).ComputeBallPositions(number_of_balls, x.data(), y.data(), radius.data(),
+                                                                                                          distance_x.data(), distance_y.data(), distance_z.data());
+            }
+            else {
+                for (size_t k = 0; k < number_of_balls; k++) {
+                    GolfBall ball = balls_and_timing[k].ball;
+
+                    if (!ComputeSingleBallXYZOrthoCamPerspective(camera, ball)) {
+                        GS_LOG_MSG(error, "FitStrobedBallTrajectory - could not ComputeSingleBallXYZOrthoCamPerspective for ball " + std::to_string(k));
+                        return false;
+                    }
+
+                    distance_x[k] = ball.distances_ortho_camera_perspective_[0];
+                    distance_y[k] = ball.distances_ortho_camera_perspective_[1];
+                    distance_z[k] = ball.distances_ortho_camera_perspective_[2];
+                }
+            }
+
+            // Same axes as ComputeXyzDeltaDistances - Ball X is -Camera Z, Ball Y is Camera Y, Ball Z is Camera X
+            std::vector<GsTrajectorySample> samples(number_of_balls);
+
+            for (size_t k = 0; k < number_of_balls; k++) {
+                samples[k] = GsTrajectorySample{ times_us[k] / 1.0e6, cv::Vec3d(-distance_z[k], distance_y[k], distance_x[k]) };
+            }
+
+            GsTrajectoryFit fit;
+            GsTrajectoryFitResult trajectory;
+
+            if (!fit.Fit(samples, trajectory)) {
+                GS_LOG_TRACE_MSG(trace, "FitStrobedBallTrajectory - the least-squares fit failed.");
+                return false;
+            }
+
+            for (int axis = 0; axis < 3; axis++) {
+                const std::vector<bool>& inliers = trajectory.inliers[axis];
+                GS_LOG_TRACE_MSG(trace, "FitStrobedBallTrajectory - axis " + std::to_string(axis) + " used " +
+                    std::to_string(std::count(inliers.begin(), inliers.end(), true)) + " of " + std::to_string(number_of_balls) +
+                    " balls, RMS residual " + std::to_string(trajectory.rms_residual[axis]) + " meters.");
+            }
+
+            // Report the movement over the whole span of the balls, as if it were one (very accurate) ball pair
+            const double span_seconds = samples.back().time_seconds;
+            const cv::Vec3d& v = trajectory.velocity;
+
+            output_ball = first_ball;
+            output_ball.position_deltas_ball_perspective_ = v * span_seconds;
+            output_ball.distance_deltas_camera_perspective_ = cv::Vec3d(v[2], v[1], -v[0]) * span_seconds;
+            output_ball.velocity_ = cv::norm(v);
+            output_ball.time_between_ball_positions_for_velocity_uS_ = (long)std::round(times_us.back());
+
+            if (!getXYDeltaAnglesBallPerspective(output_ball.position_deltas_ball_perspective_, output_ball.angles_ball_perspective_)) {
+                GS_LOG_MSG(error, "FitStrobedBallTrajectory - could not calculate getXYDeltaAnglesBallPerspective");
+                return false;
+            }
+
+            GS_LOG_TRACE_MSG(trace, "FitStrobedBallTrajectory - velocity " + std::to_string(output_ball.velocity_) + " m/s, X,Y angles (ball perspective) " +
+                std::to_string(output_ball.angles_ball_perspective_[0]) + ", " + std::to_string(output_ball.angles_ball_perspective_[1]) + " degrees.");
+
+            return true;
+        }
+
+
         bool GolfSimCamera::FindBestTwoSpinBalls(const cv::Mat& img,
                                                 const GsBallsAndTimingVector& balls_and_timing,
                                                 const bool use_edge_backoffs,
@@ -3348,9 +4343,39 @@ namespace golf_sim {
                                                 GolfBall& output_ball2,
                                                 double& timing_interval_uS) {
 
-            int closest_ball1 = -1;
-            int closest_ball2 = -1;
-            double closest_distance_so_far = 100000;
+            std::vector<GsBallPairAndSpinCandidateScoreElement> best_pairs;
+
+            if (!FindBestSpinBallPairs(img, balls_and_timing, use_edge_backoffs, 1, best_pairs)) {
+                return false;
+            }
+
+            int closest_ball1 = best_pairs[0].ball1_index;
+            int closest_ball2 = best_pairs[0].ball2_index;
+
+            // If necessary, reverse the ball order so that the ball on the left will be first.
+            if (best_pairs[0].ball1.x() > best_pairs[0].ball2.x()) {
+                closest_ball1 = best_pairs[0].ball1_index;
+                closest_ball2 = best_pairs[0].ball2_index;
+            }
+
+            output_ball1 = balls_and_timing[closest_ball1].ball;
+            output_ball2 = balls_and_timing[closest_ball2].ball;
+
+            int index_of_ball_with_interval = std::max(closest_ball1, closest_ball2);
+
+            timing_interval_uS = balls_and_timing[index_of_ball_with_interval].time_interval_before_ball_us;
+
+            return true;
+        }
+
+
+        bool GolfSimCamera::FindBestSpinBallPairs(const cv::Mat& img,
+                                                  const GsBallsAndTimingVector& balls_and_timing,
+                                                  const bool use_edge_backoffs,
+                                                  const int max_pairs,
+                                                  std::vector<GsBallPairAndSpinCandidateScoreElement>& best_pairs) {
+
+            best_pairs.clear();
 
             int minX = kClosestBallPairEdgeBackoffPixels;
             int minY = kClosestBallPairEdgeBackoffPixels;
@@ -3455,7 +4480,7 @@ namespace golf_sim {
                     radius_similarity_score = std::max(0.0, (img.rows / 13.6) - 3.0 * pow((ball1.measured_radius_pixels_ - ball2.measured_radius_pixels_), 2.0)) / 8.;
 
                     // Not implemented yet - TBD
-                    if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kRightHanded) {
+                    if (GsAnalysisContext::GolferHandedness() == GolferOrientation::kRightHanded) {
                         kLegProximityScoreWeighting = 0;
                     }
                     else {
@@ -3506,28 +4531,26 @@ namespace golf_sim {
                 GS_LOG_TRACE_MSG(trace, "Potential Spin Ball Combination of balls ( " + std::to_string(ball_pair_element.ball1_index) + ", " + std::to_string(ball_pair_element.ball2_index) + ") scored: " + spin_ball_score_text);
             }
 
-            // Find the balls with the two highest scores
-
-            closest_ball1 = ball_pair_elements[0].ball1_index;
-            closest_ball2 = ball_pair_elements[0].ball2_index;
+            // Keep the pairs with the highest scores
 
-            if (closest_ball1 == -1 || closest_ball2 == -1) {
+            if (ball_pair_elements[0].ball1_index == -1 || ball_pair_elements[0].ball2_index == -1) {
                 GS_LOG_TRACE_MSG(warning, "Could not find any potential ball pairs for spin analysis");
                 return false;
             }
 
-            // If necessary, reverse the ball order so that the ball on the left will be first.
-            if (ball_pair_elements[0].ball1.x() > ball_pair_elements[0].ball2.x()) {
-                closest_ball1 = ball_pair_elements[0].ball1_index;
-                closest_ball2 = ball_pair_elements[0].ball2_index;
+            if ((int)ball_pair_elements.size() > max_pairs) {
+                ball_pair_elements.resize(std::max(1, max_pairs));
             }
 
-            output_ball1 = balls[closest_ball1];
-            output_ball2 = balls[closest_ball2];
-
-            int index_of_ball_with_interval = std::max(closest_ball1, closest_ball2);
+            // The balls are in time order, so a pair's interval is the sum of the intervals up to its second ball
+            for (GsBallPairAndSpinCandidateScoreElement& ball_pair_element : ball_pair_elements) {
+                ball_pair_element.timing_interval_uS = 0;
+                for (int k = ball_pair_element.ball1_index + 1; k <= ball_pair_element.ball2_index; k++) {
+                    ball_pair_element.timing_interval_uS += balls_and_timing[k].time_interval_before_ball_us;
+                }
+            }
 
-            timing_interval_uS = balls_and_timing[index_of_ball_with_interval].time_interval_before_ball_us;
+            best_pairs = ball_pair_elements;
 
             return true;
         }
@@ -3584,7 +4607,8 @@ namespace golf_sim {
             }
         }
 
-        bool GolfSimCamera::CleanExternalStrobeArtifacts(const cv::Mat &image, cv::Mat& output_image, std::vector<cv::Vec4i>& lines)
+        bool GolfSimCamera::CleanExternalStrobeArtifacts(const cv::Mat &image, cv::Mat& output_image, std::vector<cv::Vec4i>& lines,
+                                                         const cv::Rect& region_of_interest)
         {
             // Filtering out long lines (usually of the golf shaft)
 
@@ -3592,14 +4616,37 @@ namespace golf_sim {
             int h = image.rows;
             int w = image.cols;
 
-            cv::Mat image_gray;
-            cv::Mat cannyOutput;
+            if (kExternallyStrobedEnvPreHoughBlurSize > 0) {
+                if (kExternallyStrobedEnvPreHoughBlurSize % 2 != 1) {
+                    kExternallyStrobedEnvPreHoughBlurSize++;
+                }
+            }
+
+            // The floor band is blacked out below anyway, and pixels outside the region of interest
+            // are never searched, so the conversion, blurs and Canny are only run over what is left.
+            // The margin covers the two blurs plus the Canny's 3x3 gradient and non-maximum suppression.
+            const int region_margin = kExternallyStrobedEnvPreCannyBlurSize / 2 + std::max(0, kExternallyStrobedEnvPreHoughBlurSize / 2) + 2;
+            const int kept_height = std::max(0, h - std::max(0, kExternallyStrobedEnvBottomIgnoreHeight));
+
+            cv::Rect band{ 0, 0, w, h };
+
+            if (!region_of_interest.empty()) {
+                band = cv::Rect(region_of_interest.x - region_margin, region_of_interest.y - region_margin,
+                                region_of_interest.width + 2 * region_margin, region_of_interest.height + 2 * region_margin);
+            }
+            // One more margin below the floor band keeps the last kept rows the same as a full-image pass
+            band &= cv::Rect(0, 0, w, std::min(h, kept_height + region_margin));
+
+            output_image = cv::Mat::zeros(h, w, CV_8UC1);
+
+            if (band.empty() || kept_height == 0) {
+                return true;
+            }
 
-            cv::cvtColor(image, image_gray, cv::COLOR_BGR2GRAY);
+            cv::Mat image_gray;
+            cv::cvtColor(image(band), image_gray, cv::COLOR_BGR2GRAY);
 
             cv::Scalar black_color{ 0,0,0 };
-            cv::Scalar white_color{ 255,255,255 };
-            cv::Scalar red_color{ 0 ,0, 255 };
 
             cv::GaussianBlur(image_gray, image_gray, cv::Size(kExternallyStrobedEnvPreCannyBlurSize, kExternallyStrobedEnvPreCannyBlurSize), 0);
 
@@ -3610,16 +4657,16 @@ namespace golf_sim {
 
             LoggingTools::DebugShowImage("Initial cannyOutput", cannyOutput_for_balls);
 
+            cv::Mat output_band = output_image(band);
+
             if (kExternallyStrobedEnvPreHoughBlurSize > 0) {
-                if (kExternallyStrobedEnvPreHoughBlurSize % 2 != 1) {
-                    kExternallyStrobedEnvPreHoughBlurSize++;
-                }
-                cv::GaussianBlur(cannyOutput_for_balls, cannyOutput_for_balls, cv::Size(kExternallyStrobedEnvPreHoughBlurSize, kExternallyStrobedEnvPreHoughBlurSize), 0);
+                cv::GaussianBlur(cannyOutput_for_balls, output_band, cv::Size(kExternallyStrobedEnvPreHoughBlurSize, kExternallyStrobedEnvPreHoughBlurSize), 0);
+            }
+            else {
+                cannyOutput_for_balls.copyTo(output_band);
             }
 
-            LoggingTools::DebugShowImage("Post-Blur cannyOutput", cannyOutput_for_balls);
-
-            output_image = cannyOutput_for_balls;
+            LoggingTools::DebugShowImage("Post-Blur cannyOutput", output_image);
 
 
 
@@ -3654,9 +4701,9 @@ namespace golf_sim {
             cv::merge(output_image_planes, output_image);
             ***/
 
-            if (kExternallyStrobedEnvBottomIgnoreHeight > 0) {
-                cv::Rect floor_blackout_area{ 0, h - kExternallyStrobedEnvBottomIgnoreHeight, w, h };
-                cv::rectangle(output_image, floor_blackout_area.tl(), floor_blackout_area.br(), black_color, cv::FILLED);
+            // The margin rows that were processed below the kept area are still blacked out
+            if (kept_height < h) {
+                output_image(cv::Rect(0, kept_height, w, h - kept_height)).setTo(black_color);
             }
 
             // LoggingTools::DebugShowImage("External Strobe Final Result Image", output_image);
@@ -3845,17 +4892,6 @@ namespace golf_sim {
                 // There shouldn't be too many missed pulses, but they could occur anywhere, so make sure
                 // that we consider possible collapsed pulses all the way to the end
 
-                std::vector<float>best_pulse_intervals;
-                double best_ratio_distance = 999999.;
-                int best_final_offset_of_distance_ratios = -1;
-                int best_pulses_to_collapse = -1;
-                int best_collapse_offset = -1;
-
-                // We effectively generate all combinations of ways of fitting the <x> 'missing' balls into the <y> possible
-                // positions that exist in the pulse vector.  We had originally been assuming there would just be one 
-                // contiguous group of missing balls, but that turned out not to be true.  So, now go through all combinations
-                // Balls images can go missing anywhere in the pattern for all sorts of reasons.
-
                 int number_ball_exposures = (int)input_balls.size();
 
                 // Add 1 to account for the initial strobe (before the first strobe interval) that is not included in the pulse intervals vector
@@ -3866,150 +4902,86 @@ namespace golf_sim {
                     return false;
                 }
 
-                // We will create a binary bit-vector where a "1" in a position represents a 
-                // pulsed image (and a corresponding pulse) that we are going to pretend is not there.
-                // This vector will then be used to create a set of hypothetical sets of pulses (defined
-                // by pulse intervals) that might have resulted in the same set of images that we
-                // were able to identify as balls in the overall strobed image.  
-                // One of these bit vectors will hopefully match up well with the distance ratios that 
-                // we see in the image, which will then allow us to determine which pulses correspond 
-                // to which intervals between the balls in the image.
-
-                // Each of the resulting candidate vectors will contain zero or more 'true' bits where we will assume we missed
-                // the strobed image at that same (0-based) index of that true bit.  So, 0000011 indicates a scenario in which
-                // the last two pulses were missing from the photo (perhaps because they went off the view port and so
-                // could not be captured by the camera, or maybe the ball-ID just failed for some reason).
-
-                // Note - there might be 0 missing exposures, in which case, we won't have to do any
-                // interval collapsing, and only one pattern will correspond
-                // The one pattern will be 00....00 (as many zeros as there are strobes) which means 
-                // that we assume all strobed images were captured in the photo and so we don't collapse any intervals.
-
+                // A "1" in a missing-balls vector represents a pulsed image (and a corresponding pulse)
+                // that we are going to pretend is not there.  Each such vector defines a hypothetical
+                // set of pulse intervals that might have resulted in the set of ball images that we
+                // found.  One of them will hopefully match up well with the distance ratios that we
+                // see in the image, which then tells us which pulses correspond to which intervals
+                // between the balls in the image.  So, 0000011 indicates that the last two pulses
+                // were missing from the photo (perhaps because they went off the view port, or maybe
+                // the ball-ID just failed for some reason).
+                // Ball images can go missing anywhere in the pattern, so every combination is considered.
+                // All of the combinations for the current pulse sequence are in the strobe-pattern index,
+                // along with their collapsed intervals and ratios.
+
+                // Note - there might be 0 missing exposures, in which case only the 00....00 pattern corresponds
                 int number_of_missing_exposures = number_of_strobes - number_ball_exposures;
 
-                // Start with an all-false vector template into which we will
-                // subsequently set patterns of on-bits that match the number of 
-                // strobes that may be missing missing
-
-                std::vector<bool> missing_balls_vector(number_of_strobes, false);
-                std::vector<std::vector<bool>> candidate_intervals_to_collapse_patterns_vector;
-
-                // Because we're unlikely to have more than 8 or so possible strobes, we will just use a 
-                // brute-force method to figure out all combinations of exposures in the strobe vector.  
-                // This code iterates though all possible numbers of an n-bit number and whenever the number
-                // has the correct number of on-bits (representing strobed ball images that are missing), 
-                // we use that pattern as a possible candidate for how the exposures correllate to the strobes.
-
-                // Note that in many cases, the right-most <n> balls will be missing from the image because
-                // the ball was too fast and went out of view before those strobes were flashed.
-                // This situation is covered by the case in which the last <n-1> intervals are missing. 
+                std::shared_ptr<const StrobePatternIndex> pattern_index = GetStrobePatternIndex(pulse_intervals_from_strobe);
 
-                for (int i = 0; i < (1 << number_of_strobes) - 1; ++i) {
+                // The pulses that went out while camera 2 was not exposing cannot be any of the balls
+                std::vector<bool> pulses_outside_exposure;
+                if (kUseMeasuredStrobeTiming &&
+                    GetPulsesOutsideExposure(GsAnalysisContext::StrobedFrameTiming(), pulse_intervals_from_strobe, pulses_outside_exposure)) {
 
-                    if (CountSetBits(i) == number_of_missing_exposures) {
+                    const int number_outside_exposure = (int)std::count(pulses_outside_exposure.begin(), pulses_outside_exposure.end(), true);
 
-                        // This combination of bits has the right number of on-bits, s
-                        // so we will use it as a candidate pattern of missing exposures
-                        SetPulseVector(i, missing_balls_vector);
-
-                        candidate_intervals_to_collapse_patterns_vector.push_back(missing_balls_vector);
-                        // For debugging, but too detailed to keep in production system - PrintPulseVector(missing_balls_vector);
+                    if (number_outside_exposure > number_of_missing_exposures) {
+                        GS_LOG_MSG(warning, "DetermineStrobeIntervals - " + std::to_string(number_outside_exposure) + " pulses were outside the exposure, but only " +
+                                   std::to_string(number_of_missing_exposures) + " ball images are missing.  Ignoring the measured timing.");
+                        pulses_outside_exposure.clear();
                     }
                 }
 
-                int best_intervals_pattern_index = -1;
-
-                for (int i = 0; i < (int)candidate_intervals_to_collapse_patterns_vector.size(); i++) {
-
-                    std::vector<bool> missing_ball_image_vector = candidate_intervals_to_collapse_patterns_vector[i];
-
-                    PrintPulseVector(missing_ball_image_vector);
+                // If the model said which exposure each ball is, that is the only pattern to consider
+                std::vector<bool> required_missing_pulses = pulses_outside_exposure;
+                std::vector<bool> model_missing_pulses;
+                if (GetPulsesMissingFromModelSequence(input_balls, number_of_strobes, model_missing_pulses)) {
 
-                    // Just a breakpoint trigger for debugging.  Keep this in the code for now
-                    /*
-                    if (missing_ball_image_vector[0] == true &&
-                        missing_ball_image_vector[1] == true &&
-                        missing_ball_image_vector[2] == false &&
-                        missing_ball_image_vector[3] == false &&
-                        missing_ball_image_vector[4] == false &&
-                        missing_ball_image_vector[5] == false &&
-                        missing_ball_image_vector[6] == false &&
-                        missing_ball_image_vector[7] == false) {
-                        GS_LOG_TRACE_MSG(trace, "----------> - Reached the vector of interest.");
+                    bool consistent = true;
+                    for (size_t i = 0; i < pulses_outside_exposure.size() && i < model_missing_pulses.size(); i++) {
+                        if (pulses_outside_exposure[i] && !model_missing_pulses[i]) {
+                            consistent = false;
+                        }
                     }
-                    */
-
-                    // Formulate a new set of pulses intervals that correspond to the current bit vector pattern
-                    // with the pulses corresponding to the 'missing' exposures collapsed/removed.
-
-                    // These next two vectors will hold the hypothetical results of any collapsing of the pulse vector
-                    std::vector<double>pulse_ratios;
-                    std::vector<float>pulse_intervals;
-
-                    std::vector<float> current_pulse_intervals_ms = GetPulseIntervalsNoTrailingZero();
 
-                    if (!GetPulseIntervalsAndRatiosUsingMissingBallsVector(missing_ball_image_vector, current_pulse_intervals_ms, pulse_intervals, pulse_ratios)) {
-                        GS_LOG_TRACE_MSG(error, "Failed to GetPulseIntervalsAndRatiosUsingMissingBallsVector");
-                        return false;
+                    if (consistent) {
+                        required_missing_pulses = model_missing_pulses;
+                        GsMetrics::Increment(GsMetrics::Counter::kModelSequencePatternSearchSkipped);
                     }
-
-                    // Too chatty - turn off - TBD
-                    /*
-                    LoggingTools::Trace("The (potentially collapsed) pulse_intervals were (ignore last '0' interval): ", pulse_intervals);
-                    LoggingTools::Trace("The (potentially collapsed) pulse_ratios were : ", pulse_ratios);
-                    */
-
-                    double delta_to_closest_ratio;
-
-                    // If our set of strobes includes less than the total number strobed balls that we know should have existed, then 
-                    // we need to figure out where this set of <n> strobed images and intervals best fits within the <total> set of pulse intervals.  
-                    // This is because we don't necessarily know which images were the ones that were missed, so we need to try all 
-                    // combinations of missing images and see which one best fits the pattern of distances between the balls that we did find.
-
-                    int best_local_offset_of_distance_ratios = FindClosestRatioPatternMatchOffset(distance_ratios, pulse_ratios, delta_to_closest_ratio, true /* Try any offset */);
-
-
-                    if (IsLikelyMissingBallsPattern(missing_ball_image_vector)) {
-						delta_to_closest_ratio *= 0.5;  // If the pattern is consistent with missing balls, give it a boost in score because it's more likely to be correct
-						GS_LOG_TRACE_MSG(trace, "Pattern is consistent with missing balls, so boosting score.  New delta_to_closest_ratio = " + std::to_string(delta_to_closest_ratio));
+                    else {
+                        GS_LOG_MSG(warning, "DetermineStrobeIntervals - the model's exposure order has a ball from a pulse outside the exposure.  Ignoring the model's order.");
                     }
+                }
 
-                    // If this is the closest match seen so far, save the information
-                    if (best_local_offset_of_distance_ratios >= 0 && delta_to_closest_ratio <= best_ratio_distance) {
-
-                        best_ratio_distance = delta_to_closest_ratio;
-                        best_final_offset_of_distance_ratios = best_local_offset_of_distance_ratios;
-                        best_intervals_pattern_index = i;
+                double best_ratio_distance = 999999.;
+                const StrobePatternIndexEntry* best_pattern = FindClosestStrobePattern(*pattern_index,
+                                                                                        number_of_missing_exposures,
+                                                                                        distance_ratios,
+                                                                                        best_ratio_distance,
+                                                                                        required_missing_pulses);
+
+                if (best_pattern == nullptr && !required_missing_pulses.empty()) {
+                    GS_LOG_MSG(warning, "DetermineStrobeIntervals - no pulse pattern fits the measured timing or the model's exposure order.  Trying every pattern.");
+                    best_pattern = FindClosestStrobePattern(*pattern_index, number_of_missing_exposures, distance_ratios, best_ratio_distance);
+                }
 
-                        GS_LOG_TRACE_MSG(trace, "------------> Found best (so far) pulse ratio pattern match.  best_ratio_distance= " + std::to_string(best_ratio_distance)
-                            + " best_final_offset_of_distance_ratios= " + std::to_string(best_ratio_distance)
-                            + " best_intervals_pattern_index= " + std::to_string(best_intervals_pattern_index) + ".  Vector was : ");
-                        PrintPulseVector(candidate_intervals_to_collapse_patterns_vector[best_intervals_pattern_index]);
-                    }
+                if (best_pattern == nullptr) {
+                    LoggingTools::Warning("DetermineStrobeIntervals could not find any pulse pattern for " + std::to_string(number_ball_exposures) + " ball exposures.");
+                    return false;
                 }
 
-                // In the unlikely event we didn't find ANY best interval, just default it to the first interval (index 0)
-                best_intervals_pattern_index = std::max(0, best_intervals_pattern_index);
+                // Because the number of collapsed pulse ratios is always the same as the
+                // number of distance ratios, the only offset is 0
+                int best_final_offset_of_distance_ratios = 0;
 
-                GS_LOG_TRACE_MSG(trace, "------------> Best-fitting pulse vector was number: " + std::to_string(best_intervals_pattern_index) + ".  With score of: " +
+                GS_LOG_TRACE_MSG(trace, "------------> Best-fitting pulse vector was number: " + std::to_string(best_pattern->order) + ".  With score of: " +
                     std::to_string(best_ratio_distance) + ".  Vector was : ");
-                PrintPulseVector(candidate_intervals_to_collapse_patterns_vector[best_intervals_pattern_index]);
-
-
-                // If we found a best correllation, re-create the corresponding set of ratios and intervals
-                std::vector<double>pulse_ratios;
-                std::vector<float>pulse_intervals;
+                PrintPulseVector(best_pattern->missing_ball_image_vector);
 
                 // We will retrieve the actual pulse interval (in uS) from the list of such intervals.
                 // Just need to figure out WHICH interval corresponds to the two balls of interest.
-                if (!GetPulseIntervalsAndRatiosUsingMissingBallsVector(candidate_intervals_to_collapse_patterns_vector[best_intervals_pattern_index],
-                    PulseStrobe::GetPulseIntervals(),
-                    pulse_intervals,
-                    pulse_ratios)) {
-                    GS_LOG_TRACE_MSG(error, "Failed to GetPulseIntervalsAndRatiosUsingMissingBallsVector");
-                    return false;
-                }
-
+                const std::vector<float>& pulse_intervals = best_pattern->pulse_intervals;
 
                 LoggingTools::Trace("The best set of pulse_intervals was (ignore last '0' interval): ", pulse_intervals);
 
@@ -4085,7 +5057,7 @@ namespace golf_sim {
                 // for a putter  shot where the ball is moving slowly and so we only got a couple of exposures 
                 // by the time the ball made it into the FoV).
 
-                if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
+                if (GsAnalysisContext::ClubType() == GolfSimClubs::kPutter) {
 
                     GS_LOG_MSG(warning, "DetermineStrobeInterval received only two recognized balls - will make a guess that this was the last two exposures.");
 
@@ -4192,6 +5164,18 @@ namespace golf_sim {
 
             output_pulse_intervals = GetPulseIntervalsNoTrailingZero();
 
+            CollapsePulseIntervals(missing_ball_image_vector, output_pulse_intervals);
+
+            // Now that we have the final set of pulse intervals, we can calculate the ratios for that final set of intervals.  
+            // We will later use those ratios to compare to the distance ratios to find the best match.
+
+            ComputePulseIntervalRatiosFromIntervals(output_pulse_intervals, output_pulse_ratios);
+
+            return true;
+        }
+
+        void GolfSimCamera::CollapsePulseIntervals(const std::vector<bool>& missing_ball_image_vector, std::vector<float>& pulse_intervals) {
+
             int initial_pulse_vector_length = (int)missing_ball_image_vector.size();
 
             // Build the pulse interval list to match the (typically shorter) collapsed vector
@@ -4205,98 +5189,271 @@ namespace golf_sim {
 
                     if (v == 0) {
                         // If we are losing the FIRST ball, then lose the first interval entirely and perforn no collapsing, because there is no prior interval to collapse into.
-                        output_pulse_intervals.erase(output_pulse_intervals.begin());
+                        pulse_intervals.erase(pulse_intervals.begin());
                         continue;
                     }
-                    else if (v == (int)output_pulse_intervals.size()) {
+                    else if (v == (int)pulse_intervals.size()) {
                         // If the pulse we are removing is the LAST one, then we just remove it and we don't have to do any collapsing
-                        output_pulse_intervals.pop_back();
+                        pulse_intervals.pop_back();
                         continue;
                     }
                     else {
                         // Otherwise, for the [nth] ball, we will remove the [nth - 1] interval and add that interval's time 
                         // to the new [nth - 1] interval
-                        float prior_interval = output_pulse_intervals[v - 1];
+                        float prior_interval = pulse_intervals[v - 1];
 
-                        output_pulse_intervals.erase(output_pulse_intervals.begin() + (v - 1));
+                        pulse_intervals.erase(pulse_intervals.begin() + (v - 1));
 
                         // We erased the original [v-th] element, so no need to move one back
-                        output_pulse_intervals[v - 1] += prior_interval;
+                        pulse_intervals[v - 1] += prior_interval;
                     }
                 }
             }
+        }
+
+        bool GolfSimCamera::GetPulsesOutsideExposure(const GsStrobedFrameTiming& timing,
+                                                     const std::vector<float>& pulse_intervals_ms,
+                                                     std::vector<bool>& pulses_outside_exposure) {
+
+            pulses_outside_exposure.clear();
+
+            if (!timing.valid) {
+                return false;
+            }
+
+            // The exposure, relative to the first pulse
+            const double exposure_start_us = (timing.sensor_timestamp_ns - timing.strobe_write_start_ns) / 1000.0;
+            const double exposure_end_us = exposure_start_us + (double)timing.exposure_time_us;
+            const double tolerance_us = (double)std::max(0, kStrobeTimingToleranceUs);
+
+            // One more pulse than there are intervals
+            pulses_outside_exposure.assign(pulse_intervals_ms.size() + 1, false);
+
+            double pulse_time_us = 0.0;
+            bool any_outside = false;
+
+            for (size_t i = 0; i < pulses_outside_exposure.size(); i++) {
+                if (i > 0) {
+                    pulse_time_us += 1000.0 * pulse_intervals_ms[i - 1];
+                }
+
+                if (pulse_time_us < exposure_start_us - tolerance_us || pulse_time_us > exposure_end_us + tolerance_us) {
+                    pulses_outside_exposure[i] = true;
+                    any_outside = true;
+                }
+            }
 
-            // Now that we have the final set of pulse intervals, we can calculate the ratios for that final set of intervals.  
-            // We will later use those ratios to compare to the distance ratios to find the best match.
+            GS_LOG_TRACE_MSG(trace, "GolfSimCamera::GetPulsesOutsideExposure - the exposure ran from " + std::to_string(exposure_start_us) + " to " +
+                             std::to_string(exposure_end_us) + " us after the first pulse.  The last pulse was at " + std::to_string(pulse_time_us) + " us.");
 
-            ComputePulseIntervalRatiosFromIntervals(output_pulse_intervals, output_pulse_ratios);
+            if (!any_outside) {
+                pulses_outside_exposure.clear();
+            }
 
-            return true;
+            return any_outside;
         }
 
-        void GolfSimCamera::ComputePulseIntervalRatiosFromIntervals(const std::vector<float>& input_pulse_intervals,
-            std::vector<double>& output_pulse_ratios) {
-            output_pulse_ratios.clear();
+        bool GolfSimCamera::GetPulsesMissingFromModelSequence(const std::vector<GolfBall>& balls,
+                                                              int number_of_strobes,
+                                                              std::vector<bool>& missing_pulses) {
 
-            for (size_t i = 0; i <= input_pulse_intervals.size() - 2; i++) {
+            missing_pulses.clear();
 
-                double ratio = ((double)(input_pulse_intervals[i + 1])) /
-                    ((double)(input_pulse_intervals[i]));
+            if (!BallImageProc::kModelHasSequenceOutputs || balls.empty() || number_of_strobes <= 0) {
+                return false;
+            }
 
-                output_pulse_ratios.push_back(ratio);
+            const double tolerance = 1.0 - BallImageProc::kModelSequenceConfidence;
+
+            std::vector<bool> missing((size_t)number_of_strobes, true);
+            int prior_index = -1;
+
+            for (const GolfBall& b : balls) {
+                if (b.ball_color_ != GolfBall::BallColor::kModelDetected || b.model_exposure_index_ < 0.0) {
+                    return false;
+                }
+
+                const int index = (int)std::lround(b.model_exposure_index_);
+
+                if (std::abs(b.model_exposure_index_ - index) > tolerance || index <= prior_index || index >= number_of_strobes) {
+                    GS_LOG_TRACE_MSG(trace, "GolfSimCamera::GetPulsesMissingFromModelSequence - exposure index " + std::to_string(b.model_exposure_index_) +
+                                     " is not usable.  Not using the model's exposure order.");
+                    return false;
+                }
+
+                missing[index] = false;
+                prior_index = index;
             }
+
+            missing_pulses = missing;
+            return true;
         }
 
-        int GolfSimCamera::FindClosestRatioPatternMatchOffset(const std::vector<double> distance_ratios,
-            const std::vector<double> pulse_ratios,
-            double& delta_to_closest_ratio,
-            bool try_different_offsets) {
+        std::shared_ptr<const GolfSimCamera::StrobePatternIndex> GolfSimCamera::GetStrobePatternIndex(const std::vector<float>& pulse_intervals_ms) {
 
-            // The current offset within the pulse interval ratios at which the pattern
-            // of distance ratios is most closely correlated.
-            delta_to_closest_ratio = 99999.0;
+            // One index for each pulse sequence that has been used, which is usually just the
+            // fast and the slow (putter) sequences
+            static std::mutex index_mutex;
+            static std::vector<std::shared_ptr<const StrobePatternIndex>> indexes;
 
-            // Default offset is zero, such that if the two patterns to compare are the same size,
-            // then there can be only a 0 offset.
-            int closest_timing_interval_offset = 0;
+            std::lock_guard<std::mutex> lock(index_mutex);
 
-            if (pulse_ratios.size() < distance_ratios.size()) {
-                return -1;
+            for (const auto& index : indexes) {
+                if (index->pulse_intervals_ms == pulse_intervals_ms) {
+                    return index;
+                }
+            }
+
+            auto index = std::make_shared<StrobePatternIndex>();
+            index->pulse_intervals_ms = pulse_intervals_ms;
+
+            int number_of_strobes = (int)pulse_intervals_ms.size() + 1;
+            index->patterns_by_missing_count.resize(number_of_strobes + 1);
+
+            std::vector<bool> missing_balls_vector(number_of_strobes, false);
+
+            // Every n-bit pattern other than all-missing.  The bit value is also the order in
+            // which the patterns used to be tried, which decides between equally-good matches.
+            for (int i = 0; i < (1 << number_of_strobes) - 1; ++i) {
+
+                SetPulseVector(i, missing_balls_vector);
+
+                StrobePatternIndexEntry entry;
+                entry.order = i;
+                entry.missing_ball_image_vector = missing_balls_vector;
+                entry.pulse_intervals = pulse_intervals_ms;
+                CollapsePulseIntervals(missing_balls_vector, entry.pulse_intervals);
+
+                // Fewer than two intervals have no ratios to match against
+                if (entry.pulse_intervals.size() < 2) {
+                    continue;
+                }
+
+                ComputePulseIntervalRatiosFromIntervals(entry.pulse_intervals, entry.pulse_ratios);
+                entry.is_likely_missing_balls_pattern = IsLikelyMissingBallsPattern(missing_balls_vector);
+
+                index->patterns_by_missing_count[CountSetBits(i)].push_back(std::move(entry));
+            }
+
+            for (auto& patterns : index->patterns_by_missing_count) {
+                std::sort(patterns.begin(), patterns.end(), [](const StrobePatternIndexEntry& a, const StrobePatternIndexEntry& b)
+                    { return (a.pulse_ratios[0] < b.pulse_ratios[0]); });
+            }
+
+            GS_LOG_TRACE_MSG(trace, "GolfSimCamera::GetStrobePatternIndex - built the strobe-pattern index for " +
+                std::to_string(number_of_strobes) + " strobes.");
+
+            indexes.push_back(index);
+
+            return index;
+        }
+
+        const GolfSimCamera::StrobePatternIndexEntry* GolfSimCamera::FindClosestStrobePattern(const StrobePatternIndex& index,
+                                                                                             int number_of_missing_exposures,
+                                                                                             const std::vector<double>& distance_ratios,
+                                                                                             double& delta_to_closest_ratio,
+                                                                                             const std::vector<bool>& required_missing_pulses) {
+
+            if (distance_ratios.empty() || number_of_missing_exposures < 0 ||
+                number_of_missing_exposures >= (int)index.patterns_by_missing_count.size()) {
+                return nullptr;
             }
 
-            for (int distance_pattern_offset = 0; distance_pattern_offset <= (int)(pulse_ratios.size() - distance_ratios.size()); distance_pattern_offset++) {
+            const std::vector<StrobePatternIndexEntry>& patterns = index.patterns_by_missing_count[number_of_missing_exposures];
+
+            // Must match ComputeRatioDistance's per-ratio limit
+            constexpr double kMaxRatioDistance = 1000.0;
+            // The most that a likely missing-balls pattern's score is reduced by
+            constexpr double kLikelyPatternScoreFactor = 0.5;
 
-                double difference_in_ratios = ComputeRatioDistance(distance_ratios, pulse_ratios, distance_pattern_offset);
+            const StrobePatternIndexEntry* best_pattern = nullptr;
+            delta_to_closest_ratio = 999999.;
 
-                GS_LOG_TRACE_MSG(trace, "difference_in_ratios for offset " + std::to_string(distance_pattern_offset) + " is: " + std::to_string(difference_in_ratios));
+            const double first_distance_ratio = distance_ratios[0];
 
-                // If the current offset of the distance ratios within the pulse ratio pattern
-                // results in the lowest error (distance), then assume it's the best for now.
-                if (difference_in_ratios < delta_to_closest_ratio) {
+            // Work outwards from the patterns whose first ratio is closest to the first distance
+            // ratio.  The first ratio's difference alone bounds a pattern's whole score from below,
+            // so once even that is worse than the best match, no further pattern can be better.
+            auto right = std::lower_bound(patterns.begin(), patterns.end(), first_distance_ratio,
+                [](const StrobePatternIndexEntry& entry, double ratio) { return entry.pulse_ratios[0] < ratio; });
+            auto left = right;
 
-                    // This is the smallest difference we've seen so far, so keep it!
-                    // Also, figure out if the interval is to the left or to the right of the 
-                    // middle ball (depending on which ball we chose as ball 2).
-                    delta_to_closest_ratio = difference_in_ratios;
-                    closest_timing_interval_offset = distance_pattern_offset;
+            while (left != patterns.begin() || right != patterns.end()) {
 
+                bool use_right;
+
+                if (left == patterns.begin()) {
+                    use_right = true;
+                }
+                else if (right == patterns.end()) {
+                    use_right = false;
+                }
+                else {
+                    use_right = (right->pulse_ratios[0] - first_distance_ratio) < (first_distance_ratio - (left - 1)->pulse_ratios[0]);
                 }
 
-                // If we are, for example, enumerating all possible strobe vector patterns,
-                // we will only be interested in a match without any offset.
-                if (!try_different_offsets) {
+                const StrobePatternIndexEntry& entry = use_right ? *right++ : *--left;
+
+                double first_difference = std::min(100. * std::abs(entry.pulse_ratios[0] - first_distance_ratio), kMaxRatioDistance);
+                if (kLikelyPatternScoreFactor * first_difference * first_difference > delta_to_closest_ratio) {
                     break;
                 }
+
+                if (entry.pulse_ratios.size() != distance_ratios.size()) {
+                    continue;
+                }
+
+                if (!required_missing_pulses.empty()) {
+                    bool consistent_with_timing = true;
+
+                    for (size_t i = 0; i < required_missing_pulses.size() && i < entry.missing_ball_image_vector.size(); i++) {
+                        if (required_missing_pulses[i] && !entry.missing_ball_image_vector[i]) {
+                            consistent_with_timing = false;
+                            break;
+                        }
+                    }
+
+                    if (!consistent_with_timing) {
+                        continue;
+                    }
+                }
+
+                int offset = 0;
+                double score = ComputeRatioDistance(distance_ratios, entry.pulse_ratios, offset);
+
+                // Give the patterns that are consistent with missing balls a boost, because they're more likely to be correct
+                if (entry.is_likely_missing_balls_pattern) {
+                    score *= kLikelyPatternScoreFactor;
+                }
+
+                // Ties go to the later pattern, as they did when the patterns were tried in order
+                if (score < delta_to_closest_ratio ||
+                    (score == delta_to_closest_ratio && best_pattern != nullptr && entry.order > best_pattern->order)) {
+                    delta_to_closest_ratio = score;
+                    best_pattern = &entry;
+                }
             }
 
-            return closest_timing_interval_offset;
+            return best_pattern;
         }
 
+        void GolfSimCamera::ComputePulseIntervalRatiosFromIntervals(const std::vector<float>& input_pulse_intervals,
+            std::vector<double>& output_pulse_ratios) {
+            output_pulse_ratios.clear();
+
+            for (size_t i = 0; i <= input_pulse_intervals.size() - 2; i++) {
+
+                double ratio = ((double)(input_pulse_intervals[i + 1])) /
+                    ((double)(input_pulse_intervals[i]));
+
+                output_pulse_ratios.push_back(ratio);
+            }
+        }
 
         // Returns a score of the closeness of the vector of distance_ratios within the pulse_ratios at an offset
         // of the distance_ratios from the beginning of the pulse_ratios
-        double GolfSimCamera::ComputeRatioDistance(const std::vector<double> distance_ratios,
-            const std::vector<double> pulse_ratios,
+        double GolfSimCamera::ComputeRatioDistance(const std::vector<double>& distance_ratios,
+            const std::vector<double>& pulse_ratios,
             int& distance_pattern_offset) {
 
             // TBD - Do some error checking on the inputs
@@ -15,12 +15,16 @@
     See U.S. Patent Application No. 18/428,191 for more details.
 */
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include "logging_tools.h"
 #include "cv_utils.h"
 #include "gs_globals.h"
 #include "camera_hardware.h"
 #include "golf_ball.h"
+#include "gs_color_statistics.h"
+#include "gs_shot_ball_context.h"
 
 namespace golf_sim {
 
@@ -31,6 +35,21 @@ namespace golf_sim {
 
     using GsBallsAndTimingVector = std::vector<GsBallAndTimingElement>;
 
+    // When the external trigger was sent, relative to the camera 1 frame in which
+    // the motion detector first saw the ball move.  Recorded once per shot.
+    // All times are CLOCK_BOOTTIME, which is the clock libcamera's SensorTimestamp uses.
+    struct GsTriggerTiming {
+        bool valid = false;
+        // Start of exposure of the first line of the motion-detection frame
+        int64_t sensor_timestamp_ns = 0;
+        int64_t trigger_sent_ns = 0;
+        int64_t frame_duration_us = 0;
+        int64_t exposure_time_us = 0;
+
+        // How long after the motion-detection frame started exposing the trigger went out
+        int64_t GetTriggerLatencyUs() const { return (trigger_sent_ns - sensor_timestamp_ns) / 1000; }
+    };
+
     // This structure models a multi-dimensional goodness metric between
     // a pair of balls.  A pair with a good score is a candidate to be used
     // to compare to on another to determine ball spin.
@@ -60,8 +79,14 @@ namespace golf_sim {
         double radius_similarity_score = 0;
 
         double total_pair_score = 0;
+
+        // The strobe time between the two balls
+        double timing_interval_uS = 0;
     };
 
+    struct GsAnalysisContext;
+    struct GsStrobedFrameTiming;
+
 
     class GolfSimCamera
     {
@@ -124,6 +149,13 @@ namespace golf_sim {
 
         static int kClosestBallPairEdgeBackoffPixels;
 
+        // If more than 1, the spin is the per-axis median of the spins of up to this many of
+        // the best-scoring ball pairs, which are analyzed in parallel (see ProcessSpin)
+        static int kSpinMultiPairCount;
+        // The extra pairs that have not finished this long after the spin analysis started
+        // are left out of the consensus.  0 means wait for all of them.
+        static int kSpinMultiPairTimeBudgetMs;
+
         static double kMaxIntermediateBallRadiusChangePercent;
         static double kMaxPuttingIntermediateBallRadiusChangePercent;
         static double kMaxOverlappedBallRadiusChangeRatio;
@@ -159,8 +191,31 @@ namespace golf_sim {
         static double kStandardBallSpeedSlowdownPercentage;
         static double kPracticeBallSpeedSlowdownPercentage;
         static double kPuttingBallSpeedSlowdownPercentage;
+
+        // If true, putts are searched for in a downscaled copy of the strobed image
+        // (kPuttingFastPathDetectionScale, e.g., 0.5), and the found circles are scaled
+        // back up.  A putted ball is large and slow, so little accuracy is lost.
+        static bool kPuttingFastPath;
+        static double kPuttingFastPathDetectionScale;
         static bool kCameraRequiresFlushPulse;
 
+        // Called by the motion detector right after it sends the trigger, and read when
+        // the shot is analyzed.  Safe to call from different threads.
+        static void RecordTriggerTiming(const GsTriggerTiming& timing);
+        static GsTriggerTiming GetLastTriggerTiming();
+
+        // Called by the camera 2 capture with the strobed frame's metadata.  The returned timing
+        // also has the strobe write times from PulseStrobe, and is only valid if the frame and
+        // the strobes are from the same shot.
+        static void RecordCamera2FrameTiming(int64_t sensor_timestamp_ns, int64_t exposure_time_us);
+        static GsStrobedFrameTiming GetLastStrobedFrameTiming();
+
+        // If true, and the shot has a valid GsStrobedFrameTiming, the strobe patterns in which
+        // a pulse that fell outside camera 2's exposure (by more than kStrobeTimingToleranceUs)
+        // left a ball image are not considered by DetermineStrobeIntervals
+        static bool kUseMeasuredStrobeTiming;
+        static int kStrobeTimingToleranceUs;
+
         static int kMaxBallsToRetain;
 
         // The following group of constants configure the system that attempts to 
@@ -207,9 +262,17 @@ namespace golf_sim {
 
         static bool kUseOnlyHighQualityBallImagesForHLA;
 
+        // If set, the strobed-ball angles come from one trajectory fit over all of the balls,
+        // rather than from averaging every ball pair.  Off by default.
+        static bool kUseStrobedTrajectoryFit;
+
         // Refers to the camera_hardware device object associated with this higher-level camera object
         CameraHardware camera_hardware_;
 
+        // If not empty, where GsExposurePredictor expects the strobed balls of the current full
+        // swing to be, and the only places that AnalyzeStrobedBalls looks first
+        std::vector<cv::Rect> predicted_exposure_windows_;
+
         GolfSimCamera();
 
         ~GolfSimCamera();
@@ -274,6 +337,10 @@ namespace golf_sim {
                              const int middle_ball_index = -1,
                              const int second_ball_index = -1 );
 
+        // True if ShowAndLogBalls would do anything, so that callers can avoid building
+        // a ball vector just to have it ignored
+        static bool WillShowOrLogBalls(const bool log_image_to_file);
+
         bool GetBallDistancesAndRatios(const std::vector<GolfBall>& balls,
                                              std::vector<double>& distances,
                                              std::vector<double>& distance_ratios);
@@ -368,6 +435,7 @@ namespace golf_sim {
         // Finds the current color information from the image at the point where the ball exists and
         // sets up the corresponding color information
         static void GetBallColorInformation(const cv::Mat& color_image, GolfBall& b);
+        static void GetBallColorInformation(const GsColorStatistics& color_statistics, GolfBall& b);
 
         // Because the strobe timing between different images of the ball can differ from ball-pair to pair,
         // this method helps figure what those intervals are.
@@ -377,20 +445,64 @@ namespace golf_sim {
                                       long& time_between_ball_images_ms,
                                       GsBallsAndTimingVector& return_balls_and_timing);
 
-        void PrintPulseVector(const std::vector<bool>& combinations_vector);
+        static void PrintPulseVector(const std::vector<bool>& combinations_vector);
 
-        int CountSetBits(int n);
+        static int CountSetBits(int n);
 
 	std::vector<float> GetPulseIntervalsNoTrailingZero();
 
-	void ComputePulseIntervalRatiosFromIntervals(const std::vector<float>& input_pulse_intervals, std::vector<double>& output_pulse_ratios); 
-
-        void SetPulseVector(int bit_value, std::vector<bool>& combinations_vector);
-
-        int FindClosestRatioPatternMatchOffset(const std::vector<double> distance_ratios,
-                                               const std::vector<double> pulse_ratios,
-                                               double& delta_to_closest_ratio,
-                                               bool try_different_offsets = true);
+	static void ComputePulseIntervalRatiosFromIntervals(const std::vector<float>& input_pulse_intervals, std::vector<double>& output_pulse_ratios); 
+
+        static void SetPulseVector(int bit_value, std::vector<bool>& combinations_vector);
+
+        // Removes the intervals of the pulses whose ball images are flagged as missing, adding
+        // each removed interval's time to the interval before it
+        static void CollapsePulseIntervals(const std::vector<bool>& missing_ball_image_vector, std::vector<float>& pulse_intervals);
+
+        // One hypothetical pattern of missing ball images, and the pulse intervals and
+        // ratios that the remaining ball images would have
+        struct StrobePatternIndexEntry {
+            int order = 0;     // The pattern's bits, which is also its enumeration order
+            std::vector<bool> missing_ball_image_vector;
+            std::vector<float> pulse_intervals;
+            std::vector<double> pulse_ratios;
+            bool is_likely_missing_balls_pattern = false;
+        };
+
+        // Every missing-ball pattern for one pulse sequence, grouped by the number of missing
+        // balls, and within each group sorted by the first pulse ratio so that the closest
+        // match to a set of distance ratios can be searched for from the nearest first ratio out.
+        // The pulse sequence only changes with the configuration (and between the putter and
+        // the other clubs), so each index is only built once.
+        struct StrobePatternIndex {
+            std::vector<float> pulse_intervals_ms;
+            std::vector<std::vector<StrobePatternIndexEntry>> patterns_by_missing_count;
+        };
+
+        static std::shared_ptr<const StrobePatternIndex> GetStrobePatternIndex(const std::vector<float>& pulse_intervals_ms);
+
+        // Returns the entry whose pulse ratios are closest to the distance_ratios, or nullptr.
+        // If required_missing_pulses is not empty, only the patterns in which each of the
+        // flagged pulses is missing are considered.
+        static const StrobePatternIndexEntry* FindClosestStrobePattern(const StrobePatternIndex& index,
+                                                                       int number_of_missing_exposures,
+                                                                       const std::vector<double>& distance_ratios,
+                                                                       double& delta_to_closest_ratio,
+                                                                       const std::vector<bool>& required_missing_pulses = std::vector<bool>());
+
+        // Flags each pulse that was sent outside of the strobed frame's exposure, and so cannot
+        // have left a ball image.  Returns false (and no flags) if the timing is not valid or
+        // if every pulse was within the exposure.
+        static bool GetPulsesOutsideExposure(const GsStrobedFrameTiming& timing,
+                                             const std::vector<float>& pulse_intervals_ms,
+                                             std::vector<bool>& pulses_outside_exposure);
+
+        // Flags each pulse that, going by the model's exposure index for each of the balls
+        // (in flight order), left no ball image.  Returns false (and no flags) unless every ball
+        // has a confident index and the indices are in order and within the number_of_strobes.
+        static bool GetPulsesMissingFromModelSequence(const std::vector<GolfBall>& balls,
+                                                      int number_of_strobes,
+                                                      std::vector<bool>& missing_pulses);
 
         bool GetPulseIntervalsAndRatiosFromIntervalVector(  const std::vector<bool>& intervals_to_collapse_vector,
                                                             const std::vector<float>& initial_pulse_intervals_ms,
@@ -402,7 +514,7 @@ namespace golf_sim {
             std::vector<float>& pulse_intervals,
             std::vector<double>& pulse_ratios);
 
-        bool IsLikelyMissingBallsPattern(const std::vector<bool>& missing_balls_vector);
+        static bool IsLikelyMissingBallsPattern(const std::vector<bool>& missing_balls_vector);
 
         double GetPerpendicularDistanceFromLine(double x, double y, double x1, double y1, double x2, double y2);
 
@@ -416,9 +528,9 @@ namespace golf_sim {
 
         // Returns a score of the closeness of the vector of distance_ratios within the pulse_ratios at an offset
         // of the distance_ratios from the beginning of the pulse_ratios
-        double ComputeRatioDistance(const std::vector<double> distance_ratios,
-                                    const std::vector<double> pulse_ratios,
-                                    int& distance_pattern_offset);
+        static double ComputeRatioDistance(const std::vector<double>& distance_ratios,
+                                           const std::vector<double>& pulse_ratios,
+                                           int& distance_pattern_offset);
 
         // If we identified a lot of balls, only retain the top <n>
         void RemoveLowScoringBalls(std::vector<GolfBall>& initial_balls, const int max_balls_to_retain);
@@ -451,6 +563,94 @@ namespace golf_sim {
                                           const double max_ball_proximity,
                                           const int max_quality_difference);
 
+        // A compact, one-column-per-field copy of the values that the candidate-ball filters
+        // look at.  The filters drop candidates by editing the (small) order vector instead of
+        // erasing the (large) GolfBall objects, so the GolfBalls are only copied once, for
+        // the survivors, by MaterializeCandidates.  Each of the Remove*Balls methods above is
+        // a wrapper around the corresponding Filter*Candidates method below.
+        struct BallCandidateTable {
+            std::vector<long> x;
+            std::vector<long> y;
+            std::vector<float> circle_x;
+            std::vector<float> circle_y;
+            std::vector<double> radius;
+            std::vector<uint> quality_ranking;
+            std::vector<uint8_t> model_detected;
+
+            // Computed at most once per candidate, on first use
+            std::vector<uint8_t> has_color_statistics;
+            std::vector<GsColorTriplet> average_color;
+            std::vector<GsColorTriplet> median_color;
+            std::vector<GsColorTriplet> std_color;
+
+            // Set by the filters whose decisions do not depend on which other candidates survive,
+            // and then applied all at once by CompactCandidates
+            std::vector<uint8_t> rejected;
+
+            // The rows of the surviving candidates, in their current (quality or X-position) order
+            std::vector<int> order;
+        };
+
+        static void BuildCandidateTable(const std::vector<GolfBall>& balls, BallCandidateTable& table);
+
+        // Returns a copy of the ball in the given row, including any color statistics that were computed for it
+        static GolfBall MaterializeCandidate(const std::vector<GolfBall>& balls, const BallCandidateTable& table, const int row);
+
+        // survivors may be the same vector as balls
+        static void MaterializeCandidates(const std::vector<GolfBall>& balls,
+                                          const BallCandidateTable& table,
+                                          std::vector<GolfBall>& survivors);
+
+        static void ComputeCandidateColorStatistics(const GsColorStatistics& color_statistics,
+                                                    const std::vector<GolfBall>& balls,
+                                                    BallCandidateTable& table,
+                                                    const int row);
+
+        static void CompactCandidates(BallCandidateTable& table);
+
+        void SortCandidatesByXPosition(BallCandidateTable& table);
+
+        void FilterLowScoringCandidates(BallCandidateTable& table, const int max_balls_to_retain);
+
+        void FilterOffTrajectoryCandidates(BallCandidateTable& table,
+                                           const double max_distance_from_trajectory,
+                                           const GolfBall& best_ball,
+                                           const GolfBall& second_best_ball);
+
+        void FilterUnlikelyRadiusChangeCandidates(BallCandidateTable& table,
+                                                  const double max_change_percent,
+                                                  const double max_overlapped_ball_radius_change_ratio,
+                                                  const bool preserve_high_quality_balls = true);
+
+        void FilterWrongColorCandidates(const GsColorStatistics& color_statistics,
+                                        const std::vector<GolfBall>& balls,
+                                        BallCandidateTable& table,
+                                        const GsColorTriplet& expected_rgb_average,
+                                        const GsColorTriplet& expected_rgb_median,
+                                        const GsColorTriplet& expected_rgb_std,
+                                        const double max_strobed_ball_color_difference);
+
+        void FilterUnlikelyAngleLowerQualityCandidates(BallCandidateTable& table);
+
+        void FilterWrongRadiusCandidates(BallCandidateTable& table, const double nominal_radius);
+
+        void FilterNearbyPoorQualityCandidates(BallCandidateTable& table,
+                                               const double max_ball_proximity,
+                                               const int max_quality_difference);
+
+        // Runs the initial (pre-overlap-removal) candidate filters of AnalyzeStrobedBalls over a
+        // single candidate table.  On return, initial_balls holds the survivors sorted by X
+        // position, and best_ball and second_best_ball are the ones the filters last settled on.
+        // Returns false if too few balls survived.
+        bool FilterStrobedBallCandidates(const cv::Mat& strobed_balls_color_image,
+                                         const GsColorStatistics& color_statistics,
+                                         const int min_ball_radius,
+                                         const double max_color_difference,
+                                         const double max_intermediate_ball_radius_change_percent,
+                                         std::vector<GolfBall>& initial_balls,
+                                         GolfBall& best_ball,
+                                         GolfBall& second_best_ball);
+
         void DetermineSecondBall(std::vector<GolfBall>& return_balls,
             const int most_centered_ball_index,
             int& second_ball_index);
@@ -471,12 +671,42 @@ namespace golf_sim {
             GolfBall& ball2,
             double& timing_interval_uS);
 
-        // For each pair of balls, determines the angles and velocity, and then averages
-        // all of them and returns that average in output_averaged_ball
+        // Returns up to max_pairs of the ball pairs, best-scoring first, using the same
+        // scoring as FindBestTwoSpinBalls
+        static bool FindBestSpinBallPairs(const cv::Mat& img,
+            const GsBallsAndTimingVector& balls,
+            const bool use_edge_backoffs,
+            const int max_pairs,
+            std::vector<GsBallPairAndSpinCandidateScoreElement>& best_pairs);
+
+        // Determines the spin of each pair (the first on the calling thread, the others on the
+        // shared pool) and returns the per-axis median and median absolute deviation of their
+        // RPMs.  Returns false if fewer than two of the pairs finished within the time budget.
+        // Pairs that miss it are cancelled, and all of them are done before this returns.
+        static bool ComputeMultiPairSpin(const cv::Mat& strobed_balls_gray_image,
+            const std::vector<GsBallPairAndSpinCandidateScoreElement>& spin_pairs,
+            cv::Vec3d& consensus_rpm,
+            cv::Vec3d& dispersion_rpm,
+            int& pairs_used,
+            BallImageProc::SpinSearchQuality& best_pair_quality);
+
+        // Determines the angles and velocity of the strobed balls as a group.  Uses
+        // FitStrobedBallTrajectory if kUseStrobedTrajectoryFit is set (and the fit works).
+        // Otherwise, determines the angles and velocity for each pair of balls, and
+        // then averages all of them and returns that average in output_averaged_ball
         static bool ComputeAveragedStrobedBallData(const GolfSimCamera& camera, 
                                             const GsBallsAndTimingVector& balls_and_timing,
                                             GolfBall& output_averaged_ball);
 
+        // Fits one constant-velocity trajectory to all of the balls at once, using their strobe
+        // intervals (see gs_trajectory_fit.h), and returns the resulting velocity and angles
+        // in output_ball as if it were the second ball of a left-to-right pair spanning all
+        // of the balls.  Each ball's position is only computed once.  Returns false if any
+        // interval is unknown.
+        static bool FitStrobedBallTrajectory(const GolfSimCamera& camera,
+                                             const GsBallsAndTimingVector& balls_and_timing,
+                                             GolfBall& output_ball);
+
         // Return_balls will hold the set of balls that are non-overlapping with other balls
         // Will also remove/collapse pulse intervals as necessary to ensure they stay 
         // correlated wiht the return_balls vector.
@@ -500,19 +730,49 @@ namespace golf_sim {
                                              cv::Mat& exposures_image,
                                              std::vector<GolfBall>& exposure_balls);
 
+        // Same, but everything about the shot comes from the context rather than from the
+        // process-wide settings (see GsShotAnalysis), so shots can be analyzed in parallel.
+        // The context's golfer_orientation is updated to the handedness that was found.
+        static bool ProcessReceivedCam2Image(const cv::Mat& ball1_mat,
+                                             const cv::Mat& strobed_ball_mat,
+                                             const cv::Mat& camera2_pre_image_color,
+                                             GsAnalysisContext& context,
+                                             GolfBall& result_ball,
+                                             cv::Vec3d& rotationResults,
+                                             cv::Mat& exposures_image,
+                                             std::vector<GolfBall>& exposure_balls);
+
         static bool ProcessSpin(GolfSimCamera& camera, 
                                 const cv::Mat& strobed_balls_gray_image,
                                 const GsBallsAndTimingVector& non_overlapping_balls_and_timing,
                                 GolfBall& result_ball,
                                 cv::Vec3d& rotationResults);
 
+        // The spin analysis runs as its own stage on the shared thread pool.
+        // FinishSpinAnalysis waits for up to deadline_ms after the stage was started
+        // (forever if negative), and only then copies the spin information into
+        // result_ball.  Returns false if the spin failed or missed the deadline.
+        struct SpinAnalysisTask;
+
+        static std::shared_ptr<SpinAnalysisTask> StartSpinAnalysis(const GolfSimCamera& camera,
+                                                                   const cv::Mat& strobed_balls_gray_image,
+                                                                   const GsBallsAndTimingVector& non_overlapping_balls_and_timing);
+
+        static bool FinishSpinAnalysis(SpinAnalysisTask& task,
+                                       GolfBall& result_ball,
+                                       cv::Vec3d& rotationResults,
+                                       const int deadline_ms);
+
         static void DrawFilterLines(const std::vector<cv::Vec4i>& lines,
                                     cv::Mat& image, 
                                     const cv::Scalar& color, 
                                     const int thickness = 1);
 
-        // Returns the lines used to try to remove the golf club shaft artifacts
-        static bool CleanExternalStrobeArtifacts(const cv::Mat& image, cv::Mat& output_image, std::vector<cv::Vec4i>& lines);
+        // Returns the lines used to try to remove the golf club shaft artifacts.
+        // Only the region_of_interest (if not empty) above the ignored floor band is
+        // processed.  The rest of the output_image is black.
+        static bool CleanExternalStrobeArtifacts(const cv::Mat& image, cv::Mat& output_image, std::vector<cv::Vec4i>& lines,
+                                                 const cv::Rect& region_of_interest = cv::Rect());
 
         // Take a single still picture with the specified camera.  May require the Pi 2 (Camera 2) 
         // process to be running if that is the specified camera.
@@ -548,6 +808,10 @@ namespace golf_sim {
 
         // Compute the distance to the ball based on the known radius of the ball in the real world
         static double ComputeDistanceToBallUsingRadius(const GolfSimCamera& camera, const GolfBall& ball);
+
+        // The rest of GetCalibratedBall once the ball's circle is known - the distance to the
+        // ball and its position and angles from the camera
+        static bool ComputeCalibratedBallPosition(const GolfSimCamera& camera, GolfBall& b);
     };
 }
 
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+
+#include "gs_camera2_background.h"
+
+namespace golf_sim {
+
+    bool GsCamera2Background::kUseCamera2BackgroundModel = false;
+    double GsCamera2Background::kCamera2BackgroundModelScale = 0.25;
+    int GsCamera2Background::kCamera2BackgroundModelRefreshMs = 250;
+    double GsCamera2Background::kCamera2BackgroundModelLearningRate = 0.5;
+
+    std::mutex GsCamera2Background::mutex_;
+    cv::Mat GsCamera2Background::accumulated_model_;
+    cv::Mat GsCamera2Background::snapshot_;
+    std::chrono::steady_clock::time_point GsCamera2Background::last_update_time_;
+
+
+    void GsCamera2Background::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kUseCamera2BackgroundModel", kUseCamera2BackgroundModel);
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kCamera2BackgroundModelScale", kCamera2BackgroundModelScale);
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kCamera2BackgroundModelRefreshMs", kCamera2BackgroundModelRefreshMs);
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kCamera2BackgroundModelLearningRate", kCamera2BackgroundModelLearningRate);
+
+        kCamera2BackgroundModelScale = std::clamp(kCamera2BackgroundModelScale, 0.05, 1.0);
+        kCamera2BackgroundModelLearningRate = std::clamp(kCamera2BackgroundModelLearningRate, 0.01, 1.0);
+    }
+
+    bool GsCamera2Background::WantsFrame() {
+        if (!kUseCamera2BackgroundModel) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return accumulated_model_.empty() ||
+            (std::chrono::steady_clock::now() - last_update_time_) >= std::chrono::milliseconds(kCamera2BackgroundModelRefreshMs);
+    }
+
+    void GsCamera2Background::Update(const cv::Mat& undistorted_frame) {
+        if (!kUseCamera2BackgroundModel || undistorted_frame.empty()) {
+            return;
+        }
+
+        // Done before taking the lock, as it is the expensive part
+        cv::Mat small_frame;
+        cv::resize(undistorted_frame, small_frame, cv::Size(), kCamera2BackgroundModelScale, kCamera2BackgroundModelScale, cv::INTER_AREA);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (accumulated_model_.size() != small_frame.size() || accumulated_model_.channels() != small_frame.channels()) {
+            small_frame.convertTo(accumulated_model_, CV_MAKETYPE(CV_32F, small_frame.channels()));
+        }
+        else {
+            cv::accumulateWeighted(small_frame, accumulated_model_, kCamera2BackgroundModelLearningRate);
+        }
+
+        // A new image each time, so that the snapshots already handed out never change
+        cv::Mat new_snapshot;
+        accumulated_model_.convertTo(new_snapshot, CV_MAKETYPE(CV_8U, accumulated_model_.channels()));
+        snapshot_ = new_snapshot;
+
+        last_update_time_ = std::chrono::steady_clock::now();
+
+        GS_LOG_TRACE_MSG(trace, "GsCamera2Background - updated the " + std::to_string(snapshot_.cols) + "x" + std::to_string(snapshot_.rows) + " background model.");
+    }
+
+    cv::Mat GsCamera2Background::Snapshot() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return snapshot_;
+    }
+
+    void GsCamera2Background::Reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        accumulated_model_.release();
+        snapshot_ = cv::Mat();
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A running model of what camera 2 sees with no ball in flight, for the pre-image
+// subtraction in GolfSimCamera::ProcessReceivedCam2Image.  Camera 2 is externally
+// triggered, so the only frames it takes before the hit are the priming-pulse frames.
+// Each shot's priming frames (at most one every kCamera2BackgroundModelRefreshMs) are
+// undistorted in the camera 2 thread and blended into a downscaled model.  At hit time,
+// Snapshot() just hands out the latest (small, never-again-written) model image, so the
+// post-hit path neither waits for nor copies a separate pre-image capture.
+// ProcessReceivedCam2Image scales the snapshot back up to the strobed image's size.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <chrono>
+#include <mutex>
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    class GsCamera2Background {
+
+    public:
+        // If false (the default), the priming frames are ignored and Snapshot() is always empty
+        static bool kUseCamera2BackgroundModel;
+        // The model's size relative to the camera 2 image, e.g., 0.25
+        static double kCamera2BackgroundModelScale;
+        // The shortest time between two updates of the model
+        static int kCamera2BackgroundModelRefreshMs;
+        // How much of each new frame goes into the model.  1 means the model is just the latest frame.
+        static double kCamera2BackgroundModelLearningRate;
+
+        static void LoadConfigurationValues();
+
+        // True if the next priming frame should be passed to Update, so that the camera
+        // thread does not have to undistort the frames that would be ignored anyway
+        static bool WantsFrame();
+
+        // Blends the (undistorted) frame into the model
+        static void Update(const cv::Mat& undistorted_frame);
+
+        // The latest model image, at kCamera2BackgroundModelScale, or an empty image if
+        // there is none yet.  The image is never changed after it is returned.
+        static cv::Mat Snapshot();
+
+        // Forgets the model, e.g., if camera 2's exposure settings have changed
+        static void Reset();
+
+    private:
+        static std::mutex mutex_;
+        // Floating-point, so that small learning rates still move the model
+        static cv::Mat accumulated_model_;
+        static cv::Mat snapshot_;
+        static std::chrono::steady_clock::time_point last_update_time_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
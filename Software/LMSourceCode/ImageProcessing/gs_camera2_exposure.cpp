@@ -0,0 +1,158 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <cmath>
+
+#include "gs_format_lib.h"
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_color_statistics.h"
+
+#include "gs_camera2_exposure.h"
+
+namespace golf_sim {
+
+    bool GsCamera2Exposure::kUseCamera2ExposureControl = false;
+    double GsCamera2Exposure::kCamera2ExposureTargetBrightness = 150.0;
+    double GsCamera2Exposure::kCamera2ExposureMinGainFactor = 0.5;
+    double GsCamera2Exposure::kCamera2ExposureMaxGainFactor = 2.0;
+    double GsCamera2Exposure::kCamera2ExposureSmoothing = 0.3;
+    double GsCamera2Exposure::kCamera2ExposureDeadband = 0.1;
+    double GsCamera2Exposure::kCamera2ExposureMaxStep = 1.25;
+
+    std::mutex GsCamera2Exposure::mutex_;
+    GsCamera2Exposure::ControlState GsCamera2Exposure::state_[2];
+
+
+    void GsCamera2Exposure::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kUseCamera2ExposureControl", kUseCamera2ExposureControl);
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kCamera2ExposureTargetBrightness", kCamera2ExposureTargetBrightness);
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kCamera2ExposureMinGainFactor", kCamera2ExposureMinGainFactor);
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kCamera2ExposureMaxGainFactor", kCamera2ExposureMaxGainFactor);
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kCamera2ExposureSmoothing", kCamera2ExposureSmoothing);
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kCamera2ExposureDeadband", kCamera2ExposureDeadband);
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kCamera2ExposureMaxStep", kCamera2ExposureMaxStep);
+
+        kCamera2ExposureTargetBrightness = std::clamp(kCamera2ExposureTargetBrightness, 1.0, 255.0);
+        kCamera2ExposureMinGainFactor = std::clamp(kCamera2ExposureMinGainFactor, 0.01, 1.0);
+        kCamera2ExposureMaxGainFactor = std::max(kCamera2ExposureMaxGainFactor, 1.0);
+        kCamera2ExposureSmoothing = std::clamp(kCamera2ExposureSmoothing, 0.01, 1.0);
+        kCamera2ExposureDeadband = std::clamp(kCamera2ExposureDeadband, 0.0, 0.5);
+        kCamera2ExposureMaxStep = std::max(kCamera2ExposureMaxStep, 1.0);
+
+        Reset();
+    }
+
+    double GsCamera2Exposure::GetGain(bool putting, double configured_gain) {
+        if (!kUseCamera2ExposureControl) {
+            return configured_gain;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        ControlState& state = state_[putting ? 1 : 0];
+
+        // The history means nothing once the starting point has been re-configured
+        if (state.configured_gain != configured_gain) {
+            state = ControlState();
+            state.configured_gain = configured_gain;
+        }
+
+        state.armed_gain = (state.next_gain > 0.0) ? state.next_gain : configured_gain;
+
+        return state.armed_gain;
+    }
+
+    void GsCamera2Exposure::RecordShot(const cv::Mat& strobed_image, const std::vector<GolfBall>& exposure_balls, bool putting) {
+        if (!kUseCamera2ExposureControl || strobed_image.empty() || exposure_balls.empty()) {
+            return;
+        }
+
+        // Measured before taking the lock, as it reads the image
+        std::vector<GsCircle> circles;
+        for (const GolfBall& ball : exposure_balls) {
+            circles.push_back(ball.ball_circle_);
+        }
+        GsColorStatistics color_statistics(strobed_image, circles);
+
+        // A mono image only has the first channel of each triplet
+        const int channels = std::clamp(strobed_image.channels(), 1, 3);
+        double total_brightness = 0.0;
+        double total_contrast = 0.0;
+        int measured_balls = 0;
+
+        for (const GsCircle& circle : circles) {
+            std::vector<GsColorTriplet> stats = color_statistics.GetBallColorRgb(circle);
+            if (stats.size() < 3) {
+                continue;
+            }
+
+            for (int c = 0; c < channels; c++) {
+                total_brightness += stats[0][c] / channels;
+                total_contrast += stats[2][c] / channels;
+            }
+            measured_balls++;
+        }
+
+        if (measured_balls == 0) {
+            return;
+        }
+
+        const double brightness = total_brightness / measured_balls;
+        const double contrast = total_contrast / measured_balls;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        ControlState& state = state_[putting ? 1 : 0];
+
+        // The shot was not armed through GetGain, e.g., right after a Reset
+        if (state.armed_gain <= 0.0 || brightness <= 0.0) {
+            return;
+        }
+
+        // Below saturation, the brightness goes up with the gain, so readings taken at
+        // different gains can be smoothed together
+        const double brightness_per_gain = brightness / state.armed_gain;
+        state.brightness_per_gain = (state.brightness_per_gain <= 0.0) ? brightness_per_gain :
+            kCamera2ExposureSmoothing * brightness_per_gain + (1.0 - kCamera2ExposureSmoothing) * state.brightness_per_gain;
+
+        const double wanted_gain = kCamera2ExposureTargetBrightness / state.brightness_per_gain;
+        double next_gain = state.armed_gain;
+
+        if (std::abs(wanted_gain / state.armed_gain - 1.0) > kCamera2ExposureDeadband) {
+            next_gain *= std::clamp(wanted_gain / state.armed_gain, 1.0 / kCamera2ExposureMaxStep, kCamera2ExposureMaxStep);
+        }
+
+        next_gain = std::clamp(next_gain, kCamera2ExposureMinGainFactor * state.configured_gain,
+                                          kCamera2ExposureMaxGainFactor * state.configured_gain);
+
+        const std::string summary = std::string(putting ? "putting" : "full swing") + " ball brightness " +
+                                    GS_FORMATLIB_FORMAT("{:.1f}", brightness) + " (contrast " +
+                                    GS_FORMATLIB_FORMAT("{:.1f}", contrast) + ") at gain " +
+                                    GS_FORMATLIB_FORMAT("{:.2f}", state.armed_gain);
+
+        if (next_gain != state.armed_gain) {
+            GS_LOG_MSG(info, "GsCamera2Exposure - " + summary + ".  The next gain is " + GS_FORMATLIB_FORMAT("{:.2f}", next_gain) + ".");
+        }
+        else {
+            GS_LOG_TRACE_MSG(trace, "GsCamera2Exposure - " + summary + ".  Keeping the gain.");
+        }
+
+        state.next_gain = next_gain;
+    }
+
+    void GsCamera2Exposure::Reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        state_[0] = ControlState();
+        state_[1] = ControlState();
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
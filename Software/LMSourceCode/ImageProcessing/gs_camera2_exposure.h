@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A feedback loop for camera 2's analogue gain.  kCamera2Gain and kCamera2PuttingGain are
+// otherwise fixed, so a darker room (or a worn ball) leaves the strobed balls dim, which
+// sends GetBall's adaptive Hough search through many more passes, and often to a failure.
+// After each successful shot, RecordShot measures the mean brightness of the exposure
+// balls (with the same GsColorStatistics as GetBallColorInformation) and divides it by the
+// gain that the shot was taken with.  That brightness-per-unit-gain is smoothed over the
+// recent shots, and at the next arm time GetGain returns the gain that should bring the
+// balls to kCamera2ExposureTargetBrightness.  The gain moves by no more than
+// kCamera2ExposureMaxStep per shot, not at all while it is within kCamera2ExposureDeadband
+// of the target, and never outside kCamera2ExposureMin/MaxGainFactor times the configured
+// gain.  Putting and full swings have separate state, as they start from separate gains.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "golf_ball.h"
+
+namespace golf_sim {
+
+    class GsCamera2Exposure {
+
+    public:
+        // If false (the default), GetGain returns the configured gain
+        static bool kUseCamera2ExposureControl;
+        // The mean of the ball pixels (0-255, averaged over the channels) to aim for
+        static double kCamera2ExposureTargetBrightness;
+        // The gain is kept within these multiples of kCamera2Gain (or kCamera2PuttingGain)
+        static double kCamera2ExposureMinGainFactor;
+        static double kCamera2ExposureMaxGainFactor;
+        // How much each new shot counts in the smoothed brightness.  1 means only the latest shot.
+        static double kCamera2ExposureSmoothing;
+        // The fraction of the target within which the gain is left alone
+        static double kCamera2ExposureDeadband;
+        // The largest ratio between one shot's gain and the next
+        static double kCamera2ExposureMaxStep;
+
+        static void LoadConfigurationValues();
+
+        // The gain to arm camera 2 with, given the configured one.  The returned gain is
+        // remembered as the one that the next RecordShot's image was taken with.
+        static double GetGain(bool putting, double configured_gain);
+
+        // Feeds back the brightness of a successfully analyzed shot's exposure balls
+        static void RecordShot(const cv::Mat& strobed_image, const std::vector<GolfBall>& exposure_balls, bool putting);
+
+        // Forgets the history, e.g., if the configured gains have changed
+        static void Reset();
+
+    private:
+        struct ControlState {
+            // The configured gain that the state is for
+            double configured_gain = 0.0;
+            // The gain that camera 2 was last armed with
+            double armed_gain = 0.0;
+            // The gain to use for the next shot, or 0 if there has been no shot yet
+            double next_gain = 0.0;
+            // The smoothed ball brightness per unit of gain, or 0 if there has been no shot yet
+            double brightness_per_gain = 0.0;
+        };
+
+        static std::mutex mutex_;
+        // Indexed by whether the shot is a putt
+        static ControlState state_[2];
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
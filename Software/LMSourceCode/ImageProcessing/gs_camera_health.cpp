@@ -0,0 +1,213 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+
+#include <libcamera/control_ids.h>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+
+#include "gs_camera_health.h"
+
+namespace golf_sim {
+
+    // Well beyond the ~100 ms that a re-started stream takes to deliver its first frame
+    int GsCameraHealth::kCameraHealthStallTimeoutMs = 1000;
+    double GsCameraHealth::kCameraHealthLateFrameFactor = 2.0;
+    int GsCameraHealth::kCameraHealthHealthyFramesToReset = 100;
+    int GsCameraHealth::kCameraHealthMaxRecoveries = 6;
+    bool GsCameraHealth::kCameraHealthTryRequeue = true;
+
+    // Only ever added to as a watch ends, from the thread that ran the watch
+    GsCameraHealth::Counters GsCameraHealth::camera_totals_[kGsCamera2 + 1];
+
+
+    void GsCameraHealth::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kCameraHealthStallTimeoutMs", kCameraHealthStallTimeoutMs);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kCameraHealthLateFrameFactor", kCameraHealthLateFrameFactor);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kCameraHealthHealthyFramesToReset", kCameraHealthHealthyFramesToReset);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kCameraHealthMaxRecoveries", kCameraHealthMaxRecoveries);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kCameraHealthTryRequeue", kCameraHealthTryRequeue);
+
+        kCameraHealthStallTimeoutMs = std::max(kCameraHealthStallTimeoutMs, 100);
+        kCameraHealthLateFrameFactor = std::max(kCameraHealthLateFrameFactor, 1.0);
+        kCameraHealthHealthyFramesToReset = std::max(kCameraHealthHealthyFramesToReset, 1);
+        kCameraHealthMaxRecoveries = std::max(kCameraHealthMaxRecoveries, 1);
+    }
+
+    char const* GsCameraHealth::RecoveryName(GsCameraRecovery tier) {
+        switch (tier) {
+            case GsCameraRecovery::kRequeue:
+                return "re-queue";
+            case GsCameraRecovery::kRestartStream:
+                return "stream re-start";
+            case GsCameraRecovery::kReconfigure:
+                return "re-configure";
+            case GsCameraRecovery::kReopen:
+                return "re-open";
+            default:
+                return "none";
+        }
+    }
+
+    GsCameraHealth::GsCameraHealth(GsCameraNumber camera_number, const std::string& loop_name, double expected_fps)
+        : camera_number_(camera_number), loop_name_(loop_name) {
+        expected_interval_us_ = (expected_fps > 0.0) ? 1.0e6 / expected_fps : 0.0;
+    }
+
+    GsCameraHealth::~GsCameraHealth() {
+        Counters& totals = camera_totals_[camera_number_];
+
+        totals.frames += watch_.frames;
+        totals.timeouts += watch_.timeouts;
+        totals.stalls += watch_.stalls;
+        totals.dropped_frames += watch_.dropped_frames;
+        totals.late_frames += watch_.late_frames;
+        totals.max_queue_depth = std::max(totals.max_queue_depth, watch_.max_queue_depth);
+        for (int i = 0; i < kNumRecoveryTiers; i++) {
+            totals.recoveries[i] += watch_.recoveries[i];
+            totals.failed_recoveries[i] += watch_.failed_recoveries[i];
+        }
+
+        GsMetrics::SetGauge(GsMetrics::Gauge::kCameraMessageQueueMaxDepth, (double)watch_.max_queue_depth);
+
+        LogCounters(loop_name_ + " on camera " + std::to_string((int)camera_number_) + " - this watch had ", watch_);
+        LogCounters("Camera " + std::to_string((int)camera_number_) + " has had ", totals);
+    }
+
+    void GsCameraHealth::LogCounters(const std::string& prefix, const Counters& counters) const {
+        std::string recoveries;
+        for (int i = 0; i < kNumRecoveryTiers; i++) {
+            recoveries += (i == 0 ? "" : ", ") + std::string(RecoveryName((GsCameraRecovery)(i + 1))) + " " +
+                          std::to_string(counters.recoveries[i]) + " (" + std::to_string(counters.failed_recoveries[i]) + " failed)";
+        }
+
+        const std::string message = "GsCameraHealth - " + prefix + std::to_string(counters.frames) + " frames, " +
+                                    std::to_string(counters.timeouts) + " timeouts, " + std::to_string(counters.stalls) + " stalls, " +
+                                    std::to_string(counters.dropped_frames) + " dropped and " + std::to_string(counters.late_frames) +
+                                    " late frames, and a queue depth of up to " + std::to_string(counters.max_queue_depth) +
+                                    ".  Recoveries: " + recoveries + ".";
+
+        // Only a watch that had a problem is worth more than a trace
+        if (&counters == &watch_ && (counters.timeouts > 0 || counters.stalls > 0 || counters.dropped_frames > 0)) {
+            GS_LOG_MSG(warning, message);
+        }
+        else {
+            GS_LOG_TRACE_MSG(trace, message);
+        }
+    }
+
+    void GsCameraHealth::RecordFrame(const CompletedRequest& request, size_t pending_messages) {
+        watch_.frames++;
+        watch_.max_queue_depth = std::max(watch_.max_queue_depth, pending_messages);
+
+        auto sensor_sequence = request.metadata.get(libcamera::controls::SensorSequence);
+        if (sensor_sequence) {
+            const int64_t sequence = *sensor_sequence;
+            if (have_sensor_sequence_ && sequence > last_sensor_sequence_ + 1) {
+                watch_.dropped_frames += sequence - last_sensor_sequence_ - 1;
+                GsMetrics::Increment(GsMetrics::Counter::kCameraDroppedFrames, sequence - last_sensor_sequence_ - 1);
+            }
+            last_sensor_sequence_ = sequence;
+            have_sensor_sequence_ = true;
+        }
+
+        // The first frame of a (re-)started camera has no interval
+        if (request.framerate > 0.0f) {
+            const double interval_us = 1.0e6 / request.framerate;
+            const double expected_interval_us = (expected_interval_us_ > 0.0) ? expected_interval_us_ :
+                                                (intervals_ > 0) ? total_interval_us_ / intervals_ : 0.0;
+
+            if (expected_interval_us > 0.0 && interval_us > kCameraHealthLateFrameFactor * expected_interval_us) {
+                watch_.late_frames++;
+                GsMetrics::Increment(GsMetrics::Counter::kCameraLateFrames);
+            }
+
+            total_interval_us_ += interval_us;
+            intervals_++;
+        }
+
+        if (recoveries_since_healthy_ > 0 && ++healthy_frames_ >= kCameraHealthHealthyFramesToReset) {
+            GS_LOG_TRACE_MSG(trace, "GsCameraHealth - camera " + std::to_string((int)camera_number_) + " is healthy again after " +
+                                    std::to_string(recoveries_since_healthy_) + " recoveries.");
+            recoveries_since_healthy_ = 0;
+            next_tier_ = GsCameraRecovery::kRequeue;
+            healthy_frames_ = 0;
+        }
+    }
+
+    GsCameraRecovery GsCameraHealth::RecordTimeout() {
+        watch_.timeouts++;
+        GsMetrics::Increment(GsMetrics::Counter::kCameraTimeouts);
+        return FirstTier(GsCameraRecovery::kRequeue);
+    }
+
+    GsCameraRecovery GsCameraHealth::RecordStall() {
+        watch_.stalls++;
+        GsMetrics::Increment(GsMetrics::Counter::kCameraStalls);
+        return FirstTier(GsCameraRecovery::kRestartStream);
+    }
+
+    GsCameraRecovery GsCameraHealth::FirstTier(GsCameraRecovery cheapest_tier) {
+        healthy_frames_ = 0;
+
+        if (recoveries_since_healthy_ >= kCameraHealthMaxRecoveries) {
+            GS_LOG_MSG(error, "GsCameraHealth - camera " + std::to_string((int)camera_number_) + " has not stayed up after " +
+                              std::to_string(recoveries_since_healthy_) + " recoveries.  Giving up.");
+            return GsCameraRecovery::kNone;
+        }
+
+        GsCameraRecovery tier = std::max(next_tier_, cheapest_tier);
+        if (tier == GsCameraRecovery::kRequeue && !kCameraHealthTryRequeue) {
+            tier = GsCameraRecovery::kRestartStream;
+        }
+
+        return tier;
+    }
+
+    GsCameraRecovery GsCameraHealth::RecordRecovery(GsCameraRecovery tier, bool succeeded) {
+        if (tier == GsCameraRecovery::kNone) {
+            return GsCameraRecovery::kNone;
+        }
+
+        const int tier_index = (int)tier - 1;
+        recoveries_since_healthy_++;
+        watch_.recoveries[tier_index]++;
+        GsMetrics::Increment(GsMetrics::Counter::kCameraRecoveries);
+
+        // The re-started stream does not carry on with the old sequence numbers
+        if (tier != GsCameraRecovery::kRequeue) {
+            have_sensor_sequence_ = false;
+        }
+
+        // If the problem comes back before the camera is healthy again, this tier did not
+        // really fix it, so the next attempt starts one higher
+        const GsCameraRecovery next_tier = (tier == GsCameraRecovery::kReopen) ? GsCameraRecovery::kReopen :
+                                           (GsCameraRecovery)((int)tier + 1);
+        next_tier_ = std::max(next_tier_, next_tier);
+
+        if (succeeded) {
+            GS_LOG_TRACE_MSG(trace, "GsCameraHealth - camera " + std::to_string((int)camera_number_) + " " + RecoveryName(tier) + " done.");
+            return GsCameraRecovery::kNone;
+        }
+
+        watch_.failed_recoveries[tier_index]++;
+        GsMetrics::Increment(GsMetrics::Counter::kCameraFailedRecoveries);
+        GS_LOG_MSG(warning, "GsCameraHealth - camera " + std::to_string((int)camera_number_) + " " + RecoveryName(tier) + " failed.");
+
+        if (tier == GsCameraRecovery::kReopen || recoveries_since_healthy_ >= kCameraHealthMaxRecoveries) {
+            return GsCameraRecovery::kNone;
+        }
+
+        return next_tier_;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
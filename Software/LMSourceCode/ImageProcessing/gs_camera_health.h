@@ -0,0 +1,124 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Keeps track of how well a camera's watcher loop is being fed, and picks how to recover
+// when the feed breaks.
+// Each watch keeps counts of the device timeouts, stalls (no frame at all within
+// kCameraHealthStallTimeoutMs), dropped frames (gaps in the sensor's frame sequence), late
+// frames (intervals of more than kCameraHealthLateFrameFactor times the expected one) and
+// the deepest that the app's message queue got.  The counts are also added up per camera
+// over all of the watches, and both are logged when the watch is over.
+// A timeout or stall is recovered at the cheapest tier that has not already failed since
+// the camera was last healthy:
+//    1) re-queue the requests that the timeout cancelled,
+//    2) stop and re-start the stream,
+//    3) tear down and re-configure the camera, and
+//    4) close and re-open the camera.
+// A stall is never just re-queued, as there is nothing cancelled to re-queue.  Once
+// kCameraHealthHealthyFramesToReset frames have come in since the last problem, the next
+// one starts back at the first tier.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "gs_options.h"
+#include "core/completed_request.hpp"
+
+namespace golf_sim {
+
+    enum class GsCameraRecovery {
+        kNone = 0,
+        kRequeue,
+        kRestartStream,
+        kReconfigure,
+        kReopen
+    };
+
+    class GsCameraHealth {
+
+    public:
+        // How long to wait for a frame before the stream is taken to have stalled
+        static int kCameraHealthStallTimeoutMs;
+        // A frame interval of more than this many expected intervals counts as late
+        static double kCameraHealthLateFrameFactor;
+        // The frames that must come in after a problem before the recovery starts over at
+        // the cheapest tier
+        static int kCameraHealthHealthyFramesToReset;
+        // The recoveries that can be tried without a healthy run in between, before the
+        // watcher loop gives up and leaves it to its caller
+        static int kCameraHealthMaxRecoveries;
+        // If false, the first tier is a stream re-start, as it was before
+        static bool kCameraHealthTryRequeue;
+
+        static void LoadConfigurationValues();
+
+        static char const* RecoveryName(GsCameraRecovery tier);
+
+        // expected_fps is the rate that the camera was asked for, or 0 to use the
+        // watch's running mean interval instead
+        GsCameraHealth(GsCameraNumber camera_number, const std::string& loop_name, double expected_fps);
+
+        // Logs the watch's and the camera's counts
+        ~GsCameraHealth();
+
+        // Called for each frame that the loop gets, with the number of messages that were
+        // still waiting in the app's queue.  Does not allocate.
+        void RecordFrame(const CompletedRequest& request, size_t pending_messages);
+
+        // Each returns the tier to try first, or kNone if the loop should give up
+        GsCameraRecovery RecordTimeout();
+        GsCameraRecovery RecordStall();
+
+        // Records how the tier went.  If it failed, returns the next tier up to try, or
+        // kNone if there is none left.
+        GsCameraRecovery RecordRecovery(GsCameraRecovery tier, bool succeeded);
+
+    private:
+        static const int kNumRecoveryTiers = 4;
+
+        struct Counters {
+            uint64_t frames = 0;
+            unsigned int timeouts = 0;
+            unsigned int stalls = 0;
+            uint64_t dropped_frames = 0;
+            uint64_t late_frames = 0;
+            size_t max_queue_depth = 0;
+            unsigned int recoveries[kNumRecoveryTiers] = {};
+            unsigned int failed_recoveries[kNumRecoveryTiers] = {};
+        };
+
+        GsCameraRecovery FirstTier(GsCameraRecovery cheapest_tier);
+        void LogCounters(const std::string& prefix, const Counters& counters) const;
+
+        // Indexed by camera number
+        static Counters camera_totals_[kGsCamera2 + 1];
+
+        GsCameraNumber camera_number_;
+        std::string loop_name_;
+        double expected_interval_us_ = 0.0;
+
+        Counters watch_;
+
+        // Recoveries tried since the camera was last healthy
+        int recoveries_since_healthy_ = 0;
+        // The cheapest tier that has not failed since the camera was last healthy
+        GsCameraRecovery next_tier_ = GsCameraRecovery::kRequeue;
+        int healthy_frames_ = 0;
+
+        bool have_sensor_sequence_ = false;
+        int64_t last_sensor_sequence_ = 0;
+
+        double total_interval_us_ = 0.0;
+        uint64_t intervals_ = 0;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,149 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "cv_utils.h"
+#include "golf_ball.h"
+#include "gs_camera_intrinsics.h"
+
+namespace golf_sim {
+
+    GsCameraIntrinsics GsCameraIntrinsics::FromCameraHardware(const CameraHardware& camera) {
+
+        GsCameraIntrinsics intrinsics;
+
+        // See GolfSimCamera::convertXDistanceToMeters, convertYDistanceToMeters and
+        // ComputeDistanceToBallUsingRadius.  GolfBall::kBallRadiusMeters is read now.
+        intrinsics.center_x = std::round(camera.resolution_x_ / 2.0);
+        intrinsics.center_y = std::round(camera.resolution_y_ / 2.0);
+        intrinsics.meters_per_pixel_x = (double)camera.sensor_width_ / ((double)camera.focal_length_ * camera.resolution_x_);
+        intrinsics.meters_per_pixel_y = (double)camera.sensor_height_ / ((double)camera.focal_length_ * camera.resolution_y_);
+        intrinsics.distance_times_radius = camera.resolution_x_ * GolfBall::kBallRadiusMeters * camera.focal_length_ / camera.sensor_width_;
+
+        const double angle_x = CvUtils::DegreesToRadians(camera.camera_angles_[0]);
+        const double angle_y = CvUtils::DegreesToRadians(camera.camera_angles_[1]);
+        intrinsics.cos_angle_x = std::cos(angle_x);
+        intrinsics.sin_angle_x = std::sin(angle_x);
+        intrinsics.cos_angle_y = std::cos(angle_y);
+        intrinsics.sin_angle_y = std::sin(angle_y);
+
+        // See GolfSimCamera::computeFocalDistanceFromBallData and GetExpectedBallRadiusPixelsUsingKnownFocalLength
+        intrinsics.focal_length_per_radius_distance = (double)camera.sensor_width_ / (camera.resolution_x_ * GolfBall::kBallRadiusMeters);
+        intrinsics.radius_distance_per_resolution_x = (double)camera.focal_length_ * GolfBall::kBallRadiusMeters / camera.sensor_width_;
+
+        intrinsics.focal_length_ = camera.focal_length_;
+        intrinsics.sensor_width_ = camera.sensor_width_;
+        intrinsics.sensor_height_ = camera.sensor_height_;
+        intrinsics.resolution_x_ = camera.resolution_x_;
+        intrinsics.resolution_y_ = camera.resolution_y_;
+        intrinsics.camera_angles_ = camera.camera_angles_;
+        intrinsics.ball_radius_meters_ = GolfBall::kBallRadiusMeters;
+
+        return intrinsics;
+    }
+
+    bool GsCameraIntrinsics::IsFor(const CameraHardware& camera) const {
+        return focal_length_ == camera.focal_length_ &&
+               sensor_width_ == camera.sensor_width_ &&
+               sensor_height_ == camera.sensor_height_ &&
+               resolution_x_ == camera.resolution_x_ &&
+               resolution_y_ == camera.resolution_y_ &&
+               camera_angles_ == camera.camera_angles_ &&
+               ball_radius_meters_ == GolfBall::kBallRadiusMeters;
+    }
+
+    const GsCameraIntrinsics& GsCameraIntrinsics::ForCamera(const CameraHardware& camera) {
+
+        // One per camera number.  Per thread, so that shots analyzed in parallel never share one.
+        static thread_local GsCameraIntrinsics cache[2];
+        static thread_local bool cache_valid[2] = { false, false };
+
+        const int index = (camera.camera_number_ == GsCameraNumber::kGsCamera2) ? 1 : 0;
+
+        if (!cache_valid[index] || !cache[index].IsFor(camera)) {
+            cache[index] = FromCameraHardware(camera);
+            cache_valid[index] = true;
+        }
+
+        return cache[index];
+    }
+
+    // theta = camera_angle_x - atan(tan_x), and the elevation is camera_angle_y - atan(tan_y).
+    // The result is the spherical-to-cartesian conversion of ComputeXyzDistanceFromOrthoCamPerspective,
+    // where phi is 90 degrees plus the elevation.
+    static inline void PositionFromTangents(const double tan_x, const double tan_y, const double z,
+                                            const double cos_x, const double sin_x, const double cos_y, const double sin_y,
+                                            double& distance_x, double& distance_y, double& distance_z) {
+        const double inverse_x = 1.0 / std::sqrt(1.0 + tan_x * tan_x);
+        const double inverse_y = 1.0 / std::sqrt(1.0 + tan_y * tan_y);
+        const double cos_theta = (cos_x + sin_x * tan_x) * inverse_x;
+        const double sin_theta = (sin_x - cos_x * tan_x) * inverse_x;
+        const double cos_elevation = (cos_y + sin_y * tan_y) * inverse_y;
+        const double sin_elevation = (sin_y - cos_y * tan_y) * inverse_y;
+
+        distance_x = -z * cos_elevation * sin_theta;
+        distance_y = z * sin_elevation;
+        distance_z = z * cos_elevation * cos_theta;
+    }
+
+    void GsCameraIntrinsics::ComputeBallPosition(const double x, const double y, const double distance_z, cv::Vec3d& distances) const {
+        PositionFromTangents(meters_per_pixel_x * (x - center_x), meters_per_pixel_y * (y - center_y), distance_z,
+                             cos_angle_x, sin_angle_x, cos_angle_y, sin_angle_y,
+                             distances[0], distances[1], distances[2]);
+    }
+
+    bool GsCameraIntrinsics::ProjectBallPosition(const cv::Vec3d& distances, double& x, double& y, double& radius_pixels) const {
+        const double z = cv::norm(distances);
+        if (z <= 0.0 || distance_times_radius <= 0.0 || meters_per_pixel_x == 0.0 || meters_per_pixel_y == 0.0) {
+            return false;
+        }
+
+        // Undoes PositionFromTangents, whose theta and elevation are the camera angles less the
+        // ball's angles from the bore line
+        const double theta = std::atan2(-distances[0], distances[2]);
+        const double elevation = std::asin(std::clamp(distances[1] / z, -1.0, 1.0));
+        const double bore_angle_x = std::atan2(sin_angle_x, cos_angle_x) - theta;
+        const double bore_angle_y = std::atan2(sin_angle_y, cos_angle_y) - elevation;
+
+        if (std::abs(bore_angle_x) >= CV_PI / 2.0 || std::abs(bore_angle_y) >= CV_PI / 2.0) {
+            return false;
+        }
+
+        x = center_x + std::tan(bore_angle_x) / meters_per_pixel_x;
+        y = center_y + std::tan(bore_angle_y) / meters_per_pixel_y;
+        radius_pixels = distance_times_radius / z;
+
+        return true;
+    }
+
+    void GsCameraIntrinsics::ComputeBallPositions(const size_t count,
+                                                  const float* x, const float* y, const float* radius,
+                                                  double* distance_x, double* distance_y, double* distance_z) const {
+
+        // Copies, so the compiler knows that the output stores cannot change them
+        const double cx = center_x;
+        const double cy = center_y;
+        const double mx = meters_per_pixel_x;
+        const double my = meters_per_pixel_y;
+        const double k = distance_times_radius;
+        const double cos_x = cos_angle_x;
+        const double sin_x = sin_angle_x;
+        const double cos_y = cos_angle_y;
+        const double sin_y = sin_angle_y;
+
+        for (size_t i = 0; i < count; i++) {
+            const double z = k / radius[i];
+
+            // The tangents of the ball's angles from the bore line
+            const double tan_x = mx * (x[i] - cx);
+            const double tan_y = my * (y[i] - cy);
+
+            PositionFromTangents(tan_x, tan_y, z, cos_x, sin_x, cos_y, sin_y, distance_x[i], distance_y[i], distance_z[i]);
+        }
+    }
+
+}
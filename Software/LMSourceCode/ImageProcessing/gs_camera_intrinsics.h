@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// The parts of CameraHardware that turn a ball circle's image position and radius into a 3D
+// position, pre-computed so that many balls (e.g., all of the ball candidates of a strobed
+// image) can be located in one pass.  The result is the same as
+// GolfSimCamera::ComputeSingleBallXYZOrthoCamPerspective's distances_ortho_camera_perspective_
+// for a ball without an ellipse, to within rounding.
+//
+// The per-ball part is only multiplies, divides and square roots (the angles of the ball
+// from the camera's bore line are folded into the camera angles with the angle-difference
+// identities instead of atan/sin/cos), so the compiler can vectorize the loop.
+//
+// ForCamera() keeps the intrinsics of the last camera hardware of each camera number, and
+// only rebuilds them when the hardware values they come from (e.g., the calibrated focal
+// length) change.  The single-ball pixel/meter conversions of GolfSimCamera use them too.
+
+#pragma once
+
+#include <cstddef>
+
+#include "camera_hardware.h"
+
+namespace golf_sim {
+
+    struct GsCameraIntrinsics {
+
+        // The pixel that the camera bore line goes through
+        double center_x = 0.0;
+        double center_y = 0.0;
+
+        // Meters per pixel, per meter of distance to the ball plane
+        double meters_per_pixel_x = 0.0;
+        double meters_per_pixel_y = 0.0;
+
+        // The distance to the ball plane is this divided by the ball radius in pixels
+        double distance_times_radius = 0.0;
+
+        // Of the camera angles (camera_angles_)
+        double cos_angle_x = 1.0;
+        double sin_angle_x = 0.0;
+        double cos_angle_y = 1.0;
+        double sin_angle_y = 0.0;
+
+        // The focal length (in mm) that puts a ball of a given radius in pixels at a given
+        // distance is this times the radius times the distance
+        double focal_length_per_radius_distance = 0.0;
+
+        // The radius in pixels of a ball at a given distance is this times the image width
+        // (in pixels) divided by the distance
+        double radius_distance_per_resolution_x = 0.0;
+
+        static GsCameraIntrinsics FromCameraHardware(const CameraHardware& camera);
+
+        // The same as FromCameraHardware, but only re-computed if the camera (of that
+        // camera number) has changed since the last call on this thread
+        static const GsCameraIntrinsics& ForCamera(const CameraHardware& camera);
+
+        double MetersX(const double distance_z, const double pixels_x) const { return distance_z * meters_per_pixel_x * pixels_x; }
+        double MetersY(const double distance_z, const double pixels_y) const { return distance_z * meters_per_pixel_y * pixels_y; }
+
+        double FocalLengthFromBall(const double radius_pixels, const double distance) const {
+            return focal_length_per_radius_distance * radius_pixels * distance;
+        }
+
+        double RadiusPixelsAtDistance(const double distance, const int resolution_x) const {
+            return radius_distance_per_resolution_x * resolution_x / distance;
+        }
+
+        // One ball at (x, y) in the image and distance_z from the lens, in the axes of
+        // distances_ortho_camera_perspective_
+        void ComputeBallPosition(const double x, const double y, const double distance_z, cv::Vec3d& distances) const;
+
+        // The inverse of ComputeBallPosition.  Returns the image position and radius (in pixels) of
+        // a ball at distances, in the same axes.  False if the ball is not in front of the camera.
+        bool ProjectBallPosition(const cv::Vec3d& distances, double& x, double& y, double& radius_pixels) const;
+
+        // Struct-of-arrays version of ComputeSingleBallXYZOrthoCamPerspective for count
+        // circles.  Each output array gets count values, in the same axes as
+        // distances_ortho_camera_perspective_.  The radii must be greater than 0.
+        void ComputeBallPositions(const size_t count,
+                                  const float* x, const float* y, const float* radius,
+                                  double* distance_x, double* distance_y, double* distance_z) const;
+
+    private:
+        // The CameraHardware values that the above came from
+        float focal_length_ = 0;
+        float sensor_width_ = 0;
+        float sensor_height_ = 0;
+        int resolution_x_ = 0;
+        int resolution_y_ = 0;
+        cv::Vec2d camera_angles_;
+        double ball_radius_meters_ = 0.0;
+
+        bool IsFor(const CameraHardware& camera) const;
+    };
+
+}
@@ -0,0 +1,66 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "gs_circle_grid_index.h"
+
+namespace golf_sim {
+
+    GsCircleGridIndex::GsCircleGridIndex(const double cell_size) : cell_size_(std::max(1.0, cell_size)) {
+    }
+
+    int GsCircleGridIndex::CellIndex(const double coordinate) const {
+        return (int)std::floor(coordinate / cell_size_);
+    }
+
+    int64_t GsCircleGridIndex::CellKey(const int cell_x, const int cell_y) const {
+        return ((int64_t)cell_x << 32) | (uint32_t)cell_y;
+    }
+
+    void GsCircleGridIndex::Insert(const int id, const double x, const double y) {
+
+        if (id >= (int)removed_.size()) {
+            removed_.resize(id + 1, 0);
+        }
+
+        removed_[id] = 0;
+        cells_[CellKey(CellIndex(x), CellIndex(y))].push_back(id);
+    }
+
+    void GsCircleGridIndex::Remove(const int id) {
+        if (id >= 0 && id < (int)removed_.size()) {
+            removed_[id] = 1;
+        }
+    }
+
+    bool GsCircleGridIndex::IsRemoved(const int id) const {
+        return (id < 0 || id >= (int)removed_.size() || removed_[id] != 0);
+    }
+
+    void GsCircleGridIndex::GetNearbyIds(const double x, const double y, const double distance, std::vector<int>& ids) const {
+
+        const int cell_x = CellIndex(x);
+        const int cell_y = CellIndex(y);
+        const int cell_reach = (int)std::ceil(std::max(0.0, distance) / cell_size_);
+
+        for (int cx = cell_x - cell_reach; cx <= cell_x + cell_reach; cx++) {
+            for (int cy = cell_y - cell_reach; cy <= cell_y + cell_reach; cy++) {
+                auto cell = cells_.find(CellKey(cx, cy));
+                if (cell == cells_.end()) {
+                    continue;
+                }
+
+                for (const int id : cell->second) {
+                    if (!removed_[id]) {
+                        ids.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,47 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A uniform-grid spatial index over circle (or ball) centers, so that filters that
+// compare each candidate with its neighbors do not have to compare every pair.
+// The cell size is normally the expected ball radius (or whatever the largest
+// distance of interest is), so that a neighbor query only visits a few cells.
+// Removing a point only marks it as removed, so ids remain stable.
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace golf_sim {
+
+    class GsCircleGridIndex {
+
+    public:
+        // A cell_size of less than 1 pixel is treated as 1
+        explicit GsCircleGridIndex(const double cell_size);
+
+        // Ids are expected to be small, dense integers such as vector indexes
+        void Insert(const int id, const double x, const double y);
+
+        void Remove(const int id);
+        bool IsRemoved(const int id) const;
+
+        // Appends the ids of the non-removed points in every cell that could hold a point
+        // within distance of (x, y).  This is a superset of the points within that distance,
+        // so the caller still makes the exact check.  A distance of 0 returns just the
+        // points in the same cell as (x, y).
+        void GetNearbyIds(const double x, const double y, const double distance, std::vector<int>& ids) const;
+
+    private:
+        int64_t CellKey(const int cell_x, const int cell_y) const;
+        int CellIndex(const double coordinate) const;
+
+        double cell_size_;
+        std::unordered_map<int64_t, std::vector<int>> cells_;
+        std::vector<uint8_t> removed_;
+    };
+
+}
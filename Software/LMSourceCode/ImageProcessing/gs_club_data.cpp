@@ -4,12 +4,14 @@
  */
 
 
-#include <boost/circular_buffer.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
 #include "logging_tools.h"
 #include "gs_options.h"
 #include "gs_config.h"
+#include "gs_club_strike_encoder.h"
+#include "gs_club_strike_analysis.h"
+#include "gs_memory_footprint.h"
 
 #include "gs_club_data.h"
 
@@ -47,17 +49,23 @@ namespace golf_sim {
 			GolfSimConfiguration::SetConstant("gs_config.club_data.kEnableClubImages", kClubImageOutputDir);
 			GolfSimConfiguration::SetConstant("gs_config.club_data.kNumberFramesToSaveBeforeHit", kNumberFramesToSaveBeforeHit);
 			GolfSimConfiguration::SetConstant("gs_config.club_data.kNumberFramesToSaveAfterHit", kNumberFramesToSaveAfterHit);
+			GsMemoryFootprint::LimitRecentFrames(kNumberFramesToSaveBeforeHit, kNumberFramesToSaveAfterHit);
 			GolfSimConfiguration::SetConstant("gs_config.club_data.kClubImageWidthPixels", kClubImageWidthPixels);
 			GolfSimConfiguration::SetConstant("gs_config.club_data.kClubImageHeightPixels", kClubImageHeightPixels);
 			GolfSimConfiguration::SetConstant("gs_config.club_data.kClubImageCameraGain", kClubImageCameraGain);
 			GolfSimConfiguration::SetConstant("gs_config.club_data.kClubImageShutterSpeedMultiplier", kClubImageShutterSpeedMultiplier);
+
+#ifdef __unix__
+			GsClubStrikeEncoder::LoadConfigurationValues();
+			GsClubStrikeAnalysis::LoadConfigurationValues();
+#endif
 		}
 
 		// Not too much can go wrong so far
 		return true;
 	}
 
-	bool GolfSimClubData::ProcessClubStrikeData(boost::circular_buffer<RecentFrameInfo>& frame_info) {
+	bool GolfSimClubData::ProcessClubStrikeData(std::vector<RecentFrameInfo>& frame_info, const GolfBall& ball, long shot_number) {
 		GS_LOG_TRACE_MSG(trace, "GolfSimClubData::ProcessClubStrikeData.");
 
 		if (!kGatherClubData) {
@@ -65,18 +73,26 @@ namespace golf_sim {
 			return true;
 		}
 
+#ifdef __unix__
+		// Queued first, so that the analysis is under way while the video is handed over.
+		// The Mats are shared with the video, not copied.
+		if (GsClubStrikeAnalysis::kEnableClubStrikeAnalysis) {
+			if (!GsClubStrikeAnalysis::Submit(shot_number, std::vector<RecentFrameInfo>(frame_info), ball.measured_radius_pixels_)) {
+				GS_LOG_TRACE_MSG(warning, "GolfSimClubData::ProcessClubStrikeData could not queue the club strike analysis.");
+			}
+		}
+#endif
+
 		if (!CreateClubStrikeVideo(frame_info)) {
 			GS_LOG_TRACE_MSG(warning, "GolfSimClubData::CreateClubStrikeVideo failed.");
 			return false;
 		}
 
-		// TBD - Perform analysis
-
 		return true;
 	}
 
 
-	bool GolfSimClubData::CreateClubStrikeVideo(boost::circular_buffer<RecentFrameInfo>& frame_info) {
+	bool GolfSimClubData::CreateClubStrikeVideo(std::vector<RecentFrameInfo>& frame_info) {
 		GS_LOG_TRACE_MSG(trace, "GolfSimClubData::CreateClubStrikeVideo with " + std::to_string(frame_info.size()) + " frames.");
 
 		if (!kGatherClubData) {
@@ -84,7 +100,14 @@ namespace golf_sim {
 			return false;
 		}
 
-		// TBD - For now, just dump the frame images to the output directory
+#ifdef __unix__
+		if (GsClubStrikeEncoder::UseEncoder()) {
+			// The Mats are shared, not copied.  The encode happens in the background.
+			return GsClubStrikeEncoder::SubmitClubStrike(std::vector<RecentFrameInfo>(frame_info));
+		}
+#endif
+
+		// Otherwise, dump the frame images to the output directory and let ffmpeg make the video
 
 		int frame_index = 0;
 
@@ -103,16 +126,28 @@ namespace golf_sim {
 				GS_LOG_TRACE_MSG(warning, "GolfSimClubData::CreateClubStrikeVideo -- " + frame_image_name + " was empty.");
 			}
 			else {
-				LoggingTools::LogImage("", next_frame_mat, std::vector < cv::Point >{}, true, frame_image_name);
+				LoggingTools::LogImage("", next_frame_mat, std::vector < cv::Point >{}, true, frame_image_name,
+									   "", GsImageWriter::ArtifactClass::kClubFrame);
 			}
 
 			frame_index++;
 		}
 
 
+		if (GsImageWriter::GetEncodingPolicy(GsImageWriter::ArtifactClass::kClubFrame).encoding == GsImageWriter::ImageEncoding::kRaw) {
+			GS_LOG_TRACE_MSG(warning, "CreateClubStrikeVideo cannot make a video from raw club frames.  Skipping the video.");
+			return true;
+		}
+
+		// The frames must all have been written before ffmpeg looks for them
+		GsImageWriter::Flush();
+
+		// E.g., "Club*.png" or "Club*.jpg", depending on how the frames were encoded
+		std::string frame_glob = GsImageWriter::GetEncodedFileName("Club*.png", GsImageWriter::ArtifactClass::kClubFrame);
+
 		std::string unique_time_tag = LoggingTools::GetUniqueLogName();
 		std::string make_movie_command = "ffmpeg -framerate 2 -pattern_type glob -i '" + LoggingTools::kBaseImageLoggingDir + 
-				"Club*.png' -c:v libx264 -pix_fmt yuv420p " +  LoggingTools::kBaseImageLoggingDir + "ClubStrike_" + unique_time_tag + ".mp4";
+				frame_glob + "' -c:v libx264 -pix_fmt yuv420p " +  LoggingTools::kBaseImageLoggingDir + "ClubStrike_" + unique_time_tag + ".mp4";
 
 		GS_LOG_TRACE_MSG(info, "CreateClubStrikeVideo video creation command is: " + make_movie_command);
 
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "ball_watcher_image_buffer.h"
+#include "golf_ball.h"
 
 namespace golf_sim {
 
@@ -17,10 +18,12 @@ namespace golf_sim {
 		static bool Configure();
 
 		// Create a video of the club strike, detect club face information,
-		// perform analysis, etc.
-		static bool ProcessClubStrikeData(boost::circular_buffer<RecentFrameInfo>& frame_info);
+		// perform analysis, etc.  The frame_info is usually RecentFrames.TakeFrames().
+		// The ball is the teed-up ball whose hit the frames are of.  The analysis runs in
+		// the background, and its result is picked up by shot_number (see GsClubStrikeAnalysis).
+		static bool ProcessClubStrikeData(std::vector<RecentFrameInfo>& frame_info, const GolfBall& ball, long shot_number);
 
-		static bool CreateClubStrikeVideo(boost::circular_buffer<RecentFrameInfo>& frame_info);
+		static bool CreateClubStrikeVideo(std::vector<RecentFrameInfo>& frame_info);
 
 
 	public:
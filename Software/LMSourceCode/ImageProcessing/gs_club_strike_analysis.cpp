@@ -0,0 +1,316 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "golf_ball.h"
+#include "cv_utils.h"
+
+#include "gs_club_strike_analysis.h"
+
+namespace golf_sim {
+
+    bool GsClubStrikeAnalysis::kEnableClubStrikeAnalysis = false;
+    int GsClubStrikeAnalysis::kClubStrikeMotionPixelThreshold = 25;
+    int GsClubStrikeAnalysis::kClubStrikeMinMotionPixels = 40;
+    int GsClubStrikeAnalysis::kClubStrikeResultWaitMs = 150;
+
+    // Faster than any club head, so anything above this is taken to be a mis-match
+    static const double kMaxClubSpeedMps = 90.0;
+
+    // Wide enough to open away the 2-pixel ROI rectangle and frame-number text
+    static const int kMotionOpeningKernelSize = 5;
+
+    std::deque<GsClubStrikeAnalysis::Job> GsClubStrikeAnalysis::queue_;
+    long GsClubStrikeAnalysis::analyzing_shot_number_ = 0;
+    std::deque<std::pair<long, GsClubStrikeResult>> GsClubStrikeAnalysis::results_;
+    std::mutex GsClubStrikeAnalysis::mutex_;
+    std::condition_variable GsClubStrikeAnalysis::result_ready_;
+    GsBackgroundJob GsClubStrikeAnalysis::analysis_job_(&GsClubStrikeAnalysis::Process);
+    bool GsClubStrikeAnalysis::running_ = false;
+
+
+    void GsClubStrikeAnalysis::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.club_data.kEnableClubStrikeAnalysis", kEnableClubStrikeAnalysis);
+        GolfSimConfiguration::SetConstant("gs_config.club_data.kClubStrikeMotionPixelThreshold", kClubStrikeMotionPixelThreshold);
+        GolfSimConfiguration::SetConstant("gs_config.club_data.kClubStrikeMinMotionPixels", kClubStrikeMinMotionPixels);
+        GolfSimConfiguration::SetConstant("gs_config.club_data.kClubStrikeResultWaitMs", kClubStrikeResultWaitMs);
+
+        kClubStrikeMotionPixelThreshold = std::clamp(kClubStrikeMotionPixelThreshold, 1, 254);
+        kClubStrikeMinMotionPixels = std::max(kClubStrikeMinMotionPixels, 1);
+        kClubStrikeResultWaitMs = std::max(kClubStrikeResultWaitMs, 0);
+
+        if (kEnableClubStrikeAnalysis) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = true;
+        }
+    }
+
+    bool GsClubStrikeAnalysis::Submit(long shot_number, std::vector<RecentFrameInfo>&& frames, double ball_radius_pixels) {
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!running_) {
+                GS_LOG_TRACE_MSG(trace, "GsClubStrikeAnalysis::Submit called, but the analysis is not running.");
+                return false;
+            }
+
+            // The FSM only ever waits for the latest shot, so an older one that has not
+            // started yet is not worth doing
+            queue_.clear();
+
+            Job job;
+            job.shot_number = shot_number;
+            job.frames = std::move(frames);
+            job.ball_radius_pixels = ball_radius_pixels;
+
+            queue_.push_back(std::move(job));
+        }
+
+        analysis_job_.Schedule();
+
+        return true;
+    }
+
+    bool GsClubStrikeAnalysis::GetResult(long shot_number, GsClubStrikeResult& result) {
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        auto find_result = [&]() {
+            for (const auto& entry : results_) {
+                if (entry.first == shot_number) {
+                    result = entry.second;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        auto is_pending = [&]() {
+            if (analyzing_shot_number_ == shot_number) {
+                return true;
+            }
+            for (const Job& job : queue_) {
+                if (job.shot_number == shot_number) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        if (find_result()) {
+            return true;
+        }
+
+        if (!is_pending()) {
+            return false;
+        }
+
+        result_ready_.wait_for(lock, std::chrono::milliseconds(kClubStrikeResultWaitMs), [&] { return !is_pending(); });
+
+        if (!find_result()) {
+            GS_LOG_TRACE_MSG(trace, "GsClubStrikeAnalysis - the analysis of shot " + std::to_string(shot_number) + " was not done in time.");
+            return false;
+        }
+
+        return true;
+    }
+
+    void GsClubStrikeAnalysis::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!running_) {
+                return;
+            }
+
+            running_ = false;
+        }
+
+        // Anything still queued is finished first
+        analysis_job_.WaitUntilIdle();
+    }
+
+    bool GsClubStrikeAnalysis::Process() {
+        Job job;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (queue_.empty()) {
+                return false;
+            }
+
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            analyzing_shot_number_ = job.shot_number;
+        }
+
+        GsClubStrikeResult result;
+
+        try {
+            result = Analyze(job.frames, job.ball_radius_pixels);
+        }
+        catch (std::exception const& e) {
+            GS_LOG_MSG(error, "ERROR: *** GsClubStrikeAnalysis - " + std::string(e.what()) + " ***");
+        }
+
+        // The frames are released before the result is handed out
+        job.frames.clear();
+
+        bool more;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            results_.emplace_back(job.shot_number, result);
+            while (results_.size() > kMaxKeptResults) {
+                results_.pop_front();
+            }
+
+            analyzing_shot_number_ = 0;
+            more = !queue_.empty();
+        }
+
+        result_ready_.notify_all();
+
+        return more;
+    }
+
+    GsClubStrikeResult GsClubStrikeAnalysis::Analyze(const std::vector<RecentFrameInfo>& frames, double ball_radius_pixels) {
+
+        GsClubStrikeResult result;
+
+        if (frames.size() < 3 || ball_radius_pixels <= 0.0) {
+            GS_LOG_TRACE_MSG(trace, "GsClubStrikeAnalysis::Analyze - not enough frames, or no ball radius.");
+            return result;
+        }
+
+        // Only the frames up to and including the one where the hit was first seen
+        size_t last_frame = frames.size() - 1;
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (frames[i].isballHitFrame) {
+                last_frame = i;
+                break;
+            }
+        }
+
+        const cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(kMotionOpeningKernelSize, kMotionOpeningKernelSize));
+
+        struct ClubSample {
+            size_t frame = 0;
+            cv::Point2d centroid;
+            float frame_rate = 0;
+        };
+        std::vector<ClubSample> samples;
+
+        cv::Mat difference;
+        cv::Mat motion;
+        cv::Mat labels;
+        cv::Mat stats;
+        cv::Mat centroids;
+
+        for (size_t i = 1; i <= last_frame; i++) {
+            const cv::Mat& prior_frame = frames[i - 1].mat;
+            const cv::Mat& frame = frames[i].mat;
+
+            if (prior_frame.empty() || frame.empty() || prior_frame.size() != frame.size() || prior_frame.type() != frame.type()) {
+                continue;
+            }
+
+            cv::absdiff(prior_frame, frame, difference);
+            cv::threshold(difference, motion, kClubStrikeMotionPixelThreshold, 255, cv::THRESH_BINARY);
+            cv::morphologyEx(motion, motion, cv::MORPH_OPEN, kernel);
+
+            const int num_labels = cv::connectedComponentsWithStats(motion, labels, stats, centroids, 8, CV_32S);
+
+            // Label 0 is the background
+            int largest_label = 0;
+            int largest_area = 0;
+            for (int label = 1; label < num_labels; label++) {
+                const int area = stats.at<int>(label, cv::CC_STAT_AREA);
+                if (area > largest_area) {
+                    largest_area = area;
+                    largest_label = label;
+                }
+            }
+
+            if (largest_label == 0 || largest_area < kClubStrikeMinMotionPixels) {
+                continue;
+            }
+
+            ClubSample sample;
+            sample.frame = i;
+            sample.centroid = cv::Point2d(centroids.at<double>(largest_label, 0), centroids.at<double>(largest_label, 1));
+            sample.frame_rate = frames[i].frameRate;
+            samples.push_back(sample);
+        }
+
+        result.frames_with_club = (int)samples.size();
+
+        // The speed and path come from the latest run of frame pairs that all had the club,
+        // which is what ends at (or just before) the impact
+        size_t run_start = samples.empty() ? 0 : samples.size() - 1;
+        while (run_start > 0 && samples[run_start].frame == samples[run_start - 1].frame + 1) {
+            run_start--;
+        }
+
+        if (samples.size() < 2 || samples.size() - run_start < 2) {
+            GS_LOG_TRACE_MSG(trace, "GsClubStrikeAnalysis::Analyze - the club was found in " + std::to_string(samples.size()) +
+                                    " frame pairs, but not in two in a row.");
+            return result;
+        }
+
+        // The last (up to) two movements are averaged, as each centroid is only good to a few pixels
+        const size_t last_sample = samples.size() - 1;
+        const size_t first_speed_sample = std::max(run_start, (last_sample >= 2) ? last_sample - 2 : (size_t)0);
+
+        double pixels_per_second = 0.0;
+        int num_movements = 0;
+        for (size_t i = first_speed_sample + 1; i <= last_sample; i++) {
+            if (samples[i].frame_rate <= 0.0) {
+                continue;
+            }
+            const cv::Point2d movement = samples[i].centroid - samples[i - 1].centroid;
+            pixels_per_second += std::hypot(movement.x, movement.y) * samples[i].frame_rate;
+            num_movements++;
+        }
+
+        if (num_movements == 0) {
+            GS_LOG_TRACE_MSG(trace, "GsClubStrikeAnalysis::Analyze - the club frames had no frame rate.");
+            return result;
+        }
+
+        // The club head is at about the ball's distance from the camera at impact
+        const double meters_per_pixel = GolfBall::kBallRadiusMeters / ball_radius_pixels;
+        const double club_speed_mps = (pixels_per_second / num_movements) * meters_per_pixel;
+
+        const cv::Point2d path = samples[last_sample].centroid - samples[run_start].centroid;
+
+        result.club_speed_mps = (float)club_speed_mps;
+        // Image y is down, so it is negated to make up positive
+        result.path_image_deg = (float)CvUtils::RadiansToDegrees(std::atan2(-path.y, path.x));
+        result.valid = club_speed_mps > 0.0 && club_speed_mps < kMaxClubSpeedMps;
+
+        GS_LOG_TRACE_MSG(trace, "GsClubStrikeAnalysis::Analyze - club found in " + std::to_string(result.frames_with_club) +
+                                " frame pairs.  Club speed = " + std::to_string(CvUtils::MetersPerSecondToMPH(club_speed_mps)) +
+                                " mph, image path = " + std::to_string(result.path_image_deg) + " degrees" +
+                                (result.valid ? "." : " (not valid)."));
+
+        return result;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,98 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Estimates the club speed and path from the club-strike frames that the ball watcher
+// keeps around the hit (see RecentFrameRing).  The ball is still on the tee in the frames
+// before the hit, so anything that changes from one of those frames to the next is the
+// club.  Each pair of frames is differenced, thresholded and opened (which also removes
+// the thin ROI rectangle and frame numbers that the watcher draws on the frames), and the
+// centroid of the largest remaining blob is taken as the club head.  The centroid's
+// movement from frame to frame, at the frames' frame rate and at the ball's scale of
+// meters per pixel, gives the club speed at impact.
+// The frames after the hit are not used, as the ball leaves the tee in those and would
+// be taken for the club.
+// The analysis runs on the shared, low-priority GsBackgroundWorker while the ball analysis
+// goes ahead, and the FSM joins the result to the shot record with GetResult().
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ball_watcher_image_buffer.h"
+#include "worker_thread.h"
+
+namespace golf_sim {
+
+    struct GsClubStrikeResult {
+        // False if the club could not be followed over at least two frame pairs
+        bool valid = false;
+        // The number of frame pairs in which the club was found
+        int frames_with_club = 0;
+        float club_speed_mps = 0;
+        // The direction that the club head moved across the image just before the hit.
+        // 0 is along the image's x axis, and positive is up in the image.
+        float path_image_deg = 0;
+    };
+
+    class GsClubStrikeAnalysis {
+
+    public:
+        // If false (the default), nothing is analyzed and GetResult() never has a result
+        static bool kEnableClubStrikeAnalysis;
+        // The smallest (0-255) difference between two frames that is counted as motion
+        static int kClubStrikeMotionPixelThreshold;
+        // The smallest blob of motion, in pixels, that is taken to be the club
+        static int kClubStrikeMinMotionPixels;
+        // How long GetResult() will wait for an analysis that is still running
+        static int kClubStrikeResultWaitMs;
+
+        static void LoadConfigurationValues();
+
+        // Queues the frames (oldest first) for analysis.  The Mats are shared, not copied,
+        // and are not changed.  The radius is the teed-up ball's, for the image scale.
+        static bool Submit(long shot_number, std::vector<RecentFrameInfo>&& frames, double ball_radius_pixels);
+
+        // Returns true and sets result if the shot's analysis was done (or got done within
+        // kClubStrikeResultWaitMs), even if the result is not valid
+        static bool GetResult(long shot_number, GsClubStrikeResult& result);
+
+        // Does the analysis on the calling thread
+        static GsClubStrikeResult Analyze(const std::vector<RecentFrameInfo>& frames, double ball_radius_pixels);
+
+        // Finishes any queued analysis and stops taking new ones
+        static void Shutdown();
+
+    private:
+        struct Job {
+            long shot_number = 0;
+            std::vector<RecentFrameInfo> frames;
+            double ball_radius_pixels = 0;
+        };
+
+        // Only the results of the last few shots are kept
+        static const size_t kMaxKeptResults = 4;
+
+        // Analyzes the queued shot.  Run by analysis_job_.
+        static bool Process();
+
+        static std::deque<Job> queue_;
+        // The shot that analysis_job_ is working on, or 0
+        static long analyzing_shot_number_;
+        static std::deque<std::pair<long, GsClubStrikeResult>> results_;
+        static std::mutex mutex_;
+        static std::condition_variable result_ready_;
+        static GsBackgroundJob analysis_job_;
+        static bool running_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
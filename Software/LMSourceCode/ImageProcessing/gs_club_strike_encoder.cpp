@@ -0,0 +1,328 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include <linux/dma-buf.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include <libcamera/color_space.h>
+#include <libcamera/formats.h>
+
+#include <opencv2/imgproc.hpp>
+
+#include "core/dma_heaps.hpp"
+#include "core/video_options.hpp"
+#include "encoder/encoder.hpp"
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+
+#include "gs_club_strike_encoder.h"
+
+namespace golf_sim {
+
+    std::string GsClubStrikeEncoder::kClubStrikeVideoCodec = "h264";
+    int GsClubStrikeEncoder::kClubStrikeVideoFrameRate = 10;
+    int GsClubStrikeEncoder::kClubStrikeVideoBitrateKbps = 0;
+    int GsClubStrikeEncoder::kClubStrikeVideoMjpegQuality = 80;
+
+    // The frames are handed to the codec a few at a time, and each buffer is
+    // re-used once the codec says that it is done with it
+    static const unsigned int kNumInputBuffers = 4;
+
+    std::deque<std::vector<RecentFrameInfo>> GsClubStrikeEncoder::queue_;
+    std::mutex GsClubStrikeEncoder::mutex_;
+    GsBackgroundJob GsClubStrikeEncoder::encoder_job_(&GsClubStrikeEncoder::Process);
+    bool GsClubStrikeEncoder::running_ = false;
+
+
+    void GsClubStrikeEncoder::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.club_data.kClubStrikeVideoCodec", kClubStrikeVideoCodec);
+        GolfSimConfiguration::SetConstant("gs_config.club_data.kClubStrikeVideoFrameRate", kClubStrikeVideoFrameRate);
+        GolfSimConfiguration::SetConstant("gs_config.club_data.kClubStrikeVideoBitrateKbps", kClubStrikeVideoBitrateKbps);
+        GolfSimConfiguration::SetConstant("gs_config.club_data.kClubStrikeVideoMjpegQuality", kClubStrikeVideoMjpegQuality);
+
+        if (kClubStrikeVideoFrameRate <= 0) {
+            GS_LOG_MSG(warning, "GsClubStrikeEncoder - kClubStrikeVideoFrameRate must be positive.  Using 10.");
+            kClubStrikeVideoFrameRate = 10;
+        }
+
+        if (UseEncoder()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = true;
+        }
+    }
+
+    bool GsClubStrikeEncoder::UseEncoder() {
+        return kClubStrikeVideoCodec == "h264" || kClubStrikeVideoCodec == "mjpeg";
+    }
+
+    bool GsClubStrikeEncoder::SubmitClubStrike(std::vector<RecentFrameInfo>&& frames) {
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!running_) {
+                GS_LOG_MSG(warning, "GsClubStrikeEncoder::SubmitClubStrike called, but the encoder is not running.");
+                return false;
+            }
+
+            if (queue_.size() >= kMaxQueuedClubStrikes) {
+                GS_LOG_MSG(warning, "GsClubStrikeEncoder - still encoding an earlier club strike.  Dropping the oldest waiting one.");
+                queue_.pop_front();
+                GsMetrics::Increment(GsMetrics::Counter::kDroppedClubStrikeVideos);
+            }
+
+            queue_.push_back(std::move(frames));
+        }
+
+        encoder_job_.Schedule();
+
+        return true;
+    }
+
+    void GsClubStrikeEncoder::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!running_) {
+                return;
+            }
+
+            running_ = false;
+        }
+
+        // Anything still queued is finished first
+        encoder_job_.WaitUntilIdle();
+    }
+
+    bool GsClubStrikeEncoder::Process() {
+        std::vector<RecentFrameInfo> frames;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (queue_.empty()) {
+                return false;
+            }
+
+            frames = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        try {
+            if (!EncodeClubStrike(frames)) {
+                GS_LOG_MSG(warning, "GsClubStrikeEncoder - failed to encode the club strike video.");
+            }
+        }
+        catch (std::exception const& e) {
+            GS_LOG_MSG(error, "ERROR: *** GsClubStrikeEncoder - " + std::string(e.what()) + " ***");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !queue_.empty();
+    }
+
+    bool GsClubStrikeEncoder::EncodeClubStrike(const std::vector<RecentFrameInfo>& frames) {
+
+        auto start_time = std::chrono::steady_clock::now();
+
+        // All of the frames come from the same ring, so they share a size.  The
+        // YUV420 planes need an even width and height.
+        cv::Size frame_size;
+        for (const RecentFrameInfo& frame : frames) {
+            if (!frame.mat.empty()) {
+                frame_size = cv::Size(frame.mat.cols & ~1, frame.mat.rows & ~1);
+                break;
+            }
+        }
+
+        if (frame_size.width == 0 || frame_size.height == 0) {
+            GS_LOG_MSG(warning, "GsClubStrikeEncoder - no usable club strike frames.");
+            return false;
+        }
+
+        StreamInfo info;
+        info.width = frame_size.width;
+        info.height = frame_size.height;
+        info.stride = (frame_size.width + 63) & ~63;
+        info.pixel_format = libcamera::formats::YUV420;
+        info.colour_space = libcamera::ColorSpace::Smpte170m;
+
+        const size_t luma_size = (size_t)info.stride * info.height;
+        const size_t buffer_size = luma_size + luma_size / 2;
+
+        // Only the few options that the H.264 and MJPEG encoders look at are needed
+        VideoOptions options;
+        OptsInternal& opts = options.Set();
+        opts.width = info.width;
+        opts.height = info.height;
+        opts.framerate = (float)kClubStrikeVideoFrameRate;
+        opts.bitrate.set(std::to_string(kClubStrikeVideoBitrateKbps) + "kbps");
+        opts.profile = "";
+        opts.level = "";
+        opts.intra = (unsigned int)frames.size();
+        opts.inline_headers = true;
+        opts.quality = kClubStrikeVideoMjpegQuality;
+        opts.encoder_libs = "";
+        opts.libav_video_codec = "";
+        opts.codec = kClubStrikeVideoCodec;
+
+        // The V4L2 M2M codec can only read DMA-bufs, and only exists on the Pi 4 and earlier
+        DmaHeap dma_heap;
+        if (opts.codec == "h264" && (options.GetPlatform() != Platform::VC4 || !dma_heap.isValid())) {
+            GS_LOG_TRACE_MSG(trace, "GsClubStrikeEncoder - no hardware H.264 encoder here.  Using MJPEG instead.");
+            opts.codec = "mjpeg";
+        }
+        const bool use_dma_buf = (opts.codec == "h264");
+
+        struct InputBuffer {
+            libcamera::UniqueFD fd;
+            void* mem = nullptr;
+            std::vector<uint8_t> heap_mem;
+        };
+        std::vector<InputBuffer> input_buffers(kNumInputBuffers);
+
+        auto release_input_buffers = [&input_buffers, buffer_size]() {
+            for (InputBuffer& buffer : input_buffers) {
+                if (buffer.fd.isValid() && buffer.mem != nullptr && buffer.mem != MAP_FAILED) {
+                    munmap(buffer.mem, buffer_size);
+                }
+                buffer.mem = nullptr;
+            }
+        };
+
+        for (InputBuffer& buffer : input_buffers) {
+            if (use_dma_buf) {
+                buffer.fd = dma_heap.alloc("club_strike", buffer_size);
+                buffer.mem = buffer.fd.isValid() ?
+                    mmap(nullptr, buffer_size, PROT_READ | PROT_WRITE, MAP_SHARED, buffer.fd.get(), 0) : MAP_FAILED;
+
+                if (buffer.mem == MAP_FAILED) {
+                    GS_LOG_MSG(error, "GsClubStrikeEncoder - could not allocate a DMA-buf for the encoder.");
+                    release_input_buffers();
+                    return false;
+                }
+            }
+            else {
+                // The MJPEG encoder only uses the userland pointer
+                buffer.heap_mem.resize(buffer_size);
+                buffer.mem = buffer.heap_mem.data();
+            }
+
+            // The frames are monochrome, so the chroma planes never change
+            memset((uint8_t*)buffer.mem + luma_size, 128, buffer_size - luma_size);
+        }
+
+        const std::string file_name = LoggingTools::kBaseImageLoggingDir + "ClubStrike_" + LoggingTools::GetUniqueLogName() +
+            (opts.codec == "h264" ? ".h264" : ".mjpeg");
+
+        FILE* output_file = fopen(file_name.c_str(), "wb");
+        if (output_file == nullptr) {
+            GS_LOG_MSG(error, "GsClubStrikeEncoder - could not open " + file_name);
+            release_input_buffers();
+            return false;
+        }
+
+        std::mutex input_mutex;
+        std::condition_variable input_done;
+        unsigned int buffers_in_use = 0;
+        size_t bytes_written = 0;
+
+        int frames_encoded = 0;
+
+        try {
+            std::unique_ptr<Encoder> encoder(Encoder::Create(&options, info));
+
+            encoder->SetInputDoneCallback([&](void*) {
+                std::lock_guard<std::mutex> lock(input_mutex);
+                buffers_in_use--;
+                input_done.notify_one();
+            });
+
+            // Runs on the encoder's output thread
+            encoder->SetOutputReadyCallback([&](void* mem, size_t size, int64_t, bool) {
+                bytes_written += fwrite(mem, 1, size, output_file);
+            });
+
+            cv::Mat gray_frame;
+
+            for (const RecentFrameInfo& frame : frames) {
+
+                if (frame.mat.empty() || frame.mat.cols < frame_size.width || frame.mat.rows < frame_size.height) {
+                    continue;
+                }
+
+                const cv::Mat* luma = &frame.mat;
+                if (frame.mat.type() != CV_8UC1) {
+                    cv::cvtColor(frame.mat, gray_frame, cv::COLOR_BGR2GRAY);
+                    luma = &gray_frame;
+                }
+
+                {
+                    // The encoders hand the buffers back in the order they were queued
+                    std::unique_lock<std::mutex> lock(input_mutex);
+                    input_done.wait(lock, [&] { return buffers_in_use < kNumInputBuffers; });
+                    buffers_in_use++;
+                }
+
+                InputBuffer& buffer = input_buffers[frames_encoded % kNumInputBuffers];
+
+                struct dma_buf_sync sync = {};
+                if (use_dma_buf) {
+                    sync.flags = DMA_BUF_SYNC_START | DMA_BUF_SYNC_WRITE;
+                    ioctl(buffer.fd.get(), DMA_BUF_IOCTL_SYNC, &sync);
+                }
+
+                for (int row = 0; row < frame_size.height; row++) {
+                    memcpy((uint8_t*)buffer.mem + (size_t)row * info.stride, luma->ptr<uint8_t>(row), frame_size.width);
+                }
+
+                if (use_dma_buf) {
+                    sync.flags = DMA_BUF_SYNC_END | DMA_BUF_SYNC_WRITE;
+                    ioctl(buffer.fd.get(), DMA_BUF_IOCTL_SYNC, &sync);
+                }
+
+                const int64_t timestamp_us = (int64_t)frames_encoded * 1000000 / kClubStrikeVideoFrameRate;
+                encoder->EncodeBuffer(buffer.fd.isValid() ? buffer.fd.get() : -1, buffer_size, buffer.mem, info, timestamp_us);
+
+                frames_encoded++;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(input_mutex);
+                input_done.wait(lock, [&] { return buffers_in_use == 0; });
+            }
+
+            // Destroying the encoder drains its output queue
+        }
+        catch (...) {
+            fclose(output_file);
+            release_input_buffers();
+            throw;
+        }
+
+        fclose(output_file);
+        release_input_buffers();
+
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+        GS_LOG_MSG(info, "GsClubStrikeEncoder - wrote " + std::to_string(frames_encoded) + " frames (" +
+                   std::to_string(bytes_written) + " bytes) to " + file_name + " in " + std::to_string(elapsed_ms) + " ms.");
+
+        return frames_encoded > 0;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Turns the club-strike frames from the ball watcher into a single short clip per
+// shot using the rpicam-apps encoder/ stack (H264Encoder on the V4L2 M2M codec, or
+// MjpegEncoder).  The encode runs as a job on the shared, low-priority
+// GsBackgroundWorker, so the FSM only pays for handing over the frames.
+// Where a dma-heap is available, each frame is copied once into a DMA-buf so that
+// the hardware codec can read it directly.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ball_watcher_image_buffer.h"
+#include "worker_thread.h"
+
+namespace golf_sim {
+
+    class GsClubStrikeEncoder {
+
+    public:
+        // "h264", "mjpeg", or "images" (the older per-frame image dump followed by ffmpeg)
+        static std::string kClubStrikeVideoCodec;
+        // The playback rate of the clip, not the rate at which the frames were captured
+        static int kClubStrikeVideoFrameRate;
+        // 0 lets the H.264 codec pick
+        static int kClubStrikeVideoBitrateKbps;
+        static int kClubStrikeVideoMjpegQuality;
+
+        static void LoadConfigurationValues();
+
+        static bool UseEncoder();
+
+        // Queues the frames (oldest first) to be encoded into a new clip in
+        // kBaseImageLoggingDir.  Returns right away.  If a prior clip is still being
+        // encoded and another is already waiting, the waiting one is dropped.
+        static bool SubmitClubStrike(std::vector<RecentFrameInfo>&& frames);
+
+        // Finishes any queued clip and stops taking new ones.  Called once at shutdown.
+        static void Shutdown();
+
+    private:
+        static const size_t kMaxQueuedClubStrikes = 1;
+
+        // Encodes the oldest queued clip.  Run by encoder_job_.
+        static bool Process();
+        static bool EncodeClubStrike(const std::vector<RecentFrameInfo>& frames);
+
+        static std::deque<std::vector<RecentFrameInfo>> queue_;
+        static std::mutex mutex_;
+        static GsBackgroundJob encoder_job_;
+        static bool running_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
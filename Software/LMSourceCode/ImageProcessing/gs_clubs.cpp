@@ -9,19 +9,18 @@
 #include "gs_http_client.h"
 #include "gs_result_types.h"
 #include "gs_clubs.h"
+#include "gs_session_settings.h"
 
 
 namespace golf_sim {
 
-	GolfSimClubs::GsClubType GolfSimClubs::current_club_ = GolfSimClubs::kNotSelected;
-
 	GolfSimClubs::GsClubType GolfSimClubs::GetCurrentClubType() {
 
-		return current_club_;
+		return GsSessionSettings::Current().club_type;
 	}
 
 	void GolfSimClubs::SetCurrentClubType(GsClubType club_type) {
-		current_club_ = club_type;
+		GsSessionSettings::SetClubType(club_type);
 
 		GS_LOG_MSG(info, "Club type set to " + std::string((club_type == GolfSimClubs::GsClubType::kPutter) ? "Putter" : "Driver"));
 
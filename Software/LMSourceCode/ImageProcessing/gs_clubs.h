@@ -21,8 +21,8 @@ namespace golf_sim {
 			kPutter = 3
 		};
 
-		static GsClubType current_club_;
-
+		// The current club is held in the GsSessionSettings.  Note that while a shot is
+		// in progress, GsSessionSettings::ShotSettings() has the club it was armed with.
 		static GsClubType GetCurrentClubType();
 		static void SetCurrentClubType(GsClubType club_type);
 
@@ -0,0 +1,150 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <deque>
+
+#include <opencv2/imgproc.hpp>
+
+#include "gs_color_mask.h"
+
+namespace golf_sim {
+
+    // Only a handful of ball color ranges are in use at once
+    static constexpr size_t kMaxTablesPerThread = 4;
+
+    static thread_local std::deque<GsColorMaskTable> color_mask_tables;
+
+
+    GsColorMaskTable::GsColorMaskTable(const GsHsvRanges& hsv_ranges)
+        : hsv_ranges_(hsv_ranges),
+          cell_states_(kCellsPerChannel * kCellsPerChannel * kCellsPerChannel, kUnknown),
+          mixed_cell_index_(kCellsPerChannel * kCellsPerChannel * kCellsPerChannel, 0) {
+    }
+
+    GsColorMaskTable& GsColorMaskTable::ForThisThread(const GsHsvRanges& hsv_ranges) {
+
+        for (GsColorMaskTable& table : color_mask_tables) {
+            if (table.hsv_ranges() == hsv_ranges) {
+                return table;
+            }
+        }
+
+        if (color_mask_tables.size() >= kMaxTablesPerThread) {
+            color_mask_tables.pop_front();
+        }
+
+        color_mask_tables.emplace_back(hsv_ranges);
+
+        return color_mask_tables.back();
+    }
+
+    void GsColorMaskTable::ComputeMask(const cv::Mat& bgr_image, const std::vector<cv::Rect>& regions, cv::Mat& mask) {
+
+        CV_Assert(bgr_image.type() == CV_8UC3);
+
+        mask.create(bgr_image.size(), CV_8UC1);
+
+        const cv::Rect image_rect(0, 0, bgr_image.cols, bgr_image.rows);
+
+        if (regions.empty()) {
+            ComputeRegionMask(bgr_image, image_rect, mask);
+            return;
+        }
+
+        mask.setTo(cv::Scalar(0));
+
+        // Overlapping regions are just computed twice
+        for (const cv::Rect& region : regions) {
+            const cv::Rect clipped = region & image_rect;
+
+            if (!clipped.empty()) {
+                ComputeRegionMask(bgr_image, clipped, mask);
+            }
+        }
+    }
+
+    void GsColorMaskTable::ComputeRegionMask(const cv::Mat& bgr_image, const cv::Rect& region, cv::Mat& mask) {
+
+        for (int y = region.y; y < region.y + region.height; y++) {
+            const uchar* pixel = bgr_image.ptr<uchar>(y) + 3 * region.x;
+            uchar* mask_pixel = mask.ptr<uchar>(y) + region.x;
+
+            for (int x = 0; x < region.width; x++, pixel += 3) {
+                const int b = pixel[0];
+                const int g = pixel[1];
+                const int r = pixel[2];
+                const int cell = ((b >> kCellBits) << (2 * (8 - kCellBits))) | ((g >> kCellBits) << (8 - kCellBits)) | (r >> kCellBits);
+
+                if (cell_states_[cell] == kUnknown) {
+                    ClassifyCell(cell);
+                }
+
+                const uint8_t state = cell_states_[cell];
+
+                if (state == kMixed) {
+                    const int color = ((b & 7) << 6) | ((g & 7) << 3) | (r & 7);
+                    const std::array<uint64_t, 8>& bits = mixed_cell_bits_[mixed_cell_index_[cell]];
+                    mask_pixel[x] = ((bits[color >> 6] >> (color & 63)) & 1) ? 255 : 0;
+                }
+                else {
+                    mask_pixel[x] = (state == kAllIn) ? 255 : 0;
+                }
+            }
+        }
+    }
+
+    void GsColorMaskTable::ClassifyCell(const int cell) {
+
+        const int base_b = ((cell >> (2 * (8 - kCellBits))) & (kCellsPerChannel - 1)) << kCellBits;
+        const int base_g = ((cell >> (8 - kCellBits)) & (kCellsPerChannel - 1)) << kCellBits;
+        const int base_r = (cell & (kCellsPerChannel - 1)) << kCellBits;
+
+        // All 512 colors of the cell, in the same order as the bit maps
+        cv::Mat cell_colors(8, 64, CV_8UC3);
+
+        for (int color = 0; color < 512; color++) {
+            cv::Vec3b& c = cell_colors.at<cv::Vec3b>(color >> 6, color & 63);
+            c[0] = (uchar)(base_b + ((color >> 6) & 7));
+            c[1] = (uchar)(base_g + ((color >> 3) & 7));
+            c[2] = (uchar)(base_r + (color & 7));
+        }
+
+        cv::Mat cell_hsv;
+        cv::cvtColor(cell_colors, cell_hsv, cv::COLOR_BGR2HSV);
+
+        cv::Mat in_range(cell_colors.size(), CV_8UC1, cv::Scalar(0));
+        cv::Mat range_mask;
+
+        for (const auto& range : hsv_ranges_) {
+            cv::inRange(cell_hsv, range.first, range.second, range_mask);
+            cv::bitwise_or(in_range, range_mask, in_range);
+        }
+
+        const int number_in_range = cv::countNonZero(in_range);
+
+        if (number_in_range == 0) {
+            cell_states_[cell] = kAllOut;
+            return;
+        }
+
+        if (number_in_range == 512) {
+            cell_states_[cell] = kAllIn;
+            return;
+        }
+
+        std::array<uint64_t, 8> bits{};
+
+        for (int color = 0; color < 512; color++) {
+            if (in_range.at<uchar>(color >> 6, color & 63) != 0) {
+                bits[color >> 6] |= (uint64_t)1 << (color & 63);
+            }
+        }
+
+        mixed_cell_index_[cell] = (uint16_t)mixed_cell_bits_.size();
+        mixed_cell_bits_.push_back(bits);
+        cell_states_[cell] = kMixed;
+    }
+
+}
@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Builds a BallImageProc::GetColorMaskImage-style in-range mask straight from a BGR image,
+// without converting the image to HSV first, and only over the regions that are asked for
+// (e.g., around the candidate balls).
+//
+// Each table answers "is this BGR color in the HSV range(s)?" for one set of ranges.  The BGR
+// cube is divided into 32x32x32 cells of 8x8x8 colors.  The first time a pixel falls in a
+// cell, the cell's 512 colors are converted with cv::cvtColor and tested with cv::inRange, so
+// the masks are exactly what the HSV conversion would have produced.  A cell that is all in
+// or all out of range is then just one byte; otherwise it keeps a 512-bit map of its colors.
+// Most images only ever touch a small part of the cube.
+//
+// Tables are per thread (see ForThisThread), so they need no locking.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    // Lower and upper HSV bounds, as they would be passed to cv::inRange.  A pixel is in the
+    // mask if it is within any of the ranges.
+    using GsHsvRanges = std::vector<std::pair<cv::Scalar, cv::Scalar>>;
+
+    class GsColorMaskTable {
+
+    public:
+        explicit GsColorMaskTable(const GsHsvRanges& hsv_ranges);
+
+        // The calling thread's table for the ranges, created if needed.  A thread keeps
+        // the tables of its last few sets of ranges.
+        static GsColorMaskTable& ForThisThread(const GsHsvRanges& hsv_ranges);
+
+        // Sets mask (CV_8UC1, the size of bgr_image, allocated if needed) to 255 wherever
+        // the pixel is within the ranges, within each region.  Pixels outside all of the
+        // regions are 0.  No regions means the whole image.
+        void ComputeMask(const cv::Mat& bgr_image, const std::vector<cv::Rect>& regions, cv::Mat& mask);
+
+        const GsHsvRanges& hsv_ranges() const { return hsv_ranges_; }
+
+    private:
+        enum CellState : uint8_t {
+            kUnknown = 0,
+            kAllOut,
+            kAllIn,
+            kMixed
+        };
+
+        static constexpr int kCellBits = 3;
+        static constexpr int kCellsPerChannel = 256 >> kCellBits;
+
+        void ComputeRegionMask(const cv::Mat& bgr_image, const cv::Rect& region, cv::Mat& mask);
+        void ClassifyCell(const int cell);
+
+        GsHsvRanges hsv_ranges_;
+        std::vector<uint8_t> cell_states_;
+
+        // For kMixed cells, the index of their bit map in mixed_cell_bits_
+        std::vector<uint16_t> mixed_cell_index_;
+        std::vector<std::array<uint64_t, 8>> mixed_cell_bits_;
+    };
+
+}
@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <cmath>
+
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "cv_utils.h"
+
+#include "gs_color_statistics.h"
+
+namespace golf_sim {
+
+    GsColorStatistics::GsColorStatistics(const cv::Mat& img, const std::vector<GsCircle>& expected_circles) : img_(img) {
+
+        if (img.empty() || img.depth() != CV_8U || img.channels() > 4) {
+            return;
+        }
+
+        cv::Rect region;
+        long query_pixels = 0;
+
+        for (const GsCircle& circle : expected_circles) {
+            if ((int)CvUtils::CircleRadius(circle) == 0) {
+                continue;
+            }
+
+            cv::Rect rect = CvUtils::GetBallColorRect(img, circle);
+            region = (region.area() == 0) ? rect : (region | rect);
+            query_pixels += rect.area();
+        }
+
+        // Building the integral images costs about as much as averaging the same number of
+        // pixels directly, so they only pay off if the circles cover more than the region
+        if (region.area() == 0 || query_pixels <= region.area()) {
+            return;
+        }
+
+        GS_LOG_TRACE_MSG(trace, "GsColorStatistics - using integral images over " + std::to_string(region.width) + "x" + std::to_string(region.height) +
+                                " pixels for " + std::to_string(expected_circles.size()) + " circles.");
+
+        region_ = region;
+        cv::integral(img(region_), sum_, squared_sum_, CV_64F, CV_64F);
+    }
+
+    bool GsColorStatistics::GetRectColorStatistics(const cv::Rect& rect, GsColorTriplet& mean, GsColorTriplet& std) const {
+
+        const double number_pixels = (double)rect.area();
+
+        if (!UsesIntegralImages() || number_pixels <= 0 || (rect & region_) != rect) {
+            return false;
+        }
+
+        // The integral images have one extra leading row and column
+        const int x0 = rect.x - region_.x;
+        const int y0 = rect.y - region_.y;
+        const int x1 = x0 + rect.width;
+        const int y1 = y0 + rect.height;
+
+        const int channels = img_.channels();
+        mean = GsColorTriplet(0, 0, 0);
+        std = GsColorTriplet(0, 0, 0);
+
+        for (int c = 0; c < channels; c++) {
+            const double sum = sum_.ptr<double>(y1)[x1 * channels + c] - sum_.ptr<double>(y0)[x1 * channels + c]
+                             - sum_.ptr<double>(y1)[x0 * channels + c] + sum_.ptr<double>(y0)[x0 * channels + c];
+            const double squared_sum = squared_sum_.ptr<double>(y1)[x1 * channels + c] - squared_sum_.ptr<double>(y0)[x1 * channels + c]
+                                     - squared_sum_.ptr<double>(y1)[x0 * channels + c] + squared_sum_.ptr<double>(y0)[x0 * channels + c];
+
+            const double channel_mean = sum / number_pixels;
+            mean[c] = channel_mean;
+            std[c] = std::sqrt(std::max(0.0, squared_sum / number_pixels - channel_mean * channel_mean));
+        }
+
+        return true;
+    }
+
+    std::vector<GsColorTriplet> GsColorStatistics::GetBallColorRgb(const GsCircle& circle) const {
+
+        GsColorTriplet avg_color;
+        GsColorTriplet std_color;
+
+        if ((int)CvUtils::CircleRadius(circle) == 0 ||
+            !GetRectColorStatistics(CvUtils::GetBallColorRect(img_, circle), avg_color, std_color)) {
+            return CvUtils::GetBallColorRgb(img_, circle);
+        }
+
+        // Match the float precision that CvUtils::GetBallColorRgb returns
+        GsColorTriplet avg_color_vec3f{ (float)avg_color[0], (float)avg_color[1], (float)avg_color[2] };
+        GsColorTriplet std_color_vec3f{ (float)std_color[0], (float)std_color[1], (float)std_color[2] };
+
+        // TBD - Compute Median, as in CvUtils
+        std::vector<GsColorTriplet> results{ avg_color_vec3f, avg_color_vec3f, std_color_vec3f };
+        return results;
+    }
+
+}
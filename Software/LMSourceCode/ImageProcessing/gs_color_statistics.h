@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Answers CvUtils::GetBallColorRgb-style mean/std queries for many circles on the
+// same image.  The per-channel sum and sum-of-squares integral images are built once,
+// over just the region that the expected circles cover, after which each query is a
+// handful of lookups instead of a cv::meanStdDev pass over the ball's pixels.
+// If the circles would not share enough of that region to pay for the integral images,
+// or a query falls outside of it, the queries are passed through to CvUtils instead.
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "gs_globals.h"
+
+namespace golf_sim {
+
+    class GsColorStatistics {
+
+    public:
+        // The image must outlive this object
+        GsColorStatistics(const cv::Mat& img, const std::vector<GsCircle>& expected_circles);
+
+        // Returns the same { average, median, std } as CvUtils::GetBallColorRgb(img, circle)
+        std::vector<GsColorTriplet> GetBallColorRgb(const GsCircle& circle) const;
+
+        // Mean and (population) standard deviation of each channel within the rectangle
+        bool GetRectColorStatistics(const cv::Rect& rect, GsColorTriplet& mean, GsColorTriplet& std) const;
+
+        bool UsesIntegralImages() const { return !sum_.empty(); }
+
+        const cv::Mat& image() const { return img_; }
+
+    private:
+        const cv::Mat& img_;
+
+        // The region of img_ that the integral images cover
+        cv::Rect region_;
+        cv::Mat sum_;
+        cv::Mat squared_sum_;
+    };
+
+}
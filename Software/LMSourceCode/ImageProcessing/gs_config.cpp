@@ -20,6 +20,8 @@
 
 // Having to set the constants in this way creates more entanglement than we'd like.  TBD - Re-architect
 #include "libcamera_interface.h"
+#include "gs_startup_cache.h"
+#include "gs_config_snapshot.h"
 
 
 
@@ -49,6 +51,9 @@ namespace golf_sim {
 			GS_LOG_MSG(info, "ConfigurationManager initialized with override support");
 		}
 
+		// Every scalar value is resolved and parsed once, here, instead of on each SetConstant
+		RebuildSnapshot();
+
 		// Read any values that we want to set early, here at initialization
 		if (!ReadValues()) {
 			return false;
@@ -180,6 +185,34 @@ bool GolfSimConfiguration::ReadValues() {
 	
 	SetConstant("gs_config.image_capture.kMaxWatchingCropWidth", LibCameraInterface::kMaxWatchingCropWidth);
 	SetConstant("gs_config.image_capture.kMaxWatchingCropHeight", LibCameraInterface::kMaxWatchingCropHeight);
+	SetConstant("gs_config.image_capture.kUseAdaptiveWatchingRoi", LibCameraInterface::kUseAdaptiveWatchingRoi);
+	SetConstant("gs_config.image_capture.kMinWatchingCropWidth", LibCameraInterface::kMinWatchingCropWidth);
+	SetConstant("gs_config.image_capture.kMinWatchingCropHeight", LibCameraInterface::kMinWatchingCropHeight);
+	SetConstant("gs_config.image_capture.kAdaptiveWatchingRoiExitFraction", LibCameraInterface::kAdaptiveWatchingRoiExitFraction);
+	SetConstant("gs_config.image_capture.kUseApproachZone", LibCameraInterface::kUseApproachZone);
+	SetConstant("gs_config.image_capture.kApproachZoneMinWidthPixels", LibCameraInterface::kApproachZoneMinWidthPixels);
+	SetConstant("gs_config.image_capture.kApproachZoneReleaseFrames", LibCameraInterface::kApproachZoneReleaseFrames);
+	SetConstant("gs_config.image_capture.kUseBallPlacementWatcher", LibCameraInterface::kUseBallPlacementWatcher);
+	SetConstant("gs_config.image_capture.kBallPlacementWatcherFPS", LibCameraInterface::kBallPlacementWatcherFPS);
+	SetConstant("gs_config.image_capture.kBallPlacementWatcherFramePeriod", LibCameraInterface::kBallPlacementWatcherFramePeriod);
+	SetConstant("gs_config.image_capture.kBallPlacementWatcherDecimation", LibCameraInterface::kBallPlacementWatcherDecimation);
+	SetConstant("gs_config.image_capture.kBallPlacementWatcherRegionHalfSizePixels", LibCameraInterface::kBallPlacementWatcherRegionHalfSizePixels);
+	SetConstant("gs_config.image_capture.kBallPlacementWatcherPixelDifference", LibCameraInterface::kBallPlacementWatcherPixelDifference);
+	SetConstant("gs_config.image_capture.kBallPlacementWatcherChangedFraction", LibCameraInterface::kBallPlacementWatcherChangedFraction);
+	SetConstant("gs_config.image_capture.kBallPlacementWatcherMaxWatchTimeMs", LibCameraInterface::kBallPlacementWatcherMaxWatchTimeMs);
+	SetConstant("gs_config.image_capture.kBallPlacementWatcherForcedCheckIntervalMs", LibCameraInterface::kBallPlacementWatcherForcedCheckIntervalMs);
+	SetConstant("gs_config.image_capture.kUseBallPlacementTracking", LibCameraInterface::kUseBallPlacementTracking);
+	SetConstant("gs_config.image_capture.kBallPlacementTrackingWindowRadiusRatio", LibCameraInterface::kBallPlacementTrackingWindowRadiusRatio);
+	SetConstant("gs_config.image_capture.kBallPlacementTrackingMinCorrelation", LibCameraInterface::kBallPlacementTrackingMinCorrelation);
+	SetConstant("gs_config.image_capture.kBallPlacementTrackingMaxMovePixels", LibCameraInterface::kBallPlacementTrackingMaxMovePixels);
+	SetConstant("gs_config.image_capture.kBallPlacementBurstFrames", LibCameraInterface::kBallPlacementBurstFrames);
+	SetConstant("gs_config.image_capture.kBallPlacementBurstMaxMeanDifference", LibCameraInterface::kBallPlacementBurstMaxMeanDifference);
+	SetConstant("gs_config.image_capture.kBallPlacementCaptureDownscale", LibCameraInterface::kBallPlacementCaptureDownscale);
+	SetConstant("gs_config.image_capture.kUseEmptyTeeFastPath", LibCameraInterface::kUseEmptyTeeFastPath);
+	SetConstant("gs_config.image_capture.kEmptyTeeMaxMeanDifference", LibCameraInterface::kEmptyTeeMaxMeanDifference);
+	SetConstant("gs_config.image_capture.kEmptyTeeMaxAgeMs", LibCameraInterface::kEmptyTeeMaxAgeMs);
+	SetConstant("gs_config.image_capture.kBallWatcherDetectOnly", LibCameraInterface::kBallWatcherDetectOnly);
+	SetConstant("gs_config.image_capture.kBallWatcherRealtimeMode", LibCameraInterface::kBallWatcherRealtimeMode);
 	SetConstant("gs_config.cameras.kCamera1Gain", LibCameraInterface::kCamera1Gain);
 	SetConstant("gs_config.cameras.kCamera1Saturation", LibCameraInterface::kCamera1Saturation);
 	SetConstant("gs_config.cameras.kCamera1HighFPSGain", LibCameraInterface::kCamera1HighFPSGain);
@@ -204,6 +237,15 @@ bool GolfSimConfiguration::ReadValues() {
 	SetConstant("gs_config.cameras.kCamera1StillShutterTimeuS", LibCameraInterface::kCamera1StillShutterTimeuS);
 	SetConstant("gs_config.cameras.kCamera2StillShutterTimeuS", LibCameraInterface::kCamera2StillShutterTimeuS);
 	SetConstant("gs_config.cameras.kCameraMotionDetectSettings", LibCameraInterface::kCameraMotionDetectSettings);
+	SetConstant("gs_config.cameras.kCamera2UndistortRoiOnly", LibCameraInterface::kCamera2UndistortRoiOnly);
+	SetConstant("gs_config.cameras.kCamera2UndistortRoiTopFraction", LibCameraInterface::kCamera2UndistortRoiTopFraction);
+	SetConstant("gs_config.cameras.kCamera2UndistortRoiBottomFraction", LibCameraInterface::kCamera2UndistortRoiBottomFraction);
+	SetConstant("gs_config.cameras.kCamera2UndistortRoiMarginPixels", LibCameraInterface::kCamera2UndistortRoiMarginPixels);
+	SetConstant("gs_config.cameras.kCamera2MonoCapture", LibCameraInterface::kCamera2MonoCapture);
+	SetConstant("gs_config.cameras.kCamera2GpuPreprocessing", LibCameraInterface::kCamera2GpuPreprocessing);
+	SetConstant("gs_config.cameras.kCamera2PersistentRequests", LibCameraInterface::kCamera2PersistentRequests);
+	SetConstant("gs_config.cameras.kCamera1PersistentStills", LibCameraInterface::kCamera1PersistentStills);
+	SetConstant("gs_config.cameras.kStartupCacheDirectory", GsStartupCache::kStartupCacheDirectory);
 
 	// The web server share directory isn't really a value we want to use from the .json configuration
 	// file anymore, but for now, let's allow it as a fall-back to the command line
@@ -316,7 +358,23 @@ bool GolfSimConfiguration::ReadValues() {
 	}
 
 
+	void GolfSimConfiguration::RebuildSnapshot() {
+		GsConfigSnapshot::Publish(GsConfigSnapshot::Build(configuration_root_));
+	}
+
+	// The pre-parsed snapshot covers almost every value.  The rest (and any value that
+	// would fail to convert) take the original, slower path below.
+	template <typename T>
+	static bool GetFromSnapshot(const std::string& tag_name, T& constant_value) {
+		const std::shared_ptr<const GsConfigSnapshot> snapshot = GsConfigSnapshot::Current();
+		return snapshot && snapshot->Get(tag_name, constant_value);
+	}
+
 	void GolfSimConfiguration::SetConstant(const std::string& tag_name, bool& constant_value) {
+		if (GetFromSnapshot(tag_name, constant_value)) {
+			return;
+		}
+
 		// Try ConfigurationManager first for override support
 		ConfigurationManager& config_mgr = ConfigurationManager::GetInstance();
 		if (config_mgr.HasKey(tag_name)) {
@@ -340,6 +398,10 @@ bool GolfSimConfiguration::ReadValues() {
 	}
 
 	void GolfSimConfiguration::SetConstant(const std::string& tag_name, int& constant_value) {
+		if (GetFromSnapshot(tag_name, constant_value)) {
+			return;
+		}
+
 		// Try ConfigurationManager first for override support
 		ConfigurationManager& config_mgr = ConfigurationManager::GetInstance();
 		if (config_mgr.HasKey(tag_name)) {
@@ -363,6 +425,10 @@ bool GolfSimConfiguration::ReadValues() {
 	}
 
 	void GolfSimConfiguration::SetConstant(const std::string& tag_name, long& constant_value) {
+		if (GetFromSnapshot(tag_name, constant_value)) {
+			return;
+		}
+
 		try {
 			constant_value = configuration_root_.get<long>(tag_name, 0);
 		}
@@ -374,6 +440,10 @@ bool GolfSimConfiguration::ReadValues() {
 	}
 
 	void GolfSimConfiguration::SetConstant(const std::string& tag_name, unsigned int& constant_value) {
+		if (GetFromSnapshot(tag_name, constant_value)) {
+			return;
+		}
+
 		try {
 			constant_value = configuration_root_.get<uint>(tag_name, 0);
 		}
@@ -385,6 +455,10 @@ bool GolfSimConfiguration::ReadValues() {
 	}
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, float& constant_value) {
+		if (GetFromSnapshot(tag_name, constant_value)) {
+			return;
+		}
+
 		// Try ConfigurationManager first for override support
 		ConfigurationManager& config_mgr = ConfigurationManager::GetInstance();
 		if (config_mgr.HasKey(tag_name)) {
@@ -408,6 +482,10 @@ bool GolfSimConfiguration::ReadValues() {
 	}
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, double& constant_value) {
+		if (GetFromSnapshot(tag_name, constant_value)) {
+			return;
+		}
+
 		try {
 			constant_value = configuration_root_.get<double>(tag_name, 0.0);
 		}
@@ -419,6 +497,10 @@ bool GolfSimConfiguration::ReadValues() {
 	}
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, std::string& constant_value) {
+		if (GetFromSnapshot(tag_name, constant_value)) {
+			return;
+		}
+
 		// Try ConfigurationManager first for override support
 		ConfigurationManager& config_mgr = ConfigurationManager::GetInstance();
 		
@@ -564,6 +646,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 			 if (PropertyExists(tag_name)) {
 				 configuration_root_.erase(tag_name);
+				 RebuildSnapshot();
 				 return true;
 			 }
 		 }
@@ -604,6 +687,8 @@ bool GolfSimConfiguration::ReadValues() {
 
 				 configuration_root_.add_child(tag_name, new_node);
 			 }
+
+			 RebuildSnapshot();
 		 }
 		 catch (std::exception const& e)
 		 {
@@ -622,6 +707,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 		 try {
 			 configuration_root_.put(tag_name, value);
+			 RebuildSnapshot();
 		 }
 		 catch (std::exception const& e)
 		 {
@@ -634,6 +720,30 @@ bool GolfSimConfiguration::ReadValues() {
 		 return true;
 	 }
 
+	 bool GolfSimConfiguration::SetTreeValue(const std::string& tag_name, const std::vector<double>& values) {
+
+		 try {
+			 boost::property_tree::ptree new_node;
+
+			 for (const double value : values) {
+				 boost::property_tree::ptree element;
+				 element.put("", value);
+				 new_node.push_back(std::make_pair("", element));
+			 }
+
+			 // Replaces the whole array, which may have had a different length
+			 configuration_root_.put_child(tag_name, new_node);
+			 RebuildSnapshot();
+		 }
+		 catch (std::exception const& e)
+		 {
+			 GS_LOG_MSG(error, "GolfSimConfiguration::SetTreeValue failed. ERROR: *** " + std::string(e.what()) + " ***");
+			 return false;
+		 }
+
+		 return true;
+	 }
+
 	 bool GolfSimConfiguration::WriteTreeToFile(const std::string& file_name) {
 
 		 GS_LOG_MSG(trace, "GolfSimConfiguration::WriteTreeToFile called for file_name = " + file_name);
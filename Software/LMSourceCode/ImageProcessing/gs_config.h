@@ -58,6 +58,10 @@ namespace golf_sim {
 
 		static bool PropertyExists(const std::string& value_tag);
 
+		// Re-resolves every value (e.g., after a ConfigurationManager override changes) and
+		// publishes the result for SetConstant to use
+		static void RebuildSnapshot();
+
 		static void SetConstant(const std::string& value_tag, bool& constant_value);
 		static void SetConstant(const std::string& value_tag, int& constant_value);
 		static void SetConstant(const std::string& value_tag, long& constant_value);
@@ -79,6 +83,7 @@ namespace golf_sim {
 		// Set the specified value to the value.  The node will be created if necessary
 		static bool SetTreeValue(const std::string& tag_name, const cv::Vec2d& vec);
 		static bool SetTreeValue(const std::string& tag_name, const double value);
+		static bool SetTreeValue(const std::string& tag_name, const std::vector<double>& values);
 
 		// Write the current json tree to the specified file
 		static bool WriteTreeToFile(const std::string& file_name);
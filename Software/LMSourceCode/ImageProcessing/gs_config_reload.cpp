@@ -0,0 +1,178 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "configuration_manager.h"
+#include "ball_image_proc.h"
+#include "gs_memory_footprint.h"
+#ifdef __unix__
+#include "gs_performance_profile.h"
+#endif
+
+#include "gs_config_reload.h"
+
+namespace golf_sim {
+
+    std::string GsConfigReload::kConfigReloadFile;
+    int GsConfigReload::kConfigReloadPollIntervalMs = 1000;
+
+    std::thread GsConfigReload::watcher_thread_;
+    std::atomic<bool> GsConfigReload::exiting_{ false };
+    std::atomic<bool> GsConfigReload::changes_pending_{ false };
+
+    std::mutex GsConfigReload::pending_mutex_;
+    std::map<std::string, std::string> GsConfigReload::pending_values_;
+
+
+    void GsConfigReload::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.modes.kConfigReloadFile", kConfigReloadFile);
+        GolfSimConfiguration::SetConstant("gs_config.modes.kConfigReloadPollIntervalMs", kConfigReloadPollIntervalMs);
+    }
+
+    void GsConfigReload::Start() {
+        if (kConfigReloadFile.empty() || watcher_thread_.joinable()) {
+            return;
+        }
+
+        exiting_ = false;
+        watcher_thread_ = std::thread(&GsConfigReload::Watch);
+
+        GS_LOG_MSG(info, "GsConfigReload - watching " + kConfigReloadFile + " for tuning changes.");
+    }
+
+    void GsConfigReload::Stop() {
+        exiting_ = true;
+
+        if (watcher_thread_.joinable()) {
+            watcher_thread_.join();
+        }
+    }
+
+    void GsConfigReload::Watch() {
+
+        const std::filesystem::path reload_file(kConfigReloadFile);
+        std::filesystem::file_time_type last_write_time{};
+        bool have_read_file = false;
+
+        const auto poll_interval = std::chrono::milliseconds(std::max(100, kConfigReloadPollIntervalMs));
+        const auto sleep_interval = std::chrono::milliseconds(100);
+
+        while (!exiting_) {
+            std::error_code ec;
+            const std::filesystem::file_time_type write_time = std::filesystem::last_write_time(reload_file, ec);
+
+            // A file that is already there at startup counts as a change, too
+            if (!ec && (!have_read_file || write_time != last_write_time)) {
+                std::map<std::string, std::string> values;
+
+                // An editor may still be writing the file, so only move on once it parses
+                if (ReadChanges(values)) {
+                    last_write_time = write_time;
+                    have_read_file = true;
+
+                    {
+                        std::lock_guard<std::mutex> lock(pending_mutex_);
+                        for (const auto& [key, value] : values) {
+                            pending_values_[key] = value;
+                        }
+                    }
+
+                    changes_pending_ = true;
+
+                    GS_LOG_MSG(info, "GsConfigReload - read " + std::to_string(values.size()) + " value(s) from " + kConfigReloadFile +
+                        ".  They will be used once the system is waiting for a ball.");
+                }
+            }
+
+            for (auto waited = std::chrono::milliseconds(0); waited < poll_interval && !exiting_; waited += sleep_interval) {
+                std::this_thread::sleep_for(sleep_interval);
+            }
+        }
+    }
+
+    bool GsConfigReload::ReadChanges(std::map<std::string, std::string>& values) {
+
+        boost::property_tree::ptree reload_root;
+
+        try {
+            boost::property_tree::read_json(kConfigReloadFile, reload_root);
+        }
+        catch (std::exception const& e)
+        {
+            GS_LOG_MSG(warning, "GsConfigReload - could not read " + kConfigReloadFile + ". ERROR: *** " + std::string(e.what()) + " ***");
+            return false;
+        }
+
+        std::function<void(const boost::property_tree::ptree&, const std::string&)> add_values =
+            [&](const boost::property_tree::ptree& node, const std::string& path) {
+
+            for (const boost::property_tree::ptree::value_type& child : node) {
+                if (child.first.empty()) {
+                    GS_LOG_MSG(warning, "GsConfigReload - ignoring " + path + ".  Array values cannot be reloaded.");
+                    return;
+                }
+
+                const std::string child_path = path.empty() ? child.first : path + "." + child.first;
+
+                if (child.second.empty()) {
+                    values[child_path] = child.second.data();
+                }
+                else {
+                    add_values(child.second, child_path);
+                }
+            }
+        };
+
+        add_values(reload_root, "");
+
+        return true;
+    }
+
+    bool GsConfigReload::ApplyPendingChanges() {
+
+        if (!changes_pending_.exchange(false)) {
+            return false;
+        }
+
+        std::map<std::string, std::string> values;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            values.swap(pending_values_);
+        }
+
+        const auto start_time = std::chrono::steady_clock::now();
+
+        ConfigurationManager& config_mgr = ConfigurationManager::GetInstance();
+
+        for (const auto& [key, value] : values) {
+            GS_LOG_MSG(info, "GsConfigReload - " + key + " = " + value);
+            config_mgr.SetOverride(key, value);
+        }
+
+        GolfSimConfiguration::RebuildSnapshot();
+        BallImageProc::ReloadTuningValues();
+        // The reload would otherwise undo the profiles' spin search settings
+        GsMemoryFootprint::ApplyLowMemoryProfile();
+#ifdef __unix__
+        GsPerformanceProfile::ApplySelectedProfile();
+#endif
+
+        const long reload_ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+        GS_LOG_MSG(info, "GsConfigReload - applied " + std::to_string(values.size()) + " value(s) in " + std::to_string(reload_ms) + "ms.");
+
+        return true;
+    }
+
+}
@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Lets detection and spin values be tuned while pitrac_lm is running.  A watcher
+// thread polls kConfigReloadFile - a partial copy of golf_sim_config.json holding
+// only the values being tuned, e.g.,
+//     { "gs_config": { "spin_analysis": { "kCoarseXRotationDegreesIncrement": "4" } } }
+// When the file changes, its values are read (but not yet used).  The FSM then calls
+// ApplyPendingChanges when it is waiting for a ball, i.e., between shots.  That turns
+// each value into a ConfigurationManager override, republishes the configuration
+// snapshot and reloads the ball-identification values.
+//
+// Anything read when a GolfSimCamera is constructed takes effect on the next shot.
+// Camera modes, model files and model input sizes still need a restart.
+// Removing a value from the file does not undo its override - set it back instead.
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace golf_sim {
+
+    class GsConfigReload {
+
+    public:
+        // An empty file name (the default) turns the watcher off
+        static std::string kConfigReloadFile;
+        static int kConfigReloadPollIntervalMs;
+
+        static void LoadConfigurationValues();
+
+        static void Start();
+        static void Stop();
+
+        // Only call this when no shot is being processed.  Returns true if anything changed.
+        static bool ApplyPendingChanges();
+
+    private:
+        static void Watch();
+        static bool ReadChanges(std::map<std::string, std::string>& values);
+
+        static std::thread watcher_thread_;
+        static std::atomic<bool> exiting_;
+        static std::atomic<bool> changes_pending_;
+
+        // Guards pending_values_
+        static std::mutex pending_mutex_;
+        static std::map<std::string, std::string> pending_values_;
+    };
+
+}
@@ -0,0 +1,282 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include "logging_tools.h"
+#include "configuration_manager.h"
+
+#include "gs_config_snapshot.h"
+
+namespace golf_sim {
+
+    std::atomic<std::shared_ptr<const GsConfigSnapshot>> GsConfigSnapshot::current_;
+    std::atomic<uint64_t> GsConfigSnapshot::last_generation_{ 0 };
+
+
+    GsConfigSnapshot::Value GsConfigSnapshot::ParseValue(const std::string& text) {
+
+        Value value;
+        value.text = text;
+
+        // The same spellings that the property tree accepts
+        if (text == "true" || text == "1") {
+            value.bool_value = true;
+        }
+        else if (text == "false" || text == "0") {
+            value.bool_value = false;
+        }
+
+        if (text.empty()) {
+            return value;
+        }
+
+        // Only whole-string conversions count.  Anything else is left to the slower
+        // path so that its error handling stays the same.
+        const char* begin = text.c_str();
+        char* end = nullptr;
+
+        errno = 0;
+        const long integer_value = std::strtol(begin, &end, 10);
+        if (errno == 0 && *end == '\0') {
+            value.integer_value = integer_value;
+        }
+
+        errno = 0;
+        const double number_value = std::strtod(begin, &end);
+        if (errno == 0 && *end == '\0') {
+            value.number_value = number_value;
+        }
+
+        return value;
+    }
+
+    void GsConfigSnapshot::AddEntries(const boost::property_tree::ptree& node, const std::string& path, GsConfigSnapshot& snapshot) {
+
+        const ConfigurationManager& config_mgr = ConfigurationManager::GetInstance();
+
+        for (const boost::property_tree::ptree::value_type& child : node) {
+            if (child.first.empty()) {
+                continue;
+            }
+
+            const std::string child_path = path.empty() ? child.first : path + "." + child.first;
+
+            if (!child.second.empty()) {
+                AddEntries(child.second, child_path, snapshot);
+                continue;
+            }
+
+            Entry entry;
+            entry.json = ParseValue(child.second.data());
+
+            if (config_mgr.HasKey(child_path)) {
+                const std::string override_text = config_mgr.GetString(child_path, entry.json.text);
+                if (override_text != entry.json.text) {
+                    entry.override = ParseValue(override_text);
+                }
+            }
+
+            snapshot.entries_[child_path] = std::move(entry);
+        }
+    }
+
+    std::shared_ptr<const GsConfigSnapshot> GsConfigSnapshot::Build(const boost::property_tree::ptree& configuration_root) {
+
+        const auto start_time = std::chrono::steady_clock::now();
+
+        std::shared_ptr<GsConfigSnapshot> snapshot = std::make_shared<GsConfigSnapshot>();
+
+        AddEntries(configuration_root, "", *snapshot);
+
+        MotionDetectValues& m = snapshot->motion_detect_values_;
+        snapshot->Get("gs_config.motion_detect_stage.kDifferenceM", m.difference_m);
+        snapshot->Get("gs_config.motion_detect_stage.kDifferenceC", m.difference_c);
+        snapshot->Get("gs_config.motion_detect_stage.kRegionThreshold", m.region_threshold);
+        snapshot->Get("gs_config.motion_detect_stage.kMaxRegionThreshold", m.max_region_threshold);
+        snapshot->Get("gs_config.motion_detect_stage.kFramePeriod", m.frame_period);
+        snapshot->Get("gs_config.motion_detect_stage.kHSkip", m.hskip);
+        snapshot->Get("gs_config.motion_detect_stage.kVSkip", m.vskip);
+        snapshot->Get("gs_config.motion_detect_stage.kUseLoresStream", m.use_lores_stream);
+        snapshot->Get("gs_config.motion_detect_stage.kUseSensorFrameSkipping", m.use_sensor_frame_skipping);
+        snapshot->Get("gs_config.motion_detect_stage.kUseBackgroundModel", m.use_background_model);
+        snapshot->Get("gs_config.motion_detect_stage.kBackgroundModelScreenStride", m.background_model_screen_stride);
+        snapshot->Get("gs_config.motion_detect_stage.kCroppedImagePixelOffsetLeft", m.cropped_image_pixel_offset_left);
+        snapshot->Get("gs_config.motion_detect_stage.kCroppedImagePixelOffsetUp", m.cropped_image_pixel_offset_up);
+
+        // FNV-1a over the sorted keys and their resolved values
+        std::vector<const std::pair<const std::string, Entry>*> sorted_entries;
+        sorted_entries.reserve(snapshot->entries_.size());
+        for (const auto& entry : snapshot->entries_) {
+            sorted_entries.push_back(&entry);
+        }
+        std::sort(sorted_entries.begin(), sorted_entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+        uint64_t content_hash = 14695981039346656037ULL;
+        auto hash_bytes = [&content_hash](const std::string& bytes) {
+            for (const char c : bytes) {
+                content_hash = (content_hash ^ (uint8_t)c) * 1099511628211ULL;
+            }
+            content_hash = (content_hash ^ 0xFF) * 1099511628211ULL;
+        };
+        for (const auto* entry : sorted_entries) {
+            hash_bytes(entry->first);
+            hash_bytes(entry->second.override ? entry->second.override->text : entry->second.json.text);
+        }
+        snapshot->content_hash_ = content_hash;
+
+        snapshot->generation_ = ++last_generation_;
+
+        const long build_us = (long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+        GS_LOG_TRACE_MSG(trace, "GsConfigSnapshot::Build - " + std::to_string(snapshot->entries_.size()) + " values in " +
+            std::to_string(build_us) + "us (generation " + std::to_string(snapshot->generation_) + ").");
+
+        return snapshot;
+    }
+
+    std::shared_ptr<const GsConfigSnapshot> GsConfigSnapshot::Current() {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    void GsConfigSnapshot::Publish(std::shared_ptr<const GsConfigSnapshot> snapshot) {
+        current_.store(std::move(snapshot), std::memory_order_release);
+    }
+
+    std::future<bool> GsConfigSnapshot::ReloadAsync(const std::string& configuration_filename) {
+
+        return std::async(std::launch::async, [configuration_filename]() {
+
+            boost::property_tree::ptree configuration_root;
+
+            try {
+                boost::property_tree::read_json(configuration_filename, configuration_root);
+            }
+            catch (std::exception const& e)
+            {
+                GS_LOG_MSG(error, "GsConfigSnapshot::ReloadAsync failed. ERROR: *** " + std::string(e.what()) + " ***");
+                return false;
+            }
+
+            Publish(Build(configuration_root));
+
+            GS_LOG_MSG(info, "GsConfigSnapshot::ReloadAsync - published the configuration from " + configuration_filename);
+            return true;
+        });
+    }
+
+    const GsConfigSnapshot::Entry* GsConfigSnapshot::Find(const std::string& tag_name) const {
+        const auto it = entries_.find(tag_name);
+        return (it == entries_.end()) ? nullptr : &it->second;
+    }
+
+    bool GsConfigSnapshot::Get(const std::string& tag_name, bool& constant_value) const {
+        const Entry* entry = Find(tag_name);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        const Value& value = entry->override ? *entry->override : entry->json;
+        if (!value.bool_value) {
+            return false;
+        }
+
+        constant_value = *value.bool_value;
+        return true;
+    }
+
+    bool GsConfigSnapshot::Get(const std::string& tag_name, int& constant_value) const {
+        const Entry* entry = Find(tag_name);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        const Value& value = entry->override ? *entry->override : entry->json;
+        if (!value.integer_value || *value.integer_value < INT_MIN || *value.integer_value > INT_MAX) {
+            return false;
+        }
+
+        constant_value = (int)*value.integer_value;
+        return true;
+    }
+
+    bool GsConfigSnapshot::Get(const std::string& tag_name, float& constant_value) const {
+        const Entry* entry = Find(tag_name);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        const Value& value = entry->override ? *entry->override : entry->json;
+        if (!value.number_value) {
+            return false;
+        }
+
+        constant_value = (float)*value.number_value;
+        return true;
+    }
+
+    bool GsConfigSnapshot::Get(const std::string& tag_name, std::string& constant_value) const {
+        const Entry* entry = Find(tag_name);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        constant_value = entry->override ? entry->override->text : entry->json.text;
+        return true;
+    }
+
+    bool GsConfigSnapshot::Get(const std::string& tag_name, long& constant_value) const {
+        const Entry* entry = Find(tag_name);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        const Value& value = entry->override ? *entry->override : entry->json;
+        if (!value.integer_value) {
+            return false;
+        }
+
+        constant_value = *value.integer_value;
+        return true;
+    }
+
+    bool GsConfigSnapshot::Get(const std::string& tag_name, unsigned int& constant_value) const {
+        const Entry* entry = Find(tag_name);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        const Value& value = entry->override ? *entry->override : entry->json;
+        if (!value.integer_value || *value.integer_value < 0 || *value.integer_value > (long)UINT_MAX) {
+            return false;
+        }
+
+        constant_value = (unsigned int)*value.integer_value;
+        return true;
+    }
+
+    bool GsConfigSnapshot::Get(const std::string& tag_name, double& constant_value) const {
+        const Entry* entry = Find(tag_name);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        const Value& value = entry->override ? *entry->override : entry->json;
+        if (!value.number_value) {
+            return false;
+        }
+
+        constant_value = *value.number_value;
+        return true;
+    }
+
+}
@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// An immutable, already-parsed copy of every scalar value in the configuration.
+// Each value is resolved once (the golf_sim_config.json value plus any
+// ConfigurationManager YAML/command-line override) and converted to its bool and
+// numeric forms when the snapshot is built.  After that, GolfSimConfiguration::SetConstant
+// is a hash lookup - no ptree path walking, no string-to-number conversion and no
+// ConfigurationManager mutex - which matters for the code that re-reads its values
+// on every shot (e.g., each GolfSimCamera and each motion-detect re-arm).
+//
+// The current snapshot is swapped atomically, so a reader always sees one whole,
+// consistent configuration.  ReloadAsync re-reads the .json file and publishes a new
+// snapshot without blocking anyone.  Values that have already been copied into
+// static members only change when their LoadConfigurationValues (or similar) runs again.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace golf_sim {
+
+    class GsConfigSnapshot {
+
+    public:
+        struct Value {
+            std::string text;
+            std::optional<bool> bool_value;
+            std::optional<long> integer_value;
+            std::optional<double> number_value;
+        };
+
+        struct Entry {
+            // From the .json file
+            Value json;
+            // Only set if the ConfigurationManager resolves the key to something different
+            std::optional<Value> override;
+        };
+
+        // The values that ConfigurePostProcessing hands to the motion-detect stage on
+        // every re-arm of the ball watcher
+        struct MotionDetectValues {
+            float difference_m = 0.f;
+            float difference_c = 0.f;
+            float region_threshold = 0.f;
+            float max_region_threshold = 0.f;
+            unsigned int frame_period = 0;
+            unsigned int hskip = 0;
+            unsigned int vskip = 0;
+            bool use_lores_stream = false;
+            bool use_sensor_frame_skipping = false;
+            bool use_background_model = false;
+            int background_model_screen_stride = 4;
+            int cropped_image_pixel_offset_left = 0;
+            int cropped_image_pixel_offset_up = 0;
+        };
+
+        // Flattens the tree.  Array elements (which have no key) are skipped - the
+        // vector and matrix values are still read from the tree itself.
+        static std::shared_ptr<const GsConfigSnapshot> Build(const boost::property_tree::ptree& configuration_root);
+
+        // Returns nullptr until the first snapshot is published
+        static std::shared_ptr<const GsConfigSnapshot> Current();
+        static void Publish(std::shared_ptr<const GsConfigSnapshot> snapshot);
+
+        // Re-reads the configuration file on a separate thread and publishes the result.
+        // The YAML and command-line overrides are the ones already loaded.
+        // Resolves to false (and leaves the current snapshot in place) if the file cannot be read.
+        static std::future<bool> ReloadAsync(const std::string& configuration_filename);
+
+        // Each returns false, leaving constant_value unchanged, if the key is not a scalar
+        // in the snapshot or its value does not convert cleanly to the requested type.
+        // The caller then falls back to reading the tree directly.  A ConfigurationManager
+        // override is used for every type, including the long, unsigned int and double
+        // values that the tree-reading path has never overridden.
+        bool Get(const std::string& tag_name, bool& constant_value) const;
+        bool Get(const std::string& tag_name, int& constant_value) const;
+        bool Get(const std::string& tag_name, long& constant_value) const;
+        bool Get(const std::string& tag_name, unsigned int& constant_value) const;
+        bool Get(const std::string& tag_name, float& constant_value) const;
+        bool Get(const std::string& tag_name, double& constant_value) const;
+        bool Get(const std::string& tag_name, std::string& constant_value) const;
+
+        const MotionDetectValues& GetMotionDetectValues() const { return motion_detect_values_; }
+
+        // Increases by one with each snapshot that is built
+        uint64_t Generation() const { return generation_; }
+
+        size_t Size() const { return entries_.size(); }
+
+        // A hash of every resolved value (and its key), e.g., to tell whether two shots were
+        // processed with the same configuration.  Does not depend on the order of the file.
+        uint64_t ContentHash() const { return content_hash_; }
+
+    private:
+        static Value ParseValue(const std::string& text);
+        static void AddEntries(const boost::property_tree::ptree& node, const std::string& path, GsConfigSnapshot& snapshot);
+
+        const Entry* Find(const std::string& tag_name) const;
+
+        std::unordered_map<std::string, Entry> entries_;
+        MotionDetectValues motion_detect_values_;
+        uint64_t generation_ = 0;
+        uint64_t content_hash_ = 0;
+
+        static std::atomic<std::shared_ptr<const GsConfigSnapshot>> current_;
+        static std::atomic<uint64_t> last_generation_;
+    };
+
+}
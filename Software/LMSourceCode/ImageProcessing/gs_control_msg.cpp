@@ -9,6 +9,7 @@
 #include "logging_tools.h"
 
 #include "gs_control_msg.h"
+#include "gs_clubs.h"
 #include "cv_utils.h"
 
 namespace golf_sim {
@@ -35,6 +36,21 @@ namespace golf_sim {
         return result_table[t];
     }
 
+    bool GsIPCControlMsg::Apply(const GsIPCControlMsgType t) {
+
+        if (t == GsIPCControlMsgType::kClubChangeToPutter) {
+            GolfSimClubs::SetCurrentClubType(GolfSimClubs::GsClubType::kPutter);
+        }
+        else if (t == GsIPCControlMsgType::kClubChangeToDriver) {
+            GolfSimClubs::SetCurrentClubType(GolfSimClubs::GsClubType::kDriver);
+        }
+        else {
+            return false;
+        }
+
+        return true;
+    }
+
     std::string GsIPCControlMsg::Format() const {
 
         std::string control_type = FormatControlMessageType(control_type_);
@@ -48,6 +48,11 @@ namespace golf_sim {
 
         static std::string FormatControlMessageType(const GsIPCControlMsgType t);
 
+        // Changes the session settings for the message right away, from whatever thread
+        // received it.  Any shot that was already armed keeps the settings it was armed with.
+        // Returns false for an unknown message type.
+        static bool Apply(const GsIPCControlMsgType t);
+
     public:
         GsIPCControlMsgType control_type_ = GsIPCControlMsgType::kUnknown;
 
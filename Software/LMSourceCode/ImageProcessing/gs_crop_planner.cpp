@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <cmath>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+#include "libcamera_interface.h"
+
+#include "gs_crop_planner.h"
+
+namespace golf_sim {
+
+    bool GsCropPlanner::kUseCropPlanner = false;
+    // 1100 clocks at 74.25 MHz.  With the blanking below, this gives the ~536 FPS that the
+    // IMX296 manages at its smallest (88-line) crop, and ~60 FPS at the full 1088 lines.
+    double GsCropPlanner::kCropPlannerLineTimeUs = 14.81;
+    int GsCropPlanner::kCropPlannerBlankingLines = 38;
+    double GsCropPlanner::kCropPlannerShortfallFraction = 0.9;
+
+    GsCropPlan GsCropPlanner::last_plan_;
+
+
+    void GsCropPlanner::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kUseCropPlanner", kUseCropPlanner);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kCropPlannerLineTimeUs", kCropPlannerLineTimeUs);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kCropPlannerBlankingLines", kCropPlannerBlankingLines);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kCropPlannerShortfallFraction", kCropPlannerShortfallFraction);
+
+        kCropPlannerLineTimeUs = std::max(kCropPlannerLineTimeUs, 0.1);
+        kCropPlannerBlankingLines = std::max(kCropPlannerBlankingLines, 0);
+        kCropPlannerShortfallFraction = std::clamp(kCropPlannerShortfallFraction, 0.0, 1.0);
+    }
+
+    double GsCropPlanner::PredictFrameRate(int crop_height) {
+        return 1.0e6 / ((double)(std::max(crop_height, 1) + kCropPlannerBlankingLines) * kCropPlannerLineTimeUs);
+    }
+
+    GsCropPlan GsCropPlanner::PlanWatchingCrop(const cv::Vec2i& requested_size, float roi_side, bool gathering_club_data) {
+
+        GsCropPlan plan;
+        plan.size = requested_size;
+
+        if (kUseCropPlanner && !gathering_club_data) {
+            // The height only has to cover the motion ROI, and no more than was asked for.
+            // The sensor cannot crop below kMinWatchingCropHeight, and (from the Pi 5 on)
+            // the crop must be an even number of lines.
+            int planned_height = std::min((int)std::ceil(roi_side), requested_size[1]);
+            planned_height = std::max(planned_height, (int)LibCameraInterface::kMinWatchingCropHeight);
+
+            plan.size[1] = planned_height + (planned_height % 2);
+        }
+
+        plan.predicted_fps = PredictFrameRate(plan.size[1]);
+
+        if (plan.size != requested_size) {
+            GS_LOG_TRACE_MSG(trace, "GsCropPlanner - cut the watching crop from " + std::to_string(requested_size[0]) + "x" +
+                                    std::to_string(requested_size[1]) + " (" + std::to_string((int)PredictFrameRate(requested_size[1])) +
+                                    " FPS) to " + std::to_string(plan.size[0]) + "x" + std::to_string(plan.size[1]) + " (" +
+                                    std::to_string((int)plan.predicted_fps) + " FPS).");
+        }
+
+        last_plan_ = plan;
+        return plan;
+    }
+
+    void GsCropPlanner::CheckReportedFrameRate(const GsCropPlan& plan, double reported_fps) {
+
+        if (reported_fps < kCropPlannerShortfallFraction * plan.predicted_fps) {
+            GS_LOG_MSG(warning, "GsCropPlanner - libcamera allows only " + std::to_string((int)reported_fps) + " FPS for the " +
+                                std::to_string(plan.size[0]) + "x" + std::to_string(plan.size[1]) + " watching crop, but the sensor should manage " +
+                                std::to_string((int)plan.predicted_fps) + " FPS.  Check the sensor mode, or kCropPlannerLineTimeUs.");
+        }
+        else {
+            GS_LOG_TRACE_MSG(trace, "GsCropPlanner - libcamera allows " + std::to_string((int)reported_fps) + " FPS for the watching crop (predicted " +
+                                    std::to_string((int)plan.predicted_fps) + " FPS).");
+        }
+    }
+
+    void GsCropPlanner::CheckDeliveredFrameRate(unsigned int frames, double mean_interval_us, double worst_interval_us,
+                                                double requested_fps) {
+
+        if (frames == 0 || mean_interval_us <= 0.0) {
+            return;
+        }
+
+        const double delivered_fps = 1.0e6 / mean_interval_us;
+
+        GsMetrics::SetGauge(GsMetrics::Gauge::kWatcherDeliveredFps, delivered_fps);
+        GsMetrics::SetGauge(GsMetrics::Gauge::kWatcherWorstFrameIntervalSeconds, worst_interval_us / 1.0e6);
+
+        // The camera may have been asked for less than the sensor could do (e.g., with sensor frame skipping)
+        const double expected_fps = (requested_fps > 0.0) ? requested_fps : last_plan_.predicted_fps;
+
+        const std::string summary = std::to_string(frames) + " frames at " + std::to_string((int)std::round(delivered_fps)) +
+                                    " FPS (worst interval " + std::to_string((int)worst_interval_us) + " us), against " +
+                                    std::to_string((int)expected_fps) + " FPS requested and " +
+                                    std::to_string((int)last_plan_.predicted_fps) + " FPS predicted";
+
+        if (expected_fps > 0.0 && delivered_fps < kCropPlannerShortfallFraction * expected_fps) {
+            GS_LOG_MSG(warning, "GsCropPlanner - the ball watcher got only " + summary + ".");
+        }
+        else {
+            GS_LOG_TRACE_MSG(trace, "GsCropPlanner - the ball watcher got " + summary + ".");
+        }
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
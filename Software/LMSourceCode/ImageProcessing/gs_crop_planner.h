@@ -0,0 +1,66 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Plans the camera 1 watching crop from a model of the sensor's readout, and checks the
+// frame rate that the camera actually delivers against it.
+// The IMX296 reads the crop out a line at a time, so a frame takes about
+// (crop height + blanking lines) * line time, whatever the crop's width.  The width is left
+// as ConfigCameraForCropping sized it, but the height only has to cover the motion ROI
+// (the square inscribed in the ball), so the planner cuts the height down to that.
+// Whether or not the planner picks the crop, the predicted rate is logged next to the rate
+// that libcamera reports for the crop, and the ball watcher's frame intervals are checked
+// against both once each watch is over, so that a bay that is running well below what the
+// sensor could do shows up in the log.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    struct GsCropPlan {
+        cv::Vec2i size;
+        // What the sensor model says the crop can run at
+        double predicted_fps = 0;
+    };
+
+    class GsCropPlanner {
+
+    public:
+        // If false (the default), the crop is sized as before, and is only checked
+        static bool kUseCropPlanner;
+        // The sensor's time per line, and the lines of blanking between frames
+        static double kCropPlannerLineTimeUs;
+        static int kCropPlannerBlankingLines;
+        // The delivered (or reported) rate is logged as falling short if it is below this
+        // fraction of the expected rate
+        static double kCropPlannerShortfallFraction;
+
+        static void LoadConfigurationValues();
+
+        static double PredictFrameRate(int crop_height);
+
+        // requested_size is the crop that ConfigCameraForCropping would otherwise use, and
+        // roi_side is the side of the (square) motion ROI within the ball.  Club strike crops
+        // are not made smaller, as the club needs the room.
+        static GsCropPlan PlanWatchingCrop(const cv::Vec2i& requested_size, float roi_side, bool gathering_club_data);
+
+        // Logs the plan next to what libcamera reported for the crop
+        static void CheckReportedFrameRate(const GsCropPlan& plan, double reported_fps);
+
+        // Logs how many frames the ball watcher got and at what rate, against the rate that
+        // the camera was asked for and the last plan's prediction
+        static void CheckDeliveredFrameRate(unsigned int frames, double mean_interval_us, double worst_interval_us,
+                                            double requested_fps);
+
+    private:
+        static GsCropPlan last_plan_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <chrono>
+#include <string>
+
+#include "logging_tools.h"
+
+#include "gs_deferred_log.h"
+
+namespace golf_sim {
+
+    std::array<GsDeferredLog::Entry, GsDeferredLog::kRingSize> GsDeferredLog::ring_;
+    std::atomic<uint32_t> GsDeferredLog::head_{ 0 };
+    std::atomic<uint32_t> GsDeferredLog::tail_{ 0 };
+    std::atomic<uint32_t> GsDeferredLog::dropped_{ 0 };
+
+    void GsDeferredLog::Log(const char* message) noexcept {
+        Push(message, 0, false);
+    }
+
+    void GsDeferredLog::Log(const char* message, int64_t value) noexcept {
+        Push(message, value, true);
+    }
+
+    void GsDeferredLog::Push(const char* message, int64_t value, bool has_value) noexcept {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+
+        if (head - tail_.load(std::memory_order_acquire) >= kRingSize) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Entry& entry = ring_[head % kRingSize];
+        entry.message = message;
+        entry.value = value;
+        entry.has_value = has_value;
+        entry.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    void GsDeferredLog::Flush() {
+        const uint32_t head = head_.load(std::memory_order_acquire);
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (head == tail) {
+            return;
+        }
+
+        const int64_t first_ns = ring_[tail % kRingSize].time_ns;
+
+        for (; tail != head; tail++) {
+            const Entry& entry = ring_[tail % kRingSize];
+
+            GS_LOG_TRACE_MSG(trace, "[deferred +" + std::to_string((entry.time_ns - first_ns) / 1000) + " us] " +
+                                    std::string(entry.message) + (entry.has_value ? std::to_string(entry.value) : ""));
+        }
+
+        tail_.store(tail, std::memory_order_release);
+
+        const uint32_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            GS_LOG_MSG(warning, "GsDeferredLog - dropped " + std::to_string(dropped) + " messages.");
+        }
+    }
+
+}
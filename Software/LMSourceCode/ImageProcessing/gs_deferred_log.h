@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A lock-free, allocation-free log for the SCHED_FIFO trigger path.
+// Log() only copies a message pointer, one value and a timestamp into a fixed ring.
+// The messages are formatted and sent to the normal logger later, when Flush() is
+// called from outside the real-time path.
+// There may be one logging thread and one flushing thread at a time.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace golf_sim {
+
+    class GsDeferredLog {
+
+    public:
+        // message must be a string literal, or anything else that lives until the next Flush().
+        // If the ring is full, the entry is dropped and counted.
+        static void Log(const char* message) noexcept;
+        // The value is appended to the message when it is flushed
+        static void Log(const char* message, int64_t value) noexcept;
+
+        // Logs (at trace level) and removes everything logged so far
+        static void Flush();
+
+    private:
+        static constexpr uint32_t kRingSize = 256;
+
+        static void Push(const char* message, int64_t value, bool has_value) noexcept;
+
+        struct Entry {
+            const char* message;
+            int64_t value;
+            bool has_value;
+            int64_t time_ns;
+        };
+
+        static std::array<Entry, kRingSize> ring_;
+        static std::atomic<uint32_t> head_;
+        static std::atomic<uint32_t> tail_;
+        static std::atomic<uint32_t> dropped_;
+    };
+
+}
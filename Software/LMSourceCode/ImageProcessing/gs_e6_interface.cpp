@@ -135,6 +135,10 @@ namespace golf_sim {
 
         GS_LOG_TRACE_MSG(trace, "GsE6Interface::SendResults called.");
 
+        if (BackgroundReconnectInProgress()) {
+            return ReconnectInBackground(input_results);
+        }
+
         if (!initialized_) {
             GS_LOG_MSG(error, "GsE6Interface::SendResults called before the interface was intialized.");
             return false;
@@ -145,8 +149,12 @@ namespace golf_sim {
             return false;
         }
 
-        if (receive_thread_exited_) {
-            // If we ended the recieve thread, try re-initializing the connection
+        if (receiver_stopped_) {
+            if (ReconnectInBackground(input_results)) {
+                return true;
+            }
+
+            // If the receiver stopped, try re-initializing the connection
 
             GS_LOG_MSG(error, "GsGSProInterface::SendResults called before the interface was intialized.");
 
@@ -159,6 +167,8 @@ namespace golf_sim {
 
         GsE6Results results(input_results);
 
+        CacheShot(input_results);
+
         size_t write_length = -1;
 
         std::string results_msg = results.Format();
@@ -175,26 +185,10 @@ namespace golf_sim {
         // Give E6 a moment to proces the earlier message
         usleep(kE6InterMessageDelayMs * 1000);
 
-        boost::property_tree::ptree root;
-        root.put("Type", "SetClubData");
-
-        // Create the three required children objects and add to the JSON root
-        boost::property_tree::ptree club_data_child;
-
-        // Create a dummy club data - we really don't have this information
-        // Head speed is feet per second
-        club_data_child.put("ClubHeadSpeed", GsResults::FormatDoubleAsString(0.0)); // (results.speed_mph_ / 3600.) * 5280.));
-        club_data_child.put("ClubAngleFace", GsResults::FormatDoubleAsString(0.0));
-        club_data_child.put("ClubAnglePath", GsResults::FormatDoubleAsString(0.0));
-        club_data_child.put("ClubHeadSpeedMPH", GsResults::FormatDoubleAsString(0.0));  // results.speed_mph_));
-
-        root.add_child("ClubData", club_data_child);
-
-        std::string club_data_message = GsE6Results::GenerateStringFromJsonTree(root);
-
-        if (club_data_message == "") {
-            GS_LOG_MSG(warning, "GsE6Results::Format() returning empty string.");
-        }
+        // A dummy club data - we really don't have this information.
+        // Head speed is feet per second, e.g., (results.speed_mph_ / 3600.) * 5280.
+        const std::string club_data_message =
+            "{\"Type\":\"SetClubData\",\"ClubData\":{\"ClubHeadSpeed\":0.0,\"ClubAngleFace\":0.0,\"ClubAnglePath\":0.0,\"ClubHeadSpeedMPH\":0.0}}";
 
         write_length = SendSimMessage(club_data_message);
 
@@ -208,7 +202,8 @@ namespace golf_sim {
 
         results_msg = "{\"Type\":\"SendShot\"}";
 
-        write_length = SendSimMessage(results_msg);
+        // The shot only counts as delivered once E6 has been told to take it
+        write_length = SendSimMessage(results_msg, false, input_results.result_message_is_keepalive_ ? 0 : input_results.shot_number_);
 
         if (write_length <= 0) {
             GS_LOG_MSG(error, "GsE6Interface::SendResults was not able to send SendShot message.");
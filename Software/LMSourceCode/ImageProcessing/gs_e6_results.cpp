@@ -7,9 +7,8 @@
 // The PiTrac project is not endorsed, sponsored by or associated with TrueGolf products or services.
 
 
-#include <regex>
-#include <boost/program_options.hpp>
-#include <boost/property_tree/json_parser.hpp>
+#include <algorithm>
+#include "gs_format_lib.h"
 
 #include "logging_tools.h"
 
@@ -33,18 +32,12 @@ namespace golf_sim {
     }
 
 
-    std::string GsE6Results::Format() const {
-        // Create a JSON object based on https://e6golf.com/E6ConnectV1.html
-        // Create a property tree object
-        boost::property_tree::ptree root;
-
-        // Create the three required children objects and add to the JSON root
-        boost::property_tree::ptree ball_data_child;
-        boost::property_tree::ptree club_data_child;
-        boost::property_tree::ptree shot_data_options_child;
+    // Based on https://e6golf.com/E6ConnectV1.html.  Some of the ball values such as tilt
+    // are not required and we don't include them.
+    static constexpr const char kE6BallDataTemplate[] =
+        "{{\"Type\":\"SetBallData\",\"BallData\":{{\"BackSpin\":{},\"BallSpeed\":{},\"LaunchAngle\":{},\"LaunchDirection\":{},\"SideSpin\":{}}}}}";
 
-        // Root-level values
-        root.put("Type", "SetBallData");
+    std::string GsE6Results::Format() const {
 
         // E6 Enforces certain ranges.  Make sure we do, too
         int back_spin_rpm = std::min(back_spin_rpm_, 19999);
@@ -56,23 +49,12 @@ namespace golf_sim {
         int side_spin_rpm = std::min(side_spin_rpm_, 5999);
         side_spin_rpm = std::max(side_spin_rpm_, -5999);
 
-
-        // Ball data - some of the values such as tilt are not required and we don't include them
-        ball_data_child.put("BackSpin", FormatDoubleAsString(back_spin_rpm_));
-        ball_data_child.put("BallSpeed", FormatDoubleAsString(speed_mph_));
-        ball_data_child.put("LaunchAngle", FormatDoubleAsString(vla_deg_));
-        ball_data_child.put("LaunchDirection", FormatDoubleAsString(hla_deg_));
-        ball_data_child.put("SideSpin", FormatDoubleAsString(side_spin_rpm_));
-
-        root.add_child("BallData", ball_data_child);
-
-        std::string result = GenerateStringFromJsonTree(root);
-
-        if (result == "") {
-            GS_LOG_MSG(warning, "GsE6Results::Format() returning empty string.");
-        }
-
-        return result;
+        return GS_FORMATLIB_FORMAT(kE6BallDataTemplate,
+            FormatDoubleAsString(back_spin_rpm_),
+            FormatDoubleAsString(speed_mph_),
+            FormatDoubleAsString(vla_deg_),
+            FormatDoubleAsString(hla_deg_),
+            FormatDoubleAsString(side_spin_rpm_));
     }
 
 }
@@ -0,0 +1,644 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "gs_format_lib.h"
+#include "logging_tools.h"
+#include "gs_config.h"
+
+#include "gs_event_journal.h"
+
+namespace golf_sim {
+
+    std::string GsEventJournal::kEventJournalFile;
+    std::string GsEventJournal::kEventJournalFrameArchive;
+    std::string GsEventJournal::kEventJournalReplayFile;
+    double GsEventJournal::kEventJournalReplaySpeed = 0.0;
+
+    // Past this many frames waiting to be written, the frames are dropped (but not their lines)
+    static const int kMaxQueuedFrames = 16;
+
+    static const char kJournalHeader[] = "PiTrac event journal";
+    static const int kJournalVersion = 1;
+
+    // By ObservationKind
+    static const char* kObservationNames[] = {
+        "CheckForBall",
+        "WatchForBallPlacementChange",
+        "CheckForBallStableIncremental",
+        "WatchForHit",
+        "AllSystemsArmed"
+    };
+
+    std::deque<GsEventJournal::PendingRecord> GsEventJournal::queue_;
+    std::mutex GsEventJournal::mutex_;
+    GsBackgroundJob GsEventJournal::writer_job_(&GsEventJournal::Process);
+    bool GsEventJournal::recording_ = false;
+    int GsEventJournal::queued_frames_ = 0;
+    int GsEventJournal::next_frame_number_ = 1;
+
+    std::vector<GsEventJournal::ReplayRecord> GsEventJournal::replay_records_;
+    size_t GsEventJournal::replay_position_ = 0;
+    std::atomic<bool> GsEventJournal::replaying_{ false };
+    int64_t GsEventJournal::simulated_ns_ = 0;
+    GsShotArchiveReader GsEventJournal::replay_frames_;
+    std::chrono::steady_clock::time_point GsEventJournal::replay_started_;
+    int64_t GsEventJournal::replay_first_event_ns_ = 0;
+    int GsEventJournal::replayed_events_ = 0;
+    int GsEventJournal::state_mismatches_ = 0;
+    int GsEventJournal::divergences_ = 0;
+
+    // Only used by the writer thread once it has started
+    static std::ofstream journal_file;
+    static GsShotArchiveWriter journal_frames;
+    static bool journal_frames_open = false;
+
+    // Frame names from an earlier run that appended to the same archive are not re-used
+    static std::string frame_name_prefix;
+
+    static int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static std::vector<std::string> SplitFields(const std::string& text, char separator) {
+        std::vector<std::string> fields;
+        std::stringstream stream(text);
+        std::string field;
+
+        while (std::getline(stream, field, separator)) {
+            fields.push_back(field);
+        }
+
+        return fields;
+    }
+
+    static std::string FormatBall(const GolfBall& ball) {
+        return GS_FORMATLIB_FORMAT("{:.2f},{:.2f},{:.2f},{},{},{}",
+                                   ball.ball_circle_[0], ball.ball_circle_[1], ball.ball_circle_[2],
+                                   ball.search_area_center_[0], ball.search_area_center_[1], ball.search_area_radius_);
+    }
+
+    // ControlMessage's Format() has the message type in it, which goes in <arg> instead
+    static std::string EventName(GolfSimEventBase* event) {
+        if (dynamic_cast<GolfSimEvent::ControlMessage*>(event) != nullptr) {
+            return "ControlMessage";
+        }
+
+        return event->Format();
+    }
+
+
+    bool GsEventJournal::StartRecording() {
+
+        GolfSimConfiguration::SetConstant("gs_config.logging.kEventJournalFile", kEventJournalFile);
+        GolfSimConfiguration::SetConstant("gs_config.logging.kEventJournalFrameArchive", kEventJournalFrameArchive);
+
+        // A replay is not journaled again
+        if (kEventJournalFile.empty() || replaying_ || recording_) {
+            return true;
+        }
+
+        journal_file.open(kEventJournalFile, std::ios::out | std::ios::app);
+        if (!journal_file) {
+            GS_LOG_MSG(error, "GsEventJournal - could not open " + kEventJournalFile + ".");
+            return false;
+        }
+
+        journal_frames_open = !kEventJournalFrameArchive.empty() && journal_frames.Open(kEventJournalFrameArchive);
+        if (!kEventJournalFrameArchive.empty() && !journal_frames_open) {
+            GS_LOG_MSG(warning, "GsEventJournal - could not open " + kEventJournalFrameArchive + ".  Only the frames' sizes will be journaled.");
+        }
+
+        const int64_t wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        frame_name_prefix = "journal_" + std::to_string(wall_ms) + "_";
+        next_frame_number_ = 1;
+
+        // A journal that is appended to gets a header for each run
+        journal_file << kJournalHeader << '\t' << kJournalVersion << '\t' << wall_ms << '\t'
+                     << (journal_frames_open ? kEventJournalFrameArchive : "") << '\n';
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queued_frames_ = 0;
+        }
+
+        recording_ = true;
+
+        GS_LOG_MSG(info, "GsEventJournal - journaling the FSM's events to " + kEventJournalFile + ".");
+        return true;
+    }
+
+    void GsEventJournal::StopRecording() {
+
+        if (!recording_) {
+            return;
+        }
+
+        recording_ = false;
+
+        // Anything still queued is written first
+        writer_job_.WaitUntilIdle();
+
+        journal_file.close();
+        if (journal_frames_open) {
+            journal_frames.Close();
+            journal_frames_open = false;
+        }
+    }
+
+    bool GsEventJournal::IsRecording() {
+        return recording_;
+    }
+
+    void GsEventJournal::Queue(PendingRecord&& record) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!record.frame.empty()) {
+                queued_frames_++;
+            }
+
+            queue_.push_back(std::move(record));
+        }
+
+        writer_job_.Schedule();
+    }
+
+    bool GsEventJournal::Process() {
+        std::deque<PendingRecord> batch;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (queue_.empty()) {
+                return false;
+            }
+
+            batch.swap(queue_);
+        }
+
+        int frames_written = 0;
+
+        for (const PendingRecord& record : batch) {
+            if (!record.frame.empty()) {
+                if (!journal_frames.AddFrame(record.frame_name, record.frame)) {
+                    GS_LOG_MSG(warning, "GsEventJournal - could not archive frame " + record.frame_name + ".");
+                }
+                frames_written++;
+            }
+
+            journal_file << record.line << '\n';
+        }
+
+        journal_file.flush();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_frames_ -= frames_written;
+
+        // Whatever was queued in the meantime is written by the next turn
+        return !queue_.empty();
+    }
+
+    std::string GsEventJournal::ReferenceImage(const cv::Mat& image, bool keep_frame, PendingRecord& record) {
+
+        if (image.empty()) {
+            return "-,0,0,0";
+        }
+
+        std::string frame_name = "-";
+
+        if (keep_frame && journal_frames_open) {
+            bool writer_behind;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                writer_behind = queued_frames_ >= kMaxQueuedFrames;
+            }
+
+            if (writer_behind) {
+                GS_LOG_TRACE_MSG(trace, "GsEventJournal - the frame writer is not keeping up.  Only journaling the frame's size.");
+            }
+            else {
+                // The camera buffers behind the image will be re-used
+                frame_name = frame_name_prefix + std::to_string(next_frame_number_++);
+                record.frame_name = frame_name;
+                record.frame = image.clone();
+            }
+        }
+
+        return frame_name + "," + std::to_string(image.cols) + "," + std::to_string(image.rows) + "," + std::to_string(image.type());
+    }
+
+    void GsEventJournal::RecordEvent(const GolfSimEventElement& event) {
+
+        if (!recording_ || event.e_ == nullptr) {
+            return;
+        }
+
+        GolfBall ball;
+        cv::Mat image;
+        bool keep_frame = false;
+        int arg = 0;
+
+        if (auto control_message = dynamic_cast<GolfSimEvent::ControlMessage*>(event.e_)) {
+            arg = (int)control_message->message_type_;
+        }
+        else if (auto found_multiple_balls = dynamic_cast<GolfSimEvent::FoundMultipleBalls*>(event.e_)) {
+            arg = (int)found_multiple_balls->numberBallsFound;
+        }
+        else if (auto ball_stabilized = dynamic_cast<GolfSimEvent::BallStabilized*>(event.e_)) {
+            ball = ball_stabilized->ball_;
+        }
+        else if (auto ball_hit = dynamic_cast<GolfSimEvent::BallHit*>(event.e_)) {
+            ball = ball_hit->ball_;
+            image = ball_hit->ball_hit_image_;
+            keep_frame = true;
+        }
+        else if (auto camera2_image_received = dynamic_cast<GolfSimEvent::Camera2ImageReceived*>(event.e_)) {
+            image = camera2_image_received->GetBallFlightImage();
+            keep_frame = true;
+        }
+
+        const int64_t now_ns = NowNs();
+        const int64_t queue_wait_ns = (event.queued_ns_ != 0) ? now_ns - event.queued_ns_ : 0;
+
+        PendingRecord record;
+        record.line = "E\t" + std::to_string(now_ns) + "\t" + EventName(event.e_) + "\t" + std::to_string(event.priority_) + "\t" +
+                      std::to_string(queue_wait_ns) + "\t" + std::to_string(arg) + "\t" + FormatBall(ball) + "\t" +
+                      ReferenceImage(image, keep_frame, record);
+
+        Queue(std::move(record));
+    }
+
+    void GsEventJournal::RecordObservation(ObservationKind kind, const Observation& observation, bool keep_frame) {
+
+        if (!recording_) {
+            return;
+        }
+
+        PendingRecord record;
+        record.line = "O\t" + std::to_string(NowNs()) + "\t" + kObservationNames[(int)kind] + "\t" +
+                      (observation.ok ? "1" : "0") + "\t" + (observation.flag ? "1" : "0") + "\t" +
+                      FormatBall(observation.ball) + "\t" + ReferenceImage(observation.image, keep_frame, record);
+
+        Queue(std::move(record));
+    }
+
+    void GsEventJournal::RecordState(const std::string& state) {
+
+        if (replaying_) {
+            const bool have_state = replay_position_ < replay_records_.size() && replay_records_[replay_position_].kind == 'S';
+
+            if (have_state) {
+                const ReplayRecord& record = replay_records_[replay_position_++];
+                Consume(record);
+
+                if (record.name == state) {
+                    return;
+                }
+            }
+
+            state_mismatches_++;
+            GS_LOG_MSG(warning, "GsEventJournal - after replayed event " + std::to_string(replayed_events_) + ", the FSM went to " + state +
+                       ", but the journal has " + (have_state ? replay_records_[replay_position_ - 1].name : std::string("no state")) + ".");
+            return;
+        }
+
+        if (!recording_) {
+            return;
+        }
+
+        PendingRecord record;
+        record.line = "S\t" + std::to_string(NowNs()) + "\t" + state;
+
+        Queue(std::move(record));
+    }
+
+
+    bool GsEventJournal::StartReplay() {
+
+        GolfSimConfiguration::SetConstant("gs_config.testing.kEventJournalReplayFile", kEventJournalReplayFile);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kEventJournalReplaySpeed", kEventJournalReplaySpeed);
+
+        kEventJournalReplaySpeed = std::max(kEventJournalReplaySpeed, 0.0);
+
+        std::ifstream file(kEventJournalReplayFile);
+        if (!file) {
+            GS_LOG_MSG(error, "GsEventJournal - could not open kEventJournalReplayFile " + kEventJournalReplayFile + ".");
+            return false;
+        }
+
+        replay_records_.clear();
+        std::string frame_archive;
+        bool have_header = false;
+        int bad_lines = 0;
+
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.rfind(kJournalHeader, 0) == 0) {
+                // A journal that was appended to has one header for each run.  All the
+                // runs' frames went to the same archive.
+                const std::vector<std::string> fields = SplitFields(line, '\t');
+
+                if (fields.size() < 2 || fields[1] != std::to_string(kJournalVersion)) {
+                    GS_LOG_MSG(error, "GsEventJournal - " + kEventJournalReplayFile + " is not a version " + std::to_string(kJournalVersion) + " journal.");
+                    return false;
+                }
+
+                if (fields.size() >= 4 && !fields[3].empty()) {
+                    frame_archive = fields[3];
+                }
+
+                have_header = true;
+                continue;
+            }
+
+            ReplayRecord record;
+            if (ParseRecord(line, record)) {
+                replay_records_.push_back(std::move(record));
+            }
+            else if (!line.empty()) {
+                bad_lines++;
+            }
+        }
+
+        if (!have_header) {
+            GS_LOG_MSG(error, "GsEventJournal - " + kEventJournalReplayFile + " is not an event journal.");
+            return false;
+        }
+
+        if (bad_lines > 0) {
+            GS_LOG_MSG(warning, "GsEventJournal - skipped " + std::to_string(bad_lines) + " unreadable lines of " + kEventJournalReplayFile + ".");
+        }
+
+        if (!frame_archive.empty()) {
+            // E.g., the journal and its frames were copied off the Pi together
+            if (!std::filesystem::exists(frame_archive)) {
+                frame_archive = (std::filesystem::path(kEventJournalReplayFile).parent_path() /
+                                 std::filesystem::path(frame_archive).filename()).string();
+            }
+
+            if (!replay_frames_.Open(frame_archive)) {
+                GS_LOG_MSG(warning, "GsEventJournal - could not open the journal's frame archive " + frame_archive + ".  Blank frames will be replayed.");
+            }
+        }
+
+        replay_position_ = 0;
+        simulated_ns_ = replay_records_.empty() ? NowNs() : replay_records_.front().t_ns;
+        replayed_events_ = 0;
+        state_mismatches_ = 0;
+        divergences_ = 0;
+        replaying_ = true;
+
+        GS_LOG_MSG(info, "GsEventJournal - replaying " + std::to_string(replay_records_.size()) + " records from " + kEventJournalReplayFile + ".");
+        return true;
+    }
+
+    void GsEventJournal::StopReplay() {
+
+        if (!replaying_) {
+            return;
+        }
+
+        // Anything the replay never got to counts as a divergence
+        divergences_ += (int)(replay_records_.size() - replay_position_);
+
+        GS_LOG_MSG(info, "GsEventJournal - replayed " + std::to_string(replayed_events_) + " events, with " +
+                   std::to_string(state_mismatches_) + " state mismatches and " + std::to_string(divergences_) + " divergences.");
+
+        replaying_ = false;
+        replay_records_.clear();
+        replay_frames_.Close();
+    }
+
+    bool GsEventJournal::IsReplaying() {
+        return replaying_;
+    }
+
+    std::chrono::steady_clock::time_point GsEventJournal::Now() {
+        if (replaying_) {
+            return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(simulated_ns_));
+        }
+
+        return std::chrono::steady_clock::now();
+    }
+
+    void GsEventJournal::Consume(const ReplayRecord& record) {
+        simulated_ns_ = record.t_ns;
+    }
+
+    bool GsEventJournal::NextReplayEvent(GolfSimEventElement& event) {
+
+        while (replay_position_ < replay_records_.size()) {
+            const ReplayRecord& record = replay_records_[replay_position_++];
+
+            // E.g., an observation of a call that the replay did not make
+            if (record.kind != 'E') {
+                divergences_++;
+                continue;
+            }
+
+            GolfSimEventBase* replayed_event = MakeEvent(record);
+            if (replayed_event == nullptr) {
+                GS_LOG_MSG(warning, "GsEventJournal - skipping unknown event " + record.name + ".");
+                divergences_++;
+                continue;
+            }
+
+            if (kEventJournalReplaySpeed > 0.0) {
+                if (replayed_events_ == 0) {
+                    replay_started_ = std::chrono::steady_clock::now();
+                    replay_first_event_ns_ = record.t_ns;
+                }
+                else {
+                    const auto journal_elapsed_ns = (int64_t)((record.t_ns - replay_first_event_ns_) / kEventJournalReplaySpeed);
+                    std::this_thread::sleep_until(replay_started_ + std::chrono::nanoseconds(journal_elapsed_ns));
+                }
+            }
+
+            Consume(record);
+
+            event.e_ = replayed_event;
+            event.priority_ = record.priority;
+            event.queued_ns_ = record.t_ns - record.queue_wait_ns;
+            event.polling_event_index_ = -1;
+
+            replayed_events_++;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool GsEventJournal::ReplayObservation(ObservationKind kind, Observation& observation) {
+
+        if (!replaying_) {
+            return false;
+        }
+
+        observation = Observation{};
+
+        if (replay_position_ < replay_records_.size() && replay_records_[replay_position_].kind == 'O' &&
+            replay_records_[replay_position_].name == kObservationNames[(int)kind]) {
+
+            const ReplayRecord& record = replay_records_[replay_position_++];
+            Consume(record);
+
+            observation.ok = record.ok;
+            observation.flag = record.flag;
+            GetBall(record, observation.ball);
+            observation.image = GetImage(record.image);
+            return true;
+        }
+
+        divergences_++;
+        GS_LOG_MSG(warning, "GsEventJournal - after replayed event " + std::to_string(replayed_events_) + ", the FSM called " +
+                   kObservationNames[(int)kind] + ", which the journal does not have.  Replaying it as failed.");
+        return true;
+    }
+
+    GolfSimEventBase* GsEventJournal::MakeEvent(const ReplayRecord& record) {
+
+        const std::string& name = record.name;
+
+        if (name == "EventLoopTick") {
+            return new GolfSimEvent::EventLoopTick{ };
+        }
+        else if (name == "BeginWatchingForBallHit") {
+            return new GolfSimEvent::BeginWatchingForBallHit{ };
+        }
+        else if (name == "BeginWaitingForBallPlaced") {
+            return new GolfSimEvent::BeginWaitingForBallPlaced{ };
+        }
+        else if (name == "CheckForBallStable") {
+            return new GolfSimEvent::CheckForBallStable{ };
+        }
+        else if (name == "BallStabilized") {
+            GolfBall ball;
+            GetBall(record, ball);
+            return new GolfSimEvent::BallStabilized{ ball };
+        }
+        else if (name == "BallHit") {
+            GolfBall ball;
+            GetBall(record, ball);
+            cv::Mat image = GetImage(record.image);
+            return new GolfSimEvent::BallHit{ ball, image };
+        }
+        else if (name == "ControlMessage") {
+            return new GolfSimEvent::ControlMessage{ (GsIPCControlMsgType)record.arg };
+        }
+        else if (name == "BeginWaitingForSimulatorArmed") {
+            return new GolfSimEvent::BeginWaitingForSimulatorArmed{ };
+        }
+        else if (name == "SimulatorIsArmed") {
+            return new GolfSimEvent::SimulatorIsArmed{ };
+        }
+        else if (name == "CheckForCam2ImageReceived") {
+            return new GolfSimEvent::CheckForCam2ImageReceived{ };
+        }
+        else if (name == "FoundMultipleBalls") {
+            GolfSimEvent::FoundMultipleBalls* found_multiple_balls = new GolfSimEvent::FoundMultipleBalls{ };
+            found_multiple_balls->numberBallsFound = (unsigned int)record.arg;
+            return found_multiple_balls;
+        }
+        else if (name == "Camera2ImageReceived") {
+            return new GolfSimEvent::Camera2ImageReceived{ GetImage(record.image) };
+        }
+        else if (name == "Restart") {
+            return new GolfSimEvent::Restart{ };
+        }
+        else if (name == "Exit") {
+            return new GolfSimEvent::Exit{ };
+        }
+
+        return nullptr;
+    }
+
+    void GsEventJournal::GetBall(const ReplayRecord& record, GolfBall& ball) {
+        ball.set_circle(record.ball_circle);
+        ball.search_area_center_ = cv::Vec2i(record.search_area[0], record.search_area[1]);
+        ball.search_area_radius_ = record.search_area[2];
+    }
+
+    cv::Mat GsEventJournal::GetImage(const ImageReference& image) {
+
+        if (image.cols <= 0 || image.rows <= 0) {
+            return cv::Mat();
+        }
+
+        cv::Mat frame;
+        if (image.frame_name != "-" && replay_frames_.IsOpen() && replay_frames_.GetFrame(image.frame_name, frame)) {
+            // The FSM may draw on (or keep) the frame past the replay's reader
+            return frame.clone();
+        }
+
+        return cv::Mat::zeros(image.rows, image.cols, image.type);
+    }
+
+    bool GsEventJournal::ParseRecord(const std::string& line, ReplayRecord& record) {
+
+        const std::vector<std::string> fields = SplitFields(line, '\t');
+
+        if (fields.size() < 3 || fields[0].size() != 1) {
+            return false;
+        }
+
+        try {
+            record.kind = fields[0][0];
+            record.t_ns = std::stoll(fields[1]);
+            record.name = fields[2];
+
+            size_t ball_field = 0;
+
+            if (record.kind == 'E' && fields.size() == 8) {
+                record.priority = std::stoi(fields[3]);
+                record.queue_wait_ns = std::stoll(fields[4]);
+                record.arg = std::stoi(fields[5]);
+                ball_field = 6;
+            }
+            else if (record.kind == 'O' && fields.size() == 7) {
+                record.ok = (fields[3] == "1");
+                record.flag = (fields[4] == "1");
+                ball_field = 5;
+            }
+            else if (record.kind == 'S' && fields.size() == 3) {
+                return true;
+            }
+            else {
+                return false;
+            }
+
+            const std::vector<std::string> ball = SplitFields(fields[ball_field], ',');
+            const std::vector<std::string> image = SplitFields(fields[ball_field + 1], ',');
+
+            if (ball.size() != 6 || image.size() != 4) {
+                return false;
+            }
+
+            record.ball_circle = GsCircle(std::stof(ball[0]), std::stof(ball[1]), std::stof(ball[2]));
+            record.search_area = cv::Vec3i(std::stoi(ball[3]), std::stoi(ball[4]), std::stoi(ball[5]));
+
+            record.image.frame_name = image[0];
+            record.image.cols = std::stoi(image[1]);
+            record.image.rows = std::stoi(image[2]);
+            record.image.type = std::stoi(image[3]);
+        }
+        catch (std::exception&) {
+            return false;
+        }
+
+        return true;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
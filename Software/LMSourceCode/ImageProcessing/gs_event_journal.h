@@ -0,0 +1,192 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A journal of everything the FSM was given, so that a session (e.g., one in which a shot
+// took too long) can be run through the FSM again, as often as need be, without the
+// hardware.  If kEventJournalFile is set, RunGolfSimFsm writes down each event as it takes
+// it off the queue, what each of the hardware-facing calls the FSM made (e.g., CheckForBall
+// or the ball watcher) returned, and the state the FSM went to.  The images that the rest of
+// the shot is worked out from (e.g., the teed ball and the strobed camera 2 frame) are kept
+// in the kEventJournalFrameArchive GsShotArchive, and the journal refers to them by name.
+// The FSM thread only formats a line (and clones the frame) and queues it.  The shared,
+// low-priority GsBackgroundWorker does the writing.  If the writer falls behind, frames are dropped
+// before lines are.
+//
+// The journal is tab-separated text, one record per line, after a header line:
+//
+//     E  <t_ns>  <event>  <priority>  <queue_wait_ns>  <arg>  <ball>  <image>
+//     O  <t_ns>  <observation>  <ok>  <flag>  <ball>  <image>
+//     S  <t_ns>  <state>
+//
+// where t_ns is the steady clock, <ball> is "x,y,r,search_x,search_y,search_radius" and
+// <image> is "frame_name,cols,rows,type" (the name is "-" if the frame was not kept).
+//
+// In the event_journal_replay mode, kEventJournalReplayFile is fed back into RunGolfSimFsm.
+// The journal is then the only source of events (anything queued by the timers, the cameras
+// or the FSM itself is dropped, as the journal already has it), the recorded observations
+// stand in for the hardware, and Now() is the time of the record being replayed, so the FSM
+// takes the same path through the same states at the same (simulated) times.  A frame that
+// was not kept is replayed as a blank image of the same size.  At kEventJournalReplaySpeed
+// 1.0 the events are replayed at the pace they were recorded, and at 0 (the default) as fast
+// as the FSM can take them.  Each state is checked against the recorded one, and any
+// differences are reported when the journal runs out.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "golf_ball.h"
+#include "gs_events.h"
+#include "gs_shot_archive.h"
+#include "worker_thread.h"
+
+namespace golf_sim {
+
+    class GsEventJournal {
+
+    public:
+        // Empty (the default) means no journal
+        static std::string kEventJournalFile;
+        // Empty (the default) means the journal only has the frames' sizes
+        static std::string kEventJournalFrameArchive;
+        static std::string kEventJournalReplayFile;
+        // 1.0 is the recorded pace.  0 means as fast as possible.
+        static double kEventJournalReplaySpeed;
+
+        // The hardware-facing calls of the FSM whose results are journaled
+        enum class ObservationKind {
+            kCheckForBall = 0,
+            kWatchForBallPlacementChange = 1,
+            kCheckForBallStableIncremental = 2,
+            kWatchForHit = 3,
+            kAllSystemsArmed = 4
+        };
+
+        struct Observation {
+            bool ok = false;
+            // E.g., whether the placement changed or the ball was hit
+            bool flag = false;
+            GolfBall ball;
+            cv::Mat image;
+        };
+
+        // Starts the writer if kEventJournalFile is set
+        static bool StartRecording();
+
+        // Writes what is still queued and closes the journal
+        static void StopRecording();
+
+        static bool IsRecording();
+
+        // Reads all of kEventJournalReplayFile.  Until StopReplay, IsReplaying() is true.
+        static bool StartReplay();
+
+        // Logs how closely the replay followed the journal
+        static void StopReplay();
+
+        static bool IsReplaying();
+
+        // The steady clock, or while replaying, the time of the record being replayed
+        static std::chrono::steady_clock::time_point Now();
+
+        // Called by RunGolfSimFsm for each event it takes off the queue
+        static void RecordEvent(const GolfSimEventElement& event);
+
+        // If keep_frame is set, the observation's image is kept in the frame archive
+        static void RecordObservation(ObservationKind kind, const Observation& observation, bool keep_frame);
+
+        static void RecordState(const std::string& state);
+
+        // The next recorded event, or false once the journal has run out.  The caller owns the event.
+        static bool NextReplayEvent(GolfSimEventElement& event);
+
+        // False if not replaying.  Otherwise, fills in what was recorded for the call (or, if the
+        // replay has gone a different way, a failed observation).
+        static bool ReplayObservation(ObservationKind kind, Observation& observation);
+
+    private:
+        struct PendingRecord {
+            std::string line;
+            std::string frame_name;
+            cv::Mat frame;
+        };
+
+        struct ImageReference {
+            std::string frame_name;
+            int cols = 0;
+            int rows = 0;
+            int type = 0;
+        };
+
+        struct ReplayRecord {
+            char kind = ' ';
+            int64_t t_ns = 0;
+            // The event, observation or state
+            std::string name;
+            int priority = 0;
+            int64_t queue_wait_ns = 0;
+            int arg = 0;
+            bool ok = false;
+            bool flag = false;
+            GsCircle ball_circle{ 0, 0, 0 };
+            cv::Vec3i search_area{ 0, 0, 0 };
+            ImageReference image;
+        };
+
+        // Writes out what has been queued.  Run by writer_job_.
+        static bool Process();
+
+        static void Queue(PendingRecord&& record);
+
+        // Returns the <image> field, and if keep_frame is set (and the writer is keeping up),
+        // queues a copy of the image for the frame archive
+        static std::string ReferenceImage(const cv::Mat& image, bool keep_frame, PendingRecord& record);
+
+        static bool ParseRecord(const std::string& line, ReplayRecord& record);
+
+        static void GetBall(const ReplayRecord& record, GolfBall& ball);
+        static cv::Mat GetImage(const ImageReference& image);
+
+        // nullptr if the event is not one the FSM knows
+        static GolfSimEventBase* MakeEvent(const ReplayRecord& record);
+
+        // Sets the simulated time to the record's
+        static void Consume(const ReplayRecord& record);
+
+        static std::deque<PendingRecord> queue_;
+        static std::mutex mutex_;
+        static GsBackgroundJob writer_job_;
+        // Only changed by the FSM thread
+        static bool recording_;
+        static int queued_frames_;
+        static int next_frame_number_;
+
+        static std::vector<ReplayRecord> replay_records_;
+        static size_t replay_position_;
+        static std::atomic<bool> replaying_;
+        static int64_t simulated_ns_;
+        static GsShotArchiveReader replay_frames_;
+        static std::chrono::steady_clock::time_point replay_started_;
+        static int64_t replay_first_event_ns_;
+        static int replayed_events_;
+        static int state_mismatches_;
+        // Records the replay did not take the same way, e.g., an observation it did not ask for
+        static int divergences_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -8,32 +8,173 @@
 
 #include "gs_events.h"
 #include "logging_tools.h" 
+#include "gs_shot_trace.h"
+#include "gs_event_journal.h"
 
 #ifdef __unix__  // Ignore in Windows environment
 
+#include <chrono>
+
 
 namespace golf_sim {
 
-	// boost::lockfree::queue<GolfSimEventElement, boost::lockfree::capacity<GolfSimEventQueue::kMaxQueueSize>> GolfSimEventQueue::queue_;
-    queue<GolfSimEventElement> GolfSimEventQueue::queue_(GolfSimEventQueue::kMaxQueueSize);
-    int GolfSimEventQueue::queue_size_ = 0;
+    static_assert((int)GolfSimEventQueue::Priority::kNumPriorities == GsShotTrace::kNumEventPriorities,
+                  "The shot trace keeps queue wait times for each event priority");
+
+    futex_doorbell GolfSimEventQueue::doorbell_;
+
+    std::array<std::unique_ptr<mpsc_queue<GolfSimEventElement>>, (int)GolfSimEventQueue::Priority::kNumPriorities> GolfSimEventQueue::queues_ = {
+        std::make_unique<mpsc_queue<GolfSimEventElement>>(GolfSimEventQueue::kMaxQueueSize, &GolfSimEventQueue::doorbell_),
+        std::make_unique<mpsc_queue<GolfSimEventElement>>(GolfSimEventQueue::kMaxQueueSize, &GolfSimEventQueue::doorbell_),
+        std::make_unique<mpsc_queue<GolfSimEventElement>>(GolfSimEventQueue::kMaxQueueSize, &GolfSimEventQueue::doorbell_)
+    };
+
+    // The FSM re-queues these for itself while it polls, so more than one waiting
+    // at a time would only make it do the same check again.
+    static const int kNumPollingEvents = 5;
+
+    // True while an event of that type is waiting in the queue
+    static std::array<std::atomic<bool>, kNumPollingEvents> polling_event_queued{};
+
+    static int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Returns -1 if the event is not a polling event
+    static int GetPollingEventIndex(GolfSimEventBase* event) {
+        if (dynamic_cast<GolfSimEvent::EventLoopTick*>(event) != nullptr) {
+            return 0;
+        }
+        else if (dynamic_cast<GolfSimEvent::BeginWaitingForBallPlaced*>(event) != nullptr) {
+            return 1;
+        }
+        else if (dynamic_cast<GolfSimEvent::CheckForBallStable*>(event) != nullptr) {
+            return 2;
+        }
+        else if (dynamic_cast<GolfSimEvent::BeginWaitingForSimulatorArmed*>(event) != nullptr) {
+            return 3;
+        }
+        else if (dynamic_cast<GolfSimEvent::CheckForCam2ImageReceived*>(event) != nullptr) {
+            return 4;
+        }
+
+        return -1;
+    }
+
+    GolfSimEventQueue::Priority GolfSimEventQueue::GetEventPriority(GolfSimEventBase* event) {
+        if (dynamic_cast<GolfSimEvent::BallHit*>(event) != nullptr ||
+            dynamic_cast<GolfSimEvent::BeginWatchingForBallHit*>(event) != nullptr ||
+            dynamic_cast<GolfSimEvent::Camera2ImageReceived*>(event) != nullptr ||
+            dynamic_cast<GolfSimEvent::CheckForCam2ImageReceived*>(event) != nullptr) {
+            return Priority::kHigh;
+        }
+
+        if (dynamic_cast<GolfSimEvent::EventLoopTick*>(event) != nullptr ||
+            dynamic_cast<GolfSimEvent::BeginWaitingForBallPlaced*>(event) != nullptr ||
+            dynamic_cast<GolfSimEvent::CheckForBallStable*>(event) != nullptr ||
+            dynamic_cast<GolfSimEvent::BeginWaitingForSimulatorArmed*>(event) != nullptr ||
+            dynamic_cast<GolfSimEvent::ControlMessage*>(event) != nullptr) {
+            return Priority::kLow;
+        }
+
+        // E.g., BallStabilized, Restart and Exit
+        return Priority::kNormal;
+    }
 
 	bool GolfSimEventQueue::QueueEvent(GolfSimEventElement& event) {
-		queue_.push(std::move(event));
-        queue_size_++;
+
+        // While a journal is replayed, it already has everything that would be queued here
+        if (GsEventJournal::IsReplaying()) {
+            delete event.e_;
+            event.e_ = nullptr;
+            return true;
+        }
+
+        const int polling_event_index = GetPollingEventIndex(event.e_);
+
+        if (polling_event_index >= 0 && polling_event_queued[polling_event_index].exchange(true)) {
+            GS_LOG_TRACE_MSG(trace, "Dropping duplicate " + event.e_->Format() + " event.");
+            delete event.e_;
+            event.e_ = nullptr;
+            return true;
+        }
+
+        event.queued_ns_ = NowNs();
+        event.priority_ = (int)GetEventPriority(event.e_);
+        event.polling_event_index_ = polling_event_index;
+
+		queues_[event.priority_]->push(std::move(event));
         return true;
 	}
 
     int GolfSimEventQueue::GetQueueLength() {
-        return queue_size_;
+        size_t length = 0;
+        for (const auto& queue : queues_) {
+            length += queue->size();
+        }
+        return (int)length;
+    }
+
+    // Checks each queue, highest priority first
+    static bool TryDeQueueEvent(GolfSimEventElement& event) {
+        for (auto& queue : GolfSimEventQueue::queues_) {
+            if (queue->try_pop(event)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool WaitForEvent(GolfSimEventElement& event, unsigned int time_out_ms) {
+        if (TryDeQueueEvent(event)) {
+            return true;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_out_ms);
+
+        // The same wait as mpsc_queue::pop, but on the doorbell that all the queues share
+        while (true) {
+            unsigned int remaining_ms = 0;
+
+            if (time_out_ms != 0) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+                if (remaining <= 0) {
+                    return TryDeQueueEvent(event);
+                }
+                remaining_ms = (unsigned int)remaining;
+            }
+
+            uint32_t seen_push_count = GolfSimEventQueue::doorbell_.count();
+            GolfSimEventQueue::doorbell_.begin_wait();
+
+            if (TryDeQueueEvent(event)) {
+                GolfSimEventQueue::doorbell_.end_wait();
+                return true;
+            }
+
+            GolfSimEventQueue::doorbell_.wait(seen_push_count, remaining_ms);
+            GolfSimEventQueue::doorbell_.end_wait();
+
+            if (TryDeQueueEvent(event)) {
+                return true;
+            }
+        }
     }
 
 	bool GolfSimEventQueue::DeQueueEvent(GolfSimEventElement& event, unsigned int time_out_ms) {
-        bool status = queue_.pop(event, time_out_ms);
-        if (status) {
-            queue_size_--;
+        if (!WaitForEvent(event, time_out_ms)) {
+            return false;
+        }
+
+        // Clear this before the event is processed, so that the FSM can re-queue it
+        if (event.polling_event_index_ >= 0) {
+            polling_event_queued[event.polling_event_index_].store(false);
         }
-        return status;
+
+        GsShotTrace::RecordEventQueueWait(event.priority_, NowNs() - event.queued_ns_);
+
+        return true;
     }
 
     bool GolfSimEventQueue::EventIsShutdownEvent(GolfSimEventBase* event) {
@@ -14,10 +14,13 @@
 #ifdef __unix__  // Ignore in Windows environment
 
 
+#include <array>
+#include <memory>
+
 #include <boost/thread/thread.hpp>
 #include <boost/lockfree/queue.hpp>
 
-#include "blocking_queue.h"
+#include "mpsc_queue.h"
 
 #include <opencv2/core.hpp>
 
@@ -213,17 +216,37 @@ namespace golf_sim {
 
         GolfSimEventBase* e_;
 
-        // TBD - Might add, for example, queue time
+        // Set by QueueEvent
+        int64_t queued_ns_ = 0;
+        int priority_ = 0;
+        int polling_event_index_ = -1;
     };
 
     class GolfSimEventQueue {
 
     public:
-        static const int kMaxQueueSize = 20;
+        // The queue ring is a power of two in size
+        static constexpr int kMaxQueueSize = 32;
+
+        // Events are de-queued highest priority first, and in order within a priority.
+        // High is the hit / trigger / camera 2 path, so that shot data is never stuck
+        // behind polling events and control messages, which are low.
+        enum class Priority {
+            kHigh = 0,
+            kNormal = 1,
+            kLow = 2,
+            kNumPriorities = 3
+        };
 
+        static Priority GetEventPriority(GolfSimEventBase* event);
+
+        // A polling event that the FSM re-queues for itself (e.g., BeginWaitingForBallPlaced)
+        // is dropped (and deleted) if one of the same type is already waiting in the queue.
+        // Returns true in that case, too.
         static bool QueueEvent(GolfSimEventElement& event);
 
-        // Caller is responsible for deleting the event element's event pointer
+        // Caller is responsible for deleting the event element's event pointer.
+        // Each event's time in the queue is recorded in the shot trace by priority.
         static bool DeQueueEvent(GolfSimEventElement& event, unsigned int time_out_ms = 0);
 
         // Cast a specific derived event type into the PossibleEvent variant type
@@ -234,13 +257,15 @@ namespace golf_sim {
 
         static bool EventIsControlEvent(GolfSimEventBase* event);
 
-        // Not thread safe
+        // Approximate if events are being queued or de-queued at the same time
         static int GetQueueLength();
 
-        // static boost::lockfree::queue<GolfSimEventElement, boost::lockfree::capacity<kMaxQueueSize>> queue_;
-        static queue<GolfSimEventElement> queue_;
-
-        static int queue_size_;
+        // Producers (e.g., the camera2 thread, timers and control messages) never take a
+        // lock to queue an event, so they don't contend with the FSM loop during a hit.
+        // Only the FSM thread may de-queue.  There is one queue per priority, all sharing
+        // one doorbell so that the FSM can wait on every queue at once.
+        static futex_doorbell doorbell_;
+        static std::array<std::unique_ptr<mpsc_queue<GolfSimEventElement>>, (int)Priority::kNumPriorities> queues_;
     };
 }
 
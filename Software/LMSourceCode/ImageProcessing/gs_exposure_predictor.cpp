@@ -0,0 +1,258 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <utility>
+
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_camera.h"
+#include "gs_camera_intrinsics.h"
+#include "pulse_strobe.h"
+
+#include "gs_exposure_predictor.h"
+
+namespace golf_sim {
+
+    bool GsExposurePredictor::kUseExposurePrediction = false;
+    int GsExposurePredictor::kExposurePredictionDifferenceThreshold = 40;
+    double GsExposurePredictor::kExposurePredictionWindowRadii = 2.5;
+    double GsExposurePredictor::kExposurePredictionSpeedUncertainty = 0.25;
+
+    // The strobes of a shot go out well within this of its hit
+    static const int64_t kMaxHitToStrobeNs = 1000000000;
+
+    std::mutex GsExposurePredictor::mutex_;
+    GsExposurePredictor::Cam1Motion GsExposurePredictor::last_motion_;
+
+
+    void GsExposurePredictor::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kUseExposurePrediction", kUseExposurePrediction);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kExposurePredictionDifferenceThreshold", kExposurePredictionDifferenceThreshold);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kExposurePredictionWindowRadii", kExposurePredictionWindowRadii);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kExposurePredictionSpeedUncertainty", kExposurePredictionSpeedUncertainty);
+
+        kExposurePredictionDifferenceThreshold = std::clamp(kExposurePredictionDifferenceThreshold, 1, 254);
+        kExposurePredictionWindowRadii = std::max(kExposurePredictionWindowRadii, 1.0);
+        kExposurePredictionSpeedUncertainty = std::max(kExposurePredictionSpeedUncertainty, 0.0);
+    }
+
+    bool GsExposurePredictor::MeasureDisplacement(const cv::Mat& before_hit, const cv::Mat& after_hit, double ball_radius_px,
+                                                  cv::Vec2d& displacement_px) {
+
+        if (before_hit.empty() || before_hit.size() != after_hit.size() || before_hit.type() != after_hit.type()) {
+            return false;
+        }
+
+        // The ball is lit, so it is brighter than what is behind it.  The subtractions saturate at 0.
+        cv::Mat arrived, left;
+        cv::subtract(after_hit, before_hit, arrived);
+        cv::subtract(before_hit, after_hit, left);
+        cv::threshold(arrived, arrived, kExposurePredictionDifferenceThreshold, 255, cv::THRESH_BINARY);
+        cv::threshold(left, left, kExposurePredictionDifferenceThreshold, 255, cv::THRESH_BINARY);
+
+        // The frame labels and the motion ROI outline that the ball watcher may have drawn on the
+        // frames are only a couple of pixels wide
+        const cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
+        cv::morphologyEx(arrived, arrived, cv::MORPH_OPEN, kernel);
+        cv::morphologyEx(left, left, cv::MORPH_OPEN, kernel);
+
+        const cv::Moments new_position = cv::moments(arrived, true);
+        const cv::Moments teed_position = cv::moments(left, true);
+
+        // Each should be about a ball's worth of pixels.  Much more is likely the club.
+        const double ball_area = CV_PI * ball_radius_px * ball_radius_px;
+        auto is_ball_sized = [ball_area](double area) { return area > 0.3 * ball_area && area < 3.0 * ball_area; };
+
+        if (!is_ball_sized(new_position.m00) || !is_ball_sized(teed_position.m00)) {
+            return false;
+        }
+
+        displacement_px = cv::Vec2d(new_position.m10 / new_position.m00 - teed_position.m10 / teed_position.m00,
+                                    new_position.m01 / new_position.m00 - teed_position.m01 / teed_position.m00);
+
+        // Until the ball is clear of the tee, the two regions are crescents whose centroids are
+        // further apart than the ball has moved
+        return cv::norm(displacement_px) >= 2.0 * ball_radius_px;
+    }
+
+    void GsExposurePredictor::RecordCam1Motion(const std::vector<RecentFrameInfo>& frames, const GolfBall& ball) {
+
+        Cam1Motion motion;
+
+        const GsTriggerTiming trigger_timing = GolfSimCamera::GetLastTriggerTiming();
+        auto hit_frame = std::find_if(frames.begin(), frames.end(), [](const RecentFrameInfo& frame) { return frame.isballHitFrame; });
+        const double ball_radius_px = (ball.measured_radius_pixels_ > 0.0) ? ball.measured_radius_pixels_ : ball.ball_circle_[2];
+
+        if (kUseExposurePrediction && trigger_timing.valid && ball_radius_px > 0.0 &&
+            hit_frame != frames.end() && hit_frame != frames.begin()) {
+
+            const double frame_duration_ns = (trigger_timing.frame_duration_us > 0) ? trigger_timing.frame_duration_us * 1000.0 :
+                                             (hit_frame->frameRate > 0.0f) ? 1.0e9 / hit_frame->frameRate : 0.0;
+            const cv::Mat& before_hit = std::prev(hit_frame)->mat;
+
+            // The time and displacement of each frame in which the ball was clear of the tee.  The
+            // sequence numbers allow for any frames that the watcher dropped.
+            std::vector<std::pair<int64_t, cv::Vec2d>> sightings;
+
+            for (auto frame = hit_frame; frame != frames.end() && frame_duration_ns > 0.0; ++frame) {
+                cv::Vec2d displacement_px;
+
+                if (MeasureDisplacement(before_hit, frame->mat, ball_radius_px, displacement_px)) {
+                    const double frames_after_hit = (double)frame->requestSequence - (double)hit_frame->requestSequence;
+                    sightings.emplace_back(trigger_timing.sensor_timestamp_ns + (int64_t)(frames_after_hit * frame_duration_ns), displacement_px);
+                }
+            }
+
+            if (!sightings.empty()) {
+                const auto& first = sightings.front();
+                const auto& last = sightings.back();
+
+                motion.hit_sensor_timestamp_ns = trigger_timing.sensor_timestamp_ns;
+                motion.reference_time_ns = last.first;
+                motion.reference_displacement_px = last.second;
+
+                if (sightings.size() >= 2 && last.first > first.first) {
+                    motion.velocity_px_per_s = (last.second - first.second) * (1.0e9 / (double)(last.first - first.first));
+                }
+                else {
+                    // The ball was still on the tee in the frame before the hit frame, so it left
+                    // (on average) half a frame before the hit frame started
+                    const double moving_ns = (double)(last.first - trigger_timing.sensor_timestamp_ns) + frame_duration_ns / 2.0;
+                    motion.velocity_px_per_s = last.second * (1.0e9 / moving_ns);
+                }
+
+                motion.valid = true;
+
+                GS_LOG_TRACE_MSG(trace, "GsExposurePredictor - from " + std::to_string(sightings.size()) + " camera 1 frames, the ball moved (" +
+                                        std::to_string(motion.velocity_px_per_s[0]) + ", " + std::to_string(motion.velocity_px_per_s[1]) + ") pixels/s.");
+            }
+            else {
+                GS_LOG_TRACE_MSG(trace, "GsExposurePredictor - the ball was not clear of the tee in any of the camera 1 frames.");
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_motion_ = motion;
+    }
+
+    bool GsExposurePredictor::PredictExposureWindows(const CameraHardware& camera1, const CameraHardware& camera2,
+                                                     const GolfBall& calibrated_ball, const std::vector<float>& pulse_intervals_ms,
+                                                     std::vector<cv::Rect>& windows) {
+        windows.clear();
+
+        if (!kUseExposurePrediction) {
+            return false;
+        }
+
+        Cam1Motion motion;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            motion = last_motion_;
+        }
+
+        const GsTriggerTiming trigger_timing = GolfSimCamera::GetLastTriggerTiming();
+
+        if (!motion.valid || !trigger_timing.valid || motion.hit_sensor_timestamp_ns != trigger_timing.sensor_timestamp_ns) {
+            return false;
+        }
+
+        int64_t strobe_start_ns = 0;
+        int64_t strobe_end_ns = 0;
+        PulseStrobe::GetLastStrobeWriteTimes(strobe_start_ns, strobe_end_ns);
+
+        if (strobe_start_ns <= 0 || std::abs(strobe_start_ns - motion.hit_sensor_timestamp_ns) > kMaxHitToStrobeNs) {
+            GS_LOG_TRACE_MSG(trace, "GsExposurePredictor - the last strobes were not for this shot.");
+            return false;
+        }
+
+        const double distance = calibrated_ball.distance_to_z_plane_from_lens_;
+        if (distance <= 0.0) {
+            return false;
+        }
+
+        const GsCameraIntrinsics& camera1_intrinsics = GsCameraIntrinsics::ForCamera(camera1);
+        const GsCameraIntrinsics& camera2_intrinsics = GsCameraIntrinsics::ForCamera(camera2);
+
+        // From a displacement of the teed ball in camera 1's image to camera 2's image
+        auto project = [&](const cv::Vec2d& displacement_px, cv::Vec2d& camera2_px, double& radius_px) {
+            cv::Vec3d position;
+            camera1_intrinsics.ComputeBallPosition(calibrated_ball.x() + displacement_px[0], calibrated_ball.y() + displacement_px[1],
+                                                   distance, position);
+
+            // Camera 2's axes are camera 1's, moved by the offset (see ComputeBallDeltas)
+            return camera2_intrinsics.ProjectBallPosition(position - GolfSimCamera::kCamera2OffsetFromCamera1OriginMeters,
+                                                          camera2_px[0], camera2_px[1], radius_px);
+        };
+
+        cv::Vec2d last_seen_px;
+        double last_seen_radius_px = 0.0;
+        if (!project(motion.reference_displacement_px, last_seen_px, last_seen_radius_px)) {
+            return false;
+        }
+
+        const cv::Rect image_area(0, 0, camera2.resolution_x_, camera2.resolution_y_);
+        int64_t pulse_time_ns = strobe_start_ns;
+
+        for (size_t i = 0; i <= pulse_intervals_ms.size(); i++) {
+            const double seconds_since_seen = (double)(pulse_time_ns - motion.reference_time_ns) / 1.0e9;
+            const cv::Vec2d displacement_px = motion.reference_displacement_px + motion.velocity_px_per_s * seconds_since_seen;
+
+            cv::Vec2d center_px;
+            double radius_px = 0.0;
+
+            if (project(displacement_px, center_px, radius_px)) {
+                const double half_size = kExposurePredictionWindowRadii * radius_px +
+                                         kExposurePredictionSpeedUncertainty * cv::norm(center_px - last_seen_px);
+                const cv::Rect window = cv::Rect(cv::Point((int)(center_px[0] - half_size), (int)(center_px[1] - half_size)),
+                                                 cv::Point((int)std::ceil(center_px[0] + half_size), (int)std::ceil(center_px[1] + half_size))) & image_area;
+
+                if (window.area() > 0) {
+                    windows.push_back(window);
+                }
+            }
+
+            if (i < pulse_intervals_ms.size()) {
+                pulse_time_ns += (int64_t)(pulse_intervals_ms[i] * 1.0e6);
+            }
+        }
+
+        if (windows.size() < 2) {
+            GS_LOG_TRACE_MSG(trace, "GsExposurePredictor - only " + std::to_string(windows.size()) + " of the predicted exposures are in camera 2's image.");
+            windows.clear();
+            return false;
+        }
+
+        const cv::Rect search_area = SearchArea(windows);
+        GS_LOG_TRACE_MSG(trace, "GsExposurePredictor - predicted " + std::to_string(windows.size()) + " exposures within (" +
+                                std::to_string(search_area.x) + ", " + std::to_string(search_area.y) + ") " +
+                                std::to_string(search_area.width) + "x" + std::to_string(search_area.height) + ".");
+        return true;
+    }
+
+    cv::Rect GsExposurePredictor::SearchArea(const std::vector<cv::Rect>& windows) {
+        cv::Rect area;
+
+        for (const cv::Rect& window : windows) {
+            area = (area.area() > 0) ? (area | window) : window;
+        }
+
+        return area;
+    }
+
+    void GsExposurePredictor::KeepBallsInWindows(const std::vector<cv::Rect>& windows, std::vector<GolfBall>& balls) {
+        balls.erase(std::remove_if(balls.begin(), balls.end(), [&windows](const GolfBall& ball) {
+                        const cv::Point center((int)ball.x(), (int)ball.y());
+                        return std::none_of(windows.begin(), windows.end(), [&center](const cv::Rect& window) { return window.contains(center); });
+                    }),
+                    balls.end());
+    }
+
+}
@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Predicts where each strobed exposure of a full swing should be in camera 2's frame, from the
+// ball's first movement in camera 1, so that AnalyzeStrobedBalls only has to search those parts
+// of the frame.
+// When the club strike frames are kept (see GolfSimClubData::kGatherClubData), the ball watcher
+// hands them to RecordCam1Motion.  In each frame from the hit on, the pixels that got brighter
+// than in the frame before the hit are the ball's new position, and the ones that got darker are
+// where it was teed.  Once the two no longer overlap, their centroids give the ball's movement
+// across camera 1's image, and two such frames (or one and the hit) give its speed.
+// PredictExposureWindows then moves the teed ball along at that speed to the time of each strobe
+// pulse, at the teed ball's distance from camera 1 (i.e., the ball is assumed to move across
+// camera 1's view, not toward or away from it), moves that position into camera 2's axes with
+// kCamera2OffsetFromCamera1OriginMeters, and projects it into camera 2's image.  Each window is
+// kExposurePredictionWindowRadii ball radii around the predicted exposure, plus
+// kExposurePredictionSpeedUncertainty of the distance from where the ball was last seen.
+// A prediction is only used for the shot whose hit it was made from.  Otherwise (e.g., for
+// a re-analyzed shot, or without the club strike frames), the whole frame is searched, as before.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "ball_watcher_image_buffer.h"
+#include "camera_hardware.h"
+#include "golf_ball.h"
+
+namespace golf_sim {
+
+    class GsExposurePredictor {
+
+    public:
+        static bool kUseExposurePrediction;
+        // The change in a camera 1 pixel's value that counts as the ball arriving or leaving
+        static int kExposurePredictionDifferenceThreshold;
+        static double kExposurePredictionWindowRadii;
+        static double kExposurePredictionSpeedUncertainty;
+
+        static void LoadConfigurationValues();
+
+        // frames are the club strike frames, oldest first, and ball is the teed ball in camera 1's
+        // image.  Replaces any earlier shot's prediction.
+        static void RecordCam1Motion(const std::vector<RecentFrameInfo>& frames, const GolfBall& ball);
+
+        // Returns false (and no windows) if there is no prediction for the current shot, or fewer
+        // than two of the exposures would be in camera 2's image
+        static bool PredictExposureWindows(const CameraHardware& camera1, const CameraHardware& camera2,
+                                           const GolfBall& calibrated_ball, const std::vector<float>& pulse_intervals_ms,
+                                           std::vector<cv::Rect>& windows);
+
+        // The smallest rectangle that covers all of the windows
+        static cv::Rect SearchArea(const std::vector<cv::Rect>& windows);
+
+        // Drops the balls whose centers are not in any of the windows
+        static void KeepBallsInWindows(const std::vector<cv::Rect>& windows, std::vector<GolfBall>& balls);
+
+    private:
+        struct Cam1Motion {
+            bool valid = false;
+            // Of the motion-detection frame, which identifies the shot
+            int64_t hit_sensor_timestamp_ns = 0;
+            // When the ball was last seen, and how far (in camera 1 pixels) it had moved from the tee by then
+            int64_t reference_time_ns = 0;
+            cv::Vec2d reference_displacement_px;
+            cv::Vec2d velocity_px_per_s;
+        };
+
+        // False unless the ball in after_hit is clear of where it was in before_hit
+        static bool MeasureDisplacement(const cv::Mat& before_hit, const cv::Mat& after_hit, double ball_radius_px,
+                                        cv::Vec2d& displacement_px);
+
+        static std::mutex mutex_;
+        static Cam1Motion last_motion_;
+    };
+
+}
@@ -8,7 +8,9 @@
 #ifdef __unix__  // Ignore in Windows environment
 #include <fmt/core.h>
 #define GS_FORMATLIB_FORMAT fmt::format
+#define GS_FORMATLIB_FORMAT_TO fmt::format_to
 #else
 #include <format>
 #define GS_FORMATLIB_FORMAT std::format
+#define GS_FORMATLIB_FORMAT_TO std::format_to
 #endif // __unix__
@@ -10,6 +10,7 @@
 
 #include <variant>
 #include <thread>
+#include <atomic>
 #include "gs_format_lib.h"
 #include <iostream>
 #include <signal.h>
@@ -27,15 +28,32 @@
 #include "gs_http_client.h"
 #include "gs_ui_system.h"
 #include "gs_sim_interface.h"
+#include "gs_shot_record.h"
 #include "pulse_strobe.h"
 #include "libcamera_interface.h"
 
 #include "gs_fsm.h"
+#include "cam1_watcher.h"
 #include "cam2_thread.h"
+#include "gs_shot_trace.h"
+#include "gs_remote_analysis.h"
+#include "gs_parallel_startup.h"
+#include "gs_config_reload.h"
+#include "gs_performance_state.h"
+#include "gs_preview_stream.h"
+#include "gs_shot_pipeline.h"
+#include "gs_session_settings.h"
+#include "gs_camera2_background.h"
+#include "gs_camera2_exposure.h"
+#include "gs_shot_history.h"
+#include "gs_club_strike_analysis.h"
+#include "gs_event_journal.h"
+#include "gs_trace_zones.h"
 
 
 namespace golf_sim {
 
+    static Camera1Watcher g_cam1_watcher;
     static Camera2Thread g_cam2_thread;
 
     static int signal_received;
@@ -53,6 +71,14 @@ namespace golf_sim {
     const int kEventLoopPauseMs = 5000;
     const int kBallStabilizationTime = 1; // seconds
 
+    // In the incremental mode, the stabilization check only compares the patch around the
+    // teed ball to the image from when the ball was first found, and only does a full ball
+    // search if that patch changed.  That check is cheap enough to do sooner.
+    static bool kUseIncrementalBallStabilization = false;
+    static int kIncrementalStabilizationCheckIntervalMs = 300;
+    static double kIncrementalStabilizationMinCorrelation = 0.95;
+    static double kIncrementalStabilizationRoiRadiusRatio = 1.5;
+
     // This is where the strobed-ball image will be put so that the web interface can display it
     std::string kWebServerCamera2Image;
     std::string kWebServerLastTeedBallImage;
@@ -61,14 +87,120 @@ namespace golf_sim {
         template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
     }
 
-    TimedCallbackThread* BallStabilizationCheckTimerThread = nullptr;
-    TimedCallbackThread* ReceivedCam2ImageCheckTimerThread = nullptr;
+    // Both timers run on the shared GsTimerScheduler thread.  kNoTimer means not pending.
+    std::atomic<GsTimerScheduler::TimerId> BallStabilizationCheckTimer{ GsTimerScheduler::kNoTimer };
+    std::atomic<GsTimerScheduler::TimerId> ReceivedCam2ImageCheckTimer{ GsTimerScheduler::kNoTimer };
+
+    void cancelTimer(std::atomic<GsTimerScheduler::TimerId>& timer) {
+        const GsTimerScheduler::TimerId timer_id = timer.exchange(GsTimerScheduler::kNoTimer);
+        if (timer_id != GsTimerScheduler::kNoTimer) {
+            GsTimerScheduler::GetInstance().Cancel(timer_id);
+        }
+    }
+
+
+    // The hardware-facing calls of the FSM go through these, so that GsEventJournal can write
+    // down what each returned, and so that a replay of the journal gets the same answers back.
+
+    static bool JournaledCheckForBall(GolfBall& ball, cv::Mat& img, bool full_resolution = false) {
+        GsEventJournal::Observation observation;
+
+        if (GsEventJournal::ReplayObservation(GsEventJournal::ObservationKind::kCheckForBall, observation)) {
+            ball = observation.ball;
+            img = observation.image;
+            return observation.ok;
+        }
+
+        observation.ok = CheckForBall(ball, img, full_resolution);
+
+        if (GsEventJournal::IsRecording()) {
+            observation.ball = ball;
+            observation.image = img;
+            // Only the image the ball was found in is needed for the rest of the shot
+            GsEventJournal::RecordObservation(GsEventJournal::ObservationKind::kCheckForBall, observation, observation.ok);
+        }
+
+        return observation.ok;
+    }
+
+    static bool JournaledWatchForBallPlacementChange(bool& change_detected) {
+        GsEventJournal::Observation observation;
+
+        if (GsEventJournal::ReplayObservation(GsEventJournal::ObservationKind::kWatchForBallPlacementChange, observation)) {
+            change_detected = observation.flag;
+            return observation.ok;
+        }
+
+        observation.ok = WatchForBallPlacementChange(change_detected);
+        observation.flag = change_detected;
+        GsEventJournal::RecordObservation(GsEventJournal::ObservationKind::kWatchForBallPlacementChange, observation, false);
+
+        return observation.ok;
+    }
+
+    static bool JournaledCheckForBallStableIncremental(const GsShotBallContext& ball_context,
+                                                       cv::Mat& img, bool& patch_unchanged) {
+        GsEventJournal::Observation observation;
+
+        if (GsEventJournal::ReplayObservation(GsEventJournal::ObservationKind::kCheckForBallStableIncremental, observation)) {
+            img = observation.image;
+            patch_unchanged = observation.flag;
+            return observation.ok;
+        }
+
+        observation.ok = CheckForBallStableIncremental(ball_context,
+                                                       kIncrementalStabilizationMinCorrelation,
+                                                       img, patch_unchanged);
+
+        if (GsEventJournal::IsRecording()) {
+            observation.flag = patch_unchanged;
+            observation.image = img;
+            GsEventJournal::RecordObservation(GsEventJournal::ObservationKind::kCheckForBallStableIncremental, observation, false);
+        }
+
+        return observation.ok;
+    }
+
+    static bool JournaledWatchForHit(const GolfBall& ball, cv::Mat& image, bool& ball_hit) {
+        GsEventJournal::Observation observation;
+
+        if (GsEventJournal::ReplayObservation(GsEventJournal::ObservationKind::kWatchForHit, observation)) {
+            image = observation.image;
+            ball_hit = observation.flag;
+            return observation.ok;
+        }
+
+        observation.ok = g_cam1_watcher.watch(ball, image, ball_hit);
+
+        if (GsEventJournal::IsRecording()) {
+            observation.flag = ball_hit;
+            observation.image = image;
+            GsEventJournal::RecordObservation(GsEventJournal::ObservationKind::kWatchForHit, observation, false);
+        }
+
+        return observation.ok;
+    }
+
+    static bool JournaledGetAllSystemsArmed() {
+        GsEventJournal::Observation observation;
+
+        if (GsEventJournal::ReplayObservation(GsEventJournal::ObservationKind::kAllSystemsArmed, observation)) {
+            return observation.ok;
+        }
+
+        observation.ok = GsSimInterface::GetAllSystemsArmed();
+        GsEventJournal::RecordObservation(GsEventJournal::ObservationKind::kAllSystemsArmed, observation, false);
+
+        return observation.ok;
+    }
 
 
     void queueBallStabilizationCheck() {
 
         GS_LOG_TRACE_MSG(trace, "Queueing CheckForBallStableEvent.");
 
+        BallStabilizationCheckTimer = GsTimerScheduler::kNoTimer;
+
         if (GolfSimGlobals::golf_sim_running_) {
             GolfSimEventElement CheckForBallStableEvent{ new GolfSimEvent::CheckForBallStable{ } };
             GolfSimEventQueue::QueueEvent(CheckForBallStableEvent);
@@ -85,9 +217,9 @@ namespace golf_sim {
         GS_LOG_TRACE_MSG(trace, "setupBallStabilizationCheckTimer.");
         // queueBallStabilizationCheck();
 
-        if (BallStabilizationCheckTimerThread == nullptr) {
-            BallStabilizationCheckTimerThread = new TimedCallbackThread("BallStabilizationCheckTimerThread", kBallStabilizationTime * 1000, queueBallStabilizationCheck);
-            BallStabilizationCheckTimerThread->CreateThread();
+        if (BallStabilizationCheckTimer == GsTimerScheduler::kNoTimer) {
+            long stabilization_time_ms = kUseIncrementalBallStabilization ? kIncrementalStabilizationCheckIntervalMs : kBallStabilizationTime * 1000;
+            BallStabilizationCheckTimer = GsTimerScheduler::GetInstance().Schedule(stabilization_time_ms, queueBallStabilizationCheck);
         }
     }
 
@@ -96,6 +228,8 @@ namespace golf_sim {
 
         GS_LOG_TRACE_MSG(trace, "Queueing CheckForCam2ImageReceived.");
 
+        ReceivedCam2ImageCheckTimer = GsTimerScheduler::kNoTimer;
+
         if (GolfSimGlobals::golf_sim_running_) {
             GolfSimEventElement checkForCam2ImageReceivedEvent{ new GolfSimEvent::CheckForCam2ImageReceived{ } };
             GolfSimEventQueue::QueueEvent(checkForCam2ImageReceivedEvent);
@@ -111,10 +245,32 @@ namespace golf_sim {
 
         GS_LOG_TRACE_MSG(trace, "setupCam2ImageReceivedCheckTimer - Setting call back for " + std::to_string(kMaxCam2ImageReceivedTimeMs) + " milliseconds.");
 
-        if (ReceivedCam2ImageCheckTimerThread == nullptr) {
-            ReceivedCam2ImageCheckTimerThread = new TimedCallbackThread("setupCam2ImageReceivedCheckTimerThread", kMaxCam2ImageReceivedTimeMs * 1000, queueCam2ImageReceivedCheck);
-            ReceivedCam2ImageCheckTimerThread->CreateThread();
-        }
+        // Never leave a timer from an earlier shot pending
+        cancelTimer(ReceivedCam2ImageCheckTimer);
+        ReceivedCam2ImageCheckTimer = GsTimerScheduler::GetInstance().Schedule(kMaxCam2ImageReceivedTimeMs, queueCam2ImageReceivedCheck);
+    }
+
+    // A restart only drops what belongs to the shot (or placement) in progress.  The cameras and
+    // their pipelines, the models, the sim connections, the configuration and the image pools are
+    // all kept, so getting back to waiting for a ball takes milliseconds rather than seconds.
+    void resetPerShotState() {
+        // Otherwise, e.g., a stale CheckForCam2ImageReceived could arrive in the middle of the next shot
+        cancelTimer(BallStabilizationCheckTimer);
+        cancelTimer(ReceivedCam2ImageCheckTimer);
+
+        // The ball has most likely been moved or hit
+        ResetPlacedBallTrack();
+    }
+
+    GolfSimState warmRestart(const std::string& reason) {
+        GS_LOG_MSG(warning, "Restarting GolfSim FSM (warm) - " + reason);
+
+        resetPerShotState();
+
+        GolfSimEventElement restartEvent{ new GolfSimEvent::Restart{ } };
+        GolfSimEventQueue::QueueEvent(restartEvent);
+
+        return state::InitializingCamera1System{};
     }
 
 
@@ -129,20 +285,41 @@ namespace golf_sim {
         GsUISystem::SendIPCStatusMessage(GsIPCResultType::kInitializing);
 
         // If we're already armed, just start waiting for a ball to appear.
-        if (GsSimInterface::GetAllSystemsArmed()) {
+        if (JournaledGetAllSystemsArmed()) {
             GolfSimEventElement beginWaitingForBallPlacedEvent{ new GolfSimEvent::BeginWaitingForBallPlaced{ } };
             GolfSimEventQueue::QueueEvent(beginWaitingForBallPlacedEvent);
 
-            return state::WaitingForBall{ std::chrono::steady_clock::now(), false /* have not sent the waiting-for-ball IPC message yet */ };
+            return state::WaitingForBall{ GsEventJournal::Now(), false /* have not sent the waiting-for-ball IPC message yet */ };
         }
 
         GolfSimEventElement beginWaitingForSimulatorArmedEvent{ new GolfSimEvent::BeginWaitingForSimulatorArmed{ } };
         GolfSimEventQueue::QueueEvent(beginWaitingForSimulatorArmedEvent);
 
-        return state::WaitingForSimulatorArmed{ std::chrono::steady_clock::now() };
+        return state::WaitingForSimulatorArmed{ GsEventJournal::Now() };
 
     }
 
+    // Events from before the restart (e.g., a late timer or camera 2 image) that arrive before
+    // the Restart event itself is processed are just dropped.
+    GolfSimState onEvent(const state::InitializingCamera1System& initializing,
+        const auto& staleEvent) {
+        GS_LOG_TRACE_MSG(trace, "GolfSim state transition: Initializing - Ignoring an event from before the restart.");
+
+        return initializing;
+    }
+
+    GolfSimState onEvent(const state::InitializingCamera1System& initializing,
+        const GolfSimEvent::EventLoopTick& eventLoopTick) {
+        return initializing;
+    }
+
+    // A Restart in any other state goes straight back to initializing
+    GolfSimState onEvent(const auto& state, const GolfSimEvent::Restart& restart) {
+        GS_LOG_MSG(debug, "GolfSim state transition: Received Restart - Next state Initializing.");
+
+        return warmRestart("Restart event received.");
+    }
+
 
     /************ WaitingForBall ***********/
 
@@ -156,13 +333,21 @@ namespace golf_sim {
         // So just ignore.
         // TBD - a little sloppy - why not just get rid of the late-breaking event?
 
-        return state::WaitingForBall{ std::chrono::steady_clock::now(), false /* have not sent the waiting-for-ball IPC message yet */ };
+        return state::WaitingForBall{ GsEventJournal::Now(), false /* have not sent the waiting-for-ball IPC message yet */ };
     }
 
     GolfSimState onEvent(const state::WaitingForBall& waitingForBallState,
         const GolfSimEvent::BeginWaitingForBallPlaced& beginWaitingForBallPlacedEvent) {
         GS_LOG_MSG(trace, "State: WaitingForBall - Received BeginWaitingForBallPlacedEvent - Now waiting for ball to show up.");
 
+        // Unless the last shot is still being analyzed in the background, no shot is in
+        // progress here, so this is a safe time to pick up any live tuning changes and to
+        // let the SoC cool down until a ball is teed up.  Otherwise, a later re-poll will.
+        if (!GsShotPipeline::IsBusy()) {
+            GsConfigReload::ApplyPendingChanges();
+            GsPerformanceState::SetMode(GsPerformanceState::Mode::kIdle);
+        }
+
         // Let the monitor interface know what's happening
         // TBD - see if we need to move this back to the initializating state
         if (!waitingForBallState.already_sent_waiting_ipc_message) {
@@ -174,11 +359,38 @@ namespace golf_sim {
         // That way, we can process other, asynchronous, events like button presses and such as we
         // continue to wait to see a ball.
 
+        // Rather than taking a full picture and searching it for a ball each time through here,
+        // the placement watcher can first wait (cheaply) for the tee region to change.  A full
+        // check is still done periodically in case the change detector missed something.
+        if (LibCameraInterface::kUseBallPlacementWatcher && waitingForBallState.already_sent_waiting_ipc_message) {
+            auto ms_since_full_check = std::chrono::duration_cast<std::chrono::milliseconds>(
+                GsEventJournal::Now() - waitingForBallState.last_full_ball_check_time_).count();
+
+            if (ms_since_full_check < LibCameraInterface::kBallPlacementWatcherForcedCheckIntervalMs) {
+                bool change_detected = false;
+
+                if (!JournaledWatchForBallPlacementChange(change_detected)) {
+                    GS_LOG_MSG(warning, "WatchForBallPlacementChange failed - falling back to CheckForBall.");
+                }
+                else if (!change_detected) {
+                    // Nothing changed, so go around again (after processing any other waiting events)
+                    GolfSimEventElement newBeginWaitingForBallPlacedEvent{ new GolfSimEvent::BeginWaitingForBallPlaced{ } };
+                    GolfSimEventQueue::QueueEvent(newBeginWaitingForBallPlacedEvent);
+
+                    return state::WaitingForBall{ GsEventJournal::Now(), true, waitingForBallState.last_full_ball_check_time_ };
+                }
+                else {
+                    GS_LOG_TRACE_MSG(trace, "Tee region changed - checking for ball.");
+                }
+            }
+        }
+
         // Otherwise, check for the ball.  The check SHOULD yield to other threads
         cv::Mat img;
         GolfBall ball;
 
-        bool found = CheckForBall(ball, img);
+        bool found = JournaledCheckForBall(ball, img);
+        const std::chrono::steady_clock::time_point full_ball_check_time = GsEventJournal::Now();
 
         if (img.empty()) {
             GS_LOG_MSG(warning, "CheckForBall() return image was empty - ignoring.");
@@ -198,7 +410,7 @@ namespace golf_sim {
                 StartFsmShutdown();
             }
 
-            std::chrono::steady_clock::time_point lastBallAcquisitionTime = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point lastBallAcquisitionTime = GsEventJournal::Now();
 
             // Schedule the timer for a determined (short) time in the future.  When the timer goes off, an
             // CheckForBallStable event will be injected
@@ -208,7 +420,9 @@ namespace golf_sim {
             // Let the monitor interface know what's happening
             GsUISystem::SendIPCStatusMessage(GsIPCResultType::kPausingForBallStabilization);
 
-            return state::WaitingForBallStabilization{ lastBallAcquisitionTime, std::chrono::steady_clock::now(), ball, img };
+            // Everything from here to the analysis of the shot works from this, rather than finding the ball again
+            return state::WaitingForBallStabilization{ lastBallAcquisitionTime, GsEventJournal::Now(),
+                                                       GsShotBallContext::Create(ball, img, kIncrementalStabilizationRoiRadiusRatio) };
         }
 
 
@@ -228,14 +442,19 @@ namespace golf_sim {
         }
 
         // Update what it is the LM 'sees' when looking for th teed ball to allow users to see
-        // if they need to reposition that ball.
-        GsUISystem::SaveWebserverImage(GsUISystem::kWebServerBallSearchAreaImage, img, true);
+        // if they need to reposition that ball.  The live preview, if it is on, replaces the image.
+        if (GsPreviewStream::IsRunning()) {
+            GsPreviewStream::SubmitFrame(img);
+        }
+        else {
+            GsUISystem::SaveWebserverImage(GsUISystem::kWebServerBallSearchAreaImage, img, true);
+        }
 
         // Queue up another event to get back here (after processing any other waiting events)
         GolfSimEventElement newBeginWaitingForBallPlacedEvent{ new GolfSimEvent::BeginWaitingForBallPlaced{ } };
         GolfSimEventQueue::QueueEvent(newBeginWaitingForBallPlacedEvent);
 
-        return state::WaitingForBall{ std::chrono::steady_clock::now(), true /* already_sent_waiting_ipc_message */};
+        return state::WaitingForBall{ GsEventJournal::Now(), true /* already_sent_waiting_ipc_message */, full_ball_check_time };
     }
 
 
@@ -249,22 +468,42 @@ namespace golf_sim {
         GolfBall ball;
         cv::Mat img;
 
-        bool found = CheckForBall(ball, img);
-        // LoggingTools::LogImage("", img, std::vector < cv::Point >{}, true, "log_last_ball_2bcompared2_still.png");
+        bool found = false;
+        bool checked_incrementally = false;
 
+        const GsShotBallContextPtr& placed_ball_context = waitingForBallStabilization.ball_context_;
 
-        // We were called by a timer in a separate thread.  Clean up that thread
-        if (BallStabilizationCheckTimerThread != nullptr) {
-            BallStabilizationCheckTimerThread->ExitThread();
-            delete BallStabilizationCheckTimerThread;
-            BallStabilizationCheckTimerThread = nullptr;
+        if (kUseIncrementalBallStabilization) {
+            bool patch_unchanged = false;
+
+            if (JournaledCheckForBallStableIncremental(*placed_ball_context, img, patch_unchanged) && patch_unchanged) {
+                // Nothing around the ball changed, so it is still where we first found it
+                ball = placed_ball_context->ball;
+                found = true;
+                checked_incrementally = true;
+            }
+            else {
+                GS_LOG_TRACE_MSG(trace, "Ball patch changed (or could not be compared) - doing a full ball check.");
+            }
         }
 
+        if (!checked_incrementally) {
+            found = JournaledCheckForBall(ball, img);
+        }
+        // LoggingTools::LogImage("", img, std::vector < cv::Point >{}, true, "log_last_ball_2bcompared2_still.png");
+
+
+        // We were called by the timer, so it has normally already gone
+        cancelTimer(BallStabilizationCheckTimer);
+
         bool ballMoved = true;
 
         // If the ball hasn't been found, then whether the ball moved is moot
-        if (found) {
-            ballMoved = ball.CheckIfBallMoved(waitingForBallStabilization.cam1_ball_, 10 /* max center move pixels */, 6 /* % radius change */);
+        if (checked_incrementally) {
+            ballMoved = false;
+        }
+        else if (found) {
+            ballMoved = ball.CheckIfBallMoved(placed_ball_context->ball, 10 /* max center move pixels */, 6 /* % radius change */);
         }
         else {
             GS_LOG_MSG(info, "=============== Ball Lost Before Stabilizing - Will look for ball again.");
@@ -280,7 +519,25 @@ namespace golf_sim {
             GolfSimEventElement beginWaitingForBallPlaced{ new GolfSimEvent::BeginWaitingForBallPlaced{ } };
             GolfSimEventQueue::QueueEvent(beginWaitingForBallPlaced);
 
-            return state::WaitingForBall{ std::chrono::steady_clock::now(), false /* send the ball-waiting message again*/};
+            return state::WaitingForBall{ GsEventJournal::Now(), false /* send the ball-waiting message again*/};
+        }
+
+        GsShotBallContextPtr shot_ball_context = placed_ball_context;
+
+        // The placement checks only had downscaled pictures, so find the ball once more at full
+        // resolution to get its precise position for the hit watching and the shot analysis
+        if (LibCameraInterface::kBallPlacementCaptureDownscale > 1) {
+            if (!JournaledCheckForBall(ball, img, true /* full_resolution */) ||
+                ball.CheckIfBallMoved(placed_ball_context->ball, 10 /* max center move pixels */, 6 /* % radius change */)) {
+                GS_LOG_MSG(info, "=============== Ball Moved (or was lost) in the full-resolution check - Will look for ball again.");
+
+                GolfSimEventElement beginWaitingForBallPlaced{ new GolfSimEvent::BeginWaitingForBallPlaced{ } };
+                GolfSimEventQueue::QueueEvent(beginWaitingForBallPlaced);
+
+                return state::WaitingForBall{ GsEventJournal::Now(), false /* send the ball-waiting message again*/};
+            }
+
+            shot_ball_context = GsShotBallContext::Create(ball, img, kIncrementalStabilizationRoiRadiusRatio);
         }
 
         // The ball has stabilized.  Now we just have to wait for the ball to be hit
@@ -289,15 +546,22 @@ namespace golf_sim {
         // Whatever happens, this is a new shot with a new shot number
         GsSimInterface::IncrementShotCounter();
 
-        // Arm Camera2 thread to start waiting for the external trigger
-        g_cam2_thread.arm();
-
-        // The sending of the priming pulses will include a trigger to make the camera2
-        // take a pre-image.  That will in turn send an event to the camera1 system that 
-        // will eventually set up the WaitingForBallHit state.
-        bool use_fast_speed = (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::GsClubType::kDriver);
-        if (!PulseStrobe::SendCameraPrimingPulses(use_fast_speed)) {
-            GS_LOG_MSG(error, "FAILED to PulseStrobe::SendCameraPrimingPulses");
+        // From here on, the capture, strobing and analysis of this shot use these settings,
+        // even if a club change comes in while the shot is in progress
+        const GsSessionSettings::Snapshot shot_settings = GsSessionSettings::ArmShot();
+
+        // A replayed journal has no cameras or strobe to arm
+        if (!GsEventJournal::IsReplaying()) {
+            // Arm Camera2 thread to start waiting for the external trigger
+            g_cam2_thread.arm();
+
+            // The sending of the priming pulses will include a trigger to make the camera2
+            // take a pre-image.  That will in turn send an event to the camera1 system that 
+            // will eventually set up the WaitingForBallHit state.
+            bool use_fast_speed = (shot_settings.club_type == GolfSimClubs::GsClubType::kDriver);
+            if (!PulseStrobe::SendCameraPrimingPulses(use_fast_speed)) {
+                GS_LOG_MSG(error, "FAILED to PulseStrobe::SendCameraPrimingPulses");
+            }
         }
 
         // Log the pertinent images for debugging & analysis
@@ -313,8 +577,9 @@ namespace golf_sim {
             }
 
             // In any case, save the image with a non-unique name that will be overwritten on the next show, but that the GUI
-            // will be able to depend on the name of.
-            LoggingTools::LogImageWithCircles("", img, std::vector < GsCircle >{ball.ball_circle_}, true, kWebServerLastTeedBallImage + ".png");
+            // will be able to depend on the name of.  It is encoded like the other web-server images.
+            LoggingTools::LogImageWithCircles("", img, std::vector < GsCircle >{ball.ball_circle_}, true, kWebServerLastTeedBallImage + ".png",
+                                              "", GsImageWriter::ArtifactClass::kWebserverImage);
         }
 
         GsUISystem::ClearWebserverImages();
@@ -323,10 +588,12 @@ namespace golf_sim {
         GolfSimEventElement beginWatchingForBallHit{ new GolfSimEvent::BeginWatchingForBallHit{ } };
         GolfSimEventQueue::QueueEvent(beginWatchingForBallHit);
 
+        // Stay at full speed from here through the post-hit analysis
+        GsPerformanceState::SetMode(GsPerformanceState::Mode::kPerformance);
+
         cv::Mat empty_mat;
-        return state::WaitingForBallHit{ std::chrono::steady_clock::now(),
-                                         waitingForBallStabilization.cam1_ball_,
-                                         waitingForBallStabilization.ball_image_,
+        return state::WaitingForBallHit{ GsEventJournal::Now(),
+                                         shot_ball_context,
                                          empty_mat };
     }
 
@@ -341,21 +608,24 @@ namespace golf_sim {
         // Let the monitor interface know what's happening so it can alert the user
         GsUISystem::SendIPCStatusMessage(GsIPCResultType::kWaitingForSimulatorArmed);
 
-        // Wait a moment so that we're not spinning too much
-        sleep(1);
+        // Wait a moment so that we're not spinning too much.  A replay already has the
+        // journal's pace.
+        if (!GsEventJournal::IsReplaying()) {
+            sleep(1);
+        }
 
-        if (GsSimInterface::GetAllSystemsArmed()) {
+        if (JournaledGetAllSystemsArmed()) {
             GolfSimEventElement beginWaitingForBallPlacedEvent{ new GolfSimEvent::BeginWaitingForBallPlaced{ } };
             GolfSimEventQueue::QueueEvent(beginWaitingForBallPlacedEvent);
 
-            return state::WaitingForBall{ std::chrono::steady_clock::now(), false /* have not sent the waiting-for-ball IPC message yet */};
+            return state::WaitingForBall{ GsEventJournal::Now(), false /* have not sent the waiting-for-ball IPC message yet */};
         }
 
         // Otherwise, keep in waiting state
         GolfSimEventElement nextBeginWaitingForSimulatorArmed{ new GolfSimEvent::BeginWaitingForSimulatorArmed{ } };
         GolfSimEventQueue::QueueEvent(nextBeginWaitingForSimulatorArmed);
 
-        return state::WaitingForSimulatorArmed{ std::chrono::steady_clock::now() };
+        return state::WaitingForSimulatorArmed{ GsEventJournal::Now() };
     }
 
     // TBD - Not certain we are going to use this state
@@ -371,12 +641,22 @@ namespace golf_sim {
         GolfSimEventElement beginWaitingForSimulatorArmed{ new GolfSimEvent::BeginWaitingForSimulatorArmed{ } };
         GolfSimEventQueue::QueueEvent(beginWaitingForSimulatorArmed);
 
-        return state::WaitingForBall{ std::chrono::steady_clock::now(), false /* have not sent the waiting-for-ball IPC message yet */ };
+        return state::WaitingForBall{ GsEventJournal::Now(), false /* have not sent the waiting-for-ball IPC message yet */ };
     }
 
 
     /*********** WaitingForBallHit ************/
 
+    // If no pre-image was captured for the shot, the camera 2 background model's latest
+    // snapshot is used.  It is small, and is never changed, so it is neither copied nor waited for.
+    static cv::Mat GetCamera2PreImage(const state::WaitingForBallHit& waitingForBallHit) {
+        if (!waitingForBallHit.camera2_pre_image_.empty() || !GolfSimCamera::kUsePreImageSubtraction) {
+            return waitingForBallHit.camera2_pre_image_;
+        }
+
+        return GsCamera2Background::Snapshot();
+    }
+
     GolfSimState onEvent(const state::WaitingForBallHit& waitingForBallHit,
         const GolfSimEvent::BeginWatchingForBallHit& beginWatchingForBallHit) {
         GS_LOG_MSG(debug, "GolfSim state transition: WaitingForBallHit - Received BeginWatchingForBallHit.");
@@ -388,24 +668,21 @@ namespace golf_sim {
         // Let the monitor interface know what's happening
         GsUISystem::SendIPCStatusMessage(GsIPCResultType::kBallPlacedAndReadyForHit);
 
-        if (!WatchForHitAndTrigger(waitingForBallHit.cam1_ball_, image, ball_hit)) {
-            GS_LOG_MSG(error, "Failed to WatchForHitAndTrigger.  Restarting GolfSim FSM.");
-            GolfSimEventElement restartEvent{ new GolfSimEvent::Restart{ } };
-            GolfSimEventQueue::QueueEvent(restartEvent);
-            return state::InitializingCamera1System{};
+        if (!JournaledWatchForHit(waitingForBallHit.ball_context_->ball, image, ball_hit)) {
+            GS_LOG_MSG(error, "Failed to WatchForHitAndTrigger.");
+            return warmRestart("WatchForHitAndTrigger failed.");
         }
 
         // TBD - Consider case where we did NOT get a ball hit indication for some reason
         GS_LOG_MSG(info, "============= BALL HIT ===============\n");
 
         // Make sure we do something sensible if we don't receive an image from the camera 2
-        // system in a reasonable amount of time.
-        // TBD - How to turn the check off when we DO get an image?
+        // system in a reasonable amount of time.  The check is cancelled when the image arrives.
         setupCam2ImageReceivedCheckTimer();
 
         // Start waiting for the camera 2 image to returned. 
         // TBD - Should probably start timer to make sure we get an image soon.
-        return state::BallHitNowWaitingForCam2Image{ waitingForBallHit.cam1_ball_, waitingForBallHit.ball_image_, waitingForBallHit.camera2_pre_image_ };
+        return state::BallHitNowWaitingForCam2Image{ waitingForBallHit.ball_context_, GetCamera2PreImage(waitingForBallHit) };
     }
 
     GolfSimState onEvent(const state::WaitingForBallHit& waitingForBallHit,
@@ -414,19 +691,20 @@ namespace golf_sim {
 
         // TBD - Perform state transition processing here
 
-        return state::BallHitNowWaitingForCam2Image{ waitingForBallHit.cam1_ball_, waitingForBallHit.ball_image_, waitingForBallHit.camera2_pre_image_ };
+        return state::BallHitNowWaitingForCam2Image{ waitingForBallHit.ball_context_, GetCamera2PreImage(waitingForBallHit) };
     }
 
     /*********** BallHitNowWaitingForCam2Image ************/
 
-    GolfSimState onEvent(const state::BallHitNowWaitingForCam2Image& BallHitNowWaitingForCam2Image,
-        const GolfSimEvent::Camera2ImageReceived& cam2ImageReceived) {
-        GS_LOG_MSG(debug, "GolfSim state transition: BallHitNowWaitingForCam2Image - Received Camera2ImageReceived ");
-
-        // TBD - Perform state transition processing here
-        // Most importantly, all of the hit analysis!
-
-        const cv::Mat& cam2_mat = cam2ImageReceived.GetBallFlightImage();
+    // All of the hit analysis, and the sending of the results.  Run either on the FSM
+    // thread or (see GsShotPipeline) in the background while the next ball is teed up.
+    // The analysis_context was made when the shot came in, so it has the shot's own settings
+    // even if the next shot has been armed since.
+    static void AnalyzeShotAndSendResults(long shot_number,
+                                          const cv::Mat& ball_image,
+                                          const cv::Mat& cam2_mat,
+                                          const cv::Mat& camera2_pre_image,
+                                          GsAnalysisContext& analysis_context) {
 
 #ifdef __unix__
         // Save the raw strobed image before processing (was lost in single-process migration)
@@ -438,9 +716,10 @@ namespace golf_sim {
         cv::Mat exposures_image;
         std::vector<GolfBall> exposure_balls;
 
-        if (!GolfSimCamera::ProcessReceivedCam2Image(BallHitNowWaitingForCam2Image.ball_image_,
+        if (!GsRemoteAnalysis::ProcessReceivedCam2Image(ball_image,
                                                     cam2_mat,
-                                                    BallHitNowWaitingForCam2Image.camera2_pre_image_,
+                                                    camera2_pre_image,
+                                                    analysis_context,
                                                     result_ball,
                                                     rotation_results,
                                                     exposures_image,
@@ -451,29 +730,45 @@ namespace golf_sim {
             GsUISystem::SaveWebserverImage(GsUISystem::kWebServerErrorExposuresImage, cam2_mat);
 #endif
 
-            GsUISystem::SendIPCErrorStatusMessage("GolfSim FSM could not ProcessReceivedCam2Image.");
+            GsUISystem::SendIPCErrorStatusMessage("GolfSim FSM could not ProcessReceivedCam2Image.", analysis_context.error_root_cause);
 
-            GS_LOG_MSG(info, "BALL_HIT_CSV, " + std::to_string(GsSimInterface::GetShotCounter()) + ", (carry - Error), (Total - Error), (Side Dest - Error), (Smash Factor - Error), (Club Speed - Error), "
-                + std::to_string(0) + ", "
-                + std::to_string(0) + ", "
-                + std::to_string(0) + ", "
-                + std::to_string(0) + ", "
-                + std::to_string(0)
-                + ", (Descent Angle-Error), (Apex-Error), (Flight Time-Error), (Type-Error)"
-            );
+            GS_LOG_MSG(info, GsShotRecord::FormatErrorCsv(shot_number));
 
         }
         else {
 
             GS_LOG_TRACE_MSG(trace, "Received and processed cam2ImageReceived.  Now sending Results to any connected Golf Simulator");
-            GsResults results(result_ball);
+            // Worked out once, and shared by the simulators and the UI
+            GsShotRecord shot_record(result_ball, shot_number);
+
+#ifdef __unix__
+            // The club strike was analyzed while the ball was, so this usually does not wait
+            GsClubStrikeResult club_strike;
+            if (GsClubStrikeAnalysis::GetResult(shot_number, club_strike) && club_strike.valid) {
+                shot_record.SetClubData(club_strike.club_speed_mps, club_strike.path_image_deg);
+            }
+#endif
+
+            GsResults results = shot_record.results;
+
+            for (const GolfBall& exposure_ball : exposure_balls) {
+                results.exposures_.push_back(GsResultsExposure{
+                    (float)exposure_ball.ball_circle_[0],
+                    (float)exposure_ball.ball_circle_[1],
+                    (float)exposure_ball.ball_circle_[2],
+                    (float)exposure_ball.distances_ortho_camera_perspective_[0],
+                    (float)exposure_ball.distances_ortho_camera_perspective_[1],
+                    (float)exposure_ball.distances_ortho_camera_perspective_[2] });
+            }
 
 
             // Get the result to the golf simulator ASAP
-            if (!GsSimInterface::SendResultsToGolfSims(results)) {
+            if (!GsSimInterface::SendResultsToGolfSims(results, shot_number)) {
                 GS_LOG_MSG(error, "GolfSim FSM could not SendResultsToGolfSim.");
             }
 
+            GsShotTrace::Mark(GsShotTrace::Stage::kResultSent);
+
             GS_LOG_TRACE_MSG(trace, "Received and processed cam2ImageReceived.  Now sending an IPC Results Message:");
 
             std::string s;
@@ -482,37 +777,85 @@ namespace golf_sim {
             auto velocity_time_period_string = GS_FORMATLIB_FORMAT("{: <6.2f}", velocity_time_period);
             s = " Time between chosen images for velocity calculation: " + velocity_time_period_string + " ms.";
 
-            GsUISystem::SendIPCHitMessage(result_ball, s);
+            GsUISystem::SendIPCHitMessage(shot_record, s);
+            GsShotTrace::Mark(GsShotTrace::Stage::kUiUpdated);
 
 #ifdef __unix__ 
             if (exposures_image.empty()) {
                 GS_LOG_MSG(warning, "Exposures_image from ProcessReceivedCamera2 was empty.");
             }
+            // Don't tell the web server about the image until it has actually been written
             GsUISystem::SaveWebserverImage(GsUISystem::kWebServerResultBallExposureCandidates,
-                exposures_image, exposure_balls);
-            GsHttpClient::PostImageReady(GsUISystem::kWebServerResultBallExposureCandidates + ".png");
+                exposures_image, exposure_balls, false,
+                [] { GsHttpClient::PostImageReady(GsImageWriter::GetEncodedFileName(GsUISystem::kWebServerResultBallExposureCandidates + ".png",
+                                                                                    GsImageWriter::ArtifactClass::kWebserverImage)); });
+
+            // Only queued here.  The history is written in the background.
+            GsShotHistory::Record(results);
+
+            // Lets the next shot's camera 2 gain make up for this one's exposure.  Done after
+            // the results are out, as nothing is waiting for it.
+            GsCamera2Exposure::RecordShot(cam2_mat, exposure_balls, analysis_context.club_type == GolfSimClubs::kPutter);
 #endif
 
         }
 
+        // Whether or not the shot could be processed, its trace is done
+        GsShotTrace::EndShot();
+    }
+
+    GolfSimState onEvent(const state::BallHitNowWaitingForCam2Image& BallHitNowWaitingForCam2Image,
+        const GolfSimEvent::Camera2ImageReceived& cam2ImageReceived) {
+        GS_LOG_MSG(debug, "GolfSim state transition: BallHitNowWaitingForCam2Image - Received Camera2ImageReceived ");
+
+        // The image arrived, so there is nothing to time out
+        cancelTimer(ReceivedCam2ImageCheckTimer);
+
+        GsPerformanceState::RecordThermalState();
+
+        const cv::Mat& cam2_mat = cam2ImageReceived.GetBallFlightImage();
+        const long shot_number = GsSimInterface::GetShotCounter();
+
+        // Made here, on the FSM thread, before the next shot can be armed with other settings
+        // (e.g., a club change) or strobe timing
+        GsAnalysisContext analysis_context = GsAnalysisContext::FromCurrentSettings();
+        analysis_context.send_staged_results = true;
+        analysis_context.skip_spin_if_busy = true;
+        analysis_context.teed_ball_context = BallHitNowWaitingForCam2Image.ball_context_;
+
+        if (GsShotPipeline::IsEnabled()) {
+            // The next shot will re-use the camera buffers (and the camera 2 frame is from a
+            // pool), so the background analysis gets its own copies
+            const cv::Mat ball_image = BallHitNowWaitingForCam2Image.ball_context_->ball_image.clone();
+            const cv::Mat strobed_image = cam2_mat.clone();
+            // The pre-image is not written to by anything, so it is shared.  So is the context's
+            // ball context, as the analysis only uses its ball and the size of its image.
+            const cv::Mat camera2_pre_image = BallHitNowWaitingForCam2Image.camera2_pre_image_;
+
+            GsShotPipeline::Submit(shot_number, [shot_number, ball_image, strobed_image, camera2_pre_image, analysis_context]() mutable {
+                AnalyzeShotAndSendResults(shot_number, ball_image, strobed_image, camera2_pre_image, analysis_context);
+            });
+        }
+        else {
+            AnalyzeShotAndSendResults(shot_number, BallHitNowWaitingForCam2Image.ball_context_->ball_image, cam2_mat,
+                                      BallHitNowWaitingForCam2Image.camera2_pre_image_, analysis_context);
+        }
+
         // Setup to go through the whole sequence again
         GolfSimEventElement beginWaitingForBallPlacedEvent{ new GolfSimEvent::BeginWaitingForBallPlaced{ } };
         GolfSimEventQueue::QueueEvent(beginWaitingForBallPlacedEvent);
 
 
-        return state::WaitingForBall{ std::chrono::steady_clock::now(), false /* have not sent the waiting-for-ball IPC message yet */ };
+        return state::WaitingForBall{ GsEventJournal::Now(), false /* have not sent the waiting-for-ball IPC message yet */ };
     }
 
     GolfSimState onEvent(const state::BallHitNowWaitingForCam2Image& BallHitNowWaitingForCam2Image,
         const GolfSimEvent::CheckForCam2ImageReceived& checkForCam2ImageReceived) {
         GS_LOG_MSG(debug, "GolfSim state transition: BallHitNowWaitingForCam2Image - Received CheckForCam2ImageReceived - Will restart ");
 
-        GS_LOG_MSG(error, "BallHitNowWaitingForCam2Image - Timed out waiting for Cam2Image.  Restarting... ");
-
-        GolfSimEventElement restartEvent{ new GolfSimEvent::Restart{ } };
-        GolfSimEventQueue::QueueEvent(restartEvent);
+        GS_LOG_MSG(error, "BallHitNowWaitingForCam2Image - Timed out waiting for Cam2Image.");
 
-        return state::InitializingCamera1System{};
+        return warmRestart("Timed out waiting for the camera 2 image.");
     }
 
 
@@ -588,24 +931,31 @@ namespace golf_sim {
                 helper::overload{
                             [](const state::InitializingCamera1System& initializing) {
                             GS_LOG_TRACE_MSG(trace, "Initializing.");
+                            GsEventJournal::RecordState("Initializing");
                             },
                             [](const state::Exiting& exiting) {
                             GS_LOG_TRACE_MSG(trace, "Exiting.");
+                            GsEventJournal::RecordState("Exiting");
                             },
                             [](const state::WaitingForBall& ballPlaced) {
                             GS_LOG_TRACE_MSG(trace, "BallPlaced.");
+                            GsEventJournal::RecordState("BallPlaced");
                             },
                             [](const state::WaitingForBallStabilization& waitingForBallStabilization) {
                             GS_LOG_TRACE_MSG(trace, "WaitingForBallStabilization.");
+                            GsEventJournal::RecordState("WaitingForBallStabilization");
                             },
                             [](const state::BallHitNowWaitingForCam2Image& ballHitNowWaitingForCam2Image) {
                             GS_LOG_TRACE_MSG(trace, "BallHitNowWaitingForCam2Image.");
+                            GsEventJournal::RecordState("BallHitNowWaitingForCam2Image");
                             },
                             [](const state::WaitingForBallHit& ballHit) {
                             GS_LOG_TRACE_MSG(trace, "WaitingForBallHit.");
+                            GsEventJournal::RecordState("WaitingForBallHit");
                             },
                             [](const state::WaitingForSimulatorArmed& waitingForSimulatorArmed) {
                             GS_LOG_TRACE_MSG(trace, "WaitingForSimulatorArmed.");
+                            GsEventJournal::RecordState("WaitingForSimulatorArmed");
                             }
                 },
                 state_);
@@ -627,13 +977,7 @@ namespace golf_sim {
 
         GS_LOG_TRACE_MSG(trace, "Processing ControlMessage of type: " + GsIPCControlMsg::FormatControlMessageType(message_type));
 
-        if (message_type == GsIPCControlMsgType::kClubChangeToPutter) {
-            GolfSimClubs::SetCurrentClubType(GolfSimClubs::GsClubType::kPutter);
-        }
-        else if (message_type == GsIPCControlMsgType::kClubChangeToDriver) {
-            GolfSimClubs::SetCurrentClubType(GolfSimClubs::GsClubType::kDriver);
-        }
-        else {
+        if (!GsIPCControlMsg::Apply(message_type)) {
             GS_LOG_MSG(error, "Received ControlMessage event with unknown message type.");
         }
 
@@ -643,6 +987,7 @@ namespace golf_sim {
 
     bool RunGolfSimFsm( const GolfSimState& starting_state ) {
         GS_LOG_TRACE_MSG(trace, "RunGolfSimFsm");
+        GS_TRACE_THREAD_NAME("FSM");
 
         // Catch Ctrl-C and such to get out of the FSM when necessary.
         signal(SIGUSR1, default_signal_handler);
@@ -657,8 +1002,17 @@ namespace golf_sim {
 
         GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kMaxCam2ImageReceivedTimeMs", kMaxCam2ImageReceivedTimeMs);
 
+        GolfSimConfiguration::SetConstant("gs_config.ball_position.kUseIncrementalBallStabilization", kUseIncrementalBallStabilization);
+        GolfSimConfiguration::SetConstant("gs_config.ball_position.kIncrementalStabilizationCheckIntervalMs", kIncrementalStabilizationCheckIntervalMs);
+        GolfSimConfiguration::SetConstant("gs_config.ball_position.kIncrementalStabilizationMinCorrelation", kIncrementalStabilizationMinCorrelation);
+        GolfSimConfiguration::SetConstant("gs_config.ball_position.kIncrementalStabilizationRoiRadiusRatio", kIncrementalStabilizationRoiRadiusRatio);
+
         GolfSimConfiguration::SetConstant("gs_config.user_interface.kWebServerCamera2Image", kWebServerCamera2Image);
         GolfSimConfiguration::SetConstant("gs_config.user_interface.kWebServerLastTeedBallImage", kWebServerLastTeedBallImage);        
+
+        if (!GsEventJournal::StartRecording()) {
+            GS_LOG_MSG(warning, "Could not start the event journal.  Continuing without it.");
+        }
         
         GolfSimStateMachine golfSim;
 
@@ -682,10 +1036,15 @@ namespace golf_sim {
 
             GS_LOG_TRACE_MSG(trace, "       Event Queue size = " + std::to_string(GolfSimEventQueue::GetQueueLength()) );
 
+            // A replayed journal is the only source of events, and the replay ends with it
+            if (GsEventJournal::IsReplaying()) {
+                if (!GsEventJournal::NextReplayEvent(eventElement)) {
+                    GS_LOG_MSG(info, "Reached the end of the event journal.");
+                    break;
+                }
+            }
             // Only wait for a bit
-            bool event_present = GolfSimEventQueue::DeQueueEvent(eventElement, kEventLoopPauseMs);
-       
-            if (!event_present) {
+            else if (!GolfSimEventQueue::DeQueueEvent(eventElement, kEventLoopPauseMs)) {
                 continue;
             }
 
@@ -695,6 +1054,10 @@ namespace golf_sim {
             }
 
             GS_LOG_TRACE_MSG(trace, "       Received event: " + eventElement.e_->Format());
+            GsEventJournal::RecordEvent(eventElement);
+
+            GS_TRACE_ZONE("FsmEvent");
+            GS_TRACE_COUNTER("fsm_event_queue_length", GolfSimEventQueue::GetQueueLength());
             // At least one event is waiting - process it
             try {
                 PossibleEvent e = GolfSimEventQueue::ConvertEventToPossibleEvent(eventElement.e_);
@@ -729,8 +1092,10 @@ namespace golf_sim {
             }
             catch (std::exception& ex) {
                 GS_LOG_TRACE_MSG(trace, "Exception! - " + std::string(ex.what()) + ".  Restarting...");
-                state::InitializingCamera1System state;
-                golfSim.restartSim(state);
+
+                // Without the Restart event that warmRestart queues, nothing would get the FSM
+                // out of the Initializing state again
+                golfSim.restartSim(warmRestart("Exception while processing an event."));
             }
 
             // If there is another event, we won't pause before processing it in the next loop
@@ -738,6 +1103,8 @@ namespace golf_sim {
 
         GS_LOG_TRACE_MSG(trace, "Shutting down system...");
 
+        GsEventJournal::StopRecording();
+
         PerformSystemShutdownTasks();
 
         GS_LOG_TRACE_MSG(trace, "Exiting eventLoop");
@@ -782,21 +1149,18 @@ namespace golf_sim {
         // Allow other things that might be checking the running flag to do so
         std::this_thread::yield();
 
-        // Clean up any threads that still exist
-        // TBD - This is not thread-safe - move to a central function with a lock
-        if (BallStabilizationCheckTimerThread != nullptr) {
-            GS_LOG_TRACE_MSG(trace, "Shutting down BallStabilizationCheckTimerThread");
-            BallStabilizationCheckTimerThread->ExitThread();
-            delete BallStabilizationCheckTimerThread;
-            BallStabilizationCheckTimerThread = nullptr;
-        }
-        if (ReceivedCam2ImageCheckTimerThread != nullptr) {
-            GS_LOG_TRACE_MSG(trace, "Shutting down ReceivedCam2ImageCheckTimerThread");
-            ReceivedCam2ImageCheckTimerThread->ExitThread();
-            delete ReceivedCam2ImageCheckTimerThread;
-            ReceivedCam2ImageCheckTimerThread = nullptr;
-        }
+        // Drop any pending timers and stop the timer thread
+        GS_LOG_TRACE_MSG(trace, "Shutting down the GsTimerScheduler");
+        cancelTimer(BallStabilizationCheckTimer);
+        cancelTimer(ReceivedCam2ImageCheckTimer);
+        GsTimerScheduler::GetInstance().Shutdown();
+
+        // Any shot that is still being analyzed still gets its results sent
+        GsShotPipeline::Shutdown();
 
+        GsPerformanceState::Restore();
+
+        g_cam1_watcher.stop();
         g_cam2_thread.stop();
 
         std::this_thread::yield();
@@ -821,40 +1185,77 @@ namespace golf_sim {
                            mode == SystemMode::kTestSpin ||
                            mode == SystemMode::kTestExternalSimMessage ||
                            mode == SystemMode::kTestGSProServer ||
-                           mode == SystemMode::kAutomatedTesting);
+                           mode == SystemMode::kAutomatedTesting ||
+                           mode == SystemMode::kEventJournalReplay);
+
+        bool kParallelStartup = false;
+        GolfSimConfiguration::SetConstant("gs_config.modes.kParallelStartup", kParallelStartup);
+
+        GsParallelStartup startup;
 
         if (!skip_camera) {
             // Setup the Pi Camera to be internally or externally triggered as appropriate
-            if (!PerformCameraSystemStartup() ) {
-                GS_LOG_MSG(error, "Failed to PerformCameraSystemStartup.");
-                return false;
-            }
+            startup.Add("cameras", []() {
+                if (!PerformCameraSystemStartup()) {
+                    GS_LOG_MSG(error, "Failed to PerformCameraSystemStartup.");
+                    return false;
+                }
+                return true;
+            });
         } else {
             GS_LOG_MSG(info, "Skipping camera initialization for test mode: " + std::to_string(mode));
         }
 
-        GsHttpClient::Init();
-        GsUISystem::SendIPCStatusMessage(GsIPCResultType::kInitializing);
-
-        if (!PulseStrobe::InitGPIOSystem(default_signal_handler)) {
-            GS_LOG_MSG(error, "Failed to InitGPIOSystem.");
-            return false;
-        }
+        // Loads (and warms up) whichever NCNN models the detection methods use, so that
+        // the first shot does not have to
+        startup.Add("models", []() {
+            return BallImageProc::get_ball_image_processor() != nullptr;
+        });
+
+        startup.Add("ui", []() {
+            GsHttpClient::Init();
+            GsUISystem::SendIPCStatusMessage(GsIPCResultType::kInitializing);
+            return true;
+        });
+
+        startup.Add("gpio", []() {
+            if (!PulseStrobe::InitGPIOSystem(default_signal_handler)) {
+                GS_LOG_MSG(error, "Failed to InitGPIOSystem.");
+                return false;
+            }
+            return true;
+        });
 
-        if (!GsSimInterface::InitializeSims()) {
-            GS_LOG_MSG(error, "Failed to Initialize the Golf Simulator Interface.");
-            return false;
-        }
+        startup.Add("sims", []() {
+            if (!GsSimInterface::InitializeSims()) {
+                GS_LOG_MSG(error, "Failed to Initialize the Golf Simulator Interface.");
+                return false;
+            }
+            return true;
+        });
 
         // Start Camera2 capture thread for the main shot-detection modes
         // Wait for Camera2's pipeline to finish before Camera1 opens —
         // libcamera's pipeline handler is not thread-safe for concurrent setup.
+        // The priming pulses need the GPIO system.
         if (mode == SystemMode::kCamera1 || mode == SystemMode::kCamera1TestStandalone) {
-            g_cam2_thread.start();
-            if (!g_cam2_thread.wait_until_ready()) {
-                GS_LOG_MSG(error, "Camera2 pipeline failed to initialize");
-                return false;
+            std::vector<std::string> camera2_depends_on{ "gpio" };
+            if (!skip_camera) {
+                camera2_depends_on.push_back("cameras");
             }
+
+            startup.Add("camera2", []() {
+                g_cam2_thread.start();
+                if (!g_cam2_thread.wait_until_ready()) {
+                    GS_LOG_MSG(error, "Camera2 pipeline failed to initialize");
+                    return false;
+                }
+                return true;
+            }, camera2_depends_on);
+        }
+
+        if (!startup.Run(kParallelStartup)) {
+            return false;
         }
 
         bool kStartInPuttingMode = false;
@@ -20,6 +20,7 @@
 #include "golf_ball.h"
 #include "gs_result_types.h"
 #include "gs_events.h"
+#include "gs_shot_ball_context.h"
 
 
 namespace golf_sim {
@@ -35,6 +36,8 @@ namespace golf_sim {
         struct WaitingForBall {
             std::chrono::steady_clock::time_point startTime_;
             bool already_sent_waiting_ipc_message = false;
+            // When the last full CheckForBall was done.  Used by the ball placement watcher.
+            std::chrono::steady_clock::time_point last_full_ball_check_time_{};
         };
 
         struct WaitingForSimulatorArmed {
@@ -44,20 +47,18 @@ namespace golf_sim {
         struct WaitingForBallStabilization {
             std::chrono::steady_clock::time_point lastBallAcquisitionTime_;
             std::chrono::steady_clock::time_point startTime_;
-            GolfBall cam1_ball_;
-            cv::Mat ball_image_;
+            // The ball as it was first found.  Made again if a full-resolution check refines it.
+            GsShotBallContextPtr ball_context_;
         };
 
         struct WaitingForBallHit {
             std::chrono::steady_clock::time_point  startTime_;
-            GolfBall cam1_ball_;
-            cv::Mat ball_image_;
+            GsShotBallContextPtr ball_context_;
             cv::Mat camera2_pre_image_;
         };
 
         struct BallHitNowWaitingForCam2Image {
-            GolfBall cam1_ball_;
-            cv::Mat ball_image_;
+            GsShotBallContextPtr ball_context_;
             cv::Mat camera2_pre_image_;
         };
 
@@ -0,0 +1,505 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <cstring>
+#include <string>
+
+#include <opencv2/imgproc.hpp>
+
+#include "gs_gpu_preprocess.h"
+#include "logging_tools.h"
+
+#ifdef GS_USE_GPU_PREPROCESSING
+#include <epoxy/egl.h>
+#include <epoxy/gl.h>
+#endif
+
+namespace golf_sim {
+
+#ifdef GS_USE_GPU_PREPROCESSING
+
+    // Must match local_size_x and local_size_y in the undistort shader
+    static const GLuint kUndistortLocalSize = 8;
+
+    // Each invocation writes 4 gray pixels of a row, packed into one uint, so the output
+    // buffer can be copied straight into a CV_8UC1 image.  A pixel whose undistorted source
+    // is off the frame is 0, as cv::remap's default BORDER_CONSTANT would make it.
+    // FRAME_SAMPLER is defined as samplerExternalOES for an imported camera buffer and as
+    // sampler2D for an uploaded frame.
+    static const char* kUndistortShaderBody = R"(
+layout(local_size_x = 8, local_size_y = 8) in;
+
+uniform highp FRAME_SAMPLER u_frame;
+uniform highp sampler2D u_map;
+
+layout(std430, binding = 0) writeonly buffer Gray { uint gray[]; };
+
+uniform int u_rows;
+uniform int u_cols;
+uniform int u_row_words;
+uniform bool u_use_map;
+uniform bool u_single_channel;
+uniform bool u_swap_red_blue;
+
+float GrayAt(int col, int row) {
+    vec2 source = vec2(float(col), float(row));
+
+    if (u_use_map) {
+        source = texelFetch(u_map, ivec2(col, row), 0).xy;
+    }
+
+    if (source.x < 0.0 || source.y < 0.0 || source.x > float(u_cols - 1) || source.y > float(u_rows - 1)) {
+        return 0.0;
+    }
+
+    // Texel centers are at +0.5, so this is the same bilinear weighting as cv::remap's
+    vec4 color = texture(u_frame, (source + 0.5) / vec2(float(u_cols), float(u_rows)));
+
+    if (u_single_channel) {
+        return color.r;
+    }
+
+    vec3 rgb = u_swap_red_blue ? color.bgr : color.rgb;
+    return dot(rgb, vec3(0.299, 0.587, 0.114));
+}
+
+void main() {
+    int word = int(gl_GlobalInvocationID.x);
+    int row = int(gl_GlobalInvocationID.y);
+
+    if (word >= u_row_words || row >= u_rows) {
+        return;
+    }
+
+    uint packed_pixels = 0u;
+
+    for (int i = 0; i < 4; i++) {
+        int col = word * 4 + i;
+
+        if (col < u_cols) {
+            uint value = uint(clamp(GrayAt(col, row) * 255.0 + 0.5, 0.0, 255.0));
+            packed_pixels |= value << uint(8 * i);
+        }
+    }
+
+    gray[row * u_row_words + word] = packed_pixels;
+}
+)";
+
+    static const char* kExternalFrameHeader = "#version 310 es\n"
+                                              "#extension GL_OES_EGL_image_external_essl3 : require\n"
+                                              "#define FRAME_SAMPLER samplerExternalOES\n";
+
+    static const char* kUploadedFrameHeader = "#version 310 es\n"
+                                              "#define FRAME_SAMPLER sampler2D\n";
+
+    struct GsGpuPreprocess::GpuState {
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLContext context = EGL_NO_CONTEXT;
+
+        // 0 if the camera buffers cannot be imported
+        GLuint external_program = 0;
+        GLuint uploaded_program = 0;
+
+        // Cleared after the first failed import, e.g., of a pixel format the GPU cannot sample
+        bool import_frame_buffers = false;
+
+        GLuint external_texture = 0;
+        GLuint frame_texture = 0;
+        GLuint map_texture = 0;
+        GLuint gray_buffer = 0;
+
+        // What frame_texture currently holds storage for
+        cv::Size frame_texture_size;
+        int frame_texture_type = -1;
+
+        // The maps that map_texture was made from.  Holding map1 keeps its data pointer from
+        // being re-used by other maps.
+        cv::Mat map_texture_source;
+
+        size_t gray_buffer_bytes = 0;
+    };
+
+    static GLuint CompileComputeProgram(const char* header, const std::string& name) {
+
+        const char* sources[] = { header, kUndistortShaderBody };
+
+        GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+        glShaderSource(shader, 2, sources, nullptr);
+        glCompileShader(shader);
+
+        GLint ok = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+
+        if (ok != GL_TRUE) {
+            char log[1024] = {};
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            GS_LOG_MSG(warning, "Could not compile the " + name + " GPU preprocessing shader: " + std::string(log));
+            glDeleteShader(shader);
+            return 0;
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, shader);
+        glLinkProgram(program);
+        glDeleteShader(shader);
+
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+
+        if (ok != GL_TRUE) {
+            char log[1024] = {};
+            glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+            GS_LOG_MSG(warning, "Could not link the " + name + " GPU preprocessing shader: " + std::string(log));
+            glDeleteProgram(program);
+            return 0;
+        }
+
+        return program;
+    }
+
+    static void SetTextureFiltering(GLenum target, GLint filter) {
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, filter);
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    // Uploads image (whose rows may be padded) into the currently bound GL_TEXTURE_2D
+    static void UploadTexture(const cv::Mat& image, GLint internal_format, GLenum format, GLenum type, bool allocate) {
+
+        cv::Mat continuous_rows = image;
+
+        if (image.step[0] % image.elemSize() != 0) {
+            continuous_rows = image.clone();
+        }
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint)(continuous_rows.step[0] / continuous_rows.elemSize()));
+
+        if (allocate) {
+            glTexImage2D(GL_TEXTURE_2D, 0, internal_format, image.cols, image.rows, 0, format, type, continuous_rows.data);
+        }
+        else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.cols, image.rows, format, type, continuous_rows.data);
+        }
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+    bool GsGpuPreprocess::Initialize() {
+
+        auto gpu = std::make_unique<GpuState>();
+
+        // A surfaceless display needs no window system, e.g., when running headless over ssh
+        if (epoxy_has_egl_extension(EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless")) {
+            gpu->display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+
+        if (gpu->display == EGL_NO_DISPLAY) {
+            gpu->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        EGLint egl_major = 0;
+        EGLint egl_minor = 0;
+
+        if (gpu->display == EGL_NO_DISPLAY || !eglInitialize(gpu->display, &egl_major, &egl_minor)) {
+            GS_LOG_MSG(warning, "No EGL display for the GPU preprocessing.");
+            return false;
+        }
+
+        if (!epoxy_has_egl_extension(gpu->display, "EGL_KHR_surfaceless_context")) {
+            GS_LOG_MSG(warning, "The EGL display does not support surfaceless contexts, so there is no GPU preprocessing.");
+            eglTerminate(gpu->display);
+            return false;
+        }
+
+        eglBindAPI(EGL_OPENGL_ES_API);
+
+        EGLConfig config = EGL_NO_CONFIG_KHR;
+
+        if (!epoxy_has_egl_extension(gpu->display, "EGL_KHR_no_config_context")) {
+            // Any surface type will do, as the context never draws to one
+            const EGLint config_attribs[] = {
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+                EGL_SURFACE_TYPE, 0,
+                EGL_NONE
+            };
+            EGLint num_configs = 0;
+
+            if (!eglChooseConfig(gpu->display, config_attribs, &config, 1, &num_configs) || num_configs < 1) {
+                GS_LOG_MSG(warning, "No OpenGL ES 3 EGL config for the GPU preprocessing.");
+                eglTerminate(gpu->display);
+                return false;
+            }
+        }
+
+        const EGLint context_attribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 1,
+            EGL_NONE
+        };
+
+        gpu->context = eglCreateContext(gpu->display, config, EGL_NO_CONTEXT, context_attribs);
+
+        if (gpu->context == EGL_NO_CONTEXT || !eglMakeCurrent(gpu->display, EGL_NO_SURFACE, EGL_NO_SURFACE, gpu->context)) {
+            GS_LOG_MSG(warning, "Could not create an OpenGL ES 3.1 context for the GPU preprocessing.");
+            if (gpu->context != EGL_NO_CONTEXT) {
+                eglDestroyContext(gpu->display, gpu->context);
+            }
+            eglTerminate(gpu->display);
+            return false;
+        }
+
+        gpu->uploaded_program = CompileComputeProgram(kUploadedFrameHeader, "uploaded frame");
+
+        if (gpu->uploaded_program == 0) {
+            eglMakeCurrent(gpu->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(gpu->display, gpu->context);
+            eglTerminate(gpu->display);
+            return false;
+        }
+
+        // Without the import, the frames are uploaded instead, which still takes the remap off the CPU
+        if (epoxy_has_egl_extension(gpu->display, "EGL_EXT_image_dma_buf_import") &&
+            epoxy_has_gl_extension("GL_OES_EGL_image_external_essl3")) {
+            gpu->external_program = CompileComputeProgram(kExternalFrameHeader, "camera buffer");
+            gpu->import_frame_buffers = (gpu->external_program != 0);
+        }
+
+        if (!gpu->import_frame_buffers) {
+            GS_LOG_MSG(info, "The GPU cannot import the camera buffers, so the GPU preprocessing will upload each frame.");
+        }
+
+        glGenTextures(1, &gpu->external_texture);
+        glGenTextures(1, &gpu->frame_texture);
+        glGenTextures(1, &gpu->map_texture);
+        glGenBuffers(1, &gpu->gray_buffer);
+
+        glBindTexture(GL_TEXTURE_2D, gpu->frame_texture);
+        SetTextureFiltering(GL_TEXTURE_2D, GL_LINEAR);
+
+        // Float textures are not filterable in OpenGL ES, and the maps are only texelFetch'ed
+        glBindTexture(GL_TEXTURE_2D, gpu->map_texture);
+        SetTextureFiltering(GL_TEXTURE_2D, GL_NEAREST);
+
+        GS_LOG_MSG(info, "GPU preprocessing is using " + std::string((const char*)glGetString(GL_RENDERER)) +
+                         " (" + std::string((const char*)glGetString(GL_VERSION)) + ").");
+
+        // The context is made current again by whichever thread processes the next frame
+        eglMakeCurrent(gpu->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+        gpu_ = std::move(gpu);
+
+        return true;
+    }
+
+    GsGpuPreprocess::~GsGpuPreprocess() {
+
+        if (!gpu_) {
+            return;
+        }
+
+        eglMakeCurrent(gpu_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, gpu_->context);
+        glDeleteTextures(1, &gpu_->external_texture);
+        glDeleteTextures(1, &gpu_->frame_texture);
+        glDeleteTextures(1, &gpu_->map_texture);
+        glDeleteBuffers(1, &gpu_->gray_buffer);
+        glDeleteProgram(gpu_->external_program);
+        glDeleteProgram(gpu_->uploaded_program);
+        eglMakeCurrent(gpu_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(gpu_->display, gpu_->context);
+        eglTerminate(gpu_->display);
+    }
+
+    GsGpuPreprocess* GsGpuPreprocess::Instance() {
+
+        // Never deleted, because the order of the EGL teardown at exit is not defined
+        static GsGpuPreprocess* instance = []() -> GsGpuPreprocess* {
+            GsGpuPreprocess* gpu_preprocess = new GsGpuPreprocess();
+
+            if (!gpu_preprocess->Initialize()) {
+                delete gpu_preprocess;
+                return nullptr;
+            }
+
+            return gpu_preprocess;
+        }();
+
+        return instance;
+    }
+
+    bool GsGpuPreprocess::UndistortToGray(const cv::Mat& frame,
+                                          const GsGpuFrameBuffer* frame_buffer,
+                                          const cv::Mat& map1,
+                                          const cv::Mat& map2,
+                                          cv::Mat& gray_image) {
+
+        CV_Assert((frame.type() == CV_8UC1 || frame.type() == CV_8UC3));
+        CV_Assert((map1.empty() || map1.size() == frame.size()));
+
+        const int rows = frame.rows;
+        const int cols = frame.cols;
+        const int row_words = (cols + 3) / 4;
+        const size_t gray_bytes = (size_t)rows * row_words * sizeof(GLuint);
+
+        gray_image.create(rows, cols, CV_8UC1);
+
+        if (rows == 0 || cols == 0) {
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!eglMakeCurrent(gpu_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, gpu_->context)) {
+            GS_LOG_MSG(warning, "Could not make the GPU preprocessing context current.");
+            return false;
+        }
+
+        // The maps only change with the calibration (or the image size), so are usually already on the GPU
+        const bool use_map = !map1.empty();
+
+        if (use_map && (map1.data != gpu_->map_texture_source.data || map1.size() != gpu_->map_texture_source.size())) {
+            cv::Mat map_xy = map1;
+
+            if (map1.type() != CV_32FC2 || !map2.empty()) {
+                cv::convertMaps(map1, map2, map_xy, cv::noArray(), CV_32FC2);
+            }
+
+            glBindTexture(GL_TEXTURE_2D, gpu_->map_texture);
+            UploadTexture(map_xy, GL_RG32F, GL_RG, GL_FLOAT, true);
+            gpu_->map_texture_source = map1;
+        }
+
+        EGLImageKHR frame_image = EGL_NO_IMAGE_KHR;
+
+        if (frame_buffer != nullptr && gpu_->import_frame_buffers) {
+            const EGLint image_attribs[] = {
+                EGL_WIDTH, frame_buffer->width,
+                EGL_HEIGHT, frame_buffer->height,
+                EGL_LINUX_DRM_FOURCC_EXT, (EGLint)frame_buffer->drm_fourcc,
+                EGL_DMA_BUF_PLANE0_FD_EXT, frame_buffer->fd,
+                EGL_DMA_BUF_PLANE0_OFFSET_EXT, (EGLint)frame_buffer->offset,
+                EGL_DMA_BUF_PLANE0_PITCH_EXT, (EGLint)frame_buffer->stride,
+                EGL_NONE
+            };
+
+            frame_image = eglCreateImageKHR(gpu_->display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, image_attribs);
+
+            if (frame_image == EGL_NO_IMAGE_KHR) {
+                GS_LOG_MSG(warning, "Could not import the camera buffer (fourcc " + std::to_string(frame_buffer->drm_fourcc) +
+                                    ") into the GPU, so the GPU preprocessing will upload each frame instead.");
+                gpu_->import_frame_buffers = false;
+            }
+        }
+
+        GLuint program = gpu_->uploaded_program;
+
+        if (frame_image != EGL_NO_IMAGE_KHR) {
+            program = gpu_->external_program;
+
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_EXTERNAL_OES, gpu_->external_texture);
+            SetTextureFiltering(GL_TEXTURE_EXTERNAL_OES, GL_LINEAR);
+            glEGLImageTargetTexture2DOES(GL_TEXTURE_EXTERNAL_OES, frame_image);
+        }
+        else {
+            const bool single_channel = (frame.channels() == 1);
+            const bool allocate = (frame.size() != gpu_->frame_texture_size || frame.type() != gpu_->frame_texture_type);
+
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, gpu_->frame_texture);
+            UploadTexture(frame, single_channel ? GL_R8 : GL_RGB8, single_channel ? GL_RED : GL_RGB, GL_UNSIGNED_BYTE, allocate);
+
+            gpu_->frame_texture_size = frame.size();
+            gpu_->frame_texture_type = frame.type();
+        }
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, gpu_->map_texture);
+
+        if (gpu_->gray_buffer_bytes != gray_bytes) {
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, gpu_->gray_buffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)gray_bytes, nullptr, GL_DYNAMIC_READ);
+            gpu_->gray_buffer_bytes = gray_bytes;
+        }
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, gpu_->gray_buffer);
+
+        // An imported buffer has its real channel order, while an uploaded (OpenCV) frame is BGR
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "u_frame"), 0);
+        glUniform1i(glGetUniformLocation(program, "u_map"), 1);
+        glUniform1i(glGetUniformLocation(program, "u_rows"), rows);
+        glUniform1i(glGetUniformLocation(program, "u_cols"), cols);
+        glUniform1i(glGetUniformLocation(program, "u_row_words"), row_words);
+        glUniform1i(glGetUniformLocation(program, "u_use_map"), use_map ? 1 : 0);
+        glUniform1i(glGetUniformLocation(program, "u_single_channel"), frame.channels() == 1 ? 1 : 0);
+        glUniform1i(glGetUniformLocation(program, "u_swap_red_blue"), frame_image == EGL_NO_IMAGE_KHR ? 1 : 0);
+        glDispatchCompute((GLuint)((row_words + kUndistortLocalSize - 1) / kUndistortLocalSize),
+                          (GLuint)((rows + kUndistortLocalSize - 1) / kUndistortLocalSize), 1);
+
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        bool ok = true;
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, gpu_->gray_buffer);
+        const uchar* gray = (const uchar*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, (GLsizeiptr)gray_bytes, GL_MAP_READ_BIT);
+
+        if (gray == nullptr) {
+            ok = false;
+        }
+        else {
+            const size_t row_bytes = (size_t)row_words * sizeof(GLuint);
+
+            for (int row = 0; row < rows; row++) {
+                std::memcpy(gray_image.ptr<uchar>(row), gray + row * row_bytes, cols);
+            }
+            glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+        }
+
+        GLenum error = glGetError();
+
+        if (error != GL_NO_ERROR) {
+            GS_LOG_MSG(warning, "GPU preprocessing failed with GL error " + std::to_string(error) + ".");
+            ok = false;
+        }
+
+        // The mapping above waited for the shader, so the camera buffer is no longer being read
+        if (frame_image != EGL_NO_IMAGE_KHR) {
+            eglDestroyImageKHR(gpu_->display, frame_image);
+        }
+
+        eglMakeCurrent(gpu_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+        return ok;
+    }
+
+#else
+
+    struct GsGpuPreprocess::GpuState {
+    };
+
+    bool GsGpuPreprocess::Initialize() {
+        return false;
+    }
+
+    GsGpuPreprocess::~GsGpuPreprocess() {
+    }
+
+    GsGpuPreprocess* GsGpuPreprocess::Instance() {
+        return nullptr;
+    }
+
+    bool GsGpuPreprocess::UndistortToGray(const cv::Mat& frame,
+                                          const GsGpuFrameBuffer* frame_buffer,
+                                          const cv::Mat& map1,
+                                          const cv::Mat& map2,
+                                          cv::Mat& gray_image) {
+        return false;
+    }
+
+#endif
+
+}
@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// An OpenGL ES 3.1 compute-shader backend that undistorts the camera 2 (strobed) frame and
+// converts it to grayscale on the GPU, so that the CPU cores are free for the post-hit analysis
+// as soon as the frame arrives.  The camera buffer is imported directly as an EGL image (as the
+// EGL preview does), or, if that is not possible, uploaded as a texture.
+//
+// The undistortion is a bilinear texture lookup through the same maps as the CPU cv::remap, and
+// the gray value uses the same BT.601 weights as cv::COLOR_BGR2GRAY.  The GPU's filtering is
+// less precise than cv::remap's, so a pixel can differ from the CPU's by a gray level or so.
+// The CLAHE and the blur in BallImageProc::PreProcessStrobedImage stay on the CPU, because the
+// blur has to follow the CLAHE there.
+//
+// Only built with -DGS_USE_GPU_PREPROCESSING (the enable_gpu_preprocessing meson option, which
+// needs libepoxy).  Otherwise, or if no suitable GPU is found, Instance() is nullptr and the
+// CPU undistortion is used.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    // The DMA-buf behind a camera frame, as the EGL_EXT_image_dma_buf_import extension wants it
+    struct GsGpuFrameBuffer {
+        int fd = -1;
+        uint32_t offset = 0;
+        uint32_t stride = 0;
+        int width = 0;
+        int height = 0;
+
+        // E.g., DRM_FORMAT_R8 for just the Y plane of a YUV420 frame
+        uint32_t drm_fourcc = 0;
+    };
+
+    class GsGpuPreprocess {
+
+    public:
+        // The shared backend, created on first use.  nullptr if the build or the system has
+        // no OpenGL ES 3.1 compute support.
+        static GsGpuPreprocess* Instance();
+
+        ~GsGpuPreprocess();
+
+        // Sets gray_image (CV_8UC1, the size of frame) to cv::remap(frame, map1, map2, INTER_LINEAR)
+        // converted to grayscale.  frame is CV_8UC1 or (BGR) CV_8UC3.  The maps are any pair that
+        // cv::convertMaps accepts, and empty maps mean no undistortion.  If frame_buffer is not
+        // nullptr, it is frame's DMA-buf, and is read directly instead of uploading frame.
+        // gray_image's pixel buffer is re-used if it is already the right size and type.
+        // Returns false on any GPU error.  Safe to call from any thread - the calls are serialized.
+        bool UndistortToGray(const cv::Mat& frame,
+                             const GsGpuFrameBuffer* frame_buffer,
+                             const cv::Mat& map1,
+                             const cv::Mat& map2,
+                             cv::Mat& gray_image);
+
+    private:
+        GsGpuPreprocess() = default;
+
+        bool Initialize();
+
+        struct GpuState;
+        std::unique_ptr<GpuState> gpu_;
+        std::mutex mutex_;
+    };
+
+}
@@ -0,0 +1,520 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <string>
+
+#include "gs_gpu_spin_search.h"
+#include "logging_tools.h"
+
+#ifdef GS_USE_GPU_SPIN_SEARCH
+#include <epoxy/egl.h>
+#include <epoxy/gl.h>
+#endif
+
+namespace golf_sim {
+
+#ifdef GS_USE_GPU_SPIN_SEARCH
+
+    // Each rotation is its 3 sines and cosines and then its 3 rotating_on flags (1.0 or 0.0).
+    // Must match the scatter shader.
+    static const int kFloatsPerRotation = 9;
+
+    // The winner buffer holds rows * cols entries per candidate, so the candidates are
+    // dispatched in batches that keep it to about this size
+    static const size_t kMaxWinnerBufferBytes = 32 * 1024 * 1024;
+
+    // Must match local_size_x in the scatter shader
+    static const GLuint kScatterLocalSize = 64;
+
+    // One invocation per (source pixel, candidate).  Rotates the pixel exactly as
+    // projectionOp::rotatedDestination does, and records it (as index + 1) in the
+    // destination pixel that it lands on.  As in the serial projection loop, the
+    // highest (i.e., last) source index that lands on a pixel wins, and a source
+    // pixel that is off the ball also marks its own position.
+    static const char* kScatterShaderSource = R"(#version 310 es
+layout(local_size_x = 64) in;
+
+layout(std430, binding = 0) readonly buffer Hemisphere { vec4 hemisphere[]; };
+layout(std430, binding = 1) readonly buffer Rotations { float rotations[]; };
+layout(std430, binding = 2) buffer Winners { uint winners[]; };
+
+uniform int u_rows;
+uniform int u_cols;
+uniform int u_first_rotation;
+uniform float u_center_x;
+uniform float u_center_y;
+uniform float u_radius;
+
+void main() {
+    int num_pixels = u_rows * u_cols;
+    int i = int(gl_GlobalInvocationID.x);
+    int c = int(gl_GlobalInvocationID.y);
+
+    if (i >= num_pixels) {
+        return;
+    }
+
+    int r = (u_first_rotation + c) * 9;
+    uint base = uint(c) * uint(num_pixels);
+
+    float image_z = hemisphere[i].z;
+    bool source_not_valid = (image_z <= 0.0001);
+
+    if (source_not_valid) {
+        atomicMax(winners[base + uint(i)], uint(i + 1));
+    }
+
+    float x = hemisphere[i].x;
+    float y = hemisphere[i].y;
+
+    if (rotations[r + 6] > 0.5) {
+        float tmp_y = y;
+        y = (y * rotations[r + 1]) - (image_z * rotations[r + 0]);
+        image_z = float(int((tmp_y * rotations[r + 0]) + (image_z * rotations[r + 1])));
+    }
+
+    if (rotations[r + 7] > 0.5) {
+        float tmp_x = x;
+        x = (x * rotations[r + 3]) + (image_z * rotations[r + 2]);
+        image_z = float(int((image_z * rotations[r + 3]) - (tmp_x * rotations[r + 2])));
+    }
+
+    if (rotations[r + 8] > 0.5) {
+        float tmp_x = x;
+        x = (x * rotations[r + 5]) - (y * rotations[r + 4]);
+        y = (tmp_x * rotations[r + 4]) + (y * rotations[r + 5]);
+    }
+
+    float image_x = x + u_center_x;
+    float image_y = y + u_center_y;
+    float dest_x = image_x - u_center_x;
+    float dest_y = image_y - u_center_y;
+    bool visible = (dest_x * dest_x + dest_y * dest_y) < (u_radius * u_radius);
+
+    if (image_x >= 0.0 && image_y >= 0.0 && image_x < float(u_cols) && image_y < float(u_rows) && visible) {
+        int destination = int(image_x + 0.5) * u_cols + int(image_y + 0.5);
+
+        if (destination < num_pixels) {
+            atomicMax(winners[base + uint(destination)], uint(i + 1));
+        }
+    }
+}
+)";
+
+    // One work group per candidate.  Compares the projected pixels with the target
+    // as CompareRotationImage does, and clears the winners for the next batch.
+    // The source pixels are followed by the target pixels.
+    static const char* kScoreShaderSource = R"(#version 310 es
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) readonly buffer Hemisphere { vec4 hemisphere[]; };
+layout(std430, binding = 2) buffer Winners { uint winners[]; };
+layout(std430, binding = 3) readonly buffer Pixels { uint pixels[]; };
+layout(std430, binding = 4) writeonly buffer Counts { int counts[]; };
+
+uniform int u_rows;
+uniform int u_cols;
+uniform int u_first_rotation;
+uniform uint u_ignore_value;
+
+shared int matching[256];
+shared int examined[256];
+
+void main() {
+    int num_pixels = u_rows * u_cols;
+    int c = int(gl_WorkGroupID.x);
+    uint base = uint(c) * uint(num_pixels);
+    int local_id = int(gl_LocalInvocationID.x);
+
+    int local_matching = 0;
+    int local_examined = 0;
+
+    for (int d = local_id; d < num_pixels; d += 256) {
+        uint winner = winners[base + uint(d)];
+        winners[base + uint(d)] = 0u;
+
+        uint p2 = u_ignore_value;
+        if (winner != 0u && hemisphere[winner - 1u].z > 0.0001) {
+            p2 = pixels[winner - 1u];
+        }
+
+        uint p1 = pixels[uint(num_pixels + d)];
+
+        if (p1 != u_ignore_value && p2 != u_ignore_value) {
+            local_examined++;
+            if (p1 == p2) {
+                local_matching++;
+            }
+        }
+    }
+
+    matching[local_id] = local_matching;
+    examined[local_id] = local_examined;
+    barrier();
+
+    for (int stride = 128; stride > 0; stride >>= 1) {
+        if (local_id < stride) {
+            matching[local_id] += matching[local_id + stride];
+            examined[local_id] += examined[local_id + stride];
+        }
+        barrier();
+    }
+
+    if (local_id == 0) {
+        counts[(u_first_rotation + c) * 2] = matching[0];
+        counts[(u_first_rotation + c) * 2 + 1] = examined[0];
+    }
+}
+)";
+
+    struct GsGpuSpinSearch::GpuState {
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLContext context = EGL_NO_CONTEXT;
+
+        GLuint scatter_program = 0;
+        GLuint score_program = 0;
+
+        // Indexed by the binding points in the shaders
+        static const int kNumberOfBuffers = 5;
+        GLuint buffers[kNumberOfBuffers] = {};
+
+        // In winner entries
+        size_t winner_buffer_size = 0;
+    };
+
+    // OpenGL ES 3.1 only guarantees 4 storage blocks per shader, hence the packing
+    enum GpuBufferBinding {
+        kHemisphereBinding = 0,
+        kRotationsBinding = 1,
+        kWinnersBinding = 2,
+        kPixelsBinding = 3,
+        kCountsBinding = 4,
+    };
+
+    static GLuint CompileComputeProgram(const char* source, const std::string& name) {
+
+        GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+
+        GLint ok = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+
+        if (ok != GL_TRUE) {
+            char log[1024] = {};
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            GS_LOG_MSG(warning, "Could not compile the " + name + " GPU spin search shader: " + std::string(log));
+            glDeleteShader(shader);
+            return 0;
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, shader);
+        glLinkProgram(program);
+        glDeleteShader(shader);
+
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+
+        if (ok != GL_TRUE) {
+            char log[1024] = {};
+            glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+            GS_LOG_MSG(warning, "Could not link the " + name + " GPU spin search shader: " + std::string(log));
+            glDeleteProgram(program);
+            return 0;
+        }
+
+        return program;
+    }
+
+    static void UploadBuffer(GLuint buffer, const void* data, size_t bytes) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)bytes, data, GL_DYNAMIC_DRAW);
+    }
+
+    // The shaders index the pixels as uints
+    static void AppendShaderPixels(const cv::Mat& image, std::vector<GLuint>& pixels) {
+        for (int row = 0; row < image.rows; row++) {
+            const uchar* p = image.ptr<uchar>(row);
+            pixels.insert(pixels.end(), p, p + image.cols);
+        }
+    }
+
+    bool GsGpuSpinSearch::Initialize() {
+
+        auto gpu = std::make_unique<GpuState>();
+
+        // A surfaceless display needs no window system, e.g., when running headless over ssh
+        if (epoxy_has_egl_extension(EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless")) {
+            gpu->display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+
+        if (gpu->display == EGL_NO_DISPLAY) {
+            gpu->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        EGLint egl_major = 0;
+        EGLint egl_minor = 0;
+
+        if (gpu->display == EGL_NO_DISPLAY || !eglInitialize(gpu->display, &egl_major, &egl_minor)) {
+            GS_LOG_MSG(warning, "No EGL display for the GPU spin search.");
+            return false;
+        }
+
+        if (!epoxy_has_egl_extension(gpu->display, "EGL_KHR_surfaceless_context")) {
+            GS_LOG_MSG(warning, "The EGL display does not support surfaceless contexts, so there is no GPU spin search.");
+            eglTerminate(gpu->display);
+            return false;
+        }
+
+        eglBindAPI(EGL_OPENGL_ES_API);
+
+        EGLConfig config = EGL_NO_CONFIG_KHR;
+
+        if (!epoxy_has_egl_extension(gpu->display, "EGL_KHR_no_config_context")) {
+            // Any surface type will do, as the context never draws to one
+            const EGLint config_attribs[] = {
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+                EGL_SURFACE_TYPE, 0,
+                EGL_NONE
+            };
+            EGLint num_configs = 0;
+
+            if (!eglChooseConfig(gpu->display, config_attribs, &config, 1, &num_configs) || num_configs < 1) {
+                GS_LOG_MSG(warning, "No OpenGL ES 3 EGL config for the GPU spin search.");
+                eglTerminate(gpu->display);
+                return false;
+            }
+        }
+
+        const EGLint context_attribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 1,
+            EGL_NONE
+        };
+
+        gpu->context = eglCreateContext(gpu->display, config, EGL_NO_CONTEXT, context_attribs);
+
+        if (gpu->context == EGL_NO_CONTEXT || !eglMakeCurrent(gpu->display, EGL_NO_SURFACE, EGL_NO_SURFACE, gpu->context)) {
+            GS_LOG_MSG(warning, "Could not create an OpenGL ES 3.1 context for the GPU spin search.");
+            if (gpu->context != EGL_NO_CONTEXT) {
+                eglDestroyContext(gpu->display, gpu->context);
+            }
+            eglTerminate(gpu->display);
+            return false;
+        }
+
+        gpu->scatter_program = CompileComputeProgram(kScatterShaderSource, "scatter");
+        gpu->score_program = CompileComputeProgram(kScoreShaderSource, "score");
+
+        if (gpu->scatter_program == 0 || gpu->score_program == 0) {
+            glDeleteProgram(gpu->scatter_program);
+            glDeleteProgram(gpu->score_program);
+            eglMakeCurrent(gpu->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(gpu->display, gpu->context);
+            eglTerminate(gpu->display);
+            return false;
+        }
+
+        glGenBuffers(GpuState::kNumberOfBuffers, gpu->buffers);
+
+        GS_LOG_MSG(info, "GPU spin search is using " + std::string((const char*)glGetString(GL_RENDERER)) +
+                         " (" + std::string((const char*)glGetString(GL_VERSION)) + ").");
+
+        // The context is made current again by whichever thread runs the next search
+        eglMakeCurrent(gpu->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+        gpu_ = std::move(gpu);
+
+        return true;
+    }
+
+    GsGpuSpinSearch::~GsGpuSpinSearch() {
+
+        if (!gpu_) {
+            return;
+        }
+
+        eglMakeCurrent(gpu_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, gpu_->context);
+        glDeleteBuffers(GpuState::kNumberOfBuffers, gpu_->buffers);
+        glDeleteProgram(gpu_->scatter_program);
+        glDeleteProgram(gpu_->score_program);
+        eglMakeCurrent(gpu_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(gpu_->display, gpu_->context);
+        eglTerminate(gpu_->display);
+    }
+
+    GsGpuSpinSearch* GsGpuSpinSearch::Instance() {
+
+        // Never deleted, because the order of the EGL teardown at exit is not defined
+        static GsGpuSpinSearch* instance = []() -> GsGpuSpinSearch* {
+            GsGpuSpinSearch* gpu_search = new GsGpuSpinSearch();
+
+            if (!gpu_search->Initialize()) {
+                delete gpu_search;
+                return nullptr;
+            }
+
+            return gpu_search;
+        }();
+
+        return instance;
+    }
+
+    bool GsGpuSpinSearch::ScoreRotations(const cv::Mat& source_image,
+                                         const cv::Mat& target_image,
+                                         const GsGpuSpinProjection& projection,
+                                         const std::vector<GsGpuSpinRotation>& rotations,
+                                         std::vector<cv::Vec2i>& scores) {
+
+        CV_Assert((source_image.size() == target_image.size()));
+        CV_Assert((source_image.type() == CV_8UC1 && target_image.type() == CV_8UC1));
+
+        const int rows = source_image.rows;
+        const int cols = source_image.cols;
+        const size_t num_pixels = (size_t)rows * cols;
+        const int num_rotations = (int)rotations.size();
+
+        scores.assign(num_rotations, cv::Vec2i(0, 0));
+
+        if (num_rotations == 0 || num_pixels == 0) {
+            return true;
+        }
+
+        std::vector<GLfloat> rotation_values;
+        rotation_values.reserve((size_t)num_rotations * kFloatsPerRotation);
+
+        for (const GsGpuSpinRotation& rotation : rotations) {
+            rotation_values.insert(rotation_values.end(), { rotation.sin_x, rotation.cos_x, rotation.sin_y, rotation.cos_y,
+                                                            rotation.sin_z, rotation.cos_z,
+                                                            rotation.rotating_on_x ? 1.0f : 0.0f,
+                                                            rotation.rotating_on_y ? 1.0f : 0.0f,
+                                                            rotation.rotating_on_z ? 1.0f : 0.0f });
+        }
+
+        // x, y and z from center, and a pad
+        std::vector<GLfloat> hemisphere(num_pixels * 4, 0.0f);
+
+        for (size_t i = 0; i < num_pixels; i++) {
+            hemisphere[4 * i] = projection.x_from_center[i];
+            hemisphere[4 * i + 1] = projection.y_from_center[i];
+            hemisphere[4 * i + 2] = projection.z[i];
+        }
+
+        std::vector<GLuint> pixels;
+        pixels.reserve(2 * num_pixels);
+        AppendShaderPixels(source_image, pixels);
+        AppendShaderPixels(target_image, pixels);
+
+        const int batch_size = (int)std::max<size_t>(1, std::min<size_t>(num_rotations, kMaxWinnerBufferBytes / (num_pixels * sizeof(GLuint))));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!eglMakeCurrent(gpu_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, gpu_->context)) {
+            GS_LOG_MSG(warning, "Could not make the GPU spin search context current.");
+            return false;
+        }
+
+        GLuint* buffers = gpu_->buffers;
+
+        UploadBuffer(buffers[kHemisphereBinding], hemisphere.data(), hemisphere.size() * sizeof(GLfloat));
+        UploadBuffer(buffers[kRotationsBinding], rotation_values.data(), rotation_values.size() * sizeof(GLfloat));
+        UploadBuffer(buffers[kPixelsBinding], pixels.data(), pixels.size() * sizeof(GLuint));
+        UploadBuffer(buffers[kCountsBinding], nullptr, (size_t)num_rotations * 2 * sizeof(GLint));
+
+        // The score shader leaves the winners cleared, so they only need to be zeroed when the buffer is (re)allocated
+        const size_t winners_needed = (size_t)batch_size * num_pixels;
+
+        if (gpu_->winner_buffer_size < winners_needed) {
+            std::vector<GLuint> zeros(winners_needed, 0);
+            UploadBuffer(buffers[kWinnersBinding], zeros.data(), zeros.size() * sizeof(GLuint));
+            gpu_->winner_buffer_size = winners_needed;
+        }
+
+        for (int binding = 0; binding < GpuState::kNumberOfBuffers; binding++) {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffers[binding]);
+        }
+
+        for (int first_rotation = 0; first_rotation < num_rotations; first_rotation += batch_size) {
+            const int count = std::min(batch_size, num_rotations - first_rotation);
+
+            glUseProgram(gpu_->scatter_program);
+            glUniform1i(glGetUniformLocation(gpu_->scatter_program, "u_rows"), rows);
+            glUniform1i(glGetUniformLocation(gpu_->scatter_program, "u_cols"), cols);
+            glUniform1i(glGetUniformLocation(gpu_->scatter_program, "u_first_rotation"), first_rotation);
+            glUniform1f(glGetUniformLocation(gpu_->scatter_program, "u_center_x"), projection.center_x);
+            glUniform1f(glGetUniformLocation(gpu_->scatter_program, "u_center_y"), projection.center_y);
+            glUniform1f(glGetUniformLocation(gpu_->scatter_program, "u_radius"), projection.radius);
+            glDispatchCompute((GLuint)((num_pixels + kScatterLocalSize - 1) / kScatterLocalSize), (GLuint)count, 1);
+
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+            glUseProgram(gpu_->score_program);
+            glUniform1i(glGetUniformLocation(gpu_->score_program, "u_rows"), rows);
+            glUniform1i(glGetUniformLocation(gpu_->score_program, "u_cols"), cols);
+            glUniform1i(glGetUniformLocation(gpu_->score_program, "u_first_rotation"), first_rotation);
+            glUniform1ui(glGetUniformLocation(gpu_->score_program, "u_ignore_value"), projection.ignore_value);
+            glDispatchCompute((GLuint)count, 1, 1);
+
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
+
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        bool ok = true;
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[kCountsBinding]);
+        const GLint* counts = (const GLint*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0,
+                                                             (GLsizeiptr)((size_t)num_rotations * 2 * sizeof(GLint)), GL_MAP_READ_BIT);
+
+        if (counts == nullptr) {
+            ok = false;
+        }
+        else {
+            for (int i = 0; i < num_rotations; i++) {
+                scores[i] = cv::Vec2i(counts[2 * i], counts[2 * i + 1]);
+            }
+            glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+        }
+
+        GLenum error = glGetError();
+
+        if (error != GL_NO_ERROR) {
+            GS_LOG_MSG(warning, "GPU spin search failed with GL error " + std::to_string(error) + ".");
+            ok = false;
+        }
+
+        eglMakeCurrent(gpu_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+        return ok;
+    }
+
+#else
+
+    struct GsGpuSpinSearch::GpuState {
+    };
+
+    bool GsGpuSpinSearch::Initialize() {
+        return false;
+    }
+
+    GsGpuSpinSearch::~GsGpuSpinSearch() {
+    }
+
+    GsGpuSpinSearch* GsGpuSpinSearch::Instance() {
+        return nullptr;
+    }
+
+    bool GsGpuSpinSearch::ScoreRotations(const cv::Mat& source_image,
+                                         const cv::Mat& target_image,
+                                         const GsGpuSpinProjection& projection,
+                                         const std::vector<GsGpuSpinRotation>& rotations,
+                                         std::vector<cv::Vec2i>& scores) {
+        return false;
+    }
+
+#endif
+
+}
@@ -0,0 +1,88 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// An OpenGL ES 3.1 compute-shader backend for the spin rotation search.  Each rotation
+// candidate is projected and compared with the target ball image on the GPU (e.g., the
+// Pi 5's VideoCore VII), and only the per-candidate match counts are read back.
+//
+// The projection is the same as the serial Project2dImageTo3dBall loop: the (un-rotated)
+// hemisphere positions come from the CPU, the sines and cosines of each rotation are
+// computed on the CPU, and a destination pixel that several source pixels land on takes the
+// last of them in row-major order (an atomicMax of the source index).  Only the rotation
+// itself is evaluated in the shader, so the results can only differ from the CPU's where the
+// GPU's float rounding moves a pixel across a rounding boundary.  The comparisons are never
+// cut off early.
+//
+// Only built with -DGS_USE_GPU_SPIN_SEARCH (the enable_gpu_spin_search meson option, which
+// needs libepoxy).  Otherwise, or if no suitable GPU is found, Instance() is nullptr and the
+// CPU search is used.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    // One rotation to evaluate, with the values that projectionOp would use for it
+    struct GsGpuSpinRotation {
+        float sin_x = 0.0f;
+        float cos_x = 1.0f;
+        float sin_y = 0.0f;
+        float cos_y = 1.0f;
+        float sin_z = 0.0f;
+        float cos_z = 1.0f;
+        bool rotating_on_x = false;
+        bool rotating_on_y = false;
+        bool rotating_on_z = false;
+    };
+
+    // The un-rotated hemisphere position of each pixel of the source image, indexed by
+    // row * cols + col (see BallProjectionTable)
+    struct GsGpuSpinProjection {
+        const float* x_from_center = nullptr;
+        const float* y_from_center = nullptr;
+        const float* z = nullptr;
+        float center_x = 0.0f;
+        float center_y = 0.0f;
+        float radius = 0.0f;
+
+        // The pixel value that is never compared (kPixelIgnoreValue)
+        unsigned ignore_value = 0;
+    };
+
+    class GsGpuSpinSearch {
+
+    public:
+        // The shared backend, created on first use.  nullptr if the build or the system has
+        // no OpenGL ES 3.1 compute support.
+        static GsGpuSpinSearch* Instance();
+
+        ~GsGpuSpinSearch();
+
+        // Sets scores[i] to the (matching, examined) pixel counts of rotations[i], as
+        // BallImageProc::CompareRotationImage(target_image, <projected source_image>) would.
+        // Both images are CV_8UC1 and the same size.  Returns false on any GPU error.
+        // Safe to call from any thread - the calls are serialized.
+        bool ScoreRotations(const cv::Mat& source_image,
+                            const cv::Mat& target_image,
+                            const GsGpuSpinProjection& projection,
+                            const std::vector<GsGpuSpinRotation>& rotations,
+                            std::vector<cv::Vec2i>& scores);
+
+    private:
+        GsGpuSpinSearch() = default;
+
+        bool Initialize();
+
+        struct GpuState;
+        std::unique_ptr<GpuState> gpu_;
+        std::mutex mutex_;
+    };
+
+}
@@ -134,15 +134,23 @@ namespace golf_sim {
 
     bool GsGSProInterface::SendResults(const GsResults& input_results) {
 
+        if (BackgroundReconnectInProgress()) {
+            return ReconnectInBackground(input_results);
+        }
+
         if (!initialized_) {
             GS_LOG_MSG(error, "GsGSProInterface::SendResults called before the interface was intialized.");
             return false;
         }
 
-        if (receive_thread_exited_) {
+        if (receiver_stopped_) {
+            if (ReconnectInBackground(input_results)) {
+                return true;
+            }
+
             GS_LOG_MSG(error, "GsGSProInterface::SendResults called before the interface was intialized.");
 
-            // If we ended the receive thread, try re-initializing the connection
+            // If the receiver stopped, try re-initializing the connection
             DeInitialize();
             if (!Initialize()) {
                 GS_LOG_MSG(error, "GsGSProInterface::SendResults called before the interface was intialized.");
@@ -160,7 +168,9 @@ namespace golf_sim {
 
             std::string results_msg = results.Format();
 
-            size_t write_length = SendSimMessage(results_msg);
+            CacheShot(input_results);
+            size_t write_length = SendSimMessage(results_msg, input_results.result_message_is_keepalive_,
+                                                 input_results.result_message_is_keepalive_ ? 0 : input_results.shot_number_);
         }
         catch (std::exception& e)
         {
@@ -204,9 +214,12 @@ namespace golf_sim {
                 club_instruction = GsIPCControlMsgType::kUnknown;
             }
 
-            // The the instruction to switch clubs to the main FSM
-            GolfSimEventElement control_message{ new GolfSimEvent::ControlMessage{ club_instruction } };
-            GolfSimEventQueue::QueueEvent(control_message);
+            // Applied right here rather than through the FSM's event queue, so that the change is not
+            // held up behind a shot that is being analyzed
+            if (club_instruction != GsIPCControlMsgType::kUnknown) {
+                GS_LOG_TRACE_MSG(trace, "Applying control message: " + GsIPCControlMsg::FormatControlMessageType(club_instruction));
+                GsIPCControlMsg::Apply(club_instruction);
+            }
         }
         else {
             GS_LOG_MSG(info, "GsSimSocketInterface::ProcessReceivedData Received unknown GSPro result type.  Result was: \n" + gspro_response.Format());
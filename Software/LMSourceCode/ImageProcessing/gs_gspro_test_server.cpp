@@ -46,44 +46,51 @@ namespace golf_sim {
 
     void GsGSProConnection::Start()
     {
-        std::array<char, 2000> buf;
-        boost::system::error_code error;
-
-
-        std::string buffer_string;
-
-        while (true) {
-            GS_LOG_TRACE_MSG(trace, "About to read data.");
-            size_t len = socket_.read_some(boost::asio::buffer(buf), error);
-            if (len == 0) {
-                GS_LOG_MSG(warning, "Received a 0-length string from GSPro server.");
-            }
-            else {
-                // Null-terminate the string
-                buf[len] = (char)0;
-                buffer_string += std::string(buf.data());
-                GS_LOG_TRACE_MSG(trace, "   Read some data (" + std::to_string(len) + " bytes) : " + buffer_string);
-            }
-
-            if (error == boost::asio::error::eof) {
-                GS_LOG_MSG(error, "Received unexpected EOF from the Launch Monitor.");
-                return; // Connection closed cleanly by peer.
-            }
-            else if (error) {
-                GS_LOG_MSG(error, "Received unexpected error from the Launch Monitor.");
-                throw boost::system::system_error(error); // Some other error.
-            }
-
-            GS_LOG_TRACE_MSG(trace, "Received the following message from the Launch Monitor: " + buffer_string);
-
-            message_ = GenerateResponseString();
-
-            GS_LOG_TRACE_MSG(trace, "Sending the following message from the GSPro simulated server: " + message_);
-            boost::asio::async_write(socket_, boost::asio::buffer(message_),
-                boost::bind(&GsGSProConnection::HandleWrite, shared_from_this(),
-                    boost::asio::placeholders::error,
-                    boost::asio::placeholders::bytes_transferred));
+        StartRead();
+    }
+
+    void GsGSProConnection::StartRead()
+    {
+        GS_LOG_TRACE_MSG(trace, "About to read data.");
+
+        // The handler's reference keeps this connection alive until the launch monitor goes away
+        socket_.async_read_some(boost::asio::buffer(read_buffer_),
+            boost::bind(&GsGSProConnection::HandleRead, shared_from_this(),
+                boost::asio::placeholders::error,
+                boost::asio::placeholders::bytes_transferred));
+    }
+
+    void GsGSProConnection::HandleRead(const boost::system::error_code& error, size_t bytes_transferred)
+    {
+        if (error == boost::asio::error::eof) {
+            GS_LOG_MSG(error, "Received unexpected EOF from the Launch Monitor.");
+            return; // Connection closed cleanly by peer.
+        }
+        else if (error) {
+            GS_LOG_MSG(error, "Received unexpected error from the Launch Monitor: " + error.message());
+            return;
         }
+
+        GS_LOG_TRACE_MSG(trace, "   Read some data (" + std::to_string(bytes_transferred) + " bytes)");
+
+        framer_.Append(read_buffer_.data(), bytes_transferred);
+
+        std::string received_message;
+
+        while (framer_.NextMessage(received_message)) {
+            GS_LOG_TRACE_MSG(trace, "Received the following message from the Launch Monitor: " + received_message);
+
+            // Each write has its own buffer, as a later message may arrive before the last reply is written
+            std::shared_ptr<std::string> response = std::make_shared<std::string>(GenerateResponseString());
+
+            GS_LOG_TRACE_MSG(trace, "Sending the following message from the GSPro simulated server: " + *response);
+            boost::asio::async_write(socket_, boost::asio::buffer(*response),
+                [self = shared_from_this(), response](const boost::system::error_code& error, size_t bytes_transferred) {
+                    self->HandleWrite(error, bytes_transferred);
+                });
+        }
+
+        StartRead();
     }
 
     GsGSProConnection::GsGSProConnection(boost::asio::io_context& io_context, int port_number)
@@ -3,15 +3,20 @@
  * Copyright (C) 2022-2025, Verdant Consultants, LLC.
  */
 
-// Just for testing.  This class simulates the GSPro golf simulator interface.
+// Just for testing.  This class simulates the GSPro golf simulator interface.  It runs on the
+// GsSimSocketReactor's io_context, like the simulator connections, and answers each complete
+// message from the launch monitor with a player-information response.
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <iostream>
 #include <boost/asio.hpp>
 #include <boost/bind/bind.hpp>
 
+#include "gs_sim_socket_reactor.h"
+
 using boost::asio::ip::tcp;
 
 
@@ -33,10 +38,15 @@ namespace golf_sim {
     private:
         GsGSProConnection(boost::asio::io_context& io_context, int port_number);
 
+        void StartRead();
+
+        void HandleRead(const boost::system::error_code& error, size_t bytes_transferred);
+
         void HandleWrite(const boost::system::error_code& error, size_t bytes_transferred);
 
         tcp::socket socket_;
-        std::string message_;
+        std::array<char, 2000> read_buffer_;
+        GsSimMessageFramer framer_;
     };
 
     class GsGSProTestServer
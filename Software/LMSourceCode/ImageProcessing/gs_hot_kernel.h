@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// GS_HOT_KERNEL marks the few pixel loops that dominate a shot's processing time
+// (motion detection, the spin rotation comparison and the Gabor accumulation).
+// When meson is configured with -Denable_function_multiversioning=true, each one is
+// compiled once per listed feature level plus a baseline version, and the dynamic
+// loader picks the best one for the CPU it is running on.  That lets a
+// -Dtarget_board=generic binary use the Pi 5's extra instructions and still run on a Pi 4.
+// Otherwise GS_HOT_KERNEL does nothing.
+
+#pragma once
+
+#if defined(GS_USE_FUNCTION_MULTIVERSIONING) && defined(__aarch64__)
+#define GS_HOT_KERNEL __attribute__((target_clones("dotprod", "default")))
+#elif defined(GS_USE_FUNCTION_MULTIVERSIONING) && defined(__x86_64__)
+#define GS_HOT_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define GS_HOT_KERNEL
+#endif
@@ -0,0 +1,939 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/tokenizer.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_config_reload.h"
+#include "gs_camera.h"
+#include "gs_performance_state.h"
+#include "gs_shot_archive.h"
+
+#include "gs_hough_sweep.h"
+
+namespace golf_sim {
+
+    std::string GsHoughSweep::kHoughSweepLabelsCSV;
+    std::string GsHoughSweep::kHoughSweepResultsFile;
+    int GsHoughSweep::kHoughSweepThreads = 0;
+    double GsHoughSweep::kHoughSweepMaxCenterErrorRatio = 0.5;
+
+    std::vector<float> GsHoughSweep::kHoughSweepPreHoughBlurSizes;
+    std::vector<float> GsHoughSweep::kHoughSweepCannyLowers;
+    std::vector<float> GsHoughSweep::kHoughSweepCannyUppers;
+    std::vector<float> GsHoughSweep::kHoughSweepDps;
+    std::vector<float> GsHoughSweep::kHoughSweepStartingParam2s;
+    std::vector<float> GsHoughSweep::kHoughSweepUseCLAHE;
+
+    std::string GsHoughSweep::kHoughAutotuneShotArchive;
+    int GsHoughSweep::kHoughAutotuneMaxShots = 50;
+    double GsHoughSweep::kHoughAutotuneMinAccuracy = 0.98;
+    double GsHoughSweep::kHoughAutotuneMinSpeedup = 0.03;
+    int GsHoughSweep::kHoughAutotunePasses = 3;
+    std::string GsHoughSweep::kHoughAutotuneProposalFile = "PiTrac_Hough_Autotune.json";
+    bool GsHoughSweep::kHoughAutotuneApply = false;
+
+    // The configured values, which a negative sweep value stands for, and which are put
+    // back when the sweep is done
+    struct HoughSweepConstants {
+        int placed_pre_hough_blur_size;
+        double placed_canny_lower;
+        double placed_canny_upper;
+        double placed_dp;
+        double placed_starting_param2;
+
+        int strobed_pre_hough_blur_size;
+        double strobed_canny_lower;
+        double strobed_canny_upper;
+        double strobed_dp;
+        double strobed_starting_param2;
+        bool strobed_use_clahe;
+
+        std::string placement_detection_method;
+        std::string strobed_detection_method;
+        bool use_hough_parameter_memory;
+
+        double placed_param2_increment;
+        double strobed_param2_increment;
+        bool strobed_use_alt_hough;
+        int strobed_alt_pre_hough_blur_size;
+        double strobed_alt_canny_lower;
+        double strobed_alt_canny_upper;
+        double strobed_alt_dp;
+        double strobed_alt_starting_param2;
+        double strobed_alt_param2_increment;
+
+        static HoughSweepConstants Read() {
+            return { BallImageProc::kPlacedPreHoughBlurSize, BallImageProc::kPlacedBallCannyLower, BallImageProc::kPlacedBallCannyUpper,
+                     BallImageProc::kPlacedBallHoughDpParam1, BallImageProc::kPlacedBallStartingParam2,
+                     BallImageProc::kStrobedBallsPreHoughBlurSize, BallImageProc::kStrobedBallsCannyLower, BallImageProc::kStrobedBallsCannyUpper,
+                     BallImageProc::kStrobedBallsHoughDpParam1, BallImageProc::kStrobedBallsStartingParam2, BallImageProc::kUseCLAHEProcessing,
+                     BallImageProc::kBallPlacementDetectionMethod, BallImageProc::kStrobedBallDetectionMethod,
+                     BallImageProc::kUseHoughParameterMemory,
+                     BallImageProc::kPlacedBallParam2Increment, BallImageProc::kStrobedBallsParam2Increment,
+                     BallImageProc::kStrobedBallsUseAltHoughAlgorithm, BallImageProc::kStrobedBallsAltPreHoughBlurSize,
+                     BallImageProc::kStrobedBallsAltCannyLower, BallImageProc::kStrobedBallsAltCannyUpper,
+                     BallImageProc::kStrobedBallsAltHoughDpParam1, BallImageProc::kStrobedBallsAltStartingParam2,
+                     BallImageProc::kStrobedBallsAltParam2Increment };
+        }
+
+        void Write() const {
+            BallImageProc::kPlacedPreHoughBlurSize = placed_pre_hough_blur_size;
+            BallImageProc::kPlacedBallCannyLower = placed_canny_lower;
+            BallImageProc::kPlacedBallCannyUpper = placed_canny_upper;
+            BallImageProc::kPlacedBallHoughDpParam1 = placed_dp;
+            BallImageProc::kPlacedBallStartingParam2 = placed_starting_param2;
+            BallImageProc::kStrobedBallsPreHoughBlurSize = strobed_pre_hough_blur_size;
+            BallImageProc::kStrobedBallsCannyLower = strobed_canny_lower;
+            BallImageProc::kStrobedBallsCannyUpper = strobed_canny_upper;
+            BallImageProc::kStrobedBallsHoughDpParam1 = strobed_dp;
+            BallImageProc::kStrobedBallsStartingParam2 = strobed_starting_param2;
+            BallImageProc::kUseCLAHEProcessing = strobed_use_clahe;
+            BallImageProc::kBallPlacementDetectionMethod = placement_detection_method;
+            BallImageProc::kStrobedBallDetectionMethod = strobed_detection_method;
+            BallImageProc::kUseHoughParameterMemory = use_hough_parameter_memory;
+            BallImageProc::kPlacedBallParam2Increment = placed_param2_increment;
+            BallImageProc::kStrobedBallsParam2Increment = strobed_param2_increment;
+            BallImageProc::kStrobedBallsUseAltHoughAlgorithm = strobed_use_alt_hough;
+            BallImageProc::kStrobedBallsAltPreHoughBlurSize = strobed_alt_pre_hough_blur_size;
+            BallImageProc::kStrobedBallsAltCannyLower = strobed_alt_canny_lower;
+            BallImageProc::kStrobedBallsAltCannyUpper = strobed_alt_canny_upper;
+            BallImageProc::kStrobedBallsAltHoughDpParam1 = strobed_alt_dp;
+            BallImageProc::kStrobedBallsAltStartingParam2 = strobed_alt_starting_param2;
+            BallImageProc::kStrobedBallsAltParam2Increment = strobed_alt_param2_increment;
+        }
+    };
+
+    static HoughSweepConstants configured_constants;
+
+
+    // Same as the latency bench's sweep lists, except that an empty list stands for the configured value
+    static void LoadSweepValues(const std::string& tag_name, std::vector<float>& values) {
+        values.clear();
+        GolfSimConfiguration::SetConstant(tag_name, values);
+
+        if (values.empty()) {
+            values.push_back(-1);
+        }
+    }
+
+    void GsHoughSweep::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughSweepLabelsCSV", kHoughSweepLabelsCSV);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughSweepResultsFile", kHoughSweepResultsFile);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughSweepThreads", kHoughSweepThreads);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughSweepMaxCenterErrorRatio", kHoughSweepMaxCenterErrorRatio);
+
+        LoadSweepValues("gs_config.testing.kHoughSweepPreHoughBlurSizes", kHoughSweepPreHoughBlurSizes);
+        LoadSweepValues("gs_config.testing.kHoughSweepCannyLowers", kHoughSweepCannyLowers);
+        LoadSweepValues("gs_config.testing.kHoughSweepCannyUppers", kHoughSweepCannyUppers);
+        LoadSweepValues("gs_config.testing.kHoughSweepDps", kHoughSweepDps);
+        LoadSweepValues("gs_config.testing.kHoughSweepStartingParam2s", kHoughSweepStartingParam2s);
+        LoadSweepValues("gs_config.testing.kHoughSweepUseCLAHE", kHoughSweepUseCLAHE);
+
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughAutotuneShotArchive", kHoughAutotuneShotArchive);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughAutotuneMaxShots", kHoughAutotuneMaxShots);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughAutotuneMinAccuracy", kHoughAutotuneMinAccuracy);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughAutotuneMinSpeedup", kHoughAutotuneMinSpeedup);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughAutotunePasses", kHoughAutotunePasses);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughAutotuneProposalFile", kHoughAutotuneProposalFile);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kHoughAutotuneApply", kHoughAutotuneApply);
+
+        if (kHoughSweepThreads <= 0) {
+            kHoughSweepThreads = std::max(1, (int)std::thread::hardware_concurrency());
+        }
+
+        kHoughAutotuneMaxShots = std::max(kHoughAutotuneMaxShots, 1);
+        kHoughAutotuneMinAccuracy = std::clamp(kHoughAutotuneMinAccuracy, 0.0, 1.0);
+        kHoughAutotuneMinSpeedup = std::clamp(kHoughAutotuneMinSpeedup, 0.0, 0.9);
+        kHoughAutotunePasses = std::max(kHoughAutotunePasses, 1);
+    }
+
+    bool GsHoughSweep::ReadLabels(const std::string& labels_filename, std::vector<LabeledImage>& images) {
+
+        std::ifstream file(labels_filename);
+        std::string line;
+
+        if (!file.is_open()) {
+            GS_LOG_MSG(error, "GsHoughSweep - could not open labels file: " + labels_filename);
+            return false;
+        }
+
+        // Skip the column headings
+        if (!std::getline(file, line)) {
+            GS_LOG_MSG(error, "GsHoughSweep - labels file " + labels_filename + " was empty.");
+            return false;
+        }
+
+        const std::filesystem::path labels_directory = std::filesystem::path(labels_filename).parent_path();
+
+        while (std::getline(file, line)) {
+
+            boost::tokenizer<boost::escaped_list_separator<char>> tok(line, boost::escaped_list_separator<char>('\\', ',', '"'));
+            std::vector<std::string> fields;
+
+            for (const auto& t : tok) {
+                std::string field = t;
+                field.erase(0, field.find_first_not_of(" \t"));
+                field.erase(field.find_last_not_of(" \t\r") + 1);
+                fields.push_back(field);
+            }
+
+            if (fields.size() < 5 || fields[0].empty()) {
+                continue;
+            }
+
+            BallImageProc::BallSearchMode search_mode;
+
+            if (fields[1] == "placed") {
+                search_mode = BallImageProc::kFindPlacedBall;
+            }
+            else if (fields[1] == "strobed") {
+                search_mode = BallImageProc::kStrobed;
+            }
+            else {
+                GS_LOG_MSG(error, "GsHoughSweep - unknown search mode '" + fields[1] + "' for " + fields[0]);
+                return false;
+            }
+
+            const std::string filename = (labels_directory / fields[0]).string();
+
+            cv::Vec3f ball;
+            try {
+                ball = cv::Vec3f(std::stof(fields[2]), std::stof(fields[3]), std::stof(fields[4]));
+            }
+            catch (std::exception&) {
+                GS_LOG_MSG(error, "GsHoughSweep - could not read the ball of line: " + line);
+                return false;
+            }
+
+            // The balls of one image are listed together
+            if (images.empty() || images.back().filename != filename) {
+                LabeledImage image;
+                image.filename = filename;
+                image.search_mode = search_mode;
+                image.img = cv::imread(filename, cv::IMREAD_COLOR);
+
+                if (image.img.empty()) {
+                    GS_LOG_MSG(error, "GsHoughSweep - could not read image " + filename);
+                    return false;
+                }
+
+                images.push_back(image);
+            }
+
+            images.back().balls.push_back(ball);
+        }
+
+        return !images.empty();
+    }
+
+    bool GsHoughSweep::ReadArchivedShots(const std::string& archive_filename, std::vector<LabeledImage>& images) {
+
+        GsShotArchiveReader reader;
+
+        if (!reader.Open(archive_filename)) {
+            GS_LOG_MSG(error, "GsHoughSweep - could not open shot archive: " + archive_filename);
+            return false;
+        }
+
+        const std::vector<GsArchivedShot>& shots = reader.GetShots();
+        const size_t first_shot = (shots.size() > (size_t)kHoughAutotuneMaxShots) ? shots.size() - kHoughAutotuneMaxShots : 0;
+
+        for (size_t i = first_shot; i < shots.size(); i++) {
+            const GsArchivedShot& shot = shots[i];
+
+            cv::Mat teed_ball_img;
+            cv::Mat strobed_balls_img;
+
+            if (!reader.GetFrame(shot.teed_ball_frame_name, teed_ball_img) ||
+                !reader.GetFrame(shot.strobed_balls_frame_name, strobed_balls_img)) {
+                GS_LOG_MSG(warning, "GsHoughSweep - the shot archive has no images for shot " + shot.name);
+                continue;
+            }
+
+            GolfBall result_ball;
+            cv::Vec3d rotation_results;
+            cv::Mat exposures_image;
+            cv::Mat no_pre_image;
+            std::vector<GolfBall> exposure_balls;
+
+            if (!GolfSimCamera::ProcessReceivedCam2Image(teed_ball_img, strobed_balls_img, no_pre_image, result_ball,
+                                                         rotation_results, exposures_image, exposure_balls) || exposure_balls.empty()) {
+                GS_LOG_TRACE_MSG(trace, "GsHoughSweep - the configured analysis found no balls in shot " + shot.name + ".  Skipping it.");
+                continue;
+            }
+
+            LabeledImage image;
+            image.filename = shot.name;
+            image.search_mode = BallImageProc::kStrobed;
+            // The archive's frames are only valid while it is open
+            image.img = strobed_balls_img.clone();
+
+            for (const GolfBall& ball : exposure_balls) {
+                image.balls.push_back(cv::Vec3f(ball.ball_circle_[0], ball.ball_circle_[1], ball.ball_circle_[2]));
+            }
+
+            images.push_back(image);
+        }
+
+        GS_LOG_MSG(info, "GsHoughSweep - labeled " + std::to_string(images.size()) + " of the last " +
+                         std::to_string(shots.size() - first_shot) + " shot(s) in " + archive_filename);
+
+        return !images.empty();
+    }
+
+    void GsHoughSweep::ApplySweepPoint(const SweepPoint& point) {
+
+        const HoughSweepConstants& c = configured_constants;
+
+        BallImageProc::kPlacedPreHoughBlurSize = (point.pre_hough_blur_size < 0) ? c.placed_pre_hough_blur_size : point.pre_hough_blur_size;
+        BallImageProc::kPlacedBallCannyLower = (point.canny_lower < 0) ? c.placed_canny_lower : point.canny_lower;
+        BallImageProc::kPlacedBallCannyUpper = (point.canny_upper < 0) ? c.placed_canny_upper : point.canny_upper;
+        BallImageProc::kPlacedBallHoughDpParam1 = (point.dp < 0) ? c.placed_dp : point.dp;
+        BallImageProc::kPlacedBallStartingParam2 = (point.starting_param2 < 0) ? c.placed_starting_param2 : point.starting_param2;
+        BallImageProc::kPlacedBallParam2Increment = (point.param2_increment < 0) ? c.placed_param2_increment : point.param2_increment;
+
+        const bool use_alt_hough = (point.use_alt_hough < 0) ? c.strobed_use_alt_hough : (point.use_alt_hough != 0);
+        BallImageProc::kStrobedBallsUseAltHoughAlgorithm = use_alt_hough;
+
+        // The strobed values only go to the Hough algorithm that the strobed search will use
+        const SweepPoint configured_point;
+        const SweepPoint& hough_point = use_alt_hough ? configured_point : point;
+        const SweepPoint& alt_hough_point = use_alt_hough ? point : configured_point;
+
+        BallImageProc::kStrobedBallsPreHoughBlurSize = (hough_point.pre_hough_blur_size < 0) ? c.strobed_pre_hough_blur_size : hough_point.pre_hough_blur_size;
+        BallImageProc::kStrobedBallsCannyLower = (hough_point.canny_lower < 0) ? c.strobed_canny_lower : hough_point.canny_lower;
+        BallImageProc::kStrobedBallsCannyUpper = (hough_point.canny_upper < 0) ? c.strobed_canny_upper : hough_point.canny_upper;
+        BallImageProc::kStrobedBallsHoughDpParam1 = (hough_point.dp < 0) ? c.strobed_dp : hough_point.dp;
+        BallImageProc::kStrobedBallsStartingParam2 = (hough_point.starting_param2 < 0) ? c.strobed_starting_param2 : hough_point.starting_param2;
+        BallImageProc::kStrobedBallsParam2Increment = (hough_point.param2_increment < 0) ? c.strobed_param2_increment : hough_point.param2_increment;
+
+        BallImageProc::kStrobedBallsAltPreHoughBlurSize = (alt_hough_point.pre_hough_blur_size < 0) ? c.strobed_alt_pre_hough_blur_size : alt_hough_point.pre_hough_blur_size;
+        BallImageProc::kStrobedBallsAltCannyLower = (alt_hough_point.canny_lower < 0) ? c.strobed_alt_canny_lower : alt_hough_point.canny_lower;
+        BallImageProc::kStrobedBallsAltCannyUpper = (alt_hough_point.canny_upper < 0) ? c.strobed_alt_canny_upper : alt_hough_point.canny_upper;
+        BallImageProc::kStrobedBallsAltHoughDpParam1 = (alt_hough_point.dp < 0) ? c.strobed_alt_dp : alt_hough_point.dp;
+        BallImageProc::kStrobedBallsAltStartingParam2 = (alt_hough_point.starting_param2 < 0) ? c.strobed_alt_starting_param2 : alt_hough_point.starting_param2;
+        BallImageProc::kStrobedBallsAltParam2Increment = (alt_hough_point.param2_increment < 0) ? c.strobed_alt_param2_increment : alt_hough_point.param2_increment;
+
+        BallImageProc::kUseCLAHEProcessing = (point.use_clahe < 0) ? c.strobed_use_clahe : (point.use_clahe != 0);
+    }
+
+    GsHoughSweep::ImageResult GsHoughSweep::EvaluateImage(const LabeledImage& image) {
+
+        ImageResult result;
+
+        // As in GetCalibratedBall, each search has its own processor with the search radii around
+        // the expected (here, the labeled) radius
+        BallImageProc ball_image_proc;
+        ball_image_proc.image_name_ = image.filename;
+        ball_image_proc.ball_.ball_color_ = GolfBall::BallColor::kUnknown;
+
+        float min_radius = image.balls[0][2];
+        float max_radius = image.balls[0][2];
+        for (const cv::Vec3f& ball : image.balls) {
+            min_radius = std::min(min_radius, ball[2]);
+            max_radius = std::max(max_radius, ball[2]);
+        }
+
+        ball_image_proc.min_ball_radius_ = std::max(0, (int)std::round(min_radius) - GolfSimCamera::kMinRadiusOffset);
+        ball_image_proc.max_ball_radius_ = (int)max_radius + GolfSimCamera::kMaxRadiusOffset;
+
+        // A placed ball is searched for only around where it is expected.  Strobed balls could be anywhere.
+        cv::Rect roi;
+        if (image.search_mode == BallImageProc::kFindPlacedBall) {
+            const double search_area_radius = ball_image_proc.max_ball_radius_ * 1.1;
+            roi = cv::Rect((int)(image.balls[0][0] - search_area_radius), (int)(image.balls[0][1] - search_area_radius),
+                           (int)(2. * search_area_radius), (int)(2. * search_area_radius)) & cv::Rect(0, 0, image.img.cols, image.img.rows);
+        }
+
+        GolfBall search_ball;
+        std::vector<GolfBall> found_balls;
+
+        const auto start_time = std::chrono::steady_clock::now();
+        const bool found = ball_image_proc.GetBall(image.img, search_ball, found_balls, roi, image.search_mode, false, false);
+        result.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+        if (!found) {
+            found_balls.clear();
+        }
+
+        // Only the best ball is used for a placed ball
+        if (image.search_mode == BallImageProc::kFindPlacedBall && found_balls.size() > 1) {
+            found_balls.resize(1);
+        }
+
+        std::vector<bool> matched(found_balls.size(), false);
+
+        for (const cv::Vec3f& ball : image.balls) {
+            int best_index = -1;
+            double best_distance = kHoughSweepMaxCenterErrorRatio * ball[2];
+
+            for (size_t i = 0; i < found_balls.size(); i++) {
+                const double distance = std::hypot(found_balls[i].ball_circle_[0] - ball[0], found_balls[i].ball_circle_[1] - ball[1]);
+                if (!matched[i] && distance <= best_distance) {
+                    best_index = (int)i;
+                    best_distance = distance;
+                }
+            }
+
+            if (best_index >= 0) {
+                matched[best_index] = true;
+                result.found_balls++;
+                result.center_error_px += best_distance;
+                result.radius_error_px += std::abs(found_balls[best_index].ball_circle_[2] - ball[2]);
+            }
+        }
+
+        result.false_positives = (int)std::count(matched.begin(), matched.end(), false);
+
+        return result;
+    }
+
+    GsHoughSweep::SweepResult GsHoughSweep::EvaluateSweepPoint(const SweepPoint& point, const std::vector<LabeledImage>& images, int num_threads) {
+
+        ApplySweepPoint(point);
+
+        std::vector<ImageResult> image_results(images.size());
+        std::atomic<size_t> next_image{ 0 };
+
+        auto evaluate_images = [&]() {
+            for (size_t i = next_image++; i < images.size(); i = next_image++) {
+                image_results[i] = EvaluateImage(images[i]);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < num_threads; i++) {
+            workers.emplace_back(evaluate_images);
+        }
+        evaluate_images();
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        SweepResult result;
+        result.point = point;
+
+        std::vector<double> times_ms;
+        double center_error_px = 0.0;
+        double radius_error_px = 0.0;
+
+        for (size_t i = 0; i < images.size(); i++) {
+            result.labeled_balls += (int)images[i].balls.size();
+            result.found_balls += image_results[i].found_balls;
+            result.false_positives += image_results[i].false_positives;
+            center_error_px += image_results[i].center_error_px;
+            radius_error_px += image_results[i].radius_error_px;
+            times_ms.push_back(image_results[i].elapsed_ms);
+            result.mean_ms += image_results[i].elapsed_ms;
+        }
+
+        if (result.found_balls > 0) {
+            result.mean_center_error_px = center_error_px / result.found_balls;
+            result.mean_radius_error_px = radius_error_px / result.found_balls;
+        }
+
+        std::sort(times_ms.begin(), times_ms.end());
+        result.median_ms = times_ms[times_ms.size() / 2];
+        result.mean_ms /= times_ms.size();
+
+        return result;
+    }
+
+    std::string GsHoughSweep::ResultsToJson(const std::vector<SweepResult>& results, size_t num_images) {
+
+        const int soc_temperature_millic = GsPerformanceState::ReadSocTemperatureMilliC();
+
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(3);
+        s << "{\"labels\":\"" << kHoughSweepLabelsCSV << "\",\"images\":" << num_images << ",\"threads\":" << kHoughSweepThreads << ",\"soc_temp_c\":";
+        if (soc_temperature_millic < 0) {
+            s << "null";
+        }
+        else {
+            s << soc_temperature_millic / 1000.0;
+        }
+        s << ",\"configurations\":[";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const SweepResult& r = results[i];
+            s << (i == 0 ? "" : ",") << "{\"pre_hough_blur_size\":" << r.point.pre_hough_blur_size
+                << ",\"canny_lower\":" << r.point.canny_lower << ",\"canny_upper\":" << r.point.canny_upper
+                << ",\"dp\":" << r.point.dp << ",\"starting_param2\":" << r.point.starting_param2
+                << ",\"use_clahe\":" << r.point.use_clahe
+                << ",\"labeled_balls\":" << r.labeled_balls << ",\"found_balls\":" << r.found_balls
+                << ",\"false_positives\":" << r.false_positives << ",\"accuracy\":" << r.Accuracy()
+                << ",\"mean_center_error_px\":" << r.mean_center_error_px << ",\"mean_radius_error_px\":" << r.mean_radius_error_px
+                << ",\"median_ms\":" << r.median_ms << ",\"mean_ms\":" << r.mean_ms
+                << ",\"pareto_optimal\":" << (r.pareto_optimal ? "true" : "false") << "}";
+        }
+
+        s << "]}";
+        return s.str();
+    }
+
+    bool GsHoughSweep::Run() {
+
+        LoadConfigurationValues();
+
+        std::vector<LabeledImage> images;
+
+        if (kHoughSweepLabelsCSV.empty() || !ReadLabels(kHoughSweepLabelsCSV, images)) {
+            GS_LOG_MSG(error, "GsHoughSweep - No labeled images.  Check kHoughSweepLabelsCSV.");
+            return false;
+        }
+
+        configured_constants = HoughSweepConstants::Read();
+
+        // The sweep is of the Hough search itself, and each combination should start from scratch
+        BallImageProc::kBallPlacementDetectionMethod = "legacy";
+        BallImageProc::kStrobedBallDetectionMethod = "legacy";
+        BallImageProc::kUseHoughParameterMemory = false;
+
+        std::vector<SweepPoint> points;
+
+        for (const float blur : kHoughSweepPreHoughBlurSizes) {
+            for (const float canny_lower : kHoughSweepCannyLowers) {
+                for (const float canny_upper : kHoughSweepCannyUppers) {
+                    for (const float dp : kHoughSweepDps) {
+                        for (const float param2 : kHoughSweepStartingParam2s) {
+                            for (const float clahe : kHoughSweepUseCLAHE) {
+                                SweepPoint point;
+                                point.pre_hough_blur_size = (int)blur;
+                                point.canny_lower = canny_lower;
+                                point.canny_upper = canny_upper;
+                                point.dp = dp;
+                                point.starting_param2 = param2;
+                                point.use_clahe = (int)clahe;
+
+                                // Canny needs the lower threshold below the upper one
+                                if (canny_lower >= 0 && canny_upper >= 0 && canny_lower >= canny_upper) {
+                                    continue;
+                                }
+
+                                points.push_back(point);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        std::cout << "Hough sweep: " << points.size() << " configuration(s) over " << images.size() << " image(s) on "
+            << kHoughSweepThreads << " thread(s).  -1 is the configured value.\n";
+
+        // Otherwise, the first combination's first search would pay for any lazy initialization
+        EvaluateImage(images[0]);
+
+        std::vector<SweepResult> results;
+
+        for (const SweepPoint& point : points) {
+            results.push_back(EvaluateSweepPoint(point, images, kHoughSweepThreads));
+        }
+
+        configured_constants.Write();
+
+        // A configuration is worth considering only if no other one is at least as accurate and
+        // at least as fast, and better in one of the two
+        for (SweepResult& r : results) {
+            r.pareto_optimal = std::none_of(results.begin(), results.end(), [&r](const SweepResult& other) {
+                return other.Accuracy() >= r.Accuracy() && other.median_ms <= r.median_ms &&
+                       (other.Accuracy() > r.Accuracy() || other.median_ms < r.median_ms);
+            });
+        }
+
+        std::sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+            return (a.Accuracy() != b.Accuracy()) ? (a.Accuracy() > b.Accuracy()) : (a.median_ms < b.median_ms);
+        });
+
+        std::cout << "  blur  canny_lo  canny_hi     dp  param2  clahe    found  false+  center_err  radius_err  median_ms   mean_ms\n";
+
+        for (const SweepResult& r : results) {
+            std::cout << std::fixed << std::setprecision(1) << (r.pareto_optimal ? "* " : "  ")
+                << std::setw(4) << r.point.pre_hough_blur_size << std::setw(10) << r.point.canny_lower << std::setw(10) << r.point.canny_upper
+                << std::setprecision(2) << std::setw(7) << r.point.dp << std::setprecision(1) << std::setw(8) << r.point.starting_param2
+                << std::setw(7) << r.point.use_clahe
+                << std::setw(6) << r.found_balls << "/" << std::left << std::setw(3) << r.labeled_balls << std::right
+                << std::setw(7) << r.false_positives << std::setprecision(2) << std::setw(12) << r.mean_center_error_px
+                << std::setw(12) << r.mean_radius_error_px << std::setw(11) << r.median_ms << std::setw(10) << r.mean_ms << "\n";
+        }
+
+        const std::string results_json = ResultsToJson(results, images.size());
+
+        if (!kHoughSweepResultsFile.empty()) {
+            std::ofstream results_file(kHoughSweepResultsFile);
+            results_file << results_json << std::endl;
+
+            if (!results_file) {
+                GS_LOG_MSG(error, "GsHoughSweep - Could not write " + kHoughSweepResultsFile);
+                return false;
+            }
+
+            GS_LOG_MSG(info, "GsHoughSweep - wrote the results to " + kHoughSweepResultsFile);
+        }
+        else {
+            std::cout << results_json << "\n";
+        }
+
+        return !results.empty();
+    }
+
+    GsHoughSweep::SweepPoint GsHoughSweep::ConfiguredPoint(BallImageProc::BallSearchMode search_mode, bool use_alt_hough) {
+
+        const HoughSweepConstants& c = configured_constants;
+
+        SweepPoint point;
+        point.use_clahe = c.strobed_use_clahe ? 1 : 0;
+        point.use_alt_hough = use_alt_hough ? 1 : 0;
+
+        if (search_mode == BallImageProc::kFindPlacedBall) {
+            point.pre_hough_blur_size = c.placed_pre_hough_blur_size;
+            point.canny_lower = c.placed_canny_lower;
+            point.canny_upper = c.placed_canny_upper;
+            point.dp = c.placed_dp;
+            point.starting_param2 = c.placed_starting_param2;
+            point.param2_increment = c.placed_param2_increment;
+        }
+        else if (use_alt_hough) {
+            point.pre_hough_blur_size = c.strobed_alt_pre_hough_blur_size;
+            point.canny_lower = c.strobed_alt_canny_lower;
+            point.canny_upper = c.strobed_alt_canny_upper;
+            point.dp = c.strobed_alt_dp;
+            point.starting_param2 = c.strobed_alt_starting_param2;
+            point.param2_increment = c.strobed_alt_param2_increment;
+        }
+        else {
+            point.pre_hough_blur_size = c.strobed_pre_hough_blur_size;
+            point.canny_lower = c.strobed_canny_lower;
+            point.canny_upper = c.strobed_canny_upper;
+            point.dp = c.strobed_dp;
+            point.starting_param2 = c.strobed_starting_param2;
+            point.param2_increment = c.strobed_param2_increment;
+        }
+
+        return point;
+    }
+
+    GsHoughSweep::SweepResult GsHoughSweep::AutotuneSearchMode(BallImageProc::BallSearchMode search_mode, const std::vector<LabeledImage>& images,
+                                                            SweepResult& configured_result) {
+
+        // The placed-ball search always uses HOUGH_GRADIENT_ALT, and CLAHE is only for strobed images
+        const bool placed = (search_mode == BallImageProc::kFindPlacedBall);
+
+        enum Axis { kBlur, kCannyLower, kCannyUpper, kDp, kStartingParam2, kParam2Increment, kUseAltHough, kUseCLAHE, kNumAxes };
+
+        auto neighbors = [placed](Axis axis, const SweepPoint& p) {
+            std::vector<SweepPoint> points;
+
+            const bool use_alt_hough = (p.use_alt_hough != 0);
+            const double min_param2 = placed ? BallImageProc::kPlacedBallMinParam2 :
+                                      (use_alt_hough ? BallImageProc::kStrobedBallsAltMinParam2 : BallImageProc::kStrobedBallsMinParam2);
+            const double max_param2 = placed ? BallImageProc::kPlacedBallMaxParam2 :
+                                      (use_alt_hough ? BallImageProc::kStrobedBallsAltMaxParam2 : BallImageProc::kStrobedBallsMaxParam2);
+
+            // Each value is stepped down and up, and a step that ends where it started is dropped
+            auto add_steps = [&](double SweepPoint::* value, std::initializer_list<double> factors, double min_value, double max_value) {
+                for (const double factor : factors) {
+                    SweepPoint q = p;
+                    q.*value = std::clamp(p.*value * factor, min_value, max_value);
+
+                    // Canny needs the lower threshold below the upper one
+                    if (q.*value != p.*value && q.canny_lower < q.canny_upper) {
+                        points.push_back(q);
+                    }
+                }
+            };
+
+            switch (axis) {
+                case kBlur:
+                    // GetBall rounds an even size up to the next odd one, so the size moves in steps of 2
+                    for (const int step : { -2, 2 }) {
+                        if (p.pre_hough_blur_size + step >= 0) {
+                            SweepPoint q = p;
+                            q.pre_hough_blur_size += step;
+                            points.push_back(q);
+                        }
+                    }
+                    break;
+
+                case kCannyLower:
+                    add_steps(&SweepPoint::canny_lower, { 0.8, 1.25 }, 1.0, 255.0);
+                    break;
+
+                case kCannyUpper:
+                    add_steps(&SweepPoint::canny_upper, { 0.8, 1.25 }, 1.0, 255.0);
+                    break;
+
+                case kDp:
+                    add_steps(&SweepPoint::dp, { 0.8, 1.25 }, 0.5, 3.0);
+                    break;
+
+                case kStartingParam2:
+                    // A starting value closer to the final one saves Hough iterations
+                    add_steps(&SweepPoint::starting_param2, { 0.9, 1.1 }, min_param2, max_param2);
+                    break;
+
+                case kParam2Increment:
+                    add_steps(&SweepPoint::param2_increment, { 0.5, 2.0 }, 0.001, max_param2 - min_param2);
+                    break;
+
+                case kUseAltHough:
+                    // The other algorithm starts from its own configured values
+                    if (!placed) {
+                        SweepPoint q = ConfiguredPoint(BallImageProc::kStrobed, !use_alt_hough);
+                        q.use_clahe = p.use_clahe;
+                        points.push_back(q);
+                    }
+                    break;
+
+                case kUseCLAHE:
+                    if (!placed) {
+                        SweepPoint q = p;
+                        q.use_clahe = (p.use_clahe != 0) ? 0 : 1;
+                        points.push_back(q);
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            return points;
+        };
+
+        auto meets_target = [](const SweepResult& r) { return r.Accuracy() >= kHoughAutotuneMinAccuracy; };
+
+        // Until the target is met, accuracy comes first.  After that, only a faster point that still meets it is better.
+        auto better = [&meets_target](const SweepResult& r, const SweepResult& best) {
+            const bool faster = r.median_ms < best.median_ms * (1.0 - kHoughAutotuneMinSpeedup);
+
+            if (meets_target(best)) {
+                return meets_target(r) && faster;
+            }
+
+            return r.Accuracy() > best.Accuracy() || (r.Accuracy() == best.Accuracy() && faster);
+        };
+
+        configured_result = EvaluateSweepPoint(ConfiguredPoint(search_mode, configured_constants.strobed_use_alt_hough), images, kHoughSweepThreads);
+        SweepResult best = configured_result;
+
+        const std::string mode_name = placed ? "placed" : "strobed";
+        int evaluated_points = 1;
+
+        for (int pass = 0; pass < kHoughAutotunePasses; pass++) {
+            bool improved = false;
+
+            for (int axis = 0; axis < kNumAxes; axis++) {
+                for (const SweepPoint& point : neighbors((Axis)axis, best.point)) {
+                    const SweepResult result = EvaluateSweepPoint(point, images, kHoughSweepThreads);
+                    evaluated_points++;
+
+                    if (better(result, best)) {
+                        best = result;
+                        improved = true;
+                    }
+                }
+            }
+
+            GS_LOG_MSG(info, "GsHoughSweep - " + mode_name + " autotune pass " + std::to_string(pass + 1) + ": " +
+                             std::to_string(best.median_ms) + " ms median at an accuracy of " + std::to_string(best.Accuracy()) +
+                             " after " + std::to_string(evaluated_points) + " configuration(s).");
+
+            if (!improved) {
+                break;
+            }
+        }
+
+        return best;
+    }
+
+    static std::string FormatOverrideValue(double value) {
+        std::ostringstream s;
+        s << std::setprecision(4) << value;
+        return s.str();
+    }
+
+    void GsHoughSweep::AddOverrides(BallImageProc::BallSearchMode search_mode, const SweepPoint& point,
+                                    std::vector<std::pair<std::string, std::string>>& overrides) {
+
+        const HoughSweepConstants& c = configured_constants;
+        const bool placed = (search_mode == BallImageProc::kFindPlacedBall);
+        const bool use_alt_hough = !placed && (point.use_alt_hough != 0);
+
+        // Compared with the configured values of the Hough algorithm that the point uses
+        const SweepPoint configured = ConfiguredPoint(search_mode, placed ? c.strobed_use_alt_hough : use_alt_hough);
+
+        auto add_if_changed = [&overrides](const std::string& key, double value, double configured_value) {
+            if (value != configured_value) {
+                overrides.emplace_back(key, FormatOverrideValue(value));
+            }
+        };
+
+        if (!placed) {
+            add_if_changed("kStrobedBallsUseAltHoughAlgorithm", use_alt_hough ? 1 : 0, c.strobed_use_alt_hough ? 1 : 0);
+            add_if_changed("kUseCLAHEProcessing", point.use_clahe, c.strobed_use_clahe ? 1 : 0);
+        }
+
+        const std::string prefix = placed ? "kPlacedBall" : (use_alt_hough ? "kStrobedBallsAlt" : "kStrobedBalls");
+
+        add_if_changed(placed ? "kPlacedPreHoughBlurSize" : prefix + "PreHoughBlurSize", point.pre_hough_blur_size, configured.pre_hough_blur_size);
+        add_if_changed(prefix + "CannyLower", point.canny_lower, configured.canny_lower);
+        add_if_changed(prefix + "CannyUpper", point.canny_upper, configured.canny_upper);
+        add_if_changed(prefix + "HoughDpParam1", point.dp, configured.dp);
+        add_if_changed(prefix + "StartingParam2", point.starting_param2, configured.starting_param2);
+        add_if_changed(prefix + "Param2Increment", point.param2_increment, configured.param2_increment);
+    }
+
+    bool GsHoughSweep::WriteOverrides(const std::string& filename, const std::vector<std::pair<std::string, std::string>>& overrides,
+                                      bool merge) {
+
+        boost::property_tree::ptree root;
+
+        try {
+            // Keeps whatever else is already being tuned through the file
+            if (merge && std::filesystem::exists(filename)) {
+                boost::property_tree::read_json(filename, root);
+            }
+
+            for (const auto& [key, value] : overrides) {
+                root.put("gs_config.ball_identification." + key, value);
+            }
+
+            // Written to the side and then moved into place, so that GsConfigReload never reads part of the file
+            boost::property_tree::write_json(filename + ".tmp", root);
+        }
+        catch (std::exception const& e)
+        {
+            GS_LOG_MSG(error, "GsHoughSweep - could not write " + filename + ". ERROR: *** " + std::string(e.what()) + " ***");
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(filename + ".tmp", filename, error);
+
+        if (error) {
+            GS_LOG_MSG(error, "GsHoughSweep - could not replace " + filename + ": " + error.message());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool GsHoughSweep::RunAutotune() {
+
+        LoadConfigurationValues();
+
+        std::vector<LabeledImage> images;
+
+        if (!kHoughSweepLabelsCSV.empty()) {
+            if (!ReadLabels(kHoughSweepLabelsCSV, images)) {
+                GS_LOG_MSG(error, "GsHoughSweep - No labeled images.  Check kHoughSweepLabelsCSV.");
+                return false;
+            }
+        }
+        else if (kHoughAutotuneShotArchive.empty() || !ReadArchivedShots(kHoughAutotuneShotArchive, images)) {
+            GS_LOG_MSG(error, "GsHoughSweep - No labeled images or archived shots.  Check kHoughSweepLabelsCSV or kHoughAutotuneShotArchive.");
+            return false;
+        }
+
+        // Only read now, as labeling the archived shots runs the configured analysis
+        configured_constants = HoughSweepConstants::Read();
+
+        BallImageProc::kBallPlacementDetectionMethod = "legacy";
+        BallImageProc::kStrobedBallDetectionMethod = "legacy";
+        BallImageProc::kUseHoughParameterMemory = false;
+
+        std::cout << "Hough autotune over " << images.size() << " image(s) on " << kHoughSweepThreads
+            << " thread(s), for an accuracy of at least " << kHoughAutotuneMinAccuracy << ".\n";
+
+        EvaluateImage(images[0]);
+
+        std::vector<std::pair<std::string, std::string>> overrides;
+
+        for (const BallImageProc::BallSearchMode search_mode : { BallImageProc::kFindPlacedBall, BallImageProc::kStrobed }) {
+
+            std::vector<LabeledImage> mode_images;
+            std::copy_if(images.begin(), images.end(), std::back_inserter(mode_images),
+                         [search_mode](const LabeledImage& image) { return image.search_mode == search_mode; });
+
+            if (mode_images.empty()) {
+                continue;
+            }
+
+            SweepResult configured_result;
+            const SweepResult tuned_result = AutotuneSearchMode(search_mode, mode_images, configured_result);
+
+            const std::string mode_name = (search_mode == BallImageProc::kFindPlacedBall) ? "placed" : "strobed";
+
+            std::cout << std::fixed << std::setprecision(2) << "  " << mode_name << " (" << mode_images.size() << " image(s)): configured "
+                << configured_result.median_ms << " ms median at an accuracy of " << configured_result.Accuracy() << ", tuned "
+                << tuned_result.median_ms << " ms median at an accuracy of " << tuned_result.Accuracy() << "\n";
+
+            if (tuned_result.Accuracy() < kHoughAutotuneMinAccuracy) {
+                GS_LOG_MSG(warning, "GsHoughSweep - no " + mode_name + " configuration met kHoughAutotuneMinAccuracy.  Proposing nothing for it.");
+                continue;
+            }
+
+            AddOverrides(search_mode, tuned_result.point, overrides);
+        }
+
+        configured_constants.Write();
+
+        if (overrides.empty()) {
+            std::cout << "Nothing to propose - no faster values were found.\n";
+            return true;
+        }
+
+        std::cout << "Proposed values:\n";
+        for (const auto& [key, value] : overrides) {
+            std::cout << "  gs_config.ball_identification." << key << " = " << value << "\n";
+        }
+
+        if (!kHoughAutotuneProposalFile.empty()) {
+            if (!WriteOverrides(kHoughAutotuneProposalFile, overrides, false)) {
+                return false;
+            }
+
+            GS_LOG_MSG(info, "GsHoughSweep - wrote the proposed values to " + kHoughAutotuneProposalFile);
+        }
+
+        if (kHoughAutotuneApply) {
+            if (GsConfigReload::kConfigReloadFile.empty()) {
+                GS_LOG_MSG(error, "GsHoughSweep - kHoughAutotuneApply is set, but there is no kConfigReloadFile to apply the values through.");
+                return false;
+            }
+
+            if (!WriteOverrides(GsConfigReload::kConfigReloadFile, overrides, true)) {
+                return false;
+            }
+
+            GS_LOG_MSG(info, "GsHoughSweep - added the proposed values to " + GsConfigReload::kConfigReloadFile +
+                             ".  A running pitrac_lm will use them from its next wait for a ball.");
+        }
+
+        return true;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
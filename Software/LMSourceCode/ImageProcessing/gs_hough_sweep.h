@@ -0,0 +1,167 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// The headless counterpart of the HoughCirclePlayground.  Runs the real BallImageProc::GetBall
+// over a set of labeled images for every combination of the Hough and pre-processing values
+// in the kHoughSweep* lists, and reports how accurate and how fast each combination was.
+// The images of one combination are searched in parallel (on kHoughSweepThreads threads),
+// but the combinations are run one after another, as GetBall reads the values from
+// BallImageProc's static tuning constants.
+//
+// The labels file is a CSV with a heading line and then one line per ball:
+//      image_file, search_mode, center_x, center_y, radius
+// where search_mode is "placed" or "strobed", and the image file is relative to the labels
+// file's directory.  A strobed image has one line for each of its balls.
+//
+// Run with --system_mode=hough_sweep.  The results are printed (the combinations that no
+// other combination beats on both accuracy and time are marked with a '*') and also written
+// as JSON to kHoughSweepResultsFile.
+// The strobed values go to whichever of the two Hough algorithms (see
+// kStrobedBallsUseAltHoughAlgorithm) the strobed search uses.
+//
+// Run with --system_mode=hough_autotune to have the values picked instead.  The autotuner
+// walks from the configured values, one value at a time (including the strobed Hough
+// algorithm), and keeps any step that is at least kHoughAutotuneMinSpeedup faster while
+// still meeting kHoughAutotuneMinAccuracy (or, until that is met, any step that is more
+// accurate).  The placed and strobed searches are tuned separately.  The images are those
+// of kHoughSweepLabelsCSV, if there is one.  Otherwise, they are the strobed frames of the
+// last kHoughAutotuneMaxShots shots in kHoughAutotuneShotArchive, labeled with the balls
+// that the configured analysis found in them - so the accuracy is then the agreement with
+// the configured search, and the tuner looks for the fastest search that still finds the
+// same balls.  The values that changed are written to kHoughAutotuneProposalFile in the
+// GsConfigReload format and, if kHoughAutotuneApply is set, are also merged into
+// GsConfigReload::kConfigReloadFile, so that a running pitrac_lm picks them up between
+// shots.  As the tuner changes BallImageProc's constants, it has to run in its own
+// process, e.g., from a timer while the bay is idle.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "ball_image_proc.h"
+
+namespace golf_sim {
+
+    class GsHoughSweep {
+
+    public:
+        static std::string kHoughSweepLabelsCSV;
+        // Empty means the results are only printed
+        static std::string kHoughSweepResultsFile;
+        // 0 means one per core.  1 gives the least-disturbed timings.
+        static int kHoughSweepThreads;
+        // A found ball matches a labeled one if its center is within this times the labeled radius
+        static double kHoughSweepMaxCenterErrorRatio;
+
+        // The values to try.  An empty list means only the configured value of each search mode is used.
+        static std::vector<float> kHoughSweepPreHoughBlurSizes;
+        static std::vector<float> kHoughSweepCannyLowers;
+        static std::vector<float> kHoughSweepCannyUppers;
+        static std::vector<float> kHoughSweepDps;
+        static std::vector<float> kHoughSweepStartingParam2s;
+        // Strobed images only.  0 or 1.
+        static std::vector<float> kHoughSweepUseCLAHE;
+
+        // Only used if there is no kHoughSweepLabelsCSV
+        static std::string kHoughAutotuneShotArchive;
+        static int kHoughAutotuneMaxShots;
+        // The fraction (0-1) of the labeled balls that have to be found, less the false positives
+        static double kHoughAutotuneMinAccuracy;
+        // A step has to cut the median search time by at least this fraction to be taken
+        static double kHoughAutotuneMinSpeedup;
+        static int kHoughAutotunePasses;
+        // Empty means the proposal is only printed
+        static std::string kHoughAutotuneProposalFile;
+        static bool kHoughAutotuneApply;
+
+        static void LoadConfigurationValues();
+
+        static bool Run();
+
+        static bool RunAutotune();
+
+    private:
+        struct LabeledImage {
+            std::string filename;
+            BallImageProc::BallSearchMode search_mode = BallImageProc::kFindPlacedBall;
+            cv::Mat img;
+            std::vector<cv::Vec3f> balls;
+        };
+
+        // A negative value means the configured value of the image's search mode
+        struct SweepPoint {
+            int pre_hough_blur_size = -1;
+            double canny_lower = -1.0;
+            double canny_upper = -1.0;
+            double dp = -1.0;
+            double starting_param2 = -1.0;
+            int use_clahe = -1;
+            double param2_increment = -1.0;
+            int use_alt_hough = -1;
+        };
+
+        struct SweepResult {
+            SweepPoint point;
+            int labeled_balls = 0;
+            int found_balls = 0;
+            int false_positives = 0;
+            double mean_center_error_px = 0.0;
+            double mean_radius_error_px = 0.0;
+            double median_ms = 0.0;
+            double mean_ms = 0.0;
+            bool pareto_optimal = false;
+
+            double DetectionRate() const { return (labeled_balls > 0) ? (double)found_balls / labeled_balls : 0.0; }
+            // The false positives count against the found balls
+            double Accuracy() const { return (labeled_balls > 0) ? (double)(found_balls - false_positives) / labeled_balls : 0.0; }
+        };
+
+        struct ImageResult {
+            double elapsed_ms = 0.0;
+            int found_balls = 0;
+            int false_positives = 0;
+            double center_error_px = 0.0;
+            double radius_error_px = 0.0;
+        };
+
+        static bool ReadLabels(const std::string& labels_filename, std::vector<LabeledImage>& images);
+
+        // Labels the strobed frames of the archive's most recent shots with the exposures that the
+        // configured analysis finds in them
+        static bool ReadArchivedShots(const std::string& archive_filename, std::vector<LabeledImage>& images);
+
+        // Sets BallImageProc's constants for the search modes that the sweep covers
+        static void ApplySweepPoint(const SweepPoint& point);
+
+        static ImageResult EvaluateImage(const LabeledImage& image);
+
+        static SweepResult EvaluateSweepPoint(const SweepPoint& point, const std::vector<LabeledImage>& images, int num_threads);
+
+        static std::string ResultsToJson(const std::vector<SweepResult>& results, size_t num_images);
+
+        // The configured values of the search mode (and, for a strobed search, Hough algorithm), with none left negative
+        static SweepPoint ConfiguredPoint(BallImageProc::BallSearchMode search_mode, bool use_alt_hough);
+
+        // Walks from the configured values to the fastest point that meets kHoughAutotuneMinAccuracy
+        static SweepResult AutotuneSearchMode(BallImageProc::BallSearchMode search_mode, const std::vector<LabeledImage>& images,
+                                              SweepResult& configured_result);
+
+        // The ball_identification values of the tuned point that differ from the configured ones
+        static void AddOverrides(BallImageProc::BallSearchMode search_mode, const SweepPoint& point,
+                                 std::vector<std::pair<std::string, std::string>>& overrides);
+
+        static bool WriteOverrides(const std::string& filename, const std::vector<std::pair<std::string, std::string>>& overrides,
+                                   bool merge);
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
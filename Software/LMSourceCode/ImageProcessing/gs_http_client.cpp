@@ -5,55 +5,307 @@
 
 #ifdef __unix__
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
 #include "gs_http_client.h"
+#include "gs_image_service.h"
+#include "gs_http_server.h"
 #include "logging_tools.h"
 #include "httplib.h"
 
 namespace golf_sim {
 
-std::string GsHttpClient::host_ = "localhost";
-int GsHttpClient::port_ = 8080;
+// Enough for a few shots' worth of results and images if the web server stalls
+static const size_t kMaxQueuedPosts = 16;
+
+// How often (in posts sent) to log the client statistics
+static const long kStatisticsLoggingInterval = 50;
+
+std::string GsHttpClient::server_url_ = "http://localhost:8080";
+bool GsHttpClient::config_batches_supported_ = true;
+
+std::deque<GsHttpClient::PendingPost> GsHttpClient::queue_;
+std::mutex GsHttpClient::mutex_;
+std::condition_variable GsHttpClient::queue_not_empty_;
+std::thread GsHttpClient::sender_thread_;
+bool GsHttpClient::exiting_ = false;
+bool GsHttpClient::reconnect_ = false;
+
+long GsHttpClient::number_sent_ = 0;
+long GsHttpClient::number_failed_ = 0;
+long GsHttpClient::number_coalesced_ = 0;
+long GsHttpClient::number_dropped_ = 0;
+size_t GsHttpClient::max_queue_depth_ = 0;
+double GsHttpClient::total_post_ms_ = 0.0;
+double GsHttpClient::max_post_ms_ = 0.0;
 
 void GsHttpClient::Init(const std::string& host, int port) {
-    host_ = host;
-    port_ = port;
+    const char* env_url = std::getenv("PITRAC_WEB_SERVER_URL");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    server_url_ = (env_url != nullptr) ? std::string(env_url) : "http://" + host + ":" + std::to_string(port);
+    reconnect_ = true;
+}
+
+void GsHttpClient::PostResult(const std::string& json_body, bool supersedable) {
+    QueuePost(PendingPost{ supersedable ? PostType::kSupersedableResult : PostType::kResult,
+                           "/api/internal/shot-result", json_body });
 }
 
-void GsHttpClient::PostResult(const std::string& json_body) {
-    try {
-        httplib::Client cli(host_, port_);
-        cli.set_connection_timeout(1);
-        cli.set_read_timeout(1);
+void GsHttpClient::PostImageReady(const std::string& filename) {
+    std::string json = "{\"filename\":\"" + filename + "\"";
+
+    // The image is not in the share directory, so tell the web server where to fetch it from
+    if (GsImageService::IsRunning()) {
+        json += ",\"url_path\":\"" + GsImageService::GetImagePath(filename) + "\"" +
+                ",\"port\":" + std::to_string(GsHttpServer::kHttpServerPort);
+    }
+
+    json += "}";
+    QueuePost(PendingPost{ PostType::kImageReady, "/api/internal/image-ready", json });
+}
+
+void GsHttpClient::PutConfigValue(const std::string& key, const std::string& json_value) {
+    PendingPost post;
+    post.type = PostType::kConfigValues;
+    post.path = "/api/config";
+    post.config_values.emplace_back(key, json_value);
+    QueuePost(std::move(post));
+}
+
+void GsHttpClient::QueuePost(PendingPost&& post) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (exiting_) {
+            GS_LOG_TRACE_MSG(trace, "GsHttpClient - shutting down.  Ignoring post to " + post.path);
+            return;
+        }
+
+        if (!sender_thread_.joinable()) {
+            sender_thread_ = std::thread(&GsHttpClient::Process);
+        }
+
+        // Config values join whatever batch is still waiting
+        if (post.type == PostType::kConfigValues) {
+            for (auto& queued_post : queue_) {
+                if (queued_post.type != PostType::kConfigValues) {
+                    continue;
+                }
+
+                for (auto& value : post.config_values) {
+                    auto queued_value = std::find_if(queued_post.config_values.begin(), queued_post.config_values.end(),
+                        [&](const auto& v) { return v.first == value.first; });
+
+                    if (queued_value != queued_post.config_values.end()) {
+                        queued_value->second = std::move(value.second);
+                    } else {
+                        queued_post.config_values.push_back(std::move(value));
+                    }
+                }
+
+                number_coalesced_++;
+                return;
+            }
+        }
+        // Coalesce with a queued post that this one makes redundant.  The newer post goes
+        // to the back, so that it is not sent ahead of anything queued after the old one.
+        else if (post.type != PostType::kResult) {
+            auto superseded_post = std::find_if(queue_.begin(), queue_.end(), [&](const PendingPost& queued_post) {
+                return queued_post.type == post.type &&
+                       (post.type == PostType::kSupersedableResult || queued_post.body == post.body);
+            });
+
+            if (superseded_post != queue_.end()) {
+                queue_.erase(superseded_post);
+                number_coalesced_++;
+            }
+        }
 
-        auto res = cli.Post("/api/internal/shot-result", json_body, "application/json");
+        if (queue_.size() >= kMaxQueuedPosts) {
+            // Prefer to lose a status message or image notification over a hit result or
+            // a calibration
+            auto victim = queue_.begin();
+            for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+                if (it->type != PostType::kResult && it->type != PostType::kConfigValues) {
+                    victim = it;
+                    break;
+                }
+            }
 
-        if (!res) {
-            GS_LOG_MSG(warning, "HTTP POST to web server failed (no response)");
-        } else if (res->status != 200) {
-            GS_LOG_MSG(warning, "HTTP POST returned status " + std::to_string(res->status));
+            GS_LOG_MSG(warning, "GsHttpClient - queue full (is the web server responding?).  Dropping post to " + victim->path);
+            queue_.erase(victim);
+            number_dropped_++;
         }
-    } catch (const std::exception& e) {
-        GS_LOG_MSG(warning, "HTTP POST exception: " + std::string(e.what()));
+
+        queue_.push_back(std::move(post));
+        max_queue_depth_ = std::max(max_queue_depth_, queue_.size());
     }
+
+    queue_not_empty_.notify_one();
 }
 
-void GsHttpClient::PostImageReady(const std::string& filename) {
-    try {
-        httplib::Client cli(host_, port_);
-        cli.set_connection_timeout(1);
-        cli.set_read_timeout(1);
+void GsHttpClient::Process() {
+
+    std::unique_ptr<httplib::Client> cli;
+
+    while (true) {
+        PendingPost post;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            queue_not_empty_.wait(lock, [] { return !queue_.empty() || exiting_; });
 
-        std::string json = "{\"filename\":\"" + filename + "\"}";
-        auto res = cli.Post("/api/internal/image-ready", json, "application/json");
+            if (queue_.empty()) {
+                // Exiting, and everything has been sent
+                return;
+            }
 
-        if (!res) {
-            GS_LOG_MSG(warning, "HTTP POST image-ready failed (no response)");
+            post = std::move(queue_.front());
+            queue_.pop_front();
+
+            if (!cli || reconnect_) {
+                cli = std::make_unique<httplib::Client>(server_url_);
+                cli->set_keep_alive(true);
+                cli->set_connection_timeout(1);
+                cli->set_read_timeout(1);
+                reconnect_ = false;
+            }
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+        bool success = false;
+
+        try {
+            if (post.type == PostType::kConfigValues) {
+                success = SendConfigValues(*cli, post.config_values);
+            } else {
+                auto res = cli->Post(post.path, post.body, "application/json");
+
+                if (!res) {
+                    GS_LOG_MSG(warning, "HTTP POST to " + post.path + " failed (no response)");
+                } else if (res->status != 200) {
+                    GS_LOG_MSG(warning, "HTTP POST to " + post.path + " returned status " + std::to_string(res->status));
+                } else {
+                    success = true;
+                }
+            }
+        } catch (const std::exception& e) {
+            GS_LOG_MSG(warning, "HTTP POST exception: " + std::string(e.what()));
+        }
+
+        double post_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+        bool log_statistics = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (success) {
+                number_sent_++;
+                total_post_ms_ += post_ms;
+                max_post_ms_ = std::max(max_post_ms_, post_ms);
+                log_statistics = (number_sent_ % kStatisticsLoggingInterval == 0);
+            }
+            else {
+                number_failed_++;
+            }
+        }
+
+        if (log_statistics) {
+            GS_LOG_MSG(info, "GsHttpClient statistics: " + GetStatistics());
         }
-    } catch (const std::exception& e) {
-        GS_LOG_MSG(warning, "HTTP POST image-ready exception: " + std::string(e.what()));
     }
 }
 
+bool GsHttpClient::SendConfigValues(httplib::Client& cli, const ConfigValues& config_values) {
+
+    if (config_values.size() > 1 && config_batches_supported_) {
+        std::string body = "{\"updates\": {";
+        for (size_t i = 0; i < config_values.size(); i++) {
+            body += (i > 0 ? ", \"" : "\"") + config_values[i].first + "\": " + config_values[i].second;
+        }
+        body += "}}";
+
+        auto res = cli.Put("/api/config", body, "application/json");
+
+        if (res && res->status >= 200 && res->status < 300) {
+            GS_LOG_MSG(info, "Updated " + std::to_string(config_values.size()) + " configuration values in the web server.");
+            return true;
+        }
+
+        if (res && (res->status == 404 || res->status == 405)) {
+            // An older web server.  It still takes the values one at a time.
+            GS_LOG_TRACE_MSG(trace, "GsHttpClient - the web server does not take batched configuration updates.");
+            config_batches_supported_ = false;
+        } else {
+            GS_LOG_MSG(warning, "Failed to update configuration values via web API (" +
+                       (res ? "status " + std::to_string(res->status) : std::string("no response")) +
+                       ").  Web server may not be running.  Calibration saved locally to golf_sim_config.json");
+            return false;
+        }
+    }
+
+    bool success = true;
+
+    for (const auto& value : config_values) {
+        auto res = cli.Put("/api/config/" + value.first, "{\"value\": " + value.second + "}", "application/json");
+
+        if (res && res->status >= 200 && res->status < 300) {
+            GS_LOG_MSG(info, "Successfully updated calibration: " + value.first + " = " + value.second);
+        } else {
+            GS_LOG_MSG(warning, "Failed to update calibration via web API: " + value.first +
+                       ". Web server may not be running. Calibration saved locally to golf_sim_config.json");
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+void GsHttpClient::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (exiting_) {
+            return;
+        }
+
+        GS_LOG_TRACE_MSG(trace, "GsHttpClient::Shutdown - sending " + std::to_string(queue_.size()) + " queued posts.");
+        exiting_ = true;
+    }
+
+    queue_not_empty_.notify_all();
+
+    if (sender_thread_.joinable()) {
+        sender_thread_.join();
+    }
+
+    GS_LOG_MSG(info, "GsHttpClient statistics at shutdown: " + GetStatistics());
+}
+
+std::string GsHttpClient::GetStatistics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::ostringstream s;
+    s << std::fixed << std::setprecision(1)
+      << "sent=" << number_sent_
+      << ", failed=" << number_failed_
+      << ", coalesced=" << number_coalesced_
+      << ", dropped=" << number_dropped_
+      << ", queue_depth=" << queue_.size()
+      << ", max_queue_depth=" << max_queue_depth_
+      << ", average_ms=" << ((number_sent_ > 0) ? (total_post_ms_ / number_sent_) : 0.0)
+      << ", max_ms=" << max_post_ms_;
+
+    return s.str();
+}
+
 } // namespace golf_sim
 
 #endif
@@ -7,21 +7,94 @@
 
 #ifdef __unix__
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace httplib {
+class Client;
+}
 
 namespace golf_sim {
 
 // Lightweight HTTP client for posting shot results to the Python web server.
 // Fire-and-forget — failures are logged but don't block the shot cycle.
+// The posts are queued and sent by a single background thread over one persistent
+// (keep-alive) connection, so a slow or missing web server never holds up the FSM.
 class GsHttpClient {
 public:
+    // If PITRAC_WEB_SERVER_URL (e.g., "http://localhost:8080") is set, it is used instead
     static void Init(const std::string& host = "localhost", int port = 8080);
-    static void PostResult(const std::string& json_body);
+
+    // If supersedable is true, the result is only of interest until a newer
+    // supersedable result (e.g., the next status message) is posted, so a queued one
+    // that has not been sent yet will be dropped, and the newer one queued in order.
+    // Hit results should never be supersedable.
+    static void PostResult(const std::string& json_body, bool supersedable = false);
+
+    // Repeated notifications for the same file are coalesced if the first has not been sent yet
     static void PostImageReady(const std::string& filename);
 
+    // Sets a configuration value (e.g., a calibration result) in the web server.  json_value
+    // is already formatted, e.g., "[1.5, 2]".  Values that are set before the sender thread
+    // gets to them go out in a single request, and a newer value for a queued key replaces it.
+    static void PutConfigValue(const std::string& key, const std::string& json_value);
+
+    // Sends whatever is still queued and stops the sender thread.  Called once at shutdown.
+    static void Shutdown();
+
+    // E.g., "sent=10, failed=0, coalesced=2, dropped=0, queue_depth=0, max_queue_depth=3, average_ms=4.2, max_ms=12.0"
+    static std::string GetStatistics();
+
 private:
-    static std::string host_;
-    static int port_;
+    enum class PostType {
+        kResult,
+        kSupersedableResult,
+        kImageReady,
+        kConfigValues
+    };
+
+    typedef std::vector<std::pair<std::string, std::string>> ConfigValues;
+
+    struct PendingPost {
+        PostType type = PostType::kResult;
+        std::string path;
+        std::string body;
+        // Only for kConfigValues, as (key, JSON value)
+        ConfigValues config_values;
+    };
+
+    static void QueuePost(PendingPost&& post);
+    static void Process();
+
+    // PUTs the values in one request if the web server takes batches, and otherwise one at a time
+    static bool SendConfigValues(httplib::Client& cli, const ConfigValues& config_values);
+
+    // E.g., "http://localhost:8080"
+    static std::string server_url_;
+    // Only touched by the sender thread.  Cleared if the web server has no batch endpoint.
+    static bool config_batches_supported_;
+
+    static std::deque<PendingPost> queue_;
+    static std::mutex mutex_;
+    static std::condition_variable queue_not_empty_;
+    static std::thread sender_thread_;
+    static bool exiting_;
+    // Set by Init so that the sender thread re-connects to the (possibly new) host
+    static bool reconnect_;
+
+    // All guarded by mutex_
+    static long number_sent_;
+    static long number_failed_;
+    static long number_coalesced_;
+    static long number_dropped_;
+    static size_t max_queue_depth_;
+    static double total_post_ms_;
+    static double max_post_ms_;
 };
 
 } // namespace golf_sim
@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__
+
+#include <memory>
+#include <thread>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+
+#include "gs_http_server.h"
+
+namespace golf_sim {
+
+    std::string GsHttpServer::kHttpServerAddress = "127.0.0.1";
+    int GsHttpServer::kHttpServerPort = 0;
+
+    // Created by the first route, so that routes can be added before the server is bound
+    static std::unique_ptr<httplib::Server> http_server;
+    static std::thread http_server_thread;
+    static bool http_server_started = false;
+
+
+    void GsHttpServer::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kHttpServerAddress", kHttpServerAddress);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kHttpServerPort", kHttpServerPort);
+
+        if (kHttpServerAddress.empty()) {
+            GS_LOG_MSG(warning, "GsHttpServer - kHttpServerAddress was empty.  Using 127.0.0.1.");
+            kHttpServerAddress = "127.0.0.1";
+        }
+    }
+
+    bool GsHttpServer::IsEnabled() {
+        return kHttpServerPort > 0;
+    }
+
+    bool GsHttpServer::Get(const std::string& pattern, httplib::Server::Handler handler) {
+        if (!IsEnabled()) {
+            return false;
+        }
+
+        // httplib does not expect its routes to change once it is listening
+        if (http_server_started) {
+            GS_LOG_MSG(warning, "GsHttpServer - could not add " + pattern + " after the server was started.");
+            return false;
+        }
+
+        if (http_server == nullptr) {
+            http_server = std::make_unique<httplib::Server>();
+        }
+
+        http_server->Get(pattern, std::move(handler));
+
+        return true;
+    }
+
+    void GsHttpServer::Start() {
+        if (http_server == nullptr || http_server_started) {
+            return;
+        }
+
+        http_server_started = true;
+
+        // Bind here so that a port that is already in use is reported right away
+        if (!http_server->bind_to_port(kHttpServerAddress, kHttpServerPort)) {
+            GS_LOG_MSG(warning, "GsHttpServer - could not listen on " + kHttpServerAddress + ":" + std::to_string(kHttpServerPort) +
+                                ".  None of the HTTP endpoints will be served.");
+            return;
+        }
+
+        http_server_thread = std::thread([]() {
+            http_server->listen_after_bind();
+        });
+
+        GS_LOG_MSG(info, "GsHttpServer - serving at " + GetUrl("/"));
+    }
+
+    void GsHttpServer::Stop() {
+        if (!IsRunning()) {
+            return;
+        }
+
+        // Once bound, the server is running (or about to be), so this will not wait long
+        http_server->wait_until_ready();
+        http_server->stop();
+
+        http_server_thread.join();
+    }
+
+    bool GsHttpServer::IsRunning() {
+        return http_server_thread.joinable();
+    }
+
+    std::string GsHttpServer::GetUrl(const std::string& path) {
+        return "http://" + kHttpServerAddress + ":" + std::to_string(kHttpServerPort) + path;
+    }
+
+}
+
+#endif // #ifdef __unix__
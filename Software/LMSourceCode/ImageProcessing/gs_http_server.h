@@ -0,0 +1,59 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// The one HTTP server that every PiTrac endpoint is served from (e.g., /metrics, the
+// web-server images and the live preview), instead of each feature binding its own port
+// and running its own listener thread.  Each feature adds its routes while it starts up,
+// and lm_main then starts the server once, after all of them.
+// The server is off unless kHttpServerPort is set.  It only listens on kHttpServerAddress,
+// which is the loopback interface by default, so that nothing is reachable from the
+// network unless that is asked for (e.g., "0.0.0.0" for every interface).
+
+#pragma once
+
+#ifdef __unix__
+
+#include <functional>
+#include <string>
+
+#include "httplib.h"
+
+namespace golf_sim {
+
+    class GsHttpServer {
+
+    public:
+        static std::string kHttpServerAddress;
+
+        // 0 (the default) means no HTTP server, and so none of the endpoints
+        static int kHttpServerPort;
+
+        static void LoadConfigurationValues();
+
+        // True if the server is configured, i.e., routes that are added will be served
+        static bool IsEnabled();
+
+        // Adds a GET route.  The pattern is an httplib one, so may be a regular expression.
+        // Must be called before Start.  Returns false if the server is off or already started.
+        static bool Get(const std::string& pattern, httplib::Server::Handler handler);
+
+        // Binds kHttpServerAddress:kHttpServerPort and serves the routes on its own thread.
+        // Does nothing if the server is off, has no routes, or has already been started.
+        static void Start();
+
+        // Stops serving.  Anything that keeps a response open (e.g., a stream) must have
+        // been told to finish first.
+        static void Stop();
+
+        // True once Start has bound the port, until Stop
+        static bool IsRunning();
+
+        // E.g., "http://127.0.0.1:8081/metrics", for the log
+        static std::string GetUrl(const std::string& path);
+    };
+
+}
+
+#endif // #ifdef __unix__
@@ -0,0 +1,301 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_http_server.h"
+
+#include "gs_image_service.h"
+#include "gs_jpeg_encoder.h"
+
+namespace golf_sim {
+
+    bool GsImageService::kImageServiceHttpEnabled = false;
+    int GsImageService::kImageServiceMaxImages = 16;
+    int GsImageService::kImageServiceMaxWidth = 800;
+    int GsImageService::kImageServiceJpegQuality = 85;
+
+    static const std::string kImagePathPrefix = "/images/";
+
+    struct PublishRequest {
+        std::string name;
+        cv::Mat img;
+        std::vector<GsImageWriter::CircleAnnotation> annotations;
+        std::function<void()> on_published;
+    };
+
+    struct ServedImage {
+        // Shared with any response that is still being sent when the image is replaced
+        std::shared_ptr<const std::string> jpeg;
+        std::string etag;
+        uint64_t sequence = 0;
+    };
+
+    // Read by the threads that publish images
+    static std::atomic<bool> image_service_started{ false };
+
+    static std::mutex encoder_mutex;
+    static std::condition_variable encoder_queue_not_empty;
+    static std::deque<PublishRequest> encoder_queue;
+    static std::thread encoder_thread;
+    static bool encoder_exiting = false;
+
+    // Guarded by images_mutex
+    static std::mutex images_mutex;
+    static std::map<std::string, ServedImage> images;
+    static uint64_t image_sequence = 0;
+
+
+    static std::string GetImageStem(const std::string& name) {
+        const size_t slash = name.find_last_of('/');
+        std::string stem = (slash == std::string::npos) ? name : name.substr(slash + 1);
+
+        const size_t dot = stem.find_last_of('.');
+        if (dot != std::string::npos) {
+            stem.erase(dot);
+        }
+
+        return stem;
+    }
+
+    static bool EncodeAndStore(const PublishRequest& request) {
+
+        auto start_time = std::chrono::steady_clock::now();
+
+        cv::Mat img = request.img;
+
+        // The annotations are in full-resolution coordinates, so they are drawn before scaling
+        if (!request.annotations.empty()) {
+            img = request.img.clone();
+
+            for (const GsImageWriter::CircleAnnotation& annotation : request.annotations) {
+                LoggingTools::DrawCircleOutlineAndCenter(img, annotation.circle, annotation.label, annotation.ordinal, annotation.de_emphasize);
+            }
+        }
+
+        if (GsImageService::kImageServiceMaxWidth > 0 && img.cols > GsImageService::kImageServiceMaxWidth) {
+            const double scale = (double)GsImageService::kImageServiceMaxWidth / img.cols;
+            cv::Mat scaled_img;
+            cv::resize(img, scaled_img, cv::Size(), scale, scale, cv::INTER_AREA);
+            img = scaled_img;
+        }
+
+        std::vector<uchar> buffer;
+
+        if (!GsJpegEncoder::Encode(img, GsImageService::kImageServiceJpegQuality, buffer)) {
+            GS_LOG_MSG(warning, "GsImageService - could not encode image " + request.name);
+            return false;
+        }
+
+        auto jpeg = std::make_shared<const std::string>(buffer.begin(), buffer.end());
+
+        {
+            std::lock_guard<std::mutex> lock(images_mutex);
+
+            ServedImage& served_image = images[request.name];
+            served_image.jpeg = jpeg;
+            served_image.sequence = ++image_sequence;
+            served_image.etag = "\"" + std::to_string(served_image.sequence) + "\"";
+
+            while (images.size() > (size_t)std::max(1, GsImageService::kImageServiceMaxImages)) {
+                auto oldest = images.begin();
+                for (auto it = images.begin(); it != images.end(); ++it) {
+                    if (it->second.sequence < oldest->second.sequence) {
+                        oldest = it;
+                    }
+                }
+                images.erase(oldest);
+            }
+        }
+
+        double encode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+        GS_LOG_TRACE_MSG(trace, "GsImageService - published " + request.name + " (" + std::to_string(jpeg->size()) +
+                                " bytes, " + std::to_string((int)encode_ms) + " ms)");
+
+        return true;
+    }
+
+    static void ProcessPublishRequests() {
+
+        while (true) {
+            PublishRequest request;
+
+            {
+                std::unique_lock<std::mutex> lock(encoder_mutex);
+                encoder_queue_not_empty.wait(lock, [] { return encoder_exiting || !encoder_queue.empty(); });
+
+                if (encoder_queue.empty()) {
+                    return;
+                }
+
+                request = std::move(encoder_queue.front());
+                encoder_queue.pop_front();
+            }
+
+            bool success = false;
+
+            try {
+                success = EncodeAndStore(request);
+            }
+            catch (std::exception& ex) {
+                GS_LOG_MSG(warning, "GsImageService - failed to publish " + request.name + " - " + ex.what());
+            }
+
+            if (success && request.on_published) {
+                try {
+                    request.on_published();
+                }
+                catch (std::exception& ex) {
+                    GS_LOG_MSG(error, "GsImageService - on_published callback failed. ERROR: *** " + std::string(ex.what()) + " ***");
+                }
+            }
+        }
+    }
+
+    void GsImageService::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kImageServiceHttpEnabled", kImageServiceHttpEnabled);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kImageServiceMaxImages", kImageServiceMaxImages);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kImageServiceMaxWidth", kImageServiceMaxWidth);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kImageServiceJpegQuality", kImageServiceJpegQuality);
+    }
+
+    std::string GsImageService::GetImagePath(const std::string& name) {
+        return kImagePathPrefix + GetImageStem(name) + ".jpg";
+    }
+
+    bool GsImageService::IsRunning() {
+        return image_service_started && GsHttpServer::IsRunning();
+    }
+
+    bool GsImageService::Publish(const std::string& name, const cv::Mat& img,
+                                 std::vector<GsImageWriter::CircleAnnotation> annotations,
+                                 const std::function<void()>& on_published) {
+
+        if (!IsRunning() || img.empty()) {
+            return false;
+        }
+
+        PublishRequest request{ GetImageStem(name), img, std::move(annotations), on_published };
+
+        {
+            std::lock_guard<std::mutex> lock(encoder_mutex);
+
+            if (encoder_exiting) {
+                return false;
+            }
+
+            // A queued image that has not been encoded yet is superseded by the new one
+            bool superseded = false;
+
+            for (PublishRequest& queued_request : encoder_queue) {
+                if (queued_request.name == request.name) {
+                    queued_request = std::move(request);
+                    superseded = true;
+                    break;
+                }
+            }
+
+            if (!superseded) {
+                encoder_queue.push_back(std::move(request));
+            }
+        }
+
+        encoder_queue_not_empty.notify_one();
+
+        return true;
+    }
+
+    void GsImageService::Start() {
+        if (!kImageServiceHttpEnabled || image_service_started) {
+            return;
+        }
+
+        const bool added = GsHttpServer::Get(kImagePathPrefix + R"(([^/]+)\.jpg)", [](const httplib::Request& http_request, httplib::Response& response) {
+            ServedImage served_image;
+
+            {
+                std::lock_guard<std::mutex> lock(images_mutex);
+
+                auto it = images.find(http_request.matches[1].str());
+                if (it == images.end()) {
+                    response.status = 404;
+                    return;
+                }
+
+                served_image = it->second;
+            }
+
+            response.set_header("ETag", served_image.etag);
+            // The browser may keep the image, but has to check that it is still the latest
+            response.set_header("Cache-Control", "no-cache");
+            response.set_header("Access-Control-Allow-Origin", "*");
+
+            if (http_request.get_header_value("If-None-Match") == served_image.etag) {
+                response.status = 304;
+                return;
+            }
+
+            response.set_content(served_image.jpeg->data(), served_image.jpeg->size(), "image/jpeg");
+        });
+
+        if (!added) {
+            GS_LOG_MSG(warning, "GsImageService - kImageServiceHttpEnabled is set, but the HTTP server is off (see kHttpServerPort).  "
+                                "Web-server images will be written to files instead.");
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(encoder_mutex);
+            encoder_exiting = false;
+        }
+
+        encoder_thread = std::thread(&ProcessPublishRequests);
+        image_service_started = true;
+
+        GS_LOG_MSG(info, "GsImageService - serving web-server images at " + GsHttpServer::GetUrl(kImagePathPrefix));
+    }
+
+    void GsImageService::Stop() {
+        if (!image_service_started) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(encoder_mutex);
+            encoder_exiting = true;
+        }
+
+        encoder_queue_not_empty.notify_all();
+
+        if (encoder_thread.joinable()) {
+            encoder_thread.join();
+        }
+
+        // The route stays on the GsHttpServer until it stops, but has nothing to serve
+        image_service_started = false;
+
+        std::lock_guard<std::mutex> lock(images_mutex);
+        images.clear();
+    }
+
+}
+
+#endif // #ifdef __unix__
@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// In-memory image service for the web UI.  Rather than writing each web-server image as a
+// full-resolution PNG to the share directory (for the web server to read and re-send), the
+// latest few images are kept here as JPEGs, scaled down to the width the UI shows them at,
+// and served directly from the GsHttpServer as GET /images/<name>.jpg.
+// Each image is encoded once, on the service's own thread, when it is published, and is then
+// served as often as it is asked for.  Every published image has a new ETag, so a browser
+// that already has the latest version of an image just gets a 304 back.
+// The service is off unless kImageServiceHttpEnabled is set (and the GsHttpServer is on),
+// in which case the web-server images are no longer written to kWebServerShareDirectory.
+
+#pragma once
+
+#ifdef __unix__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "gs_image_writer.h"
+
+namespace golf_sim {
+
+    class GsImageService {
+
+    public:
+        // False (the default) means no image service
+        static bool kImageServiceHttpEnabled;
+
+        // The number of (differently-named) images that are kept.  The least recently
+        // published image is dropped to make room for a new one.
+        static int kImageServiceMaxImages;
+
+        // Wider images are scaled down to this width before they are encoded.  0 means full size.
+        static int kImageServiceMaxWidth;
+
+        static int kImageServiceJpegQuality;
+
+        static void LoadConfigurationValues();
+
+        // Adds the image route to the GsHttpServer.  Does nothing unless
+        // kImageServiceHttpEnabled is set.
+        static void Start();
+        static void Stop();
+
+        // True once Start() has added the route and the GsHttpServer is listening
+        static bool IsRunning();
+
+        // Queues img (with the annotations drawn on a copy of it) to be encoded and then served
+        // as name.  Any extension on name is dropped.  The service owns img from here on, as
+        // with GsImageWriter::Write.  on_published, if set, is called (on the service's thread)
+        // once the image can be fetched.  Returns false if the service is not running.
+        static bool Publish(const std::string& name, const cv::Mat& img,
+                            std::vector<GsImageWriter::CircleAnnotation> annotations = {},
+                            const std::function<void()>& on_published = nullptr);
+
+        // E.g., "/images/ball_exposure_candidates.jpg" for "ball_exposure_candidates.png"
+        static std::string GetImagePath(const std::string& name);
+    };
+
+}
+
+#endif // #ifdef __unix__
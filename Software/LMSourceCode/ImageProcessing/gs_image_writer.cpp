@@ -0,0 +1,376 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+#include "gs_image_writer.h"
+#include "gs_jpeg_encoder.h"
+
+
+namespace golf_sim {
+
+    bool GsImageWriter::kUseAsyncImageWriter = false;
+    int GsImageWriter::kAsyncImageWriterMaxQueuedImages = 8;
+
+    // How often (in images written) to log the writer statistics
+    static const long kStatisticsLoggingInterval = 50;
+
+    GsImageWriter::EncodingPolicy GsImageWriter::encoding_policies_[(int)GsImageWriter::ArtifactClass::kNumArtifactClasses];
+
+    std::deque<GsImageWriter::WriteRequest> GsImageWriter::queue_;
+    std::mutex GsImageWriter::mutex_;
+    GsBackgroundJob GsImageWriter::writer_job_(&GsImageWriter::Process);
+    bool GsImageWriter::exiting_ = false;
+
+    std::atomic<long> GsImageWriter::number_written_{ 0 };
+    std::atomic<long> GsImageWriter::number_dropped_{ 0 };
+    std::atomic<long> GsImageWriter::number_failed_{ 0 };
+    double GsImageWriter::total_write_ms_ = 0.0;
+    double GsImageWriter::max_write_ms_ = 0.0;
+
+
+    void GsImageWriter::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.logging.kUseAsyncImageWriter", kUseAsyncImageWriter);
+        GolfSimConfiguration::SetConstant("gs_config.logging.kAsyncImageWriterMaxQueuedImages", kAsyncImageWriterMaxQueuedImages);
+
+        if (kAsyncImageWriterMaxQueuedImages < 1) {
+            GS_LOG_MSG(warning, "kAsyncImageWriterMaxQueuedImages was < 1.  Using 1.");
+            kAsyncImageWriterMaxQueuedImages = 1;
+        }
+
+        GS_LOG_TRACE_MSG(trace, "GsImageWriter - kUseAsyncImageWriter = " + std::to_string(kUseAsyncImageWriter) +
+            ", kAsyncImageWriterMaxQueuedImages = " + std::to_string(kAsyncImageWriterMaxQueuedImages));
+    }
+
+        LoadEncodingPolicy("gs_config.logging.kLogImage", encoding_policies_[(int)ArtifactClass::kLogImage]);
+        LoadEncodingPolicy("gs_config.logging.kWebserverImage", encoding_policies_[(int)ArtifactClass::kWebserverImage]);
+        LoadEncodingPolicy("gs_config.logging.kClubFrameImage", encoding_policies_[(int)ArtifactClass::kClubFrame]);
+    }
+
+    void GsImageWriter::LoadEncodingPolicy(const std::string& config_prefix, EncodingPolicy& policy) {
+
+        std::string encoding_string = "png";
+        GolfSimConfiguration::SetConstant(config_prefix + "Encoding", encoding_string);
+        GolfSimConfiguration::SetConstant(config_prefix + "PngCompressionLevel", policy.png_compression_level);
+        GolfSimConfiguration::SetConstant(config_prefix + "JpegQuality", policy.jpeg_quality);
+        GolfSimConfiguration::SetConstant(config_prefix + "DownscaleFactor", policy.downscale_factor);
+
+        std::transform(encoding_string.begin(), encoding_string.end(), encoding_string.begin(), ::tolower);
+
+        if (encoding_string == "png") {
+            policy.encoding = ImageEncoding::kPng;
+        }
+        else if (encoding_string == "jpeg" || encoding_string == "jpg") {
+            policy.encoding = ImageEncoding::kJpeg;
+        }
+        else if (encoding_string == "raw") {
+            policy.encoding = ImageEncoding::kRaw;
+        }
+        else {
+            GS_LOG_MSG(warning, config_prefix + "Encoding of '" + encoding_string + "' is not recognized.  Using png.");
+            policy.encoding = ImageEncoding::kPng;
+        }
+
+        policy.png_compression_level = std::clamp(policy.png_compression_level, 0, 9);
+        policy.jpeg_quality = std::clamp(policy.jpeg_quality, 1, 100);
+
+        if (policy.downscale_factor <= 0.0 || policy.downscale_factor > 1.0) {
+            GS_LOG_MSG(warning, config_prefix + "DownscaleFactor must be in (0, 1].  Using 1.0.");
+            policy.downscale_factor = 1.0;
+        }
+
+        GS_LOG_TRACE_MSG(trace, config_prefix + " encoding = " + encoding_string +
+            ", png_compression_level = " + std::to_string(policy.png_compression_level) +
+            ", jpeg_quality = " + std::to_string(policy.jpeg_quality) +
+            ", downscale_factor = " + std::to_string(policy.downscale_factor));
+    }
+
+    const GsImageWriter::EncodingPolicy& GsImageWriter::GetEncodingPolicy(ArtifactClass artifact_class) {
+        return encoding_policies_[(int)artifact_class];
+    }
+
+    std::string GsImageWriter::GetEncodedFileName(const std::string& file_name, ArtifactClass artifact_class) {
+
+        std::string base_name(file_name);
+        const std::string png_extension(".png");
+
+        if (base_name.size() >= png_extension.size() &&
+            base_name.compare(base_name.size() - png_extension.size(), png_extension.size(), png_extension) == 0) {
+            base_name.erase(base_name.size() - png_extension.size());
+        }
+
+        switch (GetEncodingPolicy(artifact_class).encoding) {
+            case ImageEncoding::kJpeg:
+                return base_name + ".jpg";
+            case ImageEncoding::kRaw:
+                return base_name + ".raw";
+            case ImageEncoding::kPng:
+            default:
+                return base_name + png_extension;
+        }
+    }
+
+    bool GsImageWriter::WriteRaw(const std::string& file_name, const cv::Mat& img) {
+
+        // The sidecar is just enough to get the pixels back, e.g., with
+        // cv::Mat(rows, cols, type, buffer)
+        std::ofstream header_file(file_name + ".hdr");
+        if (!header_file) {
+            return false;
+        }
+        header_file << "rows=" << img.rows << "\n"
+                    << "cols=" << img.cols << "\n"
+                    << "type=" << img.type() << "\n"
+                    << "channels=" << img.channels() << "\n"
+                    << "element_size=" << img.elemSize() << "\n";
+        header_file.close();
+
+        std::ofstream raw_file(file_name, std::ios::binary);
+        if (!raw_file) {
+            return false;
+        }
+
+        const size_t row_bytes = img.cols * img.elemSize();
+
+        if (img.isContinuous()) {
+            raw_file.write(reinterpret_cast<const char*>(img.data), row_bytes * img.rows);
+        }
+        else {
+            for (int row = 0; row < img.rows; row++) {
+                raw_file.write(reinterpret_cast<const char*>(img.ptr(row)), row_bytes);
+            }
+        }
+
+        return raw_file.good();
+    }
+
+    bool GsImageWriter::EncodeAndWrite(const std::string& file_name, const cv::Mat& img, const EncodingPolicy& policy) {
+
+        cv::Mat img_to_write = img;
+
+        if (policy.downscale_factor < 1.0) {
+            cv::resize(img, img_to_write, cv::Size(), policy.downscale_factor, policy.downscale_factor, cv::INTER_AREA);
+        }
+
+        switch (policy.encoding) {
+            case ImageEncoding::kJpeg:
+                return GsJpegEncoder::EncodeToFile(file_name, img_to_write, policy.jpeg_quality);
+
+            case ImageEncoding::kRaw:
+                return WriteRaw(file_name, img_to_write);
+
+            case ImageEncoding::kPng:
+            default:
+                return cv::imwrite(file_name, img_to_write, std::vector<int>{ cv::IMWRITE_PNG_COMPRESSION, policy.png_compression_level });
+        }
+    }
+
+    bool GsImageWriter::WriteNow(const WriteRequest& request) {
+
+        auto start_time = std::chrono::steady_clock::now();
+        bool success = false;
+
+        try {
+            cv::Mat img = request.img;
+
+            if (!request.annotations.empty()) {
+                img = request.img.clone();
+
+                for (const CircleAnnotation& annotation : request.annotations) {
+                    LoggingTools::DrawCircleOutlineAndCenter(img, annotation.circle, annotation.label, annotation.ordinal, annotation.de_emphasize);
+                }
+            }
+
+            success = EncodeAndWrite(request.file_name, img, GetEncodingPolicy(request.artifact_class));
+        }
+        catch (std::exception& ex) {
+            GS_LOG_TRACE_MSG(warning, "Exception! - failed to imwrite with fname = " + request.file_name + " - " + ex.what());
+            success = false;
+        }
+
+        double write_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+        if (!success) {
+            number_failed_++;
+            GS_LOG_MSG(warning, "GsImageWriter - could not save to file name: " + request.file_name);
+            return false;
+        }
+
+        long written = ++number_written_;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            total_write_ms_ += write_ms;
+            max_write_ms_ = std::max(max_write_ms_, write_ms);
+        }
+
+        GS_LOG_TRACE_MSG(trace, "Logged image to file: " + request.file_name + " (" + std::to_string((int)write_ms) + " ms)");
+
+        if (written % kStatisticsLoggingInterval == 0) {
+            GS_LOG_MSG(info, "GsImageWriter statistics: " + GetStatistics());
+        }
+
+        if (request.on_written) {
+            try {
+                request.on_written();
+            }
+            catch (std::exception& ex) {
+                GS_LOG_MSG(error, "GsImageWriter - on_written callback failed. ERROR: *** " + std::string(ex.what()) + " ***");
+            }
+        }
+
+        return true;
+    }
+
+    bool GsImageWriter::Write(const std::string& file_name, const cv::Mat& img,
+                              ArtifactClass artifact_class,
+                              const std::function<void()>& on_written) {
+
+        if (img.empty()) {
+            GS_LOG_MSG(warning, "GsImageWriter::Write - image was empty - ignoring.");
+            return false;
+        }
+
+        return Submit(WriteRequest{ GetEncodedFileName(file_name, artifact_class), img, artifact_class, on_written });
+    }
+
+    bool GsImageWriter::WriteAnnotated(const std::string& file_name, const cv::Mat& img,
+                                       std::vector<CircleAnnotation> annotations,
+                                       ArtifactClass artifact_class,
+                                       const std::function<void()>& on_written) {
+
+        if (img.empty()) {
+            GS_LOG_MSG(warning, "GsImageWriter::WriteAnnotated - image was empty - ignoring.");
+            return false;
+        }
+
+        return Submit(WriteRequest{ GetEncodedFileName(file_name, artifact_class), img, artifact_class, on_written, std::move(annotations) });
+    }
+
+    bool GsImageWriter::Submit(WriteRequest&& request) {
+
+        if (!kUseAsyncImageWriter) {
+            return WriteNow(request);
+        }
+
+        bool too_late_to_queue = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            too_late_to_queue = exiting_;
+
+            if (!too_late_to_queue) {
+                // The newest images are the ones most likely to be looked at, so drop
+                // the oldest if the writer has fallen behind.  An image that something is
+                // waiting on (i.e., that has an on_written callback) is never dropped, as
+                // its callback would then never be called.  There are only ever a few of
+                // those per shot, so the queue may go over its limit for them.
+                while ((int)queue_.size() >= kAsyncImageWriterMaxQueuedImages) {
+                    auto victim = std::find_if(queue_.begin(), queue_.end(),
+                        [](const WriteRequest& queued_request) { return !queued_request.on_written; });
+
+                    if (victim == queue_.end()) {
+                        GS_LOG_MSG(warning, "GsImageWriter - queue full of images with callbacks.  Queueing " + request.file_name + " anyway.");
+                        break;
+                    }
+
+                    GS_LOG_MSG(warning, "GsImageWriter - queue full.  Dropping image: " + victim->file_name);
+                    queue_.erase(victim);
+                    number_dropped_++;
+                    GsMetrics::Increment(GsMetrics::Counter::kDroppedImages);
+                }
+
+                queue_.push_back(std::move(request));
+            }
+        }
+
+        if (too_late_to_queue) {
+            // Nothing is flushed after shutdown, so do it here
+            return WriteNow(request);
+        }
+
+        writer_job_.Schedule();
+
+        return true;
+    }
+
+    bool GsImageWriter::Process() {
+        WriteRequest request;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (queue_.empty()) {
+                return false;
+            }
+
+            request = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        // One image per turn, so that the other background jobs are not held up
+        WriteNow(request);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !queue_.empty();
+    }
+
+    void GsImageWriter::Flush() {
+        writer_job_.WaitUntilIdle();
+    }
+
+    void GsImageWriter::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (exiting_) {
+                return;
+            }
+
+            GS_LOG_TRACE_MSG(trace, "GsImageWriter::Shutdown - flushing " + std::to_string(queue_.size()) + " queued images.");
+            exiting_ = true;
+        }
+
+        // Whatever is left is written first
+        writer_job_.WaitUntilIdle();
+
+        GS_LOG_MSG(info, "GsImageWriter statistics at shutdown: " + GetStatistics());
+        GS_LOG_MSG(info, "GsJpegEncoder statistics at shutdown: " + GsJpegEncoder::GetStatistics());
+    }
+
+    std::string GsImageWriter::GetStatistics() {
+        long written = number_written_;
+        double total_ms;
+        double max_ms;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            total_ms = total_write_ms_;
+            max_ms = max_write_ms_;
+        }
+
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(1)
+          << "written=" << written
+          << ", dropped=" << number_dropped_.load()
+          << ", failed=" << number_failed_.load()
+          << ", average_ms=" << ((written > 0) ? (total_ms / written) : 0.0)
+          << ", max_ms=" << max_ms;
+
+        return s.str();
+    }
+
+}
@@ -0,0 +1,142 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Background image-writing service.  Encoding a full-resolution PNG takes tens of ms,
+// which is too long to do on the FSM thread during (for example) the post-hit processing.
+// Images are instead queued here and encoded and written on the shared, low-priority
+// GsBackgroundWorker.
+// If the queue fills up, the oldest queued image is dropped, unless something is waiting
+// for it to be written.
+// Each class of image (artifact) also has its own encoding policy, so that, for example,
+// the many diagnostic log images can be written as fast JPEGs or raw dumps while the
+// web-server images stay PNGs.
+// Ball outlines and labels can also be recorded as annotations against the (unchanging)
+// source image, so that the copy of the image they are drawn on is only made on the
+// background worker, and only for images that are actually written.
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "worker_thread.h"
+
+#include "gs_globals.h"
+
+namespace golf_sim {
+
+class GsImageWriter {
+public:
+    enum class ArtifactClass {
+        kLogImage = 0,
+        kWebserverImage = 1,
+        kClubFrame = 2,
+        kNumArtifactClasses = 3
+    };
+
+    enum class ImageEncoding {
+        kPng = 0,
+        kJpeg = 1,
+        // The uncompressed pixel buffer, plus a small ".hdr" text sidecar that
+        // describes its size and type.  The fastest possible format to write.
+        kRaw = 2
+    };
+
+    struct EncodingPolicy {
+        ImageEncoding encoding = ImageEncoding::kPng;
+        int png_compression_level = 1;
+        int jpeg_quality = 90;
+        // 1.0 writes the image at full resolution.  0.5 halves each dimension.
+        double downscale_factor = 1.0;
+    };
+
+    // Drawn with LoggingTools::DrawCircleOutlineAndCenter
+    struct CircleAnnotation {
+        GsCircle circle;
+        std::string label;
+        int ordinal = 0;
+        bool de_emphasize = false;
+    };
+
+    // If false, every image is written synchronously by the caller, as before
+    static bool kUseAsyncImageWriter;
+    static int kAsyncImageWriterMaxQueuedImages;
+
+    static void LoadConfigurationValues();
+
+    static const EncodingPolicy& GetEncodingPolicy(ArtifactClass artifact_class);
+
+    // Returns the name that file_name will actually be written as, which will have a
+    // different extension if the artifact class is not encoded as a PNG.
+    static std::string GetEncodedFileName(const std::string& file_name, ArtifactClass artifact_class);
+
+    // Writes img to file_name (with the extension changed to suit the artifact class's
+    // encoding), either now or (usually) later on the background worker.
+    // The writer owns the image from here on, so the caller must not change its pixels
+    // afterward. Pass a clone if that matters.
+    // on_written, if set, is called (on the background worker) after a successful write, and
+    // the image is then never dropped from a full queue.
+    // Returns false only if a synchronous write failed.
+    static bool Write(const std::string& file_name, const cv::Mat& img,
+                      ArtifactClass artifact_class = ArtifactClass::kLogImage,
+                      const std::function<void()>& on_written = nullptr);
+
+    // Like Write, but the annotations are drawn onto a copy of img just before it is encoded.
+    // img itself is shared with the writer rather than copied, so again, the caller must
+    // not change its pixels afterward.
+    static bool WriteAnnotated(const std::string& file_name, const cv::Mat& img,
+                               std::vector<CircleAnnotation> annotations,
+                               ArtifactClass artifact_class = ArtifactClass::kLogImage,
+                               const std::function<void()>& on_written = nullptr);
+
+    // Blocks until everything that has been queued so far has been written (or dropped)
+    static void Flush();
+
+    // Flushes, and then writes any later images right away.  Called once at shutdown.
+    static void Shutdown();
+
+    // E.g., "written=10, dropped=0, failed=0, average_ms=23.1, max_ms=41.0"
+    static std::string GetStatistics();
+
+private:
+    struct WriteRequest {
+        std::string file_name;
+        cv::Mat img;
+        ArtifactClass artifact_class = ArtifactClass::kLogImage;
+        std::function<void()> on_written;
+        std::vector<CircleAnnotation> annotations;
+    };
+
+    static bool Submit(WriteRequest&& request);
+
+    static void LoadEncodingPolicy(const std::string& config_prefix, EncodingPolicy& policy);
+    static bool EncodeAndWrite(const std::string& file_name, const cv::Mat& img, const EncodingPolicy& policy);
+    static bool WriteRaw(const std::string& file_name, const cv::Mat& img);
+    static bool WriteNow(const WriteRequest& request);
+    // Writes the oldest queued image.  Run by writer_job_.
+    static bool Process();
+
+    static EncodingPolicy encoding_policies_[(int)ArtifactClass::kNumArtifactClasses];
+
+    static std::deque<WriteRequest> queue_;
+    static std::mutex mutex_;
+    static GsBackgroundJob writer_job_;
+    static bool exiting_;
+
+    static std::atomic<long> number_written_;
+    static std::atomic<long> number_dropped_;
+    static std::atomic<long> number_failed_;
+    // Guarded by mutex_
+    static double total_write_ms_;
+    static double max_write_ms_;
+};
+
+}
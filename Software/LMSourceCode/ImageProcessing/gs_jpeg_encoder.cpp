@@ -0,0 +1,492 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+#include <opencv2/imgcodecs.hpp>
+
+#ifdef __unix__
+#include <csetjmp>
+#include <cstdio>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <linux/videodev2.h>
+
+#include <jpeglib.h>
+#endif
+
+#include "logging_tools.h"
+#include "gs_config.h"
+
+#include "gs_jpeg_encoder.h"
+
+namespace golf_sim {
+
+    bool GsJpegEncoder::kUseHardwareJpegEncoder = true;
+    std::string GsJpegEncoder::kHardwareJpegEncoderDevice = "/dev/video31";
+
+    static std::atomic<long> number_hardware_encoded{ 0 };
+    static std::atomic<long> number_software_encoded{ 0 };
+    static std::atomic<long> number_hardware_failed{ 0 };
+
+#ifdef __unix__
+
+#if JPEG_LIB_VERSION_MAJOR > 9 || (JPEG_LIB_VERSION_MAJOR == 9 && JPEG_LIB_VERSION_MINOR >= 4)
+    typedef size_t jpeg_mem_len_t;
+#else
+    typedef unsigned long jpeg_mem_len_t;
+#endif
+
+    // How long to wait for the hardware to encode one image before giving up on it
+    static const int kHardwareEncodeTimeoutMs = 2000;
+
+    static int xioctl(int fd, unsigned long ctl, void* arg) {
+        int ret;
+        int num_tries = 10;
+        do {
+            ret = ioctl(fd, ctl, arg);
+        } while (ret == -1 && errno == EINTR && num_tries-- > 0);
+        return ret;
+    }
+
+    // One open V4L2 image-encoder device, with a single memory-mapped buffer on each side.
+    // It stays configured for the last image size and format it encoded.
+    class HardwareJpegSession {
+
+    public:
+        enum class Result {
+            kEncoded,
+            // The hardware cannot take this image (e.g., its size), but may take the next one
+            kUnsupported,
+            kFailed
+        };
+
+        ~HardwareJpegSession() {
+            Close();
+        }
+
+        Result Encode(const cv::Mat& img, int quality, std::vector<uchar>& jpeg) {
+
+            const uint32_t pixel_format = (img.channels() == 1) ? V4L2_PIX_FMT_YUV420 : V4L2_PIX_FMT_BGR24;
+
+            if (fd_ < 0 || img.cols != width_ || img.rows != height_ || pixel_format != pixel_format_) {
+                const Result open_result = Open(img.cols, img.rows, pixel_format);
+
+                if (open_result != Result::kEncoded) {
+                    Close();
+                    return open_result;
+                }
+            }
+
+            if (quality != quality_) {
+                v4l2_control ctrl = {};
+                ctrl.id = V4L2_CID_JPEG_COMPRESSION_QUALITY;
+                ctrl.value = quality;
+                if (xioctl(fd_, VIDIOC_S_CTRL, &ctrl) < 0) {
+                    GS_LOG_MSG(warning, "GsJpegEncoder - could not set the hardware JPEG quality.");
+                    return Result::kFailed;
+                }
+                quality_ = quality;
+            }
+
+            CopyIntoOutputBuffer(img);
+
+            v4l2_plane capture_plane = {};
+            v4l2_buffer capture_buffer = {};
+            capture_buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+            capture_buffer.memory = V4L2_MEMORY_MMAP;
+            capture_buffer.index = 0;
+            capture_buffer.length = 1;
+            capture_buffer.m.planes = &capture_plane;
+
+            v4l2_plane output_plane = {};
+            output_plane.bytesused = output_size_;
+            output_plane.length = output_length_;
+            v4l2_buffer output_buffer = {};
+            output_buffer.type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
+            output_buffer.memory = V4L2_MEMORY_MMAP;
+            output_buffer.index = 0;
+            output_buffer.field = V4L2_FIELD_NONE;
+            output_buffer.length = 1;
+            output_buffer.m.planes = &output_plane;
+
+            if (xioctl(fd_, VIDIOC_QBUF, &capture_buffer) < 0 || xioctl(fd_, VIDIOC_QBUF, &output_buffer) < 0) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - could not queue the hardware encoder buffers.");
+                return Result::kFailed;
+            }
+
+            pollfd poll_fd = { fd_, POLLIN, 0 };
+            if (poll(&poll_fd, 1, kHardwareEncodeTimeoutMs) <= 0) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - the hardware encoder timed out.");
+                return Result::kFailed;
+            }
+
+            if (xioctl(fd_, VIDIOC_DQBUF, &capture_buffer) < 0 || xioctl(fd_, VIDIOC_DQBUF, &output_buffer) < 0) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - could not dequeue the hardware encoder buffers.");
+                return Result::kFailed;
+            }
+
+            if (capture_buffer.flags & V4L2_BUF_FLAG_ERROR || capture_plane.bytesused == 0) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - the hardware encoder reported an error.");
+                return Result::kFailed;
+            }
+
+            const uchar* encoded = (const uchar*)capture_mem_ + capture_plane.data_offset;
+            jpeg.assign(encoded, encoded + (capture_plane.bytesused - capture_plane.data_offset));
+
+            return Result::kEncoded;
+        }
+
+        void Close() {
+            if (fd_ < 0) {
+                return;
+            }
+
+            v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
+            xioctl(fd_, VIDIOC_STREAMOFF, &type);
+            type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+            xioctl(fd_, VIDIOC_STREAMOFF, &type);
+
+            if (output_mem_ != MAP_FAILED) {
+                munmap(output_mem_, output_length_);
+                output_mem_ = MAP_FAILED;
+            }
+
+            if (capture_mem_ != MAP_FAILED) {
+                munmap(capture_mem_, capture_length_);
+                capture_mem_ = MAP_FAILED;
+            }
+
+            close(fd_);
+            fd_ = -1;
+            width_ = 0;
+            height_ = 0;
+            quality_ = -1;
+        }
+
+    private:
+        // kEncoded here means ready to encode
+        Result Open(int width, int height, uint32_t pixel_format) {
+
+            Close();
+
+            fd_ = open(GsJpegEncoder::kHardwareJpegEncoderDevice.c_str(), O_RDWR, 0);
+            if (fd_ < 0) {
+                GS_LOG_TRACE_MSG(trace, "GsJpegEncoder - no hardware encoder at " + GsJpegEncoder::kHardwareJpegEncoderDevice);
+                return Result::kFailed;
+            }
+
+            // Other devices (e.g., the Pi 5's ISP) can have the same name, so make sure that this
+            // is a memory-to-memory device that makes JPEGs
+            v4l2_capability capability = {};
+            if (xioctl(fd_, VIDIOC_QUERYCAP, &capability) < 0 || !(capability.device_caps & V4L2_CAP_VIDEO_M2M_MPLANE)) {
+                GS_LOG_MSG(info, "GsJpegEncoder - " + GsJpegEncoder::kHardwareJpegEncoderDevice + " is not a memory-to-memory encoder.");
+                return Result::kFailed;
+            }
+
+            bool makes_jpegs = false;
+            v4l2_fmtdesc format_description = {};
+            format_description.type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+            while (xioctl(fd_, VIDIOC_ENUM_FMT, &format_description) == 0) {
+                makes_jpegs = makes_jpegs || format_description.pixelformat == V4L2_PIX_FMT_JPEG;
+                format_description.index++;
+            }
+
+            if (!makes_jpegs) {
+                GS_LOG_MSG(info, "GsJpegEncoder - " + GsJpegEncoder::kHardwareJpegEncoderDevice + " is not a JPEG encoder.");
+                return Result::kFailed;
+            }
+
+            v4l2_format format = {};
+            format.type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
+            format.fmt.pix_mp.width = width;
+            format.fmt.pix_mp.height = height;
+            format.fmt.pix_mp.pixelformat = pixel_format;
+            format.fmt.pix_mp.field = V4L2_FIELD_NONE;
+            format.fmt.pix_mp.colorspace = V4L2_COLORSPACE_JPEG;
+            format.fmt.pix_mp.num_planes = 1;
+            if (xioctl(fd_, VIDIOC_S_FMT, &format) < 0 || format.fmt.pix_mp.pixelformat != pixel_format ||
+                (int)format.fmt.pix_mp.width != width || (int)format.fmt.pix_mp.height != height) {
+                GS_LOG_MSG(info, "GsJpegEncoder - the hardware encoder does not take " + std::to_string(width) + "x" +
+                                 std::to_string(height) + " images of this type.");
+                return Result::kUnsupported;
+            }
+
+            output_stride_ = format.fmt.pix_mp.plane_fmt[0].bytesperline;
+            output_size_ = format.fmt.pix_mp.plane_fmt[0].sizeimage;
+
+            format = {};
+            format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+            format.fmt.pix_mp.width = width;
+            format.fmt.pix_mp.height = height;
+            format.fmt.pix_mp.pixelformat = V4L2_PIX_FMT_JPEG;
+            format.fmt.pix_mp.field = V4L2_FIELD_NONE;
+            format.fmt.pix_mp.num_planes = 1;
+            format.fmt.pix_mp.plane_fmt[0].sizeimage = (uint32_t)width * height * 3 / 2;
+            if (xioctl(fd_, VIDIOC_S_FMT, &format) < 0) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - could not set the hardware encoder's JPEG format.");
+                return Result::kFailed;
+            }
+
+            if (!MapBuffer(V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE, output_mem_, output_length_) ||
+                !MapBuffer(V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE, capture_mem_, capture_length_)) {
+                return Result::kFailed;
+            }
+
+            v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
+            if (xioctl(fd_, VIDIOC_STREAMON, &type) < 0) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - could not start the hardware encoder's input.");
+                return Result::kFailed;
+            }
+            type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+            if (xioctl(fd_, VIDIOC_STREAMON, &type) < 0) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - could not start the hardware encoder's output.");
+                return Result::kFailed;
+            }
+
+            width_ = width;
+            height_ = height;
+            pixel_format_ = pixel_format;
+
+            GS_LOG_TRACE_MSG(trace, "GsJpegEncoder - hardware encoder configured for " + std::to_string(width) + "x" + std::to_string(height) + " images.");
+
+            return Result::kEncoded;
+        }
+
+        bool MapBuffer(v4l2_buf_type type, void*& mem, size_t& length) {
+
+            v4l2_requestbuffers request = {};
+            request.count = 1;
+            request.type = type;
+            request.memory = V4L2_MEMORY_MMAP;
+            if (xioctl(fd_, VIDIOC_REQBUFS, &request) < 0 || request.count < 1) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - could not get a hardware encoder buffer.");
+                return false;
+            }
+
+            v4l2_plane plane = {};
+            v4l2_buffer buffer = {};
+            buffer.type = type;
+            buffer.memory = V4L2_MEMORY_MMAP;
+            buffer.index = 0;
+            buffer.length = 1;
+            buffer.m.planes = &plane;
+            if (xioctl(fd_, VIDIOC_QUERYBUF, &buffer) < 0) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - could not query a hardware encoder buffer.");
+                return false;
+            }
+
+            length = plane.length;
+            mem = mmap(0, plane.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, plane.m.mem_offset);
+            if (mem == MAP_FAILED) {
+                GS_LOG_MSG(warning, "GsJpegEncoder - could not map a hardware encoder buffer.");
+                return false;
+            }
+
+            return true;
+        }
+
+        void CopyIntoOutputBuffer(const cv::Mat& img) {
+
+            uchar* destination = (uchar*)output_mem_;
+            const size_t row_bytes = (size_t)img.cols * img.elemSize();
+
+            for (int row = 0; row < img.rows; row++) {
+                memcpy(destination + (size_t)row * output_stride_, img.ptr(row), row_bytes);
+            }
+
+            if (pixel_format_ != V4L2_PIX_FMT_YUV420) {
+                return;
+            }
+
+            // A grey image is the luminance of a YUV420 image with no colour.  The driver may pad
+            // the planes' heights, so the chroma planes start where its buffer size says they do.
+            const size_t aligned_height = (size_t)output_size_ * 2 / (3 * output_stride_);
+            uchar* chroma = destination + aligned_height * output_stride_;
+            memset(chroma, 128, output_size_ - aligned_height * output_stride_);
+        }
+
+        int fd_ = -1;
+        int width_ = 0;
+        int height_ = 0;
+        uint32_t pixel_format_ = 0;
+        int quality_ = -1;
+
+        void* output_mem_ = MAP_FAILED;
+        size_t output_length_ = 0;
+        uint32_t output_stride_ = 0;
+        uint32_t output_size_ = 0;
+
+        void* capture_mem_ = MAP_FAILED;
+        size_t capture_length_ = 0;
+    };
+
+    // Only one image is encoded in hardware at a time
+    static std::mutex hardware_session_mutex;
+    static HardwareJpegSession hardware_session;
+    static std::atomic<bool> hardware_encoder_usable{ true };
+
+    struct JpegErrorManager {
+        jpeg_error_mgr manager;
+        jmp_buf jump_buffer;
+    };
+
+    static void OnJpegError(j_common_ptr cinfo) {
+        longjmp(((JpegErrorManager*)cinfo->err)->jump_buffer, 1);
+    }
+
+    // Note that nothing here may need destroying if libjpeg longjmp's out.
+    static bool EncodeWithLibJpeg(const cv::Mat& img, int quality, std::vector<uchar>& jpeg) {
+
+        jpeg_compress_struct cinfo;
+        JpegErrorManager error_manager;
+        unsigned char* encoded = nullptr;
+        jpeg_mem_len_t encoded_length = 0;
+
+#ifndef JCS_EXTENSIONS
+        // Without libjpeg-turbo's extensions, each BGR row is swapped to RGB here
+        std::vector<uchar> rgb_row(img.channels() == 3 ? img.cols * 3 : 0);
+#endif
+
+        cinfo.err = jpeg_std_error(&error_manager.manager);
+        error_manager.manager.error_exit = OnJpegError;
+
+        if (setjmp(error_manager.jump_buffer)) {
+            jpeg_destroy_compress(&cinfo);
+            free(encoded);
+            return false;
+        }
+
+        jpeg_create_compress(&cinfo);
+        jpeg_mem_dest(&cinfo, &encoded, &encoded_length);
+
+        cinfo.image_width = img.cols;
+        cinfo.image_height = img.rows;
+
+        if (img.channels() == 1) {
+            cinfo.input_components = 1;
+            cinfo.in_color_space = JCS_GRAYSCALE;
+        }
+        else {
+            cinfo.input_components = 3;
+#ifdef JCS_EXTENSIONS
+            cinfo.in_color_space = JCS_EXT_BGR;
+#else
+            cinfo.in_color_space = JCS_RGB;
+#endif
+        }
+
+        jpeg_set_defaults(&cinfo);
+        jpeg_set_quality(&cinfo, quality, TRUE);
+        cinfo.dct_method = JDCT_IFAST;
+
+        jpeg_start_compress(&cinfo, TRUE);
+
+        while (cinfo.next_scanline < cinfo.image_height) {
+            JSAMPROW row = (JSAMPROW)img.ptr(cinfo.next_scanline);
+#ifndef JCS_EXTENSIONS
+            if (img.channels() == 3) {
+                for (int x = 0; x < img.cols; x++) {
+                    rgb_row[3 * x] = row[3 * x + 2];
+                    rgb_row[3 * x + 1] = row[3 * x + 1];
+                    rgb_row[3 * x + 2] = row[3 * x];
+                }
+                row = rgb_row.data();
+            }
+#endif
+            jpeg_write_scanlines(&cinfo, &row, 1);
+        }
+
+        jpeg_finish_compress(&cinfo);
+        jpeg_destroy_compress(&cinfo);
+
+        jpeg.assign(encoded, encoded + encoded_length);
+        free(encoded);
+
+        return true;
+    }
+
+#endif // #ifdef __unix__
+
+    void GsJpegEncoder::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.logging.kUseHardwareJpegEncoder", kUseHardwareJpegEncoder);
+        GolfSimConfiguration::SetConstant("gs_config.logging.kHardwareJpegEncoderDevice", kHardwareJpegEncoderDevice);
+    }
+
+    bool GsJpegEncoder::Encode(const cv::Mat& img, int quality, std::vector<uchar>& jpeg) {
+
+        if (img.empty() || img.depth() != CV_8U || (img.channels() != 1 && img.channels() != 3)) {
+            // E.g., a 16-bit image.  OpenCV converts these.
+            return cv::imencode(".jpg", img, jpeg, std::vector<int>{ cv::IMWRITE_JPEG_QUALITY, quality });
+        }
+
+#ifdef __unix__
+        // If another thread has the hardware, it is quicker to do this one in software than to wait
+        if (kUseHardwareJpegEncoder && hardware_encoder_usable) {
+            std::unique_lock<std::mutex> lock(hardware_session_mutex, std::try_to_lock);
+
+            if (lock.owns_lock() && hardware_encoder_usable) {
+                const HardwareJpegSession::Result result = hardware_session.Encode(img, quality, jpeg);
+
+                if (result == HardwareJpegSession::Result::kEncoded) {
+                    number_hardware_encoded++;
+                    return true;
+                }
+
+                if (result == HardwareJpegSession::Result::kFailed) {
+                    hardware_session.Close();
+                    hardware_encoder_usable = false;
+                    number_hardware_failed++;
+                    GS_LOG_MSG(info, "GsJpegEncoder - not using the hardware JPEG encoder.  Falling back to libjpeg.");
+                }
+            }
+        }
+
+        if (EncodeWithLibJpeg(img, quality, jpeg)) {
+            number_software_encoded++;
+            return true;
+        }
+
+        GS_LOG_MSG(warning, "GsJpegEncoder - libjpeg could not encode the image.");
+        return false;
+#else
+        number_software_encoded++;
+        return cv::imencode(".jpg", img, jpeg, std::vector<int>{ cv::IMWRITE_JPEG_QUALITY, quality });
+#endif
+    }
+
+    bool GsJpegEncoder::EncodeToFile(const std::string& file_name, const cv::Mat& img, int quality) {
+
+        std::vector<uchar> jpeg;
+
+        if (!Encode(img, quality, jpeg)) {
+            return false;
+        }
+
+        std::ofstream jpeg_file(file_name, std::ios::binary);
+        if (!jpeg_file) {
+            return false;
+        }
+
+        jpeg_file.write(reinterpret_cast<const char*>(jpeg.data()), jpeg.size());
+
+        return jpeg_file.good();
+    }
+
+    std::string GsJpegEncoder::GetStatistics() {
+        return "hardware=" + std::to_string(number_hardware_encoded.load()) +
+               ", software=" + std::to_string(number_software_encoded.load()) +
+               ", hardware_failed=" + std::to_string(number_hardware_failed.load());
+    }
+
+}
@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// JPEG encoding for the image artifacts (log, web-server and club-strike frame images),
+// for the in-memory image service and for the live preview.
+// Where the Pi has a hardware JPEG encoder (the V4L2 memory-to-memory image encoder of the
+// Pi 4's codec block), the images are encoded there.  Otherwise (e.g., on a Pi 5, which
+// has no JPEG hardware), or if the hardware encoder is busy with another image, they are
+// encoded with libjpeg, whose libjpeg-turbo build on Raspberry Pi OS is NEON-accelerated,
+// using its fast DCT and without the colour-space conversion that cv::imencode would do.
+// If the hardware encoder fails, it is not used again, and everything goes to libjpeg.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    class GsJpegEncoder {
+
+    public:
+        static bool kUseHardwareJpegEncoder;
+        static std::string kHardwareJpegEncoderDevice;
+
+        static void LoadConfigurationValues();
+
+        // Encodes a CV_8UC1 or CV_8UC3 (BGR) image.  Safe to call from any thread.
+        static bool Encode(const cv::Mat& img, int quality, std::vector<uchar>& jpeg);
+
+        static bool EncodeToFile(const std::string& file_name, const cv::Mat& img, int quality);
+
+        // E.g., "hardware=120, software=3, hardware_failed=0"
+        static std::string GetStatistics();
+    };
+
+}
@@ -0,0 +1,360 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_camera.h"
+#include "gs_automated_testing.h"
+#include "gs_performance_state.h"
+#include "ball_image_proc.h"
+#include "libcamera_interface.h"
+#include "motion_detect.h"
+#include "EllipseDetectorYaed.h"
+#include "ED.h"
+#include "gs_ternary_image.h"
+
+#include "gs_kernel_benchmark.h"
+
+namespace golf_sim {
+
+    int GsKernelBenchmark::kKernelBenchmarkIterations = 50;
+    std::string GsKernelBenchmark::kKernelBenchmarkResultsFile;
+    std::string GsKernelBenchmark::kKernelBenchmarkFilter;
+
+
+    void GsKernelBenchmark::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.testing.kKernelBenchmarkIterations", kKernelBenchmarkIterations);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kKernelBenchmarkResultsFile", kKernelBenchmarkResultsFile);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kKernelBenchmarkFilter", kKernelBenchmarkFilter);
+
+        kKernelBenchmarkIterations = std::max(1, kKernelBenchmarkIterations);
+    }
+
+    bool GsKernelBenchmark::TimeKernel(const std::string& name, const std::function<void()>& kernel, std::vector<KernelResult>& results) {
+
+        if (!kKernelBenchmarkFilter.empty() && name.find(kKernelBenchmarkFilter) == std::string::npos) {
+            return false;
+        }
+
+        // The first call fills any caches (undistortion maps, Gabor kernels, model weights)
+        kernel();
+
+        std::vector<double> times_us(kKernelBenchmarkIterations);
+
+        for (int i = 0; i < kKernelBenchmarkIterations; i++) {
+            const auto start_time = std::chrono::steady_clock::now();
+            kernel();
+            times_us[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time).count();
+        }
+
+        std::sort(times_us.begin(), times_us.end());
+
+        KernelResult result;
+        result.name = name;
+        result.iterations = kKernelBenchmarkIterations;
+        result.min_us = times_us.front();
+        result.median_us = times_us[times_us.size() / 2];
+        result.p95_us = times_us[std::min(times_us.size() - 1, (size_t)(0.95 * times_us.size()))];
+        for (const double t : times_us) {
+            result.mean_us += t;
+        }
+        result.mean_us /= times_us.size();
+
+        std::cout << std::fixed << std::setprecision(1) << std::left << std::setw(48) << name << std::right
+            << " median " << std::setw(10) << result.median_us << "us, min " << std::setw(10) << result.min_us
+            << "us, p95 " << std::setw(10) << result.p95_us << "us\n";
+
+        results.push_back(result);
+        return true;
+    }
+
+    std::string GsKernelBenchmark::ResultsToJson(const std::string& fixture_filename, const std::vector<KernelResult>& results) {
+
+        const int soc_temperature_millic = GsPerformanceState::ReadSocTemperatureMilliC();
+
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(1);
+        s << "{\"fixture\":\"" << fixture_filename << "\",\"soc_temp_c\":";
+        if (soc_temperature_millic < 0) {
+            s << "null";
+        }
+        else {
+            s << soc_temperature_millic / 1000.0;
+        }
+        s << ",\"kernels\":[";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const KernelResult& r = results[i];
+            s << (i == 0 ? "" : ",") << "{\"name\":\"" << r.name << "\",\"iterations\":" << r.iterations
+                << ",\"min_us\":" << r.min_us << ",\"median_us\":" << r.median_us
+                << ",\"mean_us\":" << r.mean_us << ",\"p95_us\":" << r.p95_us << "}";
+        }
+
+        s << "]}";
+        return s.str();
+    }
+
+    bool GsKernelBenchmark::Run() {
+
+        LoadConfigurationValues();
+
+        std::string kAutomatedTestSuiteDirectory;
+        std::string kAutomatedTestExpectedResultsCSV;
+
+        GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestSuiteDirectory", kAutomatedTestSuiteDirectory);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestExpectedResultsCSV", kAutomatedTestExpectedResultsCSV);
+
+        std::vector<GsAutomatedTesting::FinalResultsTestScenario> tests;
+
+        try {
+            if (!GsAutomatedTesting::ReadExpectedResults(kAutomatedTestSuiteDirectory + kAutomatedTestExpectedResultsCSV, tests)) {
+                GS_LOG_MSG(error, "GsKernelBenchmark - Could not ReadExpectedResults().");
+                return false;
+            }
+        }
+        catch (std::exception& ex) {
+            GS_LOG_MSG(error, "GsKernelBenchmark - Exception! - " + std::string(ex.what()));
+            return false;
+        }
+
+        tests.erase(std::remove_if(tests.begin(), tests.end(), [](const GsAutomatedTesting::FinalResultsTestScenario& t) { return t.ignore_shot; }), tests.end());
+
+        if (tests.empty() || !GsAutomatedTesting::FindFinalResultsTestImages(kAutomatedTestSuiteDirectory, tests)) {
+            GS_LOG_MSG(error, "GsKernelBenchmark - No test shot to use as the fixture.");
+            return false;
+        }
+
+        const std::string& fixture_filename = tests[0].teed_ball_filename;
+        const cv::Mat teed_ball_img = cv::imread(tests[0].teed_ball_filename, cv::IMREAD_COLOR);
+        const cv::Mat strobed_balls_img = cv::imread(tests[0].strobed_ball_filename, cv::IMREAD_COLOR);
+
+        if (teed_ball_img.empty() || strobed_balls_img.empty()) {
+            GS_LOG_MSG(error, "GsKernelBenchmark - Could not read the images for shot " + std::to_string(tests[0].shot_number));
+            return false;
+        }
+
+        cv::Mat teed_ball_gray;
+        cv::Mat strobed_balls_gray;
+        cv::cvtColor(teed_ball_img, teed_ball_gray, cv::COLOR_BGR2GRAY);
+        cv::cvtColor(strobed_balls_img, strobed_balls_gray, cv::COLOR_BGR2GRAY);
+
+        // Same as RunReplayBenchmark - use whatever (simulated) resolution the recorded images have
+        CameraHardware::resolution_x_override_ = teed_ball_img.cols;
+        CameraHardware::resolution_y_override_ = teed_ball_img.rows;
+
+        GolfSimCamera camera;
+        camera.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera1, GolfSimCamera::kSystemSlot1CameraType,
+                                                       GolfSimCamera::kSystemSlot1LensType, GolfSimCamera::kSystemSlot1CameraOrientation);
+
+        const cv::Vec2i expected_ball_center(teed_ball_img.cols / 2, teed_ball_img.rows / 2);
+
+        // The ball that the spin kernels work on, found the normal way
+        GolfBall ball;
+        if (!camera.GetCalibratedBall(camera, teed_ball_img, ball, expected_ball_center)) {
+            GS_LOG_MSG(error, "GsKernelBenchmark - Could not find the ball in " + fixture_filename);
+            return false;
+        }
+
+        GolfBall local_ball = ball;
+        const cv::Mat ball_gray = BallImageProc::IsolateBall(teed_ball_gray, local_ball);
+
+        std::cout << "Kernel benchmark: " << kKernelBenchmarkIterations << " iteration(s) per kernel on " << fixture_filename << "\n";
+
+        std::vector<KernelResult> results;
+
+        {
+            int kDifferenceC = 0;
+            float kDifferenceM = 0.0;
+            int kHSkip = 1;
+            int kVSkip = 1;
+            GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kDifferenceM", kDifferenceM);
+            GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kDifferenceC", kDifferenceC);
+            GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kHSkip", kHSkip);
+            GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kVSkip", kVSkip);
+
+            MotionDetectStage motion_detect_stage(nullptr);
+            motion_detect_stage.config_.difference_m = kDifferenceM;
+            motion_detect_stage.config_.difference_c = kDifferenceC;
+            motion_detect_stage.config_.hskip = kHSkip;
+            motion_detect_stage.config_.vskip = kVSkip;
+            motion_detect_stage.ConfigureForBenchmark(teed_ball_gray.cols / std::max(1, kHSkip), teed_ball_gray.rows / std::max(1, kVSkip));
+
+            // Alternate between the two images so that there is always something that changed
+            bool use_teed_ball_frame = true;
+            TimeKernel("MotionDetectStage::CountChangedPixels", [&]() {
+                const cv::Mat& frame = use_teed_ball_frame ? teed_ball_gray : strobed_balls_gray;
+                motion_detect_stage.CountChangedPixels(frame.ptr<uint8_t>(0), (unsigned int)frame.step[0]);
+                use_teed_ball_frame = !use_teed_ball_frame;
+            }, results);
+
+            float kRegionThreshold = 0.0;
+            GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kRegionThreshold", kRegionThreshold);
+
+            MotionDetectStage background_detect_stage(nullptr);
+            background_detect_stage.config_ = motion_detect_stage.config_;
+            background_detect_stage.config_.region_threshold = kRegionThreshold;
+            background_detect_stage.config_.use_background_model = true;
+            background_detect_stage.ConfigureForBenchmark(teed_ball_gray.cols / std::max(1, kHSkip), teed_ball_gray.rows / std::max(1, kVSkip));
+            background_detect_stage.InitializeBackground(teed_ball_gray.ptr<uint8_t>(0), (unsigned int)teed_ball_gray.step[0]);
+
+            // The common case - nothing has moved, so only the sparse screen is checked
+            TimeKernel("MotionDetectStage::DiffersFromBackground (no motion)", [&]() {
+                background_detect_stage.DiffersFromBackground(teed_ball_gray.ptr<uint8_t>(0), (unsigned int)teed_ball_gray.step[0]);
+            }, results);
+        }
+
+        {
+            const std::string original_method = BallImageProc::kBallPlacementDetectionMethod;
+
+            BallImageProc::kBallPlacementDetectionMethod = "legacy";
+            TimeKernel("BallImageProc::GetBall (Hough)", [&]() {
+                GolfBall found_ball;
+                camera.GetCalibratedBall(camera, teed_ball_img, found_ball, expected_ball_center);
+            }, results);
+            BallImageProc::kBallPlacementDetectionMethod = original_method;
+        }
+
+        TimeKernel("NCNNDetector::Detect", [&]() {
+            std::vector<GsCircle> circles;
+            BallImageProc::DetectBallsNCNN(teed_ball_img, BallImageProc::BallSearchMode::kFindPlacedBall, circles, false);
+        }, results);
+
+        TimeKernel("LibCameraInterface::undistort_camera_image", [&]() {
+            LibCameraInterface::undistort_camera_image(teed_ball_img, camera);
+        }, results);
+
+        TimeKernel("BallImageProc::ComputeGaborAccumulation", [&]() {
+            cv::Mat img_f32;
+            ball_gray.convertTo(img_f32, CV_32F, 1.0 / 255, 0);
+            // The nominal values that ApplyGaborFilterToBall uses
+            BallImageProc::ComputeGaborAccumulation(img_f32, 21, 1.0, 6.0, 120.0, 270.0, 0.2);
+        }, results);
+
+        cv::Mat ball_dimple_edges;
+        TimeKernel("BallImageProc::ApplyGaborFilterToBall", [&]() {
+            float calibrated_binary_threshold = 0.0;
+            ball_dimple_edges = BallImageProc::ApplyGaborFilterToBall(ball_gray, local_ball, calibrated_binary_threshold);
+        }, results);
+
+        if (ball_dimple_edges.empty()) {
+            float calibrated_binary_threshold = 0.0;
+            ball_dimple_edges = BallImageProc::ApplyGaborFilterToBall(ball_gray, local_ball, calibrated_binary_threshold);
+        }
+
+        // Side by side with the Gabor filter, if there is a dimple-edge model
+        if (!BallImageProc::kSpinDimpleEdgeModelPath.empty() && BallImageProc::PreloadSpinModel() &&
+            BallImageProc::dimple_edge_extractor_ != nullptr) {
+
+            cv::Mat model_dimple_edges;
+            const bool timed = TimeKernel("DimpleEdgeExtractor::Extract", [&]() {
+                BallImageProc::dimple_edge_extractor_->Extract(ball_gray, model_dimple_edges);
+            }, results);
+
+            if (timed && !model_dimple_edges.empty()) {
+                // Only the inside of the ball matters to the spin search
+                cv::Mat ball_mask = cv::Mat::zeros(ball_gray.size(), CV_8UC1);
+                cv::circle(ball_mask, cv::Point((int)local_ball.x(), (int)local_ball.y()), (int)local_ball.measured_radius_pixels_, cv::Scalar(255), cv::FILLED);
+
+                cv::Mat agreeing_pixels = (model_dimple_edges == ball_dimple_edges) & ball_mask;
+                const int ball_pixels = std::max(1, cv::countNonZero(ball_mask));
+
+                std::cout << "DimpleEdgeExtractor::Extract agrees with ApplyGaborFilterToBall on "
+                    << std::fixed << std::setprecision(1) << 100.0 * cv::countNonZero(agreeing_pixels) / ball_pixels << "% of the ball\n";
+            }
+        }
+
+        // A typical spin-search candidate, a few degrees of rotation on each axis
+        const cv::Vec3i candidate_rotation(6, -4, 8);
+
+        TimeKernel("BallImageProc::Project2dImageTo3dBall", [&]() {
+            BallImageProc::Project2dImageTo3dBall(ball_dimple_edges, local_ball, candidate_rotation);
+        }, results);
+
+        // With kSpinSearchUseRemapTables, a lookup through the cached table
+        TimeKernel("BallImageProc::GetRotatedImage", [&]() {
+            cv::Mat rotated_ball;
+            BallImageProc::GetRotatedImage(ball_dimple_edges, local_ball, candidate_rotation, rotated_ball);
+        }, results);
+
+        {
+            const cv::Mat unrotated_ball = BallImageProc::Project2dImageTo3dBall(ball_dimple_edges, local_ball, cv::Vec3i(0, 0, 0));
+            const cv::Mat rotated_ball = BallImageProc::Project2dImageTo3dBall(ball_dimple_edges, local_ball, candidate_rotation);
+
+            TimeKernel("BallImageProc::CompareRotationImage", [&]() {
+                BallImageProc::CompareRotationImage(unrotated_ball, rotated_ball);
+            }, results);
+
+            // The target is packed once per search, so only the candidate's packing is timed
+            GsTernaryImage packed_unrotated_ball;
+            packed_unrotated_ball.Pack(unrotated_ball, kPixelIgnoreValue);
+            GsTernaryImage packed_rotated_ball;
+
+            TimeKernel("GsTernaryImage::Compare", [&]() {
+                bool terminated_early = false;
+                packed_rotated_ball.Pack(rotated_ball, kPixelIgnoreValue);
+                GsTernaryImage::Compare(packed_unrotated_ball, packed_rotated_ball, -1.0, terminated_early);
+            }, results);
+        }
+
+        TimeKernel("BallImageProc::FitBallEllipseToEdges", [&]() {
+            cv::RotatedRect ellipse;
+            BallImageProc::FitBallEllipseToEdges(ball_gray, local_ball.ball_circle_, ellipse);
+        }, results);
+
+        {
+            // Default parameters, as the ellipse search is run on the isolated ball
+            CEllipseDetectorYaed ellipse_detector;
+            cv::Mat blurred_ball;
+            cv::GaussianBlur(ball_gray, blurred_ball, cv::Size(5, 5), 0);
+
+            TimeKernel("CEllipseDetectorYaed::Detect", [&]() {
+                std::vector<Ellipse> ellipses;
+                cv::Mat working_img = blurred_ball.clone();
+                ellipse_detector.Detect(working_img, ellipses);
+            }, results);
+        }
+
+        {
+            ED edge_detector;
+            TimeKernel("ED::Detect", [&]() {
+                edge_detector.Detect(strobed_balls_gray);
+            }, results);
+        }
+
+        const std::string results_json = ResultsToJson(fixture_filename, results);
+
+        if (!kKernelBenchmarkResultsFile.empty()) {
+            std::ofstream results_file(kKernelBenchmarkResultsFile);
+            results_file << results_json << std::endl;
+
+            if (!results_file) {
+                GS_LOG_MSG(error, "GsKernelBenchmark - Could not write " + kKernelBenchmarkResultsFile);
+                return false;
+            }
+
+            GS_LOG_MSG(info, "GsKernelBenchmark - wrote the results to " + kKernelBenchmarkResultsFile);
+        }
+        else {
+            std::cout << results_json << "\n";
+        }
+
+        return !results.empty();
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Times each of the image-processing hot kernels on its own (motion detection, the
+// Hough and NCNN ball searches, undistortion, the Gabor filter and any dimple-edge model,
+// the spin projection and comparison, and the ellipse fits and edge detectors), so that a change to one of them
+// can be measured without the noise of a whole shot.  The fixture is the first shot of
+// the automated test suite, the same images that GsAutomatedTesting::RunReplayBenchmark
+// replays end-to-end.
+// Run with --system_mode=kernel_benchmark.  The results are printed and also written
+// as JSON to kKernelBenchmarkResultsFile so that they can be compared from run to run.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace golf_sim {
+
+    class GsKernelBenchmark {
+
+    public:
+        // Timed calls of each kernel, after one untimed warm-up call
+        static int kKernelBenchmarkIterations;
+        // Empty means the results are only printed
+        static std::string kKernelBenchmarkResultsFile;
+        // If not empty, only the kernels whose names contain this are run
+        static std::string kKernelBenchmarkFilter;
+
+        static void LoadConfigurationValues();
+
+        static bool Run();
+
+    private:
+        struct KernelResult {
+            std::string name;
+            int iterations = 0;
+            double min_us = 0.0;
+            double median_us = 0.0;
+            double mean_us = 0.0;
+            double p95_us = 0.0;
+        };
+
+        // Returns false (and adds nothing) if the kernel is filtered out
+        static bool TimeKernel(const std::string& name, const std::function<void()>& kernel, std::vector<KernelResult>& results);
+
+        static std::string ResultsToJson(const std::string& fixture_filename, const std::vector<KernelResult>& results);
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,481 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <lgpio.h>
+#include <sys/utsname.h>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_globals.h"
+#include "gs_camera.h"
+#include "gs_performance_state.h"
+#include "gs_startup_cache.h"
+#include "libcamera_interface.h"
+#include "ball_watcher.h"
+#include "motion_detect.h"
+#include "pulse_strobe.h"
+
+#include "gs_latency_bench.h"
+
+namespace golf_sim {
+
+    int GsLatencyBench::kLatencyBenchIterations = 1000;
+    int GsLatencyBench::kLatencyBenchInjectPin = -1;
+    int GsLatencyBench::kLatencyBenchLoopbackInputPin = -1;
+    int GsLatencyBench::kLatencyBenchSettleMs = 500;
+    int GsLatencyBench::kLatencyBenchTimeoutMs = 2000;
+    int GsLatencyBench::kLatencyBenchHistogramBinUs = 100;
+    std::string GsLatencyBench::kLatencyBenchResultsFile;
+
+    std::vector<float> GsLatencyBench::kLatencyBenchFrameRates;
+    std::vector<float> GsLatencyBench::kLatencyBenchRoiWidths;
+    std::vector<float> GsLatencyBench::kLatencyBenchRoiHeights;
+    std::vector<float> GsLatencyBench::kLatencyBenchHSkips;
+    std::vector<float> GsLatencyBench::kLatencyBenchVSkips;
+
+    std::atomic<bool> GsLatencyBench::active_{ false };
+    std::array<std::atomic<int64_t>, GsLatencyBench::kNumPoints> GsLatencyBench::stamps_{};
+
+
+    // Called on lgpio's alert thread.  The kernel timestamps each edge with CLOCK_MONOTONIC,
+    // which is moved onto the CLOCK_MONOTONIC_RAW timeline (the two only drift apart by
+    // NTP's slewing, which is nothing over the microseconds involved).
+    static void OnLoopbackEdge(int num_alerts, lgGpioAlert_p alerts, void* userdata) {
+
+        // Edges from before the trigger (e.g., a prior iteration's flush pulse) are ignored
+        if (num_alerts <= 0 || GsLatencyBench::GetStamp(GsLatencyBench::kTriggerStarted) == 0) {
+            return;
+        }
+
+        struct timespec monotonic_now;
+        clock_gettime(CLOCK_MONOTONIC, &monotonic_now);
+        const int64_t raw_now_ns = GsLatencyBench::NowNs();
+        const int64_t monotonic_now_ns = (int64_t)monotonic_now.tv_sec * 1000000000 + monotonic_now.tv_nsec;
+
+        const int64_t edge_ns = raw_now_ns - (monotonic_now_ns - (int64_t)alerts[0].report.timestamp);
+        GsLatencyBench::StampAt(GsLatencyBench::kTriggerSeen, edge_ns);
+    }
+
+    static void LoadSweepValues(const std::string& tag_name, std::vector<float>& values, float default_value) {
+        values.clear();
+        GolfSimConfiguration::SetConstant(tag_name, values);
+
+        if (values.empty()) {
+            values.push_back(default_value);
+        }
+    }
+
+    void GsLatencyBench::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.testing.kLatencyBenchIterations", kLatencyBenchIterations);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kLatencyBenchInjectPin", kLatencyBenchInjectPin);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kLatencyBenchLoopbackInputPin", kLatencyBenchLoopbackInputPin);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kLatencyBenchSettleMs", kLatencyBenchSettleMs);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kLatencyBenchTimeoutMs", kLatencyBenchTimeoutMs);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kLatencyBenchHistogramBinUs", kLatencyBenchHistogramBinUs);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kLatencyBenchResultsFile", kLatencyBenchResultsFile);
+
+        LoadSweepValues("gs_config.testing.kLatencyBenchFrameRates", kLatencyBenchFrameRates, 0);
+        LoadSweepValues("gs_config.testing.kLatencyBenchRoiWidths", kLatencyBenchRoiWidths, (float)LibCameraInterface::kMaxWatchingCropWidth);
+        LoadSweepValues("gs_config.testing.kLatencyBenchRoiHeights", kLatencyBenchRoiHeights, (float)LibCameraInterface::kMaxWatchingCropHeight);
+        LoadSweepValues("gs_config.testing.kLatencyBenchHSkips", kLatencyBenchHSkips, 1);
+        LoadSweepValues("gs_config.testing.kLatencyBenchVSkips", kLatencyBenchVSkips, 1);
+
+        kLatencyBenchIterations = std::max(1, kLatencyBenchIterations);
+        kLatencyBenchHistogramBinUs = std::max(1, kLatencyBenchHistogramBinUs);
+    }
+
+    bool GsLatencyBench::RunSweepPoint(const SweepPoint& sweep_point, SweepResult& result) {
+
+        GolfSimCamera camera;
+        camera.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera1, GolfSimCamera::kSystemSlot1CameraType,
+                                                       GolfSimCamera::kSystemSlot1LensType, GolfSimCamera::kSystemSlot1CameraOrientation);
+
+        // As in ConfigCameraForCropping, the crop has to be an even size.  It is centered
+        // on the sensor, which is where the LED should be.
+        cv::Vec2i crop_size(sweep_point.roi_width + (sweep_point.roi_width % 2), sweep_point.roi_height + (sweep_point.roi_height % 2));
+        cv::Vec2i crop_offset((camera.camera_hardware_.resolution_x_ - crop_size[0]) / 2,
+                              (camera.camera_hardware_.resolution_y_ - crop_size[1]) / 2);
+
+        if (!SendCameraCroppingCommand(camera, crop_size, crop_offset)) {
+            GS_LOG_MSG(error, "GsLatencyBench - Failed to SendCameraCroppingCommand.");
+            return false;
+        }
+
+        uint frame_rate = (uint)sweep_point.frame_rate;
+
+        if (frame_rate == 0) {
+            cv::Vec2i cropped_resolution;
+            if (!GsStartupCache::LookupCameraInfo(camera.camera_hardware_.camera_number_, crop_size, cropped_resolution, frame_rate)) {
+                if (!RetrieveCameraInfo(camera.camera_hardware_.camera_number_, cropped_resolution, frame_rate, true)) {
+                    GS_LOG_MSG(error, "GsLatencyBench - Failed to RetrieveCameraInfo.");
+                    return false;
+                }
+
+                GsStartupCache::StoreCameraInfo(camera.camera_hardware_.camera_number_, crop_size, cropped_resolution, frame_rate);
+            }
+        }
+
+        result.frame_rate = (int)frame_rate;
+
+        // The same app is opened for each iteration, without finding the sensor modes each time
+        RPiCamEncoder app;
+        app.KeepSensorModes(true);
+
+        if (!ConfigureLibCameraOptions(camera, app, crop_size, frame_rate)) {
+            GS_LOG_MSG(error, "GsLatencyBench - Failed to ConfigureLibCameraOptions.");
+            return false;
+        }
+
+        // The motion ROI is the whole crop
+        if (!ConfigurePostProcessing(crop_size, cv::Vec2i(0, 0))) {
+            GS_LOG_MSG(error, "GsLatencyBench - Failed to ConfigurePostProcessing.");
+            return false;
+        }
+
+        MotionDetectStage::incoming_configuration.hskip = sweep_point.hskip;
+        MotionDetectStage::incoming_configuration.vskip = sweep_point.vskip;
+
+        if (MotionDetectStage::incoming_configuration.use_lores_stream) {
+            VideoOptions* options = app.GetOptions();
+            options->Set().lores_width = std::max(2, (crop_size[0] / sweep_point.hskip) & ~1);
+            options->Set().lores_height = std::max(2, (crop_size[1] / sweep_point.vskip) & ~1);
+        }
+
+        // So that the next camera 1 user knows to go back to full-screen
+        LibCameraInterface::current_watch_resolution_ = crop_size;
+        LibCameraInterface::current_watch_offset_ = crop_offset;
+        LibCameraInterface::camera_crop_configuration_ = LibCameraInterface::kCropped;
+
+        std::vector<std::array<int64_t, kNumPoints>> samples;
+        int false_triggers = 0;
+
+        // Hits are spread over a frame period so that they do not always land at the same
+        // point in the sensor's readout
+        std::mt19937 random_generator(12345);
+        std::uniform_int_distribution<int> jitter_us(0, 1000000 / std::max(1u, frame_rate));
+
+        for (int i = 0; i < kLatencyBenchIterations && GolfSimGlobals::golf_sim_running_; i++) {
+
+            for (auto& stamp : stamps_) {
+                stamp.store(0, std::memory_order_relaxed);
+            }
+
+            std::atomic<bool> loop_done{ false };
+            std::atomic<bool> timed_out{ false };
+            const int settle_us = kLatencyBenchSettleMs * 1000 + jitter_us(random_generator);
+
+            active_ = true;
+
+            std::thread injector([&]() {
+                const auto inject_time = std::chrono::steady_clock::now() + std::chrono::microseconds(settle_us);
+
+                while (!loop_done && std::chrono::steady_clock::now() < inject_time) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+
+                if (loop_done) {
+                    return;
+                }
+
+                lgGpioWrite(PulseStrobe::lggpio_chip_handle_, kLatencyBenchInjectPin, 1);
+                Stamp(kInjected);
+
+                const auto timeout_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(kLatencyBenchTimeoutMs);
+
+                while (!loop_done && std::chrono::steady_clock::now() < timeout_time) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+
+                if (!loop_done) {
+                    // The ball watcher only otherwise stops for motion
+                    timed_out = true;
+                    GolfSimGlobals::golf_sim_running_ = false;
+                }
+            });
+
+            bool motion_detected = false;
+
+            try {
+                ball_watcher_event_loop(app, motion_detected);
+            }
+            catch (std::exception const& e) {
+                GS_LOG_MSG(error, "GsLatencyBench - ball_watcher_event_loop failed: " + std::string(e.what()));
+            }
+
+            loop_done = true;
+            injector.join();
+            active_ = false;
+
+            if (timed_out) {
+                GolfSimGlobals::golf_sim_running_ = true;
+            }
+
+            lgGpioWrite(PulseStrobe::lggpio_chip_handle_, kLatencyBenchInjectPin, 0);
+
+            // As in Camera1Watcher, the ball watcher's output only lives as long as the loop
+            try {
+                app.StopCamera();
+                app.Teardown();
+                app.CloseCamera();
+            }
+            catch (std::exception const& e) {
+                GS_LOG_MSG(warning, "GsLatencyBench - could not release the camera: " + std::string(e.what()));
+            }
+            app.SetEncodeOutputReadyCallback(nullptr);
+            app.SetMetadataReadyCallback(nullptr);
+
+            std::array<int64_t, kNumPoints> sample;
+            for (int point = 0; point < kNumPoints; point++) {
+                sample[point] = stamps_[point].load(std::memory_order_relaxed);
+            }
+
+            if (sample[kInjected] == 0) {
+                // Something other than the LED was seen as motion
+                false_triggers++;
+            }
+            else if (sample[kMotionDetected] == 0) {
+                result.missed++;
+            }
+            else {
+                samples.push_back(sample);
+            }
+        }
+
+        if (false_triggers > 0) {
+            GS_LOG_MSG(warning, "GsLatencyBench - " + std::to_string(false_triggers) + " iteration(s) saw motion before the LED was turned on.");
+        }
+
+        const struct {
+            const char* name;
+            Point from;
+            Point to;
+        } kSegments[] = {
+            { "inject_to_detect", kInjected, kMotionDetected },
+            { "detect_to_trigger_call", kMotionDetected, kTriggerStarted },
+            { "trigger_call_to_line", kTriggerStarted, kTriggerSent },
+            { "line_to_loopback", kTriggerSent, kTriggerSeen },
+            { "inject_to_trigger", kInjected, kTriggerSent },
+            { "inject_to_loopback", kInjected, kTriggerSeen },
+        };
+
+        for (const auto& segment_points : kSegments) {
+            Segment segment;
+            segment.name = segment_points.name;
+
+            for (const auto& sample : samples) {
+                if (sample[segment_points.from] != 0 && sample[segment_points.to] != 0) {
+                    segment.latencies_us.push_back((sample[segment_points.to] - sample[segment_points.from]) / 1000.0);
+                }
+            }
+
+            if (!segment.latencies_us.empty()) {
+                std::sort(segment.latencies_us.begin(), segment.latencies_us.end());
+                result.segments.push_back(segment);
+            }
+        }
+
+        return true;
+    }
+
+    static double Percentile(const std::vector<double>& sorted_values, double fraction) {
+        return sorted_values[std::min(sorted_values.size() - 1, (size_t)(fraction * sorted_values.size()))];
+    }
+
+    void GsLatencyBench::PrintResult(const SweepResult& result) {
+
+        const SweepPoint& p = result.sweep_point;
+
+        std::cout << "\n" << p.roi_width << "x" << p.roi_height << " crop at " << result.frame_rate << " FPS, hskip " << p.hskip
+            << ", vskip " << p.vskip << ": " << result.missed << " missed\n";
+
+        for (const Segment& segment : result.segments) {
+            const std::vector<double>& v = segment.latencies_us;
+
+            std::cout << std::fixed << std::setprecision(1) << "  " << std::left << std::setw(24) << segment.name << std::right
+                << " n " << std::setw(6) << v.size() << ", min " << std::setw(9) << v.front() << "us, p50 " << std::setw(9) << Percentile(v, 0.50)
+                << "us, p95 " << std::setw(9) << Percentile(v, 0.95) << "us, p99 " << std::setw(9) << Percentile(v, 0.99)
+                << "us, max " << std::setw(9) << v.back() << "us\n";
+
+            // Only the bins that have something in them
+            size_t i = 0;
+            while (i < v.size()) {
+                const long bin = (long)(v[i] / kLatencyBenchHistogramBinUs);
+                size_t count = 0;
+                while (i < v.size() && (long)(v[i] / kLatencyBenchHistogramBinUs) == bin) {
+                    count++;
+                    i++;
+                }
+
+                std::cout << "    " << std::setw(8) << bin * kLatencyBenchHistogramBinUs << "us " << std::setw(6) << count << " "
+                    << std::string(std::max<size_t>(1, (60 * count) / v.size()), '#') << "\n";
+            }
+        }
+    }
+
+    std::string GsLatencyBench::ResultsToJson(const std::vector<SweepResult>& results) {
+
+        const int soc_temperature_millic = GsPerformanceState::ReadSocTemperatureMilliC();
+
+        struct utsname kernel_info;
+        const std::string kernel = (uname(&kernel_info) == 0) ? std::string(kernel_info.release) + " " + kernel_info.version : "";
+
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(1);
+        s << "{\"kernel\":\"" << kernel << "\",\"soc_temp_c\":";
+        if (soc_temperature_millic < 0) {
+            s << "null";
+        }
+        else {
+            s << soc_temperature_millic / 1000.0;
+        }
+        s << ",\"iterations\":" << kLatencyBenchIterations << ",\"histogram_bin_us\":" << kLatencyBenchHistogramBinUs << ",\"sweep\":[";
+
+        for (size_t r = 0; r < results.size(); r++) {
+            const SweepResult& result = results[r];
+            const SweepPoint& p = result.sweep_point;
+
+            s << (r == 0 ? "" : ",") << "{\"roi_width\":" << p.roi_width << ",\"roi_height\":" << p.roi_height
+                << ",\"frame_rate\":" << result.frame_rate << ",\"hskip\":" << p.hskip << ",\"vskip\":" << p.vskip
+                << ",\"missed\":" << result.missed << ",\"segments\":[";
+
+            for (size_t j = 0; j < result.segments.size(); j++) {
+                const Segment& segment = result.segments[j];
+                const std::vector<double>& v = segment.latencies_us;
+
+                s << (j == 0 ? "" : ",") << "{\"name\":\"" << segment.name << "\",\"samples\":" << v.size()
+                    << ",\"min_us\":" << v.front() << ",\"p50_us\":" << Percentile(v, 0.50) << ",\"p95_us\":" << Percentile(v, 0.95)
+                    << ",\"p99_us\":" << Percentile(v, 0.99) << ",\"max_us\":" << v.back() << ",\"histogram\":[";
+
+                // [bin start, count] pairs, for the bins that have something in them
+                size_t i = 0;
+                bool first_bin = true;
+                while (i < v.size()) {
+                    const long bin = (long)(v[i] / kLatencyBenchHistogramBinUs);
+                    size_t count = 0;
+                    while (i < v.size() && (long)(v[i] / kLatencyBenchHistogramBinUs) == bin) {
+                        count++;
+                        i++;
+                    }
+
+                    s << (first_bin ? "" : ",") << "[" << bin * kLatencyBenchHistogramBinUs << "," << count << "]";
+                    first_bin = false;
+                }
+
+                s << "]}";
+            }
+
+            s << "]}";
+        }
+
+        s << "]}";
+        return s.str();
+    }
+
+    bool GsLatencyBench::Run() {
+
+        LoadConfigurationValues();
+
+        if (kLatencyBenchInjectPin < 0) {
+            GS_LOG_MSG(error, "GsLatencyBench - kLatencyBenchInjectPin must be set to the GPIO that drives the LED.");
+            return false;
+        }
+
+        if (!PulseStrobe::InitGPIOSystem()) {
+            GS_LOG_MSG(error, "GsLatencyBench - Failed to InitGPIOSystem.");
+            return false;
+        }
+
+        const int gpio_handle = PulseStrobe::lggpio_chip_handle_;
+
+        if (lgGpioClaimOutput(gpio_handle, 0, kLatencyBenchInjectPin, 0) != LG_OKAY) {
+            GS_LOG_MSG(error, "GsLatencyBench - Could not claim GPIO " + std::to_string(kLatencyBenchInjectPin) + " for the LED.");
+            PulseStrobe::DeinitGPIOSystem();
+            return false;
+        }
+
+        if (kLatencyBenchLoopbackInputPin >= 0) {
+            if (lgGpioClaimAlert(gpio_handle, 0, LG_BOTH_EDGES, kLatencyBenchLoopbackInputPin, -1) != LG_OKAY ||
+                lgGpioSetAlertsFunc(gpio_handle, kLatencyBenchLoopbackInputPin, OnLoopbackEdge, nullptr) != LG_OKAY) {
+                GS_LOG_MSG(warning, "GsLatencyBench - Could not watch loopback GPIO " + std::to_string(kLatencyBenchLoopbackInputPin) +
+                           ".  The trigger will not be read back.");
+                kLatencyBenchLoopbackInputPin = -1;
+            }
+        }
+
+        std::vector<SweepPoint> sweep;
+
+        for (const float frame_rate : kLatencyBenchFrameRates) {
+            for (size_t roi = 0; roi < std::min(kLatencyBenchRoiWidths.size(), kLatencyBenchRoiHeights.size()); roi++) {
+                for (size_t skip = 0; skip < std::min(kLatencyBenchHSkips.size(), kLatencyBenchVSkips.size()); skip++) {
+                    SweepPoint p;
+                    p.frame_rate = std::max(0, (int)frame_rate);
+                    p.roi_width = std::max(2, (int)kLatencyBenchRoiWidths[roi]);
+                    p.roi_height = std::max(2, (int)kLatencyBenchRoiHeights[roi]);
+                    p.hskip = std::max(1, (int)kLatencyBenchHSkips[skip]);
+                    p.vskip = std::max(1, (int)kLatencyBenchVSkips[skip]);
+                    sweep.push_back(p);
+                }
+            }
+        }
+
+        std::cout << "Latency bench: " << sweep.size() << " configuration(s), " << kLatencyBenchIterations << " iteration(s) each\n";
+
+        std::vector<SweepResult> results;
+        bool success = true;
+
+        for (const SweepPoint& sweep_point : sweep) {
+            if (!GolfSimGlobals::golf_sim_running_) {
+                break;
+            }
+
+            SweepResult result;
+            result.sweep_point = sweep_point;
+
+            if (!RunSweepPoint(sweep_point, result)) {
+                success = false;
+                break;
+            }
+
+            PrintResult(result);
+            results.push_back(result);
+        }
+
+        if (kLatencyBenchLoopbackInputPin >= 0) {
+            lgGpioSetAlertsFunc(gpio_handle, kLatencyBenchLoopbackInputPin, nullptr, nullptr);
+            lgGpioFree(gpio_handle, kLatencyBenchLoopbackInputPin);
+        }
+        lgGpioWrite(gpio_handle, kLatencyBenchInjectPin, 0);
+        lgGpioFree(gpio_handle, kLatencyBenchInjectPin);
+        PulseStrobe::DeinitGPIOSystem();
+
+        if (!kLatencyBenchResultsFile.empty() && !results.empty()) {
+            std::ofstream results_file(kLatencyBenchResultsFile);
+            results_file << ResultsToJson(results) << "\n";
+
+            if (!results_file) {
+                GS_LOG_MSG(error, "GsLatencyBench - Could not write " + kLatencyBenchResultsFile);
+                return false;
+            }
+
+            std::cout << "\nResults written to " << kLatencyBenchResultsFile << "\n";
+        }
+
+        return success;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,126 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Measures the end-to-end latency of the hit-detection path on real hardware: from a
+// synthetic "hit" to MotionDetectStage::Process seeing it, to PulseStrobe::SendExternalTrigger,
+// to the camera 2 trigger line changing.  The hit is an LED in camera 1's (cropped) view,
+// driven by kLatencyBenchInjectPin.  If kLatencyBenchLoopbackInputPin is wired back to the
+// camera 2 trigger output, the time the trigger actually reached the camera (which is when
+// its exposure starts) is measured too.
+// Every point is timestamped with CLOCK_MONOTONIC_RAW, so NTP slewing does not skew the
+// results.  Each combination of the swept frame rates, crop (ROI) sizes, and hskip/vskip
+// settings is run kLatencyBenchIterations times, and the latency histograms are printed
+// and also written as JSON to kLatencyBenchResultsFile, e.g., to qualify a kernel or
+// firmware update.
+// Run with --system_mode=latency_bench.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <time.h>
+
+namespace golf_sim {
+
+    class GsLatencyBench {
+
+    public:
+        enum Point {
+            kInjected = 0,      // The LED was turned on
+            kMotionDetected,    // MotionDetectStage::Process saw the change
+            kTriggerStarted,    // PulseStrobe::SendExternalTrigger was called
+            kTriggerSent,       // The camera 2 trigger line was written
+            kTriggerSeen,       // The trigger was read back on the loopback input
+            kNumPoints
+        };
+
+        static int kLatencyBenchIterations;
+        // The GPIO (BCM numbering) that drives the LED in camera 1's view
+        static int kLatencyBenchInjectPin;
+        // A GPIO wired to the camera 2 trigger output, or -1 if there is none
+        static int kLatencyBenchLoopbackInputPin;
+        // The time that the camera is given to start (and the scene to settle) before each hit
+        static int kLatencyBenchSettleMs;
+        // An iteration in which the hit was not seen within this time counts as missed
+        static int kLatencyBenchTimeoutMs;
+        static int kLatencyBenchHistogramBinUs;
+        // Empty means the results are only printed
+        static std::string kLatencyBenchResultsFile;
+
+        // The sweep.  A frame rate of 0 means the sensor's own rate for the crop size.  The
+        // widths and heights are paired up, as are the hskips and vskips.
+        static std::vector<float> kLatencyBenchFrameRates;
+        static std::vector<float> kLatencyBenchRoiWidths;
+        static std::vector<float> kLatencyBenchRoiHeights;
+        static std::vector<float> kLatencyBenchHSkips;
+        static std::vector<float> kLatencyBenchVSkips;
+
+        static void LoadConfigurationValues();
+
+        static bool Run();
+
+        // Called from the hit-detection path.  Does nothing unless the bench is running, and
+        // only the first stamp of each point in an iteration is kept.
+        static inline void Stamp(Point point) {
+            if (active_.load(std::memory_order_relaxed)) {
+                StampAt(point, NowNs());
+            }
+        }
+
+        static inline void StampAt(Point point, int64_t time_ns) {
+            int64_t unset = 0;
+            stamps_[point].compare_exchange_strong(unset, time_ns, std::memory_order_relaxed);
+        }
+
+        static inline int64_t GetStamp(Point point) {
+            return stamps_[point].load(std::memory_order_relaxed);
+        }
+
+        static inline int64_t NowNs() {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+            return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+        }
+
+    private:
+        struct SweepPoint {
+            int frame_rate = 0;
+            int roi_width = 0;
+            int roi_height = 0;
+            int hskip = 1;
+            int vskip = 1;
+        };
+
+        struct Segment {
+            std::string name;
+            std::vector<double> latencies_us;
+        };
+
+        struct SweepResult {
+            SweepPoint sweep_point;
+            // The frame rate that the camera was actually configured for
+            int frame_rate = 0;
+            int missed = 0;
+            std::vector<Segment> segments;
+        };
+
+        static bool RunSweepPoint(const SweepPoint& sweep_point, SweepResult& result);
+
+        static void PrintResult(const SweepResult& result);
+        static std::string ResultsToJson(const std::vector<SweepResult>& results);
+
+        static std::atomic<bool> active_;
+        static std::array<std::atomic<int64_t>, kNumPoints> stamps_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,636 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include <opencv2/imgproc.hpp>
+
+#ifdef GS_USE_LOCAL_DISPLAY
+#include <drm.h>
+#include <drm_fourcc.h>
+#include <drm_mode.h>
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <libcamera/formats.h>
+#include <libcamera/framebuffer.h>
+#endif
+
+#include "logging_tools.h"
+#include "gs_config.h"
+
+#include "gs_local_display.h"
+
+namespace golf_sim {
+
+    bool GsLocalDisplay::kLocalDisplayEnabled = false;
+    int GsLocalDisplay::kLocalDisplayMaxFps = 15;
+    int GsLocalDisplay::kLocalDisplayStatusBarHeight = 72;
+
+    void GsLocalDisplay::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kLocalDisplayEnabled", kLocalDisplayEnabled);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kLocalDisplayMaxFps", kLocalDisplayMaxFps);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kLocalDisplayStatusBarHeight", kLocalDisplayStatusBarHeight);
+
+        kLocalDisplayMaxFps = std::max(kLocalDisplayMaxFps, 1);
+        kLocalDisplayStatusBarHeight = std::max(kLocalDisplayStatusBarHeight, 0);
+    }
+
+#ifdef GS_USE_LOCAL_DISPLAY
+
+    // A camera buffer, imported once and then shown whenever the camera hands it back
+    struct CameraFrameBuffer {
+        uint32_t bo_handle = 0;
+        uint32_t fb_handle = 0;
+        unsigned int width = 0;
+        unsigned int height = 0;
+        unsigned int stride = 0;
+    };
+
+    // One of the two status bar images, which are drawn in turn so that the one on the screen
+    // is never drawn into
+    struct StatusBarBuffer {
+        uint32_t handle = 0;
+        uint32_t fb_handle = 0;
+        uint32_t pitch = 0;
+        uint64_t size = 0;
+        uint8_t* pixels = nullptr;
+    };
+
+    // The status bar is partly see-through.  The planes' pixels are pre-multiplied.
+    static const cv::Scalar kStatusBarBackground(0, 0, 0, 160);
+    static const cv::Scalar kStatusBarText(255, 255, 255, 255);
+
+    static std::atomic<bool> display_running{ false };
+    static std::atomic<int64_t> next_frame_due_ns{ 0 };
+
+    // Guards everything below
+    static std::mutex display_mutex;
+    static int drm_fd = -1;
+    static uint32_t crtc_id = 0;
+    static int crtc_index = -1;
+    static unsigned int screen_width = 0;
+    static unsigned int screen_height = 0;
+    static uint32_t video_plane_id = 0;
+    static uint32_t status_plane_id = 0;
+    static unsigned int status_bar_height = 0;
+
+    // By the DMA-buf's fd
+    static std::map<int, CameraFrameBuffer> camera_frame_buffers;
+    // Keeps the buffer on the screen from going back to the camera
+    static CompletedRequestPtr shown_request;
+    static bool colour_space_set = false;
+    static bool unsupported_format_logged = false;
+
+    static StatusBarBuffer status_bars[2];
+    static int next_status_bar = 0;
+    static std::string status_text;
+    static std::string last_shot_text;
+
+
+    static int64_t GetNowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Picks the first connected connector that is already driven by a CRTC, e.g., the console's
+    static bool FindCrtc() {
+        drmModeRes* resources = drmModeGetResources(drm_fd);
+        if (resources == nullptr) {
+            GS_LOG_MSG(error, "GsLocalDisplay - drmModeGetResources failed: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        crtc_id = 0;
+
+        for (int i = 0; i < resources->count_connectors && crtc_id == 0; i++) {
+            drmModeConnector* connector = drmModeGetConnector(drm_fd, resources->connectors[i]);
+            if (connector == nullptr) {
+                continue;
+            }
+
+            if (connector->connection == DRM_MODE_CONNECTED && connector->encoder_id != 0) {
+                drmModeEncoder* encoder = drmModeGetEncoder(drm_fd, connector->encoder_id);
+
+                if (encoder != nullptr && encoder->crtc_id != 0) {
+                    drmModeCrtc* crtc = drmModeGetCrtc(drm_fd, encoder->crtc_id);
+
+                    if (crtc != nullptr && crtc->mode_valid) {
+                        crtc_id = crtc->crtc_id;
+                        screen_width = crtc->width;
+                        screen_height = crtc->height;
+                    }
+
+                    if (crtc != nullptr) {
+                        drmModeFreeCrtc(crtc);
+                    }
+                }
+
+                if (encoder != nullptr) {
+                    drmModeFreeEncoder(encoder);
+                }
+            }
+
+            drmModeFreeConnector(connector);
+        }
+
+        crtc_index = -1;
+        for (int i = 0; i < resources->count_crtcs; i++) {
+            if (resources->crtcs[i] == crtc_id) {
+                crtc_index = i;
+            }
+        }
+
+        drmModeFreeResources(resources);
+
+        if (crtc_id == 0 || crtc_index < 0) {
+            GS_LOG_MSG(error, "GsLocalDisplay - no connected display was found.");
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool PlaneSupportsFormat(const drmModePlane* plane, uint32_t fourcc) {
+        return std::find(plane->formats, plane->formats + plane->count_formats, fourcc) != plane->formats + plane->count_formats;
+    }
+
+    // Without the universal-planes capability, only the overlay planes are listed, in their
+    // default stacking order.  So the status bar's plane is the first ARGB one after the video's.
+    static bool FindPlanes() {
+        drmModePlaneRes* planes = drmModeGetPlaneResources(drm_fd);
+        if (planes == nullptr) {
+            GS_LOG_MSG(error, "GsLocalDisplay - drmModeGetPlaneResources failed: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        video_plane_id = 0;
+        status_plane_id = 0;
+
+        for (uint32_t i = 0; i < planes->count_planes && status_plane_id == 0; i++) {
+            drmModePlane* plane = drmModeGetPlane(drm_fd, planes->planes[i]);
+            if (plane == nullptr) {
+                continue;
+            }
+
+            if (plane->possible_crtcs & (1u << crtc_index)) {
+                if (video_plane_id == 0 && PlaneSupportsFormat(plane, DRM_FORMAT_YUV420)) {
+                    video_plane_id = plane->plane_id;
+                }
+                else if (video_plane_id != 0 && PlaneSupportsFormat(plane, DRM_FORMAT_ARGB8888)) {
+                    status_plane_id = plane->plane_id;
+                }
+            }
+
+            drmModeFreePlane(plane);
+        }
+
+        drmModeFreePlaneResources(planes);
+
+        if (video_plane_id == 0) {
+            GS_LOG_MSG(error, "GsLocalDisplay - the display has no YUV420 overlay plane.");
+            return false;
+        }
+
+        if (status_plane_id == 0 && kLocalDisplayStatusBarHeight > 0) {
+            GS_LOG_MSG(warning, "GsLocalDisplay - the display has no second overlay plane, so there is no status bar.");
+        }
+
+        return true;
+    }
+
+    // Sets e.g. the plane's "COLOR_RANGE" to the enum value whose name contains value_name
+    static void SetPlaneEnumProperty(uint32_t plane_id, const char* property_name, const char* value_name) {
+        drmModeObjectProperties* properties = drmModeObjectGetProperties(drm_fd, plane_id, DRM_MODE_OBJECT_PLANE);
+        if (properties == nullptr) {
+            return;
+        }
+
+        bool set = false;
+
+        for (uint32_t i = 0; i < properties->count_props && !set; i++) {
+            drmModePropertyRes* property = drmModeGetProperty(drm_fd, properties->props[i]);
+            if (property == nullptr) {
+                continue;
+            }
+
+            if (drm_property_type_is(property, DRM_MODE_PROP_ENUM) && strcmp(property->name, property_name) == 0) {
+                for (int j = 0; j < property->count_enums && !set; j++) {
+                    if (strstr(property->enums[j].name, value_name) != nullptr) {
+                        set = drmModeObjectSetProperty(drm_fd, plane_id, DRM_MODE_OBJECT_PLANE, property->prop_id, property->enums[j].value) == 0;
+                    }
+                }
+            }
+
+            drmModeFreeProperty(property);
+        }
+
+        drmModeFreeObjectProperties(properties);
+
+        if (!set) {
+            GS_LOG_TRACE_MSG(trace, "GsLocalDisplay - could not set " + std::string(property_name) + " to " + std::string(value_name) + ".");
+        }
+    }
+
+    // The same choices as the DRM preview
+    static void SetColourSpace(const std::optional<libcamera::ColorSpace>& colour_space) {
+        const char* encoding = "601";
+        const char* range = "limited";
+
+        if (colour_space == libcamera::ColorSpace::Sycc) {
+            range = "full";
+        }
+        else if (colour_space == libcamera::ColorSpace::Rec709) {
+            encoding = "709";
+        }
+
+        SetPlaneEnumProperty(video_plane_id, "COLOR_ENCODING", encoding);
+        SetPlaneEnumProperty(video_plane_id, "COLOR_RANGE", range);
+    }
+
+    static bool CreateStatusBarBuffer(unsigned int width, unsigned int height, StatusBarBuffer& buffer) {
+        struct drm_mode_create_dumb create = {};
+        create.width = width;
+        create.height = height;
+        create.bpp = 32;
+
+        if (drmIoctl(drm_fd, DRM_IOCTL_MODE_CREATE_DUMB, &create) != 0) {
+            GS_LOG_MSG(error, "GsLocalDisplay - could not create the status bar buffer: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        buffer.handle = create.handle;
+        buffer.pitch = create.pitch;
+        buffer.size = create.size;
+
+        const uint32_t handles[4] = { buffer.handle };
+        const uint32_t pitches[4] = { buffer.pitch };
+        const uint32_t offsets[4] = { 0 };
+
+        struct drm_mode_map_dumb map = {};
+        map.handle = buffer.handle;
+
+        if (drmModeAddFB2(drm_fd, width, height, DRM_FORMAT_ARGB8888, handles, pitches, offsets, &buffer.fb_handle, 0) != 0 ||
+            drmIoctl(drm_fd, DRM_IOCTL_MODE_MAP_DUMB, &map) != 0) {
+            GS_LOG_MSG(error, "GsLocalDisplay - could not set up the status bar buffer: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        void* pixels = mmap(nullptr, buffer.size, PROT_READ | PROT_WRITE, MAP_SHARED, drm_fd, map.offset);
+        if (pixels == MAP_FAILED) {
+            GS_LOG_MSG(error, "GsLocalDisplay - could not map the status bar buffer: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        buffer.pixels = static_cast<uint8_t*>(pixels);
+        return true;
+    }
+
+    static void DestroyStatusBarBuffer(StatusBarBuffer& buffer) {
+        if (buffer.pixels != nullptr) {
+            munmap(buffer.pixels, buffer.size);
+        }
+
+        if (buffer.fb_handle != 0) {
+            drmModeRmFB(drm_fd, buffer.fb_handle);
+        }
+
+        if (buffer.handle != 0) {
+            struct drm_mode_destroy_dumb destroy = {};
+            destroy.handle = buffer.handle;
+            drmIoctl(drm_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy);
+        }
+
+        buffer = StatusBarBuffer();
+    }
+
+    static void ReleaseCameraFrameBuffer(const CameraFrameBuffer& frame_buffer) {
+        drmModeRmFB(drm_fd, frame_buffer.fb_handle);
+
+        // There is no libdrm call to undo drmPrimeFDToHandle
+        struct drm_gem_close gem_close = {};
+        gem_close.handle = frame_buffer.bo_handle;
+        drmIoctl(drm_fd, DRM_IOCTL_GEM_CLOSE, &gem_close);
+    }
+
+    // Must be called with the display_mutex held
+    static void RenderStatusBar() {
+        StatusBarBuffer& buffer = status_bars[next_status_bar];
+
+        if (status_plane_id == 0 || buffer.pixels == nullptr) {
+            return;
+        }
+
+        // ARGB8888 is B, G, R, A in memory, the same as OpenCV's BGRA
+        cv::Mat bar((int)status_bar_height, (int)screen_width, CV_8UC4, buffer.pixels, buffer.pitch);
+        bar.setTo(kStatusBarBackground);
+
+        const int line_height = (int)status_bar_height / 2;
+        const int thickness = std::max(1, line_height / 16);
+        const double font_scale = cv::getFontScaleFromHeight(cv::FONT_HERSHEY_SIMPLEX, (int)(line_height * 0.6), thickness);
+        const int margin = line_height / 3;
+
+        cv::putText(bar, status_text, cv::Point(margin, line_height - margin), cv::FONT_HERSHEY_SIMPLEX, font_scale, kStatusBarText, thickness, cv::LINE_AA);
+        cv::putText(bar, last_shot_text, cv::Point(margin, 2 * line_height - margin), cv::FONT_HERSHEY_SIMPLEX, font_scale, kStatusBarText, thickness, cv::LINE_AA);
+
+        if (drmModeSetPlane(drm_fd, status_plane_id, crtc_id, buffer.fb_handle, 0,
+                            0, (int)(screen_height - status_bar_height), screen_width, status_bar_height,
+                            0, 0, screen_width << 16, status_bar_height << 16) != 0) {
+            GS_LOG_TRACE_MSG(trace, "GsLocalDisplay - could not show the status bar: " + std::string(strerror(errno)));
+            return;
+        }
+
+        next_status_bar = 1 - next_status_bar;
+    }
+
+    bool GsLocalDisplay::Start() {
+
+        if (!kLocalDisplayEnabled || display_running) {
+            return true;
+        }
+
+        std::lock_guard<std::mutex> lock(display_mutex);
+
+        drm_fd = drmOpen("vc4", nullptr);
+        if (drm_fd < 0) {
+            GS_LOG_MSG(error, "GsLocalDisplay - could not open the display: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        if (!drmIsMaster(drm_fd)) {
+            GS_LOG_MSG(error, "GsLocalDisplay - another program (e.g., a desktop) is using the display.");
+            close(drm_fd);
+            drm_fd = -1;
+            return false;
+        }
+
+        if (!FindCrtc() || !FindPlanes()) {
+            close(drm_fd);
+            drm_fd = -1;
+            return false;
+        }
+
+        status_bar_height = std::min((unsigned int)kLocalDisplayStatusBarHeight, screen_height / 3);
+
+        if (status_plane_id != 0 && status_bar_height > 0) {
+            if (!CreateStatusBarBuffer(screen_width, status_bar_height, status_bars[0]) ||
+                !CreateStatusBarBuffer(screen_width, status_bar_height, status_bars[1])) {
+                DestroyStatusBarBuffer(status_bars[0]);
+                DestroyStatusBarBuffer(status_bars[1]);
+                status_plane_id = 0;
+            }
+        }
+
+        if (status_plane_id == 0) {
+            status_bar_height = 0;
+        }
+
+        RenderStatusBar();
+
+        next_frame_due_ns = 0;
+        display_running = true;
+
+        GS_LOG_MSG(info, "GsLocalDisplay - showing the tee on the " + std::to_string(screen_width) + "x" + std::to_string(screen_height) + " display.");
+        return true;
+    }
+
+    void GsLocalDisplay::Stop() {
+
+        if (!display_running) {
+            return;
+        }
+
+        display_running = false;
+
+        ReleaseFrames();
+
+        std::lock_guard<std::mutex> lock(display_mutex);
+
+        if (status_plane_id != 0) {
+            drmModeSetPlane(drm_fd, status_plane_id, crtc_id, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        }
+
+        DestroyStatusBarBuffer(status_bars[0]);
+        DestroyStatusBarBuffer(status_bars[1]);
+
+        close(drm_fd);
+        drm_fd = -1;
+    }
+
+    bool GsLocalDisplay::IsRunning() {
+        return display_running.load(std::memory_order_relaxed);
+    }
+
+    bool GsLocalDisplay::WantsFrame() {
+        return display_running.load(std::memory_order_relaxed) &&
+               GetNowNs() >= next_frame_due_ns.load(std::memory_order_relaxed);
+    }
+
+    void GsLocalDisplay::ShowFrame(CompletedRequestPtr& request, libcamera::Stream* stream, const StreamInfo& info) {
+
+        if (stream == nullptr || !WantsFrame()) {
+            return;
+        }
+
+        next_frame_due_ns.store(GetNowNs() + 1000000000LL / kLocalDisplayMaxFps, std::memory_order_relaxed);
+
+        if (info.pixel_format != libcamera::formats::YUV420) {
+            if (!unsupported_format_logged) {
+                GS_LOG_MSG(warning, "GsLocalDisplay - only YUV420 streams can be shown, not " + info.pixel_format.toString() + ".");
+                unsupported_format_logged = true;
+            }
+            return;
+        }
+
+        auto buffer = request->buffers.find(stream);
+        if (buffer == request->buffers.end()) {
+            return;
+        }
+
+        const int fd = buffer->second->planes()[0].fd.get();
+
+        std::lock_guard<std::mutex> lock(display_mutex);
+
+        if (drm_fd < 0) {
+            return;
+        }
+
+        auto found = camera_frame_buffers.find(fd);
+
+        if (found != camera_frame_buffers.end() &&
+            (found->second.width != info.width || found->second.height != info.height || found->second.stride != info.stride)) {
+            ReleaseCameraFrameBuffer(found->second);
+            camera_frame_buffers.erase(found);
+            found = camera_frame_buffers.end();
+        }
+
+        if (found == camera_frame_buffers.end()) {
+            CameraFrameBuffer frame_buffer;
+            frame_buffer.width = info.width;
+            frame_buffer.height = info.height;
+            frame_buffer.stride = info.stride;
+
+            if (drmPrimeFDToHandle(drm_fd, fd, &frame_buffer.bo_handle) != 0) {
+                GS_LOG_MSG(warning, "GsLocalDisplay - could not import camera buffer " + std::to_string(fd) + ": " + std::string(strerror(errno)));
+                return;
+            }
+
+            // The three planes of the YUV420 image are back to back in the one buffer
+            const uint32_t luma_size = info.stride * info.height;
+            const uint32_t offsets[4] = { 0, luma_size, luma_size + (info.stride / 2) * (info.height / 2) };
+            const uint32_t pitches[4] = { info.stride, info.stride / 2, info.stride / 2 };
+            const uint32_t handles[4] = { frame_buffer.bo_handle, frame_buffer.bo_handle, frame_buffer.bo_handle };
+
+            if (drmModeAddFB2(drm_fd, info.width, info.height, DRM_FORMAT_YUV420, handles, pitches, offsets, &frame_buffer.fb_handle, 0) != 0) {
+                GS_LOG_MSG(warning, "GsLocalDisplay - could not add a frame buffer for camera buffer " + std::to_string(fd) + ": " + std::string(strerror(errno)));
+                frame_buffer.fb_handle = 0;
+                struct drm_gem_close gem_close = {};
+                gem_close.handle = frame_buffer.bo_handle;
+                drmIoctl(drm_fd, DRM_IOCTL_GEM_CLOSE, &gem_close);
+                return;
+            }
+
+            found = camera_frame_buffers.emplace(fd, frame_buffer).first;
+        }
+
+        if (!colour_space_set) {
+            SetColourSpace(info.colour_space);
+            colour_space_set = true;
+        }
+
+        // Letterboxed into the screen above the status bar
+        const unsigned int area_height = screen_height - status_bar_height;
+        unsigned int width = screen_width;
+        unsigned int height = area_height;
+        unsigned int x_offset = 0;
+        unsigned int y_offset = 0;
+
+        if (info.width * area_height > screen_width * info.height) {
+            height = screen_width * info.height / info.width;
+            y_offset = (area_height - height) / 2;
+        }
+        else {
+            width = area_height * info.width / info.height;
+            x_offset = (screen_width - width) / 2;
+        }
+
+        if (drmModeSetPlane(drm_fd, video_plane_id, crtc_id, found->second.fb_handle, 0, (int)x_offset, (int)y_offset, width, height,
+                            0, 0, info.width << 16, info.height << 16) != 0) {
+            GS_LOG_TRACE_MSG(trace, "GsLocalDisplay - could not show the frame: " + std::string(strerror(errno)));
+            return;
+        }
+
+        // The buffer that was on the screen goes back to the camera
+        shown_request = request;
+    }
+
+    void GsLocalDisplay::ReleaseFrames() {
+
+        std::lock_guard<std::mutex> lock(display_mutex);
+
+        if (drm_fd < 0) {
+            return;
+        }
+
+        if (!camera_frame_buffers.empty()) {
+            drmModeSetPlane(drm_fd, video_plane_id, crtc_id, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        }
+
+        for (const auto& frame_buffer : camera_frame_buffers) {
+            ReleaseCameraFrameBuffer(frame_buffer.second);
+        }
+
+        camera_frame_buffers.clear();
+        shown_request.reset();
+        colour_space_set = false;
+    }
+
+    void GsLocalDisplay::SetStatus(const std::string& status) {
+
+        if (!IsRunning()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(display_mutex);
+
+        if (status == status_text) {
+            return;
+        }
+
+        status_text = status;
+        RenderStatusBar();
+    }
+
+    void GsLocalDisplay::SetLastShot(const GsResults& results) {
+
+        if (!IsRunning() || results.result_message_is_keepalive_) {
+            return;
+        }
+
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1)
+             << "Shot " << results.shot_number_ << ":  " << results.speed_mph_ << " mph   VLA " << results.vla_deg_
+             << "   HLA " << results.hla_deg_ << "   Spin " << results.back_spin_rpm_ << " / " << results.side_spin_rpm_ << " rpm";
+
+        if (results.carry_m_ > 0) {
+            text << "   Carry " << std::setprecision(0) << results.carry_m_ << " m";
+        }
+
+        std::lock_guard<std::mutex> lock(display_mutex);
+
+        last_shot_text = text.str();
+        RenderStatusBar();
+    }
+
+#else
+
+    bool GsLocalDisplay::Start() {
+        if (kLocalDisplayEnabled) {
+            GS_LOG_MSG(warning, "GsLocalDisplay - kLocalDisplayEnabled is set, but PiTrac was built without enable_local_display.");
+        }
+        return true;
+    }
+
+    void GsLocalDisplay::Stop() {
+    }
+
+    bool GsLocalDisplay::IsRunning() {
+        return false;
+    }
+
+    bool GsLocalDisplay::WantsFrame() {
+        return false;
+    }
+
+    void GsLocalDisplay::ShowFrame(CompletedRequestPtr&, libcamera::Stream*, const StreamInfo&) {
+    }
+
+    void GsLocalDisplay::ReleaseFrames() {
+    }
+
+    void GsLocalDisplay::SetStatus(const std::string&) {
+    }
+
+    void GsLocalDisplay::SetLastShot(const GsResults&) {
+    }
+
+#endif // #ifdef GS_USE_LOCAL_DISPLAY
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
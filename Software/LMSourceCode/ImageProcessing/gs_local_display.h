@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Shows the live tee view on a display attached to the Pi, for bays that have a small local
+// screen instead of (or as well as) a browser on another device.  The camera's YUV420 buffers
+// are scanned out directly on a DRM/KMS overlay plane, as preview/drm_preview.cpp does, and a
+// second plane above it has a status bar with the placement state and the last shot's numbers.
+// The display hardware does the compositing, so the live view costs no copies, no drawing and no
+// encoding.  The status bar is only redrawn when its text changes.
+// The frame being shown is kept from the camera until the next one replaces it, so the watcher
+// loops have one buffer fewer while the display is on.  Frames are offered by the watcher loops
+// (but not in realtime mode), at most kLocalDisplayMaxFps times a second.
+// Needs to be DRM master (i.e., no desktop running on the display) and the build's
+// enable_local_display meson option (-DGS_USE_LOCAL_DISPLAY, which needs libdrm).
+// Off unless kLocalDisplayEnabled is set.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <string>
+
+#include "core/completed_request.hpp"
+#include "core/stream_info.hpp"
+
+#include "gs_results.h"
+
+namespace libcamera {
+    class Stream;
+}
+
+namespace golf_sim {
+
+    class GsLocalDisplay {
+
+    public:
+        static bool kLocalDisplayEnabled;
+        static int kLocalDisplayMaxFps;
+        // Of the status bar at the bottom of the screen.  0 means no status bar.
+        static int kLocalDisplayStatusBarHeight;
+
+        static void LoadConfigurationValues();
+
+        // Opens the display.  Does nothing if kLocalDisplayEnabled is not set.
+        static bool Start();
+        static void Stop();
+
+        static bool IsRunning();
+
+        // True if the display is running and the next frame is due.  Cheap enough to be
+        // called for every captured frame.
+        static bool WantsFrame();
+
+        // Puts the stream's buffer of the request on the screen, and keeps the request until
+        // the next frame replaces it.  Only YUV420 streams can be shown.
+        static void ShowFrame(CompletedRequestPtr& request, libcamera::Stream* stream, const StreamInfo& info);
+
+        // Takes the frame off the screen and forgets the camera's buffers.  Must be called
+        // before the camera's buffers are freed, e.g., when a watcher loop ends or the camera
+        // is reconfigured.
+        static void ReleaseFrames();
+
+        // E.g., "Ball placed - Let's Golf!"
+        static void SetStatus(const std::string& status);
+        static void SetLastShot(const GsResults& results);
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
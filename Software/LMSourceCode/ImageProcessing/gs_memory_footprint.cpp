@@ -0,0 +1,223 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "gs_format_lib.h"
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+#include "ball_image_proc.h"
+
+#ifdef __unix__
+#include "libcamera_interface.h"
+#include "gs_shot_pipeline.h"
+#endif
+
+#include "gs_memory_footprint.h"
+
+namespace golf_sim {
+
+    bool GsMemoryFootprint::kUseLowMemoryProfile = false;
+    int GsMemoryFootprint::kLowMemoryMaxRecentFrames = 5;
+
+    std::array<std::atomic<int64_t>, GsMemoryFootprint::kNumSubsystems> GsMemoryFootprint::bytes_;
+    std::array<std::atomic<int64_t>, GsMemoryFootprint::kNumSubsystems> GsMemoryFootprint::shot_peak_bytes_;
+
+    // Where each subsystem's bytes are published.  The long-lived ones show their current
+    // size, and the per-shot ones their peak in the last shot.
+    static const GsMetrics::Gauge kSubsystemGauges[] = {
+        GsMetrics::Gauge::kMemoryRecentFramesBytes,
+        GsMetrics::Gauge::kMemoryBallDetectorModelsBytes,
+        GsMetrics::Gauge::kMemorySpinPredictorModelBytes,
+        GsMetrics::Gauge::kMemoryCamera2ImagesBytes,
+        GsMetrics::Gauge::kMemoryShotPeakGaborBuffersBytes,
+        GsMetrics::Gauge::kMemoryShotPeakSpinCandidatesBytes,
+    };
+    static_assert(sizeof(kSubsystemGauges) / sizeof(kSubsystemGauges[0]) == (size_t)GsMemoryFootprint::Subsystem::kNumSubsystems,
+                  "Each subsystem needs a gauge");
+
+    static bool IsPerShot(GsMemoryFootprint::Subsystem subsystem) {
+        return subsystem >= GsMemoryFootprint::Subsystem::kGaborBuffers;
+    }
+
+    static std::string FormatMegabytes(int64_t bytes) {
+        return GS_FORMATLIB_FORMAT("{:.1f}", (double)bytes / (1024.0 * 1024.0)) + " MB";
+    }
+
+
+    void GsMemoryFootprint::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.modes.kUseLowMemoryProfile", kUseLowMemoryProfile);
+        GolfSimConfiguration::SetConstant("gs_config.modes.kLowMemoryMaxRecentFrames", kLowMemoryMaxRecentFrames);
+
+        // Room for at least the hit frame and one on either side
+        kLowMemoryMaxRecentFrames = std::max(kLowMemoryMaxRecentFrames, 3);
+
+        ApplyLowMemoryProfile();
+    }
+
+    void GsMemoryFootprint::ApplyLowMemoryProfile() {
+        if (!kUseLowMemoryProfile) {
+            return;
+        }
+
+        // 1 bit per pixel for each of the two planes, rather than a byte
+        BallImageProc::kSpinSearchUseBitPackedImages = true;
+
+        // The placed ball is then found with the strobed ball's detector, and the int8 model
+        // (if there is one) is loaded on its own, rather than alongside the fp16 one to be timed
+        BallImageProc::kModelPlacementInputWidth = 0;
+        BallImageProc::kModelPlacementInputHeight = 0;
+        if (BallImageProc::kModelVariant == "auto") {
+            BallImageProc::kModelVariant = "int8";
+        }
+
+#ifdef __unix__
+        // Only takes effect with a mono camera 2
+        LibCameraInterface::kCamera2MonoCapture = true;
+
+        // Each shot in the pipeline has its own copies of both cameras' images
+        GsShotPipeline::kMaxPipelinedShots = 1;
+#endif
+
+        GS_LOG_MSG(info, "GsMemoryFootprint - using the low-memory profile.");
+    }
+
+    void GsMemoryFootprint::LimitRecentFrames(unsigned int& frames_before_hit, unsigned int& frames_after_hit) {
+        if (!kUseLowMemoryProfile) {
+            return;
+        }
+
+        // The hit frame itself is always kept
+        const unsigned int frame_budget = (unsigned int)kLowMemoryMaxRecentFrames - 1;
+
+        frames_after_hit = std::min(frames_after_hit, frame_budget / 2);
+        frames_before_hit = std::min(frames_before_hit, frame_budget - frames_after_hit);
+    }
+
+    const char* GsMemoryFootprint::GetSubsystemName(Subsystem subsystem) {
+        switch (subsystem) {
+            case Subsystem::kRecentFrames:          return "recent_frames";
+            case Subsystem::kBallDetectorModels:    return "ball_detector_models";
+            case Subsystem::kSpinPredictorModel:    return "spin_predictor_model";
+            case Subsystem::kCamera2Images:         return "camera2_images";
+            case Subsystem::kGaborBuffers:          return "gabor_buffers";
+            case Subsystem::kSpinCandidates:        return "spin_candidates";
+            default:                                return "unknown";
+        }
+    }
+
+    void GsMemoryFootprint::SetBytes(Subsystem subsystem, size_t bytes) {
+        const int index = (int)subsystem;
+
+        bytes_[index].store((int64_t)bytes, std::memory_order_relaxed);
+        RecordPeak(subsystem, bytes);
+
+        GsMetrics::SetGauge(kSubsystemGauges[index], (double)bytes);
+    }
+
+    void GsMemoryFootprint::RecordPeak(Subsystem subsystem, size_t bytes) {
+        std::atomic<int64_t>& peak = shot_peak_bytes_[(int)subsystem];
+
+        int64_t previous_peak = peak.load(std::memory_order_relaxed);
+        while ((int64_t)bytes > previous_peak &&
+               !peak.compare_exchange_weak(previous_peak, (int64_t)bytes, std::memory_order_relaxed)) {
+        }
+    }
+
+    void GsMemoryFootprint::EndShot() {
+
+        std::string summary;
+
+        for (int index = 0; index < kNumSubsystems; index++) {
+            // The next shot's peak starts from what is held now
+            const int64_t peak = shot_peak_bytes_[index].exchange(bytes_[index].load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+            if (IsPerShot((Subsystem)index)) {
+                GsMetrics::SetGauge(kSubsystemGauges[index], (double)peak);
+            }
+
+            summary += std::string(", ") + GetSubsystemName((Subsystem)index) + " " + FormatMegabytes(peak);
+        }
+
+        int64_t resident = 0;
+        int64_t peak_resident = 0;
+        int64_t swapped = 0;
+
+        if (ReadProcessStatus(resident, peak_resident, swapped)) {
+            GsMetrics::SetGauge(GsMetrics::Gauge::kProcessResidentBytes, (double)resident);
+            GsMetrics::SetGauge(GsMetrics::Gauge::kProcessShotPeakResidentBytes, (double)peak_resident);
+            GsMetrics::SetGauge(GsMetrics::Gauge::kProcessSwapBytes, (double)swapped);
+
+            summary = "resident " + FormatMegabytes(peak_resident) + " (swapped " + FormatMegabytes(swapped) + ")" + summary;
+
+#ifdef __unix__
+            // Resets the kernel's peak resident size (VmHWM), so that the next one is the next shot's
+            std::ofstream clear_refs("/proc/self/clear_refs");
+            clear_refs << "5";
+#endif
+        }
+
+        GS_LOG_MSG(info, "GsMemoryFootprint - shot peaks: " + summary + ".");
+
+        if (swapped > 0 && !kUseLowMemoryProfile) {
+            GS_LOG_MSG(warning, "GsMemoryFootprint - " + FormatMegabytes(swapped) + " of PiTrac is swapped out.  Consider kUseLowMemoryProfile.");
+        }
+    }
+
+    void GsMemoryFootprint::SampleProcess() {
+        int64_t resident = 0;
+        int64_t peak_resident = 0;
+        int64_t swapped = 0;
+
+        if (ReadProcessStatus(resident, peak_resident, swapped)) {
+            GsMetrics::SetGauge(GsMetrics::Gauge::kProcessResidentBytes, (double)resident);
+            GsMetrics::SetGauge(GsMetrics::Gauge::kProcessSwapBytes, (double)swapped);
+        }
+    }
+
+    bool GsMemoryFootprint::ReadProcessStatus(int64_t& resident, int64_t& peak_resident, int64_t& swapped) {
+        resident = 0;
+        peak_resident = 0;
+        swapped = 0;
+
+#ifdef __unix__
+        std::ifstream status("/proc/self/status");
+        if (!status) {
+            return false;
+        }
+
+        // E.g., "VmRSS:	  123456 kB"
+        std::string line;
+        while (std::getline(status, line)) {
+            std::istringstream fields(line);
+            std::string name;
+            int64_t kilobytes = 0;
+
+            if (!(fields >> name >> kilobytes)) {
+                continue;
+            }
+
+            if (name == "VmRSS:") {
+                resident = kilobytes * 1024;
+            }
+            else if (name == "VmHWM:") {
+                peak_resident = kilobytes * 1024;
+            }
+            else if (name == "VmSwap:") {
+                swapped = kilobytes * 1024;
+            }
+        }
+
+        return resident > 0;
+#else
+        return false;
+#endif
+    }
+
+}
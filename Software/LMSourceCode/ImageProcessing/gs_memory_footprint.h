@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Where the memory goes, for the 2 GB Pis that otherwise start swapping (and so miss
+// shots) under load.  The subsystems that hold large buffers report them here:
+// long-lived ones (the club strike frame ring, the NCNN models, camera 2's image pool)
+// with SetBytes whenever they change, and the per-shot working sets (the Gabor filter's
+// per-thread buffers, the spin search's candidate images) with RecordPeak each time
+// they are at their largest.  The process' own resident, peak resident and swapped
+// sizes come from /proc/self/status.  Everything goes into GsMetrics gauges.  EndShot
+// publishes the peaks since the last shot (and logs them), and starts the next shot's.
+// The NCNN models are counted by their weight files, so their runtime blobs are not.
+//
+// kUseLowMemoryProfile picks the compact alternatives where there are any: a mono camera
+// 2 capture, bit-packed spin search images, a frame ring of at most
+// kLowMemoryMaxRecentFrames, a single (int8 if there is one) ball detector for both
+// the placed and strobed balls, and one shot in the analysis pipeline at a time.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace golf_sim {
+
+    class GsMemoryFootprint {
+
+    public:
+        enum class Subsystem {
+            // Long-lived, reported with SetBytes
+            kRecentFrames = 0,
+            kBallDetectorModels,
+            kSpinPredictorModel,
+            kCamera2Images,
+            // Per-shot working sets, reported with RecordPeak
+            kGaborBuffers,
+            kSpinCandidates,
+            kNumSubsystems
+        };
+
+        static bool kUseLowMemoryProfile;
+        // The largest club strike frame ring (before, at and after the hit) in the profile
+        static int kLowMemoryMaxRecentFrames;
+
+        // Also applies the profile, so it must run after the settings that it overrides are loaded
+        static void LoadConfigurationValues();
+
+        // Overrides the settings that the profile covers.  Does nothing if it is off.
+        static void ApplyLowMemoryProfile();
+
+        // Cuts the club strike frames down to kLowMemoryMaxRecentFrames, keeping the
+        // post-hit frames first.  Does nothing if the profile is off.
+        static void LimitRecentFrames(unsigned int& frames_before_hit, unsigned int& frames_after_hit);
+
+        static void SetBytes(Subsystem subsystem, size_t bytes);
+        static void RecordPeak(Subsystem subsystem, size_t bytes);
+
+        // Publishes (and logs) the shot's peaks, and starts over for the next shot
+        static void EndShot();
+
+        // Reads the process' memory sizes into the gauges.  Called when the metrics are scraped.
+        static void SampleProcess();
+
+    private:
+        static constexpr int kNumSubsystems = (int)Subsystem::kNumSubsystems;
+
+        static const char* GetSubsystemName(Subsystem subsystem);
+
+        // In bytes.  0 if they could not be read.
+        static bool ReadProcessStatus(int64_t& resident, int64_t& peak_resident, int64_t& swapped);
+
+        static std::array<std::atomic<int64_t>, kNumSubsystems> bytes_;
+        static std::array<std::atomic<int64_t>, kNumSubsystems> shot_peak_bytes_;
+    };
+
+}
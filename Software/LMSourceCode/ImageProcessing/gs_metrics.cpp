@@ -0,0 +1,239 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_events.h"
+#include "gs_shot_trace.h"
+#include "gs_memory_footprint.h"
+
+#ifdef __unix__
+#include "gs_http_server.h"
+#include "gs_performance_state.h"
+#endif
+
+#include "gs_metrics.h"
+
+namespace golf_sim {
+
+    bool GsMetrics::kMetricsHttpEnabled = false;
+
+    std::array<std::atomic<uint64_t>, GsMetrics::kNumCounters> GsMetrics::counters_;
+    std::array<std::atomic<double>, GsMetrics::kNumGauges> GsMetrics::gauges_;
+    std::array<std::array<GsMetrics::HistogramSeries, GsMetrics::kMaxHistogramLabels>, GsMetrics::kNumHistograms> GsMetrics::histograms_;
+
+    // The upper bounds of the histogram buckets, in seconds
+    static const double kHistogramBucketBounds[] = { 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+                                                     0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0 };
+
+    struct MetricInfo {
+        // Consecutive series that share a family are written under the one HELP and TYPE
+        const char* family;
+        // E.g., kind="image", or empty
+        const char* labels;
+        const char* help;
+    };
+
+    static const MetricInfo kCounterInfo[] = {
+        { "pitrac_shots_processed_total", "", "Shots whose latency trace was completed." },
+        { "pitrac_hough_circle_calls_total", "", "HoughCircles calls made by the adaptive ball search." },
+        { "pitrac_camera_timeouts_total", "", "Device timeouts in the camera 1 watcher loops." },
+        { "pitrac_camera_stalls_total", "", "Times that the camera 1 watcher loops got no frame within kCameraHealthStallTimeoutMs." },
+        { "pitrac_camera_dropped_frames_total", "", "Gaps in the camera 1 sensor frame sequence." },
+        { "pitrac_camera_late_frames_total", "", "Camera 1 frames that came in well after the expected interval." },
+        { "pitrac_camera_recoveries_total", "", "Camera 1 recoveries tried, of any tier." },
+        { "pitrac_camera_failed_recoveries_total", "", "Camera 1 recoveries that did not work." },
+        { "pitrac_dropped_artifacts_total", "kind=\"image\"", "Artifacts dropped because their writer or consumer fell behind." },
+        { "pitrac_dropped_artifacts_total", "kind=\"raw_frame\"", "" },
+        { "pitrac_dropped_artifacts_total", "kind=\"club_strike_video\"", "" },
+        { "pitrac_dropped_artifacts_total", "kind=\"swing_replay\"", "" },
+        { "pitrac_dropped_artifacts_total", "kind=\"bus_result\"", "" },
+        { "pitrac_dropped_artifacts_total", "kind=\"sim_message\"", "" },
+        { "pitrac_dropped_artifacts_total", "kind=\"sim_heartbeat\"", "" },
+        { "pitrac_dropped_artifacts_total", "kind=\"shot_history\"", "" },
+        { "pitrac_exposure_predictions_total", "outcome=\"used\"", "Full swings with predicted strobed-ball positions, by whether the balls were found there." },
+        { "pitrac_exposure_predictions_total", "outcome=\"fallback\"", "" },
+        { "pitrac_model_sequence_shortcuts_total", "step=\"overlap_filter\"", "Strobed-ball analysis steps that were skipped because the detection model's exposure sequence was used instead." },
+        { "pitrac_model_sequence_shortcuts_total", "step=\"pattern_search\"", "" },
+        { "pitrac_trigger_pre_arms_total", "outcome=\"triggered\"", "Times the club was seen in the approach zone, by whether the ball was then hit or the club went away again." },
+        { "pitrac_trigger_pre_arms_total", "outcome=\"released\"", "" },
+        { "pitrac_spin_optimizer_evaluations_total", "", "Rotations compared by the optimizer spin search (kSpinSearchUseOptimizer)." },
+    };
+    static_assert(sizeof(kCounterInfo) / sizeof(kCounterInfo[0]) == (size_t)GsMetrics::Counter::kNumCounters,
+                  "Each counter needs a MetricInfo");
+
+    static const MetricInfo kGaugeInfo[] = {
+        { "pitrac_watcher_delivered_fps", "", "The frame rate that the last ball watch got from camera 1." },
+        { "pitrac_watcher_worst_frame_interval_seconds", "", "The longest frame interval of the last ball watch." },
+        { "pitrac_camera_message_queue_max_depth", "", "The deepest that the camera 1 message queue got in the last watch." },
+        { "pitrac_event_queue_depth", "", "Events waiting in the FSM's event queue." },
+        { "pitrac_soc_temperature_celsius", "", "The SoC temperature, or -1 if it cannot be read." },
+        { "pitrac_throttled_flags", "", "The firmware's throttling flags (as from vcgencmd get_throttled)." },
+        { "pitrac_memory_bytes", "subsystem=\"recent_frames\"", "Memory held by the long-lived buffers of each subsystem." },
+        { "pitrac_memory_bytes", "subsystem=\"ball_detector_models\"", "" },
+        { "pitrac_memory_bytes", "subsystem=\"spin_predictor_model\"", "" },
+        { "pitrac_memory_bytes", "subsystem=\"camera2_images\"", "" },
+        { "pitrac_memory_shot_peak_bytes", "subsystem=\"gabor_buffers\"", "The largest working set of each subsystem in the last shot." },
+        { "pitrac_memory_shot_peak_bytes", "subsystem=\"spin_candidates\"", "" },
+        { "pitrac_process_resident_bytes", "", "The process' resident memory." },
+        { "pitrac_process_shot_peak_resident_bytes", "", "The process' largest resident memory in the last shot." },
+        { "pitrac_process_swap_bytes", "", "The process' memory that is swapped out." },
+    };
+    static_assert(sizeof(kGaugeInfo) / sizeof(kGaugeInfo[0]) == (size_t)GsMetrics::Gauge::kNumGauges,
+                  "Each gauge needs a MetricInfo");
+
+    static const char* const kEventPriorityNames[] = { "high", "normal", "low" };
+
+    struct HistogramInfo {
+        const char* family;
+        const char* help;
+        // nullptr if the histogram has a single, unlabelled series
+        const char* label_name;
+        int num_labels;
+    };
+
+    static const HistogramInfo kHistogramInfo[] = {
+        { "pitrac_shot_stage_latency_seconds", "The time from the motion being detected to each stage of a shot.", "stage", GsShotTrace::kNumStages },
+        { "pitrac_event_queue_wait_seconds", "How long FSM events waited in the event queue.", "priority", GsShotTrace::kNumEventPriorities },
+        { "pitrac_ball_detector_inference_seconds", "NCNN ball detector inference time.", nullptr, 1 },
+        { "pitrac_spin_predictor_inference_seconds", "NCNN spin predictor inference time.", nullptr, 1 },
+        { "pitrac_dimple_edge_extractor_inference_seconds", "NCNN dimple-edge extractor inference time.", nullptr, 1 },
+    };
+    static_assert(sizeof(kHistogramInfo) / sizeof(kHistogramInfo[0]) == (size_t)GsMetrics::Histogram::kNumHistograms,
+                  "Each histogram needs a HistogramInfo");
+
+
+    void GsMetrics::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.logging.kMetricsHttpEnabled", kMetricsHttpEnabled);
+    }
+
+    void GsMetrics::Observe(Histogram histogram, int64_t duration_ns, int label) {
+        const int histogram_index = (int)histogram;
+        if (label < 0 || label >= kHistogramInfo[histogram_index].num_labels || label >= kMaxHistogramLabels) {
+            return;
+        }
+
+        const double seconds = (double)std::max<int64_t>(duration_ns, 0) / 1.0e9;
+
+        int bucket = 0;
+        while (bucket < kNumHistogramBuckets && seconds > kHistogramBucketBounds[bucket]) {
+            bucket++;
+        }
+
+        HistogramSeries& series = histograms_[histogram_index][label];
+        series.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        series.sum_ns.fetch_add((uint64_t)std::max<int64_t>(duration_ns, 0), std::memory_order_relaxed);
+    }
+
+    void GsMetrics::SampleGauges() {
+        SetGauge(Gauge::kEventQueueDepth, GolfSimEventQueue::GetQueueLength());
+        GsMemoryFootprint::SampleProcess();
+
+#ifdef __unix__
+        const int temperature_millic = GsPerformanceState::ReadSocTemperatureMilliC();
+        SetGauge(Gauge::kSocTemperatureCelsius, (temperature_millic >= 0) ? temperature_millic / 1000.0 : -1.0);
+        SetGauge(Gauge::kThrottledFlags, GsPerformanceState::ReadThrottledFlags());
+#endif
+    }
+
+    std::string GsMetrics::GetPrometheusText() {
+
+        SampleGauges();
+
+        std::ostringstream s;
+
+        auto write_header = [&](const char* family, const char* help, const char* type) {
+            s << "# HELP " << family << " " << help << "\n";
+            s << "# TYPE " << family << " " << type << "\n";
+        };
+
+        auto write_series = [&](const MetricInfo* info, int count, const char* type, auto value_of) {
+            const char* previous_family = nullptr;
+            for (int i = 0; i < count; i++) {
+                if (previous_family == nullptr || std::string(previous_family) != info[i].family) {
+                    write_header(info[i].family, info[i].help, type);
+                    previous_family = info[i].family;
+                }
+
+                s << info[i].family;
+                if (info[i].labels[0] != '\0') {
+                    s << "{" << info[i].labels << "}";
+                }
+                s << " " << value_of(i) << "\n";
+            }
+        };
+
+        write_series(kCounterInfo, kNumCounters, "counter",
+                     [](int i) { return counters_[i].load(std::memory_order_relaxed); });
+        write_series(kGaugeInfo, kNumGauges, "gauge",
+                     [](int i) { return gauges_[i].load(std::memory_order_relaxed); });
+
+        for (int h = 0; h < kNumHistograms; h++) {
+            const HistogramInfo& info = kHistogramInfo[h];
+            write_header(info.family, info.help, "histogram");
+
+            for (int label = 0; label < info.num_labels && label < kMaxHistogramLabels; label++) {
+                // The motion is where the shot latencies are measured from, so it has none
+                if (h == (int)Histogram::kShotStageLatency && label == (int)GsShotTrace::Stage::kMotionDetected) {
+                    continue;
+                }
+
+                std::string label_pair;
+                if (info.label_name != nullptr) {
+                    const char* label_value = (h == (int)Histogram::kShotStageLatency) ?
+                        GsShotTrace::GetStageName((GsShotTrace::Stage)label) : kEventPriorityNames[label];
+                    label_pair = std::string(info.label_name) + "=\"" + label_value + "\"";
+                }
+
+                const HistogramSeries& series = histograms_[h][label];
+                const std::string separator = label_pair.empty() ? "" : ",";
+
+                uint64_t cumulative = 0;
+                for (int bucket = 0; bucket <= kNumHistogramBuckets; bucket++) {
+                    cumulative += series.buckets[bucket].load(std::memory_order_relaxed);
+                    s << info.family << "_bucket{" << label_pair << separator << "le=\"";
+                    if (bucket < kNumHistogramBuckets) {
+                        s << kHistogramBucketBounds[bucket];
+                    }
+                    else {
+                        s << "+Inf";
+                    }
+                    s << "\"} " << cumulative << "\n";
+                }
+
+                const std::string labels = label_pair.empty() ? "" : "{" + label_pair + "}";
+                s << info.family << "_sum" << labels << " " << (double)series.sum_ns.load(std::memory_order_relaxed) / 1.0e9 << "\n";
+                // The buckets are read one at a time, so the count is taken from them to stay consistent
+                s << info.family << "_count" << labels << " " << cumulative << "\n";
+            }
+        }
+
+        return s.str();
+    }
+
+    void GsMetrics::StartHttpEndpoint() {
+#ifdef __unix__
+        if (!kMetricsHttpEnabled) {
+            return;
+        }
+
+        const bool added = GsHttpServer::Get("/metrics", [](const httplib::Request&, httplib::Response& response) {
+            response.set_content(GetPrometheusText(), "text/plain; version=0.0.4; charset=utf-8");
+        });
+
+        if (!added) {
+            GS_LOG_MSG(warning, "GsMetrics - kMetricsHttpEnabled is set, but the HTTP server is off (see kHttpServerPort).");
+            return;
+        }
+
+        GS_LOG_MSG(info, "GsMetrics - serving metrics at " + GsHttpServer::GetUrl("/metrics"));
+#endif
+    }
+
+}
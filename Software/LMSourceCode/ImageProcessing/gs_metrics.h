@@ -0,0 +1,130 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Process-wide runtime metrics, served in the Prometheus text format so that a fleet of
+// bays can be scraped and compared.
+// Every counter, gauge and histogram is a fixed set of atomics, so recording a value never
+// allocates or takes a lock, and can be done from the trigger path.  A histogram has the
+// same fixed buckets (from 100 us to 5 s) for everything, and some are split by a label,
+// e.g., the shot latency by GsShotTrace stage.  A few gauges (the FSM event queue depth, the
+// SoC's thermal state and the process' memory) are instead read each time the metrics are scraped.
+// If kMetricsHttpEnabled is set, GET /metrics on the GsHttpServer returns GetPrometheusText().
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace golf_sim {
+
+    class GsMetrics {
+
+    public:
+        enum class Counter {
+            kShotsProcessed = 0,
+            kHoughCircleCalls,
+            kCameraTimeouts,
+            kCameraStalls,
+            kCameraDroppedFrames,
+            kCameraLateFrames,
+            kCameraRecoveries,
+            kCameraFailedRecoveries,
+            kDroppedImages,
+            kDroppedRawFrames,
+            kDroppedClubStrikeVideos,
+            kDroppedSwingReplays,
+            kDroppedBusResults,
+            kDroppedSimMessages,
+            kDroppedSimHeartbeats,
+            kDroppedShotHistory,
+            kExposurePredictionsUsed,
+            kExposurePredictionFallbacks,
+            kModelSequenceOverlapFilterSkipped,
+            kModelSequencePatternSearchSkipped,
+            kTriggerPreArmsTriggered,
+            kTriggerPreArmsReleased,
+            kSpinOptimizerEvaluations,
+            kNumCounters
+        };
+
+        enum class Gauge {
+            kWatcherDeliveredFps = 0,
+            kWatcherWorstFrameIntervalSeconds,
+            kCameraMessageQueueMaxDepth,
+            kEventQueueDepth,
+            kSocTemperatureCelsius,
+            kThrottledFlags,
+            // Labelled by GsMemoryFootprint subsystem
+            kMemoryRecentFramesBytes,
+            kMemoryBallDetectorModelsBytes,
+            kMemorySpinPredictorModelBytes,
+            kMemoryCamera2ImagesBytes,
+            kMemoryShotPeakGaborBuffersBytes,
+            kMemoryShotPeakSpinCandidatesBytes,
+            kProcessResidentBytes,
+            kProcessShotPeakResidentBytes,
+            kProcessSwapBytes,
+            kNumGauges
+        };
+
+        enum class Histogram {
+            // Labelled by GsShotTrace::Stage, and measured from kMotionDetected
+            kShotStageLatency = 0,
+            // Labelled by GolfSimEventQueue priority
+            kEventQueueWait,
+            kBallDetectorInference,
+            kSpinPredictorInference,
+            kDimpleEdgeExtractorInference,
+            kNumHistograms
+        };
+
+        // False (the default) means no HTTP endpoint
+        static bool kMetricsHttpEnabled;
+
+        static void LoadConfigurationValues();
+
+        static void Increment(Counter counter, uint64_t amount = 1) {
+            counters_[(int)counter].fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        static void SetGauge(Gauge gauge, double value) {
+            gauges_[(int)gauge].store(value, std::memory_order_relaxed);
+        }
+
+        // Values outside of the histogram's labels are ignored
+        static void Observe(Histogram histogram, int64_t duration_ns, int label = 0);
+
+        static std::string GetPrometheusText();
+
+        // Adds GET /metrics, with GetPrometheusText(), to the GsHttpServer.  Does nothing
+        // unless kMetricsHttpEnabled is set.
+        static void StartHttpEndpoint();
+
+    private:
+        static constexpr int kNumCounters = (int)Counter::kNumCounters;
+        static constexpr int kNumGauges = (int)Gauge::kNumGauges;
+        static constexpr int kNumHistograms = (int)Histogram::kNumHistograms;
+
+        // Enough for every GsShotTrace stage
+        static constexpr int kMaxHistogramLabels = 10;
+        static constexpr int kNumHistogramBuckets = 15;
+
+        struct HistogramSeries {
+            // Not cumulative.  The last one is for everything above the largest bound.
+            std::array<std::atomic<uint64_t>, kNumHistogramBuckets + 1> buckets{};
+            std::atomic<uint64_t> sum_ns{ 0 };
+        };
+
+        // Reads the gauges that are only sampled when the metrics are scraped
+        static void SampleGauges();
+
+        static std::array<std::atomic<uint64_t>, kNumCounters> counters_;
+        static std::array<std::atomic<double>, kNumGauges> gauges_;
+        static std::array<std::array<HistogramSeries, kMaxHistogramLabels>, kNumHistograms> histograms_;
+    };
+
+}
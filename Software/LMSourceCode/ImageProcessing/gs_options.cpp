@@ -26,6 +26,7 @@ GsCameraNumber GolfSimOptions::GetCameraNumber() {
 		system_mode_ == kTest ||
 		system_mode_ == kCamera1Calibrate ||
 		system_mode_ == kCamera1AutoCalibrate ||
+		system_mode_ == kCamera1MarkerCalibrate ||
 		system_mode_ == kCamera1BallLocation ) {
 		camera_number = GsCameraNumber::kGsCamera1;
 	} 
@@ -68,6 +69,17 @@ bool GolfSimOptions::Parse(int argc, char *argv[])
 		{ "automated_testing", SystemMode::kAutomatedTesting },
 		{ "camera1AutoCalibrate", SystemMode::kCamera1AutoCalibrate },
 		{ "camera2AutoCalibrate", SystemMode::kCamera2AutoCalibrate },
+		{ "remote_analysis_worker", SystemMode::kRemoteAnalysisWorker },
+		{ "replay_benchmark", SystemMode::kReplayBenchmark },
+		{ "kernel_benchmark", SystemMode::kKernelBenchmark },
+		{ "latency_bench", SystemMode::kLatencyBench },
+		{ "hough_sweep", SystemMode::kHoughSweep },
+		{ "virtual_camera", SystemMode::kVirtualCamera },
+		{ "hough_autotune", SystemMode::kHoughAutotune },
+		{ "event_journal_replay", SystemMode::kEventJournalReplay },
+		{ "performance_benchmark", SystemMode::kPerformanceBenchmark },
+		{ "camera1MarkerCalibrate", SystemMode::kCamera1MarkerCalibrate },
+		{ "camera2MarkerCalibrate", SystemMode::kCamera2MarkerCalibrate },
 	};
 	if (mode_table.count(system_mode_string_) == 0)
 		throw std::runtime_error("Invalid system_mode: " + system_mode_string_);
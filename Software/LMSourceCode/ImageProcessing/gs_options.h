@@ -29,6 +29,17 @@ namespace golf_sim {
 		kAutomatedTesting = 12,
 		kCamera1AutoCalibrate = 13,
 		kCamera2AutoCalibrate = 14,
+		kRemoteAnalysisWorker = 15,	// Analyzes shots sent by other PiTrac systems (see GsRemoteAnalysis)
+		kReplayBenchmark = 16,		// Times the analysis of the automated test suite's recorded shots
+		kKernelBenchmark = 17,		// Times each image-processing kernel on its own (see GsKernelBenchmark)
+		kLatencyBench = 18,			// Measures the hit-to-trigger latency with an LED and a GPIO loopback (see GsLatencyBench)
+		kHoughSweep = 19,			// Rates combinations of Hough parameters over labeled images (see GsHoughSweep)
+		kVirtualCamera = 20,		// Plays archived shots through the ball watcher's trigger path (see GsVirtualCamera)
+		kHoughAutotune = 21,		// Picks the fastest Hough parameters that meet an accuracy target (see GsHoughSweep)
+		kEventJournalReplay = 22,	// Feeds a recorded event journal back through the FSM (see GsEventJournal)
+		kPerformanceBenchmark = 23,	// Re-runs the benchmark that picks the performance profile (see GsPerformanceProfile)
+		kCamera1MarkerCalibrate = 24,	// Auto-calibrates from a ChArUco board instead of a ball (see GolfSimCalibration::MarkerCalibrateCamera)
+		kCamera2MarkerCalibrate = 25,
 	};
 
 	enum LoggingLevel {
@@ -73,7 +84,7 @@ namespace golf_sim {
 				("golfer_orientation", value<std::string>(&golfer_orientation_string_)->default_value("right_handed"),
 					"Set the golfer's handed-ness (right_handed, left_handed)")
 				("system_mode", value<std::string>(&system_mode_string_)->default_value("test"),
-					"Set the system's operating mode (camera1, camera1_test_standalone, camera1Calibrate, camera2Calibrate, test_spin, camera1_ball_location, camera2_ball_location, test_gspro_server, automated_testing, camera1AutoCalibrate, camera2AutoCalibrate, test)")
+					"Set the system's operating mode (camera1, camera1_test_standalone, camera1Calibrate, camera2Calibrate, test_spin, camera1_ball_location, camera2_ball_location, test_gspro_server, automated_testing, camera1AutoCalibrate, camera2AutoCalibrate, camera1MarkerCalibrate, camera2MarkerCalibrate, test)")
 				("logging_level", value<std::string>(&logging_level_string_)->default_value("warn"),
 					"Set the system's logging level (trace, debug, info, warn, error, none)")
 				("artifact_save_level", value<std::string>(&artifact_save_level_string_)->default_value("final_results_only"),
@@ -0,0 +1,118 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <future>
+#include <thread>
+
+#include "logging_tools.h"
+
+#include "gs_parallel_startup.h"
+
+namespace golf_sim {
+
+    void GsParallelStartup::Add(const std::string& name, Task task, const std::vector<std::string>& depends_on) {
+
+        StartupTask startup_task;
+        startup_task.name = name;
+        startup_task.task = std::move(task);
+
+        for (const std::string& dependency : depends_on) {
+            auto it = std::find_if(tasks_.begin(), tasks_.end(), [&dependency](const StartupTask& t) { return t.name == dependency; });
+
+            if (it == tasks_.end()) {
+                GS_LOG_MSG(error, "GsParallelStartup - " + name + " depends on unknown task " + dependency);
+                continue;
+            }
+
+            startup_task.depends_on.push_back((size_t)(it - tasks_.begin()));
+        }
+
+        tasks_.push_back(std::move(startup_task));
+    }
+
+
+    bool GsParallelStartup::RunTask(StartupTask& startup_task, const std::chrono::steady_clock::time_point& start_time) {
+
+        const auto task_start_time = std::chrono::steady_clock::now();
+        startup_task.started_ms = std::chrono::duration<double, std::milli>(task_start_time - start_time).count();
+
+        try {
+            startup_task.succeeded = startup_task.task();
+        }
+        catch (std::exception& e) {
+            GS_LOG_MSG(error, "GsParallelStartup - " + startup_task.name + " failed - Error was: " + std::string(e.what()));
+            startup_task.succeeded = false;
+        }
+
+        startup_task.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - task_start_time).count();
+
+        GS_LOG_MSG(info, "Startup task " + startup_task.name + (startup_task.succeeded ? " finished" : " FAILED") +
+            " - started at " + std::to_string((int)startup_task.started_ms) + "ms, took " + std::to_string((int)startup_task.elapsed_ms) + "ms");
+
+        return startup_task.succeeded;
+    }
+
+
+    bool GsParallelStartup::Run(bool run_in_parallel) {
+
+        const auto start_time = std::chrono::steady_clock::now();
+        bool success = true;
+
+        if (!run_in_parallel) {
+            for (StartupTask& startup_task : tasks_) {
+                if (!RunTask(startup_task, start_time)) {
+                    success = false;
+                    break;
+                }
+            }
+        }
+        else {
+            // Each task waits on its dependencies' futures, so the tasks run as soon as they can.
+            // The futures are all created before any task starts, because the tasks refer to them.
+            std::vector<std::promise<bool>> promises(tasks_.size());
+            std::vector<std::shared_future<bool>> results;
+
+            for (std::promise<bool>& promise : promises) {
+                results.push_back(promise.get_future().share());
+            }
+
+            std::vector<std::thread> threads;
+
+            for (size_t i = 0; i < tasks_.size(); i++) {
+                threads.emplace_back([this, i, &promises, &results, &start_time]() {
+                    StartupTask& startup_task = tasks_[i];
+
+                    for (size_t dependency : startup_task.depends_on) {
+                        if (!results[dependency].get()) {
+                            GS_LOG_MSG(warning, "Startup task " + startup_task.name + " skipped because " + tasks_[dependency].name + " failed");
+                            promises[i].set_value(false);
+                            return;
+                        }
+                    }
+
+                    promises[i].set_value(RunTask(startup_task, start_time));
+                });
+            }
+
+            for (size_t i = 0; i < threads.size(); i++) {
+                threads[i].join();
+                success = results[i].get() && success;
+            }
+        }
+
+        const double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+        double sum_ms = 0.0;
+        for (const StartupTask& startup_task : tasks_) {
+            sum_ms += startup_task.elapsed_ms;
+        }
+
+        GS_LOG_MSG(info, "System startup tasks " + std::string(success ? "finished" : "FAILED") + " in " + std::to_string((int)total_ms) +
+            "ms (" + std::to_string((int)sum_ms) + "ms if run one at a time)");
+
+        return success;
+    }
+
+}
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Runs the independent system startup steps (camera bring-up, model loading, GPIO/SPI,
+// the simulator connections, ...) at the same time, so that the time to become ready is
+// that of the slowest chain of steps instead of the sum of all of them.  Each task
+// starts once every task that it depends on has succeeded.  If a task fails, the tasks
+// that depend on it are not run, and Run() returns false.  Each task's start and
+// run times are logged.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace golf_sim {
+
+    class GsParallelStartup {
+
+    public:
+        using Task = std::function<bool()>;
+
+        // The dependencies must have been added first
+        void Add(const std::string& name, Task task, const std::vector<std::string>& depends_on = {});
+
+        // If run_in_parallel is false, the tasks are run one at a time in the order
+        // that they were added
+        bool Run(bool run_in_parallel);
+
+    private:
+        struct StartupTask {
+            std::string name;
+            Task task;
+            std::vector<size_t> depends_on;
+
+            bool succeeded = false;
+            double started_ms = 0.0;
+            double elapsed_ms = 0.0;
+        };
+
+        bool RunTask(StartupTask& startup_task, const std::chrono::steady_clock::time_point& start_time);
+
+        std::vector<StartupTask> tasks_;
+    };
+
+}
@@ -0,0 +1,357 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+
+#include <opencv2/imgproc.hpp>
+
+#include "gs_format_lib.h"
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_options.h"
+#include "gs_startup_cache.h"
+#include "gs_memory_footprint.h"
+#include "ball_image_proc.h"
+#include "ncnn_detector.hpp"
+#include "ncnn_runtime.hpp"
+
+#include "gs_performance_profile.h"
+
+namespace golf_sim {
+
+    std::string GsPerformanceProfile::kPerformanceProfile;
+    int GsPerformanceProfile::kPerformanceProfileTargetMs = 500;
+
+    std::string GsPerformanceProfile::selected_profile_;
+
+    // Timed calls of each kernel, after one untimed warm-up call
+    static const int kBenchmarkIterations = 5;
+
+    // The synthetic ball, about the size of a strobed ball in the camera 2 image
+    static const int kBenchmarkBallRadius = 60;
+
+
+    const std::vector<GsPerformanceProfile::Profile>& GsPerformanceProfile::GetProfiles() {
+        // The model input sizes are multiples of the detector's 32-pixel stride
+        static const std::vector<Profile> profiles = {
+            { "thorough", 4, 736, 544, 90, false, false },
+            { "balanced", 4, 640, 480, 72, true, true },
+            { "light", 3, 512, 384, 60, true, true },
+        };
+
+        return profiles;
+    }
+
+    const GsPerformanceProfile::Profile* GsPerformanceProfile::FindProfile(const std::string& name) {
+        for (const Profile& profile : GetProfiles()) {
+            if (profile.name == name) {
+                return &profile;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // A Pi 4 or 5 has 4 cores, but don't ask for more threads than there are
+    static int GetInferenceThreads(int profile_threads) {
+        const int cores = std::max(1, (int)std::thread::hardware_concurrency());
+        return std::min(profile_threads, cores);
+    }
+
+
+    void GsPerformanceProfile::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.modes.kPerformanceProfile", kPerformanceProfile);
+        GolfSimConfiguration::SetConstant("gs_config.modes.kPerformanceProfileTargetMs", kPerformanceProfileTargetMs);
+
+        kPerformanceProfileTargetMs = std::max(1, kPerformanceProfileTargetMs);
+
+        selected_profile_.clear();
+
+        if (kPerformanceProfile.empty()) {
+            return;
+        }
+
+        if (kPerformanceProfile != "auto") {
+            if (FindProfile(kPerformanceProfile) == nullptr) {
+                GS_LOG_MSG(warning, "GsPerformanceProfile - there is no performance profile named '" + kPerformanceProfile + "'.  Using the .json values.");
+                return;
+            }
+
+            selected_profile_ = kPerformanceProfile;
+        }
+        else if (GolfSimOptions::GetCommandLineOptions().system_mode_ == SystemMode::kPerformanceBenchmark) {
+            // RunBenchmark is about to benchmark anyway
+            return;
+        }
+        else if (!GsStartupCache::LookupPerformanceProfile(kPerformanceProfileTargetMs, selected_profile_) ||
+                 FindProfile(selected_profile_) == nullptr) {
+
+            if (GsStartupCache::kStartupCacheDirectory.empty()) {
+                GS_LOG_MSG(info, "GsPerformanceProfile - there is no kStartupCacheDirectory, so the performance benchmark runs at every startup.");
+            }
+
+            std::string results;
+            selected_profile_ = SelectByBenchmark(results);
+
+            if (selected_profile_.empty()) {
+                GS_LOG_MSG(warning, "GsPerformanceProfile - could not benchmark this system.  Using the .json values.");
+                return;
+            }
+
+            GsStartupCache::StorePerformanceProfile(kPerformanceProfileTargetMs, selected_profile_, results);
+        }
+
+        ApplySelectedProfile();
+    }
+
+    void GsPerformanceProfile::ApplySelectedProfile() {
+        const Profile* profile = FindProfile(selected_profile_);
+
+        if (profile == nullptr) {
+            return;
+        }
+
+        BallImageProc::kInferenceThreads = GetInferenceThreads(profile->inference_threads);
+        BallImageProc::kModelInputWidth = profile->model_input_width;
+        BallImageProc::kModelInputHeight = profile->model_input_height;
+        BallImageProc::kCoarseSearchResolution = profile->coarse_search_resolution;
+        BallImageProc::kGaborUseFixedPoint = profile->gabor_use_fixed_point;
+        BallImageProc::kSpinSearchUseHierarchical = profile->spin_search_use_hierarchical;
+
+        GS_LOG_MSG(info, "GsPerformanceProfile - using the '" + profile->name + "' performance profile.");
+    }
+
+
+    // The median time of kBenchmarkIterations calls
+    static double TimeKernelMs(const std::function<void()>& kernel) {
+
+        // The first call fills any caches (Gabor kernels, remap tables)
+        kernel();
+
+        std::vector<double> times_ms(kBenchmarkIterations);
+
+        for (int i = 0; i < kBenchmarkIterations; i++) {
+            const auto start_time = std::chrono::steady_clock::now();
+            kernel();
+            times_ms[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+        }
+
+        std::sort(times_ms.begin(), times_ms.end());
+        return times_ms[times_ms.size() / 2];
+    }
+
+    // The same model files (and backend) that BallImageProc::CreateNCNNDetector would load, but
+    // just the one variant, as an int8 model is almost always the faster one on a Pi
+    static std::unique_ptr<NCNNDetector> CreateBenchmarkDetector(int threads, int input_width, int input_height) {
+
+        NCNNDetector::Config config;
+        config.confidence_threshold = BallImageProc::kModelConfidenceThreshold;
+        config.nms_threshold = BallImageProc::kModelNMSThreshold;
+        config.input_width = input_width;
+        config.input_height = input_height;
+        config.num_threads = threads;
+        config.is_single_class_model = true;
+        config.num_classes = 1;
+        config.has_sequence_outputs = BallImageProc::kModelHasSequenceOutputs;
+        config.use_vulkan_compute = (NcnnRuntime::kNcnnComputeBackend != "cpu") && NcnnRuntime::VulkanAvailable();
+
+        config.param_path = BallImageProc::kModelPath + "/best.ncnn.int8.param";
+        config.bin_path = BallImageProc::kModelPath + "/best.ncnn.int8.bin";
+        config.use_int8_inference = true;
+
+        if (BallImageProc::kModelVariant == "fp16" || !std::filesystem::exists(config.param_path) || !std::filesystem::exists(config.bin_path)) {
+            config.param_path = BallImageProc::kModelPath + "/best.ncnn.param";
+            config.bin_path = BallImageProc::kModelPath + "/best.ncnn.bin";
+            config.use_int8_inference = false;
+        }
+
+        auto detector = std::make_unique<NCNNDetector>(config);
+
+        if (!detector->Initialize()) {
+            GS_LOG_MSG(warning, "GsPerformanceProfile - could not load the NCNN model " + config.param_path);
+            return nullptr;
+        }
+
+        return detector;
+    }
+
+    // A ball with a dimple-like texture on a plain background, so that no test images are needed.
+    // Only the sizes matter to the timings, not what the Gabor filter finds.
+    static cv::Mat MakeSyntheticBallImage(GolfBall& ball) {
+
+        const int size = 2 * kBenchmarkBallRadius + 8;
+        const cv::Point center(size / 2, size / 2);
+
+        cv::Mat texture(size, size, CV_8UC1);
+        cv::RNG rng(12345);
+        rng.fill(texture, cv::RNG::UNIFORM, 0, 256);
+        cv::GaussianBlur(texture, texture, cv::Size(0, 0), 1.5);
+
+        cv::Mat ball_mask = cv::Mat::zeros(size, size, CV_8UC1);
+        cv::circle(ball_mask, center, kBenchmarkBallRadius, cv::Scalar(255), cv::FILLED);
+
+        cv::Mat ball_image(size, size, CV_8UC1, cv::Scalar(40));
+        texture.copyTo(ball_image, ball_mask);
+
+        ball.set_circle(GsCircle((float)center.x, (float)center.y, (float)kBenchmarkBallRadius));
+        ball.measured_radius_pixels_ = kBenchmarkBallRadius;
+
+        return ball_image;
+    }
+
+    std::string GsPerformanceProfile::SelectByBenchmark(std::string& results) {
+
+        const auto start_time = std::chrono::steady_clock::now();
+
+        results.clear();
+
+        // The spin search tuning values are otherwise only loaded with the first BallImageProc
+        BallImageProc::ReloadTuningValues();
+        GsMemoryFootprint::ApplyLowMemoryProfile();
+
+        const bool detect_with_model = (BallImageProc::kStrobedBallDetectionMethod == "experimental");
+        const bool search_spin = (BallImageProc::kSpinDetectionMethod != "ml");
+
+        GolfBall ball;
+        const cv::Mat ball_image = MakeSyntheticBallImage(ball);
+
+        // The Gabor filter's cost only depends on whether it is in fixed point
+        const bool original_gabor_use_fixed_point = BallImageProc::kGaborUseFixedPoint;
+        double gabor_ms[2] = { 0.0, 0.0 };
+        cv::Mat dimple_edges;
+
+        for (const bool use_fixed_point : { true, false }) {
+            BallImageProc::kGaborUseFixedPoint = use_fixed_point;
+            gabor_ms[use_fixed_point ? 1 : 0] = TimeKernelMs([&]() {
+                float calibrated_binary_threshold = 0.0;
+                dimple_edges = BallImageProc::ApplyGaborFilterToBall(ball_image, ball, calibrated_binary_threshold);
+            });
+        }
+
+        BallImageProc::kGaborUseFixedPoint = original_gabor_use_fixed_point;
+
+        // The coarse rotation grid at each profile's resolution.  The candidates are compared with
+        // the unrotated ball, as their contents make no difference to the (exhaustive) comparison.
+        std::map<int, double> coarse_search_ms;
+
+        if (search_spin && !dimple_edges.empty()) {
+            BallImageProc::RotationSearchSpace search_space;
+            search_space.anglex_rotation_degrees_increment = BallImageProc::kCoarseXRotationDegreesIncrement;
+            search_space.anglex_rotation_degrees_start = BallImageProc::kCoarseXRotationDegreesStart;
+            search_space.anglex_rotation_degrees_end = BallImageProc::kCoarseXRotationDegreesEnd;
+            search_space.angley_rotation_degrees_increment = BallImageProc::kCoarseYRotationDegreesIncrement;
+            search_space.angley_rotation_degrees_start = BallImageProc::kCoarseYRotationDegreesStart;
+            search_space.angley_rotation_degrees_end = BallImageProc::kCoarseYRotationDegreesEnd;
+            search_space.anglez_rotation_degrees_increment = BallImageProc::kCoarseZRotationDegreesIncrement;
+            search_space.anglez_rotation_degrees_start = BallImageProc::kCoarseZRotationDegreesStart;
+            search_space.anglez_rotation_degrees_end = BallImageProc::kCoarseZRotationDegreesEnd;
+
+            for (const Profile& profile : GetProfiles()) {
+                const int resolution = profile.coarse_search_resolution;
+
+                if (coarse_search_ms.count(resolution) > 0) {
+                    continue;
+                }
+
+                cv::Mat coarse_dimple_edges;
+                cv::resize(dimple_edges, coarse_dimple_edges, cv::Size(resolution, resolution), 0, 0, cv::INTER_NEAREST);
+
+                const float scale = (float)resolution / (float)dimple_edges.cols;
+                GolfBall coarse_ball = ball;
+                coarse_ball.set_x((float)(ball.x() * scale));
+                coarse_ball.set_y((float)(ball.y() * scale));
+                coarse_ball.measured_radius_pixels_ = ball.measured_radius_pixels_ * scale;
+
+                coarse_search_ms[resolution] = TimeKernelMs([&]() {
+                    cv::Mat candidate_elements_mat;
+                    cv::Vec3i candidate_elements_mat_size;
+                    std::vector<RotationCandidate> candidates;
+
+                    BallImageProc::ComputeCandidateAngleImages(coarse_dimple_edges, search_space, candidate_elements_mat,
+                                                              candidate_elements_mat_size, candidates, coarse_ball, &coarse_dimple_edges);
+                    BallImageProc::CompareCandidateAngleImages(&coarse_dimple_edges, &candidate_elements_mat,
+                                                              &candidate_elements_mat_size, &candidates);
+                });
+            }
+        }
+
+        std::string chosen_profile_name;
+
+        for (const Profile& profile : GetProfiles()) {
+            double detection_ms = 0.0;
+
+            if (detect_with_model) {
+                std::unique_ptr<NCNNDetector> detector = CreateBenchmarkDetector(GetInferenceThreads(profile.inference_threads),
+                                                                                 profile.model_input_width, profile.model_input_height);
+                if (!detector) {
+                    return "";
+                }
+
+                detection_ms = detector->MeasureDetectMs(kBenchmarkIterations);
+            }
+
+            const double both_gabor_ms = 2.0 * gabor_ms[profile.gabor_use_fixed_point ? 1 : 0];
+            const double spin_search_ms = search_spin ? coarse_search_ms[profile.coarse_search_resolution] : 0.0;
+            const double estimate_ms = detection_ms + both_gabor_ms + spin_search_ms;
+
+            const bool meets_target = (estimate_ms <= kPerformanceProfileTargetMs);
+
+            if (meets_target && chosen_profile_name.empty()) {
+                chosen_profile_name = profile.name;
+            }
+
+            results += GS_FORMATLIB_FORMAT("{}: {:.1f} ms (detection {:.1f}, Gabor filters {:.1f}, coarse spin search {:.1f}){}\n",
+                                           profile.name, estimate_ms, detection_ms, both_gabor_ms, spin_search_ms,
+                                           meets_target ? "" : " - over the target");
+        }
+
+        // Nothing meets the target, so take the fastest
+        if (chosen_profile_name.empty()) {
+            chosen_profile_name = GetProfiles().back().name;
+        }
+
+        const long benchmark_ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+        GS_LOG_MSG(info, "GsPerformanceProfile - benchmarked in " + std::to_string(benchmark_ms) + "ms against a target of " +
+                         std::to_string(kPerformanceProfileTargetMs) + "ms.  Chose '" + chosen_profile_name + "':\n" + results);
+
+        return chosen_profile_name;
+    }
+
+    bool GsPerformanceProfile::RunBenchmark() {
+
+        std::string results;
+        const std::string profile_name = SelectByBenchmark(results);
+
+        if (profile_name.empty()) {
+            GS_LOG_MSG(error, "GsPerformanceProfile - could not benchmark this system.");
+            return false;
+        }
+
+        std::cout << "Estimated post-hit analysis times (target " << kPerformanceProfileTargetMs << " ms):\n" << results
+                  << "Chosen performance profile: " << profile_name << "\n";
+
+        if (GsStartupCache::kStartupCacheDirectory.empty()) {
+            std::cout << "There is no kStartupCacheDirectory, so the choice was not saved.\n";
+        }
+        else {
+            GsStartupCache::StorePerformanceProfile(kPerformanceProfileTargetMs, profile_name, results);
+        }
+
+        return true;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Picks one of a few named performance profiles (the NCNN ball detector's threads and input
+// size, the spin search's coarse resolution, and the Gabor and spin search algorithms) to suit
+// the Pi and cameras that PiTrac is running on, rather than one set of .json values for all of
+// them.  The profiles are tried from the most to the least thorough, and the first whose
+// estimated post-hit analysis time is within kPerformanceProfileTargetMs is used (or the least
+// thorough one if none is).  The estimate adds up the key kernels, timed on this hardware on a
+// synthetic ball: the strobed-ball NCNN detection at the profile's threads and input size, the
+// Gabor filter of both balls, and (unless the spin is found with the ML model) the coarse
+// rotation search at the profile's resolution.
+//
+// kPerformanceProfile is "" (use the .json values as they are), "auto" (use the profile that
+// was chosen for this hardware and target before, as saved in the startup cache, or else run
+// the benchmark now), or the name of the profile to use.  --system_mode=performance_benchmark
+// re-runs the benchmark on demand and saves its choice.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <string>
+#include <vector>
+
+namespace golf_sim {
+
+    class GsPerformanceProfile {
+
+    public:
+        static std::string kPerformanceProfile;
+        static int kPerformanceProfileTargetMs;
+
+        // Also selects (benchmarking if need be) and applies the profile, so it must run after
+        // the settings that it overrides are loaded
+        static void LoadConfigurationValues();
+
+        // Overrides the settings that the selected profile covers.  Does nothing if there is none.
+        static void ApplySelectedProfile();
+
+        // Benchmarks the profiles, prints the estimates and saves the choice in the startup cache
+        static bool RunBenchmark();
+
+    private:
+        struct Profile {
+            std::string name;
+            int inference_threads = 4;
+            int model_input_width = 0;
+            int model_input_height = 0;
+            int coarse_search_resolution = 0;
+            bool gabor_use_fixed_point = false;
+            bool spin_search_use_hierarchical = false;
+        };
+
+        // From the most to the least thorough
+        static const std::vector<Profile>& GetProfiles();
+
+        // nullptr if there is no such profile
+        static const Profile* FindProfile(const std::string& name);
+
+        // Returns the name of the chosen profile, or "" if the kernels could not be timed.
+        // results gets one line per profile.
+        static std::string SelectByBenchmark(std::string& results);
+
+        static std::string selected_profile_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,165 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_shot_trace.h"
+
+#include "gs_performance_state.h"
+
+namespace golf_sim {
+
+    bool GsPerformanceState::kUsePerformanceGovernor = false;
+    std::string GsPerformanceState::kPerformanceCpuGovernor = "performance";
+    std::string GsPerformanceState::kIdleCpuGovernor;
+
+    std::mutex GsPerformanceState::mutex_;
+    bool GsPerformanceState::mode_is_set_ = false;
+    GsPerformanceState::Mode GsPerformanceState::mode_ = GsPerformanceState::Mode::kIdle;
+    std::string GsPerformanceState::original_governor_;
+    bool GsPerformanceState::write_failure_logged_ = false;
+    uint32_t GsPerformanceState::last_throttled_flags_ = 0;
+
+    static const char* kCpuFreqDirectory = "/sys/devices/system/cpu/cpufreq";
+    static const char* kThermalZoneFile = "/sys/class/thermal/thermal_zone0/temp";
+    static const char* kThrottledFile = "/sys/devices/platform/soc/soc:firmware/get_throttled";
+
+    // The "now" bits of get_throttled.  The "since boot" bits are these shifted up by 16.
+    static constexpr uint32_t kThrottledNowMask = 0xF;
+
+
+    void GsPerformanceState::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.modes.kUsePerformanceGovernor", kUsePerformanceGovernor);
+        GolfSimConfiguration::SetConstant("gs_config.modes.kPerformanceCpuGovernor", kPerformanceCpuGovernor);
+        GolfSimConfiguration::SetConstant("gs_config.modes.kIdleCpuGovernor", kIdleCpuGovernor);
+    }
+
+    std::vector<std::string> GsPerformanceState::GetGovernorFiles() {
+        std::vector<std::string> governor_files;
+
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(kCpuFreqDirectory, ec)) {
+            if (entry.path().filename().string().rfind("policy", 0) == 0) {
+                governor_files.push_back((entry.path() / "scaling_governor").string());
+            }
+        }
+
+        return governor_files;
+    }
+
+    bool GsPerformanceState::WriteGovernor(const std::string& governor) {
+        bool success = true;
+
+        for (const std::string& governor_file : GetGovernorFiles()) {
+            std::ofstream file(governor_file);
+            file << governor;
+            file.close();
+
+            if (!file) {
+                success = false;
+            }
+        }
+
+        if (!success && !write_failure_logged_) {
+            GS_LOG_MSG(warning, "GsPerformanceState - could not set the CPU governor to '" + governor +
+                "'.  pitrac_lm needs write access to " + std::string(kCpuFreqDirectory) + ".");
+            write_failure_logged_ = true;
+        }
+
+        return success;
+    }
+
+    void GsPerformanceState::SetMode(Mode mode) {
+        if (!kUsePerformanceGovernor) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (mode_is_set_ && mode_ == mode) {
+            return;
+        }
+
+        if (original_governor_.empty()) {
+            const std::vector<std::string> governor_files = GetGovernorFiles();
+            if (!governor_files.empty()) {
+                std::ifstream file(governor_files[0]);
+                std::getline(file, original_governor_);
+            }
+        }
+
+        const std::string governor = (mode == Mode::kPerformance) ? kPerformanceCpuGovernor :
+                                     (kIdleCpuGovernor.empty() ? original_governor_ : kIdleCpuGovernor);
+
+        if (!governor.empty() && WriteGovernor(governor)) {
+            GS_LOG_TRACE_MSG(trace, "GsPerformanceState - CPU governor is now '" + governor + "'.");
+        }
+
+        mode_ = mode;
+        mode_is_set_ = true;
+    }
+
+    void GsPerformanceState::Restore() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (mode_is_set_ && !original_governor_.empty()) {
+            WriteGovernor(original_governor_);
+        }
+
+        mode_is_set_ = false;
+    }
+
+    int GsPerformanceState::ReadSocTemperatureMilliC() {
+        std::ifstream file(kThermalZoneFile);
+        int temperature_millic = -1;
+
+        if (!(file >> temperature_millic)) {
+            return -1;
+        }
+
+        return temperature_millic;
+    }
+
+    uint32_t GsPerformanceState::ReadThrottledFlags() {
+        std::ifstream file(kThrottledFile);
+        uint32_t flags = 0;
+
+        if (!(file >> std::hex >> flags)) {
+            return 0;
+        }
+
+        return flags;
+    }
+
+    void GsPerformanceState::RecordThermalState() {
+        const int temperature_millic = ReadSocTemperatureMilliC();
+        const uint32_t throttled_flags = ReadThrottledFlags();
+
+        GsShotTrace::SetThermalState(temperature_millic, throttled_flags);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Only the conditions that are new since the last shot
+        const uint32_t new_flags = throttled_flags & kThrottledNowMask & ~last_throttled_flags_;
+        if (new_flags != 0) {
+            std::ostringstream flags_hex;
+            flags_hex << std::hex << throttled_flags;
+
+            GS_LOG_MSG(warning, "GsPerformanceState - the SoC is being throttled (get_throttled = 0x" + flags_hex.str() +
+                ") at " + std::to_string(temperature_millic / 1000.0) + " C.  Shot latency will be higher.");
+        }
+
+        last_throttled_flags_ = throttled_flags;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,76 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Switches the CPU frequency governor between a fixed, full-speed setting while a
+// shot can happen (WaitingForBallHit through the post-hit analysis) and a relaxed
+// one while PiTrac is waiting for a ball to be placed, so that the SoC can cool down
+// between shots without the shot itself running at a lower clock.
+// Also reads the SoC temperature and the Pi firmware's throttling flags, which are
+// added to each shot's latency trace.
+// Changing the governor needs write access to /sys/devices/system/cpu/cpufreq
+// (e.g., running as root).  Without it only the temperature reporting is done.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace golf_sim {
+
+    class GsPerformanceState {
+
+    public:
+        enum class Mode {
+            kIdle,
+            kPerformance
+        };
+
+        // If false (the default), the governor is never changed
+        static bool kUsePerformanceGovernor;
+        // Used from WaitingForBallHit through the post-hit analysis
+        static std::string kPerformanceCpuGovernor;
+        // Used while waiting for the ball to be placed.  Empty means whatever the
+        // governor was when PiTrac started.
+        static std::string kIdleCpuGovernor;
+
+        static void LoadConfigurationValues();
+
+        // Does nothing if the mode is already set
+        static void SetMode(Mode mode);
+
+        // Puts back the governor that was in use when PiTrac started
+        static void Restore();
+
+        // In thousandths of a degree C, or -1 if there is no thermal zone
+        static int ReadSocTemperatureMilliC();
+
+        // The firmware's get_throttled bits (e.g., bit 2 = throttled now, bit 18 = has
+        // been throttled since boot), or 0 if they are not available
+        static uint32_t ReadThrottledFlags();
+
+        // Adds the current temperature and throttling flags to the current shot trace,
+        // and logs any throttling that has started since the last call
+        static void RecordThermalState();
+
+    private:
+        static bool WriteGovernor(const std::string& governor);
+
+        static std::vector<std::string> GetGovernorFiles();
+
+        static std::mutex mutex_;
+        static bool mode_is_set_;
+        static Mode mode_;
+        static std::string original_governor_;
+        static bool write_failure_logged_;
+        static uint32_t last_throttled_flags_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Whole-image pixel operations for 8-bit, single-channel images, for use in place of
+// per-pixel at<uchar>() loops.  Each one works a row at a time through OpenCV's
+// vectorized routines.
+
+#pragma once
+
+#include <algorithm>
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    namespace GsPixelKernels {
+
+        // image = fill_value wherever mask == mask_value.  image and mask must be the same size.
+        inline void FillWhereMaskEquals(cv::Mat& image, const cv::Mat& mask, uchar mask_value, uchar fill_value) {
+            CV_Assert(image.size() == mask.size() && image.type() == CV_8UC1 && mask.type() == CV_8UC1);
+
+            cv::Mat selected;
+            cv::compare(mask, mask_value, selected, cv::CMP_EQ);
+            image.setTo(fill_value, selected);
+        }
+
+        // destination = source wherever the two images overlap.  Unlike copyTo, the
+        // destination is never reallocated.
+        inline void CopyOverlap(const cv::Mat& source, cv::Mat& destination) {
+            CV_Assert(source.type() == destination.type());
+
+            const cv::Rect overlap(0, 0, std::min(source.cols, destination.cols), std::min(source.rows, destination.rows));
+            cv::Mat destination_overlap = destination(overlap);
+            source(overlap).copyTo(destination_overlap);
+        }
+
+    }
+
+}
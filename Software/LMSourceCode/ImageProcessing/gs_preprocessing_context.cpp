@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <vector>
+
+#include "gs_preprocessing_context.h"
+
+namespace golf_sim {
+
+    struct StructuringElementEntry {
+        int shape;
+        cv::Size size;
+        cv::Mat element;
+    };
+
+    struct ClaheEntry {
+        double clip_limit;
+        int tiles_grid_size;
+        cv::Ptr<cv::CLAHE> clahe;
+    };
+
+    // Only a handful of parameter sets are ever used, so a short list is quicker than a map
+    static thread_local std::vector<StructuringElementEntry> structuring_elements;
+    static thread_local std::vector<ClaheEntry> clahe_objects;
+
+
+    GsPreprocessingContext::GsPreprocessingContext(const cv::Rect& region_of_interest)
+        : region_of_interest_(region_of_interest) {
+    }
+
+    cv::Mat GsPreprocessingContext::StructuringElement(int shape, const cv::Size& size) {
+
+        for (const StructuringElementEntry& entry : structuring_elements) {
+            if (entry.shape == shape && entry.size == size) {
+                return entry.element;
+            }
+        }
+
+        structuring_elements.push_back(StructuringElementEntry{ shape, size, cv::getStructuringElement(shape, size) });
+
+        return structuring_elements.back().element;
+    }
+
+    cv::Ptr<cv::CLAHE> GsPreprocessingContext::Clahe(double clip_limit, int tiles_grid_size) {
+
+        for (const ClaheEntry& entry : clahe_objects) {
+            if (entry.clip_limit == clip_limit && entry.tiles_grid_size == tiles_grid_size) {
+                return entry.clahe;
+            }
+        }
+
+        cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE();
+        clahe->setClipLimit(clip_limit);
+        clahe->setTilesGridSize(cv::Size(tiles_grid_size, tiles_grid_size));
+
+        clahe_objects.push_back(ClaheEntry{ clip_limit, tiles_grid_size, clahe });
+
+        return clahe;
+    }
+
+    cv::Mat GsPreprocessingContext::RegionToProcess(cv::Mat& image, int margin) const {
+
+        if (!HasRegionOfInterest()) {
+            return image;
+        }
+
+        cv::Rect region(region_of_interest_.x - margin, region_of_interest_.y - margin,
+                        region_of_interest_.width + 2 * margin, region_of_interest_.height + 2 * margin);
+        region &= cv::Rect(0, 0, image.cols, image.rows);
+
+        if (region.empty()) {
+            return image;
+        }
+
+        return image(region);
+    }
+
+}
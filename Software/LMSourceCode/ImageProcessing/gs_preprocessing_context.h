@@ -0,0 +1,44 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Shared pieces of the ball-search image preprocessing.
+// The structuring elements and CLAHE objects only depend on their parameters, so they
+// are built once per parameter set (and per thread, because a CLAHE object keeps working
+// buffers) instead of on every call.
+// An instance also carries the region of interest of one search, so that the blurs and
+// edge detection are only run over the part of the image that the search will look at.
+
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace golf_sim {
+
+    class GsPreprocessingContext {
+
+    public:
+        // An empty region_of_interest means the whole image
+        explicit GsPreprocessingContext(const cv::Rect& region_of_interest = cv::Rect());
+
+        // Same as cv::getStructuringElement(shape, size).  The returned Mat shares the cached data.
+        static cv::Mat StructuringElement(int shape, const cv::Size& size);
+
+        // A CLAHE object with the given parameters.  Only for use on the calling thread.
+        static cv::Ptr<cv::CLAHE> Clahe(double clip_limit, int tiles_grid_size);
+
+        bool HasRegionOfInterest() const { return !region_of_interest_.empty(); }
+
+        // A view of the part of the image to preprocess: the region of interest plus margin
+        // pixels on each side (so that filters near its edges see the same neighbors as they
+        // would in the whole image), clipped to the image.  The whole image if there is no
+        // region of interest.
+        cv::Mat RegionToProcess(cv::Mat& image, int margin) const;
+
+    private:
+        cv::Rect region_of_interest_;
+    };
+
+}
@@ -0,0 +1,275 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_http_server.h"
+
+#include "gs_preview_stream.h"
+#include "gs_jpeg_encoder.h"
+
+namespace golf_sim {
+
+    bool GsPreviewStream::kPreviewStreamHttpEnabled = false;
+    int GsPreviewStream::kPreviewStreamMaxFps = 10;
+    int GsPreviewStream::kPreviewStreamMaxWidth = 640;
+    int GsPreviewStream::kPreviewStreamJpegQuality = 70;
+    int GsPreviewStream::kPreviewStreamMaxViewers = 2;
+
+    static const std::string kPreviewPath = "/preview.mjpg";
+    static const std::string kFrameBoundary = "pitracpreviewframe";
+
+    // How long a viewer waits for a new frame before checking that it is still connected
+    static const auto kViewerFrameWait = std::chrono::milliseconds(1000);
+
+    static bool preview_started = false;
+
+    static std::atomic<bool> preview_running{ false };
+    static std::atomic<int> number_of_viewers{ 0 };
+    static std::atomic<int64_t> next_frame_due_ns{ 0 };
+
+    // The scaled-down frame waiting to be encoded
+    static std::mutex pending_frame_mutex;
+    static std::condition_variable pending_frame_ready;
+    static cv::Mat pending_frame;
+    static cv::Rect pending_search_area;
+    static std::thread encoder_thread;
+    static bool encoder_exiting = false;
+
+    // The latest encoded frame, guarded by latest_frame_mutex
+    static std::mutex latest_frame_mutex;
+    static std::condition_variable latest_frame_changed;
+    static std::shared_ptr<const std::string> latest_frame;
+    static uint64_t latest_frame_sequence = 0;
+
+
+    static int64_t GetNowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static void EncodeFrames() {
+
+        cv::Mat frame;
+        cv::Mat bgr_frame;
+        cv::Rect search_area;
+        std::vector<uchar> buffer;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(pending_frame_mutex);
+                pending_frame_ready.wait(lock, [] { return encoder_exiting || !pending_frame.empty(); });
+
+                if (encoder_exiting) {
+                    return;
+                }
+
+                frame = pending_frame;
+                pending_frame = cv::Mat();
+                search_area = pending_search_area;
+            }
+
+            // The overlay is in color even if the camera's frames are not
+            if (frame.channels() == 1) {
+                cv::cvtColor(frame, bgr_frame, cv::COLOR_GRAY2BGR);
+            }
+            else {
+                bgr_frame = frame;
+            }
+
+            if (!search_area.empty()) {
+                cv::rectangle(bgr_frame, search_area, cv::Scalar(0, 255, 0), 2);
+            }
+
+            if (!GsJpegEncoder::Encode(bgr_frame, GsPreviewStream::kPreviewStreamJpegQuality, buffer)) {
+                GS_LOG_TRACE_MSG(warning, "GsPreviewStream - could not encode a preview frame.");
+                continue;
+            }
+
+            std::string part = "--" + kFrameBoundary + "\r\nContent-Type: image/jpeg\r\nContent-Length: " +
+                               std::to_string(buffer.size()) + "\r\n\r\n";
+            part.append(buffer.begin(), buffer.end());
+            part += "\r\n";
+
+            {
+                std::lock_guard<std::mutex> lock(latest_frame_mutex);
+                latest_frame = std::make_shared<const std::string>(std::move(part));
+                latest_frame_sequence++;
+            }
+
+            latest_frame_changed.notify_all();
+        }
+    }
+
+    void GsPreviewStream::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kPreviewStreamHttpEnabled", kPreviewStreamHttpEnabled);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kPreviewStreamMaxFps", kPreviewStreamMaxFps);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kPreviewStreamMaxWidth", kPreviewStreamMaxWidth);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kPreviewStreamJpegQuality", kPreviewStreamJpegQuality);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kPreviewStreamMaxViewers", kPreviewStreamMaxViewers);
+    }
+
+    bool GsPreviewStream::IsRunning() {
+        return preview_running.load(std::memory_order_relaxed);
+    }
+
+    bool GsPreviewStream::WantsFrame() {
+        return preview_running.load(std::memory_order_relaxed) &&
+               number_of_viewers.load(std::memory_order_relaxed) > 0 &&
+               GetNowNs() >= next_frame_due_ns.load(std::memory_order_relaxed);
+    }
+
+    void GsPreviewStream::SubmitFrame(const cv::Mat& frame, const cv::Rect& search_area) {
+
+        if (frame.empty() || !WantsFrame()) {
+            return;
+        }
+
+        next_frame_due_ns.store(GetNowNs() + 1000000000LL / std::max(1, kPreviewStreamMaxFps), std::memory_order_relaxed);
+
+        const double scale = (kPreviewStreamMaxWidth > 0 && frame.cols > kPreviewStreamMaxWidth) ?
+                             (double)kPreviewStreamMaxWidth / frame.cols : 1.0;
+
+        cv::Mat scaled_frame;
+
+        if (scale < 1.0) {
+            cv::resize(frame, scaled_frame, cv::Size(), scale, scale, cv::INTER_LINEAR);
+        }
+        else {
+            scaled_frame = frame.clone();
+        }
+
+        const cv::Rect scaled_search_area((int)(search_area.x * scale), (int)(search_area.y * scale),
+                                          (int)(search_area.width * scale), (int)(search_area.height * scale));
+
+        {
+            std::lock_guard<std::mutex> lock(pending_frame_mutex);
+
+            // A frame that has not been encoded yet is just replaced
+            pending_frame = scaled_frame;
+            pending_search_area = scaled_search_area;
+        }
+
+        pending_frame_ready.notify_one();
+    }
+
+    void GsPreviewStream::Start() {
+        if (!kPreviewStreamHttpEnabled || preview_started) {
+            return;
+        }
+
+        const bool added = GsHttpServer::Get(kPreviewPath, [](const httplib::Request&, httplib::Response& response) {
+
+            if (number_of_viewers.fetch_add(1) >= kPreviewStreamMaxViewers) {
+                number_of_viewers--;
+                response.status = 503;
+                response.set_content("Too many preview viewers", "text/plain");
+                return;
+            }
+
+            // The first frame is sent as soon as there is one
+            next_frame_due_ns.store(0, std::memory_order_relaxed);
+
+            auto last_sent_sequence = std::make_shared<uint64_t>(0);
+
+            response.set_header("Cache-Control", "no-cache");
+            response.set_header("Access-Control-Allow-Origin", "*");
+
+            response.set_content_provider("multipart/x-mixed-replace; boundary=" + kFrameBoundary,
+                [last_sent_sequence](size_t, httplib::DataSink& sink) {
+                    std::shared_ptr<const std::string> frame;
+
+                    {
+                        std::unique_lock<std::mutex> lock(latest_frame_mutex);
+                        latest_frame_changed.wait_for(lock, kViewerFrameWait, [&] {
+                            return !preview_running || latest_frame_sequence > *last_sent_sequence;
+                        });
+
+                        if (!preview_running) {
+                            return false;
+                        }
+
+                        if (latest_frame_sequence > *last_sent_sequence && latest_frame != nullptr) {
+                            frame = latest_frame;
+                            *last_sent_sequence = latest_frame_sequence;
+                        }
+                    }
+
+                    if (frame == nullptr) {
+                        // Nothing new - e.g., the LM is busy with a shot
+                        return sink.is_writable();
+                    }
+
+                    return sink.write(frame->data(), frame->size());
+                },
+                [](bool) {
+                    number_of_viewers--;
+                });
+        });
+
+        if (!added) {
+            GS_LOG_MSG(warning, "GsPreviewStream - kPreviewStreamHttpEnabled is set, but the HTTP server is off (see kHttpServerPort).");
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(pending_frame_mutex);
+            encoder_exiting = false;
+        }
+
+        preview_running = true;
+        encoder_thread = std::thread(&EncodeFrames);
+
+        preview_started = true;
+
+        GS_LOG_MSG(info, "GsPreviewStream - serving the live preview at " + GsHttpServer::GetUrl(kPreviewPath));
+    }
+
+    void GsPreviewStream::Stop() {
+        if (!preview_started) {
+            return;
+        }
+
+        {
+            // Under the lock so that no viewer misses the notification
+            std::lock_guard<std::mutex> lock(latest_frame_mutex);
+            preview_running = false;
+        }
+
+        latest_frame_changed.notify_all();
+
+        {
+            std::lock_guard<std::mutex> lock(pending_frame_mutex);
+            encoder_exiting = true;
+        }
+
+        pending_frame_ready.notify_all();
+
+        if (encoder_thread.joinable()) {
+            encoder_thread.join();
+        }
+
+        // The route stays on the GsHttpServer until it stops, but each new viewer's
+        // stream now ends right away
+        preview_started = false;
+    }
+
+}
+
+#endif // #ifdef __unix__
@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A live, low-resolution MJPEG preview of what the LM sees while it waits for a ball to be
+// teed up, so that the web UI can show a smooth view of the tee area instead of refreshing
+// a search-area image file.  Viewers fetch GET /preview.mjpg (a multipart/x-mixed-replace
+// stream that an <img> tag can show directly) from the GsHttpServer.
+// The capture loops offer their frames with SubmitFrame.  Frames are only taken when
+// someone is watching and at most kPreviewStreamMaxFps times a second, independent of the
+// rate the detector runs at.  A taken frame is scaled down right away (so the camera gets
+// its buffer back) and then has its overlay drawn and is encoded once on the stream's own
+// thread, for all of the viewers.
+
+#pragma once
+
+#ifdef __unix__
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    class GsPreviewStream {
+
+    public:
+        // False (the default) means no preview stream
+        static bool kPreviewStreamHttpEnabled;
+        static int kPreviewStreamMaxFps;
+        // Wider frames are scaled down to this width
+        static int kPreviewStreamMaxWidth;
+        static int kPreviewStreamJpegQuality;
+        // Each viewer holds one of the HTTP server's threads for as long as it watches
+        static int kPreviewStreamMaxViewers;
+
+        static void LoadConfigurationValues();
+
+        // Adds the preview route to the GsHttpServer.  Does nothing unless
+        // kPreviewStreamHttpEnabled is set.  Stop ends every viewer's stream, so must be
+        // called before the GsHttpServer is stopped.
+        static void Start();
+        static void Stop();
+
+        static bool IsRunning();
+
+        // True if someone is watching and the next frame is due.  Cheap enough to be
+        // called for every captured frame.
+        static bool WantsFrame();
+
+        // Offers a CV_8UC1 or CV_8UC3 frame to the stream, which copies what it needs before
+        // returning.  search_area (in frame coordinates), if not empty, is drawn on the preview.
+        static void SubmitFrame(const cv::Mat& frame, const cv::Rect& search_area = cv::Rect());
+    };
+
+}
+
+#endif // #ifdef __unix__
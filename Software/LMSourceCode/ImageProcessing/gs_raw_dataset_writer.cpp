@@ -0,0 +1,251 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_shot_archive.h"
+#include "image/image.hpp"
+#include "gs_metrics.h"
+#include "worker_thread.h"
+
+#include "gs_raw_dataset_writer.h"
+
+namespace golf_sim {
+
+    bool GsRawDatasetWriter::kRawDatasetCaptureEnabled = false;
+    std::string GsRawDatasetWriter::kRawDatasetDirectory;
+    std::string GsRawDatasetWriter::kRawDatasetFormat = "dng";
+    int GsRawDatasetWriter::kRawDatasetMaxQueuedMegabytes = 64;
+
+    static const std::string kArchiveFileName = "raw_dataset.psa";
+
+    struct RawDatasetFrame {
+        std::string name;
+        // Either the raw buffer (with its stream info and metadata) or a processed frame
+        std::vector<uint8_t> raw;
+        StreamInfo info;
+        libcamera::ControlList metadata;
+        std::string camera_model;
+        cv::Mat frame;
+
+        size_t Bytes() const { return raw.size() + frame.total() * frame.elemSize(); }
+    };
+
+    static std::deque<RawDatasetFrame> queue;
+    static std::mutex queue_mutex;
+    static bool exiting = false;
+    static size_t queued_bytes = 0;
+    static long next_frame_number = 0;
+
+    static std::atomic<long> number_written{ 0 };
+    static std::atomic<long> number_dropped{ 0 };
+    static std::atomic<long> number_failed{ 0 };
+
+
+    static std::string GetDatasetDirectory() {
+        std::string directory = GsRawDatasetWriter::kRawDatasetDirectory;
+
+        if (directory.empty()) {
+            directory = LoggingTools::kBaseImageLoggingDir + "raw_dataset/";
+        }
+
+        if (directory.back() != '/') {
+            directory += '/';
+        }
+
+        return directory;
+    }
+
+    static bool WriteFrame(RawDatasetFrame& frame, GsShotArchiveWriter& archive_writer) {
+
+        if (!frame.raw.empty()) {
+            const std::string file_name = GetDatasetDirectory() + frame.name + ".dng";
+
+            try {
+                std::vector<libcamera::Span<uint8_t>> mem = { libcamera::Span<uint8_t>(frame.raw.data(), frame.raw.size()) };
+                dng_save(mem, frame.info, frame.metadata, file_name, frame.camera_model, nullptr);
+            }
+            catch (std::exception const& e) {
+                GS_LOG_MSG(warning, "GsRawDatasetWriter - could not write " + file_name + ": " + std::string(e.what()));
+                return false;
+            }
+
+            return true;
+        }
+
+        return archive_writer.AddFrame(frame.name, frame.frame);
+    }
+
+    // Only used by writer_job, and then by Shutdown once the job is idle
+    static bool directory_created = false;
+    // Only opened if there is a processed frame to write
+    static GsShotArchiveWriter archive_writer;
+    static bool archive_opened = false;
+
+    // Writes the oldest queued frame
+    static bool ProcessFrame() {
+        RawDatasetFrame frame;
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+
+            if (queue.empty()) {
+                return false;
+            }
+
+            frame = std::move(queue.front());
+            queue.pop_front();
+            queued_bytes -= frame.Bytes();
+        }
+
+        if (!directory_created) {
+            std::error_code error;
+            std::filesystem::create_directories(GetDatasetDirectory(), error);
+            directory_created = true;
+        }
+
+        if (frame.raw.empty() && !archive_opened) {
+            archive_opened = archive_writer.Open(GetDatasetDirectory() + kArchiveFileName);
+        }
+
+        if ((frame.raw.empty() && !archive_opened) || !WriteFrame(frame, archive_writer)) {
+            number_failed++;
+        }
+        else {
+            number_written++;
+            GS_LOG_TRACE_MSG(trace, "GsRawDatasetWriter - wrote " + frame.name);
+        }
+
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return !queue.empty();
+    }
+
+    static GsBackgroundJob writer_job(&ProcessFrame);
+
+    // Takes the lock, and returns false (counting the frame as dropped) if there is no room.
+    // Otherwise, bytes are reserved in the queue and the frame's name is returned.
+    static bool ReserveSpace(size_t bytes, std::string& name) {
+
+        std::lock_guard<std::mutex> lock(queue_mutex);
+
+        if (exiting || queued_bytes + bytes > (size_t)GsRawDatasetWriter::kRawDatasetMaxQueuedMegabytes * 1024 * 1024) {
+            number_dropped++;
+            GsMetrics::Increment(GsMetrics::Counter::kDroppedRawFrames);
+            return false;
+        }
+
+        queued_bytes += bytes;
+        name = "cam2_" + LoggingTools::GetUniqueLogName() + "_" + std::to_string(next_frame_number++);
+
+        return true;
+    }
+
+    static void Enqueue(RawDatasetFrame&& frame) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            queue.push_back(std::move(frame));
+        }
+
+        writer_job.Schedule();
+    }
+
+    void GsRawDatasetWriter::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.logging.kRawDatasetCaptureEnabled", kRawDatasetCaptureEnabled);
+        GolfSimConfiguration::SetConstant("gs_config.logging.kRawDatasetDirectory", kRawDatasetDirectory);
+        GolfSimConfiguration::SetConstant("gs_config.logging.kRawDatasetFormat", kRawDatasetFormat);
+        GolfSimConfiguration::SetConstant("gs_config.logging.kRawDatasetMaxQueuedMegabytes", kRawDatasetMaxQueuedMegabytes);
+
+        std::transform(kRawDatasetFormat.begin(), kRawDatasetFormat.end(), kRawDatasetFormat.begin(), ::tolower);
+
+        if (kRawDatasetFormat != "dng" && kRawDatasetFormat != "archive") {
+            GS_LOG_MSG(warning, "Unknown kRawDatasetFormat '" + kRawDatasetFormat + "'.  Using dng.");
+            kRawDatasetFormat = "dng";
+        }
+
+        if (kRawDatasetCaptureEnabled) {
+            GS_LOG_MSG(info, "GsRawDatasetWriter - capturing camera 2 frames (" + kRawDatasetFormat + ") to " + GetDatasetDirectory());
+        }
+    }
+
+    bool GsRawDatasetWriter::IsEnabled() {
+        return kRawDatasetCaptureEnabled;
+    }
+
+    bool GsRawDatasetWriter::WantsRawFrames() {
+        return kRawDatasetFormat == "dng";
+    }
+
+    void GsRawDatasetWriter::SubmitRawFrame(const libcamera::Span<const uint8_t>& raw, const StreamInfo& info,
+                                            const libcamera::ControlList& metadata, const std::string& camera_model) {
+
+        RawDatasetFrame frame;
+
+        if (!kRawDatasetCaptureEnabled || raw.empty() || !ReserveSpace(raw.size(), frame.name)) {
+            return;
+        }
+
+        frame.raw.assign(raw.begin(), raw.end());
+        frame.info = info;
+        frame.metadata = metadata;
+        frame.camera_model = camera_model;
+
+        Enqueue(std::move(frame));
+    }
+
+    void GsRawDatasetWriter::SubmitFrame(const cv::Mat& img) {
+
+        RawDatasetFrame frame;
+
+        if (!kRawDatasetCaptureEnabled || img.empty() || !ReserveSpace(img.total() * img.elemSize(), frame.name)) {
+            return;
+        }
+
+        frame.frame = img.clone();
+
+        Enqueue(std::move(frame));
+    }
+
+    void GsRawDatasetWriter::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+
+            if (exiting) {
+                return;
+            }
+
+            exiting = true;
+        }
+
+        // Whatever is left is written first
+        writer_job.WaitUntilIdle();
+
+        if (archive_opened) {
+            archive_writer.Close();
+            archive_opened = false;
+        }
+
+        if (kRawDatasetCaptureEnabled) {
+            GS_LOG_MSG(info, "GsRawDatasetWriter statistics at shutdown: " + GetStatistics());
+        }
+    }
+
+    std::string GsRawDatasetWriter::GetStatistics() {
+        return "written=" + std::to_string(number_written.load()) +
+               ", dropped=" + std::to_string(number_dropped.load()) +
+               ", failed=" + std::to_string(number_failed.load());
+    }
+
+}
+
+#endif // #ifdef __unix__
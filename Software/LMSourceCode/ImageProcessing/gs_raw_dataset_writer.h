@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Background capture of camera 2's final (strobed) frame for every shot, to build training
+// and regression data sets from live traffic.
+// The camera loop only copies the frame into a queue here.  The shared, niced-down
+// GsBackgroundWorker then writes each one, either as a DNG of the sensor's raw (Bayer or mono) buffer, or, for the
+// "archive" format, as the camera's processed frame appended to a shot archive (see
+// gs_shot_archive.h).  The queue is bounded by its total size in bytes, and a frame that
+// does not fit is dropped rather than waited for, so the capture never slows the camera
+// or the FSM down.
+
+#pragma once
+
+#ifdef __unix__
+
+#include <string>
+
+#include <libcamera/base/span.h>
+#include <libcamera/controls.h>
+
+#include <opencv2/core.hpp>
+
+#include "core/stream_info.hpp"
+
+namespace golf_sim {
+
+    class GsRawDatasetWriter {
+
+    public:
+        static bool kRawDatasetCaptureEnabled;
+        // Empty means a "raw_dataset/" directory under the image logging directory
+        static std::string kRawDatasetDirectory;
+        // "dng" or "archive"
+        static std::string kRawDatasetFormat;
+        static int kRawDatasetMaxQueuedMegabytes;
+
+        static void LoadConfigurationValues();
+
+        static bool IsEnabled();
+
+        // True if frames should be submitted with SubmitRawFrame rather than SubmitFrame
+        static bool WantsRawFrames();
+
+        // Each copies the frame (if there is room for it in the queue) and returns right away.
+        // raw is the sensor's raw buffer, as described by info.
+        static void SubmitRawFrame(const libcamera::Span<const uint8_t>& raw, const StreamInfo& info,
+                                   const libcamera::ControlList& metadata, const std::string& camera_model);
+        static void SubmitFrame(const cv::Mat& frame);
+
+        // Writes whatever is still queued, closes the archive and stops taking frames
+        static void Shutdown();
+
+        // E.g., "written=10, dropped=0, failed=0"
+        static std::string GetStatistics();
+    };
+
+}
+
+#endif // #ifdef __unix__
@@ -0,0 +1,529 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <msgpack.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_globals.h"
+#include "gs_clubs.h"
+#include "gs_camera.h"
+#include "gs_session_settings.h"
+
+#include "gs_remote_analysis.h"
+
+namespace golf_sim {
+
+    std::string GsRemoteAnalysis::kRemoteAnalysisAddress = "";
+    int GsRemoteAnalysis::kRemoteAnalysisPort = 9211;
+    int GsRemoteAnalysis::kRemoteAnalysisTimeoutMs = 5000;
+
+    static const uint32_t kRemoteAnalysisMagic = 0x50545241;  // "PTRA"
+    static const uint32_t kRemoteAnalysisVersion = 1;
+
+    // Well above three uncompressed full-resolution color images
+    static const uint32_t kMaxRemoteAnalysisPayloadBytes = 64 * 1024 * 1024;
+
+    // Limits how long the worker may take to notice that it should exit
+    static const int kWorkerAcceptPollTimeoutMs = 500;
+
+    static const int kExposuresImageJpegQuality = 85;
+
+
+    void GsRemoteAnalysis::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kRemoteAnalysisAddress", kRemoteAnalysisAddress);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kRemoteAnalysisPort", kRemoteAnalysisPort);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kRemoteAnalysisTimeoutMs", kRemoteAnalysisTimeoutMs);
+    }
+
+    // The sockets are non-blocking, and every send and receive of an exchange waits against
+    // the one deadline, so that a slow peer cannot stretch the exchange out one call at a time
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    static Deadline DeadlineFromNow(int timeout_ms) {
+        return std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+
+    // Sets errno to ETIMEDOUT if the deadline passes first
+    static bool WaitForSocket(int fd, short events, const Deadline& deadline) {
+        while (true) {
+            const long long remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining_ms <= 0) {
+                errno = ETIMEDOUT;
+                return false;
+            }
+
+            struct pollfd poll_fd = { fd, events, 0 };
+            const int ready = poll(&poll_fd, 1, (int)remaining_ms);
+
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready == 0) {
+                errno = ETIMEDOUT;
+                return false;
+            }
+
+            // An error or hang-up is left for the send or receive to report
+            return ready > 0;
+        }
+    }
+
+    static bool WriteAll(int fd, const char* data, size_t length, const Deadline& deadline) {
+        while (length > 0) {
+            if (!WaitForSocket(fd, POLLOUT, deadline)) {
+                return false;
+            }
+            ssize_t written = send(fd, data, length, MSG_NOSIGNAL);
+            if (written < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            length -= (size_t)written;
+        }
+        return true;
+    }
+
+    static bool ReadAll(int fd, char* data, size_t length, const Deadline& deadline) {
+        while (length > 0) {
+            if (!WaitForSocket(fd, POLLIN, deadline)) {
+                return false;
+            }
+            ssize_t received = recv(fd, data, length, 0);
+            if (received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+                continue;
+            }
+            if (received <= 0) {
+                return false;
+            }
+            data += received;
+            length -= (size_t)received;
+        }
+        return true;
+    }
+
+    static bool WriteFrame(int fd, const msgpack::sbuffer& payload, const Deadline& deadline) {
+        const uint32_t header[2] = { htonl(kRemoteAnalysisMagic), htonl((uint32_t)payload.size()) };
+        return WriteAll(fd, (const char*)header, sizeof(header), deadline) && WriteAll(fd, payload.data(), payload.size(), deadline);
+    }
+
+    static bool ReadFrame(int fd, std::string& payload, const Deadline& deadline) {
+        uint32_t header[2];
+        if (!ReadAll(fd, (char*)header, sizeof(header), deadline)) {
+            return false;
+        }
+
+        const uint32_t payload_bytes = ntohl(header[1]);
+        if (ntohl(header[0]) != kRemoteAnalysisMagic || payload_bytes > kMaxRemoteAnalysisPayloadBytes) {
+            GS_LOG_MSG(error, "GsRemoteAnalysis - received a malformed message header.");
+            return false;
+        }
+
+        payload.resize(payload_bytes);
+        return ReadAll(fd, payload.data(), payload_bytes, deadline);
+    }
+
+    static void SetSocketOptions(int fd) {
+        int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    }
+
+    template <typename Packer>
+    static void PackImage(Packer& packer, const cv::Mat& image) {
+        const cv::Mat continuous_image = image.isContinuous() ? image : image.clone();
+        const size_t image_bytes = continuous_image.total() * continuous_image.elemSize();
+
+        packer.pack_array(4);
+        packer.pack(continuous_image.rows);
+        packer.pack(continuous_image.cols);
+        packer.pack(continuous_image.type());
+        packer.pack_bin((uint32_t)image_bytes);
+        packer.pack_bin_body((const char*)continuous_image.data, (uint32_t)image_bytes);
+    }
+
+    static bool UnpackImage(const msgpack::object& object, cv::Mat& image) {
+        if (object.type != msgpack::type::ARRAY || object.via.array.size != 4 ||
+            object.via.array.ptr[3].type != msgpack::type::BIN) {
+            return false;
+        }
+
+        const int rows = object.via.array.ptr[0].as<int>();
+        const int cols = object.via.array.ptr[1].as<int>();
+        const int type = object.via.array.ptr[2].as<int>();
+        const msgpack::object_bin& bin = object.via.array.ptr[3].via.bin;
+
+        if (rows == 0 || cols == 0) {
+            image = cv::Mat();
+            return true;
+        }
+
+        if (rows < 0 || cols < 0 || (size_t)bin.size != (size_t)rows * (size_t)cols * CV_ELEM_SIZE(type)) {
+            return false;
+        }
+
+        // Copied so that the image outlives the received message
+        image = cv::Mat(rows, cols, type, (void*)bin.ptr).clone();
+        return true;
+    }
+
+    // Returns nullptr if the map does not have the key
+    static const msgpack::object* FindValue(const msgpack::object& map, const char* key) {
+        if (map.type != msgpack::type::MAP) {
+            return nullptr;
+        }
+
+        for (uint32_t i = 0; i < map.via.map.size; i++) {
+            const msgpack::object& map_key = map.via.map.ptr[i].key;
+            if (map_key.type == msgpack::type::STR && map_key.via.str.size == strlen(key) &&
+                strncmp(map_key.via.str.ptr, key, map_key.via.str.size) == 0) {
+                return &map.via.map.ptr[i].val;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static const msgpack::object& GetRequiredValue(const msgpack::object& map, const char* key) {
+        const msgpack::object* value = FindValue(map, key);
+        if (value == nullptr) {
+            throw std::runtime_error("missing " + std::string(key));
+        }
+        return *value;
+    }
+
+    static int ConnectToWorker(const std::string& address, int port, const Deadline& deadline) {
+
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        struct addrinfo* addresses = nullptr;
+        if (getaddrinfo(address.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0 || addresses == nullptr) {
+            GS_LOG_MSG(warning, "GsRemoteAnalysis - could not resolve " + address);
+            return -1;
+        }
+
+        int fd = socket(addresses->ai_family, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (fd < 0) {
+            freeaddrinfo(addresses);
+            return -1;
+        }
+
+        // Connect without blocking so that an unreachable worker cannot hold up the shot past the deadline
+        int status = connect(fd, addresses->ai_addr, addresses->ai_addrlen);
+        freeaddrinfo(addresses);
+
+        if (status != 0 && errno == EINPROGRESS) {
+            int socket_error = 0;
+            socklen_t socket_error_length = sizeof(socket_error);
+
+            if (WaitForSocket(fd, POLLOUT, deadline) &&
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &socket_error, &socket_error_length) == 0 && socket_error == 0) {
+                status = 0;
+            }
+        }
+
+        if (status != 0) {
+            close(fd);
+            return -1;
+        }
+
+        // Left non-blocking for WriteAll and ReadAll
+        SetSocketOptions(fd);
+
+        return fd;
+    }
+
+    bool GsRemoteAnalysis::ProcessReceivedCam2Image(const cv::Mat& ball1_mat,
+                                                    const cv::Mat& strobed_ball_mat,
+                                                    const cv::Mat& camera2_pre_image_color,
+                                                    GsAnalysisContext& context,
+                                                    GolfBall& result_ball,
+                                                    cv::Vec3d& rotationResults,
+                                                    cv::Mat& exposures_image,
+                                                    std::vector<GolfBall>& exposure_balls) {
+
+        if (!kRemoteAnalysisAddress.empty()) {
+            if (AnalyzeRemotely(ball1_mat, strobed_ball_mat, camera2_pre_image_color, context, result_ball, rotationResults, exposures_image, exposure_balls)) {
+                return true;
+            }
+
+            GS_LOG_MSG(warning, "GsRemoteAnalysis - the remote analysis failed.  Analyzing the shot locally.");
+            result_ball = GolfBall();
+            exposure_balls.clear();
+        }
+
+        const bool success = GolfSimCamera::ProcessReceivedCam2Image(ball1_mat, strobed_ball_mat, camera2_pre_image_color, context,
+                                                                     result_ball, rotationResults, exposures_image, exposure_balls);
+
+        // The command-line handedness is overridden by whatever the shot showed
+        GsSessionSettings::SetGolferHandedness(context.golfer_orientation);
+
+        return success;
+    }
+
+    bool GsRemoteAnalysis::AnalyzeRemotely(const cv::Mat& ball1_mat,
+                                           const cv::Mat& strobed_ball_mat,
+                                           const cv::Mat& camera2_pre_image_color,
+                                           const GsAnalysisContext& context,
+                                           GolfBall& result_ball,
+                                           cv::Vec3d& rotationResults,
+                                           cv::Mat& exposures_image,
+                                           std::vector<GolfBall>& exposure_balls) {
+
+        auto start = std::chrono::steady_clock::now();
+
+        msgpack::sbuffer request;
+        msgpack::packer<msgpack::sbuffer> packer(request);
+
+        packer.pack_map(5);
+        packer.pack("version");
+        packer.pack(kRemoteAnalysisVersion);
+        packer.pack("club_type");
+        packer.pack((int)context.club_type);
+        packer.pack("ball1");
+        PackImage(packer, ball1_mat);
+        packer.pack("strobed");
+        PackImage(packer, strobed_ball_mat);
+        packer.pack("pre_image");
+        PackImage(packer, camera2_pre_image_color);
+
+        // Everything from here until the response is in, including the worker's analysis
+        const Deadline deadline = DeadlineFromNow(kRemoteAnalysisTimeoutMs);
+
+        int fd = ConnectToWorker(kRemoteAnalysisAddress, kRemoteAnalysisPort, deadline);
+        if (fd < 0) {
+            GS_LOG_MSG(warning, "GsRemoteAnalysis - could not connect to " + kRemoteAnalysisAddress + ":" + std::to_string(kRemoteAnalysisPort));
+            return false;
+        }
+
+        std::string response_payload;
+        bool exchanged = WriteFrame(fd, request, deadline) && ReadFrame(fd, response_payload, deadline);
+        close(fd);
+
+        if (!exchanged) {
+            GS_LOG_MSG(warning, "GsRemoteAnalysis - no response from the worker: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        try {
+            msgpack::object_handle handle = msgpack::unpack(response_payload.data(), response_payload.size());
+            const msgpack::object& response = handle.get();
+
+            const msgpack::object* success = FindValue(response, "success");
+            if (success == nullptr || !success->as<bool>()) {
+                GS_LOG_MSG(warning, "GsRemoteAnalysis - the worker could not analyze the shot.");
+                return false;
+            }
+
+            std::vector<double> angles = GetRequiredValue(response, "angles_deg").as<std::vector<double>>();
+            std::vector<double> spin = GetRequiredValue(response, "rotation_speeds_rpm").as<std::vector<double>>();
+            std::vector<double> rotation = GetRequiredValue(response, "rotation_deg").as<std::vector<double>>();
+
+            if (angles.size() != 2 || spin.size() != 3 || rotation.size() != 3) {
+                GS_LOG_MSG(error, "GsRemoteAnalysis - the worker's response is malformed.");
+                return false;
+            }
+
+            result_ball.velocity_ = GetRequiredValue(response, "velocity_mps").as<double>();
+            result_ball.angles_ball_perspective_ = cv::Vec2d(angles[0], angles[1]);
+            result_ball.rotation_speeds_RPM_ = cv::Vec3d(spin[0], spin[1], spin[2]);
+            result_ball.time_between_ball_positions_for_velocity_uS_ = GetRequiredValue(response, "velocity_time_us").as<long>();
+            rotationResults = cv::Vec3d(rotation[0], rotation[1], rotation[2]);
+
+            // x, y, radius (pixels) and then the x, y, z distances (meters) of each exposure
+            exposure_balls.clear();
+            for (const std::vector<double>& exposure : GetRequiredValue(response, "exposures").as<std::vector<std::vector<double>>>()) {
+                if (exposure.size() != 6) {
+                    continue;
+                }
+
+                GolfBall exposure_ball;
+                exposure_ball.ball_circle_ = GsCircle((float)exposure[0], (float)exposure[1], (float)exposure[2]);
+                exposure_ball.distances_ortho_camera_perspective_ = cv::Vec3d(exposure[3], exposure[4], exposure[5]);
+                exposure_balls.push_back(exposure_ball);
+            }
+
+            const msgpack::object* exposures_jpeg = FindValue(response, "exposures_image_jpeg");
+            if (exposures_jpeg != nullptr && exposures_jpeg->type == msgpack::type::BIN && exposures_jpeg->via.bin.size > 0) {
+                exposures_image = cv::imdecode(cv::Mat(1, (int)exposures_jpeg->via.bin.size, CV_8UC1, (void*)exposures_jpeg->via.bin.ptr), cv::IMREAD_COLOR);
+            }
+        }
+        catch (std::exception& e) {
+            GS_LOG_MSG(error, "GsRemoteAnalysis - could not decode the worker's response - Error was: " + std::string(e.what()));
+            return false;
+        }
+
+        auto round_trip_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        GS_LOG_MSG(info, "GsRemoteAnalysis - shot analyzed by " + kRemoteAnalysisAddress + " in " + std::to_string(round_trip_ms) + "ms (round trip).");
+
+        return true;
+    }
+
+    bool GsRemoteAnalysis::RunWorker() {
+
+        int listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0) {
+            GS_LOG_MSG(error, "GsRemoteAnalysis - could not create socket: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        int reuse_address = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons((uint16_t)kRemoteAnalysisPort);
+
+        if (bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listen_fd, 4) != 0) {
+            GS_LOG_MSG(error, "GsRemoteAnalysis - could not listen on port " + std::to_string(kRemoteAnalysisPort) + ": " + std::string(strerror(errno)));
+            close(listen_fd);
+            return false;
+        }
+
+        GS_LOG_MSG(info, "GsRemoteAnalysis - waiting for shots to analyze on port " + std::to_string(kRemoteAnalysisPort));
+
+        while (GolfSimGlobals::golf_sim_running_) {
+            struct pollfd poll_fd = { listen_fd, POLLIN, 0 };
+
+            if (poll(&poll_fd, 1, kWorkerAcceptPollTimeoutMs) <= 0 || !(poll_fd.revents & POLLIN)) {
+                continue;
+            }
+
+            int client_fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (client_fd < 0) {
+                continue;
+            }
+
+            // The analysis uses the whole machine anyway, so the shots are taken one at a time
+            ServeConnection(client_fd);
+            close(client_fd);
+        }
+
+        close(listen_fd);
+        return true;
+    }
+
+    void GsRemoteAnalysis::ServeConnection(int client_fd) {
+
+        SetSocketOptions(client_fd);
+
+        // The worker's own analysis time is not counted against either the request or the response
+        std::string request_payload;
+        if (!ReadFrame(client_fd, request_payload, DeadlineFromNow(kRemoteAnalysisTimeoutMs))) {
+            GS_LOG_MSG(warning, "GsRemoteAnalysis - could not read a request.");
+            return;
+        }
+
+        cv::Mat ball1_mat;
+        cv::Mat strobed_ball_mat;
+        cv::Mat camera2_pre_image;
+        bool success = false;
+
+        GolfBall result_ball;
+        cv::Vec3d rotation_results(0, 0, 0);
+        cv::Mat exposures_image;
+        std::vector<GolfBall> exposure_balls;
+
+        try {
+            msgpack::object_handle handle = msgpack::unpack(request_payload.data(), request_payload.size());
+            const msgpack::object& request = handle.get();
+
+            const msgpack::object* version = FindValue(request, "version");
+            const msgpack::object* club_type = FindValue(request, "club_type");
+            const msgpack::object* ball1 = FindValue(request, "ball1");
+            const msgpack::object* strobed = FindValue(request, "strobed");
+            const msgpack::object* pre_image = FindValue(request, "pre_image");
+
+            if (version == nullptr || version->as<uint32_t>() != kRemoteAnalysisVersion ||
+                club_type == nullptr || ball1 == nullptr || strobed == nullptr || pre_image == nullptr ||
+                !UnpackImage(*ball1, ball1_mat) || !UnpackImage(*strobed, strobed_ball_mat) || !UnpackImage(*pre_image, camera2_pre_image)) {
+                GS_LOG_MSG(error, "GsRemoteAnalysis - received a malformed request.");
+            }
+            else {
+                // E.g., putting is analyzed differently
+                GolfSimClubs::SetCurrentClubType((GolfSimClubs::GsClubType)club_type->as<int>());
+
+                success = GolfSimCamera::ProcessReceivedCam2Image(ball1_mat, strobed_ball_mat, camera2_pre_image,
+                                                                  result_ball, rotation_results, exposures_image, exposure_balls);
+            }
+        }
+        catch (std::exception& e) {
+            GS_LOG_MSG(error, "GsRemoteAnalysis - could not process a request - Error was: " + std::string(e.what()));
+            success = false;
+        }
+
+        msgpack::sbuffer response;
+        msgpack::packer<msgpack::sbuffer> packer(response);
+
+        if (!success) {
+            packer.pack_map(1);
+            packer.pack("success");
+            packer.pack(false);
+        }
+        else {
+            std::vector<uchar> exposures_jpeg;
+            if (!exposures_image.empty()) {
+                cv::imencode(".jpg", exposures_image, exposures_jpeg, { cv::IMWRITE_JPEG_QUALITY, kExposuresImageJpegQuality });
+            }
+
+            std::vector<std::vector<double>> exposures;
+            for (const GolfBall& exposure_ball : exposure_balls) {
+                exposures.push_back({ exposure_ball.ball_circle_[0], exposure_ball.ball_circle_[1], exposure_ball.ball_circle_[2],
+                                      exposure_ball.distances_ortho_camera_perspective_[0],
+                                      exposure_ball.distances_ortho_camera_perspective_[1],
+                                      exposure_ball.distances_ortho_camera_perspective_[2] });
+            }
+
+            packer.pack_map(8);
+            packer.pack("success");
+            packer.pack(true);
+            packer.pack("velocity_mps");
+            packer.pack(result_ball.velocity_);
+            packer.pack("angles_deg");
+            packer.pack(std::vector<double>{ result_ball.angles_ball_perspective_[0], result_ball.angles_ball_perspective_[1] });
+            packer.pack("rotation_speeds_rpm");
+            packer.pack(std::vector<double>{ result_ball.rotation_speeds_RPM_[0], result_ball.rotation_speeds_RPM_[1], result_ball.rotation_speeds_RPM_[2] });
+            packer.pack("velocity_time_us");
+            packer.pack(result_ball.time_between_ball_positions_for_velocity_uS_);
+            packer.pack("rotation_deg");
+            packer.pack(std::vector<double>{ rotation_results[0], rotation_results[1], rotation_results[2] });
+            packer.pack("exposures");
+            packer.pack(exposures);
+            packer.pack("exposures_image_jpeg");
+            packer.pack_bin((uint32_t)exposures_jpeg.size());
+            packer.pack_bin_body((const char*)exposures_jpeg.data(), (uint32_t)exposures_jpeg.size());
+        }
+
+        if (!WriteFrame(client_fd, response, DeadlineFromNow(kRemoteAnalysisTimeoutMs))) {
+            GS_LOG_MSG(warning, "GsRemoteAnalysis - could not send the response.");
+        }
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Optionally moves the post-hit analysis (ProcessReceivedCam2Image - exposure
+// selection, trajectory, spin) off of the capture Pi.  The capture side sends the
+// teed-ball image, the strobed image, the camera2 pre-image and the current club
+// over TCP to a worker that is running this same code in the
+// "remote_analysis_worker" system mode, and gets back just the values that the FSM
+// needs from the result.  Several capture Pis can share one (faster) worker.
+// The worker must be run with the same calibration (the same golf_sim_config.json
+// values) as the capture Pi.  If the worker cannot be reached or fails, the shot is
+// analyzed locally.
+//
+// Each message is an 8-byte header (a "PTRA" magic number and the payload size,
+// both big-endian) followed by a MessagePack payload.  Images are sent uncompressed.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "golf_ball.h"
+#include "gs_shot_analysis.h"
+
+namespace golf_sim {
+
+    class GsRemoteAnalysis {
+
+    public:
+        // An empty address (the default) means that every shot is analyzed locally
+        static std::string kRemoteAnalysisAddress;
+        // The port that the capture side connects to and that the worker listens on
+        static int kRemoteAnalysisPort;
+        // The capture side's deadline for the connection and the whole round trip of one shot,
+        // including the worker's analysis.  The worker allows the same for reading each request
+        // and, separately, for sending each response.
+        static int kRemoteAnalysisTimeoutMs;
+
+        static void LoadConfigurationValues();
+
+        // Same as GolfSimCamera::ProcessReceivedCam2Image, but tries the remote worker first
+        // if one is configured.  The exposures_image comes back JPEG-compressed from a worker.
+        // The shot's settings come from the context, which the caller makes when the shot is
+        // taken, as the analysis may run after the next shot has been armed.  A worker finds the
+        // teed ball itself, so only a local analysis uses the context's teed_ball_context.
+        static bool ProcessReceivedCam2Image(const cv::Mat& ball1_mat,
+                                             const cv::Mat& strobed_ball_mat,
+                                             const cv::Mat& camera2_pre_image_color,
+                                             GsAnalysisContext& context,
+                                             GolfBall& result_ball,
+                                             cv::Vec3d& rotationResults,
+                                             cv::Mat& exposures_image,
+                                             std::vector<GolfBall>& exposure_balls);
+
+        // Serves analysis requests on kRemoteAnalysisPort, one at a time, until
+        // GolfSimGlobals::golf_sim_running_ is cleared
+        static bool RunWorker();
+
+    private:
+        static bool AnalyzeRemotely(const cv::Mat& ball1_mat,
+                                    const cv::Mat& strobed_ball_mat,
+                                    const cv::Mat& camera2_pre_image_color,
+                                    const GsAnalysisContext& context,
+                                    GolfBall& result_ball,
+                                    cv::Vec3d& rotationResults,
+                                    cv::Mat& exposures_image,
+                                    std::vector<GolfBall>& exposure_balls);
+
+        static void ServeConnection(int client_fd);
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -6,12 +6,16 @@
 // Representation of the results of processing a golf shot
 
 #include <regex>
+#include <sstream>
+#include <msgpack.hpp>
 #include "gs_format_lib.h"
 #include "math.h"
 #include "logging_tools.h"
 #include "cv_utils.h"
+#include "gs_ball_flight.h"
 
 #include "gs_results.h"
+#include "gs_session_settings.h"
 
 namespace golf_sim {
 
@@ -21,7 +25,26 @@ namespace golf_sim {
     GsResults::~GsResults() {
     }
 
-    GsResults::GsResults(const GolfBall& ball) {
+    static bool EstimateFlight(const GolfBall& ball, GsBallFlightResult& flight) {
+        GsBallLaunch launch;
+        launch.speed_mps = ball.velocity_;
+        launch.vla_deg = (float)ball.angles_ball_perspective_[1];
+        launch.hla_deg = (float)ball.angles_ball_perspective_[0];
+        launch.back_spin_rpm = (int)ball.rotation_speeds_RPM_[2];
+        launch.side_spin_rpm = (int)ball.rotation_speeds_RPM_[0];
+
+        return GsBallFlight::Estimate(launch, flight);
+    }
+
+    GsResults::GsResults(const GolfBall& ball) : GsResults(ball, nullptr) {
+        GsBallFlightResult flight;
+
+        if (EstimateFlight(ball, flight)) {
+            SetFlight(flight);
+        }
+    }
+
+    GsResults::GsResults(const GolfBall& ball, const GsBallFlightResult* flight) {
         shot_number_ = 0;
         speed_mph_ = (float)CvUtils::MetersPerSecondToMPH((float)ball.velocity_);
         hla_deg_ = (float)(ball.angles_ball_perspective_[0]);
@@ -30,13 +53,22 @@ namespace golf_sim {
         side_spin_rpm_ = (int)ball.rotation_speeds_RPM_[0];
         // TBD - Not sure club type should be set here,
         // but this is a reasonable default for now
-        club_type_ = GolfSimClubs::GetCurrentClubType();
+        club_type_ = GsSessionSettings::ShotSettings().club_type;
 
         // Real shot data implies a ball was definitely detected.
         heartbeat_ball_detected_ = true;
 
-        // TBD - Even though this is a constructor, it might be a reasonable
-        // place to calculate the Carry yardarge.
+        if (flight != nullptr) {
+            SetFlight(*flight);
+        }
+    }
+
+    void GsResults::SetFlight(const GsBallFlightResult& flight) {
+        carry_m_ = (float)flight.carry_m;
+        total_m_ = (float)flight.total_m;
+        apex_m_ = (float)flight.apex_m;
+        descent_deg_ = (float)flight.descent_deg;
+        flight_time_s_ = (float)flight.flight_time_s;
     }
 
     float GsResults::GetSpinAxis() const {
@@ -57,8 +89,8 @@ namespace golf_sim {
         s += "Side Spin:        " + std::to_string(side_spin_rpm_) + "\n";
         s += "Spin Axis (deg.): " + std::to_string(GetSpinAxis()) + "\n";
         s += "Club Type: (1D 3P)" + std::to_string(club_type_) + "\n";
-
-        // TBD - Add internal carry value.
+        s += "Carry (yards):    " + std::to_string(CvUtils::MetersToYards(carry_m_)) + "\n";
+        s += "Total (yards):    " + std::to_string(CvUtils::MetersToYards(total_m_)) + "\n";
 
         return s;
     }
@@ -113,4 +145,93 @@ namespace golf_sim {
         return result;
     }
 
+    std::string GsResults::SerializeToMsgPack() const {
+
+        msgpack::sbuffer buffer;
+        msgpack::packer<msgpack::sbuffer> packer(buffer);
+
+        const bool has_exposures = !exposures_.empty();
+
+        packer.pack_map(16 + (has_exposures ? 1 : 0) + (has_club_data_ ? 2 : 0));
+
+        packer.pack("shot_number");
+        packer.pack(shot_number_);
+        packer.pack("speed_mph");
+        packer.pack(speed_mph_);
+        packer.pack("hla_deg");
+        packer.pack(hla_deg_);
+        packer.pack("vla_deg");
+        packer.pack(vla_deg_);
+        packer.pack("back_spin_rpm");
+        packer.pack(back_spin_rpm_);
+        packer.pack("side_spin_rpm");
+        packer.pack(side_spin_rpm_);
+        packer.pack("spin_axis_deg");
+        packer.pack(GetSpinAxis());
+        packer.pack("club_type");
+        packer.pack((int)club_type_);
+        packer.pack("carry_m");
+        packer.pack(carry_m_);
+        packer.pack("total_m");
+        packer.pack(total_m_);
+        packer.pack("apex_m");
+        packer.pack(apex_m_);
+        packer.pack("descent_deg");
+        packer.pack(descent_deg_);
+        packer.pack("flight_time_s");
+        packer.pack(flight_time_s_);
+        packer.pack("is_keepalive");
+        packer.pack(result_message_is_keepalive_);
+        packer.pack("launch_monitor_ready");
+        packer.pack(heartbeat_launch_monitor_ready_);
+        packer.pack("ball_detected");
+        packer.pack(heartbeat_ball_detected_);
+
+        if (has_club_data_) {
+            packer.pack("club_speed_mph");
+            packer.pack(club_speed_mph_);
+            packer.pack("club_path_deg");
+            packer.pack(club_path_deg_);
+        }
+
+        if (has_exposures) {
+            packer.pack("exposures");
+            packer.pack_array((uint32_t)exposures_.size());
+
+            for (const GsResultsExposure& exposure : exposures_) {
+                packer.pack_map(6);
+                packer.pack("x_px");
+                packer.pack(exposure.x_px);
+                packer.pack("y_px");
+                packer.pack(exposure.y_px);
+                packer.pack("radius_px");
+                packer.pack(exposure.radius_px);
+                packer.pack("x_m");
+                packer.pack(exposure.x_m);
+                packer.pack("y_m");
+                packer.pack(exposure.y_m);
+                packer.pack("z_m");
+                packer.pack(exposure.z_m);
+            }
+        }
+
+        return std::string(buffer.data(), buffer.size());
+    }
+
+    std::string GsResults::MsgPackToJson(const std::string& msgpack_frame) {
+
+        try {
+            msgpack::object_handle handle = msgpack::unpack(msgpack_frame.data(), msgpack_frame.size());
+
+            // msgpack's stream output for maps, arrays, strings and numbers is JSON
+            std::ostringstream s;
+            s << handle.get();
+            return s.str();
+        }
+        catch (std::exception& ex) {
+            GS_LOG_MSG(error, "GsResults::MsgPackToJson could not unpack the frame. ERROR: *** " + std::string(ex.what()) + " ***");
+            return "";
+        }
+    }
+
 }
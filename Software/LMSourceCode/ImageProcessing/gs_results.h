@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <boost/property_tree/json_parser.hpp>
 
 #include "logging_tools.h"
@@ -18,11 +20,26 @@
 
 namespace golf_sim {
 
+    struct GsBallFlightResult;
+
+    // Optional per-exposure detail for data-logging consumers
+    struct GsResultsExposure {
+        float x_px = 0;
+        float y_px = 0;
+        float radius_px = 0;
+        // Distances from the camera, in meters
+        float x_m = 0;
+        float y_m = 0;
+        float z_m = 0;
+    };
+
     class GsResults {
 
     public:
         GsResults();
         GsResults(const GolfBall& ball);
+        // For a caller that already has the ball-flight estimate (or nullptr if there is none)
+        GsResults(const GolfBall& ball, const GsBallFlightResult* flight);
         virtual ~GsResults();
         virtual std::string Format() const;
 
@@ -33,6 +50,9 @@ namespace golf_sim {
         // to the right.
         float GetSpinAxis() const;
 
+        // Sets the carry, total, apex, descent and flight time
+        void SetFlight(const GsBallFlightResult& flight);
+
         // Deals with problem where Boost will put double-quotes around double values
         static std::string FormatDoubleAsString(const double value);
         
@@ -40,6 +60,15 @@ namespace golf_sim {
         // will remove extraneous quotes.
         static std::string GenerateStringFromJsonTree(const boost::property_tree::ptree& root);
 
+        // Encodes the results (including any exposures_) once into a compact MessagePack
+        // map with the same field names as the JSON view below.  The frame is what is
+        // published on the results socket.
+        std::string SerializeToMsgPack() const;
+
+        // A JSON rendering of a frame from SerializeToMsgPack(), e.g., for logging.  Much
+        // cheaper than building a property tree.
+        static std::string MsgPackToJson(const std::string& msgpack_frame);
+
 
     public:
         long shot_number_ = 0;
@@ -50,11 +79,28 @@ namespace golf_sim {
         int side_spin_rpm_ = 0;     // Negative is left (counter-clockwise from above ball)
         GolfSimClubs::GsClubType club_type_ = GolfSimClubs::GsClubType::kNotSelected;
 
+        // From the internal ball-flight model (see gs_ball_flight.h).  All 0 if there was
+        // no flight to estimate.
+        float carry_m_ = 0;
+        float total_m_ = 0;
+        float apex_m_ = 0;
+        float descent_deg_ = 0;
+        float flight_time_s_ = 0;
+
+        // From the club strike analysis, if there was one.  The path is the club head's
+        // direction across the camera 1 image, not relative to the target line.
+        bool has_club_data_ = false;
+        float club_speed_mph_ = 0;
+        float club_path_deg_ = 0;
+
         // Some systems need a keep-alive
         bool result_message_is_keepalive_ = false;
         bool heartbeat_launch_monitor_ready_ = true;
         bool heartbeat_ball_detected_ = false;
 
+        // Empty unless the caller has the exposure data at hand
+        std::vector<GsResultsExposure> exposures_;
+
     };
 
 }
@@ -0,0 +1,139 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+
+#include "gs_results_bus.h"
+
+namespace golf_sim {
+
+    bool GsResultsBus::kUseResultsBus = false;
+    int GsResultsBus::kResultsBusMaxQueuedResults = 8;
+
+    std::vector<std::unique_ptr<GsResultsBus::Subscriber>> GsResultsBus::subscribers_;
+    std::mutex GsResultsBus::subscribers_mutex_;
+
+
+    void GsResultsBus::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kUseResultsBus", kUseResultsBus);
+        GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kResultsBusMaxQueuedResults", kResultsBusMaxQueuedResults);
+    }
+
+    void GsResultsBus::Subscribe(const std::string& name, Consumer consumer) {
+
+        std::unique_ptr<Subscriber> subscriber = std::make_unique<Subscriber>();
+        subscriber->name = name;
+        subscriber->consumer = std::move(consumer);
+        subscriber->thread = std::thread(&GsResultsBus::Process, subscriber.get());
+
+        GS_LOG_TRACE_MSG(trace, "GsResultsBus - subscribed " + name);
+
+        std::lock_guard<std::mutex> lock(subscribers_mutex_);
+        subscribers_.push_back(std::move(subscriber));
+    }
+
+    bool GsResultsBus::IsRunning() {
+        std::lock_guard<std::mutex> lock(subscribers_mutex_);
+        return !subscribers_.empty();
+    }
+
+    void GsResultsBus::Publish(const GsResults& results) {
+
+        // The one copy, shared by every consumer
+        const QueuedResults queued_results{ std::make_shared<const GsResults>(results), std::chrono::steady_clock::now() };
+        const size_t max_queued = (size_t)std::max(1, kResultsBusMaxQueuedResults);
+
+        std::lock_guard<std::mutex> subscribers_lock(subscribers_mutex_);
+
+        for (const std::unique_ptr<Subscriber>& subscriber : subscribers_) {
+            {
+                std::lock_guard<std::mutex> lock(subscriber->mutex);
+
+                if (subscriber->queue.size() >= max_queued) {
+                    auto oldest_heartbeat = std::find_if(subscriber->queue.begin(), subscriber->queue.end(),
+                        [](const QueuedResults& q) { return q.results->result_message_is_keepalive_; });
+
+                    subscriber->queue.erase(oldest_heartbeat != subscriber->queue.end() ? oldest_heartbeat : subscriber->queue.begin());
+                    subscriber->dropped++;
+                    GsMetrics::Increment(GsMetrics::Counter::kDroppedBusResults);
+
+                    GS_LOG_MSG(warning, "GsResultsBus - " + subscriber->name + " is not keeping up.  Dropped a queued result.");
+                }
+
+                subscriber->queue.push_back(queued_results);
+            }
+
+            subscriber->queue_not_empty.notify_one();
+        }
+    }
+
+    void GsResultsBus::Process(Subscriber* subscriber) {
+
+        while (true) {
+            QueuedResults queued_results;
+
+            {
+                std::unique_lock<std::mutex> lock(subscriber->mutex);
+                subscriber->queue_not_empty.wait(lock, [subscriber] { return subscriber->exiting || !subscriber->queue.empty(); });
+
+                if (subscriber->queue.empty()) {
+                    // Exiting, and nothing left to deliver
+                    return;
+                }
+
+                queued_results = std::move(subscriber->queue.front());
+                subscriber->queue.pop_front();
+            }
+
+            try {
+                subscriber->consumer(*queued_results.results);
+            }
+            catch (std::exception& e) {
+                GS_LOG_MSG(error, "GsResultsBus - " + subscriber->name + " failed - Error was: " + std::string(e.what()));
+            }
+
+            const long latency_us = (long)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - queued_results.published_time).count();
+
+            std::lock_guard<std::mutex> lock(subscriber->mutex);
+            subscriber->delivered++;
+            subscriber->total_latency_us += latency_us;
+            subscriber->max_latency_us = std::max(subscriber->max_latency_us, latency_us);
+        }
+    }
+
+    void GsResultsBus::Stop() {
+
+        std::lock_guard<std::mutex> subscribers_lock(subscribers_mutex_);
+
+        for (const std::unique_ptr<Subscriber>& subscriber : subscribers_) {
+            {
+                std::lock_guard<std::mutex> lock(subscriber->mutex);
+                subscriber->exiting = true;
+            }
+            subscriber->queue_not_empty.notify_one();
+        }
+
+        for (const std::unique_ptr<Subscriber>& subscriber : subscribers_) {
+            if (subscriber->thread.joinable()) {
+                subscriber->thread.join();
+            }
+
+            const double average_latency_ms = (subscriber->delivered == 0) ? 0.0 :
+                (double)subscriber->total_latency_us / (double)subscriber->delivered / 1000.0;
+
+            GS_LOG_MSG(info, "GsResultsBus - " + subscriber->name + " delivered " + std::to_string(subscriber->delivered) +
+                ", dropped " + std::to_string(subscriber->dropped) + ", average latency " + std::to_string(average_latency_ms) +
+                "ms, maximum latency " + std::to_string(subscriber->max_latency_us / 1000.0) + "ms");
+        }
+
+        subscribers_.clear();
+    }
+
+}
@@ -0,0 +1,81 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Fans each shot result (and heartbeat) out to every consumer - the golf simulator
+// interfaces, the results socket, and anything added later.  The result is copied
+// once when published.  Each consumer then gets it from its own bounded queue on its
+// own thread, so a slow consumer (e.g., a simulator PC that has stopped reading) only
+// delays itself.  If a consumer's queue is full, its oldest result is dropped, and a
+// heartbeat is always dropped before a shot.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gs_results.h"
+
+namespace golf_sim {
+
+    class GsResultsBus {
+
+    public:
+        using Consumer = std::function<void(const GsResults&)>;
+
+        // If false (the default), GsSimInterface calls the consumers directly on the FSM thread
+        static bool kUseResultsBus;
+        static int kResultsBusMaxQueuedResults;
+
+        static void LoadConfigurationValues();
+
+        // Starts a thread for the consumer.  Must be called before the first Publish.
+        static void Subscribe(const std::string& name, Consumer consumer);
+
+        // Queues the results for every consumer.  Returns right away.
+        static void Publish(const GsResults& results);
+
+        static bool IsRunning();
+
+        // Delivers whatever is still queued, then stops every consumer thread and
+        // logs each consumer's counters
+        static void Stop();
+
+    private:
+        struct QueuedResults {
+            std::shared_ptr<const GsResults> results;
+            std::chrono::steady_clock::time_point published_time;
+        };
+
+        struct Subscriber {
+            std::string name;
+            Consumer consumer;
+
+            std::mutex mutex;
+            std::condition_variable queue_not_empty;
+            std::deque<QueuedResults> queue;
+            bool exiting = false;
+            std::thread thread;
+
+            // Guarded by mutex
+            long delivered = 0;
+            long dropped = 0;
+            long max_latency_us = 0;
+            long total_latency_us = 0;
+        };
+
+        static void Process(Subscriber* subscriber);
+
+        static std::vector<std::unique_ptr<Subscriber>> subscribers_;
+        static std::mutex subscribers_mutex_;
+    };
+
+}
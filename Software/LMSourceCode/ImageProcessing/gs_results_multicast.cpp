@@ -0,0 +1,255 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+
+#include "gs_results_multicast.h"
+
+namespace golf_sim {
+
+    std::string GsResultsMulticast::kResultsMulticastAddress = "";
+    int GsResultsMulticast::kResultsMulticastPort = 9212;
+    int GsResultsMulticast::kResultsMulticastTtl = 1;
+    std::string GsResultsMulticast::kResultsMulticastInterface = "";
+    int GsResultsMulticast::kResultsMulticastRetransmitFrames = 32;
+
+    // Limits how long Stop() may have to wait for the retransmit thread
+    static const int kRetransmitPollTimeoutMs = 500;
+
+    static const char kDatagramMagic[4] = { 'P', 'T', 'R', 'M' };
+    static const char kRetransmitRequestMagic[4] = { 'P', 'T', 'R', 'N' };
+    static const uint8_t kDatagramVersion = 1;
+    static const size_t kDatagramHeaderBytes = 16;
+    static const size_t kRetransmitRequestBytes = 12;
+
+    static const uint8_t kHeartbeatFlag = 0x01;
+    static const uint8_t kResentFlag = 0x02;
+
+    // The most that one UDP datagram can carry over IPv4
+    static const size_t kMaxDatagramBytes = 65507;
+
+    int GsResultsMulticast::socket_fd_ = -1;
+    struct sockaddr_in GsResultsMulticast::group_address_;
+    uint32_t GsResultsMulticast::session_ = 0;
+    uint32_t GsResultsMulticast::next_sequence_ = 1;
+    std::deque<GsResultsMulticast::SentDatagram> GsResultsMulticast::sent_datagrams_;
+    std::mutex GsResultsMulticast::mutex_;
+    std::thread GsResultsMulticast::retransmit_thread_;
+    std::atomic<bool> GsResultsMulticast::running_{ false };
+
+
+    static void PutUint32(std::string& buffer, size_t offset, uint32_t value) {
+        const uint32_t network_value = htonl(value);
+        memcpy(&buffer[offset], &network_value, sizeof(network_value));
+    }
+
+    static uint32_t GetUint32(const char* buffer) {
+        uint32_t network_value;
+        memcpy(&network_value, buffer, sizeof(network_value));
+        return ntohl(network_value);
+    }
+
+    bool GsResultsMulticast::Start() {
+
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kResultsMulticastAddress", kResultsMulticastAddress);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kResultsMulticastPort", kResultsMulticastPort);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kResultsMulticastTtl", kResultsMulticastTtl);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kResultsMulticastInterface", kResultsMulticastInterface);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kResultsMulticastRetransmitFrames", kResultsMulticastRetransmitFrames);
+
+        kResultsMulticastTtl = std::clamp(kResultsMulticastTtl, 1, 255);
+        kResultsMulticastRetransmitFrames = std::max(kResultsMulticastRetransmitFrames, 0);
+
+        if (kResultsMulticastAddress.empty()) {
+            GS_LOG_TRACE_MSG(trace, "GsResultsMulticast - no kResultsMulticastAddress, so not multicasting results.");
+            return true;
+        }
+
+        if (running_) {
+            return true;
+        }
+
+        struct in_addr group;
+        if (inet_pton(AF_INET, kResultsMulticastAddress.c_str(), &group) != 1 || !IN_MULTICAST(ntohl(group.s_addr))) {
+            GS_LOG_MSG(error, "GsResultsMulticast - kResultsMulticastAddress is not an IPv4 multicast address: " + kResultsMulticastAddress);
+            return false;
+        }
+
+        socket_fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (socket_fd_ < 0) {
+            GS_LOG_MSG(error, "GsResultsMulticast - could not create socket: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        const unsigned char ttl = (unsigned char)kResultsMulticastTtl;
+        // The Pi's own listeners (e.g., the web UI) hear the datagrams too
+        const unsigned char loop = 1;
+        bool configured = setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) == 0 &&
+                          setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) == 0;
+
+        if (configured && !kResultsMulticastInterface.empty()) {
+            struct in_addr interface_address;
+            configured = inet_pton(AF_INET, kResultsMulticastInterface.c_str(), &interface_address) == 1 &&
+                         setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_IF, &interface_address, sizeof(interface_address)) == 0;
+        }
+
+        // A fixed source port, for the listeners' retransmit requests to come back to
+        struct sockaddr_in local_address;
+        memset(&local_address, 0, sizeof(local_address));
+        local_address.sin_family = AF_INET;
+        local_address.sin_addr.s_addr = htonl(INADDR_ANY);
+        local_address.sin_port = 0;
+
+        if (!configured || bind(socket_fd_, (struct sockaddr*)&local_address, sizeof(local_address)) != 0) {
+            GS_LOG_MSG(error, "GsResultsMulticast - could not set up the socket for " + kResultsMulticastAddress + ": " + std::string(strerror(errno)));
+            close(socket_fd_);
+            socket_fd_ = -1;
+            return false;
+        }
+
+        // Not connected to the group, as the socket would then only hear from the group
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            memset(&group_address_, 0, sizeof(group_address_));
+            group_address_.sin_family = AF_INET;
+            group_address_.sin_addr = group;
+            group_address_.sin_port = htons((uint16_t)kResultsMulticastPort);
+            session_ = std::random_device{}();
+            next_sequence_ = 1;
+            sent_datagrams_.clear();
+        }
+
+        running_ = true;
+
+        if (kResultsMulticastRetransmitFrames > 0) {
+            retransmit_thread_ = std::thread(&GsResultsMulticast::HandleRetransmitRequests);
+        }
+
+        GS_LOG_MSG(info, "GsResultsMulticast - multicasting results to " + kResultsMulticastAddress + ":" + std::to_string(kResultsMulticastPort));
+
+        return true;
+    }
+
+    void GsResultsMulticast::Stop() {
+
+        if (!running_) {
+            return;
+        }
+
+        running_ = false;
+
+        if (retransmit_thread_.joinable()) {
+            retransmit_thread_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        close(socket_fd_);
+        socket_fd_ = -1;
+        sent_datagrams_.clear();
+    }
+
+    void GsResultsMulticast::Publish(const GsResults& results) {
+
+        if (!running_) {
+            return;
+        }
+
+        const std::string frame = results.SerializeToMsgPack();
+
+        if (kDatagramHeaderBytes + frame.size() > kMaxDatagramBytes) {
+            GS_LOG_MSG(warning, "GsResultsMulticast - a " + std::to_string(frame.size()) + "-byte result does not fit in a datagram.  Not sending it.");
+            return;
+        }
+
+        std::string datagram(kDatagramHeaderBytes, '\0');
+        memcpy(&datagram[0], kDatagramMagic, sizeof(kDatagramMagic));
+        datagram[4] = (char)kDatagramVersion;
+        datagram[5] = (char)(results.result_message_is_keepalive_ ? kHeartbeatFlag : 0);
+        datagram += frame;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const uint32_t sequence = next_sequence_++;
+        PutUint32(datagram, 8, session_);
+        PutUint32(datagram, 12, sequence);
+
+        // As with the results socket, the launch monitor never waits on the network
+        if (sendto(socket_fd_, datagram.data(), datagram.size(), MSG_DONTWAIT | MSG_NOSIGNAL,
+                   (struct sockaddr*)&group_address_, sizeof(group_address_)) < 0) {
+            GS_LOG_TRACE_MSG(trace, "GsResultsMulticast - could not send datagram " + std::to_string(sequence) + ": " + std::string(strerror(errno)));
+        }
+
+        if (kResultsMulticastRetransmitFrames > 0) {
+            sent_datagrams_.push_back(SentDatagram{ sequence, std::move(datagram) });
+
+            while ((int)sent_datagrams_.size() > kResultsMulticastRetransmitFrames) {
+                sent_datagrams_.pop_front();
+            }
+        }
+    }
+
+    void GsResultsMulticast::HandleRetransmitRequests() {
+
+        char request[kRetransmitRequestBytes + 1];
+
+        while (running_) {
+            struct pollfd poll_fd = { socket_fd_, POLLIN, 0 };
+
+            if (poll(&poll_fd, 1, kRetransmitPollTimeoutMs) <= 0 || !(poll_fd.revents & POLLIN)) {
+                continue;
+            }
+
+            struct sockaddr_in listener_address;
+            socklen_t address_length = sizeof(listener_address);
+
+            const ssize_t received = recvfrom(socket_fd_, request, sizeof(request), MSG_DONTWAIT,
+                                              (struct sockaddr*)&listener_address, &address_length);
+
+            if (received != (ssize_t)kRetransmitRequestBytes || memcmp(request, kRetransmitRequestMagic, sizeof(kRetransmitRequestMagic)) != 0) {
+                continue;
+            }
+
+            const uint32_t session = GetUint32(&request[4]);
+            const uint32_t sequence = GetUint32(&request[8]);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (session != session_) {
+                continue;
+            }
+
+            auto sent = std::find_if(sent_datagrams_.begin(), sent_datagrams_.end(),
+                                     [sequence](const SentDatagram& datagram) { return datagram.sequence == sequence; });
+
+            if (sent == sent_datagrams_.end()) {
+                GS_LOG_TRACE_MSG(trace, "GsResultsMulticast - datagram " + std::to_string(sequence) + " was asked for again, but is no longer kept.");
+                continue;
+            }
+
+            std::string datagram = sent->datagram;
+            datagram[5] = (char)(datagram[5] | kResentFlag);
+
+            sendto(socket_fd_, datagram.data(), datagram.size(), MSG_DONTWAIT | MSG_NOSIGNAL,
+                   (struct sockaddr*)&listener_address, address_length);
+        }
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Sends every shot result and heartbeat as one UDP multicast datagram, so that any number
+// of displays and apps on the bay's network can listen for results with a single send from
+// the Pi.  Each datagram is a 16-byte header followed by the same MessagePack frame as on the
+// results socket (see GsResults::SerializeToMsgPack):
+//
+//     bytes 0-3    "PTRM"
+//     byte  4      version (1)
+//     byte  5      flags: 0x01 heartbeat, 0x02 re-sent
+//     bytes 6-7    0
+//     bytes 8-11   session, chosen at random when the publisher starts (network order)
+//     bytes 12-15  sequence number, from 1 (network order)
+//
+// A gap in the sequence numbers of a session means lost datagrams.  If
+// kResultsMulticastRetransmitFrames is set, the last that many datagrams are kept, and a
+// listener can ask for one again by sending "PTRN" followed by the session and the
+// sequence number (each 4 bytes, network order) to the port that the datagrams came from.
+// The datagram is re-sent to the listener alone, with the re-sent flag set.
+// Off unless kResultsMulticastAddress is set.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <netinet/in.h>
+
+#include "gs_results.h"
+
+namespace golf_sim {
+
+    class GsResultsMulticast {
+
+    public:
+        // An empty address (the default) disables the multicast, e.g., "239.255.80.84"
+        static std::string kResultsMulticastAddress;
+        static int kResultsMulticastPort;
+        // 1 keeps the datagrams on the local network
+        static int kResultsMulticastTtl;
+        // The local address of the interface to send on.  Empty lets the routing table pick.
+        static std::string kResultsMulticastInterface;
+        // 0 means listeners cannot ask for a lost datagram again
+        static int kResultsMulticastRetransmitFrames;
+
+        // Reads the configuration and, if enabled, opens the socket
+        static bool Start();
+        static void Stop();
+
+        static void Publish(const GsResults& results);
+
+    private:
+        struct SentDatagram {
+            uint32_t sequence;
+            std::string datagram;
+        };
+
+        // Answers the listeners' requests for lost datagrams
+        static void HandleRetransmitRequests();
+
+        static int socket_fd_;
+        static struct sockaddr_in group_address_;
+        static uint32_t session_;
+        static uint32_t next_sequence_;
+        static std::deque<SentDatagram> sent_datagrams_;
+        static std::mutex mutex_;
+        static std::thread retransmit_thread_;
+        static std::atomic<bool> running_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,164 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+
+#include "gs_results_publisher.h"
+
+namespace golf_sim {
+
+    std::string GsResultsPublisher::kResultsSocketPath = "";
+
+    // Limits how long Stop() may have to wait for the accept thread
+    static const int kAcceptPollTimeoutMs = 500;
+
+    static const int kMaxClients = 8;
+
+    int GsResultsPublisher::listen_fd_ = -1;
+    std::vector<int> GsResultsPublisher::client_fds_;
+    std::mutex GsResultsPublisher::clients_mutex_;
+    std::thread GsResultsPublisher::accept_thread_;
+    std::atomic<bool> GsResultsPublisher::running_{ false };
+
+
+    bool GsResultsPublisher::Start() {
+
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kResultsSocketPath", kResultsSocketPath);
+
+        if (kResultsSocketPath.empty()) {
+            GS_LOG_TRACE_MSG(trace, "GsResultsPublisher - no kResultsSocketPath, so not publishing results.");
+            return true;
+        }
+
+        if (running_) {
+            return true;
+        }
+
+        struct sockaddr_un address;
+        if (kResultsSocketPath.size() >= sizeof(address.sun_path)) {
+            GS_LOG_MSG(error, "GsResultsPublisher - kResultsSocketPath is too long: " + kResultsSocketPath);
+            return false;
+        }
+
+        listen_fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            GS_LOG_MSG(error, "GsResultsPublisher - could not create socket: " + std::string(strerror(errno)));
+            return false;
+        }
+
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, kResultsSocketPath.c_str(), sizeof(address.sun_path) - 1);
+
+        // Remove any socket file left over from a prior run
+        unlink(kResultsSocketPath.c_str());
+
+        if (bind(listen_fd_, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+            listen(listen_fd_, kMaxClients) != 0) {
+            GS_LOG_MSG(error, "GsResultsPublisher - could not listen on " + kResultsSocketPath + ": " + std::string(strerror(errno)));
+            close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+
+        running_ = true;
+        accept_thread_ = std::thread(&GsResultsPublisher::AcceptConnections);
+
+        GS_LOG_MSG(info, "GsResultsPublisher - publishing results on " + kResultsSocketPath);
+
+        return true;
+    }
+
+    void GsResultsPublisher::Stop() {
+
+        if (!running_) {
+            return;
+        }
+
+        running_ = false;
+
+        if (accept_thread_.joinable()) {
+            accept_thread_.join();
+        }
+
+        close(listen_fd_);
+        listen_fd_ = -1;
+        unlink(kResultsSocketPath.c_str());
+
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        for (int fd : client_fds_) {
+            close(fd);
+        }
+        client_fds_.clear();
+    }
+
+    void GsResultsPublisher::AcceptConnections() {
+
+        while (running_) {
+            struct pollfd poll_fd = { listen_fd_, POLLIN, 0 };
+
+            if (poll(&poll_fd, 1, kAcceptPollTimeoutMs) <= 0 || !(poll_fd.revents & POLLIN)) {
+                continue;
+            }
+
+            int client_fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client_fd < 0) {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(clients_mutex_);
+
+            if ((int)client_fds_.size() >= kMaxClients) {
+                GS_LOG_MSG(warning, "GsResultsPublisher - too many consumers.  Refusing a new connection.");
+                close(client_fd);
+                continue;
+            }
+
+            GS_LOG_TRACE_MSG(trace, "GsResultsPublisher - consumer connected.");
+            client_fds_.push_back(client_fd);
+        }
+    }
+
+    void GsResultsPublisher::Publish(const GsResults& results) {
+
+        if (!running_) {
+            return;
+        }
+
+        // Encoded once, no matter how many consumers there are
+        const std::string frame = results.SerializeToMsgPack();
+
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+
+        for (auto it = client_fds_.begin(); it != client_fds_.end(); ) {
+            ssize_t sent = send(*it, frame.data(), frame.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+
+            if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                // Consumer went away
+                GS_LOG_TRACE_MSG(trace, "GsResultsPublisher - consumer disconnected.");
+                close(*it);
+                it = client_fds_.erase(it);
+                continue;
+            }
+
+            // If the consumer's buffer is full, it just misses this frame
+            ++it;
+        }
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Publishes every shot result and heartbeat as a MessagePack frame (see
+// GsResults::SerializeToMsgPack) on a local Unix-domain socket, for data-logging
+// and other local consumers.  The socket is SOCK_SEQPACKET, so each read returns
+// exactly one frame.  Consumers that cannot keep up simply miss frames - the
+// launch monitor never waits for them.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gs_results.h"
+
+namespace golf_sim {
+
+    class GsResultsPublisher {
+
+    public:
+        // An empty path (the default) disables the publisher
+        static std::string kResultsSocketPath;
+
+        // Reads the configuration and, if enabled, starts listening for consumers
+        static bool Start();
+        static void Stop();
+
+        static void Publish(const GsResults& results);
+
+    private:
+        static void AcceptConnections();
+
+        static int listen_fd_;
+        static std::vector<int> client_fds_;
+        static std::mutex clients_mutex_;
+        static std::thread accept_thread_;
+        static std::atomic<bool> running_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include "gs_scratch_pool.h"
+
+namespace golf_sim {
+
+    // True if only the pool refers to the buffer.  The count is read atomically because the
+    // last other reference may be dropped on a different thread.
+    static bool IsUnused(const cv::Mat& buffer) {
+        return buffer.u != nullptr && CV_XADD(&buffer.u->refcount, 0) == 1;
+    }
+
+
+    GsScratchPool& GsScratchPool::ForThisThread() {
+        static thread_local GsScratchPool pool;
+        return pool;
+    }
+
+    cv::Mat GsScratchPool::Get(int rows, int cols, int type) {
+
+        Bucket* bucket = nullptr;
+
+        for (Bucket& b : buckets_) {
+            if (b.rows == rows && b.cols == cols && b.type == type) {
+                bucket = &b;
+                break;
+            }
+        }
+
+        if (bucket == nullptr) {
+            buckets_.push_back(Bucket{ rows, cols, type, {} });
+            bucket = &buckets_.back();
+        }
+
+        for (const cv::Mat& buffer : bucket->buffers) {
+            if (IsUnused(buffer)) {
+                return buffer;
+            }
+        }
+
+        cv::Mat buffer(rows, cols, type);
+
+        if (number_of_buffers_ < kMaxPooledBuffers) {
+            bucket->buffers.push_back(buffer);
+            number_of_buffers_++;
+        }
+
+        return buffer;
+    }
+
+    cv::Mat GsScratchPool::Get(int rows, int cols, int type, const cv::Scalar& value) {
+        cv::Mat buffer = Get(rows, cols, type);
+        buffer.setTo(value);
+        return buffer;
+    }
+
+}
@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A per-thread pool of cv::Mat buffers for the temporaries of a shot's image processing
+// (the Gabor accumulations, the spin projections, the ball masks, ...), most of which
+// have the same few sizes from shot to shot.  Rather than being freed, a buffer goes back
+// to its thread's pool once the last cv::Mat that refers to it goes away, and the next
+// request for the same size and type gets it again.  That keeps the allocator (and the
+// page faults of fresh allocations) out of the per-shot latency.
+//
+// A buffer that is handed out on one thread may be used and released on another.
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    class GsScratchPool {
+
+    public:
+        // The most buffers that one thread's pool keeps.  Past that, Get() just allocates.
+        static constexpr size_t kMaxPooledBuffers = 512;
+
+        // The pool of the calling thread
+        static GsScratchPool& ForThisThread();
+
+        // A buffer of the given size and type.  The contents are whatever was there before.
+        cv::Mat Get(int rows, int cols, int type);
+        cv::Mat Get(const cv::Size& size, int type) { return Get(size.height, size.width, type); }
+
+        // Same, but set to the value
+        cv::Mat Get(int rows, int cols, int type, const cv::Scalar& value);
+
+    private:
+        struct Bucket {
+            int rows;
+            int cols;
+            int type;
+            std::vector<cv::Mat> buffers;
+        };
+
+        std::vector<Bucket> buckets_;
+        size_t number_of_buffers_ = 0;
+    };
+
+}
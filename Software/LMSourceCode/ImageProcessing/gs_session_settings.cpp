@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include "logging_tools.h"
+
+#include "gs_session_settings.h"
+
+namespace golf_sim {
+
+    // Bits 0-7 are the club, bits 8-15 the handedness and the rest the version.
+    // A handedness of kHandednessNotSet means that it has not been changed from the
+    // command-line option, which is then used.
+    static const uint64_t kFieldMask = 0xFF;
+    static const uint64_t kHandednessNotSet = 0xFF;
+    static const int kHandednessShift = 8;
+    static const int kVersionShift = 16;
+
+    // The current settings start at version 1, so that an armed_ of 0 means no shot has been armed yet
+    std::atomic<uint64_t> GsSessionSettings::current_{ (1ULL << kVersionShift) | (kHandednessNotSet << kHandednessShift) |
+                                                       (uint64_t)GolfSimClubs::GsClubType::kNotSelected };
+    std::atomic<uint64_t> GsSessionSettings::armed_{ 0 };
+
+
+    GsSessionSettings::Snapshot GsSessionSettings::Unpack(uint64_t packed) {
+        Snapshot settings;
+        settings.club_type = (GolfSimClubs::GsClubType)(packed & kFieldMask);
+
+        const uint64_t handedness = (packed >> kHandednessShift) & kFieldMask;
+        settings.golfer_orientation = (handedness == kHandednessNotSet) ? GolfSimOptions::GetCommandLineOptions().golfer_orientation_
+                                                                         : (GolferOrientation)handedness;
+        settings.version = packed >> kVersionShift;
+        return settings;
+    }
+
+    GsSessionSettings::Snapshot GsSessionSettings::Current() {
+        return Unpack(current_.load(std::memory_order_acquire));
+    }
+
+    void GsSessionSettings::SetClubType(GolfSimClubs::GsClubType club_type) {
+        uint64_t packed = current_.load(std::memory_order_relaxed);
+        uint64_t updated;
+
+        do {
+            updated = (((packed >> kVersionShift) + 1) << kVersionShift) | (packed & (kFieldMask << kHandednessShift)) |
+                      ((uint64_t)club_type & kFieldMask);
+        } while (!current_.compare_exchange_weak(packed, updated, std::memory_order_acq_rel, std::memory_order_relaxed));
+    }
+
+    void GsSessionSettings::SetGolferHandedness(GolferOrientation golfer_orientation) {
+        uint64_t packed = current_.load(std::memory_order_relaxed);
+        uint64_t updated;
+
+        do {
+            updated = (((packed >> kVersionShift) + 1) << kVersionShift) | (packed & kFieldMask) |
+                      (((uint64_t)golfer_orientation & kFieldMask) << kHandednessShift);
+        } while (!current_.compare_exchange_weak(packed, updated, std::memory_order_acq_rel, std::memory_order_relaxed));
+    }
+
+    GsSessionSettings::Snapshot GsSessionSettings::ArmShot() {
+        const uint64_t packed = current_.load(std::memory_order_acquire);
+        armed_.store(packed, std::memory_order_release);
+
+        Snapshot settings = Unpack(packed);
+
+        GS_LOG_TRACE_MSG(trace, "GsSessionSettings - armed shot with settings version " + std::to_string(settings.version) +
+                                ((settings.club_type == GolfSimClubs::GsClubType::kPutter) ? " (putter)." : "."));
+        return settings;
+    }
+
+    GsSessionSettings::Snapshot GsSessionSettings::ShotSettings() {
+        const uint64_t packed = armed_.load(std::memory_order_acquire);
+
+        if (packed == 0) {
+            return Current();
+        }
+
+        return Unpack(packed);
+    }
+
+}
@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// The settings that the player can change during a session - the club and the golfer's
+// handedness.  They are packed (with a version number that goes up on every change) into
+// one atomic word, so that a control message can change them right away, from any thread,
+// while a shot is being captured or analyzed.
+// When the system is armed for a shot, the current settings are also saved as that shot's
+// settings.  The camera 2 capture, the strobing and the analysis of the shot all read
+// those, so a change that arrives mid-shot only takes effect with the next shot.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "gs_clubs.h"
+#include "gs_options.h"
+
+namespace golf_sim {
+
+    class GsSessionSettings {
+
+    public:
+        struct Snapshot {
+            GolfSimClubs::GsClubType club_type = GolfSimClubs::GsClubType::kNotSelected;
+            GolferOrientation golfer_orientation = GolferOrientation::kRightHanded;
+            // Goes up by one with each change
+            uint64_t version = 0;
+        };
+
+        static Snapshot Current();
+
+        static void SetClubType(GolfSimClubs::GsClubType club_type);
+        static void SetGolferHandedness(GolferOrientation golfer_orientation);
+
+        // Saves the current settings as those of the shot being armed, and returns them
+        static Snapshot ArmShot();
+
+        // The settings of the last shot that was armed.  The current ones if no shot has
+        // been armed, e.g., when working on saved images.
+        static Snapshot ShotSettings();
+
+    private:
+        static Snapshot Unpack(uint64_t packed);
+
+        static std::atomic<uint64_t> current_;
+        static std::atomic<uint64_t> armed_;
+    };
+
+}
@@ -0,0 +1,264 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_sim_interface.h"
+
+#include "gs_shared_memory.h"
+
+namespace golf_sim {
+
+    std::string GsSharedMemory::kSharedMemoryName = "";
+    int GsSharedMemory::kSharedMemoryFrameSlots = 8;
+    int GsSharedMemory::kSharedMemoryFrameMaxWidth = 728;
+    int GsSharedMemory::kSharedMemoryFrameMaxHeight = 544;
+    int GsSharedMemory::kSharedMemoryResultSlots = 16;
+    int GsSharedMemory::kSharedMemoryMaxResultBytes = 4096;
+
+    // Keeps each slot (and each row of pixels in it) on its own cache lines
+    static const size_t kSlotAlignment = 64;
+
+    std::mutex GsSharedMemory::start_mutex_;
+    std::mutex GsSharedMemory::frames_mutex_;
+    std::mutex GsSharedMemory::results_mutex_;
+    pitrac_shm_header* GsSharedMemory::header_ = nullptr;
+    size_t GsSharedMemory::size_ = 0;
+
+
+    static size_t Aligned(size_t bytes) {
+        return (bytes + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+    }
+
+    static int64_t RealtimeNs() {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+    }
+
+    void GsSharedMemory::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kSharedMemoryName", kSharedMemoryName);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kSharedMemoryFrameSlots", kSharedMemoryFrameSlots);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kSharedMemoryFrameMaxWidth", kSharedMemoryFrameMaxWidth);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kSharedMemoryFrameMaxHeight", kSharedMemoryFrameMaxHeight);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kSharedMemoryResultSlots", kSharedMemoryResultSlots);
+        GolfSimConfiguration::SetConstant("gs_config.ipc_interface.kSharedMemoryMaxResultBytes", kSharedMemoryMaxResultBytes);
+
+        kSharedMemoryFrameSlots = std::max(kSharedMemoryFrameSlots, 1);
+        kSharedMemoryFrameMaxWidth = std::max(kSharedMemoryFrameMaxWidth, 16);
+        kSharedMemoryFrameMaxHeight = std::max(kSharedMemoryFrameMaxHeight, 16);
+        kSharedMemoryResultSlots = std::max(kSharedMemoryResultSlots, 1);
+        kSharedMemoryMaxResultBytes = std::max(kSharedMemoryMaxResultBytes, 256);
+    }
+
+    bool GsSharedMemory::Start() {
+
+        std::lock_guard<std::mutex> lock(start_mutex_);
+
+        if (kSharedMemoryName.empty()) {
+            GS_LOG_TRACE_MSG(trace, "GsSharedMemory - no kSharedMemoryName, so no shared memory.");
+            return true;
+        }
+
+        if (header_ != nullptr) {
+            return true;
+        }
+
+        const size_t frame_pixels_offset = Aligned(sizeof(pitrac_shm_frame));
+        const size_t frame_stride = Aligned((size_t)kSharedMemoryFrameMaxWidth * 3);
+        const size_t frame_slot_bytes = frame_pixels_offset + Aligned(frame_stride * kSharedMemoryFrameMaxHeight);
+        const size_t result_slot_bytes = Aligned(sizeof(pitrac_shm_result) + kSharedMemoryMaxResultBytes);
+
+        const size_t frames_offset = Aligned(sizeof(pitrac_shm_header));
+        const size_t results_offset = frames_offset + frame_slot_bytes * kSharedMemoryFrameSlots;
+        const size_t size = results_offset + result_slot_bytes * kSharedMemoryResultSlots;
+
+        // Any segment left over from an earlier run may have a different layout
+        shm_unlink(kSharedMemoryName.c_str());
+
+        const int fd = shm_open(kSharedMemoryName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            GS_LOG_MSG(error, "GsSharedMemory - could not create " + kSharedMemoryName + ": " + std::string(strerror(errno)));
+            return false;
+        }
+
+        void* memory = MAP_FAILED;
+        if (ftruncate(fd, (off_t)size) == 0) {
+            memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        const int map_error = errno;
+        close(fd);
+
+        if (memory == MAP_FAILED) {
+            GS_LOG_MSG(error, "GsSharedMemory - could not map " + std::to_string(size) + " bytes of " + kSharedMemoryName + ": " +
+                       std::string(strerror(map_error)));
+            shm_unlink(kSharedMemoryName.c_str());
+            return false;
+        }
+
+        // ftruncate zeroes the segment, so every slot starts out empty and unlocked
+        pitrac_shm_header* header = static_cast<pitrac_shm_header*>(memory);
+        header->version = PITRAC_SHM_VERSION;
+        header->size = size;
+        header->frame_slots = (uint32_t)kSharedMemoryFrameSlots;
+        header->frame_max_width = (uint32_t)kSharedMemoryFrameMaxWidth;
+        header->frame_max_height = (uint32_t)kSharedMemoryFrameMaxHeight;
+        header->result_slots = (uint32_t)kSharedMemoryResultSlots;
+        header->frames_offset = frames_offset;
+        header->frame_slot_bytes = frame_slot_bytes;
+        header->frame_pixels_offset = frame_pixels_offset;
+        header->results_offset = results_offset;
+        header->result_slot_bytes = result_slot_bytes;
+        __atomic_store_n(&header->magic, PITRAC_SHM_MAGIC, __ATOMIC_RELEASE);
+
+        {
+            std::lock_guard<std::mutex> frames_lock(frames_mutex_);
+            std::lock_guard<std::mutex> results_lock(results_mutex_);
+            header_ = header;
+            size_ = size;
+        }
+
+        GS_LOG_MSG(info, "GsSharedMemory - publishing frames and results in " + kSharedMemoryName + " (" +
+                   std::to_string(size / 1024) + " KB).");
+        return true;
+    }
+
+    void GsSharedMemory::Stop() {
+
+        std::lock_guard<std::mutex> lock(start_mutex_);
+        std::lock_guard<std::mutex> frames_lock(frames_mutex_);
+        std::lock_guard<std::mutex> results_lock(results_mutex_);
+
+        if (header_ == nullptr) {
+            return;
+        }
+
+        // Readers that still have the segment mapped keep their mapping
+        munmap(header_, size_);
+        shm_unlink(kSharedMemoryName.c_str());
+
+        header_ = nullptr;
+        size_ = 0;
+    }
+
+    bool GsSharedMemory::IsRunning() {
+        std::lock_guard<std::mutex> lock(frames_mutex_);
+        return header_ != nullptr;
+    }
+
+    pitrac_shm_frame* GsSharedMemory::FrameSlot(uint32_t slot) {
+        return reinterpret_cast<pitrac_shm_frame*>(reinterpret_cast<uint8_t*>(header_) + header_->frames_offset + slot * header_->frame_slot_bytes);
+    }
+
+    pitrac_shm_result* GsSharedMemory::ResultSlot(uint32_t slot) {
+        return reinterpret_cast<pitrac_shm_result*>(reinterpret_cast<uint8_t*>(header_) + header_->results_offset + slot * header_->result_slot_bytes);
+    }
+
+    void GsSharedMemory::PublishFrame(pitrac_shm_frame_kind kind, const std::string& name, const cv::Mat& img,
+                                      const std::vector<GsCircle>& circles) {
+
+        if (img.empty() || (img.type() != CV_8UC1 && img.type() != CV_8UC3)) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(frames_mutex_);
+
+        if (header_ == nullptr) {
+            return;
+        }
+
+        const double scale = std::min({ 1.0, (double)header_->frame_max_width / img.cols, (double)header_->frame_max_height / img.rows });
+        const cv::Size size(std::max(1, (int)(img.cols * scale)), std::max(1, (int)(img.rows * scale)));
+
+        const uint64_t frame_number = header_->latest_frame_number + 1;
+        pitrac_shm_frame* frame = FrameSlot((uint32_t)((frame_number - 1) % header_->frame_slots));
+
+        pitrac_shm_write_begin(&frame->sequence);
+
+        frame->kind = (uint32_t)kind;
+        frame->frame_number = frame_number;
+        frame->shot_number = (uint64_t)GsSimInterface::GetShotCounter();
+        frame->timestamp_ns = RealtimeNs();
+        frame->scale = (float)scale;
+        frame->width = (uint32_t)size.width;
+        frame->height = (uint32_t)size.height;
+        frame->channels = (uint32_t)img.channels();
+        frame->stride = (uint32_t)Aligned((size_t)header_->frame_max_width * 3);
+
+        frame->circle_count = (uint32_t)std::min(circles.size(), (size_t)PITRAC_SHM_MAX_CIRCLES);
+        for (uint32_t i = 0; i < frame->circle_count; i++) {
+            frame->circles[i] = { (float)(circles[i][0] * scale), (float)(circles[i][1] * scale), (float)(circles[i][2] * scale), (int32_t)i };
+        }
+
+        const size_t name_length = std::min(name.size(), (size_t)PITRAC_SHM_MAX_NAME - 1);
+        memcpy(frame->name, name.data(), name_length);
+        frame->name[name_length] = '\0';
+
+        // Straight into the slot, so that this is the only pass over the pixels
+        cv::Mat pixels(size, img.type(), reinterpret_cast<uint8_t*>(frame) + header_->frame_pixels_offset, frame->stride);
+        if (size == img.size()) {
+            img.copyTo(pixels);
+        }
+        else {
+            cv::resize(img, pixels, size, 0, 0, cv::INTER_AREA);
+        }
+
+        pitrac_shm_write_end(&frame->sequence);
+
+        __atomic_store_n(&header_->latest_frame_number, frame_number, __ATOMIC_RELEASE);
+    }
+
+    void GsSharedMemory::PublishResults(const GsResults& results) {
+
+        // The heartbeats would soon push the shots out of the ring
+        if (results.result_message_is_keepalive_ || !IsRunning()) {
+            return;
+        }
+
+        const std::string message = results.SerializeToMsgPack();
+
+        std::lock_guard<std::mutex> lock(results_mutex_);
+
+        if (header_ == nullptr) {
+            return;
+        }
+
+        if (message.size() > header_->result_slot_bytes - sizeof(pitrac_shm_result)) {
+            GS_LOG_MSG(warning, "GsSharedMemory - a " + std::to_string(message.size()) + "-byte result is larger than kSharedMemoryMaxResultBytes.  Not publishing it.");
+            return;
+        }
+
+        const uint64_t result_number = header_->latest_result_number + 1;
+        pitrac_shm_result* result = ResultSlot((uint32_t)((result_number - 1) % header_->result_slots));
+
+        pitrac_shm_write_begin(&result->sequence);
+
+        result->length = (uint32_t)message.size();
+        result->result_number = result_number;
+        result->shot_number = (uint64_t)results.shot_number_;
+        result->timestamp_ns = RealtimeNs();
+        memcpy(result + 1, message.data(), message.size());
+
+        pitrac_shm_write_end(&result->sequence);
+
+        __atomic_store_n(&header_->latest_result_number, result_number, __ATOMIC_RELEASE);
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Keeps the latest frames (the teed ball, the strobed balls and the web UI's images) and shot
+// results in a POSIX shared-memory segment, so that local consumers such as dashboards and
+// analyzers can read them in place - no image encoding, no files and no HTTP.  The layout is
+// in pitrac_shm.h, which is all that a reader needs.
+// Each frame is scaled down (if need be) into its ring slot in one pass, and each result is
+// the same MessagePack frame as on the results socket.  The web UI's ball outlines are passed
+// along as circles rather than drawn.  Readers never hold anything up: each slot has a sequence
+// lock, and a reader that was overtaken by the writer just reads the slot again.
+// Off unless kSharedMemoryName (e.g., "/pitrac_lm") is set.  The segment is removed at shutdown.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "gs_globals.h"
+#include "gs_results.h"
+#include "pitrac_shm.h"
+
+namespace golf_sim {
+
+    class GsSharedMemory {
+
+    public:
+        // Empty (the default) means no shared memory
+        static std::string kSharedMemoryName;
+        static int kSharedMemoryFrameSlots;
+        // Larger frames are scaled down to fit
+        static int kSharedMemoryFrameMaxWidth;
+        static int kSharedMemoryFrameMaxHeight;
+        static int kSharedMemoryResultSlots;
+        // Larger results are not published
+        static int kSharedMemoryMaxResultBytes;
+
+        static void LoadConfigurationValues();
+
+        // Creates the segment.  Does nothing if kSharedMemoryName is empty.
+        static bool Start();
+        static void Stop();
+
+        static bool IsRunning();
+
+        // Only 8-bit gray or BGR frames are published.  The circles are in img's pixels.
+        static void PublishFrame(pitrac_shm_frame_kind kind, const std::string& name, const cv::Mat& img,
+                                 const std::vector<GsCircle>& circles = {});
+
+        static void PublishResults(const GsResults& results);
+
+    private:
+        static pitrac_shm_frame* FrameSlot(uint32_t slot);
+        static pitrac_shm_result* ResultSlot(uint32_t slot);
+
+        static std::mutex start_mutex_;
+        // Each ring has only one writer at a time
+        static std::mutex frames_mutex_;
+        static std::mutex results_mutex_;
+
+        static pitrac_shm_header* header_;
+        static size_t size_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
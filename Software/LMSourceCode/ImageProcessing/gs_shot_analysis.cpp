@@ -0,0 +1,146 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include "logging_tools.h"
+#include "gs_camera.h"
+
+#include "gs_shot_analysis.h"
+#include "gs_session_settings.h"
+
+namespace golf_sim {
+
+    // The context of the shot that this thread is analyzing, if any
+    static thread_local GsAnalysisContext* active_context = nullptr;
+
+
+    GsAnalysisContext::Scope::Scope(GsAnalysisContext* context) {
+        prior_context_ = active_context;
+        active_context = context;
+    }
+
+    GsAnalysisContext::Scope::~Scope() {
+        active_context = prior_context_;
+    }
+
+    GsAnalysisContext* GsAnalysisContext::Active() {
+        return active_context;
+    }
+
+    GsAnalysisContext GsAnalysisContext::FromCurrentSettings() {
+        const GolfSimOptions& options = GolfSimOptions::GetCommandLineOptions();
+
+        GsAnalysisContext context;
+
+        context.camera1_model = GolfSimCamera::kSystemSlot1CameraType;
+        context.camera1_lens_type = GolfSimCamera::kSystemSlot1LensType;
+        context.camera1_orientation = GolfSimCamera::kSystemSlot1CameraOrientation;
+        context.camera2_model = GolfSimCamera::kSystemSlot2CameraType;
+        context.camera2_lens_type = GolfSimCamera::kSystemSlot2LensType;
+        context.camera2_orientation = GolfSimCamera::kSystemSlot2CameraOrientation;
+
+        context.resolution_x = CameraHardware::resolution_x_override_;
+        context.resolution_y = CameraHardware::resolution_y_override_;
+
+        context.teed_ball_search_center = cv::Vec2i((int)options.search_center_x_, (int)options.search_center_y_);
+
+        // The settings the shot was armed with, in case they have been changed since
+        const GsSessionSettings::Snapshot shot_settings = GsSessionSettings::ShotSettings();
+        context.club_type = shot_settings.club_type;
+        context.golfer_orientation = shot_settings.golfer_orientation;
+        context.practice_ball = options.practice_ball_;
+        context.lm_comparison_mode = options.lm_comparison_mode_;
+
+        context.strobed_frame_timing = GolfSimCamera::GetLastStrobedFrameTiming();
+
+        return context;
+    }
+
+    GolfSimClubs::GsClubType GsAnalysisContext::ClubType() {
+        return (active_context != nullptr) ? active_context->club_type : GsSessionSettings::ShotSettings().club_type;
+    }
+
+    GolferOrientation GsAnalysisContext::GolferHandedness() {
+        return (active_context != nullptr) ? active_context->golfer_orientation : GsSessionSettings::Current().golfer_orientation;
+    }
+
+    void GsAnalysisContext::SetGolferHandedness(GolferOrientation golfer_orientation) {
+        if (active_context != nullptr) {
+            active_context->golfer_orientation = golfer_orientation;
+        }
+        else {
+            GsSessionSettings::SetGolferHandedness(golfer_orientation);
+        }
+    }
+
+    bool GsAnalysisContext::PracticeBall() {
+        return (active_context != nullptr) ? active_context->practice_ball : GolfSimOptions::GetCommandLineOptions().practice_ball_;
+    }
+
+    bool GsAnalysisContext::LmComparisonMode() {
+        return (active_context != nullptr) ? active_context->lm_comparison_mode : GolfSimOptions::GetCommandLineOptions().lm_comparison_mode_;
+    }
+
+    GsStrobedFrameTiming GsAnalysisContext::StrobedFrameTiming() {
+        return (active_context != nullptr) ? active_context->strobed_frame_timing : GolfSimCamera::GetLastStrobedFrameTiming();
+    }
+
+    void GsAnalysisContext::SetErrorRootCause(const std::string& root_cause) {
+        if (active_context != nullptr) {
+            active_context->error_root_cause = root_cause;
+        }
+        else {
+            LoggingTools::SetErrorRootCause(root_cause);
+        }
+    }
+
+
+    bool GsShotAnalysis::AnalyzeShot(const cv::Mat& teed_ball_img,
+                                     const cv::Mat& strobed_balls_img,
+                                     const GsAnalysisContext& context,
+                                     GsResults& results) {
+
+        if (teed_ball_img.empty() || strobed_balls_img.empty()) {
+            GS_LOG_MSG(error, "GsShotAnalysis::AnalyzeShot - received an empty image.");
+            return false;
+        }
+
+        // The analysis writes the handedness it finds back into the context, and the
+        // caller's context may be shared by other threads
+        GsAnalysisContext shot_context = context;
+
+        GolfBall result_ball;
+        cv::Vec3d rotation_results;
+        cv::Mat exposures_image;
+        std::vector<GolfBall> exposure_balls;
+
+        if (!GolfSimCamera::ProcessReceivedCam2Image(teed_ball_img,
+                                                     strobed_balls_img,
+                                                     cv::Mat(),
+                                                     shot_context,
+                                                     result_ball,
+                                                     rotation_results,
+                                                     exposures_image,
+                                                     exposure_balls)) {
+            GS_LOG_MSG(warning, "GsShotAnalysis::AnalyzeShot - could not analyze the shot.");
+            return false;
+        }
+
+        results = GsResults(result_ball);
+        results.club_type_ = shot_context.club_type;
+
+        for (const GolfBall& exposure_ball : exposure_balls) {
+            results.exposures_.push_back(GsResultsExposure{
+                (float)exposure_ball.ball_circle_[0],
+                (float)exposure_ball.ball_circle_[1],
+                (float)exposure_ball.ball_circle_[2],
+                (float)exposure_ball.distances_ortho_camera_perspective_[0],
+                (float)exposure_ball.distances_ortho_camera_perspective_[1],
+                (float)exposure_ball.distances_ortho_camera_perspective_[2] });
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A reentrant entry point to the shot analysis, for processing recorded shots (e.g.,
+// a whole shot archive) on as many threads as the machine has.
+//
+// Everything about the shot that used to come from the command-line options, the
+// current club or the system-slot camera settings is in a GsAnalysisContext.  While
+// a shot is being analyzed, its context is the Active() one on each thread that works
+// on it, and the analysis code reads those values through the helpers below.  Outside
+// of a shot (or if a caller does not set up a context), the helpers fall back to the
+// process-wide settings, as before.
+// The tuning values in golf_sim_config.json are shared, read-only state.
+
+#pragma once
+
+#include <string>
+
+#include <opencv2/core.hpp>
+
+#include "camera_hardware.h"
+#include "gs_clubs.h"
+#include "gs_options.h"
+#include "gs_results.h"
+#include "gs_shot_ball_context.h"
+
+namespace golf_sim {
+
+    // When camera 2's strobed frame was exposed, and when the strobe pulses that it caught were
+    // sent.  All times are CLOCK_BOOTTIME (the clock of libcamera's SensorTimestamp), so the two
+    // can be compared directly.
+    struct GsStrobedFrameTiming {
+        bool valid = false;
+        // Start of the strobed frame's exposure, and how long it was
+        int64_t sensor_timestamp_ns = 0;
+        int64_t exposure_time_us = 0;
+        // The first strobe pulse goes out at the start of the SPI write
+        int64_t strobe_write_start_ns = 0;
+        int64_t strobe_write_end_ns = 0;
+    };
+
+    struct GsAnalysisContext {
+
+        CameraHardware::CameraModel camera1_model = CameraHardware::CameraModel::PiGS;
+        CameraHardware::LensType camera1_lens_type = CameraHardware::LensType::Lens_6mm;
+        CameraHardware::CameraOrientation camera1_orientation = CameraHardware::CameraOrientation::kUpsideUp;
+        CameraHardware::CameraModel camera2_model = CameraHardware::CameraModel::PiGS;
+        CameraHardware::LensType camera2_lens_type = CameraHardware::LensType::Lens_6mm;
+        CameraHardware::CameraOrientation camera2_orientation = CameraHardware::CameraOrientation::kUpsideUp;
+
+        // The resolution the images were taken at.  <= 0 means the camera model's own.
+        int resolution_x = -1;
+        int resolution_y = -1;
+
+        // Where to look for the teed ball.  (0, 0) means the middle of a full-size image.
+        cv::Vec2i teed_ball_search_center = cv::Vec2i(0, 0);
+
+        GolfSimClubs::GsClubType club_type = GolfSimClubs::GsClubType::kNotSelected;
+        // The analysis replaces this with the handedness that it sees in the shot
+        GolferOrientation golfer_orientation = GolferOrientation::kRightHanded;
+        bool practice_ball = false;
+        bool lm_comparison_mode = false;
+
+        // Only for shots happening live.  Sends the speed and launch angles to the UI
+        // before the spin is done if kStagedResultDelivery is set.
+        bool send_staged_results = false;
+        // Only for shots happening live.  Skips the spin if the prior shot's spin
+        // analysis is still running, rather than piling up work.
+        bool skip_spin_if_busy = false;
+        // Only for shots happening live.  Lets the strobe-pattern search skip the patterns
+        // that the measured timing rules out.
+        GsStrobedFrameTiming strobed_frame_timing;
+        // Only for shots happening live.  The teed ball as the FSM found it when it was placed.
+        // If it can be re-used (see GsShotBallContext::CanReuseBallFor), the teed-ball image is
+        // not searched again.
+        GsShotBallContextPtr teed_ball_context;
+
+        // Set by the analysis if it fails (or cannot find the spin), for the UI
+        std::string error_root_cause;
+
+        // A context for a live shot, from the command-line options, the current club
+        // and the system-slot camera settings
+        static GsAnalysisContext FromCurrentSettings();
+
+        // The context of the shot that this thread is working on, or nullptr
+        static GsAnalysisContext* Active();
+
+        // Makes a context the Active() one on this thread for as long as the Scope exists
+        class Scope {
+        public:
+            explicit Scope(GsAnalysisContext* context);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            GsAnalysisContext* prior_context_;
+        };
+
+        // The Active() context's values, or the process-wide ones if there is none
+        static GolfSimClubs::GsClubType ClubType();
+        static GolferOrientation GolferHandedness();
+        static void SetGolferHandedness(GolferOrientation golfer_orientation);
+        static bool PracticeBall();
+        static bool LmComparisonMode();
+        // Invalid if there is an Active() context without any timing, e.g., for a recorded shot
+        static GsStrobedFrameTiming StrobedFrameTiming();
+        // Sets the Active() context's error_root_cause, or else LoggingTools' process-wide one
+        static void SetErrorRootCause(const std::string& root_cause);
+    };
+
+
+    class GsShotAnalysis {
+
+    public:
+        // Analyzes one shot from the teed-ball (camera 1) and strobed-ball (camera 2) images.
+        // Safe to call from several threads at once.  Returns false if no shot could be found.
+        static bool AnalyzeShot(const cv::Mat& teed_ball_img,
+                                const cv::Mat& strobed_balls_img,
+                                const GsAnalysisContext& context,
+                                GsResults& results);
+    };
+
+}
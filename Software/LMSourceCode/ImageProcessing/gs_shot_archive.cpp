@@ -0,0 +1,573 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "logging_tools.h"
+
+#include "gs_shot_archive.h"
+
+namespace golf_sim {
+
+    static const char kFileMagic[8] = { 'P', 'T', 'S', 'H', 'O', 'T', 'A', 'R' };
+    static const char kTrailerMagic[8] = { 'P', 'T', 'S', 'A', 'I', 'D', 'X', '1' };
+    static const uint32_t kFileVersion = 1;
+    static const uint32_t kRecordMagic = 0x43455253;  // "SREC"
+    static const uint32_t kIndexMagic = 0x58444953;   // "SIDX"
+
+    static const size_t kFileHeaderSize = GsShotArchive::kAlignment;
+    static const size_t kRecordHeaderSize = 16;
+    static const size_t kTrailerSize = 16;
+
+    // The frame payload ends with the file offset of its pixels, which is only known once the
+    // record's place in the file is known
+    static const size_t kPixelOffsetSize = sizeof(uint64_t);
+
+
+    static uint64_t AlignUp(uint64_t offset) {
+        return (offset + GsShotArchive::kAlignment - 1) & ~(uint64_t)(GsShotArchive::kAlignment - 1);
+    }
+
+    template <typename T>
+    static void Put(std::string& buffer, const T value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    static void PutString(std::string& buffer, const std::string& value) {
+        Put<uint32_t>(buffer, (uint32_t)value.size());
+        buffer.append(value);
+    }
+
+    // Bounds-checked reading of a little-endian (i.e., native, on the Pi) record
+    class RecordCursor {
+
+    public:
+        RecordCursor(const uint8_t* begin, const uint8_t* end) : position_(begin), end_(end) {}
+
+        template <typename T>
+        T Get() {
+            T value{};
+            if (!ok_ || (size_t)(end_ - position_) < sizeof(T)) {
+                ok_ = false;
+                return value;
+            }
+            memcpy(&value, position_, sizeof(T));
+            position_ += sizeof(T);
+            return value;
+        }
+
+        std::string GetString() {
+            const uint32_t length = Get<uint32_t>();
+            if (!ok_ || (size_t)(end_ - position_) < length) {
+                ok_ = false;
+                return std::string();
+            }
+            std::string value(reinterpret_cast<const char*>(position_), length);
+            position_ += length;
+            return value;
+        }
+
+        bool ok() const { return ok_; }
+
+    private:
+        const uint8_t* position_;
+        const uint8_t* end_;
+        bool ok_ = true;
+    };
+
+    static void PutResults(std::string& buffer, const GsResults& results) {
+        Put<int64_t>(buffer, results.shot_number_);
+        Put<float>(buffer, results.speed_mph_);
+        Put<float>(buffer, results.hla_deg_);
+        Put<float>(buffer, results.vla_deg_);
+        Put<int32_t>(buffer, results.back_spin_rpm_);
+        Put<int32_t>(buffer, results.side_spin_rpm_);
+        Put<int32_t>(buffer, (int32_t)results.club_type_);
+        Put<float>(buffer, results.carry_m_);
+        Put<float>(buffer, results.total_m_);
+        Put<float>(buffer, results.apex_m_);
+        Put<float>(buffer, results.descent_deg_);
+        Put<float>(buffer, results.flight_time_s_);
+    }
+
+    static void GetResults(RecordCursor& cursor, GsResults& results) {
+        results.shot_number_ = (long)cursor.Get<int64_t>();
+        results.speed_mph_ = cursor.Get<float>();
+        results.hla_deg_ = cursor.Get<float>();
+        results.vla_deg_ = cursor.Get<float>();
+        results.back_spin_rpm_ = cursor.Get<int32_t>();
+        results.side_spin_rpm_ = cursor.Get<int32_t>();
+        results.club_type_ = (GolfSimClubs::GsClubType)cursor.Get<int32_t>();
+        results.carry_m_ = cursor.Get<float>();
+        results.total_m_ = cursor.Get<float>();
+        results.apex_m_ = cursor.Get<float>();
+        results.descent_deg_ = cursor.Get<float>();
+        results.flight_time_s_ = cursor.Get<float>();
+    }
+
+
+    GsShotArchiveWriter::~GsShotArchiveWriter() {
+        Close();
+    }
+
+    bool GsShotArchiveWriter::Open(const std::string& file_name) {
+
+        Close();
+
+        file_name_ = file_name;
+        index_.clear();
+        frame_index_.clear();
+
+        std::error_code error;
+        const bool exists = std::filesystem::exists(file_name, error);
+
+        if (!exists) {
+            file_.open(file_name, std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!file_) {
+                GS_LOG_MSG(error, "GsShotArchiveWriter - could not create " + file_name);
+                return false;
+            }
+
+            std::string header(kFileMagic, sizeof(kFileMagic));
+            Put<uint32_t>(header, kFileVersion);
+            header.resize(kFileHeaderSize, '\0');
+            file_.write(header.data(), header.size());
+            end_offset_ = kFileHeaderSize;
+
+            return file_.good();
+        }
+
+        // Find the end of the last whole record.  Anything after it (the old index, or part of a
+        // record that was being written when the writer died) is dropped.
+        {
+            GsShotArchiveReader reader;
+            if (!reader.Open(file_name)) {
+                GS_LOG_MSG(error, "GsShotArchiveWriter - " + file_name + " is not a shot archive.");
+                return false;
+            }
+        }
+
+        std::ifstream existing_file(file_name, std::ios::binary);
+        const uint64_t file_size = std::filesystem::file_size(file_name, error);
+        uint64_t offset = kFileHeaderSize;
+
+        while (offset + kRecordHeaderSize + sizeof(uint32_t) <= file_size) {
+            uint8_t record_header[kRecordHeaderSize + sizeof(uint32_t)];
+            existing_file.seekg(offset);
+            existing_file.read(reinterpret_cast<char*>(record_header), sizeof(record_header));
+
+            RecordCursor cursor(record_header, record_header + sizeof(record_header));
+            const uint32_t magic = cursor.Get<uint32_t>();
+            const GsShotArchive::RecordType type = (GsShotArchive::RecordType)cursor.Get<uint32_t>();
+            const uint64_t payload_size = cursor.Get<uint64_t>();
+            const uint32_t name_length = cursor.Get<uint32_t>();
+
+            if (!existing_file || magic != kRecordMagic || offset + kRecordHeaderSize + payload_size > file_size ||
+                name_length > payload_size) {
+                break;
+            }
+
+            std::string name(name_length, '\0');
+            existing_file.read(name.data(), name_length);
+
+            if (type == GsShotArchive::RecordType::kFrame) {
+                frame_index_[name] = index_.size();
+            }
+            index_.push_back(GsShotArchive::IndexEntry{ type, offset, name });
+
+            offset = AlignUp(offset + kRecordHeaderSize + payload_size);
+        }
+
+        existing_file.close();
+
+        end_offset_ = std::min(offset, file_size);
+        std::filesystem::resize_file(file_name, end_offset_, error);
+        if (error) {
+            GS_LOG_MSG(error, "GsShotArchiveWriter - could not truncate " + file_name + ": " + error.message());
+            return false;
+        }
+
+        file_.open(file_name, std::ios::binary | std::ios::in | std::ios::out);
+        file_.seekp(end_offset_);
+
+        GS_LOG_TRACE_MSG(trace, "GsShotArchiveWriter - appending to " + file_name + " after " + std::to_string(index_.size()) + " records.");
+
+        return file_.good();
+    }
+
+    bool GsShotArchiveWriter::HasFrame(const std::string& name) const {
+        return frame_index_.count(name) > 0;
+    }
+
+    bool GsShotArchiveWriter::AddFrame(const std::string& name, const cv::Mat& img) {
+
+        if (HasFrame(name)) {
+            GS_LOG_MSG(warning, "GsShotArchiveWriter - the archive already has a frame named " + name);
+            return false;
+        }
+
+        std::string payload;
+        Put<int32_t>(payload, img.rows);
+        Put<int32_t>(payload, img.cols);
+        Put<int32_t>(payload, img.type());
+        Put<uint64_t>(payload, (uint64_t)img.cols * img.elemSize());
+        Put<uint64_t>(payload, 0);
+
+        if (!AppendRecord(GsShotArchive::RecordType::kFrame, name, payload, &img)) {
+            return false;
+        }
+
+        frame_index_[name] = index_.size() - 1;
+
+        return true;
+    }
+
+    bool GsShotArchiveWriter::AddShot(const GsArchivedShot& shot) {
+
+        std::string payload;
+        PutString(payload, shot.teed_ball_frame_name);
+        PutString(payload, shot.strobed_balls_frame_name);
+        Put<int32_t>(payload, shot.camera1_model);
+        Put<int32_t>(payload, shot.camera1_lens_type);
+        Put<int32_t>(payload, shot.camera2_model);
+        Put<int32_t>(payload, shot.camera2_lens_type);
+        Put<uint64_t>(payload, shot.config_hash);
+        PutResults(payload, shot.results);
+
+        return AppendRecord(GsShotArchive::RecordType::kShot, shot.name, payload);
+    }
+
+    bool GsShotArchiveWriter::AppendRecord(GsShotArchive::RecordType type, const std::string& name, const std::string& payload,
+                                           const cv::Mat* pixels) {
+
+        if (!file_.is_open()) {
+            GS_LOG_MSG(error, "GsShotArchiveWriter - the archive is not open.");
+            return false;
+        }
+
+        const uint64_t record_offset = end_offset_;
+
+        std::string body;
+        PutString(body, name);
+        body += payload;
+
+        uint64_t payload_size = body.size();
+        uint64_t pixel_offset = 0;
+        const size_t row_bytes = (pixels != nullptr) ? pixels->cols * pixels->elemSize() : 0;
+
+        if (pixels != nullptr) {
+            pixel_offset = AlignUp(record_offset + kRecordHeaderSize + body.size());
+            payload_size = (pixel_offset - record_offset - kRecordHeaderSize) + (uint64_t)row_bytes * pixels->rows;
+            memcpy(body.data() + body.size() - kPixelOffsetSize, &pixel_offset, kPixelOffsetSize);
+        }
+
+        std::string header;
+        Put<uint32_t>(header, kRecordMagic);
+        Put<uint32_t>(header, (uint32_t)type);
+        Put<uint64_t>(header, payload_size);
+
+        file_.write(header.data(), header.size());
+        file_.write(body.data(), body.size());
+
+        if (pixels != nullptr) {
+            const std::string padding(pixel_offset - (record_offset + kRecordHeaderSize + body.size()), '\0');
+            file_.write(padding.data(), padding.size());
+
+            for (int row = 0; row < pixels->rows; row++) {
+                file_.write(reinterpret_cast<const char*>(pixels->ptr(row)), row_bytes);
+            }
+        }
+
+        const uint64_t record_end = record_offset + kRecordHeaderSize + payload_size;
+        end_offset_ = AlignUp(record_end);
+
+        const std::string padding(end_offset_ - record_end, '\0');
+        file_.write(padding.data(), padding.size());
+
+        if (!file_) {
+            GS_LOG_MSG(error, "GsShotArchiveWriter - could not write to " + file_name_);
+            return false;
+        }
+
+        index_.push_back(GsShotArchive::IndexEntry{ type, record_offset, name });
+
+        return true;
+    }
+
+    bool GsShotArchiveWriter::Close() {
+
+        if (!file_.is_open()) {
+            return true;
+        }
+
+        std::string index;
+        Put<uint32_t>(index, kIndexMagic);
+        Put<uint64_t>(index, index_.size());
+
+        for (const GsShotArchive::IndexEntry& entry : index_) {
+            Put<uint32_t>(index, (uint32_t)entry.type);
+            Put<uint64_t>(index, entry.offset);
+            PutString(index, entry.name);
+        }
+
+        Put<uint64_t>(index, end_offset_);
+        index.append(kTrailerMagic, sizeof(kTrailerMagic));
+
+        file_.write(index.data(), index.size());
+        file_.close();
+
+        const bool success = !file_.fail();
+
+        if (!success) {
+            GS_LOG_MSG(error, "GsShotArchiveWriter - could not write the index of " + file_name_);
+        }
+
+        return success;
+    }
+
+
+    GsShotArchiveReader::~GsShotArchiveReader() {
+        Close();
+    }
+
+    bool GsShotArchiveReader::Open(const std::string& file_name) {
+
+        Close();
+
+#ifdef __unix__
+        const int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) {
+            GS_LOG_MSG(error, "GsShotArchiveReader - could not open " + file_name);
+            return false;
+        }
+
+        struct stat file_stat = {};
+        if (fstat(fd, &file_stat) != 0 || (size_t)file_stat.st_size < kFileHeaderSize) {
+            close(fd);
+            GS_LOG_MSG(error, "GsShotArchiveReader - " + file_name + " is too small to be a shot archive.");
+            return false;
+        }
+
+        size_ = (size_t)file_stat.st_size;
+
+        // Private and writable, so that changes to a frame are copy-on-write rather than a crash
+        void* mapping = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (mapping == MAP_FAILED) {
+            GS_LOG_MSG(error, "GsShotArchiveReader - could not map " + file_name);
+            size_ = 0;
+            return false;
+        }
+
+        data_ = (uint8_t*)mapping;
+#else
+        std::ifstream file(file_name, std::ios::binary);
+        if (!file) {
+            GS_LOG_MSG(error, "GsShotArchiveReader - could not open " + file_name);
+            return false;
+        }
+
+        file_contents_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (file_contents_.size() < kFileHeaderSize) {
+            GS_LOG_MSG(error, "GsShotArchiveReader - " + file_name + " is too small to be a shot archive.");
+            file_contents_.clear();
+            return false;
+        }
+
+        data_ = file_contents_.data();
+        size_ = file_contents_.size();
+#endif
+
+        RecordCursor header(data_ + sizeof(kFileMagic), data_ + kFileHeaderSize);
+        if (memcmp(data_, kFileMagic, sizeof(kFileMagic)) != 0 || header.Get<uint32_t>() != kFileVersion) {
+            GS_LOG_MSG(error, "GsShotArchiveReader - " + file_name + " is not a (version " + std::to_string(kFileVersion) + ") shot archive.");
+            Close();
+            return false;
+        }
+
+        std::vector<GsShotArchive::IndexEntry> index;
+
+        if (!ReadIndex(index)) {
+            GS_LOG_MSG(info, "GsShotArchiveReader - " + file_name + " has no index (its writer may not have closed it).  Scanning it instead.");
+            index.clear();
+            ScanRecords(index);
+        }
+
+        for (const GsShotArchive::IndexEntry& entry : index) {
+            if (entry.type == GsShotArchive::RecordType::kFrame) {
+                frame_offsets_[entry.name] = entry.offset;
+                continue;
+            }
+
+            if (entry.type != GsShotArchive::RecordType::kShot || entry.offset + kRecordHeaderSize > size_) {
+                continue;
+            }
+
+            RecordCursor record_header(data_ + entry.offset, data_ + entry.offset + kRecordHeaderSize);
+            record_header.Get<uint32_t>();
+            record_header.Get<uint32_t>();
+            const uint64_t payload_size = record_header.Get<uint64_t>();
+
+            if (entry.offset + kRecordHeaderSize + payload_size > size_) {
+                continue;
+            }
+
+            const uint8_t* payload = data_ + entry.offset + kRecordHeaderSize;
+            RecordCursor cursor(payload, payload + payload_size);
+
+            GsArchivedShot shot;
+            shot.name = cursor.GetString();
+            shot.teed_ball_frame_name = cursor.GetString();
+            shot.strobed_balls_frame_name = cursor.GetString();
+            shot.camera1_model = cursor.Get<int32_t>();
+            shot.camera1_lens_type = cursor.Get<int32_t>();
+            shot.camera2_model = cursor.Get<int32_t>();
+            shot.camera2_lens_type = cursor.Get<int32_t>();
+            shot.config_hash = cursor.Get<uint64_t>();
+            GetResults(cursor, shot.results);
+
+            if (cursor.ok()) {
+                shots_.push_back(std::move(shot));
+            }
+        }
+
+        GS_LOG_TRACE_MSG(trace, "GsShotArchiveReader - " + file_name + " has " + std::to_string(frame_offsets_.size()) +
+                                " frames and " + std::to_string(shots_.size()) + " shots.");
+
+        return true;
+    }
+
+    bool GsShotArchiveReader::ReadIndex(std::vector<GsShotArchive::IndexEntry>& index) const {
+
+        if (size_ < kFileHeaderSize + kTrailerSize ||
+            memcmp(data_ + size_ - sizeof(kTrailerMagic), kTrailerMagic, sizeof(kTrailerMagic)) != 0) {
+            return false;
+        }
+
+        uint64_t index_offset = 0;
+        memcpy(&index_offset, data_ + size_ - kTrailerSize, sizeof(index_offset));
+
+        if (index_offset < kFileHeaderSize || index_offset > size_ - kTrailerSize) {
+            return false;
+        }
+
+        RecordCursor cursor(data_ + index_offset, data_ + size_ - kTrailerSize);
+
+        if (cursor.Get<uint32_t>() != kIndexMagic) {
+            return false;
+        }
+
+        const uint64_t count = cursor.Get<uint64_t>();
+
+        for (uint64_t i = 0; i < count && cursor.ok(); i++) {
+            GsShotArchive::IndexEntry entry;
+            entry.type = (GsShotArchive::RecordType)cursor.Get<uint32_t>();
+            entry.offset = cursor.Get<uint64_t>();
+            entry.name = cursor.GetString();
+            index.push_back(std::move(entry));
+        }
+
+        return cursor.ok();
+    }
+
+    bool GsShotArchiveReader::ScanRecords(std::vector<GsShotArchive::IndexEntry>& index) const {
+
+        uint64_t offset = kFileHeaderSize;
+
+        while (offset + kRecordHeaderSize <= size_) {
+            RecordCursor cursor(data_ + offset, data_ + size_);
+            const uint32_t magic = cursor.Get<uint32_t>();
+            const GsShotArchive::RecordType type = (GsShotArchive::RecordType)cursor.Get<uint32_t>();
+            const uint64_t payload_size = cursor.Get<uint64_t>();
+
+            if (magic != kRecordMagic || offset + kRecordHeaderSize + payload_size > size_) {
+                break;
+            }
+
+            RecordCursor payload(data_ + offset + kRecordHeaderSize, data_ + offset + kRecordHeaderSize + payload_size);
+            const std::string name = payload.GetString();
+
+            if (!payload.ok()) {
+                break;
+            }
+
+            index.push_back(GsShotArchive::IndexEntry{ type, offset, name });
+
+            offset = AlignUp(offset + kRecordHeaderSize + payload_size);
+        }
+
+        return true;
+    }
+
+    bool GsShotArchiveReader::GetFrame(const std::string& name, cv::Mat& img) const {
+
+        const auto it = frame_offsets_.find(name);
+        if (it == frame_offsets_.end()) {
+            return false;
+        }
+
+        const uint64_t offset = it->second;
+        if (offset + kRecordHeaderSize > size_) {
+            return false;
+        }
+
+        RecordCursor record_header(data_ + offset, data_ + offset + kRecordHeaderSize);
+        record_header.Get<uint32_t>();
+        record_header.Get<uint32_t>();
+        const uint64_t payload_size = record_header.Get<uint64_t>();
+
+        const uint64_t record_end = offset + kRecordHeaderSize + payload_size;
+        if (record_end > size_) {
+            return false;
+        }
+
+        RecordCursor cursor(data_ + offset + kRecordHeaderSize, data_ + record_end);
+        cursor.GetString();
+        const int32_t rows = cursor.Get<int32_t>();
+        const int32_t cols = cursor.Get<int32_t>();
+        const int32_t type = cursor.Get<int32_t>();
+        const uint64_t step = cursor.Get<uint64_t>();
+        const uint64_t pixel_offset = cursor.Get<uint64_t>();
+
+        if (!cursor.ok() || rows <= 0 || cols <= 0 || pixel_offset + step * rows > record_end ||
+            step < (uint64_t)cols * CV_ELEM_SIZE(type)) {
+            GS_LOG_MSG(warning, "GsShotArchiveReader - frame " + name + " is damaged.");
+            return false;
+        }
+
+        img = cv::Mat(rows, cols, type, data_ + pixel_offset, (size_t)step);
+
+        return true;
+    }
+
+    void GsShotArchiveReader::Close() {
+
+        if (data_ == nullptr) {
+            return;
+        }
+
+#ifdef __unix__
+        munmap(data_, size_);
+#else
+        file_contents_.clear();
+#endif
+
+        data_ = nullptr;
+        size_ = 0;
+        frame_offsets_.clear();
+        shots_.clear();
+    }
+
+}
@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A single-file archive of recorded shots for offline analysis and regression runs, so
+// that loading thousands of shots does not mean decoding thousands of PNGs.
+//
+// The file is append-only.  After a 64-byte header, it is a sequence of length-prefixed
+// records, each of which is either a named frame (the raw pixels, as-is) or a shot (its
+// teed-ball and strobed-balls frame names, the camera setup, the hash of the configuration
+// it was processed with and its GsResults).  Closing a writer adds an index of the records
+// at the end.  A writer that re-opens the archive drops the index and appends after the
+// last whole record, so an archive whose writer never closed loses nothing but the index,
+// and the reader just scans the records instead.
+//
+// The reader memory-maps the file.  Each frame's pixels start on a 64-byte boundary, and
+// GetFrame returns a cv::Mat over the mapping itself - no copy and no decoding.  The mapping
+// is private, so a caller that draws on a frame only changes its own copy of those pages.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "gs_results.h"
+
+namespace golf_sim {
+
+    struct GsArchivedShot {
+        std::string name;
+        std::string teed_ball_frame_name;
+        std::string strobed_balls_frame_name;
+
+        // The (slot 1 and slot 2) camera setup the frames were taken with
+        int camera1_model = 0;
+        int camera1_lens_type = 0;
+        int camera2_model = 0;
+        int camera2_lens_type = 0;
+
+        // GsConfigSnapshot::ContentHash() of the configuration, or 0 if unknown
+        uint64_t config_hash = 0;
+
+        GsResults results;
+    };
+
+    class GsShotArchive {
+
+    public:
+        enum class RecordType : uint32_t {
+            kFrame = 1,
+            kShot = 2
+        };
+
+        struct IndexEntry {
+            RecordType type = RecordType::kFrame;
+            uint64_t offset = 0;
+            std::string name;
+        };
+
+        static constexpr size_t kAlignment = 64;
+    };
+
+    class GsShotArchiveWriter {
+
+    public:
+        ~GsShotArchiveWriter();
+
+        // Creates the archive, or appends to it if it already exists
+        bool Open(const std::string& file_name);
+
+        // img is written exactly as it is (any type).  Returns false if the name is already in the archive.
+        bool AddFrame(const std::string& name, const cv::Mat& img);
+        bool AddShot(const GsArchivedShot& shot);
+
+        bool HasFrame(const std::string& name) const;
+
+        // Writes the index.  Called by the destructor if need be.
+        bool Close();
+
+    private:
+        bool AppendRecord(GsShotArchive::RecordType type, const std::string& name, const std::string& payload,
+                          const cv::Mat* pixels = nullptr);
+
+        std::string file_name_;
+        std::ofstream file_;
+        uint64_t end_offset_ = 0;
+        std::vector<GsShotArchive::IndexEntry> index_;
+        std::unordered_map<std::string, size_t> frame_index_;
+    };
+
+    class GsShotArchiveReader {
+
+    public:
+        GsShotArchiveReader() = default;
+        GsShotArchiveReader(const GsShotArchiveReader&) = delete;
+        GsShotArchiveReader& operator=(const GsShotArchiveReader&) = delete;
+        ~GsShotArchiveReader();
+
+        bool Open(const std::string& file_name);
+        void Close();
+
+        bool IsOpen() const { return data_ != nullptr; }
+
+        // img is only valid while the reader is open
+        bool GetFrame(const std::string& name, cv::Mat& img) const;
+
+        const std::vector<GsArchivedShot>& GetShots() const { return shots_; }
+
+    private:
+        bool ReadIndex(std::vector<GsShotArchive::IndexEntry>& index) const;
+        bool ScanRecords(std::vector<GsShotArchive::IndexEntry>& index) const;
+
+        uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+#ifndef __unix__
+        std::vector<uint8_t> file_contents_;
+#endif
+
+        std::unordered_map<std::string, uint64_t> frame_offsets_;
+        std::vector<GsArchivedShot> shots_;
+    };
+
+}
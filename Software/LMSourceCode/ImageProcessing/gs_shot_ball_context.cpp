@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "cv_utils.h"
+
+#include "gs_shot_ball_context.h"
+
+
+namespace golf_sim {
+
+    GsShotBallContextPtr GsShotBallContext::Create(const GolfBall& ball,
+                                                   const cv::Mat& ball_image,
+                                                   double patch_radius_ratio) {
+
+        auto context = std::make_shared<GsShotBallContext>();
+
+        context->ball = ball;
+        context->ball_image = ball_image;
+
+        if (ball_image.empty()) {
+            return context;
+        }
+
+        const int half_size = (int)std::round(CvUtils::CircleRadius(ball.ball_circle_) * patch_radius_ratio);
+        const cv::Rect patch_rect = cv::Rect(CvUtils::CircleX(ball.ball_circle_) - half_size, CvUtils::CircleY(ball.ball_circle_) - half_size,
+                                             2 * half_size, 2 * half_size) & cv::Rect(0, 0, ball_image.cols, ball_image.rows);
+
+        if (patch_rect.width < 2 || patch_rect.height < 2) {
+            GS_LOG_TRACE_MSG(trace, "GsShotBallContext - ball patch is empty.");
+            return context;
+        }
+
+        context->patch_rect = patch_rect;
+
+        // A copy, as the camera may re-use the image's buffer before the shot is over
+        if (ball_image.channels() > 1) {
+            cv::cvtColor(ball_image(patch_rect), context->gray_patch, cv::COLOR_BGR2GRAY);
+        }
+        else {
+            context->gray_patch = ball_image(patch_rect).clone();
+        }
+
+        return context;
+    }
+
+    bool GsShotBallContext::CanReuseBallFor(const cv::Mat& teed_ball_image) const {
+        return ball.calibrated &&
+               !ball_image.empty() &&
+               ball_image.size() == teed_ball_image.size();
+    }
+
+}
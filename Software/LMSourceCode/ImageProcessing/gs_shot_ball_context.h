@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// What was learned about the teed ball when it was placed, made once per shot and carried
+// through the FSM's WaitingForBallStabilization, WaitingForBallHit and
+// BallHitNowWaitingForCam2Image states, so that the later stages start from it rather than
+// finding the ball in a raw image again:
+// - the incremental stabilization check compares against the cached gray patch,
+// - the watching crop is centered on the refined ball circle, and
+// - the post-hit analysis takes the ball's circle, color statistics and search area from
+//   here instead of searching the teed-ball image, and only works out its 3D position again
+//   (which is cheap) for camera 1 as the analysis describes it.
+//
+// A context is never changed once made, so it can be shared with the shot's background
+// analysis (see GsShotPipeline).
+
+#pragma once
+
+#include <memory>
+
+#include <opencv2/core.hpp>
+
+#include "golf_ball.h"
+
+namespace golf_sim {
+
+    struct GsShotBallContext {
+
+        // As found in ball_image, with its radius refined, its color statistics and (for a full
+        // placement search) its position from camera 1
+        GolfBall ball;
+        cv::Mat ball_image;
+
+        // A gray copy of the patch of ball_image around the ball, for the stabilization check.
+        // Empty if the ball was too near the edge.
+        cv::Rect patch_rect;
+        cv::Mat gray_patch;
+
+        // The patch has a half-size of patch_radius_ratio times the ball's radius
+        static std::shared_ptr<const GsShotBallContext> Create(const GolfBall& ball,
+                                                              const cv::Mat& ball_image,
+                                                              double patch_radius_ratio);
+
+        // True if the ball was calibrated from a full search (i.e., not just by the placement
+        // detector) of an image the same size as teed_ball_image, so that the analysis of
+        // that image does not have to find the ball again.  Only the image's size is compared.
+        bool CanReuseBallFor(const cv::Mat& teed_ball_image) const;
+    };
+
+    using GsShotBallContextPtr = std::shared_ptr<const GsShotBallContext>;
+
+}
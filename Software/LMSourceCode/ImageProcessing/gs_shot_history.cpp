@@ -0,0 +1,475 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/crc.hpp>
+#include <msgpack.hpp>
+
+#include "gs_http_server.h"
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+
+#include "gs_shot_history.h"
+
+namespace golf_sim {
+
+    std::string GsShotHistory::kShotHistoryFile;
+    int GsShotHistory::kShotHistoryCommitDelayMs = 250;
+    int GsShotHistory::kShotHistoryMaxIndexedShots = 1000;
+    bool GsShotHistory::kShotHistoryHttpEnabled = false;
+
+    // The length and CRC-32 before each payload
+    static const size_t kRecordHeaderBytes = 2 * sizeof(uint32_t);
+
+    // Far larger than any shot, so that a corrupt length is not taken for a record
+    static const uint32_t kMaxPayloadBytes = 1 << 20;
+
+    int64_t GsShotHistory::session_ms_ = 0;
+
+    std::deque<GsShotHistory::PendingShot> GsShotHistory::queue_;
+    std::mutex GsShotHistory::mutex_;
+    GsBackgroundJob GsShotHistory::writer_job_(&GsShotHistory::Process);
+    bool GsShotHistory::running_ = false;
+
+    std::deque<GsShotHistory::IndexedShot> GsShotHistory::index_;
+    std::map<int, GsShotHistory::ClubStats> GsShotHistory::session_stats_;
+    std::mutex GsShotHistory::index_mutex_;
+
+    // Only used by writer_job_, and then by Shutdown once the job is idle
+    static bool history_loaded = false;
+    static int history_fd = -1;
+
+    static int64_t NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static uint32_t Crc32(const char* data, size_t size) {
+        boost::crc_32_type crc;
+        crc.process_bytes(data, size);
+        return crc.checksum();
+    }
+
+
+    void GsShotHistory::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kShotHistoryFile", kShotHistoryFile);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kShotHistoryCommitDelayMs", kShotHistoryCommitDelayMs);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kShotHistoryMaxIndexedShots", kShotHistoryMaxIndexedShots);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kShotHistoryHttpEnabled", kShotHistoryHttpEnabled);
+
+        kShotHistoryCommitDelayMs = std::max(kShotHistoryCommitDelayMs, 0);
+        kShotHistoryMaxIndexedShots = std::max(kShotHistoryMaxIndexedShots, 1);
+    }
+
+    void GsShotHistory::Start() {
+        if (kShotHistoryFile.empty()) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (running_) {
+                return;
+            }
+
+            session_ms_ = NowMs();
+            running_ = true;
+        }
+
+        // Loads the existing history right away
+        writer_job_.Schedule();
+
+        StartHttpEndpoint();
+    }
+
+    void GsShotHistory::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!running_) {
+                return;
+            }
+
+            running_ = false;
+        }
+
+        // Anything still queued is committed first, without waiting out the commit delay
+        writer_job_.WaitUntilIdle();
+
+        if (history_fd >= 0) {
+            close(history_fd);
+            history_fd = -1;
+        }
+    }
+
+    void GsShotHistory::Record(const GsResults& results) {
+        if (kShotHistoryFile.empty()) {
+            return;
+        }
+
+        PendingShot shot;
+        shot.time_ms = NowMs();
+        shot.results = results;
+        GsShotTrace::GetStageLatenciesUs(shot.stage_latencies_us);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!running_) {
+                return;
+            }
+
+            // Only if the disk has stopped keeping up
+            if ((int)queue_.size() >= kShotHistoryMaxIndexedShots) {
+                GS_LOG_MSG(warning, "GsShotHistory - the history writer is not keeping up.  Dropping the oldest queued shot.");
+                queue_.pop_front();
+                GsMetrics::Increment(GsMetrics::Counter::kDroppedShotHistory);
+            }
+
+            queue_.push_back(std::move(shot));
+        }
+
+        // Lets any other shots that are close behind go out in the same commit
+        writer_job_.Schedule(kShotHistoryCommitDelayMs);
+    }
+
+    bool GsShotHistory::Process() {
+
+        if (!history_loaded) {
+            // Here rather than in Start, so that a long history does not hold up the startup
+            LoadHistory();
+
+            history_fd = open(kShotHistoryFile.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+            if (history_fd < 0) {
+                GS_LOG_MSG(error, "GsShotHistory - could not open " + kShotHistoryFile + ": " + std::string(strerror(errno)));
+            }
+
+            history_loaded = true;
+        }
+
+        std::deque<PendingShot> batch;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch.swap(queue_);
+        }
+
+        if (batch.empty()) {
+            return false;
+        }
+
+        std::string records;
+
+        for (const PendingShot& shot : batch) {
+            const std::string payload = EncodePayload(shot);
+
+            const uint32_t header[2] = { (uint32_t)payload.size(), Crc32(payload.data(), payload.size()) };
+            records.append((const char*)header, sizeof(header));
+            records.append(payload);
+
+            IndexedShot indexed_shot;
+            if (DecodePayload(payload, indexed_shot)) {
+                AddToIndex(std::move(indexed_shot));
+            }
+
+            std::lock_guard<std::mutex> lock(index_mutex_);
+
+            ClubStats& stats = session_stats_[(int)shot.results.club_type_];
+            stats.shots++;
+            stats.speed_mph_sum += shot.results.speed_mph_;
+            stats.max_speed_mph = std::max(stats.max_speed_mph, (double)shot.results.speed_mph_);
+            stats.back_spin_rpm_sum += shot.results.back_spin_rpm_;
+            if (shot.results.carry_m_ > 0) {
+                stats.carry_shots++;
+                stats.carry_m_sum += shot.results.carry_m_;
+            }
+        }
+
+        if (history_fd < 0) {
+            return false;
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+
+        size_t written = 0;
+        while (written < records.size()) {
+            const ssize_t result = write(history_fd, records.data() + written, records.size() - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            written += (size_t)result;
+        }
+
+        if (written < records.size() || fdatasync(history_fd) != 0) {
+            GS_LOG_MSG(error, "GsShotHistory - could not commit " + std::to_string(batch.size()) + " shot(s) to " + kShotHistoryFile +
+                              ": " + std::string(strerror(errno)));
+            return false;
+        }
+
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+        GS_LOG_TRACE_MSG(trace, "GsShotHistory - committed " + std::to_string(batch.size()) + " shot(s) (" +
+                                std::to_string(records.size()) + " bytes) in " + std::to_string(elapsed_ms) + " ms.");
+
+        // Any shots queued in the meantime have scheduled their own, delayed commit
+        return false;
+    }
+
+    void GsShotHistory::LoadHistory() {
+        std::ifstream file(kShotHistoryFile, std::ios::binary);
+        if (!file) {
+            // There is no history yet
+            return;
+        }
+
+        // Only the newest payloads are decoded
+        std::deque<std::string> payloads;
+        uint64_t whole_records_bytes = 0;
+        long records = 0;
+
+        while (true) {
+            uint32_t header[2];
+            if (!file.read((char*)header, sizeof(header))) {
+                break;
+            }
+
+            if (header[0] == 0 || header[0] > kMaxPayloadBytes) {
+                break;
+            }
+
+            std::string payload(header[0], '\0');
+            if (!file.read(payload.data(), payload.size()) || Crc32(payload.data(), payload.size()) != header[1]) {
+                break;
+            }
+
+            whole_records_bytes += kRecordHeaderBytes + payload.size();
+            records++;
+
+            payloads.push_back(std::move(payload));
+            if ((int)payloads.size() > kShotHistoryMaxIndexedShots) {
+                payloads.pop_front();
+            }
+        }
+
+        file.close();
+
+        std::error_code error;
+        const uintmax_t file_bytes = std::filesystem::file_size(kShotHistoryFile, error);
+
+        // Anything after the last whole record would otherwise be in front of the next one
+        if (!error && file_bytes > whole_records_bytes) {
+            GS_LOG_MSG(warning, "GsShotHistory - dropping " + std::to_string(file_bytes - whole_records_bytes) +
+                                " bytes of torn or corrupt history from the end of " + kShotHistoryFile + ".");
+            std::filesystem::resize_file(kShotHistoryFile, whole_records_bytes, error);
+            if (error) {
+                GS_LOG_MSG(error, "GsShotHistory - could not truncate " + kShotHistoryFile + ": " + error.message());
+            }
+        }
+
+        for (const std::string& payload : payloads) {
+            IndexedShot shot;
+            if (DecodePayload(payload, shot)) {
+                AddToIndex(std::move(shot));
+            }
+        }
+
+        GS_LOG_MSG(info, "GsShotHistory - loaded " + std::to_string(payloads.size()) + " of the " + std::to_string(records) +
+                         " shots in " + kShotHistoryFile + ".");
+    }
+
+    std::string GsShotHistory::EncodePayload(const PendingShot& shot) {
+        msgpack::sbuffer buffer;
+        msgpack::packer<msgpack::sbuffer> packer(buffer);
+
+        packer.pack_map(4);
+
+        packer.pack("time_ms");
+        packer.pack(shot.time_ms);
+        packer.pack("session_ms");
+        packer.pack(session_ms_);
+
+        // Kept as the simulators' frame, so that the history follows any change to it
+        const std::string results_frame = shot.results.SerializeToMsgPack();
+        packer.pack("results");
+        packer.pack_bin((uint32_t)results_frame.size());
+        packer.pack_bin_body(results_frame.data(), (uint32_t)results_frame.size());
+
+        // Only the stages that were reached.  The motion is where they are measured from.
+        uint32_t marked_stages = 0;
+        for (int stage = 1; stage < GsShotTrace::kNumStages; stage++) {
+            marked_stages += (shot.stage_latencies_us[stage] >= 0) ? 1 : 0;
+        }
+
+        packer.pack("stage_latencies_us");
+        packer.pack_map(marked_stages);
+        for (int stage = 1; stage < GsShotTrace::kNumStages; stage++) {
+            if (shot.stage_latencies_us[stage] >= 0) {
+                packer.pack(GsShotTrace::GetStageName((GsShotTrace::Stage)stage));
+                packer.pack(shot.stage_latencies_us[stage]);
+            }
+        }
+
+        return std::string(buffer.data(), buffer.size());
+    }
+
+    bool GsShotHistory::DecodePayload(const std::string& payload, IndexedShot& shot) {
+        try {
+            msgpack::object_handle handle = msgpack::unpack(payload.data(), payload.size());
+            const msgpack::object& root = handle.get();
+
+            if (root.type != msgpack::type::MAP) {
+                return false;
+            }
+
+            int64_t time_ms = 0;
+            int64_t session_ms = 0;
+            std::string results_json = "null";
+            std::string latencies_json = "{}";
+
+            for (uint32_t i = 0; i < root.via.map.size; i++) {
+                const std::string key = root.via.map.ptr[i].key.as<std::string>();
+                const msgpack::object& value = root.via.map.ptr[i].val;
+
+                if (key == "time_ms") {
+                    time_ms = value.as<int64_t>();
+                }
+                else if (key == "session_ms") {
+                    session_ms = value.as<int64_t>();
+                }
+                else if (key == "results" && value.type == msgpack::type::BIN) {
+                    const std::string json = GsResults::MsgPackToJson(std::string(value.via.bin.ptr, value.via.bin.size));
+                    if (!json.empty()) {
+                        results_json = json;
+                    }
+                }
+                else if (key == "stage_latencies_us") {
+                    // msgpack's stream output for a map of strings and numbers is JSON
+                    std::ostringstream s;
+                    s << value;
+                    latencies_json = s.str();
+                }
+            }
+
+            shot.time_ms = time_ms;
+            shot.json = "{\"time_ms\":" + std::to_string(time_ms) + ",\"session_ms\":" + std::to_string(session_ms) +
+                        ",\"results\":" + results_json + ",\"stage_latencies_us\":" + latencies_json + "}";
+            return true;
+        }
+        catch (std::exception& ex) {
+            GS_LOG_MSG(warning, "GsShotHistory - could not decode a shot. ERROR: *** " + std::string(ex.what()) + " ***");
+            return false;
+        }
+    }
+
+    void GsShotHistory::AddToIndex(IndexedShot&& shot) {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+
+        index_.push_back(std::move(shot));
+        while ((int)index_.size() > kShotHistoryMaxIndexedShots) {
+            index_.pop_front();
+        }
+    }
+
+    std::string GsShotHistory::GetRecentShotsJson(int count) {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+
+        std::string json = "{\"shots\":[";
+
+        const int shots = std::clamp(count, 0, (int)index_.size());
+        for (int i = 0; i < shots; i++) {
+            json += (i == 0 ? "" : ",") + index_[index_.size() - 1 - i].json;
+        }
+
+        json += "]}";
+        return json;
+    }
+
+    std::string GsShotHistory::GetSessionStatsJson() {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(1);
+
+        int total_shots = 0;
+        for (const auto& [club_type, stats] : session_stats_) {
+            total_shots += stats.shots;
+        }
+
+        s << "{\"session_ms\":" << session_ms_ << ",\"shots\":" << total_shots << ",\"clubs\":[";
+
+        bool first = true;
+        for (const auto& [club_type, stats] : session_stats_) {
+            s << (first ? "" : ",")
+              << "{\"club_type\":" << club_type
+              << ",\"shots\":" << stats.shots
+              << ",\"mean_speed_mph\":" << stats.speed_mph_sum / stats.shots
+              << ",\"max_speed_mph\":" << stats.max_speed_mph
+              << ",\"mean_back_spin_rpm\":" << stats.back_spin_rpm_sum / stats.shots;
+            if (stats.carry_shots > 0) {
+                s << ",\"mean_carry_m\":" << stats.carry_m_sum / stats.carry_shots;
+            }
+            s << "}";
+            first = false;
+        }
+
+        s << "]}";
+        return s.str();
+    }
+
+    void GsShotHistory::StartHttpEndpoint() {
+        if (!kShotHistoryHttpEnabled) {
+            return;
+        }
+
+        const bool added = GsHttpServer::Get("/shot-history", [](const httplib::Request& request, httplib::Response& response) {
+            int count = 20;
+            if (request.has_param("count")) {
+                try {
+                    count = std::stoi(request.get_param_value("count"));
+                }
+                catch (std::exception&) {
+                    response.status = 400;
+                    return;
+                }
+            }
+
+            response.set_header("Access-Control-Allow-Origin", "*");
+            response.set_content(GetRecentShotsJson(count), "application/json");
+        });
+
+        if (!added) {
+            GS_LOG_MSG(warning, "GsShotHistory - kShotHistoryHttpEnabled is set, but the HTTP server is off (see kHttpServerPort).");
+            return;
+        }
+
+        GsHttpServer::Get("/shot-history/session", [](const httplib::Request&, httplib::Response& response) {
+            response.set_header("Access-Control-Allow-Origin", "*");
+            response.set_content(GetSessionStatsJson(), "application/json");
+        });
+
+        GS_LOG_MSG(info, "GsShotHistory - serving the shot history at " + GsHttpServer::GetUrl("/shot-history"));
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,119 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A local history of the shots, so that the web UI's history views do not have to dig
+// them out of the BALL_HIT_CSV log lines.  Each successful shot's GsResults (as the same
+// MessagePack frame that the simulators get) and its GsShotTrace stage latencies are
+// appended to kShotHistoryFile.  Record() only queues the shot.  A job on the shared,
+// low-priority GsBackgroundWorker gathers whatever is queued within kShotHistoryCommitDelayMs
+// and commits it with one write and one fdatasync, so the FSM and analysis threads never
+// wait on the disk.
+// Each record is a 4-byte length and a 4-byte CRC-32 of the (MessagePack map) payload,
+// both little-endian as on the Pi.  A record that was torn by a power cut is dropped, and
+// the file is cut back to the last whole record, when the history is next loaded.
+// The newest kShotHistoryMaxIndexedShots are also kept in memory (the older ones are
+// loaded from the file at startup), along with running stats for the current session,
+// i.e., since PiTrac started.  If kShotHistoryHttpEnabled is set, the GsHttpServer serves
+// them as GET /shot-history?count=N (newest first) and GET /shot-history/session.
+// The file is never trimmed.  A shot takes a few hundred bytes.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "gs_results.h"
+#include "gs_shot_trace.h"
+#include "worker_thread.h"
+
+namespace golf_sim {
+
+    class GsShotHistory {
+
+    public:
+        // Empty (the default) means no history
+        static std::string kShotHistoryFile;
+        // How long the writer waits for more shots before it commits what it has
+        static int kShotHistoryCommitDelayMs;
+        static int kShotHistoryMaxIndexedShots;
+        // False (the default) means no HTTP endpoint
+        static bool kShotHistoryHttpEnabled;
+
+        static void LoadConfigurationValues();
+
+        // Starts the writer (which first loads the existing history) and the HTTP endpoint
+        static void Start();
+
+        // Commits anything still queued, and stops.  Called once at shutdown.
+        static void Shutdown();
+
+        // Queues the shot, along with the stage latencies of the calling thread's GsShotTrace
+        static void Record(const GsResults& results);
+
+        // E.g., {"shots":[{"time_ms":1760000000000,"session_ms":...,"results":{...},"stage_latencies_us":{"trigger_sent":412,...}},...]}
+        static std::string GetRecentShotsJson(int count);
+
+        // E.g., {"session_ms":...,"shots":12,"clubs":[{"club_type":1,"shots":10,"mean_speed_mph":128.4,...},...]}
+        static std::string GetSessionStatsJson();
+
+    private:
+        struct PendingShot {
+            int64_t time_ms = 0;
+            GsResults results;
+            std::array<int64_t, GsShotTrace::kNumStages> stage_latencies_us{};
+        };
+
+        struct IndexedShot {
+            int64_t time_ms = 0;
+            std::string json;
+        };
+
+        struct ClubStats {
+            int shots = 0;
+            double speed_mph_sum = 0.0;
+            double max_speed_mph = 0.0;
+            double back_spin_rpm_sum = 0.0;
+            int carry_shots = 0;
+            double carry_m_sum = 0.0;
+        };
+
+        // Loads the history the first time, and then commits what is queued.  Run by writer_job_.
+        static bool Process();
+
+        // Reads the newest kShotHistoryMaxIndexedShots into the index
+        static void LoadHistory();
+
+        static std::string EncodePayload(const PendingShot& shot);
+        static bool DecodePayload(const std::string& payload, IndexedShot& shot);
+
+        // Adds to the index, dropping the oldest shot if it is full
+        static void AddToIndex(IndexedShot&& shot);
+
+        static void StartHttpEndpoint();
+
+        // When this run of PiTrac started, which identifies its session
+        static int64_t session_ms_;
+
+        static std::deque<PendingShot> queue_;
+        static std::mutex mutex_;
+        static GsBackgroundJob writer_job_;
+        static bool running_;
+
+        // Oldest first
+        static std::deque<IndexedShot> index_;
+        // By GolfSimClubs::GsClubType
+        static std::map<int, ClubStats> session_stats_;
+        static std::mutex index_mutex_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,179 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_shot_trace.h"
+
+#include "gs_shot_pipeline.h"
+
+namespace golf_sim {
+
+    bool GsShotPipeline::kPipelineShotAnalysis = false;
+    int GsShotPipeline::kMaxPipelinedShots = 2;
+
+    struct PipelinedShot {
+        long shot_number = 0;
+        uint64_t shot_trace_id = 0;
+        GsShotPipeline::Analysis analysis;
+    };
+
+    static std::deque<PipelinedShot> queue;
+    static std::mutex queue_mutex;
+    static std::condition_variable queue_changed;
+    static std::thread analysis_thread;
+    static bool exiting = false;
+    // Guarded by queue_mutex.  True while the analysis thread is running a shot.
+    static bool analyzing = false;
+    static long last_shot_number = 0;
+
+    static std::atomic<long> number_analyzed{ 0 };
+    static std::atomic<long> number_waited_for_room{ 0 };
+    static std::atomic<int> max_backlog{ 0 };
+
+    static void ProcessShots() {
+
+        while (true) {
+            PipelinedShot shot;
+
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_changed.wait(lock, [] { return !queue.empty() || exiting; });
+
+                if (queue.empty()) {
+                    // Exiting, and every shot has been analyzed
+                    break;
+                }
+
+                shot = std::move(queue.front());
+                queue.pop_front();
+                analyzing = true;
+            }
+
+            // Room for another shot
+            queue_changed.notify_all();
+
+            GS_LOG_TRACE_MSG(trace, "GsShotPipeline - analyzing shot " + std::to_string(shot.shot_number));
+
+            GsShotTrace::SetThreadShot(shot.shot_trace_id);
+
+            try {
+                shot.analysis();
+            }
+            catch (std::exception const& e) {
+                GS_LOG_MSG(error, "GsShotPipeline - analysis of shot " + std::to_string(shot.shot_number) + " failed: " + std::string(e.what()));
+            }
+
+            GsShotTrace::SetThreadShot(0);
+
+            number_analyzed++;
+
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                analyzing = false;
+            }
+
+            queue_changed.notify_all();
+        }
+    }
+
+    void GsShotPipeline::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.modes.kPipelineShotAnalysis", kPipelineShotAnalysis);
+        GolfSimConfiguration::SetConstant("gs_config.modes.kMaxPipelinedShots", kMaxPipelinedShots);
+
+        kMaxPipelinedShots = std::max(1, kMaxPipelinedShots);
+
+        if (kPipelineShotAnalysis) {
+            GS_LOG_MSG(info, "GsShotPipeline - analyzing up to " + std::to_string(kMaxPipelinedShots) + " shots in the background.");
+        }
+    }
+
+    bool GsShotPipeline::IsEnabled() {
+        return kPipelineShotAnalysis;
+    }
+
+    void GsShotPipeline::Submit(long shot_number, Analysis analysis) {
+
+        PipelinedShot shot{ shot_number, GsShotTrace::GetCurrentShotId(), std::move(analysis) };
+
+        std::unique_lock<std::mutex> lock(queue_mutex);
+
+        if (exiting) {
+            lock.unlock();
+            GS_LOG_MSG(warning, "GsShotPipeline - shutting down, so analyzing shot " + std::to_string(shot_number) + " right away.");
+            shot.analysis();
+            return;
+        }
+
+        if (shot_number < last_shot_number) {
+            GS_LOG_MSG(warning, "GsShotPipeline - shot " + std::to_string(shot_number) + " was submitted after shot " +
+                                std::to_string(last_shot_number) + ".  Its results will be published out of order.");
+        }
+        last_shot_number = shot_number;
+
+        auto backlog = [] { return (int)queue.size() + (analyzing ? 1 : 0); };
+
+        if (backlog() >= kMaxPipelinedShots) {
+            number_waited_for_room++;
+            GS_LOG_MSG(warning, "GsShotPipeline - " + std::to_string(backlog()) + " shots are still being analyzed.  Waiting.");
+            queue_changed.wait(lock, [&] { return backlog() < kMaxPipelinedShots; });
+        }
+
+        queue.push_back(std::move(shot));
+        max_backlog = std::max(max_backlog.load(), backlog());
+
+        if (!analysis_thread.joinable()) {
+            analysis_thread = std::thread(&ProcessShots);
+        }
+
+        lock.unlock();
+        queue_changed.notify_all();
+    }
+
+    bool GsShotPipeline::IsBusy() {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return !queue.empty() || analyzing;
+    }
+
+    void GsShotPipeline::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+
+            if (exiting) {
+                return;
+            }
+
+            exiting = true;
+        }
+
+        queue_changed.notify_all();
+
+        if (analysis_thread.joinable()) {
+            analysis_thread.join();
+        }
+
+        if (kPipelineShotAnalysis) {
+            GS_LOG_MSG(info, "GsShotPipeline statistics at shutdown: " + GetStatistics());
+        }
+    }
+
+    std::string GsShotPipeline::GetStatistics() {
+        return "analyzed=" + std::to_string(number_analyzed.load()) +
+               ", max_backlog=" + std::to_string(max_backlog.load()) +
+               ", waited_for_room=" + std::to_string(number_waited_for_room.load());
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
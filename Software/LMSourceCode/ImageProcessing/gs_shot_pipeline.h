@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Optionally runs each shot's post-hit analysis (ProcessReceivedCam2Image and the sending
+// of the results) on a background thread, so that the FSM can go straight back to looking
+// for the next ball and re-arming the cameras.  For range-style sessions, the next ball is
+// often teed up before the previous shot has been analyzed.
+// Each analysis must hold its own copies of the images that it uses.  The shots are
+// analyzed one at a time, in the order that they were submitted, so the results are
+// published in shot-number order.  If kMaxPipelinedShots are already waiting, Submit
+// waits for room rather than dropping a shot.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <functional>
+#include <string>
+
+namespace golf_sim {
+
+    class GsShotPipeline {
+
+    public:
+        using Analysis = std::function<void()>;
+
+        // If false (the default), the FSM analyzes each shot before it looks for the next ball
+        static bool kPipelineShotAnalysis;
+        // Includes the shot being analyzed
+        static int kMaxPipelinedShots;
+
+        static void LoadConfigurationValues();
+
+        static bool IsEnabled();
+
+        // Queues the analysis for the shot and returns right away (unless the pipeline is full).
+        // The analysis is run with the shot's latency trace (see GsShotTrace) as it
+        // was when the shot was submitted.
+        static void Submit(long shot_number, Analysis analysis);
+
+        // True while any shot is waiting or being analyzed
+        static bool IsBusy();
+
+        // Finishes every submitted shot and stops the analysis thread
+        static void Shutdown();
+
+        // E.g., "analyzed=10, max_backlog=2, waited_for_room=0"
+        static std::string GetStatistics();
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <cmath>
+#include <iterator>
+
+#include "gs_format_lib.h"
+#include "cv_utils.h"
+
+#include "gs_shot_record.h"
+
+namespace golf_sim {
+
+    GsShotRecord::GsShotRecord(const GolfBall& ball, long shot_number) :
+        shot_number(shot_number),
+        speed_mps((float)ball.velocity_),
+        vla_deg((float)ball.angles_ball_perspective_[1]),
+        hla_deg((float)ball.angles_ball_perspective_[0]),
+        back_spin_rpm((int)ball.rotation_speeds_RPM_[2]),
+        side_spin_rpm((int)ball.rotation_speeds_RPM_[0]) {
+
+        GsBallLaunch launch;
+        launch.speed_mps = speed_mps;
+        launch.vla_deg = vla_deg;
+        launch.hla_deg = hla_deg;
+        launch.back_spin_rpm = back_spin_rpm;
+        launch.side_spin_rpm = side_spin_rpm;
+
+        // The one estimate for this shot.  The simulators get it even without spin, but
+        // without the spin (e.g., a preliminary result) it is too far off to show the user.
+        const bool estimated = GsBallFlight::Estimate(launch, flight);
+        has_flight = estimated && (back_spin_rpm != 0 || side_spin_rpm != 0);
+
+        results = GsResults(ball, estimated ? &flight : nullptr);
+        results.shot_number_ = shot_number;
+    }
+
+    void GsShotRecord::SetClubData(float club_speed_mps, float club_path_image_deg) {
+        has_club_data = club_speed_mps > 0;
+        this->club_speed_mps = club_speed_mps;
+        this->club_path_image_deg = club_path_image_deg;
+
+        results.has_club_data_ = has_club_data;
+        results.club_speed_mph_ = (float)CvUtils::MetersPerSecondToMPH(club_speed_mps);
+        results.club_path_deg_ = club_path_image_deg;
+    }
+
+    void GsShotRecord::AppendCsv(std::string& out) const {
+
+        auto it = std::back_inserter(out);
+
+        it = GS_FORMATLIB_FORMAT_TO(it, "BALL_HIT_CSV, {}, ", shot_number);
+
+        if (has_flight) {
+            it = GS_FORMATLIB_FORMAT_TO(it, "{:f}, {:f}, {:f}, ",
+                                        CvUtils::MetersToYards(flight.carry_m),
+                                        CvUtils::MetersToYards(flight.total_m),
+                                        CvUtils::MetersToYards(flight.offline_m));
+        }
+        else {
+            it = GS_FORMATLIB_FORMAT_TO(it, "(carry - NA), (Total - NA), (Side Dest - NA), ");
+        }
+
+        if (has_club_data) {
+            it = GS_FORMATLIB_FORMAT_TO(it, "{:f}, {:f}, ", speed_mps / club_speed_mps, CvUtils::MetersPerSecondToMPH(club_speed_mps));
+        }
+        else {
+            it = GS_FORMATLIB_FORMAT_TO(it, "(Smash Factor - NA), (Club Speed - NA), ");
+        }
+
+        it = GS_FORMATLIB_FORMAT_TO(it, "{:f}, {}, {}, {:f}, {:f}, ",
+                                    CvUtils::MetersPerSecondToMPH(speed_mps), back_spin_rpm, side_spin_rpm, vla_deg, hla_deg);
+
+        if (has_flight) {
+            GS_FORMATLIB_FORMAT_TO(it, "{:f}, {:f}, {:f}, (Type-NA)",
+                                   flight.descent_deg, CvUtils::MetersToYards(flight.apex_m), flight.flight_time_s);
+        }
+        else {
+            GS_FORMATLIB_FORMAT_TO(it, "(Descent Angle-NA), (Apex-NA), (Flight Time-NA), (Type-NA)");
+        }
+    }
+
+    std::string GsShotRecord::FormatErrorCsv(long shot_number) {
+        return GS_FORMATLIB_FORMAT("BALL_HIT_CSV, {}, (carry - Error), (Total - Error), (Side Dest - Error), (Smash Factor - Error), (Club Speed - Error), "
+                                   "0, 0, 0, 0, 0, (Descent Angle-Error), (Apex-Error), (Flight Time-Error), (Type-Error)", shot_number);
+    }
+
+    static void AppendEscapedJson(std::string& out, const std::string& s) {
+        for (char c : s) {
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n";  break;
+                case '\r': out += "\\r";  break;
+                case '\t': out += "\\t";  break;
+                default:   out += c;
+            }
+        }
+    }
+
+    void GsShotRecord::AppendJson(std::string& out, int result_type, const std::string& message,
+                                  const std::vector<std::string>& images) const {
+
+        const int carry_m = has_flight ? (int)std::round(flight.carry_m) : 0;
+
+        GS_FORMATLIB_FORMAT_TO(std::back_inserter(out),
+            "{{\"result_type\":{},\"speed_mps\":{:f},\"launch_angle\":{:f},\"side_angle\":{:f},"
+            "\"back_spin\":{},\"side_spin\":{},\"carry\":{},\"message\":\"",
+            result_type, speed_mps, vla_deg, hla_deg, back_spin_rpm, side_spin_rpm, carry_m);
+
+        AppendEscapedJson(out, message);
+        out += "\",\"images\":[";
+
+        for (size_t i = 0; i < images.size(); i++) {
+            if (i > 0) {
+                out += ',';
+            }
+            out += '"';
+            AppendEscapedJson(out, images[i]);
+            out += '"';
+        }
+
+        out += "]}";
+    }
+
+}
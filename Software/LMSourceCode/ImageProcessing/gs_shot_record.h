@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Everything that is reported about one shot, worked out once (including the ball-flight
+// estimate) and then rendered as each consumer needs it - the BALL_HIT_CSV log line, the
+// web server's result JSON, and the GsResults (and so the MessagePack frame) that go to the
+// golf simulators.  The CSV and JSON are formatted straight into a re-used buffer.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "golf_ball.h"
+#include "gs_results.h"
+#include "gs_ball_flight.h"
+
+namespace golf_sim {
+
+    class GsShotRecord {
+
+    public:
+        // An all-zero record, e.g., for a status message
+        GsShotRecord() = default;
+
+        explicit GsShotRecord(const GolfBall& ball, long shot_number = 0);
+
+        // Joins the club strike analysis (see gs_club_strike_analysis.h) to the shot.  The
+        // path is in the camera 1 image, not relative to the target line.
+        void SetClubData(float club_speed_mps, float club_path_image_deg);
+
+        // Each appends to out, so that a caller can re-use one buffer for every shot.
+        // E.g., "BALL_HIT_CSV, 12, 215.3, ..."  The flight values are "NA" if there is no flight.
+        void AppendCsv(std::string& out) const;
+
+        // The web server's result message
+        void AppendJson(std::string& out, int result_type, const std::string& message,
+                        const std::vector<std::string>& images = {}) const;
+
+        // The line logged for a shot that could not be processed
+        static std::string FormatErrorCsv(long shot_number);
+
+        std::string SerializeToMsgPack() const { return results.SerializeToMsgPack(); }
+
+    public:
+        long shot_number = 0;
+        float speed_mps = 0;
+        float vla_deg = 0;
+        float hla_deg = 0;
+        int back_spin_rpm = 0;
+        int side_spin_rpm = 0;
+
+        // Only true if the club strike was analyzed
+        bool has_club_data = false;
+        float club_speed_mps = 0;
+        float club_path_image_deg = 0;
+
+        // Only true if the ball has spin (i.e., is not a preliminary result)
+        bool has_flight = false;
+        GsBallFlightResult flight;
+
+        // For the simulators.  Its flight values are set whenever there was an estimate.
+        GsResults results;
+    };
+
+}
@@ -0,0 +1,313 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+#include "gs_memory_footprint.h"
+
+#ifdef __unix__
+#include "gs_http_server.h"
+#endif
+
+#include "gs_shot_trace.h"
+
+namespace golf_sim {
+
+    bool GsShotTrace::kShotLatencyHttpEnabled = false;
+
+    std::array<GsShotTrace::TraceRecord, GsShotTrace::kTraceRingSize> GsShotTrace::ring_;
+    std::atomic<uint64_t> GsShotTrace::current_shot_id_{ 0 };
+    std::array<GsShotTrace::QueueWaitRecord, GsShotTrace::kNumEventPriorities> GsShotTrace::queue_waits_;
+
+    static thread_local uint64_t thread_shot_id = 0;
+
+    void GsShotTrace::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.logging.kShotLatencyHttpEnabled", kShotLatencyHttpEnabled);
+
+        std::string header = "SHOT_LATENCY_CSV_HEADER, shot_trace_id";
+        for (int stage = 1; stage < kNumStages; stage++) {
+            header += std::string(", ") + GetStageName((Stage)stage) + "_us";
+        }
+        header += ", soc_temp_c, throttled_flags";
+        GS_LOG_MSG(info, header);
+    }
+
+    const char* GsShotTrace::GetStageName(Stage stage) {
+        switch (stage) {
+            case Stage::kMotionDetected:    return "motion_detected";
+            case Stage::kTriggerSent:       return "trigger_sent";
+            case Stage::kCam2FrameReceived: return "cam2_frame_received";
+            case Stage::kUndistorted:       return "undistorted";
+            case Stage::kBallDetection:     return "ball_detection";
+            case Stage::kTrajectory:        return "trajectory";
+            case Stage::kSpin:              return "spin";
+            case Stage::kResultSent:        return "result_sent";
+            case Stage::kUiUpdated:         return "ui_updated";
+            default:                        return "unknown";
+        }
+    }
+
+    int64_t GsShotTrace::NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void GsShotTrace::BeginShot() {
+        const uint64_t shot_id = current_shot_id_.load(std::memory_order_relaxed) + 1;
+        TraceRecord& record = ring_[shot_id % kTraceRingSize];
+
+        // Retire whatever was in this slot before publishing the new id
+        record.complete.store(false, std::memory_order_relaxed);
+        for (auto& stage_ns : record.stage_ns) {
+            stage_ns.store(0, std::memory_order_relaxed);
+        }
+        record.soc_temperature_millic.store(-1, std::memory_order_relaxed);
+        record.throttled_flags.store(0, std::memory_order_relaxed);
+        record.stage_ns[(int)Stage::kMotionDetected].store(NowNs(), std::memory_order_relaxed);
+        record.shot_id.store(shot_id, std::memory_order_release);
+
+        current_shot_id_.store(shot_id, std::memory_order_release);
+    }
+
+    uint64_t GsShotTrace::GetCurrentShotId() {
+        return current_shot_id_.load(std::memory_order_acquire);
+    }
+
+    void GsShotTrace::SetThreadShot(uint64_t shot_id) {
+        thread_shot_id = shot_id;
+    }
+
+    uint64_t GsShotTrace::GetShotIdForThread() {
+        return (thread_shot_id != 0) ? thread_shot_id : current_shot_id_.load(std::memory_order_acquire);
+    }
+
+    void GsShotTrace::Mark(Stage stage) {
+        const uint64_t shot_id = GetShotIdForThread();
+        if (shot_id == 0) {
+            return;
+        }
+
+        ring_[shot_id % kTraceRingSize].stage_ns[(int)stage].store(NowNs(), std::memory_order_release);
+    }
+
+    void GsShotTrace::SetThermalState(int soc_temperature_millic, uint32_t throttled_flags) {
+        const uint64_t shot_id = GetShotIdForThread();
+        if (shot_id == 0) {
+            return;
+        }
+
+        TraceRecord& record = ring_[shot_id % kTraceRingSize];
+        record.soc_temperature_millic.store(soc_temperature_millic, std::memory_order_relaxed);
+        record.throttled_flags.store(throttled_flags, std::memory_order_release);
+    }
+
+    bool GsShotTrace::GetStageLatenciesUs(std::array<int64_t, kNumStages>& latencies_us) {
+        latencies_us.fill(-1);
+
+        const uint64_t shot_id = GetShotIdForThread();
+        if (shot_id == 0) {
+            return false;
+        }
+
+        const TraceRecord& record = ring_[shot_id % kTraceRingSize];
+
+        const int64_t start_ns = record.stage_ns[(int)Stage::kMotionDetected].load(std::memory_order_acquire);
+        if (start_ns == 0) {
+            return false;
+        }
+
+        for (int stage = 0; stage < kNumStages; stage++) {
+            const int64_t stage_ns = record.stage_ns[stage].load(std::memory_order_acquire);
+            if (stage_ns != 0) {
+                latencies_us[stage] = (stage_ns - start_ns) / 1000;
+            }
+        }
+
+        return true;
+    }
+
+    void GsShotTrace::EndShot() {
+        const uint64_t shot_id = GetShotIdForThread();
+        if (shot_id == 0) {
+            return;
+        }
+
+        TraceRecord& record = ring_[shot_id % kTraceRingSize];
+
+        if (record.complete.exchange(true, std::memory_order_acq_rel)) {
+            // Already ended
+            return;
+        }
+
+        const int64_t start_ns = record.stage_ns[(int)Stage::kMotionDetected].load(std::memory_order_acquire);
+
+        // Unmarked stages are left empty so that the columns always line up
+        std::string csv = "SHOT_LATENCY_CSV, " + std::to_string(shot_id);
+        for (int stage = 1; stage < kNumStages; stage++) {
+            const int64_t stage_ns = record.stage_ns[stage].load(std::memory_order_acquire);
+            csv += ", ";
+            if (stage_ns != 0 && start_ns != 0) {
+                csv += std::to_string((stage_ns - start_ns) / 1000);
+                GsMetrics::Observe(GsMetrics::Histogram::kShotStageLatency, stage_ns - start_ns, stage);
+            }
+        }
+
+        const int32_t soc_temperature_millic = record.soc_temperature_millic.load(std::memory_order_relaxed);
+        csv += ", ";
+        if (soc_temperature_millic >= 0) {
+            std::ostringstream temperature;
+            temperature << std::fixed << std::setprecision(1) << soc_temperature_millic / 1000.0;
+            csv += temperature.str();
+        }
+        csv += ", " + std::to_string(record.throttled_flags.load(std::memory_order_acquire));
+
+        GS_LOG_MSG(info, csv);
+
+        GsMetrics::Increment(GsMetrics::Counter::kShotsProcessed);
+
+        GsMemoryFootprint::EndShot();
+    }
+
+    void GsShotTrace::RecordEventQueueWait(int priority, int64_t wait_ns) {
+        if (priority < 0 || priority >= kNumEventPriorities) {
+            return;
+        }
+
+        // Single writer, so the count only needs to be published after the value
+        QueueWaitRecord& record = queue_waits_[priority];
+        const uint64_t count = record.count.load(std::memory_order_relaxed);
+        record.wait_ns[count % kQueueWaitRingSize].store(wait_ns, std::memory_order_relaxed);
+        record.count.store(count + 1, std::memory_order_release);
+
+        GsMetrics::Observe(GsMetrics::Histogram::kEventQueueWait, wait_ns, priority);
+    }
+
+    std::string GsShotTrace::GetPercentilesJson() {
+
+        std::array<std::vector<double>, kNumStages> stage_ms;
+        int number_of_shots = 0;
+        int number_of_throttled_shots = 0;
+        int32_t max_soc_temperature_millic = -1;
+
+        for (const TraceRecord& record : ring_) {
+            if (record.shot_id.load(std::memory_order_acquire) == 0 || !record.complete.load(std::memory_order_acquire)) {
+                continue;
+            }
+
+            const int64_t start_ns = record.stage_ns[(int)Stage::kMotionDetected].load(std::memory_order_acquire);
+            if (start_ns == 0) {
+                continue;
+            }
+
+            number_of_shots++;
+
+            // Only whether the SoC was being throttled during the shot, not if it ever was since boot
+            if ((record.throttled_flags.load(std::memory_order_acquire) & 0xF) != 0) {
+                number_of_throttled_shots++;
+            }
+            max_soc_temperature_millic = std::max(max_soc_temperature_millic, record.soc_temperature_millic.load(std::memory_order_relaxed));
+
+            for (int stage = 1; stage < kNumStages; stage++) {
+                const int64_t ns = record.stage_ns[stage].load(std::memory_order_acquire);
+                if (ns != 0) {
+                    stage_ms[stage].push_back((double)(ns - start_ns) / 1.0e6);
+                }
+            }
+        }
+
+        auto percentile = [](const std::vector<double>& sorted_values, double fraction) {
+            size_t index = (size_t)std::min((double)(sorted_values.size() - 1), fraction * (double)sorted_values.size());
+            return sorted_values[index];
+        };
+
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(2);
+        s << "{\"shots\":" << number_of_shots << ",\"throttled_shots\":" << number_of_throttled_shots;
+        if (max_soc_temperature_millic >= 0) {
+            s << ",\"max_soc_temp_c\":" << max_soc_temperature_millic / 1000.0;
+        }
+        s << ",\"stages\":[";
+
+        bool first = true;
+        for (int stage = 1; stage < kNumStages; stage++) {
+            std::vector<double>& values = stage_ms[stage];
+            if (values.empty()) {
+                continue;
+            }
+
+            std::sort(values.begin(), values.end());
+
+            s << (first ? "" : ",")
+              << "{\"stage\":\"" << GetStageName((Stage)stage) << "\""
+              << ",\"samples\":" << values.size()
+              << ",\"p50_ms\":" << percentile(values, 0.50)
+              << ",\"p95_ms\":" << percentile(values, 0.95)
+              << ",\"p99_ms\":" << percentile(values, 0.99) << "}";
+            first = false;
+        }
+
+        static const char* const kPriorityNames[kNumEventPriorities] = { "high", "normal", "low" };
+
+        // Queue waits are usually well under a millisecond
+        s << "],\"queue_wait\":[" << std::setprecision(3);
+
+        first = true;
+        for (int priority = 0; priority < kNumEventPriorities; priority++) {
+            const QueueWaitRecord& record = queue_waits_[priority];
+            const uint64_t count = std::min<uint64_t>(record.count.load(std::memory_order_acquire), kQueueWaitRingSize);
+            if (count == 0) {
+                continue;
+            }
+
+            std::vector<double> values;
+            values.reserve(count);
+            for (uint64_t i = 0; i < count; i++) {
+                values.push_back((double)record.wait_ns[i].load(std::memory_order_relaxed) / 1.0e6);
+            }
+
+            std::sort(values.begin(), values.end());
+
+            s << (first ? "" : ",")
+              << "{\"priority\":\"" << kPriorityNames[priority] << "\""
+              << ",\"samples\":" << values.size()
+              << ",\"p50_ms\":" << percentile(values, 0.50)
+              << ",\"p95_ms\":" << percentile(values, 0.95)
+              << ",\"p99_ms\":" << percentile(values, 0.99) << "}";
+            first = false;
+        }
+
+        s << "]}";
+
+        return s.str();
+    }
+
+    void GsShotTrace::StartHttpEndpoint() {
+#ifdef __unix__
+        if (!kShotLatencyHttpEnabled) {
+            return;
+        }
+
+        const bool added = GsHttpServer::Get("/shot-latency", [](const httplib::Request&, httplib::Response& response) {
+            response.set_content(GetPercentilesJson(), "application/json");
+        });
+
+        if (!added) {
+            GS_LOG_MSG(warning, "GsShotTrace - kShotLatencyHttpEnabled is set, but the HTTP server is off (see kHttpServerPort).");
+            return;
+        }
+
+        GS_LOG_MSG(info, "GsShotTrace - serving shot latencies at " + GsHttpServer::GetUrl("/shot-latency"));
+#endif
+    }
+
+}
@@ -0,0 +1,121 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Per-shot latency tracing.  Each of the stages below gets a monotonic timestamp
+// as the shot moves through the system, from the motion detector (on the camera
+// post-processing thread) to the UI update (on the FSM thread).
+// The traces are kept in a small lock-free ring so that marking a stage costs only a
+// clock read and an atomic store, even in the SCHED_FIFO trigger path.  Each finished
+// shot is also logged as a "SHOT_LATENCY_CSV" line, and the p50/p95/p99 of each stage
+// over the recent shots can be fetched from the GsHttpServer if kShotLatencyHttpEnabled is set.
+// The same JSON has the recent FSM event queue wait times for each event priority.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace golf_sim {
+
+    class GsShotTrace {
+
+    public:
+        enum class Stage {
+            kMotionDetected = 0,
+            kTriggerSent,
+            kCam2FrameReceived,
+            kUndistorted,
+            kBallDetection,
+            kTrajectory,
+            kSpin,
+            kResultSent,
+            kUiUpdated,
+            kNumStages
+        };
+
+        static constexpr int kNumStages = (int)Stage::kNumStages;
+
+        // High, normal and low, as in GolfSimEventQueue::Priority
+        static constexpr int kNumEventPriorities = 3;
+
+        // False (the default) means no HTTP endpoint
+        static bool kShotLatencyHttpEnabled;
+
+        static void LoadConfigurationValues();
+
+        // Starts a new trace and marks it kMotionDetected
+        static void BeginShot();
+
+        // Marks the stage of the current trace.  Does nothing if there is no current trace.
+        static void Mark(Stage stage);
+
+        // 0 if no shot has been traced yet
+        static uint64_t GetCurrentShotId();
+
+        // Until it is called again with 0, Mark, SetThermalState and EndShot on the calling
+        // thread apply to the given trace rather than the current one.  E.g., for a shot that
+        // is analyzed in the background while the next one is traced (see GsShotPipeline).
+        static void SetThreadShot(uint64_t shot_id);
+
+        // Records the SoC temperature (thousandths of a degree C, or -1 if unknown) and the
+        // firmware's throttling flags for the current trace
+        static void SetThermalState(int soc_temperature_millic, uint32_t throttled_flags);
+
+        // The time from kMotionDetected to each stage of the calling thread's trace (or else
+        // the current one), in microseconds.  -1 for the stages that have not been marked.
+        // False if there is no trace.
+        static bool GetStageLatenciesUs(std::array<int64_t, kNumStages>& latencies_us);
+
+        // Completes the current trace and logs it as a CSV line
+        static void EndShot();
+
+        // Records how long an event of the given priority waited in the FSM's event queue.
+        // Only the FSM thread may call this.
+        static void RecordEventQueueWait(int priority, int64_t wait_ns);
+
+        // E.g., {"shots":20,"throttled_shots":0,"max_soc_temp_c":61.2,"stages":[{"stage":"trigger_sent","p50_ms":0.4,...},...]}
+        // Each stage's time is measured from kMotionDetected.  Then, e.g.,
+        // "queue_wait":[{"priority":"high","samples":256,"p50_ms":0.02,...},...]
+        static std::string GetPercentilesJson();
+
+        // Adds GET /shot-latency, with GetPercentilesJson(), to the GsHttpServer.  Does
+        // nothing unless kShotLatencyHttpEnabled is set.
+        static void StartHttpEndpoint();
+
+        static const char* GetStageName(Stage stage);
+
+    private:
+        static constexpr int kTraceRingSize = 64;
+        static constexpr int kQueueWaitRingSize = 256;
+
+        struct TraceRecord {
+            std::atomic<uint64_t> shot_id{ 0 };
+            std::atomic<bool> complete{ false };
+            // Monotonic nanoseconds.  0 means not (yet) marked.
+            std::array<std::atomic<int64_t>, kNumStages> stage_ns{};
+            std::atomic<int32_t> soc_temperature_millic{ -1 };
+            std::atomic<uint32_t> throttled_flags{ 0 };
+        };
+
+        static int64_t NowNs();
+
+        // The calling thread's trace, if it has one, or else the current trace
+        static uint64_t GetShotIdForThread();
+
+        static std::array<TraceRecord, kTraceRingSize> ring_;
+        static std::atomic<uint64_t> current_shot_id_;
+
+        // The most recent waits for each priority
+        struct QueueWaitRecord {
+            std::atomic<uint64_t> count{ 0 };
+            std::array<std::atomic<int64_t>, kQueueWaitRingSize> wait_ns{};
+        };
+
+        static std::array<QueueWaitRecord, kNumEventPriorities> queue_waits_;
+    };
+
+}
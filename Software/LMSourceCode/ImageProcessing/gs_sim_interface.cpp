@@ -3,14 +3,22 @@
  * Copyright (C) 2022-2025, Verdant Consultants, LLC.
  */
 
+#include <algorithm>
+
 #include "logging_tools.h"
 #include "cv_utils.h"
 #include "gs_options.h"
 #include "gs_config.h"
 
 #include "gs_sim_interface.h"
+#include "gs_sim_socket_reactor.h"
 #include "gs_gspro_interface.h"
 #include "gs_e6_interface.h"
+#include "gs_results_publisher.h"
+#include "gs_results_multicast.h"
+#include "gs_shared_memory.h"
+#include "gs_local_display.h"
+#include "gs_results_bus.h"
 
 namespace golf_sim {
 
@@ -27,6 +35,19 @@ namespace golf_sim {
     // the system will increment the counter first before storing information
     long GsSimInterface::shot_counter_ = 0;
 
+    bool GsSimInterface::kUseHeartbeatScheduler = false;
+    int GsSimInterface::kHeartbeatKeepAliveIntervalMs = 5000;
+
+    std::thread GsSimInterface::heartbeat_thread_;
+    std::mutex GsSimInterface::heartbeat_mutex_;
+    std::condition_variable GsSimInterface::heartbeat_changed_;
+    bool GsSimInterface::heartbeat_ball_detected_ = false;
+    // Nothing has been sent yet, so the first heartbeat always goes out
+    bool GsSimInterface::heartbeat_pending_ = true;
+    bool GsSimInterface::heartbeat_exiting_ = false;
+    long GsSimInterface::heartbeats_sent_ = 0;
+    long GsSimInterface::heartbeats_coalesced_ = 0;
+
 
     GsSimInterface::GsSimInterface() {
         GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kLaunchMonitorIdString", launch_monitor_id_string_);
@@ -84,11 +105,44 @@ namespace golf_sim {
         if (interfaces_.size() == 0) {
             GS_LOG_TRACE_MSG(trace, "No simulator interface detected.");
         }
+
+        // Not being able to publish to local consumers is not a reason to stop
+        if (!GsResultsPublisher::Start()) {
+            GS_LOG_MSG(warning, "Could not start the results publisher.");
+        }
+
+        if (!GsResultsMulticast::Start()) {
+            GS_LOG_MSG(warning, "Could not start the results multicast.");
+        }
+
+        GsResultsBus::LoadConfigurationValues();
+
+        if (GsResultsBus::kUseResultsBus) {
+            for (auto interface : interfaces_) {
+                if (interface == nullptr) {
+                    continue;
+                }
+
+                const std::string name = (interface->simulator_type_ == GolfSimulatorType::kGSPro) ? "GSPro" :
+                                         (interface->simulator_type_ == GolfSimulatorType::kE6) ? "E6" : "Simulator";
+
+                GsResultsBus::Subscribe(name, [interface](const GsResults& results) { interface->SendResults(results); });
+            }
+
+            GsResultsBus::Subscribe("ResultsPublisher", [](const GsResults& results) { GsResultsPublisher::Publish(results); });
+            GsResultsBus::Subscribe("ResultsMulticast", [](const GsResults& results) { GsResultsMulticast::Publish(results); });
+            GsResultsBus::Subscribe("SharedMemory", [](const GsResults& results) { GsSharedMemory::PublishResults(results); });
+            GsResultsBus::Subscribe("LocalDisplay", [](const GsResults& results) { GsLocalDisplay::SetLastShot(results); });
+        }
 #endif
         shot_counter_ = 0;
 
         sims_initialized_ = true;
 
+#ifdef __unix__  // Ignore in Windows environment
+        StartHeartbeatScheduler();
+#endif
+
         return true;
     }
 
@@ -122,6 +176,10 @@ namespace golf_sim {
 
 #ifdef __unix__  // Ignore in Windows environment
 
+        // The heartbeat thread and the bus's consumers use the interfaces, so they have to stop first
+        StopHeartbeatScheduler();
+        GsResultsBus::Stop();
+
         for (auto interface : interfaces_) {
             if (interface == nullptr) {
                 GS_LOG_MSG(error, "GsSimInterface::DeInitializeSims() found a null interface");
@@ -131,6 +189,14 @@ namespace golf_sim {
             interface->DeInitialize();
             delete interface;
         }
+
+        interfaces_.clear();
+
+        // Every simulator socket has been closed by now
+        GsSimSocketReactor::Instance().Stop();
+
+        GsResultsPublisher::Stop();
+        GsResultsMulticast::Stop();
 #endif
         sims_initialized_ = false;
     }
@@ -167,10 +233,14 @@ namespace golf_sim {
     bool GsSimInterface::SendResultsToGolfSims(const GsResults& input_results) {
 
         // The shot number should already have been set when the ball was teed up
+        return SendResultsToGolfSims(input_results, shot_counter_);
+    }
 
-        // Make a local copy of the results so that we can set the shot_counter
+    bool GsSimInterface::SendResultsToGolfSims(const GsResults& input_results, long shot_number) {
+
+        // Make a local copy of the results so that we can set the shot number
         GsResults results = input_results;
-        results.shot_number_ = shot_counter_;
+        results.shot_number_ = shot_number;
 
         if (results.speed_mph_ > 200.0) {
             GS_LOG_MSG(warning, "GsSimInterface::SendResultsToGolfSim got out of bounds speed_mph.  Settting to 200.");
@@ -181,6 +251,11 @@ namespace golf_sim {
 
 #ifdef __unix__  // Ignore in Windows environment
 
+        if (GsResultsBus::IsRunning()) {
+            GsResultsBus::Publish(results);
+            return status;
+        }
+
         // Loop through any interfaces that we are configured for and send the results
         for (auto interface : interfaces_) {
             if (interface == nullptr) {
@@ -191,6 +266,11 @@ namespace golf_sim {
             interface->SendResults(results);
         }
 
+        GsResultsPublisher::Publish(results);
+        GsResultsMulticast::Publish(results);
+        GsSharedMemory::PublishResults(results);
+        GsLocalDisplay::SetLastShot(results);
+
 #endif
         return status;
     }
@@ -243,20 +323,119 @@ namespace golf_sim {
             return;
         }
 
+        {
+            std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+
+            if (heartbeat_thread_.joinable()) {
+                if (ball_detected == heartbeat_ball_detected_ && !heartbeat_pending_) {
+                    // The simulators already know.  The keep-alive will repeat it.
+                    heartbeats_coalesced_++;
+                    return;
+                }
+
+                heartbeat_ball_detected_ = ball_detected;
+                heartbeat_pending_ = true;
+                heartbeat_changed_.notify_one();
+                return;
+            }
+        }
+
+        DeliverHeartbeat(ball_detected);
+#endif
+    }
+
+    void GsSimInterface::ResetHeartbeatState() {
+        std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+        heartbeat_pending_ = true;
+    }
+
+    void GsSimInterface::DeliverHeartbeat(bool ball_detected) {
+#ifdef __unix__  // Ignore in Windows environment
         GsResults heartbeat;
         heartbeat.result_message_is_keepalive_ = true;
         heartbeat.heartbeat_ball_detected_ = ball_detected;
         heartbeat.heartbeat_launch_monitor_ready_ = true;
 
+        if (GsResultsBus::IsRunning()) {
+            GsResultsBus::Publish(heartbeat);
+            return;
+        }
+
         for (auto interface : interfaces_) {
             if (interface == nullptr) {
                 continue;
             }
             interface->SendResults(heartbeat);
         }
+
+        GsResultsPublisher::Publish(heartbeat);
+        GsResultsMulticast::Publish(heartbeat);
 #endif
     }
 
+    void GsSimInterface::StartHeartbeatScheduler() {
+
+        GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kUseHeartbeatScheduler", kUseHeartbeatScheduler);
+        GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kHeartbeatKeepAliveIntervalMs", kHeartbeatKeepAliveIntervalMs);
+
+        std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+
+        if (!kUseHeartbeatScheduler || heartbeat_thread_.joinable()) {
+            return;
+        }
+
+        kHeartbeatKeepAliveIntervalMs = std::max(100, kHeartbeatKeepAliveIntervalMs);
+
+        heartbeat_exiting_ = false;
+        heartbeats_sent_ = 0;
+        heartbeats_coalesced_ = 0;
+        heartbeat_thread_ = std::thread(&GsSimInterface::ProcessHeartbeats);
+
+        GS_LOG_TRACE_MSG(trace, "GsSimInterface - heartbeat scheduler started.  Keep-alive every " + std::to_string(kHeartbeatKeepAliveIntervalMs) + "ms.");
+    }
+
+    void GsSimInterface::StopHeartbeatScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+
+            if (!heartbeat_thread_.joinable()) {
+                return;
+            }
+
+            heartbeat_exiting_ = true;
+        }
+
+        heartbeat_changed_.notify_one();
+        heartbeat_thread_.join();
+
+        GS_LOG_MSG(info, "GsSimInterface - sent " + std::to_string(heartbeats_sent_) + " heartbeats, coalesced " +
+                         std::to_string(heartbeats_coalesced_) + ".");
+    }
+
+    void GsSimInterface::ProcessHeartbeats() {
+
+        std::unique_lock<std::mutex> lock(heartbeat_mutex_);
+
+        while (!heartbeat_exiting_) {
+            // Either a state change or, if nothing changes, another keep-alive
+            heartbeat_changed_.wait_for(lock, std::chrono::milliseconds(kHeartbeatKeepAliveIntervalMs),
+                                        [] { return heartbeat_exiting_ || heartbeat_pending_; });
+
+            if (heartbeat_exiting_) {
+                break;
+            }
+
+            const bool ball_detected = heartbeat_ball_detected_;
+            heartbeat_pending_ = false;
+            heartbeats_sent_++;
+
+            // A state change that arrives while this one is being sent is picked up next time around
+            lock.unlock();
+            DeliverHeartbeat(ball_detected);
+            lock.lock();
+        }
+    }
+
     bool GsSimInterface::InterfaceIsPresent() {
         // The base interface isn't a real interface, so cannot be 'present'
         return false;
@@ -5,6 +5,11 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include <boost/asio.hpp>
 #include <boost/thread/mutex.hpp>
 
@@ -42,6 +47,10 @@ namespace golf_sim {
         // To be called from the launch monitor
         static bool SendResultsToGolfSims(const GsResults& results);
 
+        // For a shot whose number is no longer the current one, e.g., one that
+        // was analyzed in the background while the next ball was teed up
+        static bool SendResultsToGolfSims(const GsResults& results, long shot_number);
+
         // If the interface is present (usually indicated in the config.json file),
         // this method returns true;
         static bool InterfaceIsPresent();
@@ -80,12 +89,28 @@ namespace golf_sim {
         // Returns true only if each of the available interfaces is armed
         static bool GetAllSystemsArmed();
 
+        // If true, heartbeats are sent by a separate thread.  SendHeartbeat then only records
+        // the ball state - a change is sent right away, a repeat of the last state is not
+        // sent at all, and the current state is re-sent every kHeartbeatKeepAliveIntervalMs.
+        static bool kUseHeartbeatScheduler;
+        static int kHeartbeatKeepAliveIntervalMs;
+
         // Heartbeat support for external simulators
         static void SendHeartbeat(bool ball_detected);
-        static inline void ResetHeartbeatState() {}
+
+        // Makes the next heartbeat go out even if the ball state has not changed, e.g.,
+        // because a simulator has just connected
+        static void ResetHeartbeatState();
 
     protected:
 
+        // Sends the heartbeat on the calling thread
+        static void DeliverHeartbeat(bool ball_detected);
+
+        static void StartHeartbeatScheduler();
+        static void StopHeartbeatScheduler();
+        static void ProcessHeartbeats();
+
         // Typical derived-class behavior will be to convert the results into a
         // sim-specific data packet, such as a JSON string
         virtual std::string GenerateResultsDataToSend(const GsResults& results);
@@ -105,6 +130,16 @@ namespace golf_sim {
 
         static long shot_counter_;
 
+        static std::thread heartbeat_thread_;
+        static std::mutex heartbeat_mutex_;
+        static std::condition_variable heartbeat_changed_;
+        // All guarded by heartbeat_mutex_
+        static bool heartbeat_ball_detected_;
+        static bool heartbeat_pending_;
+        static bool heartbeat_exiting_;
+        static long heartbeats_sent_;
+        static long heartbeats_coalesced_;
+
         // True if all THIS sim has been initialized
         bool initialized_;
 
@@ -7,7 +7,9 @@
 
 #ifdef __unix__  // Ignore in Windows environment
 
-#include <pthread.h>
+#include <algorithm>
+#include <future>
+#include <unistd.h>
 #include <boost/asio.hpp>
 #include <boost/bind/bind.hpp>
 #include <boost/enable_shared_from_this.hpp>
@@ -17,6 +19,8 @@
 #include "gs_config.h"
 #include "gs_events.h"
 #include "gs_control_msg.h"
+#include "gs_metrics.h"
+#include "gs_trace_zones.h"
 
 #include "gs_sim_socket_interface.h"
 #include "gs_gspro_interface.h"
@@ -29,6 +33,21 @@ using ip::tcp;
 
 namespace golf_sim {
 
+    bool GsSimSocketInterface::kSimSocketAsyncSend = false;
+    int GsSimSocketInterface::kSimSocketMaxQueuedMessages = 8;
+    int GsSimSocketInterface::kSimSocketResultCacheSize = 0;
+    int GsSimSocketInterface::kSimSocketReconnectIntervalMs = 1000;
+    int GsSimSocketInterface::kSimSocketResendMaxAgeMs = 30000;
+
+    // How long DeInitialize will wait for queued messages (e.g., E6's Disconnect) to go out
+    static const int kSimSocketDrainTimeoutMs = 250;
+
+    // How long DeInitialize will wait for the reactor to finish the closed socket's operations
+    static const int kSimSocketCloseTimeoutMs = 1000;
+
+    // Set only on the reconnect thread, which reconnects and re-sends as any other caller would
+    static thread_local bool on_reconnect_thread = false;
+
     GsSimSocketInterface::GsSimSocketInterface() {
     }
 
@@ -51,37 +70,44 @@ namespace golf_sim {
         // setup a keep-alive ping to the SimSocket system.
         GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface Initialize called.");
 
+        GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kSimSocketAsyncSend", kSimSocketAsyncSend);
+        GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kSimSocketMaxQueuedMessages", kSimSocketMaxQueuedMessages);
+        GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kSimSocketResultCacheSize", kSimSocketResultCacheSize);
+        GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kSimSocketReconnectIntervalMs", kSimSocketReconnectIntervalMs);
+        GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.kSimSocketResendMaxAgeMs", kSimSocketResendMaxAgeMs);
+
         try
         {
-            io_context_ = new boost::asio::io_context();
-
-            if (io_context_ == nullptr) {
-                GS_LOG_MSG(error, "GsSimSocketInterface could not create a new io_context.");
-                return false;
-            }
+            boost::asio::io_context& io_context = GsSimSocketReactor::Instance().GetIoContext();
 
-            tcp::resolver resolver(*io_context_);
+            tcp::resolver resolver(io_context);
             GS_LOG_TRACE_MSG(trace, "Connecting to SimSocketServer at address: " + socket_connect_address_ + ":" + socket_connect_port_);
             tcp::resolver::results_type endpoints = resolver.resolve(socket_connect_address_, socket_connect_port_);
 
-            // Create the socket if we haven't done so already
-            if (socket_ == nullptr) {
-                socket_ = new tcp::socket(*io_context_);
+            // The connect itself is synchronous, and only the reads and writes are left to the reactor
+            std::shared_ptr<tcp::socket> socket = std::make_shared<tcp::socket>(io_context);
 
-                if (socket_ == nullptr) {
-                    GS_LOG_MSG(error, "GsSimSocketInterface could not create a new socket.");
-                    return false;
-                }
-            }
+            boost::asio::connect(*socket, endpoints);
 
+            // The messages are small JSON frames, so don't let Nagle hold them back
+            socket->set_option(tcp::no_delay(true));
 
-            boost::asio::connect(*socket_, endpoints);
+            {
+                boost::lock_guard<boost::mutex> lock(socket_mutex_);
+                socket_ = socket;
+            }
 
-            receiver_thread_ = std::unique_ptr<std::thread>(new std::thread(&GsSimSocketInterface::ReceiveSocketData, this));
+            if (kSimSocketAsyncSend) {
+                StartAsyncSender();
+            }
 
-            // GS_LOG_TRACE_MSG(trace, "Thread was created.  Thread id: " + std::string(receiver_thread_.get()->get_id()) );
+            // Set here rather than only in the first read, so that a SendResults that comes before
+            // the read has started does not see the last connection's state
+            receiver_stopped_ = false;
+            read_in_progress_ = true;
+            framer_.Clear();
 
-            // socket_->set_option(boost::asio::detail::socket_option::integer<SOL_SOCKET, SO_RCVTIMEO>{ 10 });
+            boost::asio::post(io_context, [this, socket]() { StartReceive(socket); });
         }
         catch (std::exception& e)
         {
@@ -89,11 +115,6 @@ namespace golf_sim {
             return false;
         }
 
-#ifdef __unix__  // Ignore in Windows environment
-        // Give the new thread a moment to get running
-        usleep(500);
-#endif
-
         initialized_ = true;
 
         // Connection just came up – make sure the first heartbeat reports no ball detected.
@@ -105,68 +126,70 @@ namespace golf_sim {
         return true;
     }
 
-    void GsSimSocketInterface::ReceiveSocketData() {
+    std::shared_ptr<tcp::socket> GsSimSocketInterface::GetSocket() {
+        boost::lock_guard<boost::mutex> lock(socket_mutex_);
+        return socket_;
+    }
 
-        receive_thread_exited_ = false;
+    void GsSimSocketInterface::StartReceive(std::shared_ptr<tcp::socket> socket) {
 
-        static std::array<char, 2000> buf;
-        boost::system::error_code error;
-        std::string received_data_string;
+        read_in_progress_ = true;
 
-        while (GolfSimGlobals::golf_sim_running_)
-        {
-            // We don't want to re-enter this while we're processing
-            // a received message
-            // boost::lock_guard<boost::mutex> lock(sim_socket_receive_mutex_);
+        GS_LOG_TRACE_MSG(trace, "Waiting to receive data from SimSocketserver.");
 
-            GS_LOG_TRACE_MSG(trace, "Waiting to receive data from SimSocketserver.");
+        socket->async_read_some(boost::asio::buffer(receive_buffer_),
+            [this, socket](const boost::system::error_code& error, size_t length) {
+                OnDataReceived(socket, error, length);
+            });
+    }
 
-            size_t len = 0;
+    void GsSimSocketInterface::OnDataReceived(std::shared_ptr<tcp::socket> socket, const boost::system::error_code& error, size_t length) {
 
-            try {
-                // Read_some should be blocking, but if the socket has closed, it will return immediately
-                len = socket_->read_some(boost::asio::buffer(buf), error);
+        // DeInitialize has already let go of this connection
+        if (socket != GetSocket()) {
+            read_in_progress_ = false;
+            return;
+        }
+
+        if (error || length == 0) {
+            if (error == boost::asio::error::eof) {
+                // Connection closed cleanly by peer.
+                GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface::OnDataReceived Received EOF");
             }
-            catch (std::exception& e)
-            {
-                GS_LOG_MSG(error, "GsSimSocketInterface::ReceiveSocketData failed to read from socket - Error was: " + std::string(e.what()));
+            else {
+                GS_LOG_MSG(warning, "GsSimSocketInterface::OnDataReceived failed to read from socket - Error was: " + error.message() +
+                                    ".  Will attempt to re-initialize");
             }
 
-            if (len == 0) {
-                GS_LOG_MSG(warning, "Received 0-length message from server. Will attempt to re-initialize");
-                /// TBD - Are we sure we want to exit?
-                receive_thread_exited_ = true;
-                return; 
-            }
+            receiver_stopped_ = true;
+            read_in_progress_ = false;
+            StartBackgroundReconnect();
+            return;
+        }
 
-            // Null-terminate the string
-            buf[len] = (char)0;
-            received_data_string = std::string(buf.data());
-            GS_LOG_TRACE_MSG(trace, "   Read some data (" + std::to_string(len) + " bytes) : " + received_data_string);
+        GS_LOG_TRACE_MSG(trace, "   Read some data (" + std::to_string(length) + " bytes)");
 
-            if (error == boost::asio::error::eof) {
-                // Connection closed cleanly by peer.  
-                // In this case, we may want to de-initialize
-                GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface::ReceiveSocketData Received EOF");
-                receive_thread_exited_ = true;
-                return;
-            }
-            else if (error) {
-                GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface::ReceiveSocketData Received Error");
-                throw boost::system::system_error(error); // Some other error.
-            }
-            // Derived classes will, for example, parse the message and inject any
-            // relevant events into the FSM.
+        framer_.Append(receive_buffer_.data(), length);
 
+        // Derived classes will, for example, parse the message and inject any
+        // relevant events into the FSM.
+        std::string received_data_string;
+
+        while (framer_.NextMessage(received_data_string)) {
             GS_LOG_TRACE_MSG(trace, "Received SimSocket message of: \n" + received_data_string);
 
+            // One bad message does not stop the messages after it
             if (!ProcessReceivedData(received_data_string)) {
-                GS_LOG_MSG(error, "Failed GsSimSocketInterface::ReceiveSocketData - Could process data: " + received_data_string);
-                return;
+                GS_LOG_MSG(error, "Failed GsSimSocketInterface::OnDataReceived - Could process data: " + received_data_string);
             }
         }
 
-        GS_LOG_MSG(error, "GsSimSocketInterface::ReceiveSocketData Exiting");
+        if (!GolfSimGlobals::golf_sim_running_) {
+            read_in_progress_ = false;
+            return;
+        }
+
+        StartReceive(socket);
     }
 
     void GsSimSocketInterface::DeInitialize() {
@@ -174,26 +197,52 @@ namespace golf_sim {
         GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface::DeInitialize() called.");
         try {
 
-            if (receiver_thread_ != nullptr) {
-                /***  TBD - Was locking up
-                GS_LOG_TRACE_MSG(trace, "Waiting for join of receiver_thread_.");
-                receiver_thread_->join();
-                receiver_thread_.release();
-                delete receiver_thread_.get();
-                */
-                GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface::DeInitialize() killing receive thread.");
+            // The reconnect thread de-initializes the old connection itself
+            if (!on_reconnect_thread) {
+                StopBackgroundReconnect();
+            }
+
+            StopAsyncSender();
 
-#ifdef __unix__  // Ignore in Windows environment
-                pthread_cancel(receiver_thread_.get()->native_handle());
-#endif
-                receiver_thread_ = nullptr;
+            std::shared_ptr<tcp::socket> socket;
+            {
+                boost::lock_guard<boost::mutex> lock(socket_mutex_);
+                socket.swap(socket_);
+            }
+
+            if (socket != nullptr) {
+                GsSimSocketReactor& reactor = GsSimSocketReactor::Instance();
+
+                // Closed on the reactor thread, like every other operation on the socket.  The pending
+                // read (and any write) then completes with operation_aborted.
+                boost::asio::post(reactor.GetIoContext(), [socket]() {
+                    boost::system::error_code ignored_error;
+                    socket->shutdown(tcp::socket::shutdown_both, ignored_error);
+                    socket->close(ignored_error);
+                });
+
+                // Those handlers use this object, which may be deleted as soon as this returns
+                if (!reactor.OnReactorThread()) {
+                    for (int waited_ms = 0; waited_ms < kSimSocketCloseTimeoutMs; waited_ms += 10) {
+                        {
+                            boost::lock_guard<boost::mutex> lock(send_queue_mutex_);
+                            if (!read_in_progress_ && !write_in_progress_) {
+                                break;
+                            }
+                        }
+                        usleep(10 * 1000);
+                    }
+
+                    if (read_in_progress_) {
+                        GS_LOG_MSG(warning, "GsSimSocketInterface::DeInitialize() timed out waiting for the socket to close.");
+                    }
+                }
             }
 
-            // TBD - not sure how to deinitialize the TCP socket stuff
-            delete socket_;
-            socket_ = nullptr;
-            delete io_context_;
-            io_context_ = nullptr;
+            {
+                boost::lock_guard<boost::mutex> lock(send_queue_mutex_);
+                send_queue_.clear();
+            }
 
             GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface::DeInitialize() completed.");
         }
@@ -205,20 +254,218 @@ namespace golf_sim {
         initialized_ = false;
     }
 
+    void GsSimSocketInterface::StartAsyncSender() {
+
+        if (async_sender_running_) {
+            return;
+        }
+
+        {
+            boost::lock_guard<boost::mutex> lock(send_queue_mutex_);
+            send_queue_.clear();
+            write_in_progress_ = false;
+        }
+
+        async_sender_running_ = true;
+
+        GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface started the asynchronous sender.");
+    }
+
+    void GsSimSocketInterface::StopAsyncSender() {
+
+        if (!async_sender_running_) {
+            return;
+        }
+
+        for (int waited_ms = 0; waited_ms < kSimSocketDrainTimeoutMs; waited_ms += 10) {
+            {
+                boost::lock_guard<boost::mutex> lock(send_queue_mutex_);
+                if (send_queue_.empty() && !write_in_progress_) {
+                    break;
+                }
+            }
+            usleep(10 * 1000);
+        }
+
+        async_sender_running_ = false;
+
+        boost::lock_guard<boost::mutex> lock(send_queue_mutex_);
+
+        GS_LOG_MSG(info, "GsSimSocketInterface asynchronous sender stopped.  Messages written: " + std::to_string(messages_written_) +
+            ", dropped: " + std::to_string(messages_dropped_ + (long)send_queue_.size()) +
+            ", heartbeats dropped: " + std::to_string(heartbeats_dropped_) +
+            ", maximum send latency: " + std::to_string(max_send_latency_us_ / 1000.0) + "ms");
+
+        // Anything still being written is abandoned when DeInitialize closes the socket
+        send_queue_.clear();
+    }
+
+    void GsSimSocketInterface::WriteNextQueuedMessage() {
+
+        boost::lock_guard<boost::mutex> lock(send_queue_mutex_);
+
+        if (write_in_progress_ || send_queue_.empty()) {
+            return;
+        }
+
+        std::shared_ptr<tcp::socket> socket = GetSocket();
+
+        if (socket == nullptr) {
+            messages_dropped_ += (long)send_queue_.size();
+            send_queue_.clear();
+            return;
+        }
+
+        // Moved out of the queue so that the buffer stays put while the queue changes
+        message_being_written_ = std::move(send_queue_.front());
+        send_queue_.pop_front();
+        write_in_progress_ = true;
+
+        // async_write (unlike write_some) does not complete until the whole message is written
+        boost::asio::async_write(*socket, boost::asio::buffer(message_being_written_.data),
+            [this, socket](const boost::system::error_code& error, size_t bytes_written) {
+                OnMessageWritten(error, bytes_written);
+            });
+    }
+
+    void GsSimSocketInterface::OnMessageWritten(const boost::system::error_code& error, size_t bytes_written) {
+
+        {
+            boost::lock_guard<boost::mutex> lock(send_queue_mutex_);
+
+            write_in_progress_ = false;
+
+            if (error == boost::asio::error::operation_aborted) {
+                // DeInitialize closed the socket
+                return;
+            }
+
+            if (error) {
+                GS_LOG_MSG(error, "GsSimSocketInterface could not write to the socket - Error was: " + error.message());
+
+                // The next SendResults will re-initialize the connection, as it does when the receiver stops
+                receiver_stopped_ = true;
+                messages_dropped_ += 1 + (long)send_queue_.size();
+                GsMetrics::Increment(GsMetrics::Counter::kDroppedSimMessages, 1 + send_queue_.size());
+                send_queue_.clear();
+                return;
+            }
+
+            long latency_us = (long)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - message_being_written_.queued_time).count();
+
+            if (message_being_written_.shot_number > 0) {
+                MarkShotDelivered(message_being_written_.shot_number);
+            }
+
+            messages_written_++;
+            max_send_latency_us_ = std::max(max_send_latency_us_, latency_us);
+
+            GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface wrote " + std::to_string(bytes_written) + " bytes " +
+                std::to_string(latency_us / 1000.0) + "ms after the message was queued.");
+        }
+
+        WriteNextQueuedMessage();
+    }
+
     int GsSimSocketInterface::SendSimMessage(const std::string& message) {
+        return SendSimMessage(message, false);
+    }
+
+    int GsSimSocketInterface::SendSimMessage(const std::string& message, bool is_heartbeat) {
+        return SendSimMessage(message, is_heartbeat, 0);
+    }
+
+    int GsSimSocketInterface::SendSimMessage(const std::string& message, bool is_heartbeat, long shot_number) {
         size_t write_length = 0;
         boost::system::error_code error;
 
         GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface::SendSimMessage - Message was: " + message);
 
+        GsSimSocketReactor& reactor = GsSimSocketReactor::Instance();
+
+        // A reply from ProcessReceivedData is queued too, as the reactor thread cannot wait for its own write
+        if (async_sender_running_ || reactor.OnReactorThread()) {
+            boost::lock_guard<boost::mutex> lock(send_queue_mutex_);
+
+            // Only the latest (not yet written) heartbeat matters
+            if (is_heartbeat) {
+                for (OutgoingMessage& queued_message : send_queue_) {
+                    if (queued_message.is_heartbeat) {
+                        queued_message.data = message;
+                        return (int)message.size();
+                    }
+                }
+            }
+
+            if ((int)send_queue_.size() >= std::max(1, kSimSocketMaxQueuedMessages)) {
+                // A heartbeat never pushes out a shot.  There is at most one queued heartbeat,
+                // as they are coalesced above.
+                if (is_heartbeat) {
+                    GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface::SendSimMessage - the send queue is full.  Dropping the heartbeat.");
+                    heartbeats_dropped_++;
+                    GsMetrics::Increment(GsMetrics::Counter::kDroppedSimHeartbeats);
+                    return (int)message.size();
+                }
+
+                auto queued_heartbeat = std::find_if(send_queue_.begin(), send_queue_.end(),
+                    [](const OutgoingMessage& queued_message) { return queued_message.is_heartbeat; });
+
+                if (queued_heartbeat != send_queue_.end()) {
+                    GS_LOG_TRACE_MSG(trace, "GsSimSocketInterface::SendSimMessage - the send queue is full.  Dropping the queued heartbeat.");
+                    send_queue_.erase(queued_heartbeat);
+                    heartbeats_dropped_++;
+                    GsMetrics::Increment(GsMetrics::Counter::kDroppedSimHeartbeats);
+                }
+                else {
+                    GS_LOG_MSG(warning, "GsSimSocketInterface::SendSimMessage - the simulator is not keeping up.  Dropping the oldest queued shot.");
+                    send_queue_.pop_front();
+                    messages_dropped_++;
+                    GsMetrics::Increment(GsMetrics::Counter::kDroppedSimMessages);
+                }
+            }
+
+            send_queue_.push_back(OutgoingMessage{ message, is_heartbeat, std::chrono::steady_clock::now(), shot_number });
+
+            boost::asio::post(reactor.GetIoContext(), [this]() { WriteNextQueuedMessage(); });
+
+            return (int)message.size();
+        }
+
         // We don't want to re-enter this while we're processing
         // a received message
         boost::lock_guard<boost::mutex> lock(sim_socket_send_mutex_);
 
+        std::shared_ptr<tcp::socket> socket = GetSocket();
 
-        try {
+        if (socket == nullptr) {
+            GS_LOG_MSG(error, "GsSimSocketInterface::SendSimMessage called without a connection.");
+            return -1;
+        }
+
+        // Still written on the reactor thread, so that the socket is only ever used there, but
+        // this waits for the write to finish.  The handler holds its own copy of everything it uses.
+        struct PendingWrite {
+            std::string data;
+            std::promise<size_t> written;
+        };
 
-            write_length = socket_->write_some(boost::asio::buffer(message), error);
+        std::shared_ptr<PendingWrite> pending_write = std::make_shared<PendingWrite>();
+        pending_write->data = message;
+        std::future<size_t> written = pending_write->written.get_future();
+
+        try {
+            boost::asio::post(reactor.GetIoContext(), [socket, pending_write]() {
+                boost::asio::async_write(*socket, boost::asio::buffer(pending_write->data),
+                    [pending_write](const boost::system::error_code& error, size_t bytes_written) {
+                        if (error) {
+                            GS_LOG_MSG(error, "GsSimSocketInterface::SendSimMessage - Error was: " + error.message());
+                        }
+                        pending_write->written.set_value(bytes_written);
+                    });
+            });
+
+            write_length = written.get();
         }
         catch (std::exception& e)
         {
@@ -226,18 +473,178 @@ namespace golf_sim {
             return -2;
         }
 
+        if (shot_number > 0 && write_length == message.size()) {
+            MarkShotDelivered(shot_number);
+        }
+
         return write_length;
     }
 
+    void GsSimSocketInterface::CacheShot(const GsResults& results) {
+
+        if (kSimSocketResultCacheSize <= 0 || results.result_message_is_keepalive_ || results.shot_number_ <= 0) {
+            return;
+        }
+
+        boost::lock_guard<boost::mutex> lock(shot_cache_mutex_);
+
+        // E.g., a shot that is being re-sent
+        for (const CachedShot& cached_shot : shot_cache_) {
+            if (cached_shot.results.shot_number_ == results.shot_number_) {
+                return;
+            }
+        }
+
+        shot_cache_.push_back(CachedShot{ results, std::chrono::steady_clock::now(), false });
+
+        while ((int)shot_cache_.size() > kSimSocketResultCacheSize) {
+            shot_cache_.pop_front();
+        }
+    }
+
+    void GsSimSocketInterface::MarkShotDelivered(long shot_number) {
+
+        boost::lock_guard<boost::mutex> lock(shot_cache_mutex_);
+
+        for (CachedShot& cached_shot : shot_cache_) {
+            if (cached_shot.results.shot_number_ == shot_number) {
+                cached_shot.delivered = true;
+                return;
+            }
+        }
+    }
+
+    bool GsSimSocketInterface::BackgroundReconnectInProgress() const {
+        return reconnect_in_progress_ && !on_reconnect_thread;
+    }
+
+    bool GsSimSocketInterface::ReconnectInBackground(const GsResults& results) {
+
+        if (kSimSocketResultCacheSize <= 0) {
+            return false;
+        }
+
+        CacheShot(results);
+
+        if (!results.result_message_is_keepalive_) {
+            GS_LOG_MSG(warning, "GsSimSocketInterface - the simulator is not connected.  Shot " + std::to_string(results.shot_number_) +
+                                " will be sent once it has reconnected.");
+        }
+
+        StartBackgroundReconnect();
+
+        return true;
+    }
+
+    void GsSimSocketInterface::StartBackgroundReconnect() {
+
+        // On the reconnect thread, the loop that is already running deals with the connection
+        if (kSimSocketResultCacheSize <= 0 || !GolfSimGlobals::golf_sim_running_ || on_reconnect_thread || reconnect_in_progress_) {
+            return;
+        }
+
+        boost::lock_guard<boost::mutex> lock(reconnect_thread_mutex_);
+
+        if (reconnect_in_progress_) {
+            return;
+        }
+
+        // The last reconnect has finished, but its thread has not been joined yet
+        if (reconnect_thread_ != nullptr) {
+            reconnect_thread_->join();
+            reconnect_thread_ = nullptr;
+        }
+
+        reconnect_exiting_ = false;
+        reconnect_in_progress_ = true;
+        reconnect_thread_ = std::unique_ptr<std::thread>(new std::thread(&GsSimSocketInterface::ReconnectAndResend, this));
+    }
+
+    void GsSimSocketInterface::StopBackgroundReconnect() {
+
+        boost::lock_guard<boost::mutex> lock(reconnect_thread_mutex_);
+
+        if (reconnect_thread_ == nullptr) {
+            return;
+        }
+
+        reconnect_exiting_ = true;
+        reconnect_thread_->join();
+        reconnect_thread_ = nullptr;
+        reconnect_in_progress_ = false;
+    }
+
+    void GsSimSocketInterface::ReconnectAndResend() {
+
+        on_reconnect_thread = true;
+
+        GS_LOG_MSG(info, "GsSimSocketInterface - reconnecting to " + socket_connect_address_ + ":" + socket_connect_port_ + " in the background.");
+
+        bool connected = false;
+
+        while (GolfSimGlobals::golf_sim_running_ && !reconnect_exiting_) {
+            DeInitialize();
+
+            if (Initialize()) {
+                connected = true;
+                break;
+            }
+
+            for (int waited_ms = 0; waited_ms < kSimSocketReconnectIntervalMs && GolfSimGlobals::golf_sim_running_ && !reconnect_exiting_; waited_ms += 50) {
+                usleep(50 * 1000);
+            }
+        }
+
+        if (connected) {
+            std::vector<GsResults> shots_to_resend;
+            {
+                boost::lock_guard<boost::mutex> lock(shot_cache_mutex_);
+
+                const auto now = std::chrono::steady_clock::now();
+
+                for (const CachedShot& cached_shot : shot_cache_) {
+                    const long age_ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(now - cached_shot.sent_time).count();
+
+                    if (!cached_shot.delivered && age_ms <= kSimSocketResendMaxAgeMs) {
+                        shots_to_resend.push_back(cached_shot.results);
+                    }
+                }
+            }
+
+            for (const GsResults& results : shots_to_resend) {
+                GS_LOG_MSG(info, "GsSimSocketInterface - re-sending shot " + std::to_string(results.shot_number_) + ".");
+
+                if (SendResults(results)) {
+                    shots_resent_++;
+                }
+                else {
+                    GS_LOG_MSG(warning, "GsSimSocketInterface - could not re-send shot " + std::to_string(results.shot_number_) + ".");
+                }
+            }
+
+            GS_LOG_MSG(info, "GsSimSocketInterface - reconnected.  Shots re-sent so far: " + std::to_string(shots_resent_) + ".");
+        }
+
+        reconnect_in_progress_ = false;
+    }
+
 
     bool GsSimSocketInterface::SendResults(const GsResults& results) {
 
+        if (BackgroundReconnectInProgress()) {
+            return ReconnectInBackground(results);
+        }
+
         if (!initialized_) {
             GS_LOG_MSG(error, "GsSimSocketInterface::SendResults called before the interface was intialized.");
             return false;
         }
 
-        if (receive_thread_exited_) {
+        if (receiver_stopped_) {
+            if (ReconnectInBackground(results)) {
+                return true;
+            }
+
             GS_LOG_MSG(error, "GsSimSocketInterface::SendResults called before the interface was intialized - trying to re-initialize.");
             // If we ended the receive thread, try re-initializing the connection
             DeInitialize();
@@ -252,12 +659,10 @@ namespace golf_sim {
         size_t write_length = -1;
 
         try {
-            static std::array<char, 2000> buf;
-            boost::system::error_code error;
-
             std::string results_msg = GenerateResultsDataToSend(results);
 
-            write_length = SendSimMessage(results_msg);
+            CacheShot(results);
+            write_length = SendSimMessage(results_msg, false, results.shot_number_);
         }
         catch (std::exception& e)
         {
@@ -5,16 +5,26 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <vector>
+
 #include <boost/asio.hpp>
 #include <boost/thread.hpp>
 
 #include "gs_results.h"
 #include "gs_sim_interface.h"
+#include "gs_sim_socket_reactor.h"
 
 using namespace boost::asio;
 using ip::tcp;
 
-// Base class for representing and transferring Golf Sim results over sockets
+// Base class for representing and transferring Golf Sim results over sockets.  The socket is read
+// and written on the shared GsSimSocketReactor thread, and each complete JSON message that is
+// received is passed to ProcessReceivedData there.
 
 namespace golf_sim {
 
@@ -35,35 +45,137 @@ namespace golf_sim {
 
         virtual bool SendResults(const GsResults& results);
 
-        virtual void ReceiveSocketData();
-
     public:
 
         std::string socket_connect_address_;
         std::string socket_connect_port_;
 
+        // If set, SendSimMessage only queues the message, and the reactor thread writes it
+        // to the socket.  A slow or stalled simulator PC then cannot hold up the FSM.
+        static bool kSimSocketAsyncSend;
+
+        // Limit on the messages waiting to be written when kSimSocketAsyncSend is set.
+        // Queued heartbeats are always coalesced into the latest one.  When the queue is
+        // full, a new heartbeat is dropped, and a new shot evicts the queued heartbeat
+        // or, if there is none, the oldest queued shot.
+        static int kSimSocketMaxQueuedMessages;
+
+        // If more than 0, the last kSimSocketResultCacheSize shots are kept, each with its shot
+        // number.  When the connection drops, the simulator is reconnected on a separate thread
+        // (every kSimSocketReconnectIntervalMs until it succeeds) instead of on the FSM thread,
+        // and the shots that were never fully written to the simulator, and that are no older
+        // than kSimSocketResendMaxAgeMs, are then sent again, oldest first.
+        static int kSimSocketResultCacheSize;
+        static int kSimSocketReconnectIntervalMs;
+        static int kSimSocketResendMaxAgeMs;
+
     protected:
 
         virtual std::string GenerateResultsDataToSend(const GsResults& results);
         
+        // Called on the reactor thread once per received message, so must not block for long
         virtual bool ProcessReceivedData(const std::string received_data);
 
-        // Default behavior here is just to send the message to the socket and 
-        // return the number of bytes written
+        // Default behavior here is just to send the message to the socket and
+        // return the number of bytes written (or queued, if kSimSocketAsyncSend is set
+        // or if called from ProcessReceivedData)
         virtual int SendSimMessage(const std::string& message);
 
-    protected:
+        // A heartbeat may be replaced by a later heartbeat if it has not been written yet
+        int SendSimMessage(const std::string& message, bool is_heartbeat);
+
+        // If shot_number is more than 0, that cached shot is marked as delivered once the
+        // whole message has been written.  Used for the last message of each shot.
+        int SendSimMessage(const std::string& message, bool is_heartbeat, long shot_number);
+
+        // Keeps the shot (but not a keep-alive) for a possible re-send.  Does nothing if the
+        // shot is already cached or if kSimSocketResultCacheSize is 0.
+        void CacheShot(const GsResults& results);
+
+        // To be called by SendResults when the connection is down.  Returns false if the
+        // background reconnect is not enabled, in which case the caller must reconnect itself.
+        // Otherwise, caches the shot, makes sure the reconnect thread is running, and returns true.
+        bool ReconnectInBackground(const GsResults& results);
+
+        // True while the reconnect thread owns the connection (except on that thread itself)
+        bool BackgroundReconnectInProgress() const;
+
+    private:
+
+        struct OutgoingMessage {
+            std::string data;
+            bool is_heartbeat = false;
+            std::chrono::steady_clock::time_point queued_time;
+            long shot_number = 0;
+        };
+
+        void StartAsyncSender();
+        void StopAsyncSender();
+
+        // Only called on the reactor thread
+        void WriteNextQueuedMessage();
+        void OnMessageWritten(const boost::system::error_code& error, size_t bytes_written);
+        void StartReceive(std::shared_ptr<tcp::socket> socket);
+        void OnDataReceived(std::shared_ptr<tcp::socket> socket, const boost::system::error_code& error, size_t length);
+
+        // nullptr if not connected
+        std::shared_ptr<tcp::socket> GetSocket();
 
-        tcp::socket* socket_ = nullptr;
-        boost::asio::io_context* io_context_ = nullptr;
+        struct CachedShot {
+            GsResults results;
+            std::chrono::steady_clock::time_point sent_time;
+            bool delivered = false;
+        };
 
-        std::unique_ptr<std::thread> receiver_thread_ = nullptr;
+        void MarkShotDelivered(long shot_number);
 
-        // TBD - Is this thread safe?
-        bool receive_thread_exited_ = false;
+        void StartBackgroundReconnect();
+        void StopBackgroundReconnect();
+
+        // Runs on the reconnect thread
+        void ReconnectAndResend();
+
+    protected:
+
+        // Set when the simulator closes the connection or a read or write fails
+        std::atomic<bool> receiver_stopped_{ false };
 
         boost::mutex sim_socket_receive_mutex_;
         boost::mutex sim_socket_send_mutex_;
+
+    private:
+
+        // Each pending operation holds its own reference, so the socket outlives them.
+        // Replaced (under socket_mutex_) by Initialize and DeInitialize.
+        std::shared_ptr<tcp::socket> socket_;
+        boost::mutex socket_mutex_;
+
+        // Only used on the reactor thread while a read is pending
+        std::array<char, 2000> receive_buffer_;
+        GsSimMessageFramer framer_;
+        std::atomic<bool> read_in_progress_{ false };
+
+        std::atomic<bool> async_sender_running_{ false };
+
+        // Guards everything below
+        boost::mutex send_queue_mutex_;
+        std::deque<OutgoingMessage> send_queue_;
+        OutgoingMessage message_being_written_;
+        bool write_in_progress_ = false;
+
+        long messages_written_ = 0;
+        long messages_dropped_ = 0;
+        long heartbeats_dropped_ = 0;
+        long max_send_latency_us_ = 0;
+
+        boost::mutex shot_cache_mutex_;
+        std::deque<CachedShot> shot_cache_;
+
+        std::unique_ptr<std::thread> reconnect_thread_ = nullptr;
+        std::atomic<bool> reconnect_in_progress_{ false };
+        std::atomic<bool> reconnect_exiting_{ false };
+        boost::mutex reconnect_thread_mutex_;
+        long shots_resent_ = 0;
     };
 
 }
@@ -0,0 +1,150 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include "logging_tools.h"
+#include "gs_trace_zones.h"
+
+#include "gs_sim_socket_reactor.h"
+
+
+namespace golf_sim {
+
+    GsSimSocketReactor& GsSimSocketReactor::Instance() {
+        static GsSimSocketReactor reactor;
+        return reactor;
+    }
+
+    GsSimSocketReactor::~GsSimSocketReactor() {
+        // Destroying a still-joinable thread would terminate the process
+        Stop();
+    }
+
+    boost::asio::io_context& GsSimSocketReactor::GetIoContext() {
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (reactor_thread_ != nullptr) {
+            return io_context_;
+        }
+
+        io_context_.restart();
+
+        // Keeps run() from returning while no socket has anything pending
+        work_guard_ = std::make_unique<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(
+            boost::asio::make_work_guard(io_context_));
+
+        reactor_thread_ = std::make_unique<std::thread>([this]() {
+            GS_TRACE_THREAD_NAME("SimReactor");
+            reactor_thread_id_ = std::this_thread::get_id();
+
+            // A handler that throws only loses its own operation, not the other connections
+            while (true) {
+                try {
+                    io_context_.run();
+                    break;
+                }
+                catch (std::exception& e) {
+                    GS_LOG_MSG(error, "GsSimSocketReactor - a socket handler failed - Error was: " + std::string(e.what()));
+                }
+            }
+
+            reactor_thread_id_ = std::thread::id();
+        });
+
+        GS_LOG_TRACE_MSG(trace, "GsSimSocketReactor started.");
+
+        return io_context_;
+    }
+
+    bool GsSimSocketReactor::OnReactorThread() const {
+        return reactor_thread_id_ == std::this_thread::get_id();
+    }
+
+    void GsSimSocketReactor::Stop() {
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (reactor_thread_ == nullptr) {
+            return;
+        }
+
+        if (OnReactorThread()) {
+            GS_LOG_MSG(error, "GsSimSocketReactor::Stop called from a socket handler.  Not stopping.");
+            return;
+        }
+
+        work_guard_.reset();
+        io_context_.stop();
+        reactor_thread_->join();
+        reactor_thread_ = nullptr;
+    }
+
+
+    void GsSimMessageFramer::Append(const char* data, size_t length) {
+        pending_.append(data, length);
+    }
+
+    bool GsSimMessageFramer::NextMessage(std::string& message) {
+
+        // Drop anything before the next object
+        if (brace_depth_ == 0 && scan_position_ == 0) {
+            const size_t object_start = pending_.find('{');
+
+            if (object_start == std::string::npos) {
+                pending_.clear();
+                return false;
+            }
+
+            pending_.erase(0, object_start);
+        }
+
+        for (; scan_position_ < pending_.size(); scan_position_++) {
+            const char c = pending_[scan_position_];
+
+            if (in_string_) {
+                if (escaped_) {
+                    escaped_ = false;
+                }
+                else if (c == '\\') {
+                    escaped_ = true;
+                }
+                else if (c == '"') {
+                    in_string_ = false;
+                }
+                continue;
+            }
+
+            if (c == '"') {
+                in_string_ = true;
+            }
+            else if (c == '{') {
+                brace_depth_++;
+            }
+            else if (c == '}' && --brace_depth_ == 0) {
+                message = pending_.substr(0, scan_position_ + 1);
+                pending_.erase(0, scan_position_ + 1);
+                scan_position_ = 0;
+                return true;
+            }
+        }
+
+        if (pending_.size() > kMaxMessageLength) {
+            GS_LOG_MSG(warning, "GsSimMessageFramer - discarding " + std::to_string(pending_.size()) +
+                                " bytes without a complete message.");
+            Clear();
+        }
+
+        return false;
+    }
+
+    void GsSimMessageFramer::Clear() {
+        pending_.clear();
+        scan_position_ = 0;
+        brace_depth_ = 0;
+        in_string_ = false;
+        escaped_ = false;
+    }
+
+}
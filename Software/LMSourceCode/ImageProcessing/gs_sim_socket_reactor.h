@@ -0,0 +1,82 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// One boost::asio io_context, run on a single thread, for all of the simulator sockets (GSPro,
+// E6 and the GSPro test server).  Each connection reads with async_read_some into its own
+// buffer, and the asynchronous sends (kSimSocketAsyncSend) are written on the same thread, so that
+// there is one thread for the simulators rather than a receiver and a sender per connection,
+// and a connection that stalls only leaves its own operations pending.
+//
+// The handlers must be quick, because they share the thread - e.g., parse a message and apply it,
+// or queue a reply.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+namespace golf_sim {
+
+    class GsSimSocketReactor {
+
+    public:
+        // The shared reactor, created on first use
+        static GsSimSocketReactor& Instance();
+
+        ~GsSimSocketReactor();
+
+        // Starts the reactor thread if it is not already running
+        boost::asio::io_context& GetIoContext();
+
+        // True iff called from a handler on the reactor thread
+        bool OnReactorThread() const;
+
+        // Stops the io_context and joins the thread.  Any handlers that are still pending are not
+        // called.  The sockets should all have been closed by now.  GetIoContext starts it again.
+        void Stop();
+
+    private:
+        GsSimSocketReactor() = default;
+
+        boost::asio::io_context io_context_;
+        std::unique_ptr<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> work_guard_;
+        std::unique_ptr<std::thread> reactor_thread_;
+        std::atomic<std::thread::id> reactor_thread_id_{ std::thread::id() };
+        std::mutex mutex_;
+    };
+
+
+    // Splits a TCP byte stream into the JSON objects that the simulators send, which may arrive
+    // with several in one read or one split across reads.  Bytes outside of an object (e.g., the
+    // newlines that some simulators put between messages) are skipped.
+    class GsSimMessageFramer {
+
+    public:
+        // Longest message that will be waited for.  Anything longer is discarded.
+        static const size_t kMaxMessageLength = 64 * 1024;
+
+        void Append(const char* data, size_t length);
+
+        // Sets message to the next complete object, if there is one
+        bool NextMessage(std::string& message);
+
+        void Clear();
+
+    private:
+        std::string pending_;
+
+        // Where the scan of pending_ left off, and its state there
+        size_t scan_position_ = 0;
+        int brace_depth_ = 0;
+        bool in_string_ = false;
+        bool escaped_ = false;
+    };
+
+}
@@ -0,0 +1,318 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_camera.h"
+#include "gs_v4l2_subdev.h"
+
+#include "gs_startup_cache.h"
+
+namespace golf_sim {
+
+    std::string GsStartupCache::kStartupCacheDirectory;
+
+    std::mutex GsStartupCache::mutex_;
+    std::string GsStartupCache::hardware_fingerprint_;
+    bool GsStartupCache::camera_info_loaded_ = false;
+    std::map<GsStartupCache::CameraInfoKey, GsStartupCache::CameraInfo> GsStartupCache::camera_info_;
+
+    static const std::string kCameraInfoFileName = "camera_modes.txt";
+    static const std::string kPerformanceProfileFileName = "performance_profile.txt";
+
+
+    static uint64_t HashBytes(const void* data, size_t length, uint64_t hash = 14695981039346656037ULL) {
+        const unsigned char* bytes = (const unsigned char*)data;
+        for (size_t i = 0; i < length; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    static uint64_t HashMat(const cv::Mat& mat, uint64_t hash) {
+        const cv::Mat continuous = mat.isContinuous() ? mat : mat.clone();
+        const int header[3] = { continuous.rows, continuous.cols, continuous.type() };
+        hash = HashBytes(header, sizeof(header), hash);
+        return HashBytes(continuous.data, continuous.total() * continuous.elemSize(), hash);
+    }
+
+    // Written under a temporary name so that a reader never sees half of a file
+    static bool ReplaceFile(const std::string& file_name, const std::string& contents) {
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(file_name).parent_path(), error);
+
+        const std::string temporary_file_name = file_name + ".tmp";
+        {
+            std::ofstream file(temporary_file_name, std::ios::binary);
+            file.write(contents.data(), (std::streamsize)contents.size());
+
+            if (!file) {
+                GS_LOG_MSG(warning, "Could not write startup cache file " + temporary_file_name);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary_file_name, file_name, error);
+        if (error) {
+            GS_LOG_MSG(warning, "Could not write startup cache file " + file_name + ": " + error.message());
+            return false;
+        }
+
+        return true;
+    }
+
+    static void WriteMat(std::ostringstream& s, const cv::Mat& mat) {
+        const cv::Mat continuous = mat.isContinuous() ? mat : mat.clone();
+        const int header[3] = { continuous.rows, continuous.cols, continuous.type() };
+        s.write((const char*)header, sizeof(header));
+        s.write((const char*)continuous.data, (std::streamsize)(continuous.total() * continuous.elemSize()));
+    }
+
+    static bool ReadMat(std::ifstream& file, cv::Mat& mat) {
+        int header[3] = { 0, 0, 0 };
+        if (!file.read((char*)header, sizeof(header)) || header[0] <= 0 || header[1] <= 0) {
+            return false;
+        }
+        mat.create(header[0], header[1], header[2]);
+        return (bool)file.read((char*)mat.data, (std::streamsize)(mat.total() * mat.elemSize()));
+    }
+
+
+    // Caller must hold mutex_
+    const std::string& GsStartupCache::GetHardwareFingerprint() {
+
+        if (!hardware_fingerprint_.empty()) {
+            return hardware_fingerprint_;
+        }
+
+        std::ostringstream s;
+        s << "v1"
+          << ",pi" << (int)GolfSimConfiguration::GetPiModel()
+          << ",slot1:" << (int)GolfSimCamera::kSystemSlot1CameraType << "/" << (int)GolfSimCamera::kSystemSlot1LensType
+          << ",slot2:" << (int)GolfSimCamera::kSystemSlot2CameraType << "/" << (int)GolfSimCamera::kSystemSlot2LensType;
+
+        std::vector<GsV4l2Subdev::CameraLocation> locations;
+        GsV4l2Subdev::GetCameraLocations(locations);
+
+        for (const GsV4l2Subdev::CameraLocation& location : locations) {
+            s << ",media" << location.media_number << ":" << location.entity_name << "@" << location.subdev_path;
+        }
+
+        hardware_fingerprint_ = s.str();
+
+        GS_LOG_TRACE_MSG(trace, "GsStartupCache - hardware fingerprint is " + hardware_fingerprint_);
+
+        return hardware_fingerprint_;
+    }
+
+
+    // Caller must hold mutex_
+    void GsStartupCache::LoadCameraInfo() {
+
+        if (camera_info_loaded_) {
+            return;
+        }
+        camera_info_loaded_ = true;
+
+        std::ifstream file((std::filesystem::path(kStartupCacheDirectory) / kCameraInfoFileName).string());
+        std::string fingerprint;
+
+        if (!std::getline(file, fingerprint)) {
+            return;
+        }
+
+        if (fingerprint != GetHardwareFingerprint()) {
+            GS_LOG_MSG(info, "GsStartupCache - the camera hardware has changed.  Ignoring the saved camera modes.");
+            return;
+        }
+
+        // camera_number,crop_width,crop_height,resolution_x,resolution_y,frame_rate
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            int camera_number = 0;
+            cv::Vec2i crop_size;
+            CameraInfo info;
+            char c1 = 0, c2 = 0, c3 = 0, c4 = 0, c5 = 0;
+
+            if ((fields >> camera_number >> c1 >> crop_size[0] >> c2 >> crop_size[1] >> c3
+                        >> info.resolution[0] >> c4 >> info.resolution[1] >> c5 >> info.frame_rate) &&
+                c1 == ',' && c2 == ',' && c3 == ',' && c4 == ',' && c5 == ',') {
+                camera_info_[{ camera_number, crop_size[0], crop_size[1] }] = info;
+            }
+        }
+    }
+
+
+    bool GsStartupCache::LookupCameraInfo(GsCameraNumber camera_number, const cv::Vec2i& crop_size,
+                                          cv::Vec2i& resolution, uint& frame_rate) {
+        if (kStartupCacheDirectory.empty()) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        LoadCameraInfo();
+
+        auto it = camera_info_.find({ (int)camera_number, crop_size[0], crop_size[1] });
+        if (it == camera_info_.end()) {
+            return false;
+        }
+
+        resolution = it->second.resolution;
+        frame_rate = it->second.frame_rate;
+
+        GS_LOG_TRACE_MSG(trace, "GsStartupCache - using the saved camera mode for camera " + std::to_string((int)camera_number) +
+                                " (" + std::to_string(resolution[0]) + "x" + std::to_string(resolution[1]) + " at " + std::to_string(frame_rate) + " fps)");
+        return true;
+    }
+
+
+    void GsStartupCache::StoreCameraInfo(GsCameraNumber camera_number, const cv::Vec2i& crop_size,
+                                         const cv::Vec2i& resolution, uint frame_rate) {
+        if (kStartupCacheDirectory.empty()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        LoadCameraInfo();
+
+        camera_info_[{ (int)camera_number, crop_size[0], crop_size[1] }] = CameraInfo{ resolution, frame_rate };
+
+        std::ostringstream s;
+        s << GetHardwareFingerprint() << "\n";
+        for (const auto& [key, info] : camera_info_) {
+            s << std::get<0>(key) << "," << std::get<1>(key) << "," << std::get<2>(key) << ","
+              << info.resolution[0] << "," << info.resolution[1] << "," << info.frame_rate << "\n";
+        }
+
+        ReplaceFile((std::filesystem::path(kStartupCacheDirectory) / kCameraInfoFileName).string(), s.str());
+    }
+
+
+    // Caller must hold mutex_
+    std::string GsStartupCache::GetUndistortionMapsFileName(const cv::Mat& calibration_matrix, const cv::Mat& distortion_vector,
+                                                            const cv::Size& image_size, bool is_mono) {
+        const std::string& fingerprint = GetHardwareFingerprint();
+        const int settings[3] = { image_size.width, image_size.height, is_mono ? 1 : 0 };
+
+        uint64_t hash = HashBytes(fingerprint.data(), fingerprint.size());
+        hash = HashBytes(settings, sizeof(settings), hash);
+        hash = HashMat(calibration_matrix, hash);
+        hash = HashMat(distortion_vector, hash);
+
+        std::ostringstream s;
+        s << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return (std::filesystem::path(kStartupCacheDirectory) / ("undistortion_maps_" + s.str() + ".bin")).string();
+    }
+
+
+    bool GsStartupCache::LoadUndistortionMaps(const cv::Mat& calibration_matrix, const cv::Mat& distortion_vector,
+                                              const cv::Size& image_size, bool is_mono,
+                                              cv::Mat& map1, cv::Mat& map2) {
+        if (kStartupCacheDirectory.empty()) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const std::string file_name = GetUndistortionMapsFileName(calibration_matrix, distortion_vector, image_size, is_mono);
+        std::ifstream file(file_name, std::ios::binary);
+
+        if (!file) {
+            return false;
+        }
+
+        cv::Mat loaded_map1;
+        cv::Mat loaded_map2;
+
+        if (!ReadMat(file, loaded_map1) || !ReadMat(file, loaded_map2) ||
+            loaded_map1.size() != image_size || loaded_map2.size() != image_size) {
+            GS_LOG_MSG(warning, "GsStartupCache - ignoring the unreadable undistortion map file " + file_name);
+            return false;
+        }
+
+        map1 = loaded_map1;
+        map2 = loaded_map2;
+
+        GS_LOG_TRACE_MSG(trace, "GsStartupCache - loaded the undistortion maps from " + file_name);
+        return true;
+    }
+
+
+    void GsStartupCache::StoreUndistortionMaps(const cv::Mat& calibration_matrix, const cv::Mat& distortion_vector,
+                                               const cv::Size& image_size, bool is_mono,
+                                               const cv::Mat& map1, const cv::Mat& map2) {
+        if (kStartupCacheDirectory.empty()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::ostringstream s;
+        WriteMat(s, map1);
+        WriteMat(s, map2);
+
+        ReplaceFile(GetUndistortionMapsFileName(calibration_matrix, distortion_vector, image_size, is_mono), s.str());
+    }
+
+
+    bool GsStartupCache::LookupPerformanceProfile(int target_ms, std::string& profile_name) {
+        if (kStartupCacheDirectory.empty()) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::ifstream file((std::filesystem::path(kStartupCacheDirectory) / kPerformanceProfileFileName).string());
+        std::string fingerprint;
+        std::string saved_target_ms;
+        std::string saved_profile_name;
+
+        if (!std::getline(file, fingerprint) || !std::getline(file, saved_target_ms) || !std::getline(file, saved_profile_name)) {
+            return false;
+        }
+
+        if (fingerprint != GetHardwareFingerprint()) {
+            GS_LOG_MSG(info, "GsStartupCache - the camera hardware has changed.  Ignoring the saved performance profile.");
+            return false;
+        }
+
+        if (saved_target_ms != std::to_string(target_ms) || saved_profile_name.empty()) {
+            return false;
+        }
+
+        profile_name = saved_profile_name;
+
+        GS_LOG_TRACE_MSG(trace, "GsStartupCache - using the saved performance profile " + profile_name);
+        return true;
+    }
+
+
+    void GsStartupCache::StorePerformanceProfile(int target_ms, const std::string& profile_name, const std::string& benchmark_results) {
+        if (kStartupCacheDirectory.empty()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // fingerprint, target, profile, then the results
+        std::ostringstream s;
+        s << GetHardwareFingerprint() << "\n" << target_ms << "\n" << profile_name << "\n" << benchmark_results << "\n";
+
+        ReplaceFile((std::filesystem::path(kStartupCacheDirectory) / kPerformanceProfileFileName).string(), s.str());
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
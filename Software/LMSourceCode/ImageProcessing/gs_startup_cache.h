@@ -0,0 +1,77 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Keeps the slowest parts of the camera bring-up across executions.  Each time a
+// camera is cropped for ball watching, libcamera has to be restarted just to learn the
+// resulting sensor mode (resolution and frame rate), and the undistortion maps are
+// rebuilt for each camera.  Both only change if the hardware or the calibration does.
+// The performance profile that GsPerformanceProfile's benchmark chose is also kept here.
+// Everything saved here is keyed by a fingerprint of the hardware (the Pi model, the
+// configured camera and lens types, and the sensors that the media controller reports),
+// so moving the cameras to other ports or swapping a camera is never served stale data.
+// An empty kStartupCacheDirectory (the default) turns the cache off.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include <opencv2/core.hpp>
+
+#include "gs_options.h"
+
+namespace golf_sim {
+
+    class GsStartupCache {
+
+    public:
+        static std::string kStartupCacheDirectory;
+
+        // The sensor mode that a given crop size resulted in the last time
+        static bool LookupCameraInfo(GsCameraNumber camera_number, const cv::Vec2i& crop_size,
+                                     cv::Vec2i& resolution, uint& frame_rate);
+        static void StoreCameraInfo(GsCameraNumber camera_number, const cv::Vec2i& crop_size,
+                                    const cv::Vec2i& resolution, uint frame_rate);
+
+        // The maps from cv::initUndistortRectifyMap for the given calibration
+        static bool LoadUndistortionMaps(const cv::Mat& calibration_matrix, const cv::Mat& distortion_vector,
+                                         const cv::Size& image_size, bool is_mono,
+                                         cv::Mat& map1, cv::Mat& map2);
+        static void StoreUndistortionMaps(const cv::Mat& calibration_matrix, const cv::Mat& distortion_vector,
+                                          const cv::Size& image_size, bool is_mono,
+                                          const cv::Mat& map1, const cv::Mat& map2);
+
+        // The profile that the benchmark chose for the given latency target, and the benchmark's
+        // results (for anyone reading the file)
+        static bool LookupPerformanceProfile(int target_ms, std::string& profile_name);
+        static void StorePerformanceProfile(int target_ms, const std::string& profile_name, const std::string& benchmark_results);
+
+    private:
+        struct CameraInfo {
+            cv::Vec2i resolution;
+            uint frame_rate = 0;
+        };
+
+        // (camera number, crop width, crop height)
+        using CameraInfoKey = std::tuple<int, int, int>;
+
+        static const std::string& GetHardwareFingerprint();
+        static void LoadCameraInfo();
+        static std::string GetUndistortionMapsFileName(const cv::Mat& calibration_matrix, const cv::Mat& distortion_vector,
+                                                       const cv::Size& image_size, bool is_mono);
+
+        static std::mutex mutex_;
+        static std::string hardware_fingerprint_;
+        static bool camera_info_loaded_;
+        static std::map<CameraInfoKey, CameraInfo> camera_info_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
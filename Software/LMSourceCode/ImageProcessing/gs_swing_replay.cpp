@@ -0,0 +1,274 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+#include "gs_ui_system.h"
+
+#include "gs_swing_replay.h"
+
+namespace golf_sim {
+
+    double GsSwingReplay::kSwingReplaySeconds = 0.0;
+    int GsSwingReplay::kSwingReplayPostHitFrames = 10;
+    std::string GsSwingReplay::kSwingReplayCodec = "h264";
+    int GsSwingReplay::kSwingReplayBitrateKbps = 0;
+    int GsSwingReplay::kSwingReplayMjpegQuality = 50;
+    int GsSwingReplay::kSwingReplayBufferMegabytes = 32;
+    std::string GsSwingReplay::kSwingReplayFileName = "SwingReplay.h264";
+
+    // Each encoded frame is kept in the buffer after one of these
+    struct FrameHeader {
+        unsigned int length;
+        bool keyframe;
+        int64_t timestamp;
+    };
+
+    std::deque<GsSwingReplay::Clip> GsSwingReplay::queue_;
+    std::mutex GsSwingReplay::mutex_;
+    GsBackgroundJob GsSwingReplay::writer_job_(&GsSwingReplay::Process);
+    bool GsSwingReplay::running_ = false;
+
+
+    void GsSwingReplay::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kSwingReplaySeconds", kSwingReplaySeconds);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kSwingReplayPostHitFrames", kSwingReplayPostHitFrames);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kSwingReplayCodec", kSwingReplayCodec);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kSwingReplayBitrateKbps", kSwingReplayBitrateKbps);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kSwingReplayMjpegQuality", kSwingReplayMjpegQuality);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kSwingReplayBufferMegabytes", kSwingReplayBufferMegabytes);
+        GolfSimConfiguration::SetConstant("gs_config.image_capture.kSwingReplayFileName", kSwingReplayFileName);
+
+        kSwingReplayPostHitFrames = std::max(kSwingReplayPostHitFrames, 0);
+        kSwingReplayBufferMegabytes = std::max(kSwingReplayBufferMegabytes, 1);
+
+        if (kSwingReplaySeconds <= 0.0) {
+            return;
+        }
+
+        if (!UseReplay()) {
+            GS_LOG_MSG(warning, "GsSwingReplay - there is no " + kSwingReplayCodec + " encoder for the swing replay on this Pi.  The replay is off.");
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = true;
+    }
+
+    bool GsSwingReplay::UseReplay() {
+        if (kSwingReplaySeconds <= 0.0) {
+            return false;
+        }
+
+        // The V4L2 M2M H.264 codec only exists on the Pi 4 and earlier
+        return kSwingReplayCodec == "mjpeg" ||
+               (kSwingReplayCodec == "h264" && GolfSimConfiguration::GetPiModel() != GolfSimConfiguration::PiModel::kRPi5);
+    }
+
+    void GsSwingReplay::ConfigureVideoOptions(VideoOptions* options) {
+        OptsInternal& opts = options->Set();
+
+        opts.codec = kSwingReplayCodec;
+        opts.bitrate.set(std::to_string(kSwingReplayBitrateKbps) + "kbps");
+        opts.quality = kSwingReplayMjpegQuality;
+
+        // A few key frames a second, each with its own headers, so that the clip can start
+        // close to kSwingReplaySeconds before the hit
+        opts.intra = std::max(1u, (unsigned int)(opts.framerate.value_or(0.0f) / 4));
+        opts.inline_headers = true;
+    }
+
+    void GsSwingReplay::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!running_) {
+                return;
+            }
+
+            running_ = false;
+        }
+
+        // Anything still queued is finished first
+        writer_job_.WaitUntilIdle();
+    }
+
+    GsSwingReplay::GsSwingReplay(VideoOptions const* options)
+        : Output(options), buffer_(std::make_unique<CircularBuffer>((size_t)kSwingReplayBufferMegabytes << 20)) {
+    }
+
+    void GsSwingReplay::outputBuffer(void* mem, size_t size, int64_t timestamp_us, uint32_t flags) {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+
+        if (!buffer_) {
+            return;
+        }
+
+        const size_t frame_size = sizeof(FrameHeader) + size;
+        if (frame_size >= ((size_t)kSwingReplayBufferMegabytes << 20)) {
+            GS_LOG_MSG(warning, "GsSwingReplay - an encoded frame of " + std::to_string(size) + " bytes does not fit in kSwingReplayBufferMegabytes.");
+            return;
+        }
+
+        // Keeps no more than kSwingReplaySeconds, and makes room for the new frame
+        const int64_t replay_us = (int64_t)(kSwingReplaySeconds * 1.0e6);
+        while (!frame_timestamps_.empty() &&
+               (timestamp_us - frame_timestamps_.front() > replay_us || frame_size > buffer_->Available())) {
+            DropOldestFrame();
+        }
+
+        FrameHeader header = { (unsigned int)size, !!(flags & FLAG_KEYFRAME), timestamp_us };
+        buffer_->Write(&header, sizeof(header));
+        buffer_->Write(mem, size);
+        frame_timestamps_.push_back(timestamp_us);
+    }
+
+    void GsSwingReplay::DropOldestFrame() {
+        FrameHeader header;
+        uint8_t* dst = (uint8_t*)&header;
+        buffer_->Read([&dst](void* src, unsigned int n) {
+            memcpy(dst, src, n);
+            dst += n;
+        }, sizeof(header));
+        buffer_->Skip(header.length);
+
+        frame_timestamps_.pop_front();
+    }
+
+    void GsSwingReplay::SaveClip() {
+        Clip clip;
+
+        {
+            std::lock_guard<std::mutex> lock(buffer_mutex_);
+            clip.frames = (unsigned int)frame_timestamps_.size();
+            clip.buffer = std::move(buffer_);
+            frame_timestamps_.clear();
+        }
+
+        if (!clip.buffer || clip.frames == 0) {
+            GS_LOG_TRACE_MSG(trace, "GsSwingReplay - no frames were buffered for the swing replay.");
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (!running_) {
+                GS_LOG_MSG(warning, "GsSwingReplay::SaveClip called, but the writer is not running.");
+                return;
+            }
+
+            // Only the latest swing is of any use to the UI
+            if (!queue_.empty()) {
+                GS_LOG_MSG(warning, "GsSwingReplay - still writing an earlier swing replay.  Dropping the waiting one.");
+                queue_.clear();
+                GsMetrics::Increment(GsMetrics::Counter::kDroppedSwingReplays);
+            }
+
+            queue_.push_back(std::move(clip));
+        }
+
+        writer_job_.Schedule();
+    }
+
+    bool GsSwingReplay::Process() {
+        Clip clip;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (queue_.empty()) {
+                return false;
+            }
+
+            clip = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        try {
+            if (!WriteClip(clip)) {
+                GS_LOG_MSG(warning, "GsSwingReplay - failed to write the swing replay.");
+            }
+        }
+        catch (std::exception const& e) {
+            GS_LOG_MSG(error, "ERROR: *** GsSwingReplay - " + std::string(e.what()) + " ***");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !queue_.empty();
+    }
+
+    bool GsSwingReplay::WriteClip(Clip& clip) {
+
+        auto start_time = std::chrono::steady_clock::now();
+
+        const std::string file_name = GsUISystem::kWebServerShareDirectory + kSwingReplayFileName;
+        const std::string temporary_file_name = file_name + ".tmp";
+
+        FILE* output_file = fopen(temporary_file_name.c_str(), "wb");
+        if (output_file == nullptr) {
+            GS_LOG_MSG(error, "GsSwingReplay - could not open " + temporary_file_name);
+            return false;
+        }
+
+        // As in CircularOutput, the clip has to start at a key frame
+        unsigned int frames_written = 0;
+        size_t bytes_written = 0;
+        bool seen_keyframe = false;
+
+        while (!clip.buffer->Empty()) {
+            FrameHeader header;
+            uint8_t* dst = (uint8_t*)&header;
+            clip.buffer->Read([&dst](void* src, unsigned int n) {
+                memcpy(dst, src, n);
+                dst += n;
+            }, sizeof(header));
+
+            seen_keyframe |= header.keyframe;
+            if (!seen_keyframe) {
+                clip.buffer->Skip(header.length);
+                continue;
+            }
+
+            clip.buffer->Read([&](void* src, unsigned int n) { bytes_written += fwrite(src, 1, n, output_file); }, header.length);
+            frames_written++;
+        }
+
+        const bool write_failed = ferror(output_file) != 0;
+        fclose(output_file);
+
+        if (write_failed || frames_written == 0) {
+            GS_LOG_MSG(warning, "GsSwingReplay - " + std::string(write_failed ? "could not write " : "no key frame was buffered for ") + file_name);
+            std::filesystem::remove(temporary_file_name);
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary_file_name, file_name, error);
+        if (error) {
+            GS_LOG_MSG(warning, "GsSwingReplay - could not replace " + file_name + ": " + error.message());
+            return false;
+        }
+
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+        GS_LOG_MSG(info, "GsSwingReplay - wrote " + std::to_string(frames_written) + " of " + std::to_string(clip.frames) + " frames (" +
+                   std::to_string(bytes_written) + " bytes) to " + file_name + " in " + std::to_string(elapsed_ms) + " ms.");
+
+        return true;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
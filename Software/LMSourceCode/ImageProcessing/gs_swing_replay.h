@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// An instant replay of the swing, from the ball watcher's own video stream.
+// When kSwingReplaySeconds is set, the ball watcher runs the rpicam-apps video encoder
+// (H264Encoder on the V4L2 M2M codec, or MjpegEncoder) over the frames in which there was
+// no motion, and its output goes into a GsSwingReplay instead of being thrown away.  That
+// keeps roughly the last kSwingReplaySeconds of encoded frames in a CircularBuffer (see
+// output/circular_output.hpp).  Once the ball has been hit, the watcher encodes another
+// kSwingReplayPostHitFrames frames, stops, and hands the buffer over to be written out
+// (from the first key frame on) as GsUISystem::kWebServerShareDirectory +
+// kSwingReplayFileName on the shared, low-priority GsBackgroundWorker.  The file is
+// replaced in one go, so the UI never sees a part-written clip.
+// The encoder only ever sees a frame after the motion detector is done with it, so the
+// trigger path is unchanged.  The post-hit frames only delay the watcher's return.
+// The clip is a raw H.264 (or MJPEG) stream with no container, so a player shows it at
+// its own default rate, i.e., in slow motion.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "output/circular_output.hpp"
+#include "worker_thread.h"
+
+namespace golf_sim {
+
+    class GsSwingReplay : public Output {
+
+    public:
+        // 0 (the default) means no replay
+        static double kSwingReplaySeconds;
+        static int kSwingReplayPostHitFrames;
+        // "h264" or "mjpeg".  The H.264 codec only exists on the Pi 4 and earlier.  Elsewhere,
+        // "h264" turns the replay off rather than encode every frame in software.
+        static std::string kSwingReplayCodec;
+        // 0 lets the H.264 codec pick
+        static int kSwingReplayBitrateKbps;
+        static int kSwingReplayMjpegQuality;
+        // An upper bound on the memory for the buffered stream
+        static int kSwingReplayBufferMegabytes;
+        static std::string kSwingReplayFileName;
+
+        static void LoadConfigurationValues();
+
+        // True if the replay is on, and there is an encoder for it on this Pi
+        static bool UseReplay();
+
+        // Sets up the ball watcher's video options for the replay encoder
+        static void ConfigureVideoOptions(VideoOptions* options);
+
+        // Finishes writing any clip that has been handed over.  Called once at shutdown.
+        static void Shutdown();
+
+        GsSwingReplay(VideoOptions const* options);
+
+        // Hands the buffered stream over to be written out, and returns right away.  Must
+        // be called after the encoder has been stopped, and nothing more is buffered after.
+        void SaveClip();
+
+    protected:
+        // Runs on the encoder's output thread
+        void outputBuffer(void* mem, size_t size, int64_t timestamp_us, uint32_t flags) override;
+
+    private:
+        struct Clip {
+            std::unique_ptr<CircularBuffer> buffer;
+            unsigned int frames = 0;
+        };
+
+        // Drops the oldest frame from the buffer
+        void DropOldestFrame();
+
+        // Writes the queued clip.  Run by writer_job_.
+        static bool Process();
+        static bool WriteClip(Clip& clip);
+
+        std::unique_ptr<CircularBuffer> buffer_;
+        // The timestamps of the buffered frames, oldest first
+        std::deque<int64_t> frame_timestamps_;
+        std::mutex buffer_mutex_;
+
+        static std::deque<Clip> queue_;
+        static std::mutex mutex_;
+        static GsBackgroundJob writer_job_;
+        static bool running_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+
+#include "gs_ternary_image.h"
+
+namespace golf_sim {
+
+    // The same as CompareRotationImageWithCutoff, so that the cut-offs happen in the same places
+    static const int kRowsBetweenCutoffChecks = 4;
+
+    void GsTernaryImage::Create(int rows, int cols) {
+        rows_ = rows;
+        cols_ = cols;
+        words_per_row_ = WordsPerRow(cols);
+
+        valid_.assign((size_t)rows_ * words_per_row_, 0);
+        white_.assign((size_t)rows_ * words_per_row_, 0);
+    }
+
+    void GsTernaryImage::Pack(const cv::Mat& image, uchar ignore_value) {
+        CV_Assert(image.type() == CV_8UC1);
+
+        Create(image.rows, image.cols);
+
+        for (int row = 0; row < rows_; row++) {
+            const uchar* pixels = image.ptr<uchar>(row);
+            uint64_t* valid = ValidRow(row);
+            uint64_t* white = WhiteRow(row);
+
+            for (int w = 0; w < words_per_row_; w++) {
+                const int first_col = w * 64;
+                const int num_cols = std::min(64, cols_ - first_col);
+
+                uint64_t valid_bits = 0;
+                uint64_t white_bits = 0;
+
+                for (int bit = 0; bit < num_cols; bit++) {
+                    const uchar p = pixels[first_col + bit];
+                    valid_bits |= (uint64_t)(p != ignore_value) << bit;
+                    white_bits |= (uint64_t)(p == 255) << bit;
+                }
+
+                valid[w] = valid_bits;
+                white[w] = white_bits;
+            }
+        }
+    }
+
+    cv::Mat GsTernaryImage::Unpack(uchar ignore_value) const {
+        cv::Mat image(rows_, cols_, CV_8UC1);
+
+        for (int row = 0; row < rows_; row++) {
+            uchar* pixels = image.ptr<uchar>(row);
+            const uint64_t* valid = ValidRow(row);
+            const uint64_t* white = WhiteRow(row);
+
+            for (int col = 0; col < cols_; col++) {
+                const uint64_t bit = (uint64_t)1 << (col % 64);
+
+                if ((valid[col / 64] & bit) == 0) {
+                    pixels[col] = ignore_value;
+                }
+                else {
+                    pixels[col] = (white[col / 64] & bit) ? 255 : 0;
+                }
+            }
+        }
+
+        return image;
+    }
+
+    cv::Vec2i GsTernaryImage::Compare(const GsTernaryImage& image1, const GsTernaryImage& image2,
+                                      double min_score_to_beat, bool& terminated_early) {
+
+        CV_Assert(image1.rows_ == image2.rows_ && image1.cols_ == image2.cols_);
+
+        long matching = 0;
+        long examined = 0;
+        terminated_early = false;
+
+        for (int row = 0; row < image1.rows_; row++) {
+            CountRow(image1.ValidRow(row), image1.WhiteRow(row), image2.ValidRow(row), image2.WhiteRow(row),
+                     image1.words_per_row_, matching, examined);
+
+            if (min_score_to_beat >= 0.0 && (row + 1) % kRowsBetweenCutoffChecks == 0 && row + 1 < image1.rows_) {
+                // Best case, every remaining pixel is examined and matches
+                const long remaining_pixels = (long)(image1.rows_ - (row + 1)) * image1.cols_;
+                const double best_possible_score = (double)(matching + remaining_pixels) / (double)(examined + remaining_pixels);
+
+                if (best_possible_score < min_score_to_beat) {
+                    terminated_early = true;
+                    break;
+                }
+            }
+        }
+
+        return cv::Vec2i(matching, examined);
+    }
+
+}
@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// The one translation unit that creates the "pitrac" tracepoint probes (see gs_trace_zones.h)
+
+#ifdef GS_USE_LTTNG_TRACING
+
+#define TRACEPOINT_CREATE_PROBES
+#define TRACEPOINT_DEFINE
+#include "gs_trace_zones_tp.h"
+
+#endif // #ifdef GS_USE_LTTNG_TRACING
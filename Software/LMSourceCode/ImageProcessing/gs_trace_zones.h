@@ -0,0 +1,87 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Named zones, counters and thread names for an external profiler, for the detail inside
+// a shot (e.g., GetBall, the spin search or the NCNN inference) that GsShotTrace's per-stage
+// latencies do not go into.
+//
+//     GS_TRACE_ZONE("GetBall");                    // From here to the end of the scope
+//     GS_TRACE_COUNTER("ncnn_detections", n);
+//     GS_TRACE_THREAD_NAME("Camera2Thread");       // At most 15 characters
+//
+// When meson is configured with -Denable_lttng_tracing=true (which needs lttng-ust), these
+// are LTTng-UST tracepoints of the "pitrac" provider (see gs_trace_zones_tp.h), e.g.:
+//
+//     lttng create pitrac && lttng enable-event --userspace 'pitrac:*'
+//     lttng add-context --userspace --type=vtid --type=procname && lttng start
+//
+// A tracepoint that no session has enabled costs one predictable branch.  The thread names
+// (other than the main thread's) are also set with pthread_setname_np, so that perf and
+// the other profilers show them.
+// Otherwise, the macros expand to nothing and cost nothing.
+
+#pragma once
+
+#ifdef GS_USE_LTTNG_TRACING
+
+#include <cstdint>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "gs_trace_zones_tp.h"
+
+namespace golf_sim {
+
+    // Emits zone_begin when constructed and zone_end when destroyed
+    class GsTraceZone {
+
+    public:
+        explicit GsTraceZone(const char* name) : name_(name) {
+            tracepoint(pitrac, zone_begin, name_);
+        }
+
+        ~GsTraceZone() {
+            tracepoint(pitrac, zone_end, name_);
+        }
+
+        GsTraceZone(const GsTraceZone&) = delete;
+        GsTraceZone& operator=(const GsTraceZone&) = delete;
+
+    private:
+        const char* name_;
+    };
+
+    inline void GsTraceSetThreadName(const char* name) {
+        // pthread_setname_np refuses names longer than the kernel's 15 characters
+        char short_name[16] = {};
+        for (int i = 0; i < 15 && name[i] != '\0'; i++) {
+            short_name[i] = name[i];
+        }
+
+        // The main thread's name is the process's, which ps, systemd and the scripts look for
+        if (gettid() != getpid()) {
+            pthread_setname_np(pthread_self(), short_name);
+        }
+        tracepoint(pitrac, thread_name, short_name);
+    }
+
+}
+
+#define GS_TRACE_CONCAT_INNER(a, b) a##b
+#define GS_TRACE_CONCAT(a, b) GS_TRACE_CONCAT_INNER(a, b)
+
+// name must be a string literal (or otherwise outlive the zone)
+#define GS_TRACE_ZONE(name) golf_sim::GsTraceZone GS_TRACE_CONCAT(gs_trace_zone_, __LINE__)(name)
+#define GS_TRACE_COUNTER(name, value) tracepoint(pitrac, counter, name, (int64_t)(value))
+#define GS_TRACE_THREAD_NAME(name) golf_sim::GsTraceSetThreadName(name)
+
+#else
+
+#define GS_TRACE_ZONE(name) ((void)0)
+#define GS_TRACE_COUNTER(name, value) ((void)0)
+#define GS_TRACE_THREAD_NAME(name) ((void)0)
+
+#endif
@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// The LTTng-UST tracepoint provider behind gs_trace_zones.h.  Only included if
+// GS_USE_LTTNG_TRACING is defined.  This header is read more than once by lttng-ust's
+// own headers, so it has no #pragma once.  gs_trace_zones.cpp creates the probes.
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER pitrac
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "./gs_trace_zones_tp.h"
+
+#if !defined(GS_TRACE_ZONES_TP_H) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define GS_TRACE_ZONES_TP_H
+
+#include <stdint.h>
+
+#include <lttng/tracepoint.h>
+
+TRACEPOINT_EVENT(
+    pitrac,
+    zone_begin,
+    TP_ARGS(const char*, name),
+    TP_FIELDS(
+        ctf_string(name, name)
+    )
+)
+
+TRACEPOINT_EVENT(
+    pitrac,
+    zone_end,
+    TP_ARGS(const char*, name),
+    TP_FIELDS(
+        ctf_string(name, name)
+    )
+)
+
+TRACEPOINT_EVENT(
+    pitrac,
+    counter,
+    TP_ARGS(const char*, name, int64_t, value),
+    TP_FIELDS(
+        ctf_string(name, name)
+        ctf_integer(int64_t, value, value)
+    )
+)
+
+TRACEPOINT_EVENT(
+    pitrac,
+    thread_name,
+    TP_ARGS(const char*, name),
+    TP_FIELDS(
+        ctf_string(name, name)
+    )
+)
+
+#endif // #if !defined(GS_TRACE_ZONES_TP_H) || defined(TRACEPOINT_HEADER_MULTI_READ)
+
+#include <lttng/tracepoint-event.h>
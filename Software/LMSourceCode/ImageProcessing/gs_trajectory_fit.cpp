@@ -0,0 +1,162 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "gs_trajectory_fit.h"
+
+namespace golf_sim {
+
+    // The MAD of normally-distributed residuals times this is their standard deviation
+    static constexpr double kMadToSigma = 1.4826;
+
+    static double Median(std::vector<double>& values) {
+        const size_t middle = values.size() / 2;
+        std::nth_element(values.begin(), values.begin() + middle, values.end());
+        double median = values[middle];
+
+        if (values.size() % 2 == 0) {
+            median = (median + *std::max_element(values.begin(), values.begin() + middle)) / 2.0;
+        }
+
+        return median;
+    }
+
+
+    bool GsTrajectoryFit::Fit(const std::vector<GsTrajectorySample>& samples, GsTrajectoryFitResult& result) const {
+
+        if (samples.size() < 2) {
+            return false;
+        }
+
+        for (int axis = 0; axis < 3; axis++) {
+            if (!FitAxis(samples, axis, result.position_at_time_zero[axis], result.velocity[axis],
+                         result.rms_residual[axis], result.inliers[axis])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool GsTrajectoryFit::FitAxis(const std::vector<GsTrajectorySample>& samples, const int axis,
+                                  double& intercept, double& slope, double& rms_residual, std::vector<bool>& inliers) const {
+
+        const size_t n = samples.size();
+
+        std::vector<double> weights(n, 1.0);
+        std::vector<double> residuals(n, 0.0);
+        inliers.assign(n, true);
+
+        for (int iteration = 0; iteration < std::max(1, maximum_iterations); iteration++) {
+
+            // Solve about the weighted mean time, which keeps the sums well-conditioned
+            double weight_sum = 0.0;
+            double mean_time = 0.0;
+            double mean_position = 0.0;
+
+            for (size_t i = 0; i < n; i++) {
+                weight_sum += weights[i];
+                mean_time += weights[i] * samples[i].time_seconds;
+                mean_position += weights[i] * samples[i].position[axis];
+            }
+
+            if (weight_sum <= 0.0) {
+                return false;
+            }
+
+            mean_time /= weight_sum;
+            mean_position /= weight_sum;
+
+            double time_variance = 0.0;
+            double covariance = 0.0;
+
+            for (size_t i = 0; i < n; i++) {
+                const double dt = samples[i].time_seconds - mean_time;
+                time_variance += weights[i] * dt * dt;
+                covariance += weights[i] * dt * (samples[i].position[axis] - mean_position);
+            }
+
+            if (time_variance <= 0.0) {
+                // All of the (weighted) samples are at the same time
+                return false;
+            }
+
+            slope = covariance / time_variance;
+            intercept = mean_position - slope * mean_time;
+
+            std::vector<double> inlier_residuals;
+            inlier_residuals.reserve(n);
+
+            for (size_t i = 0; i < n; i++) {
+                residuals[i] = samples[i].position[axis] - (intercept + slope * samples[i].time_seconds);
+
+                if (inliers[i]) {
+                    inlier_residuals.push_back(std::abs(residuals[i]));
+                }
+            }
+
+            const double scale = std::max(minimum_residual_scale, kMadToSigma * Median(inlier_residuals));
+
+            // Drop the worst outliers first, as long as enough points remain
+            std::vector<size_t> order(n);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return std::abs(residuals[a]) > std::abs(residuals[b]); });
+
+            size_t number_of_inliers = inlier_residuals.size();
+            bool changed = false;
+
+            for (size_t i : order) {
+                if (number_of_inliers <= kMinimumInliers || std::abs(residuals[i]) <= outlier_rejection_scales * scale) {
+                    break;
+                }
+
+                if (inliers[i]) {
+                    inliers[i] = false;
+                    number_of_inliers--;
+                    changed = true;
+                }
+            }
+
+            const double huber_threshold = huber_threshold_scales * scale;
+
+            for (size_t i = 0; i < n; i++) {
+                double new_weight = 0.0;
+
+                if (inliers[i]) {
+                    const double r = std::abs(residuals[i]);
+                    new_weight = (r <= huber_threshold) ? 1.0 : huber_threshold / r;
+                }
+
+                if (std::abs(new_weight - weights[i]) > 1e-6) {
+                    changed = true;
+                }
+
+                weights[i] = new_weight;
+            }
+
+            if (!changed) {
+                break;
+            }
+        }
+
+        double squared_sum = 0.0;
+        size_t number_of_inliers = 0;
+
+        for (size_t i = 0; i < n; i++) {
+            if (inliers[i]) {
+                squared_sum += residuals[i] * residuals[i];
+                number_of_inliers++;
+            }
+        }
+
+        rms_residual = std::sqrt(squared_sum / std::max<size_t>(1, number_of_inliers));
+
+        return true;
+    }
+
+}
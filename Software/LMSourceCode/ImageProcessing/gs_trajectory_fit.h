@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Fits a straight, constant-velocity 3D trajectory, p(t) = p0 + v * t, to all of a shot's
+// strobed ball positions at once, instead of averaging the deltas of every pair of balls.
+// Over the few milliseconds of a strobed image, gravity and drag move the ball well under a
+// millimeter off such a line, which is less than the position measurement error.
+//
+// Each axis is a separate 2-parameter weighted least-squares problem, solved in closed
+// form.  The weights come from iteratively reweighted least squares with Huber weights,
+// using the median absolute deviation of the residuals as the noise scale, and points whose
+// residual is still far outside that scale are dropped.  An axis keeps at least
+// kMinimumInliers points.  The axes are fitted separately so that, for example, a bad
+// depth (radius-based) measurement does not also throw out a good up/down position.
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    struct GsTrajectorySample {
+        double time_seconds = 0.0;
+        cv::Vec3d position;
+    };
+
+    struct GsTrajectoryFitResult {
+        // The position at time 0 and the (per second) velocity
+        cv::Vec3d position_at_time_zero;
+        cv::Vec3d velocity;
+
+        // The RMS residual of the inliers of each axis
+        cv::Vec3d rms_residual;
+
+        // inliers[axis][i] is false if samples[i] was rejected for that axis
+        std::vector<bool> inliers[3];
+    };
+
+    class GsTrajectoryFit {
+
+    public:
+        static constexpr size_t kMinimumInliers = 3;
+
+        // Residuals below this (in the units of the positions) are never treated as outliers,
+        // so that a nearly-perfect fit does not reject good points because of tiny differences
+        double minimum_residual_scale = 0.0005;
+
+        // A point is dropped once its residual is more than this many noise scales
+        double outlier_rejection_scales = 3.0;
+
+        // The Huber threshold, in noise scales
+        double huber_threshold_scales = 1.345;
+
+        int maximum_iterations = 10;
+
+        // Needs at least 2 samples with different times
+        bool Fit(const std::vector<GsTrajectorySample>& samples, GsTrajectoryFitResult& result) const;
+
+    private:
+        bool FitAxis(const std::vector<GsTrajectorySample>& samples, const int axis,
+                     double& intercept, double& slope, double& rms_residual, std::vector<bool>& inliers) const;
+    };
+
+}
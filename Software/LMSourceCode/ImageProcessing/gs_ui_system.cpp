@@ -16,6 +16,11 @@
 #include "gs_camera.h"
 #include "gs_http_client.h"
 #include "cv_utils.h"
+#include "gs_shot_record.h"
+#include "gs_image_writer.h"
+#include "gs_image_service.h"
+#include "gs_shared_memory.h"
+#include "gs_local_display.h"
 
 namespace golf_sim {
 
@@ -27,52 +32,16 @@ namespace golf_sim {
     std::string GsUISystem::kWebServerErrorExposuresImage;
     std::string GsUISystem::kWebServerBallSearchAreaImage;
 
-    static std::string EscapeJson(const std::string& s) {
-        std::string out;
-        out.reserve(s.size() + 16);
-        for (char c : s) {
-            switch (c) {
-                case '"':  out += "\\\""; break;
-                case '\\': out += "\\\\"; break;
-                case '\n': out += "\\n";  break;
-                case '\r': out += "\\r";  break;
-                case '\t': out += "\\t";  break;
-                default:   out += c;
-            }
-        }
-        return out;
-    }
-
-    static std::string BuildResultJson(int result_type, const std::string& message,
-                                       float speed_mps = 0, float launch_deg = 0,
-                                       float side_deg = 0, int back_spin = 0,
-                                       int side_spin = 0, int carry_m = 0,
-                                       const std::vector<std::string>& images = {}) {
-        std::string json = "{";
-        json += "\"result_type\":" + std::to_string(result_type);
-        json += ",\"speed_mps\":" + std::to_string(speed_mps);
-        json += ",\"launch_angle\":" + std::to_string(launch_deg);
-        json += ",\"side_angle\":" + std::to_string(side_deg);
-        json += ",\"back_spin\":" + std::to_string(back_spin);
-        json += ",\"side_spin\":" + std::to_string(side_spin);
-        json += ",\"carry\":" + std::to_string(carry_m);
-        json += ",\"message\":\"" + EscapeJson(message) + "\"";
-        json += ",\"images\":[";
-        for (size_t i = 0; i < images.size(); i++) {
-            if (i > 0) json += ",";
-            json += "\"" + EscapeJson(images[i]) + "\"";
-        }
-        json += "]}";
+    static std::string BuildResultJson(int result_type, const std::string& message) {
+        std::string json;
+        GsShotRecord().AppendJson(json, result_type, message);
         return json;
     }
 
 
-    void GsUISystem::SendIPCErrorStatusMessage(const std::string& error_message) {
-        std::string msg;
-        if (!LoggingTools::current_error_root_cause_.empty()) {
-            msg = LoggingTools::current_error_root_cause_;
-            LoggingTools::current_error_root_cause_ = "";
-        } else {
+    void GsUISystem::SendIPCErrorStatusMessage(const std::string& error_message, const std::string& root_cause) {
+        std::string msg = root_cause.empty() ? LoggingTools::TakeErrorRootCause() : root_cause;
+        if (msg.empty()) {
             msg = error_message;
         }
 
@@ -125,40 +94,37 @@ namespace golf_sim {
         }
 
         GS_LOG_TRACE_MSG(trace, "Sending status result: " + msg);
-        GsHttpClient::PostResult(BuildResultJson(static_cast<int>(message_type), msg));
+#ifdef __unix__
+        GsLocalDisplay::SetStatus(msg);
+#endif
+        // A status is stale as soon as there is a newer one
+        GsHttpClient::PostResult(BuildResultJson(static_cast<int>(message_type), msg), true);
         return true;
     }
 
     void GsUISystem::SendIPCHitMessage(const GolfBall& result_ball, const std::string& secondary_message) {
-        float speed = result_ball.velocity_;
-        float launch = result_ball.angles_ball_perspective_[1];
-        float side = result_ball.angles_ball_perspective_[0];
-        int back_spin = static_cast<int>(result_ball.rotation_speeds_RPM_[2]);
-        int side_spin = static_cast<int>(result_ball.rotation_speeds_RPM_[0]);
-        int carry = 100 + rand() % 150;
-
-        std::vector<std::string> images;
-
-        std::string msg = "Ball Hit - Results returned." + secondary_message;
-
-        GS_LOG_MSG(info, "BALL_HIT_CSV, " + std::to_string(GsSimInterface::GetShotCounter())
-            + ", (carry - NA), (Total - NA), (Side Dest - NA), (Smash Factor - NA), (Club Speed - NA), "
-            + std::to_string(CvUtils::MetersPerSecondToMPH(speed)) + ", "
-            + std::to_string(back_spin) + ", "
-            + std::to_string(side_spin) + ", "
-            + std::to_string(launch) + ", "
-            + std::to_string(side)
-            + ", (Descent Angle-NA), (Apex-NA), (Flight Time-NA), (Type-NA)");
+        SendIPCHitMessage(GsShotRecord(result_ball, GsSimInterface::GetShotCounter()), secondary_message);
+    }
 
-        GsHttpClient::PostResult(BuildResultJson(
-            static_cast<int>(GsIPCResultType::kHit), msg,
-            speed, launch, side, back_spin, side_spin, carry, images));
+    void GsUISystem::SendIPCHitMessage(const GsShotRecord& shot_record, const std::string& secondary_message) {
+
+        // Re-used from shot to shot, so that formatting does not allocate once it is big enough
+        static thread_local std::string buffer;
+
+        buffer.clear();
+        shot_record.AppendCsv(buffer);
+        GS_LOG_MSG(info, buffer);
+
+        buffer.clear();
+        shot_record.AppendJson(buffer, static_cast<int>(GsIPCResultType::kHit), "Ball Hit - Results returned." + secondary_message);
+        GsHttpClient::PostResult(buffer);
     }
 
 
     bool GsUISystem::SaveWebserverImage(const std::string& input_file_name,
                                         const cv::Mat& img,
-                                        bool suppress_diagnostic_saving) {
+                                        bool suppress_diagnostic_saving,
+                                        const std::function<void()>& on_saved) {
 
         GS_LOG_MSG(trace, "GsUISystem::SaveWebserverImage called with file name = " + input_file_name);
 
@@ -173,7 +139,19 @@ namespace golf_sim {
             LoggingTools::LogImage(file_name + "_", img, std::vector < cv::Point >{}, false, "", "_Shot_" + std::to_string(GsSimInterface::GetShotCounter()));
         }
 
+        GsSharedMemory::PublishFrame(PITRAC_SHM_FRAME_ANNOTATED, file_name, img);
+
+        // The caller may re-use img, so the image service and the writer get their own copy.
+        // Anything that tells the web server the image is ready has to wait for on_saved,
+        // not for this function to return.
+        if (GsImageService::IsRunning() && GsImageService::Publish(file_name, img.clone(), {}, on_saved)) {
+            return true;
+        }
+
         if (!GolfSimCamera::kLogWebserverImagesToFile) {
+            if (on_saved) {
+                on_saved();
+            }
             return true;
         }
 
@@ -183,17 +161,8 @@ namespace golf_sim {
 
         std::string fname = kWebServerShareDirectory + file_name;
 
-        try {
-            if (cv::imwrite(fname, img)) {
-                GS_LOG_TRACE_MSG(trace, "Logged image to file: " + fname);
-            }
-            else {
-                GS_LOG_MSG(warning, "GsUISystem::SaveWebserverImage - could not save to file name: " + fname);
-            }
-        }
-        catch (std::exception& ex) {
-            GS_LOG_TRACE_MSG(warning, "Exception! - failed to imwrite with fname = " + fname);
-        }
+        GsImageWriter::Write(fname, GsImageWriter::kUseAsyncImageWriter ? img.clone() : img,
+                             GsImageWriter::ArtifactClass::kWebserverImage, on_saved);
 
         return true;
     }
@@ -202,22 +171,65 @@ namespace golf_sim {
     bool GsUISystem::SaveWebserverImage(const std::string& file_name,
                                         const cv::Mat& img,
                                         const std::vector<GolfBall>& balls,
-                                        bool suppress_diagnostic_saving) {
+                                        bool suppress_diagnostic_saving,
+                                        const std::function<void()>& on_saved) {
 
-        if (!GolfSimCamera::kLogWebserverImagesToFile) {
+        // The shared-memory readers draw any outlines themselves
+        if (GsSharedMemory::IsRunning() && !img.empty()) {
+            std::vector<GsCircle> circles;
+            circles.reserve(balls.size());
+
+            for (const GolfBall& ball : balls) {
+                circles.push_back(ball.ball_circle_);
+            }
+
+            GsSharedMemory::PublishFrame(PITRAC_SHM_FRAME_ANNOTATED, file_name, img, circles);
+        }
+
+        if (!GolfSimCamera::kLogWebserverImagesToFile && !GsImageService::IsRunning()) {
+            if (on_saved) {
+                on_saved();
+            }
             return true;
         }
 
-        cv::Mat ball_image = img.clone();
+        if (img.empty()) {
+            GS_LOG_MSG(warning, "GsUISystem::SaveWebserverImage was empty - ignoring.");
+            return false;
+        }
+
+        // The outlines are drawn by the image writer on its own copy of img
+        std::vector<GsImageWriter::CircleAnnotation> annotations;
+        annotations.reserve(balls.size());
 
         for (size_t i = 0; i < balls.size(); i++) {
-            const GolfBall& b = balls[i];
-            const GsCircle& c = b.ball_circle_;
-            std::string label = std::to_string(i);
-            LoggingTools::DrawCircleOutlineAndCenter(ball_image, c, label);
+            annotations.push_back(GsImageWriter::CircleAnnotation{ balls[i].ball_circle_, std::to_string(i) });
+        }
+
+        if (GolfSimCamera::kLogDiagnosticImagesToUniqueFiles && !suppress_diagnostic_saving) {
+            LoggingTools::LogAnnotatedImage(file_name + "_", img, annotations);
+        }
+
+        if (GsImageService::Publish(file_name, img, annotations, on_saved)) {
+            return true;
         }
 
-        return SaveWebserverImage(file_name, ball_image, suppress_diagnostic_saving);
+        if (!GolfSimCamera::kLogWebserverImagesToFile) {
+            if (on_saved) {
+                on_saved();
+            }
+            return true;
+        }
+
+        std::string fname = kWebServerShareDirectory + file_name;
+
+        if (fname.find(".png") == std::string::npos) {
+            fname += ".png";
+        }
+
+        GsImageWriter::WriteAnnotated(fname, img, std::move(annotations), GsImageWriter::ArtifactClass::kWebserverImage, on_saved);
+
+        return true;
     }
 
     void GsUISystem::ClearWebserverImages() {
@@ -9,10 +9,12 @@
 
 #ifdef __unix__  // Ignore in Windows environment
 
+#include <functional>
 
 #include "logging_tools.h"
 #include "golf_ball.h"
 #include "gs_result_types.h"
+#include "gs_shot_record.h"
 
 
 // The primary object for communications to the Golf Sim user interface
@@ -32,18 +34,27 @@ namespace golf_sim {
         static std::string kWebServerBallSearchAreaImage;
         
 
-        static void SendIPCErrorStatusMessage(const std::string& error_message);
+        // Sends the root cause instead of error_message if there is one.  An empty root_cause
+        // means the process-wide one (see LoggingTools::SetErrorRootCause).
+        static void SendIPCErrorStatusMessage(const std::string& error_message, const std::string& root_cause = "");
 
         static bool SendIPCStatusMessage(const GsIPCResultType message_type, const std::string& custom_message = "");
 
         static void SendIPCHitMessage(const GolfBall& result_ball, const std::string& secondary_message = "");
+        // For a shot whose record has already been made (e.g., for the simulators)
+        static void SendIPCHitMessage(const GsShotRecord& shot_record, const std::string& secondary_message = "");
 
         // Save the image into the shared web-server directory so that the web-based 
         // golf-sim user interface can access it.  
         // Also save a uniquely-named copy to the usual images directory unless suppressed.
-
-        static bool SaveWebserverImage(const std::string& file_name, const cv::Mat& img, bool suppress_diagnostic_saving = false);
-        static bool SaveWebserverImage(const std::string& file_name, const cv::Mat& img, const std::vector<GolfBall>& balls, bool suppress_diagnostic_saving = false);
+        // The file may be written later by the GsImageWriter thread.  If on_saved is set, it
+        // is called once the web-server copy is actually on disk.
+
+        static bool SaveWebserverImage(const std::string& file_name, const cv::Mat& img, bool suppress_diagnostic_saving = false,
+                                       const std::function<void()>& on_saved = nullptr);
+        // The balls are outlined on the writer's own copy of img, so here the caller must not change img afterward
+        static bool SaveWebserverImage(const std::string& file_name, const cv::Mat& img, const std::vector<GolfBall>& balls, bool suppress_diagnostic_saving = false,
+                                       const std::function<void()>& on_saved = nullptr);
 
         static void ClearWebserverImages();
     };
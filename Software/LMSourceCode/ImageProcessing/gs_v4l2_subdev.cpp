@@ -0,0 +1,196 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <linux/media.h>
+#include <linux/media-bus-format.h>
+#include <linux/v4l2-subdev.h>
+
+#include "logging_tools.h"
+
+#include "gs_v4l2_subdev.h"
+
+namespace golf_sim {
+
+    std::mutex GsV4l2Subdev::mutex_;
+    bool GsV4l2Subdev::discovery_done_ = false;
+    std::vector<GsV4l2Subdev::CameraLocation> GsV4l2Subdev::cameras_;
+    std::vector<int> GsV4l2Subdev::subdev_fds_;
+
+    // The original discovery script looked at /dev/media0 through /dev/media5
+    static constexpr int kMaxMediaNumber = 5;
+    static const std::string kSensorEntityPrefix = "imx296 ";
+
+
+    // Maps a character device number to its /dev node, e.g., 81:3 to /dev/v4l-subdev2
+    static std::string GetDevicePath(uint32_t major, uint32_t minor) {
+
+        std::ifstream uevent("/sys/dev/char/" + std::to_string(major) + ":" + std::to_string(minor) + "/uevent");
+        std::string line;
+
+        while (std::getline(uevent, line)) {
+            if (line.rfind("DEVNAME=", 0) == 0) {
+                return "/dev/" + line.substr(strlen("DEVNAME="));
+            }
+        }
+
+        return "";
+    }
+
+
+    bool GsV4l2Subdev::DiscoverCameras() {
+
+        for (int m = 0; m <= kMaxMediaNumber; m++) {
+            const std::string media_path = "/dev/media" + std::to_string(m);
+            const int media_fd = open(media_path.c_str(), O_RDWR | O_CLOEXEC);
+
+            if (media_fd < 0) {
+                continue;
+            }
+
+            struct media_entity_desc entity;
+            memset(&entity, 0, sizeof(entity));
+            entity.id = MEDIA_ENT_ID_FLAG_NEXT;
+
+            while (ioctl(media_fd, MEDIA_IOC_ENUM_ENTITIES, &entity) == 0) {
+                const std::string name(entity.name);
+
+                if (name.rfind(kSensorEntityPrefix, 0) == 0) {
+                    CameraLocation location;
+                    location.media_number = m;
+                    location.entity_name = name;
+                    location.subdev_path = GetDevicePath(entity.dev.major, entity.dev.minor);
+
+                    try {
+                        location.device_number = std::stoi(name.substr(kSensorEntityPrefix.length()));
+                    }
+                    catch (std::exception const& e) {
+                        GS_LOG_MSG(warning, "GsV4l2Subdev - could not parse the device number of sensor " + name);
+                    }
+
+                    GS_LOG_TRACE_MSG(trace, "GsV4l2Subdev - found " + name + " on " + media_path + " at " + location.subdev_path);
+                    cameras_.push_back(location);
+                    subdev_fds_.push_back(-1);
+                }
+
+                entity.id |= MEDIA_ENT_ID_FLAG_NEXT;
+            }
+
+            close(media_fd);
+        }
+
+        return !cameras_.empty();
+    }
+
+
+    bool GsV4l2Subdev::GetCameraLocation(GsCameraNumber camera_number, CameraLocation& location) {
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // The cameras won't move during a single execution, so there is no need to look more than once
+        if (!discovery_done_) {
+            DiscoverCameras();
+            discovery_done_ = true;
+        }
+
+        const size_t index = (camera_number == GsCameraNumber::kGsCamera1) ? 0 : 1;
+
+        if (index >= cameras_.size()) {
+            GS_LOG_MSG(error, "GsV4l2Subdev - found " + std::to_string(cameras_.size()) + " camera(s).  Both cameras must be connected.");
+            return false;
+        }
+
+        location = cameras_[index];
+        return true;
+    }
+
+
+    void GsV4l2Subdev::GetCameraLocations(std::vector<CameraLocation>& locations) {
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!discovery_done_) {
+            DiscoverCameras();
+            discovery_done_ = true;
+        }
+
+        locations = cameras_;
+    }
+
+
+    bool GsV4l2Subdev::SetCrop(GsCameraNumber camera_number, bool mono, const cv::Vec2i& size, const cv::Vec2i& offset) {
+
+        CameraLocation location;
+
+        if (!GetCameraLocation(camera_number, location) || location.subdev_path.empty()) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const size_t index = (camera_number == GsCameraNumber::kGsCamera1) ? 0 : 1;
+
+        if (subdev_fds_[index] < 0) {
+            subdev_fds_[index] = open(location.subdev_path.c_str(), O_RDWR | O_CLOEXEC);
+
+            if (subdev_fds_[index] < 0) {
+                GS_LOG_MSG(error, "GsV4l2Subdev - could not open " + location.subdev_path + ": " + std::string(strerror(errno)));
+                return false;
+            }
+        }
+
+        const int fd = subdev_fds_[index];
+
+        // Like media-ctl, set the crop rectangle first and then the format within it
+        struct v4l2_subdev_selection selection;
+        memset(&selection, 0, sizeof(selection));
+        selection.which = V4L2_SUBDEV_FORMAT_ACTIVE;
+        selection.pad = 0;
+        selection.target = V4L2_SEL_TGT_CROP;
+        selection.r.left = offset[0];
+        selection.r.top = offset[1];
+        selection.r.width = size[0];
+        selection.r.height = size[1];
+
+        if (ioctl(fd, VIDIOC_SUBDEV_S_SELECTION, &selection) < 0) {
+            GS_LOG_MSG(error, "GsV4l2Subdev - VIDIOC_SUBDEV_S_SELECTION failed on " + location.entity_name + ": " + std::string(strerror(errno)));
+            return false;
+        }
+
+        struct v4l2_subdev_format format;
+        memset(&format, 0, sizeof(format));
+        format.which = V4L2_SUBDEV_FORMAT_ACTIVE;
+        format.pad = 0;
+
+        if (ioctl(fd, VIDIOC_SUBDEV_G_FMT, &format) < 0) {
+            GS_LOG_MSG(error, "GsV4l2Subdev - VIDIOC_SUBDEV_G_FMT failed on " + location.entity_name + ": " + std::string(strerror(errno)));
+            return false;
+        }
+
+        format.format.code = mono ? MEDIA_BUS_FMT_Y10_1X10 : MEDIA_BUS_FMT_SBGGR10_1X10;
+        format.format.width = size[0];
+        format.format.height = size[1];
+
+        if (ioctl(fd, VIDIOC_SUBDEV_S_FMT, &format) < 0) {
+            GS_LOG_MSG(error, "GsV4l2Subdev - VIDIOC_SUBDEV_S_FMT failed on " + location.entity_name + ": " + std::string(strerror(errno)));
+            return false;
+        }
+
+        GS_LOG_TRACE_MSG(trace, "GsV4l2Subdev - " + location.entity_name + " set to " + std::to_string(format.format.width) + "x" +
+            std::to_string(format.format.height) + " at (" + std::to_string(offset[0]) + "," + std::to_string(offset[1]) + ")");
+
+        return true;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
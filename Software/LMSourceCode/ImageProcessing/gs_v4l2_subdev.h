@@ -0,0 +1,58 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Crops the IMX296 sensors directly through the V4L2 media controller and subdevice
+// ioctls.  Does what the "media-ctl --print-dot" discovery and "media-ctl --set-v4l2"
+// cropping commands used to do, but in-process, so that re-arming a camera does not
+// fork a shell or write any files.  The camera locations are discovered once and cached.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "gs_options.h"
+
+namespace golf_sim {
+
+    class GsV4l2Subdev {
+
+    public:
+        struct CameraLocation {
+            int media_number = -1;
+            // E.g., the 10 in "imx296 10-001a"
+            int device_number = -1;
+            std::string entity_name;
+            std::string subdev_path;
+        };
+
+        // Camera 1's sensor is reported on the lowest-numbered media device and camera 2's on
+        // the next one, same as the original media-ctl discovery.
+        static bool GetCameraLocation(GsCameraNumber camera_number, CameraLocation& location);
+
+        // Every sensor that was found, in camera number order
+        static void GetCameraLocations(std::vector<CameraLocation>& locations);
+
+        // Same as "media-ctl --set-v4l2 '<sensor>':0 [fmt:<format>/WxH crop:(x,y)/WxH]"
+        static bool SetCrop(GsCameraNumber camera_number, bool mono, const cv::Vec2i& size, const cv::Vec2i& offset);
+
+    private:
+        static bool DiscoverCameras();
+
+        static std::mutex mutex_;
+        static bool discovery_done_;
+        static std::vector<CameraLocation> cameras_;
+        // Kept open once used.  Index is the same as cameras_.
+        static std::vector<int> subdev_fds_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
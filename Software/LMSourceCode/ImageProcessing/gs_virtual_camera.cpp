@@ -0,0 +1,395 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include <time.h>
+
+#include <boost/property_tree/ptree.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <libcamera/control_ids.h>
+#include <libcamera/stream.h>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_globals.h"
+#include "gs_camera.h"
+#include "gs_shot_trace.h"
+#include "gs_shot_archive.h"
+#include "camera_hardware.h"
+#include "libcamera_interface.h"
+#include "motion_detect.h"
+#include "pulse_strobe.h"
+#include "gs_watcher_stage_chain.h"
+
+#include "gs_virtual_camera.h"
+
+namespace golf_sim {
+
+    std::string GsVirtualCamera::kVirtualCameraShotArchive;
+    double GsVirtualCamera::kVirtualCameraFps = 500.0;
+    int GsVirtualCamera::kVirtualCameraPreHitFrames = 200;
+    // Roughly camera 2's exposure and readout once it has been triggered
+    int GsVirtualCamera::kVirtualCameraCam2DelayUs = 17000;
+    int GsVirtualCamera::kVirtualCameraCropWidth = 0;
+    int GsVirtualCamera::kVirtualCameraCropHeight = 0;
+    bool GsVirtualCamera::kVirtualCameraAnalyzeShots = true;
+    int GsVirtualCamera::kVirtualCameraIterations = 1;
+    std::string GsVirtualCamera::kVirtualCameraResultsFile;
+
+    // The synthetic hit frame is repeated this many times, so that the motion detector still
+    // sees it if the hit lands on one of the frames that frame_period skips
+    static const int kSyntheticPostHitFrames = 30;
+
+
+    void GsVirtualCamera::LoadConfigurationValues() {
+        GolfSimConfiguration::SetConstant("gs_config.testing.kVirtualCameraShotArchive", kVirtualCameraShotArchive);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kVirtualCameraFps", kVirtualCameraFps);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kVirtualCameraPreHitFrames", kVirtualCameraPreHitFrames);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kVirtualCameraCam2DelayUs", kVirtualCameraCam2DelayUs);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kVirtualCameraCropWidth", kVirtualCameraCropWidth);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kVirtualCameraCropHeight", kVirtualCameraCropHeight);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kVirtualCameraAnalyzeShots", kVirtualCameraAnalyzeShots);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kVirtualCameraIterations", kVirtualCameraIterations);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kVirtualCameraResultsFile", kVirtualCameraResultsFile);
+
+        kVirtualCameraFps = std::max(kVirtualCameraFps, 1.0);
+        // The first frame only primes the motion detector
+        kVirtualCameraPreHitFrames = std::max(kVirtualCameraPreHitFrames, 2);
+        kVirtualCameraCam2DelayUs = std::max(kVirtualCameraCam2DelayUs, 0);
+        kVirtualCameraIterations = std::max(kVirtualCameraIterations, 1);
+    }
+
+    // The single-channel, cropped copy of the frame that camera 1 would have delivered
+    static cv::Mat ToWatchedFrame(const cv::Mat& img, const cv::Rect& crop) {
+        cv::Mat gray;
+
+        if (img.channels() == 1) {
+            gray = img;
+        }
+        else {
+            cv::cvtColor(img, gray, (img.channels() == 4) ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+        }
+
+        // Own, continuous memory, as a camera buffer would be
+        return gray(crop).clone();
+    }
+
+    bool GsVirtualCamera::LoadShotFrames(const GsShotArchiveReader& reader, const GsArchivedShot& shot, ShotFrames& frames) {
+
+        frames.name = shot.name;
+
+        if (!reader.GetFrame(shot.teed_ball_frame_name, frames.teed_ball_img) ||
+            !reader.GetFrame(shot.strobed_balls_frame_name, frames.strobed_balls_img)) {
+            GS_LOG_MSG(error, "GsVirtualCamera - The shot archive has no images for shot " + shot.name);
+            return false;
+        }
+
+        const cv::Size frame_size = frames.teed_ball_img.size();
+
+        // As for the ball watcher's sensor crop, the size has to be even
+        const int crop_width = (kVirtualCameraCropWidth > 0) ? std::min(kVirtualCameraCropWidth, frame_size.width) : frame_size.width;
+        const int crop_height = (kVirtualCameraCropHeight > 0) ? std::min(kVirtualCameraCropHeight, frame_size.height) : frame_size.height;
+        const cv::Rect crop((frame_size.width - (crop_width & ~1)) / 2, (frame_size.height - (crop_height & ~1)) / 2,
+                            std::max(crop_width & ~1, 2), std::max(crop_height & ~1, 2));
+
+        cv::Mat recorded_frame;
+
+        for (int i = 0; ; i++) {
+            std::ostringstream frame_name;
+            frame_name << shot.name << "_cam1_" << std::setw(4) << std::setfill('0') << i;
+
+            if (!reader.GetFrame(frame_name.str(), recorded_frame)) {
+                break;
+            }
+
+            if (recorded_frame.size() != frame_size) {
+                GS_LOG_MSG(error, "GsVirtualCamera - " + frame_name.str() + " is not the size of the teed-ball frame.");
+                return false;
+            }
+
+            frames.camera1_frames.push_back(ToWatchedFrame(recorded_frame, crop));
+        }
+
+        if (!frames.camera1_frames.empty()) {
+            GS_LOG_TRACE_MSG(trace, "GsVirtualCamera - playing the " + std::to_string(frames.camera1_frames.size()) +
+                                    " recorded camera 1 frames of shot " + shot.name);
+            frames.hit_frame = -1;
+            return true;
+        }
+
+        // No recording, so the teed ball just sits there until it is "hit".  The repeated
+        // frames share the one image, as nothing writes to them.
+        const cv::Mat teed_ball_frame = ToWatchedFrame(frames.teed_ball_img, crop);
+        cv::Mat hit_frame;
+        cv::bitwise_not(teed_ball_frame, hit_frame);
+
+        frames.camera1_frames.assign(kVirtualCameraPreHitFrames, teed_ball_frame);
+        frames.hit_frame = (int)frames.camera1_frames.size();
+        frames.camera1_frames.insert(frames.camera1_frames.end(), kSyntheticPostHitFrames, hit_frame);
+
+        return true;
+    }
+
+    void GsVirtualCamera::WatchShot(const ShotFrames& frames, WatchResult& result) {
+
+        const cv::Mat& first_frame = frames.camera1_frames.front();
+
+        // The motion ROI is the whole watched frame, as the ball watcher's is the whole crop
+        if (!ConfigurePostProcessing(cv::Vec2i(first_frame.cols, first_frame.rows), cv::Vec2i(0, 0))) {
+            GS_LOG_MSG(error, "GsVirtualCamera - Failed to ConfigurePostProcessing.");
+            return;
+        }
+
+        // There is no app, so the stage is given the (otherwise unused) stream directly
+        libcamera::Stream stream;
+        StreamInfo info;
+        info.width = first_frame.cols;
+        info.height = first_frame.rows;
+        info.stride = (unsigned int)first_frame.step[0];
+
+        MotionDetectStage motion_detect_stage(nullptr);
+        boost::property_tree::ptree empty_params;
+        motion_detect_stage.Read(empty_params);
+        motion_detect_stage.Configure(&stream, info);
+
+        GsWatcherStageChain watcher_chain;
+        watcher_chain.Add(motion_detect_stage);
+        watcher_chain.Configure(&stream, info);
+
+        // The requests are made up front so that the watch does not allocate for them
+        std::vector<CompletedRequestPtr> requests;
+        requests.reserve(frames.camera1_frames.size());
+
+        for (size_t i = 0; i < frames.camera1_frames.size(); i++) {
+            libcamera::ControlList metadata(libcamera::controls::controls);
+            metadata.set(libcamera::controls::SensorTimestamp, (int64_t)0);
+            metadata.set(libcamera::controls::SensorSequence, (int64_t)i);
+            metadata.set(libcamera::controls::FrameDuration, (int64_t)(1.0e6 / kVirtualCameraFps));
+
+            CompletedRequestPtr request = std::make_shared<CompletedRequest>((unsigned int)i, metadata);
+            request->framerate = (i == 0) ? 0.0f : (float)kVirtualCameraFps;
+            requests.push_back(request);
+        }
+
+        const auto frame_interval = std::chrono::nanoseconds((int64_t)(1.0e9 / kVirtualCameraFps));
+        const auto watch_start = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < requests.size() && GolfSimGlobals::golf_sim_running_; i++) {
+
+            // A frame that is late is played as soon as possible, as a camera's queued
+            // buffer would be
+            const auto frame_time = watch_start + (int64_t)i * frame_interval;
+            std::this_thread::sleep_until(frame_time);
+
+            // The same clock as a real SensorTimestamp
+            struct timespec sensor_time;
+            clock_gettime(CLOCK_BOOTTIME, &sensor_time);
+            requests[i]->metadata.set(libcamera::controls::SensorTimestamp, (int64_t)sensor_time.tv_sec * 1000000000 + sensor_time.tv_nsec);
+
+            const auto process_start = std::chrono::steady_clock::now();
+
+            watcher_chain.Process(requests[i], frames.camera1_frames[i].data);
+
+            const auto process_end = std::chrono::steady_clock::now();
+            const int64_t frame_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(process_end - process_start).count();
+
+            result.frames++;
+            result.total_frame_ns += frame_ns;
+            result.max_frame_ns = std::max(result.max_frame_ns, frame_ns);
+            if (process_end > frame_time + frame_interval) {
+                result.late_frames++;
+            }
+
+            if (!motion_detect_stage.GetLastResult()) {
+                continue;
+            }
+
+            // The stage does not send the external trigger in this mode, so this is where
+            // camera 2 would have been triggered
+            GsShotTrace::Mark(GsShotTrace::Stage::kTriggerSent);
+
+            result.motion_detected = true;
+            result.motion_frame = (int)i;
+
+            std::this_thread::sleep_until(process_end + std::chrono::microseconds(kVirtualCameraCam2DelayUs));
+            GsShotTrace::Mark(GsShotTrace::Stage::kCam2FrameReceived);
+
+            if (frames.hit_frame >= 0) {
+                const auto hit_time = watch_start + (int64_t)frames.hit_frame * frame_interval;
+                result.hit_to_cam2_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hit_time).count();
+            }
+
+            if (kVirtualCameraAnalyzeShots) {
+                GolfBall result_ball;
+                cv::Vec3d rotation_results;
+                cv::Mat exposures_image;
+                cv::Mat camera2_pre_image;
+                std::vector<GolfBall> exposure_balls;
+
+                const auto analysis_start = std::chrono::steady_clock::now();
+
+                result.analyzed = GolfSimCamera::ProcessReceivedCam2Image(frames.teed_ball_img, frames.strobed_balls_img, camera2_pre_image,
+                                                                          result_ball, rotation_results, exposures_image, exposure_balls);
+
+                result.analysis_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - analysis_start).count();
+            }
+
+            GsShotTrace::EndShot();
+            break;
+        }
+
+        watcher_chain.LogTimings();
+    }
+
+    std::string GsVirtualCamera::ResultsToJson(const std::vector<ShotFrames>& shots, const std::vector<WatchResult>& results) {
+
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(3);
+        s << "{\"fps\":" << kVirtualCameraFps << ",\"cam2_delay_us\":" << kVirtualCameraCam2DelayUs << ",\"shots\":[";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const ShotFrames& shot = shots[i % shots.size()];
+            const WatchResult& r = results[i];
+
+            s << (i == 0 ? "" : ",") << "{\"name\":\"" << shot.name << "\",\"motion_detected\":" << (r.motion_detected ? "true" : "false")
+                << ",\"hit_frame\":" << shot.hit_frame << ",\"motion_frame\":" << r.motion_frame << ",\"frames\":" << r.frames
+                << ",\"late_frames\":" << r.late_frames
+                << ",\"mean_frame_us\":" << ((r.frames > 0) ? r.total_frame_ns / 1000.0 / r.frames : 0.0)
+                << ",\"max_frame_us\":" << r.max_frame_ns / 1000.0 << ",\"hit_to_cam2_ms\":" << r.hit_to_cam2_ms
+                << ",\"analyzed\":" << (r.analyzed ? "true" : "false") << ",\"analysis_ms\":" << r.analysis_ms << "}";
+        }
+
+        s << "],\"shot_trace\":" << GsShotTrace::GetPercentilesJson() << "}";
+        return s.str();
+    }
+
+    bool GsVirtualCamera::Run() {
+
+        LoadConfigurationValues();
+
+        if (kVirtualCameraShotArchive.empty()) {
+            GS_LOG_MSG(error, "GsVirtualCamera - kVirtualCameraShotArchive is not set.");
+            return false;
+        }
+
+        GsShotArchiveReader archive_reader;
+
+        if (!archive_reader.Open(kVirtualCameraShotArchive)) {
+            return false;
+        }
+
+        std::vector<ShotFrames> shots;
+
+        for (const GsArchivedShot& archived_shot : archive_reader.GetShots()) {
+            ShotFrames frames;
+            if (!LoadShotFrames(archive_reader, archived_shot, frames)) {
+                return false;
+            }
+            shots.push_back(std::move(frames));
+        }
+
+        if (shots.empty()) {
+            GS_LOG_MSG(error, "GsVirtualCamera - No shots in " + kVirtualCameraShotArchive);
+            return false;
+        }
+
+        // Same as RunReplayBenchmark - use whatever (simulated) resolution the recorded images have
+        CameraHardware::resolution_x_override_ = shots[0].teed_ball_img.cols;
+        CameraHardware::resolution_y_override_ = shots[0].teed_ball_img.rows;
+
+        // In this mode, this only loads the strobe timing that the analysis needs
+        if (!PulseStrobe::InitGPIOSystem(nullptr /* Signal handler not needed here */)) {
+            GS_LOG_MSG(error, "Failed to InitGPIOSystem.");
+            return false;
+        }
+
+        std::cout << "Virtual camera: " << shots.size() << " shot(s), " << kVirtualCameraIterations << " iteration(s), at "
+            << kVirtualCameraFps << " FPS\n";
+
+        std::vector<WatchResult> results;
+        unsigned int missed = 0;
+        unsigned int late_frames = 0;
+        uint64_t frames = 0;
+        int64_t total_frame_ns = 0;
+        int64_t max_frame_ns = 0;
+        double total_hit_to_cam2_ms = 0.0;
+        unsigned int timed_hits = 0;
+
+        for (int iteration = 0; iteration < kVirtualCameraIterations && GolfSimGlobals::golf_sim_running_; iteration++) {
+            for (const ShotFrames& shot : shots) {
+                if (!GolfSimGlobals::golf_sim_running_) {
+                    break;
+                }
+
+                WatchResult result;
+                WatchShot(shot, result);
+                results.push_back(result);
+
+                frames += result.frames;
+                late_frames += result.late_frames;
+                total_frame_ns += result.total_frame_ns;
+                max_frame_ns = std::max(max_frame_ns, result.max_frame_ns);
+
+                if (!result.motion_detected) {
+                    missed++;
+                    std::cout << std::left << std::setw(32) << shot.name << std::right << " no motion detected in " << result.frames << " frames\n";
+                    continue;
+                }
+
+                if (shot.hit_frame >= 0) {
+                    total_hit_to_cam2_ms += result.hit_to_cam2_ms;
+                    timed_hits++;
+                }
+
+                std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(32) << shot.name << std::right
+                    << " motion in frame " << std::setw(5) << result.motion_frame;
+                if (shot.hit_frame >= 0) {
+                    std::cout << " (hit in " << shot.hit_frame << "), hit to camera 2 frame " << std::setw(8) << result.hit_to_cam2_ms << " ms";
+                }
+                if (kVirtualCameraAnalyzeShots) {
+                    std::cout << ", analysis " << std::setw(8) << result.analysis_ms << " ms" << (result.analyzed ? "" : " (failed)");
+                }
+                std::cout << "\n";
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(1) << "\n" << results.size() << " watches, " << missed << " without motion.  "
+            << frames << " frames, mean " << ((frames > 0) ? total_frame_ns / 1000.0 / frames : 0.0) << " us, worst "
+            << max_frame_ns / 1000.0 << " us, " << late_frames << " later than the " << 1.0e6 / kVirtualCameraFps << " us frame interval.\n";
+        if (timed_hits > 0) {
+            std::cout << "Mean hit to camera 2 frame: " << total_hit_to_cam2_ms / timed_hits << " ms (of which " << kVirtualCameraCam2DelayUs / 1000.0
+                << " ms is the configured camera 2 delay).\n";
+        }
+        std::cout << "Shot stages: " << GsShotTrace::GetPercentilesJson() << "\n";
+
+        if (!kVirtualCameraResultsFile.empty() && !results.empty()) {
+            std::ofstream results_file(kVirtualCameraResultsFile);
+            results_file << ResultsToJson(shots, results) << "\n";
+
+            if (!results_file) {
+                GS_LOG_MSG(error, "GsVirtualCamera - Could not write " + kVirtualCameraResultsFile);
+                return false;
+            }
+
+            std::cout << "\nResults written to " << kVirtualCameraResultsFile << "\n";
+        }
+
+        return missed == 0;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,98 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A stand-in for both cameras, so that the trigger path can be run and timed end-to-end
+// without any camera hardware, e.g., in CI or on a development machine.
+// Each shot in kVirtualCameraShotArchive (see gs_shot_archive.h) is played as a camera 1
+// watch: its frames are wrapped in CompletedRequests (with the SensorTimestamp and
+// SensorSequence metadata that libcamera would have added) and are paced at
+// kVirtualCameraFps through a GsWatcherStageChain with the same MotionDetectStage that
+// ball_watcher_event_loop runs.  The frames are the shot's recorded camera 1 sequence
+// (frames named <shot name>_cam1_0000, _cam1_0001, ...) if the archive has one.  Otherwise,
+// the teed-ball frame is repeated kVirtualCameraPreHitFrames times and then followed by a
+// copy whose watched region is inverted, which stands in for the ball leaving the tee.
+// Once the motion is detected, the shot's strobed frame is handed over as the camera 2
+// frame kVirtualCameraCam2DelayUs later (i.e., after camera 2's exposure and readout),
+// and is analyzed as the FSM would.
+// Every frame is prepared before a watch starts, so the watch itself does no I/O.  Each
+// shot is traced by GsShotTrace (and so also goes into the GsMetrics histograms), and the
+// frame processing times, the frames that could not keep up with kVirtualCameraFps and the
+// detection delay are printed, and also written as JSON to kVirtualCameraResultsFile.
+// Run with --system_mode=virtual_camera.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace golf_sim {
+
+    class GsShotArchiveReader;
+    struct GsArchivedShot;
+
+    class GsVirtualCamera {
+
+    public:
+        static std::string kVirtualCameraShotArchive;
+        static double kVirtualCameraFps;
+        // The frames of the teed ball before the synthetic hit, when there is no recorded sequence
+        static int kVirtualCameraPreHitFrames;
+        // The time from the trigger to the camera 2 frame being available
+        static int kVirtualCameraCam2DelayUs;
+        // The size of the (centered) region of camera 1's frames that is watched, as the
+        // ball watcher's cropped sensor would deliver it.  0 means the whole frame.
+        static int kVirtualCameraCropWidth;
+        static int kVirtualCameraCropHeight;
+        // If false, the shots end with the camera 2 frame being handed over
+        static bool kVirtualCameraAnalyzeShots;
+        static int kVirtualCameraIterations;
+        // Empty means the results are only printed
+        static std::string kVirtualCameraResultsFile;
+
+        static void LoadConfigurationValues();
+
+        static bool Run();
+
+    private:
+        struct ShotFrames {
+            std::string name;
+            cv::Mat teed_ball_img;
+            cv::Mat strobed_balls_img;
+            // The camera 1 frames to play, single-channel and of the watched size
+            std::vector<cv::Mat> camera1_frames;
+            // The frame in which the ball was hit, or -1 if not known (i.e., for a recorded sequence)
+            int hit_frame = -1;
+        };
+
+        struct WatchResult {
+            bool motion_detected = false;
+            // The frame in which the motion was detected
+            int motion_frame = -1;
+            unsigned int frames = 0;
+            // Frames that were not processed within the frame interval
+            unsigned int late_frames = 0;
+            int64_t total_frame_ns = 0;
+            int64_t max_frame_ns = 0;
+            // From the start of the hit frame's interval to the camera 2 frame being handed over
+            double hit_to_cam2_ms = 0.0;
+            double analysis_ms = 0.0;
+            bool analyzed = false;
+        };
+
+        static bool LoadShotFrames(const GsShotArchiveReader& reader, const GsArchivedShot& shot, ShotFrames& frames);
+
+        static void WatchShot(const ShotFrames& frames, WatchResult& result);
+
+        static std::string ResultsToJson(const std::vector<ShotFrames>& shots, const std::vector<WatchResult>& results);
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
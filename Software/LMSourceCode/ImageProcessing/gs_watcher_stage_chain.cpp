@@ -0,0 +1,144 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "core/rpicam_app.hpp"
+
+#include "logging_tools.h"
+
+#include "gs_watcher_stage_chain.h"
+
+namespace golf_sim {
+
+    uint8_t* GsWatcherFrame::Image(const libcamera::Stream* stream) const {
+        if (stream == nullptr) {
+            return nullptr;
+        }
+
+        if (stream == main_stream) {
+            return main_image;
+        }
+
+        return (stream == lores_stream) ? lores_image : nullptr;
+    }
+
+    const StreamInfo& GsWatcherFrame::Info(const libcamera::Stream* stream) const {
+        return (stream != nullptr && stream == lores_stream) ? lores_info : main_info;
+    }
+
+    GsWatcherStageChain::GsWatcherStageChain(RPiCamApp& app) : app_(&app) {
+    }
+
+    void GsWatcherStageChain::Add(GsWatcherStage& stage) {
+        StageEntry entry;
+        entry.stage = &stage;
+        stages_.push_back(entry);
+    }
+
+    void GsWatcherStageChain::Configure() {
+        frame_ = GsWatcherFrame();
+        frame_.main_stream = app_->VideoStream(&frame_.main_info);
+        frame_.lores_stream = app_->LoresStream(&frame_.lores_info);
+
+        LogStageNames();
+    }
+
+    void GsWatcherStageChain::Configure(libcamera::Stream* main_stream, const StreamInfo& main_info) {
+        frame_ = GsWatcherFrame();
+        frame_.main_stream = main_stream;
+        frame_.main_info = main_info;
+
+        LogStageNames();
+    }
+
+    void GsWatcherStageChain::LogStageNames() const {
+        std::string stage_names;
+        for (const StageEntry& entry : stages_) {
+            stage_names += (stage_names.empty() ? "" : ", ") + std::string(entry.stage->Name());
+        }
+        GS_LOG_TRACE_MSG(trace, "GsWatcherStageChain - stages are: " + stage_names +
+                                (frame_.lores_stream != nullptr ? " (with a lores stream)." : "."));
+    }
+
+    void GsWatcherStageChain::MapStream(CompletedRequestPtr& request, libcamera::Stream* stream, uint8_t*& image) const {
+        image = nullptr;
+
+        if (stream == nullptr || app_ == nullptr) {
+            return;
+        }
+
+        auto buffer = request->buffers.find(stream);
+        if (buffer == request->buffers.end()) {
+            return;
+        }
+
+        // As for BufferReadSync, the read sync was already done when the request completed.
+        // This is just the look-up, without copying the plane list.
+        auto mapped_buffer = app_->mapped_buffers_.find(buffer->second);
+        if (mapped_buffer == app_->mapped_buffers_.end() || mapped_buffer->second.empty()) {
+            return;
+        }
+
+        image = mapped_buffer->second[0].data();
+    }
+
+    bool GsWatcherStageChain::Process(CompletedRequestPtr& request) {
+        MapStream(request, frame_.main_stream, frame_.main_image);
+        MapStream(request, frame_.lores_stream, frame_.lores_image);
+
+        return RunStages(request);
+    }
+
+    bool GsWatcherStageChain::Process(CompletedRequestPtr& request, uint8_t* main_image) {
+        frame_.main_image = main_image;
+        frame_.lores_image = nullptr;
+
+        return RunStages(request);
+    }
+
+    bool GsWatcherStageChain::RunStages(CompletedRequestPtr& request) {
+        frame_.request = &request;
+
+        bool chain_ended = false;
+
+        for (StageEntry& entry : stages_) {
+            auto stage_start = std::chrono::steady_clock::now();
+
+            chain_ended = entry.stage->Process(frame_);
+
+            int64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - stage_start).count();
+            entry.frames++;
+            entry.total_ns += elapsed_ns;
+            entry.max_ns = std::max(entry.max_ns, elapsed_ns);
+
+            if (chain_ended) {
+                break;
+            }
+        }
+
+        frame_.request = nullptr;
+        return chain_ended;
+    }
+
+    void GsWatcherStageChain::LogTimings() const {
+        for (const StageEntry& entry : stages_) {
+            if (entry.frames == 0) {
+                continue;
+            }
+
+            GS_LOG_TRACE_MSG(trace, "GsWatcherStageChain - stage " + std::string(entry.stage->Name()) + " ran on " + std::to_string(entry.frames) +
+                                    " frames, mean " + std::to_string(entry.total_ns / entry.frames / 1000) + " us, worst " +
+                                    std::to_string(entry.max_ns / 1000) + " us.");
+        }
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,109 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// A small, in-process alternative to the rpicam-apps PostProcessor for PiTrac's own
+// per-frame work in the watcher loops (motion detection, the live preview, placement
+// tracking).  The stages are added in the order they should run and are called one after
+// another on the loop's own thread, with no extra threads, futures or JSON-configured
+// stage lookups.  The planes of each request's buffers are looked up once per frame and
+// handed to every stage, instead of each stage doing its own BufferReadSync.
+// The chain times each stage, and LogTimings() reports them once the loop is done, so a
+// stage added to the trigger path cannot add latency without it showing up.
+// A chain without an app (e.g., GsVirtualCamera's) is given its one stream and each
+// frame's image directly instead.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cstdint>
+#include <vector>
+
+#include "core/completed_request.hpp"
+#include "core/stream_info.hpp"
+
+class RPiCamApp;
+
+namespace libcamera {
+    class Stream;
+}
+
+namespace golf_sim {
+
+    // What every stage sees of one frame.  The images are the first (luminance) plane of
+    // each stream, and are null if the app or the request does not have that stream.
+    struct GsWatcherFrame {
+        CompletedRequestPtr* request = nullptr;
+
+        libcamera::Stream* main_stream = nullptr;
+        uint8_t* main_image = nullptr;
+        StreamInfo main_info;
+
+        libcamera::Stream* lores_stream = nullptr;
+        uint8_t* lores_image = nullptr;
+        StreamInfo lores_info;
+
+        // The image of the given stream (one of the two above), or null
+        uint8_t* Image(const libcamera::Stream* stream) const;
+        const StreamInfo& Info(const libcamera::Stream* stream) const;
+    };
+
+    class GsWatcherStage {
+    public:
+        virtual ~GsWatcherStage() = default;
+
+        virtual char const* Name() const = 0;
+
+        // Returns true if the later stages should not see this frame, e.g., because the
+        // shot was just triggered and the loop is about to return
+        virtual bool Process(GsWatcherFrame& frame) = 0;
+    };
+
+    class GsWatcherStageChain {
+    public:
+        explicit GsWatcherStageChain(RPiCamApp& app);
+        // For frames that do not come from an app's buffers
+        GsWatcherStageChain() = default;
+
+        // The stages run in the order that they were added.  The chain does not own them.
+        void Add(GsWatcherStage& stage);
+
+        // Looks up the app's streams.  Must be called after the camera is configured.
+        void Configure();
+        // For a chain without an app, whose frames are all of the one main stream
+        void Configure(libcamera::Stream* main_stream, const StreamInfo& main_info);
+
+        // Runs the stages over the request.  Returns true if one of them ended the chain.
+        // Does not allocate.
+        bool Process(CompletedRequestPtr& request);
+        // As above, but for a chain without an app.  main_image is the frame's luminance plane.
+        bool Process(CompletedRequestPtr& request, uint8_t* main_image);
+
+        // Logs the mean and worst time that each stage took per frame
+        void LogTimings() const;
+
+    private:
+        struct StageEntry {
+            GsWatcherStage* stage = nullptr;
+            unsigned int frames = 0;
+            int64_t total_ns = 0;
+            int64_t max_ns = 0;
+        };
+
+        // Points image at the first plane of the stream's buffer in the request, if any
+        void MapStream(CompletedRequestPtr& request, libcamera::Stream* stream, uint8_t*& image) const;
+        bool RunStages(CompletedRequestPtr& request);
+        void LogStageNames() const;
+
+        // Null if the frames do not come from an app
+        RPiCamApp* app_ = nullptr;
+        std::vector<StageEntry> stages_;
+        // The per-frame fields are filled in by each Process()
+        GsWatcherFrame frame_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
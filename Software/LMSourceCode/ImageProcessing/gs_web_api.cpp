@@ -9,6 +9,11 @@
 #include <sstream>
 #include <iomanip>
 
+#ifdef __unix__
+#include "gs_http_client.h"
+#include "httplib.h"
+#endif
+
 #ifdef _WIN32
 #define popen _popen
 #define pclose _pclose
@@ -18,6 +23,11 @@
 namespace golf_sim {
 
 bool WebApi::UpdateCalibration(const std::string& key, double value) {
+#ifdef __unix__
+    // No process is forked, and a write-back that also sets other keys goes in one request
+    GsHttpClient::PutConfigValue(key, FormatAsJson(value));
+    return true;
+#else
     std::string url = GetWebServerUrl() + "/api/config/" + key;
     std::string payload = "{\"value\": " + FormatAsJson(value) + "}";
     std::string response;
@@ -32,9 +42,14 @@ bool WebApi::UpdateCalibration(const std::string& key, double value) {
     }
     
     return success;
+#endif
 }
 
 bool WebApi::UpdateCalibration(const std::string& key, const std::vector<double>& values) {
+#ifdef __unix__
+    GsHttpClient::PutConfigValue(key, FormatAsJson(values));
+    return true;
+#else
     std::string url = GetWebServerUrl() + "/api/config/" + key;
     std::string payload = "{\"value\": " + FormatAsJson(values) + "}";
     std::string response;
@@ -49,13 +64,23 @@ bool WebApi::UpdateCalibration(const std::string& key, const std::vector<double>
     }
     
     return success;
+#endif
 }
 
 bool WebApi::IsWebServerAvailable() {
+#ifdef __unix__
+    httplib::Client cli(GetWebServerUrl());
+    cli.set_connection_timeout(2);
+    cli.set_read_timeout(2);
+
+    auto res = cli.Get("/health");
+    return res && res->status == 200 && !res->body.empty();
+#else
     std::string url = GetWebServerUrl() + "/health";
     std::string response;
     
     return ExecuteCurl(url, "GET", "", response);
+#endif
 }
 
 std::string WebApi::GetWebServerUrl() {
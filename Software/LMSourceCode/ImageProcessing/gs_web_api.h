@@ -13,7 +13,9 @@ namespace golf_sim {
 class WebApi {
 public:
     // Send calibration update to web server
-    // Returns true if successful, false otherwise
+    // On Linux, the update is queued for GsHttpClient's sender thread (which logs whether
+    // it worked), along with any other updates made before it is sent, and true is
+    // returned.  Otherwise, returns true if successful, false otherwise.
     static bool UpdateCalibration(const std::string& key, double value);
     static bool UpdateCalibration(const std::string& key, const std::vector<double>& values);
     
@@ -14,6 +14,7 @@
 
 #ifdef __unix__  // Ignore in Windows environment
 
+#include <algorithm>
 #include <chrono>
 
 
@@ -29,18 +30,24 @@
 #include "image/image.hpp"
 
 #include <boost/circular_buffer.hpp>
-#include <boost/range/adaptor/reversed.hpp>
 
 #include "gs_camera.h"
 #include "camera_hardware.h"
 #include "gs_options.h"
 #include "gs_config.h"
+#include "gs_config_snapshot.h"
+#include "gs_session_settings.h"
 #include "logging_tools.h"
+#include "gs_startup_cache.h"
+#include "gs_sim_interface.h"
+#include "gs_crop_planner.h"
+#include "gs_exposure_predictor.h"
 
 #include <libcamera/logging.h>
 #include "motion_detect.h"
 #include "libcamera_interface.h"
 #include "ball_image_proc.h"
+#include "gs_v4l2_subdev.h"
 
 
 namespace golf_sim {
@@ -51,6 +58,14 @@ namespace golf_sim {
     uint LibCameraInterface::kMaxWatchingCropWidth = 96;
     uint LibCameraInterface::kMaxWatchingCropHeight = 88;
 
+    bool LibCameraInterface::kUseAdaptiveWatchingRoi = false;
+    uint LibCameraInterface::kMinWatchingCropWidth = 96;
+    uint LibCameraInterface::kMinWatchingCropHeight = 88;
+    double LibCameraInterface::kAdaptiveWatchingRoiExitFraction = 0.5;
+    bool LibCameraInterface::kUseApproachZone = false;
+    uint LibCameraInterface::kApproachZoneMinWidthPixels = 4;
+    int LibCameraInterface::kApproachZoneReleaseFrames = 30;
+
     double LibCameraInterface::kCamera1Gain = 6.0;
     double LibCameraInterface::kCamera1Saturation = 1.0;
     double LibCameraInterface::kCamera1HighFPSGain = 15.0;
@@ -68,6 +83,39 @@ namespace golf_sim {
     long LibCameraInterface::kCamera1StillShutterTimeuS = 15000;
     long LibCameraInterface::kCamera2StillShutterTimeuS = 15000;
 
+    bool LibCameraInterface::kCamera2UndistortRoiOnly = false;
+    double LibCameraInterface::kCamera2UndistortRoiTopFraction = 0.0;
+    double LibCameraInterface::kCamera2UndistortRoiBottomFraction = 1.0;
+    int LibCameraInterface::kCamera2UndistortRoiMarginPixels = 20;
+    bool LibCameraInterface::kCamera2MonoCapture = false;
+    bool LibCameraInterface::kCamera2GpuPreprocessing = false;
+    bool LibCameraInterface::kCamera2PersistentRequests = false;
+    bool LibCameraInterface::kCamera1PersistentStills = false;
+
+    bool LibCameraInterface::kUseBallPlacementWatcher = false;
+    uint LibCameraInterface::kBallPlacementWatcherFPS = 10;
+    int LibCameraInterface::kBallPlacementWatcherFramePeriod = 2;
+    int LibCameraInterface::kBallPlacementWatcherDecimation = 4;
+    int LibCameraInterface::kBallPlacementWatcherRegionHalfSizePixels = 200;
+    int LibCameraInterface::kBallPlacementWatcherPixelDifference = 25;
+    double LibCameraInterface::kBallPlacementWatcherChangedFraction = 0.02;
+    int LibCameraInterface::kBallPlacementWatcherMaxWatchTimeMs = 2000;
+    int LibCameraInterface::kBallPlacementWatcherForcedCheckIntervalMs = 30000;
+
+    bool LibCameraInterface::kUseBallPlacementTracking = false;
+    double LibCameraInterface::kBallPlacementTrackingWindowRadiusRatio = 3.0;
+    double LibCameraInterface::kBallPlacementTrackingMinCorrelation = 0.9;
+    int LibCameraInterface::kBallPlacementTrackingMaxMovePixels = 3;
+    int LibCameraInterface::kBallPlacementBurstFrames = 1;
+    double LibCameraInterface::kBallPlacementBurstMaxMeanDifference = 8.0;
+    int LibCameraInterface::kBallPlacementCaptureDownscale = 1;
+    bool LibCameraInterface::kUseEmptyTeeFastPath = false;
+    double LibCameraInterface::kEmptyTeeMaxMeanDifference = 3.0;
+    int LibCameraInterface::kEmptyTeeMaxAgeMs = 10000;
+
+    bool LibCameraInterface::kBallWatcherDetectOnly = false;
+    bool LibCameraInterface::kBallWatcherRealtimeMode = false;
+
     // Default values are based on empirical measurements using a 6mm lens
     int kCroppedImagePixelOffsetLeft = -5;
     int kCroppedImagePixelOffsetUp = -13;
@@ -81,6 +129,11 @@ namespace golf_sim {
     LibCameraInterface::CameraConfiguration LibCameraInterface::libcamera_configuration_[] = { LibCameraInterface::CameraConfiguration::kNotConfigured, LibCameraInterface::CameraConfiguration::kNotConfigured };
 
     LibcameraJpegApp* LibCameraInterface::libcamera_app_[] = { nullptr, nullptr };
+    bool LibCameraInterface::still_camera_streaming_[] = { false, false };
+    int LibCameraInterface::still_capture_downscale_[] = { 1, 1 };
+
+    LibCameraInterface::UndistortionMapCacheEntry LibCameraInterface::undistortion_map_cache_[2];
+    std::mutex LibCameraInterface::undistortion_map_cache_mutex_;
 
     bool camera_location_found_ = false;
     int previously_found_media_number_ = -1;
@@ -109,30 +162,31 @@ namespace golf_sim {
      * As soon as movement is detected, signals are sent to the camera 2 and strobe to take
      * a picture.
      *
+     * \param camera Camera 1
+     * \param app The ball-watcher app.  It may be re-used from shot to shot (see Camera1Watcher)
      * \param ball The teed-up ball that was previously located in the image
      * \param image The image with the ball
      * \param motion_detected Returns whether motion was detected at the time the method ended
      * \return True iff no error occurred.
      */
-    bool WatchForHitAndTrigger(const GolfBall& ball, cv::Mat& image, bool& motion_detected) {
-
-        const CameraHardware::CameraModel  camera_model = GolfSimCamera::kSystemSlot1CameraType;
-        const CameraHardware::LensType camera_lens_type = GolfSimCamera::kSystemSlot1LensType;
-        const CameraHardware::CameraOrientation camera_orientation = GolfSimCamera::kSystemSlot1CameraOrientation;
-
-        // TBD - refactor this to get rid of the dummy camera necessity
-        GolfSimCamera c;
-        c.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera1, camera_model, camera_lens_type, camera_orientation);
+    bool WatchForHitAndTrigger(GolfSimCamera& camera, RPiCamEncoder& app, const GolfBall& ball, cv::Mat& image, bool& motion_detected) {
 
-        if (!WatchForBallMovement(c, ball, motion_detected)) {
+        if (!WatchForBallMovement(camera, app, ball, motion_detected)) {
             GS_LOG_MSG(error, "Failed to WatchForBallMovement.");
             return false;
         }
 
         // We have access to the set of frames before and after the hit, so process
-        // club data here
+        // club data here.  The frames are handed over rather than copied, as the ring
+        // is configured (and re-allocated) again before the next watch anyway.
+
+        std::vector<RecentFrameInfo> club_strike_frames = RecentFrames.TakeFrames();
+
+        // Before the club data processing, which may take its time
+        GsExposurePredictor::RecordCam1Motion(club_strike_frames, ball);
 
-        if (!GolfSimClubData::ProcessClubStrikeData(RecentFrames)) {
+        // The shot counter was already advanced for this shot before the watch started
+        if (!GolfSimClubData::ProcessClubStrikeData(club_strike_frames, ball, GsSimInterface::GetShotCounter())) {
             GS_LOG_MSG(warning, "Failed to GolfSimClubData::ProcessClubStrikeData(RecentFrames().");
             // TBD - Ignore for now
             // return false;
@@ -141,7 +195,7 @@ namespace golf_sim {
         return true;
     }
 
-    bool WatchForBallMovement(GolfSimCamera& camera, const GolfBall& ball, bool& motion_detected) {
+    bool WatchForBallMovement(GolfSimCamera& camera, RPiCamEncoder& app, const GolfBall& ball, bool& motion_detected) {
 
         if (!GolfSimClubData::Configure()) {
             GS_LOG_TRACE_MSG(warning, "Failed to GolfSimClubData::Configure()");
@@ -151,14 +205,19 @@ namespace golf_sim {
         // Setup the camera to watch at a high FPS by reducing the portion of the sensor that will
         // be processed in each frame (cropping)
 
-        // Will be setup when camera is configured for cropping, then is used in the ball-watcher-loop
-        RPiCamEncoder app;
+        // The app will be setup when camera is configured for cropping, then is used in the ball-watcher-loop
+        const cv::Vec2i prior_watch_resolution = LibCameraInterface::current_watch_resolution_;
 
         if (!ConfigCameraForCropping(ball, camera, app)) {
             GS_LOG_MSG(error, "Failed to ConfigCameraForCropping.");
             return false;
         }
 
+        // A re-used app only has to find the sensor modes again if the cropped sensor has changed size
+        if (LibCameraInterface::current_watch_resolution_ != prior_watch_resolution) {
+            app.ForgetSensorModes();
+        }
+
         // Prepare the camera to watch the small ROI at a high frame rate
         // This flag will be set here locally, but the sending of strobe 
         // pulses will be done within the motion-detection stage to reduce
@@ -177,38 +236,9 @@ namespace golf_sim {
             return false;
         }
 
-        uint frameIndex = 0;
-        unsigned int numFramesToShow = 10;
-
+        // The frames themselves are left in the ring for the club data processing
         if (motion_detected) {
-            std::string frame_information;
-            float average_frame_rate = 0.0;
-            float slowest_frame_rate = 10000.0;
-            float fastest_frame_rate = -10000.0;
-
-            for (auto& it : boost::adaptors::reverse(RecentFrames)) {
-                cv::Mat& mostRecentFrameMat = it.mat;
-
-                frame_information += "Frame " + std::to_string(frameIndex) + ": Framerate = " + std::to_string(it.frameRate) + "\n";
-                average_frame_rate += it.frameRate;
-
-                if (it.frameRate < slowest_frame_rate) {
-                    slowest_frame_rate = it.frameRate;
-                }
-
-                if (it.frameRate > fastest_frame_rate) {
-                    fastest_frame_rate = it.frameRate;
-                }
-
-                if (mostRecentFrameMat.empty()) {
-                    GS_LOG_TRACE_MSG(warning, "Sequence No. " + std::to_string(it.requestSequence) + " was empty.");
-                }
-
-
-                frameIndex++;
-            }
-
-            average_frame_rate /= RecentFrames.size();
+            GS_LOG_TRACE_MSG(trace, "WatchForBallMovement - " + std::to_string(RecentFrames.size()) + " club strike frames were kept.");
         }
 
         return true;
@@ -216,7 +246,7 @@ namespace golf_sim {
 
 
 
-    bool ConfigCameraForCropping(GolfBall ball, GolfSimCamera& camera, RPiCamEncoder& app) {
+    bool ConfigCameraForCropping(const GolfBall& ball, GolfSimCamera& camera, RPiCamEncoder& app) {
 
         // First, determine the cropping window size
 
@@ -237,6 +267,15 @@ namespace golf_sim {
             // cropping area that will still allow for the maximum FPS
             watching_crop_width = LibCameraInterface::kMaxWatchingCropWidth;
             watching_crop_height = LibCameraInterface::kMaxWatchingCropHeight;
+
+            // Otherwise, size the crop to just fit the ball, as a smaller crop allows
+            // for a faster frame rate (down to whatever the sensor can crop to)
+            if (LibCameraInterface::kUseAdaptiveWatchingRoi) {
+                const float ball_diameter = 2.0 * CvUtils::CircleRadius(ball.ball_circle_);
+
+                watching_crop_width = std::clamp(ball_diameter, (float)LibCameraInterface::kMinWatchingCropWidth, (float)LibCameraInterface::kMaxWatchingCropWidth);
+                watching_crop_height = std::clamp(ball_diameter, (float)LibCameraInterface::kMinWatchingCropHeight, (float)LibCameraInterface::kMaxWatchingCropHeight);
+            }
         }
 
         // One issue here is that the current GS camera will not crop any smaller than 98x88.  So, if the ball is smaller
@@ -275,6 +314,13 @@ namespace golf_sim {
         watching_crop_width += ((int)watching_crop_width % 2);
         watching_crop_height += ((int)watching_crop_height % 2);
 
+        // The frame rate only depends on the crop's height, which may be cut down to the motion ROI
+        const GsCropPlan crop_plan = GsCropPlanner::PlanWatchingCrop(cv::Vec2i((int)watching_crop_width, (int)watching_crop_height),
+                                                                     (float)largest_inscribed_square_side_length_of_ball,
+                                                                     GolfSimClubData::kGatherClubData);
+        watching_crop_width = crop_plan.size[0];
+        watching_crop_height = crop_plan.size[1];
+
         // TBD - After all that, and just for the current GS camera, we'll just set the cropping size to the smalllest possible size (for FPS)
         // and either center the ball within that area, or put the ball in the bottom-right of the
         // viewport if we want to see the club data.
@@ -378,10 +424,16 @@ namespace golf_sim {
         // The camera would have been stopped after we took the first picture, so need re-start for this call
         cv::Vec2i cropped_resolution;
         uint cropped_frame_rate_fps;
-        if (!RetrieveCameraInfo(camera.camera_hardware_.camera_number_, cropped_resolution, cropped_frame_rate_fps, true)) {
-            return false;
+        if (!GsStartupCache::LookupCameraInfo(camera.camera_hardware_.camera_number_, watching_crop_size, cropped_resolution, cropped_frame_rate_fps)) {
+            if (!RetrieveCameraInfo(camera.camera_hardware_.camera_number_, cropped_resolution, cropped_frame_rate_fps, true)) {
+                return false;
+            }
+
+            GsStartupCache::StoreCameraInfo(camera.camera_hardware_.camera_number_, watching_crop_size, cropped_resolution, cropped_frame_rate_fps);
         }
 
+        GsCropPlanner::CheckReportedFrameRate(crop_plan, cropped_frame_rate_fps);
+
         if (!ConfigureLibCameraOptions(camera, app, watching_crop_size, cropped_frame_rate_fps)) {
             GS_LOG_TRACE_MSG(error, "Failed to ConfigureLibCameraOptions.");
             return false;
@@ -446,6 +498,21 @@ namespace golf_sim {
             GS_LOG_TRACE_MSG(trace, "Updated roi_offset_y = " + std::to_string(roi_offset_y));
         }
 
+        // The first pixels to change when the ball is struck are at its back, but the club
+        // (and golfer) are also moving there before impact.  So only watch the part of the
+        // ball on the side that it will leave towards.  For a right-handed golfer, the ball
+        // leaves towards the right of the image.
+        if (LibCameraInterface::kUseAdaptiveWatchingRoi && !GolfSimClubData::kGatherClubData) {
+            const float exit_fraction = std::clamp(LibCameraInterface::kAdaptiveWatchingRoiExitFraction, 0.1, 1.0);
+            const float reduced_roi_size_x = std::max(8.0f, std::round(roi_size_x * exit_fraction));
+
+            if (GsSessionSettings::Current().golfer_orientation == GolferOrientation::kRightHanded) {
+                roi_offset_x += (roi_size_x - reduced_roi_size_x);
+            }
+
+            roi_size_x = reduced_roi_size_x;
+        }
+
         roi_offset_x = std::max(roi_offset_x, 0.0f);
         roi_offset_y = std::max(roi_offset_y, 0.0f);
 
@@ -461,11 +528,77 @@ namespace golf_sim {
         cv::Vec2i roi_offset = cv::Vec2i((int)roi_offset_x, (int)roi_offset_y);
         cv::Vec2i roi_size = cv::Vec2i((uint)roi_size_x, (uint)roi_size_y);
 
-        if (!ConfigurePostProcessing(roi_size, roi_offset)) {
+        GS_LOG_MSG(info, "Watching for ball movement with a " + std::to_string(watching_crop_size[0]) + "x" + std::to_string(watching_crop_size[1]) +
+                   " crop at " + std::to_string(cropped_frame_rate_fps) + " FPS.  Motion ROI is " + std::to_string(roi_size[0]) + "x" +
+                   std::to_string(roi_size[1]) + " at (" + std::to_string(roi_offset[0]) + ", " + std::to_string(roi_offset[1]) + ")" +
+                   (LibCameraInterface::kUseAdaptiveWatchingRoi ? " (adaptive)." : "."));
+
+        // The club is on its way once it is in the part of the crop behind the ball.  The zone
+        // has the same rows as the ROI, as the club head comes in level with the ball.
+        cv::Rect approach_roi;
+
+        if (LibCameraInterface::kUseApproachZone) {
+            const float ball_radius = CvUtils::CircleRadius(ball.ball_circle_);
+            // See the club-strike skew of the crop offset above
+            const float ball_center_x = GolfSimClubData::kGatherClubData ? (watching_crop_width - 0.5f * largest_inscribed_square_side_length_of_ball) : 0.5f * watching_crop_width;
+
+            int approach_x = 0;
+            int approach_width = 0;
+
+            if (GsSessionSettings::Current().golfer_orientation == GolferOrientation::kRightHanded) {
+                approach_width = (int)(ball_center_x - ball_radius);
+            }
+            else {
+                approach_x = (int)std::ceil(ball_center_x + ball_radius);
+                approach_width = (int)watching_crop_width - approach_x;
+            }
+
+            if (approach_width >= (int)LibCameraInterface::kApproachZoneMinWidthPixels) {
+                approach_roi = cv::Rect(approach_x, roi_offset[1], approach_width, roi_size[1]);
+
+                GS_LOG_MSG(info, "Watching for the club with a " + std::to_string(approach_roi.width) + "x" + std::to_string(approach_roi.height) +
+                           " approach zone at (" + std::to_string(approach_roi.x) + ", " + std::to_string(approach_roi.y) + ").");
+            }
+            else {
+                GS_LOG_MSG(warning, "The watching crop has only " + std::to_string(std::max(approach_width, 0)) + " pixels behind the ball, which is less than kApproachZoneMinWidthPixels.  " +
+                           "The trigger will not be pre-armed.  A wider kMinWatchingCropWidth/kMaxWatchingCropWidth would leave more room.");
+            }
+        }
+
+        if (!ConfigurePostProcessing(roi_size, roi_offset, approach_roi)) {
             GS_LOG_TRACE_MSG(error, "Failed to ConfigurePostProcessing.");
             return false;
         }
 
+        // Have the ISP produce a second, scaled-down stream for the motion detector
+        // so that it does not have to decimate the main stream itself.  The main
+        // stream is still there for the club-strike frames and logged images.
+        if (MotionDetectStage::incoming_configuration.use_lores_stream) {
+            const int hskip = std::max(MotionDetectStage::incoming_configuration.hskip, 1);
+            const int vskip = std::max(MotionDetectStage::incoming_configuration.vskip, 1);
+
+            VideoOptions* options = app.GetOptions();
+            options->Set().lores_width = std::max(2, (watching_crop_size[0] / hskip) & ~1);
+            options->Set().lores_height = std::max(2, (watching_crop_size[1] / vskip) & ~1);
+
+            GS_LOG_TRACE_MSG(trace, "Motion detection lores stream will be " + std::to_string(options->Get().lores_width) +
+                             "x" + std::to_string(options->Get().lores_height));
+        }
+
+        // Instead of having the motion detector throw away all but every frame_period'th frame
+        // (after the sensor, ISP and watcher thread have already dealt with each of them), run
+        // the sensor at the sampled rate.  The shutter speed stays that of the full rate.  The
+        // club strike frames need the full rate, so they are left alone.
+        MotionDetectStage::Config& motion_configuration = MotionDetectStage::incoming_configuration;
+
+        if (motion_configuration.use_sensor_frame_skipping && motion_configuration.frame_period > 1 && !GolfSimClubData::kGatherClubData) {
+            VideoOptions* options = app.GetOptions();
+            options->Set().framerate = (float)cropped_frame_rate_fps / motion_configuration.frame_period;
+            motion_configuration.frame_period = 0;
+
+            GS_LOG_TRACE_MSG(trace, "Sensor frame skipping - running the watching crop at " + std::to_string(options->Get().framerate.value_or(0)) + " FPS");
+        }
+
 
         // Save the current cropping setup in hopes that we might be able to
         // avoid another media-ctl call next time if we are going to use the same
@@ -492,6 +625,18 @@ bool DiscoverCameraLocation(const GsCameraNumber camera_number, int& media_numbe
         return true;
     }
 
+    // Look for the sensors through the media controller API first.  The media-ctl script
+    // below is only a fallback now.
+    GsV4l2Subdev::CameraLocation location;
+
+    if (GsV4l2Subdev::GetCameraLocation(camera_number, location) && location.device_number >= 0) {
+        media_number = location.media_number;
+        device_number = location.device_number;
+        return true;
+    }
+
+    GS_LOG_MSG(warning, "DiscoverCameraLocation - could not find the camera through the media controller.  Trying media-ctl.");
+
     // Otherwise, go out and search all of the possible places to search for the camera
     const std::string pitrac_root = std::getenv("PITRAC_ROOT");
 
@@ -654,6 +799,16 @@ bool DiscoverCameraLocation(const GsCameraNumber camera_number, int& media_numbe
 
 bool SendCameraCroppingCommand(const GolfSimCamera& camera, cv::Vec2i& cropping_window_size, cv::Vec2i& cropping_window_offset) {
 
+    // The sensor cannot be re-cropped while it is streaming
+    ReleasePersistentStillCamera(camera.camera_hardware_.camera_number_);
+
+    if (GsV4l2Subdev::SetCrop(camera.camera_hardware_.camera_number_, camera.camera_hardware_.camera_is_mono(),
+                              cropping_window_size, cropping_window_offset)) {
+        return true;
+    }
+
+    GS_LOG_MSG(warning, "SendCameraCroppingCommand - could not crop the sensor directly.  Trying media-ctl.");
+
     std::string mediaCtlCmd = GetCmdLineForMediaCtlCropping(camera, cropping_window_size, cropping_window_offset);
     int cmdResult = system(mediaCtlCmd.c_str());
 
@@ -665,7 +820,7 @@ bool SendCameraCroppingCommand(const GolfSimCamera& camera, cv::Vec2i& cropping_
 }
 
 
-bool ConfigurePostProcessing(const cv::Vec2i& roi_size, const cv::Vec2i& roi_offset ) {
+bool ConfigurePostProcessing(const cv::Vec2i& roi_size, const cv::Vec2i& roi_offset, const cv::Rect& approach_roi) {
 
     float kDifferenceM = 0.;
     float kDifferenceC = 0.;
@@ -674,18 +829,46 @@ bool ConfigurePostProcessing(const cv::Vec2i& roi_size, const cv::Vec2i& roi_off
     uint kFramePeriod = 0;
     uint kHSkip = 0;
     uint kVSkip = 0;
+    bool kUseLoresStream = false;
+    bool kUseSensorFrameSkipping = false;
+    bool kUseBackgroundModel = false;
+    int kBackgroundModelScreenStride = 4;
+
+    // This runs on every re-arm, so use the values that were already parsed into the snapshot
+    const std::shared_ptr<const GsConfigSnapshot> snapshot = GsConfigSnapshot::Current();
+
+    if (snapshot) {
+        const GsConfigSnapshot::MotionDetectValues& values = snapshot->GetMotionDetectValues();
+        kDifferenceM = values.difference_m;
+        kDifferenceC = values.difference_c;
+        kRegionThreshold = values.region_threshold;
+        kMaxRegionThreshold = values.max_region_threshold;
+        kFramePeriod = values.frame_period;
+        kHSkip = values.hskip;
+        kVSkip = values.vskip;
+        kUseLoresStream = values.use_lores_stream;
+        kUseSensorFrameSkipping = values.use_sensor_frame_skipping;
+        kUseBackgroundModel = values.use_background_model;
+        kBackgroundModelScreenStride = values.background_model_screen_stride;
+        kCroppedImagePixelOffsetLeft = values.cropped_image_pixel_offset_left;
+        kCroppedImagePixelOffsetUp = values.cropped_image_pixel_offset_up;
+    }
+    else {
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kDifferenceM", kDifferenceM);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kDifferenceC", kDifferenceC);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kRegionThreshold", kRegionThreshold);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kMaxRegionThreshold", kMaxRegionThreshold);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kFramePeriod", kFramePeriod);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kHSkip", kHSkip);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kVSkip", kVSkip);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kUseLoresStream", kUseLoresStream);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kUseSensorFrameSkipping", kUseSensorFrameSkipping);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kUseBackgroundModel", kUseBackgroundModel);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kBackgroundModelScreenStride", kBackgroundModelScreenStride);
 
-
-    GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kDifferenceM", kDifferenceM);
-    GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kDifferenceC", kDifferenceC);
-    GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kRegionThreshold", kRegionThreshold);
-    GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kMaxRegionThreshold", kMaxRegionThreshold);
-    GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kFramePeriod", kFramePeriod);
-    GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kHSkip", kHSkip);
-    GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kVSkip", kVSkip);
-
-    GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kCroppedImagePixelOffsetLeft", kCroppedImagePixelOffsetLeft);
-    GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kCroppedImagePixelOffsetUp", kCroppedImagePixelOffsetUp);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kCroppedImagePixelOffsetLeft", kCroppedImagePixelOffsetLeft);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kCroppedImagePixelOffsetUp", kCroppedImagePixelOffsetUp);
+    }
 
     // These values will be used within the motion-detect post-processing
 
@@ -707,6 +890,18 @@ bool ConfigurePostProcessing(const cv::Vec2i& roi_size, const cv::Vec2i& roi_off
     MotionDetectStage::incoming_configuration.vskip = kVSkip;
     MotionDetectStage::incoming_configuration.verbose = 2;
     MotionDetectStage::incoming_configuration.showroi = true;
+    MotionDetectStage::incoming_configuration.use_lores_stream = kUseLoresStream;
+    MotionDetectStage::incoming_configuration.use_sensor_frame_skipping = kUseSensorFrameSkipping;
+    MotionDetectStage::incoming_configuration.use_background_model = kUseBackgroundModel;
+    MotionDetectStage::incoming_configuration.background_screen_stride = kBackgroundModelScreenStride;
+    MotionDetectStage::incoming_configuration.realtime_mode = LibCameraInterface::kBallWatcherRealtimeMode;
+
+    MotionDetectStage::incoming_configuration.use_approach_zone = !approach_roi.empty();
+    MotionDetectStage::incoming_configuration.approach_roi_x = approach_roi.x;
+    MotionDetectStage::incoming_configuration.approach_roi_y = approach_roi.y;
+    MotionDetectStage::incoming_configuration.approach_roi_width = approach_roi.width;
+    MotionDetectStage::incoming_configuration.approach_roi_height = approach_roi.height;
+    MotionDetectStage::incoming_configuration.approach_release_frames = LibCameraInterface::kApproachZoneReleaseFrames;
 
     return true;
 }
@@ -716,12 +911,15 @@ bool ConfigureLibCameraOptions(const GolfSimCamera& camera, RPiCamEncoder& app,
 
     GsCameraNumber camera_number = camera.camera_hardware_.camera_number_;
 
+    // The video pipeline is about to open the same camera
+    ReleasePersistentStillCamera(camera_number);
+
     VideoOptions* options = app.GetOptions();
 
     char dummy_arguments[] = "DummyExecutableName";
     char* argv[] = { dummy_arguments, NULL };
 
-    if (!options->Parse(1, argv))
+    if (!options->ParseOnce(1, argv))
     {
         GS_LOG_TRACE_MSG(trace, "failed to parse dummy command line.");
         return false;
@@ -838,6 +1036,10 @@ std::string GetCmdLineForMediaCtlCropping(const GolfSimCamera &camera, cv::Vec2i
 
 bool RetrieveCameraInfo(const GsCameraNumber camera_number, cv::Vec2i& resolution, uint& frameRate, bool restartCamera) {
 
+    if (restartCamera) {
+        ReleasePersistentStillCamera(camera_number);
+    }
+
     LibcameraJpegApp app;
 
     if (restartCamera) {
@@ -849,7 +1051,7 @@ bool RetrieveCameraInfo(const GsCameraNumber camera_number, cv::Vec2i& resolutio
             char dummy_arguments[] = "DummyExecutableName";
             char* argv[] = { dummy_arguments, NULL };
 
-            if (options->Parse(1, argv))
+            if (options->ParseOnce(1, argv))
             {
                 if (options->Set().verbose >= 2)
                     options->Set().Print();
@@ -914,6 +1116,108 @@ bool RetrieveCameraInfo(const GsCameraNumber camera_number, cv::Vec2i& resolutio
 
 
 
+// Returns true only if both matrices have the same shape, type and contents
+static bool CalibrationMatsAreIdentical(const cv::Mat& a, const cv::Mat& b) {
+
+    if (a.empty() || b.empty()) {
+        return a.empty() && b.empty();
+    }
+
+    if (a.size() != b.size() || a.type() != b.type()) {
+        return false;
+    }
+
+    return cv::norm(a, b, cv::NORM_INF) == 0.0;
+}
+
+
+bool LibCameraInterface::UndistortionMapsAreCurrent(const UndistortionMapCacheEntry& entry,
+                                                    const GolfSimCamera& camera,
+                                                    const cv::Size& image_size) {
+    return entry.valid &&
+        entry.image_size == image_size &&
+        entry.is_mono == camera.camera_hardware_.camera_is_mono() &&
+        CalibrationMatsAreIdentical(entry.calibration_matrix, camera.camera_hardware_.calibrationMatrix_) &&
+        CalibrationMatsAreIdentical(entry.distortion_vector, camera.camera_hardware_.cameraDistortionVector_);
+}
+
+
+LibCameraInterface::UndistortionMapCacheEntry& LibCameraInterface::GetUndistortionMaps(const GolfSimCamera& camera, const cv::Size& image_size) {
+
+    GsCameraNumber camera_number = camera.camera_hardware_.camera_number_;
+    int camera_slot_number = (camera_number == GsCameraNumber::kGsCamera1) ? 0 : 1;
+    UndistortionMapCacheEntry& entry = undistortion_map_cache_[camera_slot_number];
+
+    if (UndistortionMapsAreCurrent(entry, camera, image_size)) {
+        return entry;
+    }
+
+    GS_LOG_TRACE_MSG(trace, "Building undistortion maps for camera " + std::to_string((int)camera_number) +
+                            " at " + std::to_string(image_size.width) + "x" + std::to_string(image_size.height));
+
+    // Get the calibration values from the camera
+    // Clone them so that a later change to the camera's calibration will be noticed
+    entry.calibration_matrix = camera.camera_hardware_.calibrationMatrix_.clone();
+    entry.distortion_vector = camera.camera_hardware_.cameraDistortionVector_.clone();
+    entry.image_size = image_size;
+    entry.is_mono = camera.camera_hardware_.camera_is_mono();
+
+    if (GsStartupCache::LoadUndistortionMaps(entry.calibration_matrix, entry.distortion_vector, image_size, entry.is_mono, entry.map1, entry.map2)) {
+        entry.valid = true;
+        return entry;
+    }
+
+    if (entry.is_mono) {
+        cv::initUndistortRectifyMap(entry.calibration_matrix, entry.distortion_vector, cv::Mat(), entry.calibration_matrix, image_size, CV_8UC1, entry.map1, entry.map2);
+    }
+    else {
+        cv::initUndistortRectifyMap(entry.calibration_matrix, entry.distortion_vector, cv::Mat(), entry.calibration_matrix, image_size, CV_32FC1, entry.map1, entry.map2);
+    }
+
+    GsStartupCache::StoreUndistortionMaps(entry.calibration_matrix, entry.distortion_vector, image_size, entry.is_mono, entry.map1, entry.map2);
+
+    entry.valid = true;
+
+    return entry;
+}
+
+
+bool LibCameraInterface::PrepareUndistortionMaps(const GolfSimCamera& camera, const cv::Size& image_size) {
+
+    if (!camera.camera_hardware_.use_undistortion_matrix_) {
+        GS_LOG_TRACE_MSG(trace, "PrepareUndistortionMaps - camera " + std::to_string((int)camera.camera_hardware_.camera_number_) + " has no undistortion matrix.  Nothing to do.");
+        return true;
+    }
+
+    if (image_size.width <= 0 || image_size.height <= 0) {
+        GS_LOG_MSG(error, "PrepareUndistortionMaps called with an invalid image size.");
+        return false;
+    }
+
+    try {
+        std::lock_guard<std::mutex> lock(undistortion_map_cache_mutex_);
+        GetUndistortionMaps(camera, image_size);
+    }
+    catch (std::exception const& e)
+    {
+        GS_LOG_MSG(error, "ERROR in PrepareUndistortionMaps: *** " + std::string(e.what()) + " ***");
+        return false;
+    }
+
+    return true;
+}
+
+
+void LibCameraInterface::InvalidateUndistortionMapCache() {
+
+    std::lock_guard<std::mutex> lock(undistortion_map_cache_mutex_);
+
+    for (UndistortionMapCacheEntry& entry : undistortion_map_cache_) {
+        entry = UndistortionMapCacheEntry();
+    }
+}
+
+
 cv::Mat LibCameraInterface::undistort_camera_image(const cv::Mat& img, const GolfSimCamera& camera) {
 
     if (!camera.camera_hardware_.use_undistortion_matrix_) {
@@ -921,27 +1225,184 @@ cv::Mat LibCameraInterface::undistort_camera_image(const cv::Mat& img, const Gol
         return img;
     }
 
-    GsCameraNumber camera_number = camera.camera_hardware_.camera_number_;
-    CameraHardware::CameraModel camera_model = camera.camera_hardware_.camera_model_;
-
-    // Get the calibration values from the camera
+    // The cv::Mat headers share (reference-count) the underlying map data, so holding
+    // copies of them lets us do the remap outside of the lock.
+    cv::Mat map1, map2;
 
-    cv::Mat cameracalibrationMatrix_ = camera.camera_hardware_.calibrationMatrix_;
-    cv::Mat cameraDistortionVector_ = camera.camera_hardware_.cameraDistortionVector_;
+    {
+        std::lock_guard<std::mutex> lock(undistortion_map_cache_mutex_);
+        const UndistortionMapCacheEntry& entry = GetUndistortionMaps(camera, cv::Size(img.cols, img.rows));
+        map1 = entry.map1;
+        map2 = entry.map2;
+    }
 
     cv::Mat unDistortedBall1Img;
-    cv::Mat m_undistMap1, m_undistMap2;
+    cv::remap(img, unDistortedBall1Img, map1, map2, cv::INTER_LINEAR);
 
-    if (camera.camera_hardware_.camera_is_mono()) {
-        cv::initUndistortRectifyMap(cameracalibrationMatrix_, cameraDistortionVector_, cv::Mat(), cameracalibrationMatrix_, cv::Size(img.cols, img.rows), CV_8UC1, m_undistMap1, m_undistMap2);
+    return unDistortedBall1Img;
+}
+
+
+unsigned int LibCameraInterface::GetCamera2ViewfinderFlags() {
+
+    if (kCamera2MonoCapture && GolfSimCamera::kSystemSlot2CameraType == CameraHardware::CameraModel::InnoMakerIMX296GS_Mono) {
+        // No flags gets us the default YUV420 viewfinder format, whose first plane is the Y plane
+        return 0;
     }
-    else {
-        cv::initUndistortRectifyMap(cameracalibrationMatrix_, cameraDistortionVector_, cv::Mat(), cameracalibrationMatrix_, cv::Size(img.cols, img.rows), CV_32FC1, m_undistMap1, m_undistMap2);
+
+    return RPiCamApp::FLAG_STILL_RGB;
+}
+
+
+cv::Rect LibCameraInterface::GetCamera2UndistortionRoi(const cv::Size& image_size) {
+
+    double top_fraction = kCamera2UndistortRoiTopFraction;
+    double bottom_fraction = kCamera2UndistortRoiBottomFraction;
+
+    // Keep this consistent with GolfSimCamera::AnalyzeStrobedBalls, which only looks
+    // in the lower half of the image when putting
+    if (GsSessionSettings::ShotSettings().club_type == GolfSimClubs::kPutter) {
+        top_fraction = 0.5;
+        bottom_fraction = 1.0;
     }
 
-    cv::remap(img, unDistortedBall1Img, m_undistMap1, m_undistMap2, cv::INTER_LINEAR);
+    int top = (int)(top_fraction * image_size.height) - kCamera2UndistortRoiMarginPixels;
+    int bottom = (int)(bottom_fraction * image_size.height) + kCamera2UndistortRoiMarginPixels;
 
-    return unDistortedBall1Img;
+    cv::Rect roi(0, top, image_size.width, bottom - top);
+
+    return roi & cv::Rect(0, 0, image_size.width, image_size.height);
+}
+
+
+cv::Mat LibCameraInterface::undistort_camera_image_roi(const cv::Mat& img, const GolfSimCamera& camera, const cv::Rect& roi) {
+
+    const cv::Rect clipped_roi = roi & cv::Rect(0, 0, img.cols, img.rows);
+
+    if (clipped_roi.empty() || clipped_roi.area() == img.cols * img.rows) {
+        return undistort_camera_image(img, camera);
+    }
+
+    if (!camera.camera_hardware_.use_undistortion_matrix_) {
+        GS_LOG_MSG(trace, "undistort_camera_image_roi ignoring camera with no undistortion matrix. Returning original roi.");
+        return img(clipped_roi).clone();
+    }
+
+    cv::Mat map1, map2;
+
+    {
+        std::lock_guard<std::mutex> lock(undistortion_map_cache_mutex_);
+        const UndistortionMapCacheEntry& entry = GetUndistortionMaps(camera, cv::Size(img.cols, img.rows));
+        map1 = entry.map1;
+        map2 = entry.map2;
+    }
+
+    // The maps hold absolute source coordinates, so remapping just the roi of the maps
+    // against the whole source image gives the same pixels as the full-frame remap would.
+    // remap allocates only the roi-sized result, so nothing outside of the roi is copied.
+    cv::Mat unDistortedRoi;
+    cv::remap(img, unDistortedRoi, map1(clipped_roi), map2.empty() ? map2 : map2(clipped_roi), cv::INTER_LINEAR);
+
+    return unDistortedRoi;
+}
+
+
+void LibCameraInterface::undistort_camera_image_into(const cv::Mat& img, const GolfSimCamera& camera, const cv::Rect& roi, cv::Mat& undistorted_img) {
+
+    if (!camera.camera_hardware_.use_undistortion_matrix_) {
+        img.copyTo(undistorted_img);
+        return;
+    }
+
+    const cv::Rect clipped_roi = roi & cv::Rect(0, 0, img.cols, img.rows);
+    const bool full_frame = clipped_roi.empty() || clipped_roi.area() == img.cols * img.rows;
+
+    cv::Mat map1, map2;
+
+    {
+        std::lock_guard<std::mutex> lock(undistortion_map_cache_mutex_);
+        const UndistortionMapCacheEntry& entry = GetUndistortionMaps(camera, cv::Size(img.cols, img.rows));
+        map1 = entry.map1;
+        map2 = entry.map2;
+    }
+
+    if (full_frame) {
+        // remap only allocates if undistorted_img is not already the right size and type
+        cv::remap(img, undistorted_img, map1, map2, cv::INTER_LINEAR);
+        return;
+    }
+
+    undistorted_img.create(img.size(), img.type());
+
+    // Copy only the (distorted) pixels around the roi, as the roi itself is about to be
+    // overwritten by the remap
+    const cv::Rect outside_rects[] = {
+        cv::Rect(0, 0, img.cols, clipped_roi.y),
+        cv::Rect(0, clipped_roi.br().y, img.cols, img.rows - clipped_roi.br().y),
+        cv::Rect(0, clipped_roi.y, clipped_roi.x, clipped_roi.height),
+        cv::Rect(clipped_roi.br().x, clipped_roi.y, img.cols - clipped_roi.br().x, clipped_roi.height) };
+
+    for (const cv::Rect& outside_rect : outside_rects) {
+        if (!outside_rect.empty()) {
+            img(outside_rect).copyTo(undistorted_img(outside_rect));
+        }
+    }
+
+    cv::Mat undistorted_roi = undistorted_img(clipped_roi);
+    cv::remap(img, undistorted_roi, map1(clipped_roi), map2.empty() ? map2 : map2(clipped_roi), cv::INTER_LINEAR);
+}
+
+
+bool LibCameraInterface::undistort_camera_image_to_gray_gpu(const cv::Mat& img, const GsGpuFrameBuffer* frame_buffer,
+                                                            const GolfSimCamera& camera, cv::Mat& gray_img) {
+
+    GsGpuPreprocess* gpu = GsGpuPreprocess::Instance();
+
+    if (gpu == nullptr) {
+        return false;
+    }
+
+    cv::Mat map1, map2;
+
+    if (camera.camera_hardware_.use_undistortion_matrix_) {
+        std::lock_guard<std::mutex> lock(undistortion_map_cache_mutex_);
+        const UndistortionMapCacheEntry& entry = GetUndistortionMaps(camera, cv::Size(img.cols, img.rows));
+        map1 = entry.map1;
+        map2 = entry.map2;
+    }
+
+    return gpu->UndistortToGray(img, frame_buffer, map1, map2, gray_img);
+}
+
+
+bool LibCameraInterface::undistort_points(const std::vector<cv::Point2f>& distorted_points,
+                                          std::vector<cv::Point2f>& undistorted_points,
+                                          const GolfSimCamera& camera) {
+
+    if (!camera.camera_hardware_.use_undistortion_matrix_) {
+        undistorted_points = distorted_points;
+        return true;
+    }
+
+    if (distorted_points.empty()) {
+        undistorted_points.clear();
+        return true;
+    }
+
+    try {
+        // Passing the calibration matrix as the new projection matrix keeps the results
+        // in pixel coordinates instead of normalized coordinates
+        const cv::Mat& calibration_matrix = camera.camera_hardware_.calibrationMatrix_;
+        cv::undistortPoints(distorted_points, undistorted_points, calibration_matrix,
+                            camera.camera_hardware_.cameraDistortionVector_, cv::noArray(), calibration_matrix);
+    }
+    catch (std::exception const& e)
+    {
+        GS_LOG_MSG(error, "ERROR in undistort_points: *** " + std::string(e.what()) + " ***");
+        return false;
+    }
+
+    return true;
 }
 
 
@@ -963,11 +1424,11 @@ bool ConfigCameraForFullScreenWatching(const GolfSimCamera& c) {
     }
 
     // Ensure no cropping and full resolution on the camera
-    std::string mediaCtlCmd = GetCmdLineForMediaCtlCropping(c, cv::Vec2i(width, height), cv::Vec2i(0, 0));
-    int cmdResult = system(mediaCtlCmd.c_str());
+    cv::Vec2i full_screen_size(width, height);
+    cv::Vec2i no_offset(0, 0);
 
-    if (cmdResult != 0) {
-        GS_LOG_MSG(error, "system(mediaCtlCmd) failed.");
+    if (!SendCameraCroppingCommand(c, full_screen_size, no_offset)) {
+        GS_LOG_MSG(error, "ConfigCameraForFullScreenWatching - failed to SendCameraCroppingCommand.");
         return false;
     }
 
@@ -1020,7 +1481,7 @@ bool SetLibcameraTuningFileEnvVariable(const GolfSimCamera& camera) {
 }
 
 
-LibcameraJpegApp* ConfigureForLibcameraStill(const GolfSimCamera& camera) {
+LibcameraJpegApp* ConfigureForLibcameraStill(const GolfSimCamera& camera, int downscale) {
 
     const GsCameraNumber camera_number = camera.camera_hardware_.camera_number_;
     int hardware_camera_index = camera_number;
@@ -1062,7 +1523,7 @@ LibcameraJpegApp* ConfigureForLibcameraStill(const GolfSimCamera& camera) {
         char dummy_arguments[] = "DummyExecutableName";
         char* argv[] = { dummy_arguments, NULL };
 
-        if (!options->Parse(1, argv))
+        if (!options->ParseOnce(1, argv))
         {
             GS_LOG_TRACE_MSG(error, "failed to parse dummy command line.");
             return nullptr;
@@ -1154,6 +1615,14 @@ LibcameraJpegApp* ConfigureForLibcameraStill(const GolfSimCamera& camera) {
             return nullptr;
         }
 
+        // The ISP does the scaling down, so the sensor still reads out the whole (undistortable) field
+        // of view.  libcamera wants even sizes.
+        if (downscale > 1) {
+            options->Set().width = (camera.camera_hardware_.resolution_x_ / downscale) & ~1u;
+            options->Set().height = (camera.camera_hardware_.resolution_y_ / downscale) & ~1u;
+            GS_LOG_TRACE_MSG(trace, "Still picture downscaled to " + std::to_string(options->Set().width) + "x" + std::to_string(options->Set().height) + ".");
+        }
+
         if (options->Set().verbose >= 2)
             options->Set().Print();
 
@@ -1171,6 +1640,7 @@ LibcameraJpegApp* ConfigureForLibcameraStill(const GolfSimCamera& camera) {
 
     // Note the type of configuration we've done
     lci::libcamera_configuration_[hardware_camera_index] = lci::CameraConfiguration::kStillPicture;
+    lci::still_capture_downscale_[hardware_camera_index] = downscale;
 
     return app;
 }
@@ -1208,19 +1678,69 @@ bool DeConfigureForLibcameraStill(const GsCameraNumber camera_number) {
 
 
 
+bool ReleasePersistentStillCamera(const GsCameraNumber camera_number) {
+
+    if (!lci::still_camera_streaming_[camera_number]) {
+        return true;
+    }
+
+    GS_LOG_TRACE_MSG(trace, "Releasing the persistent still pipeline of camera " + std::to_string((int)camera_number + 1) + ".");
+
+    lci::still_camera_streaming_[camera_number] = false;
+
+    return DeConfigureForLibcameraStill(camera_number);
+}
+
+
+
 // Actually from libcamera_jpeg code, not libcamera_still
-bool TakeLibcameraStill(const GolfSimCamera &camera, cv::Mat& img) {
+bool TakeLibcameraStill(const GolfSimCamera &camera, cv::Mat& img,
+                        const std::function<bool(const cv::Mat&)>& frame_handler,
+                        int downscale) {
+
+    const GsCameraNumber camera_number = camera.camera_hardware_.camera_number_;
+
+    downscale = std::max(1, downscale);
 
-    LibcameraJpegApp *app = ConfigureForLibcameraStill(camera);
+    // Bursts start and stop the camera themselves
+    const bool persistent = LibCameraInterface::kCamera1PersistentStills && camera_number == GsCameraNumber::kGsCamera1 && !frame_handler;
+
+    // A pipeline that was left running at another output size has to be re-configured
+    if (!persistent || lci::still_capture_downscale_[camera_number] != downscale) {
+        ReleasePersistentStillCamera(camera_number);
+    }
+
+    LibcameraJpegApp *app = ConfigureForLibcameraStill(camera, downscale);
 
     if (app == nullptr) {
         GS_LOG_TRACE_MSG(error, "failed to ConfigureForLibcameraStill.");
         return false;
     }
 
+    if (persistent) {
+        bool success = false;
+
+        try
+        {
+            success = persistent_still_event_loop(*app, img, lci::still_camera_streaming_[camera_number]);
+        }
+        catch (std::exception const& e)
+        {
+            GS_LOG_MSG(error, "ERROR: *** " + std::string(e.what()) + " ***");
+        }
+
+        // Start from scratch next time
+        if (!success) {
+            GS_LOG_TRACE_MSG(error, "failed to take a persistent still.");
+            ReleasePersistentStillCamera(camera_number);
+        }
+
+        return success;
+    }
+
     try
     {
-        still_image_event_loop(*app, img);
+        still_image_event_loop(*app, img, frame_handler);
     }
     catch (std::exception const& e)
     {
@@ -1238,8 +1758,22 @@ bool TakeLibcameraStill(const GolfSimCamera &camera, cv::Mat& img) {
 
 
 
+// Scales a downscaled still (see kBallPlacementCaptureDownscale) back up to the camera's full
+// resolution, which is what the undistortion maps and the ball search expect
+static cv::Mat ToFullResolution(const cv::Mat& img, const GolfSimCamera& camera) {
+    const cv::Size full_size(camera.camera_hardware_.resolution_x_, camera.camera_hardware_.resolution_y_);
+
+    if (img.empty() || full_size.width <= 0 || full_size.height <= 0 || img.size() == full_size) {
+        return img;
+    }
+
+    cv::Mat full_resolution_img;
+    cv::resize(img, full_resolution_img, full_size, 0, 0, cv::INTER_LINEAR);
+    return full_resolution_img;
+}
+
 // TBD - This really seems like it should exist in the gs_camera module?
-bool TakeRawPicture(const GolfSimCamera& camera, cv::Mat& img) {
+bool TakeRawPicture(const GolfSimCamera& camera, cv::Mat& img, int downscale) {
 
     const GsCameraNumber camera_number = camera.camera_hardware_.camera_number_;
 
@@ -1249,7 +1783,7 @@ bool TakeRawPicture(const GolfSimCamera& camera, cv::Mat& img) {
     ConfigCameraForFullScreenWatching(camera);
 
     cv::Mat initialImg;
-    if (!TakeLibcameraStill(camera, initialImg)) {
+    if (!TakeLibcameraStill(camera, initialImg, nullptr, downscale)) {
         GS_LOG_MSG(error, "Failed to take still picture.");
         return false;
     }
@@ -1258,13 +1792,289 @@ bool TakeRawPicture(const GolfSimCamera& camera, cv::Mat& img) {
         return false;
     }
 
-    img = golf_sim::LibCameraInterface::undistort_camera_image(initialImg, camera);
+    img = golf_sim::LibCameraInterface::undistort_camera_image(ToFullResolution(initialImg, camera), camera);
+
+    return true;
+}
+
+bool TakeRawPictures(const GolfSimCamera& camera, const std::function<bool(const cv::Mat&)>& frame_handler) {
+
+    // Ensure we have full resolution
+    ConfigCameraForFullScreenWatching(camera);
+
+    cv::Mat last_img;
+    if (!TakeLibcameraStill(camera, last_img, [&camera, &frame_handler](const cv::Mat& frame) {
+            return frame_handler(golf_sim::LibCameraInterface::undistort_camera_image(frame, camera));
+        })) {
+        GS_LOG_MSG(error, "Failed to take still pictures.");
+        return false;
+    }
+
+    return true;
+}
+
+bool TakeAveragedRawPicture(const GolfSimCamera& camera, int number_frames, cv::Mat& img, int downscale) {
+
+    // The sum of 256 8-bit frames still fits in 16 bits
+    number_frames = std::clamp(number_frames, 1, 256);
+
+    // Ensure we have full resolution
+    ConfigCameraForFullScreenWatching(camera);
+
+    cv::Mat sum;
+    cv::Mat first_frame;
+    int frames_summed = 0;
+
+    cv::Mat last_img;
+    const bool success = TakeLibcameraStill(camera, last_img, [&](const cv::Mat& frame) {
+        if (frames_summed == 0) {
+            // Each frame is a new image, so it can just be kept
+            first_frame = frame;
+            frame.convertTo(sum, CV_MAKETYPE(CV_16U, frame.channels()));
+        }
+        else {
+            if (LibCameraInterface::kBallPlacementBurstMaxMeanDifference > 0.0) {
+                cv::Mat difference;
+                cv::absdiff(frame, first_frame, difference);
+                const cv::Scalar channel_means = cv::mean(difference);
+                const double mean_difference = (channel_means[0] + channel_means[1] + channel_means[2] + channel_means[3]) / frame.channels();
+
+                if (mean_difference > LibCameraInterface::kBallPlacementBurstMaxMeanDifference) {
+                    GS_LOG_TRACE_MSG(trace, "TakeAveragedRawPicture - the scene changed (mean difference " + std::to_string(mean_difference) +
+                                            ").  Using the " + std::to_string(frames_summed) + " frames so far.");
+                    return false;
+                }
+            }
+
+            cv::add(sum, frame, sum, cv::noArray(), sum.type());
+        }
+
+        frames_summed++;
+        return frames_summed < number_frames;
+    }, downscale);
+
+    if (!success || frames_summed == 0) {
+        GS_LOG_MSG(error, "Failed to take the still pictures to average.");
+        return false;
+    }
+
+    // convertTo rounds to the nearest level
+    cv::Mat average;
+    sum.convertTo(average, CV_MAKETYPE(CV_8U, sum.channels()), 1.0 / frames_summed);
+
+    img = golf_sim::LibCameraInterface::undistort_camera_image(ToFullResolution(average, camera), camera);
+
+    GS_LOG_TRACE_MSG(trace, "TakeAveragedRawPicture - averaged " + std::to_string(frames_summed) + " frames.");
+
+    return true;
+}
+
+// The last ball that a full CheckForBall search found, and the gray patch around it
+struct PlacedBallTrack {
+    bool valid = false;
+    GolfBall ball;
+    cv::Mat patch;
+};
+
+static PlacedBallTrack placed_ball_track;
+
+// The tee region of the last full CheckForBall search that found no ball
+struct EmptyTeeSample {
+    bool valid = false;
+    cv::Rect region;
+    cv::Mat sample;
+    std::chrono::steady_clock::time_point time;
+};
+
+static EmptyTeeSample empty_tee_sample;
+
+// Guards both placed_ball_track and empty_tee_sample
+static std::mutex placed_ball_track_mutex;
+
+void ResetPlacedBallTrack() {
+    std::lock_guard<std::mutex> lock(placed_ball_track_mutex);
+    placed_ball_track.valid = false;
+    empty_tee_sample.valid = false;
+}
+
+// The patch covers a little more than the ball, so that the tee and the ball's edge are matched too
+static const double kPlacedBallTrackPatchRadiusRatio = 1.25;
+
+static cv::Rect PlacedBallPatchRect(const GsCircle& circle, double radius_ratio, const cv::Mat& img) {
+    const int half_size = std::max(1, (int)std::round(CvUtils::CircleRadius(circle) * radius_ratio));
+    return cv::Rect(CvUtils::CircleX(circle) - half_size, CvUtils::CircleY(circle) - half_size,
+                    2 * half_size, 2 * half_size) & cv::Rect(0, 0, img.cols, img.rows);
+}
+
+static cv::Mat GrayPatch(const cv::Mat& img, const cv::Rect& rect) {
+    cv::Mat patch;
+    if (img.channels() > 1) {
+        cv::cvtColor(img(rect), patch, cv::COLOR_BGR2GRAY);
+    }
+    else {
+        patch = img(rect).clone();
+    }
+    return patch;
+}
+
+// Called with the result of each full search
+static void UpdatePlacedBallTrack(bool found, const GolfBall& ball, const cv::Mat& img) {
+
+    if (!LibCameraInterface::kUseBallPlacementTracking) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(placed_ball_track_mutex);
+
+    placed_ball_track.valid = false;
+
+    if (!found || img.empty() || CvUtils::CircleRadius(ball.ball_circle_) < 1.0) {
+        return;
+    }
+
+    const cv::Rect patch_rect = PlacedBallPatchRect(ball.ball_circle_, kPlacedBallTrackPatchRadiusRatio, img);
+
+    if (patch_rect.width < 2 || patch_rect.height < 2) {
+        return;
+    }
+
+    placed_ball_track.ball = ball;
+    placed_ball_track.patch = GrayPatch(img, patch_rect);
+    placed_ball_track.valid = true;
+}
+
+// Looks for the tracked ball's patch near where it was last found.  Returns true (and the
+// ball, moved to where the patch now is) if it is still there.
+static bool TrackPlacedBall(const cv::Mat& img, GolfBall& ball) {
+
+    if (!LibCameraInterface::kUseBallPlacementTracking || img.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(placed_ball_track_mutex);
+
+    if (!placed_ball_track.valid) {
+        return false;
+    }
+
+    const GsCircle& last_circle = placed_ball_track.ball.ball_circle_;
+    const cv::Mat& patch = placed_ball_track.patch;
+    const double window_ratio = std::max(kPlacedBallTrackPatchRadiusRatio, LibCameraInterface::kBallPlacementTrackingWindowRadiusRatio);
+    const cv::Rect window_rect = PlacedBallPatchRect(last_circle, window_ratio, img);
+
+    if (window_rect.width < patch.cols || window_rect.height < patch.rows) {
+        placed_ball_track.valid = false;
+        return false;
+    }
+
+    cv::Mat correlation;
+    cv::matchTemplate(GrayPatch(img, window_rect), patch, correlation, cv::TM_CCOEFF_NORMED);
+
+    double best_score = 0.0;
+    cv::Point best_location;
+    cv::minMaxLoc(correlation, nullptr, &best_score, nullptr, &best_location);
+
+    // Where the patch (i.e., the ball) was before, and where it matched now
+    const cv::Rect last_patch_rect = PlacedBallPatchRect(last_circle, kPlacedBallTrackPatchRadiusRatio, img);
+    const int dx = window_rect.x + best_location.x - last_patch_rect.x;
+    const int dy = window_rect.y + best_location.y - last_patch_rect.y;
+
+    const bool still_there = best_score >= LibCameraInterface::kBallPlacementTrackingMinCorrelation &&
+                             std::abs(dx) <= LibCameraInterface::kBallPlacementTrackingMaxMovePixels &&
+                             std::abs(dy) <= LibCameraInterface::kBallPlacementTrackingMaxMovePixels;
+
+    GS_LOG_TRACE_MSG(trace, "TrackPlacedBall - best match correlation = " + std::to_string(best_score) + " at offset (" +
+                            std::to_string(dx) + ", " + std::to_string(dy) + ")" + (still_there ? "." : " - doing a full search."));
+
+    if (!still_there) {
+        placed_ball_track.valid = false;
+        return false;
+    }
+
+    ball = placed_ball_track.ball;
+    ball.set_x((float)(last_circle[0] + dx));
+    ball.set_y((float)(last_circle[1] + dy));
 
     return true;
 }
 
+static cv::Rect EmptyTeeRegion(const cv::Vec2i& search_center, const cv::Mat& img) {
+    const int half_size = std::max(1, LibCameraInterface::kBallPlacementWatcherRegionHalfSizePixels);
+    return cv::Rect(search_center[0] - half_size, search_center[1] - half_size, 2 * half_size, 2 * half_size) &
+           cv::Rect(0, 0, img.cols, img.rows);
+}
+
+// Area-averaging, so the sample is less noisy than the picture
+static cv::Mat SampleEmptyTeeRegion(const cv::Mat& img, const cv::Rect& region) {
+    const int decimation = std::max(1, LibCameraInterface::kBallPlacementWatcherDecimation);
+    const cv::Size sample_size(std::max(1, region.width / decimation), std::max(1, region.height / decimation));
+
+    cv::Mat gray = (img.channels() > 1) ? GrayPatch(img, region) : img(region);
+    cv::Mat sample;
+    cv::resize(gray, sample, sample_size, 0, 0, cv::INTER_AREA);
+    return sample;
+}
+
+// Called with the result of each full search
+static void UpdateEmptyTeeSample(bool found, const cv::Vec2i& search_center, const cv::Mat& img) {
+
+    if (!LibCameraInterface::kUseEmptyTeeFastPath) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(placed_ball_track_mutex);
+
+    empty_tee_sample.valid = false;
+
+    if (found || img.empty()) {
+        return;
+    }
+
+    const cv::Rect region = EmptyTeeRegion(search_center, img);
+
+    if (region.width < 2 || region.height < 2) {
+        return;
+    }
+
+    empty_tee_sample.region = region;
+    empty_tee_sample.sample = SampleEmptyTeeRegion(img, region);
+    empty_tee_sample.time = std::chrono::steady_clock::now();
+    empty_tee_sample.valid = true;
+}
+
+// Returns true if the tee region looks the same as when the last full search found no ball
+static bool TeeStillEmpty(const cv::Mat& img, const cv::Vec2i& search_center) {
+
+    if (!LibCameraInterface::kUseEmptyTeeFastPath || img.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(placed_ball_track_mutex);
+
+    if (!empty_tee_sample.valid) {
+        return false;
+    }
+
+    const auto age_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - empty_tee_sample.time).count();
+
+    if (age_ms > LibCameraInterface::kEmptyTeeMaxAgeMs || EmptyTeeRegion(search_center, img) != empty_tee_sample.region) {
+        empty_tee_sample.valid = false;
+        return false;
+    }
+
+    const cv::Mat sample = SampleEmptyTeeRegion(img, empty_tee_sample.region);
+    const double mean_difference = cv::norm(sample, empty_tee_sample.sample, cv::NORM_L1) / (double)sample.total();
+
+    const bool still_empty = mean_difference <= LibCameraInterface::kEmptyTeeMaxMeanDifference;
+
+    GS_LOG_TRACE_MSG(trace, "TeeStillEmpty - mean difference from the empty tee = " + std::to_string(mean_difference) +
+                            (still_empty ? "." : " - doing a full search."));
+
+    return still_empty;
+}
+
 // Enhanced ball detection using YOLO when configured
-bool CheckForBallEnhanced(GolfBall& ball, cv::Mat& img) {
+bool CheckForBallEnhanced(GolfBall& ball, cv::Mat& img, bool full_resolution) {
     bool use_yolo = (golf_sim::BallImageProc::kBallPlacementDetectionMethod == "experimental");
     
     GsCameraNumber camera_number = GolfSimOptions::GetCommandLineOptions().GetCameraNumber();
@@ -1277,12 +2087,28 @@ bool CheckForBallEnhanced(GolfBall& ball, cv::Mat& img) {
     GolfSimCamera camera;
     camera.camera_hardware_.init_camera_parameters(camera_number, camera_model, camera_lens_type, camera_orientation);
     
-    if (!TakeRawPicture(camera, img)) {
+    const int downscale = full_resolution ? 1 : std::max(1, LibCameraInterface::kBallPlacementCaptureDownscale);
+
+    // In a dim bay, a short burst of averaged frames is much less noisy than one still
+    const bool took_picture = (LibCameraInterface::kBallPlacementBurstFrames > 1) ?
+        TakeAveragedRawPicture(camera, LibCameraInterface::kBallPlacementBurstFrames, img, downscale) :
+        TakeRawPicture(camera, img, downscale);
+
+    if (!took_picture) {
         GS_LOG_MSG(error, "Failed to TakeRawPicture.");
         return false;
     }
+
+    // A full-resolution check is there to find the ball precisely, so it always does the full search
+    if (!full_resolution && TrackPlacedBall(img, ball)) {
+        return true;
+    }
     
     cv::Vec2i search_center = camera.GetExpectedBallCenter();
+
+    if (!full_resolution && TeeStillEmpty(img, search_center)) {
+        return false;
+    }
     
     if (use_yolo) {
         std::vector<GsCircle> detected_circles;
@@ -1311,6 +2137,8 @@ bool CheckForBallEnhanced(GolfBall& ball, cv::Mat& img) {
                 ball.search_area_center_ = search_center;
                 ball.search_area_radius_ = 200;
 
+                UpdatePlacedBallTrack(true, ball, img);
+                UpdateEmptyTeeSample(true, search_center, img);
                 return true;
             }
         }
@@ -1318,12 +2146,127 @@ bool CheckForBallEnhanced(GolfBall& ball, cv::Mat& img) {
 
     // We don't necessarily expect a ball so don't create any warnings if we don't find one.
     bool expectBall = false;
-    return camera.GetCalibratedBall(camera, img, ball, search_center, expectBall);
+    bool found = camera.GetCalibratedBall(camera, img, ball, search_center, expectBall);
+
+    UpdatePlacedBallTrack(found, ball, img);
+    UpdateEmptyTeeSample(found, search_center, img);
+    return found;
 }
 
 // TBD - This really seems like it should exist in the gs_camera module?
-bool CheckForBall(GolfBall& ball, cv::Mat& img) {
-    return CheckForBallEnhanced(ball, img);
+bool CheckForBall(GolfBall& ball, cv::Mat& img, bool full_resolution) {
+    return CheckForBallEnhanced(ball, img, full_resolution);
+}
+
+bool CheckForBallStableIncremental(const GsShotBallContext& ball_context, double min_correlation,
+                                   cv::Mat& img, bool& patch_unchanged) {
+
+    patch_unchanged = false;
+
+    if (ball_context.ball_image.empty()) {
+        GS_LOG_MSG(warning, "CheckForBallStableIncremental - no prior ball image to compare to.");
+        return false;
+    }
+
+    if (ball_context.gray_patch.empty()) {
+        GS_LOG_MSG(warning, "CheckForBallStableIncremental - ball patch is empty.");
+        return false;
+    }
+
+    GsCameraNumber camera_number = GolfSimOptions::GetCommandLineOptions().GetCameraNumber();
+    const CameraHardware::CameraModel camera_model = (camera_number == GsCameraNumber::kGsCamera1) ?
+        GolfSimCamera::kSystemSlot1CameraType : GolfSimCamera::kSystemSlot2CameraType;
+    const CameraHardware::LensType camera_lens_type = (camera_number == GsCameraNumber::kGsCamera1) ?
+        GolfSimCamera::kSystemSlot1LensType : GolfSimCamera::kSystemSlot2LensType;
+    const CameraHardware::CameraOrientation camera_orientation = (camera_number == GsCameraNumber::kGsCamera1) ? GolfSimCamera::kSystemSlot1CameraOrientation : GolfSimCamera::kSystemSlot2CameraOrientation;
+
+    GolfSimCamera camera;
+    camera.camera_hardware_.init_camera_parameters(camera_number, camera_model, camera_lens_type, camera_orientation);
+
+    // The same kind of picture as the one that the ball was found in
+    if (!TakeRawPicture(camera, img, std::max(1, LibCameraInterface::kBallPlacementCaptureDownscale))) {
+        GS_LOG_MSG(error, "Failed to TakeRawPicture.");
+        return false;
+    }
+
+    if (img.size() != ball_context.ball_image.size() || img.type() != ball_context.ball_image.type()) {
+        GS_LOG_MSG(warning, "CheckForBallStableIncremental - new image does not match the prior ball image.");
+        return false;
+    }
+
+    // Only the new picture's patch has to be converted.  The prior one was cached when the ball was found.
+    const cv::Mat new_patch = GrayPatch(img, ball_context.patch_rect);
+
+    // Same-sized patches, so the result is a single correlation value
+    cv::Mat correlation;
+    cv::matchTemplate(new_patch, ball_context.gray_patch, correlation, cv::TM_CCOEFF_NORMED);
+    const double score = correlation.at<float>(0, 0);
+
+    patch_unchanged = (score >= min_correlation);
+
+    GS_LOG_TRACE_MSG(trace, "CheckForBallStableIncremental - ball patch correlation = " + std::to_string(score) +
+                            (patch_unchanged ? " (unchanged)." : " (changed)."));
+
+    return true;
+}
+
+bool WatchForBallPlacementChange(bool& change_detected) {
+
+    change_detected = false;
+
+    // The decimated tee region from the last watch.  Keeping it across calls means that a
+    // ball placed while the camera was switching modes still shows up as a change.
+    static cv::Mat reference_region;
+
+    GsCameraNumber camera_number = GolfSimOptions::GetCommandLineOptions().GetCameraNumber();
+    const CameraHardware::CameraModel camera_model = (camera_number == GsCameraNumber::kGsCamera1) ?
+        GolfSimCamera::kSystemSlot1CameraType : GolfSimCamera::kSystemSlot2CameraType;
+    const CameraHardware::LensType camera_lens_type = (camera_number == GsCameraNumber::kGsCamera1) ?
+        GolfSimCamera::kSystemSlot1LensType : GolfSimCamera::kSystemSlot2LensType;
+    const CameraHardware::CameraOrientation camera_orientation = (camera_number == GsCameraNumber::kGsCamera1) ? GolfSimCamera::kSystemSlot1CameraOrientation : GolfSimCamera::kSystemSlot2CameraOrientation;
+
+    GolfSimCamera camera;
+    camera.camera_hardware_.init_camera_parameters(camera_number, camera_model, camera_lens_type, camera_orientation);
+
+    cv::Vec2i search_center = camera.GetExpectedBallCenter();
+    const int half_size = LibCameraInterface::kBallPlacementWatcherRegionHalfSizePixels;
+    cv::Rect watch_region(search_center[0] - half_size, search_center[1] - half_size, 2 * half_size, 2 * half_size);
+
+    if (!ConfigCameraForFullScreenWatching(camera)) {
+        GS_LOG_MSG(error, "WatchForBallPlacementChange - failed to ConfigCameraForFullScreenWatching.");
+        return false;
+    }
+
+    RPiCamEncoder app;
+    cv::Vec2i full_resolution(camera.camera_hardware_.resolution_x_, camera.camera_hardware_.resolution_y_);
+
+    if (!ConfigureLibCameraOptions(camera, app, full_resolution, LibCameraInterface::kBallPlacementWatcherFPS)) {
+        GS_LOG_MSG(error, "WatchForBallPlacementChange - failed to ConfigureLibCameraOptions.");
+        return false;
+    }
+
+    // The high-FPS settings would be far too bright (and noisy) for this, so expose like a still picture
+    VideoOptions* options = app.GetOptions();
+    options->Set().gain = (camera_number == GsCameraNumber::kGsCamera1) ? LibCameraInterface::kCamera1Gain : LibCameraInterface::kCamera2Gain;
+    long shutter_time_uS = (camera_number == GsCameraNumber::kGsCamera1) ? LibCameraInterface::kCamera1StillShutterTimeuS : LibCameraInterface::kCamera2StillShutterTimeuS;
+    options->Set().shutter.set(std::to_string(shutter_time_uS) + "us");
+
+    try
+    {
+        if (!ball_placement_watcher_event_loop(app, watch_region, reference_region,
+                                               (unsigned int)std::max(0, LibCameraInterface::kBallPlacementWatcherMaxWatchTimeMs),
+                                               change_detected)) {
+            GS_LOG_MSG(error, "ball_placement_watcher_event_loop failed to process.");
+            return false;
+        }
+    }
+    catch (std::exception const& e)
+    {
+        GS_LOG_MSG(error, "ERROR: *** " + std::string(e.what()) + " ***");
+        return false;
+    }
+
+    return true;
 }
 
 bool CheckForBallLegacy(GolfBall& ball, cv::Mat& img) {
@@ -1346,12 +2289,18 @@ bool CheckForBallLegacy(GolfBall& ball, cv::Mat& img) {
         return false;
     }
 
+    if (TrackPlacedBall(img, ball)) {
+        return true;
+    }
+
     cv::Vec2i search_area_center = camera.GetExpectedBallCenter();
 
     // We don't necessarily expect a ball so don't create any warnings if we don't find one.
     bool expectBall = false;
     bool success = camera.GetCalibratedBall(camera, img, ball, search_area_center, expectBall);
 
+    UpdatePlacedBallTrack(success, ball, img);
+
     if (!success) {
         return false;
     }
@@ -1382,7 +2331,7 @@ bool WaitForCam2Trigger(cv::Mat& return_image) {
         char dummy_arguments[] = "DummyExecutableName";
         char* argv[] = { dummy_arguments, NULL };
 
-        if (!options->Parse(1, argv))
+        if (!options->ParseOnce(1, argv))
         {
             return -1;
         }
@@ -1397,7 +2346,7 @@ bool WaitForCam2Trigger(cv::Mat& return_image) {
 
             options->Set().gain = LibCameraInterface::kCamera2CalibrateOrLocationGain;
         }
-        else if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::kPutter) {
+        else if (GsSessionSettings::ShotSettings().club_type == GolfSimClubs::kPutter) {
             options->Set().gain = LibCameraInterface::kCamera2PuttingGain;
             options->Set().contrast = LibCameraInterface::kCamera2PuttingContrast;
         }
@@ -1510,6 +2459,31 @@ bool PerformCameraSystemStartup() {
             break;
     }
 
+    // Build the undistortion maps now so that the first shot doesn't have to
+    if (mode == SystemMode::kCamera1 || mode == SystemMode::kCamera1TestStandalone) {
+
+        GolfSimCamera camera1;
+        camera1.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera1,
+                                                        GolfSimCamera::kSystemSlot1CameraType,
+                                                        GolfSimCamera::kSystemSlot1LensType,
+                                                        GolfSimCamera::kSystemSlot1CameraOrientation);
+
+        GolfSimCamera camera2;
+        camera2.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera2,
+                                                        GolfSimCamera::kSystemSlot2CameraType,
+                                                        GolfSimCamera::kSystemSlot2LensType,
+                                                        GolfSimCamera::kSystemSlot2CameraOrientation);
+
+        for (const GolfSimCamera* camera : { &camera1, &camera2 }) {
+            const cv::Size image_size(camera->camera_hardware_.resolution_x_, camera->camera_hardware_.resolution_y_);
+
+            if (!LibCameraInterface::PrepareUndistortionMaps(*camera, image_size)) {
+                // Not fatal - the maps will just be built on first use
+                GS_LOG_MSG(warning, "Failed to PrepareUndistortionMaps for camera " + std::to_string((int)camera->camera_hardware_.camera_number_));
+            }
+        }
+    }
+
     return true;
 }
 
@@ -13,11 +13,15 @@
 #include "core/rpicam_encoder.hpp"
 #include "core/still_options.hpp"
 
+#include <functional>
+#include <mutex>
 #include <opencv2/core.hpp>
 
 #include "golf_ball.h"
 #include "gs_camera.h"
+#include "gs_gpu_preprocess.h"
 #include "gs_options.h"
+#include "gs_shot_ball_context.h"
 
 #include "still_image_libcamera_app.hpp"
 
@@ -48,8 +52,60 @@ namespace golf_sim {
 
 		static cv::Mat undistort_camera_image(const cv::Mat& img, const GolfSimCamera& camera);
 
+		// Builds (if necessary) the undistortion maps for the camera at the given image size.
+		// undistort_camera_image will call this itself, but calling it ahead of time (e.g., at
+		// startup) keeps the expensive map generation off of the per-shot critical path.
+		static bool PrepareUndistortionMaps(const GolfSimCamera& camera, const cv::Size& image_size);
+
+		// Forces the maps to be rebuilt on next use, e.g., after a calibration change
+		static void InvalidateUndistortionMapCache();
+
+		// Same as undistort_camera_image, but only remaps the pixels within roi, and returns just
+		// that roi-sized part of the undistorted image (so its (0, 0) is roi.tl() in img).
+		// An empty roi will undistort the entire image.
+		static cv::Mat undistort_camera_image_roi(const cv::Mat& img, const GolfSimCamera& camera, const cv::Rect& roi);
+
+		// Writes the whole undistorted image into undistorted_img, re-using its pixel buffer if it
+		// is already the right size and type.  Only the pixels within roi are remapped; those
+		// outside of it are left as they were in the (distorted) original image.  An empty roi
+		// will undistort the entire image.  undistorted_img never shares data with img, so img
+		// can be a view of a camera buffer that is about to be recycled.
+		static void undistort_camera_image_into(const cv::Mat& img, const GolfSimCamera& camera, const cv::Rect& roi, cv::Mat& undistorted_img);
+
+		// Same as undistort_camera_image_into for the whole image, but done on the GPU (see
+		// GsGpuPreprocess), and gray_img is the grayscale (CV_8UC1) version of the result.
+		// frame_buffer is img's camera buffer, or nullptr if img is not a camera buffer.
+		// Returns false if there is no GPU preprocessing or it fails, in which case the caller
+		// should fall back to undistort_camera_image_into.
+		static bool undistort_camera_image_to_gray_gpu(const cv::Mat& img, const GsGpuFrameBuffer* frame_buffer,
+													   const GolfSimCamera& camera, cv::Mat& gray_img);
+
+		// Returns the part of the camera 2 image where the strobed ball(s) are expected to be,
+		// based on the current club type and the kCamera2UndistortRoi... constants.
+		static cv::Rect GetCamera2UndistortionRoi(const cv::Size& image_size);
+
+		// Corrects (e.g., circle-center) points in a distorted image to where they would be in
+		// the undistorted image.  Allows geometry-only users to skip rectifying the full image.
+		static bool undistort_points(const std::vector<cv::Point2f>& distorted_points,
+									 std::vector<cv::Point2f>& undistorted_points,
+									 const GolfSimCamera& camera);
+
 		static uint kMaxWatchingCropWidth;
 		static uint kMaxWatchingCropHeight;
+
+		// When enabled (and not gathering club data), the watching crop is sized to the
+		// measured ball, within the kMin/kMaxWatchingCrop limits, and the motion ROI is cut
+		// down to kAdaptiveWatchingRoiExitFraction of the ball on the side it will leave towards.
+		static bool kUseAdaptiveWatchingRoi;
+		static uint kMinWatchingCropWidth;
+		static uint kMinWatchingCropHeight;
+		static double kAdaptiveWatchingRoiExitFraction;
+		// When enabled, the part of the watching crop behind the ball (on the side the club comes
+		// from) is also watched for motion, and the club coming into it pre-arms the trigger.
+		// The crop needs at least kApproachZoneMinWidthPixels of room there.
+		static bool kUseApproachZone;
+		static uint kApproachZoneMinWidthPixels;
+		static int kApproachZoneReleaseFrames;
 		static double kCamera1Gain;  // 0.0 to TBD??
 		static double kCamera1Saturation;
 		static double kCamera1HighFPSGain;  // 15.0 to TBD??
@@ -67,6 +123,100 @@ namespace golf_sim {
 		static long kCamera1StillShutterTimeuS;
 		static long kCamera2StillShutterTimeuS;
 
+		// If true, only the ball-flight corridor of the camera 2 image is undistorted.
+		// The corridor is expressed as fractions of the image height, and is expanded
+		// by the margin (in pixels) on each side
+		static bool kCamera2UndistortRoiOnly;
+		static double kCamera2UndistortRoiTopFraction;
+		static double kCamera2UndistortRoiBottomFraction;
+		static int kCamera2UndistortRoiMarginPixels;
+
+		// If true and camera 2 is a mono camera, camera 2 captures just the Y (luminance) plane
+		// of a YUV420 image, and the strobed image is carried as a single-channel (CV_8UC1) image
+		// at least until the analysis needs a color version of it
+		static bool kCamera2MonoCapture;
+
+		// If true (and the build has GsGpuPreprocess), the camera 2 frame is undistorted and
+		// turned into a single-channel (CV_8UC1) image on the GPU, straight from the camera buffer,
+		// instead of on the CPU.  The whole frame is undistorted, even if kCamera2UndistortRoiOnly.
+		static bool kCamera2GpuPreprocessing;
+
+		// If true, the camera 2 thread starts the camera once, when its pipeline is set up, and
+		// leaves it running (externally triggered) with its requests queued between shots.
+		// Otherwise, each shot starts and stops the camera.
+		static bool kCamera2PersistentRequests;
+
+		// If true, camera 1's still pipeline is configured and started once, and left running
+		// between still pictures (e.g., the ball placement checks), so that each still is just the
+		// next frame.  It is released whenever anything else needs camera 1, e.g., the ball watcher.
+		static bool kCamera1PersistentStills;
+
+		// The flags to pass to ConfigureViewfinder for the camera 2 (strobed) capture
+		static unsigned int GetCamera2ViewfinderFlags();
+
+		// When enabled, the FSM waits for a ball to be placed by watching a cheap, decimated
+		// low-FPS video of the tee region for changes, and only runs the full ball
+		// detection once that region changes (or after the forced-check interval).
+		// Only every kBallPlacementWatcherFramePeriod-th frame is examined.
+		static bool kUseBallPlacementWatcher;
+		static uint kBallPlacementWatcherFPS;
+		static int kBallPlacementWatcherFramePeriod;
+		static int kBallPlacementWatcherDecimation;
+		static int kBallPlacementWatcherRegionHalfSizePixels;
+		static int kBallPlacementWatcherPixelDifference;
+		static double kBallPlacementWatcherChangedFraction;
+		static int kBallPlacementWatcherMaxWatchTimeMs;
+		static int kBallPlacementWatcherForcedCheckIntervalMs;
+
+		// When enabled, CheckForBall remembers the last ball it found (and the image patch
+		// around it).  The next check first looks for that patch within a window of
+		// kBallPlacementTrackingWindowRadiusRatio ball radii of the last position.  If the
+		// best match correlates at least kBallPlacementTrackingMinCorrelation and has moved
+		// no more than kBallPlacementTrackingMaxMovePixels, that ball is returned without a
+		// full search.  Otherwise the full search runs (and restarts the tracking).
+		static bool kUseBallPlacementTracking;
+		static double kBallPlacementTrackingWindowRadiusRatio;
+		static double kBallPlacementTrackingMinCorrelation;
+		static int kBallPlacementTrackingMaxMovePixels;
+
+		// If more than 1, CheckForBall searches the average of this many consecutive (streamed)
+		// full-resolution stills instead of a single one, which cuts the sensor noise of a dim,
+		// high-gain bay by about the square root of the count.  The frames are summed in 16-bit
+		// fixed point, and only the average is undistorted.  If a frame's mean difference from
+		// the first one is more than kBallPlacementBurstMaxMeanDifference gray levels (e.g., the
+		// ball is still being placed), the burst ends early.  0 means no check.
+		static int kBallPlacementBurstFrames;
+		static double kBallPlacementBurstMaxMeanDifference;
+
+		// If more than 1, the placement and stabilization checks (CheckForBall and
+		// CheckForBallStableIncremental) take their stills at 1/kBallPlacementCaptureDownscale of
+		// the full width and height, scaled down by the ISP.  That cuts the capture bandwidth (and
+		// the burst averaging) by the square of it.  Each picture is scaled back up before it is
+		// undistorted and searched, so the ball and the image stay in full-resolution coordinates.
+		// Once the ball has stabilized, the FSM takes one full-resolution picture to fix the
+		// precise ball position for the shot.  1 means full-resolution stills throughout.
+		static int kBallPlacementCaptureDownscale;
+
+		// When enabled, a CheckForBall whose full search found no ball keeps a decimated gray
+		// sample of the tee region (kBallPlacementWatcherRegionHalfSizePixels around the
+		// expected ball, kBallPlacementWatcherDecimation times smaller).  Later checks compare
+		// the same sample of their picture to it, and if the mean difference is no more than
+		// kEmptyTeeMaxMeanDifference gray levels, report no ball without a full search.  The
+		// full search still runs at least every kEmptyTeeMaxAgeMs, so that lighting drift
+		// is not mistaken for an empty tee forever.
+		static bool kUseEmptyTeeFastPath;
+		static double kEmptyTeeMaxMeanDifference;
+		static int kEmptyTeeMaxAgeMs;
+
+		// If set, the high-FPS ball watcher runs without a video encoder or output.
+		// The encoded stream is only of use when debugging.
+		static bool kBallWatcherDetectOnly;
+
+		// If set, the ball watcher locks the process memory, pre-faults its stack, and
+		// sends the trigger-path log messages through GsDeferredLog, so that nothing in
+		// that path allocates or takes a page fault.
+		static bool kBallWatcherRealtimeMode;
+
 		// Once the cropped rectange is determined (usually around the center of the ball)
 		// These offsets can further move that cropping area
 		static int kCroppedImagePixelOffsetLeft;
@@ -81,35 +231,104 @@ namespace golf_sim {
 		// The first (0th) element in the array is for camera1, the second for camera2
 		static CameraConfiguration libcamera_configuration_[];
 		static LibcameraJpegApp* libcamera_app_[];
+		// True if the camera's still pipeline was left running (see kCamera1PersistentStills)
+		static bool still_camera_streaming_[];
+		// The downscale (see kBallPlacementCaptureDownscale) that each still pipeline was configured for
+		static int still_capture_downscale_[];
 
 		// True (or set to a non-negative number) if we've already figured out the media and device number for the camera;
 		static bool camera_location_found_;
 		static int previously_found_media_number_;
 		static int previously_found_device_number_;
-	};
 
-	bool TakeRawPicture(const GolfSimCamera& camera, cv::Mat& img);
+	private:
+
+		// The maps depend only on the camera's calibration, resolution and color-vs-mono,
+		// so we keep a copy of those to determine whether the cached maps are still valid.
+		struct UndistortionMapCacheEntry {
+			bool valid = false;
+			cv::Size image_size;
+			bool is_mono = false;
+			cv::Mat calibration_matrix;
+			cv::Mat distortion_vector;
+			cv::Mat map1;
+			cv::Mat map2;
+		};
+
+		// Returns true if the cache entry was built for the camera's current calibration
+		static bool UndistortionMapsAreCurrent(const UndistortionMapCacheEntry& entry,
+												const GolfSimCamera& camera,
+												const cv::Size& image_size);
 
-	// Takes a picture and then tries to find the ball
-	bool CheckForBall(GolfBall& ball, cv::Mat& return_image);
+		// Caller must hold undistortion_map_cache_mutex_
+		static UndistortionMapCacheEntry& GetUndistortionMaps(const GolfSimCamera& camera, const cv::Size& image_size);
+
+		// The first (0th) element in the array is for camera1, the second for camera2
+		static UndistortionMapCacheEntry undistortion_map_cache_[];
+
+		// Camera 2 images are undistorted on the Camera2Thread while camera 1 images are
+		// undistorted on the FSM thread
+		static std::mutex undistortion_map_cache_mutex_;
+	};
+
+	// How the camera 2 event loop hands a frame to the Camera2Thread.  frame is a view onto the
+	// camera buffer, and frame_buffer is that buffer (e.g., for a GPU import).  Both are only
+	// valid during the call.
+	using Cam2FrameHandoff = std::function<void(const cv::Mat& frame, const GsGpuFrameBuffer* frame_buffer)>;
+
+	// If downscale is more than 1, the still is taken at 1/downscale of the full width and height
+	// and is then scaled back up - see LibCameraInterface::kBallPlacementCaptureDownscale
+	bool TakeRawPicture(const GolfSimCamera& camera, cv::Mat& img, int downscale = 1);
+
+	// Same as TakeRawPicture, but keeps the camera streaming full-resolution stills and passes
+	// each (undistorted) one to frame_handler until it returns false.  This avoids re-configuring
+	// the camera for every picture.
+	bool TakeRawPictures(const GolfSimCamera& camera, const std::function<bool(const cv::Mat&)>& frame_handler);
+
+	// Streams up to number_frames (at most 256) full-resolution stills and returns their
+	// (undistorted) average in img.  See LibCameraInterface::kBallPlacementBurstFrames.
+	bool TakeAveragedRawPicture(const GolfSimCamera& camera, int number_frames, cv::Mat& img, int downscale = 1);
+
+	// Takes a picture and then tries to find the ball.  Unless full_resolution is set, the picture
+	// is downscaled if kBallPlacementCaptureDownscale says so, and the ball may just be tracked
+	// from the last check (see kUseBallPlacementTracking).
+	bool CheckForBall(GolfBall& ball, cv::Mat& return_image, bool full_resolution = false);
+
+	// Forgets the ball that CheckForBall last found (see kUseBallPlacementTracking), so that
+	// the next check does a full search
+	void ResetPlacedBallTrack();
+
+	// Takes a picture and compares just the patch around the previously-found ball to the
+	// gray patch that was cached from the ball's image when it was found.
+	// patch_unchanged is set if the normalized cross-correlation is at least min_correlation.
+	// Returns false if no comparison could be done, in which case a full CheckForBall is needed.
+	bool CheckForBallStableIncremental(const GsShotBallContext& ball_context, double min_correlation,
+									   cv::Mat& img, bool& patch_unchanged);
+
+	// Watches the tee region in a low-power video mode for up to kBallPlacementWatcherMaxWatchTimeMs.
+	// change_detected is set if something in the region changed, such that a (full) CheckForBall is
+	// worth doing.  Returns true iff no error occurred.
+	bool WatchForBallPlacementChange(bool& change_detected);
 
 	// Configures the camera and the rest of the system to sit in a tight loop, waiting for the
 	// ball to move.  Blocks until movement or some other event that causes the loop to stop
 	// Returns whether or not motion was detected
 	// Lower-level methods in the loop will try to trigger the external shutter of the camera 2
 	// as soon as possible after motion has been detected.
-	bool WatchForBallMovement(GolfSimCamera& camera, const GolfBall& ball, bool & motion_detected);
+	bool WatchForBallMovement(GolfSimCamera& camera, RPiCamEncoder& app, const GolfBall& ball, bool & motion_detected);
 
 	// Do everything necessary to get the system ready to use a tightly-cropped camera video
 	// mode (in order to allow high FPS)
-	bool ConfigCameraForCropping(GolfBall ball, GolfSimCamera& camera, RPiCamEncoder& app);
+	bool ConfigCameraForCropping(const GolfBall& ball, GolfSimCamera& camera, RPiCamEncoder& app);
 
-	// Uses media-ctl to setup a cropping mode to allow for high FPS.  Requires GS camera.
+	// Sets up a cropping mode to allow for high FPS.  Requires GS camera.
+	// Uses the V4L2 subdevice API (see GsV4l2Subdev), or media-ctl if that fails.
 	bool SendCameraCroppingCommand(const GolfSimCamera &camera, cv::Vec2i& cropping_window_size, cv::Vec2i& cropping_window_offset);
 
 	// Sets up the rpicam-app-based post-processing pipeline so that the motion-detection stage knows 
 	// how to analyze the cropped image
-	bool ConfigurePostProcessing(const cv::Vec2i& roi_size, const cv::Vec2i& roi_offset);
+	// approach_roi is the motion detector's approach zone, if not empty.
+	bool ConfigurePostProcessing(const cv::Vec2i& roi_size, const cv::Vec2i& roi_offset, const cv::Rect& approach_roi = cv::Rect());
 
 	// Sets up a libcamera encoder with options necessary for a high FPS video loop in a cropped part of
 	// the camera sensor.
@@ -122,12 +341,18 @@ namespace golf_sim {
 
 	bool RetrieveCameraInfo(const GsCameraNumber camera_number, cv::Vec2i& resolution, uint& frameRate, bool restartCamera = false);
 
-	LibcameraJpegApp* ConfigureForLibcameraStill(const GolfSimCamera& camera);
+	LibcameraJpegApp* ConfigureForLibcameraStill(const GolfSimCamera& camera, int downscale = 1);
 	bool DeConfigureForLibcameraStill(const GsCameraNumber camera_number);
 
-	bool TakeLibcameraStill(const GolfSimCamera& camera, cv::Mat& return_image);
+	// Stops and de-configures the still pipeline that kCamera1PersistentStills left running, if any
+	bool ReleasePersistentStillCamera(const GsCameraNumber camera_number);
+
+	bool TakeLibcameraStill(const GolfSimCamera& camera, cv::Mat& return_image,
+							const std::function<bool(const cv::Mat&)>& frame_handler = nullptr,
+							int downscale = 1);
 
-	bool WatchForHitAndTrigger(const GolfBall& ball, cv::Mat& return_image, bool& motion_detected);
+	// camera is camera 1, and app is the ball-watcher app (which may be re-used across shots)
+	bool WatchForHitAndTrigger(GolfSimCamera& camera, RPiCamEncoder& app, const GolfBall& ball, cv::Mat& return_image, bool& motion_detected);
 
 	// TBD - REMOVE bool ConfigCameraForCropping(const GolfSimCamera& c);
 
@@ -7,6 +7,8 @@
 #ifdef __unix__  // Ignore in Windows environment
 
 #include <chrono>
+#include <ctime>
+#include <functional>
 #include <signal.h>
 #include <sys/stat.h>
 #include <thread>
@@ -36,6 +38,8 @@
 #include "logging_tools.h"
 #include "ball_watcher.h"
 #include "pulse_strobe.h"
+#include "gs_raw_dataset_writer.h"
+#include "gs_camera2_background.h"
 #include "core/rpicam_app.hpp"
 #include "core/still_options.hpp"
 
@@ -84,13 +88,94 @@ void SetExternalTrigger(bool& flag) {
 	}
 }
 
-// Run the triggered capture event loop on an already-opened camera.
+// Starts the camera for persistent_capture use of cam2_run_event_loop, below.
 // The camera must have been opened and configured before calling this.
-// Calls StartCamera at entry and StopCamera when the final image arrives.
-bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_priming_pulses)
+void cam2_start_persistent_capture(LibcameraJpegApp& app)
 {
 	app.StartCamera();
-	GS_LOG_TRACE_MSG(trace, "cam2_run_event_loop: camera started, waiting for triggers");
+
+	// The InnoMaker camera needs its trigger script to be called after the camera has started
+	bool external_trigger_is_set = false;
+	SetExternalTrigger(external_trigger_is_set);
+
+	GS_LOG_TRACE_MSG(trace, "cam2_start_persistent_capture: camera started and left running");
+}
+
+// Describes the (first plane of the) viewfinder buffer for a GPU import (see GsGpuPreprocess)
+static golf_sim::GsGpuFrameBuffer get_gpu_frame_buffer(libcamera::FrameBuffer* buffer, const StreamInfo& info, bool y_plane_only)
+{
+	golf_sim::GsGpuFrameBuffer frame_buffer;
+
+	frame_buffer.fd = buffer->planes()[0].fd.get();
+	frame_buffer.offset = buffer->planes()[0].offset;
+	frame_buffer.stride = info.stride;
+	frame_buffer.width = info.width;
+	frame_buffer.height = info.height;
+
+	// libcamera's fourccs are the DRM ones, and the Y plane on its own is just an 8-bit single-channel image
+	frame_buffer.drm_fourcc = y_plane_only ? libcamera::formats::R8.fourcc() : info.pixel_format.fourcc();
+
+	return frame_buffer;
+}
+
+// Calls frame_handoff with a view directly onto the request's viewfinder buffer, and that buffer.
+// Both are only valid during the call.
+static void hand_off_viewfinder_frame(LibcameraJpegApp& app, CompletedRequestPtr& payload,
+									  const golf_sim::Cam2FrameHandoff& frame_handoff)
+{
+	Stream* stream = app.ViewfinderStream();
+
+	if (stream == nullptr) {
+		return;
+	}
+
+	auto buffer = payload->buffers.find(stream);
+
+	if (buffer == payload->buffers.end()) {
+		return;
+	}
+
+	StreamInfo info = app.GetStreamInfo(stream);
+
+	// A YUV420 stream means that we are doing a mono capture (see GetCamera2ViewfinderFlags)
+	const bool y_plane_only = (info.pixel_format == libcamera::formats::YUV420);
+
+	BufferReadSync r(&app, buffer->second);
+	const std::vector<libcamera::Span<uint8_t>> mem = r.Get();
+
+	if (mem.empty() || mem[0].data() == nullptr) {
+		return;
+	}
+
+	cv::Mat frame = cv::Mat(info.height, info.width, y_plane_only ? CV_8UC1 : CV_8UC3, mem[0].data(), info.stride);
+	const golf_sim::GsGpuFrameBuffer frame_buffer = get_gpu_frame_buffer(buffer->second, info, y_plane_only);
+
+	frame_handoff(frame, &frame_buffer);
+}
+
+// Run the triggered capture event loop on an already-opened camera.
+// The camera must have been opened and configured before calling this.
+// Calls StartCamera at entry and StopCamera when the final image arrives, unless
+// persistent_capture is set, in which case the camera was already started by
+// cam2_start_persistent_capture and is left running.
+// If frame_handoff is set, it is called with a view directly onto the final image's
+// camera buffer (and that buffer, e.g., for a GPU import) instead of returnImg getting a
+// copy of it.  Both are only valid during the call.
+// If priming_frame_handoff is set, it is called the same way with the later priming
+// frames that the camera 2 background model wants (see GsCamera2Background).
+bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_priming_pulses,
+						 const golf_sim::Cam2FrameHandoff& frame_handoff, bool persistent_capture,
+						 const golf_sim::Cam2FrameHandoff& priming_frame_handoff)
+{
+	if (persistent_capture) {
+		// Any frames from stray triggers since the last shot would otherwise be taken as priming frames
+		app.ClearMessages();
+		GS_LOG_TRACE_MSG(trace, "cam2_run_event_loop: camera already running, waiting for triggers");
+	}
+	else {
+		app.StartCamera();
+		GS_LOG_TRACE_MSG(trace, "cam2_run_event_loop: camera started, waiting for triggers");
+	}
 
 
 	auto start_time = std::chrono::high_resolution_clock::now();
@@ -123,12 +208,15 @@ bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_pr
     // True if the InnoMaker camera external trigger script has not been called yet
     // Note - The InnoMaker camera needs its trigger script to be called AFTER the camera
     // has already started up.  No idea why.
-	bool innomaker_first_external_trigger_is_set = false;
+	bool innomaker_first_external_trigger_is_set = persistent_capture;
 
 	// We want to make sure we are externally triggered here every time just in case we're using an InnoMaker camera
+	// A persistent capture was already set up by cam2_start_persistent_capture
 
-	bool dummy = false;
-	SetExternalTrigger(dummy);
+	if (!persistent_capture) {
+		bool dummy = false;
+		SetExternalTrigger(dummy);
+	}
 
 	// Send priming pulses + trigger in a background thread so the event loop
 	// can process the resulting hardware trigger events as they arrive.
@@ -180,9 +268,11 @@ bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_pr
 		{
 			GS_LOG_MSG(error, "ERROR: Device timeout detected, attempting a restart!!!");
 			app.StopCamera();
-			uint flags = RPiCamApp::FLAG_STILL_RGB;
+			uint flags = golf_sim::LibCameraInterface::GetCamera2ViewfinderFlags();
 			app.ConfigureViewfinder(flags);
 			app.StartCamera();
+			// The restarted camera will need its external trigger to be set up again
+			innomaker_first_external_trigger_is_set = false;
 			continue;
 		}
 
@@ -223,7 +313,9 @@ bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_pr
 		case kWaitingForFinalImageFlush: {
 
 			GS_LOG_TRACE_MSG(trace, "Flushing Final Strobed Image");
-			app.StopCamera();
+			if (!persistent_capture) {
+				app.StopCamera();
+			}
 
 			Stream* stream = app.ViewfinderStream();
 
@@ -236,10 +328,19 @@ bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_pr
 
 			StreamInfo info = app.GetStreamInfo(stream);
 
+			// A YUV420 stream means that we are doing a mono capture (see GetCamera2ViewfinderFlags)
+			const bool y_plane_only = (info.pixel_format == libcamera::formats::YUV420);
+
 			CompletedRequestPtr& payload = std::get<CompletedRequestPtr>(msg.payload);
 			libcamera::FrameBuffer *buffer = payload->buffers[stream];
 			BufferReadSync r(&app, buffer);
 
+			// So that the analysis can tell which of the strobe pulses this frame could have caught
+			auto sensor_timestamp = payload->metadata.get(libcamera::controls::SensorTimestamp);
+			if (sensor_timestamp) {
+				golf_sim::GolfSimCamera::RecordCamera2FrameTiming(*sensor_timestamp, payload->metadata.get(libcamera::controls::ExposureTime).value_or(0));
+			}
+
 			const std::vector<libcamera::Span<uint8_t>> mem = r.Get();
 
 			uint32_t* image = (uint32_t*)mem[0].data();
@@ -255,15 +356,42 @@ bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_pr
 								", " + std::to_string(info.width) + ". Stride = " + std::to_string(info.stride));
 
 
-			cv::Mat frame = cv::Mat(info.height, info.width, CV_8UC3, image, info.stride);
+			// The Y plane comes first in a YUV420 buffer, and info.stride is its stride
+			cv::Mat frame = cv::Mat(info.height, info.width, y_plane_only ? CV_8UC1 : CV_8UC3, image, info.stride);
 
 			GS_LOG_TRACE_MSG(trace, "Created Mat frame");
 
-			// Save the image in memory
-			returnImg = frame.clone();
+			if (frame_handoff) {
+				// The completed request (held by msg) and the read sync are both still alive
+				// here, so the buffer cannot be recycled while the consumer reads it.
+				const golf_sim::GsGpuFrameBuffer frame_buffer = get_gpu_frame_buffer(buffer, info, y_plane_only);
+				frame_handoff(frame, &frame_buffer);
+			}
+			else {
+				// Save the image in memory
+				returnImg = frame.clone();
+			}
+
+			// Only a copy is made here.  The writing happens later, on the raw-dataset writer's thread.
+			if (golf_sim::GsRawDatasetWriter::IsEnabled()) {
+				StreamInfo raw_info;
+				Stream* raw_stream = golf_sim::GsRawDatasetWriter::WantsRawFrames() ? app.RawStream(&raw_info) : nullptr;
+				auto raw_buffer = (raw_stream != nullptr) ? payload->buffers.find(raw_stream) : payload->buffers.end();
+
+				if (raw_buffer != payload->buffers.end()) {
+					BufferReadSync raw_read(&app, raw_buffer->second);
+					const std::vector<libcamera::Span<uint8_t>> raw_mem = raw_read.Get();
+					golf_sim::GsRawDatasetWriter::SubmitRawFrame(raw_mem[0], raw_info, payload->metadata, app.CameraModel());
+				}
+				else {
+					// E.g., the camera was configured without a raw stream
+					golf_sim::GsRawDatasetWriter::SubmitFrame(frame);
+				}
+			}
 
 			// THE FOLLOWING CREATES A SEGMENTATION FAULT: returnImg = cv::Mat(info.height, info.width, CV_8UC3, image, info.stride);
-			// So, that's why the frame is being cloned.
+			// That is because returnImg would outlive the completed request that owns the buffer.
+			// So, that's why the frame is being cloned (or handed off, above).
 			GS_LOG_TRACE_MSG(trace, "Returning (Final, Strobed) Viewfinder captured image");
 			// golf_sim::LoggingTools::LogImage("", returnImg, std::vector < cv::Point >{}, true, "Cam2_Strobed_Image.png");
 
@@ -311,6 +439,12 @@ bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_pr
 			// Create a completed request to make sure that the buffer(s) get re-used.
 			CompletedRequestPtr& completed_request = std::get<CompletedRequestPtr>(msg.payload);
 
+			// The first frames after the camera starts may not be properly exposed (see above), so
+			// only the later priming frames go into the background model
+			if (priming_frame_handoff && timeLapsed >= kQuiesceTimeMs / 2 && gs::GsCamera2Background::WantsFrame()) {
+				hand_off_viewfinder_frame(app, completed_request, priming_frame_handoff);
+			}
+
 			if (timeLapsed < kQuiesceTimeMs) {
 				GS_LOG_TRACE_MSG(trace, "Ignoring trigger - still quiescing...");
 				state = kWaitingForFirstPrimingTimeEnd;
@@ -429,15 +563,16 @@ bool cam2_run_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool send_pr
 bool ball_flight_camera_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg)
 {
 	app.OpenCamera();
-	uint flags = RPiCamApp::FLAG_STILL_RGB;
+	uint flags = golf_sim::LibCameraInterface::GetCamera2ViewfinderFlags();
 	app.ConfigureViewfinder(flags);
-	bool result = cam2_run_event_loop(app, returnImg, true);
+	bool result = cam2_run_event_loop(app, returnImg, true, nullptr, false, nullptr);
 	return result;
 }
 
 	// The main event loop for the camera 1 system.
 
-	bool still_image_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg)
+	bool still_image_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg,
+								const std::function<bool(const cv::Mat&)>& frame_handler)
 	{
 		GS_LOG_TRACE_MSG(trace, "still_image_event_loop");
 
@@ -513,7 +648,10 @@ bool ball_flight_camera_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg)
 			// In still capture mode, save a jpeg and quit.
 			else if (app.StillStream())
 			{
-				app.StopCamera();
+				// When streaming, the camera stays in the still configuration between frames
+				if (!frame_handler) {
+					app.StopCamera();
+				}
 				GS_LOG_TRACE_MSG(trace, "Still capture image received");
 
 
@@ -537,11 +675,91 @@ bool ball_flight_camera_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg)
 				// Save the image in memory
 				returnImg = frame.clone();
 
-				return true;
+				if (!frame_handler) {
+					return true;
+				}
+
+				if (!frame_handler(returnImg)) {
+					app.StopCamera();
+					return true;
+				}
 			}
 		}
 }
 
+	bool persistent_still_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool& camera_started)
+	{
+		if (!camera_started) {
+			GS_LOG_TRACE_MSG(trace, "persistent_still_event_loop - starting the camera.");
+
+			libcamera::logSetLevel("*", "ERROR");
+			RPiCamApp::verbosity = 0;
+
+			app.GetOptions()->Set().no_raw = true;  // See https://forums.raspberrypi.com/viewtopic.php?t=369927
+
+			app.StartCamera();
+			camera_started = true;
+		}
+
+		// Whatever was queued while nobody was asking is older than the request.  Dropping those
+		// frames gives their buffers back to the camera, so a new frame follows within a frame or two.
+		struct timespec request_time;
+		clock_gettime(CLOCK_BOOTTIME, &request_time);
+		const int64_t request_time_ns = (int64_t)request_time.tv_sec * 1000000000 + request_time.tv_nsec;
+
+		for (;;)
+		{
+			if (!gs::GolfSimGlobals::golf_sim_running_) {
+				return false;
+			}
+
+			RPiCamApp::Msg msg = app.Wait();
+
+			if (msg.type == RPiCamApp::MsgType::Timeout)
+			{
+				GS_LOG_MSG(error, "ERROR: Device timeout detected in persistent_still_event_loop, attempting a restart.");
+				app.StopCamera();
+				app.StartCamera();
+				continue;
+			}
+			if (msg.type == RPiCamApp::MsgType::Quit) {
+				GS_LOG_TRACE_MSG(trace, "Received Quit message in persistent_still_event_loop.");
+				return false;
+			}
+			else if (msg.type != RPiCamApp::MsgType::RequestComplete) {
+				GS_LOG_MSG(error, "Unrecognised camera message type in persistent_still_event_loop, aborting.");
+				return false;
+			}
+
+			Stream* stream = app.StillStream();
+			if (stream == nullptr) {
+				continue;
+			}
+
+			CompletedRequestPtr& payload = std::get<CompletedRequestPtr>(msg.payload);
+
+			auto sensor_timestamp = payload->metadata.get(libcamera::controls::SensorTimestamp);
+			if (sensor_timestamp && *sensor_timestamp < request_time_ns) {
+				continue;
+			}
+
+			StreamInfo info = app.GetStreamInfo(stream);
+			libcamera::FrameBuffer *buffer = payload->buffers[stream];
+
+			BufferReadSync r(&app, buffer);
+
+			const std::vector<libcamera::Span<uint8_t>> mem = r.Get();
+
+			uint32_t* image = (uint32_t*)mem[0].data();
+
+			cv::Mat frame = cv::Mat(info.height, info.width, CV_8UC3, image, info.stride);
+
+			returnImg = frame.clone();
+
+			return true;
+		}
+}
+
 
 
 
@@ -6,6 +6,9 @@
 // ImageProcessing.cpp { This file contains the main test function. Program execution begins and ends there.
 //
 
+#include <chrono>
+#include <thread>
+
 #include <boost/timer/timer.hpp>
 
 #include <opencv2/calib3d/calib3d.hpp>
@@ -36,6 +39,7 @@
 
 #include "gs_gspro_results.h"
 #include "gs_gspro_test_server.h"
+#include "gs_sim_socket_reactor.h"
 #include "gs_gspro_response.h"
 #include "gs_sim_interface.h"
 #include "gs_e6_interface.h"
@@ -44,6 +48,38 @@
 
 #include "gs_fsm.h"
 #include "gs_http_client.h"
+#include "gs_image_writer.h"
+#include "gs_jpeg_encoder.h"
+#include "gs_image_service.h"
+#include "gs_shared_memory.h"
+#include "gs_preview_stream.h"
+#include "gs_local_display.h"
+#include "gs_raw_dataset_writer.h"
+#include "gs_club_strike_encoder.h"
+#include "gs_club_strike_analysis.h"
+#include "gs_shot_trace.h"
+#include "gs_metrics.h"
+#include "gs_http_server.h"
+#include "gs_memory_footprint.h"
+#include "gs_ball_flight.h"
+#include "gs_exposure_predictor.h"
+#include "gs_remote_analysis.h"
+#include "gs_config_reload.h"
+#include "gs_performance_state.h"
+#include "gs_camera2_background.h"
+#include "gs_crop_planner.h"
+#include "gs_camera_health.h"
+#include "gs_swing_replay.h"
+#include "gs_camera2_exposure.h"
+#include "gs_shot_history.h"
+#include "gs_shot_pipeline.h"
+#include "gs_kernel_benchmark.h"
+#include "gs_performance_profile.h"
+#include "gs_latency_bench.h"
+#include "gs_hough_sweep.h"
+#include "gs_virtual_camera.h"
+#include "gs_event_journal.h"
+#include "worker_thread.h"
 #include "libcamera_interface.h"
 
 
@@ -883,10 +919,15 @@ bool TestGSProServer() {
         int kGSProConnectPort;
         GolfSimConfiguration::SetConstant("gs_config.golf_simulator_interfaces.GSPro.kGSProConnectPort", kGSProConnectPort);
 
-        boost::asio::io_context io_context;
-        GsGSProTestServer server(io_context, kGSProConnectPort);
-        GS_LOG_TRACE_MSG(trace, "About to call io_context.run()");
-        io_context.run();
+        GsGSProTestServer server(GsSimSocketReactor::Instance().GetIoContext(), kGSProConnectPort);
+        GS_LOG_TRACE_MSG(trace, "GSPro test server is running on the simulator socket reactor.");
+
+        while (GolfSimGlobals::golf_sim_running_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        // The server's pending accept refers to it, so stop before it goes away
+        GsSimSocketReactor::Instance().Stop();
     }
     catch (std::exception& e)
     {
@@ -1168,6 +1209,30 @@ void run_main(int argc, char* argv[])
             break;
         }
 
+        case SystemMode::kCamera1MarkerCalibrate:
+        case SystemMode::kCamera2MarkerCalibrate:
+        {
+            GS_LOG_MSG(info, "Running in kCamera1MarkerCalibrate or kCamera2MarkerCalibrate mode.");
+
+            // Initialize cameras and system components
+            if (!PerformSystemStartupTasks()) {
+                GS_LOG_MSG(error, "Failed to PerformSystemStartupTasks.");
+                return;
+            }
+
+            GsCameraNumber camera_number = (GolfSimOptions::GetCommandLineOptions().system_mode_ == SystemMode::kCamera1MarkerCalibrate ?
+                                        GsCameraNumber::kGsCamera1 : GsCameraNumber::kGsCamera2);
+
+            GolfSimCalibration calibrator;
+
+            if (!calibrator.MarkerCalibrateCamera(camera_number)) {
+                GS_LOG_MSG(info, "Failed to MarkerCalibrateCamera.");
+                return;
+            }
+
+            break;
+        }
+
         case SystemMode::kCamera1Calibrate:
         case SystemMode::kCamera2Calibrate:
         {
@@ -1226,6 +1291,110 @@ void run_main(int argc, char* argv[])
         }
         break;
 
+        case SystemMode::kRemoteAnalysisWorker:
+        {
+            GS_LOG_MSG(info, "Running in kRemoteAnalysisWorker mode.");
+
+            if (!GsRemoteAnalysis::RunWorker()) {
+                GS_LOG_MSG(error, "Failed to RunWorker.");
+                return;
+            }
+        }
+        break;
+
+        case SystemMode::kReplayBenchmark:
+        {
+            GS_LOG_MSG(info, "Running in kReplayBenchmark mode.");
+
+            if (!GsAutomatedTesting::RunReplayBenchmark()) {
+                GS_LOG_MSG(error, "Failed to RunReplayBenchmark.");
+                return;
+            }
+        }
+        break;
+
+        case SystemMode::kKernelBenchmark:
+        {
+            GS_LOG_MSG(info, "Running in kKernelBenchmark mode.");
+
+            if (!GsKernelBenchmark::Run()) {
+                GS_LOG_MSG(error, "Failed to run the GsKernelBenchmark.");
+                return;
+            }
+        }
+        break;
+
+        case SystemMode::kPerformanceBenchmark:
+        {
+            GS_LOG_MSG(info, "Running in kPerformanceBenchmark mode.");
+
+            if (!GsPerformanceProfile::RunBenchmark()) {
+                GS_LOG_MSG(error, "Failed to run the GsPerformanceProfile benchmark.");
+                return;
+            }
+        }
+        break;
+
+        case SystemMode::kLatencyBench:
+        {
+            GS_LOG_MSG(info, "Running in kLatencyBench mode.");
+
+            if (!GsLatencyBench::Run()) {
+                GS_LOG_MSG(error, "Failed to run the GsLatencyBench.");
+                return;
+            }
+        }
+        break;
+
+        case SystemMode::kHoughSweep:
+        {
+            GS_LOG_MSG(info, "Running in kHoughSweep mode.");
+
+            if (!GsHoughSweep::Run()) {
+                GS_LOG_MSG(error, "Failed to run the GsHoughSweep.");
+                return;
+            }
+        }
+        break;
+
+        case SystemMode::kHoughAutotune:
+        {
+            GS_LOG_MSG(info, "Running in kHoughAutotune mode.");
+
+            if (!GsHoughSweep::RunAutotune()) {
+                GS_LOG_MSG(error, "Failed to run the GsHoughSweep autotune.");
+                return;
+            }
+        }
+        break;
+
+        case SystemMode::kVirtualCamera:
+        {
+            GS_LOG_MSG(info, "Running in kVirtualCamera mode.");
+
+            if (!GsVirtualCamera::Run()) {
+                GS_LOG_MSG(error, "Failed to run the GsVirtualCamera.");
+                return;
+            }
+        }
+        break;
+
+        case SystemMode::kEventJournalReplay:
+        {
+            GS_LOG_MSG(info, "Running in kEventJournalReplay mode.");
+
+            if (!GsEventJournal::StartReplay()) {
+                GS_LOG_MSG(error, "Failed to start the GsEventJournal replay.");
+                return;
+            }
+
+            state::InitializingCamera1System camera1_state;
+            RunGolfSimFsm(camera1_state);
+
+            GsEventJournal::StopReplay();
+        }
+        break;
+
         case SystemMode::kAutomatedTesting:
         {
             if (!GsAutomatedTesting::TestBallPosition()) {
@@ -1362,6 +1531,25 @@ void run_main(int argc, char* argv[])
             break;
         }
 
+        case SystemMode::kCamera1MarkerCalibrate:
+        case SystemMode::kCamera2MarkerCalibrate:
+        {
+            GS_LOG_MSG(info, "Running in kCamera1MarkerCalibrate or kCamera2MarkerCalibrate mode.");
+
+            GsCameraNumber camera_number = (GolfSimOptions::GetCommandLineOptions().system_mode_ == SystemMode::kCamera1MarkerCalibrate ?
+                GsCameraNumber::kGsCamera1 : GsCameraNumber::kGsCamera2);
+
+            // The constructor reads the board's constants
+            GolfSimCalibration calibrator;
+
+            if (!calibrator.MarkerCalibrateCamera(camera_number)) {
+                GS_LOG_MSG(info, "Failed to MarkerCalibrateCamera.");
+                return;
+            }
+
+            break;
+        }
+
         case SystemMode::kCamera1BallLocation:
         case SystemMode::kCamera2BallLocation:
         {
@@ -1524,6 +1712,54 @@ int main(int argc, char *argv[])
 
         // Load BallImageProc configuration values after JSON config is loaded
         BallImageProc::LoadConfigurationValues();
+        GsThreadPool::LoadConfigurationValues();
+        GsThreadPool::InstallOpenCVParallelBackend();
+        GsImageWriter::LoadConfigurationValues();
+        GsJpegEncoder::LoadConfigurationValues();
+        GsShotTrace::LoadConfigurationValues();
+        GsMetrics::LoadConfigurationValues();
+#ifdef __unix__
+        GsHttpServer::LoadConfigurationValues();
+#endif
+        GsBallFlight::LoadConfigurationValues();
+        GsExposurePredictor::LoadConfigurationValues();
+#ifdef __unix__
+        GsImageService::LoadConfigurationValues();
+        GsSharedMemory::LoadConfigurationValues();
+        GsPreviewStream::LoadConfigurationValues();
+        GsLocalDisplay::LoadConfigurationValues();
+        GsRawDatasetWriter::LoadConfigurationValues();
+        GsRemoteAnalysis::LoadConfigurationValues();
+        GsPerformanceState::LoadConfigurationValues();
+        GsShotPipeline::LoadConfigurationValues();
+        GsCamera2Background::LoadConfigurationValues();
+        GsCropPlanner::LoadConfigurationValues();
+        GsCameraHealth::LoadConfigurationValues();
+        GsSwingReplay::LoadConfigurationValues();
+        GsCamera2Exposure::LoadConfigurationValues();
+        GsShotHistory::LoadConfigurationValues();
+#endif
+        // After everything that the low-memory profile overrides
+        GsMemoryFootprint::LoadConfigurationValues();
+#ifdef __unix__
+        // May benchmark the kernels, so after everything that they use
+        GsPerformanceProfile::LoadConfigurationValues();
+#endif
+        GsConfigReload::LoadConfigurationValues();
+        GsShotTrace::StartHttpEndpoint();
+        GsMetrics::StartHttpEndpoint();
+#ifdef __unix__
+        GsImageService::Start();
+        GsSharedMemory::Start();
+        GsPreviewStream::Start();
+        if (!GsLocalDisplay::Start()) {
+            GS_LOG_MSG(warning, "Could not start the local display.");
+        }
+        GsShotHistory::Start();
+        // After everything that adds a route to it
+        GsHttpServer::Start();
+#endif
+        GsConfigReload::Start();
 
 	// If we have a version 3 Connector Board, then we want to ensure
 	// that it has been properly calibrated before we let the system
@@ -1554,6 +1790,29 @@ int main(int argc, char *argv[])
         // Signal all background threads to stop
         GolfSimGlobals::golf_sim_running_ = false;
 
+        GsConfigReload::Stop();
+#ifdef __unix__
+        GsPreviewStream::Stop();
+        GsLocalDisplay::Stop();
+        // Publishes anything still queued, so the web server hears about it below
+        GsImageService::Stop();
+        GsSharedMemory::Stop();
+        // After the preview stream has closed its viewers' responses
+        GsHttpServer::Stop();
+#endif
+
+        // Make sure any queued diagnostic and web-server images make it to disk,
+        // and then that the web server hears about anything still queued
+        GsImageWriter::Shutdown();
+#ifdef __unix__
+        GsRawDatasetWriter::Shutdown();
+        GsHttpClient::Shutdown();
+        GsClubStrikeEncoder::Shutdown();
+        GsSwingReplay::Shutdown();
+        GsClubStrikeAnalysis::Shutdown();
+        GsShotHistory::Shutdown();
+#endif
+
         try {
             golf_sim::PulseStrobe::DeinitGPIOSystem();
             GS_LOG_MSG(info, "GPIO system cleaned up successfully");
@@ -1566,6 +1825,15 @@ int main(int argc, char *argv[])
     {
         GS_LOG_MSG(error, "Exception occurred. ERROR: *** " + std::string(e.what()) + " ***");
 
+        GsImageWriter::Shutdown();
+#ifdef __unix__
+        GsHttpClient::Shutdown();
+        GsClubStrikeEncoder::Shutdown();
+        GsSwingReplay::Shutdown();
+        GsClubStrikeAnalysis::Shutdown();
+        GsShotHistory::Shutdown();
+#endif
+
         try {
             golf_sim::PulseStrobe::DeinitGPIOSystem();
         } catch (...) {
@@ -4,7 +4,13 @@
  */
 
 #include <algorithm>
+#include <cstdlib>
+#include <mutex>
 #include "gs_format_lib.h"
+#include <boost/core/null_deleter.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/bounded_fifo_queue.hpp>
+#include <boost/log/sinks/block_on_overflow.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
 #include <boost/log/sinks/basic_sink_backend.hpp>
 #include <boost/log/core/record_view.hpp>
@@ -61,8 +67,22 @@ namespace golf_sim {
 
 
 
+    // The console and file sinks format and write each record on their own thread.
+    // Their queues are bounded, and a full queue makes the logging thread wait rather
+    // than drop the record.
+    static const size_t kAsyncLogQueueSize = 4096;
+
+    typedef asynchronous_sink<text_ostream_backend, bounded_fifo_queue<kAsyncLogQueueSize, block_on_overflow>> AsyncConsoleSink;
+    typedef asynchronous_sink<text_file_backend, bounded_fifo_queue<kAsyncLogQueueSize, block_on_overflow>> AsyncFileSink;
+
+    static boost::shared_ptr<AsyncConsoleSink> console_sink;
+    static boost::shared_ptr<AsyncFileSink> file_sink;
+
     bool LoggingTools::logging_is_initialized_ = false;
-    std::string LoggingTools::current_error_root_cause_;
+
+    // Set on the FSM thread and read on whichever thread sends the error to the UI
+    static std::string current_error_root_cause;
+    static std::mutex current_error_root_cause_mutex;
 
     // Waits for the user to press a key before continuing after showing an image
     bool LoggingTools::logging_tool_wait_for_keypress_ = false;
@@ -77,6 +97,19 @@ namespace golf_sim {
 
 
 
+    void LoggingTools::SetErrorRootCause(const std::string& root_cause) {
+        std::lock_guard<std::mutex> lock(current_error_root_cause_mutex);
+        current_error_root_cause = root_cause;
+    }
+
+    std::string LoggingTools::TakeErrorRootCause() {
+        std::lock_guard<std::mutex> lock(current_error_root_cause_mutex);
+        std::string root_cause;
+        root_cause.swap(current_error_root_cause);
+        return root_cause;
+    }
+
+
     void LoggingTools::InitLogging()
     {
         boost::log::add_common_attributes();
@@ -156,8 +189,13 @@ namespace golf_sim {
             % fmtTimeStamp % fmtThreadId % fmtSeverity % fmtScope
             % boost::log::expressions::smessage;
 
-        auto consoleSink = boost::log::add_console_log(std::clog);
-        consoleSink->set_formatter(logFmt);
+        boost::shared_ptr<text_ostream_backend> console_backend = boost::make_shared<text_ostream_backend>();
+        console_backend->add_stream(boost::shared_ptr<std::ostream>(&std::clog, boost::null_deleter()));
+        console_backend->auto_flush(true);
+
+        console_sink = boost::make_shared<AsyncConsoleSink>(console_backend);
+        console_sink->set_formatter(logFmt);
+        boost::log::core::get()->add_sink(console_sink);
 
         // Use ~/.pitrac/logs/ for text logs
         std::string log_dir;
@@ -169,15 +207,19 @@ namespace golf_sim {
             log_dir = "/tmp/pitrac/logs/";
         }
         
-        auto fsSink = boost::log::add_file_log(
+        boost::shared_ptr<text_file_backend> file_backend = boost::make_shared<text_file_backend>(
             boost::log::keywords::file_name = log_dir + "test_%Y-%m-%d_%H-%M-%S.%N.log",
             boost::log::keywords::rotation_size = 10 * 1024 * 1024,
             boost::log::keywords::min_free_space = 30 * 1024 * 1024,
             boost::log::keywords::open_mode = std::ios_base::app);
+        file_backend->auto_flush(true);
 
-        // This is pretty verbose! fsSink->set_formatter(logFmtWithLineNumbers);
-        fsSink->set_formatter(logFmt);
-        fsSink->locked_backend()->auto_flush(true);
+        file_sink = boost::make_shared<AsyncFileSink>(file_backend);
+        // This is pretty verbose! file_sink->set_formatter(logFmtWithLineNumbers);
+        file_sink->set_formatter(logFmt);
+        boost::log::core::get()->add_sink(file_sink);
+
+        std::atexit(&LoggingTools::ShutdownLogging);
 
         // Add our custom recent-messages sink to the logger.
         /*** TBD - Not Completed yet
@@ -195,6 +237,23 @@ namespace golf_sim {
 
     }
 
+    void LoggingTools::ShutdownLogging() {
+        // Remove the sinks first so that nothing new is queued while the rest is written
+        if (console_sink) {
+            boost::log::core::get()->remove_sink(console_sink);
+            console_sink->stop();
+            console_sink->flush();
+            console_sink.reset();
+        }
+
+        if (file_sink) {
+            boost::log::core::get()->remove_sink(file_sink);
+            file_sink->stop();
+            file_sink->flush();
+            file_sink.reset();
+        }
+    }
+
     boost::circular_buffer<std::string> &LoggingTools::GetRecentLogMessagesQueue() {
         return RecentLogMessages;
     }
@@ -456,7 +515,8 @@ namespace golf_sim {
         const std::vector < GsCircle >& circles,
         bool forceFixedFileName,
         const std::string& fixedFileName,
-        const std::string& suffix) {
+        const std::string& suffix,
+        GsImageWriter::ArtifactClass artifact_class) {
 
         cv::Mat imgToLog = img.clone();
 
@@ -471,7 +531,9 @@ namespace golf_sim {
             imgToLog,
             std::vector<cv::Point>({}),
             forceFixedFileName,
-            fixedFileName);
+            fixedFileName,
+            suffix,
+            artifact_class);
     }
 
 
@@ -489,12 +551,52 @@ namespace golf_sim {
         const std::vector < cv::Point >& pointFeatures,
         bool forceFixedFileName,
         const std::string& fixedFileName,
-        const std::string& suffix) {
+        const std::string& suffix,
+        GsImageWriter::ArtifactClass artifact_class) {
 
         if (img.empty()) {
             InternalLog(warning, "LogImage: image was empty - ignoring.");
             return false;
         }
+
+        std::string fname = GetLogImageFileName(fileNameTag, forceFixedFileName, fixedFileName);
+
+        cv::Mat imgToLog = img.clone();
+
+        for (auto& point : pointFeatures)
+        {
+            cv::circle(imgToLog, point, 2, cv::Scalar{ 0, 0, 0 }, 24);  // Nominal width was 24
+        }
+
+        // imgToLog is our own copy, so the writer can have it.  Any failure is logged by the writer.
+        GsImageWriter::Write(fname, imgToLog, artifact_class);
+
+        return true;
+    }
+
+    bool LoggingTools::LogAnnotatedImage(const std::string& fileNameTag,
+        const cv::Mat& img,
+        std::vector<GsImageWriter::CircleAnnotation> annotations,
+        bool forceFixedFileName,
+        const std::string& fixedFileName,
+        GsImageWriter::ArtifactClass artifact_class) {
+
+        if (img.empty()) {
+            InternalLog(warning, "LogAnnotatedImage: image was empty - ignoring.");
+            return false;
+        }
+
+        std::string fname = GetLogImageFileName(fileNameTag, forceFixedFileName, fixedFileName);
+
+        // No copy here - the writer draws the annotations on its own copy.  Any failure is logged by the writer.
+        GsImageWriter::WriteAnnotated(fname, img, std::move(annotations), artifact_class);
+
+        return true;
+    }
+
+    std::string LoggingTools::GetLogImageFileName(const std::string& fileNameTag,
+                                                  bool forceFixedFileName,
+                                                  const std::string& fixedFileName) {
         std::string fname;
 
         // To ensure that the GUI has a fixed file name to use to display for the user, we may later save both
@@ -509,28 +611,11 @@ namespace golf_sim {
             fname = kBaseImageLoggingDir + kLogImagePrefix + fileNameTag + dateTimeStr + ".png";
         }
 
-        cv::Mat imgToLog = img.clone();
-
-        for (auto& point : pointFeatures)
-        {
-            cv::circle(imgToLog, point, 2, cv::Scalar{ 0, 0, 0 }, 24);  // Nominal width was 24
-        }
-
         if (fname.find(".png") == std::string::npos) {
             fname += ".png";
         }
 
-        try {
-            cv::imwrite(fname, imgToLog);
-        }
-        catch (std::exception& ex) {
-            GS_LOG_TRACE_MSG(warning, "Exception! - failed to imwrite with fname = " + fname + " - " + ex.what());
-            return true;
-        }
-
-        InternalLog(trace, "Logged image to file: " + fname);
-
-        return true;
+        return fname;
     }
 
     // Only shows the image if the logging level is at or below debug
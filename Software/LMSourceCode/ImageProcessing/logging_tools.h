@@ -28,7 +28,10 @@
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/highgui.hpp>
 
+#include "gs_image_writer.h"
+
 #include <string>
+#include <type_traits>
 
 #include "golf_ball.h"   // TBD - Something wrong here architecturally - why does logging know about specific golf types?  Does that make sense?
 #include "gs_globals.h"
@@ -42,12 +45,21 @@ struct LoggingTools
 	static bool logging_is_initialized_;
 	static bool logging_tool_wait_for_keypress_;
 
-	static std::string current_error_root_cause_;
+	// Why the last attempt to find or analyze a shot failed, for the UI (see
+	// GsUISystem::SendIPCErrorStatusMessage).  Safe to use from any thread.  A shot that
+	// is being analyzed keeps its own in its GsAnalysisContext instead.
+	static void SetErrorRootCause(const std::string& root_cause);
+	// Returns the root cause, if any, and clears it
+	static std::string TakeErrorRootCause();
 
 	static std::string kBaseImageLoggingDir;
 
 	static void InitLogging();
 
+	// Stops the background logging threads once everything queued so far has been
+	// written.  Registered with atexit by InitLogging, so it normally need not be called.
+	static void ShutdownLogging();
+
 	// Lowest-level logging function to allow for additional filtering, sinking, etc.
 	static void InternalLog(boost::log::trivial::severity_level level, const std::string& msg);
 
@@ -84,19 +96,37 @@ struct LoggingTools
 	//      "gs_log_img__last_hit__2023-11-13_12-52-47.0.png"
 	// If forceFixedFileName is true, the logged image filename will be fixedFileName
 	// Otherwise, the file name will have a date & 
+	// The artifact_class determines how the image is encoded, which may change the ".png" extension.
 	static bool LogImage(const std::string& fileNameTag,
 							const cv::Mat& img,
 							const std::vector < cv::Point >& pointFeatures,
 							bool forceFixedFileName = false,
 							const std::string& fixedFileName = std::string(""),
-							const std::string& suffix = std::string(""));
+							const std::string& suffix = std::string(""),
+							GsImageWriter::ArtifactClass artifact_class = GsImageWriter::ArtifactClass::kLogImage);
 
 	static bool LogImageWithCircles(const std::string& fileNameTag,
 								    const cv::Mat& img,
 									const std::vector < GsCircle >& circles,
 									bool forceFixedFileName = false,
 									const std::string& fixedFileName = std::string(""),
-									const std::string& suffix = std::string(""));
+									const std::string& suffix = std::string(""),
+									GsImageWriter::ArtifactClass artifact_class = GsImageWriter::ArtifactClass::kLogImage);
+
+	// Like LogImage, but without copying img here.  The annotations are drawn on a copy
+	// of img only when the image is written, usually on the image-writer thread, so img
+	// must not be changed afterward.
+	static bool LogAnnotatedImage(const std::string& fileNameTag,
+								  const cv::Mat& img,
+								  std::vector<GsImageWriter::CircleAnnotation> annotations,
+								  bool forceFixedFileName = false,
+								  const std::string& fixedFileName = std::string(""),
+								  GsImageWriter::ArtifactClass artifact_class = GsImageWriter::ArtifactClass::kLogImage);
+
+	// The full path that LogImage will write to (before any change of extension by the image writer)
+	static std::string GetLogImageFileName(const std::string& fileNameTag,
+										   bool forceFixedFileName,
+										   const std::string& fixedFileName);
 
 	// Create a unique, seconds-based date-time string
 	static std::string GetUniqueLogName();
@@ -145,11 +175,33 @@ protected:
 	static boost::circular_buffer<std::string> RecentLogMessages;
 };
 
+// Messages below this level are compiled out entirely, so their MSG expressions are
+// never even built.  0 (trace) keeps everything.  Set with the meson
+// 'min_compiled_log_level' option.  Levels that are compiled in are still subject to the
+// run-time --logging_level filter, which also skips building MSG.
+#ifndef GS_LOG_MIN_COMPILED_LEVEL
+#define GS_LOG_MIN_COMPILED_LEVEL 0
+#endif
+
+#define GS_LOG_LEVEL_IS_COMPILED(LEVEL) ((int)::boost::log::trivial::LEVEL >= GS_LOG_MIN_COMPILED_LEVEL)
+
+// Takes the place of the BOOST_LOG_FUNCTION named-scope sentry if the level is compiled out
+struct GsNoLogScope {
+	template <typename... Args> constexpr GsNoLogScope(Args&&...) {}
+};
+
+template <bool kCompiledIn>
+using GsLogScope = std::conditional_t<kCompiledIn, boost::log::attributes::named_scope::sentry, GsNoLogScope>;
+
+// Same as BOOST_LOG_FUNCTION(), but costs nothing if the level is compiled out
+#define GS_LOG_SCOPE(LEVEL) [[maybe_unused]] ::golf_sim::GsLogScope<GS_LOG_LEVEL_IS_COMPILED(LEVEL)> \
+	BOOST_LOG_UNIQUE_IDENTIFIER_NAME(gs_log_scope_)(BOOST_CURRENT_FUNCTION, __FILE__, __LINE__, ::boost::log::attributes::named_scope_entry::function)
+
 // Used as a define so that we can get file/line-numbers in our tracing if we want
-#define GS_LOG_MSG(LEVEL, MSG) BOOST_LOG_FUNCTION();  BOOST_LOG_TRIVIAL(LEVEL) << MSG
+#define GS_LOG_MSG(LEVEL, MSG) GS_LOG_SCOPE(LEVEL);  if constexpr (GS_LOG_LEVEL_IS_COMPILED(LEVEL)) BOOST_LOG_TRIVIAL(LEVEL) << MSG
 
 // Trace logging is everywhere, so this macro allows just that macro to be undefined
 // in order to increase performance
-#define GS_LOG_TRACE_MSG(LEVEL, MSG) BOOST_LOG_FUNCTION();  BOOST_LOG_TRIVIAL(LEVEL) << MSG
+#define GS_LOG_TRACE_MSG(LEVEL, MSG) GS_LOG_SCOPE(LEVEL);  if constexpr (GS_LOG_LEVEL_IS_COMPILED(LEVEL)) BOOST_LOG_TRIVIAL(LEVEL) << MSG
 
 }
@@ -11,14 +11,20 @@
 
 #pragma once
 
+#include <array>
+
 #include "core/rpicam_app.hpp"
 
 #include "post_processing_stages/post_processing_stage.hpp"
 
+#include "gs_watcher_stage_chain.h"
+
 
 using Stream = libcamera::Stream;
 
-class MotionDetectStage : public PostProcessingStage
+// Also a GsWatcherStage, so that ball_watcher_event_loop can run it in a GsWatcherStageChain
+// on frames that are already mapped
+class MotionDetectStage : public PostProcessingStage, public golf_sim::GsWatcherStage
 {
 public:
 	MotionDetectStage(RPiCamApp* app) : PostProcessingStage(app) {}
@@ -28,9 +34,33 @@ public:
 	void Read(boost::property_tree::ptree const& params) override;
 
 	void Configure() override;
+	// The work of Configure(), for streams that need not be app_'s (e.g., GsVirtualCamera's,
+	// whose stage has no app).  lores_stream is only used if use_lores_stream is set.
+	void Configure(Stream* main_stream, const StreamInfo& main_info, Stream* lores_stream = nullptr,
+				   const StreamInfo& lores_info = StreamInfo());
 
+	// The rpicam-apps post-processing entry point, which maps the buffers itself
 	bool Process(CompletedRequestPtr& completed_request) override;
 
+	// Ends the chain once motion has been reported (see GetLastResult)
+	bool Process(golf_sim::GsWatcherFrame& frame) override;
+
+	// The same value that Process() puts in "motion_detect.result"
+	bool GetLastResult() const { return last_result_; }
+
+	// Only for GsKernelBenchmark.  Sets up the ROI, thresholds and background model the way
+	// Configure() does, but without a camera stream.  roi_width and roi_height are in
+	// decimated pixels.
+	void ConfigureForBenchmark(unsigned int roi_width, unsigned int roi_height);
+	// Runs Process()'s pixel loop over the whole ROI of frame (without stopping early) and
+	// returns the number of changed pixels.  frame_stride is the stride before decimation.
+	unsigned int CountChangedPixels(const uint8_t* frame, unsigned int frame_stride);
+	// The background-model detector's test of one frame (see use_background_model).
+	// Returns true if enough of the ROI differs from the background to count as motion.
+	bool DiffersFromBackground(const uint8_t* frame, unsigned int frame_stride);
+	// Sets the background to the frame, as is done with the first frame
+	void InitializeBackground(const uint8_t* frame, unsigned int frame_stride);
+
 
 	// In the Config, dimensions are given as fractions of the image size.
 	struct Config
@@ -46,6 +76,34 @@ public:
 		int frame_period;
 		bool verbose;
 		bool showroi;
+		// If true and the app configured a lores stream, the motion detection runs on
+		// that ISP-scaled stream instead of decimating the main stream by hskip/vskip.
+		// The ROI is still given in main-stream pixels.
+		bool use_lores_stream = false;
+		// If true and frame_period > 1, the sensor is run at the sampled frame rate instead
+		// (see ConfigCameraForCropping), so the skipped frames are never captured at all.
+		bool use_sensor_frame_skipping = false;
+		// If true, each frame is compared to a running average of the prior frames rather
+		// than to just the previous frame, which averages out the sensor noise.  A sparse
+		// grid of the ROI (every background_screen_stride'th pixel of every
+		// background_screen_stride'th row) is checked first, and the whole ROI is only
+		// scanned if enough of the grid has changed.
+		bool use_background_model = false;
+		int background_screen_stride = 4;
+		// If true, nothing in Process() allocates once the stage is running.  The result
+		// is only available from GetLastResult() and the log messages are deferred.
+		bool realtime_mode = false;
+		// If true, a second ROI (given like the ROI) behind the ball, on the side that the club
+		// comes from, is also watched.  Motion there means the club is on its way, and pre-arms
+		// the trigger (see PulseStrobe::PreArmTrigger), so that once the ball moves there is
+		// nothing left to do but send it.  The approach zone is always compared to the
+		// previous frame, even with use_background_model.
+		bool use_approach_zone = false;
+		float approach_roi_x = 0, approach_roi_y = 0;
+		float approach_roi_width = 0, approach_roi_height = 0;
+		// The number of checked frames without motion in the approach zone after which a
+		// pre-arm is given up, e.g., after a practice swing or a waggle
+		int approach_release_frames = 30;
 	};
 
 	// This is the current configuration of the MotionDetectStage
@@ -59,7 +117,17 @@ public:
 	static Config incoming_configuration;
 
 private:
+	// stream_ is the one that is checked for motion.  The club-strike frames and
+	// logged images always come from main_stream_, which may be the same stream.
 	Stream* stream_;
+	Stream* main_stream_;
+	// Main-stream pixels per stream_ pixel, used to draw the ROI on main-stream frames
+	float roi_to_main_scale_x_ = 1.0;
+	float roi_to_main_scale_y_ = 1.0;
+	// The skips that Process() uses - config_'s, or 1 when the lores stream has already been
+	// decimated by the ISP.  config_ itself is left as configured, so Configure() may be
+	// called again (e.g., when the camera is recovered).
+	uint hskip_ = 1, vskip_ = 1;
 	// Here we convert the dimensions to pixel locations in the image, as if subsampled
 	// by hskip and vskip.
 	uint roi_x_, roi_y_;
@@ -67,8 +135,58 @@ private:
 	uint region_threshold_;
 	uint max_region_threshold_;
 	std::vector<uint8_t> previous_frame_;
+
+	// The approach zone, in the same (decimated) pixels as the ROI.  Only watched if
+	// approach_zone_active_, which also needs the trigger to be sent from this stage.
+	bool approach_zone_active_ = false;
+	uint approach_roi_x_ = 0, approach_roi_y_ = 0;
+	uint approach_roi_width_ = 0, approach_roi_height_ = 0;
+	uint approach_region_threshold_ = 0;
+	uint approach_quiet_frames_ = 0;
+	std::vector<uint8_t> approach_previous_frame_;
+
+	// The background model, in 8.8 fixed point, one value per (decimated) ROI pixel.  Each
+	// update moves a pixel 1/2^kBackgroundShift of the way to the new value.
+	static constexpr int kBackgroundShift = 4;
+	std::vector<uint16_t> background_;
+	// The number of grid pixels that have to differ before the whole ROI is scanned
+	uint screen_threshold_ = 1;
+	// Only every background_screen_stride'th row is updated in a frame, in turn
+	uint background_update_row_ = 0;
+
+	// Sizes background_ and the screen threshold for the current ROI
+	void ConfigureBackgroundModel();
+	// Moves the next band of rows of the background towards the frame
+	void UpdateBackground(const uint8_t* frame, unsigned int sampled_frame_stride);
+	inline bool DiffersFromBackgroundPixel(uint8_t new_value, uint16_t background_value) const {
+		const uint8_t old_value = (uint8_t)((background_value + 128) >> 8);
+		const uint8_t difference = (new_value > old_value) ? (new_value - old_value) : (old_value - new_value);
+		return difference > threshold_lut_[old_value];
+	}
+
+	// threshold_lut_[old] is the largest |new - old| that does NOT count as a change,
+	// i.e., floor(difference_m * old + difference_c), clamped to 0..255.  Built in
+	// Configure() so that Process() needs no per-pixel floating point.
+	std::array<uint8_t, 256> threshold_lut_;
+
+	// Fills threshold_lut_ from config_.difference_m and config_.difference_c
+	void BuildThresholdLut();
+	// Updates the previous-frame row (of width decimated pixels) from the new row and returns
+	// how many of its pixels changed
+	unsigned int CountChangedPixelsInRow(const uint8_t* new_row, uint8_t* old_row, unsigned int width) const;
+	// Compares the approach zone to the previous frame, and pre-arms the trigger if the
+	// club has come into it (or gives up the pre-arm once it has been quiet for long enough)
+	void WatchApproachZone(const uint8_t* frame, unsigned int frame_stride);
+	// Records the result for GetLastResult() and, unless in realtime_mode, in the request metadata
+	void SetResult(CompletedRequestPtr& completed_request, bool result);
+	// The work of both Process() methods.  image is stream_'s first plane.  main_image is
+	// main_stream_'s, or null if that is not mapped (in which case image is used).
+	void ProcessImage(CompletedRequestPtr& completed_request, uint8_t* image, const StreamInfo& info,
+					  uint8_t* main_image, const StreamInfo& main_info);
+
 	bool first_time_;
 	bool motion_detected_;
+	bool last_result_ = false;
 	uint postMotionFramesToCapture_;
 	std::mutex mutex_;
 
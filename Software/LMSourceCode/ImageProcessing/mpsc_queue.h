@@ -0,0 +1,218 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// A bounded, lock-free multi-producer/single-consumer queue with the same push/pop
+// interface as the blocking queue in blocking_queue.h.
+// The slots are pre-allocated in a ring, and each slot carries a sequence number that
+// tells producers and the consumer whether it is free or full (D. Vyukov's bounded queue).
+// Producers never take a lock.  A consumer that finds the queue empty sleeps on a futex
+// that the producers only signal when somebody is actually waiting.
+// Several queues can share one futex_doorbell, so that a consumer can wait on all of
+// them at once (see GolfSimEventQueue).
+
+namespace golf_sim {
+
+
+// Bumped on every push.  A consumer futex-waits on the count it last saw.
+class futex_doorbell {
+
+  alignas(64) std::atomic<uint32_t> push_count{ 0 };
+  std::atomic<uint32_t> waiting_consumers{ 0 };
+
+ public:
+  uint32_t count() const {
+    return push_count.load(std::memory_order_seq_cst);
+  }
+
+  void ring() {
+    push_count.fetch_add(1, std::memory_order_seq_cst);
+    if (waiting_consumers.load(std::memory_order_seq_cst) != 0) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&push_count), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+  }
+
+  // Must be called before the consumer's last check for an item, so that a push in
+  // between either is seen by that check or changes the count and wakes the futex
+  void begin_wait() {
+    waiting_consumers.fetch_add(1, std::memory_order_seq_cst);
+  }
+
+  void end_wait() {
+    waiting_consumers.fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  // Returns when the count may no longer equal seen_count, or when the time-out elapses.
+  // A time_out_ms of 0 waits forever.
+  void wait(uint32_t seen_count, unsigned int time_out_ms) {
+    struct timespec time_out;
+    struct timespec* time_out_ptr = nullptr;
+
+    if (time_out_ms != 0) {
+      time_out.tv_sec = time_out_ms / 1000;
+      time_out.tv_nsec = (long)(time_out_ms % 1000) * 1000000L;
+      time_out_ptr = &time_out;
+    }
+
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&push_count), FUTEX_WAIT_PRIVATE, seen_count, time_out_ptr, nullptr, 0);
+  }
+};
+
+
+template<typename T>
+class mpsc_queue {
+
+  struct slot {
+    std::atomic<size_t> sequence;
+    T item;
+  };
+
+  const size_t capacity_mask;
+  std::unique_ptr<slot[]> slots;
+
+  alignas(64) std::atomic<size_t> enqueue_pos{ 0 };
+  alignas(64) std::atomic<size_t> dequeue_pos{ 0 };
+
+  // Either own_doorbell, or one shared with other queues
+  futex_doorbell own_doorbell;
+  futex_doorbell& doorbell;
+
+  mpsc_queue(const mpsc_queue &) = delete;
+  mpsc_queue(mpsc_queue &&) = delete;
+  mpsc_queue &operator = (const mpsc_queue &) = delete;
+  mpsc_queue &operator = (mpsc_queue &&) = delete;
+
+  static size_t round_up_to_power_of_two(size_t n) {
+    size_t result = 2;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+ public:
+  // The capacity is rounded up to the next power of two.
+  // If shared_doorbell is given, every push rings it instead of the queue's own.
+  mpsc_queue(size_t capacity, futex_doorbell* shared_doorbell = nullptr)
+    : capacity_mask(round_up_to_power_of_two(capacity) - 1),
+      slots(new slot[capacity_mask + 1]),
+      doorbell(shared_doorbell != nullptr ? *shared_doorbell : own_doorbell) {
+    for (size_t i = 0; i <= capacity_mask; i++) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool try_push(T &&item) {
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+    while (true) {
+      slot& s = slots[pos & capacity_mask];
+      size_t sequence = s.sequence.load(std::memory_order_acquire);
+      intptr_t difference = (intptr_t)sequence - (intptr_t)pos;
+
+      if (difference == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          s.item = std::move(item);
+          s.sequence.store(pos + 1, std::memory_order_release);
+          doorbell.ring();
+          return true;
+        }
+      }
+      else if (difference < 0) {
+        // Full
+        return false;
+      }
+      else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Like the blocking queue, waits if the queue is full.  The consumer should
+  // never fall that far behind, so just yield rather than sleeping on anything.
+  void push(T &&item) {
+    while (!try_push(std::move(item))) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Only one thread may pop
+  bool try_pop(T &item) {
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    slot& s = slots[pos & capacity_mask];
+    size_t sequence = s.sequence.load(std::memory_order_acquire);
+
+    if ((intptr_t)sequence - (intptr_t)(pos + 1) < 0) {
+      // Empty, or the producer that owns this slot has not finished writing it yet
+      return false;
+    }
+
+    item = std::move(s.item);
+    s.sequence.store(pos + capacity_mask + 1, std::memory_order_release);
+    dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Returns true if the queue was successfully popped.
+  // Will wait (block) forever if time_out_ms == 0
+  bool pop(T &item, unsigned int time_out_ms = 0) {
+    if (try_pop(item)) {
+      return true;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_out_ms);
+
+    while (true) {
+      unsigned int remaining_ms = 0;
+
+      if (time_out_ms != 0) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+          return try_pop(item);
+        }
+        remaining_ms = (unsigned int)remaining;
+      }
+
+      // Register as a waiter before the last check so that a push in between
+      // either is seen by try_pop or changes the count and wakes the futex
+      uint32_t seen_push_count = doorbell.count();
+      doorbell.begin_wait();
+
+      if (try_pop(item)) {
+        doorbell.end_wait();
+        return true;
+      }
+
+      doorbell.wait(seen_push_count, remaining_ms);
+      doorbell.end_wait();
+
+      if (try_pop(item)) {
+        return true;
+      }
+    }
+  }
+
+  // Approximate if there are concurrent pushes or pops
+  size_t size() const {
+    size_t enqueued = enqueue_pos.load(std::memory_order_relaxed);
+    size_t dequeued = dequeue_pos.load(std::memory_order_relaxed);
+    return (enqueued > dequeued) ? (enqueued - dequeued) : 0;
+  }
+};
+
+}
@@ -5,10 +5,19 @@
 
 #include "ncnn_detector.hpp"
 #include "logging_tools.h"
+#include "gs_metrics.h"
+#include "gs_trace_zones.h"
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
+#include <map>
 #include <numeric>
 
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GS_USE_NEON_POSTPROCESSING
+#endif
+
 namespace golf_sim {
 
 NCNNDetector::NCNNDetector(const Config& config)
@@ -29,11 +38,13 @@ bool NCNNDetector::Initialize() {
         return false;
     }
 
-    net_.opt.num_threads = config_.num_threads;
+    NcnnRuntime::ConfigureNet(net_, workspace_, config_.num_threads);
     net_.opt.use_fp16_packed = config_.use_fp16_packing;
     net_.opt.use_fp16_storage = config_.use_fp16_packing;
     net_.opt.use_fp16_arithmetic = true;  // Pi 5 Cortex-A76 has native FEAT_FP16
     net_.opt.use_packing_layout = true;
+    net_.opt.use_int8_inference = config_.use_int8_inference;
+    NcnnRuntime::ConfigureVulkan(net_, config_.use_vulkan_compute);
 
     if (net_.load_param(config_.param_path.c_str()) != 0) {
         GS_LOG_MSG(error, "Failed to load NCNN param: " + config_.param_path);
@@ -48,7 +59,7 @@ bool NCNNDetector::Initialize() {
     letterbox_buf_ = cv::Mat(config_.input_height, config_.input_width, CV_8UC3, cv::Scalar(114, 114, 114));
 
     initialized_ = true;
-    GS_LOG_MSG(info, "NCNN detector initialized (" + std::to_string(config_.num_threads) + " threads)");
+    GS_LOG_MSG(info, "NCNN detector initialized (" + std::string(net_.opt.use_vulkan_compute ? "Vulkan GPU" : std::to_string(net_.opt.num_threads) + " threads") + ")");
 
     WarmUp(5);
     return true;
@@ -59,6 +70,8 @@ std::vector<NCNNDetector::Detection> NCNNDetector::Detect(
 
     if (image.empty() || !initialized_) return {};
 
+    GS_TRACE_ZONE("NCNNDetect");
+
     auto t0 = std::chrono::high_resolution_clock::now();
 
     // Letterbox + convert to ncnn::Mat
@@ -68,19 +81,28 @@ std::vector<NCNNDetector::Detection> NCNNDetector::Detect(
     auto t1 = std::chrono::high_resolution_clock::now();
 
     // Run inference
+    NcnnRuntime::PinInferenceThreads(net_.opt.num_threads);
     ncnn::Extractor ex = net_.create_extractor();
     ex.input("in0", in);
 
     ncnn::Mat out;
-    ex.extract("out0", out);
+    {
+        GS_TRACE_ZONE("NCNNInference");
+        ex.extract("out0", out);
+    }
 
     auto t2 = std::chrono::high_resolution_clock::now();
 
+    GsMetrics::Observe(GsMetrics::Histogram::kBallDetectorInference,
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+
     // Parse detections
     auto detections = PostprocessYOLO(out);
 
     auto t3 = std::chrono::high_resolution_clock::now();
 
+    GS_TRACE_COUNTER("ncnn_detections", detections.size());
+
     if (metrics) {
         auto ms = [](auto a, auto b) {
             return std::chrono::duration<float, std::milli>(b - a).count();
@@ -103,9 +125,6 @@ void NCNNDetector::Letterbox(const cv::Mat& image, ncnn::Mat& out) {
     int new_w = (int)(image.cols * scale);
     int new_h = (int)(image.rows * scale);
 
-    cv::resize(image, resized_buf_, cv::Size(new_w, new_h), 0, 0, cv::INTER_LINEAR);
-
-    letterbox_buf_.setTo(cv::Scalar(114, 114, 114));
     int x_off = (config_.input_width - new_w) / 2;
     int y_off = (config_.input_height - new_h) / 2;
 
@@ -113,6 +132,50 @@ void NCNNDetector::Letterbox(const cv::Mat& image, ncnn::Mat& out) {
     letterbox_params_.x_offset = x_off;
     letterbox_params_.y_offset = y_off;
 
+    if (config_.use_direct_letterbox) {
+        LetterboxDirect(image, out);
+    }
+    else {
+        LetterboxWithOpenCV(image, out);
+    }
+}
+
+void NCNNDetector::LetterboxDirect(const cv::Mat& image, ncnn::Mat& out) {
+    const int new_w = (int)(image.cols * letterbox_params_.scale);
+    const int new_h = (int)(image.rows * letterbox_params_.scale);
+    const int x_off = letterbox_params_.x_offset;
+    const int y_off = letterbox_params_.y_offset;
+
+    // One pass does the resize and the gray/BGR->RGB conversion straight from the
+    // source image (using its stride, so ROIs don't need to be copied first)
+    int pixel_type = (image.channels() == 1) ? ncnn::Mat::PIXEL_GRAY2RGB : ncnn::Mat::PIXEL_BGR2RGB;
+    ncnn::Mat resized = ncnn::Mat::from_pixels_resize(image.data, pixel_type, image.cols, image.rows,
+                                                      (int)image.step, new_w, new_h);
+
+    const float norm_vals[3] = { 1 / 255.0f, 1 / 255.0f, 1 / 255.0f };
+    resized.substract_mean_normalize(nullptr, norm_vals);
+
+    // The padding value is pre-normalized to match the (114, 114, 114) gray of the OpenCV path
+    ncnn::copy_make_border(resized, out,
+                           y_off, config_.input_height - new_h - y_off,
+                           x_off, config_.input_width - new_w - x_off,
+                           ncnn::BORDER_CONSTANT, 114.0f / 255.0f);
+}
+
+void NCNNDetector::LetterboxWithOpenCV(const cv::Mat& image, ncnn::Mat& out) {
+    const int new_w = (int)(image.cols * letterbox_params_.scale);
+    const int new_h = (int)(image.rows * letterbox_params_.scale);
+    const int x_off = letterbox_params_.x_offset;
+    const int y_off = letterbox_params_.y_offset;
+
+    cv::resize(image, resized_buf_, cv::Size(new_w, new_h), 0, 0, cv::INTER_LINEAR);
+
+    if (resized_buf_.channels() == 1) {
+        cv::cvtColor(resized_buf_, resized_buf_, cv::COLOR_GRAY2BGR);
+    }
+
+    letterbox_buf_.setTo(cv::Scalar(114, 114, 114));
+
     resized_buf_.copyTo(letterbox_buf_(cv::Rect(x_off, y_off, new_w, new_h)));
 
     // ncnn expects RGB, pixel-interleaved. from_pixels handles BGR->RGB + normalization.
@@ -123,14 +186,48 @@ void NCNNDetector::Letterbox(const cv::Mat& image, ncnn::Mat& out) {
     out.substract_mean_normalize(nullptr, norm_vals);
 }
 
+void NCNNDetector::FindScoresAboveThreshold(const float* scores, int n, float threshold, std::vector<int>& indices) {
+    int i = 0;
+
+#ifdef GS_USE_NEON_POSTPROCESSING
+    // Almost every score is below the threshold, so check 16 at a time and only look
+    // closer at the blocks that have a survivor
+    const float32x4_t threshold_v = vdupq_n_f32(threshold);
+
+    for (; i + 16 <= n; i += 16) {
+        const uint32x4_t above0 = vcgeq_f32(vld1q_f32(scores + i), threshold_v);
+        const uint32x4_t above1 = vcgeq_f32(vld1q_f32(scores + i + 4), threshold_v);
+        const uint32x4_t above2 = vcgeq_f32(vld1q_f32(scores + i + 8), threshold_v);
+        const uint32x4_t above3 = vcgeq_f32(vld1q_f32(scores + i + 12), threshold_v);
+
+        const uint32x4_t any_above = vorrq_u32(vorrq_u32(above0, above1), vorrq_u32(above2, above3));
+        if (vmaxvq_u32(any_above) == 0) {
+            continue;
+        }
+
+        for (int j = i; j < i + 16; j++) {
+            if (scores[j] >= threshold) {
+                indices.push_back(j);
+            }
+        }
+    }
+#endif
+
+    for (; i < n; i++) {
+        if (scores[i] >= threshold) {
+            indices.push_back(i);
+        }
+    }
+}
+
 std::vector<NCNNDetector::Detection> NCNNDetector::PostprocessYOLO(
     const ncnn::Mat& output) {
 
     // NCNN exports YOLO26 in traditional format: [data_width, num_predictions]
-    // where data_width = 4 + num_classes, transposed (channel-first).
+    // where data_width = 4 + num_classes (+ 2 for the sequence outputs), transposed (channel-first).
 
     const int num_preds = PredictionCount(config_.input_width, config_.input_height);
-    const int data_w = 4 + config_.num_classes;
+    const int data_w = 4 + config_.num_classes + (config_.has_sequence_outputs ? 2 : 0);
 
     // output shape from ncnn: [data_w, num_preds] (w, h in ncnn terms)
     // output.w = num_preds, output.h = data_w  (or vice versa depending on export)
@@ -157,64 +254,82 @@ std::vector<NCNNDetector::Detection> NCNNDetector::PostprocessYOLO(
                    std::to_string(data_w) + ", got " + std::to_string(n_feats));
     }
 
-    std::vector<Detection> detections;
-    detections.reserve(64);
-
     const float* data = (const float*)output.data;
 
-    for (int i = 0; i < n_preds; i++) {
-        float cx, cy, w, h, conf;
-        int class_id = 0;
+    // Channel-first: output[channel * n_preds + i].  Row-major: output[i * n_feats + channel]
+    auto value = [&](int i, int channel) {
+        return transposed ? data[i * n_feats + channel] : data[channel * n_preds + i];
+    };
 
-        if (!transposed) {
-            // Channel-first: output[channel * n_preds + i]
-            cx = data[0 * n_preds + i];
-            cy = data[1 * n_preds + i];
-            w  = data[2 * n_preds + i];
-            h  = data[3 * n_preds + i];
-
-            if (config_.is_single_class_model) {
-                conf = data[4 * n_preds + i];
-            } else {
-                float best = 0;
-                for (int c = 0; c < config_.num_classes; c++) {
-                    float s = data[(4 + c) * n_preds + i];
-                    if (s > best) { best = s; class_id = c; }
-                }
-                conf = best;
+    // First find the predictions that pass the confidence threshold.  Only those are decoded.
+    candidate_indices_.clear();
+    candidate_scores_.clear();
+
+    if (config_.is_single_class_model && !transposed) {
+        // The scores are one contiguous row
+        FindScoresAboveThreshold(data + 4 * n_preds, n_preds, config_.confidence_threshold, candidate_indices_);
+        for (int i : candidate_indices_) {
+            candidate_scores_.push_back(data[4 * n_preds + i]);
+        }
+    } else {
+        for (int i = 0; i < n_preds; i++) {
+            float conf = value(i, 4);
+            for (int c = 1; !config_.is_single_class_model && c < config_.num_classes; c++) {
+                conf = std::max(conf, value(i, 4 + c));
             }
-        } else {
-            // Row-major: output[i * n_feats + channel]
-            const float* row = data + i * n_feats;
-            cx = row[0]; cy = row[1]; w = row[2]; h = row[3];
-
-            if (config_.is_single_class_model) {
-                conf = row[4];
-            } else {
-                float best = 0;
-                for (int c = 0; c < config_.num_classes; c++) {
-                    float s = row[4 + c];
-                    if (s > best) { best = s; class_id = c; }
-                }
-                conf = best;
+            if (conf >= config_.confidence_threshold) {
+                candidate_indices_.push_back(i);
+                candidate_scores_.push_back(conf);
             }
         }
+    }
+
+    // Keep only the top max_candidates, most confident first
+    std::vector<int> order(candidate_indices_.size());
+    std::iota(order.begin(), order.end(), 0);
 
-        if (conf < config_.confidence_threshold) continue;
+    auto more_confident = [this](int a, int b) { return candidate_scores_[a] > candidate_scores_[b]; };
+
+    if (config_.max_candidates > 0 && (int)order.size() > config_.max_candidates) {
+        std::nth_element(order.begin(), order.begin() + config_.max_candidates, order.end(), more_confident);
+        order.resize(config_.max_candidates);
+    }
+    std::sort(order.begin(), order.end(), more_confident);
+
+    std::vector<Detection> detections;
+    detections.reserve(order.size());
+
+    for (int k : order) {
+        const int i = candidate_indices_[k];
+        int class_id = 0;
+
+        if (!config_.is_single_class_model) {
+            float best = 0;
+            for (int c = 0; c < config_.num_classes; c++) {
+                float s = value(i, 4 + c);
+                if (s > best) { best = s; class_id = c; }
+            }
+        }
 
         // Convert from letterbox coords to original image coords
-        float cx_orig = (cx - letterbox_params_.x_offset) / letterbox_params_.scale;
-        float cy_orig = (cy - letterbox_params_.y_offset) / letterbox_params_.scale;
-        float w_orig = w / letterbox_params_.scale;
-        float h_orig = h / letterbox_params_.scale;
+        float cx_orig = (value(i, 0) - letterbox_params_.x_offset) / letterbox_params_.scale;
+        float cy_orig = (value(i, 1) - letterbox_params_.y_offset) / letterbox_params_.scale;
+        float w_orig = value(i, 2) / letterbox_params_.scale;
+        float h_orig = value(i, 3) / letterbox_params_.scale;
 
         Detection det;
         det.bbox.x = cx_orig - w_orig / 2.0f;
         det.bbox.y = cy_orig - h_orig / 2.0f;
         det.bbox.width = w_orig;
         det.bbox.height = h_orig;
-        det.confidence = conf;
+        det.confidence = candidate_scores_[k];
         det.class_id = class_id;
+
+        if (config_.has_sequence_outputs && n_feats >= data_w) {
+            det.overlap_score = std::clamp(value(i, 4 + config_.num_classes), 0.0f, 1.0f);
+            det.exposure_index = std::max(value(i, 5 + config_.num_classes), 0.0f);
+        }
+
         detections.push_back(det);
     }
 
@@ -226,27 +341,69 @@ std::vector<NCNNDetector::Detection> NCNNDetector::NMS(
 
     if (detections.empty()) return {};
 
-    std::sort(detections.begin(), detections.end(),
+    // Usually already sorted by PostprocessYOLO
+    std::stable_sort(detections.begin(), detections.end(),
               [](const Detection& a, const Detection& b) {
                   return a.confidence > b.confidence;
               });
 
-    std::vector<bool> suppressed(detections.size(), false);
-    std::vector<Detection> result;
-    result.reserve(detections.size());
+    std::vector<cv::Rect2f> boxes;
+    boxes.reserve(detections.size());
+    for (const Detection& d : detections) {
+        boxes.push_back(d.bbox);
+    }
 
-    for (size_t i = 0; i < detections.size(); i++) {
-        if (suppressed[i]) continue;
+    std::vector<Detection> result;
+    for (int i : GridNMS(boxes, config_.nms_threshold)) {
         result.push_back(detections[i]);
+    }
+    return result;
+}
+
+std::vector<int> NCNNDetector::GridNMS(const std::vector<cv::Rect2f>& boxes, float nms_threshold) {
+
+    std::vector<int> kept;
+    if (boxes.empty()) return kept;
+
+    // Two boxes can only overlap if their centers are within a largest-box size of each other
+    float cell_size = 1.0f;
+    for (const cv::Rect2f& box : boxes) {
+        cell_size = std::max({ cell_size, box.width, box.height });
+    }
+
+    auto cell_of = [cell_size](const cv::Rect2f& box) {
+        return std::make_pair((int)std::floor((box.x + box.width / 2.0f) / cell_size),
+                              (int)std::floor((box.y + box.height / 2.0f) / cell_size));
+    };
+
+    // Kept boxes, by cell
+    std::map<std::pair<int, int>, std::vector<int>> grid;
+
+    for (int i = 0; i < (int)boxes.size(); i++) {
+        const auto [cell_x, cell_y] = cell_of(boxes[i]);
+        bool suppressed = false;
+
+        for (int dy = -1; dy <= 1 && !suppressed; dy++) {
+            for (int dx = -1; dx <= 1 && !suppressed; dx++) {
+                auto cell = grid.find({ cell_x + dx, cell_y + dy });
+                if (cell == grid.end()) continue;
 
-        for (size_t j = i + 1; j < detections.size(); j++) {
-            if (suppressed[j]) continue;
-            if (IOU(detections[i].bbox, detections[j].bbox) > config_.nms_threshold) {
-                suppressed[j] = true;
+                for (int k : cell->second) {
+                    if (IOU(boxes[k], boxes[i]) > nms_threshold) {
+                        suppressed = true;
+                        break;
+                    }
+                }
             }
         }
+
+        if (!suppressed) {
+            kept.push_back(i);
+            grid[{ cell_x, cell_y }].push_back(i);
+        }
     }
-    return result;
+
+    return kept;
 }
 
 int NCNNDetector::PredictionCount(int w, int h) const {
@@ -265,4 +422,15 @@ void NCNNDetector::WarmUp(int iterations) {
     GS_LOG_MSG(info, "NCNN warmup complete (" + std::to_string(iterations) + " iterations)");
 }
 
+float NCNNDetector::MeasureDetectMs(int iterations) {
+    cv::Mat dummy(config_.input_height, config_.input_width, CV_8UC3, cv::Scalar(114, 114, 114));
+    PerformanceMetrics metrics;
+    float total_ms = 0;
+    for (int i = 0; i < iterations; i++) {
+        Detect(dummy, &metrics);
+        total_ms += metrics.total_ms;
+    }
+    return (iterations > 0) ? total_ms / iterations : 0;
+}
+
 } // namespace golf_sim
@@ -11,6 +11,8 @@
 #include <string>
 #include <chrono>
 
+#include "ncnn_runtime.hpp"
+
 namespace golf_sim {
 
 class NCNNDetector {
@@ -19,6 +21,11 @@ public:
         cv::Rect2f bbox;
         float confidence;
         int class_id;
+        // Only from a model with has_sequence_outputs, and otherwise -1.  How likely this
+        // exposure is to be overlapped or occluded by another one (0 to 1), and which of the
+        // strobed exposures it is, counting from 0 for the earliest.
+        float overlap_score = -1.0f;
+        float exposure_index = -1.0f;
     };
 
     struct LetterboxParams {
@@ -43,8 +50,20 @@ public:
         int input_height = 640;
         int num_threads = 3;
         bool use_fp16_packing = true;
+        // For param/bin files that were quantized with ncnn2int8 (and its calibration table)
+        bool use_int8_inference = false;
+        // Falls back to the CPU if there is no usable GPU
+        bool use_vulkan_compute = false;
         bool is_single_class_model = true;
         int num_classes = 1;
+        // If true, the image is resized, converted and normalized straight into the
+        // ncnn::Mat (then padded), instead of going through intermediate cv::Mat buffers
+        bool use_direct_letterbox = true;
+        // Only this many of the most confident predictions are decoded and go to the NMS
+        int max_candidates = 300;
+        // If true, each prediction has two more features after the class scores - the
+        // overlap score and the exposure index (see Detection)
+        bool has_sequence_outputs = false;
     };
 
     explicit NCNNDetector(const Config& config);
@@ -57,8 +76,27 @@ public:
 
     void WarmUp(int iterations = 5);
 
+    // The average time that Detect takes for a model input-sized image
+    float MeasureDetectMs(int iterations = 5);
+
+    // Greedy NMS over boxes that are already in descending confidence order.  Returns the
+    // (order) indices of the boxes that are kept.  The boxes are bucketed by their centers on a
+    // grid as coarse as the largest box, so each box is only compared with the kept boxes in
+    // the neighbouring cells - boxes any further apart can't overlap.
+    static std::vector<int> GridNMS(const std::vector<cv::Rect2f>& boxes, float nms_threshold);
+
+    const Config& GetConfig() const { return config_; }
+
+    // For live tuning.  Not to be called while a detection is running.
+    void SetThresholds(float confidence_threshold, float nms_threshold) {
+        config_.confidence_threshold = confidence_threshold;
+        config_.nms_threshold = nms_threshold;
+    }
+    bool UsesVulkan() const { return net_.opt.use_vulkan_compute; }
+
 private:
     Config config_;
+    NcnnRuntime::ModelWorkspace workspace_;
     ncnn::Net net_;
     LetterboxParams letterbox_params_;
     bool initialized_ = false;
@@ -67,12 +105,22 @@ private:
     cv::Mat letterbox_buf_;
     cv::Mat resized_buf_;
 
+    // Accepts either 1-channel (grayscale) or 3-channel (BGR) images
     void Letterbox(const cv::Mat& image, ncnn::Mat& out);
+    void LetterboxDirect(const cv::Mat& image, ncnn::Mat& out);
+    void LetterboxWithOpenCV(const cv::Mat& image, ncnn::Mat& out);
 
     std::vector<Detection> PostprocessYOLO(const ncnn::Mat& output);
 
     std::vector<Detection> NMS(std::vector<Detection>& detections);
 
+    // Appends the index of each of the n scores that is >= threshold
+    static void FindScoresAboveThreshold(const float* scores, int n, float threshold, std::vector<int>& indices);
+
+    // Reused from call to call
+    std::vector<int> candidate_indices_;
+    std::vector<float> candidate_scores_;
+
     static inline float IOU(const cv::Rect2f& a, const cv::Rect2f& b) {
         float inter = (a & b).area();
         float uni = a.area() + b.area() - inter;
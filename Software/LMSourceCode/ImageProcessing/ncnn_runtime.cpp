@@ -0,0 +1,118 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+#include "ncnn_runtime.hpp"
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "worker_thread.h"
+
+#include <ncnn/cpu.h>
+#if NCNN_VULKAN
+#include <ncnn/gpu.h>
+#endif
+
+#include <algorithm>
+
+namespace golf_sim {
+
+int NcnnRuntime::kRealtimeCpuCore = 3;
+std::string NcnnRuntime::kNcnnComputeBackend = "cpu";
+
+void NcnnRuntime::LoadConfigurationValues() {
+    GolfSimConfiguration::SetConstant("gs_config.ball_identification.kRealtimeCpuCore", kRealtimeCpuCore);
+
+    if (kRealtimeCpuCore >= ncnn::get_cpu_count()) {
+        GS_LOG_MSG(warning, "kRealtimeCpuCore (" + std::to_string(kRealtimeCpuCore) + ") is not a valid core.  No core will be reserved.");
+        kRealtimeCpuCore = -1;
+    }
+
+    // The shared worker pool stays off of the same core
+    GsThreadPool::kReservedCpuCore = kRealtimeCpuCore;
+
+    GolfSimConfiguration::SetConstant("gs_config.ball_identification.kNcnnComputeBackend", kNcnnComputeBackend);
+
+    if (kNcnnComputeBackend != "cpu" && kNcnnComputeBackend != "vulkan" && kNcnnComputeBackend != "benchmark") {
+        GS_LOG_MSG(error, "Unrecognized kNcnnComputeBackend: '" + kNcnnComputeBackend + "' - defaulting to 'cpu'");
+        kNcnnComputeBackend = "cpu";
+    }
+}
+
+bool NcnnRuntime::VulkanAvailable() {
+#if NCNN_VULKAN
+    static const bool available = []() {
+        ncnn::create_gpu_instance();
+        const int gpu_count = ncnn::get_gpu_count();
+
+        if (gpu_count <= 0) {
+            GS_LOG_MSG(warning, "NcnnRuntime: no Vulkan GPU was found.  The models will run on the CPU.");
+            return false;
+        }
+
+        GS_LOG_MSG(info, "NcnnRuntime: using Vulkan GPU " + std::string(ncnn::get_gpu_info(ncnn::get_default_gpu_index()).device_name()));
+        return true;
+    }();
+
+    return available;
+#else
+    static const bool logged = []() {
+        GS_LOG_MSG(warning, "NcnnRuntime: NCNN was built without Vulkan.  The models will run on the CPU.");
+        return true;
+    }();
+    (void)logged;
+
+    return false;
+#endif
+}
+
+bool NcnnRuntime::ConfigureVulkan(ncnn::Net& net, bool use_vulkan_compute) {
+    net.opt.use_vulkan_compute = use_vulkan_compute && VulkanAvailable();
+    return net.opt.use_vulkan_compute;
+}
+
+int NcnnRuntime::GetInferenceCoreCount() {
+    int cpu_count = ncnn::get_cpu_count();
+    return (kRealtimeCpuCore >= 0 && cpu_count > 1) ? cpu_count - 1 : cpu_count;
+}
+
+void NcnnRuntime::ConfigureNet(ncnn::Net& net, ModelWorkspace& workspace, int requested_threads) {
+    net.opt.blob_allocator = &workspace.blob_allocator;
+    net.opt.workspace_allocator = &workspace.workspace_allocator;
+    net.opt.num_threads = std::max(1, std::min(requested_threads, GetInferenceCoreCount()));
+
+    if (net.opt.num_threads != requested_threads) {
+        GS_LOG_MSG(info, "NcnnRuntime: using " + std::to_string(net.opt.num_threads) + " inference threads instead of " +
+                   std::to_string(requested_threads) + " to stay off of the real-time core");
+    }
+}
+
+void NcnnRuntime::PinInferenceThreads(int num_threads) {
+    if (kRealtimeCpuCore < 0) {
+        return;
+    }
+
+    // The OpenMP thread team belongs to the calling thread, so each thread must do this once
+    thread_local bool threads_pinned = false;
+    if (threads_pinned) {
+        return;
+    }
+
+    ncnn::CpuSet inference_cores;
+    for (int core = 0; core < ncnn::get_cpu_count(); core++) {
+        if (core != kRealtimeCpuCore) {
+            inference_cores.enable(core);
+        }
+    }
+
+    // set_cpu_thread_affinity applies the mask to the current OpenMP team, so size it first
+    ncnn::set_omp_num_threads(num_threads);
+
+    if (ncnn::set_cpu_thread_affinity(inference_cores) != 0) {
+        GS_LOG_MSG(warning, "NcnnRuntime: could not set the inference thread affinity");
+    }
+
+    threads_pinned = true;
+}
+
+} // namespace golf_sim
@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+// Shared NCNN inference runtime settings for the ball detector and the spin predictor.
+// Each model gets a persistent pair of pool allocators so that blob and workspace memory is
+// reused across calls, and the NCNN worker threads are kept off of the CPU core that the
+// (SCHED_FIFO) ball_watcher_event_loop runs on.
+
+#pragma once
+
+#include <ncnn/net.h>
+#include <ncnn/allocator.h>
+
+#include <string>
+
+namespace golf_sim {
+
+class NcnnRuntime {
+public:
+    // The core that the real-time motion-detection loop is pinned to.  NCNN will not
+    // use this core.  -1 means no core is reserved (and nothing is pinned).
+    static int kRealtimeCpuCore;
+
+    // "cpu" (the default), "vulkan" to run the models on the GPU (the Pi 5's VideoCore VII)
+    // if NCNN was built with Vulkan and a GPU is found, or "benchmark" to time each model
+    // on both and keep whichever is faster.  Anything that can't use the GPU uses the CPU.
+    static std::string kNcnnComputeBackend;
+
+    // Per-model memory pools.  The blob allocator is unlocked, so a model must not
+    // be run from more than one thread at a time (which is already the case for
+    // NCNNDetector and SpinPredictor).
+    struct ModelWorkspace {
+        ncnn::UnlockedPoolAllocator blob_allocator;
+        ncnn::PoolAllocator workspace_allocator;
+    };
+
+    static void LoadConfigurationValues();
+
+    // Points the net at the workspace's allocators and limits the number of threads to
+    // the cores that are available for inference.  Call before loading the model.
+    static void ConfigureNet(ncnn::Net& net, ModelWorkspace& workspace, int requested_threads);
+
+    // True if NCNN was built with Vulkan support and found a usable GPU.  Only checks once.
+    static bool VulkanAvailable();
+
+    // Turns on Vulkan compute for the net if it was asked for and is available.  Returns
+    // true if the net will run on the GPU.  Call before loading the model.
+    static bool ConfigureVulkan(ncnn::Net& net, bool use_vulkan_compute);
+
+    // Keeps the calling thread's NCNN (OpenMP) worker threads off of the real-time core.
+    // The affinity is per calling thread, so this only does any work the first time it
+    // is called on each thread.
+    static void PinInferenceThreads(int num_threads);
+
+    // The number of cores that NCNN may use
+    static int GetInferenceCoreCount();
+};
+
+} // namespace golf_sim
@@ -0,0 +1,164 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2026, Verdant Consultants, LLC.
+ */
+
+/*
+ * The layout of the POSIX shared-memory segment that pitrac_lm keeps its recent frames and
+ * shot results in (see GsSharedMemory), for local readers in C or C++.  Nothing else from
+ * PiTrac is needed to read it.
+ *
+ * A reader maps the segment (shm_open(kSharedMemoryName, O_RDONLY), then mmap of the size in
+ * the header) and checks magic and version.  Frames and results are numbered from 1, and
+ * latest_frame_number / latest_result_number are the newest ones.  Frame n is in slot
+ * (n - 1) % frame_slots, and likewise for the results, so a reader that falls more than a ring
+ * behind just misses the oldest ones.  pitrac_lm never waits for any reader.
+ *
+ * Every slot is guarded by a sequence lock.  A reader can use a slot in place (e.g., the
+ * pixels), but has to re-check the sequence once it is done, and throw away whatever it read
+ * if the slot was re-written meanwhile:
+ *
+ *     const struct pitrac_shm_frame* frame = pitrac_shm_frame_slot(shm, slot);
+ *     uint32_t sequence = pitrac_shm_read_begin(&frame->sequence);
+ *     ... copy or process frame->width, pitrac_shm_frame_pixels(shm, frame), ...
+ *     if (!pitrac_shm_read_valid(&frame->sequence, sequence)) { ... try again ... }
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PITRAC_SHM_MAGIC 0x43525450u  /* "PTRC" */
+#define PITRAC_SHM_VERSION 1u
+
+#define PITRAC_SHM_MAX_CIRCLES 32
+#define PITRAC_SHM_MAX_NAME 64
+
+enum pitrac_shm_frame_kind {
+    /* Camera 1's still picture of the teed ball */
+    PITRAC_SHM_FRAME_TEED = 0,
+    /* Camera 2's strobed picture of the ball in flight */
+    PITRAC_SHM_FRAME_STROBED = 1,
+    /* One of the images for the web UI, with any ball outlines in circles rather than drawn */
+    PITRAC_SHM_FRAME_ANNOTATED = 2
+};
+
+struct pitrac_shm_circle {
+    /* In the frame's (possibly scaled-down) pixels */
+    float x;
+    float y;
+    float radius;
+    int32_t label;
+};
+
+struct pitrac_shm_frame {
+    /* Odd while the slot is being written */
+    uint32_t sequence;
+    uint32_t kind;
+    uint64_t frame_number;
+    uint64_t shot_number;
+    /* CLOCK_REALTIME */
+    int64_t timestamp_ns;
+    /* E.g., 0.5 if the frame was scaled to half the camera's size */
+    float scale;
+    uint32_t width;
+    uint32_t height;
+    /* 1 (gray) or 3 (BGR), 8 bits each */
+    uint32_t channels;
+    /* Bytes from one row of pixels to the next */
+    uint32_t stride;
+    uint32_t circle_count;
+    struct pitrac_shm_circle circles[PITRAC_SHM_MAX_CIRCLES];
+    /* E.g., "ball_exposure_candidates.png".  Always terminated. */
+    char name[PITRAC_SHM_MAX_NAME];
+};
+
+struct pitrac_shm_result {
+    /* Odd while the slot is being written */
+    uint32_t sequence;
+    /* Of data */
+    uint32_t length;
+    uint64_t result_number;
+    uint64_t shot_number;
+    /* CLOCK_REALTIME */
+    int64_t timestamp_ns;
+    /* The same MessagePack frame as on the results socket (see GsResults::SerializeToMsgPack)
+     * follows, in the rest of the result_slot_bytes */
+};
+
+struct pitrac_shm_header {
+    /* Written last, once the rest of the header is in place */
+    uint32_t magic;
+    uint32_t version;
+    /* Of the whole segment */
+    uint64_t size;
+
+    uint32_t frame_slots;
+    uint32_t frame_max_width;
+    uint32_t frame_max_height;
+    uint32_t result_slots;
+    /* From the start of the segment */
+    uint64_t frames_offset;
+    uint64_t frame_slot_bytes;
+    /* From the start of each frame slot */
+    uint64_t frame_pixels_offset;
+    uint64_t results_offset;
+    uint64_t result_slot_bytes;
+
+    /* 0 until the first one is written */
+    uint64_t latest_frame_number;
+    uint64_t latest_result_number;
+};
+
+static inline const struct pitrac_shm_frame* pitrac_shm_frame_slot(const struct pitrac_shm_header* shm, uint32_t slot) {
+    return (const struct pitrac_shm_frame*)((const uint8_t*)shm + shm->frames_offset + (size_t)slot * shm->frame_slot_bytes);
+}
+
+static inline const uint8_t* pitrac_shm_frame_pixels(const struct pitrac_shm_header* shm, const struct pitrac_shm_frame* frame) {
+    return (const uint8_t*)frame + shm->frame_pixels_offset;
+}
+
+static inline const struct pitrac_shm_result* pitrac_shm_result_slot(const struct pitrac_shm_header* shm, uint32_t slot) {
+    return (const struct pitrac_shm_result*)((const uint8_t*)shm + shm->results_offset + (size_t)slot * shm->result_slot_bytes);
+}
+
+static inline const uint8_t* pitrac_shm_result_data(const struct pitrac_shm_result* result) {
+    return (const uint8_t*)(result + 1);
+}
+
+static inline uint64_t pitrac_shm_latest_frame_number(const struct pitrac_shm_header* shm) {
+    return __atomic_load_n(&shm->latest_frame_number, __ATOMIC_ACQUIRE);
+}
+
+static inline uint64_t pitrac_shm_latest_result_number(const struct pitrac_shm_header* shm) {
+    return __atomic_load_n(&shm->latest_result_number, __ATOMIC_ACQUIRE);
+}
+
+static inline uint32_t pitrac_shm_read_begin(const uint32_t* sequence) {
+    return __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+}
+
+/* True if nothing was written to the slot since pitrac_shm_read_begin returned begin */
+static inline int pitrac_shm_read_valid(const uint32_t* sequence, uint32_t begin) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (begin & 1u) == 0 && __atomic_load_n(sequence, __ATOMIC_RELAXED) == begin;
+}
+
+/* For the (single) writer of a slot */
+static inline void pitrac_shm_write_begin(uint32_t* sequence) {
+    __atomic_store_n(sequence, __atomic_load_n(sequence, __ATOMIC_RELAXED) + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void pitrac_shm_write_end(uint32_t* sequence) {
+    __atomic_store_n(sequence, __atomic_load_n(sequence, __ATOMIC_RELAXED) + 1u, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -21,6 +21,11 @@
 
 
 
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GS_MOTION_DETECT_USE_NEON
+#endif
+
 #include <opencv2/core.hpp>
 #include <opencv2/photo.hpp>
 #include <opencv2/core/cvdef.h>
@@ -30,6 +35,11 @@
 #include "ball_watcher_image_buffer.h"
 #include "gs_club_data.h"
 
+#include <cstdio>
+#include <optional>
+#include <time.h>
+
+#include <libcamera/control_ids.h>
 #include <libcamera/stream.h>
 #include "core/rpicam_app.hpp"
 
@@ -38,6 +48,12 @@
 #include "pulse_strobe.h"
 #include "logging_tools.h"
 #include "gs_fsm.h"
+#include "gs_camera.h"
+#include "gs_shot_trace.h"
+#include "gs_latency_bench.h"
+#include "gs_deferred_log.h"
+#include "gs_hot_kernel.h"
+#include "gs_metrics.h"
 #include "motion_detect.h"
 
 
@@ -80,6 +96,15 @@ void MotionDetectStage::Read(boost::property_tree::ptree const &params)
 		config_.frame_period = params.get<int>("frame_period", 5);
 		config_.verbose = params.get<int>("verbose", 0);
 		config_.showroi = params.get<int>("show_roi", 0);
+		config_.use_lores_stream = params.get<int>("use_lores_stream", 0);
+		config_.use_background_model = params.get<int>("use_background_model", 0);
+		config_.background_screen_stride = params.get<int>("background_screen_stride", 4);
+		config_.use_approach_zone = params.get<int>("use_approach_zone", 0);
+		config_.approach_roi_x = params.get<int>("approach_roi_x", 0);
+		config_.approach_roi_y = params.get<int>("approach_roi_y", 0);
+		config_.approach_roi_width = params.get<int>("approach_roi_width", 0);
+		config_.approach_roi_height = params.get<int>("approach_roi_height", 0);
+		config_.approach_release_frames = params.get<int>("approach_release_frames", 30);
 	}
 
 	GS_LOG_MSG(trace, "MotionDetectStage::Read set the following values:");
@@ -96,45 +121,118 @@ void MotionDetectStage::Read(boost::property_tree::ptree const &params)
 	GS_LOG_MSG(trace, "    config_.frame_period: " + std::to_string(config_.frame_period));
 	GS_LOG_MSG(trace, "    config_.verbose: " + std::to_string(config_.verbose));
 	GS_LOG_MSG(trace, "    config_.showroi: " + std::to_string(config_.showroi));
+	GS_LOG_MSG(trace, "    config_.use_lores_stream: " + std::to_string(config_.use_lores_stream));
+	GS_LOG_MSG(trace, "    config_.use_background_model: " + std::to_string(config_.use_background_model));
+	GS_LOG_MSG(trace, "    config_.background_screen_stride: " + std::to_string(config_.background_screen_stride));
+	GS_LOG_MSG(trace, "    config_.realtime_mode: " + std::to_string(config_.realtime_mode));
+	GS_LOG_MSG(trace, "    config_.use_approach_zone: " + std::to_string(config_.use_approach_zone));
+	GS_LOG_MSG(trace, "    config_.approach_roi_x: " + std::to_string(config_.approach_roi_x));
+	GS_LOG_MSG(trace, "    config_.approach_roi_y: " + std::to_string(config_.approach_roi_y));
+	GS_LOG_MSG(trace, "    config_.approach_roi_width: " + std::to_string(config_.approach_roi_width));
+	GS_LOG_MSG(trace, "    config_.approach_roi_height: " + std::to_string(config_.approach_roi_height));
+	GS_LOG_MSG(trace, "    config_.approach_release_frames: " + std::to_string(config_.approach_release_frames));
 }
 
 void MotionDetectStage::Configure()
 {
 	GS_LOG_MSG(trace, "MotionDetectStage::Configure");
 
-	// Use the kNumberFramesToSaveBeforeHit to size the circular buffer.
-	if (gs::GolfSimClubData::kGatherClubData) {
-		int final_frame_buffer_size = 1 + gs::GolfSimClubData::kNumberFramesToSaveBeforeHit + 
-			gs::GolfSimClubData::kNumberFramesToSaveAfterHit;
-		golf_sim::RecentFrames.resize(final_frame_buffer_size);
+	Stream* main_stream = app_->GetMainStream();
+	StreamInfo main_info;
+	Stream* lores_stream = nullptr;
+	StreamInfo lores_info;
+
+	if (main_stream) {
+		main_info = app_->GetStreamInfo(main_stream);
+	}
 
-		GS_LOG_MSG(trace, "Circular frame buffer size re-set to: " + std::to_string(final_frame_buffer_size));
+	if (main_stream && config_.use_lores_stream) {
+		lores_stream = app_->LoresStream(&lores_info);
 	}
 
-	// Let's process the main stream!
-	// stream_ = app_->LoresStream(&info);
-	stream_ = app_->GetMainStream();
+	Configure(main_stream, main_info, lores_stream, lores_info);
+}
+
+void MotionDetectStage::Configure(Stream* main_stream, const StreamInfo& main_info, Stream* lores_stream, const StreamInfo& lores_info)
+{
+	// Process the main stream unless there is a lores stream to use instead
+	main_stream_ = main_stream;
+	stream_ = main_stream_;
 	
 	if (!stream_)
 		return;
 
-	StreamInfo info = app_->GetStreamInfo(stream_);
+	StreamInfo info = main_info;
+
+	// Use the kNumberFramesToSaveBeforeHit to size the frame ring.  All of the frame
+	// memory is allocated here so that Process() never has to.
+	if (gs::GolfSimClubData::kGatherClubData) {
+		int final_frame_buffer_size = 1 + gs::GolfSimClubData::kNumberFramesToSaveBeforeHit + 
+			gs::GolfSimClubData::kNumberFramesToSaveAfterHit;
+		golf_sim::RecentFrames.Configure(final_frame_buffer_size, info.width, info.height);
 
-	config_.hskip = std::max(config_.hskip, 1);
-	config_.vskip = std::max(config_.vskip, 1);
+		GS_LOG_MSG(trace, "Frame ring size re-set to: " + std::to_string(final_frame_buffer_size));
+	}
+	else {
+		golf_sim::RecentFrames.clear();
+	}
 
-	info.width /= config_.hskip;
-	info.height /= config_.vskip;
+	hskip_ = (uint)std::max(config_.hskip, 1);
+	vskip_ = (uint)std::max(config_.vskip, 1);
+
+	roi_to_main_scale_x_ = 1.0;
+	roi_to_main_scale_y_ = 1.0;
+
+	// The ROIs in stream_ pixels
+	float roi_x = config_.roi_x;
+	float roi_y = config_.roi_y;
+	float roi_width = config_.roi_width;
+	float roi_height = config_.roi_height;
+	float approach_roi_x = config_.approach_roi_x;
+	float approach_roi_y = config_.approach_roi_y;
+	float approach_roi_width = config_.approach_roi_width;
+	float approach_roi_height = config_.approach_roi_height;
+
+	if (config_.use_lores_stream) {
+		if (lores_stream == nullptr || lores_info.width == 0 || lores_info.height == 0) {
+			GS_LOG_MSG(warning, "MotionDetectStage::Configure - no lores stream was configured.  Decimating the main stream instead.");
+		}
+		else {
+			// The ISP has already done the decimation, so the ROI just needs scaling
+			// into lores pixels, and every lores pixel is examined
+			roi_to_main_scale_x_ = (float)main_info.width / (float)lores_info.width;
+			roi_to_main_scale_y_ = (float)main_info.height / (float)lores_info.height;
+
+			roi_x /= roi_to_main_scale_x_;
+			roi_width /= roi_to_main_scale_x_;
+			roi_y /= roi_to_main_scale_y_;
+			roi_height /= roi_to_main_scale_y_;
+			approach_roi_x /= roi_to_main_scale_x_;
+			approach_roi_width /= roi_to_main_scale_x_;
+			approach_roi_y /= roi_to_main_scale_y_;
+			approach_roi_height /= roi_to_main_scale_y_;
+			hskip_ = 1;
+			vskip_ = 1;
+
+			stream_ = lores_stream;
+			info = lores_info;
+
+			GS_LOG_MSG(trace, "MotionDetectStage::Configure - using the " + std::to_string(info.width) + "x" + std::to_string(info.height) + " lores stream.");
+		}
+	}
+
+	info.width /= hskip_;
+	info.height /= vskip_;
 
 	// Store ROI values as if in an image subsampled by hskip and vskip.
-	roi_x_ = config_.roi_x / config_.hskip;
-	roi_y_ = config_.roi_y / config_.vskip;
+	roi_x_ = (uint)(roi_x / hskip_);
+	roi_y_ = (uint)(roi_y / vskip_);
 
-	GS_LOG_MSG(trace, "After decimating, config_.roi_x = " + std::to_string(config_.roi_x) + ", config_.roi_y = " + std::to_string(config_.roi_y));
+	GS_LOG_MSG(trace, "After decimating, roi_x = " + std::to_string(roi_x) + ", roi_y = " + std::to_string(roi_y));
 	GS_LOG_MSG(trace, "roi_x_ = " + std::to_string(roi_x_) + ", roi_y_ = " + std::to_string(roi_y_));
 
-	roi_width_ = config_.roi_width / config_.hskip;
-	roi_height_ = config_.roi_height / config_.vskip;
+	roi_width_ = (uint)(roi_width / hskip_);
+	roi_height_ = (uint)(roi_height / vskip_);
 
 	// config_.region_threshold is a % of pixels that have changed
 	// scale it down based on the fraction the ROI is of the whole
@@ -162,6 +260,33 @@ void MotionDetectStage::Configure()
 
 	previous_frame_.resize(roi_width_ * roi_height_);
 
+	approach_roi_x_ = std::clamp((uint)(approach_roi_x / hskip_), 0u, info.width);
+	approach_roi_y_ = std::clamp((uint)(approach_roi_y / vskip_), 0u, info.height);
+	approach_roi_width_ = std::clamp((uint)(approach_roi_width / hskip_), 0u, info.width - approach_roi_x_);
+	approach_roi_height_ = std::clamp((uint)(approach_roi_height / vskip_), 0u, info.height - approach_roi_y_);
+	approach_region_threshold_ = std::max(1u, (uint)(config_.region_threshold * (float)approach_roi_width_ * (float)approach_roi_height_));
+	approach_quiet_frames_ = 0;
+
+	// Without the trigger, there would be nothing to end the pre-arm
+	const gs::SystemMode system_mode = gs::GolfSimOptions::GetCommandLineOptions().system_mode_;
+	approach_zone_active_ = config_.use_approach_zone && approach_roi_width_ > 0 && approach_roi_height_ > 0 &&
+							system_mode != gs::kCamera1TestStandalone && system_mode != gs::kVirtualCamera;
+
+	approach_previous_frame_.assign(approach_zone_active_ ? approach_roi_width_ * approach_roi_height_ : 0, 0);
+
+	if (gs::PulseStrobe::IsPreArmed()) {
+		gs::PulseStrobe::ReleasePreArm();
+	}
+
+	if (config_.use_approach_zone) {
+		GS_LOG_MSG(trace, "    approach zone: (" + std::to_string(approach_roi_x_) + "," + std::to_string(approach_roi_y_) + ") " +
+				   std::to_string(approach_roi_width_) + "x" + std::to_string(approach_roi_height_) + " threshold: " +
+				   std::to_string(approach_region_threshold_) + (approach_zone_active_ ? "" : " (not watched)"));
+	}
+
+	ConfigureBackgroundModel();
+	BuildThresholdLut();
+
 	first_time_ = true;
 	motion_detected_ = false;
 	detectionPaused_ = false;
@@ -177,6 +302,269 @@ void MotionDetectStage::Configure()
 	}
 }
 
+void MotionDetectStage::BuildThresholdLut()
+{
+	// Use exactly the same float test as the original per-pixel code when building
+	// the table, so that the integer comparison in Process() gives the same answers
+	for (int old_value = 0; old_value < 256; old_value++) {
+		const float threshold = config_.difference_m * (float)old_value + config_.difference_c;
+		int largest_unchanged_difference = 0;
+		while (largest_unchanged_difference < 255 && !((float)(largest_unchanged_difference + 1) > threshold)) {
+			largest_unchanged_difference++;
+		}
+		threshold_lut_[old_value] = (uint8_t)largest_unchanged_difference;
+	}
+}
+
+void MotionDetectStage::ConfigureForBenchmark(unsigned int roi_width, unsigned int roi_height)
+{
+	hskip_ = (uint)std::max(config_.hskip, 1);
+	vskip_ = (uint)std::max(config_.vskip, 1);
+
+	roi_x_ = 0;
+	roi_y_ = 0;
+	roi_width_ = roi_width;
+	roi_height_ = roi_height;
+	region_threshold_ = config_.region_threshold * (float)roi_width_ * (float)roi_height_;
+
+	previous_frame_.assign(roi_width_ * roi_height_, 0);
+	approach_zone_active_ = false;
+
+	ConfigureBackgroundModel();
+	BuildThresholdLut();
+}
+
+unsigned int MotionDetectStage::CountChangedPixels(const uint8_t* frame, unsigned int frame_stride)
+{
+	const unsigned int sampledFrameStride = frame_stride * vskip_;
+	unsigned int regions = 0;
+
+	for (unsigned int y = 0; y < roi_height_; y++)
+	{
+		const uint8_t* new_value_ptr = frame + ((roi_y_ + y) * sampledFrameStride) + (roi_x_ * hskip_);
+		uint8_t* old_value_ptr = &previous_frame_[0] + y * roi_width_;
+
+		regions += CountChangedPixelsInRow(new_value_ptr, old_value_ptr, roi_width_);
+	}
+
+	return regions;
+}
+
+void MotionDetectStage::WatchApproachZone(const uint8_t* frame, unsigned int frame_stride)
+{
+	const unsigned int sampled_frame_stride = frame_stride * vskip_;
+	unsigned int regions = 0;
+
+	// The whole zone, as each row also updates the previous frame
+	for (unsigned int y = 0; y < approach_roi_height_; y++)
+	{
+		const uint8_t* new_value_ptr = frame + ((approach_roi_y_ + y) * sampled_frame_stride) + (approach_roi_x_ * hskip_);
+		uint8_t* old_value_ptr = &approach_previous_frame_[0] + y * approach_roi_width_;
+
+		regions += CountChangedPixelsInRow(new_value_ptr, old_value_ptr, approach_roi_width_);
+	}
+
+	if (regions >= approach_region_threshold_) {
+		approach_quiet_frames_ = 0;
+
+		const bool was_pre_armed = gs::PulseStrobe::IsPreArmed();
+
+		// Re-warms the pulse train if already pre-armed
+		if (gs::PulseStrobe::PreArmTrigger() && !was_pre_armed) {
+			if (config_.realtime_mode) {
+				gs::GsDeferredLog::Log("Club in the approach zone - trigger pre-armed.  Regions: ", regions);
+			}
+			else {
+				GS_LOG_MSG(trace, "Club in the approach zone - trigger pre-armed.  Regions: " + std::to_string(regions));
+			}
+		}
+	}
+	else if (gs::PulseStrobe::IsPreArmed() && ++approach_quiet_frames_ >= (uint)std::max(config_.approach_release_frames, 1)) {
+		gs::PulseStrobe::ReleasePreArm();
+		gs::GsMetrics::Increment(gs::GsMetrics::Counter::kTriggerPreArmsReleased);
+		approach_quiet_frames_ = 0;
+
+		if (config_.realtime_mode) {
+			gs::GsDeferredLog::Log("Approach zone quiet - trigger pre-arm released.");
+		}
+		else {
+			GS_LOG_MSG(trace, "Approach zone quiet - trigger pre-arm released.");
+		}
+	}
+}
+
+void MotionDetectStage::ConfigureBackgroundModel()
+{
+	config_.background_screen_stride = std::max(config_.background_screen_stride, 1);
+
+	const uint grid_fraction = config_.background_screen_stride * config_.background_screen_stride;
+
+	// Half of the grid pixels that a real movement would be expected to change, so that
+	// a borderline frame still gets the full scan
+	screen_threshold_ = std::max(1u, region_threshold_ / (2 * grid_fraction));
+	background_update_row_ = 0;
+
+	background_.assign(config_.use_background_model ? roi_width_ * roi_height_ : 0, 0);
+}
+
+void MotionDetectStage::InitializeBackground(const uint8_t* frame, unsigned int frame_stride)
+{
+	const unsigned int sampled_frame_stride = frame_stride * vskip_;
+
+	for (unsigned int y = 0; y < roi_height_; y++)
+	{
+		const uint8_t* new_value_ptr = frame + ((roi_y_ + y) * sampled_frame_stride) + (roi_x_ * hskip_);
+		uint16_t* background_ptr = &background_[y * roi_width_];
+
+		for (unsigned int x = 0; x < roi_width_; x++, new_value_ptr += hskip_) {
+			background_ptr[x] = (uint16_t)(*new_value_ptr << 8);
+		}
+	}
+}
+
+void MotionDetectStage::UpdateBackground(const uint8_t* frame, unsigned int sampled_frame_stride)
+{
+	const unsigned int stride = config_.background_screen_stride;
+
+	for (unsigned int y = background_update_row_; y < roi_height_; y += stride)
+	{
+		const uint8_t* new_value_ptr = frame + ((roi_y_ + y) * sampled_frame_stride) + (roi_x_ * hskip_);
+		uint16_t* background_ptr = &background_[y * roi_width_];
+
+		for (unsigned int x = 0; x < roi_width_; x++, new_value_ptr += hskip_) {
+			const int difference = (int)(*new_value_ptr << 8) - (int)background_ptr[x];
+			background_ptr[x] = (uint16_t)((int)background_ptr[x] + (difference >> kBackgroundShift));
+		}
+	}
+
+	background_update_row_ = (background_update_row_ + 1) % stride;
+}
+
+GS_HOT_KERNEL bool MotionDetectStage::DiffersFromBackground(const uint8_t* frame, unsigned int frame_stride)
+{
+	const unsigned int sampled_frame_stride = frame_stride * vskip_;
+	const unsigned int stride = config_.background_screen_stride;
+	const unsigned int hskip = hskip_;
+
+	// The cheap screen - most frames have no motion, and are done with after this
+	unsigned int screened_changes = 0;
+
+	for (unsigned int y = 0; y < roi_height_ && screened_changes < screen_threshold_; y += stride)
+	{
+		const uint8_t* new_row = frame + ((roi_y_ + y) * sampled_frame_stride) + (roi_x_ * hskip);
+		const uint16_t* background_row = &background_[y * roi_width_];
+
+		for (unsigned int x = 0; x < roi_width_; x += stride) {
+			screened_changes += DiffersFromBackgroundPixel(new_row[x * hskip], background_row[x]);
+		}
+	}
+
+	if (screened_changes >= screen_threshold_) {
+		// The whole ROI, stopping as soon as there is enough of a change
+		unsigned int regions = 0;
+
+		for (unsigned int y = 0; y < roi_height_; y++)
+		{
+			const uint8_t* new_row = frame + ((roi_y_ + y) * sampled_frame_stride) + (roi_x_ * hskip);
+			const uint16_t* background_row = &background_[y * roi_width_];
+
+			for (unsigned int x = 0; x < roi_width_; x++) {
+				regions += DiffersFromBackgroundPixel(new_row[x * hskip], background_row[x]);
+			}
+
+			if (regions >= region_threshold_) {
+				return true;
+			}
+		}
+	}
+
+	UpdateBackground(frame, frame_stride * vskip_);
+	return false;
+}
+
+GS_HOT_KERNEL unsigned int MotionDetectStage::CountChangedPixelsInRow(const uint8_t* new_row, uint8_t* old_row, unsigned int width) const
+{
+	const unsigned int hskip = hskip_;
+	unsigned int changed = 0;
+	unsigned int x = 0;
+
+#ifdef GS_MOTION_DETECT_USE_NEON
+	if (hskip == 1 || hskip == 2) {
+		// The 256-entry table is looked up as four 64-byte tables.  Indexes that are out
+		// of range for a table give 0, so OR-ing the four lookups gives threshold_lut_[old].
+		const uint8x16x4_t lut0 = vld1q_u8_x4(&threshold_lut_[0]);
+		const uint8x16x4_t lut1 = vld1q_u8_x4(&threshold_lut_[64]);
+		const uint8x16x4_t lut2 = vld1q_u8_x4(&threshold_lut_[128]);
+		const uint8x16x4_t lut3 = vld1q_u8_x4(&threshold_lut_[192]);
+		const uint8x16_t sixty_four = vdupq_n_u8(64);
+
+		// Per-lane counts of changed pixels.  Flushed before they could overflow.
+		uint8x16_t lane_counts = vdupq_n_u8(0);
+		unsigned int chunks_in_lane_counts = 0;
+
+		for (; x + 16 <= width; x += 16) {
+			uint8x16_t new_values;
+			if (hskip == 1) {
+				new_values = vld1q_u8(new_row + x);
+			}
+			else {
+				// De-interleave and keep every other pixel
+				new_values = vld2q_u8(new_row + 2 * x).val[0];
+			}
+
+			const uint8x16_t old_values = vld1q_u8(old_row + x);
+			vst1q_u8(old_row + x, new_values);
+
+			uint8x16_t index = old_values;
+			uint8x16_t threshold = vqtbl4q_u8(lut0, index);
+			index = vsubq_u8(index, sixty_four);
+			threshold = vorrq_u8(threshold, vqtbl4q_u8(lut1, index));
+			index = vsubq_u8(index, sixty_four);
+			threshold = vorrq_u8(threshold, vqtbl4q_u8(lut2, index));
+			index = vsubq_u8(index, sixty_four);
+			threshold = vorrq_u8(threshold, vqtbl4q_u8(lut3, index));
+
+			// All-ones (i.e., -1) in each lane that changed
+			const uint8x16_t changed_mask = vcgtq_u8(vabdq_u8(new_values, old_values), threshold);
+			lane_counts = vsubq_u8(lane_counts, changed_mask);
+
+			if (++chunks_in_lane_counts == 255) {
+				changed += vaddlvq_u8(lane_counts);
+				lane_counts = vdupq_n_u8(0);
+				chunks_in_lane_counts = 0;
+			}
+		}
+
+		changed += vaddlvq_u8(lane_counts);
+	}
+#endif
+
+	// Whatever is left over (or everything, without NEON or for larger hskips)
+	const uint8_t* new_value_ptr = new_row + x * hskip;
+	for (; x < width; x++, new_value_ptr += hskip) {
+		const uint8_t new_value = *new_value_ptr;
+		const uint8_t old_value = old_row[x];
+		old_row[x] = new_value;
+
+		const uint8_t difference = (new_value > old_value) ? (new_value - old_value) : (old_value - new_value);
+		if (difference > threshold_lut_[old_value]) {
+			changed++;
+		}
+	}
+
+	return changed;
+}
+
+void MotionDetectStage::SetResult(CompletedRequestPtr& completed_request, bool result)
+{
+	last_result_ = result;
+
+	// The metadata map allocates a node for each request
+	if (!config_.realtime_mode) {
+		completed_request->post_process_metadata.Set("motion_detect.result", result);
+	}
+}
+
 bool MotionDetectStage::Process(CompletedRequestPtr& completed_request)
 {
 	if (!stream_) {
@@ -184,33 +572,73 @@ bool MotionDetectStage::Process(CompletedRequestPtr& completed_request)
 		return false;
 	}
 
-	completed_request->post_process_metadata.Set("motion_detect.result", false);
+	BufferReadSync r(app_, completed_request->buffers[stream_]);
+	uint8_t* image = (uint8_t*)r.Get()[0].data();
+	StreamInfo info = app_->GetStreamInfo(stream_);
 
-	if (detectionPaused_ && postMotionFramesToCapture_ <= 0) {
-		GS_LOG_MSG(error, "detectionPaused_ and postMotionFramesToCapture_ <= 0");
-		return false;
+	// When watching a lores stream, the frames that are kept come from the main stream.
+	// Kept on the stack, so that no frame has to allocate.
+	std::optional<BufferReadSync> main_read;
+	uint8_t* main_image = nullptr;
+	StreamInfo main_info;
+
+	if (stream_ != main_stream_ && (gs::GolfSimClubData::kGatherClubData || need_to_log_first_image_)) {
+		main_read.emplace(app_, completed_request->buffers[main_stream_]);
+		main_image = (uint8_t*)main_read->Get()[0].data();
+		main_info = app_->GetStreamInfo(main_stream_);
 	}
 
-	// We are not looking at every frame, don't do anything on the off-frames
-	if (config_.frame_period && completed_request->sequence % config_.frame_period) {
-		GS_LOG_MSG(trace, "config_.frame_period && completed_request->sequence % config_.frame_period. config_.frame_period= " + std::to_string(config_.frame_period));
+	ProcessImage(completed_request, image, info, main_image, main_info);
+
+	return false;
+}
+
+bool MotionDetectStage::Process(gs::GsWatcherFrame& frame)
+{
+	uint8_t* image = frame.Image(stream_);
+
+	if (image == nullptr) {
+		if (config_.realtime_mode) {
+			gs::GsDeferredLog::Log("ERROR: MotionDetectStage::Process - the frame has no image for stream_");
+		}
+		else {
+			GS_LOG_MSG(error, "MotionDetectStage::Process - the frame has no image for stream_");
+		}
 		return false;
 	}
 
-	libcamera::FrameBuffer *buffer = completed_request->buffers[stream_];
+	ProcessImage(*frame.request, image, frame.Info(stream_), frame.Image(main_stream_), frame.Info(main_stream_));
 
-    BufferReadSync r(app_, buffer);
+	return last_result_;
+}
 
-	const std::vector<libcamera::Span<uint8_t>> mem = r.Get();
+void MotionDetectStage::ProcessImage(CompletedRequestPtr& completed_request, uint8_t* image, const StreamInfo& info,
+									 uint8_t* main_image, const StreamInfo& main_info)
+{
+	SetResult(completed_request, false);
 
-    uint8_t *image = (uint8_t *)mem[0].data();
+	if (detectionPaused_ && postMotionFramesToCapture_ <= 0) {
+		if (config_.realtime_mode) {
+			gs::GsDeferredLog::Log("ERROR: detectionPaused_ and postMotionFramesToCapture_ <= 0");
+		}
+		else {
+			GS_LOG_MSG(error, "detectionPaused_ and postMotionFramesToCapture_ <= 0");
+		}
+		return;
+	}
 
-    StreamInfo info = app_->GetStreamInfo(stream_);
+	// We are not looking at every frame, don't do anything on the off-frames
+	if (config_.frame_period && completed_request->sequence % config_.frame_period) {
+		if (!config_.realtime_mode) {
+			GS_LOG_MSG(trace, "config_.frame_period && completed_request->sequence % config_.frame_period. config_.frame_period= " + std::to_string(config_.frame_period));
+		}
+		return;
+	}
 
 	// Process() is called synchronously from the single ball_watcher event loop thread.
 	// No mutex needed — previous_frame_ and motion_detected_ are only accessed here.
 
-	unsigned int sampledFrameStride = info.stride * config_.vskip;
+	unsigned int sampledFrameStride = info.stride * vskip_;
 
 	if (first_time_)
 	{
@@ -220,18 +648,32 @@ bool MotionDetectStage::Process(CompletedRequestPtr& completed_request)
 
 		for (unsigned int y = 0; y < roi_height_; y++)
 		{
-			uint8_t *new_value_ptr = image + ((roi_y_ + y) * sampledFrameStride) + (roi_x_ * config_.hskip);
+			uint8_t *new_value_ptr = image + ((roi_y_ + y) * sampledFrameStride) + (roi_x_ * hskip_);
 			uint8_t *old_value_ptr = &previous_frame_[0] + y * roi_width_;
 
 			// Now traverse across the incoming frame in the x direction for this row
-			for (unsigned int x = 0; x < roi_width_; x++, new_value_ptr += config_.hskip) {
+			for (unsigned int x = 0; x < roi_width_; x++, new_value_ptr += hskip_) {
 				*(old_value_ptr++) = *new_value_ptr;
 			}
 		}
 
-		completed_request->post_process_metadata.Set("motion_detect.result", false);
+		if (config_.use_background_model) {
+			InitializeBackground(image, info.stride);
+		}
 
-		return false;
+		for (unsigned int y = 0; approach_zone_active_ && y < approach_roi_height_; y++)
+		{
+			const uint8_t* new_value_ptr = image + ((approach_roi_y_ + y) * sampledFrameStride) + (approach_roi_x_ * hskip_);
+			uint8_t* old_value_ptr = &approach_previous_frame_[0] + y * approach_roi_width_;
+
+			for (unsigned int x = 0; x < approach_roi_width_; x++, new_value_ptr += hskip_) {
+				*(old_value_ptr++) = *new_value_ptr;
+			}
+		}
+
+		SetResult(completed_request, false);
+
+		return;
 	}
 
 	bool local_motion_detected = false;
@@ -245,26 +687,18 @@ bool MotionDetectStage::Process(CompletedRequestPtr& completed_request)
 
 	unsigned int regions = 0;
 
+	if (!local_motion_detected && config_.use_background_model) {
+		local_motion_detected = DiffersFromBackground(image, info.stride);
+	}
+
 	// Count the  pixels where the difference between the new and previous values
 	// exceeds the threshold. At the same time, update the previous image buffer.
-	for (unsigned int y = 0; !local_motion_detected && y < roi_height_; y++)
+	for (unsigned int y = 0; !local_motion_detected && !config_.use_background_model && y < roi_height_; y++)
 	{
-		uint8_t* new_value_ptr = image + ((roi_y_ + y) * sampledFrameStride) + (roi_x_ * config_.hskip);
+		uint8_t* new_value_ptr = image + ((roi_y_ + y) * sampledFrameStride) + (roi_x_ * hskip_);
 		uint8_t* old_value_ptr = &previous_frame_[0] + y * roi_width_;
-		for (unsigned int x = 0; x < roi_width_; x++, new_value_ptr += config_.hskip)
-		{
-			int new_value = *new_value_ptr;
-			int old_value = *old_value_ptr;
 
-			// TBD - Remove
-			// LOG(1, "sampledFrameStride: " << sampledFrameStride << ". old= " << old_value << " new= " << new_value << " .New_ptr: " << (long)new_value_ptr << ".Old_ptr : " << (long)old_value_ptr << ".");
-
-
-			*(old_value_ptr++) = new_value;
-			if (std::abs(new_value - old_value) > (config_.difference_m * (float)old_value + config_.difference_c)) {
-				regions++;
-			}
-		}
+		regions += CountChangedPixelsInRow(new_value_ptr, old_value_ptr, roi_width_);
 
 		local_motion_detected = (regions >= region_threshold_);
 
@@ -278,21 +712,63 @@ bool MotionDetectStage::Process(CompletedRequestPtr& completed_request)
 	// TBD - Only for testing - REMOVE
 	// std::cout << regions << std::endl;
 
+	// After the ball ROI, so that the trigger never waits on the approach zone
+	if (approach_zone_active_ && !local_motion_detected) {
+		WatchApproachZone(image, info.stride);
+	}
+
 	if (local_motion_detected && !detectionPaused_) {
 
 		// We just now detected movement (this time through this code)
+		gs::GsLatencyBench::Stamp(gs::GsLatencyBench::kMotionDetected);
+		gs::GsShotTrace::BeginShot();
 
 		// TBD - ** Immediately ** pulse the output - we want to do this with as little latency
 		// as possible, because otherwise the ball will fly past the camera 2 FoV
-		if (gs::GolfSimOptions::GetCommandLineOptions().system_mode_ != gs::kCamera1TestStandalone) {
+		gs::GsTriggerTiming trigger_timing;
+
+		const gs::SystemMode system_mode = gs::GolfSimOptions::GetCommandLineOptions().system_mode_;
+
+		if (system_mode != gs::kCamera1TestStandalone && system_mode != gs::kVirtualCamera) {
+			const bool was_pre_armed = gs::PulseStrobe::IsPreArmed();
+
 			gs::PulseStrobe::SendExternalTrigger();
-			GS_LOG_MSG(trace, "---> SendExternalTrigger");
+
+			if (was_pre_armed) {
+				gs::GsMetrics::Increment(gs::GsMetrics::Counter::kTriggerPreArmsTriggered);
+			}
+
+			// Same clock as the SensorTimestamp
+			struct timespec trigger_time;
+			clock_gettime(CLOCK_BOOTTIME, &trigger_time);
+
+			gs::GsShotTrace::Mark(gs::GsShotTrace::Stage::kTriggerSent);
+
+			auto sensor_timestamp = completed_request->metadata.get(libcamera::controls::SensorTimestamp);
+			if (sensor_timestamp) {
+				trigger_timing.valid = true;
+				trigger_timing.sensor_timestamp_ns = *sensor_timestamp;
+				trigger_timing.trigger_sent_ns = (int64_t)trigger_time.tv_sec * 1000000000 + trigger_time.tv_nsec;
+				trigger_timing.frame_duration_us = completed_request->metadata.get(libcamera::controls::FrameDuration).value_or(0);
+				trigger_timing.exposure_time_us = completed_request->metadata.get(libcamera::controls::ExposureTime).value_or(0);
+			}
+
+			if (config_.realtime_mode) {
+				gs::GsDeferredLog::Log("---> SendExternalTrigger");
+			}
+			else {
+				GS_LOG_MSG(trace, "---> SendExternalTrigger");
+			}
 		}
 		else {
-			// Camera2 image is captured by the in-process Camera2Thread
+			// Camera2 image is captured by the in-process Camera2Thread, or handed over
+			// by the GsVirtualCamera
 		}
 
-		if (config_.verbose)
+		// An invalid timing is still recorded so that a prior shot's timing is never used for this one
+		gs::GolfSimCamera::RecordTriggerTiming(trigger_timing);
+
+		if (config_.verbose && !config_.realtime_mode)
 			LOG(1, "Saving Image x,y: " << info.width << ", " << info.height << " .");
 
 		// For now, as soon as we detect motion (except for a few frames) we stop recording.  This 
@@ -307,18 +783,25 @@ bool MotionDetectStage::Process(CompletedRequestPtr& completed_request)
 			postMotionFramesToCapture_ = 0;
 		}
 
-		GS_LOG_MSG(trace, "Will save an additional " + std::to_string(postMotionFramesToCapture_) + " frames.");
+		if (config_.realtime_mode) {
+			gs::GsDeferredLog::Log("Number of additional frames to save: ", postMotionFramesToCapture_);
+		}
+		else {
+			GS_LOG_MSG(trace, "Will save an additional " + std::to_string(postMotionFramesToCapture_) + " frames.");
+		}
 	}
 
 	// Ensure we don't tell the outer loop that there's motion until we've completed viewing
 	// the post-motion images
 	if (postMotionFramesToCapture_ > 1) {
-		GS_LOG_MSG(trace, "Post-motion frames > 0 - setting result local_motion_detected to false.");
-		completed_request->post_process_metadata.Set("motion_detect.result", false);
+		if (!config_.realtime_mode) {
+			GS_LOG_MSG(trace, "Post-motion frames > 0 - setting result local_motion_detected to false.");
+		}
+		SetResult(completed_request, false);
 	}
 	else {
 		// TBD - Too Much Logging - GS_LOG_MSG(trace, "No post-motion frames after this one - setting result local_motion_detected of: " + std::to_string(local_motion_detected) + ".");
-		completed_request->post_process_metadata.Set("motion_detect.result", local_motion_detected);
+		SetResult(completed_request, local_motion_detected);
 		// Signal motion to the outside world.
 		motion_detected_ = local_motion_detected;
 	}
@@ -330,53 +813,66 @@ bool MotionDetectStage::Process(CompletedRequestPtr& completed_request)
 
 		// std::cout << "postFrames: " << std::to_string(postMotionFramesToCapture_) << std::endl;
 
-		golf_sim::RecentFrameInfo frameInfo;
-
-		frameInfo.requestSequence = completed_request->sequence;
-		frameInfo.frameRate = completed_request->framerate;
+		// When watching a lores stream, the frames that are kept come from the main stream
+		const StreamInfo& kept_info = (main_image != nullptr) ? main_info : info;
+		uint8_t* kept_image = (main_image != nullptr) ? main_image : image;
 
-		// If we haven't started taking any post-motion frames yet, then this is the frame
-		// during which the movement was first detected.
-		frameInfo.isballHitFrame = (postMotionFramesToCapture_ == gs::GolfSimClubData::kNumberFramesToSaveAfterHit);
+		cv::Mat mat = cv::Mat(kept_info.height, kept_info.width, CV_8U, kept_image, kept_info.stride);
 
-		cv::Mat mat = cv::Mat(info.height, info.width, CV_8U, image, info.stride);
+		if (gs::GolfSimClubData::kGatherClubData) {
+			golf_sim::RecentFrameInfo frameInfo;
 
-		if (config_.showroi) {
-			cv::Scalar c_black{ 0, 0, 0 }; // black
-			cv::Scalar c_green{ 170, 255, 0 }; // bright green
+			frameInfo.requestSequence = completed_request->sequence;
+			frameInfo.frameRate = completed_request->framerate;
 
-			// We could have different frame sizes for the "hit" frame?
-			int rectWidth = frameInfo.isballHitFrame ? 2 : 2;
+			// If we haven't started taking any post-motion frames yet, then this is the frame
+			// during which the movement was first detected.
+			frameInfo.isballHitFrame = (postMotionFramesToCapture_ == gs::GolfSimClubData::kNumberFramesToSaveAfterHit);
 
-			cv::Scalar rectangle_color = frameInfo.isballHitFrame ? c_green : c_black;
+			// TBD - Too Much Logging - GS_LOG_MSG(trace, "Pushing Post-Motion Frame No. " + std::to_string(postMotionFramesToCapture_) + " - Seq. No. " + std::to_string(completed_request->sequence));
 
-			cv::Point startPoint = cv::Point(roi_x_ * config_.hskip, roi_y_ * config_.vskip);
+			// The ring keeps its own copy, so the annotations go on that copy and not on the
+			// camera's buffer.  They are drawn before the ring is unlocked.
+			const bool pushed = golf_sim::RecentFrames.Push(kept_image, kept_info.width, kept_info.height, kept_info.stride, frameInfo,
+				[&](cv::Mat& ring_frame) {
+					if (config_.showroi) {
+						cv::Scalar c_black{ 0, 0, 0 }; // black
+						cv::Scalar c_green{ 170, 255, 0 }; // bright green
 
-			cv::Point endPoint = cv::Point((roi_x_ + roi_width_) * config_.hskip, (roi_y_ + roi_height_) * config_.vskip);
+						// We could have different frame sizes for the "hit" frame?
+						int rectWidth = frameInfo.isballHitFrame ? 2 : 2;
 
-			cv::rectangle(mat, startPoint, endPoint, rectangle_color, rectWidth);
-		}
+						cv::Scalar rectangle_color = frameInfo.isballHitFrame ? c_green : c_black;
 
-		// Number the frame 
-		cv::Scalar c_label{ 170, 255, 0 }; // bright green
-		std::string frame_label = std::to_string(completed_request->sequence);
-		int text_x = info.width - 60;
-		int text_y = 25;
+						const float scale_x = hskip_ * roi_to_main_scale_x_;
+						const float scale_y = vskip_ * roi_to_main_scale_y_;
 
-		cv::putText(mat, frame_label, cv::Point(text_x, text_y), cv::FONT_HERSHEY_SIMPLEX, 0.8, c_label, 2, cv::LINE_AA);
+						cv::Point startPoint = cv::Point(roi_x_ * scale_x, roi_y_ * scale_y);
 
-		// TBD - Too Much Logging - GS_LOG_MSG(trace, "Pushing Post-Motion Frame No. " + std::to_string(postMotionFramesToCapture_) + " - Seq. No. " + std::to_string(completed_request->sequence));
+						cv::Point endPoint = cv::Point((roi_x_ + roi_width_) * scale_x, (roi_y_ + roi_height_) * scale_y);
 
-		golf_sim::RecentFrames.push_back(frameInfo);
+						cv::rectangle(ring_frame, startPoint, endPoint, rectangle_color, rectWidth);
+					}
 
-		golf_sim::RecentFrameInfo& enqueuedFrameInfo = golf_sim::RecentFrames.back();
+					// Number the frame.  Formatted on the stack - a sequence number is short enough
+					// that the string putText takes does not allocate, either.
+					cv::Scalar c_label{ 170, 255, 0 }; // bright green
+					char frame_label[16];
+					snprintf(frame_label, sizeof(frame_label), "%u", completed_request->sequence);
+					int text_x = kept_info.width - 60;
+					int text_y = 25;
 
-		// Make sure that the enqueued frame info has its own Mat, as the push_back
-		// might only do a shallow copy. TBD - figure this out!
-		enqueuedFrameInfo.mat = mat.clone();
+					cv::putText(ring_frame, frame_label, cv::Point(text_x, text_y), cv::FONT_HERSHEY_SIMPLEX, 0.8, c_label, 2, cv::LINE_AA);
+				});
 
-		if (enqueuedFrameInfo.mat.empty()) {
-			GS_LOG_MSG(error, "Enqueued a null club data image");
+			if (!pushed) {
+				if (config_.realtime_mode) {
+					gs::GsDeferredLog::Log("ERROR: Could not add a club data image to the frame ring.");
+				}
+				else {
+					GS_LOG_MSG(error, "Could not add a club data image to the frame ring.");
+				}
+			}
 		}
 
 		if (need_to_log_first_image_) {
@@ -389,8 +885,6 @@ bool MotionDetectStage::Process(CompletedRequestPtr& completed_request)
 			postMotionFramesToCapture_--;
 		}
 	}
-
-	return false;
 }
 
 static PostProcessingStage *Create(RPiCamApp *app)
@@ -9,17 +9,25 @@
 #include "gs_options.h"
 #include "gs_config.h"
 #include "gs_clubs.h"
+#include "gs_session_settings.h"
 #include "gs_camera.h"
+#include "gs_latency_bench.h"
 
 #ifdef __unix__  // Ignore in Windows environment
 
 #include <lgpio.h>
+#include <errno.h>
+#include <time.h>
 #include <unistd.h>
 #include <thread>
+#include <chrono>
+#include <sys/mman.h>
 #include <math.h>
 #include <sys/time.h>
 #include <signal.h>
 #include <sys/signalfd.h>
+#include <sys/prctl.h>
+#include <fcntl.h>
 
 #else
 #define NOMINMAX  // Get rid of a std::min/max compile issue
@@ -57,12 +65,29 @@ namespace golf_sim {
 	unsigned long PulseStrobe::camera_slow_pulse_sequence_length_ = 0;
 	unsigned long PulseStrobe::tail_repeat_sequence_length_ = 0;
 
+	char* PulseStrobe::armed_pulse_sequence_ = nullptr;
+	unsigned long PulseStrobe::armed_pulse_sequence_length_ = 0;
+	unsigned int PulseStrobe::armed_putting_delay_us_ = 0;
+	long PulseStrobe::armed_pause_before_flush_us_ = 0;
+	bool PulseStrobe::pre_armed_ = false;
+	int PulseStrobe::cpu_latency_fd_ = -1;
+	long PulseStrobe::last_trigger_to_first_pulse_us_ = -1;
+	int64_t PulseStrobe::last_strobe_write_start_ns_ = 0;
+	int64_t PulseStrobe::last_strobe_write_end_ns_ = 0;
+	std::chrono::steady_clock::time_point PulseStrobe::trigger_start_time_;
+
 	int PulseStrobe::spiHandle_ = -1;
 	int PulseStrobe::lggpio_chip_handle_ = -1;
 	bool PulseStrobe::spiOpen_ = false;
 	bool PulseStrobe::kRecordAllImages = true;
 	bool PulseStrobe::gpio_system_initialized_ = false;
 	int PulseStrobe::kPuttingStrobeDelayMs = 0;
+	int PulseStrobe::kPuttingFastPathMaxStrobePulses = 0;
+	bool PulseStrobe::kUsePreciseTriggerTiming = false;
+	int PulseStrobe::kPreArmMaxCpuWakeLatencyUs = 10;
+
+	// How much of a precisely-timed wait is spun rather than slept, to cover the scheduler's wake-up latency
+	const long kPreciseTriggerSpinUs = 200;
 
 	long PulseStrobe::kCam2SetupPeriodMilliseconds = 2000;
 	int PulseStrobe::kNumberPrimingPulses = 12;
@@ -360,8 +385,12 @@ namespace golf_sim {
 			buf = camera_fast_pulse_sequence_;
 			result_length = camera_fast_pulse_sequence_length_;
 		}
+		else if (armed_pulse_sequence_ != nullptr) {
+			buf = armed_pulse_sequence_;
+			result_length = armed_pulse_sequence_length_;
+		}
 		else {
-			if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::GsClubType::kPutter) {
+			if (GsSessionSettings::ShotSettings().club_type == GolfSimClubs::GsClubType::kPutter) {
 				buf = camera_slow_pulse_sequence_;
 				result_length = camera_slow_pulse_sequence_length_;
 			}
@@ -382,9 +411,25 @@ namespace golf_sim {
 
 #ifdef __unix__  // Ignore in Windows environment
 
-		if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::GsClubType::kPutter) {
+		unsigned int putting_delay_us = 0;
+
+		if (armed_pulse_sequence_ != nullptr) {
+			putting_delay_us = armed_putting_delay_us_;
+		}
+		else if (GsSessionSettings::ShotSettings().club_type == GolfSimClubs::GsClubType::kPutter) {
 			// TBD - CHANGES TIMING - GS_LOG_TRACE_MSG(trace, "In putting mode.  Waiting " + std::to_string(kPuttingStrobeDelayMs) + "ms before trigger.");
-			usleep(1000 * kPuttingStrobeDelayMs);
+			putting_delay_us = (kPuttingStrobeDelayMs > 0) ? (unsigned int)(1000 * kPuttingStrobeDelayMs) : 0;
+		}
+
+		if (putting_delay_us > 0) {
+			if (kUsePreciseTriggerTiming) {
+				// Measured from the start of the trigger, so the time already spent getting here does not add to the delay
+				const auto delay_start = (trigger_start_time_ != std::chrono::steady_clock::time_point{}) ? trigger_start_time_ : std::chrono::steady_clock::now();
+				WaitUntilDeadline(delay_start + std::chrono::microseconds(putting_delay_us));
+			}
+			else {
+				usleep(putting_delay_us);
+			}
 		}
 
 
@@ -400,7 +445,26 @@ namespace golf_sim {
 			lgGpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kON);
 		}
 
+		golf_sim::GsLatencyBench::Stamp(golf_sim::GsLatencyBench::kTriggerSent);
+
+		// The first strobe pulse goes out at the start of the write
+		const bool timing_trigger = (trigger_start_time_ != std::chrono::steady_clock::time_point{});
+		struct timespec write_time;
+
+		if (timing_trigger) {
+			last_trigger_to_first_pulse_us_ = (long)std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - trigger_start_time_).count();
+
+			clock_gettime(CLOCK_BOOTTIME, &write_time);
+			last_strobe_write_start_ns_ = (int64_t)write_time.tv_sec * 1000000000 + write_time.tv_nsec;
+		}
+
 		int bytes_sent = lgSpiWrite(spiHandle_, buf, result_length);
+
+		if (timing_trigger) {
+			clock_gettime(CLOCK_BOOTTIME, &write_time);
+			last_strobe_write_end_ns_ = (int64_t)write_time.tv_sec * 1000000000 + write_time.tv_nsec;
+		}
 		bool shutter_failure = false;
 
 		if (bytes_sent != (int)result_length) {
@@ -417,7 +481,7 @@ namespace golf_sim {
 			lgGpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kOFF);
 		}
 
-		GS_LOG_TRACE_MSG(trace, "SendCameraStrobeTriggerAndShutter sent pulse sequence of length = " + std::to_string(camera_fast_pulse_sequence_length_) + " bytes.");
+		GS_LOG_TRACE_MSG(trace, "SendCameraStrobeTriggerAndShutter sent pulse sequence of length = " + std::to_string(result_length) + " bytes.");
 
 
 		return !shutter_failure;
@@ -527,6 +591,17 @@ namespace golf_sim {
 		GolfSimConfiguration::SetConstant("gs_config.strobing.kStrobePulseVectorDriver", pulse_intervals_fast_ms_);
 		GolfSimConfiguration::SetConstant("gs_config.strobing.kStrobePulseVectorPutter", pulse_intervals_slow_ms_);
 		GolfSimConfiguration::SetConstant("gs_config.strobing.kDynamicFollowOnPulseVectorPutter", pulse_intervals_tail_repeat_ms_);
+		GolfSimConfiguration::SetConstant("gs_config.strobing.kPuttingFastPathMaxStrobePulses", kPuttingFastPathMaxStrobePulses);
+		GolfSimConfiguration::SetConstant("gs_config.strobing.kUsePreciseTriggerTiming", kUsePreciseTriggerTiming);
+		GolfSimConfiguration::SetConstant("gs_config.strobing.kPreArmMaxCpuWakeLatencyUs", kPreArmMaxCpuWakeLatencyUs);
+
+		// N pulses need N-1 intervals plus the terminating 0.  GetPulseIntervals returns
+		// this same vector, so the shot analysis expects only the pulses that are sent.
+		if (kPuttingFastPathMaxStrobePulses > 0 && (size_t)kPuttingFastPathMaxStrobePulses < pulse_intervals_slow_ms_.size()) {
+			pulse_intervals_slow_ms_.resize(kPuttingFastPathMaxStrobePulses);
+			pulse_intervals_slow_ms_.back() = 0.0;
+			GS_LOG_TRACE_MSG(trace, "Putter strobe pulses limited to " + std::to_string(kPuttingFastPathMaxStrobePulses) + ".");
+		}
 
 		// We generally want longer pulses in the optically-noisy comparison environment
 		if (GolfSimOptions::GetCommandLineOptions().lm_comparison_mode_) {
@@ -559,13 +634,143 @@ namespace golf_sim {
 			return false;
 		}
 
+#ifdef __unix__  // Ignore in Windows environment
+		// Keep the pulse trains resident so that the trigger never takes a page fault.
+		// Not fatal if RLIMIT_MEMLOCK is too small - ArmTrigger still pre-faults the pages.
+		if (mlock(camera_fast_pulse_sequence_, camera_fast_pulse_sequence_length_) != 0 ||
+			mlock(camera_slow_pulse_sequence_, camera_slow_pulse_sequence_length_) != 0) {
+			GS_LOG_MSG(warning, "PulseStrobe::InitGPIOSystem could not mlock the pulse sequences.  Check the memlock ulimit.");
+		}
+#endif // #ifdef __unix__  // Ignore in Windows environment
+
 		return true;
 	}
 
+	void PulseStrobe::ArmTrigger() {
+
+		if (GsSessionSettings::ShotSettings().club_type == GolfSimClubs::GsClubType::kPutter) {
+			armed_pulse_sequence_ = camera_slow_pulse_sequence_;
+			armed_pulse_sequence_length_ = camera_slow_pulse_sequence_length_;
+			armed_putting_delay_us_ = (kPuttingStrobeDelayMs > 0) ? (unsigned int)(1000 * kPuttingStrobeDelayMs) : 0;
+		}
+		else {
+			armed_pulse_sequence_ = camera_fast_pulse_sequence_;
+			armed_pulse_sequence_length_ = camera_fast_pulse_sequence_length_;
+			armed_putting_delay_us_ = 0;
+		}
+
+		if (armed_pulse_sequence_ == nullptr) {
+			GS_LOG_MSG(warning, "PulseStrobe::ArmTrigger called before the pulse sequences were built.");
+			return;
+		}
+
+		// Touch every page so that none of them faults (or misses the TLB) during the write
+		const unsigned long kPageSize = 4096;
+		TouchArmedPulseSequence(kPageSize);
+
+		// Read now rather than from the JSON configuration in the trigger path
+		long kPauseBeforeSendingImageFlushMs = 0;
+		GolfSimConfiguration::SetConstant("gs_config.strobing.kPauseBeforeSendingImageFlushMs", kPauseBeforeSendingImageFlushMs);
+		armed_pause_before_flush_us_ = kPauseBeforeSendingImageFlushMs * 1000;
+
+		GS_LOG_TRACE_MSG(trace, "PulseStrobe::ArmTrigger armed a pulse sequence of " + std::to_string(armed_pulse_sequence_length_) + " bytes.");
+	}
+
+	void PulseStrobe::TouchArmedPulseSequence(unsigned long stride) {
+		volatile char sum = 0;
+		for (unsigned long i = 0; i < armed_pulse_sequence_length_; i += stride) {
+			sum = sum + armed_pulse_sequence_[i];
+		}
+		(void)sum;
+	}
+
+	bool PulseStrobe::PreArmTrigger() {
+
+		if (armed_pulse_sequence_ == nullptr) {
+			return false;
+		}
+
+		// The train may well have been evicted while waiting for the golfer, so bring all
+		// of it back into the cache rather than just its pages back into the TLB
+		const unsigned long kCacheLineSize = 64;
+		TouchArmedPulseSequence(kCacheLineSize);
+
+		if (pre_armed_) {
+			return true;
+		}
+
+#ifdef __unix__  // Ignore in Windows environment
+		if (kUsePreciseTriggerTiming) {
+			prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+		}
+
+		// Waking a CPU from its deeper idle states can add tens of microseconds before the
+		// shutter GPIO write.  The request lasts until the descriptor is closed.
+		if (kPreArmMaxCpuWakeLatencyUs >= 0 && cpu_latency_fd_ < 0) {
+			cpu_latency_fd_ = open("/dev/cpu_dma_latency", O_WRONLY | O_CLOEXEC);
+
+			if (cpu_latency_fd_ >= 0) {
+				const int32_t max_latency_us = kPreArmMaxCpuWakeLatencyUs;
+				if (write(cpu_latency_fd_, &max_latency_us, sizeof(max_latency_us)) != (ssize_t)sizeof(max_latency_us)) {
+					close(cpu_latency_fd_);
+					cpu_latency_fd_ = -1;
+				}
+			}
+		}
+#endif // #ifdef __unix__  // Ignore in Windows environment
+
+		pre_armed_ = true;
+		return true;
+	}
+
+	void PulseStrobe::ReleasePreArm() {
+
+#ifdef __unix__  // Ignore in Windows environment
+		if (cpu_latency_fd_ >= 0) {
+			close(cpu_latency_fd_);
+			cpu_latency_fd_ = -1;
+		}
+#endif // #ifdef __unix__  // Ignore in Windows environment
+
+		pre_armed_ = false;
+	}
+
+	void PulseStrobe::WaitUntilDeadline(const std::chrono::steady_clock::time_point& deadline) {
+#ifdef __unix__  // Ignore in Windows environment
+		// steady_clock is CLOCK_MONOTONIC on Linux
+		const auto sleep_until = deadline - std::chrono::microseconds(kPreciseTriggerSpinUs);
+		const auto sleep_until_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(sleep_until.time_since_epoch()).count();
+
+		if (sleep_until > std::chrono::steady_clock::now()) {
+			struct timespec wake_time;
+			wake_time.tv_sec = (time_t)(sleep_until_ns / 1000000000);
+			wake_time.tv_nsec = (long)(sleep_until_ns % 1000000000);
+
+			// An absolute wake-up time can just be slept for again after a signal
+			while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake_time, nullptr) == EINTR) {
+			}
+		}
+
+		while (std::chrono::steady_clock::now() < deadline) {
+		}
+#endif // #ifdef __unix__  // Ignore in Windows environment
+	}
+
+	long PulseStrobe::GetLastTriggerToFirstPulseUs() {
+		return last_trigger_to_first_pulse_us_;
+	}
+
+	void PulseStrobe::GetLastStrobeWriteTimes(int64_t& start_ns, int64_t& end_ns) {
+		start_ns = last_strobe_write_start_ns_;
+		end_ns = last_strobe_write_end_ns_;
+	}
+
 	bool PulseStrobe::DeinitGPIOSystem() {
 #ifdef __unix__  // Ignore in Windows environment
 		GS_LOG_TRACE_MSG(trace, "PulseStrobe::DeinitGPIOSystem.");
 
+		ReleasePreArm();
+
 		if (spiOpen_) {
 			lgSpiClose(spiHandle_);
 			spiHandle_ = -1;
@@ -705,6 +910,7 @@ namespace golf_sim {
 		}
 
 		// The camera should be ready to receive the 'real' external trigger pulse at this point
+		ArmTrigger();
 
 #endif // #ifdef __unix__  // Ignore in Windows environment
 
@@ -715,21 +921,44 @@ namespace golf_sim {
 
 #ifdef __unix__  // Ignore in Windows environment
 
+		golf_sim::GsLatencyBench::Stamp(golf_sim::GsLatencyBench::kTriggerStarted);
+		trigger_start_time_ = std::chrono::steady_clock::now();
+
+		// PreArmTrigger will already have cut the slack if the club was seen coming
+		if (kUsePreciseTriggerTiming && !pre_armed_) {
+			// The default 50us of slack would otherwise be added to every timed wake-up on this thread
+			prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+		}
+		last_trigger_to_first_pulse_us_ = -1;
+		last_strobe_write_start_ns_ = 0;
+		last_strobe_write_end_ns_ = 0;
+
 		// GS_LOG_TRACE_MSG(trace, "Sent final camera trigger(s) and strobe pulses.");
 		SendCameraStrobeTriggerAndShutter(lggpio_chip_handle_);
 
+		trigger_start_time_ = std::chrono::steady_clock::time_point{};
+
+		ReleasePreArm();
+
 		if (golf_sim::GolfSimCamera::kCameraRequiresFlushPulse) {
 
 			GS_LOG_TRACE_MSG(trace, "Waiting a moment to send flush trigger.");
 
-			long kPauseBeforeSendingImageFlushMs = 0;
-			GolfSimConfiguration::SetConstant("gs_config.strobing.kPauseBeforeSendingImageFlushMs", kPauseBeforeSendingImageFlushMs);
-			usleep(kPauseBeforeSendingImageFlushMs * 1000);
+			if (armed_pulse_sequence_ != nullptr) {
+				usleep(armed_pause_before_flush_us_);
+			}
+			else {
+				long kPauseBeforeSendingImageFlushMs = 0;
+				GolfSimConfiguration::SetConstant("gs_config.strobing.kPauseBeforeSendingImageFlushMs", kPauseBeforeSendingImageFlushMs);
+				usleep(kPauseBeforeSendingImageFlushMs * 1000);
+			}
 
 
 			GS_LOG_TRACE_MSG(trace, "Sending additional trigger to flush last frame.");
 			SendOnOffPulse(10000);
 		}
+
+		GS_LOG_TRACE_MSG(trace, "PulseStrobe::SendExternalTrigger - trigger-to-first-pulse latency = " + std::to_string(last_trigger_to_first_pulse_us_) + " us.");
 #endif
 		return true;
 	}
@@ -740,7 +969,8 @@ namespace golf_sim {
 
 		std::vector<float> intervals;
 
-		if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::GsClubType::kPutter) {
+		// The intervals of the pulses that were sent for the shot, not the current club's
+		if (GsSessionSettings::ShotSettings().club_type == GolfSimClubs::GsClubType::kPutter) {
 			intervals = pulse_intervals_slow_ms_;
 		}
 		else {
@@ -9,6 +9,8 @@
 #pragma once
 
 
+#include <chrono>
+#include <cstdint>
 #include <vector>
 
 #include "logging_tools.h"
@@ -26,6 +28,16 @@ namespace golf_sim {
 
 		static bool kUsingActiveHighTriggerCamera;
 		static int kPuttingStrobeDelayMs;
+		// If > 0, the putter pulse vector is cut to this many pulses, so that the putting
+		// fast path has fewer exposures to find (and waits less for the last one)
+		static int kPuttingFastPathMaxStrobePulses;
+		// If true, the putting delay is timed to an absolute deadline from the start of
+		// SendExternalTrigger (slept most of the way, then spun out) instead of a usleep,
+		// and the trigger thread's timer slack is cut to the minimum
+		static bool kUsePreciseTriggerTiming;
+		// The most CPU wake-up latency that is allowed while PreArmTrigger holds the CPUs
+		// (through /dev/cpu_dma_latency).  -1 leaves the CPU idle states alone.
+		static int kPreArmMaxCpuWakeLatencyUs;
 		static long kCam2SetupPeriodMilliseconds;
 		static int kNumberPrimingPulses;
 		static int kPrimingPulseFPS;
@@ -57,6 +69,36 @@ namespace golf_sim {
 		static bool SendCameraPrimingPulses(bool use_high_speed);
 		static bool SendExternalTrigger();
 
+		// Selects the pre-built pulse train for the current club type, pre-faults its
+		// pages, and reads the trigger-path settings up front, so that SendExternalTrigger
+		// is down to the shutter GPIO writes and a single lgSpiWrite.
+		// Called at the end of SendCameraPrimingPulses, just before the system waits for the hit.
+		static void ArmTrigger();
+
+		// Called when the club is seen approaching the ball (see the MotionDetectStage's approach
+		// zone), so that the rest of the trigger set-up is done before the ball moves.  Pulls
+		// the armed pulse train back into the cache, cuts the trigger thread's timer slack, and
+		// keeps the CPUs out of their slower-to-wake idle states until the trigger.  Does not
+		// allocate or log, so it can be called from the realtime watcher loop, and must be
+		// called from the thread that will call SendExternalTrigger.  Returns false if there is
+		// no armed pulse train.  Calling it again while pre-armed only re-warms the train.
+		static bool PreArmTrigger();
+
+		// Undoes PreArmTrigger, e.g., when the club went away again without a hit.
+		// SendExternalTrigger does this itself once the strobes have been sent.
+		static void ReleasePreArm();
+
+		static bool IsPreArmed() { return pre_armed_; }
+
+		// Microseconds from the start of the last SendExternalTrigger to the start of the
+		// strobe SPI write.  -1 if unknown.
+		static long GetLastTriggerToFirstPulseUs();
+
+		// When the strobe SPI write of the last SendExternalTrigger started (with the first
+		// pulse) and ended, in CLOCK_BOOTTIME nanoseconds, which is the clock that libcamera's
+		// SensorTimestamp uses.  Both are 0 if unknown.
+		static void GetLastStrobeWriteTimes(int64_t& start_ns, int64_t& end_ns);
+
 		// Sends the already-created pulse buffer to the strobes via SPI, and also
 		// opens the shutter while the pulses are sent.
 		// requires the camera_fast_pulse_sequence_ to have already been created by
@@ -110,6 +152,28 @@ namespace golf_sim {
 		static char* tail_repeat_pulse_sequence_;
 		static unsigned long tail_repeat_sequence_length_;
 
+		// Set by ArmTrigger
+		static char* armed_pulse_sequence_;
+		static unsigned long armed_pulse_sequence_length_;
+		static unsigned int armed_putting_delay_us_;
+		static long armed_pause_before_flush_us_;
+
+		// Set by PreArmTrigger
+		static bool pre_armed_;
+		// Held open while pre-armed, as the hold on the CPU idle states lasts only that long.  -1 if none.
+		static int cpu_latency_fd_;
+
+		// Reads every stride'th byte of the armed pulse train
+		static void TouchArmedPulseSequence(unsigned long stride);
+
+		static std::chrono::steady_clock::time_point trigger_start_time_;
+
+		// Returns at (within a few microseconds of) the deadline, even if a signal interrupts the wait
+		static void WaitUntilDeadline(const std::chrono::steady_clock::time_point& deadline);
+		static long last_trigger_to_first_pulse_us_;
+		static int64_t last_strobe_write_start_ns_;
+		static int64_t last_strobe_write_end_ns_;
+
 		static int spiHandle_;
 		static bool spiOpen_;
 		static int lggpio_chip_handle_;
@@ -5,10 +5,13 @@
 
 #include "spin_predictor.hpp"
 #include "logging_tools.h"
+#include "gs_metrics.h"
 
+#include <algorithm>
 #include <cmath>
 #include <chrono>
 #include <filesystem>
+#include <vector>
 
 namespace golf_sim {
 
@@ -36,11 +39,12 @@ bool SpinPredictor::Initialize() {
         return false;
     }
 
-    net_.opt.num_threads = config_.num_threads;
+    NcnnRuntime::ConfigureNet(net_, workspace_, config_.num_threads);
     net_.opt.use_fp16_packed = config_.use_fp16_packing;
     net_.opt.use_fp16_storage = config_.use_fp16_packing;
     net_.opt.use_fp16_arithmetic = true;
     net_.opt.use_packing_layout = true;
+    NcnnRuntime::ConfigureVulkan(net_, config_.use_vulkan_compute);
 
     if (net_.load_param(config_.param_path.c_str()) != 0) {
         GS_LOG_MSG(error, "SpinPredictor: failed to load param: " + config_.param_path);
@@ -52,8 +56,8 @@ bool SpinPredictor::Initialize() {
     }
 
     initialized_ = true;
-    GS_LOG_MSG(info, "SpinPredictor initialized (" + std::to_string(config_.num_threads) +
-               " threads, input=" + std::to_string(config_.input_size) + "px)");
+    GS_LOG_MSG(info, "SpinPredictor initialized (" +
+               std::string(net_.opt.use_vulkan_compute ? "Vulkan GPU" : std::to_string(net_.opt.num_threads) + " threads") + ", input=" + std::to_string(config_.input_size) + "px)");
 
     cv::Mat dummy = cv::Mat::zeros(config_.input_size, config_.input_size, CV_8UC1);
     for (int i = 0; i < 3; i++) {
@@ -80,30 +84,87 @@ SpinPredictor::Result SpinPredictor::Predict(
         return result;
     }
 
+    const int s = config_.input_size;
+
+    // Re-used from shot to shot.  Per thread, as shots may be analyzed in parallel.
+    static thread_local ncnn::Mat in0;
+    static thread_local ncnn::Mat in1;
+    in0.create(s, s, 2);
+    in1.create(s, s, 2);
+
+    RunInference(dimple_edges_1, dimple_edges_2, in0, in1, result);
+
+    return result;
+#endif
+}
+
+SpinPredictor::BatchResult SpinPredictor::PredictBatch(
+    const std::vector<std::pair<cv::Mat, cv::Mat>>& dimple_edge_pairs) {
+
+    BatchResult batch_result;
+
+#ifndef HAS_NCNN
+    GS_LOG_MSG(error, "SpinPredictor::PredictBatch called without NCNN support");
+    return batch_result;
+#else
+    if (!initialized_) {
+        GS_LOG_MSG(error, "SpinPredictor::PredictBatch called before Initialize()");
+        return batch_result;
+    }
+
     auto t_start = std::chrono::high_resolution_clock::now();
 
     const int s = config_.input_size;
 
-    cv::Mat img1, img2;
-    cv::resize(dimple_edges_1, img1, cv::Size(s, s), 0, 0, cv::INTER_NEAREST);
-    cv::resize(dimple_edges_2, img2, cv::Size(s, s), 0, 0, cv::INTER_NEAREST);
+    // Per-thread buffers, as in Predict, re-filled for each pair
+    static thread_local ncnn::Mat in0;
+    static thread_local ncnn::Mat in1;
+    in0.create(s, s, 2);
+    in1.create(s, s, 2);
 
-    ncnn::Mat in0(s, s, 2);
-    ncnn::Mat in1(s, s, 2);
+    batch_result.results.resize(dimple_edge_pairs.size());
 
-    TernaryToTwoChannel(img1, (float*)in0.data, s);
-    TernaryToTwoChannel(img2, (float*)in1.data, s);
+    for (size_t i = 0; i < dimple_edge_pairs.size(); i++) {
+        if (!RunInference(dimple_edge_pairs[i].first, dimple_edge_pairs[i].second, in0, in1, batch_result.results[i])) {
+            GS_LOG_MSG(warning, "SpinPredictor::PredictBatch - pair " + std::to_string(i) + " failed");
+        }
+    }
 
+    auto t_end = std::chrono::high_resolution_clock::now();
+    batch_result.total_ms = std::chrono::duration<float, std::milli>(t_end - t_start).count();
+
+    GS_LOG_MSG(info, "SpinPredictor: batch of " + std::to_string(dimple_edge_pairs.size()) +
+               " pairs in " + std::to_string(batch_result.total_ms) + "ms");
+
+    return batch_result;
+#endif
+}
+
+#ifdef HAS_NCNN
+bool SpinPredictor::RunInference(
+    const cv::Mat& dimple_edges_1,
+    const cv::Mat& dimple_edges_2,
+    ncnn::Mat& in0, ncnn::Mat& in1,
+    Result& result) {
+
+    auto t_start = std::chrono::high_resolution_clock::now();
+
+    const int s = config_.input_size;
+
+    TernaryToTwoChannel(dimple_edges_1, (float*)in0.channel(0).data, (float*)in0.channel(1).data, s);
+    TernaryToTwoChannel(dimple_edges_2, (float*)in1.channel(0).data, (float*)in1.channel(1).data, s);
+
+    NcnnRuntime::PinInferenceThreads(net_.opt.num_threads);
     ncnn::Extractor ex = net_.create_extractor();
     if (ex.input("in0", in0) != 0 || ex.input("in1", in1) != 0) {
         GS_LOG_MSG(error, "SpinPredictor: failed to set input blobs");
-        return result;
+        return false;
     }
 
     ncnn::Mat out;
     if (ex.extract("out0", out) != 0 || out.data == nullptr) {
         GS_LOG_MSG(error, "SpinPredictor: failed to extract output");
-        return result;
+        return false;
     }
 
     const float* r6d = (const float*)out.data;
@@ -111,6 +172,8 @@ SpinPredictor::Result SpinPredictor::Predict(
 
     auto t_end = std::chrono::high_resolution_clock::now();
     result.inference_ms = std::chrono::duration<float, std::milli>(t_end - t_start).count();
+    GsMetrics::Observe(GsMetrics::Histogram::kSpinPredictorInference,
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(t_end - t_start).count());
 
     if (std::abs(result.z_deg) > config_.z_fallback_threshold) {
         result.z_used_fallback = true;
@@ -118,23 +181,33 @@ SpinPredictor::Result SpinPredictor::Predict(
                    "° exceeds threshold, flagging for fallback");
     }
 
-    return result;
-#endif
+    return true;
 }
+#endif
 
 void SpinPredictor::TernaryToTwoChannel(const cv::Mat& gabor_img,
-                                         float* out_data, int size) {
-    const int n_pixels = size * size;
-    float* edge_channel = out_data;
-    float* valid_channel = out_data + n_pixels;
+                                         float* edge_channel, float* valid_channel, int size) {
+    CV_Assert(gabor_img.type() == CV_8UC1 && !gabor_img.empty());
+
+    // INTER_NEAREST takes source pixel floor(dst * src_size / dst_size), with the scale
+    // computed the same way as cv::resize does, so that the same pixels are picked
+    const double scale_x = 1.0 / ((double)size / gabor_img.cols);
+    const double scale_y = 1.0 / ((double)size / gabor_img.rows);
+
+    std::vector<int> source_x(size);
+    for (int x = 0; x < size; x++) {
+        source_x[x] = std::min(cvFloor(x * scale_x), gabor_img.cols - 1);
+    }
 
     for (int y = 0; y < size; y++) {
-        const uchar* row = gabor_img.ptr<uchar>(y);
+        const uchar* row = gabor_img.ptr<uchar>(std::min(cvFloor(y * scale_y), gabor_img.rows - 1));
+        float* edge_row = edge_channel + y * size;
+        float* valid_row = valid_channel + y * size;
+
         for (int x = 0; x < size; x++) {
-            int idx = y * size + x;
-            uchar pixel = row[x];
-            edge_channel[idx] = (pixel == 255) ? 1.0f : 0.0f;
-            valid_channel[idx] = (pixel != 128) ? 1.0f : 0.0f;
+            const uchar pixel = row[source_x[x]];
+            edge_row[x] = (pixel == 255) ? 1.0f : 0.0f;
+            valid_row[x] = (pixel != 128) ? 1.0f : 0.0f;
         }
     }
 }
@@ -7,10 +7,13 @@
 
 #ifdef HAS_NCNN
 #include <ncnn/net.h>
+#include "ncnn_runtime.hpp"
 #endif
 
 #include <opencv2/opencv.hpp>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace golf_sim {
 
@@ -22,6 +25,8 @@ public:
         int input_size = 128;
         int num_threads = 3;
         bool use_fp16_packing = true;
+        // Falls back to the CPU if there is no usable GPU
+        bool use_vulkan_compute = false;
         float z_fallback_threshold = 60.0f;
     };
 
@@ -33,6 +38,11 @@ public:
         float inference_ms = 0;
     };
 
+    struct BatchResult {
+        std::vector<Result> results;  // One per input pair, in the same order
+        float total_ms = 0;
+    };
+
     explicit SpinPredictor(const Config& config);
     ~SpinPredictor();
 
@@ -42,15 +52,30 @@ public:
     Result Predict(const cv::Mat& dimple_edges_1,
                    const cv::Mat& dimple_edges_2);
 
+    // Predicts the spin for each (dimple_edges_1, dimple_edges_2) pair.  The network has no batch
+    // dimension, so the pairs are run back-to-back, reusing the same pre-allocated input buffers.
+    BatchResult PredictBatch(const std::vector<std::pair<cv::Mat, cv::Mat>>& dimple_edge_pairs);
+
 private:
     Config config_;
     bool initialized_ = false;
 
 #ifdef HAS_NCNN
+    NcnnRuntime::ModelWorkspace workspace_;
     ncnn::Net net_;
+
+    // Runs one pair through the network using the caller's (already-sized) input buffers.
+    // The dimple images may be of any size - they are sampled down to the input size as
+    // the input channels are written, instead of being resized first.
+    bool RunInference(const cv::Mat& dimple_edges_1,
+                      const cv::Mat& dimple_edges_2,
+                      ncnn::Mat& in0, ncnn::Mat& in1,
+                      Result& result);
 #endif
 
-    void TernaryToTwoChannel(const cv::Mat& gabor_img, float* out_data, int size);
+    // Samples the ternary (0 = no edge, 255 = edge, 128 = ignore) dimple image at size x size,
+    // the same way as cv::resize with INTER_NEAREST, straight into the edge and valid channels
+    static void TernaryToTwoChannel(const cv::Mat& gabor_img, float* edge_channel, float* valid_channel, int size);
     static void Rotation6DToEuler(const float* r6d,
                                   double& x_deg, double& y_deg, double& z_deg);
     static void GramSchmidt(const float* r6d, double R[3][3]);
@@ -39,8 +39,15 @@ public:
 };
 
 // The main event loops for the camera 1 and 2 systems
-bool still_image_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg);
+// If frame_handler is given, the camera keeps streaming still frames, and each one is
+// passed to it until it returns false
+bool still_image_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg,
+							const std::function<bool(const cv::Mat&)>& frame_handler = nullptr);
 
 bool ball_flight_camera_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg);
 
+// Returns the first still frame that started exposing after the call, and leaves the camera
+// running for the next call.  camera_started is set once the camera has been started.
+bool persistent_still_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg, bool& camera_started);
+
 #endif // #ifdef __unix__  // Ignore in Windows environment
@@ -7,8 +7,16 @@
 #include <iostream>
 #include <algorithm>
 
+#ifdef __unix__
+#include <pthread.h>
+#include <sys/resource.h>
+#endif
+
+#include <opencv2/core/parallel/parallel_backend.hpp>
+
 #include "logging_tools.h"
 #include "gs_globals.h"
+#include "gs_config.h"
 
 namespace golf_sim {
 
@@ -265,4 +273,427 @@ namespace gs = golf_sim;
 		}
 	}
 
-}
\ No newline at end of file
+
+
+	int GsThreadPool::kReservedCpuCore = -1;
+	bool GsThreadPool::kUseSharedWorkerPool = false;
+
+	static thread_local int current_worker_index = -1;
+
+	void GsThreadPool::LoadConfigurationValues()
+	{
+		GolfSimConfiguration::SetConstant("gs_config.modes.kUseSharedWorkerPool", kUseSharedWorkerPool);
+	}
+
+	GsThreadPool::GsThreadPool(unsigned int number_of_threads, int reserved_cpu_core)
+	{
+		number_of_threads = std::max(1u, number_of_threads);
+
+		for (unsigned int i = 0; i < number_of_threads; i++) {
+			threads_.emplace_back(&GsThreadPool::Process, this, (int)i);
+
+#ifdef __unix__
+			if (reserved_cpu_core >= 0) {
+				cpu_set_t cpu_set;
+				CPU_ZERO(&cpu_set);
+				for (unsigned int core = 0; core < std::thread::hardware_concurrency(); core++) {
+					if ((int)core != reserved_cpu_core) {
+						CPU_SET(core, &cpu_set);
+					}
+				}
+
+				if (pthread_setaffinity_np(threads_.back().native_handle(), sizeof(cpu_set), &cpu_set) != 0) {
+					GS_LOG_MSG(warning, "GsThreadPool - could not keep a pool thread off of core " + std::to_string(reserved_cpu_core));
+				}
+			}
+#endif
+		}
+
+		GS_LOG_TRACE_MSG(trace, "GsThreadPool created with " + std::to_string(number_of_threads) + " threads.");
+	}
+
+	GsThreadPool::~GsThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			exiting_ = true;
+		}
+		cv_.notify_all();
+
+		for (std::thread& t : threads_) {
+			if (t.joinable()) {
+				t.join();
+			}
+		}
+	}
+
+	GsThreadPool& GsThreadPool::GetSharedPool()
+	{
+		static GsThreadPool shared_pool([]() {
+			unsigned int cores = std::max(2u, std::thread::hardware_concurrency());
+			if (kReservedCpuCore >= 0 && kReservedCpuCore < (int)cores && cores > 2) {
+				cores--;
+			}
+			return cores - 1;
+		}(), kReservedCpuCore);
+
+		return shared_pool;
+	}
+
+	int GsThreadPool::GetCurrentWorkerIndex()
+	{
+		return current_worker_index;
+	}
+
+	// Runs OpenCV's parallel_for_ stripes with GsThreadPool::ParallelFor, so OpenCV calls
+	// made from pool tasks share the same threads instead of waking up another set
+	class GsOpenCVParallelBackend : public cv::parallel::ParallelForAPI
+	{
+	public:
+		void parallel_for(int tasks, FN_parallel_for_body_cb_t body_callback, void* callback_data) override
+		{
+			GsThreadPool::GetSharedPool().ParallelFor(0, tasks, [body_callback, callback_data](int i) {
+				body_callback(i, i + 1, callback_data);
+			});
+		}
+
+		// 0 is any thread that is not one of the pool's
+		int getThreadNum() const override { return GsThreadPool::GetCurrentWorkerIndex() + 1; }
+
+		int getNumThreads() const override { return (int)GsThreadPool::GetSharedPool().GetNumberOfThreads() + 1; }
+
+		// The pool is sized for the cores once, so this is ignored
+		int setNumThreads(int) override { return getNumThreads(); }
+
+		const char* getName() const override { return "GsThreadPool"; }
+	};
+
+	void GsThreadPool::InstallOpenCVParallelBackend()
+	{
+		if (!kUseSharedWorkerPool) {
+			return;
+		}
+
+		cv::parallel::setParallelForBackend(std::make_shared<GsOpenCVParallelBackend>(), false);
+
+		GS_LOG_MSG(info, "GsThreadPool - OpenCV will use the shared pool (" + std::to_string(GetSharedPool().GetNumberOfThreads()) + " threads).");
+	}
+
+	void GsThreadPool::Process(int worker_index)
+	{
+		current_worker_index = worker_index;
+
+		while (true) {
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				cv_.wait(lock, [this]() { return exiting_ || !tasks_.empty(); });
+
+				// Drain any remaining work before exiting so that no future is left broken
+				if (tasks_.empty()) {
+					return;
+				}
+
+				task = std::move(tasks_.front());
+				tasks_.pop();
+			}
+
+			task();
+		}
+	}
+
+
+	GsTimerScheduler& GsTimerScheduler::GetInstance()
+	{
+		static GsTimerScheduler scheduler;
+		return scheduler;
+	}
+
+	GsTimerScheduler::~GsTimerScheduler()
+	{
+		Shutdown();
+	}
+
+	GsTimerScheduler::TimerId GsTimerScheduler::Schedule(long delay_ms, std::function<void()> callback)
+	{
+		TimerId timer_id;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			timer_id = next_timer_id_++;
+			const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(std::max(0L, delay_ms));
+
+			timers_[timer_id] = Timer{ deadline, std::move(callback) };
+			heap_.emplace(deadline, timer_id);
+
+			if (!thread_.joinable()) {
+				exiting_ = false;
+				thread_ = std::thread(&GsTimerScheduler::Process, this);
+			}
+		}
+		cv_.notify_one();
+
+		return timer_id;
+	}
+
+	bool GsTimerScheduler::Cancel(TimerId timer_id)
+	{
+		// The heap entry is skipped once it reaches the top
+		std::lock_guard<std::mutex> lock(mutex_);
+		return timers_.erase(timer_id) > 0;
+	}
+
+	bool GsTimerScheduler::Reschedule(TimerId timer_id, long delay_ms)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			auto timer = timers_.find(timer_id);
+			if (timer == timers_.end()) {
+				return false;
+			}
+
+			timer->second.deadline = Clock::now() + std::chrono::milliseconds(std::max(0L, delay_ms));
+			heap_.emplace(timer->second.deadline, timer_id);
+		}
+		cv_.notify_one();
+
+		return true;
+	}
+
+	void GsTimerScheduler::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			exiting_ = true;
+			timers_.clear();
+			heap_ = {};
+		}
+		cv_.notify_one();
+
+		if (thread_.joinable()) {
+			thread_.join();
+		}
+	}
+
+	void GsTimerScheduler::Process()
+	{
+		GS_LOG_TRACE_MSG(trace, "GsTimerScheduler::Process() called.");
+
+		std::unique_lock<std::mutex> lock(mutex_);
+
+		while (!exiting_) {
+			if (heap_.empty()) {
+				cv_.wait(lock);
+				continue;
+			}
+
+			const HeapEntry next = heap_.top();
+
+			auto timer = timers_.find(next.second);
+			if (timer == timers_.end() || timer->second.deadline != next.first) {
+				heap_.pop();
+				continue;
+			}
+
+			if (Clock::now() < next.first) {
+				// Also wakes up for an earlier timer, a Reschedule or a Shutdown
+				cv_.wait_until(lock, next.first);
+				continue;
+			}
+
+			heap_.pop();
+			std::function<void()> callback = std::move(timer->second.callback);
+			timers_.erase(timer);
+
+			// Don't hold the lock in case the callback schedules another timer
+			lock.unlock();
+			callback();
+			lock.lock();
+		}
+
+		GS_LOG_TRACE_MSG(trace, "GsTimerScheduler::Process() exiting.");
+	}
+
+	GsBackgroundWorker& GsBackgroundWorker::GetInstance()
+	{
+		static GsBackgroundWorker worker;
+		return worker;
+	}
+
+	GsBackgroundWorker::~GsBackgroundWorker()
+	{
+		Shutdown();
+	}
+
+	void GsBackgroundWorker::Post(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			tasks_.push(std::move(task));
+
+			if (!thread_.joinable()) {
+				exiting_ = false;
+				thread_ = std::thread(&GsBackgroundWorker::Process, this);
+			}
+		}
+		cv_.notify_one();
+	}
+
+	void GsBackgroundWorker::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			exiting_ = true;
+		}
+		cv_.notify_one();
+
+		if (thread_.joinable()) {
+			thread_.join();
+		}
+	}
+
+	void GsBackgroundWorker::Process()
+	{
+		GS_LOG_TRACE_MSG(trace, "GsBackgroundWorker::Process() called.");
+
+#ifdef __unix__
+		// On Linux, this applies only to the calling thread
+		if (setpriority(PRIO_PROCESS, 0, kWorkerThreadNiceness) != 0) {
+			GS_LOG_MSG(warning, "GsBackgroundWorker - could not lower the worker thread priority.");
+		}
+#endif
+
+		std::unique_lock<std::mutex> lock(mutex_);
+
+		while (true) {
+			cv_.wait(lock, [this] { return exiting_ || !tasks_.empty(); });
+
+			// Even when exiting, what is queued (including anything that the queued
+			// tasks post) is still run
+			if (tasks_.empty()) {
+				break;
+			}
+
+			std::function<void()> task = std::move(tasks_.front());
+			tasks_.pop();
+
+			lock.unlock();
+			try {
+				task();
+			}
+			catch (std::exception& ex) {
+				GS_LOG_MSG(error, "GsBackgroundWorker - a background task failed. ERROR: *** " + std::string(ex.what()) + " ***");
+			}
+			lock.lock();
+		}
+
+		GS_LOG_TRACE_MSG(trace, "GsBackgroundWorker::Process() exiting.");
+	}
+
+	GsBackgroundJob::GsBackgroundJob(std::function<bool()> work) : work_(std::move(work))
+	{
+	}
+
+	void GsBackgroundJob::Schedule(long delay_ms)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		if (running_) {
+			pending_delay_ms_ = (pending_delay_ms_ < 0) ? std::max(0L, delay_ms) : std::min(pending_delay_ms_, delay_ms);
+			return;
+		}
+
+		if (queued_) {
+			return;
+		}
+
+		if (timer_id_ != GsTimerScheduler::kNoTimer) {
+			if (delay_ms > 0) {
+				return;
+			}
+
+			// Run now instead.  If the timer has already fired, its callback sees that
+			// it is no longer the current timer and does nothing.
+			GsTimerScheduler::GetInstance().Cancel(timer_id_);
+			timer_id_ = GsTimerScheduler::kNoTimer;
+		}
+
+		StartLocked(delay_ms);
+	}
+
+	void GsBackgroundJob::WaitUntilIdle()
+	{
+		Schedule(0);
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		number_of_waiters_++;
+		idle_.wait(lock, [this] {
+			return !queued_ && !running_ && pending_delay_ms_ < 0 && timer_id_ == GsTimerScheduler::kNoTimer;
+		});
+		number_of_waiters_--;
+	}
+
+	void GsBackgroundJob::StartLocked(long delay_ms)
+	{
+		if (delay_ms <= 0) {
+			queued_ = true;
+			GsBackgroundWorker::GetInstance().Post([this] { Run(); });
+			return;
+		}
+
+		// The callback can't look at timer_id before it is set, because it needs the lock
+		auto timer_id = std::make_shared<GsTimerScheduler::TimerId>(GsTimerScheduler::kNoTimer);
+
+		timer_id_ = GsTimerScheduler::GetInstance().Schedule(delay_ms, [this, timer_id] {
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			if (timer_id_ != *timer_id) {
+				return;
+			}
+
+			timer_id_ = GsTimerScheduler::kNoTimer;
+			StartLocked(0);
+		});
+
+		*timer_id = timer_id_;
+	}
+
+	void GsBackgroundJob::Run()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			queued_ = false;
+			running_ = true;
+		}
+
+		bool more = false;
+		try {
+			more = work_();
+		}
+		catch (std::exception& ex) {
+			GS_LOG_MSG(error, "GsBackgroundJob - background work failed. ERROR: *** " + std::string(ex.what()) + " ***");
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		running_ = false;
+
+		if (more) {
+			pending_delay_ms_ = -1;
+			StartLocked(0);
+		}
+		else if (pending_delay_ms_ >= 0) {
+			// Nobody should have to wait out the delay
+			const long delay_ms = (number_of_waiters_ > 0) ? 0 : pending_delay_ms_;
+			pending_delay_ms_ = -1;
+			StartLocked(delay_ms);
+		}
+		else {
+			idle_.notify_all();
+		}
+	}
+
+}
@@ -11,9 +11,18 @@
 
 #include <thread>
 #include <queue>
+#include <algorithm>
 #include <mutex>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace golf_sim {
 
@@ -117,4 +126,270 @@ private:
     std::atomic<bool> m_timerExit;
 };
 
-}
\ No newline at end of file
+
+
+// A small, fixed-size pool of worker threads, shared by work such as the post-hit
+// analysis stages so that those stages don't each spin up their own threads.
+// Tasks are run in the order that they are submitted.
+class GsThreadPool
+{
+public:
+    // The pool's threads are kept off of this core (e.g., the core that the real-time
+    // ball watcher is pinned to).  -1 means no core is reserved.  Must be set before
+    // the shared pool is first used.
+    static int kReservedCpuCore;
+
+    // If true, OpenCV's parallel_for_ (and so forEach) and the spin-analysis loops
+    // use the shared pool instead of OpenCV's own threads and OpenMP
+    static bool kUseSharedWorkerPool;
+
+    static void LoadConfigurationValues();
+
+    explicit GsThreadPool(unsigned int number_of_threads, int reserved_cpu_core = -1);
+
+    ~GsThreadPool();
+
+    // The process-wide pool.  Created on first use with one thread for each core
+    // except the one that the submitting (e.g., FSM) thread runs on and kReservedCpuCore.
+    static GsThreadPool& GetSharedPool();
+
+    // Makes OpenCV run its parallel loops on the shared pool.  Does nothing unless
+    // kUseSharedWorkerPool is set.
+    static void InstallOpenCVParallelBackend();
+
+    // The index of the pool thread that is calling, or -1 if the caller is not one of
+    // the shared pool's threads
+    static int GetCurrentWorkerIndex();
+
+    // Calls body(i) for every i in [begin, end) and returns once all have finished.
+    // The calling thread does its share of the work and takes over any part that no
+    // pool thread has started, so this can be called from inside another ParallelFor
+    // (or any pool task) without deadlocking or starting more threads.
+    template <typename F>
+    void ParallelFor(int begin, int end, F&& body)
+    {
+        const int count = end - begin;
+        if (count <= 0) {
+            return;
+        }
+
+        if (count == 1) {
+            body(begin);
+            return;
+        }
+
+        struct ForState {
+            std::function<void(int)> body;
+            int end = 0;
+            int grain = 1;
+            std::atomic<int> next{ 0 };
+            std::atomic<int> remaining{ 0 };
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+
+        auto state = std::make_shared<ForState>();
+        state->body = std::forward<F>(body);
+        state->end = end;
+        state->next = begin;
+        state->remaining = count;
+        // A few chunks per thread evens out iterations of different lengths
+        state->grain = std::max(1, count / ((int)(threads_.size() + 1) * 4));
+
+        auto run_chunks = [](const std::shared_ptr<ForState>& s) {
+            int chunk_begin;
+            while ((chunk_begin = s->next.fetch_add(s->grain)) < s->end) {
+                const int chunk_end = std::min(s->end, chunk_begin + s->grain);
+                for (int i = chunk_begin; i < chunk_end; i++) {
+                    s->body(i);
+                }
+
+                if (s->remaining.fetch_sub(chunk_end - chunk_begin) == chunk_end - chunk_begin) {
+                    std::lock_guard<std::mutex> lock(s->mutex);
+                    s->finished.notify_all();
+                }
+            }
+        };
+
+        // A helper that starts after all of the work is claimed just returns
+        const int number_of_helpers = std::min((int)threads_.size(), (count + state->grain - 1) / state->grain - 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int i = 0; i < number_of_helpers; i++) {
+                tasks_.emplace([state, run_chunks]() { run_chunks(state); });
+            }
+        }
+        cv_.notify_all();
+
+        run_chunks(state);
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state]() { return state->remaining == 0; });
+    }
+
+    // Queues the task and returns a future for its result.  Unlike a future from
+    // std::async, the returned future does not block when it is destroyed.
+    template <typename F>
+    auto Submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using ResultType = std::invoke_result_t<std::decay_t<F>>;
+
+        auto packaged_task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(task));
+        std::future<ResultType> result = packaged_task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([packaged_task]() { (*packaged_task)(); });
+        }
+        cv_.notify_one();
+
+        return result;
+    }
+
+    unsigned int GetNumberOfThreads() const { return (unsigned int)threads_.size(); }
+
+private:
+    void Process(int worker_index);
+
+    std::vector<std::thread> threads_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool exiting_ = false;
+
+    GsThreadPool(const GsThreadPool&) = delete;
+    GsThreadPool& operator=(const GsThreadPool&) = delete;
+};
+
+// One thread that runs every one-shot timer, in deadline order, instead of a
+// TimedCallbackThread (and so a new OS thread) for each timer.  The callbacks run
+// on the scheduler thread, so they should be short - e.g., just queue an event.
+class GsTimerScheduler
+{
+public:
+    using TimerId = uint64_t;
+
+    // Never returned by Schedule
+    static constexpr TimerId kNoTimer = 0;
+
+    // The process-wide scheduler.  Its thread is started by the first Schedule.
+    static GsTimerScheduler& GetInstance();
+
+    ~GsTimerScheduler();
+
+    TimerId Schedule(long delay_ms, std::function<void()> callback);
+
+    // Returns false if the timer has already fired (or been cancelled)
+    bool Cancel(TimerId timer_id);
+
+    // Moves a pending timer's deadline to delay_ms from now.  Returns false if it has
+    // already fired (or been cancelled).
+    bool Reschedule(TimerId timer_id, long delay_ms);
+
+    // Drops every pending timer and stops the thread.  A later Schedule restarts it.
+    void Shutdown();
+
+private:
+    GsTimerScheduler() = default;
+
+    void Process();
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer {
+        Clock::time_point deadline;
+        std::function<void()> callback;
+    };
+
+    // (deadline, id) pairs, earliest first.  A pair whose deadline no longer matches
+    // its timer was left behind by a Reschedule (or Cancel) and is skipped.
+    using HeapEntry = std::pair<Clock::time_point, TimerId>;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap_;
+    std::unordered_map<TimerId, Timer> timers_;
+
+    TimerId next_timer_id_ = kNoTimer + 1;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool exiting_ = false;
+
+    GsTimerScheduler(const GsTimerScheduler&) = delete;
+    GsTimerScheduler& operator=(const GsTimerScheduler&) = delete;
+};
+
+// One niced-down thread that runs the background jobs of every feature (image
+// writing, the event journal, the shot archives and so on) in the order that they
+// were posted, instead of each feature starting its own low-priority thread.
+// Tasks should do one item (or batch) of work and return, so that one busy feature
+// does not hold up the others for long.
+class GsBackgroundWorker
+{
+public:
+    // The worker thread is niced down this much so that it never competes with the FSM
+    static constexpr int kWorkerThreadNiceness = 10;
+
+    // The process-wide worker.  Its thread is started by the first Post.
+    static GsBackgroundWorker& GetInstance();
+
+    ~GsBackgroundWorker();
+
+    void Post(std::function<void()> task);
+
+    // Runs everything that is still queued and stops the thread.  A later Post
+    // restarts it.
+    void Shutdown();
+
+private:
+    GsBackgroundWorker() = default;
+
+    void Process();
+
+    std::queue<std::function<void()>> tasks_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool exiting_ = false;
+
+    GsBackgroundWorker(const GsBackgroundWorker&) = delete;
+    GsBackgroundWorker& operator=(const GsBackgroundWorker&) = delete;
+};
+
+// A feature's share of the background worker.  work() does one item (or batch) of
+// the feature's queued work and returns true if there is more.  Each call is posted
+// to the worker separately, so the features take turns.  At most one call of work()
+// is queued or running at a time, so work() does not have to be reentrant.
+class GsBackgroundJob
+{
+public:
+    explicit GsBackgroundJob(std::function<bool()> work);
+
+    // Makes sure that work() will be called, after delay_ms if it isn't already due
+    // sooner.  A call that arrives while work() is running is not lost - work() is
+    // called again afterward.
+    void Schedule(long delay_ms = 0);
+
+    // Waits until work() has returned false and nothing more is scheduled.  A delayed
+    // call is made right away rather than waited for.  Must not be called on the
+    // worker (i.e., from any job's work()).
+    void WaitUntilIdle();
+
+private:
+    void StartLocked(long delay_ms);
+    void Run();
+
+    std::function<bool()> work_;
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    bool queued_ = false;
+    bool running_ = false;
+    // -1 unless Schedule was called while work() was running
+    long pending_delay_ms_ = -1;
+    // Threads in WaitUntilIdle
+    int number_of_waiters_ = 0;
+    GsTimerScheduler::TimerId timer_id_ = GsTimerScheduler::kNoTimer;
+
+    GsBackgroundJob(const GsBackgroundJob&) = delete;
+    GsBackgroundJob& operator=(const GsBackgroundJob&) = delete;
+};
+
+}
@@ -8,6 +8,10 @@
 // touch, so sometimes it's easier to move some sliders around to figure out what
 // works best instead of trying different parameters in a .json file and running the
 // applicaiton again and again.
+//
+// To compare many combinations of the parameters at once - using the launch monitor's
+// own BallImageProc over a set of labeled images - see pitrac_lm's
+// --system_mode=hough_sweep (GsHoughSweep) instead.
 
 #include <iostream>
 #include <cstring>